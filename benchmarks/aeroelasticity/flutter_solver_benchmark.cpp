@@ -0,0 +1,324 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2017  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+// C++ includes
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+
+
+// MAST includes
+#include "benchmarks/aeroelasticity/flutter_solver_benchmark.h"
+#include "benchmarks/aeroelasticity/synthetic_flutter_assembly.h"
+#include "examples/structural/plate_piston_theory_flutter/plate_piston_theory_flutter.h"
+#include "examples/fsi/beam_flutter_solution/beam_euler_fsi_flutter_solution.h"
+#include "aeroelasticity/pk_flutter_solver.h"
+#include "aeroelasticity/ug_flutter_solver.h"
+#include "aeroelasticity/time_domain_flutter_solver.h"
+#include "aeroelasticity/flutter_root_base.h"
+#include "base/parameter.h"
+#include "base/performance_log.h"
+
+
+// libMesh includes
+#include "libmesh/libmesh.h"
+
+
+extern libMesh::LibMeshInit* __init;
+
+
+MAST::FlutterSolverBenchmark::FlutterSolverBenchmark():
+csv_file             ("flutter_benchmark.csv"),
+g_tol                (1.e-3),
+max_bisection_iters  (20),
+n_divs               (10),
+_log_enabled         (false) {
+    
+}
+
+
+
+MAST::FlutterSolverBenchmark::~FlutterSolverBenchmark() {
+    
+}
+
+
+
+void
+MAST::FlutterSolverBenchmark::run_synthetic(unsigned int n) {
+    
+    const Real
+    rho      = 1.,
+    V_lower  = 100.,
+    V_upper  = 1000.,
+    kr_lower = 0.05,
+    kr_upper = 1.;
+    
+    MAST::Parameter
+    V     ("V",     0.),
+    kr    ("kr",    0.),
+    b_ref ("b_ref", 1.);
+    
+    // PK solver
+    {
+        MAST::SyntheticFlutterAssembly assembly(n, V, kr, rho);
+        MAST::PKFlutterSolver          solver;
+        
+        Result r;
+        r.solver  = "PK";
+        r.model   = "synthetic";
+        r.n_modes = n;
+        
+        this->_start_case();
+        
+        solver.attach_assembly(assembly);
+        solver.set_reduced_structural_cache(false);
+        solver.initialize(V, kr, b_ref, rho,
+                          V_lower, V_upper, n_divs,
+                          kr_lower, kr_upper, n_divs,
+                          assembly.basis());
+        solver.scan_for_roots();
+        
+        std::pair<bool, MAST::FlutterRootBase*>
+        sol = solver.find_critical_root(g_tol, max_bisection_iters);
+        
+        if (sol.first) r.V_flutter = sol.second->V;
+        r.n_roots = solver.n_roots_found();
+        
+        this->_end_case(r, "PKFlutterSolver",
+                        "SyntheticFlutterAssembly", "SyntheticFlutterAssembly");
+        
+        solver.clear_assembly_object();
+    }
+    
+    // UG solver
+    {
+        MAST::SyntheticFlutterAssembly assembly(n, V, kr, rho);
+        MAST::UGFlutterSolver          solver;
+        
+        Result r;
+        r.solver  = "UG";
+        r.model   = "synthetic";
+        r.n_modes = n;
+        
+        this->_start_case();
+        
+        solver.attach_assembly(assembly);
+        solver.set_reduced_structural_cache(false);
+        solver.initialize(kr, b_ref, rho,
+                          kr_lower, kr_upper, n_divs,
+                          assembly.basis());
+        solver.scan_for_roots();
+        
+        std::pair<bool, MAST::FlutterRootBase*>
+        sol = solver.find_critical_root(g_tol, max_bisection_iters);
+        
+        if (sol.first) r.V_flutter = sol.second->V;
+        r.n_roots = solver.n_roots_found();
+        
+        this->_end_case(r, "UGFlutterSolver",
+                        "SyntheticFlutterAssembly", "SyntheticFlutterAssembly");
+        
+        solver.clear_assembly_object();
+    }
+    
+    // time domain solver, with the aerodynamic terms in the structural
+    // matrices
+    {
+        MAST::SyntheticFlutterAssembly assembly(n, V, kr, rho);
+        assembly.set_aero_in_structural_matrices(true);
+        
+        MAST::TimeDomainFlutterSolver  solver;
+        
+        Result r;
+        r.solver  = "TimeDomain";
+        r.model   = "synthetic";
+        r.n_modes = n;
+        
+        this->_start_case();
+        
+        solver.attach_assembly(assembly);
+        solver.set_reduced_structural_cache(false);
+        solver.initialize(V, V_lower, V_upper, n_divs, assembly.basis());
+        solver.scan_for_roots();
+        
+        std::pair<bool, MAST::FlutterRootBase*>
+        sol = solver.find_critical_root(g_tol, max_bisection_iters);
+        
+        if (sol.first) r.V_flutter = sol.second->V;
+        r.n_roots = solver.n_roots_found();
+        
+        this->_end_case(r, "TimeDomainFlutterSolver",
+                        "SyntheticFlutterAssembly", "SyntheticFlutterAssembly");
+        
+        solver.clear_assembly_object();
+    }
+}
+
+
+
+void
+MAST::FlutterSolverBenchmark::run_piston_theory() {
+    
+    MAST::PlatePistonTheoryFlutterAnalysis a;
+    a.init(libMesh::QUAD4, false);
+    
+    Result r;
+    r.solver  = "TimeDomain";
+    r.model   = "plate_piston_theory";
+    
+    this->_start_case();
+    
+    r.V_flutter = a.solve(false, g_tol, max_bisection_iters);
+    r.n_modes   = (unsigned int)a._basis.size();
+    r.n_roots   = a._flutter_solver->n_roots_found();
+    
+    this->_end_case(r, "TimeDomainFlutterSolver",
+                    "FSIGeneralizedAeroForceAssembly",
+                    "StructuralFluidInteractionAssembly");
+}
+
+
+
+void
+MAST::FlutterSolverBenchmark::run_euler_fsi() {
+    
+    MAST::BeamEulerFSIFlutterAnalysis a;
+    
+    Result r;
+    r.solver  = "UG";
+    r.model   = "beam_euler_fsi";
+    
+    this->_start_case();
+    
+    r.V_flutter = a.solve(false, g_tol, max_bisection_iters);
+    r.n_modes   = (unsigned int)a._basis.size();
+    r.n_roots   = a._flutter_solver->n_roots_found();
+    
+    this->_end_case(r, "UGFlutterSolver",
+                    "FSIGeneralizedAeroForceAssembly",
+                    "StructuralFluidInteractionAssembly");
+}
+
+
+
+void
+MAST::FlutterSolverBenchmark::_start_case() {
+    
+    _log_enabled = MAST::perf_log.enabled();
+    MAST::perf_log.reset();
+    MAST::perf_log.enable();
+    
+    __init->comm().barrier();
+    _t0 = std::chrono::high_resolution_clock::now();
+}
+
+
+
+void
+MAST::FlutterSolverBenchmark::_end_case(Result& r,
+                                        const std::string& solver_header,
+                                        const std::string& gaf_header,
+                                        const std::string& structural_header) {
+    
+    __init->comm().barrier();
+    
+    std::chrono::high_resolution_clock::time_point
+    t1 = std::chrono::high_resolution_clock::now();
+    
+    r.time = std::chrono::duration<Real>(t1-_t0).count();
+    
+    // the time domain solver initializes the structural matrices for each
+    // eigenproblem, and the frequency domain solvers the complete matrices
+    r.n_eigen_solves =
+    _count("initialize_structural_matrices()", solver_header) +
+    _count("initialize_full_order_matrices()", solver_header);
+    if (!r.n_eigen_solves)
+        r.n_eigen_solves = _count("initialize_matrices()", solver_header);
+    
+    r.n_gaf        = _count("assemble_generalized_aerodynamic_force_matrix()",
+                            gaf_header);
+    r.n_structural = _count("assemble_reduced_order_quantity()",
+                            structural_header);
+    
+    MAST::perf_log.enable(_log_enabled);
+    
+    libMesh::out
+    << std::setw(12) << std::left  << r.solver
+    << std::setw(22) << std::left  << r.model
+    << "modes: "     << std::setw(6)  << r.n_modes
+    << "roots: "     << std::setw(6)  << r.n_roots
+    << "V_f: "       << std::setw(14) << std::scientific << std::setprecision(6) << r.V_flutter
+    << "s/root: "    << std::setw(14) << r.time/std::max(1U, r.n_roots)
+    << "eig: "       << std::setw(8)  << r.n_eigen_solves
+    << "gaf: "       << std::setw(8)  << r.n_gaf
+    << "struct: "    << r.n_structural << std::endl;
+    
+    this->_write_csv(r);
+}
+
+
+
+unsigned long long
+MAST::FlutterSolverBenchmark::_count(const std::string& event,
+                                     const std::string& header) {
+    
+    return MAST::perf_log.register_event(event, header).count.load();
+}
+
+
+
+void
+MAST::FlutterSolverBenchmark::_write_csv(const Result& r) const {
+    
+    if (__init->comm().rank())
+        return;
+    
+    // the header is written only to a new file
+    bool
+    if_header = true;
+    {
+        std::ifstream in(csv_file.c_str());
+        if_header = !in.good() || in.peek() == std::ifstream::traits_type::eof();
+    }
+    
+    std::ofstream out(csv_file.c_str(), std::ios::out | std::ios::app);
+    if (!out.good())
+        libmesh_error_msg("Unable to open file: " << csv_file);
+    
+    if (if_header)
+        out
+        << "solver,model,n_modes,n_procs,n_roots,V_flutter,time,time_per_root,"
+        << "n_eigen_solves,n_gaf_assemblies,n_structural_assemblies" << std::endl;
+    
+    out
+    << r.solver                 << ","
+    << r.model                  << ","
+    << r.n_modes                << ","
+    << __init->comm().size()    << ","
+    << r.n_roots                << ","
+    << std::scientific << std::setprecision(8)
+    << r.V_flutter              << ","
+    << r.time                   << ","
+    << r.time/std::max(1U, r.n_roots) << ","
+    << r.n_eigen_solves         << ","
+    << r.n_gaf                  << ","
+    << r.n_structural           << std::endl;
+}
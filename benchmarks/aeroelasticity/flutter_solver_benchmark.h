@@ -0,0 +1,163 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2017  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+#ifndef __mast_benchmark_flutter_solver_benchmark_h__
+#define __mast_benchmark_flutter_solver_benchmark_h__
+
+// C++ includes
+#include <string>
+#include <vector>
+#include <chrono>
+
+// MAST includes
+#include "base/mast_data_types.h"
+
+
+
+namespace MAST {
+    
+    // Forward declerations
+    class FlutterSolverBase;
+    
+    
+    /*!
+     *   Times the PK, UG and time domain flutter solvers on synthetic
+     *   reduced order models (see MAST::SyntheticFlutterAssembly), and
+     *   on the piston theory plate and Euler FSI beam examples. For each
+     *   case the time per root, the number of eigenproblems, and the
+     *   number of generalized aerodynamic force and reduced structural
+     *   assemblies are printed and appended to a CSV file, along with
+     *   the critical flutter velocity, so that the cost and the results
+     *   can be tracked across versions. The counts are obtained from
+     *   \p MAST::perf_log, which is enabled during each case.
+     */
+    class FlutterSolverBenchmark {
+        
+    public:
+        
+        FlutterSolverBenchmark();
+        
+        virtual ~FlutterSolverBenchmark();
+        
+        
+        /*!
+         *   name of the CSV file to which the results are appended
+         */
+        std::string  csv_file;
+        
+        /*!
+         *   tolerance on the damping and maximum number of bisection
+         *   iterations used to find the critical root
+         */
+        Real         g_tol;
+        
+        unsigned int max_bisection_iters;
+        
+        /*!
+         *   number of divisions of the velocity or reduced frequency
+         *   range scanned for roots
+         */
+        unsigned int n_divs;
+        
+        
+        /*!
+         *   times all three solvers on a synthetic model with \p n modes
+         */
+        void run_synthetic(unsigned int n);
+        
+        
+        /*!
+         *   times the time domain solver on the piston theory plate
+         */
+        void run_piston_theory();
+        
+        
+        /*!
+         *   times the UG solver on the Euler FSI beam. This reads the
+         *   mesh and flow data from \p input.in in the working directory.
+         */
+        void run_euler_fsi();
+        
+    protected:
+        
+        /*!
+         *   result of a case
+         */
+        struct Result {
+            
+            Result():
+            n_modes(0), n_roots(0), V_flutter(0.), time(0.),
+            n_eigen_solves(0), n_gaf(0), n_structural(0) { }
+            
+            std::string   solver;
+            std::string   model;
+            unsigned int  n_modes;
+            unsigned int  n_roots;
+            Real          V_flutter;
+            Real          time;
+            unsigned long long n_eigen_solves;
+            unsigned long long n_gaf;
+            unsigned long long n_structural;
+        };
+        
+        
+        /*!
+         *   resets and enables \p MAST::perf_log, and starts the timer
+         */
+        void _start_case();
+        
+        /*!
+         *   stops the timer, reads the number of eigenproblems from the
+         *   events of \p solver_header, and the number of generalized
+         *   aerodynamic force and structural assemblies from the events of
+         *   \p gaf_header and \p structural_header. \p r is then printed
+         *   and written to the CSV file.
+         */
+        void _end_case(Result& r,
+                       const std::string& solver_header,
+                       const std::string& gaf_header,
+                       const std::string& structural_header);
+        
+        /*!
+         *   @returns the number of calls recorded for \p event of
+         *   \p header in \p MAST::perf_log
+         */
+        static unsigned long long _count(const std::string& event,
+                                         const std::string& header);
+        
+        /*!
+         *   appends \p r to the CSV file on processor 0
+         */
+        void _write_csv(const Result& r) const;
+        
+        /*!
+         *   state of \p MAST::perf_log before the case
+         */
+        bool         _log_enabled;
+        
+        /*!
+         *   start of the current case
+         */
+        std::chrono::high_resolution_clock::time_point _t0;
+    };
+}
+
+
+#endif // __mast_benchmark_flutter_solver_benchmark_h__
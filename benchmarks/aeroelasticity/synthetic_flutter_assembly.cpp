@@ -0,0 +1,173 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2017  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+// C++ includes
+#include <cmath>
+
+
+// MAST includes
+#include "benchmarks/aeroelasticity/synthetic_flutter_assembly.h"
+#include "base/parameter.h"
+#include "base/performance_log.h"
+
+
+// libMesh includes
+#include "libmesh/numeric_vector.h"
+
+
+extern libMesh::LibMeshInit* __init;
+
+
+MAST::SyntheticFlutterAssembly::
+SyntheticFlutterAssembly(unsigned int n,
+                         MAST::Parameter& V,
+                         MAST::Parameter& kr,
+                         Real rho):
+MAST::FSIGeneralizedAeroForceAssembly(),
+n_structural_assemblies  (0),
+n_gaf_assemblies         (0),
+_n                       (n),
+_V                       (V),
+_kr                      (kr),
+_rho                     (rho),
+_aero_in_structural      (false) {
+    
+    libmesh_assert_greater(n, 1);
+    
+    const Real
+    pi       = acos(-1.),
+    omega0   = 2.*pi*10.,
+    // the first pair of modes coalesces at about this velocity
+    V_ref    = 500.,
+    alpha    = 1.5*omega0*omega0/(0.5*rho*V_ref*V_ref),
+    beta     = 1.e-2;
+    
+    _K  = RealMatrixX::Zero(n, n);
+    _A0 = RealMatrixX::Zero(n, n);
+    _A1 = beta * RealMatrixX::Identity(n, n);
+    
+    for (unsigned int i=0; i<n; i++)
+        _K(i, i) = pow(omega0*(i+1), 2);
+    
+    for (unsigned int i=0; i+1<n; i+=2) {
+        _A0(i, i+1)  =  alpha;
+        _A0(i+1, i)  = -alpha;
+    }
+    
+    _basis.resize(n);
+    for (unsigned int i=0; i<n; i++) {
+        _basis[i] = libMesh::NumericVector<Real>::build(__init->comm()).release();
+        _basis[i]->init(1, false, libMesh::SERIAL);
+        _basis[i]->add(0, 1.);
+        _basis[i]->close();
+    }
+}
+
+
+
+MAST::SyntheticFlutterAssembly::~SyntheticFlutterAssembly() {
+    
+    for (unsigned int i=0; i<_basis.size(); i++)
+        delete _basis[i];
+}
+
+
+
+void
+MAST::SyntheticFlutterAssembly::
+assemble_reduced_order_quantity
+(std::vector<libMesh::NumericVector<Real>*>& basis,
+ std::map<MAST::StructuralQuantityType, RealMatrixX*>& mat_qty_map) {
+    
+    MAST_LOG_SCOPE("assemble_reduced_order_quantity()", "SyntheticFlutterAssembly");
+    
+    libmesh_assert_equal_to(basis.size(), _n);
+    
+    n_structural_assemblies++;
+    
+    const Real
+    V   = _V(),
+    q   = 0.5*_rho*V*V;
+    
+    std::map<MAST::StructuralQuantityType, RealMatrixX*>::iterator
+    it   = mat_qty_map.begin(),
+    end  = mat_qty_map.end();
+    
+    for ( ; it != end; it++) {
+        
+        RealMatrixX& m = *it->second;
+        
+        switch (it->first) {
+                
+            case MAST::MASS:
+                m = RealMatrixX::Identity(_n, _n);
+                break;
+                
+            case MAST::DAMPING:
+                if (_aero_in_structural)
+                    m = 0.5*_rho*V*_A1;
+                else
+                    m = RealMatrixX::Zero(_n, _n);
+                break;
+                
+            case MAST::STIFFNESS:
+                if (_aero_in_structural)
+                    m = _K + q*_A0;
+                else
+                    m = _K;
+                break;
+                
+            default:
+                libmesh_error(); // should not get here
+        }
+    }
+}
+
+
+
+void
+MAST::SyntheticFlutterAssembly::
+assemble_generalized_aerodynamic_force_matrix
+(std::vector<libMesh::NumericVector<Real>*>& basis,
+ ComplexMatrixX& mat,
+ MAST::Parameter* p) {
+    
+    MAST_LOG_SCOPE("assemble_generalized_aerodynamic_force_matrix()",
+                   "SyntheticFlutterAssembly");
+    
+    libmesh_assert_equal_to(basis.size(), _n);
+    
+    n_gaf_assemblies++;
+    
+    const Complex
+    iota(0., 1.);
+    
+    // the sensitivity with respect to the reduced frequency is iA_1, and
+    // zero for all other parameters
+    if (p) {
+        
+        if (p == &_kr)
+            mat = iota * _A1.cast<Complex>();
+        else
+            mat = ComplexMatrixX::Zero(_n, _n);
+    }
+    else
+        mat = _A0.cast<Complex>() + iota * _kr() * _A1.cast<Complex>();
+}
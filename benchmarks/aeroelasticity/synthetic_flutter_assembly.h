@@ -0,0 +1,137 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2017  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+#ifndef __mast_benchmark_synthetic_flutter_assembly_h__
+#define __mast_benchmark_synthetic_flutter_assembly_h__
+
+// C++ includes
+#include <vector>
+
+// MAST includes
+#include "elasticity/fsi_generalized_aero_force_assembly.h"
+
+
+
+namespace MAST {
+    
+    // Forward declerations
+    class Parameter;
+    
+    
+    /*!
+     *   Provides synthetic reduced order matrices to the flutter solvers,
+     *   so that the solvers can be timed for a large number of modes
+     *   without a finite element model. The model has a unit mass matrix,
+     *   a diagonal stiffness matrix with uncoupled frequencies
+     *   \f$ \omega_i = \omega_0 (i+1) \f$, and a generalized aerodynamic
+     *   force matrix \f$ A(k) = A_0 + i k A_1 \f$, where \f$ A_0 \f$
+     *   couples successive pairs of modes with opposite signs, as in
+     *   piston theory, and \f$ A_1 \f$ is a diagonal damping. For the
+     *   time domain solver, the piston theory terms are added to the
+     *   stiffness, \f$ q A_0 \f$, and damping, \f$ q A_1 / V \f$, with
+     *   \f$ q = \rho V^2/2 \f$. No discipline or system is attached, so
+     *   the reduced structural cache of the solvers must be turned off.
+     */
+    class SyntheticFlutterAssembly:
+    public MAST::FSIGeneralizedAeroForceAssembly {
+        
+    public:
+        
+        /*!
+         *   \p n is the number of modes. The velocity and reduced frequency
+         *   are read from \p V and \p kr.
+         */
+        SyntheticFlutterAssembly(unsigned int n,
+                                 MAST::Parameter& V,
+                                 MAST::Parameter& kr,
+                                 Real rho);
+        
+        
+        virtual ~SyntheticFlutterAssembly();
+        
+        
+        /*!
+         *   if \p f is true, the piston theory terms are included in the
+         *   reduced damping and stiffness matrices. This is used for the
+         *   time domain solver.
+         */
+        void set_aero_in_structural_matrices(bool f) {
+            _aero_in_structural = f;
+        }
+        
+        
+        /*!
+         *   @returns the basis, which has \p n vectors of unit length
+         *   and is only used for its size by the flutter solvers
+         */
+        std::vector<libMesh::NumericVector<Real>*>& basis() {
+            return _basis;
+        }
+        
+        
+        virtual void
+        assemble_reduced_order_quantity
+        (std::vector<libMesh::NumericVector<Real>*>& basis,
+         std::map<MAST::StructuralQuantityType, RealMatrixX*>& mat_qty_map);
+        
+        
+        virtual void
+        assemble_generalized_aerodynamic_force_matrix
+        (std::vector<libMesh::NumericVector<Real>*>& basis,
+         ComplexMatrixX& mat,
+         MAST::Parameter* p = nullptr);
+        
+        
+        /*!
+         *   number of calls to the respective assembly routines
+         */
+        unsigned int n_structural_assemblies;
+        
+        unsigned int n_gaf_assemblies;
+        
+    protected:
+        
+        /*!
+         *   number of modes
+         */
+        const unsigned int  _n;
+        
+        /*!
+         *   velocity and reduced frequency parameters, and the flow density
+         */
+        MAST::Parameter&    _V;
+        
+        MAST::Parameter&    _kr;
+        
+        const Real          _rho;
+        
+        bool                _aero_in_structural;
+        
+        /*!
+         *   stiffness and aerodynamic matrices
+         */
+        RealMatrixX         _K, _A0, _A1;
+        
+        std::vector<libMesh::NumericVector<Real>*> _basis;
+    };
+}
+
+
+#endif // __mast_benchmark_synthetic_flutter_assembly_h__
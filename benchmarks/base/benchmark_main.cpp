@@ -0,0 +1,137 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2017  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+// C++ includes
+#include <iostream>
+
+
+// MAST includes
+#include "benchmarks/base/kernel_timer.h"
+#include "benchmarks/structural/structural_scaling_benchmark.h"
+#include "benchmarks/aeroelasticity/flutter_solver_benchmark.h"
+
+
+// libMesh includes
+#include "libmesh/libmesh.h"
+
+
+// the element builders of the tests refer to this object
+libMesh::LibMeshInit     *__init         = nullptr;
+
+
+//
+//   times the element kernels on single element meshes. The options are
+//     --min_time <s>     minimum time over which each kernel is timed
+//     --filter <name>    only times the kernels whose name or case
+//                        contains this string
+//
+//   With --scaling, the phases of a structural analysis are timed
+//   instead, and appended to a CSV file for scaling studies. The
+//   processor count is set by the MPI launcher, and the thread count
+//   with --n_threads. The options are
+//     --model <plate|panel_3d>   model type (plate)
+//     --n_elems <n>              number of elements (10000)
+//     --weak                     n_elems is the number per processor
+//     --n_stiff <n>              number of stiffeners of the plate (0)
+//     --n_z_divs <n>             elements through panel thickness (2)
+//     --n_eig <n>                number of eigenvalues (5)
+//     --n_repeat <n>             repetitions of the assemblies (5)
+//     --csv <file>               output file (scaling.csv)
+//
+//   With --flutter, the flutter solvers are timed on synthetic reduced
+//   order models, and optionally on the finite element examples. The
+//   results are appended to a CSV file. The options are
+//     --n_modes <n>              number of modes of the synthetic model.
+//                                If not given, 10, 100 and 500 modes
+//                                are used.
+//     --piston_theory            also times the piston theory plate
+//     --euler_fsi                also times the Euler FSI beam, which
+//                                reads input.in
+//     --n_divs <n>               divisions of the scanned range (10)
+//     --csv <file>               output file (flutter_benchmark.csv)
+//
+int main(int argc, char* argv[]) {
+    
+    __init = new libMesh::LibMeshInit(argc, argv);
+    
+    if (libMesh::on_command_line("--flutter")) {
+        
+        MAST::FlutterSolverBenchmark b;
+        b.n_divs   = libMesh::command_line_value("--n_divs", b.n_divs);
+        b.csv_file = libMesh::command_line_value("--csv",    b.csv_file);
+        
+        if (libMesh::on_command_line("--n_modes"))
+            b.run_synthetic(libMesh::command_line_value("--n_modes", 10U));
+        else {
+            
+            const unsigned int
+            n_modes[] = {10, 100, 500};
+            
+            for (unsigned int i=0; i<3; i++)
+                b.run_synthetic(n_modes[i]);
+        }
+        
+        if (libMesh::on_command_line("--piston_theory"))
+            b.run_piston_theory();
+        
+        if (libMesh::on_command_line("--euler_fsi"))
+            b.run_euler_fsi();
+    }
+    else if (libMesh::on_command_line("--scaling")) {
+        
+        const std::string
+        model = libMesh::command_line_value("--model", std::string("plate"));
+        
+        MAST::StructuralScalingBenchmark b;
+        
+        if (model == "plate")
+            b.model = MAST::StructuralScalingBenchmark::PLATE;
+        else if (model == "panel_3d")
+            b.model = MAST::StructuralScalingBenchmark::PANEL_3D;
+        else
+            libmesh_error_msg("Invalid model: " << model);
+        
+        b.n_elems      = libMesh::command_line_value("--n_elems",  b.n_elems);
+        b.weak_scaling = libMesh::on_command_line("--weak");
+        b.n_stiff      = libMesh::command_line_value("--n_stiff",  b.n_stiff);
+        b.n_z_divs     = libMesh::command_line_value("--n_z_divs", b.n_z_divs);
+        b.n_eig        = libMesh::command_line_value("--n_eig",    b.n_eig);
+        b.n_repeat     = libMesh::command_line_value("--n_repeat", b.n_repeat);
+        b.csv_file     = libMesh::command_line_value("--csv",      b.csv_file);
+        
+        b.run();
+    }
+    else {
+        
+        MAST::KernelTimer timer;
+        timer.min_time = libMesh::command_line_value("--min_time", 0.2);
+        timer.filter   = libMesh::command_line_value("--filter", std::string());
+        
+        timer.print_header();
+        
+        MAST::fem_operator_matrix_benchmarks(timer);
+        MAST::structural_element_benchmarks(timer);
+        MAST::fluid_flux_benchmarks(timer);
+    }
+    
+    delete __init;
+    
+    return 0;
+}
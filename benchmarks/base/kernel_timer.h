@@ -0,0 +1,163 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2017  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+#ifndef __mast_benchmark_kernel_timer_h__
+#define __mast_benchmark_kernel_timer_h__
+
+// C++ includes
+#include <string>
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+
+// MAST includes
+#include "base/mast_data_types.h"
+
+
+namespace MAST {
+    
+    /*!
+     *   Times a kernel by calling it repeatedly until the elapsed time
+     *   exceeds a minimum. The number of calls is doubled after each
+     *   timed batch, and one untimed call is made before the timing to
+     *   initialize any data cached by the kernel. The time per call is
+     *   printed in ns, along with the GFLOP/s if the number of floating
+     *   point operations of a call is provided.
+     */
+    class KernelTimer {
+        
+    public:
+        
+        KernelTimer(std::ostream& out = std::cout):
+        min_time  (0.2),
+        filter    (),
+        _out      (out) { }
+        
+        
+        /*!
+         *   minimum time in seconds over which a kernel is timed
+         */
+        Real min_time;
+        
+        /*!
+         *   if not empty, only the kernels whose name or case contains
+         *   this string are timed
+         */
+        std::string filter;
+        
+        
+        /*!
+         *   prints the header of the table of results
+         */
+        void print_header() {
+            
+            _out
+            << std::setw(30) << std::left << "kernel"
+            << std::setw(30) << std::left << "case"
+            << std::setw(12) << std::right << "calls"
+            << std::setw(15) << std::right << "ns/elem"
+            << std::setw(12) << std::right << "GFLOP/s"
+            << std::endl;
+        }
+        
+        
+        /*!
+         *   times \p k, which evaluates the kernel for one element, and
+         *   prints the results under the names \p kernel and \p case_nm.
+         *   \p flops is the number of floating point operations of one
+         *   call, or zero if this is not known.
+         */
+        template <typename Kernel>
+        void run(const std::string& kernel,
+                 const std::string& case_nm,
+                 Real flops,
+                 Kernel k) {
+            
+            if (!filter.empty() &&
+                kernel.find(filter)  == std::string::npos &&
+                case_nm.find(filter) == std::string::npos)
+                return;
+            
+            // untimed call
+            k();
+            
+            unsigned long long
+            n_calls = 0,
+            n_batch = 1;
+            
+            Real
+            t       = 0.;
+            
+            while (t < min_time) {
+                
+                std::chrono::high_resolution_clock::time_point
+                t0 = std::chrono::high_resolution_clock::now();
+                
+                for (unsigned long long i=0; i<n_batch; i++)
+                    k();
+                
+                std::chrono::high_resolution_clock::time_point
+                t1 = std::chrono::high_resolution_clock::now();
+                
+                t       += std::chrono::duration<Real>(t1-t0).count();
+                n_calls += n_batch;
+                n_batch *= 2;
+            }
+            
+            const Real
+            ns = t*1.e9/n_calls;
+            
+            _out
+            << std::setw(30) << std::left  << kernel
+            << std::setw(30) << std::left  << case_nm
+            << std::setw(12) << std::right << n_calls
+            << std::setw(15) << std::right << std::fixed << std::setprecision(1) << ns;
+            
+            // flops per ns is the same as GFLOP/s
+            if (flops > 0.)
+                _out << std::setw(12) << std::right << std::setprecision(3) << flops/ns;
+            else
+                _out << std::setw(12) << std::right << "-";
+            
+            _out << std::endl;
+        }
+        
+    protected:
+        
+        /*!
+         *   stream to which the results are printed
+         */
+        std::ostream& _out;
+    };
+    
+    
+    /*!
+     *   benchmarks of the element kernels, which are defined in the
+     *   respective files of the benchmark directory
+     */
+    void structural_element_benchmarks(MAST::KernelTimer& timer);
+    
+    void fluid_flux_benchmarks(MAST::KernelTimer& timer);
+    
+    void fem_operator_matrix_benchmarks(MAST::KernelTimer& timer);
+}
+
+
+#endif // __mast_benchmark_kernel_timer_h__
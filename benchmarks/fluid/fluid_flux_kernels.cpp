@@ -0,0 +1,159 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2017  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+// C++ includes
+#include <vector>
+#include <sstream>
+
+
+// MAST includes
+#include "benchmarks/base/kernel_timer.h"
+#include "tests/fluid/build_conservative_fluid_elem.h"
+#include "fluid/conservative_fluid_element_base.h"
+#include "fluid/conservative_fluid_discipline.h"
+#include "fluid/conservative_fluid_system_initialization.h"
+#include "fluid/primitive_fluid_solution.h"
+#include "fluid/primitive_fluid_solution_batch.h"
+#include "fluid/flight_condition.h"
+
+
+
+void
+MAST::fluid_flux_benchmarks(MAST::KernelTimer& timer) {
+    
+    MAST::BuildConservativeFluidElem v;
+    
+    // make sure there is only one element in the mesh.
+    libmesh_assert_equal_to(v._mesh->n_elem(), 1);
+    libMesh::Elem& e = **v._mesh->local_elements_begin();
+    
+    const MAST::FlightCondition& p =
+    dynamic_cast<MAST::ConservativeFluidDiscipline*>(v._discipline)->flight_condition();
+    
+    std::auto_ptr<MAST::ConservativeFluidElementBase>
+    elem(new MAST::ConservativeFluidElementBase(*v._fluid_sys, e, p));
+    
+    // the 2D elem has 4 variables and 4 nodes
+    const unsigned int
+    dim      = 2,
+    n_vars   = dim+2,
+    ndofs    = 16;
+    
+    RealVectorX
+    x_base   = RealVectorX::Zero(ndofs),
+    res      = RealVectorX::Zero(ndofs);
+    
+    RealMatrixX
+    jac_x    = RealMatrixX::Zero(ndofs, ndofs),
+    dummy;
+    
+    // set velocity to be zero
+    elem->set_velocity(x_base);
+    
+    // the base solution with a small perturbation at each node
+    for (unsigned int i=0; i<n_vars; i++)
+        for (unsigned int j=0; j<4; j++)
+            x_base(i*4+j) = v._base_sol(i) * (1. + 1.e-2 * j);
+    
+    elem->set_solution(x_base);
+    
+    timer.run("fluid_internal_residual", "QUAD4, inviscid", 0.,
+              [&]() {
+                  res.setZero();
+                  elem->internal_residual(false, res, dummy);
+              });
+    
+    timer.run("fluid_internal_residual+jac", "QUAD4, inviscid", 0.,
+              [&]() {
+                  res.setZero();
+                  jac_x.setZero();
+                  elem->internal_residual(true, res, jac_x);
+              });
+    
+    // flux Jacobians at a point
+    const Real
+    cp   = p.gas_property.cp,
+    cv   = p.gas_property.cv;
+    
+    MAST::PrimitiveSolution
+    sol;
+    sol.init(dim, v._base_sol, cp, cv, false);
+    
+    RealMatrixX
+    A    = RealMatrixX::Zero(n_vars, n_vars);
+    
+    timer.run("advection_flux_jacobian", "2D, 1 point", 0.,
+              [&]() {
+                  for (unsigned int i=0; i<dim; i++)
+                      elem->calculate_advection_flux_jacobian(i, sol, A);
+              });
+    
+    // the same for a batch of points, for the number of quadrature
+    // points of the linear and quadratic quadrilaterals
+    const unsigned int
+    n_pts[] = {4, 9};
+    
+    for (unsigned int n=0; n<2; n++) {
+        
+        RealMatrixX
+        cons_sol = RealMatrixX::Zero(n_vars, n_pts[n]);
+        
+        for (unsigned int q=0; q<n_pts[n]; q++)
+            cons_sol.col(q) = v._base_sol * (1. + 1.e-2 * q);
+        
+        std::vector<MAST::PrimitiveSolution>
+        sols(n_pts[n]);
+        
+        for (unsigned int q=0; q<n_pts[n]; q++)
+            sols[q].init(dim, RealVectorX(cons_sol.col(q)), cp, cv, false);
+        
+        std::vector<std::vector<RealMatrixX> >
+        A_batch;
+        
+        std::ostringstream case_nm;
+        case_nm << "2D, " << n_pts[n] << " points";
+        
+        timer.run("advection_flux_jacobian", case_nm.str(), 0.,
+                  [&]() {
+                      for (unsigned int q=0; q<n_pts[n]; q++)
+                          for (unsigned int i=0; i<dim; i++)
+                              elem->calculate_advection_flux_jacobian(i, sols[q], A);
+                  });
+        
+        timer.run("advection_flux_jacobian_batch", case_nm.str(), 0.,
+                  [&]() {
+                      elem->calculate_advection_flux_jacobian(sols, A_batch);
+                  });
+        
+        MAST::PrimitiveSolutionBatch
+        batch;
+        
+        timer.run("primitive_solution_batch", case_nm.str(), 0.,
+                  [&]() {
+                      batch.init(dim, cons_sol, cp, cv, false);
+                  });
+        
+        timer.run("primitive_solution", case_nm.str(), 0.,
+                  [&]() {
+                      for (unsigned int q=0; q<n_pts[n]; q++)
+                          sols[q].init(dim, RealVectorX(cons_sol.col(q)), cp, cv, false);
+                  });
+    }
+}
@@ -0,0 +1,114 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2017  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+// C++ includes
+#include <sstream>
+
+
+// MAST includes
+#include "benchmarks/base/kernel_timer.h"
+#include "numerics/fem_operator_matrix.h"
+
+
+
+namespace MAST {
+    
+    /*!
+     *   initializes \p b as the membrane strain operator of a 2D element
+     *   with \p nphi shape functions, which has the non-zero blocks
+     *   (0, u), (1, v), (2, u) and (2, v)
+     */
+    void
+    membrane_strain_operator(unsigned int nphi,
+                             MAST::FEMOperatorMatrix& b) {
+        
+        RealVectorX
+        dphidx = RealVectorX::Random(nphi),
+        dphidy = RealVectorX::Random(nphi);
+        
+        b.reinit(3, 2, nphi);
+        b.set_shape_function(0, 0, dphidx);
+        b.set_shape_function(1, 1, dphidy);
+        b.set_shape_function(2, 0, dphidy);
+        b.set_shape_function(2, 1, dphidx);
+    }
+}
+
+
+
+void
+MAST::fem_operator_matrix_benchmarks(MAST::KernelTimer& timer) {
+    
+    // number of shape functions of a QUAD4, QUAD9 and a HEX27
+    const unsigned int
+    nphi_vals[] = {4, 9, 27};
+    
+    // number of non-zero blocks of the operator, and number of pairs of
+    // blocks in B^T D B with a full D
+    const Real
+    nb      = 4.,
+    n_pairs = 16.;
+    
+    for (unsigned int i=0; i<3; i++) {
+        
+        const unsigned int
+        nphi = nphi_vals[i],
+        n    = 2*nphi;
+        
+        std::ostringstream nm;
+        nm << "membrane strain, nphi=" << nphi;
+        
+        MAST::FEMOperatorMatrix b;
+        MAST::membrane_strain_operator(nphi, b);
+        
+        RealVectorX
+        v_n   = RealVectorX::Random(n),
+        v_3   = RealVectorX::Random(3),
+        res_n = RealVectorX::Zero(n),
+        res_3 = RealVectorX::Zero(3);
+        
+        RealMatrixX
+        d     = RealMatrixX::Random(3, 3),
+        db    = RealMatrixX::Zero(3, n),
+        btdb  = RealMatrixX::Zero(n, n);
+        
+        // the counts are the operations on the non-zero blocks
+        timer.run("FEMOperator::vector_mult", nm.str(), 2.*nb*nphi,
+                  [&]() { b.vector_mult(res_3, v_n); });
+        
+        timer.run("FEMOperator::vector_mult_T", nm.str(), 2.*nb*nphi,
+                  [&]() { b.vector_mult_transpose(res_n, v_3); });
+        
+        timer.run("FEMOperator::left_multiply", nm.str(), 2.*3.*nb*nphi,
+                  [&]() { b.left_multiply(db, d); });
+        
+        timer.run("FEMOperator::right_mult_T", nm.str(), 2.*nb*nphi*n,
+                  [&]() { b.right_multiply_transpose(btdb, db); });
+        
+        timer.run("FEMOperator::BtDB", nm.str(), 2.*3.*nb*nphi + 2.*nb*nphi*n,
+                  [&]() {
+                      b.left_multiply(db, d);
+                      b.right_multiply_transpose(btdb, db);
+                  });
+        
+        timer.run("FEMOperator::add_T_product", nm.str(), n_pairs*(2.*nphi*nphi+nphi),
+                  [&]() { b.add_transpose_product(btdb, 1., d, b); });
+    }
+}
@@ -0,0 +1,165 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2017  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+// MAST includes
+#include "benchmarks/structural/build_structural_elem_3D.h"
+#include "base/system_initialization.h"
+#include "elasticity/structural_discipline.h"
+#include "property_cards/isotropic_element_property_card_3D.h"
+#include "property_cards/isotropic_material_property_card.h"
+#include "base/parameter.h"
+#include "base/constant_field_function.h"
+#include "base/boundary_condition_base.h"
+#include "base/nonlinear_system.h"
+
+
+// libMesh includes
+#include "libmesh/mesh_generation.h"
+#include "libmesh/elem.h"
+#include "libmesh/fe_type.h"
+
+
+extern libMesh::LibMeshInit* __init;
+
+
+MAST::BuildStructural3DElem::BuildStructural3DElem():
+_initialized(false),
+_e_type(libMesh::INVALID_ELEM),
+_mesh(nullptr),
+_eq_sys(nullptr),
+_sys(nullptr),
+_structural_sys(nullptr),
+_discipline(nullptr),
+_E(nullptr),
+_nu(nullptr),
+_zero(nullptr),
+_temp(nullptr),
+_alpha(nullptr),
+_E_f(nullptr),
+_nu_f(nullptr),
+_temp_f(nullptr),
+_ref_temp_f(nullptr),
+_alpha_f(nullptr),
+_m_card(nullptr),
+_p_card(nullptr),
+_thermal_load(nullptr) {
+    
+}
+
+
+
+void
+MAST::BuildStructural3DElem::init(libMesh::ElemType e_type,
+                                  MAST::IntegrationScheme scheme) {
+    
+    // make sure that this has not already been initialized
+    libmesh_assert(!_initialized);
+    _e_type = e_type;
+    
+    // create the mesh
+    _mesh       = new libMesh::SerialMesh(__init->comm());
+    
+    // initialize the mesh with one element
+    libMesh::MeshTools::Generation::build_cube(*_mesh,
+                                               1, 1, 1,
+                                               0, 2,
+                                               0, 2,
+                                               0, 2,
+                                               e_type);
+    
+    // create the equation system
+    _eq_sys    = new  libMesh::EquationSystems(*_mesh);
+    
+    // create the libmesh system
+    _sys       = &(_eq_sys->add_system<MAST::NonlinearSystem>("structural"));
+    
+    // FEType to initialize the system, with the order of the element
+    libMesh::FEType
+    fetype ((**_mesh->elements_begin()).default_order(), libMesh::LAGRANGE);
+    
+    // initialize the system to the right set of variables
+    _structural_sys = new MAST::StructuralSystemInitializationUVW(*_sys,
+                                                                  _sys->name(),
+                                                                  fetype);
+    _discipline     = new MAST::StructuralDiscipline(*_eq_sys);
+    
+    // initialize the equation system
+    _eq_sys->init();
+    
+    // create the property functions
+    _E               = new MAST::Parameter(    "E",    72.e9);
+    _nu              = new MAST::Parameter(   "nu",     0.33);
+    _zero            = new MAST::Parameter( "zero",       0.);
+    _temp            = new MAST::Parameter("temp",       60.);
+    _alpha           = new MAST::Parameter("alpha",   2.5e-5);
+    
+    _E_f             = new MAST::ConstantFieldFunction(    "E",       *_E);
+    _nu_f            = new MAST::ConstantFieldFunction(   "nu",      *_nu);
+    _temp_f          = new MAST::ConstantFieldFunction("temperature", *_temp);
+    _ref_temp_f      = new MAST::ConstantFieldFunction("ref_temperature", *_zero);
+    _alpha_f         = new MAST::ConstantFieldFunction("alpha_expansion", *_alpha);
+    
+    // create the material property card
+    _m_card         = new MAST::IsotropicMaterialPropertyCard;
+    
+    // add the material properties to the card
+    _m_card->add(    *_E_f);
+    _m_card->add(   *_nu_f);
+    _m_card->add(*_alpha_f);
+    
+    // create the element property card
+    _p_card         = new MAST::IsotropicElementPropertyCard3D;
+    _p_card->set_material(*_m_card);
+    _p_card->set_integration_scheme(scheme);
+    
+    _thermal_load   = new MAST::BoundaryConditionBase(MAST::TEMPERATURE);
+    _thermal_load->add(*_temp_f);
+    _thermal_load->add(*_ref_temp_f);
+    
+    _initialized    = true;
+}
+
+
+
+MAST::BuildStructural3DElem::~BuildStructural3DElem() {
+    
+    delete _m_card;
+    delete _p_card;
+    
+    delete _thermal_load;
+    
+    delete _E_f;
+    delete _nu_f;
+    delete _temp_f;
+    delete _ref_temp_f;
+    delete _alpha_f;
+    
+    delete _E;
+    delete _nu;
+    delete _zero;
+    delete _temp;
+    delete _alpha;
+    
+    delete _eq_sys;
+    delete _mesh;
+    
+    delete _discipline;
+    delete _structural_sys;
+}
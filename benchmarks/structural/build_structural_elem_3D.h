@@ -0,0 +1,143 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2017  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+#ifndef __mast_benchmark_build_structural_element_3d_h__
+#define __mast_benchmark_build_structural_element_3d_h__
+
+// C++ includes
+#include <memory>
+
+// MAST includes
+#include "property_cards/element_property_card_base.h"
+#include "base/system_initialization.h"
+#include "base/nonlinear_system.h"
+
+// libMesh includes
+#include "libmesh/libmesh.h"
+#include "libmesh/equation_systems.h"
+#include "libmesh/serial_mesh.h"
+#include "libmesh/enum_elem_type.h"
+#include "libmesh/fe_type.h"
+
+
+
+namespace MAST {
+    
+    // Forward declerations
+    class StructuralDiscipline;
+    class Parameter;
+    class ConstantFieldFunction;
+    class IsotropicMaterialPropertyCard;
+    class IsotropicElementPropertyCard3D;
+    class BoundaryConditionBase;
+    
+    
+    /*!
+     *   displacement variables of the 3D solid elements
+     */
+    class StructuralSystemInitializationUVW:
+    public MAST::SystemInitialization  {
+        
+    public:
+        StructuralSystemInitializationUVW(MAST::NonlinearSystem& sys,
+                                          const std::string& prefix,
+                                          const libMesh::FEType& fe_type):
+        MAST::SystemInitialization(sys, prefix) {
+            
+            _vars.resize(3);
+            
+            std::string nm = prefix + "_ux";
+            _vars[0] = sys.add_variable(nm, fe_type);
+            
+            nm = prefix + "_uy";
+            _vars[1] = sys.add_variable(nm, fe_type);
+            
+            nm = prefix + "_uz";
+            _vars[2] = sys.add_variable(nm, fe_type);
+        }
+        
+        
+        virtual ~StructuralSystemInitializationUVW() { }
+    };
+    
+    
+    /*!
+     *   single 3D solid element, similar to the 1D and 2D elements of
+     *   the tests. The displacements are interpolated with the default
+     *   order of \p e_type.
+     */
+    struct BuildStructural3DElem {
+        
+        
+        BuildStructural3DElem();
+        
+        
+        ~BuildStructural3DElem();
+        
+        
+        void init(libMesh::ElemType e_type,
+                  MAST::IntegrationScheme scheme);
+        
+        
+        bool _initialized;
+        
+        libMesh::ElemType _e_type;
+        
+        // create the mesh
+        libMesh::SerialMesh*           _mesh;
+        
+        // create the equation system
+        libMesh::EquationSystems*      _eq_sys;
+        
+        // create the libmesh system
+        MAST::NonlinearSystem*  _sys;
+        
+        // initialize the system to the right set of variables
+        MAST::SystemInitialization*           _structural_sys;
+        MAST::StructuralDiscipline*           _discipline;
+        
+        // create the property functions and add them to the
+        MAST::Parameter
+        *_E,
+        *_nu,
+        *_zero,
+        *_temp,
+        *_alpha;
+        
+        MAST::ConstantFieldFunction
+        *_E_f,
+        *_nu_f,
+        *_temp_f,
+        *_ref_temp_f,
+        *_alpha_f;
+        
+        // create the material property card
+        MAST::IsotropicMaterialPropertyCard*     _m_card;
+        
+        // create the element property card
+        MAST::IsotropicElementPropertyCard3D*    _p_card;
+        
+        // create the temperature boundary condition
+        MAST::BoundaryConditionBase*            _thermal_load;
+    };
+}
+
+
+#endif // __mast_benchmark_build_structural_element_3d_h__
@@ -0,0 +1,234 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2017  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+// C++ includes
+#include <sstream>
+#include <map>
+
+
+// MAST includes
+#include "benchmarks/base/kernel_timer.h"
+#include "benchmarks/structural/build_structural_elem_3D.h"
+#include "tests/structural/build_structural_elem_1D.h"
+#include "tests/structural/build_structural_elem_2D.h"
+#include "property_cards/solid_1d_section_element_property_card.h"
+#include "property_cards/solid_2d_section_element_property_card.h"
+#include "property_cards/isotropic_element_property_card_3D.h"
+#include "elasticity/structural_system_initialization.h"
+#include "elasticity/structural_discipline.h"
+#include "elasticity/piston_theory_boundary_condition.h"
+#include "elasticity/structural_element_base.h"
+#include "elasticity/stress_output_base.h"
+#include "base/nonlinear_system.h"
+
+
+// libMesh includes
+#include "libmesh/dof_map.h"
+#include "libmesh/string_to_enum.h"
+
+
+
+namespace MAST {
+    
+    /*!
+     *   times the kernels of the element in the mesh of \p v. The piston
+     *   theory residual is timed only if \p if_piston_theory is true, and
+     *   the stress is evaluated at \p pt.
+     */
+    template <typename ValType>
+    void
+    benchmark_structural_element(MAST::KernelTimer& timer,
+                                 ValType& v,
+                                 const std::string& case_nm,
+                                 bool if_piston_theory,
+                                 const libMesh::Point& pt) {
+        
+        // get reference to the element in this mesh
+        const libMesh::Elem& elem = **(v._mesh->local_elements_begin());
+        
+        // now create the structural element
+        std::auto_ptr<MAST::StructuralElementBase>
+        e(MAST::build_structural_element(*v._structural_sys,
+                                         elem,
+                                         *v._p_card).release());
+        
+        // number of dofs in this element
+        const libMesh::DofMap& dofmap = v._sys->get_dof_map();
+        std::vector<libMesh::dof_id_type> dof_ids;
+        dofmap.dof_indices(&elem, dof_ids);
+        
+        const unsigned int ndofs = (unsigned int)dof_ids.size();
+        
+        // a small deformation, so that the nonlinear strain terms are
+        // non-zero
+        RealVectorX
+        x           = 1.e-3 * RealVectorX::Random(ndofs),
+        xdot        = RealVectorX::Zero(ndofs),
+        res         = RealVectorX::Zero(ndofs);
+        
+        RealMatrixX
+        jac_x       = RealMatrixX::Zero(ndofs, ndofs),
+        jac_xdot    = RealMatrixX::Zero(ndofs, ndofs),
+        dummy;
+        
+        e->set_solution(x);
+        e->set_velocity(xdot);
+        
+        timer.run("internal_residual", case_nm, 0.,
+                  [&]() {
+                      res.setZero();
+                      e->internal_residual(false, res, dummy);
+                  });
+        
+        timer.run("internal_residual+jac", case_nm, 0.,
+                  [&]() {
+                      res.setZero();
+                      jac_x.setZero();
+                      e->internal_residual(true, res, jac_x);
+                  });
+        
+        // the loads are timed one at a time
+        std::multimap<libMesh::subdomain_id_type, MAST::BoundaryConditionBase*>
+        loads;
+        
+        loads.insert(std::make_pair(0, v._thermal_load));
+        
+        timer.run("thermal_residual+jac", case_nm, 0.,
+                  [&]() {
+                      res.setZero();
+                      jac_x.setZero();
+                      e->volume_external_residual(true, res, jac_xdot, jac_x, loads);
+                  });
+        
+        if (if_piston_theory) {
+            
+            loads.clear();
+            loads.insert(std::make_pair(0, v._p_theory));
+            
+            timer.run("piston_theory_residual+jac", case_nm, 0.,
+                      [&]() {
+                          res.setZero();
+                          jac_x.setZero();
+                          jac_xdot.setZero();
+                          e->volume_external_residual(true, res, jac_xdot, jac_x, loads);
+                      });
+        }
+        
+        // stress at a point of the element
+        MAST::StressStrainOutputBase output;
+        std::vector<libMesh::Point> pts(1, pt);
+        output.set_points_for_evaluation(pts);
+        
+        std::multimap<libMesh::subdomain_id_type, MAST::OutputFunctionBase*>
+        output_map;
+        output_map.insert(std::make_pair(0, &output));
+        
+        timer.run("calculate_stress", case_nm, 0.,
+                  [&]() {
+                      e->volume_output_quantity(false, false, output_map);
+                      output.clear(false);
+                  });
+        
+        timer.run("calculate_stress+dX", case_nm, 0.,
+                  [&]() {
+                      e->volume_output_quantity(true, false, output_map);
+                      output.clear(false);
+                  });
+    }
+    
+    
+    
+    std::string
+    structural_case_name(libMesh::ElemType e_type,
+                         const std::string& model) {
+        
+        std::ostringstream nm;
+        nm << libMesh::Utility::enum_to_string<libMesh::ElemType>(e_type)
+        << ", " << model;
+        
+        return nm.str();
+    }
+}
+
+
+
+void
+MAST::structural_element_benchmarks(MAST::KernelTimer& timer) {
+    
+    // the stress of the 1D and 2D elements is evaluated on the upper
+    // surface at the element mid-point, and at the centroid of the
+    // 3D elements
+    const libMesh::Point
+    pt_1d_2d(0., 1., 0.),
+    pt_3d;
+    
+    const bool
+    strain_models[] = {false, true};
+    
+    const libMesh::ElemType
+    types_1d[] = {libMesh::EDGE2, libMesh::EDGE3},
+    types_2d[] = {libMesh::TRI3, libMesh::TRI6,
+                  libMesh::QUAD4, libMesh::QUAD8, libMesh::QUAD9},
+    types_3d[] = {libMesh::HEX8, libMesh::HEX27};
+    
+    for (unsigned int i=0; i<2; i++) {
+        
+        const std::string
+        model = strain_models[i]? "von Karman": "linear";
+        
+        for (unsigned int j=0; j<2; j++) {
+            
+            MAST::BuildStructural1DElem v;
+            v.init(false, strain_models[i], types_1d[j]);
+            
+            MAST::benchmark_structural_element
+            (timer, v, MAST::structural_case_name(types_1d[j], model), true, pt_1d_2d);
+        }
+        
+        for (unsigned int j=0; j<5; j++) {
+            
+            MAST::BuildStructural2DElem v;
+            v.init(false, strain_models[i], types_2d[j]);
+            
+            MAST::benchmark_structural_element
+            (timer, v, MAST::structural_case_name(types_2d[j], model), true, pt_1d_2d);
+        }
+    }
+    
+    // the solid elements use the nonlinear strain, with full and
+    // reduced integration
+    const MAST::IntegrationScheme
+    schemes[] = {MAST::FULL_INTEGRATION, MAST::REDUCED_INTEGRATION};
+    
+    for (unsigned int i=0; i<2; i++) {
+        
+        const std::string
+        model = (schemes[i] == MAST::FULL_INTEGRATION)? "full": "reduced";
+        
+        for (unsigned int j=0; j<2; j++) {
+            
+            MAST::BuildStructural3DElem v;
+            v.init(types_3d[j], schemes[i]);
+            
+            MAST::benchmark_structural_element
+            (timer, v, MAST::structural_case_name(types_3d[j], model), false, pt_3d);
+        }
+    }
+}
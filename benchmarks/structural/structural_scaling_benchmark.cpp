@@ -0,0 +1,543 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2017  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+// C++ includes
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <cmath>
+
+
+// MAST includes
+#include "benchmarks/structural/structural_scaling_benchmark.h"
+#include "benchmarks/structural/build_structural_elem_3D.h"
+#include "examples/structural/base/blade_stiffened_panel_mesh.h"
+#include "elasticity/structural_system_initialization.h"
+#include "elasticity/structural_nonlinear_assembly.h"
+#include "elasticity/structural_modal_eigenproblem_assembly.h"
+#include "elasticity/structural_discipline.h"
+#include "elasticity/stress_output_base.h"
+#include "base/parameter.h"
+#include "base/constant_field_function.h"
+#include "base/boundary_condition_base.h"
+#include "base/nonlinear_system.h"
+#include "property_cards/solid_2d_section_element_property_card.h"
+#include "property_cards/isotropic_element_property_card_3D.h"
+#include "property_cards/isotropic_material_property_card.h"
+#include "boundary_condition/dirichlet_boundary_condition.h"
+#include "solver/slepc_eigen_solver.h"
+
+
+// libMesh includes
+#include "libmesh/mesh_generation.h"
+#include "libmesh/numeric_vector.h"
+#include "libmesh/parameter_vector.h"
+#include "libmesh/petsc_matrix.h"
+#include "libmesh/petsc_vector.h"
+
+
+// PETSc includes
+#include <petscksp.h>
+
+
+extern libMesh::LibMeshInit* __init;
+
+
+MAST::StructuralScalingBenchmark::StructuralScalingBenchmark():
+model           (MAST::StructuralScalingBenchmark::PLATE),
+n_elems         (10000),
+weak_scaling    (false),
+n_stiff         (0),
+n_z_divs        (2),
+n_eig           (5),
+n_repeat        (5),
+csv_file        ("scaling.csv"),
+_mesh           (nullptr),
+_eq_sys         (nullptr),
+_sys            (nullptr),
+_structural_sys (nullptr),
+_discipline     (nullptr),
+_E              (nullptr),
+_p_load         (nullptr),
+_m_card         (nullptr),
+_p_card         (nullptr),
+_output         (nullptr) {
+    
+}
+
+
+
+MAST::StructuralScalingBenchmark::~StructuralScalingBenchmark() {
+    
+    this->_clear();
+}
+
+
+
+void
+MAST::StructuralScalingBenchmark::run() {
+    
+    this->_clear();
+    _phases.clear();
+    
+    this->_start_phase();
+    this->_build_mesh();
+    this->_end_phase("mesh_setup");
+    
+    this->_start_phase();
+    this->_init_system();
+    this->_end_phase("dof_distribution");
+    
+    libMesh::out
+    << "Model: " << (model == PLATE? "plate": "panel_3d")
+    << ", elements: " << _mesh->n_elem()
+    << ", dofs: "     << _sys->n_dofs()
+    << ", processors: " << _mesh->comm().size()
+    << ", threads: "  << libMesh::n_threads() << std::endl;
+    
+    MAST::StructuralNonlinearAssembly assembly;
+    assembly.set_threaded_assembly(libMesh::n_threads() > 1);
+    assembly.attach_discipline_and_system(*_discipline, *_structural_sys);
+    
+    MAST::NonlinearSystem& sys = assembly.system();
+    
+    libMesh::NumericVector<Real>
+    &X   = *sys.solution,
+    &R   = *sys.rhs;
+    libMesh::SparseMatrix<Real>
+    &J   = *sys.matrix;
+    
+    X.zero();
+    X.close();
+    
+    // residual and Jacobian assemblies
+    this->_start_phase();
+    for (unsigned int i=0; i<n_repeat; i++)
+        assembly.residual_and_jacobian(X, &R, nullptr, sys);
+    this->_end_phase("residual_assembly", n_repeat);
+    
+    this->_start_phase();
+    for (unsigned int i=0; i<n_repeat; i++)
+        assembly.residual_and_jacobian(X, nullptr, &J, sys);
+    this->_end_phase("jacobian_assembly", n_repeat);
+    
+    // the linear solve with the assembled Jacobian uses the KSP and PC
+    // specified on the command line
+    assembly.residual_and_jacobian(X, &R, nullptr, sys);
+    
+    {
+        libMesh::PetscMatrix<Real>&
+        mat = dynamic_cast<libMesh::PetscMatrix<Real>&>(J);
+        libMesh::PetscVector<Real>
+        &res = dynamic_cast<libMesh::PetscVector<Real>&>(R),
+        &sol = dynamic_cast<libMesh::PetscVector<Real>&>(X);
+        
+        PetscErrorCode ierr;
+        KSP            ksp;
+        
+        this->_start_phase();
+        
+        ierr = KSPCreate(sys.comm().get(), &ksp);        CHKERRABORT(sys.comm().get(), ierr);
+        ierr = KSPSetOperators(ksp, mat.mat(), mat.mat()); CHKERRABORT(sys.comm().get(), ierr);
+        ierr = KSPSetFromOptions(ksp);                   CHKERRABORT(sys.comm().get(), ierr);
+        ierr = KSPSolve(ksp, res.vec(), sol.vec());      CHKERRABORT(sys.comm().get(), ierr);
+        
+        this->_end_phase("linear_solve");
+        
+        PetscInt n_its = 0;
+        ierr = KSPGetIterationNumber(ksp, &n_its);       CHKERRABORT(sys.comm().get(), ierr);
+        ierr = KSPDestroy(&ksp);                         CHKERRABORT(sys.comm().get(), ierr);
+        
+        libMesh::out << "Linear solver iterations: " << n_its << std::endl;
+        
+        // J dX = -R at X = 0
+        X.scale(-1.);
+        X.close();
+        sys.update();
+    }
+    
+    // stresses of all elements
+    this->_start_phase();
+    assembly.calculate_outputs(X);
+    this->_end_phase("stress_output");
+    
+    // sensitivity of the solution and stresses with respect to the
+    // Young's modulus
+    _discipline->add_parameter(*_E);
+    
+    libMesh::ParameterVector params;
+    params.resize(1);
+    params[0]  =  _E->ptr();
+    
+    sys.add_sensitivity_solution(0).zero();
+    
+    this->_start_phase();
+    sys.sensitivity_solve(params);
+    assembly.calculate_output_sensitivity(params, true, X);
+    this->_end_phase("sensitivity");
+    
+    _discipline->remove_parameter(*_E);
+    assembly.clear_discipline_and_system();
+    
+    // modal analysis
+    MAST::StructuralModalEigenproblemAssembly eig_assembly;
+    _sys->initialize_condensed_dofs(*_discipline);
+    eig_assembly.attach_discipline_and_system(*_discipline, *_structural_sys);
+    
+    this->_start_phase();
+    _sys->eigenproblem_solve();
+    this->_end_phase("eigen_solve");
+    
+    eig_assembly.clear_discipline_and_system();
+    
+    this->_write_csv();
+}
+
+
+
+void
+MAST::StructuralScalingBenchmark::_start_phase() {
+    
+    __init->comm().barrier();
+    _t0 = std::chrono::high_resolution_clock::now();
+}
+
+
+
+void
+MAST::StructuralScalingBenchmark::_end_phase(const std::string& nm,
+                                             unsigned int n) {
+    
+    libmesh_assert_greater(n, 0);
+    
+    std::chrono::high_resolution_clock::time_point
+    t1 = std::chrono::high_resolution_clock::now();
+    
+    const libMesh::Parallel::Communicator&
+    comm = __init->comm();
+    
+    PhaseTime p;
+    p.name   = nm;
+    p.t_min  = std::chrono::duration<Real>(t1-_t0).count()/n;
+    p.t_max  = p.t_min;
+    p.t_mean = p.t_min;
+    
+    comm.min(p.t_min);
+    comm.max(p.t_max);
+    comm.sum(p.t_mean);
+    p.t_mean /= comm.size();
+    
+    _phases.push_back(p);
+    
+    libMesh::out
+    << std::setw(20) << std::left << nm
+    << std::setw(15) << std::right << std::scientific << std::setprecision(4) << p.t_min
+    << std::setw(15) << std::right << p.t_mean
+    << std::setw(15) << std::right << p.t_max << std::endl;
+}
+
+
+
+void
+MAST::StructuralScalingBenchmark::_build_mesh() {
+    
+    const Real
+    length   = 0.5,
+    width    = 0.5,
+    th       = 0.01;
+    
+    // total number of elements
+    const unsigned int
+    n_total  = weak_scaling? n_elems * __init->comm().size(): n_elems;
+    
+    switch (model) {
+            
+        case MAST::StructuralScalingBenchmark::PLATE: {
+            
+            const unsigned int
+            nx = std::max(1, (int)std::floor(std::sqrt((Real)n_total) + 0.5));
+            
+            if (n_stiff) {
+                
+                _mesh = new libMesh::SerialMesh(__init->comm());
+                
+                MAST::StiffenedPanelMesh panel_mesh;
+                panel_mesh.init(n_stiff,
+                                nx,
+                                std::max(1U, nx/(n_stiff+1)),
+                                length,
+                                width,
+                                *_mesh,
+                                libMesh::QUAD4,
+                                false,
+                                std::max(1U, nx/20),
+                                0.02);
+            }
+            else {
+                
+                _mesh = new libMesh::ParallelMesh(__init->comm());
+                
+                libMesh::MeshTools::Generation::build_square(*_mesh,
+                                                             nx, nx,
+                                                             0., length,
+                                                             0., width,
+                                                             libMesh::QUAD4);
+            }
+        }
+            break;
+            
+        case MAST::StructuralScalingBenchmark::PANEL_3D: {
+            
+            libmesh_assert_greater(n_z_divs, 0);
+            
+            const unsigned int
+            nx = std::max(1, (int)std::floor(std::sqrt((Real)n_total/n_z_divs) + 0.5));
+            
+            _mesh = new libMesh::ParallelMesh(__init->comm());
+            
+            libMesh::MeshTools::Generation::build_cube(*_mesh,
+                                                       nx, nx, n_z_divs,
+                                                       0., length,
+                                                       0., width,
+                                                       0., th,
+                                                       libMesh::HEX8);
+        }
+            break;
+            
+        default:
+            libmesh_error();
+    }
+}
+
+
+
+void
+MAST::StructuralScalingBenchmark::_init_system() {
+    
+    _eq_sys    = new libMesh::EquationSystems(*_mesh);
+    _sys       = &(_eq_sys->add_system<MAST::NonlinearSystem>("structural"));
+    _sys->set_eigenproblem_type(libMesh::GHEP);
+    
+    libMesh::FEType fetype (libMesh::FIRST, libMesh::LAGRANGE);
+    
+    // the boundaries of the plate are 0 to 3. For the 3D panel, these are
+    // the sides 1 to 4, and the pressure is applied on the upper surface 5
+    std::vector<libMesh::boundary_id_type> bids;
+    
+    if (model == MAST::StructuralScalingBenchmark::PLATE) {
+        
+        _structural_sys = new MAST::StructuralSystemInitialization(*_sys,
+                                                                   _sys->name(),
+                                                                   fetype);
+        for (unsigned int i=0; i<4; i++) bids.push_back(i);
+    }
+    else {
+        
+        _structural_sys = new MAST::StructuralSystemInitializationUVW(*_sys,
+                                                                      _sys->name(),
+                                                                      fetype);
+        for (unsigned int i=1; i<5; i++) bids.push_back(i);
+    }
+    
+    _discipline     = new MAST::StructuralDiscipline(*_eq_sys);
+    
+    for (unsigned int i=0; i<bids.size(); i++) {
+        
+        MAST::DirichletBoundaryCondition* bc = new MAST::DirichletBoundaryCondition;
+        bc->init(bids[i], _structural_sys->vars());
+        _discipline->add_dirichlet_bc(bids[i], *bc);
+        _dirichlet.push_back(bc);
+    }
+    _discipline->init_system_dirichlet_bc(*_sys);
+    
+    _eq_sys->init();
+    
+    _sys->eigen_solver->set_position_of_spectrum(libMesh::LARGEST_MAGNITUDE);
+    _sys->set_exchange_A_and_B(true);
+    _sys->set_n_requested_eigenvalues(n_eig);
+    
+    // properties
+    MAST::Parameter
+    *th     = new MAST::Parameter("th",    0.01),
+    *nu     = new MAST::Parameter("nu",     0.3),
+    *rho    = new MAST::Parameter("rho",  2.8e3),
+    *kappa  = new MAST::Parameter("kappa", 5./6.),
+    *zero   = new MAST::Parameter("zero",    0.),
+    *press  = new MAST::Parameter("p",      1.e5);
+    _E      = new MAST::Parameter("E",    72.e9);
+    
+    _params.push_back(th);
+    _params.push_back(nu);
+    _params.push_back(rho);
+    _params.push_back(kappa);
+    _params.push_back(zero);
+    _params.push_back(press);
+    _params.push_back(_E);
+    
+    MAST::ConstantFieldFunction
+    *th_f     = new MAST::ConstantFieldFunction("h",             *th),
+    *E_f      = new MAST::ConstantFieldFunction("E",             *_E),
+    *nu_f     = new MAST::ConstantFieldFunction("nu",            *nu),
+    *rho_f    = new MAST::ConstantFieldFunction("rho",          *rho),
+    *kappa_f  = new MAST::ConstantFieldFunction("kappa",      *kappa),
+    *hoff_f   = new MAST::ConstantFieldFunction("off",         *zero),
+    *press_f  = new MAST::ConstantFieldFunction("pressure",   *press);
+    
+    _functions.push_back(th_f);
+    _functions.push_back(E_f);
+    _functions.push_back(nu_f);
+    _functions.push_back(rho_f);
+    _functions.push_back(kappa_f);
+    _functions.push_back(hoff_f);
+    _functions.push_back(press_f);
+    
+    _p_load          = new MAST::BoundaryConditionBase(MAST::SURFACE_PRESSURE);
+    _p_load->add(*press_f);
+    
+    _m_card          = new MAST::IsotropicMaterialPropertyCard;
+    _m_card->add(*E_f);
+    _m_card->add(*nu_f);
+    _m_card->add(*rho_f);
+    _m_card->add(*kappa_f);
+    
+    // stresses are evaluated on the upper skin at the center of the
+    // shell elements, and at the centroid of the solid elements
+    std::vector<libMesh::Point> pts(1);
+    
+    if (model == MAST::StructuralScalingBenchmark::PLATE) {
+        
+        MAST::Solid2DSectionElementPropertyCard*
+        p_card = new MAST::Solid2DSectionElementPropertyCard;
+        p_card->add(*th_f);
+        p_card->add(*hoff_f);
+        p_card->set_material(*_m_card);
+        _p_card = p_card;
+        
+        // the skin is subdomain 0, and the stiffeners 1 to n_stiff
+        for (unsigned int i=0; i<=n_stiff; i++)
+            _discipline->set_property_for_subdomain(i, *_p_card);
+        
+        _discipline->add_volume_load(0, *_p_load);
+        
+        pts[0] = libMesh::Point(0., 0., 1.);
+    }
+    else {
+        
+        MAST::IsotropicElementPropertyCard3D*
+        p_card = new MAST::IsotropicElementPropertyCard3D;
+        p_card->set_material(*_m_card);
+        _p_card = p_card;
+        
+        _discipline->set_property_for_subdomain(0, *_p_card);
+        _discipline->add_side_load(5, *_p_load);
+    }
+    
+    // one output object for all elements
+    _output = new MAST::StressStrainOutputBase;
+    _output->set_points_for_evaluation(pts);
+    _output->set_volume_loads(_discipline->volume_loads());
+    
+    const unsigned int
+    n_sub = (model == MAST::StructuralScalingBenchmark::PLATE)? n_stiff+1: 1;
+    
+    for (unsigned int i=0; i<n_sub; i++)
+        _discipline->add_volume_output(i, *_output);
+}
+
+
+
+void
+MAST::StructuralScalingBenchmark::_write_csv() const {
+    
+    if (__init->comm().rank())
+        return;
+    
+    // the header is written only to a new file
+    bool
+    if_header = true;
+    {
+        std::ifstream in(csv_file.c_str());
+        if_header = !in.good() || in.peek() == std::ifstream::traits_type::eof();
+    }
+    
+    std::ofstream out(csv_file.c_str(), std::ios::out | std::ios::app);
+    if (!out.good())
+        libmesh_error_msg("Unable to open file: " << csv_file);
+    
+    if (if_header)
+        out
+        << "model,n_stiff,weak_scaling,n_elem,n_dofs,n_procs,n_threads,"
+        << "phase,t_min,t_mean,t_max" << std::endl;
+    
+    for (unsigned int i=0; i<_phases.size(); i++)
+        out
+        << (model == PLATE? "plate": "panel_3d") << ","
+        << n_stiff                      << ","
+        << weak_scaling                 << ","
+        << _mesh->n_elem()              << ","
+        << _sys->n_dofs()               << ","
+        << __init->comm().size()        << ","
+        << libMesh::n_threads()         << ","
+        << _phases[i].name              << ","
+        << std::scientific << std::setprecision(6)
+        << _phases[i].t_min             << ","
+        << _phases[i].t_mean            << ","
+        << _phases[i].t_max             << std::endl;
+}
+
+
+
+void
+MAST::StructuralScalingBenchmark::_clear() {
+    
+    delete _output;
+    delete _p_card;
+    delete _m_card;
+    delete _p_load;
+    
+    for (unsigned int i=0; i<_functions.size(); i++)
+        delete _functions[i];
+    
+    for (unsigned int i=0; i<_params.size(); i++)
+        delete _params[i];
+    
+    for (unsigned int i=0; i<_dirichlet.size(); i++)
+        delete _dirichlet[i];
+    
+    delete _eq_sys;
+    delete _mesh;
+    delete _discipline;
+    delete _structural_sys;
+    
+    _functions.clear();
+    _params.clear();
+    _dirichlet.clear();
+    
+    _output         = nullptr;
+    _p_card         = nullptr;
+    _m_card         = nullptr;
+    _p_load         = nullptr;
+    _E              = nullptr;
+    _eq_sys         = nullptr;
+    _sys            = nullptr;
+    _mesh           = nullptr;
+    _discipline     = nullptr;
+    _structural_sys = nullptr;
+}
@@ -0,0 +1,228 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2017  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+#ifndef __mast_benchmark_structural_scaling_benchmark_h__
+#define __mast_benchmark_structural_scaling_benchmark_h__
+
+// C++ includes
+#include <string>
+#include <vector>
+#include <chrono>
+
+// MAST includes
+#include "base/mast_data_types.h"
+
+// libMesh includes
+#include "libmesh/libmesh.h"
+#include "libmesh/parallel_mesh.h"
+#include "libmesh/serial_mesh.h"
+#include "libmesh/equation_systems.h"
+
+
+
+namespace MAST {
+    
+    // Forward declerations
+    class SystemInitialization;
+    class StructuralDiscipline;
+    class Parameter;
+    class ConstantFieldFunction;
+    class IsotropicMaterialPropertyCard;
+    class ElementPropertyCardBase;
+    class BoundaryConditionBase;
+    class DirichletBoundaryCondition;
+    class StressStrainOutputBase;
+    class NonlinearSystem;
+    
+    
+    /*!
+     *   Times the phases of a structural analysis for the strong and weak
+     *   scaling studies. The model is either a (blade stiffened) plate of
+     *   QUAD4 shell elements, or a clamped 3D solid panel of HEX8
+     *   elements. The mesh size is specified for the whole model for
+     *   strong scaling, or per processor for weak scaling. Each phase
+     *   is timed between barriers, and the minimum, mean and maximum
+     *   over the processors of the time spent in the phase are
+     *   appended to a CSV file, so that the results of runs with
+     *   different processor and thread counts accumulate in one file.
+     */
+    class StructuralScalingBenchmark {
+        
+    public:
+        
+        /*!
+         *   type of model
+         */
+        enum ModelType {
+            PLATE,
+            PANEL_3D
+        };
+        
+        
+        StructuralScalingBenchmark();
+        
+        
+        virtual ~StructuralScalingBenchmark();
+        
+        
+        /*!
+         *   type of model
+         */
+        MAST::StructuralScalingBenchmark::ModelType model;
+        
+        /*!
+         *   number of elements in the model. For weak scaling this is the
+         *   number of elements per processor.
+         */
+        unsigned int n_elems;
+        
+        /*!
+         *   if true, \p n_elems is the number of elements per processor
+         */
+        bool         weak_scaling;
+        
+        /*!
+         *   number of blade stiffeners of the plate
+         */
+        unsigned int n_stiff;
+        
+        /*!
+         *   number of elements through the thickness of the 3D panel
+         */
+        unsigned int n_z_divs;
+        
+        /*!
+         *   number of eigenvalues requested from the modal analysis
+         */
+        unsigned int n_eig;
+        
+        /*!
+         *   number of times that the residual and Jacobian assemblies are
+         *   repeated. The mean time of an assembly is reported.
+         */
+        unsigned int n_repeat;
+        
+        /*!
+         *   name of the CSV file to which the results are appended
+         */
+        std::string  csv_file;
+        
+        
+        /*!
+         *   builds the model and times the phases of the analysis. This
+         *   is a collective operation, and the results are written by
+         *   processor 0.
+         */
+        void run();
+        
+    protected:
+        
+        /*!
+         *   data of a timed phase
+         */
+        struct PhaseTime {
+            
+            std::string  name;
+            Real         t_min;
+            Real         t_mean;
+            Real         t_max;
+        };
+        
+        
+        /*!
+         *   starts the timing of a phase after synchronizing the
+         *   processors
+         */
+        void _start_phase();
+        
+        /*!
+         *   completes the timing of phase \p nm, the time of which is
+         *   divided by \p n for a phase that was repeated \p n times
+         */
+        void _end_phase(const std::string& nm,
+                        unsigned int n = 1);
+        
+        /*!
+         *   builds the mesh of the model
+         */
+        void _build_mesh();
+        
+        /*!
+         *   creates the system, boundary conditions and properties, and
+         *   distributes the degrees of freedom
+         */
+        void _init_system();
+        
+        /*!
+         *   appends the phase times to the CSV file
+         */
+        void _write_csv() const;
+        
+        /*!
+         *   deletes the model
+         */
+        void _clear();
+        
+        
+        /*!
+         *   the stiffened plate uses a replicated mesh, since the panel
+         *   and stiffener meshes are combined on each processor, and the
+         *   other models a distributed mesh
+         */
+        libMesh::UnstructuredMesh*                 _mesh;
+        
+        libMesh::EquationSystems*                  _eq_sys;
+        
+        MAST::NonlinearSystem*                     _sys;
+        
+        MAST::SystemInitialization*                _structural_sys;
+        
+        MAST::StructuralDiscipline*                _discipline;
+        
+        std::vector<MAST::DirichletBoundaryCondition*> _dirichlet;
+        
+        std::vector<MAST::Parameter*>              _params;
+        
+        std::vector<MAST::ConstantFieldFunction*>  _functions;
+        
+        MAST::Parameter*                           _E;
+        
+        MAST::BoundaryConditionBase*               _p_load;
+        
+        MAST::IsotropicMaterialPropertyCard*       _m_card;
+        
+        MAST::ElementPropertyCardBase*             _p_card;
+        
+        MAST::StressStrainOutputBase*              _output;
+        
+        /*!
+         *   start of the current phase
+         */
+        std::chrono::high_resolution_clock::time_point _t0;
+        
+        /*!
+         *   timed phases
+         */
+        std::vector<PhaseTime>                     _phases;
+    };
+}
+
+
+#endif // __mast_benchmark_structural_scaling_benchmark_h__
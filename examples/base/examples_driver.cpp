@@ -17,6 +17,13 @@
  * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
  */
 
+// C++ includes
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <map>
+
+
 // MAST includes
 #include "examples/structural/bar_extension/bar_extension.h"
 #include "examples/structural/beam_thermally_stressed_modal_analysis/beam_thermally_stressed_modal_analysis.h"
@@ -71,6 +78,7 @@
 #include "examples/fsi/beam_fsi_solution/beam_euler_fsi_solution.h"
 #include "examples/thermal/bar_transient/bar_transient.h"
 #include "examples/thermal/bar_steady_state/bar_steady_state.h"
+#include "base/performance_log.h"
 
 
 // libMesh includes
@@ -82,6 +90,101 @@ libMesh::LibMeshInit     *__init         = nullptr;
 MAST::FunctionEvaluation *__my_func_eval = nullptr;
 
 
+// parameter values of the cases of a batch run, and the flag to write the
+// output of each case
+std::vector<std::map<std::string, Real> > __batch_cases;
+bool                                      __batch_write_output = false;
+
+
+
+/*!
+ *   reads the cases of a batch run from \p nm. Each line of the file is a
+ *   case, with whitespace separated \p name=value pairs of the parameters
+ *   of the example. Empty lines, and lines starting with \p #, are skipped.
+ */
+void read_batch_cases(const std::string& nm) {
+    
+    std::ifstream input(nm.c_str());
+    if (!input.good())
+        libmesh_error_msg("Unable to open batch file: " << nm);
+    
+    std::string line, token;
+    
+    while (std::getline(input, line)) {
+        
+        std::istringstream ss(line);
+        std::map<std::string, Real> vals;
+        
+        while (ss >> token) {
+            
+            if (token[0] == '#')
+                break;
+            
+            const size_t pos = token.find('=');
+            if (pos == std::string::npos || pos == 0)
+                libmesh_error_msg("Invalid batch case entry: " << token);
+            
+            vals[token.substr(0, pos)] = atof(token.substr(pos+1).c_str());
+        }
+        
+        if (!vals.empty())
+            __batch_cases.push_back(vals);
+    }
+    
+    if (__batch_cases.empty())
+        libmesh_error_msg("No cases in batch file: " << nm);
+}
+
+
+
+/*!
+ *   @returns the number of cases to run with an initialized example, which
+ *   is one without a batch file
+ */
+unsigned int n_cases() {
+    
+    return __batch_cases.size()? (unsigned int)__batch_cases.size(): 1;
+}
+
+
+
+/*!
+ *   sets the parameters of the i^th batch case in \p run_case. The mesh and
+ *   the systems of \p run_case are retained between the cases.
+ */
+template <typename ValType>
+void set_case(unsigned int i,
+              const std::string& case_name,
+              ValType& run_case)  {
+    
+    if (__batch_cases.empty()) {
+        
+        libMesh::out << "Running case: " << case_name << std::endl;
+        return;
+    }
+    
+    libMesh::out
+    << "Running case: " << case_name
+    << "  batch case: " << i << " :";
+    
+    std::map<std::string, Real>::const_iterator
+    it   = __batch_cases[i].begin(),
+    end  = __batch_cases[i].end();
+    
+    for ( ; it != end; it++) {
+        
+        MAST::Parameter* p = run_case.get_parameter(it->first);
+        if (!p)
+            libmesh_error_msg("Unknown parameter in batch case: " << it->first);
+        
+        (*p) = it->second;
+        libMesh::out << "  " << it->first << " = " << it->second;
+    }
+    
+    libMesh::out << std::endl;
+}
+
+
 
 template <typename ValType>
 void analysis(const std::string& case_name,
@@ -93,19 +196,21 @@ void analysis(const std::string& case_name,
     ValType run_case;
     run_case.init(etype, nonlinear);
     
-    libMesh::out << "Running case: " << case_name << std::endl;
-    run_case.solve(true);
-    if (with_sens) {
-        MAST::Parameter* p = run_case.get_parameter(par_name);
-        if (p) {
-            
-            libMesh::out
-            << "Running sensitivity for case: " << case_name
-            << "  wrt  " << par_name << std::endl;
-            run_case.sensitivity_solve(*p, true);
+    for (unsigned int i=0; i<n_cases(); i++) {
+        
+        set_case(i, case_name, run_case);
+        run_case.solve(__batch_cases.empty() || __batch_write_output);
+        if (with_sens) {
+            MAST::Parameter* p = run_case.get_parameter(par_name);
+            if (p) {
+                
+                libMesh::out
+                << "Running sensitivity for case: " << case_name
+                << "  wrt  " << par_name << std::endl;
+                run_case.sensitivity_solve(*p, __batch_cases.empty() || __batch_write_output);
+            }
         }
     }
-    
 }
 
 
@@ -120,20 +225,22 @@ void eigenvalue_analysis(const std::string& case_name,
     ValType run_case;
     run_case.init(etype, if_nonlin);
     
-    libMesh::out << "Running case: " << case_name << std::endl;
-    run_case.solve(true);
-    if (with_sens) {
-        MAST::Parameter* p = run_case.get_parameter(par_name);
-        if (p) {
-            
-            std::vector<Real> eig;
-            libMesh::out
-            << "Running sensitivity for case: " << case_name
-            << "  wrt  " << par_name << std::endl;
-            run_case.sensitivity_solve(*p, eig);
+    for (unsigned int i=0; i<n_cases(); i++) {
+        
+        set_case(i, case_name, run_case);
+        run_case.solve(__batch_cases.empty() || __batch_write_output);
+        if (with_sens) {
+            MAST::Parameter* p = run_case.get_parameter(par_name);
+            if (p) {
+                
+                std::vector<Real> eig;
+                libMesh::out
+                << "Running sensitivity for case: " << case_name
+                << "  wrt  " << par_name << std::endl;
+                run_case.sensitivity_solve(*p, eig);
+            }
         }
     }
-    
 }
 
 
@@ -149,20 +256,21 @@ void flutter_analysis(const std::string& case_name,
     ValType run_case;
     run_case.init(etype, nonlinear);
     
-    libMesh::out << "Running case: " << case_name << std::endl;
-    run_case.solve(true);
-    if (with_sens) {
-        MAST::Parameter* p = run_case.get_parameter(par_name);
-        if (p) {
-            
-            std::vector<Real> eig;
-            libMesh::out
-            << "Running sensitivity for case: " << case_name
-            << "  wrt  " << par_name << std::endl;
-            run_case.sensitivity_solve(*p);
+    for (unsigned int i=0; i<n_cases(); i++) {
+        
+        set_case(i, case_name, run_case);
+        run_case.solve(__batch_cases.empty() || __batch_write_output);
+        if (with_sens) {
+            MAST::Parameter* p = run_case.get_parameter(par_name);
+            if (p) {
+                
+                libMesh::out
+                << "Running sensitivity for case: " << case_name
+                << "  wrt  " << par_name << std::endl;
+                run_case.sensitivity_solve(*p);
+            }
         }
     }
-    
 }
 
 
@@ -170,6 +278,9 @@ void flutter_analysis(const std::string& case_name,
 template <typename ValType>
 void fluid_analysis(const std::string& case_name)  {
     
+    if (__batch_cases.size())
+        libmesh_error_msg("Batch cases are not supported for: " << case_name);
+    
     ValType run_case;
     
     libMesh::out << "Running case: " << case_name << std::endl;
@@ -195,6 +306,8 @@ void optimization(const std::string& case_name,
                   bool verify_grads,
                   bool nonlinear)  {
     
+    if (__batch_cases.size())
+        libmesh_error_msg("Batch cases are not supported for: " << case_name);
     
     libMesh::out
     << case_name << std::endl
@@ -258,6 +371,25 @@ int main(int argc, char* const argv[]) {
     if_nonlin    = command_line("nonlinear",           false),
     verify_grads = command_line("verify_grads",        false);
     
+    // the performance log is written to perf_log_prefix.<rank>.json/csv
+    std::string
+    perf_log     = command_line("perf_log",       ""),
+    perf_prefix  = command_line("perf_log_prefix", "mast_perf_log");
+    
+    if (perf_log == "json" || perf_log == "csv")
+        MAST::perf_log.enable();
+    else if (perf_log != "")
+        libmesh_error_msg("perf_log must be json or csv");
+    
+    // the cases of a batch file are run back to back with one
+    // initialization of the example
+    std::string
+    batch_file   = command_line("batch_file",     "");
+    __batch_write_output = command_line("batch_output", false);
+    
+    if (batch_file != "")
+        read_batch_cases(batch_file);
+    
     
     if (case_name == "bar_extension")
         analysis<MAST::BarExtension>(case_name,
@@ -517,7 +649,11 @@ int main(int argc, char* const argv[]) {
         << "   nonlinear=<true/false>"
         << "   verify_grads=<true/false>"
         << "   with_sensitivity=<true/false>"
-        << "   param=<name>\n\n"
+        << "   param=<name>"
+        << "   perf_log=<json/csv>"
+        << "   perf_log_prefix=<name>"
+        << "   batch_file=<name>"
+        << "   batch_output=<true/false>\n\n"
         << "Possible values are:\n\n\n"
         << "**********************************\n"
         << "*********   STRUCTURAL   *********\n"
@@ -560,6 +696,8 @@ int main(int argc, char* const argv[]) {
         << "*  param is used to specify the parameter name for which sensitivity is desired.\n"
         << "*  nonlinear is used to turn on/off nonlinear stiffening in the problem.\n"
         << "*  verify_grads=true will verify the gradients of the optimization problem before calling the optimizer.\n"
+        << "*  batch_file is a file with one case per line, specified as name=value pairs of the example parameters.\n"
+        << "   The cases are run back to back without reinitializing the example, and output is written only with batch_output=true.\n"
         << "\n\n\n"
         << "**********************************\n"
         << "***********   FLUID   ************\n"
@@ -593,5 +731,11 @@ int main(int argc, char* const argv[]) {
         << std::endl;
     }
     
+    MAST::perf_log.write_summary(init.comm(),
+                                 perf_prefix,
+                                 (perf_log == "csv")?
+                                 MAST::PerformanceLog::CSV:
+                                 MAST::PerformanceLog::JSON);
+    
     return 0;
 }
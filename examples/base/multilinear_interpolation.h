@@ -26,6 +26,7 @@
 
 // MAST includes
 #include "base/field_function_base.h"
+#include "base/table_interpolation_function.h"
 
 
 
@@ -35,29 +36,17 @@ namespace MAST {
     
     /*!
      *   This class provides the ability to interpolate a function in between
-     *   a set of tabulated points.
+     *   a set of tabulated points. The interpolation is provided by
+     *   MAST::TableInterpolationFunction.
      */
     class MultilinearInterpolation:
-    public MAST::FieldFunction<Real> {
+    public MAST::TableInterpolationFunction {
     public:
         MultilinearInterpolation(const std::string& nm,
                                  std::map<Real, MAST::FieldFunction<Real>*>& values);
         
         
         virtual ~MultilinearInterpolation();
-        
-    protected:
-        
-        std::map<Real, MAST::FieldFunction<Real>*> _values;
-        
-    public:
-        
-        virtual void operator() (const libMesh::Point& p, Real t, Real& v) const;
-        
-        virtual void derivative(   const MAST::FunctionBase& f,
-                                const libMesh::Point& p,
-                                Real t,
-                                Real& v) const;
     };
     
     
@@ -89,6 +78,15 @@ namespace MAST {
                                 Real t,
                                 Real& v) const;
         
+        virtual void operator() (const std::vector<libMesh::Point>& pts,
+                                 const Real t,
+                                 std::vector<Real>& v) const;
+        
+        virtual void derivative (const MAST::FunctionBase& f,
+                                 const std::vector<libMesh::Point>& pts,
+                                 const Real t,
+                                 std::vector<Real>& v) const;
+        
     };
     
 }
@@ -18,9 +18,17 @@
  */
 
 
+// C++ includes
+#include <algorithm>
+
 // MAST includes
 #include "examples/fluid/meshing/mesh_initializer.h"
 
+// libMesh includes
+#include "libmesh/parallel_mesh.h"
+#include "libmesh/boundary_info.h"
+#include "libmesh/elem.h"
+
 
 
 void
@@ -31,8 +39,17 @@ MAST::MeshInitializer::init (const std::vector<MeshInitializer::CoordinateDivisi
     unsigned int dim = divs.size();
     _mesh = &mesh;
     
+    // a distributed mesh is serial until its remote elements are deleted,
+    // so the type of the mesh is checked
+    _distributed_mesh =
+    _distributed_generation &&
+    mesh.n_processors() > 1 &&
+    dynamic_cast<libMesh::DistributedMesh*>(&mesh) != nullptr;
+    
     // first create the mesh
-    switch (dim) {
+    if (_distributed_mesh)
+        _build_distributed_mesh(divs, t);
+    else switch (dim) {
         case 1: {
             libMesh::MeshTools::Generation::build_line (mesh,
                                                         divs[0]->total_elem_divs(),
@@ -77,3 +94,219 @@ MAST::MeshInitializer::init (const std::vector<MeshInitializer::CoordinateDivisi
 
 
 
+void
+MAST::MeshInitializer::
+_build_distributed_mesh(const std::vector<MeshInitializer::CoordinateDivisions*>& divs,
+                        libMesh::ElemType t) {
+    
+    libMesh::DistributedMesh&
+    mesh = dynamic_cast<libMesh::DistributedMesh&>(*_mesh);
+    
+    const unsigned int
+    dim = (unsigned int)divs.size();
+    
+    if ((dim == 1 && t != libMesh::EDGE2) ||
+        (dim == 2 && t != libMesh::QUAD4) ||
+        (dim == 3 && t != libMesh::HEX8))
+        libmesh_error_msg("Distributed mesh generation only supports EDGE2, QUAD4 and HEX8 elements.");
+    
+    mesh.clear();
+    mesh.set_mesh_dimension(dim);
+    
+    const libMesh::processor_id_type
+    n_procs = mesh.n_processors(),
+    rank    = mesh.processor_id();
+    
+    // number of elements and of processor blocks along each coordinate
+    unsigned int
+    n_el[3]  = {1, 1, 1},
+    n_blk[3] = {1, 1, 1};
+    
+    for (unsigned int d=0; d<dim; d++)
+        n_el[d] = divs[d]->total_elem_divs();
+    
+    // the prime factors of the number of processors are assigned, largest
+    // first, to the coordinate with the most elements per block, which
+    // keeps the blocks close to cubes
+    {
+        std::vector<unsigned int> factors;
+        unsigned int n = n_procs;
+        
+        for (unsigned int f=2; f*f<=n; f++)
+            while (n%f == 0) {
+                factors.push_back(f);
+                n /= f;
+            }
+        if (n > 1)
+            factors.push_back(n);
+        
+        for (int i=(int)factors.size()-1; i>=0; i--) {
+            
+            unsigned int d_max = 0;
+            for (unsigned int d=1; d<dim; d++)
+                if (Real(n_el[d])/n_blk[d] > Real(n_el[d_max])/n_blk[d_max])
+                    d_max = d;
+            
+            n_blk[d_max] *= factors[i];
+        }
+        
+        for (unsigned int d=0; d<dim; d++)
+            if (n_blk[d] > n_el[d])
+                libmesh_error_msg("Too many processors for distributed mesh generation.");
+    }
+    
+    // first element of block b along coordinate d
+    auto blk_begin = [&](unsigned int d, unsigned int b) -> unsigned int {
+        return (unsigned int)((unsigned long long)b * n_el[d] / n_blk[d]);
+    };
+    
+    // block of element i along coordinate d
+    auto elem_blk  = [&](unsigned int d, unsigned int i) -> unsigned int {
+        unsigned int b = (unsigned int)((unsigned long long)i * n_blk[d] / n_el[d]);
+        while (b+1 < n_blk[d] && blk_begin(d, b+1) <= i) b++;
+        while (blk_begin(d, b) > i) b--;
+        return b;
+    };
+    
+    auto elem_pid  = [&](const unsigned int* ijk) -> libMesh::processor_id_type {
+        return elem_blk(0, ijk[0]) +
+        n_blk[0] * (elem_blk(1, ijk[1]) + n_blk[1] * elem_blk(2, ijk[2]));
+    };
+    
+    // a node belongs to the lowest processor of the elements connected to it
+    auto node_pid  = [&](const unsigned int* ijk) -> libMesh::processor_id_type {
+        libMesh::processor_id_type pid = n_procs;
+        unsigned int e[3] = {0, 0, 0};
+        for (unsigned int c=0; c<(1u<<dim); c++) {
+            bool valid = true;
+            for (unsigned int d=0; d<dim; d++) {
+                const unsigned int off = (c>>d)&1;
+                valid = valid && off <= ijk[d] && ijk[d]-off < n_el[d];
+                e[d]  = ijk[d]-off;
+            }
+            if (valid)
+                pid = std::min(pid, elem_pid(e));
+        }
+        return pid;
+    };
+    
+    // range of elements created on this processor along each coordinate,
+    // which is the block of this processor with the ghost layers
+    const unsigned int
+    blk[3] = {
+        rank % n_blk[0],
+        (rank / n_blk[0]) % n_blk[1],
+        rank / (n_blk[0] * n_blk[1])};
+    
+    unsigned int
+    lo[3] = {0, 0, 0},
+    hi[3] = {1, 1, 1};
+    
+    for (unsigned int d=0; d<dim; d++) {
+        
+        lo[d] = blk_begin(d, blk[d]);
+        lo[d] = lo[d] > _n_ghost_layers? lo[d]-_n_ghost_layers: 0;
+        hi[d] = std::min(blk_begin(d, blk[d]+1) + _n_ghost_layers, n_el[d]);
+    }
+    
+    // local node numbering of the elements in the structured index space
+    const unsigned int
+    node_off[8][3] = {
+        {0, 0, 0}, {1, 0, 0}, {1, 1, 0}, {0, 1, 0},
+        {0, 0, 1}, {1, 0, 1}, {1, 1, 1}, {0, 1, 1}},
+    n_nodes = 1u<<dim;
+    
+    // boundary id of the sides of elements on each face of the domain,
+    // as used by libMesh::MeshTools::Generation. The faces are ordered
+    // as the low and high faces along x, y and z.
+    const int
+    face_bc[3][6] = {
+        {0, 1, -1, -1, -1, -1},
+        {3, 1,  0,  2, -1, -1},
+        {4, 2,  1,  3,  0,  5}};
+    
+    unsigned int
+    ijk[3] = {0, 0, 0},
+    nd[3]  = {0, 0, 0};
+    
+    libMesh::Point p0, p1;
+    
+    for (ijk[2]=0; ijk[2]<n_el[2]; ijk[2]++)
+        for (ijk[1]=0; ijk[1]<n_el[1]; ijk[1]++)
+            for (ijk[0]=0; ijk[0]<n_el[0]; ijk[0]++) {
+                
+                bool
+                in_block    = true,
+                on_boundary = false;
+                
+                for (unsigned int d=0; d<dim; d++) {
+                    in_block    = in_block && ijk[d] >= lo[d] && ijk[d] < hi[d];
+                    on_boundary = on_boundary || ijk[d] == 0 || ijk[d] == n_el[d]-1;
+                }
+                
+                bool
+                replicate = false;
+                
+                if (!in_block && on_boundary) {
+                    
+                    for (unsigned int d=0; d<dim; d++) {
+                        p0(d) = (*divs[d])(Real(ijk[d])/n_el[d]);
+                        p1(d) = (*divs[d])(Real(ijk[d]+1)/n_el[d]);
+                    }
+                    replicate = this->_replicate_elem(p0, p1);
+                }
+                
+                if (!in_block && !replicate)
+                    continue;
+                
+                libMesh::Elem* elem = libMesh::Elem::build(t).release();
+                elem->set_id(ijk[0] + n_el[0] * (ijk[1] + n_el[1] * ijk[2]));
+                elem->processor_id() = elem_pid(ijk);
+                
+                for (unsigned int i=0; i<n_nodes; i++) {
+                    
+                    for (unsigned int d=0; d<3; d++)
+                        nd[d] = ijk[d] + (d<dim? node_off[i][d]: 0);
+                    
+                    const libMesh::dof_id_type
+                    id = nd[0] + (n_el[0]+1) * (nd[1] + (n_el[1]+1) * nd[2]);
+                    
+                    libMesh::Node* node = mesh.query_node_ptr(id);
+                    
+                    // the computational coordinates are mapped to the
+                    // divisions by init()
+                    if (!node) {
+                        
+                        libMesh::Point p;
+                        for (unsigned int d=0; d<dim; d++)
+                            p(d) = Real(nd[d])/n_el[d];
+                        
+                        node = mesh.add_point(p, id, node_pid(nd));
+                    }
+                    
+                    elem->set_node(i) = node;
+                }
+                
+                elem = mesh.add_elem(elem);
+                
+                for (unsigned int d=0; d<dim; d++) {
+                    
+                    if (ijk[d] == 0)
+                        _mesh->boundary_info->add_side(elem, face_bc[dim-1][2*d], face_bc[dim-1][2*d]);
+                    if (ijk[d] == n_el[d]-1)
+                        _mesh->boundary_info->add_side(elem, face_bc[dim-1][2*d+1], face_bc[dim-1][2*d+1]);
+                }
+                
+                if (replicate)
+                    mesh.add_extra_ghost_elem(elem);
+            }
+    
+    // the processor ids are those of the blocks, and the mesh is not
+    // partitioned again
+    const bool
+    skip = mesh.skip_partitioning();
+    
+    mesh.skip_partitioning(true);
+    mesh.prepare_for_use();
+    mesh.skip_partitioning(skip);
+}
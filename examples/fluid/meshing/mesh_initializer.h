@@ -48,7 +48,10 @@ namespace MAST {
     public:
         
         MeshInitializer():
-        _mesh(nullptr)
+        _mesh(nullptr),
+        _distributed_generation(false),
+        _n_ghost_layers(1),
+        _distributed_mesh(false)
         { }
         
         virtual ~MeshInitializer()
@@ -243,8 +246,47 @@ namespace MAST {
                    libMesh::UnstructuredMesh& mesh, libMesh::ElemType t);
         
         
+        /*!
+         *   if \p f is true, init() creates a distributed mesh directly in
+         *   parallel, instead of creating the whole mesh on each processor
+         *   before partitioning. The structured index space of the elements
+         *   is split into blocks, one per processor, and each processor
+         *   creates only the elements of its block, \p n_ghost_layers
+         *   layers of elements around the block, and the boundary elements
+         *   for which _replicate_elem() is true. The element and node ids
+         *   are the indices in the structured index space, the boundary ids
+         *   are those of libMesh::MeshTools::Generation, and the processor
+         *   ids are those of the blocks. Only EDGE2, QUAD4 and HEX8 elements
+         *   are supported. This is ignored if the mesh is not a
+         *   libMesh::DistributedMesh, or on a single processor.
+         */
+        void set_distributed_generation(bool f, unsigned int n_ghost_layers = 1) {
+            _distributed_generation = f;
+            _n_ghost_layers         = n_ghost_layers;
+        }
+        
+        
     protected:
         
+        /*!
+         *    creates the mesh for the divisions \p divs in parallel. See
+         *    set_distributed_generation().
+         */
+        void _build_distributed_mesh(const std::vector<MeshInitializer::CoordinateDivisions*>& divs,
+                                     libMesh::ElemType t);
+        
+        /*!
+         *    @returns true if the boundary element with the bounding box
+         *    from \p p0 to \p p1, before process_mesh() moves the mesh
+         *    points, should be created on all processors by the distributed
+         *    generation. This is used for elements on the fluid-structure
+         *    interface, which are added as extra ghost elements.
+         */
+        virtual bool _replicate_elem(const libMesh::Point& p0,
+                                     const libMesh::Point& p1) const {
+            return false;
+        }
+        
         /*!
          *    function modifies the mesh and sets boudnary conditions. This needs to
          *    be implemented for each inherited class
@@ -255,6 +297,20 @@ namespace MAST {
          *    mesh associated with this initialization object
          */
         libMesh::UnstructuredMesh* _mesh;
+        
+        /*!
+         *    flag for distributed generation, and the number of ghost 
+         *    element layers around the block of each processor
+         */
+        bool _distributed_generation;
+        
+        unsigned int _n_ghost_layers;
+        
+        /*!
+         *    true if the mesh was created by the distributed generation, in
+         *    which case process_mesh() must not serialize the mesh
+         */
+        bool _distributed_mesh;
     };
     
     
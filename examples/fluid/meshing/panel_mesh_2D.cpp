@@ -66,7 +66,10 @@ MAST::PanelMesh2D::process_mesh( ) {
     parallel_mesh = !_mesh->is_serial();
     
     {
-        libMesh::MeshSerializer serializer(*_mesh);
+        // a mesh created by the distributed generation is not serialized,
+        // and the sides of the local and ghost elements are tagged
+        std::auto_ptr<libMesh::MeshSerializer>
+        serializer(_distributed_mesh? nullptr: new libMesh::MeshSerializer(*_mesh));
         
         
         //march over all the elmeents and tag the sides that all lie on the panel suface
@@ -148,3 +151,12 @@ MAST::PanelMesh2D::process_mesh( ) {
 
 
 
+bool
+MAST::PanelMesh2D::_replicate_elem(const libMesh::Point& p0,
+                                   const libMesh::Point& p1) const {
+    
+    // the element is on the bottom face of the domain, and within the
+    // bounds of the panel
+    return ((p0(1) == _y0) &&
+            (p0(0) >= _x0-1.0e-6) && (p1(0) <= _x1+1.0e-6));
+}
@@ -74,7 +74,10 @@ MAST::PanelMesh3D::process_mesh( ) {
     parallel_mesh = !_mesh->is_serial();
     
     {
-        libMesh::MeshSerializer serializer(*_mesh);
+        // a mesh created by the distributed generation is not serialized,
+        // and the sides of the local and ghost elements are tagged
+        std::auto_ptr<libMesh::MeshSerializer>
+        serializer(_distributed_mesh? nullptr: new libMesh::MeshSerializer(*_mesh));
         
         //march over all the elmeents and tag the sides that all lie on the panel suface
         libMesh::MeshBase::element_iterator e_it = _mesh->elements_begin();
@@ -165,3 +168,15 @@ MAST::PanelMesh3D::process_mesh( ) {
     }
 }
 
+
+
+bool
+MAST::PanelMesh3D::_replicate_elem(const libMesh::Point& p0,
+                                   const libMesh::Point& p1) const {
+    
+    // the element is on the bottom face of the domain, and within the
+    // bounds of the panel
+    return ((p0(2) == _z0) &&
+            (p0(0) >= _x0-1.0e-6) && (p1(0) <= _x1+1.0e-6) &&
+            (p0(1) >= _y0-1.0e-6) && (p1(1) <= _y1+1.0e-6));
+}
@@ -67,6 +67,13 @@ namespace MAST {
          */
         virtual void process_mesh( );
         
+        /*!
+         *   @returns true for the elements on the panel surface, which are
+         *   kept on all processors by the distributed generation
+         */
+        virtual bool _replicate_elem(const libMesh::Point& p0,
+                                     const libMesh::Point& p1) const;
+        
         /*!
          *   t/c ratio of the panel
          */
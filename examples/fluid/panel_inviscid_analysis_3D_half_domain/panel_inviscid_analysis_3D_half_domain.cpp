@@ -168,16 +168,19 @@ MAST::PanelInviscidAnalysis3DHalfDomain::PanelInviscidAnalysis3DHalfDomain() {
     z_coord_divs->init(nz_divs, z_div_loc, z_relative_dx, z_divs);
     
     
-    // initialize the mesh
-    MAST::PanelMesh3DHalfDomain().init(t_by_c,               // t/c
-                                       if_cos_bump,          // if cos bump
-                                       n_max_bumps_x,        // n max bumps in x
-                                       n_max_bumps_y,        // n max bumps in y
-                                       panel_bc_id,
-                                       symmetry_bc_id,
-                                       divs,
-                                       *_mesh,
-                                       elem_type);
+    // initialize the mesh. With distributed_mesh_generation, each
+    // processor creates only its block of the mesh
+    MAST::PanelMesh3DHalfDomain mesh_init;
+    mesh_init.set_distributed_generation(infile("distributed_mesh_generation", false));
+    mesh_init.init(t_by_c,               // t/c
+                   if_cos_bump,          // if cos bump
+                   n_max_bumps_x,        // n max bumps in x
+                   n_max_bumps_y,        // n max bumps in y
+                   panel_bc_id,
+                   symmetry_bc_id,
+                   divs,
+                   *_mesh,
+                   elem_type);
     
     
     
@@ -35,6 +35,7 @@
 #include "fluid/frequency_domain_pressure_function.h"
 #include "solver/complex_solver_base.h"
 #include "fluid/flight_condition.h"
+#include "fluid/fluid_base_solution_cache.h"
 #include "base/parameter.h"
 #include "base/constant_field_function.h"
 #include "base/boundary_condition_base.h"
@@ -241,7 +242,8 @@ _m_card                                 (nullptr),
 _p_card                                 (nullptr),
 _dirichlet_left                         (nullptr),
 _dirichlet_right                        (nullptr),
-_augment_send_list_obj                  (nullptr) {
+_augment_send_list_obj                  (nullptr),
+_base_solution_cache                    (nullptr) {
     
     //////////////////////////////////////////////////////////////////////
     //    SETUP THE FLUID DATA
@@ -351,6 +353,10 @@ _augment_send_list_obj                  (nullptr) {
     _augment_send_list_obj = new MAST::AugmentGhostElementSendListObj(*_fluid_sys);
     _fluid_sys->get_dof_map().attach_extra_send_list_object(*_augment_send_list_obj);
     
+    _base_solution_cache = new MAST::FluidBaseSolutionCache(__init->comm(),
+                                                            infile("fluid_base_cache_size", 4));
+    _base_solution_cache->set_spill_directory(infile("fluid_base_cache_dir", ""));
+    
     // initialize the equation system for analysis
     _fluid_eq_sys->init();
     
@@ -596,6 +602,8 @@ _augment_send_list_obj                  (nullptr) {
 MAST::BeamEulerFSIFlutterNonuniformAeroBaseAnalysis::
 ~BeamEulerFSIFlutterNonuniformAeroBaseAnalysis() {
     
+    delete _base_solution_cache;
+    
     delete _fluid_eq_sys;
     delete _fluid_mesh;
     
@@ -749,6 +757,15 @@ solve(bool if_write_output,
     _fluid_sys_init->initialize_solution(s);
     _pressure_function->init(base_sol);
     
+    // the base flow depends only on the flight condition and the fluid
+    // mesh, which does not change in this example. If the flight condition
+    // was solved earlier, its solution is used. Otherwise, the solution of
+    // the nearest flight condition is used as the initial condition.
+    bool
+    if_cached = _base_solution_cache->find(*_flight_cond, 0, *_fluid_sys->solution);
+    if (!if_cached)
+        _base_solution_cache->nearest(*_flight_cond, 0, *_fluid_sys->solution);
+    
     /////////////////////////////////////////////////////////////////
     // Fluid steady-state solution
     /////////////////////////////////////////////////////////////////
@@ -801,7 +818,8 @@ solve(bool if_write_output,
         libMesh::out << "Writing output to : output.exo" << std::endl;
     
     // loop over time steps
-    while ((t_step <= max_time_steps) &&
+    while (!if_cached &&
+           (t_step <= max_time_steps) &&
            (vel_1  >=  1.e-2)) {
         
         // change dt if the iteration count has increased to threshold
@@ -852,6 +870,8 @@ solve(bool if_write_output,
     
     steady_fluid_assembly.clear_discipline_and_system();
 
+    if (!if_cached)
+        _base_solution_cache->add(*_flight_cond, 0, *_fluid_sys->solution);
     
     
     // swap back the calculate solution so that we store it for later use.
@@ -959,6 +979,11 @@ solve(bool if_write_output,
                       _pressure_function,
                       _freq_domain_pressure_function,
                       _displ);
+    
+    // the fluid solutions of all modes share one matrix assembly and
+    // preconditioner setup
+    fsi_assembly.set_multiple_rhs_solve(true);
+    
     _flutter_solver->attach_assembly(fsi_assembly);
     _flutter_solver->initialize(*_omega,
                                 *_b_ref,
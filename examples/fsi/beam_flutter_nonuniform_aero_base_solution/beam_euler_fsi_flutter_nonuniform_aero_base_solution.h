@@ -66,6 +66,7 @@ namespace MAST {
     class FrequencyDomainPressureFunction;
     class DisplacementFunctionBase;
     class AugmentGhostElementSendListObj;
+    class FluidBaseSolutionCache;
 
     
     struct BeamEulerFSIFlutterNonuniformAeroBaseAnalysis {
@@ -246,6 +247,9 @@ namespace MAST {
         
         // object to augment the send list of ghosted fluid elements
         MAST::AugmentGhostElementSendListObj*    _augment_send_list_obj;
+        
+        // steady fluid solutions of the flight conditions solved earlier
+        MAST::FluidBaseSolutionCache*            _base_solution_cache;
 
         // vector of parameters to evaluate sensitivity wrt
         std::vector<MAST::Parameter*>           _params_for_sensitivity;
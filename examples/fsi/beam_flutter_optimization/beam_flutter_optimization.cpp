@@ -23,7 +23,7 @@
 
 // MAST includes
 #include "examples/fsi/beam_flutter_optimization/beam_flutter_optimization.h"
-#include "examples/fsi/base/gaf_database.h"
+#include "elasticity/gaf_database.h"
 #include "optimization/optimization_interface.h"
 #include "optimization/function_evaluation.h"
 #include "elasticity/structural_modal_eigenproblem_assembly.h"
@@ -228,6 +228,8 @@ _omega_f                                (nullptr),
 _velocity_f                             (nullptr),
 _b_ref_f                                (nullptr),
 _flutter_solver                         (nullptr),
+_flutter_warm_start                     (false),
+_flutter_state_written                  (false),
 _gaf_database                           (nullptr),
 _thz                                    (nullptr),
 _E                                      (nullptr),
@@ -451,6 +453,10 @@ MAST::BeamFSIFlutterSizingOptimization::init(GetPot &infile,
     _k_lower            = infile("k_lower",  0.05);
     _n_k_divs           = infile("n_k_divs",   10);
     
+    // the crossovers of the prior design are added to the scan of the
+    // next design only if requested
+    _flutter_warm_start = infile("flutter_warm_start", false);
+    
     
     /////////////////////////////////////////////////////////////////
     //  INITIALIZE FLUID SOLUTION
@@ -683,6 +689,7 @@ MAST::BeamFSIFlutterSizingOptimization::init(GetPot &infile,
     _weight = new MAST::BeamWeight(*_structural_discipline);
     
     _flutter_solver  = new MAST::UGFlutterSolver;
+    _flutter_solver->set_warm_start(_flutter_warm_start);
     
     ////////////////////////////////////////////////////////////
     // STRUCTURAL MODAL EIGENSOLUTION
@@ -752,11 +759,20 @@ MAST::BeamFSIFlutterSizingOptimization::init(GetPot &infile,
     libMesh::out
     << "Building GAF database..." << std::endl;
 
-    // now iterate over the reduced frequencies and calculate the GAF matrices
+    // the GAF values at all reduced frequencies are computed together,
+    // with one assembly of the fluid operators for each mode
+    std::vector<Real> kvals(_n_k_divs+1, 0.);
+    for (unsigned int i=0; i<=_n_k_divs; i++)
+        kvals[i] = _k_upper + (_k_lower-_k_upper)*(1.*i)/(1.*_n_k_divs);
+    
+    _gaf_database->add_kr_mats(_basis, kvals);
+    
+    // now iterate over the reduced frequencies and calculate the GAF
+    // sensitivity matrices
     for (unsigned int i=0; i<=_n_k_divs; i++) {
         
         Real
-        kval = _k_upper + (_k_lower-_k_upper)*(1.*i)/(1.*_n_k_divs);
+        kval = kvals[i];
 
         libMesh::out << " ***********   kr = " << kval
         << "  ***********" << std::endl;
@@ -765,17 +781,6 @@ MAST::BeamFSIFlutterSizingOptimization::init(GetPot &infile,
         // initialize reduced frequency
         (*_omega) = kval;
         
-        // first the GAF values, then the sensitivity values
-        {
-            ComplexMatrixX&
-            mat = _gaf_database->add_kr_mat(kval,
-                                            ComplexMatrixX::Zero(_basis.size(),
-                                                                 _basis.size()),
-                                            false);
-            
-            _gaf_database->assemble_generalized_aerodynamic_force_matrix(_basis, mat);
-        }
-        
         // now the sensitivity
         {
             ComplexMatrixX&
@@ -990,6 +995,10 @@ MAST::BeamFSIFlutterSizingOptimization::evaluate(const std::vector<Real>& dvars,
                                 _n_k_divs,        // number of divisions
                                 _basis);          // basis vectors
     
+    // the crossovers of the prior design are used to warm start the scan
+    const std::string flutter_state("flutter_state.bin");
+    if (_flutter_warm_start && _flutter_state_written)
+        _flutter_solver->read_binary_state(flutter_state);
     
     // find the roots for the specified divisions
     _flutter_solver->scan_for_roots();
@@ -1005,6 +1014,11 @@ MAST::BeamFSIFlutterSizingOptimization::evaluate(const std::vector<Real>& dvars,
     std::pair<bool, MAST::FlutterRootBase*>
     sol = _flutter_solver->find_critical_root(tol, max_bisection_iters);
     
+    if (_flutter_warm_start) {
+        
+        _flutter_solver->write_binary_state(flutter_state);
+        _flutter_state_written = true;
+    }
     
     _flutter_solver->print_sorted_roots();
     _gaf_database->clear_discipline_and_system();
@@ -246,6 +246,19 @@ namespace MAST {
          */
         MAST::UGFlutterSolver*                   _flutter_solver;
         
+        /*!
+         *   \p true if the flutter scan of a design is warm started from
+         *   the flutter state of the prior design, which is \p false
+         *   unless \p flutter_warm_start is set in the input file
+         */
+        bool                                     _flutter_warm_start;
+        
+        /*!
+         *   \p true if the flutter state of a prior design has been
+         *   written to file, which is used to warm start the next scan
+         */
+        bool                                     _flutter_state_written;
+        
         // vector of basis vectors from modal analysis
         std::vector<libMesh::NumericVector<Real>*>     _basis;
 
@@ -651,6 +651,9 @@ MAST::BeamEulerFSIFlutterAnalysis::solve(bool if_write_output,
                                           *_fluid_sys_init);
     assembly.set_base_solution(base_sol);
     assembly.set_frequency_function(*_freq_function);
+    // the base solution is fixed for all frequencies and modes of the
+    // flutter solution
+    assembly.set_store_base_state_operators(true);
     _pressure_function->init(base_sol);
 
     
@@ -741,6 +744,11 @@ MAST::BeamEulerFSIFlutterAnalysis::solve(bool if_write_output,
                       _pressure_function,
                       _freq_domain_pressure_function,
                       _displ);
+    
+    // the fluid solutions of all modes share one matrix assembly and
+    // preconditioner setup
+    fsi_assembly.set_multiple_rhs_solve(true);
+    
     _flutter_solver->attach_assembly(fsi_assembly);
     _flutter_solver->initialize(*_omega,
                                 *_b_ref,
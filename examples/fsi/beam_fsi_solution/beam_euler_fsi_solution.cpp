@@ -84,7 +84,8 @@ namespace MAST {
         _fluid_transient_solver (fluid_transient_solver),
         _vel                    (vel),
         _displ                  (displ),
-        _press                  (press)
+        _press                  (press),
+        _structural_fields_init (false)
         { }
         
         virtual ~FSIBoundaryConditionUpdates() { }
@@ -114,12 +115,24 @@ namespace MAST {
             _str_transient_solver.update_velocity(*structural_vel,
                                                   structural_sol);
             
-            // clear the data structures before initializing
-            _vel.clear();
-            _displ.clear();
-            
-            _vel.init        (*structural_vel);
-            _displ.init      (structural_sol);
+            // after the first coupling iteration, the interpolation data
+            // of the structural fields is retained and only the values
+            // are updated
+            if (_structural_fields_init) {
+                
+                _vel.update      (*structural_vel);
+                _displ.update    (structural_sol);
+            }
+            else {
+                
+                // clear the data structures before initializing
+                _vel.clear();
+                _displ.clear();
+                
+                _vel.init        (*structural_vel);
+                _displ.init      (structural_sol);
+                _structural_fields_init = true;
+            }
             _press.init      (fluid_sol);
             
         }
@@ -172,6 +185,10 @@ namespace MAST {
             _vel.init  (*structural_vel, structural_vel_sens.get());
             _displ.init(structural_sol, &structural_sol_sens);
             _press.init(     fluid_sol,      &fluid_sol_sens);
+            
+            // the next update of the solution initializes the fields
+            // without the perturbation
+            _structural_fields_init = false;
         }
 
         
@@ -184,6 +201,7 @@ namespace MAST {
         MAST::MeshFieldFunction     &           _vel;
         MAST::MeshFieldFunction     &           _displ;
         MAST::PressureFunction      &           _press;
+        bool                                    _structural_fields_init;
     };
 }
 
@@ -754,6 +772,12 @@ MAST::BeamEulerFSIAnalysis::solve(bool if_write_output,
     fsi_solver.set_system_assembly(0,      fluid_assembly);
     fsi_solver.set_system_assembly(1, structural_assembly);
     
+    // block Gauss-Seidel over the disciplines, with ASM on the fluid
+    // block and GAMG on the structural block
+    fsi_solver.set_fieldsplit_type(MAST::MultiphysicsNonlinearSolverBase::FIELDSPLIT_MULTIPLICATIVE);
+    fsi_solver.set_block_preconditioner(0, MAST::MultiphysicsNonlinearSolverBase::BLOCK_PC_ASM);
+    fsi_solver.set_block_preconditioner(1, MAST::MultiphysicsNonlinearSolverBase::BLOCK_PC_GAMG);
+    
     while ((t_step <= _max_time_steps) && (vel_1  >=  1.e-8)) {
 
         // change dt if the iteration count has increased to threshold
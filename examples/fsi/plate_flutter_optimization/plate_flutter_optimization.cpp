@@ -23,7 +23,7 @@
 
 // MAST includes
 #include "examples/fsi/plate_flutter_optimization/plate_flutter_optimization.h"
-#include "examples/fsi/base/gaf_database.h"
+#include "elasticity/gaf_database.h"
 #include "optimization/optimization_interface.h"
 #include "optimization/function_evaluation.h"
 #include "elasticity/structural_modal_eigenproblem_assembly.h"
@@ -1107,54 +1107,57 @@ MAST::PlateFSIFlutterSizingOptimization::evaluate(const std::vector<Real>& dvars
         // grad_k = dfi/dxj  ,  where k = j*NFunc + i
         //////////////////////////////////////////////////////////////////
         
-        // we are going to choose to use one parametric sensitivity at a time
-        for (unsigned int i=0; i<_n_vars; i++) {
+        // the flutter speed sensitivity is evaluated for all parameters
+        // with a single assembly of the reduced order matrix sensitivity
+        libMesh::ParameterVector params;
+        params.resize(_n_vars);
+        for (unsigned int i=0; i<_n_vars; i++)
+            params[i]  = _th_station_parameters[i]->ptr();
+        
+        // calculate sensitivity only if the flutter root was found
+        // else, set it to zero
+        if (sol.second) {
+            
+            _gaf_database->attach_discipline_and_system(*_structural_discipline,
+                                                        *_structural_sys_init);
+            
+            _frequency_domain_fluid_assembly->attach_discipline_and_system(*_fluid_discipline,
+                                                                           *_complex_solver,
+                                                                           *_fluid_sys_init);
+            _frequency_domain_fluid_assembly->set_base_solution(base_sol);
+            _frequency_domain_fluid_assembly->set_frequency_function(*_freq_function);
+            
+            _gaf_database->init(_freq_function,
+                                _complex_solver,                       // fluid complex solver
+                                _pressure_function,
+                                _freq_domain_pressure_function,
+                                _displ);
+            _flutter_solver->attach_assembly(*_gaf_database);
+            _flutter_solver->initialize(*_omega,
+                                        *_b_ref,
+                                        _flight_cond->rho(),
+                                        _k_lower,         // lower kr
+                                        _k_upper,         // upper kr
+                                        _n_k_divs,        // number of divisions
+                                        _basis);          // basis vectors
             
-            libMesh::ParameterVector params;
+            std::vector<Real> V_sens;
+            _flutter_solver->calculate_sensitivity(*sol.second,
+                                                   params,
+                                                   std::vector<libMesh::NumericVector<Real>*>(),
+                                                   V_sens);
             
-            params.resize(1);
-            params[0]  = _th_station_parameters[i]->ptr();
+            _gaf_database->clear_discipline_and_system();
+            _flutter_solver->clear_assembly_object();
+            _frequency_domain_fluid_assembly->clear_discipline_and_system();
             
-            // calculate sensitivity only if the flutter root was found
-            // else, set it to zero
-            if (sol.second) {
-                
-                _gaf_database->attach_discipline_and_system(*_structural_discipline,
-                                                            *_structural_sys_init);
-                
-                _frequency_domain_fluid_assembly->attach_discipline_and_system(*_fluid_discipline,
-                                                                               *_complex_solver,
-                                                                               *_fluid_sys_init);
-                _frequency_domain_fluid_assembly->set_base_solution(base_sol);
-                _frequency_domain_fluid_assembly->set_frequency_function(*_freq_function);
-                
-                _gaf_database->init(_freq_function,
-                                    _complex_solver,                       // fluid complex solver
-                                    _pressure_function,
-                                    _freq_domain_pressure_function,
-                                    _displ);
-                _flutter_solver->attach_assembly(*_gaf_database);
-                _flutter_solver->initialize(*_omega,
-                                            *_b_ref,
-                                            _flight_cond->rho(),
-                                            _k_lower,         // lower kr
-                                            _k_upper,         // upper kr
-                                            _n_k_divs,        // number of divisions
-                                            _basis);          // basis vectors
-
-                _flutter_solver->calculate_sensitivity(*sol.second, params, 0);
-
-                _gaf_database->clear_discipline_and_system();
-                _flutter_solver->clear_assembly_object();
-                _frequency_domain_fluid_assembly->clear_discipline_and_system();
-
-                // copy the sensitivity values in the output
+            // copy the sensitivity values in the output
+            for (unsigned int i=0; i<_n_vars; i++)
                 grads[i] = -_dv_scaling[i] *
-                _V0_flutter / pow(sol.second->V,2) * sol.second->V_sens;
-            }
-            else
-                grads[i] = 0.;
+                _V0_flutter / pow(sol.second->V,2) * V_sens[i];
         }
+        else
+            std::fill(grads.begin(), grads.end(), 0.);
         
         // tell all ranks about the gradients
         this->comm().broadcast(grads);
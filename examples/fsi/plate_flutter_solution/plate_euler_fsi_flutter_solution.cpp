@@ -37,6 +37,7 @@
 #include "base/constant_field_function.h"
 #include "base/boundary_condition_base.h"
 #include "base/complex_mesh_field_function.h"
+#include "base/mesh_field_transfer_operator.h"
 #include "elasticity/complex_normal_rotation_mesh_function.h"
 #include "aeroelasticity/frequency_function.h"
 #include "aeroelasticity/ug_flutter_root.h"
@@ -88,6 +89,7 @@ _slip_wall                             (nullptr),
 _pressure                              (nullptr),
 _displ                                 (nullptr),
 _normal_rot                            (nullptr),
+_displ_transfer                        (nullptr),
 _pressure_function                     (nullptr),
 _freq_domain_pressure_function         (nullptr),
 _omega                                 (nullptr),
@@ -419,6 +421,8 @@ _augment_send_list_obj                 (nullptr) {
                                                        "frequency_domain_displacement");
     _normal_rot   = new MAST::ComplexNormalRotationMeshFunction("frequency_domain_normal_rotation",
                                                                 *_displ);
+    _displ_transfer = new MAST::MeshFieldTransferOperator(*_structural_sys_init);
+    _displ->set_transfer_operator(_displ_transfer);
     _slip_wall->add(*_displ);
     _slip_wall->add(*_normal_rot);
     
@@ -528,6 +532,7 @@ MAST::PlateEulerFSIFlutterAnalysis::~PlateEulerFSIFlutterAnalysis() {
     
     delete _displ;
     delete _normal_rot;
+    delete _displ_transfer;
     delete _pressure;
     
     delete _structural_eq_sys;
@@ -743,6 +748,11 @@ MAST::PlateEulerFSIFlutterAnalysis::solve(bool if_write_output,
                       _pressure_function,
                       _freq_domain_pressure_function,
                       _displ);
+    
+    // the fluid solutions of all modes share one matrix assembly and
+    // preconditioner setup
+    fsi_assembly.set_multiple_rhs_solve(true);
+    
     _flutter_solver->attach_assembly(fsi_assembly);
     _flutter_solver->initialize(*_omega,
                                 *_b_ref,
@@ -58,6 +58,7 @@ namespace MAST {
     class FlightCondition;
     class FrequencyFunction;
     class ComplexMeshFieldFunction;
+    class MeshFieldTransferOperator;
     class ComplexNormalRotationMeshFunction;
     class PressureFunction;
     class FrequencyDomainPressureFunction;
@@ -146,6 +147,13 @@ namespace MAST {
         MAST::ComplexMeshFieldFunction                    *_displ;
         MAST::ComplexNormalRotationMeshFunction           *_normal_rot;
         
+        /*!
+         *   interpolation of the structural modes on the fluid boundary
+         *   quadrature points, computed once and reused for all modes
+         *   and reduced frequencies
+         */
+        MAST::MeshFieldTransferOperator                   *_displ_transfer;
+        
         
         /*!
          *   surface pressure
@@ -242,16 +242,19 @@ _augment_send_list_obj                 (nullptr) {
     z_coord_divs->init(nz_divs, z_div_loc, z_relative_dx, z_divs);
     
     
-    // initialize the mesh
-    MAST::PanelMesh3DHalfDomain().init(0.,               // t/c
-                                       false,            // if cos bump
-                                       0,                // n max bumps in x
-                                       0,                // n max bumps in y
-                                       panel_bc_id,
-                                       symmetry_bc_id,
-                                       divs,
-                                       *_fluid_mesh,
-                                       elem_type);
+    // initialize the mesh. With distributed_mesh_generation, each
+    // processor creates only its block of the mesh
+    MAST::PanelMesh3DHalfDomain mesh_init;
+    mesh_init.set_distributed_generation(infile("distributed_mesh_generation", false));
+    mesh_init.init(0.,               // t/c
+                   false,            // if cos bump
+                   0,                // n max bumps in x
+                   0,                // n max bumps in y
+                   panel_bc_id,
+                   symmetry_bc_id,
+                   divs,
+                   *_fluid_mesh,
+                   elem_type);
     
     _fluid_discipline   = new MAST::ConservativeFluidDiscipline(*_fluid_eq_sys);
     _fluid_sys_init     = new MAST::ConservativeFluidSystemInitialization(*_fluid_sys,
@@ -761,6 +764,11 @@ MAST::PlateEulerFSIHalfDomainFlutterAnalysis::solve(bool if_write_output,
                       _pressure_function,
                       _freq_domain_pressure_function,
                       _displ);
+    
+    // the fluid solutions of all modes share one matrix assembly and
+    // preconditioner setup
+    fsi_assembly.set_multiple_rhs_solve(true);
+    
     _flutter_solver->attach_assembly(fsi_assembly);
     _flutter_solver->initialize(*_omega,
                                 *_b_ref,
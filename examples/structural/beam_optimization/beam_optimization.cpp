@@ -25,6 +25,7 @@
 #include "elasticity/stress_output_base.h"
 #include "optimization/optimization_interface.h"
 #include "optimization/function_evaluation.h"
+#include "optimization/optimization_history.h"
 #include "elasticity/structural_nonlinear_assembly.h"
 #include "base/nonlinear_system.h"
 
@@ -173,7 +174,8 @@ BeamBendingSizingOptimization(const libMesh::Parallel::Communicator& comm):
 MAST::FunctionEvaluation(comm),
 _initialized(false),
 _n_elems(0),
-_n_stations(0) { }
+_n_stations(0),
+_group_eval(nullptr) { }
 
 
 void
@@ -183,6 +185,31 @@ MAST::BeamBendingSizingOptimization::init(GetPot &infile,
     
     libmesh_assert(!_initialized);
     
+    this->_init_analysis(infile, etype, if_nonlin);
+    
+    // the sensitivity of each design variable is computed on the copy of
+    // the analysis of the group that owns it
+    const unsigned int
+    n_groups = infile("n_sensitivity_groups", 1);
+    
+    if (n_groups > 1) {
+        
+        this->set_n_sensitivity_groups(n_groups);
+        
+        _group_eval = new MAST::BeamBendingSizingOptimization(this->sensitivity_comm());
+        _group_eval->_init_analysis(infile, etype, if_nonlin);
+    }
+}
+
+
+
+void
+MAST::BeamBendingSizingOptimization::_init_analysis(GetPot &infile,
+                                                    libMesh::ElemType etype,
+                                                    bool if_nonlin) {
+    
+    libmesh_assert(!_initialized);
+    
     // number of elements
     _n_elems    = infile("n_elems", 20);
     
@@ -204,8 +231,15 @@ MAST::BeamBendingSizingOptimization::init(GetPot &infile,
     // limit stress
     _stress_limit  = infile("max_stress", 4.00e8);
     
-    // create the mesh
-    _mesh          = new libMesh::SerialMesh(__init->comm());
+    // sensitivity only for the stresses close to the limit
+    this->set_active_set_screening(infile("active_set_screening", false),
+                                   infile("active_set_tolerance",  -0.1));
+    
+    // create the mesh. This is distributed, so that each processor stores
+    // only its partition. The element ids are retained to identify the
+    // stress constraint of each element.
+    _mesh          = new libMesh::ParallelMesh(this->comm());
+    _mesh->allow_renumbering(false);
     
     // initialize the mesh with one element
     libMesh::MeshTools::Generation::build_line(*_mesh, _n_elems, 0, _length, etype);
@@ -353,10 +387,13 @@ MAST::BeamBendingSizingOptimization::init(GetPot &infile,
     _discipline->set_property_for_subdomain(0, *_p_card);
     
     
-    // create the output objects, one for each element
+    // create the output objects, one for each local element. The
+    // outputs of elements of other processors are nullptr.
     libMesh::MeshBase::const_element_iterator
-    e_it    = _mesh->elements_begin(),
-    e_end   = _mesh->elements_end();
+    e_it    = _mesh->active_local_elements_begin(),
+    e_end   = _mesh->active_local_elements_end();
+    
+    _outputs.resize(_n_elems, nullptr);
     
     // points where stress is evaluated
     std::vector<libMesh::Point> pts;
@@ -375,7 +412,9 @@ MAST::BeamBendingSizingOptimization::init(GetPot &infile,
         output->set_elements_in_domain(e_set);
         output->set_points_for_evaluation(pts);
         output->set_volume_loads(_discipline->volume_loads());
-        _outputs.push_back(output);
+        
+        libmesh_assert_less((*e_it)->id(), _n_elems);
+        _outputs[(*e_it)->id()] = output;
         
         _discipline->add_volume_output((*e_it)->subdomain_id(), *output);
     }
@@ -400,6 +439,8 @@ MAST::BeamBendingSizingOptimization::~BeamBendingSizingOptimization() {
     if (!_initialized)
         return;
     
+    delete _group_eval;
+    
     delete _m_card;
     delete _p_card;
     
@@ -490,10 +531,6 @@ MAST::BeamBendingSizingOptimization::evaluate(const std::vector<Real>& dvars,
     libmesh_assert(_initialized);
     libmesh_assert_equal_to(dvars.size(), _n_vars);
     
-    // set the parameter values equal to the DV value
-    for (unsigned int i=0; i<_n_vars; i++)
-        (*_thy_station_parameters[i]) = dvars[i]*_dv_scaling[i];
-    
     // DO NOT zero out the gradient vector, since GCMMA needs it for the
     // subproblem solution
     
@@ -501,6 +538,83 @@ MAST::BeamBendingSizingOptimization::evaluate(const std::vector<Real>& dvars,
     
     libMesh::out << "New Eval" << std::endl;
     
+    this->_analyze(dvars, obj, fvals);
+    
+    
+    //////////////////////////////////////////////////////////////////
+    //   evaluate sensitivity if needed
+    //////////////////////////////////////////////////////////////////
+    
+    // sensitivity of the objective function
+    if (eval_obj_grad) {
+        
+        Real w_sens = 0.;
+        
+        // set gradient of weight
+        for (unsigned int i=0; i<_n_vars; i++) {
+            _weight->derivative(*_thy_station_parameters[i],
+                                pt,
+                                0.,
+                                w_sens);
+            obj_grad[i] = w_sens*_dv_scaling[i];
+        }
+        
+    }
+    
+    
+    // with active set screening, the sensitivity is computed only for
+    // the stress constraints close to the limit
+    this->screen_active_constraints(fvals, eval_grads);
+    
+    
+    // now check if the sensitivity of objective function is requested
+    bool if_sens = false;
+    
+    for (unsigned int i=0; i<eval_grads.size(); i++)
+        if_sens = (if_sens || eval_grads[i]);
+    
+    if (if_sens) {
+        
+        if (_history)
+            _history->start_phase(MAST::OptimizationHistory::SENSITIVITY);
+        
+        if (_group_eval) {
+            
+            // each group solves the design on its copy of the analysis,
+            // and computes the sensitivity of the variables it owns
+            Real o = 0.;
+            std::vector<Real> f(fvals.size(), 0.);
+            
+            _group_eval->_analyze(dvars, o, f);
+            _group_eval->_stress_sensitivity(*this, eval_grads, grads);
+            
+            this->gather_sensitivity(grads, _n_ineq);
+        }
+        else
+            this->_stress_sensitivity(*this, eval_grads, grads);
+        
+        if (_history)
+            _history->stop_phase(MAST::OptimizationHistory::SENSITIVITY);
+    }
+    
+    
+    // write the evaluation output
+    this->output(0, dvars, obj, fvals, false);
+}
+
+
+
+void
+MAST::BeamBendingSizingOptimization::_analyze(const std::vector<Real>& dvars,
+                                              Real& obj,
+                                              std::vector<Real>& fvals) {
+    
+    // set the parameter values equal to the DV value
+    for (unsigned int i=0; i<_n_vars; i++)
+        (*_thy_station_parameters[i]) = dvars[i]*_dv_scaling[i];
+    
+    libMesh::Point pt; // dummy point object
+    
     // the optimization problem is defined as
     // min weight, subject to constraints on displacement and stresses
     Real
@@ -534,77 +648,91 @@ MAST::BeamBendingSizingOptimization::evaluate(const std::vector<Real>& dvars,
     // set the function and objective values
     obj = wt;
     
-    // copy the element von Mises stress values as the functions
+    // copy the element von Mises stress values as the functions. Each
+    // value is computed by the processor that owns the element.
+    std::vector<Real> stress(_n_elems, 0.);
     for (unsigned int i=0; i<_n_elems; i++)
-        fvals[i] =  -1. +
-        _outputs[i]->von_Mises_p_norm_functional_for_all_elems(pval)/_stress_limit;
+        if (_outputs[i])
+            stress[i] =
+            _outputs[i]->von_Mises_p_norm_functional_for_all_elems(pval)/_stress_limit;
+    this->comm().sum(stress);
     
+    for (unsigned int i=0; i<_n_elems; i++)
+        fvals[i] =  -1. + stress[i];
+}
+
+
+
+void
+MAST::BeamBendingSizingOptimization::
+_stress_sensitivity(const MAST::FunctionEvaluation& owner,
+                    const std::vector<bool>& eval_grads,
+                    std::vector<Real>& grads) {
+    
+    const Real
+    pval    = 2.;
+    
+    for (unsigned int i=0; i<_n_elems; i++)
+        if (_outputs[i])
+            _outputs[i]->set_sensitivity_active(eval_grads[i]);
     
+    std::vector<Real> stress(_n_elems, 0.);
     
     //////////////////////////////////////////////////////////////////
-    //   evaluate sensitivity if needed
+    // indices used by GCMMA follow this rule:
+    // grad_k = dfi/dxj  ,  where k = j*NFunc + i
     //////////////////////////////////////////////////////////////////
     
-    // sensitivity of the objective function
-    if (eval_obj_grad) {
+    // we are going to choose to use one parametric sensitivity at a time
+    for (unsigned int i=0; i<_n_vars; i++) {
         
-        Real w_sens = 0.;
+        // the other variables are computed by the other groups
+        if (!owner.if_sensitivity_group_owns(i))
+            continue;
         
-        // set gradient of weight
-        for (unsigned int i=0; i<_n_vars; i++) {
-            _weight->derivative(*_thy_station_parameters[i],
-                                pt,
-                                0.,
-                                w_sens);
-            obj_grad[i] = w_sens*_dv_scaling[i];
-        }
+        libMesh::ParameterVector params;
+        params.resize(1);
+        params[0]  = _thy_station_parameters[i]->ptr();
         
-    }
-    
-    
-    // now check if the sensitivity of objective function is requested
-    bool if_sens = false;
-    
-    for (unsigned int i=0; i<eval_grads.size(); i++)
-        if_sens = (if_sens || eval_grads[i]);
-    
-    if (if_sens) {
+        // iterate over each dv and calculate the sensitivity
+        _sys->add_sensitivity_solution(0).zero();
+        this->clear_stresss();
         
-        //////////////////////////////////////////////////////////////////
-        // indices used by GCMMA follow this rule:
-        // grad_k = dfi/dxj  ,  where k = j*NFunc + i
-        //////////////////////////////////////////////////////////////////
+        // sensitivity analysis
+        _sys->sensitivity_solve(params);
         
-        // we are going to choose to use one parametric sensitivity at a time
-        for (unsigned int i=0; i<_n_vars; i++) {
-            
-            libMesh::ParameterVector params;
-            params.resize(1);
-            params[0]  = _thy_station_parameters[i]->ptr();
-            
-            // iterate over each dv and calculate the sensitivity
-            _sys->add_sensitivity_solution(0).zero();
-            this->clear_stresss();
-            
-            // sensitivity analysis
-            _sys->sensitivity_solve(params);
-            
-            // evaluate sensitivity of the outputs
-            _assembly->calculate_output_sensitivity(params,
-                                                    true,    // true for total sensitivity
-                                                    *(_sys->solution));
-            
-            // copy the sensitivity values in the output
-            for (unsigned int j=0; j<_n_elems; j++)
-                grads[i*_n_elems+j] = _dv_scaling[i]/_stress_limit *
+        // evaluate sensitivity of the outputs
+        _assembly->calculate_output_sensitivity(params,
+                                                true,    // true for total sensitivity
+                                                *(_sys->solution));
+        
+        // copy the sensitivity values in the output
+        std::fill(stress.begin(), stress.end(), 0.);
+        for (unsigned int j=0; j<_n_elems; j++)
+            if (eval_grads[j] && _outputs[j])
+                stress[j] = _dv_scaling[i]/_stress_limit *
                 _outputs[j]->von_Mises_p_norm_functional_sensitivity_for_all_elems
                 (pval, _thy_station_parameters[i]);
-        }
+        this->comm().sum(stress);
+        
+        for (unsigned int j=0; j<_n_elems; j++)
+            if (eval_grads[j])
+                grads[i*_n_elems+j] = stress[j];
     }
-    
-    
-    // write the evaluation output
-    this->output(0, dvars, obj, fvals, false);
+}
+
+
+
+void
+MAST::BeamBendingSizingOptimization::
+_evaluate_on_group(const std::vector<Real>& dvars,
+                   Real& obj,
+                   std::vector<Real>& fvals) {
+    
+    if (_group_eval)
+        _group_eval->_analyze(dvars, obj, fvals);
+    else
+        this->_analyze(dvars, obj, fvals);
 }
 
 
@@ -620,7 +748,8 @@ MAST::BeamBendingSizingOptimization::clear_stresss() {
     end  =   _outputs.end();
     
     for ( ; it != end; it++)
-        (*it)->clear(false);
+        if (*it)
+            (*it)->clear(false);
 }
 
 
@@ -42,7 +42,7 @@
 // libMesh includes
 #include "libmesh/libmesh.h"
 #include "libmesh/equation_systems.h"
-#include "libmesh/serial_mesh.h"
+#include "libmesh/parallel_mesh.h"
 #include "libmesh/mesh_generation.h"
 #include "libmesh/nonlinear_implicit_system.h"
 #include "libmesh/fe_type.h"
@@ -83,11 +83,24 @@ namespace MAST {
         
         
         /*!
-         *   initializes the object for specified characteristics
+         *   initializes the object for specified characteristics. If
+         *   \p n_sensitivity_groups in \p infile is greater than 1, the
+         *   ranks are split into sensitivity groups, and each group
+         *   creates a copy of the analysis on its ranks, which computes
+         *   the sensitivity of the design variables owned by the group.
          */
         void init(GetPot& infile,
                   libMesh::ElemType etype,
                   bool if_nonlin);
+        
+        
+        /*!
+         *   creates the mesh, system, properties and outputs of the
+         *   analysis on the communicator of this object
+         */
+        void _init_analysis(GetPot& infile,
+                            libMesh::ElemType etype,
+                            bool if_nonlin);
 
         
         /*!
@@ -109,6 +122,35 @@ namespace MAST {
                               std::vector<bool>& eval_grads,
                               std::vector<Real>& grads);
         
+        /*!
+         *   solves the analysis at \p dvars, and computes the objective
+         *   \p obj and stress constraints \p fvals
+         */
+        void _analyze(const std::vector<Real>& dvars,
+                      Real& obj,
+                      std::vector<Real>& fvals);
+        
+        
+        /*!
+         *   computes the sensitivity of the stress constraints flagged in
+         *   \p eval_grads at the design of the last call to _analyze(),
+         *   for the design variables owned by the sensitivity group of
+         *   \p owner.
+         */
+        void _stress_sensitivity(const MAST::FunctionEvaluation& owner,
+                                 const std::vector<bool>& eval_grads,
+                                 std::vector<Real>& grads);
+        
+        
+        /*!
+         *   evaluates the design on the copy of the analysis of the
+         *   sensitivity group of this rank, for evaluate_many()
+         */
+        virtual void _evaluate_on_group(const std::vector<Real>& dvars,
+                                        Real& obj,
+                                        std::vector<Real>& fvals);
+        
+        
         /*!
          *   customized output
          */
@@ -154,7 +196,7 @@ namespace MAST {
         _n_stations;
         
         // create the mesh
-        libMesh::SerialMesh*           _mesh;
+        libMesh::ParallelMesh*         _mesh;
         
         // create the equation system
         libMesh::EquationSystems*      _eq_sys;
@@ -228,6 +270,12 @@ namespace MAST {
         _dv_scaling,
         _dv_low,
         _dv_init;
+        
+        /*!
+         *   copy of the analysis on the ranks of the sensitivity group of
+         *   this rank, if more than one group is used
+         */
+        MAST::BeamBendingSizingOptimization*            _group_eval;
     };
 }
 
@@ -94,6 +94,9 @@ MAST::BeamWeight::operator() (const libMesh::Point& p,
         }
         
     }
+    
+    // the weight of the local elements is summed over all processors
+    mesh.comm().sum(v);
 }
 
 
@@ -163,6 +166,9 @@ MAST::BeamWeight::derivative(const MAST::FunctionBase& f,
         }
         
     }
+    
+    // the sensitivity of the local elements is summed over all processors
+    mesh.comm().sum(v);
 }
 
 
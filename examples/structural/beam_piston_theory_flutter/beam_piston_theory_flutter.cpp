@@ -367,6 +367,11 @@ MAST::BeamPistonTheoryFlutterAnalysis::solve(bool if_write_output,
     fsi_assembly.attach_discipline_and_system(*_discipline,
                                               *_structural_sys);
     _flutter_solver->attach_assembly(fsi_assembly);
+    
+    // the piston theory loads at a fixed Mach number are quadratic in
+    // velocity, so that the structural quantities need not be assembled
+    // for each velocity
+    _flutter_solver->set_velocity_polynomial_cache(true);
     _flutter_solver->initialize(*_velocity,
                                 1.e3,        // lower V
                                 1200.,         // upper V
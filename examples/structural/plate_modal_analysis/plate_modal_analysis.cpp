@@ -54,7 +54,8 @@ _initialized(false) {
 
 void
 MAST::PlateModalAnalysis::init(libMesh::ElemType e_type,
-                               bool if_vk) {
+                               bool if_vk,
+                               unsigned int n_divs) {
     
     
     libmesh_assert(!_initialized);
@@ -70,7 +71,7 @@ MAST::PlateModalAnalysis::init(libMesh::ElemType e_type,
     
     // initialize the mesh with one element
     libMesh::MeshTools::Generation::build_square(*_mesh,
-                                                 32, 32,
+                                                 n_divs, n_divs,
                                                  0, _length,
                                                  0, _width,
                                                  e_type);
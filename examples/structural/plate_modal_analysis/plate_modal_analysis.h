@@ -62,9 +62,12 @@ namespace MAST {
         
 
         /*!
-         *   initializes the object for specified characteristics
+         *   initializes the object for specified characteristics, with
+         *   \p n_divs elements along each edge of the plate
          */
-        void init(libMesh::ElemType e_type, bool if_vk);
+        void init(libMesh::ElemType e_type,
+                  bool if_vk,
+                  unsigned int n_divs = 32);
         
         
         /*!
@@ -36,6 +36,7 @@
 #include "property_cards/isotropic_material_property_card.h"
 #include "boundary_condition/dirichlet_boundary_condition.h"
 #include "base/nonlinear_system.h"
+#include "base/async_output_writer.h"
 
 
 // libMesh includes
@@ -417,8 +418,9 @@ MAST::PlateOscillatingLoad::solve(bool if_write_output) {
     this->clear_stresss();
     
     
-    // file to write the solution for visualization
-    libMesh::ExodusII_IO exodus_writer(*_mesh);
+    // the solution is written for visualization from a background thread,
+    // so that the time loop does not wait on the file system
+    MAST::AsyncOutputWriter output_writer(_mesh->comm());
     
     
     // time solver parameters
@@ -435,6 +437,10 @@ MAST::PlateOscillatingLoad::solve(bool if_write_output) {
     
     solver.dt         = t_period/n_steps_per_cycle;
     
+    // without the von Karman strain the problem is linear, and the
+    // operator of the time step is factorized only once
+    solver.set_linear_solve(!if_vk);
+    
     
     // ask the solver to update the initial condition for d2(X)/dt2
     // This is recommended only for the initial time step, since the time
@@ -457,10 +463,9 @@ MAST::PlateOscillatingLoad::solve(bool if_write_output) {
         // write the time-step
         if (if_write_output) {
             
-            exodus_writer.write_timestep("output.exo",
-                                         *_eq_sys,
-                                         t_step+1,
-                                         nonlin_sys.time);
+            output_writer.write_exodus_timestep("output.exo",
+                                                *_eq_sys,
+                                                nonlin_sys.time);
             
         }
         
@@ -472,6 +477,8 @@ MAST::PlateOscillatingLoad::solve(bool if_write_output) {
         t_step++;
     }
     
+    output_writer.flush();
+    
     assembly.clear_discipline_and_system();
     
     return *(_sys->solution);
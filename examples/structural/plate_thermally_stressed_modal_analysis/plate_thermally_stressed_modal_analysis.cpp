@@ -74,6 +74,7 @@ init(libMesh::ElemType e_type, bool if_vk) {
     _width      = infile("ly", 0.3);
     
     _n_steps    = infile("n_steps", 15);
+    _continuation = infile("continuation", true);
     
     // create the mesh
     _mesh       = new libMesh::SerialMesh(__init->comm());
@@ -410,6 +411,18 @@ MAST::PlateThermallyStressedModalAnalysis::solve(bool if_write_output,
     //  store the base solution
     libMesh::NumericVector<Real>& base_sol = _sys->add_vector("base_solution");
 
+    // converged solution of the previous load step, which is used for
+    // the predictor of the static solution in continuation
+    std::auto_ptr<libMesh::NumericVector<Real> >
+    prev_sol(_sys->solution->zero_clone().release());
+    
+    bool
+    if_predict = false;
+    
+    // with continuation the modes of a load step are used as the initial
+    // space of the eigensolver at the next load step
+    _sys->eigen_solver->set_reuse_eigenvectors(_continuation);
+    
     // zero the solution before solving
     _sys->solution->zero();
     
@@ -422,6 +435,20 @@ MAST::PlateThermallyStressedModalAnalysis::solve(bool if_write_output,
         libMesh::out
         << "Load step: " << i_step << "  Temp = " << (*_temp)() << "  p: " << (*_press)()  << std::endl;
         
+        // the load steps have equal increments, so that the solution of
+        // this step is predicted by linear extrapolation of the solutions
+        // of the two previous steps. The predictor is not used after the
+        // solution was perturbed in a mode.
+        base_sol = *_sys->solution;
+        if (_continuation && if_predict) {
+            
+            _sys->solution->scale(2.);
+            _sys->solution->add(-1., *prev_sol);
+            _sys->solution->close();
+        }
+        *prev_sol  = base_sol;
+        if_predict = true;
+        
         assembly.attach_discipline_and_system(*_discipline, *_structural_sys);
         _sys->solve();
         
@@ -493,6 +520,7 @@ MAST::PlateThermallyStressedModalAnalysis::solve(bool if_write_output,
                 *_sys->solution = base_sol;
                 _sys->solution->scale(1./_sys->solution->linfty_norm()*1.e-1);
                 n_perturb++;
+                if_predict = false;
             }
             
             if (if_write_output) {
@@ -522,6 +550,8 @@ MAST::PlateThermallyStressedModalAnalysis::solve(bool if_write_output,
     // delete the exodus writes for the modes
     for (unsigned int i=0; i<n_eig_req; i++)
         delete mode_writer[i];
+    
+    _sys->eigen_solver->set_reuse_eigenvectors(false);
 
 }
 
@@ -102,6 +102,10 @@ namespace MAST {
         // n load steps
         unsigned int _n_steps;
         
+        // continuation along the load steps with a predictor of the
+        // static solution and reuse of the modes in the eigensolver
+        bool _continuation;
+        
         // create the mesh
         libMesh::SerialMesh*           _mesh;
         
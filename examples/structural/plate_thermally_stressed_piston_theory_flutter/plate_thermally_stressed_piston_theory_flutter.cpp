@@ -407,7 +407,13 @@ namespace MAST {
         _if_write_output(if_output),
         _n_steps(25),
         _if_only_aero_load_steps(false),
-        _if_clear_vector_on_exit(if_clear_vector_on_exit) {
+        _if_clear_vector_on_exit(if_clear_vector_on_exit),
+        _if_continuation(false),
+        _if_path_state(false),
+        _V_path(0.),
+        _T_path(0.),
+        _dV_prev(0.),
+        _dT_prev(0.) {
             
             _obj._sys->add_vector("base_solution");
         }
@@ -458,20 +464,53 @@ namespace MAST {
             // zero the solution before solving
             _obj.clear_stresss();
             
+            // with continuation, the load steps start from the converged
+            // state of the previous solve, which is the initial solution.
+            // Otherwise, the loads are stepped from zero.
+            bool
+            if_continue = (_if_continuation &&
+                           _if_path_state   &&
+                           (!_if_only_aero_load_steps || T0 == _T_path));
+            
+            Real
+            V_start = if_continue ? _V_path : 0.,
+            T_start = if_continue ? _T_path : 0.,
+            V_step  = V_start,
+            T_step  = _if_only_aero_load_steps ? T0 : T_start;
+            
+            if (!if_continue) {
+                
+                _x_prev.reset();
+                _dV_prev = 0.;
+                _dT_prev = 0.;
+            }
+            
             // now iterate over the load steps
             for (unsigned int i=0; i<n_steps; i++) {
                 libMesh::out
                 << "Load step: " << i << std::endl;
 
                 // modify aero component
-                (*_obj._velocity)()  =  V0*(i+1.)/(1.*n_steps);
+                (*_obj._velocity)()  =  V_start + (V0-V_start)*(i+1.)/(1.*n_steps);
                 
                 // modify the thermal load if specified by the user
                 if (!_if_only_aero_load_steps)
-                    (*_obj._temp)()      =  T0*(i+1.)/(1.*n_steps);
+                    (*_obj._temp)()      =  T_start + (T0-T_start)*(i+1.)/(1.*n_steps);
+                
+                if (_if_continuation)
+                    _predict((*_obj._velocity)() - V_step,
+                             (*_obj._temp)()     - T_step);
+                
+                V_step = (*_obj._velocity)();
+                T_step = (*_obj._temp)();
+                
                 nonlin_sys.solve();
             }
             
+            _if_path_state = true;
+            _V_path        = V0;
+            _T_path        = T0;
+            
             // evaluate the outputs
             //nonlin_assembly.calculate_outputs(*(_obj._sys->solution));
             
@@ -515,6 +554,20 @@ namespace MAST {
         void set_modify_only_aero_load(bool f) {
             _if_only_aero_load_steps = f;
         }
+        
+        
+        /*!
+         *   Tells the solver to step the loads of a solve from the
+         *   converged state of the previous solve, instead of from zero
+         *   load, so that a sequence of velocities or temperatures is
+         *   computed along one path. The solution of each load step is
+         *   predicted by extrapolating the converged solutions of the
+         *   two previous steps. \p false by default.
+         */
+        void set_continuation(bool f) {
+            _if_continuation = f;
+            if (!f) _x_prev.reset();
+        }
 
         
         /*!
@@ -526,6 +579,47 @@ namespace MAST {
         
     protected:
         
+        /*!
+         *   sets the initial solution of a load step with increments
+         *   \p dV and \p dT of the velocity and temperature. The current
+         *   solution is the converged solution of the previous step, and
+         *   the difference to the solution before that is scaled with the
+         *   ratio of the load increments of the two steps.
+         */
+        void _predict(Real dV, Real dT) {
+            
+            libMesh::NumericVector<Real>& x = *_obj._sys->solution;
+            
+            Real
+            r = 0.;
+            
+            if (_dV_prev != 0.)
+                r = dV/_dV_prev;
+            else if (_dT_prev != 0.)
+                r = dT/_dT_prev;
+            
+            if (!_x_prev.get())
+                _x_prev.reset(x.clone().release());
+            else {
+                
+                std::auto_ptr<libMesh::NumericVector<Real> >
+                x0(x.clone().release());
+                
+                if (r != 0.) {
+                    
+                    x.scale(1.+r);
+                    x.add(-r, *_x_prev);
+                    x.close();
+                }
+                
+                *_x_prev = *x0;
+            }
+            
+            _dV_prev = dV;
+            _dT_prev = dT;
+        }
+        
+        
         /*!
          *   pointer to the object that hold all the solution data
          */
@@ -552,6 +646,27 @@ namespace MAST {
          *   destructed unless this flag is false.
          */
         bool _if_clear_vector_on_exit;
+        
+        /*!
+         *   flag for continuation from the state of the previous solve
+         */
+        bool _if_continuation;
+        
+        /*!
+         *   true after a solve, when \p _V_path and \p _T_path are the
+         *   velocity and temperature of the converged base solution
+         */
+        bool _if_path_state;
+        
+        Real _V_path, _T_path;
+        
+        /*!
+         *   converged solution before the last load step, and the load
+         *   increments of the last step, used by the predictor
+         */
+        std::auto_ptr<libMesh::NumericVector<Real> > _x_prev;
+        
+        Real _dV_prev, _dT_prev;
     };
 }
 
@@ -574,6 +689,7 @@ solve(bool if_write_output,
     // solution
     steady_solve.set_n_load_steps(4);
     steady_solve.set_modify_only_aero_load(true);
+    steady_solve.set_continuation(true);
     
     
     ///////////////////////////////////////////////////////////////
@@ -299,6 +299,8 @@ init(GetPot& infile,
     _eq_sys->init();
     _sys->initialize_condensed_dofs(*_discipline);
     _sys->eigen_solver->set_position_of_spectrum(libMesh::LARGEST_MAGNITUDE);
+    // the modes of a design iteration are the initial space of the next
+    dynamic_cast<MAST::SlepcEigenSolver&>(*_sys->eigen_solver).set_reuse_eigenvectors(true);
     _sys->set_exchange_A_and_B(true);
     _sys->set_n_requested_eigenvalues(20);
     
@@ -870,13 +872,41 @@ evaluate(const std::vector<Real>& dvars,
                                                 *_structural_sys);
     _flutter_solver->clear_solutions();
     _flutter_solver->attach_assembly(*_fsi_assembly);
+    
+    // for a small design step the scan is limited to an interval around
+    // the flutter velocity of the previous iteration, and the full
+    // interval is scanned only if no root is found
+    const std::pair<Real, Real>
+    V_full(0.0e3, 2*_V0_flutter);
+    std::pair<Real, Real>
+    V_range = V_full;
+    if (_state.if_warm_start(dvars, 0.05))
+        V_range = _state.flutter_scan_range(V_full.first, V_full.second, 0.25);
+    
     _flutter_solver->initialize(*_velocity,
-                                0.0e3,                // lower V
-                                2*_V0_flutter,        // upper V
+                                V_range.first,        // lower V
+                                V_range.second,       // upper V
                                 _n_V_divs_flutter,    // number of divisions
                                 _basis);              // basis vectors
     std::pair<bool, MAST::FlutterRootBase*>
     sol = _flutter_solver->analyze_and_find_critical_root_without_tracking(1.e-3, 20);
+    
+    if (!sol.second && V_range != V_full) {
+        
+        _flutter_solver->clear_solutions();
+        _flutter_solver->initialize(*_velocity,
+                                    V_full.first,         // lower V
+                                    V_full.second,        // upper V
+                                    _n_V_divs_flutter,    // number of divisions
+                                    _basis);              // basis vectors
+        sol = _flutter_solver->analyze_and_find_critical_root_without_tracking(1.e-3, 20);
+    }
+    
+    if (sol.second)
+        _state.store_flutter_root(*sol.second);
+    else
+        _state.clear_flutter_root();
+    _state.set_design(dvars);
     _flutter_solver->print_sorted_roots();
     _fsi_assembly->clear_discipline_and_system();
     _flutter_solver->clear_assembly_object();
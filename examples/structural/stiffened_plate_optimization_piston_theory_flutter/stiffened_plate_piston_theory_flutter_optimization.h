@@ -37,6 +37,7 @@
 #include "base/constant_field_function.h"
 #include "optimization/gcmma_optimization_interface.h"
 #include "optimization/function_evaluation.h"
+#include "optimization/design_iteration_state.h"
 #include "boundary_condition/dirichlet_boundary_condition.h"
 
 
@@ -274,6 +275,9 @@ namespace MAST {
         // vector of basis vectors from modal analysis
         std::vector<libMesh::NumericVector<Real>*>     _basis;
         
+        // analysis results of the previous design iteration
+        MAST::DesignIterationState                     _state;
+        
         // output quantity objects to evaluate stress
         std::vector<MAST::StressStrainOutputBase*>     _outputs;
         
@@ -351,6 +351,8 @@ init(GetPot& infile,
     _eq_sys->init();
     _sys->initialize_condensed_dofs(*_discipline);
     _sys->eigen_solver->set_position_of_spectrum(libMesh::LARGEST_MAGNITUDE);
+    // the modes of the previous design start the eigensolve of the next
+    _sys->eigen_solver->set_reuse_eigenvectors(true);
     _sys->set_exchange_A_and_B(true);
     _sys->set_n_requested_eigenvalues(_n_eig);
     
@@ -848,6 +850,7 @@ namespace MAST {
         _n_steps(n_steps),
         _if_only_aero_load_steps(false),
         _if_clear_vector_on_exit(if_clear_vector_on_exit),
+        _warm_start(false),
         inc (0) {
             
             _obj._sys->add_vector("base_solution");
@@ -883,7 +886,10 @@ namespace MAST {
             // set the number of load steps
             unsigned int
             n_steps = 1;
-            if (if_vk) n_steps = _n_steps;
+            if (if_vk && !_warm_start) n_steps = _n_steps;
+            
+            // the initial guess applies only to this solve
+            _warm_start = false;
             
             Real
             T0      = (*_obj._temp)(),
@@ -934,6 +940,38 @@ namespace MAST {
         }
         
         
+        /*!
+         *   sets the steady solution to a solution computed earlier
+         */
+        virtual bool
+        set_solution(const libMesh::NumericVector<Real>& x) {
+            
+            libMesh::NumericVector<Real>& sol = _obj._sys->get_vector("base_solution");
+            sol = x;
+            sol.close();
+            *_obj._sys->solution = x;
+            _obj._sys->update();
+            
+            return true;
+        }
+        
+        
+        /*!
+         *   sets the initial guess of the next solve. Since the guess is
+         *   close to the solution, the solve uses a single load step.
+         */
+        virtual bool
+        set_initial_guess(const libMesh::NumericVector<Real>& x) {
+            
+            libMesh::NumericVector<Real>& sol = _obj._sys->get_vector("base_solution");
+            sol = x;
+            sol.close();
+            _warm_start = true;
+            
+            return true;
+        }
+        
+        
         /*!
          *   sets the number of steps to be used for nonlinaer steady analysis.
          *   The default is 25 for noninear and 1 for linear.
@@ -995,6 +1033,12 @@ namespace MAST {
          *   destructed unless this flag is false.
          */
         bool _if_clear_vector_on_exit;
+        
+        /*!
+         *   the next solve starts from an initial guess set by
+         *   set_initial_guess()
+         */
+        bool _warm_start;
         libMesh::ExodusII_IO* writer;
         unsigned int inc;
     };
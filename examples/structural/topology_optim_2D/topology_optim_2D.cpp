@@ -28,6 +28,7 @@
 #include "elasticity/structural_nonlinear_assembly.h"
 #include "base/real_output_function.h"
 #include "base/nonlinear_system.h"
+#include "optimization/design_filter.h"
 
 
 // libMesh includes
@@ -170,55 +171,6 @@ topology_optim_2D_optim_con(int*    mode,
 
 
 
-MAST::YoungsModulus::YoungsModulus(const std::string& nm,
-                                   MAST::FieldFunction<Real> &rho,
-                                   const Real base_modulus,
-                                   const Real penalty):
-MAST::FieldFunction<Real>(nm),
-_rho(rho),
-_base_modulus(base_modulus),
-_penalty(penalty)  {
-    
-    _functions.insert(&rho);
-}
-
-
-
-MAST::YoungsModulus::~YoungsModulus() {
-
-}
-
-
-
-void
-MAST::YoungsModulus::operator() (const libMesh::Point& p,
-                                 Real t,
-                                 Real& v) const {
-    
-    _rho(p, t, v);
-    v = _base_modulus*pow(v, _penalty);
-}
-
-
-void
-MAST::YoungsModulus::derivative(   const MAST::FunctionBase& f,
-                                const libMesh::Point& p,
-                                Real t,
-                                Real& v) const {
-    Real
-    r = 0., dr = 0.;
-    
-    _rho(p, t, r);
-    _rho.derivative( f, p, t, dr);
-    v = _base_modulus*pow(r, _penalty-1.)*_penalty*dr;
-}
-
-
-
-
-
-
-
 MAST::TopologyOptimization2D::
 TopologyOptimization2D(const libMesh::Parallel::Communicator& comm):
 MAST::FunctionEvaluation(comm),
@@ -227,7 +179,9 @@ _penalty(0.),
 _volume_fraction(0.),
 _n_divs_x(0),
 _n_divs_y(0),
-_n_elems(0) { }
+_n_elems(0),
+_filter(nullptr),
+_dv(nullptr) { }
 
 
 
@@ -334,10 +288,50 @@ MAST::TopologyOptimization2D::init(GetPot& infile,
     _discipline->add_volume_output(0, *_output);
     
     
+    // the densities of the elements are stored in the solution of
+    // _rho_sys, and a single property card is used for all elements
+    _rho_f           = new MAST::ElementwiseDesignField("rho", *_rho_sys, 0, 1.);
+    _E_f             = new MAST::ElementwiseDesignField("E",   *_rho_sys, 0, 70.e9);
+    _E_f->set_interpolation(MAST::ElementwiseDesignField::SIMP, _penalty);
+    
+    // create the material property card
+    _m_card          = new MAST::IsotropicMaterialPropertyCard;
+    
+    // add the material properties to the card
+    _m_card->add(     *_E_f);
+    _m_card->add(    *_nu_f);
+    _m_card->add(   *_rho_f);
+    _m_card->add( *_kappa_f);
+    
+    // create the element property card
+    _p_card          = new MAST::Solid2DSectionElementPropertyCard;
+    
+    // add the section properties to the card
+    _p_card->add(*_th_f);
+    _p_card->add(*_hoff_f);
+    
+    // tell the section property about the material property
+    _p_card->set_material(*_m_card);
+    
+    _discipline->set_property_for_subdomain(0, *_p_card);
+    
+    _obj_grad        = _rho_sys->solution->zero_clone().release();
+    
+    // the density filter, if a filter radius is specified. The DVs are
+    // then stored in _dv and filtered to the element densities.
+    const Real
+    filter_radius    = infile("filter_radius", 0.);
+    
+    if (filter_radius > 0.) {
+        
+        _filter      = new MAST::DesignFilter(*_rho_sys, 0, filter_radius);
+        _filter->init();
+        _dv          = _rho_sys->solution->zero_clone().release();
+    }
+    
     // resize the elem vector
     _elems.resize(_n_elems);
 
-    // element iterators to define property cards
     libMesh::MeshBase::element_iterator
     el_it  = _mesh->local_elements_begin(),
     el_end = _mesh->local_elements_end();
@@ -345,94 +339,10 @@ MAST::TopologyOptimization2D::init(GetPot& infile,
     unsigned int
     counter = 0;
     
-    bool
-    insert_success = false;
-    
     for (; el_it != el_end; el_it++) {
         
-        libMesh::Elem* el = *el_it;
-
-        // set the subdomain ID of the element so that the
-        // property card can be associated with this ID
-        el->subdomain_id()      = counter;
-        
-        std::ostringstream oss;
-        oss << "rho_" << counter;
-
-        
-        // create the density parameters for the elements
-        MAST::Parameter*
-        rho    = new MAST::Parameter(oss.str(), 1.);
-        MAST::ConstantFieldFunction*
-        rho_f  = new MAST::ConstantFieldFunction("rho", *rho);
-        MAST::YoungsModulus*
-        E_f    = new MAST::YoungsModulus("E",
-                                         *rho_f,
-                                         70.e9,
-                                         _penalty);
-        
-        
-        // create the material property card
-        MAST::IsotropicMaterialPropertyCard*
-        m_card         = new MAST::IsotropicMaterialPropertyCard;
-        
-        // add the material properties to the card
-        m_card->add(     *E_f);
-        m_card->add(   *_nu_f);
-        m_card->add(   *rho_f);
-        m_card->add(*_kappa_f);
-        
-        // create the element property card
-        MAST::Solid2DSectionElementPropertyCard*
-        p_card         = new MAST::Solid2DSectionElementPropertyCard;
-        
-        // add the section properties to the card
-        p_card->add(*_th_f);
-        p_card->add(*_hoff_f);
-        
-        // tell the section property about the material property
-        p_card->set_material(*m_card);
-        
-        _discipline->set_property_for_subdomain(counter, *p_card);
-        _discipline->add_parameter(*rho);
-        
-        
-        // now add the property and card pointers to the map
-        _elems[counter]         =  el;
-        
-        insert_success =
-        _elem_rho.insert(std::pair<const libMesh::Elem*, MAST::Parameter*>
-                         (el, rho)).second;
-        
-        libmesh_assert(insert_success);
-
-        insert_success =
-        _elem_rho_f.insert(std::pair<const libMesh::Elem*, MAST::ConstantFieldFunction*>
-                           (el, rho_f)).second;
-        
-        libmesh_assert(insert_success);
-
-        
-        insert_success =
-        _elem_E_f.insert(std::pair<const libMesh::Elem*, MAST::YoungsModulus*>
-                         (el, E_f)).second;
-        
-        libmesh_assert(insert_success);
-
-
-        insert_success =
-        _elem_m_card.insert(std::pair<const libMesh::Elem*, MAST::IsotropicMaterialPropertyCard*>
-                            (el, m_card)).second;
-        
-        libmesh_assert(insert_success);
-
-        
-        insert_success =
-        _elem_p_card.insert(std::pair<const libMesh::Elem*, MAST::Solid2DSectionElementPropertyCard*>
-                            (el, p_card)).second;
-        
-        libmesh_assert(insert_success);
-
+        (*el_it)->subdomain_id() = 0;
+        _elems[counter]          = *el_it;
         counter++;
     }
 
@@ -481,56 +391,13 @@ MAST::TopologyOptimization2D::~TopologyOptimization2D() {
         
         delete _output;
         
-        // delete the element data
-        {
-            std::map<const libMesh::Elem*, MAST::Parameter*>::iterator
-            it   = _elem_rho.begin(),
-            end  = _elem_rho.end();
-            
-            for (; it != end; it++)
-                delete it->second;
-        }
-
-
-        {
-            std::map<const libMesh::Elem*, MAST::ConstantFieldFunction*>::iterator
-            it   = _elem_rho_f.begin(),
-            end  = _elem_rho_f.end();
-            
-            for (; it != end; it++)
-                delete it->second;
-        }
-
-        
-        {
-            std::map<const libMesh::Elem*, MAST::YoungsModulus*>::iterator
-            it   = _elem_E_f.begin(),
-            end  = _elem_E_f.end();
-            
-            for (; it != end; it++)
-                delete it->second;
-        }
-
-        
-        {
-            std::map<const libMesh::Elem*, MAST::IsotropicMaterialPropertyCard*>::iterator
-            it   = _elem_m_card.begin(),
-            end  = _elem_m_card.end();
-            
-            for (; it != end; it++)
-                delete it->second;
-        }
-
-        
-        {
-            std::map<const libMesh::Elem*, MAST::Solid2DSectionElementPropertyCard*>::iterator
-            it   = _elem_p_card.begin(),
-            end  = _elem_p_card.end();
-            
-            for (; it != end; it++)
-                delete it->second;
-        }
-
+        delete _obj_grad;
+        delete _filter;
+        delete _dv;
+        delete _p_card;
+        delete _m_card;
+        delete _E_f;
+        delete _rho_f;
     }
 }
 
@@ -564,12 +431,21 @@ MAST::TopologyOptimization2D::evaluate(const std::vector<Real>& dvars,
     
     libmesh_assert_equal_to(dvars.size(), _n_vars);
     
-    // set the parameter values equal to the DV value
-    for (unsigned int i=0; i<_n_vars; i++) {
-        const libMesh::Elem* el = _elems[i];
-        MAST::Parameter* par = _elem_rho[el];
-        (*par)() = dvars[i];
-    }
+    // set the element densities equal to the DV value, or to the
+    // filtered DV values if a filter is used
+    libMesh::NumericVector<Real>&
+    dv = _filter? *_dv : *_rho_sys->solution;
+    
+    for (unsigned int i=0; i<_n_vars; i++)
+        dv.set(_E_f->dof_index(*_elems[i]), dvars[i]);
+    dv.close();
+    
+    if (_filter)
+        _filter->filter(*_dv, *_rho_sys->solution);
+    _E_f->update();
+    
+    std::vector<Real> rho;
+    _rho_sys->solution->localize(rho);
     
     // DO NOT zero out the gradient vector, since GCMMA needs it for the
     // subproblem solution
@@ -606,7 +482,7 @@ MAST::TopologyOptimization2D::evaluate(const std::vector<Real>& dvars,
     total_vol = 0.;
     for (unsigned int i=0; i<_n_elems; i++) {
         vol = _elems[i]->volume();
-        fvals[0]  += dvars[i] * vol; // constraint:  xi vi - V <= 0
+        fvals[0]  += rho[_E_f->dof_index(*_elems[i])] * vol; // constraint:  xi vi - V <= 0
         total_vol += vol;
     }
     fvals[0] /= (total_vol * _volume_fraction);
@@ -621,26 +497,26 @@ MAST::TopologyOptimization2D::evaluate(const std::vector<Real>& dvars,
     // sensitivity of the objective function
     if (eval_obj_grad) {
         
-        // we are going to choose to use one parametric sensitivity at a time
-        for (unsigned int i=0; i<_n_elems; i++) {
-            
-            MAST::Parameter* f = _elem_rho[_elems[i]];
-            
-            libMesh::ParameterVector params;
-            params.resize(1);
-            params[0]  = f->ptr();
-            
-            // iterate over each dv and calculate the sensitivity
-            _sys->add_sensitivity_solution(0).zero();
-            
-            // sensitivity analysis
-            _sys->sensitivity_solve(params);
-            _assembly->calculate_output_sensitivity(params,
-                                                    true,
-                                                    *_sys->solution);
+        // the compliance is self-adjoint, and its sensitivity with
+        // respect to all element densities is computed with a single
+        // pass over the elements
+        _assembly->calculate_elementwise_compliance_sensitivity(*_sys->solution,
+                                                                *_E_f,
+                                                                *_obj_grad);
+        
+        // chain rule for the filtered densities
+        if (_filter) {
             
-            obj_grad[i] = _output->get_sensitivity(f);
+            std::auto_ptr<libMesh::NumericVector<Real> >
+            g(_obj_grad->clone().release());
+            _filter->filter_gradient(*g, *_obj_grad);
         }
+        
+        std::vector<Real> grad;
+        _obj_grad->localize(grad);
+        
+        for (unsigned int i=0; i<_n_elems; i++)
+            obj_grad[i] = grad[_E_f->dof_index(*_elems[i])];
     }
     
     // now check if the sensitivity of constraint function is requested
@@ -651,8 +527,29 @@ MAST::TopologyOptimization2D::evaluate(const std::vector<Real>& dvars,
         // grad_k = dfi/dxj  ,  where k = j*NFunc + i
         //////////////////////////////////////////////////////////////////
         
-        for (unsigned int i=0; i<_n_elems; i++)
-            grads[i] = _elems[i]->volume()/(_volume_fraction * total_vol);
+        if (!_filter) {
+            
+            for (unsigned int i=0; i<_n_elems; i++)
+                grads[i] = _elems[i]->volume()/(_volume_fraction * total_vol);
+        }
+        else {
+            
+            std::auto_ptr<libMesh::NumericVector<Real> >
+            g(_dv->zero_clone().release());
+            
+            for (unsigned int i=0; i<_n_elems; i++)
+                g->set(_E_f->dof_index(*_elems[i]),
+                       _elems[i]->volume()/(_volume_fraction * total_vol));
+            g->close();
+            
+            _filter->filter_gradient(*g, *_dv);
+            
+            std::vector<Real> grad;
+            _dv->localize(grad);
+            
+            for (unsigned int i=0; i<_n_elems; i++)
+                grads[i] = grad[_E_f->dof_index(*_elems[i])];
+        }
     }
     
     
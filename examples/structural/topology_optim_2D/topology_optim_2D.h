@@ -33,6 +33,7 @@
 #include "property_cards/solid_2d_section_element_property_card.h"
 #include "base/parameter.h"
 #include "base/constant_field_function.h"
+#include "base/elementwise_design_field.h"
 #include "optimization/function_evaluation.h"
 #include "boundary_condition/dirichlet_boundary_condition.h"
 
@@ -68,40 +69,8 @@ namespace MAST {
     class BoundaryConditionBase;
     class StructuralNonlinearAssembly;
     class RealOutputFunction;
-    
-    
-    /*!
-     *   This class provides the Youngs Modulus that is scaled by the 
-     *   density.
-     */
-    class YoungsModulus: public MAST::FieldFunction<Real> {
-    public:
-        YoungsModulus(const std::string& nm,
-                      MAST::FieldFunction<Real> &rho,
-                      const Real base_modulus,
-                      const Real penalty);
-                
-        virtual ~YoungsModulus();
-        
-    protected:
-        
-        MAST::FieldFunction<Real> &_rho;
-        
-        Real _base_modulus;
-        
-        Real _penalty;
-        
-    public:
-        
-        virtual void operator() (const libMesh::Point& p, Real t, Real& v) const;
-        
-        virtual void derivative(   const MAST::FunctionBase& f,
-                                const libMesh::Point& p,
-                                Real t,
-                                Real& v) const;
-        
-    };
-
+    class ElementwiseDesignField;
+    class DesignFilter;
     
     
     struct TopologyOptimization2D:
@@ -192,7 +161,8 @@ namespace MAST {
         // create the libmesh system
         MAST::NonlinearSystem*  _sys;
         
-        // system to plot the density variable over the mesh
+        // system that stores the element densities, which are also
+        // plotted over the mesh
         libMesh::ExplicitSystem*           _rho_sys;
         
         // initialize the system to the right set of variables
@@ -219,23 +189,29 @@ namespace MAST {
 
         
         // vector of elements that is in the same sequence as the DVs. This is
-        // used to map the DV vector to the density parameters.
+        // used to map the DV vector to the density values in _rho_sys.
         std::vector<const libMesh::Elem*>           _elems;
 
-        // element density parameters
-        std::map<const libMesh::Elem*, MAST::Parameter*>    _elem_rho;
-        
-        // element density functions
-        std::map<const libMesh::Elem*, MAST::ConstantFieldFunction*>  _elem_rho_f;
+        // density and Youngs modulus defined by the element densities
+        MAST::ElementwiseDesignField
+        *_rho_f,
+        *_E_f;
 
-        // element modulus functions
-        std::map<const libMesh::Elem*, MAST::YoungsModulus*>          _elem_E_f;
-
-        // element material property card, one per element
-        std::map<const libMesh::Elem*, MAST::IsotropicMaterialPropertyCard*> _elem_m_card;
+        // material property card shared by all elements
+        MAST::IsotropicMaterialPropertyCard*        _m_card;
+        
+        // element property card shared by all elements
+        MAST::Solid2DSectionElementPropertyCard*    _p_card;
+        
+        // vector of the compliance sensitivity with respect to the
+        // element densities
+        libMesh::NumericVector<Real>*               _obj_grad;
+        
+        // density filter, which is used if a filter radius is specified
+        MAST::DesignFilter*                         _filter;
         
-        // element property card, one per element
-        std::map<const libMesh::Elem*, MAST::Solid2DSectionElementPropertyCard*> _elem_p_card;
+        // DV values before filtering
+        libMesh::NumericVector<Real>*               _dv;
         
         // create the Dirichlet boundary condition on left edge
         MAST::DirichletBoundaryCondition*               _dirichlet_left;
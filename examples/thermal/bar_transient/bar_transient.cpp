@@ -271,6 +271,10 @@ MAST::BarTransient::solve(bool if_write_output) {
     solver.dt            = 1.0e7;
     solver.beta          = 1.0;
     
+    // the time step is chosen from the local truncation error, starting
+    // from the step size above
+    solver.set_adaptive_time_step(true, 1.e-2);
+    
     
     if (if_write_output)
         libMesh::out << "Writing output to : output.exo" << std::endl;
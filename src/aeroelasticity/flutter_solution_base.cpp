@@ -21,6 +21,7 @@
 // MAST includes
 #include "aeroelasticity/flutter_solution_base.h"
 #include "aeroelasticity/flutter_root_base.h"
+#include "base/memory_report.h"
 
 
 MAST::FlutterSolutionBase::~FlutterSolutionBase() {
@@ -45,3 +46,20 @@ MAST::FlutterSolutionBase::swap_root(MAST::FlutterSolutionBase& sol,
 }
 
 
+
+std::size_t
+MAST::FlutterSolutionBase::memory_bytes() const {
+    
+    std::size_t v = 0;
+    
+    for (unsigned int i=0; i<_roots.size(); i++)
+        v +=
+        sizeof(MAST::FlutterRootBase) +
+        MAST::MemoryReport::dense_bytes(_roots[i]->eig_vec_right) +
+        MAST::MemoryReport::dense_bytes(_roots[i]->eig_vec_left) +
+        MAST::MemoryReport::dense_bytes(_roots[i]->modal_participation);
+    
+    return v;
+}
+
+
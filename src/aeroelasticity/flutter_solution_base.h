@@ -108,6 +108,13 @@ namespace MAST {
         virtual void print(std::ostream& output) = 0;
         
         
+        /*!
+         *    @returns the bytes of the eigenvectors and the modal
+         *    participation stored for the roots of this solution
+         */
+        virtual std::size_t memory_bytes() const;
+        
+        
     protected:
         
         /*!
@@ -28,13 +28,22 @@
 #include "base/boundary_condition_base.h"
 #include "numerics/lapack_dggev_interface.h"
 #include "base/parameter.h"
+#include "base/nonlinear_system.h"
+#include "base/memory_report.h"
+#include "base/solver_telemetry.h"
 
 
 MAST::FlutterSolverBase::FlutterSolverBase():
 _assembly(nullptr),
 _basis_vectors(nullptr),
 _output(nullptr),
-_steady_solver(nullptr) {
+_steady_solver(nullptr),
+_reduced_structural_cache(true),
+_reduced_structural_valid(false),
+_velocity_polynomial_cache(false),
+_steady_state_cache(false),
+_steady_state_tol(1.e-8),
+_telemetry_t0(std::chrono::steady_clock::now()) {
     
 }
 
@@ -42,6 +51,8 @@ _steady_solver(nullptr) {
 
 MAST::FlutterSolverBase::~FlutterSolverBase() {
     
+    this->clear_steady_state_cache();
+    
     _assembly         = nullptr;
     _basis_vectors    = nullptr;
     if (_output)
@@ -67,6 +78,11 @@ attach_assembly(MAST::StructuralFluidInteractionAssembly&   assembly) {
 void
 MAST::FlutterSolverBase::clear() {
     
+    this->clear_reduced_structural_cache();
+    this->clear_steady_state_cache();
+    
+    _telemetry_t0 = std::chrono::steady_clock::now();
+    
     _assembly         = nullptr;
     _basis_vectors    = nullptr;
     if (_output) {
@@ -81,6 +97,9 @@ void
 MAST::FlutterSolverBase::attach_steady_solver(MAST::FlutterSolverBase::SteadySolver &solver) {
     
     _steady_solver = &solver;
+    
+    // the retained solutions were computed by a different solver
+    this->clear_steady_state_cache();
 }
 
 
@@ -88,6 +107,9 @@ MAST::FlutterSolverBase::attach_steady_solver(MAST::FlutterSolverBase::SteadySol
 void
 MAST::FlutterSolverBase::clear_assembly_object() {
     
+    this->clear_reduced_structural_cache();
+    this->clear_steady_state_cache();
+    
     _assembly      = nullptr;
     _steady_solver = nullptr;
 }
@@ -101,8 +123,561 @@ initialize(std::vector<libMesh::NumericVector<Real> *>& basis) {
     
     
     _basis_vectors  = &basis;
+    
+    // the retained quantities were computed for a different basis
+    this->clear_reduced_structural_cache();
+}
+
+
+
+void
+MAST::FlutterSolverBase::set_reduced_structural_cache(bool f) {
+    
+    _reduced_structural_cache = f;
+    
+    if (!f)
+        this->clear_reduced_structural_cache();
+}
+
+
+
+void
+MAST::FlutterSolverBase::clear_reduced_structural_cache() {
+    
+    _reduced_structural_valid = false;
+    _reduced_structural_qty.clear();
+    _reduced_structural_params.clear();
+    _reduced_structural_base_sol.reset();
+    _velocity_polynomial_qty.clear();
+}
+
+
+
+void
+MAST::FlutterSolverBase::set_velocity_polynomial_cache(bool f) {
+    
+    _velocity_polynomial_cache = f;
+    this->clear_reduced_structural_cache();
+}
+
+
+
+void
+MAST::FlutterSolverBase::set_steady_state_cache(bool f, Real tol) {
+    
+    libmesh_assert_greater_equal(tol, 0.);
+    
+    _steady_state_cache = f;
+    _steady_state_tol   = tol;
+    
+    if (!f)
+        this->clear_steady_state_cache();
+}
+
+
+
+void
+MAST::FlutterSolverBase::clear_steady_state_cache() {
+    
+    std::map<Real, libMesh::NumericVector<Real>*>::iterator
+    it  = _steady_states.begin(),
+    end = _steady_states.end();
+    
+    for ( ; it != end; it++)
+        delete it->second;
+    
+    _steady_states.clear();
+    _steady_state_params.clear();
+}
+
+
+
+void
+MAST::FlutterSolverBase::
+_parameter_values(const std::vector<MAST::Parameter*>& solver_params,
+                  std::map<const Real*, Real>& vals) const {
+    
+    libmesh_assert(_assembly);
+    
+    const MAST::PhysicsDisciplineBase& discipline = _assembly->discipline();
+    
+    vals.clear();
+    
+    std::map<const Real*, const MAST::FunctionBase*>::const_iterator
+    it  = discipline.get_parameter_map().begin(),
+    end = discipline.get_parameter_map().end();
+    
+    for ( ; it != end; it++)
+        vals[it->first] = *it->first;
+    
+    for (unsigned int i=0; i<solver_params.size(); i++)
+        vals.erase(solver_params[i]->ptr());
+}
+
+
+
+void
+MAST::FlutterSolverBase::
+_steady_solve(MAST::Parameter& velocity_param,
+              const std::vector<MAST::Parameter*>& solver_params) {
+    
+    libmesh_assert(_steady_solver);
+    
+    if (!_steady_state_cache) {
+        
+        _steady_solver->solve();
+        return;
+    }
+    
+    // the retained solutions are valid only for the same values of the
+    // other parameters
+    std::map<const Real*, Real> vals;
+    this->_parameter_values(solver_params, vals);
+    
+    if (vals != _steady_state_params) {
+        
+        this->clear_steady_state_cache();
+        _steady_state_params = vals;
+    }
+    
+    const Real
+    V   = velocity_param(),
+    tol = _steady_state_tol * std::max(std::fabs(V), 1.);
+    
+    // the two nearest retained velocities
+    std::map<Real, libMesh::NumericVector<Real>*>::iterator
+    hi  = _steady_states.lower_bound(V),
+    lo  = hi,
+    end = _steady_states.end();
+    
+    std::vector<std::map<Real, libMesh::NumericVector<Real>*>::iterator>
+    nearest;
+    
+    while (nearest.size() < 2 &&
+           (hi != end || lo != _steady_states.begin())) {
+        
+        if (lo != _steady_states.begin()) {
+            
+            std::map<Real, libMesh::NumericVector<Real>*>::iterator
+            prev = lo;
+            prev--;
+            
+            if (hi == end || V - prev->first < hi->first - V) {
+                
+                nearest.push_back(prev);
+                lo = prev;
+                continue;
+            }
+        }
+        
+        nearest.push_back(hi);
+        hi++;
+    }
+    
+    if (nearest.size() &&
+        std::fabs(nearest[0]->first - V) <= tol &&
+        _steady_solver->set_solution(*nearest[0]->second)) {
+        
+        libMesh::out
+        << "***  Using Retained Steady State at V = "
+        << nearest[0]->first << " ***" << std::endl;
+        return;
+    }
+    
+    // the initial guess is the linear interpolation between the two
+    // nearest solutions, or the nearest solution if only one is available
+    if (nearest.size()) {
+        
+        std::auto_ptr<libMesh::NumericVector<Real> >
+        x0(nearest[0]->second->clone().release());
+        
+        if (nearest.size() == 2) {
+            
+            const Real
+            f = (V - nearest[0]->first) / (nearest[1]->first - nearest[0]->first);
+            
+            x0->scale(1. - f);
+            x0->add(f, *nearest[1]->second);
+            x0->close();
+        }
+        
+        _steady_solver->set_initial_guess(*x0);
+    }
+    
+    const libMesh::NumericVector<Real>&
+    sol = _steady_solver->solve();
+    
+    libMesh::NumericVector<Real>*& v = _steady_states[V];
+    if (!v)
+        v = sol.clone().release();
+    else
+        *v = sol;
+    v->close();
+}
+
+
+
+void
+MAST::FlutterSolverBase::
+_assemble_reduced_order_quantity
+(std::map<MAST::StructuralQuantityType, RealMatrixX*>& qty_map,
+ const std::vector<MAST::Parameter*>& solver_params,
+ MAST::Parameter* velocity_param) {
+    
+    libmesh_assert(_assembly);
+    libmesh_assert(_basis_vectors);
+    
+    if (!_reduced_structural_cache) {
+        
+        _assembly->assemble_reduced_order_quantity(*_basis_vectors, qty_map);
+        return;
+    }
+    
+    const MAST::PhysicsDisciplineBase& discipline = _assembly->discipline();
+    
+    // the key includes the values of the parameters of the discipline,
+    // except for those modified by this solver.
+    std::map<const Real*, Real> vals;
+    this->_parameter_values(solver_params, vals);
+    
+    bool
+    valid = (_reduced_structural_valid &&
+             vals == _reduced_structural_params &&
+             _assembly->if_linearized_about_nonzero_solution() ==
+             (_reduced_structural_base_sol.get() != nullptr));
+    
+    if (valid && _reduced_structural_base_sol.get()) {
+        
+        std::auto_ptr<libMesh::NumericVector<Real> >
+        dX(_reduced_structural_base_sol->clone().release());
+        dX->add(-1., _assembly->base_sol());
+        
+        valid = dX->linfty_norm() == 0.;
+    }
+    
+    // all requested quantities must be available
+    std::map<MAST::StructuralQuantityType, RealMatrixX*>::iterator
+    it  = qty_map.begin(),
+    end = qty_map.end();
+    
+    for ( ; valid && it != end; it++)
+        valid = _reduced_structural_qty.count(it->first) > 0;
+    
+    if (valid) {
+        
+        for (it = qty_map.begin(); it != end; it++) {
+            
+            *it->second = _reduced_structural_qty[it->first];
+            
+            // add the velocity dependent terms, if any
+            std::map<MAST::StructuralQuantityType, std::vector<RealMatrixX> >::const_iterator
+            v_it = _velocity_polynomial_qty.find(it->first);
+            
+            if (v_it != _velocity_polynomial_qty.end()) {
+                
+                libmesh_assert(velocity_param);
+                const Real V = (*velocity_param)();
+                
+                *it->second += V * v_it->second[0] + V * V * v_it->second[1];
+            }
+        }
+        
+        return;
+    }
+    
+    _assembly->assemble_reduced_order_quantity(*_basis_vectors, qty_map);
+    
+    // the quantities are not retained if the elements depend on the
+    // parameters of the solver, unless the dependence is only on the
+    // velocity and is represented as a polynomial
+    bool
+    depends   = false,
+    depends_V = false;
+    for (unsigned int i=0; i<solver_params.size(); i++)
+        if (discipline.get_dependent_local_elems(*solver_params[i]).size()) {
+            
+            // the base solution from a steady solver changes with velocity
+            if (_velocity_polynomial_cache &&
+                !_steady_solver            &&
+                solver_params[i] == velocity_param)
+                depends_V = true;
+            else
+                depends   = true;
+        }
+    
+    _assembly->system().comm().max(depends);
+    _assembly->system().comm().max(depends_V);
+    
+    if (depends) {
+        
+        this->clear_reduced_structural_cache();
+        return;
+    }
+    
+    _reduced_structural_valid  = true;
+    _reduced_structural_params = vals;
+    _reduced_structural_qty.clear();
+    _velocity_polynomial_qty.clear();
+    
+    if (depends_V)
+        _fit_velocity_polynomial(qty_map, *velocity_param);
+    else
+        for (it = qty_map.begin(); it != end; it++)
+            _reduced_structural_qty[it->first] = *it->second;
+    
+    if (_assembly->if_linearized_about_nonzero_solution()) {
+        
+        if (!_reduced_structural_base_sol.get())
+            _reduced_structural_base_sol.reset
+            (_assembly->base_sol().zero_clone().release());
+        *_reduced_structural_base_sol = _assembly->base_sol();
+    }
+    else
+        _reduced_structural_base_sol.reset();
+}
+
+
+
+void
+MAST::FlutterSolverBase::
+_fit_velocity_polynomial
+(std::map<MAST::StructuralQuantityType, RealMatrixX*>& qty_map,
+ MAST::Parameter& velocity_param) {
+    
+    const Real
+    V0 = velocity_param();
+    
+    // sample velocities. The first sample is the current velocity, for
+    // which the quantities are already assembled.
+    Real
+    V[3] = {V0, 0., 0.};
+    if (V0 != 0.) {
+        V[1] = 2.*V0;
+        V[2] = 3.*V0;
+    }
+    else {
+        V[1] = 1.;
+        V[2] = 2.;
+    }
+    
+    // the coefficients are obtained from the inverse of the
+    // Vandermonde matrix of the sample velocities
+    RealMatrixX
+    vm = RealMatrixX::Zero(3, 3);
+    for (unsigned int i=0; i<3; i++) {
+        vm(i, 0) = 1.;
+        vm(i, 1) = V[i];
+        vm(i, 2) = V[i]*V[i];
+    }
+    
+    const RealMatrixX
+    vm_inv = vm.inverse();
+    
+    // quantities at each sample velocity
+    std::map<MAST::StructuralQuantityType, std::vector<RealMatrixX> >
+    samples;
+    
+    std::map<MAST::StructuralQuantityType, RealMatrixX*>::iterator
+    it  = qty_map.begin(),
+    end = qty_map.end();
+    
+    for ( ; it != end; it++) {
+        samples[it->first].resize(3);
+        samples[it->first][0] = *it->second;
+    }
+    
+    for (unsigned int j=1; j<3; j++) {
+        
+        velocity_param = V[j];
+        
+        std::map<MAST::StructuralQuantityType, RealMatrixX*> s_map;
+        for (it = qty_map.begin(); it != end; it++)
+            s_map[it->first] = &samples[it->first][j];
+        
+        _assembly->assemble_reduced_order_quantity(*_basis_vectors, s_map);
+    }
+    
+    velocity_param = V0;
+    
+    for (it = qty_map.begin(); it != end; it++) {
+        
+        const std::vector<RealMatrixX>& q = samples[it->first];
+        std::vector<RealMatrixX>        c(3);
+        
+        for (unsigned int k=0; k<3; k++)
+            c[k] = vm_inv(k, 0) * q[0] + vm_inv(k, 1) * q[1] + vm_inv(k, 2) * q[2];
+        
+        _reduced_structural_qty[it->first] = c[0];
+        
+        // quantities that do not change with velocity, such as mass, are
+        // stored without the velocity terms
+        if (q[1] != q[0] || q[2] != q[0]) {
+            
+            std::vector<RealMatrixX>& v = _velocity_polynomial_qty[it->first];
+            v.resize(2);
+            v[0] = c[1];
+            v[1] = c[2];
+        }
+        else
+            _reduced_structural_qty[it->first] = q[0];
+    }
+}
+
+
+
+
+
+
+
+bool
+MAST::FlutterSolverBase::_refine_eigenpair(const ComplexMatrixX& A,
+                                           const ComplexMatrixX& B,
+                                           Complex&              lambda,
+                                           ComplexVectorX&       x,
+                                           ComplexVectorX&       y,
+                                           const Real            tol,
+                                           const unsigned int    max_iters) {
+    
+    libmesh_assert_equal_to(A.rows(), x.size());
+    libmesh_assert_equal_to(A.rows(), y.size());
+    
+    x.normalize();
+    y.normalize();
+    
+    ComplexMatrixX M;
+    Complex        den;
+    
+    for (unsigned int i=0; i<=max_iters; i++) {
+        
+        // check the residual of the current estimate
+        const Real
+        ax  = (A*x).norm(),
+        res = (A*x - lambda * (B*x)).norm();
+        
+        if (res <= tol * ax)
+            return true;
+        
+        if (i == max_iters)
+            break;
+        
+        // inverse iteration with the current shift for the right and
+        // left eigenvectors
+        M = A - lambda * B;
+        Eigen::PartialPivLU<ComplexMatrixX> lu(M);
+        
+        x = lu.solve(B*x);
+        y = M.adjoint().partialPivLu().solve(B.adjoint()*y);
+        
+        if (!x.allFinite() || !y.allFinite() ||
+            x.norm() == 0.  || y.norm() == 0.)
+            return false;
+        
+        x.normalize();
+        y.normalize();
+        
+        // two-sided Rayleigh quotient
+        den    = y.dot(B*x);
+        if (std::abs(den) == 0.)
+            return false;
+        lambda = y.dot(A*x)/den;
+    }
+    
+    return false;
+}
+
+
+
+Real
+MAST::FlutterSolverBase::_modal_assurance_criterion(const ComplexVectorX& x1,
+                                                    const ComplexVectorX& x2) {
+    
+    const Real
+    n1 = x1.squaredNorm(),
+    n2 = x2.squaredNorm();
+    
+    if (n1 == 0. || n2 == 0.)
+        return 0.;
+    
+    return std::norm(x1.dot(x2))/(n1*n2);
 }
 
 
 
+void
+MAST::FlutterSolverBase::report_memory(MAST::MemoryReport& r,
+                                       const std::string& nm) const {
+    
+    std::size_t v = 0;
+    
+    if (_basis_vectors)
+        for (unsigned int i=0; i<_basis_vectors->size(); i++)
+            v += MAST::MemoryReport::bytes(*(*_basis_vectors)[i]);
+    r.add(nm, "basis vectors", v);
+    
+    v = 0;
+    std::map<MAST::StructuralQuantityType, RealMatrixX>::const_iterator
+    it   = _reduced_structural_qty.begin(),
+    end  = _reduced_structural_qty.end();
+    for ( ; it != end; it++)
+        v += MAST::MemoryReport::dense_bytes(it->second);
+    
+    std::map<MAST::StructuralQuantityType, std::vector<RealMatrixX> >::const_iterator
+    p_it   = _velocity_polynomial_qty.begin(),
+    p_end  = _velocity_polynomial_qty.end();
+    for ( ; p_it != p_end; p_it++)
+        for (unsigned int i=0; i<p_it->second.size(); i++)
+            v += MAST::MemoryReport::dense_bytes(p_it->second[i]);
+    
+    if (_reduced_structural_base_sol.get())
+        v += MAST::MemoryReport::bytes(*_reduced_structural_base_sol);
+    r.add(nm, "reduced structural cache", v);
+    
+    v = 0;
+    std::map<Real, libMesh::NumericVector<Real>*>::const_iterator
+    s_it   = _steady_states.begin(),
+    s_end  = _steady_states.end();
+    for ( ; s_it != s_end; s_it++)
+        v += MAST::MemoryReport::bytes(*s_it->second);
+    r.add(nm, "steady state cache", v);
+}
+
+
+
+void
+MAST::FlutterSolverBase::_report_root(const std::string& nm,
+                                      const MAST::FlutterRootBase& root) {
+    
+    if (!MAST::solver_telemetry.active())
+        return;
+    
+    MAST::SolverTelemetry::Event
+    e(MAST::SolverTelemetry::FLUTTER_ROOT, nm);
+    
+    e.V         = root.V;
+    e.kr        = root.kr;
+    e.g         = root.g;
+    e.omega     = root.omega;
+    e.converged = true;
+    e.wall_time = MAST::SolverTelemetry::elapsed(_telemetry_t0);
+    
+    MAST::solver_telemetry.emit(e);
+}
+
+
+
+std::size_t
+MAST::FlutterSolverBase::
+_solutions_memory(const std::map<Real, MAST::FlutterSolutionBase*>& sols) {
+    
+    std::size_t v = 0;
+    
+    std::map<Real, MAST::FlutterSolutionBase*>::const_iterator
+    it   = sols.begin(),
+    end  = sols.end();
+    
+    for ( ; it != end; it++)
+        v += it->second->memory_bytes();
+    
+    return v;
+}
 
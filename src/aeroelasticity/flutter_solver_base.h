@@ -24,10 +24,15 @@
 #include <string>
 #include <fstream>
 #include <iomanip>
+#include <map>
+#include <vector>
+#include <memory>
+#include <chrono>
 
 
 // MAST includes
 #include "base/mast_data_types.h"
+#include "elasticity/structural_fluid_interaction_assembly.h"
 
 
 // libMesh includes
@@ -40,11 +45,13 @@ namespace MAST {
     
     // Forward declerations
     class Parameter;
+    class FunctionBase;
     class FlutterModel;
     class FlutterRootBase;
     class FlutterSolutionBase;
     class FlutterRootCrossoverBase;
     class StructuralFluidInteractionAssembly;
+    class MemoryReport;
     template <typename ValType> class BasisMatrix;
     
     
@@ -87,6 +94,31 @@ namespace MAST {
             virtual const libMesh::NumericVector<Real>&
             solution() const = 0;
             
+            
+            /*!
+             *  sets the steady solution to \p x, which was computed
+             *  earlier by solve(), so that the solution() and the data
+             *  used by the assembly are the same as after that solve.
+             *  This is used by the steady state cache of the flutter
+             *  solver. @returns \p false if this is not supported, which
+             *  is the default.
+             */
+            virtual bool
+            set_solution(const libMesh::NumericVector<Real>& x) {
+                return false;
+            }
+            
+            
+            /*!
+             *  sets the initial guess of the next call to solve(), which is
+             *  provided by the steady state cache of the flutter solver
+             *  from the solutions at nearby velocities. @returns \p false
+             *  if the initial guess is not used, which is the default.
+             */
+            virtual bool
+            set_initial_guess(const libMesh::NumericVector<Real>& x) {
+                return false;
+            }
         };
 
         
@@ -131,6 +163,67 @@ namespace MAST {
         }
         
         
+        /*!
+         *   tells the solver to retain the reduced order structural
+         *   quantities, such as mass and stiffness, between the evaluations
+         *   of the flutter matrices. The quantities are reassembled when
+         *   initialize() is called with a new basis, when the values of the
+         *   parameters added to the discipline or the base solution of the
+         *   assembly change, or after clear_reduced_structural_cache().
+         *   They are not retained if the structural quantities depend on
+         *   the parameters modified by the solver between evaluations, for
+         *   example through aerodynamic loads that depend on the velocity.
+         *   This is \p true by default.
+         */
+        void set_reduced_structural_cache(bool f);
+        
+        
+        /*!
+         *   deletes the reduced order structural quantities retained from
+         *   prior evaluations.
+         */
+        void clear_reduced_structural_cache();
+        
+        
+        /*!
+         *   tells the solver that the reduced order structural quantities
+         *   are quadratic polynomials in the flow velocity,
+         *   Q(V) = Q0 + V Q1 + V^2 Q2. This holds for piston theory
+         *   aerodynamic loads at a fixed Mach number, where the aerodynamic
+         *   stiffness is proportional to V^2 and the aerodynamic damping to
+         *   V, as long as the base solution does not change with velocity.
+         *   With this, the quantities are assembled at three velocities
+         *   the first time they are needed, and the quantities at any
+         *   other velocity are computed from the coefficient matrices
+         *   without assembly. This requires the reduced structural cache
+         *   and cannot be used with a steady solver. This is \p false by
+         *   default.
+         */
+        void set_velocity_polynomial_cache(bool f);
+        
+        
+        /*!
+         *   tells the solver to retain the solutions of the steady solver
+         *   by velocity. A velocity within a relative tolerance \p tol of
+         *   a retained velocity uses the retained solution through
+         *   SteadySolver::set_solution(), without a steady solve. Otherwise,
+         *   the steady solve starts from the linear interpolation, or
+         *   extrapolation, of the solutions at the two nearest retained
+         *   velocities, which is given to SteadySolver::set_initial_guess().
+         *   The solutions are deleted when the values of the other
+         *   parameters of the discipline change, when a steady solver is
+         *   attached, or after clear_steady_state_cache(). This is \p false
+         *   by default.
+         */
+        void set_steady_state_cache(bool f, Real tol = 1.e-8);
+        
+        
+        /*!
+         *   deletes the steady solutions retained from prior evaluations
+         */
+        void clear_steady_state_cache();
+        
+        
         /*!
          *   Prints the sorted roots to the \par output
          */
@@ -144,9 +237,118 @@ namespace MAST {
         virtual void print_crossover_points() = 0;
         
         
+        /*!
+         *   adds the bytes of the basis vectors, the retained reduced order
+         *   structural quantities and the flutter solutions of this solver
+         *   to \p r, with \p nm as the name of this object.
+         */
+        virtual void report_memory(MAST::MemoryReport& r,
+                                   const std::string& nm) const;
+        
+        
     protected:
         
         
+        /*!
+         *   reports the converged \p root of the solver \p nm to
+         *   MAST::solver_telemetry. The wall time of the event is the time
+         *   since the previous root, or since the solver was created or
+         *   cleared.
+         */
+        void _report_root(const std::string& nm,
+                          const MAST::FlutterRootBase& root);
+        
+        
+        /*!
+         *   @returns the bytes of the flutter solutions in \p sols
+         */
+        static std::size_t
+        _solutions_memory(const std::map<Real, MAST::FlutterSolutionBase*>& sols);
+
+        
+        
+        /*!
+         *   improves the eigenpair \f$ (\lambda, x) \f$ of
+         *   \f$ A x = \lambda B x \f$, along with the left eigenvector
+         *   \p y, by two-sided Rayleigh quotient iteration starting from the
+         *   provided values. This requires a factorization of the small
+         *   dense matrix per iteration, instead of the solution of the
+         *   complete spectrum. @returns \p true if the relative residual
+         *   \f$ \| A x - \lambda B x \| / \| A x \| \f$ is less than
+         *   \p tol within \p max_iters iterations.
+         */
+        static bool
+        _refine_eigenpair(const ComplexMatrixX& A,
+                          const ComplexMatrixX& B,
+                          Complex&              lambda,
+                          ComplexVectorX&       x,
+                          ComplexVectorX&       y,
+                          const Real            tol,
+                          const unsigned int    max_iters);
+        
+        
+        /*!
+         *   @returns the modal assurance criterion of vectors \p x1 and
+         *   \p x2, \f$ |x_1^H x_2|^2 / (|x_1|^2 |x_2|^2) \f$, which is 1
+         *   for parallel vectors and 0 for orthogonal vectors.
+         */
+        static Real
+        _modal_assurance_criterion(const ComplexVectorX& x1,
+                                   const ComplexVectorX& x2);
+        
+        
+        /*!
+         *   assembles the reduced order structural quantities in
+         *   \p qty_map for the basis of this solver. The quantities
+         *   retained from a prior call are returned if they are still
+         *   valid. \p solver_params are the parameters modified by the
+         *   solver between evaluations, which are excluded from the key if
+         *   the structural quantities do not depend on them. If the
+         *   velocity polynomial cache is on, the quantities that depend on
+         *   \p velocity_param, which must be one of \p solver_params, are
+         *   retained as coefficients of a quadratic polynomial in its value.
+         */
+        void
+        _assemble_reduced_order_quantity
+        (std::map<MAST::StructuralQuantityType, RealMatrixX*>& qty_map,
+         const std::vector<MAST::Parameter*>& solver_params,
+         MAST::Parameter* velocity_param = nullptr);
+        
+        
+        /*!
+         *   assembles the quantities in \p qty_map at two additional values
+         *   of \p velocity_param, and computes the coefficients of the
+         *   quadratic polynomial in velocity from these and the quantities
+         *   in \p qty_map, which were assembled at the current velocity.
+         *   The velocity is restored after the assembly.
+         */
+        void
+        _fit_velocity_polynomial
+        (std::map<MAST::StructuralQuantityType, RealMatrixX*>& qty_map,
+         MAST::Parameter& velocity_param);
+        
+        
+        /*!
+         *   computes in \p vals the values of the parameters of the
+         *   discipline, except for \p solver_params
+         */
+        void
+        _parameter_values(const std::vector<MAST::Parameter*>& solver_params,
+                          std::map<const Real*, Real>& vals) const;
+        
+        
+        /*!
+         *   solves for the steady state at the current value of
+         *   \p velocity_param with the steady solver, using the steady state
+         *   cache if it is on. \p solver_params are the parameters modified
+         *   by the solver between evaluations, which must include
+         *   \p velocity_param.
+         */
+        void
+        _steady_solve(MAST::Parameter& velocity_param,
+                      const std::vector<MAST::Parameter*>& solver_params);
+        
+        
         /*!
          *   structural assembly that provides the assembly of the system
          *   matrices.
@@ -171,6 +373,63 @@ namespace MAST {
          */
         MAST::FlutterSolverBase::SteadySolver* _steady_solver;
         
+        
+        /*!
+         *   flag to retain the reduced order structural quantities
+         */
+        bool                                            _reduced_structural_cache;
+        
+        
+        /*!
+         *   reduced order structural quantities retained from the
+         *   previous assembly, and the flag that identifies them as valid
+         */
+        bool                                            _reduced_structural_valid;
+        std::map<MAST::StructuralQuantityType, RealMatrixX> _reduced_structural_qty;
+        
+        
+        /*!
+         *   parameter values and base solution for which the retained
+         *   quantities were assembled
+         */
+        std::map<const Real*, Real>                     _reduced_structural_params;
+        std::auto_ptr<libMesh::NumericVector<Real> >    _reduced_structural_base_sol;
+        
+        
+        /*!
+         *   flag to retain the quantities as polynomials in velocity
+         */
+        bool                                            _velocity_polynomial_cache;
+        
+        
+        /*!
+         *   coefficients Q1 and Q2 of the quantities that depend on the
+         *   velocity, Q(V) = Q0 + V Q1 + V^2 Q2. Q0 is stored in
+         *   \p _reduced_structural_qty.
+         */
+        std::map<MAST::StructuralQuantityType, std::vector<RealMatrixX> >
+        _velocity_polynomial_qty;
+        
+        
+        /*!
+         *   flag to retain the steady solutions, and the relative tolerance
+         *   on the velocity to reuse a solution
+         */
+        bool                                            _steady_state_cache;
+        Real                                            _steady_state_tol;
+        
+        /*!
+         *   wall time of the previous root reported by _report_root()
+         */
+        std::chrono::steady_clock::time_point           _telemetry_t0;
+        
+        
+        /*!
+         *   steady solutions by velocity, and the values of the other
+         *   parameters for which they were computed
+         */
+        std::map<Real, libMesh::NumericVector<Real>*>   _steady_states;
+        std::map<const Real*, Real>                     _steady_state_params;
     };
 }
 
@@ -0,0 +1,310 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2017  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+// C++ includes
+#include <algorithm>
+#include <cmath>
+
+
+// MAST includes
+#include "aeroelasticity/multi_fidelity_flutter_solver.h"
+#include "aeroelasticity/time_domain_flutter_solver.h"
+#include "aeroelasticity/ug_flutter_solver.h"
+#include "aeroelasticity/pk_flutter_solver.h"
+#include "aeroelasticity/flutter_root_base.h"
+#include "base/parameter.h"
+#include "base/performance_log.h"
+
+
+MAST::MultiFidelityFlutterSolver::MultiFidelityFlutterSolver():
+_lo_solver(nullptr),
+_lo_V_param(nullptr),
+_lo_V_lower(0.),
+_lo_V_upper(0.),
+_lo_n_V_divs(0),
+_ug_solver(nullptr),
+_pk_solver(nullptr),
+_V_param(nullptr),
+_kr_param(nullptr),
+_bref_param(nullptr),
+_rho(0.),
+_kr_lower(0.),
+_kr_upper(0.),
+_n_kr_divs(0),
+_V_width(0.2),
+_kr_width(0.3),
+_n_bracket_V_divs(4),
+_n_bracket_kr_divs(4),
+_n_widen(1),
+_V_correction(1.),
+_kr_correction(1.) {
+    
+}
+
+
+
+MAST::MultiFidelityFlutterSolver::~MultiFidelityFlutterSolver() {
+    
+}
+
+
+
+void
+MAST::MultiFidelityFlutterSolver::
+set_low_fidelity_solver(MAST::TimeDomainFlutterSolver& solver,
+                        MAST::Parameter&               V_param,
+                        Real                           V_lower,
+                        Real                           V_upper,
+                        unsigned int                   n_V_divs) {
+    
+    libmesh_assert_greater(V_upper, V_lower);
+    libmesh_assert_greater(n_V_divs, 0);
+    
+    _lo_solver   = &solver;
+    _lo_V_param  = &V_param;
+    _lo_V_lower  = V_lower;
+    _lo_V_upper  = V_upper;
+    _lo_n_V_divs = n_V_divs;
+}
+
+
+
+void
+MAST::MultiFidelityFlutterSolver::
+set_high_fidelity_solver(MAST::UGFlutterSolver&  solver,
+                         MAST::Parameter&        kr_param,
+                         MAST::Parameter&        bref_param,
+                         Real                    rho,
+                         Real                    kr_lower,
+                         Real                    kr_upper,
+                         unsigned int            n_kr_divs) {
+    
+    libmesh_assert_greater(kr_upper, kr_lower);
+    libmesh_assert_greater(n_kr_divs, 0);
+    
+    _ug_solver  = &solver;
+    _pk_solver  = nullptr;
+    _V_param    = nullptr;
+    _kr_param   = &kr_param;
+    _bref_param = &bref_param;
+    _rho        = rho;
+    _kr_lower   = kr_lower;
+    _kr_upper   = kr_upper;
+    _n_kr_divs  = n_kr_divs;
+}
+
+
+
+void
+MAST::MultiFidelityFlutterSolver::
+set_high_fidelity_solver(MAST::PKFlutterSolver&  solver,
+                         MAST::Parameter&        V_param,
+                         MAST::Parameter&        kr_param,
+                         MAST::Parameter&        bref_param,
+                         Real                    rho,
+                         Real                    kr_lower,
+                         Real                    kr_upper,
+                         unsigned int            n_kr_divs) {
+    
+    libmesh_assert_greater(kr_upper, kr_lower);
+    libmesh_assert_greater(n_kr_divs, 0);
+    
+    _ug_solver  = nullptr;
+    _pk_solver  = &solver;
+    _V_param    = &V_param;
+    _kr_param   = &kr_param;
+    _bref_param = &bref_param;
+    _rho        = rho;
+    _kr_lower   = kr_lower;
+    _kr_upper   = kr_upper;
+    _n_kr_divs  = n_kr_divs;
+}
+
+
+
+void
+MAST::MultiFidelityFlutterSolver::set_bracket(Real          V_width,
+                                              Real          kr_width,
+                                              unsigned int  n_V_divs,
+                                              unsigned int  n_kr_divs,
+                                              unsigned int  n_widen) {
+    
+    libmesh_assert_greater(V_width, 0.);
+    libmesh_assert_greater(kr_width, 0.);
+    libmesh_assert_greater(n_V_divs, 0);
+    libmesh_assert_greater(n_kr_divs, 0);
+    
+    _V_width           = V_width;
+    _kr_width          = kr_width;
+    _n_bracket_V_divs  = n_V_divs;
+    _n_bracket_kr_divs = n_kr_divs;
+    _n_widen           = n_widen;
+}
+
+
+
+void
+MAST::MultiFidelityFlutterSolver::clear_fidelity_correction() {
+    
+    _V_correction  = 1.;
+    _kr_correction = 1.;
+}
+
+
+
+std::pair<bool, MAST::FlutterRootBase*>
+MAST::MultiFidelityFlutterSolver::
+find_critical_root(std::vector<libMesh::NumericVector<Real>*>& basis,
+                   const Real g_tol,
+                   const unsigned int n_bisection_iters) {
+    
+    MAST_LOG_SCOPE("find_critical_root()", "MultiFidelityFlutterSolver");
+    
+    libmesh_assert(_lo_solver);
+    libmesh_assert(_ug_solver || _pk_solver);
+    
+    // the low fidelity root
+    std::pair<bool, MAST::FlutterRootBase*>
+    lo_root(false, nullptr);
+    
+    {
+        MAST_LOG_SCOPE("low_fidelity()", "MultiFidelityFlutterSolver");
+        
+        _lo_solver->clear_solutions();
+        _lo_solver->initialize(*_lo_V_param,
+                               _lo_V_lower,
+                               _lo_V_upper,
+                               _lo_n_V_divs,
+                               basis);
+        _lo_solver->scan_for_roots();
+        lo_root = _lo_solver->find_critical_root(g_tol, n_bisection_iters);
+    }
+    
+    std::pair<bool, MAST::FlutterRootBase*>
+    root(false, nullptr);
+    
+    Real
+    V_lo  = 0.,
+    kr_lo = 0.;
+    
+    if (lo_root.first && lo_root.second->V > 0.) {
+        
+        // the reduced frequency of the time domain root is obtained from
+        // its frequency and the velocity
+        V_lo  = lo_root.second->V;
+        kr_lo = std::fabs(lo_root.second->omega) * (*_bref_param)() / V_lo;
+        
+        const Real
+        V_c  = _V_correction  * V_lo,
+        kr_c = _kr_correction * kr_lo;
+        
+        Real
+        V_width  = _V_width,
+        kr_width = _kr_width;
+        
+        for (unsigned int i=0; !root.first && i<=_n_widen; i++) {
+            
+            root = _solve_high_fidelity
+            (V_c * std::max(1.-V_width, 0.1),
+             V_c * (1.+V_width),
+             _n_bracket_V_divs,
+             std::max(_kr_lower, kr_c * (1.-kr_width)),
+             std::min(_kr_upper, kr_c * (1.+kr_width)),
+             _n_bracket_kr_divs,
+             basis,
+             g_tol,
+             n_bisection_iters);
+            
+            V_width  *= 2.;
+            kr_width *= 2.;
+        }
+    }
+    
+    // without a bracket, the full range is scanned
+    if (!root.first)
+        root = _solve_high_fidelity(_lo_V_lower,
+                                    _lo_V_upper,
+                                    _lo_n_V_divs,
+                                    _kr_lower,
+                                    _kr_upper,
+                                    _n_kr_divs,
+                                    basis,
+                                    g_tol,
+                                    n_bisection_iters);
+    
+    // the fidelity correction for the next call
+    if (root.first && V_lo > 0. && kr_lo > 0.) {
+        
+        _V_correction  = root.second->V  / V_lo;
+        _kr_correction = root.second->kr / kr_lo;
+    }
+    
+    return root;
+}
+
+
+
+std::pair<bool, MAST::FlutterRootBase*>
+MAST::MultiFidelityFlutterSolver::
+_solve_high_fidelity(Real V_lower,
+                     Real V_upper,
+                     unsigned int n_V_divs,
+                     Real kr_lower,
+                     Real kr_upper,
+                     unsigned int n_kr_divs,
+                     std::vector<libMesh::NumericVector<Real>*>& basis,
+                     const Real g_tol,
+                     const unsigned int n_bisection_iters) {
+    
+    MAST_LOG_SCOPE("high_fidelity()", "MultiFidelityFlutterSolver");
+    
+    if (_ug_solver) {
+        
+        _ug_solver->clear_solutions();
+        _ug_solver->initialize(*_kr_param,
+                               *_bref_param,
+                               _rho,
+                               kr_lower,
+                               kr_upper,
+                               n_kr_divs,
+                               basis);
+        _ug_solver->scan_for_roots();
+        
+        return _ug_solver->find_critical_root(g_tol, n_bisection_iters);
+    }
+    else {
+        
+        _pk_solver->clear_solutions();
+        _pk_solver->initialize(*_V_param,
+                               *_kr_param,
+                               *_bref_param,
+                               _rho,
+                               V_lower,
+                               V_upper,
+                               n_V_divs,
+                               kr_lower,
+                               kr_upper,
+                               n_kr_divs,
+                               basis);
+        _pk_solver->scan_for_roots();
+        
+        return _pk_solver->find_critical_root(g_tol, n_bisection_iters);
+    }
+}
+
@@ -0,0 +1,237 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2017  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef __mast__multi_fidelity_flutter_solver_h__
+#define __mast__multi_fidelity_flutter_solver_h__
+
+// C++ includes
+#include <vector>
+
+
+// MAST includes
+#include "base/mast_data_types.h"
+
+
+// libMesh includes
+#include "libmesh/numeric_vector.h"
+
+
+namespace MAST {
+    
+    // Forward declerations
+    class TimeDomainFlutterSolver;
+    class UGFlutterSolver;
+    class PKFlutterSolver;
+    class FlutterRootBase;
+    class Parameter;
+    
+    
+    /*!
+     *   Finds the critical flutter root of a high fidelity aerodynamic
+     *   model, such as the frequency domain Euler generalized aerodynamic
+     *   forces of MAST::FSIGeneralizedAeroForceAssembly, by first finding the
+     *   critical root of a low fidelity model, such as piston theory, with
+     *   MAST::TimeDomainFlutterSolver on the same structural basis. The
+     *   low fidelity root brackets the velocity and reduced frequency
+     *   scanned by the UG or PK solver of the high fidelity model, so that
+     *   the high fidelity aerodynamic forces are evaluated at only a few
+     *   points close to the flutter point. The bracket is widened if no
+     *   root is found inside it, and the full high fidelity range is
+     *   scanned if this also fails, or if the low fidelity
+     *   model finds no root. The ratios of the high and low fidelity flutter
+     *   velocity and reduced frequency are retained as a fidelity
+     *   correction, which centers the bracket of the next call, for
+     *   example at the next design iteration. The root is the lowest
+     *   velocity root inside the bracket, and high fidelity roots outside
+     *   the widened bracket are not identified.
+     *
+     *   The solvers must have their assembly objects attached before
+     *   find_critical_root() is called, and are initialized by this object
+     *   for each solution.
+     */
+    class MultiFidelityFlutterSolver {
+        
+    public:
+        
+        MultiFidelityFlutterSolver();
+        
+        
+        virtual ~MultiFidelityFlutterSolver();
+        
+        
+        /*!
+         *   sets the low fidelity solver, the velocity parameter and the
+         *   velocity range scanned by the solver
+         */
+        void set_low_fidelity_solver(MAST::TimeDomainFlutterSolver& solver,
+                                     MAST::Parameter&               V_param,
+                                     Real                           V_lower,
+                                     Real                           V_upper,
+                                     unsigned int                   n_V_divs);
+        
+        
+        /*!
+         *   sets a UG solver for the high fidelity model. The bracket is
+         *   applied to the reduced frequency. \p kr_lower, \p kr_upper and
+         *   \p n_kr_divs define the range that is scanned without a bracket.
+         */
+        void set_high_fidelity_solver(MAST::UGFlutterSolver&  solver,
+                                      MAST::Parameter&        kr_param,
+                                      MAST::Parameter&        bref_param,
+                                      Real                    rho,
+                                      Real                    kr_lower,
+                                      Real                    kr_upper,
+                                      unsigned int            n_kr_divs);
+        
+        
+        /*!
+         *   sets a PK solver for the high fidelity model. The bracket is
+         *   applied to the velocity and the reduced frequency. Without a
+         *   bracket, the velocity range of the low fidelity solver and
+         *   the reduced frequency range of \p kr_lower, \p kr_upper and
+         *   \p n_kr_divs are scanned.
+         */
+        void set_high_fidelity_solver(MAST::PKFlutterSolver&  solver,
+                                      MAST::Parameter&        V_param,
+                                      MAST::Parameter&        kr_param,
+                                      MAST::Parameter&        bref_param,
+                                      Real                    rho,
+                                      Real                    kr_lower,
+                                      Real                    kr_upper,
+                                      unsigned int            n_kr_divs);
+        
+        
+        /*!
+         *   sets the bracket about the corrected low fidelity root as the
+         *   relative half-widths \p V_width and \p kr_width of the
+         *   velocity and reduced frequency, the number of divisions of
+         *   the bracket, and the number of times the widths are doubled if
+         *   no root is found in the bracket. The defaults are 0.2, 0.3, 4,
+         *   4 and 1.
+         */
+        void set_bracket(Real          V_width,
+                         Real          kr_width,
+                         unsigned int  n_V_divs,
+                         unsigned int  n_kr_divs,
+                         unsigned int  n_widen);
+        
+        
+        /*!
+         *   finds the critical root of the high fidelity model on
+         *   \p basis. The returned root is owned by the high fidelity
+         *   solver.
+         */
+        std::pair<bool, MAST::FlutterRootBase*>
+        find_critical_root(std::vector<libMesh::NumericVector<Real>*>& basis,
+                           const Real g_tol,
+                           const unsigned int n_bisection_iters);
+        
+        
+        /*!
+         *   @returns the ratio of the high and low fidelity flutter
+         *   velocities of the last call in which both roots were found.
+         *   This is 1 initially.
+         */
+        Real V_correction() const {
+            return _V_correction;
+        }
+        
+        
+        /*!
+         *   @returns the ratio of the high and low fidelity reduced
+         *   frequencies of the last call in which both roots were found.
+         *   This is 1 initially.
+         */
+        Real kr_correction() const {
+            return _kr_correction;
+        }
+        
+        
+        /*!
+         *   resets the fidelity correction to 1, for example if the
+         *   flight condition changes
+         */
+        void clear_fidelity_correction();
+        
+        
+    protected:
+        
+        /*!
+         *   initializes the high fidelity solver for the velocity and
+         *   reduced frequency range and finds its critical root. The
+         *   velocity range is only used by the PK solver.
+         */
+        std::pair<bool, MAST::FlutterRootBase*>
+        _solve_high_fidelity(Real V_lower,
+                             Real V_upper,
+                             unsigned int n_V_divs,
+                             Real kr_lower,
+                             Real kr_upper,
+                             unsigned int n_kr_divs,
+                             std::vector<libMesh::NumericVector<Real>*>& basis,
+                             const Real g_tol,
+                             const unsigned int n_bisection_iters);
+        
+        
+        /*!
+         *   low fidelity solver and its velocity range
+         */
+        MAST::TimeDomainFlutterSolver* _lo_solver;
+        
+        MAST::Parameter*               _lo_V_param;
+        
+        Real                           _lo_V_lower, _lo_V_upper;
+        
+        unsigned int                   _lo_n_V_divs;
+        
+        /*!
+         *   high fidelity solver, of which only one is set, and its
+         *   parameters and reduced frequency range
+         */
+        MAST::UGFlutterSolver*         _ug_solver;
+        
+        MAST::PKFlutterSolver*         _pk_solver;
+        
+        MAST::Parameter                *_V_param, *_kr_param, *_bref_param;
+        
+        Real                           _rho;
+        
+        Real                           _kr_lower, _kr_upper;
+        
+        unsigned int                   _n_kr_divs;
+        
+        /*!
+         *   relative half-widths and divisions of the bracket, and the
+         *   number of times it is widened
+         */
+        Real                           _V_width, _kr_width;
+        
+        unsigned int                   _n_bracket_V_divs, _n_bracket_kr_divs;
+        
+        unsigned int                   _n_widen;
+        
+        /*!
+         *   fidelity correction of the velocity and reduced frequency
+         */
+        Real                           _V_correction, _kr_correction;
+    };
+}
+
+
+#endif // __mast__multi_fidelity_flutter_solver_h__
@@ -23,6 +23,7 @@
 
 // MAST includes
 #include "aeroelasticity/pk_flutter_solution.h"
+#include "base/memory_report.h"
 #include "aeroelasticity/pk_flutter_root.h"
 #include "numerics/lapack_zggev_interface.h"
 
@@ -205,3 +206,13 @@ MAST::PKFlutterSolution::print(std::ostream &output)
 
 
 
+std::size_t
+MAST::PKFlutterSolution::memory_bytes() const {
+    
+    return
+    MAST::FlutterSolutionBase::memory_bytes() +
+    MAST::MemoryReport::dense_bytes(_Amat) +
+    MAST::MemoryReport::dense_bytes(_Bmat) +
+    MAST::MemoryReport::dense_bytes(_stiff_mat);
+}
+
@@ -72,6 +72,13 @@ namespace MAST {
          *    prints the data and modes from this solution
          */
         virtual void print(std::ostream& output);
+        
+        
+        /*!
+         *    @returns the bytes of the roots and of the matrices of this
+         *    solution
+         */
+        virtual std::size_t memory_bytes() const;
 
         
     protected:
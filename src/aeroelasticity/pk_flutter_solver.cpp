@@ -26,6 +26,8 @@
 #include "elasticity/fsi_generalized_aero_force_assembly.h"
 #include "numerics/lapack_zggev_interface.h"
 #include "base/parameter.h"
+#include "base/performance_log.h"
+#include "base/memory_report.h"
 
 
 MAST::PKFlutterSolver::PKFlutterSolver():
@@ -434,6 +436,7 @@ MAST::PKFlutterSolver::find_next_root(const Real g_tol,
                                       root_num, g_tol, n_bisection_iters);
             
             cross->root = &(sol.second->get_root(root_num));
+            this->_report_root("PKFlutterSolver", *cross->root);
             
             // now, remove this entry from the _flutter_crossover points and
             // reinsert it with the actual critical velocity
@@ -487,6 +490,7 @@ MAST::PKFlutterSolver::find_critical_root(const Real g_tol,
                                       root_num, g_tol, n_bisection_iters);
             
             cross->root = &(sol.second->get_root(root_num));
+            this->_report_root("PKFlutterSolver", *cross->root);
             
             // now, remove this entry from the _flutter_crossover points and
             // reinsert it with the actual critical velocity
@@ -850,8 +854,11 @@ MAST::PKFlutterSolver::_analyze(const Real k_red,
     << "   V_ref = " << std::setw(10) << v_ref << std::endl;
     
     _initialize_matrices(k_red, v_ref, L, R, stiff);
-    LAPACK_ZGGEV ges;
-    ges.compute(L, R);
+    MAST::LAPACK_ZGGEV& ges = _eigen_solver;
+    {
+        MAST_LOG_SCOPE("eigensolve()", "PKFlutterSolver");
+        ges.compute(L, R);
+    }
     ges.scale_eigenvectors_to_identity_innerproduct();
     
     MAST::PKFlutterSolution* root = new MAST::PKFlutterSolution;
@@ -878,24 +885,32 @@ MAST::PKFlutterSolver::calculate_sensitivity(MAST::FlutterRootBase& root,
                                              const libMesh::ParameterVector& params,
                                              const unsigned int i) {
 
-    /*
     libMesh::out
     << " ====================================================" << std::endl
     << "PK Sensitivity Solution" << std::endl
     << "   k_red = " << std::setw(10) << root.kr << std::endl
     << "   V_ref = " << std::setw(10) << root.V << std::endl;
     
-    Complex eig = root.root, sens = 0., k_sens = 0., den = 0.;
-    Real par_g_par_alpha = 0., par_g_par_kref = 0., par_k_par_alpha = 0.,
-    V_sens=0.;
+    const unsigned int n = (unsigned int)_basis_vectors->size();
+
+    Complex
+    deig_dp          = 0.,
+    deig_dV          = 0.,
+    deig_dkr         = 0.;
     
     // get the sensitivity of the matrices
-    ComplexMatrixX mat_A, mat_B, mat_A_sens, mat_B_sens;
-    ComplexVectorX v;
+    ComplexMatrixX
+    mat_A,
+    mat_B,
+    mat_A_sens,
+    mat_B_sens;
+    
+    ComplexVectorX u;
     RealMatrixX stiff;
     
     // initialize the baseline matrices
     _initialize_matrices(root.kr, root.V, mat_A, mat_B, stiff);
+    u = _quadratic_left_eigenvector(root, mat_B);
     
     // calculate the eigenproblem sensitivity
     _initialize_matrix_sensitivity_for_param(params, i,
@@ -903,64 +918,210 @@ MAST::PKFlutterSolver::calculate_sensitivity(MAST::FlutterRootBase& root,
                                              root.V,
                                              mat_A_sens,
                                              mat_B_sens);
+    deig_dp = _eigenvalue_sensitivity(root, u, mat_B, mat_A_sens, mat_B_sens);
+    
+    // the structural matrices do not depend on velocity, and the
+    // aerodynamic contribution  -rho/2 V^2 A(kr)  is obtained from L + K.
+    // Hence, its sensitivity wrt V is 2/V (L + K)
+    mat_A_sens.setZero(2*n, 2*n);
+    mat_B_sens.setZero(2*n, 2*n);
+    mat_A_sens.bottomLeftCorner(n, n) =
+    2./root.V * (mat_A.bottomLeftCorner(n, n) + stiff.cast<Complex>());
+    deig_dV = _eigenvalue_sensitivity(root, u, mat_B, mat_A_sens, mat_B_sens);
+    
+    // sensitivity wrt kr, which is only through A(kr)
+    _initialize_matrix_sensitivity_for_kr(root.kr,
+                                          root.V,
+                                          mat_A_sens,
+                                          mat_B_sens);
+    deig_dkr = _eigenvalue_sensitivity(root, u, mat_B, mat_A_sens, mat_B_sens);
+    
+    // the converged root satisfies the zero damping condition, Re(p) = 0,
+    // and the frequency condition of the PK method, Im(p) = kr V/b. The
+    // total derivative of both conditions gives
+    //     J {dV/dp  dkr/dp}^T = - {Re(dlambda/dp)  Im(dlambda/dp)}^T
+    // with the Jacobian J of the conditions wrt V and kr.
+    RealVectorX
+    dcond_dp  = RealVectorX::Zero(2),
+    sens;
+    dcond_dp(0) = deig_dp.real();
+    dcond_dp(1) = deig_dp.imag();
+    
+    sens = -_flutter_condition_jacobian(root, deig_dV, deig_dkr).inverse() * dcond_dp;
+    
+    root.V_sens     = sens(0);
+    root.kr_sens    = sens(1);
+    
+    // total sensitivity of the eigenvlaue
+    root.root_sens  = deig_dp + deig_dV * root.V_sens + deig_dkr * root.kr_sens;
+    root.has_sensitivity_data = true;
     
-    // the eigenproblem is     A x - lambda B x = 0
-    // therefore, the denominator is obtained from the inner product of
-    // x^T B x
-    // sensitivity is
-    //   -dlambda/dp x^T B x = - x^T (dA/dp - lambda dB/dp)
-    // or
-    //   dlambda/dp = [x^T (dA/dp - lambda dB/dp)]/(x^T B x)
-    
-    // now calculate the quotient for sensitivity
-    // numerator =  ( dA/dp - lambda dB/dp)
-    mat_B_sens *= -eig;
-    mat_B_sens += mat_A_sens;
-    v = mat_B_sens*root.eig_vec_right;
-    den = root.eig_vec_left.dot(mat_B*root.eig_vec_right);
-    sens = root.eig_vec_left.dot(v)/den;
-    
-    // now add the correction from sensitivity of g(k) = 0
-    par_g_par_alpha =
-    sens.imag()/eig.real() - eig.imag()/pow(eig.real(),2) * sens.real();
-    
+    libMesh::out
+    << "Finished PK Sensitivity Solution" << std::endl
+    << " ====================================================" << std::endl;
+}
+
+
+
+
+void
+MAST::PKFlutterSolver::calculate_sensitivity(const MAST::FlutterRootBase& root,
+                                             const libMesh::ParameterVector& params,
+                                             std::vector<Real>& V_sens) {
     
-    // next we need the sensitivity of k_red before we can calculate
-    // the sensitivity of flutter eigenvalue
-    _initialize_matrix_sensitivity_for_reduced_freq(root.kr,
-                                                    root.V,
-                                                    mat_A_sens,
-                                                    mat_B_sens);
+    libMesh::out
+    << " ====================================================" << std::endl
+    << "PK Sensitivity Solution" << std::endl
+    << "   k_red    = " << std::setw(10) << root.kr << std::endl
+    << "   V_ref    = " << std::setw(10) << root.V << std::endl
+    << "   n_params = " << std::setw(10) << params.size() << std::endl;
     
-    // now calculate the quotient for sensitivity wrt k_red
-    // calculate numerator
-    mat_B_sens *= -eig;
-    mat_B_sens += mat_A_sens;
-    v = mat_B_sens*root.eig_vec_right;
-    k_sens = root.eig_vec_left.dot(v) / den;
+    const unsigned int
+    n        = (unsigned int)_basis_vectors->size(),
+    n_params = params.size();
     
-    // use this to calculate the partial derivative of g wrt k_red
-    par_g_par_kref =
-    k_sens.imag()/eig.real() - eig.imag()/pow(eig.real(),2) * k_sens.real();
+    Complex
+    deig_dp          = 0.,
+    deig_dV          = 0.,
+    deig_dkr         = 0.;
     
-    // use this to calculate the sensitivity of k_red wrt alpha
-    par_k_par_alpha = -par_g_par_alpha / par_g_par_kref;
+    ComplexMatrixX
+    mat_A,
+    mat_B,
+    mat_A_sens,
+    mat_B_sens;
     
-    // finally add the correction to the flutter sensitivity
-    sens += k_sens * par_k_par_alpha;
+    std::vector<ComplexMatrixX>
+    mat_A_param_sens,
+    mat_B_param_sens;
     
-    // finally, the flutter speed sensitivity
-    V_sens = -.5*sens.real()/pow(eig.real(), 1.5);
+    ComplexVectorX u;
+    RealMatrixX stiff;
     
-    // set value in the return root
-    root.has_sensitivity_data = true;
-    root.root_sens  = sens;
-    root.V_sens     = V_sens;
+    // initialize the baseline matrices
+    _initialize_matrices(root.kr, root.V, mat_A, mat_B, stiff);
+    u = _quadratic_left_eigenvector(root, mat_B);
+    
+    // the sensitivity of the matrices for all parameters
+    _initialize_matrix_sensitivity_for_params(params,
+                                              root.kr,
+                                              root.V,
+                                              mat_A_param_sens,
+                                              mat_B_param_sens);
+    
+    // the sensitivity of eigenvalue wrt V is the same for all
+    // parameters. See the single parameter calculate_sensitivity().
+    mat_A_sens.setZero(2*n, 2*n);
+    mat_B_sens.setZero(2*n, 2*n);
+    mat_A_sens.bottomLeftCorner(n, n) =
+    2./root.V * (mat_A.bottomLeftCorner(n, n) + stiff.cast<Complex>());
+    deig_dV = _eigenvalue_sensitivity(root, u, mat_B, mat_A_sens, mat_B_sens);
+    
+    _initialize_matrix_sensitivity_for_kr(root.kr,
+                                          root.V,
+                                          mat_A_sens,
+                                          mat_B_sens);
+    deig_dkr = _eigenvalue_sensitivity(root, u, mat_B, mat_A_sens, mat_B_sens);
+    
+    // the Jacobian of the flutter conditions is factored once for all
+    // parameters
+    const RealMatrixX
+    jac_inv = _flutter_condition_jacobian(root, deig_dV, deig_dkr).inverse();
+    
+    RealVectorX
+    dcond_dp  = RealVectorX::Zero(2);
+    
+    V_sens.resize(n_params);
+    
+    for (unsigned int i=0; i<n_params; i++) {
+        
+        deig_dp   = _eigenvalue_sensitivity(root, u, mat_B,
+                                            mat_A_param_sens[i],
+                                            mat_B_param_sens[i]);
+        dcond_dp(0) = deig_dp.real();
+        dcond_dp(1) = deig_dp.imag();
+        
+        V_sens[i] = -jac_inv.row(0).dot(dcond_dp);
+    }
     
     libMesh::out
     << "Finished PK Sensitivity Solution" << std::endl
     << " ====================================================" << std::endl;
- */
+}
+
+
+
+
+ComplexVectorX
+MAST::PKFlutterSolver::
+_quadratic_left_eigenvector(const MAST::FlutterRootBase& root,
+                            const ComplexMatrixX& R) const {
+    
+    const unsigned int n = (unsigned int)root.eig_vec_left.size();
+    
+    // y1 = conj(lambda) M^H y2. The scaling of the vector does not
+    // change the eigenvalue sensitivity, so the factor is ignored.
+    return R.bottomRightCorner(n, n).adjoint().fullPivLu().solve(root.eig_vec_left);
+}
+
+
+
+
+Complex
+MAST::PKFlutterSolver::
+_eigenvalue_sensitivity(const MAST::FlutterRootBase& root,
+                        const ComplexVectorX& u,
+                        const ComplexMatrixX& R,
+                        const ComplexMatrixX& dL,
+                        const ComplexMatrixX& dR) const {
+    
+    // the PK equations
+    //
+    //   p [ I  0 ] {  X } =  [ 0  I ] {  X }
+    //     [ 0  M ] { pX }    [ L  0 ] { pX }
+    //
+    // with L = -K - qA, are equivalent to  (p^2 M - L) X = 0. Therefore,
+    // the sensitivity of the eigenvalue is obtained from
+    //   u^H (2 p M dp/dalpha + p^2 dM/dalpha - dL/dalpha) X = 0
+    // or
+    //   dp/dalpha = u^H (dL/dalpha - p^2 dM/dalpha) X / (2 p u^H M X)
+    
+    const unsigned int n = (unsigned int)root.eig_vec_right.size();
+    
+    const Complex
+    eig = root.root,
+    den = 2.*eig*u.dot(R.bottomRightCorner(n, n)*root.eig_vec_right),
+    num = u.dot((dL.bottomLeftCorner(n, n) -
+                 eig*eig*dR.bottomRightCorner(n, n))*root.eig_vec_right);
+    
+    return num/den;
+}
+
+
+
+
+RealMatrixX
+MAST::PKFlutterSolver::
+_flutter_condition_jacobian(const MAST::FlutterRootBase& root,
+                            const Complex& deig_dV,
+                            const Complex& deig_dkr) const {
+    
+    // Jacobian of the conditions
+    //     Re(lambda)          = 0
+    //     Im(lambda) - kr V/b = 0
+    // with respect to V (first column) and kr (second column)
+    const Real
+    b   = (*_bref_param)();
+    
+    RealMatrixX
+    jac = RealMatrixX::Zero(2, 2);
+    
+    jac(0, 0) = deig_dV.real();
+    jac(0, 1) = deig_dkr.real();
+    jac(1, 0) = deig_dV.imag()  - root.kr/b;
+    jac(1, 1) = deig_dkr.imag() - root.V/b;
+    
+    return jac;
 }
 
 
@@ -973,6 +1134,8 @@ MAST::PKFlutterSolver::_initialize_matrices(const Real k_red,
                                             ComplexMatrixX& B, // mass
                                             RealMatrixX& stiff)// stiffness
 {
+    MAST_LOG_SCOPE("initialize_matrices()", "PKFlutterSolver");
+    
     // the PK method equations are
     //
     //   p [ I  0 ] {  X } =  [ 0      I ] {  X }
@@ -1003,12 +1166,22 @@ MAST::PKFlutterSolver::_initialize_matrices(const Real k_red,
     (*_kred_param)      = k_red;
     (*_velocity_param)  = v_ref;
     
-    _assembly->assemble_reduced_order_quantity(*_basis_vectors, qty_map);
+    // the structural quantities are reused between evaluations, unless
+    // they depend on the reduced frequency or velocity
+    std::vector<MAST::Parameter*> solver_params(2);
+    solver_params[0] = _kred_param;
+    solver_params[1] = _velocity_param;
+    
+    _assemble_reduced_order_quantity(qty_map, solver_params, _velocity_param);
 
     dynamic_cast<MAST::FSIGeneralizedAeroForceAssembly*>(_assembly)->
     assemble_generalized_aerodynamic_force_matrix(*_basis_vectors, a);
 
 
+    A.setZero(2*n, 2*n);
+    B.setZero(2*n, 2*n);
+    stiff = k;
+    
     A.topRightCorner    (n, n)    =  ComplexMatrixX::Identity(n, n);
     A.bottomLeftCorner  (n, n)    = -k.cast<Complex>() - _rho/2.*v_ref*v_ref*a;
     B.topLeftCorner     (n, n)    = ComplexMatrixX::Identity(n, n);
@@ -1027,9 +1200,132 @@ _initialize_matrix_sensitivity_for_param(const libMesh::ParameterVector& params,
                                          ComplexMatrixX& L,   // stiff, aero, damp
                                          ComplexMatrixX& R) { // mass
     
+    // the sensitivity of the PK matrices in _initialize_matrices() is
+    //
+    //   [ 0      0 ]   and   [ 0   0  ]
+    //   [-dK/dp  0 ]         [ 0 dM/dp]
+    //
+    // since the sensitivity of the generalized aerodynamic force matrix
+    // is currently available only for the reduced frequency.
+    
+    const unsigned int n = (unsigned int)_basis_vectors->size();
+    
+    RealMatrixX
+    m      =  RealMatrixX::Zero(n, n),
+    k      =  RealMatrixX::Zero(n, n);
+    
+    std::map<MAST::StructuralQuantityType, RealMatrixX*> qty_map;
+    qty_map[MAST::MASS]       = &m;
+    qty_map[MAST::STIFFNESS]  = &k;
+    
+    // set the velocity value in the parameter that was provided
+    (*_kred_param)      = k_red;
+    (*_velocity_param)  = v_ref;
+    
+    _assembly->assemble_reduced_order_quantity_sensitivity(params,
+                                                           p,
+                                                           *_basis_vectors,
+                                                           qty_map);
+    
+    L.setZero(2*n, 2*n);
+    R.setZero(2*n, 2*n);
+    
+    L.bottomLeftCorner  (n, n)    = -k.cast<Complex>();
+    R.bottomRightCorner (n, n)    =  m.cast<Complex>();
+}
 
-    libmesh_error(); // to be implemented
+
+
+
+void
+MAST::PKFlutterSolver::
+_initialize_matrix_sensitivity_for_params(const libMesh::ParameterVector& params,
+                                          const Real k_red,
+                                          const Real v_ref,
+                                          std::vector<ComplexMatrixX>& L,
+                                          std::vector<ComplexMatrixX>& R) {
+    
+    // see _initialize_matrix_sensitivity_for_param()
+    const unsigned int
+    n        = (unsigned int)_basis_vectors->size(),
+    n_params = params.size();
+    
+    std::vector<RealMatrixX>
+    m(n_params),
+    k(n_params);
+    
+    std::vector<std::map<MAST::StructuralQuantityType, RealMatrixX*> >
+    qty_maps(n_params);
+    
+    for (unsigned int i=0; i<n_params; i++) {
+        qty_maps[i][MAST::MASS]       = &m[i];
+        qty_maps[i][MAST::STIFFNESS]  = &k[i];
+    }
+    
+    // set the velocity value in the parameter that was provided
+    (*_kred_param)      = k_red;
+    (*_velocity_param)  = v_ref;
+    
+    _assembly->assemble_reduced_order_quantity_sensitivity
+    (params,
+     *_basis_vectors,
+     std::vector<const libMesh::NumericVector<Real>*>(),
+     qty_maps);
+    
+    L.resize(n_params);
+    R.resize(n_params);
+    
+    for (unsigned int i=0; i<n_params; i++) {
+        
+        L[i].setZero(2*n, 2*n);
+        R[i].setZero(2*n, 2*n);
+        
+        L[i].bottomLeftCorner  (n, n)    = -k[i].cast<Complex>();
+        R[i].bottomRightCorner (n, n)    =  m[i].cast<Complex>();
+    }
 }
 
 
 
+void
+MAST::PKFlutterSolver::
+_initialize_matrix_sensitivity_for_kr(const Real k_red,
+                                      const Real v_ref,
+                                      ComplexMatrixX& L,   // stiff, aero, damp
+                                      ComplexMatrixX& R) { // mass
+    
+    // the structural matrices do not depend on kr, so that the
+    // sensitivity of the PK matrices in _initialize_matrices() is
+    //
+    //   [ 0                   0 ]   and   [ 0  0 ]
+    //   [ -rho/2 V^2 dA/dkr   0 ]         [ 0  0 ]
+    
+    const unsigned int n = (unsigned int)_basis_vectors->size();
+    
+    ComplexMatrixX
+    a      =  ComplexMatrixX::Zero(n, n);
+    
+    // set the velocity value in the parameter that was provided
+    (*_kred_param)      = k_red;
+    (*_velocity_param)  = v_ref;
+    
+    dynamic_cast<MAST::FSIGeneralizedAeroForceAssembly*>(_assembly)->
+    assemble_generalized_aerodynamic_force_matrix(*_basis_vectors, a, _kred_param);
+    
+    L.setZero(2*n, 2*n);
+    R.setZero(2*n, 2*n);
+    
+    L.bottomLeftCorner  (n, n)    = -_rho/2.*v_ref*v_ref*a;
+}
+
+
+
+void
+MAST::PKFlutterSolver::report_memory(MAST::MemoryReport& r,
+                                     const std::string& nm) const {
+    
+    MAST::FlutterSolverBase::report_memory(r, nm);
+    
+    r.add(nm, "flutter solutions", _solutions_memory(_flutter_solutions));
+}
+
@@ -26,6 +26,7 @@
 
 // MAST includes
 #include "aeroelasticity/flutter_solver_base.h"
+#include "numerics/lapack_zggev_interface.h"
 
 
 namespace MAST {
@@ -110,6 +111,14 @@ namespace MAST {
         virtual void print_sorted_roots();
         
         
+        /*!
+         *   adds the bytes of the flutter solutions to those reported by
+         *   the parent class
+         */
+        virtual void report_memory(MAST::MemoryReport& r,
+                                   const std::string& nm) const;
+        
+        
         /*!
          *   Prints the crossover points output. If no pointer to output is given
          *   then the output defined by set_output_file() is used.
@@ -126,13 +135,37 @@ namespace MAST {
         
         /*!
          *   Calculate the sensitivity of the flutter root with respect to the
-         *   \par i^th parameter in params
+         *   \par i^th parameter in params. The root is assumed to satisfy
+         *   the zero damping condition, Re(p) = 0, and the frequency
+         *   condition of the PK method, Im(p) = kr V/b. The total
+         *   derivative of both conditions gives a 2x2 system for the
+         *   sensitivity of the flutter speed and of the reduced frequency,
+         *   which are stored in \p root.V_sens and \p root.kr_sens. The
+         *   sensitivity of the generalized aerodynamic force matrix with
+         *   respect to kr requires the reduced frequency parameter to be
+         *   added to the fluid discipline.
          */
         virtual void calculate_sensitivity(MAST::FlutterRootBase& root,
                                            const libMesh::ParameterVector& params,
                                            const unsigned int i);
         
         
+        /*!
+         *   Calculates the sensitivity of the flutter speed of \p root with
+         *   respect to all parameters in \p params, and returns it in
+         *   \p V_sens. The sensitivity of the reduced order matrices for
+         *   all parameters is assembled with a single pass over the
+         *   elements, and the left eigenvector and the sensitivity of the
+         *   eigenvalue with respect to velocity are computed once for all
+         *   parameters. As in the single parameter version, the change in
+         *   the reduced frequency of the root is included. The sensitivity
+         *   data of \p root is not modified.
+         */
+        void calculate_sensitivity(const MAST::FlutterRootBase& root,
+                                   const libMesh::ParameterVector& params,
+                                   std::vector<Real>& V_sens);
+        
+        
     protected:
         
         
@@ -193,6 +226,72 @@ namespace MAST {
                                                  const Real U_inf,
                                                  ComplexMatrixX& L,  // stiff, aero, damp
                                                  ComplexMatrixX& R); // mass
+        
+        
+        /*!
+         *    Assembles the sensitivity of the matrices with respect to all
+         *    parameters in \p params, with \p L[i] and \p R[i] for
+         *    \p params[i].
+         */
+        void
+        _initialize_matrix_sensitivity_for_params(const libMesh::ParameterVector& params,
+                                                  const Real k_red,
+                                                  const Real U_inf,
+                                                  std::vector<ComplexMatrixX>& L,
+                                                  std::vector<ComplexMatrixX>& R);
+        
+        
+        /*!
+         *    Assembles the sensitivity of the matrices with respect to
+         *    the reduced frequency, which is only through the generalized
+         *    aerodynamic force matrix.
+         */
+        void
+        _initialize_matrix_sensitivity_for_kr(const Real k_red,
+                                              const Real U_inf,
+                                              ComplexMatrixX& L,  // stiff, aero, damp
+                                              ComplexMatrixX& R); // mass
+        
+        
+        /*!
+         *    @returns the Jacobian of the flutter conditions
+         *    Re(p) = 0 and Im(p) - kr V/b = 0 of \p root with respect to
+         *    V and kr, for the eigenvalue sensitivities \p deig_dV and
+         *    \p deig_dkr.
+         */
+        RealMatrixX
+        _flutter_condition_jacobian(const MAST::FlutterRootBase& root,
+                                    const Complex& deig_dV,
+                                    const Complex& deig_dkr) const;
+        
+        
+        /*!
+         *    @returns the sensitivity of the eigenvalue of \p root for the
+         *    sensitivity \p dL and \p dR of the matrices \p L and \p R.
+         *    Since the roots store only the displacement part of the
+         *    eigenvectors, this uses the quadratic form of the eigenproblem
+         *        (lambda^2 M + K + q A) x = 0,
+         *    with the left eigenvector \p u of the quadratic problem,
+         *    obtained from _quadratic_left_eigenvector().
+         */
+        Complex
+        _eigenvalue_sensitivity(const MAST::FlutterRootBase& root,
+                                const ComplexVectorX& u,
+                                const ComplexMatrixX& R,
+                                const ComplexMatrixX& dL,
+                                const ComplexMatrixX& dR) const;
+        
+        
+        /*!
+         *    @returns the left eigenvector of the quadratic form of the
+         *    eigenproblem for \p root. If y = {y1^T y2^T}^T is the left
+         *    eigenvector of the first order problem, y1^H = lambda y2^H M,
+         *    and y2 is obtained from the stored y1 with the mass matrix
+         *    of \p R.
+         */
+        ComplexVectorX
+        _quadratic_left_eigenvector(const MAST::FlutterRootBase& root,
+                                    const ComplexMatrixX& R) const;
 
         
         /*!
@@ -253,6 +352,12 @@ namespace MAST {
          *   two bounding roots
          */
         std::multimap<Real, MAST::FlutterRootCrossoverBase*> _flutter_crossovers;
+        
+        /*!
+         *   eigensolver retained between solutions, so that its workspace
+         *   is allocated only once for a given number of modes
+         */
+        MAST::LAPACK_ZGGEV                              _eigen_solver;
 
         
     };
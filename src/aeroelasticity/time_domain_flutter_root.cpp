@@ -61,6 +61,7 @@ MAST::TimeDomainFlutterRoot::init(const Real v_ref_val,
     for (unsigned int i=0; i<nvals; i++)
         modal_participation(i) =  std::abs(std::conj(evec_right(i)) * k_q(i));
     
-    modal_participation *= (1./modal_participation.sum());
+    if (nvals)
+        modal_participation *= (1./modal_participation.sum());
 }
 
@@ -23,8 +23,10 @@
 
 // MAST includes
 #include "aeroelasticity/time_domain_flutter_solution.h"
+#include "base/memory_report.h"
 #include "aeroelasticity/time_domain_flutter_root.h"
 #include "numerics/lapack_dggev_interface.h"
+#include "solver/slepc_quadratic_eigen_solver.h"
 
 
 MAST::TimeDomainFlutterSolution::TimeDomainFlutterSolution():
@@ -44,6 +46,26 @@ MAST::TimeDomainFlutterSolution::init (const MAST::TimeDomainFlutterSolver& solv
                                        const Real v_ref,
                                        const MAST::LAPACK_DGGEV& eig_sol) {
     
+    _init(v_ref, eig_sol);
+}
+
+
+
+void
+MAST::TimeDomainFlutterSolution::init (const MAST::TimeDomainFlutterSolver& solver,
+                                       const Real v_ref,
+                                       const MAST::SlepcQuadraticEigenSolver& eig_sol) {
+    
+    _init(v_ref, eig_sol);
+}
+
+
+
+template <typename EigSolType>
+void
+MAST::TimeDomainFlutterSolution::_init (const Real v_ref,
+                                        const EigSolType& eig_sol) {
+    
     // make sure that it hasn't already been initialized
     libmesh_assert(!_roots.size());
     
@@ -61,8 +83,13 @@ MAST::TimeDomainFlutterSolution::init (const MAST::TimeDomainFlutterSolver& solv
     const RealVectorX
     &den               = eig_sol.betas();
     
-    // use only half the modes that have a positive frequency.
-    unsigned int nvals = (int)_Bmat.rows();
+    // the quadratic eigensolver provides only a subset of the roots
+    unsigned int nvals = (int)num.size();
+    
+    // the full order eigensolver does not compute the eigenvectors, in
+    // which case the roots only store the eigenvalues
+    const bool
+    if_vecs            = VR.cols() > 0;
     
     _roots.resize(nvals);
     for (unsigned int i=0; i<nvals; i++) {
@@ -72,8 +99,8 @@ MAST::TimeDomainFlutterSolution::init (const MAST::TimeDomainFlutterSolver& solv
                    num(i),
                    den(i),
                    _Bmat,
-                   VR.col(i),
-                   VL.col(i));
+                   if_vecs ? ComplexVectorX(VR.col(i)) : ComplexVectorX(),
+                   if_vecs ? ComplexVectorX(VL.col(i)) : ComplexVectorX());
         
         _roots[i] = root;
     }
@@ -179,9 +206,13 @@ MAST::TimeDomainFlutterSolution::sort(const MAST::FlutterSolutionBase& sol) {
         for (unsigned int j=i; j<nvals; j++) {
             
             // use a combination of both the eigenvectors from both
-            // roots
-            val = .5*(r.eig_vec_left.dot(_Bmat*_roots[j]->eig_vec_right) +
-                      _roots[j]->eig_vec_left.dot(_Bmat*r.eig_vec_right));
+            // roots. If the eigenvectors were not computed, only the
+            // eigenvalue distance is used.
+            if (_Bmat.size())
+                val = .5*(r.eig_vec_left.dot(_Bmat*_roots[j]->eig_vec_right) +
+                          _roots[j]->eig_vec_left.dot(_Bmat*r.eig_vec_right));
+            else
+                val = 1.;
             //_roots[j]->modal_participation.dot(r.modal_participation);
             // scale by the eigenvalue separation with the assumption that
             // the roots will be closer to each other than any other
@@ -213,8 +244,11 @@ MAST::TimeDomainFlutterSolution::print(std::ostream &output) {
     libmesh_assert(this->n_roots() > 0);
     
     const unsigned int nvals = this->n_roots();
-    unsigned int n_participation_vals =
-    (unsigned int)this->get_root(0).modal_participation.size();
+    unsigned int
+    n_participation_vals =
+    (unsigned int)this->get_root(0).modal_participation.size(),
+    n_mode_vals          =
+    (unsigned int)this->get_root(0).eig_vec_right.size();
     libmesh_assert(nvals);
     
     // first write the reference values of the root
@@ -237,7 +271,7 @@ MAST::TimeDomainFlutterSolution::print(std::ostream &output) {
         << std::setw(2) << " ";
     
     // output the headers for flutter mode
-    for (unsigned int i=0; i<nvals; i++)
+    for (unsigned int i=0; i<n_mode_vals; i++)
         output
         << std::setw(10) << "|         "
         << std::setw(5) << "Mode "
@@ -264,7 +298,7 @@ MAST::TimeDomainFlutterSolution::print(std::ostream &output) {
             << std::setw(2) << " ";
         
         // now write the flutter mode
-        for (unsigned int j=0; j<nvals; j++)
+        for (unsigned int j=0; j<n_mode_vals; j++)
         {
             output
             << std::setw(2) << "| "
@@ -278,3 +312,13 @@ MAST::TimeDomainFlutterSolution::print(std::ostream &output) {
 }
 
 
+
+std::size_t
+MAST::TimeDomainFlutterSolution::memory_bytes() const {
+    
+    return
+    MAST::FlutterSolutionBase::memory_bytes() +
+    MAST::MemoryReport::dense_bytes(_Amat) +
+    MAST::MemoryReport::dense_bytes(_Bmat);
+}
+
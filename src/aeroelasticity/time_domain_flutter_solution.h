@@ -33,6 +33,7 @@ namespace MAST {
     // Forward declerations
     class TimeDomainFlutterSolver;
     class LAPACK_DGGEV;
+    class SlepcQuadraticEigenSolver;
 
     
     class TimeDomainFlutterSolution:
@@ -54,6 +55,14 @@ namespace MAST {
                    const Real v_ref,
                    const MAST::LAPACK_DGGEV& eig_sol);
         
+        /*!
+         *   initializes the roots from the subset of eigenpairs computed
+         *   by the quadratic eigensolver
+         */
+        void init (const MAST::TimeDomainFlutterSolver& solver,
+                   const Real v_ref,
+                   const MAST::SlepcQuadraticEigenSolver& eig_sol);
+        
         /*!
          *   number of unstable roots in this solution. Only roots with damping
          *   greater than \par tol will be considered unstable.
@@ -74,6 +83,13 @@ namespace MAST {
          *    prints the data and modes from this solution
          */
         virtual void print(std::ostream& output);
+        
+        
+        /*!
+         *    @returns the bytes of the roots and of the matrices of this
+         *    solution
+         */
+        virtual std::size_t memory_bytes() const;
 
         
         /*!
@@ -84,6 +100,15 @@ namespace MAST {
         
     protected:
         
+        /*!
+         *   initializes the roots from the eigensolution in \p eig_sol,
+         *   which is either MAST::LAPACK_DGGEV or
+         *   MAST::SlepcQuadraticEigenSolver.
+         */
+        template <typename EigSolType>
+        void _init(const Real v_ref,
+                   const EigSolType& eig_sol);
+        
         /*!
          *    Matrix used for scaling of eigenvectors, and sorting of roots
          */
@@ -27,15 +27,26 @@
 #include "base/physics_discipline_base.h"
 #include "base/boundary_condition_base.h"
 #include "numerics/lapack_dggev_interface.h"
+#include "solver/slepc_quadratic_eigen_solver.h"
 #include "base/parameter.h"
+#include "base/performance_log.h"
 #include "base/nonlinear_system.h"
+#include "base/memory_report.h"
+
+
+// libMesh includes
+#include "libmesh/sparse_matrix.h"
+#include "libmesh/dof_map.h"
 
 
 MAST::TimeDomainFlutterSolver::TimeDomainFlutterSolver():
 MAST::FlutterSolverBase(),
 _velocity_param(nullptr),
 _V_range(),
-_n_V_divs(0.) {
+_n_V_divs(0.),
+_quadratic_eigen_solver(nullptr),
+_full_order_eigensolver(false),
+_max_factorization_reuse(5) {
     
 }
 
@@ -44,6 +55,9 @@ _n_V_divs(0.) {
 MAST::TimeDomainFlutterSolver::~TimeDomainFlutterSolver() {
     
     this->clear();
+    
+    if (_quadratic_eigen_solver)
+        delete _quadratic_eigen_solver;
 }
 
 
@@ -57,6 +71,8 @@ MAST::TimeDomainFlutterSolver::clear() {
     _V_range          = std::pair<Real, Real>(0.,0.);
     _n_V_divs         = 0;
     
+    _clear_full_order_matrices();
+    
     MAST::FlutterSolverBase::clear();
 }
 
@@ -176,6 +192,7 @@ MAST::TimeDomainFlutterSolver::find_next_root(const Real g_tol,
                                       root_num, g_tol, n_bisection_iters);
             
             cross->root = &(sol.second->get_root(root_num));
+            this->_report_root("TimeDomainFlutterSolver", *cross->root);
             
             // now, remove this entry from the _flutter_crossover points and
             // reinsert it with the actual critical velocity
@@ -230,6 +247,7 @@ MAST::TimeDomainFlutterSolver::find_critical_root(const Real g_tol,
                                      root_num, g_tol, n_bisection_iters);
             
             cross->root = &(sol.second->get_root(root_num));
+            this->_report_root("TimeDomainFlutterSolver", *cross->root);
             
             // now, remove this entry from the _flutter_crossover points and
             // reinsert it with the actual critical velocity
@@ -636,6 +654,44 @@ _bisection_search(const std::pair<MAST::FlutterSolutionBase*,
 
 
 
+void
+MAST::TimeDomainFlutterSolver::set_quadratic_eigensolver(bool f,
+                                                         unsigned int n_eig,
+                                                         Real target) {
+    
+    if (_quadratic_eigen_solver) {
+        
+        delete _quadratic_eigen_solver;
+        _quadratic_eigen_solver = nullptr;
+    }
+    
+    if (f) {
+        
+        libmesh_assert_greater(n_eig, 0);
+        
+        _quadratic_eigen_solver = new MAST::SlepcQuadraticEigenSolver;
+        _quadratic_eigen_solver->set_n_eigenvalues(n_eig);
+        _quadratic_eigen_solver->set_target(target);
+    }
+}
+
+
+
+
+void
+MAST::TimeDomainFlutterSolver::set_full_order_eigensolver(bool f,
+                                                          unsigned int max_reuse) {
+    
+    _full_order_eigensolver  = f;
+    _max_factorization_reuse = max_reuse;
+    
+    if (!f)
+        _clear_full_order_matrices();
+}
+
+
+
+
 std::auto_ptr<MAST::TimeDomainFlutterSolution>
 MAST::TimeDomainFlutterSolver::_analyze(const Real v_ref,
                                        const MAST::FlutterSolutionBase* prev_sol) {
@@ -645,19 +701,63 @@ MAST::TimeDomainFlutterSolver::_analyze(const Real v_ref,
     << "Eigensolution" << std::endl
     << "   V_ref = " << std::setw(10) << v_ref << std::endl;
     
-    RealMatrixX
-    A,
-    B;
-    
-    // initialize the matrices for the structure.
-    _initialize_matrices(v_ref, A, B);
+    MAST::TimeDomainFlutterSolution* root = new MAST::TimeDomainFlutterSolution;
     
-    MAST::LAPACK_DGGEV ges;
-    ges.compute(A, B);
-    ges.scale_eigenvectors_to_identity_innerproduct();
+    if (!_quadratic_eigen_solver) {
+        
+        RealMatrixX
+        A,
+        B;
+        
+        // initialize the matrices for the structure.
+        _initialize_matrices(v_ref, A, B);
+        
+        MAST::LAPACK_DGGEV& ges = _eigen_solver;
+        {
+            MAST_LOG_SCOPE("eigensolve()", "TimeDomainFlutterSolver");
+            ges.compute(A, B);
+        }
+        ges.scale_eigenvectors_to_identity_innerproduct();
+        
+        root->init(*this, v_ref, ges);
+    }
+    else if (!_full_order_eigensolver) {
+        
+        RealMatrixX
+        m,
+        c,
+        k;
+        
+        // initialize the matrices for the structure.
+        _initialize_structural_matrices(v_ref, m, c, k);
+        
+        MAST::SlepcQuadraticEigenSolver& qes = *_quadratic_eigen_solver;
+        {
+            MAST_LOG_SCOPE("quadratic_eigensolve()", "TimeDomainFlutterSolver");
+            qes.compute(m, c, k);
+        }
+        qes.scale_eigenvectors_to_identity_innerproduct();
+        
+        root->init(*this, v_ref, qes);
+    }
+    else {
+        
+        // initialize the sparse matrices of the full order system
+        _initialize_full_order_matrices(v_ref);
+        
+        MAST::SlepcQuadraticEigenSolver& qes = *_quadratic_eigen_solver;
+        qes.set_reuse_factorization(_max_factorization_reuse > 0,
+                                    _max_factorization_reuse);
+        {
+            MAST_LOG_SCOPE("full_order_eigensolve()", "TimeDomainFlutterSolver");
+            qes.compute(*_full_order_matrices[MAST::MASS],
+                        *_full_order_matrices[MAST::DAMPING],
+                        *_full_order_matrices[MAST::STIFFNESS]);
+        }
+        
+        root->init(*this, v_ref, qes);
+    }
     
-    MAST::TimeDomainFlutterSolution* root = new MAST::TimeDomainFlutterSolution;
-    root->init(*this, v_ref, ges);
     if (prev_sol)
         root->sort(*prev_sol);
     
@@ -677,6 +777,8 @@ MAST::TimeDomainFlutterSolver::_initialize_matrices(Real U_inf,
                                                     RealMatrixX &A,
                                                     RealMatrixX &B) {
     
+    MAST_LOG_SCOPE("initialize_matrices()", "TimeDomainFlutterSolver");
+    
     // now create the matrices for first-order model
     // original equations are
     //    M x_ddot + C x_dot + K x = q_dyn (A0 x + A1 x_dot)
@@ -696,21 +798,6 @@ MAST::TimeDomainFlutterSolver::_initialize_matrices(Real U_inf,
     //
 
     
-    // set the velocity value in the parameter that was provided
-    (*_velocity_param) = U_inf;
-    
-
-    // if the steady solver object is provided, then solve for the
-    // steady state using this velocity
-    if (_steady_solver) {
-        libMesh::out
-        << "***  Performing Steady State Solve ***" << std::endl;
-        
-        _steady_solver->solve();
-        _assembly->reattach_to_system();
-    }
-    
-    
     const unsigned int n = (unsigned int)_basis_vectors->size();
 
     RealMatrixX
@@ -718,6 +805,42 @@ MAST::TimeDomainFlutterSolver::_initialize_matrices(Real U_inf,
     c      =  RealMatrixX::Zero(n, n),
     k      =  RealMatrixX::Zero(n, n);
 
+    _initialize_structural_matrices(U_inf, m, c, k);
+    
+    
+    // put the matrices back in the system matrices
+    A.setZero(2*n, 2*n);
+    B.setZero(2*n, 2*n);
+    
+    
+    B.topLeftCorner(n, n)      = RealMatrixX::Identity(n,n );
+    B.bottomRightCorner(n, n)  = m;
+    
+    
+    A.topRightCorner(n, n)     = RealMatrixX::Identity(n, n);
+    A.bottomLeftCorner(n, n)   = -k;
+    A.bottomRightCorner(n, n)  = -c;
+}
+
+
+
+
+void
+MAST::TimeDomainFlutterSolver::
+_initialize_structural_matrices(Real U_inf,
+                                RealMatrixX &m,
+                                RealMatrixX &c,
+                                RealMatrixX &k) {
+    
+    MAST_LOG_SCOPE("initialize_structural_matrices()", "TimeDomainFlutterSolver");
+    
+    _set_velocity(U_inf);
+    
+    const unsigned int n = (unsigned int)_basis_vectors->size();
+
+    m.setZero(n, n);
+    c.setZero(n, n);
+    k.setZero(n, n);
     
     // now prepare a map of the quantities and ask the assembly object to
     // calculate the quantities of interest.
@@ -727,22 +850,84 @@ MAST::TimeDomainFlutterSolver::_initialize_matrices(Real U_inf,
     qty_map[MAST::STIFFNESS]  = &k;
     
     
-    _assembly->assemble_reduced_order_quantity(*_basis_vectors,
-                                               qty_map);
+    // the structural quantities are reused between evaluations, unless
+    // they depend on the velocity, or the steady solution has changed.
+    // With the velocity polynomial cache, the velocity dependent
+    // quantities are computed from the retained coefficient matrices.
+    _assemble_reduced_order_quantity(qty_map,
+                                     std::vector<MAST::Parameter*>(1, _velocity_param),
+                                     _velocity_param);
+}
+
+
+
+
+void
+MAST::TimeDomainFlutterSolver::_initialize_full_order_matrices(Real U_inf) {
     
+    MAST_LOG_SCOPE("initialize_full_order_matrices()", "TimeDomainFlutterSolver");
     
-    // put the matrices back in the system matrices
-    A.setZero(2*n, 2*n);
-    B.setZero(2*n, 2*n);
+    _set_velocity(U_inf);
     
+    // the matrices are created with the sparsity of the system on the
+    // first call, and are reused for subsequent velocities
+    if (!_full_order_matrices.size()) {
+        
+        MAST::NonlinearSystem& sys = _assembly->system();
+        
+        const MAST::StructuralQuantityType
+        qty[3] = {MAST::MASS, MAST::DAMPING, MAST::STIFFNESS};
+        
+        for (unsigned int i=0; i<3; i++) {
+            
+            libMesh::SparseMatrix<Real>*
+            mat = libMesh::SparseMatrix<Real>::build(sys.comm()).release();
+            mat->attach_dof_map(sys.get_dof_map());
+            mat->init();
+            
+            _full_order_matrices[qty[i]] = mat;
+        }
+    }
     
-    B.topLeftCorner(n, n)      = RealMatrixX::Identity(n,n );
-    B.bottomRightCorner(n, n)  = m;
+    _assembly->assemble_quantity(_full_order_matrices);
+}
+
+
+
+
+void
+MAST::TimeDomainFlutterSolver::_set_velocity(Real U_inf) {
+    
+    // set the velocity value in the parameter that was provided
+    (*_velocity_param) = U_inf;
     
+
+    // if the steady solver object is provided, then solve for the
+    // steady state using this velocity
+    if (_steady_solver) {
+        libMesh::out
+        << "***  Performing Steady State Solve ***" << std::endl;
+        
+        this->_steady_solve(*_velocity_param,
+                            std::vector<MAST::Parameter*>(1, _velocity_param));
+        _assembly->reattach_to_system();
+    }
+}
+
+
+
+
+void
+MAST::TimeDomainFlutterSolver::_clear_full_order_matrices() {
     
-    A.topRightCorner(n, n)     = RealMatrixX::Identity(n, n);
-    A.bottomLeftCorner(n, n)   = -k;
-    A.bottomRightCorner(n, n)  = -c;
+    std::map<MAST::StructuralQuantityType, libMesh::SparseMatrix<Real>*>::iterator
+    it  = _full_order_matrices.begin(),
+    end = _full_order_matrices.end();
+    
+    for ( ; it != end; it++)
+        delete it->second;
+    
+    _full_order_matrices.clear();
 }
 
 
@@ -819,6 +1004,67 @@ _initialize_matrix_sensitivity_for_param(const libMesh::ParameterVector& params,
 
 
 
+void
+MAST::TimeDomainFlutterSolver::
+_initialize_matrix_sensitivity_for_params(const libMesh::ParameterVector& params,
+                                          const std::vector<libMesh::NumericVector<Real>*>& dXdp,
+                                          Real U_inf,
+                                          std::vector<RealMatrixX>& A,
+                                          std::vector<RealMatrixX>& B) {
+    
+    // see _initialize_matrix_sensitivity_for_param() for the first order
+    // system matrices
+    const unsigned int
+    n        = (unsigned int)_basis_vectors->size(),
+    n_params = params.size();
+    
+    std::vector<RealMatrixX>
+    m(n_params),
+    c(n_params),
+    k(n_params);
+    
+    // now prepare a map of the quantities for each parameter and ask the
+    // assembly object to calculate the quantities of interest.
+    std::vector<std::map<MAST::StructuralQuantityType, RealMatrixX*> >
+    qty_maps(n_params);
+    
+    for (unsigned int i=0; i<n_params; i++) {
+        qty_maps[i][MAST::MASS]       = &m[i];
+        qty_maps[i][MAST::DAMPING]    = &c[i];
+        qty_maps[i][MAST::STIFFNESS]  = &k[i];
+    }
+    
+    std::vector<const libMesh::NumericVector<Real>*>
+    sol_sens(dXdp.begin(), dXdp.end());
+    
+    // set the velocity value in the parameter that was provided
+    (*_velocity_param) = U_inf;
+    
+    _assembly->assemble_reduced_order_quantity_sensitivity
+    (params, *_basis_vectors, sol_sens, qty_maps);
+    
+    
+    // put the matrices back in the system matrices
+    A.resize(n_params);
+    B.resize(n_params);
+    
+    for (unsigned int i=0; i<n_params; i++) {
+        
+        A[i].setZero(2*n, 2*n);
+        B[i].setZero(2*n, 2*n);
+        
+        B[i].topLeftCorner(n, n)      = RealMatrixX::Identity(n,n );
+        B[i].bottomRightCorner(n, n)  = m[i];
+        
+        A[i].topRightCorner(n, n)     = RealMatrixX::Identity(n, n);
+        A[i].bottomLeftCorner(n, n)   = -k[i];
+        A[i].bottomRightCorner(n, n)  = -c[i];
+    }
+}
+
+
+
+
 
 void
 MAST::TimeDomainFlutterSolver::_identify_crossover_points() {
@@ -989,6 +1235,97 @@ MAST::TimeDomainFlutterSolver::_identify_crossover_points() {
 
 
 
+void
+MAST::TimeDomainFlutterSolver::
+calculate_sensitivity(const MAST::FlutterRootBase& root,
+                      const libMesh::ParameterVector& params,
+                      const std::vector<libMesh::NumericVector<Real>*>& dXdp,
+                      std::vector<Real>& V_sens,
+                      libMesh::NumericVector<Real>* dXdV) {
+    
+    libmesh_assert(!dXdp.size() || dXdp.size() == params.size());
+    
+    // the eigenvectors are not computed by the full order eigensolver
+    if (!root.eig_vec_right.size())
+        libmesh_error_msg("Error: flutter sensitivity requires the eigenvectors of the root, which are not computed by the full order eigensolver.");
+    
+    libMesh::out
+    << " ====================================================" << std::endl
+    << "Flutter Sensitivity Solution" << std::endl
+    << "   V_ref    = " << std::setw(10) << root.V << std::endl
+    << "   n_params = " << std::setw(10) << params.size() << std::endl;
+    
+    const unsigned int n_params = params.size();
+    
+    Complex
+    eig              = root.root,
+    deig_dp          = 0.,
+    deig_dV          = 0.,
+    den              = 0.;
+    
+    RealMatrixX
+    mat_A,
+    mat_B,
+    mat_A_sens,
+    mat_B_sens;
+    
+    std::vector<RealMatrixX>
+    mat_A_param_sens,
+    mat_B_param_sens;
+    
+    // initialize the baseline matrices
+    _initialize_matrices(root.V, mat_A, mat_B);
+    
+    // the sensitivity of the matrices for all parameters
+    _initialize_matrix_sensitivity_for_params(params,
+                                              dXdp,
+                                              root.V,
+                                              mat_A_param_sens,
+                                              mat_B_param_sens);
+    
+    // the sensitivity of eigenvalue wrt V is the same for all parameters
+    libMesh::ParameterVector param_V;
+    param_V.resize(1);
+    param_V[0]  =  _velocity_param->ptr();
+    
+    std::auto_ptr<libMesh::NumericVector<Real> > zero_sol_sens;
+    libMesh::NumericVector<Real>* sol_sens = dXdV;
+    if (!dXdV) {
+        zero_sol_sens.reset(_assembly->system().solution->zero_clone().release());
+        sol_sens = zero_sol_sens.get();
+    }
+    
+    _initialize_matrix_sensitivity_for_param(param_V,
+                                             0,
+                                             *sol_sens,
+                                             root.V,
+                                             mat_A_sens,
+                                             mat_B_sens);
+    
+    den     = root.eig_vec_left.dot(mat_B*root.eig_vec_right);
+    deig_dV = root.eig_vec_left.dot((mat_A_sens.cast<Complex>() -
+                                     eig*mat_B_sens.cast<Complex>())*root.eig_vec_right)/den;
+    
+    // see the single parameter calculate_sensitivity() for the
+    // derivation of the expression below
+    V_sens.resize(n_params);
+    
+    for (unsigned int i=0; i<n_params; i++) {
+        
+        deig_dp = root.eig_vec_left.dot((mat_A_param_sens[i].cast<Complex>() -
+                                         eig*mat_B_param_sens[i].cast<Complex>())*root.eig_vec_right)/den;
+        
+        V_sens[i] = - deig_dp.real() / deig_dV.real();
+    }
+    
+    libMesh::out
+    << "Finished Flutter Sensitivity Solution" << std::endl
+    << " ====================================================" << std::endl;
+}
+
+
+
+
 void
 MAST::TimeDomainFlutterSolver::
 calculate_sensitivity(MAST::FlutterRootBase& root,
@@ -997,7 +1334,9 @@ calculate_sensitivity(MAST::FlutterRootBase& root,
                       libMesh::NumericVector<Real>* dXdp,
                       libMesh::NumericVector<Real>* dXdV) {
     
-    
+    // the eigenvectors are not computed by the full order eigensolver
+    if (!root.eig_vec_right.size())
+        libmesh_error_msg("Error: flutter sensitivity requires the eigenvectors of the root, which are not computed by the full order eigensolver.");
     
     libMesh::out
     << " ====================================================" << std::endl
@@ -1101,3 +1440,15 @@ calculate_sensitivity(MAST::FlutterRootBase& root,
     << " ====================================================" << std::endl;
     
 }
+
+
+
+void
+MAST::TimeDomainFlutterSolver::report_memory(MAST::MemoryReport& r,
+                                             const std::string& nm) const {
+    
+    MAST::FlutterSolverBase::report_memory(r, nm);
+    
+    r.add(nm, "flutter solutions", _solutions_memory(_flutter_solutions));
+}
+
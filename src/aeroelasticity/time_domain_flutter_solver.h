@@ -26,6 +26,7 @@
 
 // MAST includes
 #include "aeroelasticity/flutter_solver_base.h"
+#include "numerics/lapack_dggev_interface.h"
 
 
 
@@ -33,6 +34,7 @@ namespace MAST {
     
     // Forward declerations
     class TimeDomainFlutterSolution;
+    class SlepcQuadraticEigenSolver;
     
     
     /*!
@@ -145,12 +147,40 @@ namespace MAST {
                               libMesh::NumericVector<Real>* dXdV = nullptr);
         
         
+        /*!
+         *   Calculates the sensitivity of the flutter speed of \p root with
+         *   respect to all parameters in \p params, and returns it in
+         *   \p V_sens. The sensitivity of the reduced order matrices for
+         *   all parameters is assembled with a single pass over the
+         *   elements, and the sensitivity of the eigenvalue with respect
+         *   to velocity is computed once for all parameters. \p dXdp[i]
+         *   is the sensitivity of the base solution for \p params[i],
+         *   which is assumed to be zero if \p dXdp is empty or the entry
+         *   is \p nullptr. The same applies to \p dXdV. The sensitivity
+         *   data of \p root is not modified.
+         */
+        void
+        calculate_sensitivity(const MAST::FlutterRootBase& root,
+                              const libMesh::ParameterVector& params,
+                              const std::vector<libMesh::NumericVector<Real>*>& dXdp,
+                              std::vector<Real>& V_sens,
+                              libMesh::NumericVector<Real>* dXdV = nullptr);
+        
+        
         /*!
          *   Prints the sorted roots to the \par output
          */
         virtual void print_sorted_roots();
         
         
+        /*!
+         *   adds the bytes of the flutter solutions to those reported by
+         *   the parent class
+         */
+        virtual void report_memory(MAST::MemoryReport& r,
+                                   const std::string& nm) const;
+        
+        
         /*!
          *   Prints the crossover points output. If no pointer to output is given
          *   then the output defined by set_output_file() is used.
@@ -166,6 +196,39 @@ namespace MAST {
         virtual void scan_for_roots();
         
         
+        /*!
+         *   tells the solver to compute only the \p n_eig roots closest to
+         *   \p target by solving the quadratic eigenproblem
+         *   (p^2 M + p C + K) x = 0 with SLEPc, instead of the dense
+         *   eigensolution of the first order system of size twice the
+         *   number of basis vectors. This is useful for large bases, where
+         *   only the lowest frequency roots are of interest. The number of
+         *   roots must be the same for all solutions, since they are sorted
+         *   with respect to each other. If \p f is \p false, the dense
+         *   eigensolution is used, which is the default.
+         */
+        void set_quadratic_eigensolver(bool f,
+                                       unsigned int n_eig = 0,
+                                       Real target = 0.);
+        
+        
+        /*!
+         *   tells the quadratic eigensolver to use the distributed sparse
+         *   mass, damping and stiffness matrices of the full order system,
+         *   instead of the reduced order matrices. Only the eigenvalues are
+         *   computed, and the roots are sorted by eigenvalue distance. The
+         *   roots then have no eigenvectors or modal participation, and
+         *   calculate_sensitivity() reports an error for them. The
+         *   factorization of the shift-and-invert operator is reused for up
+         *   to \p max_reuse subsequent velocities as a preconditioner, and
+         *   is not reused if \p max_reuse is zero. This has an effect only
+         *   if set_quadratic_eigensolver() has been called, and is
+         *   \p false by default.
+         */
+        void set_full_order_eigensolver(bool f,
+                                        unsigned int max_reuse = 5);
+        
+        
     protected:
         
         
@@ -198,6 +261,37 @@ namespace MAST {
         void _initialize_matrices(Real U_inf,
                                   RealMatrixX& A,
                                   RealMatrixX& B);
+        
+        
+        /*!
+         *    Assembles the reduced order mass, damping and stiffness
+         *    matrices for specified flight velocity \par U_inf.
+         */
+        void _initialize_structural_matrices(Real U_inf,
+                                             RealMatrixX& m,
+                                             RealMatrixX& c,
+                                             RealMatrixX& k);
+        
+        
+        /*!
+         *    Assembles the full order mass, damping and stiffness matrices
+         *    in \p _full_order_matrices for specified flight velocity
+         *    \par U_inf.
+         */
+        void _initialize_full_order_matrices(Real U_inf);
+        
+        
+        /*!
+         *    sets the velocity parameter to \par U_inf and computes the
+         *    steady state solution, if a steady solver has been provided.
+         */
+        void _set_velocity(Real U_inf);
+        
+        
+        /*!
+         *    deletes the matrices in \p _full_order_matrices
+         */
+        void _clear_full_order_matrices();
 
         
         /*!
@@ -213,6 +307,20 @@ namespace MAST {
                                                  RealMatrixX& B);
 
         
+        /*!
+         *    Assembles the sensitivity of the first order system matrices
+         *    with respect to all parameters in \p params, with \p A[i] and
+         *    \p B[i] for \p params[i]. See
+         *    StructuralFluidInteractionAssembly::assemble_reduced_order_quantity_sensitivity().
+         */
+        void
+        _initialize_matrix_sensitivity_for_params(const libMesh::ParameterVector& params,
+                                                  const std::vector<libMesh::NumericVector<Real>*>& dXdp,
+                                                  Real U_inf,
+                                                  std::vector<RealMatrixX>& A,
+                                                  std::vector<RealMatrixX>& B);
+        
+        
         /*!
          *   identifies all cross-over and divergence points from analyzed
          *   roots
@@ -249,6 +357,32 @@ namespace MAST {
          *   two bounding roots
          */
         std::multimap<Real, MAST::FlutterRootCrossoverBase*> _flutter_crossovers;
+        
+        /*!
+         *   eigensolver retained between solutions, so that its workspace
+         *   is allocated only once for a given number of modes
+         */
+        MAST::LAPACK_DGGEV                              _eigen_solver;
+        
+        /*!
+         *   quadratic eigensolver used instead of \p _eigen_solver, if
+         *   requested through set_quadratic_eigensolver()
+         */
+        MAST::SlepcQuadraticEigenSolver*                _quadratic_eigen_solver;
+        
+        /*!
+         *   flag to use the full order matrices with the quadratic
+         *   eigensolver, and the number of velocities for which the
+         *   factorization is reused
+         */
+        bool                                            _full_order_eigensolver;
+        
+        unsigned int                                    _max_factorization_reuse;
+        
+        /*!
+         *   full order matrices used by the quadratic eigensolver
+         */
+        std::map<MAST::StructuralQuantityType, libMesh::SparseMatrix<Real>*> _full_order_matrices;
 
     };
 }
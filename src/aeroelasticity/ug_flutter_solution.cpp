@@ -25,6 +25,7 @@
 
 // MAST includes
 #include "aeroelasticity/ug_flutter_solution.h"
+#include "base/memory_report.h"
 #include "aeroelasticity/ug_flutter_root.h"
 #include "numerics/lapack_zggev_base.h"
 
@@ -217,3 +218,12 @@ MAST::UGFlutterSolution::print(std::ostream &output)
 
 
 
+std::size_t
+MAST::UGFlutterSolution::memory_bytes() const {
+    
+    return
+    MAST::FlutterSolutionBase::memory_bytes() +
+    MAST::MemoryReport::dense_bytes(_Amat) +
+    MAST::MemoryReport::dense_bytes(_Bmat);
+}
+
@@ -74,6 +74,22 @@ namespace MAST {
         virtual void print(std::ostream& output);
         
         
+        /*!
+         *    @returns the bytes of the roots and of the matrices of this
+         *    solution
+         */
+        virtual std::size_t memory_bytes() const;
+        
+        
+        /*!
+         *    @returns the matrices of the eigenproblem from which this
+         *    solution was computed
+         */
+        const ComplexMatrixX& A() const { return _Amat; }
+        
+        const ComplexMatrixX& B() const { return _Bmat; }
+        
+        
     protected:
         
         /*!
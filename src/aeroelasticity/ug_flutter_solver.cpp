@@ -18,6 +18,16 @@
  */
 
 
+// C++ includes
+#include <fstream>
+#include <set>
+#include <algorithm>
+#include <functional>
+#include <thread>
+#include <cstring>
+#include <cmath>
+
+
 // MAST includes
 #include "aeroelasticity/ug_flutter_solver.h"
 #include "aeroelasticity/ug_flutter_solution.h"
@@ -29,7 +39,13 @@
 #include "base/boundary_condition_base.h"
 #include "numerics/lapack_zggev_interface.h"
 #include "base/parameter.h"
+#include "base/performance_log.h"
 #include "base/nonlinear_system.h"
+#include "base/memory_report.h"
+
+
+// libMesh includes
+#include "libmesh/numeric_vector.h"
 
 
 MAST::UGFlutterSolver::UGFlutterSolver():
@@ -38,7 +54,13 @@ _kr_param(nullptr),
 _bref_param(nullptr),
 _kr_range(),
 _n_kr_divs(0.),
-_include_highest_kr_unstable(false) {
+_include_highest_kr_unstable(false),
+_threaded_scan(false),
+_pipelined_scan(false),
+_prefetch_root(true),
+_root_tracking(false),
+_tracking_mac_tol(0.9),
+_warm_start(false) {
     
 }
 
@@ -109,6 +131,8 @@ MAST::UGFlutterSolver::clear_solutions() {
     
     _flutter_solutions.clear();
     _flutter_crossovers.clear();
+    _warm_start_kr.clear();
+    _prefetched_matrices.clear();
 }
 
 
@@ -181,10 +205,15 @@ MAST::UGFlutterSolver::find_next_root(const Real g_tol,
              g_tol,
              n_bisection_iters);
              if (!sol.first)*/
-            sol =   _bisection_search(cross->crossover_solutions,
-                                      root_num, g_tol, n_bisection_iters);
+            if (_root_tracking)
+                sol = _tracking_search(cross->crossover_solutions,
+                                       root_num, g_tol, n_bisection_iters);
+            else
+                sol = _bisection_search(cross->crossover_solutions,
+                                        root_num, g_tol, n_bisection_iters);
             
             cross->root = &(sol.second->get_root(root_num));
+            this->_report_root("UGFlutterSolver", *cross->root);
             
             // now, remove this entry from the _flutter_crossover points and
             // reinsert it with the actual critical velocity
@@ -234,10 +263,15 @@ MAST::UGFlutterSolver::find_critical_root(const Real g_tol,
              g_tol,
              n_bisection_iters);
              if (!sol.first)*/
-            sol =   _bisection_search(cross->crossover_solutions,
-                                      root_num, g_tol, n_bisection_iters);
+            if (_root_tracking)
+                sol = _tracking_search(cross->crossover_solutions,
+                                       root_num, g_tol, n_bisection_iters);
+            else
+                sol = _bisection_search(cross->crossover_solutions,
+                                        root_num, g_tol, n_bisection_iters);
             
             cross->root = &(sol.second->get_root(root_num));
+            this->_report_root("UGFlutterSolver", *cross->root);
             
             // now, remove this entry from the _flutter_crossover points and
             // reinsert it with the actual critical velocity
@@ -261,28 +295,66 @@ MAST::UGFlutterSolver::find_critical_root(const Real g_tol,
 void
 MAST::UGFlutterSolver::scan_for_roots() {
     
-    // if the initial scanning has not been done, then do it now
-    if (!_flutter_solutions.size()) {
-        // march from the upper limit to the lower to find the roots
-        Real
-        current_kr  = _kr_range.second,
-        delta_kr    = (_kr_range.second - _kr_range.first)/_n_kr_divs;
-        
-        std::vector<Real> k_vals(_n_kr_divs+1);
-        for (unsigned int i=0; i<_n_kr_divs+1; i++) {
-            k_vals[i]      = current_kr;
-            current_kr    -= delta_kr;
-        }
-        k_vals[_n_kr_divs] = _kr_range.first; // to get around finite-precision arithmetic
+    // the scan is performed only if it has not been done, or replaced by
+    // the solutions read with read_binary_state()
+    if (_flutter_solutions.size())
+        return;
+    
+    // march from the upper limit to the lower to find the roots
+    Real
+    current_kr  = _kr_range.second,
+    delta_kr    = (_kr_range.second - _kr_range.first)/_n_kr_divs;
+    
+    std::vector<Real> k_vals(_n_kr_divs+1);
+    for (unsigned int i=0; i<_n_kr_divs+1; i++) {
+        k_vals[i]      = current_kr;
+        current_kr    -= delta_kr;
+    }
+    k_vals[_n_kr_divs] = _kr_range.first; // to get around finite-precision arithmetic
+    
+    // the crossover brackets of a prior state are added to the scan, so
+    // that the crossovers near the prior roots are bracketed more closely
+    if (_warm_start_kr.size()) {
+        
+        k_vals.insert(k_vals.end(), _warm_start_kr.begin(), _warm_start_kr.end());
+        std::sort(k_vals.begin(), k_vals.end(), std::greater<Real>());
+        k_vals.erase(std::unique(k_vals.begin(), k_vals.end()), k_vals.end());
+        _warm_start_kr.clear();
+    }
+    
+    _scan_reduced_frequencies(k_vals);
+}
+
+
+
+
+void
+MAST::UGFlutterSolver::
+_scan_reduced_frequencies(const std::vector<Real>& k_vals) {
+    
+    // the reduced frequencies that already have a solution are skipped
+    std::vector<Real> new_k_vals;
+    for (unsigned int i=0; i<k_vals.size(); i++)
+        if (!_flutter_solutions.count(k_vals[i]))
+            new_k_vals.push_back(k_vals[i]);
+    
+    if (!new_k_vals.size())
+        return;
+    
+    if (_pipelined_scan && !_threaded_scan)
+        _add_pipelined_solutions(new_k_vals);
+    else if (!_threaded_scan) {
+        
+        std::map<Real, MAST::FlutterSolutionBase*>::const_iterator it;
         
-        MAST::FlutterSolutionBase* prev_sol = nullptr;
-        for (unsigned int i=0; i< _n_kr_divs+1; i++) {
+        for (unsigned int i=0; i<new_k_vals.size(); i++) {
             
-            current_kr = k_vals[i];
-            std::auto_ptr<MAST::FlutterSolutionBase> sol =
-            _analyze(current_kr, prev_sol);
+            // sort with respect to the solution at the next higher kr
+            it = _flutter_solutions.upper_bound(new_k_vals[i]);
             
-            prev_sol = sol.get();
+            std::auto_ptr<MAST::FlutterSolutionBase> sol =
+            _analyze(new_k_vals[i],
+                     it != _flutter_solutions.end()? it->second: nullptr);
             
             if (_output)
                 sol->print(*_output);
@@ -290,18 +362,461 @@ MAST::UGFlutterSolver::scan_for_roots() {
             // add the solution to this solver
             bool if_success =
             _flutter_solutions.insert(std::pair<Real, MAST::FlutterSolutionBase*>
-                                      (current_kr, sol.release())).second;
+                                      (new_k_vals[i], sol.release())).second;
             
             libmesh_assert(if_success);
         }
+    }
+    else {
         
-        _identify_crossover_points();
+        // the matrices are assembled for all frequencies on the
+        // communicator of the system
+        std::vector<ComplexMatrixX>
+        A(new_k_vals.size()),
+        B(new_k_vals.size());
+        
+        for (unsigned int i=0; i<new_k_vals.size(); i++)
+            _initialize_matrices(new_k_vals[i], A[i], B[i]);
+        
+        _add_solutions(new_k_vals, A, B);
     }
+    
+    // no root has been searched yet, so the crossovers are identified
+    // again from all solutions
+    std::multimap<Real, MAST::FlutterRootCrossoverBase*>::iterator
+    cross_it  = _flutter_crossovers.begin(),
+    cross_end = _flutter_crossovers.end();
+    
+    for ( ; cross_it != cross_end; cross_it++)
+        delete cross_it->second;
+    _flutter_crossovers.clear();
+    
+    _identify_crossover_points();
 }
 
 
 
 
+void
+MAST::UGFlutterSolver::
+_add_solutions(const std::vector<Real>& k_vals,
+               const std::vector<ComplexMatrixX>& A,
+               const std::vector<ComplexMatrixX>& B) {
+    
+    libmesh_assert_equal_to(A.size(), k_vals.size());
+    libmesh_assert_equal_to(B.size(), k_vals.size());
+    
+    const unsigned int n = (unsigned int)k_vals.size();
+    std::vector<MAST::UGFlutterSolution*> sols(n, nullptr);
+    
+    if (_threaded_scan) {
+        
+        // the eigensolutions are independent of each other
+        _scan_eigen_solvers.resize(n);
+        
+        std::vector<MAST::LAPACK_ZGGEV_Base*>
+        ges(n, nullptr);
+        std::vector<const ComplexMatrixX*>
+        A_ptr(n, nullptr),
+        B_ptr(n, nullptr);
+        
+        for (unsigned int i=0; i<n; i++) {
+            ges[i]   = &_scan_eigen_solvers[i];
+            A_ptr[i] = &A[i];
+            B_ptr[i] = &B[i];
+        }
+        
+        {
+            MAST_LOG_SCOPE("eigensolve()", "UGFlutterSolver");
+            MAST::LAPACK_ZGGEV_Base::compute_batch(ges, A_ptr, B_ptr);
+        }
+        
+        for (unsigned int i=0; i<n; i++)
+            sols[i] = _build_solution(k_vals[i], _scan_eigen_solvers[i]);
+    }
+    else
+        for (unsigned int i=0; i<n; i++)
+            sols[i] = _eigensolve(k_vals[i], A[i], B[i]);
+    
+    // the roots are sorted in the order of the scan
+    std::map<Real, MAST::FlutterSolutionBase*>::const_iterator it;
+    
+    for (unsigned int i=0; i<n; i++) {
+        
+        libmesh_assert(i == 0 || k_vals[i] < k_vals[i-1]);
+        
+        it = _flutter_solutions.upper_bound(k_vals[i]);
+        if (it != _flutter_solutions.end())
+            sols[i]->sort(*it->second);
+        
+        if (_output)
+            sols[i]->print(*_output);
+        
+        bool if_success =
+        _flutter_solutions.insert(std::pair<Real, MAST::FlutterSolutionBase*>
+                                  (k_vals[i], sols[i])).second;
+        
+        libmesh_assert(if_success);
+    }
+}
+
+
+
+void
+MAST::UGFlutterSolver::
+_add_pipelined_solutions(const std::vector<Real>& k_vals) {
+    
+    MAST_LOG_SCOPE("pipelined_scan()", "UGFlutterSolver");
+    
+    const unsigned int n = (unsigned int)k_vals.size();
+    
+    if (!n)
+        return;
+    
+    // the matrices and eigensolvers of two frequencies are used
+    // alternately: one by the helper thread and one by the assembly
+    ComplexMatrixX         A[2], B[2];
+    MAST::LAPACK_ZGGEV     ges[2];
+    std::thread            eig_thread;
+    
+    std::map<Real, MAST::FlutterSolutionBase*>::const_iterator it;
+    
+    for (unsigned int i=0; i<=n; i++) {
+        
+        // the matrices of this frequency are assembled while the
+        // eigensolution of the previous frequency proceeds
+        if (i < n)
+            _initialize_matrices(k_vals[i], A[i%2], B[i%2]);
+        
+        if (i) {
+            
+            {
+                MAST_LOG_SCOPE("wait_eigensolve()", "UGFlutterSolver");
+                eig_thread.join();
+            }
+            
+            // the solution is sorted with respect to the solution at the
+            // next higher reduced frequency, which is available at this
+            // point
+            const unsigned int j = i-1;
+            
+            MAST::UGFlutterSolution* sol = _build_solution(k_vals[j], ges[j%2]);
+            
+            libmesh_assert(j == 0 || k_vals[j] < k_vals[j-1]);
+            
+            it = _flutter_solutions.upper_bound(k_vals[j]);
+            if (it != _flutter_solutions.end())
+                sol->sort(*it->second);
+            
+            if (_output)
+                sol->print(*_output);
+            
+            bool if_success =
+            _flutter_solutions.insert(std::pair<Real, MAST::FlutterSolutionBase*>
+                                      (k_vals[j], sol)).second;
+            
+            libmesh_assert(if_success);
+        }
+        
+        if (i == n)
+            break;
+        
+        // the eigensolution does not use the communicator or the
+        // performance log, and is performed on the helper thread
+        {
+            MAST::LAPACK_ZGGEV&   g  = ges[i%2];
+            const ComplexMatrixX& Ai = A[i%2];
+            const ComplexMatrixX& Bi = B[i%2];
+            
+            eig_thread = std::thread([&g, &Ai, &Bi]() { g.compute(Ai, Bi); });
+        }
+        
+        // while the last eigensolution proceeds, the matrices of the
+        // first iterate of the search for the lowest velocity crossover
+        // identified from the completed solutions are assembled
+        if (i == n-1 && _prefetch_root && _flutter_solutions.size() > 1) {
+            
+            _identify_crossover_points();
+            
+            std::multimap<Real, MAST::FlutterRootCrossoverBase*>::iterator
+            cross_it  = _flutter_crossovers.begin(),
+            cross_end = _flutter_crossovers.end();
+            
+            if (cross_it != cross_end && !cross_it->second->root) {
+                
+                const MAST::FlutterRootCrossoverBase& cross = *cross_it->second;
+                
+                // this is the same interpolation as in _bisection_search()
+                const Real
+                lower_kr = cross.crossover_solutions.first->get_root(cross.root_num).kr,
+                lower_g  = cross.crossover_solutions.first->get_root(cross.root_num).g,
+                upper_kr = cross.crossover_solutions.second->get_root(cross.root_num).kr,
+                upper_g  = cross.crossover_solutions.second->get_root(cross.root_num).g,
+                new_kr   = lower_kr +
+                (upper_kr-lower_kr)/(upper_g-lower_g)*(0.-lower_g);
+                
+                if (!_prefetched_matrices.count(new_kr)) {
+                    
+                    MAST_LOG_SCOPE("prefetch_matrices()", "UGFlutterSolver");
+                    
+                    std::pair<ComplexMatrixX, ComplexMatrixX>&
+                    mats = _prefetched_matrices[new_kr];
+                    _initialize_matrices(new_kr, mats.first, mats.second);
+                }
+            }
+            
+            // the crossovers are identified again by the caller with the
+            // complete set of solutions
+            for ( ; cross_it != cross_end; cross_it++)
+                delete cross_it->second;
+            _flutter_crossovers.clear();
+        }
+    }
+}
+
+
+
+
+namespace MAST {
+    
+    /*!
+     *   identifies the binary flutter state files, followed by the
+     *   format version
+     */
+    const char         flutter_binary_file_id[8] = "MASTFLT";
+    const unsigned int flutter_binary_file_version = 1;
+    
+    
+    /*!
+     *   @returns \p true if the basis identities \p id0 and \p id1 are
+     *   equal within the relative tolerance \p tol. The identities are
+     *   computed with parallel reductions, which may differ in the last
+     *   bits between runs.
+     */
+    bool
+    same_basis_identity(const std::vector<Real>& id0,
+                        const std::vector<Real>& id1,
+                        const Real tol) {
+        
+        if (id0.size() != id1.size())
+            return false;
+        
+        for (unsigned int i=0; i<id0.size(); i++)
+            if (std::fabs(id0[i] - id1[i]) >
+                tol * std::max(std::max(std::fabs(id0[i]), std::fabs(id1[i])), 1.))
+                return false;
+        
+        return true;
+    }
+}
+
+
+
+void
+MAST::UGFlutterSolver::_basis_identity(std::vector<Real>& id) const {
+    
+    libmesh_assert(_basis_vectors);
+    
+    const unsigned int n = (unsigned int)_basis_vectors->size();
+    id.resize(2*n);
+    
+    for (unsigned int i=0; i<n; i++) {
+        id[2*i]   = (*_basis_vectors)[i]->l2_norm();
+        id[2*i+1] = (*_basis_vectors)[i]->sum();
+    }
+}
+
+
+
+void
+MAST::UGFlutterSolver::write_binary_state(const std::string& nm) {
+    
+    libmesh_assert(_basis_vectors);
+    libmesh_assert(_basis_vectors->size());
+    
+    // this requires communication, and is done on all processors
+    std::vector<Real> id;
+    _basis_identity(id);
+    
+    const libMesh::Parallel::Communicator&
+    comm = (*_basis_vectors)[0]->comm();
+    
+    if (comm.rank() == 0) {
+        
+        std::ofstream out;
+        out.open(nm.c_str(), std::ofstream::out | std::ofstream::binary);
+        
+        if (!out.good())
+            libmesh_error_msg("Error: could not open " << nm << " for writing.");
+        
+        const unsigned int
+        n_basis = (unsigned int)_basis_vectors->size(),
+        n_sols  = (unsigned int)_flutter_solutions.size(),
+        n_cross = (unsigned int)_flutter_crossovers.size();
+        
+        out.write(MAST::flutter_binary_file_id, sizeof(MAST::flutter_binary_file_id));
+        out.write(reinterpret_cast<const char*>(&MAST::flutter_binary_file_version),
+                  sizeof(unsigned int));
+        
+        // basis identity
+        out.write(reinterpret_cast<const char*>(&n_basis), sizeof(unsigned int));
+        out.write(reinterpret_cast<const char*>(&id[0]), sizeof(Real)*2*n_basis);
+        
+        // reduced order matrices of the solutions
+        out.write(reinterpret_cast<const char*>(&n_sols), sizeof(unsigned int));
+        
+        std::map<Real, MAST::FlutterSolutionBase*>::const_iterator
+        sol_it  = _flutter_solutions.begin(),
+        sol_end = _flutter_solutions.end();
+        
+        for ( ; sol_it != sol_end; sol_it++) {
+            
+            const MAST::UGFlutterSolution& sol =
+            dynamic_cast<const MAST::UGFlutterSolution&>(*sol_it->second);
+            
+            const unsigned int n = (unsigned int)sol.A().rows();
+            
+            out.write(reinterpret_cast<const char*>(&sol_it->first), sizeof(Real));
+            out.write(reinterpret_cast<const char*>(&n), sizeof(unsigned int));
+            out.write(reinterpret_cast<const char*>(sol.A().data()),
+                      sizeof(Complex)*n*n);
+            out.write(reinterpret_cast<const char*>(sol.B().data()),
+                      sizeof(Complex)*n*n);
+        }
+        
+        // bracketing reduced frequencies of the crossovers
+        out.write(reinterpret_cast<const char*>(&n_cross), sizeof(unsigned int));
+        
+        std::multimap<Real, MAST::FlutterRootCrossoverBase*>::const_iterator
+        cross_it  = _flutter_crossovers.begin(),
+        cross_end = _flutter_crossovers.end();
+        
+        for ( ; cross_it != cross_end; cross_it++) {
+            
+            const MAST::FlutterRootCrossoverBase& cross = *cross_it->second;
+            
+            const Real
+            kr_first  = cross.crossover_solutions.first->ref_val(),
+            kr_second = cross.crossover_solutions.second->ref_val();
+            
+            out.write(reinterpret_cast<const char*>(&kr_first), sizeof(Real));
+            out.write(reinterpret_cast<const char*>(&kr_second), sizeof(Real));
+            out.write(reinterpret_cast<const char*>(&cross.root_num),
+                      sizeof(unsigned int));
+        }
+        
+        if (!out.good())
+            libmesh_error_msg("Error: writing binary flutter state to " << nm << " failed.");
+    }
+    
+    comm.barrier();
+}
+
+
+
+bool
+MAST::UGFlutterSolver::read_binary_state(const std::string& nm,
+                                         const Real tol) {
+    
+    libmesh_assert(_basis_vectors);
+    
+    this->clear_solutions();
+    
+    std::ifstream input;
+    input.open(nm.c_str(), std::ifstream::in | std::ifstream::binary);
+    
+    if (!input.good())
+        libmesh_error_msg("Error: could not open " << nm << " for reading.");
+    
+    char         id[sizeof(MAST::flutter_binary_file_id)];
+    unsigned int
+    version = 0,
+    n_basis = 0,
+    n_sols  = 0,
+    n_cross = 0,
+    n       = 0,
+    root_num = 0;
+    
+    input.read(id, sizeof(id));
+    input.read(reinterpret_cast<char*>(&version), sizeof(unsigned int));
+    
+    if (!input.good() ||
+        std::memcmp(id, MAST::flutter_binary_file_id, sizeof(id)) != 0 ||
+        version != MAST::flutter_binary_file_version)
+        libmesh_error_msg("Error: " << nm << " is not a binary flutter state file.");
+    
+    // basis identity
+    input.read(reinterpret_cast<char*>(&n_basis), sizeof(unsigned int));
+    std::vector<Real> stored_id(2*n_basis, 0.), current_id;
+    if (n_basis)
+        input.read(reinterpret_cast<char*>(&stored_id[0]), sizeof(Real)*2*n_basis);
+    
+    // reduced order matrices of the solutions
+    input.read(reinterpret_cast<char*>(&n_sols), sizeof(unsigned int));
+    
+    std::vector<Real>           k_vals(n_sols, 0.);
+    std::vector<ComplexMatrixX> A(n_sols), B(n_sols);
+    
+    for (unsigned int i=0; i<n_sols; i++) {
+        
+        input.read(reinterpret_cast<char*>(&k_vals[i]), sizeof(Real));
+        input.read(reinterpret_cast<char*>(&n), sizeof(unsigned int));
+        
+        A[i].setZero(n, n);
+        B[i].setZero(n, n);
+        input.read(reinterpret_cast<char*>(A[i].data()), sizeof(Complex)*n*n);
+        input.read(reinterpret_cast<char*>(B[i].data()), sizeof(Complex)*n*n);
+    }
+    
+    // bracketing reduced frequencies of the crossovers
+    input.read(reinterpret_cast<char*>(&n_cross), sizeof(unsigned int));
+    
+    std::set<Real> cross_kr;
+    Real kr_first = 0., kr_second = 0.;
+    
+    for (unsigned int i=0; i<n_cross; i++) {
+        
+        input.read(reinterpret_cast<char*>(&kr_first), sizeof(Real));
+        input.read(reinterpret_cast<char*>(&kr_second), sizeof(Real));
+        input.read(reinterpret_cast<char*>(&root_num), sizeof(unsigned int));
+        
+        cross_kr.insert(kr_first);
+        cross_kr.insert(kr_second);
+    }
+    
+    if (!input.good())
+        libmesh_error_msg("Error: reading binary flutter state file " << nm << " failed.");
+    
+    // the stored matrices are used only if the basis is unchanged
+    _basis_identity(current_id);
+    
+    if (!MAST::same_basis_identity(current_id, stored_id, tol)) {
+        
+        // atleast two solutions are needed to identify a crossover
+        if (_warm_start && cross_kr.size() > 1)
+            _warm_start_kr.assign(cross_kr.begin(), cross_kr.end());
+        return false;
+    }
+    
+    if (!n_sols)
+        return true;
+    
+    // the solutions are sorted in the order of decreasing kr, similar
+    // to the scan
+    std::reverse(k_vals.begin(), k_vals.end());
+    std::reverse(A.begin(), A.end());
+    std::reverse(B.begin(), B.end());
+    
+    _add_solutions(k_vals, A, B);
+    
+    if (n_sols > 1)
+        _identify_crossover_points();
+    
+    return true;
+}
+
+
+
 
 void
 MAST::UGFlutterSolver::print_sorted_roots()
@@ -482,6 +997,149 @@ _bisection_search(const std::pair<MAST::FlutterSolutionBase*,
 
 
 
+void
+MAST::UGFlutterSolver::set_root_tracking(bool f, Real mac_tol) {
+    
+    libmesh_assert_greater(mac_tol, 0.);
+    libmesh_assert_less_equal(mac_tol, 1.);
+    
+    _root_tracking    = f;
+    _tracking_mac_tol = mac_tol;
+}
+
+
+
+std::pair<bool, MAST::FlutterSolutionBase*>
+MAST::UGFlutterSolver::
+_tracking_search(const std::pair<MAST::FlutterSolutionBase*,
+                 MAST::FlutterSolutionBase*>& ref_sol_range,
+                 const unsigned int root_num,
+                 const Real g_tol,
+                 const unsigned int max_iters) {
+    
+    // assumes that the upper k_val has +ve g val and lower k_val has -ve
+    // k_val
+    const MAST::FlutterRootBase
+    &lower_root = ref_sol_range.first->get_root(root_num),
+    &upper_root = ref_sol_range.second->get_root(root_num);
+    
+    Real
+    lower_kr = lower_root.kr,
+    lower_g  = lower_root.g,
+    upper_kr = upper_root.kr,
+    upper_g  = upper_root.g,
+    new_kr   = 0.,
+    new_g    = 0.;
+    
+    // eigenpairs of the tracked root at the ends of the bracket
+    Complex
+    lower_lambda = lower_root.root,
+    upper_lambda = upper_root.root,
+    lambda       = 0.;
+    
+    ComplexVectorX
+    lower_x = lower_root.eig_vec_right,
+    lower_y = lower_root.eig_vec_left,
+    upper_x = upper_root.eig_vec_right,
+    upper_y = upper_root.eig_vec_left,
+    x, y;
+    
+    ComplexMatrixX A, B;
+    unsigned int n_iters = 0;
+    bool         converged = false;
+    
+    while (n_iters < max_iters) {
+        
+        new_kr    = lower_kr +
+        (upper_kr-lower_kr)/(upper_g-lower_g)*(0.-lower_g); // linear interpolation
+        
+        _initialize_matrices(new_kr, A, B);
+        
+        // predictor: eigenvalue interpolated between the bracket values,
+        // and the eigenvectors of the nearest end of the bracket
+        const Real
+        t         = (new_kr-lower_kr)/(upper_kr-lower_kr);
+        lambda    = lower_lambda + t * (upper_lambda-lower_lambda);
+        x         = (t < 0.5)? lower_x : upper_x;
+        y         = (t < 0.5)? lower_y : upper_y;
+        const ComplexVectorX x0 = x;
+        
+        // corrector
+        bool
+        tracked   = (MAST::FlutterSolverBase::_refine_eigenpair(A, B, lambda, x, y,
+                                                                 1.e-10, 10) &&
+                     MAST::FlutterSolverBase::_modal_assurance_criterion(x, x0) >=
+                     _tracking_mac_tol &&
+                     std::real(lambda) > 0.);
+        
+        if (!tracked) {
+            
+            // the complete spectrum is used to identify the root
+            std::auto_ptr<MAST::UGFlutterSolution>
+            sol(_eigensolve(new_kr, A, B));
+            sol->sort(*ref_sol_range.first);
+            
+            const MAST::FlutterRootBase& root = sol->get_root(root_num);
+            lambda = root.root;
+            x      = root.eig_vec_right;
+            y      = root.eig_vec_left;
+        }
+        
+        // the UG eigenvalue is (1 + i g)/V^2
+        new_g = (std::real(lambda) > 0.)? std::imag(lambda)/std::real(lambda) : 0.;
+        
+        libMesh::out
+        << "Root tracking:  kr = " << new_kr
+        << "  g = " << new_g
+        << (tracked? "" : "  (complete spectrum)") << std::endl;
+        
+        n_iters++;
+        
+        if (fabs(new_g) <= g_tol) {
+            
+            converged = true;
+            break;
+        }
+        
+        if (new_g < 0.) {
+            
+            lower_kr     = new_kr;
+            lower_g      = new_g;
+            lower_lambda = lambda;
+            lower_x      = x;
+            lower_y      = y;
+        }
+        else {
+            
+            upper_kr     = new_kr;
+            upper_g      = new_g;
+            upper_lambda = lambda;
+            upper_x      = x;
+            upper_y      = y;
+        }
+    }
+    
+    // the complete solution at the final reduced frequency is stored with
+    // the other flutter solutions
+    MAST::UGFlutterSolution* new_sol = _eigensolve(new_kr, A, B);
+    new_sol->sort(*ref_sol_range.first);
+    
+    if (_output)
+        new_sol->print(*_output);
+    
+    bool if_success =
+    _flutter_solutions.insert(std::pair<Real, MAST::FlutterSolutionBase*>
+                              (new_kr, new_sol)).second;
+    
+    libmesh_assert(if_success);
+    
+    return std::pair<bool, MAST::FlutterSolutionBase*>
+    (converged && fabs(new_sol->get_root(root_num).g) <= g_tol, new_sol);
+}
+
+
+
+
 std::auto_ptr<MAST::FlutterSolutionBase>
 MAST::UGFlutterSolver::_analyze(const Real kr_ref,
                                 const MAST::FlutterSolutionBase* prev_sol) {
@@ -495,15 +1153,21 @@ MAST::UGFlutterSolver::_analyze(const Real kr_ref,
     A,
     B;
     
-    // initialize the matrices for the structure.
-    _initialize_matrices(kr_ref, A, B);
+    // initialize the matrices for the structure, unless they were
+    // assembled speculatively by the pipelined scan
+    std::map<Real, std::pair<ComplexMatrixX, ComplexMatrixX> >::iterator
+    p_it = _prefetched_matrices.find(kr_ref);
     
-    MAST::LAPACK_ZGGEV ges;
-    ges.compute(A, B);
-    ges.scale_eigenvectors_to_identity_innerproduct();
+    if (p_it != _prefetched_matrices.end()) {
+        
+        A.swap(p_it->second.first);
+        B.swap(p_it->second.second);
+        _prefetched_matrices.erase(p_it);
+    }
+    else
+        _initialize_matrices(kr_ref, A, B);
     
-    MAST::UGFlutterSolution* root = new MAST::UGFlutterSolution;
-    root->init(*this, kr_ref, (*_bref_param)(), ges);
+    MAST::UGFlutterSolution* root = _eigensolve(kr_ref, A, B);
     if (prev_sol)
         root->sort(*prev_sol);
     
@@ -518,11 +1182,42 @@ MAST::UGFlutterSolver::_analyze(const Real kr_ref,
 
 
 
+MAST::UGFlutterSolution*
+MAST::UGFlutterSolver::_eigensolve(const Real kr_ref,
+                                   const ComplexMatrixX& A,
+                                   const ComplexMatrixX& B) {
+    
+    {
+        MAST_LOG_SCOPE("eigensolve()", "UGFlutterSolver");
+        _eigen_solver.compute(A, B);
+    }
+    
+    return _build_solution(kr_ref, _eigen_solver);
+}
+
+
+
+MAST::UGFlutterSolution*
+MAST::UGFlutterSolver::_build_solution(const Real kr_ref,
+                                       MAST::LAPACK_ZGGEV& ges) {
+    
+    ges.scale_eigenvectors_to_identity_innerproduct();
+    
+    MAST::UGFlutterSolution* root = new MAST::UGFlutterSolution;
+    root->init(*this, kr_ref, (*_bref_param)(), ges);
+    
+    return root;
+}
+
+
+
 void
 MAST::UGFlutterSolver::_initialize_matrices(Real kr,
                                             ComplexMatrixX &A,
                                             ComplexMatrixX &B) {
     
+    MAST_LOG_SCOPE("initialize_matrices()", "UGFlutterSolver");
+    
     // the UG method equations are
     //
     // ((kr/b)^2 M + rho/2 A(kr))q = lambda K q
@@ -549,7 +1244,10 @@ MAST::UGFlutterSolver::_initialize_matrices(Real kr,
     // set the velocity value in the parameter that was provided
     (*_kr_param) = kr;
     
-    _assembly->assemble_reduced_order_quantity(*_basis_vectors, qty_map);
+    // the structural quantities are reused between evaluations, unless
+    // they depend on the reduced frequency
+    _assemble_reduced_order_quantity(qty_map,
+                                     std::vector<MAST::Parameter*>(1, _kr_param));
     
     dynamic_cast<MAST::FSIGeneralizedAeroForceAssembly*>(_assembly)->
     assemble_generalized_aerodynamic_force_matrix(*_basis_vectors, a);
@@ -564,6 +1262,90 @@ MAST::UGFlutterSolver::_initialize_matrices(Real kr,
 
 
 
+void
+MAST::UGFlutterSolver::
+calculate_sensitivity(const MAST::FlutterRootBase& root,
+                      const libMesh::ParameterVector& params,
+                      const std::vector<libMesh::NumericVector<Real>*>& dXdp,
+                      std::vector<Real>& V_sens) {
+    
+    libmesh_assert(!dXdp.size() || dXdp.size() == params.size());
+    
+    libMesh::out
+    << " ====================================================" << std::endl
+    << "UG Sensitivity Solution" << std::endl
+    << "   k_red    = " << std::setw(10) << root.kr << std::endl
+    << "   V_ref    = " << std::setw(10) << root.V << std::endl
+    << "   n_params = " << std::setw(10) << params.size() << std::endl;
+    
+    const unsigned int n_params = params.size();
+    
+    Complex
+    eig              = root.root,
+    deig_dp          = 0.,
+    deig_dkr         = 0.,
+    den              = 0.;
+    
+    Real
+    dkr_dp           = 0.,
+    dg_dp            = 0.,
+    dg_dkr           = 0.;
+    
+    ComplexMatrixX
+    mat_A,
+    mat_B,
+    mat_A_sens,
+    mat_B_sens;
+    
+    std::vector<ComplexMatrixX>
+    mat_A_param_sens,
+    mat_B_param_sens;
+    
+    // initialize the baseline matrices
+    _initialize_matrices(root.kr, mat_A, mat_B);
+    
+    // the sensitivity of the matrices for all parameters
+    _initialize_matrix_sensitivity_for_params(params,
+                                              dXdp,
+                                              root.kr,
+                                              mat_A_param_sens,
+                                              mat_B_param_sens);
+    
+    // the sensitivity of eigenvalue wrt kr is the same for all parameters
+    _initialize_matrix_sensitivity_for_kr(root.kr,
+                                          mat_A_sens,
+                                          mat_B_sens);
+    
+    den      = root.eig_vec_left.dot(mat_B*root.eig_vec_right);
+    deig_dkr = root.eig_vec_left.dot((mat_A_sens - eig*mat_B_sens)*root.eig_vec_right)/den;
+    dg_dkr   =
+    deig_dkr.imag()/eig.real() - eig.imag()/pow(eig.real(),2) * deig_dkr.real();
+    
+    // see the single parameter calculate_sensitivity() for the
+    // derivation of the expressions below
+    V_sens.resize(n_params);
+    
+    for (unsigned int i=0; i<n_params; i++) {
+        
+        deig_dp = root.eig_vec_left.dot((mat_A_param_sens[i] -
+                                         eig*mat_B_param_sens[i])*root.eig_vec_right)/den;
+        
+        dg_dp   =
+        deig_dp.imag()/eig.real()  - eig.imag()/pow(eig.real(),2) * deig_dp.real();
+        
+        dkr_dp  = -dg_dp / dg_dkr;
+        
+        V_sens[i] = -.5*(deig_dp + deig_dkr * dkr_dp).real()/pow(eig.real(), 1.5);
+    }
+    
+    libMesh::out
+    << "Finished Flutter Sensitivity Solution" << std::endl
+    << " ====================================================" << std::endl;
+}
+
+
+
+
 void
 MAST::UGFlutterSolver::
 _initialize_matrix_sensitivity_for_param(const libMesh::ParameterVector& params,
@@ -619,6 +1401,67 @@ _initialize_matrix_sensitivity_for_param(const libMesh::ParameterVector& params,
 
 
 
+void
+MAST::UGFlutterSolver::
+_initialize_matrix_sensitivity_for_params(const libMesh::ParameterVector& params,
+                                          const std::vector<libMesh::NumericVector<Real>*>& dXdp,
+                                          Real kr,
+                                          std::vector<ComplexMatrixX>& A,
+                                          std::vector<ComplexMatrixX>& B) {
+    
+    // the UG method equations are
+    //
+    // ((kr/b)^2 M + rho/2 A(kr))q = lambda K q
+    // where M and K are the structural reduced-order mass and stiffness
+    // matrices, and A(kr) is the generalized aerodynamic force matrix.
+    //
+    
+    const unsigned int
+    n        = (unsigned int)_basis_vectors->size(),
+    n_params = params.size();
+    
+    std::vector<RealMatrixX>
+    m(n_params),
+    k(n_params);
+    
+    // now prepare a map of the quantities for each parameter and ask the
+    // assembly object to calculate the quantities of interest.
+    std::vector<std::map<MAST::StructuralQuantityType, RealMatrixX*> >
+    qty_maps(n_params);
+    
+    for (unsigned int i=0; i<n_params; i++) {
+        qty_maps[i][MAST::MASS]       = &m[i];
+        qty_maps[i][MAST::STIFFNESS]  = &k[i];
+    }
+    
+    std::vector<const libMesh::NumericVector<Real>*>
+    sol_sens(dXdp.begin(), dXdp.end());
+    
+    // set the velocity value in the parameter that was provided
+    (*_kr_param) = kr;
+    
+    _assembly->assemble_reduced_order_quantity_sensitivity(params,
+                                                           *_basis_vectors,
+                                                           sol_sens,
+                                                           qty_maps);
+    
+    // currently, sensitivity of generalized aero matrix is available only
+    // for freq (ie non-structural parameters).
+    A.resize(n_params);
+    B.resize(n_params);
+    
+    for (unsigned int i=0; i<n_params; i++) {
+        
+        libmesh_assert_equal_to(m[i].rows(), n);
+        
+        A[i] = pow(kr/(*_bref_param)(),2) * m[i].cast<Complex>();
+        B[i] = k[i].cast<Complex>();
+    }
+}
+
+
+
+
 void
 MAST::UGFlutterSolver::
 _initialize_matrix_sensitivity_for_kr(Real kr,
@@ -649,8 +1492,8 @@ _initialize_matrix_sensitivity_for_kr(Real kr,
     // set the velocity value in the parameter that was provided
     (*_kr_param) = kr;
     
-    _assembly->assemble_reduced_order_quantity(*_basis_vectors,
-                                               qty_map);
+    _assemble_reduced_order_quantity(qty_map,
+                                     std::vector<MAST::Parameter*>(1, _kr_param));
     
     dynamic_cast<MAST::FSIGeneralizedAeroForceAssembly*>(_assembly)->
     assemble_generalized_aerodynamic_force_matrix(*_basis_vectors, a, _kr_param);
@@ -967,3 +1810,12 @@ calculate_sensitivity(MAST::FlutterRootBase& root,
 
 
 
+void
+MAST::UGFlutterSolver::report_memory(MAST::MemoryReport& r,
+                                     const std::string& nm) const {
+    
+    MAST::FlutterSolverBase::report_memory(r, nm);
+    
+    r.add(nm, "flutter solutions", _solutions_memory(_flutter_solutions));
+}
+
@@ -22,14 +22,20 @@
 
 // C++ includes
 #include <memory>
+#include <vector>
+#include <string>
 
 
 // MAST includes
 #include "aeroelasticity/flutter_solver_base.h"
+#include "numerics/lapack_zggev_interface.h"
 
 
 namespace MAST {
     
+    // Forward declerations
+    class UGFlutterSolution;
+    
     
     /*!
      *   This implements a solver for a single parameter instability
@@ -131,12 +137,38 @@ namespace MAST {
                               libMesh::NumericVector<Real>* dXdkr = nullptr);
         
         
+        /*!
+         *   Calculates the sensitivity of the flutter speed of \p root with
+         *   respect to all parameters in \p params, and returns it in
+         *   \p V_sens. The sensitivity of the reduced order matrices for
+         *   all parameters is assembled with a single pass over the
+         *   elements, and the sensitivity of the eigenvalue with respect
+         *   to kr is computed once for all parameters. \p dXdp[i] is the
+         *   sensitivity of the base solution for \p params[i], which is
+         *   assumed to be zero if \p dXdp is empty or the entry is
+         *   \p nullptr. The sensitivity data of \p root is not modified.
+         */
+        void
+        calculate_sensitivity(const MAST::FlutterRootBase& root,
+                              const libMesh::ParameterVector& params,
+                              const std::vector<libMesh::NumericVector<Real>*>& dXdp,
+                              std::vector<Real>& V_sens);
+        
+        
         /*!
          *   Prints the sorted roots to the \par output
          */
         virtual void print_sorted_roots();
         
         
+        /*!
+         *   adds the bytes of the flutter solutions to those reported by
+         *   the parent class
+         */
+        virtual void report_memory(MAST::MemoryReport& r,
+                                   const std::string& nm) const;
+        
+        
         /*!
          *   Prints the crossover points output. If no pointer to output is given
          *   then the output defined by set_output_file() is used.
@@ -152,9 +184,161 @@ namespace MAST {
         virtual void scan_for_roots();
         
         
+        /*!
+         *   tells scan_for_roots() to first assemble the matrices for all
+         *   reduced frequencies, and to then perform the dense
+         *   eigensolutions concurrently over the libMesh threads (as
+         *   specified by \p --n_threads). The roots are sorted after all
+         *   eigensolutions are complete. The assembly is not threaded since
+         *   the aerodynamic matrices require solutions on the communicator
+         *   of the system. This is \p false by default.
+         */
+        void set_threaded_scan(bool f) {
+            _threaded_scan = f;
+        }
+        
+        
+        /*!
+         *   tells scan_for_roots() to perform the dense eigensolution of
+         *   each reduced frequency on a helper thread, while the matrices
+         *   of the next reduced frequency are assembled on the
+         *   communicator of the system. If \p prefetch_root is \p true,
+         *   the first iterate of the crossover search is predicted from
+         *   the solutions completed before the last eigensolution of the
+         *   scan, and its matrices are assembled while that eigensolution
+         *   proceeds. The predicted iterate is the linear interpolation of
+         *   the damping of the lowest velocity crossover, as used by the
+         *   bisection search, and the matrices are used by _analyze() if
+         *   the search requests the same reduced frequency. This is not
+         *   used with the threaded scan, and is \p false by default.
+         */
+        void set_pipelined_scan(bool f, bool prefetch_root = true) {
+            _pipelined_scan = f;
+            _prefetch_root  = prefetch_root;
+        }
+        
+        
+        /*!
+         *   tells find_next_root() and find_critical_root() to follow the
+         *   eigenpair of the crossover root as the reduced frequency is
+         *   updated, instead of computing the complete spectrum at each
+         *   iteration. The eigenpair of the nearest bracketing solution is
+         *   refined by Rayleigh quotient iteration, and is accepted if its
+         *   modal assurance criterion with respect to the starting
+         *   eigenvector is at least \p mac_tol. Otherwise, the complete
+         *   spectrum is computed for that iteration. The complete spectrum
+         *   is always computed for the converged root, so that it is
+         *   stored as a sorted flutter solution. This is \p false by
+         *   default.
+         */
+        void set_root_tracking(bool f, Real mac_tol = 0.9);
+        
+        
+        /*!
+         *   writes the state of the solver to the binary file \p nm: the
+         *   identity of the basis (norm and sum of each basis vector), the
+         *   reduced order matrices of all analyzed solutions, including
+         *   those from the root searches, and the bracketing reduced
+         *   frequencies of the crossover points. This must be called on
+         *   all processors of the basis communicator, and the file is
+         *   written by processor 0.
+         */
+        void write_binary_state(const std::string& nm);
+        
+        
+        /*!
+         *   reads the state written by write_binary_state() from \p nm
+         *   after clearing the solutions of this solver. If the basis
+         *   identity matches that of the current basis within the relative
+         *   tolerance \p tol, the solutions are recomputed from the stored
+         *   matrices without assembly, the crossover points are
+         *   identified, and the method @returns \p true. A subsequent call
+         *   to scan_for_roots() does nothing, since the stored solutions
+         *   replace the scan.
+         *
+         *   Otherwise, for example after a design update, the method
+         *   @returns \p false. If the warm start is turned on with
+         *   set_warm_start(), the bracketing reduced frequencies of the
+         *   stored crossover points are retained and are analyzed by the
+         *   next call to scan_for_roots() in addition to its uniform
+         *   reduced frequency divisions.
+         */
+        bool read_binary_state(const std::string& nm,
+                               const Real tol = 1.e-8);
+        
+        
+        /*!
+         *   tells read_binary_state() to retain the bracketing reduced
+         *   frequencies of the stored crossovers when the basis has
+         *   changed, which are then added to the next scan. This is
+         *   \p false by default.
+         */
+        void set_warm_start(bool f) {
+            _warm_start = f;
+        }
+        
+        
     protected:
         
         
+        /*!
+         *   performs the eigensolution of the matrices \p A and \p B
+         *   assembled at \p kr_ref, and @returns the unsorted solution.
+         */
+        MAST::UGFlutterSolution*
+        _eigensolve(const Real kr_ref,
+                    const ComplexMatrixX& A,
+                    const ComplexMatrixX& B);
+        
+        
+        /*!
+         *   @returns the unsorted solution at \p kr_ref from the
+         *   eigensolution in \p ges
+         */
+        MAST::UGFlutterSolution*
+        _build_solution(const Real kr_ref,
+                        MAST::LAPACK_ZGGEV& ges);
+        
+        
+        /*!
+         *   analyzes the reduced frequencies in \p k_vals, sorted in
+         *   decreasing order, that do not yet have a solution, and
+         *   identifies the crossover points from all solutions.
+         */
+        void _scan_reduced_frequencies(const std::vector<Real>& k_vals);
+        
+        
+        /*!
+         *   performs the eigensolutions of the matrices \p A and \p B
+         *   for the reduced frequencies in \p k_vals, which must be in
+         *   decreasing order, and adds the solutions to this solver. Each
+         *   solution is sorted with respect to the stored solution at the
+         *   next higher reduced frequency. The eigensolutions are performed
+         *   concurrently if the threaded scan is turned on.
+         */
+        void _add_solutions(const std::vector<Real>& k_vals,
+                            const std::vector<ComplexMatrixX>& A,
+                            const std::vector<ComplexMatrixX>& B);
+        
+        
+        /*!
+         *   assembles the matrices and performs the eigensolutions for the
+         *   reduced frequencies in \p k_vals, which must be in decreasing
+         *   order, with the eigensolution of each frequency overlapping the
+         *   assembly for the next, and adds the solutions to this solver.
+         *   The speculative matrices of the predicted crossover iterate are
+         *   stored in \p _prefetched_matrices.
+         */
+        void _add_pipelined_solutions(const std::vector<Real>& k_vals);
+        
+        
+        /*!
+         *   computes the l2-norm and sum of each basis vector in \p id,
+         *   which are used to identify the basis in the stored state
+         */
+        void _basis_identity(std::vector<Real>& id) const;
+        
+        
         /*!
          *   performs an eigensolution at the specified reference value, and
          *   sort the roots based on the provided solution pointer. If the
@@ -177,6 +361,20 @@ namespace MAST {
                           const unsigned int max_iters);
         
         
+        /*!
+         *    root search that follows the eigenpair of root \p root_num
+         *    between the bracketing solutions, as described in
+         *    set_root_tracking(). The arguments and return values are the
+         *    same as _bisection_search().
+         */
+        std::pair<bool, MAST::FlutterSolutionBase*>
+        _tracking_search(const std::pair<MAST::FlutterSolutionBase*,
+                         MAST::FlutterSolutionBase*>& ref_sol_range,
+                         const unsigned int root_num,
+                         const Real g_tol,
+                         const unsigned int max_iters);
+        
+        
         /*!
          *    Assembles the reduced order system structural and aerodynmaic
          *    matrices for specified reduced freq \par kr.
@@ -199,6 +397,20 @@ namespace MAST {
                                                  ComplexMatrixX& B);
 
         
+        /*!
+         *    Assembles the sensitivity of the reduced order matrices with
+         *    respect to all parameters in \p params, with \p A[i] and
+         *    \p B[i] for \p params[i]. See
+         *    StructuralFluidInteractionAssembly::assemble_reduced_order_quantity_sensitivity().
+         */
+        void
+        _initialize_matrix_sensitivity_for_params(const libMesh::ParameterVector& params,
+                                                  const std::vector<libMesh::NumericVector<Real>*>& dXdp,
+                                                  Real kr,
+                                                  std::vector<ComplexMatrixX>& A,
+                                                  std::vector<ComplexMatrixX>& B);
+        
+        
         /*!
          *    Assembles the sensitivity of matrices wrt kr
          */
@@ -258,12 +470,54 @@ namespace MAST {
          */
         bool _include_highest_kr_unstable;
         
+        /*!
+         *   flag to perform the eigensolutions of the scan concurrently
+         */
+        bool _threaded_scan;
+        
+        /*!
+         *   eigensolvers retained between solutions, so that their
+         *   workspace is allocated only once for a given number of modes.
+         *   \p _scan_eigen_solvers are used by the threaded scan.
+         */
+        MAST::LAPACK_ZGGEV               _eigen_solver;
+        std::vector<MAST::LAPACK_ZGGEV>  _scan_eigen_solvers;
+        
+        /*!
+         *   flags to overlap the eigensolutions of the scan with the
+         *   assembly, and to assemble the matrices of the predicted
+         *   crossover iterate
+         */
+        bool _pipelined_scan, _prefetch_root;
+        
+        /*!
+         *   matrices assembled speculatively by the pipelined scan,
+         *   which are used once by _analyze()
+         */
+        std::map<Real, std::pair<ComplexMatrixX, ComplexMatrixX> > _prefetched_matrices;
+        
+        /*!
+         *   flag to track the eigenpair of the root in the crossover
+         *   search, and the minimum modal assurance criterion for which
+         *   the tracked eigenpair is accepted
+         */
+        bool _root_tracking;
+        Real _tracking_mac_tol;
+        
         /*!
          *   the map of flutter crossover points versus average kr of the
          *   two bounding roots
          */
         std::multimap<Real, MAST::FlutterRootCrossoverBase*> _flutter_crossovers;
         
+        /*!
+         *   flag to warm start the scan from a prior state, and the
+         *   reduced frequencies read from the prior state that will be
+         *   analyzed by the next scan in addition to its divisions
+         */
+        bool              _warm_start;
+        std::vector<Real> _warm_start_kr;
+        
     };
 }
 
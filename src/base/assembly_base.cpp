@@ -17,6 +17,11 @@
  * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
  */
 
+// C++ includes
+#include <set>
+#include <algorithm>
+
+
 // MAST includes
 #include "base/assembly_base.h"
 #include "base/system_initialization.h"
@@ -24,18 +29,32 @@
 #include "base/elem_base.h"
 #include "base/physics_discipline_base.h"
 #include "base/nonlinear_system.h"
+#include "base/elementwise_design_field.h"
+#include "base/performance_log.h"
+#include "base/memory_report.h"
+#include "base/element_matrix_scatter.h"
+#include "mesh/element_cost_model.h"
 
 
 // libMesh includes
 #include "libmesh/numeric_vector.h"
 #include "libmesh/dof_map.h"
+#include "libmesh/boundary_info.h"
 #include "libmesh/parameter_vector.h"
+#include "libmesh/threads.h"
+#include "libmesh/petsc_matrix.h"
+#include "libmesh/petsc_vector.h"
 
 
 MAST::AssemblyBase::AssemblyBase():
 _discipline(nullptr),
 _system(nullptr),
-_sol_function(nullptr) {
+_sol_function(nullptr),
+_cost_model(nullptr),
+_reuse_elem_objects(false),
+_elem_geometry_cache(false),
+_batched_output_sensitivity(false),
+_threaded_outputs(false) {
     
 }
 
@@ -44,6 +63,11 @@ _sol_function(nullptr) {
 
 MAST::AssemblyBase::~AssemblyBase() {
     
+    if (_cost_model)
+        _cost_model->remove_assembly(*this);
+    
+    this->clear_elem_objects();
+    this->clear_localized_vectors();
 }
 
 
@@ -89,28 +113,547 @@ MAST::AssemblyBase::system() {
 
 
 
+void
+MAST::AssemblyBase::set_reuse_elem_objects(bool f) {
+    
+    _reuse_elem_objects = f;
+    
+    if (!f)
+        this->clear_elem_objects();
+}
+
+
+
+void
+MAST::AssemblyBase::set_elem_geometry_cache(bool f) {
+    
+    _elem_geometry_cache = f;
+    
+    std::map<const libMesh::Elem*, MAST::ElementBase*>::iterator
+    it  = _elem_objects.begin(),
+    end = _elem_objects.end();
+    
+    for ( ; it != end; it++)
+        it->second->set_geometry_cache(f);
+}
+
+
+
+void
+MAST::AssemblyBase::clear_elem_objects() {
+    
+    std::map<const libMesh::Elem*, MAST::ElementBase*>::iterator
+    it  = _elem_objects.begin(),
+    end = _elem_objects.end();
+    
+    for ( ; it != end; it++)
+        delete it->second;
+    
+    _elem_objects.clear();
+}
+
+
+
+void
+MAST::AssemblyBase::clear_mesh_dependent_data() {
+    
+    this->clear_elem_objects();
+    this->clear_localized_vectors();
+    this->clear_output_elems();
+    
+    // the element lists of the parameter dependency refer to the old mesh
+    if (_discipline)
+        _discipline->clear_parameter_dependency();
+    
+    if (_cost_model)
+        _cost_model->clear_measured_costs();
+}
+
+
+
+void
+MAST::AssemblyBase::set_element_cost_model(MAST::ElementCostModel* m) {
+    
+    if (_cost_model)
+        _cost_model->remove_assembly(*this);
+    
+    _cost_model = m;
+    
+    if (_cost_model)
+        _cost_model->add_assembly(*this);
+}
+
+
+
+void
+MAST::AssemblyBase::clear_output_elems() {
+    
+    _volume_output_elem_lists.clear();
+    _side_output_elem_lists.clear();
+}
+
+
+
+void
+MAST::AssemblyBase::clear_localized_vectors() {
+    
+    std::map<const libMesh::System*,
+    std::pair<std::vector<libMesh::dof_id_type>, libMesh::NumericVector<Real>*> >::iterator
+    it  = _localized_vectors.begin(),
+    end = _localized_vectors.end();
+    
+    for ( ; it != end; it++)
+        delete it->second.second;
+    
+    _localized_vectors.clear();
+}
+
+
+
+void
+MAST::AssemblyBase::report_memory(MAST::MemoryReport& r,
+                                  const std::string& nm) const {
+    
+    r.add(nm, "element objects",
+          _elem_objects.size() * sizeof(MAST::ElementBase));
+    
+    std::size_t v = 0;
+    
+    std::map<const libMesh::System*,
+    std::pair<std::vector<libMesh::dof_id_type>, libMesh::NumericVector<Real>*> >::const_iterator
+    it  = _localized_vectors.begin(),
+    end = _localized_vectors.end();
+    
+    for ( ; it != end; it++)
+        v +=
+        MAST::MemoryReport::bytes(it->second.first) +
+        MAST::MemoryReport::bytes(*it->second.second);
+    
+    r.add(nm, "localized vectors", v);
+}
+
+
+
+MAST::ElementBase&
+MAST::AssemblyBase::_get_elem(const libMesh::Elem& elem,
+                              std::auto_ptr<MAST::ElementBase>& storage) {
+    
+    // element-wise design fields are evaluated on this element by the
+    // calling thread until the next element is requested
+    MAST::ElementwiseDesignField::set_current_elem(&elem);
+    
+    MAST::ElementBase* rval = nullptr;
+    
+    if (!_reuse_elem_objects) {
+        
+        MAST_LOG_SCOPE("elem_build()", "AssemblyBase");
+        
+        storage.reset(_build_elem(elem).release());
+        rval = storage.get();
+    }
+    else {
+        
+        // any element owned from a prior call is no longer needed
+        storage.reset();
+        
+        std::map<const libMesh::Elem*, MAST::ElementBase*>::iterator it;
+        
+        {
+            libMesh::Threads::spin_mutex::scoped_lock
+            lock(libMesh::Threads::spin_mtx);
+            
+            it   = _elem_objects.find(&elem);
+            if (it != _elem_objects.end())
+                rval = it->second;
+        }
+        
+        // the element is created outside the lock since only one thread
+        // will work on a given element
+        if (!rval) {
+            
+            {
+                MAST_LOG_SCOPE("elem_build()", "AssemblyBase");
+                rval = _build_elem(elem).release();
+            }
+            
+            rval->set_geometry_cache(_elem_geometry_cache);
+            
+            libMesh::Threads::spin_mutex::scoped_lock
+            lock(libMesh::Threads::spin_mtx);
+            
+            _elem_objects[&elem] = rval;
+        }
+    }
+    
+    // the sensitivity parameter may have been set in a prior call
+    rval->sensitivity_param = nullptr;
+    
+    return *rval;
+}
+
+
+
 std::auto_ptr<libMesh::NumericVector<Real> >
 MAST::AssemblyBase::_build_localized_vector(const libMesh::System& sys,
                                             const libMesh::NumericVector<Real>& global) {
     
-    libMesh::NumericVector<Real>* local =
-    libMesh::NumericVector<Real>::build(sys.comm()).release();
+    MAST_LOG_SCOPE("build_localized_vector()", "AssemblyBase");
     
     const std::vector<libMesh::dof_id_type>& send_list =
     sys.get_dof_map().get_send_list();
     
-    local->init(sys.n_dofs(),
-                sys.n_local_dofs(),
-                send_list,
-                false,
-                libMesh::GHOSTED);
-    global.localize(*local, send_list);
+    // vectors with a different parallel layout cannot be copied into the
+    // ghosted vector, and are localized through a new scatter.
+    if (global.type() == libMesh::SERIAL ||
+        global.size()       != sys.n_dofs() ||
+        global.local_size() != sys.n_local_dofs()) {
+        
+        libMesh::NumericVector<Real>* local =
+        libMesh::NumericVector<Real>::build(sys.comm()).release();
+        
+        local->init(sys.n_dofs(),
+                    sys.n_local_dofs(),
+                    send_list,
+                    false,
+                    libMesh::GHOSTED);
+        global.localize(*local, send_list);
+        
+        return std::auto_ptr<libMesh::NumericVector<Real> >(local);
+    }
+    
+    std::pair<std::vector<libMesh::dof_id_type>, libMesh::NumericVector<Real>*>&
+    tmpl = _localized_vectors[&sys];
+    
+    // the template is rebuilt if the dof distribution has changed since
+    // it was created
+    if (!tmpl.second ||
+        tmpl.second->size()       != sys.n_dofs()       ||
+        tmpl.second->local_size() != sys.n_local_dofs() ||
+        tmpl.first                != send_list) {
+        
+        delete tmpl.second;
+        tmpl.first  = send_list;
+        tmpl.second = libMesh::NumericVector<Real>::build(sys.comm()).release();
+        tmpl.second->init(sys.n_dofs(),
+                          sys.n_local_dofs(),
+                          send_list,
+                          false,
+                          libMesh::GHOSTED);
+    }
+    
+    // the duplicate shares the ghost scatter context of the template, so
+    // only the owned values are copied and the ghost values updated
+    libMesh::NumericVector<Real>* local = tmpl.second->zero_clone().release();
+    *local = global;
+    local->close();
     
     return std::auto_ptr<libMesh::NumericVector<Real> >(local);
 }
 
 
 
+std::auto_ptr<libMesh::NumericVector<Real> >
+MAST::AssemblyBase::_begin_localized_vector(const libMesh::System& sys,
+                                            const libMesh::NumericVector<Real>& global,
+                                            bool& pending) {
+    
+    pending = false;
+    
+    const libMesh::PetscVector<Real>*
+    g = dynamic_cast<const libMesh::PetscVector<Real>*>(&global);
+    
+    if (!g                                  ||
+        global.type() == libMesh::SERIAL    ||
+        global.size()       != sys.n_dofs() ||
+        global.local_size() != sys.n_local_dofs())
+        return this->_build_localized_vector(sys, global);
+    
+    MAST_LOG_SCOPE("begin_localized_vector()", "AssemblyBase");
+    
+    // the ghosted template is created by a localization of the first
+    // vector for the system and send list
+    std::map<const libMesh::System*,
+    std::pair<std::vector<libMesh::dof_id_type>, libMesh::NumericVector<Real>*> >::iterator
+    it = _localized_vectors.find(&sys);
+    
+    if (it == _localized_vectors.end()                       ||
+        !it->second.second                                   ||
+        it->second.second->size()       != sys.n_dofs()      ||
+        it->second.second->local_size() != sys.n_local_dofs() ||
+        it->second.first != sys.get_dof_map().get_send_list())
+        return this->_build_localized_vector(sys, global);
+    
+    libMesh::NumericVector<Real>* local = it->second.second->zero_clone().release();
+    libMesh::PetscVector<Real>&   l     = dynamic_cast<libMesh::PetscVector<Real>&>(*local);
+    
+    // the owned values are copied, and the ghost values are updated
+    // while the caller works with the owned values
+    PetscErrorCode ierr = 0;
+    ierr = VecCopy(const_cast<libMesh::PetscVector<Real>*>(g)->vec(), l.vec());
+    CHKERRABORT(sys.comm().get(), ierr);
+    
+    ierr = VecGhostUpdateBegin(l.vec(), INSERT_VALUES, SCATTER_FORWARD);
+    CHKERRABORT(sys.comm().get(), ierr);
+    
+    pending = true;
+    
+    return std::auto_ptr<libMesh::NumericVector<Real> >(local);
+}
+
+
+
+void
+MAST::AssemblyBase::_end_localized_vector(libMesh::NumericVector<Real>& local) {
+    
+    MAST_LOG_SCOPE("end_localized_vector()", "AssemblyBase");
+    
+    libMesh::PetscVector<Real>& l = dynamic_cast<libMesh::PetscVector<Real>&>(local);
+    
+    PetscErrorCode ierr = 0;
+    ierr = VecGhostUpdateEnd(l.vec(), INSERT_VALUES, SCATTER_FORWARD);
+    CHKERRABORT(local.comm().get(), ierr);
+}
+
+
+
+void
+MAST::AssemblyBase::
+_get_elem_values(const libMesh::NumericVector<Real>& local,
+                 const std::vector<libMesh::dof_id_type>& dof_indices,
+                 RealVectorX& v) const {
+    
+    v.setZero(dof_indices.size());
+    
+    if (dof_indices.size())
+        local.get(dof_indices, v.data());
+}
+
+
+
+void
+MAST::AssemblyBase::
+_get_elem_values(const std::vector<libMesh::NumericVector<Real>*>& local,
+                 const std::vector<libMesh::dof_id_type>& dof_indices,
+                 RealMatrixX& m) const {
+    
+    m.setZero(dof_indices.size(), local.size());
+    
+    // the matrix is stored column-major, so each column is contiguous
+    if (dof_indices.size())
+        for (unsigned int j=0; j<local.size(); j++)
+            local[j]->get(dof_indices, m.data() + j*dof_indices.size());
+}
+
+
+
+void
+MAST::AssemblyBase::
+_build_localized_basis(const libMesh::System& sys,
+                       const std::vector<libMesh::NumericVector<Real>*>& basis,
+                       MAST::AssemblyBase::LocalizedBasis& b) const {
+    
+    MAST_LOG_SCOPE("build_localized_basis()", "AssemblyBase");
+    
+    const libMesh::DofMap& dof_map = sys.get_dof_map();
+    
+    const PetscInt
+    nb  = (PetscInt)basis.size(),
+    n_l = dof_map.n_local_dofs(),
+    n_g = dof_map.n_dofs();
+    
+    libmesh_assert_greater(nb, 0);
+    
+    b.first = dof_map.first_dof();
+    b.end   = dof_map.end_dof();
+    
+    // the send list may include local dofs
+    const std::vector<libMesh::dof_id_type>& send_list = dof_map.get_send_list();
+    b.ghost_dofs.clear();
+    for (unsigned int i=0; i<send_list.size(); i++)
+        if (send_list[i] < b.first || send_list[i] >= b.end)
+            b.ghost_dofs.push_back(send_list[i]);
+    
+    std::sort(b.ghost_dofs.begin(), b.ghost_dofs.end());
+    b.ghost_dofs.erase(std::unique(b.ghost_dofs.begin(), b.ghost_dofs.end()),
+                       b.ghost_dofs.end());
+    
+    const PetscInt
+    n_ghost = (PetscInt)b.ghost_dofs.size();
+    
+    std::vector<PetscInt> ghosts(b.ghost_dofs.begin(), b.ghost_dofs.end());
+    
+    // the values of all basis vectors at a dof are stored as one block
+    PetscErrorCode ierr;
+    Vec            v, v_local;
+    ierr = VecCreateGhostBlock(sys.comm().get(), nb, nb*n_l, nb*n_g, n_ghost,
+                               n_ghost? &ghosts[0]: PETSC_NULL, &v);
+    CHKERRABORT(sys.comm().get(), ierr);
+    
+    std::vector<libMesh::numeric_index_type> idx(n_l);
+    std::vector<Real>                        vals;
+    for (PetscInt i=0; i<n_l; i++)
+        idx[i] = b.first + i;
+    
+    PetscScalar* arr = PETSC_NULL;
+    ierr = VecGetArray(v, &arr);
+    CHKERRABORT(sys.comm().get(), ierr);
+    
+    for (PetscInt j=0; j<nb; j++) {
+        
+        basis[j]->get(idx, vals);
+        for (PetscInt i=0; i<n_l; i++)
+            arr[i*nb+j] = vals[i];
+    }
+    
+    ierr = VecRestoreArray(v, &arr);
+    CHKERRABORT(sys.comm().get(), ierr);
+    ierr = VecGhostUpdateBegin(v, INSERT_VALUES, SCATTER_FORWARD);
+    CHKERRABORT(sys.comm().get(), ierr);
+    ierr = VecGhostUpdateEnd(v, INSERT_VALUES, SCATTER_FORWARD);
+    CHKERRABORT(sys.comm().get(), ierr);
+    
+    // the local form has the local blocks followed by the ghost blocks
+    ierr = VecGhostGetLocalForm(v, &v_local);
+    CHKERRABORT(sys.comm().get(), ierr);
+    ierr = VecGetArray(v_local, &arr);
+    CHKERRABORT(sys.comm().get(), ierr);
+    
+    b.rows = Eigen::Map<RealMatrixX>(arr, nb, n_l+n_ghost);
+    
+    ierr = VecRestoreArray(v_local, &arr);
+    CHKERRABORT(sys.comm().get(), ierr);
+    ierr = VecGhostRestoreLocalForm(v, &v_local);
+    CHKERRABORT(sys.comm().get(), ierr);
+    ierr = VecDestroy(&v);
+    CHKERRABORT(sys.comm().get(), ierr);
+}
+
+
+
+void
+MAST::AssemblyBase::
+_get_elem_values(const MAST::AssemblyBase::LocalizedBasis& b,
+                 const std::vector<libMesh::dof_id_type>& dof_indices,
+                 RealMatrixX& m) const {
+    
+    const libMesh::dof_id_type
+    n_l = b.end - b.first;
+    
+    m.setZero(dof_indices.size(), b.rows.rows());
+    
+    for (unsigned int i=0; i<dof_indices.size(); i++) {
+        
+        const libMesh::dof_id_type d = dof_indices[i];
+        
+        if (d >= b.first && d < b.end)
+            m.row(i) = b.rows.col(d-b.first).transpose();
+        else {
+            
+            std::vector<libMesh::dof_id_type>::const_iterator
+            it = std::lower_bound(b.ghost_dofs.begin(), b.ghost_dofs.end(), d);
+            libmesh_assert(it != b.ghost_dofs.end() && *it == d);
+            
+            m.row(i) = b.rows.col(n_l + (it-b.ghost_dofs.begin())).transpose();
+        }
+    }
+}
+
+
+
+void
+MAST::AssemblyBase::
+_add_elem_matrix(libMesh::SparseMatrix<Real>& m,
+                 const DenseRealMatrix& mat,
+                 const std::vector<libMesh::dof_id_type>& dof_indices,
+                 const libMesh::Elem* elem) const {
+    
+    // the local entries are added directly to the CSR values of the
+    // matrix, if enabled for the system
+    if (elem) {
+        
+        MAST::ElementMatrixScatter*
+        scatter = _system->system().matrix_scatter(m);
+        
+        if (scatter && scatter->add(*elem, mat, dof_indices))
+            return;
+    }
+    
+    libMesh::PetscMatrix<Real>*
+    pm = dynamic_cast<libMesh::PetscMatrix<Real>*>(&m);
+    
+    PetscInt
+    bs = 1;
+    
+    PetscErrorCode ierr;
+    
+    if (pm) {
+        ierr = MatGetBlockSize(pm->mat(), &bs);
+        CHKERRABORT(m.comm().get(), ierr);
+    }
+    
+    const unsigned int
+    n  = (unsigned int)dof_indices.size(),
+    nn = bs > 1? n/bs: 0;
+    
+    // the element dofs are ordered by variable. Blocked insertion
+    // requires the dofs of each node to form one block of the matrix.
+    bool
+    blocked = (bs > 1 && n > 0 && n%bs == 0);
+    
+    for (unsigned int i=0; blocked && i<nn; i++) {
+        
+        blocked = (dof_indices[i]%bs == 0);
+        for (unsigned int j=1; blocked && j<bs; j++)
+            blocked = (dof_indices[j*nn+i] == dof_indices[i]+j);
+    }
+    
+    if (!blocked) {
+        
+        m.add_matrix(mat, dof_indices);
+        return;
+    }
+    
+    std::vector<PetscInt>
+    idx(nn);
+    std::vector<PetscScalar>
+    vals(n*n);
+    
+    for (unsigned int i=0; i<nn; i++)
+        idx[i] = dof_indices[i]/bs;
+    
+    // values in row-major order, with the rows and columns of each node
+    // next to each other
+    for (unsigned int bi=0; bi<nn; bi++)
+        for (unsigned int vi=0; vi<bs; vi++)
+            for (unsigned int bj=0; bj<nn; bj++)
+                for (unsigned int vj=0; vj<bs; vj++)
+                    vals[(bi*bs+vi)*n + bj*bs+vj] = mat(vi*nn+bi, vj*nn+bj);
+    
+    ierr = MatSetValuesBlocked(pm->mat(), nn, &idx[0], nn, &idx[0], &vals[0],
+                               ADD_VALUES);
+    CHKERRABORT(m.comm().get(), ierr);
+}
+
+
+
+void
+MAST::AssemblyBase::
+_get_parameter_values(std::map<const Real*, Real>& vals) const {
+    
+    libmesh_assert(_discipline);
+    
+    vals.clear();
+    
+    std::map<const Real*, const MAST::FunctionBase*>::const_iterator
+    it  = _discipline->get_parameter_map().begin(),
+    end = _discipline->get_parameter_map().end();
+    
+    for ( ; it != end; it++)
+        vals[it->first] = *it->first;
+}
+
+
+
 
 void
 MAST::AssemblyBase::attach_solution_function(MAST::MeshFieldFunction& f){
@@ -143,8 +686,9 @@ MAST::AssemblyBase::calculate_outputs(const libMesh::NumericVector<Real>& X) {
     RealMatrixX mat;
     
     std::vector<libMesh::dof_id_type> dof_indices;
-    const libMesh::DofMap& dof_map = sys.get_dof_map();
-    std::auto_ptr<MAST::ElementBase> physics_elem;
+    const MAST::ElementTopologyCache& topology = sys.topology_cache();
+    std::auto_ptr<MAST::ElementBase> elem_storage;
+    MAST::ElementBase* physics_elem = nullptr;
     
     std::auto_ptr<libMesh::NumericVector<Real> > localized_solution;
     localized_solution.reset(_build_localized_vector(sys, X).release());
@@ -155,19 +699,27 @@ MAST::AssemblyBase::calculate_outputs(const libMesh::NumericVector<Real>& X) {
         _sol_function->init(X);
     
     
-    libMesh::MeshBase::const_element_iterator       el     =
-    sys.get_mesh().active_local_elements_begin();
-    const libMesh::MeshBase::const_element_iterator end_el =
-    sys.get_mesh().active_local_elements_end();
+    // elements for which the outputs are evaluated
+    std::vector<MAST::AssemblyBase::OutputElem> elems;
+    _get_output_elems(elems);
     
     
-    for ( ; el != end_el; ++el) {
+    // the elements provide their quadrature point solution to the
+    // solution function, so the threaded evaluation is not used with it
+    if (_threaded_outputs && !_sol_function && _if_thread_local_outputs(elems)) {
         
-        const libMesh::Elem* elem = *el;
+        _calculate_outputs_threaded(*localized_solution, elems);
+        return;
+    }
+    
+    
+    for (unsigned int e=0; e<elems.size(); e++) {
+        
+        const libMesh::Elem* elem = elems[e].elem;
         
-        dof_map.dof_indices (elem, dof_indices);
+        topology.dof_indices (elem, dof_indices);
         
-        physics_elem.reset(_build_elem(*elem).release());
+        physics_elem = &_get_elem(*elem, elem_storage);
         
         // get the solution
         unsigned int ndofs = (unsigned int)dof_indices.size();
@@ -175,18 +727,18 @@ MAST::AssemblyBase::calculate_outputs(const libMesh::NumericVector<Real>& X) {
         vec.setZero(ndofs);
         mat.setZero(ndofs, ndofs);
         
-        for (unsigned int i=0; i<dof_indices.size(); i++)
-            sol(i) = (*localized_solution)(dof_indices[i]);
+        _get_elem_values(*localized_solution, dof_indices, sol);
         
         physics_elem->set_solution(sol);
         
         if (_sol_function)
             physics_elem->attach_active_solution_function(*_sol_function);
         
-        // perform the element level calculations
+        // perform the element level calculations for the outputs of
+        // this element
         _elem_outputs(*physics_elem,
-                      _discipline->volume_output(),
-                      _discipline->side_output());
+                      elems[e].vol_output,
+                      elems[e].side_output);
         
         physics_elem->detach_active_solution_function();
     }
@@ -201,6 +753,187 @@ MAST::AssemblyBase::calculate_outputs(const libMesh::NumericVector<Real>& X) {
 
 
 
+MAST::AssemblyBase::OutputChunk::~OutputChunk() {
+    
+    std::map<const MAST::OutputFunctionBase*, MAST::OutputFunctionBase*>::iterator
+    it  = local.begin(),
+    end = local.end();
+    
+    for ( ; it != end; it++)
+        delete it->second;
+}
+
+
+
+void
+MAST::AssemblyBase::ElemOutputs::
+operator() (const libMesh::Threads::BlockedRange<unsigned int>& range) const {
+    
+    MAST::NonlinearSystem& sys = _assembly._system->system();
+    
+    // these data structures are local to each range
+    RealVectorX sol;
+    
+    std::vector<libMesh::dof_id_type> dof_indices;
+    const MAST::ElementTopologyCache& topology = sys.topology_cache();
+    std::auto_ptr<MAST::ElementBase> elem_storage;
+    MAST::ElementBase* physics_elem = nullptr;
+    
+    std::auto_ptr<MAST::AssemblyBase::OutputChunk>
+    chunk(new MAST::AssemblyBase::OutputChunk);
+    chunk->first = range.begin();
+    chunk->last  = range.end();
+    
+    MAST::VolumeOutputMapType vol_output;
+    MAST::SideOutputMapType   side_output;
+    
+    for (unsigned int e=range.begin(); e<range.end(); e++) {
+        
+        const libMesh::Elem* elem = _elems[e].elem;
+        
+        // the outputs of the element are replaced by their thread-local
+        // copies, which are created on first use in this range
+        vol_output.clear();
+        side_output.clear();
+        
+        MAST::VolumeOutputMapType::const_iterator
+        v_it  = _elems[e].vol_output.begin(),
+        v_end = _elems[e].vol_output.end();
+        
+        for ( ; v_it != v_end; v_it++) {
+            
+            MAST::OutputFunctionBase*& o = chunk->local[v_it->second];
+            if (!o)
+                o = v_it->second->build_thread_local_copy().release();
+            vol_output.insert(std::make_pair(v_it->first, o));
+        }
+        
+        MAST::SideOutputMapType::const_iterator
+        s_it  = _elems[e].side_output.begin(),
+        s_end = _elems[e].side_output.end();
+        
+        for ( ; s_it != s_end; s_it++) {
+            
+            MAST::OutputFunctionBase*& o = chunk->local[s_it->second];
+            if (!o)
+                o = s_it->second->build_thread_local_copy().release();
+            side_output.insert(std::make_pair(s_it->first, o));
+        }
+        
+        topology.dof_indices (elem, dof_indices);
+        
+        physics_elem = &_assembly._get_elem(*elem, elem_storage);
+        
+        sol.setZero(dof_indices.size());
+        _assembly._get_elem_values(_sol, dof_indices, sol);
+        
+        physics_elem->set_solution(sol);
+        
+        _assembly._elem_outputs(*physics_elem, vol_output, side_output);
+    }
+    
+    libMesh::Threads::spin_mutex::scoped_lock
+    lock(libMesh::Threads::spin_mtx);
+    
+    _chunks.push_back(chunk.release());
+}
+
+
+
+bool
+MAST::AssemblyBase::
+_if_thread_local_outputs(const std::vector<MAST::AssemblyBase::OutputElem>& elems) const {
+    
+    // each output is checked once
+    std::set<const MAST::OutputFunctionBase*> outputs;
+    
+    for (unsigned int e=0; e<elems.size(); e++) {
+        
+        MAST::VolumeOutputMapType::const_iterator
+        v_it  = elems[e].vol_output.begin(),
+        v_end = elems[e].vol_output.end();
+        
+        for ( ; v_it != v_end; v_it++)
+            outputs.insert(v_it->second);
+        
+        MAST::SideOutputMapType::const_iterator
+        s_it  = elems[e].side_output.begin(),
+        s_end = elems[e].side_output.end();
+        
+        for ( ; s_it != s_end; s_it++)
+            outputs.insert(s_it->second);
+    }
+    
+    std::set<const MAST::OutputFunctionBase*>::const_iterator
+    it  = outputs.begin(),
+    end = outputs.end();
+    
+    for ( ; it != end; it++)
+        if (!(*it)->build_thread_local_copy().get())
+            return false;
+    
+    return true;
+}
+
+
+
+void
+MAST::AssemblyBase::
+_calculate_outputs_threaded(const libMesh::NumericVector<Real>& sol,
+                            std::vector<MAST::AssemblyBase::OutputElem>& elems) {
+    
+    MAST_LOG_SCOPE("calculate_outputs_threaded()", "AssemblyBase");
+    
+    std::vector<MAST::AssemblyBase::OutputChunk*> chunks;
+    
+    libMesh::Threads::parallel_for
+    (libMesh::Threads::BlockedRange<unsigned int>(0, (unsigned int)elems.size()),
+     MAST::AssemblyBase::ElemOutputs(*this, sol, elems, chunks));
+    
+    // the chunks are disjoint ranges of elements, and are combined in the
+    // order of their first element, which is independent of the
+    // scheduling of the threads
+    std::sort(chunks.begin(), chunks.end(),
+              [](const MAST::AssemblyBase::OutputChunk* a,
+                 const MAST::AssemblyBase::OutputChunk* b)
+              { return a->first < b->first; });
+    
+    std::set<const MAST::OutputFunctionBase*> added;
+    
+    for (unsigned int i=0; i<chunks.size(); i++) {
+        
+        MAST::AssemblyBase::OutputChunk& c = *chunks[i];
+        
+        for (unsigned int e=c.first; e<c.last; e++) {
+            
+            // an output is added only once for an element
+            added.clear();
+            
+            MAST::VolumeOutputMapType::iterator
+            v_it  = elems[e].vol_output.begin(),
+            v_end = elems[e].vol_output.end();
+            
+            for ( ; v_it != v_end; v_it++)
+                if (added.insert(v_it->second).second)
+                    v_it->second->add_thread_local_data(*c.local[v_it->second],
+                                                        *elems[e].elem);
+            
+            MAST::SideOutputMapType::iterator
+            s_it  = elems[e].side_output.begin(),
+            s_end = elems[e].side_output.end();
+            
+            for ( ; s_it != s_end; s_it++)
+                if (added.insert(s_it->second).second)
+                    s_it->second->add_thread_local_data(*c.local[s_it->second],
+                                                        *elems[e].elem);
+        }
+        
+        delete chunks[i];
+    }
+}
+
+
+
 void
 MAST::AssemblyBase::
 calculate_output_sensitivity(libMesh::ParameterVector &params,
@@ -208,6 +941,12 @@ calculate_output_sensitivity(libMesh::ParameterVector &params,
                              const libMesh::NumericVector<Real> &X) {
     
     
+    if (_batched_output_sensitivity) {
+        
+        _calculate_batched_output_sensitivity(params, if_total_sensitivity, X);
+        return;
+    }
+    
     MAST::NonlinearSystem& sys = _system->system();
     
     // iterate over each element, initialize it and get the relevant
@@ -216,8 +955,9 @@ calculate_output_sensitivity(libMesh::ParameterVector &params,
     RealMatrixX mat;
     
     std::vector<libMesh::dof_id_type> dof_indices;
-    const libMesh::DofMap& dof_map = sys.get_dof_map();
-    std::auto_ptr<MAST::ElementBase> physics_elem;
+    const MAST::ElementTopologyCache& topology = sys.topology_cache();
+    std::auto_ptr<MAST::ElementBase> elem_storage;
+    MAST::ElementBase* physics_elem = nullptr;
     
     std::auto_ptr<libMesh::NumericVector<Real> >
     localized_solution,
@@ -230,6 +970,11 @@ calculate_output_sensitivity(libMesh::ParameterVector &params,
     if (_sol_function)
         _sol_function->init( X);
     
+    // elements for which the outputs with an active sensitivity are
+    // evaluated, and the outputs of each element
+    std::vector<MAST::AssemblyBase::OutputElem> elems;
+    _get_output_elems(elems, true);
+    
     // iterate over the parameters
     for ( unsigned int i=0; i<params.size(); i++) {
         
@@ -238,19 +983,13 @@ calculate_output_sensitivity(libMesh::ParameterVector &params,
             (_build_localized_vector(sys,
                                      sys.get_sensitivity_solution(i)).release());
     
-        libMesh::MeshBase::const_element_iterator       el     =
-        sys.get_mesh().active_local_elements_begin();
-        const libMesh::MeshBase::const_element_iterator end_el =
-        sys.get_mesh().active_local_elements_end();
-        
-        
-        for ( ; el != end_el; ++el) {
+        for (unsigned int e=0; e<elems.size(); e++) {
             
-            const libMesh::Elem* elem = *el;
+            const libMesh::Elem* elem = elems[e].elem;
             
-            dof_map.dof_indices (elem, dof_indices);
+            topology.dof_indices (elem, dof_indices);
             
-            physics_elem.reset(_build_elem(*elem).release());
+            physics_elem = &_get_elem(*elem, elem_storage);
             
             // get the solution
             unsigned int ndofs = (unsigned int)dof_indices.size();
@@ -264,16 +1003,14 @@ calculate_output_sensitivity(libMesh::ParameterVector &params,
             _discipline->get_parameter(&(params[i].get()));
             
             // get the solution
-            for (unsigned int i=0; i<dof_indices.size(); i++)
-                sol(i) = (*localized_solution)(dof_indices[i]);
+            _get_elem_values(*localized_solution, dof_indices, sol);
 
             // tell the element about the solution
             physics_elem->set_solution(sol);
 
             // get the solution sensitivity
             if (if_total_sensitivity)
-                for (unsigned int i=0; i<dof_indices.size(); i++)
-                    sol_sens(i) = (*localized_solution_sensitivity)(dof_indices[i]);
+                _get_elem_values(*localized_solution_sensitivity, dof_indices, sol_sens);
         
             // tell the solution about the sensitivity
             physics_elem->set_solution(sol_sens, true);
@@ -283,8 +1020,8 @@ calculate_output_sensitivity(libMesh::ParameterVector &params,
             
             // perform the element level calculations
             _elem_output_sensitivity(*physics_elem,
-                                     _discipline->volume_output(),
-                                     _discipline->side_output());
+                                     elems[e].vol_output,
+                                     elems[e].side_output);
             
             physics_elem->detach_active_solution_function();
         }
@@ -299,6 +1036,289 @@ calculate_output_sensitivity(libMesh::ParameterVector &params,
 
 
 
+void
+MAST::AssemblyBase::
+_calculate_batched_output_sensitivity(libMesh::ParameterVector &params,
+                                      const bool if_total_sensitivity,
+                                      const libMesh::NumericVector<Real> &X) {
+    
+    MAST_LOG_SCOPE("output_sensitivity()", "AssemblyBase");
+    
+    MAST::NonlinearSystem& sys = _system->system();
+    
+    const unsigned int n_params = params.size();
+    
+    // iterate over each element, initialize it and get the relevant
+    // analysis quantities
+    RealVectorX sol, sol_sens;
+    
+    std::vector<libMesh::dof_id_type> dof_indices;
+    const MAST::ElementTopologyCache& topology = sys.topology_cache();
+    std::auto_ptr<MAST::ElementBase> elem_storage;
+    MAST::ElementBase* physics_elem = nullptr;
+    
+    std::auto_ptr<libMesh::NumericVector<Real> > localized_solution;
+    localized_solution.reset(_build_localized_vector(sys, X).release());
+    
+    // functions for the parameters, and the localized solution
+    // sensitivity for each parameter. All solution sensitivities are
+    // localized before the element loop.
+    std::vector<const MAST::FunctionBase*> f(n_params, nullptr);
+    std::vector<libMesh::NumericVector<Real>*>
+    localized_solution_sensitivity(n_params, nullptr);
+    
+    for (unsigned int i=0; i<n_params; i++) {
+        
+        f[i] = _discipline->get_parameter(&(params[i].get()));
+        
+        if (if_total_sensitivity)
+            localized_solution_sensitivity[i] =
+            _build_localized_vector(sys, sys.get_sensitivity_solution(i)).release();
+    }
+    
+    // if a solution function is attached, initialize it
+    if (_sol_function)
+        _sol_function->init( X);
+    
+    // elements for which the outputs with an active sensitivity are
+    // evaluated, and the outputs of each element
+    std::vector<MAST::AssemblyBase::OutputElem> elems;
+    _get_output_elems(elems, true);
+    
+    for (unsigned int e=0; e<elems.size(); e++) {
+        
+        const libMesh::Elem* elem = elems[e].elem;
+        
+        topology.dof_indices (elem, dof_indices);
+        
+        physics_elem = &_get_elem(*elem, elem_storage);
+        
+        // the solution is the same for all parameters
+        unsigned int ndofs = (unsigned int)dof_indices.size();
+        sol.setZero(ndofs);
+        sol_sens.setZero(ndofs);
+        
+        _get_elem_values(*localized_solution, dof_indices, sol);
+        physics_elem->set_solution(sol);
+        
+        if (_sol_function)
+            physics_elem->attach_active_solution_function(*_sol_function);
+        
+        for (unsigned int i=0; i<n_params; i++) {
+            
+            // tell the element about the sensitivity parameter
+            physics_elem->sensitivity_param = f[i];
+            
+            // tell the element about the solution sensitivity
+            if (if_total_sensitivity)
+                _get_elem_values(*localized_solution_sensitivity[i],
+                                 dof_indices, sol_sens);
+            physics_elem->set_solution(sol_sens, true);
+            
+            // perform the element level calculations
+            _elem_output_sensitivity(*physics_elem,
+                                     elems[e].vol_output,
+                                     elems[e].side_output);
+        }
+        
+        physics_elem->detach_active_solution_function();
+    }
+    
+    // if a solution function is attached, clear it
+    if (_sol_function)
+        _sol_function->clear();
+    
+    for (unsigned int i=0; i<n_params; i++)
+        delete localized_solution_sensitivity[i];
+}
+
+
+
+void
+MAST::AssemblyBase::
+_get_output_elems(std::vector<MAST::AssemblyBase::OutputElem>& elems,
+                  bool if_sensitivity) {
+    
+    MAST_LOG_SCOPE("get_output_elems()", "AssemblyBase");
+    
+    elems.clear();
+    
+    MAST::VolumeOutputMapType vol_output;
+    MAST::SideOutputMapType   side_output;
+    
+    if (if_sensitivity)
+        _get_sensitivity_outputs(vol_output, side_output);
+    else {
+        vol_output  = _discipline->volume_output();
+        side_output = _discipline->side_output();
+    }
+    
+    // the outputs of each element are collected from the element lists
+    // of the outputs, so that the cost is proportional to the number of
+    // elements of the outputs. The elements are ordered by their ids for
+    // a deterministic order of evaluation.
+    std::map<libMesh::dof_id_type, MAST::AssemblyBase::OutputElem> elem_outputs;
+    
+    MAST::VolumeOutputMapType::const_iterator
+    v_it  = vol_output.begin(),
+    v_end = vol_output.end();
+    
+    for ( ; v_it != v_end; v_it++) {
+        
+        const std::vector<const libMesh::Elem*>&
+        e = _volume_output_elems(v_it->first, *v_it->second);
+        
+        for (unsigned int i=0; i<e.size(); i++) {
+            
+            MAST::AssemblyBase::OutputElem& oe = elem_outputs[e[i]->id()];
+            oe.elem = e[i];
+            oe.vol_output.insert(*v_it);
+        }
+    }
+    
+    MAST::SideOutputMapType::const_iterator
+    s_it  = side_output.begin(),
+    s_end = side_output.end();
+    
+    for ( ; s_it != s_end; s_it++) {
+        
+        if (!if_sensitivity && !_if_elem_side_output(*s_it->second))
+            continue;
+        
+        const std::vector<const libMesh::Elem*>&
+        e = _side_output_elems(s_it->first, *s_it->second);
+        
+        for (unsigned int i=0; i<e.size(); i++) {
+            
+            MAST::AssemblyBase::OutputElem& oe = elem_outputs[e[i]->id()];
+            oe.elem = e[i];
+            oe.side_output.insert(*s_it);
+        }
+    }
+    
+    elems.reserve(elem_outputs.size());
+    
+    std::map<libMesh::dof_id_type, MAST::AssemblyBase::OutputElem>::const_iterator
+    it  = elem_outputs.begin(),
+    end = elem_outputs.end();
+    
+    for ( ; it != end; it++)
+        elems.push_back(it->second);
+}
+
+
+
+const std::vector<const libMesh::Elem*>&
+MAST::AssemblyBase::
+_volume_output_elems(libMesh::subdomain_id_type sid,
+                     const MAST::OutputFunctionBase& o) {
+    
+    MAST::AssemblyBase::OutputElemList&
+    l = _volume_output_elem_lists[std::make_pair(sid, &o)];
+    
+    // the list is valid if the subset of the output has not changed
+    if (l.valid &&
+        l.modification_count == o.elem_subset_modification_count())
+        return l.elems;
+    
+    const std::set<const libMesh::Elem*>*
+    subset = o.get_elem_subset_for_evaluation();
+    
+    const MAST::NonlinearSystem& sys = _system->system();
+    
+    l.elems.clear();
+    l.valid              = true;
+    l.modification_count = o.elem_subset_modification_count();
+    
+    if (subset) {
+        
+        std::set<const libMesh::Elem*>::const_iterator
+        e_it  = subset->begin(),
+        e_end = subset->end();
+        
+        for ( ; e_it != e_end; e_it++)
+            if ((*e_it)->active()                             &&
+                (*e_it)->processor_id() == sys.processor_id() &&
+                (*e_it)->subdomain_id() == sid)
+                l.elems.push_back(*e_it);
+    }
+    else {
+        
+        libMesh::MeshBase::const_element_iterator       el     =
+        sys.get_mesh().active_local_subdomain_elements_begin(sid);
+        const libMesh::MeshBase::const_element_iterator end_el =
+        sys.get_mesh().active_local_subdomain_elements_end(sid);
+        
+        for ( ; el != end_el; ++el)
+            l.elems.push_back(*el);
+    }
+    
+    return l.elems;
+}
+
+
+
+const std::vector<const libMesh::Elem*>&
+MAST::AssemblyBase::
+_side_output_elems(libMesh::boundary_id_type bid,
+                   const MAST::OutputFunctionBase& o) {
+    
+    MAST::AssemblyBase::OutputElemList&
+    l = _side_output_elem_lists[std::make_pair(bid, &o)];
+    
+    if (l.valid)
+        return l.elems;
+    
+    l.valid = true;
+    
+    const MAST::NonlinearSystem& sys = _system->system();
+    const libMesh::BoundaryInfo& binfo = sys.get_mesh().get_boundary_info();
+    
+    libMesh::MeshBase::const_element_iterator       el     =
+    sys.get_mesh().active_local_elements_begin();
+    const libMesh::MeshBase::const_element_iterator end_el =
+    sys.get_mesh().active_local_elements_end();
+    
+    for ( ; el != end_el; ++el)
+        for (unsigned short int s=0; s<(*el)->n_sides(); s++)
+            if (binfo.has_boundary_id(*el, s, bid)) {
+                
+                l.elems.push_back(*el);
+                break;
+            }
+    
+    return l.elems;
+}
+
+
+
+void
+MAST::AssemblyBase::
+_get_sensitivity_outputs(MAST::VolumeOutputMapType& vol_output,
+                         MAST::SideOutputMapType& side_output) const {
+    
+    vol_output.clear();
+    side_output.clear();
+    
+    MAST::VolumeOutputMapType::const_iterator
+    v_it  = _discipline->volume_output().begin(),
+    v_end = _discipline->volume_output().end();
+    
+    for ( ; v_it != v_end; v_it++)
+        if (v_it->second->if_sensitivity_active())
+            vol_output.insert(*v_it);
+    
+    MAST::SideOutputMapType::const_iterator
+    s_it  = _discipline->side_output().begin(),
+    s_end = _discipline->side_output().end();
+    
+    for ( ; s_it != s_end; s_it++)
+        if (s_it->second->if_sensitivity_active())
+            side_output.insert(*s_it);
+}
+
+
+
 void
 MAST::AssemblyBase::
 _elem_outputs(MAST::ElementBase &elem,
@@ -23,6 +23,7 @@
 // C++ includes
 #include <map>
 #include <memory>
+#include <vector>
 
 
 // MAST includes
@@ -31,6 +32,7 @@
 
 // libMesh includes
 #include "libmesh/system.h"
+#include "libmesh/threads.h"
 
 namespace MAST {
     
@@ -41,6 +43,8 @@ namespace MAST {
     class OutputFunctionBase;
     class MeshFieldFunction;
     class NonlinearSystem;
+    class ElementCostModel;
+    class MemoryReport;
     
     class AssemblyBase {
     public:
@@ -109,7 +113,12 @@ namespace MAST {
 
         /*!
          *   tells the assembly object that this function is will
-         *   need to be initialized before each residual evaluation
+         *   need to be initialized before each residual evaluation. If the
+         *   function is only evaluated in the local elements, for example
+         *   by the elements of this system, then
+         *   MAST::MeshFieldFunction::set_local_interpolation() avoids the
+         *   serial localization and the rebuild of the mesh function at
+         *   each evaluation.
          */
         void attach_solution_function(MAST::MeshFieldFunction& f);
 
@@ -145,6 +154,155 @@ namespace MAST {
                                           const libMesh::NumericVector<Real>& X);
 
         
+        
+        /*!
+         *   tells the assembly to retain the element objects created for
+         *   each local element between subsequent assembly calls, so that
+         *   the finite element, quadrature and local element data need not
+         *   be rebuilt for every element in every residual evaluation. 
+         *   The cached objects hold references to the property cards and
+         *   mesh elements, and clear_elem_objects() must be called if 
+         *   either of these change. This is \p false by default.
+         */
+        void set_reuse_elem_objects(bool f);
+        
+        
+        /*!
+         *   @returns \p true if the element objects are retained between
+         *   assembly calls.
+         */
+        bool if_reuse_elem_objects() const {
+            return _reuse_elem_objects;
+        }
+
+        
+        /*!
+         *   deletes the element objects retained from prior assembly calls
+         */
+        void clear_elem_objects();
+        
+        
+        /*!
+         *   deletes the ghosted template vectors used by
+         *   _build_localized_vector()
+         */
+        void clear_localized_vectors();
+        
+        
+        /*!
+         *   deletes the element lists of the outputs, which must be called
+         *   if the outputs of the discipline are deleted
+         */
+        void clear_output_elems();
+        
+        
+        /*!
+         *   deletes the data that this assembly stores for the elements or
+         *   dofs of the mesh, which must be called after the mesh is
+         *   refined, coarsened or repartitioned. This deletes the element
+         *   objects and localized vectors, clears the parameter-element
+         *   dependency of the discipline and the measured costs of the
+         *   element cost model, if provided. Derived classes add their
+         *   element caches.
+         */
+        virtual void clear_mesh_dependent_data();
+        
+        
+        /*!
+         *   tells the retained element objects to store the geometric
+         *   quadrature point data between assembly calls. This has an effect
+         *   only if element objects are reused. See
+         *   MAST::ElementBase::set_geometry_cache(). This is \p false by
+         *   default.
+         */
+        void set_elem_geometry_cache(bool f);
+        
+        
+        /*!
+         *   @returns \p true if the retained element objects store the
+         *   geometric quadrature point data.
+         */
+        bool if_elem_geometry_cache() const {
+            return _elem_geometry_cache;
+        }
+        
+        
+        /*!
+         *   adds the bytes of the data retained by this assembly between
+         *   calls, the element objects and the localized vectors, to \p r,
+         *   with \p nm as the name of this object. The element objects are
+         *   reported by the size of their class, without the data that they
+         *   allocate.
+         */
+        virtual void report_memory(MAST::MemoryReport& r,
+                                   const std::string& nm) const;
+        
+        
+        /*!
+         *   tells calculate_output_sensitivity() to visit each element once
+         *   and evaluate the output sensitivities for all parameters,
+         *   instead of iterating over all elements for each parameter.
+         *   With \p if_total_sensitivity this keeps the localized
+         *   solution sensitivity of all parameters in memory at the same
+         *   time. This is \p false by default.
+         */
+        void set_batched_output_sensitivity(bool f) {
+            _batched_output_sensitivity = f;
+        }
+        
+        
+        /*!
+         *   @returns \p true if the output sensitivities for all parameters
+         *   are evaluated in a single pass over the elements.
+         */
+        bool if_batched_output_sensitivity() const {
+            return _batched_output_sensitivity;
+        }
+        
+        
+        /*!
+         *   tells calculate_outputs() to distribute the output elements
+         *   over the libMesh threads (as specified by \p --n_threads). The
+         *   elements of a range store their data in thread-local copies of
+         *   the outputs, see MAST::OutputFunctionBase::build_thread_local_copy().
+         *   After all elements are evaluated, the local data is added to the
+         *   outputs in the serial order of the elements, so that the values
+         *   and aggregated functionals do not depend on the number of threads.
+         *   The outputs are evaluated serially if a solution function is
+         *   attached, or if an output does not provide a thread-local copy.
+         *   The element kernels must be safe for concurrent evaluation on
+         *   distinct elements. This is \p false by default.
+         */
+        void set_threaded_output_evaluation(bool f) {
+            _threaded_outputs = f;
+        }
+        
+        
+        /*!
+         *   @returns \p true if the outputs are evaluated with threads.
+         */
+        bool if_threaded_output_evaluation() const {
+            return _threaded_outputs;
+        }
+        
+        
+        /*!
+         *   sets the model to which the time of each element in the
+         *   residual and Jacobian assembly is added, if the model is 
+         *   measuring the element costs. A nullptr removes the model.
+         *   The model clears the mesh dependent data of this assembly
+         *   when it repartitions the mesh.
+         */
+        void set_element_cost_model(MAST::ElementCostModel* m);
+        
+        
+        /*!
+         *   @returns the element cost model, or nullptr if none is set
+         */
+        MAST::ElementCostModel* element_cost_model() {
+            return _cost_model;
+        }
+        
     protected:
         
         /*!
@@ -154,16 +312,289 @@ namespace MAST {
         virtual std::auto_ptr<MAST::ElementBase>
         _build_elem(const libMesh::Elem& elem) = 0;
         
+        
+        /*!
+         *   @returns a reference to the element object for calculation of
+         *   element quantities on \p elem. If element objects are being
+         *   reused, the object is created on first request and retained
+         *   for subsequent calls. Otherwise, a new object is created with
+         *   _build_elem() and its ownership is given to \p storage. 
+         *   \p elem is also set as the current element of the calling
+         *   thread for MAST::ElementwiseDesignField.
+         *   This can be called concurrently from multiple threads for
+         *   distinct elements.
+         */
+        MAST::ElementBase&
+        _get_elem(const libMesh::Elem& elem,
+                  std::auto_ptr<MAST::ElementBase>& storage);
+        
         /*!
          *   localizes the parallel vector so that the local copy
          *   stores all values necessary for calculation of the
-         *   element quantities
+         *   element quantities. A ghosted template vector is retained
+         *   for each system and send list. The returned vector is
+         *   duplicated from it, so that it shares the ghost scatter
+         *   context, and its values are set with a ghost update.
          */
         std::auto_ptr<libMesh::NumericVector<Real> >
         _build_localized_vector(const libMesh::System& sys,
                                 const libMesh::NumericVector<Real>& global);
         
         
+        /*!
+         *   same as _build_localized_vector(), except that the ghost update
+         *   is only started if \p global has the parallel layout of the
+         *   system, in which case \p pending is set to \p true. The owned
+         *   values of the returned vector are available, and the ghost
+         *   values only after _end_localized_vector() is called. Otherwise,
+         *   or if the ghosted template of the system has not yet been
+         *   created by _build_localized_vector(), the vector is fully
+         *   localized and \p pending is \p false.
+         */
+        std::auto_ptr<libMesh::NumericVector<Real> >
+        _begin_localized_vector(const libMesh::System& sys,
+                                const libMesh::NumericVector<Real>& global,
+                                bool& pending);
+        
+        
+        /*!
+         *   completes the ghost update of a vector returned by
+         *   _begin_localized_vector() with \p pending set to \p true
+         */
+        void
+        _end_localized_vector(libMesh::NumericVector<Real>& local);
+        
+        
+        /*!
+         *   copies the values of \p local for \p dof_indices into \p v.
+         *   The values are read from the local array of the vector in
+         *   one call, instead of one virtual call per dof.
+         */
+        void
+        _get_elem_values(const libMesh::NumericVector<Real>& local,
+                         const std::vector<libMesh::dof_id_type>& dof_indices,
+                         RealVectorX& v) const;
+        
+        
+        /*!
+         *   copies the values of \p local[j] for \p dof_indices into
+         *   column j of \p m.
+         */
+        void
+        _get_elem_values(const std::vector<libMesh::NumericVector<Real>*>& local,
+                         const std::vector<libMesh::dof_id_type>& dof_indices,
+                         RealMatrixX& m) const;
+        
+        
+        /*!
+         *   values of a set of basis vectors on the local and ghosted dofs
+         *   of a system. Column \p c of \p rows has the values of all
+         *   basis vectors at a dof, which is the local dof \p first+c for
+         *   \p c less than the number of local dofs, and the entry of
+         *   \p ghost_dofs after that.
+         */
+        struct LocalizedBasis {
+            
+            libMesh::dof_id_type                first, end;
+            
+            std::vector<libMesh::dof_id_type>   ghost_dofs;
+            
+            RealMatrixX                         rows;
+        };
+        
+        
+        /*!
+         *   localizes all vectors of \p basis in \p b with a single ghost
+         *   update of a blocked vector, instead of one localized vector for
+         *   each basis vector.
+         */
+        void
+        _build_localized_basis(const libMesh::System& sys,
+                               const std::vector<libMesh::NumericVector<Real>*>& basis,
+                               MAST::AssemblyBase::LocalizedBasis& b) const;
+        
+        
+        /*!
+         *   copies the values of the basis vectors in \p b for
+         *   \p dof_indices into the rows of \p m, which has one column for
+         *   each basis vector.
+         */
+        void
+        _get_elem_values(const MAST::AssemblyBase::LocalizedBasis& b,
+                         const std::vector<libMesh::dof_id_type>& dof_indices,
+                         RealMatrixX& m) const;
+        
+        
+        /*!
+         *   adds the element matrix \p mat to \p m for \p dof_indices.
+         *   If \p m is a PETSc matrix with a block size larger than 1 and
+         *   the element dofs of each node are contiguous in the global
+         *   numbering, the matrix is added by blocks with
+         *   MatSetValuesBlocked(). Otherwise, add_matrix() is used.
+         *   If \p elem is provided and the system has direct matrix
+         *   insertion enabled, the matrix is first added with the
+         *   MAST::ElementMatrixScatter of the system for \p m.
+         */
+        void
+        _add_elem_matrix(libMesh::SparseMatrix<Real>& m,
+                         const DenseRealMatrix& mat,
+                         const std::vector<libMesh::dof_id_type>& dof_indices,
+                         const libMesh::Elem* elem = nullptr) const;
+        
+        
+        /*!
+         *   stores the current values of the parameters added to the
+         *   discipline in \p vals. This is used as the key to identify
+         *   whether quantities retained from a prior assembly are still
+         *   valid.
+         */
+        void
+        _get_parameter_values(std::map<const Real*, Real>& vals) const;
+        
+        
+        
+        /*!
+         *   an element and the outputs that are evaluated for it
+         */
+        struct OutputElem {
+            
+            OutputElem(): elem(nullptr) { }
+            
+            const libMesh::Elem*       elem;
+            MAST::VolumeOutputMapType  vol_output;
+            MAST::SideOutputMapType    side_output;
+        };
+        
+        
+        /*!
+         *   sets \p elems to the active local elements for which at least
+         *   one output is evaluated, in the order of their ids, along with
+         *   the outputs of each element. A volume output is evaluated on
+         *   the elements of its subdomain, or of its subset of elements if
+         *   it has one, and a side output on the elements with a side on
+         *   its boundary. If \p if_sensitivity is true, only the outputs
+         *   with an active sensitivity are considered. Otherwise, the side
+         *   outputs for which _if_elem_side_output() is \p false are
+         *   skipped.
+         */
+        void
+        _get_output_elems(std::vector<MAST::AssemblyBase::OutputElem>& elems,
+                          bool if_sensitivity = false);
+        
+        
+        /*!
+         *   elements of an output, and the modification count of the
+         *   element subset of the output for which the elements were found.
+         *   \p valid is \p false until the elements are found, since an
+         *   output may have no elements on this processor.
+         */
+        struct OutputElemList {
+            
+            OutputElemList(): valid(false), modification_count(0) { }
+            
+            bool                                   valid;
+            unsigned int                           modification_count;
+            std::vector<const libMesh::Elem*>      elems;
+        };
+        
+        
+        /*!
+         *   @returns \p true if the side output \p o is evaluated by the
+         *   elements in calculate_outputs(). Assemblies that evaluate a
+         *   side output without the elements return \p false for it.
+         */
+        virtual bool
+        _if_elem_side_output(const MAST::OutputFunctionBase& o) const {
+            return true;
+        }
+        
+        
+        /*!
+         *   @returns the active local elements of the volume output \p o
+         *   on subdomain \p sid, which are found on the first call for the
+         *   mesh and output, and again after the element subset of \p o
+         *   is modified
+         */
+        const std::vector<const libMesh::Elem*>&
+        _volume_output_elems(libMesh::subdomain_id_type sid,
+                             const MAST::OutputFunctionBase& o);
+        
+        
+        /*!
+         *   @returns the active local elements with a side on boundary
+         *   \p bid for the side output \p o
+         */
+        const std::vector<const libMesh::Elem*>&
+        _side_output_elems(libMesh::boundary_id_type bid,
+                           const MAST::OutputFunctionBase& o);
+        
+        
+        /*!
+         *   sets \p vol_output and \p side_output to the outputs of the
+         *   discipline for which the sensitivity is active.
+         */
+        void
+        _get_sensitivity_outputs(MAST::VolumeOutputMapType& vol_output,
+                                 MAST::SideOutputMapType& side_output) const;
+        
+        
+        /*!
+         *   thread-local copies of the outputs used for a range of output
+         *   elements, from \p first to \p last
+         */
+        struct OutputChunk {
+            
+            OutputChunk(): first(0), last(0) { }
+            
+            ~OutputChunk();
+            
+            unsigned int                                           first, last;
+            std::map<const MAST::OutputFunctionBase*, MAST::OutputFunctionBase*> local;
+        };
+        
+        
+        /*!
+         *   Functor that evaluates the outputs over a range of output
+         *   elements with thread-local copies of the outputs. The copies
+         *   of each range are added to \p chunks, which is serialized.
+         */
+        class ElemOutputs {
+        public:
+            
+            ElemOutputs(MAST::AssemblyBase& assembly,
+                        const libMesh::NumericVector<Real>& sol,
+                        std::vector<MAST::AssemblyBase::OutputElem>& elems,
+                        std::vector<MAST::AssemblyBase::OutputChunk*>& chunks):
+            _assembly(assembly), _sol(sol), _elems(elems), _chunks(chunks) { }
+            
+            void operator() (const libMesh::Threads::BlockedRange<unsigned int>& range) const;
+            
+        protected:
+            
+            MAST::AssemblyBase&                             _assembly;
+            const libMesh::NumericVector<Real>&             _sol;
+            std::vector<MAST::AssemblyBase::OutputElem>&    _elems;
+            std::vector<MAST::AssemblyBase::OutputChunk*>&  _chunks;
+        };
+        
+        
+        /*!
+         *   @returns \p true if all outputs of \p elems provide a
+         *   thread-local copy
+         */
+        bool
+        _if_thread_local_outputs(const std::vector<MAST::AssemblyBase::OutputElem>& elems) const;
+        
+        
+        /*!
+         *   evaluates the outputs of \p elems about the localized solution
+         *   \p sol with threads, and adds the thread-local data to the
+         *   outputs in the order of \p elems
+         */
+        void
+        _calculate_outputs_threaded(const libMesh::NumericVector<Real>& sol,
+                                    std::vector<MAST::AssemblyBase::OutputElem>& elems);
+        
         
         /*!
          *   assembles the outputs for this element
@@ -182,6 +613,18 @@ namespace MAST {
                                  std::multimap<libMesh::subdomain_id_type, MAST::OutputFunctionBase *> &vol_output,
                                  std::multimap<libMesh::boundary_id_type,MAST::OutputFunctionBase *> &side_output);
 
+
+        /*!
+         *   evaluates the output sensitivity for all parameters in
+         *   \p params in a single pass over the elements. This is used by
+         *   calculate_output_sensitivity() if batched output sensitivity
+         *   is turned on.
+         */
+        void
+        _calculate_batched_output_sensitivity(libMesh::ParameterVector& params,
+                                              const bool if_total_sensitivity,
+                                              const libMesh::NumericVector<Real>& X);
+
         /*!
          *   PhysicsDisciplineBase object for which this class is assembling
          */
@@ -197,6 +640,60 @@ namespace MAST {
          *   system solution that will be initialized before each solution
          */
         MAST::MeshFieldFunction* _sol_function;
+        
+        /*!
+         *   model to which the measured element costs are added
+         */
+        MAST::ElementCostModel* _cost_model;
+        
+        
+        /*!
+         *   flag to retain the element objects between assembly calls
+         */
+        bool _reuse_elem_objects;
+        
+        /*!
+         *   flag to store the geometric data in the retained element objects
+         */
+        bool _elem_geometry_cache;
+        
+        /*!
+         *   flag to evaluate the output sensitivities for all parameters
+         *   in a single pass over the elements
+         */
+        bool _batched_output_sensitivity;
+        
+        /*!
+         *   flag to evaluate the outputs with threads
+         */
+        bool _threaded_outputs;
+        
+        
+        /*!
+         *   element objects retained between assembly calls
+         */
+        std::map<const libMesh::Elem*, MAST::ElementBase*> _elem_objects;
+        
+        
+        /*!
+         *   ghosted template vectors created by _build_localized_vector()
+         *   for each system, along with the send list for which they were
+         *   initialized.
+         */
+        std::map<const libMesh::System*,
+        std::pair<std::vector<libMesh::dof_id_type>, libMesh::NumericVector<Real>*> >
+        _localized_vectors;
+        
+        
+        /*!
+         *   elements of the volume and side outputs by subdomain or
+         *   boundary id and output
+         */
+        std::map<std::pair<libMesh::subdomain_id_type, const MAST::OutputFunctionBase*>,
+        MAST::AssemblyBase::OutputElemList>  _volume_output_elem_lists;
+        
+        std::map<std::pair<libMesh::boundary_id_type, const MAST::OutputFunctionBase*>,
+        MAST::AssemblyBase::OutputElemList>  _side_output_elem_lists;
     };
         
 }
@@ -0,0 +1,287 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2017  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+// MAST includes
+#include "base/async_output_writer.h"
+#include "base/performance_log.h"
+
+
+// libMesh includes
+#include "libmesh/equation_systems.h"
+#include "libmesh/exodusII_io.h"
+#include "libmesh/exodusII_io_helper.h"
+#include "libmesh/numeric_vector.h"
+
+
+MAST::AsyncOutputWriter::
+AsyncOutputWriter(const libMesh::Parallel::Communicator& comm):
+_comm(comm),
+_max_pending(2),
+_n_pending(0),
+_stop(false) {
+
+}
+
+
+
+MAST::AsyncOutputWriter::~AsyncOutputWriter() {
+
+    this->flush();
+}
+
+
+
+void
+MAST::AsyncOutputWriter::set_max_pending(unsigned int n) {
+
+    libmesh_assert_greater(n, 0);
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    _max_pending = n;
+    _cv.notify_all();
+}
+
+
+
+void
+MAST::AsyncOutputWriter::write_exodus_timestep(const std::string& fname,
+                                               libMesh::EquationSystems& es,
+                                               Real time) {
+
+    MAST_LOG_SCOPE("write_exodus_timestep()", "AsyncOutputWriter");
+
+    ExodusFile& file = _exodus_files[fname];
+
+    if (!file.io) {
+
+        // the file, the mesh and the first time step are written here,
+        // which also initializes the nodal variables of the file. This is
+        // a collective operation, and cannot be done by the I/O thread.
+        std::vector<std::string> names;
+        es.build_variable_names(names);
+
+        file.io      = new libMesh::ExodusII_IO(es.get_mesh());
+        file.n_vars  = (unsigned int)names.size();
+        file.n_steps = 1;
+
+        std::lock_guard<std::mutex> lock(_exodus_mutex);
+        file.io->write_timestep(fname, es, 1, time);
+        return;
+    }
+
+    // gathers the nodal solution, which is then copied for the I/O thread
+    // on processor 0.
+    std::vector<Number> soln;
+    es.build_solution_vector(soln);
+    file.n_steps++;
+
+    if (_comm.rank())
+        return;
+
+    Buffer* b = new Buffer;
+    b->type   = EXODUS;
+    b->fname  = fname;
+    b->exodus = &file;
+    b->step   = file.n_steps;
+    b->time   = time;
+    b->values.swap(soln);
+
+    this->_push(b);
+}
+
+
+
+void
+MAST::AsyncOutputWriter::write_binary(const std::string& fname,
+                                      const libMesh::NumericVector<Real>& v,
+                                      unsigned int step,
+                                      Real time) {
+
+    MAST_LOG_SCOPE("write_binary()", "AsyncOutputWriter");
+
+    std::vector<Real> vals;
+    v.localize_to_one(vals, 0);
+
+    if (_comm.rank())
+        return;
+
+    Buffer* b = new Buffer;
+    b->type   = BINARY;
+    b->fname  = fname;
+    b->step   = step;
+    b->time   = time;
+    b->values.swap(vals);
+
+    this->_push(b);
+}
+
+
+
+void
+MAST::AsyncOutputWriter::flush() {
+
+    MAST_LOG_SCOPE("flush()", "AsyncOutputWriter");
+
+    if (_thread.joinable()) {
+
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _cv.wait(lock, [this]{ return _n_pending == 0; });
+            _stop = true;
+            _cv.notify_all();
+        }
+
+        _thread.join();
+    }
+
+    // the I/O thread has stopped, and the files can be closed
+    std::map<std::string, std::ofstream*>::iterator
+    b_it   = _binary_files.begin(),
+    b_end  = _binary_files.end();
+
+    for ( ; b_it != b_end; b_it++) {
+        b_it->second->close();
+        delete b_it->second;
+    }
+    _binary_files.clear();
+
+    std::map<std::string, ExodusFile>::iterator
+    e_it   = _exodus_files.begin(),
+    e_end  = _exodus_files.end();
+
+    for ( ; e_it != e_end; e_it++)
+        delete e_it->second.io;
+    _exodus_files.clear();
+}
+
+
+
+void
+MAST::AsyncOutputWriter::_push(Buffer* b) {
+
+    std::unique_lock<std::mutex> lock(_mutex);
+
+    if (!_thread.joinable()) {
+
+        _stop   = false;
+        _thread = std::thread(&MAST::AsyncOutputWriter::_run, this);
+    }
+
+    // wait for a free buffer
+    _cv.wait(lock, [this]{ return _n_pending < _max_pending; });
+
+    _queue.push_back(b);
+    _n_pending++;
+    _cv.notify_all();
+}
+
+
+
+void
+MAST::AsyncOutputWriter::_run() {
+
+    while (true) {
+
+        Buffer* b = nullptr;
+
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _cv.wait(lock, [this]{ return _stop || !_queue.empty(); });
+
+            if (_queue.empty())
+                return;
+
+            b = _queue.front();
+            _queue.pop_front();
+        }
+
+        this->_write(*b);
+        delete b;
+
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _n_pending--;
+            _cv.notify_all();
+        }
+    }
+}
+
+
+
+void
+MAST::AsyncOutputWriter::_write(Buffer& b) {
+
+    MAST_LOG_SCOPE("write()", "AsyncOutputWriter");
+
+    switch (b.type) {
+
+        case EXODUS: {
+
+            libMesh::ExodusII_IO_Helper&
+            helper = b.exodus->io->get_exio_helper();
+
+            const unsigned int
+            n_vars  = b.exodus->n_vars,
+            n_nodes = n_vars ? (unsigned int)b.values.size()/n_vars : 0;
+
+            std::lock_guard<std::mutex> lock(_exodus_mutex);
+
+            helper.write_timestep(b.step, b.time);
+
+            // the solution vector stores the values of all variables of
+            // a node together
+            std::vector<Real> vals(n_nodes);
+
+            for (unsigned int c=0; c<n_vars; c++) {
+
+                for (unsigned int i=0; i<n_nodes; i++)
+                    vals[i] = b.values[i*n_vars+c];
+
+                helper.write_nodal_values(c+1, vals, b.step);
+            }
+        }
+            break;
+
+        case BINARY: {
+
+            std::ofstream*& out = _binary_files[b.fname];
+
+            if (!out) {
+                out = new std::ofstream(b.fname.c_str(),
+                                        std::ios::out | std::ios::binary);
+                if (!out->good())
+                    libmesh_error_msg("Unable to open file: " << b.fname);
+            }
+
+            const unsigned long long
+            n = b.values.size();
+
+            out->write((const char*)&b.step, sizeof(unsigned int));
+            out->write((const char*)&b.time, sizeof(Real));
+            out->write((const char*)&n,      sizeof(unsigned long long));
+            if (n)
+                out->write((const char*)&b.values[0], n*sizeof(Real));
+        }
+            break;
+
+        default:
+            libmesh_error();
+    }
+}
+
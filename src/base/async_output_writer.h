@@ -0,0 +1,244 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2017  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef __mast__async_output_writer__
+#define __mast__async_output_writer__
+
+// C++ includes
+#include <string>
+#include <vector>
+#include <deque>
+#include <map>
+#include <fstream>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+
+// MAST includes
+#include "base/mast_data_types.h"
+
+
+// libMesh includes
+#include "libmesh/parallel.h"
+
+
+namespace libMesh {
+
+    // Forward declerations
+    class EquationSystems;
+    class ExodusII_IO;
+    template <typename T> class NumericVector;
+}
+
+
+namespace MAST {
+
+    /*!
+     *    Writes the output of transient analyses and of parameter sweeps
+     *    from a background thread on processor 0, so that the time loop
+     *    does not wait on the file system. A write call only gathers the
+     *    data on processor 0 (which is a collective operation) and copies
+     *    it into a buffer. The buffer is then written by the I/O thread.
+     *    At most max_pending() buffers are pending at a time; the default
+     *    of 2 gives a double-buffered output. A write call blocks only if
+     *    all buffers are still pending. flush() waits until all pending
+     *    buffers are written, and is called by the destructor.
+     *
+     *    The Exodus file and the mesh are written when the first time
+     *    step is added to the file, after which the nodal values of the
+     *    time steps are written by the I/O thread. This requires a
+     *    replicated mesh, which must not be modified until the output is
+     *    flushed. The Exodus library is not thread-safe, so all Exodus
+     *    calls of both threads hold a common mutex, since the first time
+     *    step of a file may be written while the I/O thread writes
+     *    another file.
+     */
+    class AsyncOutputWriter {
+
+    public:
+
+        AsyncOutputWriter(const libMesh::Parallel::Communicator& comm);
+
+        /*!
+         *    flushes the pending output and stops the I/O thread
+         */
+        virtual ~AsyncOutputWriter();
+
+
+        /*!
+         *    sets the maximum number of buffers that can be pending for
+         *    the I/O thread. This must be at least 1.
+         */
+        void set_max_pending(unsigned int n);
+
+
+        /*!
+         *    @returns the maximum number of buffers pending for the
+         *    I/O thread.
+         */
+        unsigned int max_pending() const {
+            return _max_pending;
+        }
+
+
+        /*!
+         *    adds a time step at \p time with the nodal solution of all
+         *    systems in \p es to the Exodus file \p fname. The time steps
+         *    are numbered in the order in which they are written to the
+         *    file. This must be called on all processors.
+         */
+        void write_exodus_timestep(const std::string& fname,
+                                   libMesh::EquationSystems& es,
+                                   Real time);
+
+
+        /*!
+         *    appends the values of \p v to the binary file \p fname. A
+         *    record of the file stores the \p step and \p time as an
+         *    \p unsigned \p int and a Real, the size of the vector as an
+         *    \p unsigned \p long \p long, followed by the values as Reals.
+         *    This must be called on all processors.
+         */
+        void write_binary(const std::string& fname,
+                          const libMesh::NumericVector<Real>& v,
+                          unsigned int step,
+                          Real time);
+
+
+        /*!
+         *    waits until all pending output is written and closes the
+         *    files. This must be called on all processors.
+         */
+        void flush();
+
+    protected:
+
+        /*!
+         *    type of output of a buffer
+         */
+        enum OutputType {
+            EXODUS,
+            BINARY
+        };
+
+
+        /*!
+         *    data of an Exodus file
+         */
+        struct ExodusFile {
+
+            ExodusFile(): io(nullptr), n_vars(0), n_steps(0) { }
+
+            libMesh::ExodusII_IO*        io;
+            unsigned int                 n_vars;
+            unsigned int                 n_steps;
+        };
+
+
+        /*!
+         *    data copied for the I/O thread
+         */
+        struct Buffer {
+
+            Buffer(): type(BINARY), exodus(nullptr), step(0), time(0.) { }
+
+            OutputType                   type;
+            std::string                  fname;
+            ExodusFile*                  exodus;
+            unsigned int                 step;
+            Real                         time;
+            std::vector<Real>            values;
+        };
+
+
+        /*!
+         *    adds \p b to the queue of the I/O thread, after waiting for a
+         *    free buffer if needed. The I/O thread is started on the first
+         *    call.
+         */
+        void _push(Buffer* b);
+
+
+        /*!
+         *    loop of the I/O thread
+         */
+        void _run();
+
+
+        /*!
+         *    writes \p b to its file on the I/O thread
+         */
+        void _write(Buffer& b);
+
+
+        /*!
+         *    communicator of the processors that write the output
+         */
+        const libMesh::Parallel::Communicator& _comm;
+
+
+        /*!
+         *    maximum number of pending buffers
+         */
+        unsigned int                           _max_pending;
+
+        /*!
+         *    buffers waiting to be written, and the number of buffers
+         *    that are queued or being written
+         */
+        std::deque<Buffer*>                    _queue;
+
+        unsigned int                           _n_pending;
+
+        /*!
+         *    flag to stop the I/O thread
+         */
+        bool                                   _stop;
+
+        /*!
+         *    Exodus files written by this object. These are only accessed
+         *    by the calling thread, and the I/O thread uses the pointers
+         *    stored in the buffers.
+         */
+        std::map<std::string, ExodusFile>      _exodus_files;
+
+        /*!
+         *    binary files opened by the I/O thread
+         */
+        std::map<std::string, std::ofstream*>  _binary_files;
+
+        /*!
+         *    I/O thread, and the synchronization of the queue
+         */
+        std::thread                            _thread;
+
+        std::mutex                             _mutex;
+
+        /*!
+         *    held by both threads around all calls to the Exodus library
+         */
+        std::mutex                             _exodus_mutex;
+
+        std::condition_variable                _cv;
+    };
+}
+
+
+#endif // __mast__async_output_writer__
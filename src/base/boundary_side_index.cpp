@@ -0,0 +1,245 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2017  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+// C++ includes
+#include <algorithm>
+
+
+// MAST includes
+#include "base/boundary_side_index.h"
+#include "base/system_initialization.h"
+#include "base/nonlinear_system.h"
+
+
+// libMesh includes
+#include "libmesh/dof_map.h"
+#include "libmesh/mesh_base.h"
+#include "libmesh/boundary_info.h"
+#include "libmesh/fe_base.h"
+#include "libmesh/quadrature.h"
+#include "libmesh/numeric_vector.h"
+
+
+MAST::BoundarySideIndex::BoundarySideIndex():
+_n_vars(0),
+_max_side_radius(0.)
+{ }
+
+
+
+MAST::BoundarySideIndex::~BoundarySideIndex()
+{ }
+
+
+
+void
+MAST::BoundarySideIndex::clear() {
+    
+    _n_vars = 0;
+    _sides.clear();
+    _side_tree.clear();
+    _max_side_radius = 0.;
+}
+
+
+
+void
+MAST::BoundarySideIndex::init(MAST::SystemInitialization& sys,
+                              const std::set<libMesh::boundary_id_type>& bids) {
+    
+    this->clear();
+    
+    MAST::NonlinearSystem& system = sys.system();
+    
+    _n_vars = sys.n_vars();
+    libmesh_assert(_n_vars);
+    
+    // all variables are assumed to be of same type
+    const libMesh::FEType fe_type = sys.fetype(0);
+    for (unsigned int i=1; i != _n_vars; ++i)
+        libmesh_assert(fe_type == sys.fetype(i));
+    
+    const libMesh::BoundaryInfo& binfo = *system.get_mesh().boundary_info;
+    const libMesh::DofMap& dof_map     = system.get_dof_map();
+    const unsigned int rank            = system.comm().rank();
+    
+    // all available elements are included, so that points can be located
+    // on sides of elements of other processors as well
+    libMesh::MeshBase::const_element_iterator       el     =
+    system.get_mesh().active_elements_begin();
+    const libMesh::MeshBase::const_element_iterator end_el =
+    system.get_mesh().active_elements_end();
+    
+    for ( ; el != end_el; ++el) {
+        
+        const libMesh::Elem* elem = *el;
+        
+        for (unsigned short int n=0; n<elem->n_sides(); n++) {
+            
+            if (!binfo.n_boundary_ids(elem, n))
+                continue;
+            
+            // check if any of the boundary ids of this side is in the set
+            std::vector<libMesh::boundary_id_type> bc_ids = binfo.boundary_ids(elem, n);
+            bool if_surface = false;
+            for (unsigned int i=0; i<bc_ids.size(); i++)
+                if (bids.count(bc_ids[i])) {
+                    if_surface = true;
+                    break;
+                }
+            
+            if (!if_surface)
+                continue;
+            
+            // same quadrature as MAST::ElementBase::_get_side_fe_and_qrule()
+            std::auto_ptr<libMesh::FEBase>
+            fe(libMesh::FEBase::build(elem->dim(), fe_type).release());
+            std::auto_ptr<libMesh::QBase>
+            qrule(fe_type.default_quadrature_rule
+                  (elem->dim()-1, system.extra_quadrature_order).release());
+            fe->attach_quadrature_rule(qrule.get());
+            
+            const std::vector<std::vector<Real> >& phi   = fe->get_phi();
+            const std::vector<Real>& JxW                 = fe->get_JxW();
+            const std::vector<libMesh::Point>& xyz       = fe->get_xyz();
+            const std::vector<libMesh::Point>& normals   = fe->get_normals();
+            
+            fe->reinit(elem, n);
+            
+            _sides.push_back(MAST::BoundarySideIndex::Side());
+            MAST::BoundarySideIndex::Side& side = _sides.back();
+            
+            side.elem    = elem;
+            side.side    = n;
+            side.local   = (elem->processor_id() == rank);
+            side.JxW     = JxW;
+            side.xyz     = xyz;
+            side.normals = normals;
+            
+            dof_map.dof_indices(elem, side.dof_indices);
+            libmesh_assert_equal_to(side.dof_indices.size(), phi.size()*_n_vars);
+            
+            side.phi.setZero(phi.size(), JxW.size());
+            for (unsigned int i=0; i<phi.size(); i++)
+                for (unsigned int qp=0; qp<JxW.size(); qp++)
+                    side.phi(i, qp) = phi[i][qp];
+            
+            // bounding box of the nodes on the side
+            bool if_first = true;
+            for (unsigned int i=0; i<elem->n_nodes(); i++) {
+                
+                if (!elem->is_node_on_side(i, n))
+                    continue;
+                
+                const libMesh::Point& pt = elem->point(i);
+                
+                if (if_first) {
+                    side.box_min = pt;
+                    side.box_max = pt;
+                    if_first     = false;
+                }
+                else
+                    for (unsigned int j=0; j<3; j++) {
+                        side.box_min(j) = std::min(side.box_min(j), pt(j));
+                        side.box_max(j) = std::max(side.box_max(j), pt(j));
+                    }
+            }
+        }
+    }
+    
+    // tree over the box centers for the point location
+    std::vector<libMesh::Point> centers(_sides.size());
+    
+    for (unsigned int i=0; i<_sides.size(); i++) {
+        
+        const MAST::BoundarySideIndex::Side& side = _sides[i];
+        
+        centers[i]       = 0.5 * (side.box_min + side.box_max);
+        _max_side_radius = std::max(_max_side_radius,
+                                    0.5 * (side.box_max - side.box_min).norm());
+    }
+    
+    _side_tree.init(centers,
+                    std::max(1u, (unsigned int)system.get_mesh().spatial_dimension()));
+}
+
+
+
+const libMesh::Elem*
+MAST::BoundarySideIndex::find_elem(const libMesh::Point& p,
+                                   const Real tol) const {
+    
+    // a point in the expanded box of a side is within the largest box
+    // radius, and the diagonal of the largest expansion, of its center
+    const Real
+    r = _max_side_radius + 2. * tol * (1. + 2. * _max_side_radius);
+    
+    std::vector<unsigned int> ids;
+    _side_tree.find(p, r, ids);
+    
+    // the sides are checked in the order of the index, so that the same
+    // element is returned for a point on a shared edge of two sides
+    std::sort(ids.begin(), ids.end());
+    
+    for (unsigned int k=0; k<ids.size(); k++) {
+        
+        const MAST::BoundarySideIndex::Side& side = _sides[ids[k]];
+        
+        // the bounding box is expanded by the tolerance relative to
+        // its size, since the box of a planar side has zero thickness
+        const Real
+        eps = tol * (1. + (side.box_max - side.box_min).norm());
+        
+        bool if_in_box = true;
+        for (unsigned int j=0; j<3; j++)
+            if (p(j) < side.box_min(j) - eps ||
+                p(j) > side.box_max(j) + eps) {
+                if_in_box = false;
+                break;
+            }
+        
+        if (if_in_box && side.elem->contains_point(p, tol))
+            return side.elem;
+    }
+    
+    return nullptr;
+}
+
+
+
+void
+MAST::BoundarySideIndex::qp_values(unsigned int i,
+                                   const libMesh::NumericVector<Real>& sol,
+                                   RealMatrixX& v) const {
+    
+    const MAST::BoundarySideIndex::Side& side = this->side(i);
+    
+    const unsigned int
+    n_phi = (unsigned int)side.phi.rows();
+    
+    RealVectorX
+    vals = RealVectorX::Zero(side.dof_indices.size());
+    if (vals.size())
+        sol.get(side.dof_indices, vals.data());
+    
+    // the dofs are ordered by variable
+    v = Eigen::Map<const RealMatrixX>(vals.data(), n_phi, _n_vars).transpose() * side.phi;
+}
+
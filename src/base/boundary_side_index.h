@@ -0,0 +1,184 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2017  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+#ifndef __mast__boundary_side_index__
+#define __mast__boundary_side_index__
+
+// C++ includes
+#include <set>
+#include <vector>
+
+
+// MAST includes
+#include "base/mast_data_types.h"
+#include "numerics/point_tree.h"
+
+
+// libMesh includes
+#include "libmesh/point.h"
+#include "libmesh/elem.h"
+
+
+namespace MAST {
+    
+    // Forward declerations
+    class SystemInitialization;
+    
+    
+    /*!
+     *    Compact list of the element sides of a system on a set of boundary
+     *    ids, for example the fluid sides on the coupled FSI surface. For
+     *    each side, the dof indices of the element, and the shape function
+     *    values, quadrature weights, locations and normals at the side
+     *    quadrature points are computed once in init(). Surface quantities
+     *    can then be evaluated by streaming over the sides, without a loop
+     *    over all elements of the mesh, and points on the surface can be
+     *    located among the boundary sides only.
+     *
+     *    All variables of the system are assumed to have the same FE type,
+     *    so that the dofs of variable \p i are stored in
+     *    [i*n_phi, (i+1)*n_phi) of the dof indices of a side. The index
+     *    must be rebuilt if the mesh or the dof numbering changes.
+     */
+    class BoundarySideIndex {
+        
+    public:
+        
+        /*!
+         *   data of a boundary side
+         */
+        struct Side {
+            
+            /*!
+             *   element and its side on the boundary
+             */
+            const libMesh::Elem*                 elem;
+            unsigned int                         side;
+            
+            /*!
+             *   \p true if the element is local to this processor
+             */
+            bool                                 local;
+            
+            /*!
+             *   dof indices of all variables of the element
+             */
+            std::vector<libMesh::dof_id_type>    dof_indices;
+            
+            /*!
+             *   n_phi x n_qp matrix of shape function values
+             */
+            RealMatrixX                          phi;
+            
+            /*!
+             *   quadrature weights, locations and normals
+             */
+            std::vector<Real>                    JxW;
+            std::vector<libMesh::Point>          xyz;
+            std::vector<libMesh::Point>          normals;
+            
+            /*!
+             *   bounding box of the side nodes
+             */
+            libMesh::Point                       box_min;
+            libMesh::Point                       box_max;
+        };
+        
+        
+        BoundarySideIndex();
+        
+        
+        virtual ~BoundarySideIndex();
+        
+        
+        /*!
+         *   builds the index for the sides of the active elements of
+         *   \p sys with any of the boundary ids in \p bids.
+         */
+        void init(MAST::SystemInitialization& sys,
+                  const std::set<libMesh::boundary_id_type>& bids);
+        
+        
+        /*!
+         *   clears the data of all sides
+         */
+        void clear();
+        
+        
+        /*!
+         *   @returns the number of sides in the index
+         */
+        unsigned int n_sides() const {
+            return (unsigned int)_sides.size();
+        }
+        
+        
+        /*!
+         *   @returns the data of side \p i
+         */
+        const MAST::BoundarySideIndex::Side& side(unsigned int i) const {
+            
+            libmesh_assert_less(i, _sides.size());
+            return _sides[i];
+        }
+        
+        
+        /*!
+         *   @returns the element with a side in the index that contains
+         *   the point \p p, within tolerance \p tol, or nullptr if no such
+         *   side is found. The candidate sides are found with a k-d tree
+         *   over the centers of the side bounding boxes.
+         */
+        const libMesh::Elem* find_elem(const libMesh::Point& p,
+                                       const Real tol = 1.e-8) const;
+        
+        
+        /*!
+         *   computes the values of the variables at the quadrature points
+         *   of side \p i from the localized solution \p sol, and returns
+         *   them as the columns of \p v.
+         */
+        void qp_values(unsigned int i,
+                       const libMesh::NumericVector<Real>& sol,
+                       RealMatrixX& v) const;
+        
+    protected:
+        
+        /*!
+         *   number of variables of the system
+         */
+        unsigned int                                 _n_vars;
+        
+        /*!
+         *   sides in the index
+         */
+        std::vector<MAST::BoundarySideIndex::Side>   _sides;
+        
+        /*!
+         *   k-d tree over the centers of the bounding boxes of the sides,
+         *   and the largest distance of a box corner from its center
+         */
+        MAST::PointTree                              _side_tree;
+        
+        Real                                         _max_side_radius;
+    };
+}
+
+#endif // __mast__boundary_side_index__
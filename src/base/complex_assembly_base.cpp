@@ -28,6 +28,7 @@
 #include "solver/complex_solver_base.h"
 #include "base/parameter.h"
 #include "base/nonlinear_system.h"
+#include "base/performance_log.h"
 
 
 // libMesh includes
@@ -98,6 +99,12 @@ void
 MAST::ComplexAssemblyBase::
 clear_discipline_and_system( ) {
     
+    // the element objects, localized vectors and output element lists
+    // refer to the system, and are no longer valid
+    this->clear_elem_objects();
+    this->clear_output_elems();
+    this->clear_localized_vectors();
+    
     if (_system && _discipline) {
         
         _system->system().nonlinear_solver->residual_and_jacobian_object =
@@ -188,7 +195,10 @@ MAST::ComplexAssemblyBase::residual_l2_norm() {
     
     std::vector<libMesh::dof_id_type> dof_indices;
     const libMesh::DofMap& dof_map = nonlin_sys.get_dof_map();
-    std::auto_ptr<MAST::ElementBase> physics_elem;
+    const MAST::ElementTopologyCache& topology = nonlin_sys.topology_cache();
+    std::auto_ptr<MAST::ElementBase> elem_storage;
+    MAST::ElementBase* physics_elem = nullptr;
+    DenseRealVector v;
     
     std::auto_ptr<libMesh::NumericVector<Real> >
     residual_re(nonlin_sys.solution->zero_clone().release()),
@@ -222,9 +232,9 @@ MAST::ComplexAssemblyBase::residual_l2_norm() {
         
         const libMesh::Elem* elem = *el;
         
-        dof_map.dof_indices (elem, dof_indices);
+        topology.dof_indices (elem, dof_indices);
         
-        physics_elem.reset(_build_elem(*elem).release());
+        physics_elem = &_get_elem(*elem, elem_storage);
         
         // get the solution
         unsigned int ndofs = (unsigned int)dof_indices.size();
@@ -238,8 +248,7 @@ MAST::ComplexAssemblyBase::residual_l2_norm() {
         
         // set the value of the base solution, if provided
         if (_base_sol)
-            for (unsigned int i=0; i<dof_indices.size(); i++)
-                sol(i) = (*localized_base_solution)(dof_indices[i]);
+            _get_elem_values(*localized_base_solution, dof_indices, sol);
         physics_elem->set_solution(sol);
         
         // set the value of the small-disturbance solution
@@ -263,7 +272,6 @@ MAST::ComplexAssemblyBase::residual_l2_norm() {
         
         // add to the real part of the residual
         vec_re  =  vec.real();
-        DenseRealVector v;
         MAST::copy(v, vec_re);
         dof_map.constrain_element_vector(v, dof_indices);
         residual_re->add_vector(v, dof_indices);
@@ -323,7 +331,11 @@ residual_and_jacobian (const libMesh::NumericVector<Real>& X,
     
     std::vector<libMesh::dof_id_type> dof_indices;
     const libMesh::DofMap& dof_map = _system->system().get_dof_map();
-    std::auto_ptr<MAST::ElementBase> physics_elem;
+    const MAST::ElementTopologyCache& topology = _system->system().topology_cache();
+    std::auto_ptr<MAST::ElementBase> elem_storage;
+    MAST::ElementBase* physics_elem = nullptr;
+    DenseRealVector v;
+    DenseRealMatrix m;
     
     std::auto_ptr<libMesh::NumericVector<Real> >
     localized_base_solution,
@@ -375,9 +387,9 @@ residual_and_jacobian (const libMesh::NumericVector<Real>& X,
         
         const libMesh::Elem* elem = *el;
         
-        dof_map.dof_indices (elem, dof_indices);
+        topology.dof_indices (elem, dof_indices);
         
-        physics_elem.reset(_build_elem(*elem).release());
+        physics_elem = &_get_elem(*elem, elem_storage);
         
         // get the solution
         unsigned int ndofs = (unsigned int)dof_indices.size();
@@ -391,8 +403,7 @@ residual_and_jacobian (const libMesh::NumericVector<Real>& X,
         
         // next, set the base solution, if provided
         if (_base_sol)
-            for (unsigned int i=0; i<dof_indices.size(); i++)
-                sol(i) = (*localized_base_solution)(dof_indices[i]);
+            _get_elem_values(*localized_base_solution, dof_indices, sol);
         
         physics_elem->set_solution(sol);
         
@@ -438,19 +449,20 @@ residual_and_jacobian (const libMesh::NumericVector<Real>& X,
         }
         
         // copy to the libMesh matrix for further processing
-        DenseRealVector v;
-        DenseRealMatrix m;
         if (R) MAST::copy(v, vec_re);
         if (J) MAST::copy(m, mat_re);
         
         // constrain the quantities to account for hanging dofs,
         // Dirichlet constraints, etc.
-        if (R && J)
-            dof_map.constrain_element_matrix_and_vector(m, v, dof_indices);
-        else if (R)
-            dof_map.constrain_element_vector(v, dof_indices);
-        else
-            dof_map.constrain_element_matrix(m, dof_indices);
+        if (topology.has_constrained_dofs(*elem)) {
+            
+            if (R && J)
+                dof_map.constrain_element_matrix_and_vector(m, v, dof_indices);
+            else if (R)
+                dof_map.constrain_element_vector(v, dof_indices);
+            else
+                dof_map.constrain_element_matrix(m, dof_indices);
+        }
         
         // add to the global matrices
         if (R) R->add_vector(v, dof_indices);
@@ -504,7 +516,11 @@ residual_and_jacobian_field_split (const libMesh::NumericVector<Real>& X_R,
     
     std::vector<libMesh::dof_id_type> dof_indices;
     const libMesh::DofMap& dof_map = _system->system().get_dof_map();
-    std::auto_ptr<MAST::ElementBase> physics_elem;
+    const MAST::ElementTopologyCache& topology = _system->system().topology_cache();
+    std::auto_ptr<MAST::ElementBase> elem_storage;
+    MAST::ElementBase* physics_elem = nullptr;
+    DenseRealVector v;
+    DenseRealMatrix m;
     
     std::auto_ptr<libMesh::NumericVector<Real> >
     localized_base_solution,
@@ -541,9 +557,9 @@ residual_and_jacobian_field_split (const libMesh::NumericVector<Real>& X_R,
         
         const libMesh::Elem* elem = *el;
         
-        dof_map.dof_indices (elem, dof_indices);
+        topology.dof_indices (elem, dof_indices);
         
-        physics_elem.reset(_build_elem(*elem).release());
+        physics_elem = &_get_elem(*elem, elem_storage);
         
         // get the solution
         unsigned int ndofs = (unsigned int)dof_indices.size();
@@ -557,8 +573,7 @@ residual_and_jacobian_field_split (const libMesh::NumericVector<Real>& X_R,
         
         // next, set the base solution, if provided
         if (_base_sol)
-            for (unsigned int i=0; i<dof_indices.size(); i++)
-                sol(i) = (*localized_base_solution)(dof_indices[i]);
+            _get_elem_values(*localized_base_solution, dof_indices, sol);
         
         physics_elem->set_solution(sol);
         
@@ -591,8 +606,6 @@ residual_and_jacobian_field_split (const libMesh::NumericVector<Real>& X_R,
         //     [ J_R   -J_I] {x_R}  +  {r_R}  = {0}
         //     [ J_I    J_R] {x_I}  +  {r_I}  = {0}
         //
-        DenseRealVector v;
-        DenseRealMatrix m;
 
         // copy the real part of the residual and Jacobian
         MAST::copy(v, vec.real());
@@ -637,7 +650,7 @@ void
 MAST::ComplexAssemblyBase::
 residual_and_jacobian_blocked (const libMesh::NumericVector<Real>& X,
                                libMesh::NumericVector<Real>& R,
-                               libMesh::SparseMatrix<Real>&  J,
+                               libMesh::SparseMatrix<Real>*  J,
                                libMesh::NonlinearImplicitSystem& S,
                                MAST::Parameter* p) {
 
@@ -650,7 +663,7 @@ residual_and_jacobian_blocked (const libMesh::NumericVector<Real>& X,
     libmesh_assert_equal_to(&S, &(nonlin_sys));
     
     R.zero();
-    J.zero();
+    if (J) J->zero();
     
     // iterate over each element, initialize it and get the relevant
     // analysis quantities
@@ -665,16 +678,27 @@ residual_and_jacobian_blocked (const libMesh::NumericVector<Real>& X,
 
     // get the petsc vector and matrix objects
     Mat
-    jac_bmat = dynamic_cast<libMesh::PetscMatrix<Real>&>(J).mat();
+    jac_bmat = J? dynamic_cast<libMesh::PetscMatrix<Real>*>(J)->mat(): PETSC_NULL;
     
     PetscInt ierr;
     
     std::vector<libMesh::dof_id_type> dof_indices;
     const libMesh::DofMap& dof_map = nonlin_sys.get_dof_map();
+    const MAST::ElementTopologyCache& topology = nonlin_sys.topology_cache();
     const std::vector<libMesh::dof_id_type>&
     send_list = nonlin_sys.get_dof_map().get_send_list();
     
-    std::auto_ptr<MAST::ElementBase> physics_elem;
+    std::auto_ptr<MAST::ElementBase> elem_storage;
+    
+    MAST::ElementBase* physics_elem = nullptr;
+    DenseRealVector v_R, v_I;
+    DenseRealMatrix m_R, m_I1, m_I2;
+    
+    // the element residual and Jacobian are scattered with the real and
+    // imaginary parts of a dof as adjacent entries
+    std::vector<Real>                 v_blk, m_blk;
+    std::vector<libMesh::dof_id_type> blk_dof_indices;
+    std::vector<PetscInt>             blk_indices;
     
     std::auto_ptr<libMesh::NumericVector<Real> >
     localized_base_solution,
@@ -718,9 +742,9 @@ residual_and_jacobian_blocked (const libMesh::NumericVector<Real>& X,
         
         const libMesh::Elem* elem = *el;
         
-        dof_map.dof_indices (elem, dof_indices);
+        topology.dof_indices (elem, dof_indices);
         
-        physics_elem.reset(_build_elem(*elem).release());
+        physics_elem = &_get_elem(*elem, elem_storage);
         
         // get the solution
         unsigned int ndofs = (unsigned int)dof_indices.size();
@@ -734,8 +758,7 @@ residual_and_jacobian_blocked (const libMesh::NumericVector<Real>& X,
         
         // next, set the base solution, if provided
         if (_base_sol)
-            for (unsigned int i=0; i<dof_indices.size(); i++)
-                sol(i) = (*localized_base_solution)(dof_indices[i]);
+            _get_elem_values(*localized_base_solution, dof_indices, sol);
         
         physics_elem->set_solution(sol);
         
@@ -755,7 +778,7 @@ residual_and_jacobian_blocked (const libMesh::NumericVector<Real>& X,
         
         
         // perform the element level calculations
-        _elem_calculations(*physics_elem, true, vec, mat);
+        _elem_calculations(*physics_elem, J != nullptr, vec, mat);
         
         // if sensitivity was requested, then ask the element for sensitivity
         // of the residual
@@ -780,10 +803,6 @@ residual_and_jacobian_blocked (const libMesh::NumericVector<Real>& X,
         //     [ J_R   -J_I] {x_R}  +  {r_R}  = {0}
         //     [ J_I    J_R] {x_I}  +  {r_I}  = {0}
         //
-        DenseRealVector v_R, v_I;
-        DenseRealMatrix m_R, m_I1, m_I2;
-        std::vector<Real> vals(4);
-        
         // copy the real part of the residual and Jacobian
         MAST::copy( m_R, mat.real());
         MAST::copy(m_I1, mat.imag()); m_I1 *= -1.;   // this is the -J_I component
@@ -797,22 +816,46 @@ residual_and_jacobian_blocked (const libMesh::NumericVector<Real>& X,
         dof_map.constrain_element_vector(v_I,  dof_indices);
         
         
-        for (unsigned int i=0; i<dof_indices.size(); i++) {
-         
-            R.add(2*dof_indices[i],     v_R(i));
-            R.add(2*dof_indices[i]+1,   v_I(i));
+        v_blk.resize(2*ndofs);
+        blk_dof_indices.resize(2*ndofs);
+        
+        for (unsigned int i=0; i<ndofs; i++) {
+            
+            v_blk[2*i  ]           = v_R(i);
+            v_blk[2*i+1]           = v_I(i);
+            blk_dof_indices[2*i  ] = 2*dof_indices[i];
+            blk_dof_indices[2*i+1] = 2*dof_indices[i]+1;
+        }
+        
+        R.add_vector(v_blk, blk_dof_indices);
+        
+        // the 2x2 blocks of all dofs of the element are added with a
+        // single call, for which the values are stored row-wise in a
+        // (2 ndofs) x (2 ndofs) array
+        if (J) {
+            
+            m_blk.resize(4*ndofs*ndofs);
+            blk_indices.resize(ndofs);
+            
+            for (unsigned int i=0; i<ndofs; i++) {
+                
+                blk_indices[i] = dof_indices[i];
+                
+                for (unsigned int j=0; j<ndofs; j++) {
+                    
+                    m_blk[(2*i  )*2*ndofs+2*j  ] = m_R (i,j);
+                    m_blk[(2*i  )*2*ndofs+2*j+1] = m_I1(i,j);
+                    m_blk[(2*i+1)*2*ndofs+2*j  ] = m_I2(i,j);
+                    m_blk[(2*i+1)*2*ndofs+2*j+1] = m_R (i,j);
+                }
+            }
             
-            for (unsigned int j=0; j<dof_indices.size(); j++) {
-                vals[0] = m_R (i,j);
-                vals[1] = m_I1(i,j);
-                vals[2] = m_I2(i,j);
-                vals[3] = m_R (i,j);
             ierr = MatSetValuesBlocked(jac_bmat,
-                                       1, (PetscInt*)&dof_indices[i],
-                                       1, (PetscInt*)&dof_indices[j],
-                                       &vals[0],
+                                       ndofs, &blk_indices[0],
+                                       ndofs, &blk_indices[0],
+                                       &m_blk[0],
                                        ADD_VALUES);
-            }
+            CHKERRABORT(nonlin_sys.comm().get(), ierr);
         }
     }
     
@@ -822,7 +865,7 @@ residual_and_jacobian_blocked (const libMesh::NumericVector<Real>& X,
     //    _sol_function->clear();
     
     R.close();
-    J.close();
+    if (J) J->close();
     
     libMesh::out << "R: " << R.l2_norm() << std::endl;
     STOP_LOG("residual_and_jacobian()", "ComplexSolve");
@@ -833,6 +876,147 @@ residual_and_jacobian_blocked (const libMesh::NumericVector<Real>& X,
 
 
 
+void
+MAST::ComplexAssemblyBase::
+residual_and_jacobian_complex (const libMesh::NumericVector<Real>& X_R,
+                               const libMesh::NumericVector<Real>& X_I,
+                               ComplexVectorX& R,
+                               std::vector<Eigen::Triplet<Complex> >& J,
+                               libMesh::NonlinearImplicitSystem& S,
+                               MAST::Parameter* p) {
+    
+    MAST_LOG_SCOPE("residual_and_jacobian_complex()", "ComplexAssemblyBase");
+    
+    MAST::NonlinearSystem& nonlin_sys = _system->system();
+    
+    // make sure that the system for which this object was created,
+    // and the system passed through the function call are the same
+    libmesh_assert_equal_to(&S, &(nonlin_sys));
+    libmesh_assert_equal_to(R.size(), nonlin_sys.n_dofs());
+    
+    // iterate over each element, initialize it and get the relevant
+    // analysis quantities
+    RealVectorX
+    sol,
+    delta_sol_re,
+    delta_sol_im;
+    ComplexVectorX
+    delta_sol,
+    vec;
+    ComplexMatrixX
+    mat,
+    dummy;
+    
+    std::vector<libMesh::dof_id_type> dof_indices;
+    const libMesh::DofMap& dof_map = nonlin_sys.get_dof_map();
+    const MAST::ElementTopologyCache& topology = nonlin_sys.topology_cache();
+    std::auto_ptr<MAST::ElementBase> elem_storage;
+    MAST::ElementBase* physics_elem = nullptr;
+    DenseRealVector v_R, v_I;
+    DenseRealMatrix m_R, m_I;
+    
+    std::auto_ptr<libMesh::NumericVector<Real> >
+    localized_base_solution,
+    localized_real_solution,
+    localized_imag_solution;
+    
+    // localize the base solution, if it was provided
+    if (_base_sol)
+        localized_base_solution.reset(_build_localized_vector(nonlin_sys,
+                                                              *_base_sol).release());
+    
+    localized_real_solution.reset(_build_localized_vector(nonlin_sys,
+                                                          X_R).release());
+    localized_imag_solution.reset(_build_localized_vector(nonlin_sys,
+                                                          X_I).release());
+    
+    
+    libMesh::MeshBase::const_element_iterator       el     =
+    nonlin_sys.get_mesh().active_local_elements_begin();
+    const libMesh::MeshBase::const_element_iterator end_el =
+    nonlin_sys.get_mesh().active_local_elements_end();
+    
+    
+    for ( ; el != end_el; ++el) {
+        
+        const libMesh::Elem* elem = *el;
+        
+        topology.dof_indices (elem, dof_indices);
+        
+        physics_elem = &_get_elem(*elem, elem_storage);
+        
+        // get the solution
+        unsigned int ndofs = (unsigned int)dof_indices.size();
+        sol.setZero(ndofs);
+        delta_sol.setZero(ndofs);
+        vec.setZero(ndofs);
+        mat.setZero(ndofs, ndofs);
+        
+        // first set the velocity to be zero
+        physics_elem->set_velocity(sol);
+        
+        // next, set the base solution, if provided
+        if (_base_sol)
+            _get_elem_values(*localized_base_solution, dof_indices, sol);
+        
+        physics_elem->set_solution(sol);
+        
+        // set the value of the small-disturbance solution
+        _get_elem_values(*localized_real_solution, dof_indices, delta_sol_re);
+        _get_elem_values(*localized_imag_solution, dof_indices, delta_sol_im);
+        delta_sol.real() = delta_sol_re;
+        delta_sol.imag() = delta_sol_im;
+        
+        physics_elem->set_complex_solution(delta_sol);
+        
+        
+        if (_sol_function)
+            physics_elem->attach_active_solution_function(*_sol_function);
+        
+        
+        // perform the element level calculations
+        _elem_calculations(*physics_elem, true, vec, mat);
+        
+        // if sensitivity was requested, then ask the element for sensitivity
+        // of the residual
+        if (p) {
+            
+            physics_elem->sensitivity_param = p;
+            // set the sensitivity of complex sol to zero
+            delta_sol.setZero();
+            physics_elem->set_complex_solution(delta_sol, true);
+            vec.setZero();
+            _elem_sensitivity_calculations(*physics_elem, false, vec, dummy);
+        }
+        
+        // the constraints are real, and are applied to the real and
+        // imaginary parts separately
+        MAST::copy(m_R, mat.real());
+        MAST::copy(m_I, mat.imag());
+        MAST::copy(v_R, vec.real());
+        MAST::copy(v_I, vec.imag());
+        dof_map.constrain_element_matrix(m_R, dof_indices);
+        dof_map.constrain_element_matrix(m_I, dof_indices);
+        dof_map.constrain_element_vector(v_R, dof_indices);
+        dof_map.constrain_element_vector(v_I, dof_indices);
+        
+        for (unsigned int i=0; i<dof_indices.size(); i++) {
+            
+            R(dof_indices[i]) += Complex(v_R(i), v_I(i));
+            
+            for (unsigned int j=0; j<dof_indices.size(); j++)
+                J.push_back(Eigen::Triplet<Complex>(dof_indices[i],
+                                                    dof_indices[j],
+                                                    Complex(m_R(i,j), m_I(i,j))));
+        }
+    }
+}
+
+
+
+
+
+
 bool
 MAST::ComplexAssemblyBase::
 sensitivity_assemble (const libMesh::ParameterVector& parameters,
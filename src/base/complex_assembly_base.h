@@ -27,6 +27,9 @@
 // libMesh includes
 #include "libmesh/nonlinear_implicit_system.h"
 
+// Eigen includes
+#include "Eigen/Sparse"
+
 
 
 namespace MAST {
@@ -36,6 +39,17 @@ namespace MAST {
     class Parameter;
     
     
+    /*!
+     *   part of a frequency-domain operator, A(omega) = A_0 + omega A_1,
+     *   that the element calculations are asked to provide.
+     */
+    enum FrequencyDomainOperator {
+        FULL_FREQUENCY_OPERATOR,          // A(omega) at the current frequency
+        FREQUENCY_INDEPENDENT_OPERATOR,   // A_0
+        FREQUENCY_COEFFICIENT_OPERATOR    // A_1
+    };
+    
+    
     class ComplexAssemblyBase:
     public MAST::AssemblyBase,
     public libMesh::NonlinearImplicitSystem::ComputeResidualandJacobian {
@@ -138,6 +152,20 @@ namespace MAST {
          *   Eigen problem, false otherwise
          */
         bool if_linearized_about_nonzero_solution() const;
+        
+        
+        /*!
+         *   tells the assembly to compute the part \p op of the
+         *   frequency-domain operator and residual. This is used to assemble
+         *   the frequency independent quantities once for multiple
+         *   frequencies. The default implementation supports only
+         *   MAST::FULL_FREQUENCY_OPERATOR.
+         */
+        virtual void set_frequency_operator(MAST::FrequencyDomainOperator op) {
+            
+            if (op != MAST::FULL_FREQUENCY_OPERATOR)
+                libmesh_error_msg("Error! Frequency operator split not supported by this assembly.");
+        }
 
         
         /*!
@@ -173,12 +201,37 @@ namespace MAST {
          *   is the current complex solution with the real and imaginary parts 
          *   of each element stored as adjacent entries. Likewise, the Jaacobian
          *   matrix has a 2x2 block storage. If \par p is provided, then \par R
-         *   will return the sensitivity of the residual vector.
+         *   will return the sensitivity of the residual vector. The
+         *   Jacobian is not assembled if \par J is \p nullptr. Unlike
+         *   residual_and_jacobian(), which keeps only the part selected with
+         *   set_assemble_real_part() or set_assemble_imag_part(), the
+         *   complex element quantities are computed once and the 2x2 blocks
+         *   of all dofs of an element are added in a single call.
          */
         void
         residual_and_jacobian_blocked (const libMesh::NumericVector<Real>& X,
                                        libMesh::NumericVector<Real>& R,
-                                       libMesh::SparseMatrix<Real>&  J,
+                                       libMesh::SparseMatrix<Real>*  J,
+                                       libMesh::NonlinearImplicitSystem& S,
+                                       MAST::Parameter* p = nullptr);
+        
+        
+        /*!
+         *   Assembles the residual and Jacobian of the complex system of
+         *   equations in complex arithmetic, in a single pass over the
+         *   elements. \par X_R and \par X_I are the real and imaginary
+         *   parts of the current complex solution. The residual from the
+         *   local elements is added to \par R, which must be sized to the
+         *   number of system dofs. The Jacobian entries from the local
+         *   elements are appended to \par J as (row, column, value)
+         *   triplets with global dof indices. If \par p is provided, then
+         *   \par R will return the sensitivity of the residual vector.
+         */
+        void
+        residual_and_jacobian_complex (const libMesh::NumericVector<Real>& X_R,
+                                       const libMesh::NumericVector<Real>& X_I,
+                                       ComplexVectorX& R,
+                                       std::vector<Eigen::Triplet<Complex> >& J,
                                        libMesh::NonlinearImplicitSystem& S,
                                        MAST::Parameter* p = nullptr);
 
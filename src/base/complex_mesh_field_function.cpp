@@ -21,6 +21,7 @@
 #include "base/complex_mesh_field_function.h"
 #include "base/system_initialization.h"
 #include "base/nonlinear_system.h"
+#include "base/mesh_field_transfer_operator.h"
 
 // libMesh includes
 #include "libmesh/dof_map.h"
@@ -39,7 +40,8 @@ _perturbed_sol_im(nullptr),
 _function_re(nullptr),
 _function_im(nullptr),
 _perturbed_function_re(nullptr),
-_perturbed_function_im(nullptr)
+_perturbed_function_im(nullptr),
+_transfer(nullptr)
 { }
 
 
@@ -60,37 +62,18 @@ init(const libMesh::NumericVector<Real>& sol_re,
      const libMesh::NumericVector<Real>& sol_im) {
     
     // first make sure that the object is not already initialized
-    libmesh_assert(!_function_re);
+    libmesh_assert(!_sol_re);
     
     MAST::NonlinearSystem& system = _system->system();
     
-    // next, clone this solution and localize to the sendlist
-    _sol_re = libMesh::NumericVector<Real>::build(system.comm()).release();
-    _sol_im = libMesh::NumericVector<Real>::build(system.comm()).release();
-    
-    const std::vector<libMesh::dof_id_type>& send_list =
-    system.get_dof_map().get_send_list();
-    
-    // initialize and then localize the vector with the provided solution
-    /*_sol_re->init(system.n_dofs(),
-                  system.n_local_dofs(),
-                  send_list,
-                  false,
-                  libMesh::GHOSTED);
-    sol_re.localize(*_sol_re, send_list);
-    
-    _sol_im->init(system.n_dofs(),
-                  system.n_local_dofs(),
-                  send_list,
-                  false,
-                  libMesh::GHOSTED);
-    sol_im.localize(*_sol_im, send_list);*/
-
-    _sol_re->init(sol_re.size(), true, libMesh::SERIAL);
-    sol_re.localize(*_sol_re);
-    _sol_im->init(sol_im.size(), true, libMesh::SERIAL);
-    sol_im.localize(*_sol_im);
-
+    // the vectors store the values needed for interpolation, which is
+    // only the ghosted part of the solution for a distributed mesh
+    _sol_re = MAST::build_localized_interpolation_vector(*_system, sol_re, _transfer);
+    _sol_im = MAST::build_localized_interpolation_vector(*_system, sol_im, _transfer);
+
+    // the mesh functions are not needed with the transfer operator
+    if (_transfer)
+        return;
     
     // finally, create the mesh interpolation function
     _function_re = new libMesh::MeshFunction(system.get_equation_systems(),
@@ -115,36 +98,20 @@ init_perturbation(const libMesh::NumericVector<Real>& sol_re,
                   const libMesh::NumericVector<Real>& sol_im) {
     
     // first make sure that the object is not already initialized
-    libmesh_assert(!_perturbed_function_re);
+    libmesh_assert(!_perturbed_sol_re);
     
     MAST::NonlinearSystem& system = _system->system();
     
-    // next, clone this solution and localize to the sendlist
-    _perturbed_sol_re = libMesh::NumericVector<Real>::build(system.comm()).release();
-    _perturbed_sol_im = libMesh::NumericVector<Real>::build(system.comm()).release();
-    
-    const std::vector<libMesh::dof_id_type>& send_list =
-    system.get_dof_map().get_send_list();
-    
-    // initialize and then localize the vector with the provided solution
-    /*_perturbed_sol_re->init(system.n_dofs(),
-                            system.n_local_dofs(),
-                            send_list,
-                            false,
-                            libMesh::GHOSTED);
-    sol_re.localize(*_sol_re, send_list);
-    
-    _perturbed_sol_im->init(system.n_dofs(),
-                            system.n_local_dofs(),
-                            send_list,
-                            false,
-                            libMesh::GHOSTED);
-    sol_im.localize(*_perturbed_sol_im, send_list);*/
-    _perturbed_sol_re->init(sol_re.size(), true, libMesh::SERIAL);
-    sol_re.localize(*_perturbed_sol_re);
-    _perturbed_sol_im->init(sol_im.size(), true, libMesh::SERIAL);
-    sol_im.localize(*_perturbed_sol_im);
+    // the vectors store the values needed for interpolation, which is
+    // only the ghosted part of the solution for a distributed mesh
+    _perturbed_sol_re =
+    MAST::build_localized_interpolation_vector(*_system, sol_re, _transfer);
+    _perturbed_sol_im =
+    MAST::build_localized_interpolation_vector(*_system, sol_im, _transfer);
     
+    // the mesh functions are not needed with the transfer operator
+    if (_transfer)
+        return;
     
     // finally, create the mesh interpolation function
     _perturbed_function_re = new libMesh::MeshFunction(system.get_equation_systems(),
@@ -163,11 +130,62 @@ init_perturbation(const libMesh::NumericVector<Real>& sol_re,
 
 
 
+bool
+MAST::ComplexMeshFieldFunction::
+update(const libMesh::NumericVector<Real>& sol_re,
+       const libMesh::NumericVector<Real>& sol_im) {
+    
+    libmesh_assert(_sol_re);
+    
+    bool
+    changed = MAST::update_localized_interpolation_vector(*_system, sol_re, *_sol_re, _transfer);
+    
+    if (MAST::update_localized_interpolation_vector(*_system, sol_im, *_sol_im, _transfer))
+        changed = true;
+    
+    if (changed)
+        _increment_version();
+    
+    return changed;
+}
+
+
+
+
+bool
+MAST::ComplexMeshFieldFunction::
+update_perturbation(const libMesh::NumericVector<Real>& dsol_re,
+                    const libMesh::NumericVector<Real>& dsol_im) {
+    
+    libmesh_assert(_perturbed_sol_re);
+    
+    bool
+    changed = MAST::update_localized_interpolation_vector(*_system, dsol_re, *_perturbed_sol_re, _transfer);
+    
+    if (MAST::update_localized_interpolation_vector(*_system, dsol_im, *_perturbed_sol_im, _transfer))
+        changed = true;
+    
+    if (changed)
+        _increment_version();
+    
+    return changed;
+}
+
+
+
+
 void
 MAST::ComplexMeshFieldFunction::operator() (const libMesh::Point& p,
                                             const Real t,
                                             ComplexVectorX& v) const {
     
+    if (_transfer) {
+        
+        libmesh_assert(_sol_re);
+        _transfer->interpolate(p, *_sol_re, *_sol_im, v);
+        return;
+    }
+    
     // make sure that the object was initialized
     libmesh_assert(_function_re);
     
@@ -194,6 +212,13 @@ MAST::ComplexMeshFieldFunction::perturbation(const libMesh::Point& p,
                                              const Real t,
                                              ComplexVectorX& v) const {
     
+    if (_transfer) {
+        
+        libmesh_assert(_perturbed_sol_re);
+        _transfer->interpolate(p, *_perturbed_sol_re, *_perturbed_sol_im, v);
+        return;
+    }
+    
     // make sure that the object was initialized
     libmesh_assert(_perturbed_function_re);
     
@@ -215,6 +240,68 @@ MAST::ComplexMeshFieldFunction::perturbation(const libMesh::Point& p,
 
 
 
+void
+MAST::ComplexMeshFieldFunction::gradient(const libMesh::Point& p,
+                                         const Real t,
+                                         ComplexMatrixX& dv) const {
+    
+    if (_transfer) {
+        
+        libmesh_assert(_sol_re);
+        _transfer->interpolate_gradient(p, *_sol_re, *_sol_im, dv);
+        return;
+    }
+    
+    // make sure that the object was initialized
+    libmesh_assert(_function_re);
+    
+    std::vector<libMesh::Gradient> g_re, g_im;
+    _function_re->gradient(p, t, g_re);
+    _function_im->gradient(p, t, g_im);
+    
+    libmesh_assert(g_re.size());
+    
+    dv = ComplexMatrixX::Zero(g_re.size(), 3);
+    for (unsigned int i=0; i<g_re.size(); i++)
+        for (unsigned int j=0; j<3; j++)
+            dv(i, j) = std::complex<Real>(g_re[i](j), g_im[i](j));
+}
+
+
+
+
+
+void
+MAST::ComplexMeshFieldFunction::perturbation_gradient(const libMesh::Point& p,
+                                                      const Real t,
+                                                      ComplexMatrixX& dv) const {
+    
+    if (_transfer) {
+        
+        libmesh_assert(_perturbed_sol_re);
+        _transfer->interpolate_gradient(p, *_perturbed_sol_re, *_perturbed_sol_im, dv);
+        return;
+    }
+    
+    // make sure that the object was initialized
+    libmesh_assert(_perturbed_function_re);
+    
+    std::vector<libMesh::Gradient> g_re, g_im;
+    _perturbed_function_re->gradient(p, t, g_re);
+    _perturbed_function_im->gradient(p, t, g_im);
+    
+    libmesh_assert(g_re.size());
+    
+    dv = ComplexMatrixX::Zero(g_re.size(), 3);
+    for (unsigned int i=0; i<g_re.size(); i++)
+        for (unsigned int j=0; j<3; j++)
+            dv(i, j) = std::complex<Real>(g_re[i](j), g_im[i](j));
+}
+
+
+
+
+
 
 
 
@@ -228,7 +315,9 @@ MAST::ComplexMeshFieldFunction::clear() {
         delete _function_im;
         _function_re = nullptr;
         _function_im = nullptr;
-        
+    }
+    
+    if (_sol_re) {
         delete _sol_re;
         delete _sol_im;
         _sol_re = nullptr;
@@ -241,7 +330,9 @@ MAST::ComplexMeshFieldFunction::clear() {
         delete _perturbed_function_im;
         _perturbed_function_re = nullptr;
         _perturbed_function_im = nullptr;
-        
+    }
+    
+    if (_perturbed_sol_re) {
         delete _perturbed_sol_re;
         delete _perturbed_sol_im;
         _perturbed_sol_re = nullptr;
@@ -34,6 +34,7 @@ namespace MAST {
     
     // Forward declerations
     class SystemInitialization;
+    class MeshFieldTransferOperator;
     
     
     /*!
@@ -67,6 +68,38 @@ namespace MAST {
                                    ComplexVectorX& v) const;
         
         
+        /*!
+         *   calculates the spatial gradient of the function at \p p, and
+         *   returns it in \p dv. Row i of \p dv is the gradient of 
+         *   variable i.
+         */
+        void gradient (const libMesh::Point& p,
+                       const Real t,
+                       ComplexMatrixX& dv) const;
+        
+        
+        /*!
+         *   calculates the spatial gradient of the perturbation in the 
+         *   function at \p p, and returns it in \p dv.
+         */
+        void perturbation_gradient (const libMesh::Point& p,
+                                    const Real t,
+                                    ComplexMatrixX& dv) const;
+        
+        
+        /*!
+         *   tells the function to interpolate the real and imaginary
+         *   parts with \p op, instead of libMesh::MeshFunction objects.
+         *   See MAST::MeshFieldFunction::set_transfer_operator(). This
+         *   should be called before init().
+         */
+        void set_transfer_operator(MAST::MeshFieldTransferOperator* op) {
+            
+            libmesh_assert(!_sol_re);
+            _transfer = op;
+        }
+        
+        
         void init(const libMesh::NumericVector<Real>& sol_re,
                   const libMesh::NumericVector<Real>& sol_im);
         
@@ -75,6 +108,25 @@ namespace MAST {
                                const libMesh::NumericVector<Real>& dsol_im);
         
         
+        /*!
+         *   replaces the real and imaginary parts of the interpolated
+         *   solution of an initialized function, with the localized vectors
+         *   and interpolation data retained. See
+         *   MAST::MeshFieldFunction::update(). @returns \p true if the
+         *   values have changed.
+         */
+        bool update(const libMesh::NumericVector<Real>& sol_re,
+                    const libMesh::NumericVector<Real>& sol_im);
+        
+        
+        /*!
+         *   same as update(), for the perturbation initialized by
+         *   init_perturbation()
+         */
+        bool update_perturbation(const libMesh::NumericVector<Real>& dsol_re,
+                                 const libMesh::NumericVector<Real>& dsol_im);
+        
+        
         /*!
          *    @returns a reference to the libMesh mesh function
          */
@@ -131,6 +183,10 @@ namespace MAST {
         *_perturbed_function_re,
         *_perturbed_function_im;
         
+        /*!
+         *   operator that performs the interpolation, if provided
+         */
+        MAST::MeshFieldTransferOperator* _transfer;
     };
 }
 
@@ -78,3 +78,25 @@ MAST::ConstantFieldFunction::derivative (        const MAST::FunctionBase& f,
     v = _p.depends_on(f)?1:0;
 }
 
+
+
+void
+MAST::ConstantFieldFunction::operator() (const std::vector<libMesh::Point>& pts,
+                                         const Real t,
+                                         std::vector<Real>& v) const {
+    
+    v.assign(pts.size(), _p());
+}
+
+
+
+
+void
+MAST::ConstantFieldFunction::derivative (const MAST::FunctionBase& f,
+                                         const std::vector<libMesh::Point>& pts,
+                                         const Real t,
+                                         std::vector<Real>& v) const {
+    
+    v.assign(pts.size(), _p.depends_on(f)?1.:0.);
+}
+
@@ -39,6 +39,22 @@ namespace MAST {
         
         
         virtual ~ConstantFieldFunction();
+        
+        
+        /*!
+         *    @returns the parameter which defines this field function
+         */
+        const MAST::Parameter& parameter() const {
+            return _p;
+        }
+        
+        /*!
+         *    @returns true since the value is independent of location
+         *    and time.
+         */
+        virtual bool is_constant() const {
+            return true;
+        }
 
         
         /*!
@@ -76,6 +92,24 @@ namespace MAST {
                                  Real& v) const;
 
         
+        /*!
+         *    fills \p v with the value of the parameter for all points
+         *    in \p pts.
+         */
+        virtual void operator() (const std::vector<libMesh::Point>& pts,
+                                 const Real t,
+                                 std::vector<Real>& v) const;
+        
+        
+        /*!
+         *    fills \p v with the derivative of the parameter for all
+         *    points in \p pts.
+         */
+        virtual void derivative (const MAST::FunctionBase& f,
+                                 const std::vector<libMesh::Point>& pts,
+                                 const Real t,
+                                 std::vector<Real>& v) const;
+        
         
     protected:
 
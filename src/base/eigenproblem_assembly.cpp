@@ -36,7 +36,10 @@
 MAST::EigenproblemAssembly::EigenproblemAssembly():
 MAST::AssemblyBase(),
 _base_sol(nullptr),
-_base_sol_sensitivity(nullptr) {
+_base_sol_sensitivity(nullptr),
+_matrix_cache(false),
+_matrix_key_A(nullptr),
+_matrix_key_B(nullptr) {
     
 }
 
@@ -82,6 +85,9 @@ MAST::EigenproblemAssembly::reattach_to_system() {
     dynamic_cast<MAST::NonlinearSystem&>(_system->system());
     
     eigen_sys.attach_eigenproblem_assemble_object(*this);
+    
+    // the matrices may have been modified by another assembly
+    this->clear_matrix_cache();
 }
 
 
@@ -90,6 +96,13 @@ void
 MAST::EigenproblemAssembly::
 clear_discipline_and_system( ) {
     
+    // the element objects, localized vectors and output element lists
+    // refer to the system, and are no longer valid
+    this->clear_elem_objects();
+    this->clear_output_elems();
+    this->clear_localized_vectors();
+    this->clear_matrix_cache();
+    
     if (_system && _discipline) {
 
         MAST::NonlinearSystem& sys =
@@ -141,11 +154,93 @@ MAST::EigenproblemAssembly::clear_base_solution(bool if_sens) {
 
 
 
+void
+MAST::EigenproblemAssembly::set_matrix_cache(bool f) {
+    
+    _matrix_cache = f;
+    this->clear_matrix_cache();
+}
+
+
+
+void
+MAST::EigenproblemAssembly::clear_matrix_cache() {
+    
+    _matrix_key_A = nullptr;
+    _matrix_key_B = nullptr;
+    _matrix_key_params.clear();
+    _matrix_key_base_sol.reset();
+}
+
+
+
+void
+MAST::EigenproblemAssembly::clear_mesh_dependent_data() {
+    
+    MAST::AssemblyBase::clear_mesh_dependent_data();
+    this->clear_matrix_cache();
+}
+
+
+
+bool
+MAST::EigenproblemAssembly::
+_if_matrix_key_valid(const libMesh::SparseMatrix<Real>& A,
+                     const libMesh::SparseMatrix<Real>& B) {
+    
+    if (!_matrix_cache)
+        return false;
+    
+    std::map<const Real*, Real> vals;
+    _get_parameter_values(vals);
+    
+    bool
+    valid = (&A == _matrix_key_A &&
+             &B == _matrix_key_B &&
+             vals == _matrix_key_params &&
+             (_base_sol != nullptr) == (_matrix_key_base_sol.get() != nullptr));
+    
+    if (valid && _base_sol) {
+        
+        std::auto_ptr<libMesh::NumericVector<Real> >
+        dX(_matrix_key_base_sol->clone().release());
+        dX->add(-1., *_base_sol);
+        
+        valid = dX->linfty_norm() == 0.;
+    }
+    
+    if (valid)
+        return true;
+    
+    // the matrices will be assembled for the current key
+    _matrix_key_A      = &A;
+    _matrix_key_B      = &B;
+    _matrix_key_params = vals;
+    
+    if (_base_sol) {
+        
+        if (!_matrix_key_base_sol.get())
+            _matrix_key_base_sol.reset(_base_sol->zero_clone().release());
+        *_matrix_key_base_sol = *_base_sol;
+    }
+    else
+        _matrix_key_base_sol.reset();
+    
+    return false;
+}
+
+
+
 void
 MAST::EigenproblemAssembly::
 eigenproblem_assemble(libMesh::SparseMatrix<Real>* A,
                       libMesh::SparseMatrix<Real>* B) {
     
+    // nothing to be done if the matrices were assembled for the
+    // current key
+    if (_if_matrix_key_valid(*A, *B))
+        return;
+    
     MAST::NonlinearSystem& eigen_sys =
     dynamic_cast<MAST::NonlinearSystem&>(_system->system());
     
@@ -172,7 +267,10 @@ eigenproblem_assemble(libMesh::SparseMatrix<Real>* A,
     RealMatrixX mat_A, mat_B;
     std::vector<libMesh::dof_id_type> dof_indices;
     const libMesh::DofMap& dof_map = eigen_sys.get_dof_map();
-    std::auto_ptr<MAST::ElementBase> physics_elem;
+    const MAST::ElementTopologyCache& topology = eigen_sys.topology_cache();
+    std::auto_ptr<MAST::ElementBase> elem_storage;
+    MAST::ElementBase* physics_elem = nullptr;
+    DenseRealMatrix A, B;
     
     libMesh::MeshBase::const_element_iterator       el     =
     eigen_sys.get_mesh().active_local_elements_begin();
@@ -183,9 +281,9 @@ eigenproblem_assemble(libMesh::SparseMatrix<Real>* A,
         
         const libMesh::Elem* elem = *el;
         
-        dof_map.dof_indices (elem, dof_indices);
+        topology.dof_indices (elem, dof_indices);
         
-        physics_elem.reset(_build_elem(*elem).release());
+        physics_elem = &_get_elem(*elem, elem_storage);
         
         // get the solution
         unsigned int ndofs = (unsigned int)dof_indices.size();
@@ -195,8 +293,7 @@ eigenproblem_assemble(libMesh::SparseMatrix<Real>* A,
         
         // if the base solution is provided, then tell the element about it
         if (_base_sol) {
-            for (unsigned int i=0; i<dof_indices.size(); i++)
-                sol(i) = (*localized_solution)(dof_indices[i]);
+            _get_elem_values(*localized_solution, dof_indices, sol);
         }
         
         physics_elem->set_solution(sol);
@@ -204,7 +301,6 @@ eigenproblem_assemble(libMesh::SparseMatrix<Real>* A,
         _elem_calculations(*physics_elem, mat_A, mat_B);
 
         // copy to the libMesh matrix for further processing
-        DenseRealMatrix A, B;
         MAST::copy(A, mat_A);
         MAST::copy(B, mat_B);
 
@@ -212,8 +308,8 @@ eigenproblem_assemble(libMesh::SparseMatrix<Real>* A,
         dof_map.constrain_element_matrix(A, dof_indices);
         dof_map.constrain_element_matrix(B, dof_indices);
         
-        matrix_A.add_matrix (A, dof_indices); // load independent
-        matrix_B.add_matrix (B, dof_indices); // load dependent
+        _add_elem_matrix(matrix_A, A, dof_indices, elem); // load independent
+        _add_elem_matrix(matrix_B, B, dof_indices, elem); // load dependent
     }
     
     
@@ -230,6 +326,10 @@ eigenproblem_sensitivity_assemble(const libMesh::ParameterVector& parameters,
                                   libMesh::SparseMatrix<Real>* sensitivity_A,
                                   libMesh::SparseMatrix<Real>* sensitivity_B) {
     
+    // the sensitivity matrices are assembled in the matrices of the
+    // eigenproblem
+    this->clear_matrix_cache();
+    
     MAST::NonlinearSystem& eigen_sys =
     dynamic_cast<MAST::NonlinearSystem&>(_system->system());
 
@@ -265,7 +365,10 @@ eigenproblem_sensitivity_assemble(const libMesh::ParameterVector& parameters,
     RealMatrixX mat_A, mat_B;
     std::vector<libMesh::dof_id_type> dof_indices;
     const libMesh::DofMap& dof_map = eigen_sys.get_dof_map();
-    std::auto_ptr<MAST::ElementBase> physics_elem;
+    const MAST::ElementTopologyCache& topology = eigen_sys.topology_cache();
+    std::auto_ptr<MAST::ElementBase> elem_storage;
+    MAST::ElementBase* physics_elem = nullptr;
+    DenseRealMatrix A, B;
     
     libMesh::MeshBase::const_element_iterator       el     =
     eigen_sys.get_mesh().active_local_elements_begin();
@@ -276,9 +379,9 @@ eigenproblem_sensitivity_assemble(const libMesh::ParameterVector& parameters,
         
         const libMesh::Elem* elem = *el;
         
-        dof_map.dof_indices (elem, dof_indices);
+        topology.dof_indices (elem, dof_indices);
         
-        physics_elem.reset(_build_elem(*elem).release());
+        physics_elem = &_get_elem(*elem, elem_storage);
         
         // get the solution
         unsigned int ndofs = (unsigned int)dof_indices.size();
@@ -290,8 +393,7 @@ eigenproblem_sensitivity_assemble(const libMesh::ParameterVector& parameters,
         if (_base_sol) {
             
             // set the element's base solution
-            for (unsigned int i=0; i<dof_indices.size(); i++)
-                sol(i) = (*localized_solution)(dof_indices[i]);
+            _get_elem_values(*localized_solution, dof_indices, sol);
         }
         
         physics_elem->set_solution(sol);
@@ -299,8 +401,7 @@ eigenproblem_sensitivity_assemble(const libMesh::ParameterVector& parameters,
         // set the element's base solution sensitivity
         if (_base_sol) {
             
-            for (unsigned int i=0; i<dof_indices.size(); i++)
-                sol(i) = (*localized_solution_sens)(dof_indices[i]);
+            _get_elem_values(*localized_solution_sens, dof_indices, sol);
         }
         
         physics_elem->set_solution(sol, true);
@@ -311,7 +412,6 @@ eigenproblem_sensitivity_assemble(const libMesh::ParameterVector& parameters,
         _elem_sensitivity_calculations(*physics_elem, mat_A, mat_B);
 
         // copy to the libMesh matrix for further processing
-        DenseRealMatrix A, B;
         MAST::copy(A, mat_A);
         MAST::copy(B, mat_B);
         
@@ -319,8 +419,8 @@ eigenproblem_sensitivity_assemble(const libMesh::ParameterVector& parameters,
         dof_map.constrain_element_matrix(A, dof_indices);
         dof_map.constrain_element_matrix(B, dof_indices);
         
-        matrix_A.add_matrix (A, dof_indices);
-        matrix_B.add_matrix (B, dof_indices);
+        _add_elem_matrix(matrix_A, A, dof_indices, elem);
+        _add_elem_matrix(matrix_B, B, dof_indices, elem);
     }
     
     return true;
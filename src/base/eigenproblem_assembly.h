@@ -155,8 +155,53 @@ namespace MAST {
         libMesh::NumericVector<Real>& base_sol(bool if_sens = false);
         
         
+        /*!
+         *   tells eigenproblem_assemble() to leave the matrices unchanged
+         *   from the previous assembly, if they were assembled in the same
+         *   matrix objects for the same values of the parameters added to
+         *   the discipline and the same base solution. This can be used for
+         *   repeated solutions of linear modal problems, for example with
+         *   different shifts. clear_matrix_cache() must be called if any
+         *   other data used by the elements is modified. This is \p false
+         *   by default.
+         */
+        void set_matrix_cache(bool f);
+        
+        
+        /*!
+         *   @returns \p true if the assembled matrices are reused while
+         *   their key is unchanged.
+         */
+        bool if_matrix_cache() const {
+            return _matrix_cache;
+        }
+        
+        
+        /*!
+         *   invalidates the matrices retained from the previous assembly, so
+         *   that the next call to eigenproblem_assemble() assembles them.
+         */
+        void clear_matrix_cache();
+        
+        
+        /*!
+         *   clears the retained matrices along with the data of the
+         *   parent class
+         */
+        virtual void clear_mesh_dependent_data();
+        
+        
     protected:
         
+        /*!
+         *   @returns \p true if the matrix cache is turned on and \p A and
+         *   \p B were assembled for the current parameter values and base
+         *   solution. Otherwise, the key is updated for the assembly that
+         *   follows.
+         */
+        bool _if_matrix_key_valid(const libMesh::SparseMatrix<Real>& A,
+                                  const libMesh::SparseMatrix<Real>& B);
+        
         /*!
          *   performs the element calculations over \par elem, and returns
          *   the element matrices for the eigenproblem
@@ -191,6 +236,20 @@ namespace MAST {
          */
         const libMesh::NumericVector<Real> * _base_sol_sensitivity;
         
+        /*!
+         *   flag to reuse the assembled matrices while their key is unchanged
+         */
+        bool _matrix_cache;
+        
+        /*!
+         *   matrices, parameter values and base solution for which the
+         *   matrices were last assembled. The matrix pointers are nullptr if
+         *   the key is not valid.
+         */
+        const libMesh::SparseMatrix<Real>               *_matrix_key_A, *_matrix_key_B;
+        std::map<const Real*, Real>                     _matrix_key_params;
+        std::auto_ptr<libMesh::NumericVector<Real> >    _matrix_key_base_sol;
+        
     };
     
 }
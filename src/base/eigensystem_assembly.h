@@ -21,10 +21,14 @@
 #ifndef __mast__eigensystem_assembly_h__
 #define __mast__eigensystem_assembly_h__
 
+// C++ includes
+#include <vector>
+
 
 // libMesh includes
 #include "libmesh/sparse_matrix.h"
 #include "libmesh/parameter_vector.h"
+#include "libmesh/numeric_vector.h"
 
 
 namespace MAST {
@@ -70,6 +74,24 @@ namespace MAST {
                                           libMesh::SparseMatrix<Real>* sensitivity_B) = 0;
         
         
+        /*!
+         *   computes
+         *   \f$ x_i^T (dA/dp_j - \lambda_i dB/dp_j) x_i \f$ for all
+         *   eigenvectors \p x and parameters \p parameters without
+         *   assembling the sensitivity matrices. The product for
+         *   eigenpair \p i and parameter \p j is returned in
+         *   \p sens[j*x.size()+i]. This returns false if the products
+         *   are not computed by this object, in which case
+         *   eigenproblem_sensitivity_assemble() is used for each parameter.
+         */
+        virtual bool
+        eigenproblem_sensitivity_products(const libMesh::ParameterVector& parameters,
+                                          const std::vector<Real>& eig,
+                                          const std::vector<libMesh::NumericVector<Real>*>& x,
+                                          std::vector<Real>& sens) {
+            return false;
+        }
+        
     };
 }
 
@@ -22,6 +22,7 @@
 #include "base/system_initialization.h"
 #include "mesh/local_elem_base.h"
 #include "base/nonlinear_system.h"
+#include "numerics/reference_element_registry.h"
 
 
 MAST::ElementBase::ElementBase(MAST::SystemInitialization& sys,
@@ -31,16 +32,23 @@ _system(sys),
 _elem(elem),
 _active_sol_function(nullptr),
 _time(_system.system().time),
+_geometry_cache(false),
 _fe(nullptr),
-_qrule(nullptr) {
+_qrule(nullptr),
+_fe_from_registry(false) {
     
 }
 
 
 MAST::ElementBase::~ElementBase() {
 
-    if (_fe)     delete _fe;
-    if (_qrule)  delete _qrule;
+    if (_fe_from_registry)
+        MAST::ReferenceElementRegistry::release(_fe, _qrule);
+    else {
+        
+        if (_fe)     delete _fe;
+        if (_qrule)  delete _qrule;
+    }
 }
 
 
@@ -189,8 +197,26 @@ MAST::ElementBase::_init_fe_and_qrule(const libMesh::Elem& e,
     for (unsigned int i=1; i != nv; ++i)
         libmesh_assert(fe_type == _system.fetype(i));
     
-    // Create an adequate quadrature rule
-    (*fe) = libMesh::FEBase::build(e.dim(), fe_type).release();
+    // the finite element and quadrature rule of the element are
+    // taken from the registry, so that the reference shape function
+    // tables are shared with the previous elements of the same type
+    const bool
+    shared = (pts == nullptr && fe == &_fe && qrule == &_qrule);
+    
+    if (shared) {
+        
+        libmesh_assert(!_fe_from_registry);
+        MAST::ReferenceElementRegistry::acquire(fe_type,
+                                                e.type(),
+                                                e.dim(),
+                                                _system.system().extra_quadrature_order,
+                                                fe,
+                                                qrule);
+        _fe_from_registry = true;
+    }
+    else
+        (*fe) = libMesh::FEBase::build(e.dim(), fe_type).release();
+    
     (*fe)->get_phi();
     (*fe)->get_xyz();
     (*fe)->get_JxW();
@@ -200,9 +226,12 @@ MAST::ElementBase::_init_fe_and_qrule(const libMesh::Elem& e,
     (*fe)->get_dphidzeta();
     
     if (pts == nullptr) {
-        (*qrule) = fe_type.default_quadrature_rule(e.dim(),
-                                                _system.system().extra_quadrature_order).release();  // system extra quadrature
-        (*fe)->attach_quadrature_rule(*qrule);
+        // Create an adequate quadrature rule
+        if (!shared) {
+            (*qrule) = fe_type.default_quadrature_rule(e.dim(),
+                                                    _system.system().extra_quadrature_order).release();  // system extra quadrature
+            (*fe)->attach_quadrature_rule(*qrule);
+        }
         (*fe)->reinit(&e);
     }
     else
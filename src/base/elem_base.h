@@ -228,6 +228,39 @@ namespace MAST {
         const MAST::FunctionBase* sensitivity_param;
         
         
+        /*!
+         *   tells the element to store the quadrature point data that only
+         *   depends on the element geometry (global location of quadrature
+         *   points, strain operators, etc.) on first use, and to reuse it in
+         *   subsequent calculations. This is useful only when the element
+         *   object is retained between assembly calls, and increases the
+         *   memory used per element in return for fewer operations per
+         *   residual evaluation. The stored data is not used for
+         *   sensitivity with respect to shape parameters. This is
+         *   \p false by default.
+         */
+        void set_geometry_cache(bool f) {
+            _geometry_cache = f;
+            if (!f)
+                this->clear_geometry_cache();
+        }
+        
+        
+        /*!
+         *   @returns \p true if the geometric quadrature point data is stored
+         */
+        bool if_geometry_cache() const {
+            return _geometry_cache;
+        }
+        
+        
+        /*!
+         *   clears the stored geometric quadrature point data. This must be
+         *   called if the element geometry changes.
+         */
+        virtual void clear_geometry_cache() { }
+        
+        
         /*!
          *   @returns a constant reference to the geometric element used for
          *   initialization of finite element quadrature and shape functions.
@@ -271,6 +304,9 @@ namespace MAST {
          *   \param e libMesh::Elem for which the finite element is initialized.
          *   \param pts the points at which the element should be initialized. If nullptr, 
          *    the points specified by quadrature rule will be used.
+         *   If \p fe and \p qrule are the element's \p _fe and \p _qrule and
+         *   \p pts is nullptr, the objects are obtained from
+         *   MAST::ReferenceElementRegistry and are owned by the registry.
          */
         virtual void
         _init_fe_and_qrule(const libMesh::Elem& e,
@@ -412,6 +448,12 @@ namespace MAST {
         RealVectorX _delta_accel_sens;
 
         
+        /*!
+         *   flag to store the geometric quadrature point data
+         */
+        bool _geometry_cache;
+        
+        
         /*!
          *   element finite element for computations
          */
@@ -422,6 +464,14 @@ namespace MAST {
          *   element quadrature rule for computations
          */
         libMesh::QBase *_qrule;
+        
+        
+        /*!
+         *   flag to indicate that \p _fe and \p _qrule were obtained from
+         *   MAST::ReferenceElementRegistry, to which they are returned
+         *   on destruction
+         */
+        bool _fe_from_registry;
     };
 }
 
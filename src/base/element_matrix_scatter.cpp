@@ -0,0 +1,333 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2017  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+// C++ includes
+#include <algorithm>
+#include <cstring>
+
+
+// MAST includes
+#include "base/element_matrix_scatter.h"
+#include "base/element_topology_cache.h"
+
+
+// libMesh includes
+#include "libmesh/elem.h"
+
+
+MAST::ElementMatrixScatter::
+ElementMatrixScatter(const MAST::ElementTopologyCache& topology,
+                     Mat mat):
+_topology(topology),
+_mat(mat),
+_nz_state(0),
+_A_d(nullptr),
+_A_o(nullptr),
+_nz_d(0) {
+    
+    libmesh_assert(supported(mat));
+    
+    MPI_Comm comm;
+    PetscErrorCode ierr;
+    
+    ierr = PetscObjectGetComm((PetscObject)mat, &comm);
+    CHKERRABORT(comm, ierr);
+    
+    ierr = MatGetNonzeroState(mat, &_nz_state);
+    CHKERRABORT(comm, ierr);
+    
+    MatType type;
+    ierr = MatGetType(mat, &type);
+    CHKERRABORT(comm, ierr);
+    
+    // global column of each local column of the off-diagonal block,
+    // in ascending order
+    const PetscInt* garray = nullptr;
+    PetscInt        n_garray = 0;
+    
+    if (!std::strcmp(type, MATMPIAIJ)) {
+        
+        ierr = MatMPIAIJGetSeqAIJ(mat, &_A_d, &_A_o, &garray);
+        CHKERRABORT(comm, ierr);
+        
+        // the columns of the assembled off-diagonal block are numbered
+        // by their position in garray
+        ierr = MatGetSize(_A_o, nullptr, &n_garray);
+        CHKERRABORT(comm, ierr);
+    }
+    else
+        _A_d = mat;
+    
+    PetscInt
+    r_begin = 0,
+    r_end   = 0,
+    c_begin = 0,
+    c_end   = 0;
+    
+    ierr = MatGetOwnershipRange(mat, &r_begin, &r_end);
+    CHKERRABORT(comm, ierr);
+    ierr = MatGetOwnershipRangeColumn(mat, &c_begin, &c_end);
+    CHKERRABORT(comm, ierr);
+    
+    // CSR structure of the local blocks
+    const PetscInt
+    *ia_d = nullptr, *ja_d = nullptr,
+    *ia_o = nullptr, *ja_o = nullptr;
+    PetscInt  n = 0;
+    PetscBool done;
+    
+    ierr = MatGetRowIJ(_A_d, 0, PETSC_FALSE, PETSC_FALSE, &n, &ia_d, &ja_d, &done);
+    CHKERRABORT(comm, ierr);
+    libmesh_assert(done);
+    _nz_d = ia_d[n];
+    
+    if (_A_o) {
+        ierr = MatGetRowIJ(_A_o, 0, PETSC_FALSE, PETSC_FALSE, &n, &ia_o, &ja_o, &done);
+        CHKERRABORT(comm, ierr);
+        libmesh_assert(done);
+    }
+    
+    const unsigned int
+    n_elems = _topology.n_elems();
+    
+    _elem_offset.resize(n_elems, -1);
+    
+    std::vector<PetscInt> pos;
+    
+    for (unsigned int e=0; e<n_elems; e++) {
+        
+        const unsigned int
+        nd = _topology.n_elem_dofs(e);
+        
+        const libMesh::dof_id_type*
+        dofs = _topology.elem_dofs(e);
+        
+        pos.assign(nd*nd, -1);
+        
+        bool
+        found = true;
+        
+        for (unsigned int i=0; found && i<nd; i++) {
+            
+            const PetscInt
+            row = (PetscInt)dofs[i];
+            
+            // rows of other processors are added to the stash
+            if (row < r_begin || row >= r_end)
+                continue;
+            
+            const PetscInt
+            r = row - r_begin;
+            
+            for (unsigned int j=0; found && j<nd; j++) {
+                
+                const PetscInt
+                col = (PetscInt)dofs[j];
+                
+                if (col >= c_begin && col < c_end) {
+                    
+                    const PetscInt
+                    *b   = ja_d + ia_d[r],
+                    *end = ja_d + ia_d[r+1],
+                    *it  = std::lower_bound(b, end, col - c_begin);
+                    
+                    found = (it != end && *it == col - c_begin);
+                    if (found) pos[i*nd+j] = (PetscInt)(it - ja_d);
+                }
+                else if (_A_o) {
+                    
+                    // local column of the off-diagonal block
+                    const PetscInt
+                    *g   = std::lower_bound(garray, garray + n_garray, col);
+                    
+                    found = (g != garray + n_garray && *g == col);
+                    
+                    if (found) {
+                        
+                        const PetscInt
+                        *b   = ja_o + ia_o[r],
+                        *end = ja_o + ia_o[r+1],
+                        *it  = std::lower_bound(b, end, (PetscInt)(g - garray));
+                        
+                        found = (it != end && *it == (PetscInt)(g - garray));
+                        if (found) pos[i*nd+j] = _nz_d + (PetscInt)(it - ja_o);
+                    }
+                }
+                else
+                    found = false;
+            }
+        }
+        
+        if (found) {
+            
+            _elem_offset[e] = (PetscInt)_positions.size();
+            _positions.insert(_positions.end(), pos.begin(), pos.end());
+        }
+    }
+    
+    ierr = MatRestoreRowIJ(_A_d, 0, PETSC_FALSE, PETSC_FALSE, &n, &ia_d, &ja_d, &done);
+    CHKERRABORT(comm, ierr);
+    
+    if (_A_o) {
+        ierr = MatRestoreRowIJ(_A_o, 0, PETSC_FALSE, PETSC_FALSE, &n, &ia_o, &ja_o, &done);
+        CHKERRABORT(comm, ierr);
+    }
+}
+
+
+
+MAST::ElementMatrixScatter::~ElementMatrixScatter() {
+    
+}
+
+
+
+bool
+MAST::ElementMatrixScatter::supported(Mat mat) {
+    
+    if (!mat)
+        return false;
+    
+    MatType   type;
+    PetscBool assembled;
+    PetscErrorCode ierr;
+    
+    ierr = MatGetType(mat, &type);
+    CHKERRABORT(PETSC_COMM_SELF, ierr);
+    
+    ierr = MatAssembled(mat, &assembled);
+    CHKERRABORT(PETSC_COMM_SELF, ierr);
+    
+    return (assembled &&
+            (!std::strcmp(type, MATSEQAIJ) || !std::strcmp(type, MATMPIAIJ)));
+}
+
+
+
+bool
+MAST::ElementMatrixScatter::valid(Mat mat) const {
+    
+    if (mat != _mat)
+        return false;
+    
+    PetscObjectState s;
+    PetscErrorCode ierr = MatGetNonzeroState(mat, &s);
+    CHKERRABORT(PETSC_COMM_SELF, ierr);
+    
+    return s == _nz_state;
+}
+
+
+
+bool
+MAST::ElementMatrixScatter::
+add(const libMesh::Elem& e,
+    const DenseRealMatrix& m,
+    const std::vector<libMesh::dof_id_type>& dof_indices) {
+    
+    const unsigned int
+    i_elem = _topology.elem_index(e);
+    
+    if (i_elem == libMesh::invalid_uint ||
+        _elem_offset[i_elem] < 0)
+        return false;
+    
+    // the dofs may have been modified by the constraints
+    const unsigned int
+    nd = _topology.n_elem_dofs(i_elem);
+    
+    const libMesh::dof_id_type*
+    dofs = _topology.elem_dofs(i_elem);
+    
+    if (dof_indices.size() != nd ||
+        !std::equal(dof_indices.begin(), dof_indices.end(), dofs))
+        return false;
+    
+    libmesh_assert_equal_to(m.m(), nd);
+    libmesh_assert_equal_to(m.n(), nd);
+    
+    const PetscInt*
+    pos = &_positions[_elem_offset[i_elem]];
+    
+    PetscErrorCode ierr;
+    PetscScalar
+    *v_d = nullptr,
+    *v_o = nullptr;
+    
+    ierr = MatSeqAIJGetArray(_A_d, &v_d);
+    CHKERRABORT(PETSC_COMM_SELF, ierr);
+    
+    if (_A_o) {
+        ierr = MatSeqAIJGetArray(_A_o, &v_o);
+        CHKERRABORT(PETSC_COMM_SELF, ierr);
+    }
+    
+    std::vector<PetscInt>    cols;
+    std::vector<PetscScalar> vals;
+    
+    for (unsigned int i=0; i<nd; i++) {
+        
+        const PetscInt* p = pos + i*nd;
+        
+        if (p[0] < 0) {
+            
+            // row of another processor
+            if (cols.empty()) {
+                
+                cols.assign(dofs, dofs + nd);
+                vals.resize(nd);
+            }
+            
+            for (unsigned int j=0; j<nd; j++)
+                vals[j] = m(i, j);
+            
+            const PetscInt row = (PetscInt)dofs[i];
+            
+            ierr = MatSetValues(_mat, 1, &row, nd, &cols[0], &vals[0], ADD_VALUES);
+            CHKERRABORT(PETSC_COMM_SELF, ierr);
+            continue;
+        }
+        
+        for (unsigned int j=0; j<nd; j++) {
+            
+            if (p[j] < _nz_d) v_d[p[j]]        += m(i, j);
+            else              v_o[p[j]-_nz_d]  += m(i, j);
+        }
+    }
+    
+    ierr = MatSeqAIJRestoreArray(_A_d, &v_d);
+    CHKERRABORT(PETSC_COMM_SELF, ierr);
+    
+    if (_A_o) {
+        ierr = MatSeqAIJRestoreArray(_A_o, &v_o);
+        CHKERRABORT(PETSC_COMM_SELF, ierr);
+    }
+    
+    return true;
+}
+
+
+
+std::size_t
+MAST::ElementMatrixScatter::memory() const {
+    
+    return (_elem_offset.size() + _positions.size()) * sizeof(PetscInt);
+}
+
@@ -0,0 +1,151 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2017  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+#ifndef __mast__element_matrix_scatter__
+#define __mast__element_matrix_scatter__
+
+// C++ includes
+#include <vector>
+
+
+// MAST includes
+#include "base/mast_data_types.h"
+
+
+// PETSc includes
+#include <petscmat.h>
+
+
+namespace libMesh {
+    
+    // Forward declerations
+    class Elem;
+}
+
+
+namespace MAST {
+    
+    // Forward declerations
+    class ElementTopologyCache;
+    
+    
+    /*!
+     *    Adds element matrices to an assembled PETSc AIJ matrix by direct
+     *    addition to its value arrays. For each element in the topology
+     *    cache, the positions of the element entries in the CSR values of
+     *    the diagonal and off-diagonal blocks of the local rows are found
+     *    once on construction, so that the assembly does not search the
+     *    CSR structure with MatSetValues() for each element and entry.
+     *    Rows owned by other processors are added with MatSetValues() to
+     *    the stash, and the matrix must be assembled as usual after the
+     *    element loop.
+     *
+     *    The positions are only valid for the nonzero structure of the
+     *    matrix at construction, which is checked by valid(). Elements
+     *    with an entry that is not in the structure are not handled by
+     *    the scatter. Only \p MATSEQAIJ and \p MATMPIAIJ matrices are
+     *    supported.
+     */
+    class ElementMatrixScatter {
+        
+    public:
+        
+        /*!
+         *   computes the positions of the entries of the elements in
+         *   \p topology in the assembled matrix \p mat
+         */
+        ElementMatrixScatter(const MAST::ElementTopologyCache& topology,
+                             Mat mat);
+        
+        
+        virtual ~ElementMatrixScatter();
+        
+        
+        /*!
+         *   @returns \p true if \p mat is an assembled matrix of a type
+         *   supported by this class
+         */
+        static bool supported(Mat mat);
+        
+        
+        /*!
+         *   @returns \p true if the scatter was computed for \p mat and
+         *   the nonzero structure of \p mat has not changed since.
+         */
+        bool valid(Mat mat) const;
+        
+        
+        /*!
+         *   adds \p m to the matrix for element \p e with dofs
+         *   \p dof_indices. @returns \p false, without modifying the
+         *   matrix, if the element is not handled by the scatter, or if
+         *   \p dof_indices are not the dofs of the element in the cache.
+         */
+        bool add(const libMesh::Elem& e,
+                 const DenseRealMatrix& m,
+                 const std::vector<libMesh::dof_id_type>& dof_indices);
+        
+        
+        /*!
+         *   @returns the number of bytes used by the scatter
+         */
+        std::size_t memory() const;
+        
+    protected:
+        
+        /*!
+         *   topology cache with the element dofs
+         */
+        const MAST::ElementTopologyCache&     _topology;
+        
+        /*!
+         *   matrix, and the nonzero state for which the scatter was
+         *   computed
+         */
+        Mat                                   _mat;
+        
+        PetscObjectState                      _nz_state;
+        
+        /*!
+         *   diagonal and off-diagonal blocks of the local rows. The
+         *   off-diagonal block is \p nullptr for a sequential matrix.
+         */
+        Mat                                   _A_d, _A_o;
+        
+        /*!
+         *   number of nonzeros of the diagonal block. The positions in
+         *   the off-diagonal block are stored after these.
+         */
+        PetscInt                              _nz_d;
+        
+        /*!
+         *   the positions of the n x n entries of element \p i, in row
+         *   major order, start at \p _elem_offset[i], or the offset is
+         *   -1 if the element is not handled. The positions of the rows
+         *   of other processors are -1.
+         */
+        std::vector<PetscInt>                 _elem_offset;
+        
+        std::vector<PetscInt>                 _positions;
+    };
+}
+
+
+#endif // __mast__element_matrix_scatter__
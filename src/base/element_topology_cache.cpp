@@ -0,0 +1,233 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2017  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+// MAST includes
+#include "base/element_topology_cache.h"
+
+
+// libMesh includes
+#include "libmesh/system.h"
+#include "libmesh/dof_map.h"
+#include "libmesh/mesh_base.h"
+#include "libmesh/boundary_info.h"
+
+
+MAST::ElementTopologyCache::ElementTopologyCache():
+_dof_map(nullptr),
+_binfo(nullptr) {
+    
+}
+
+
+
+MAST::ElementTopologyCache::~ElementTopologyCache() {
+    
+}
+
+
+
+void
+MAST::ElementTopologyCache::init(const libMesh::System& sys) {
+    
+    this->clear();
+    
+    const libMesh::MeshBase& mesh = sys.get_mesh();
+    
+    _dof_map = &sys.get_dof_map();
+    _binfo   = mesh.boundary_info.get();
+    
+    const unsigned int
+    n_elems = (unsigned int)mesh.n_active_local_elem();
+    
+    _elem_index.reserve(n_elems);
+    _elems.reserve(n_elems);
+    _dof_offset.reserve(n_elems+1);
+    _constrained.reserve(n_elems);
+    _side_offset.reserve(n_elems+1);
+    _dof_offset.push_back(0);
+    _side_offset.push_back(0);
+    _bc_offset.push_back(0);
+    
+    std::vector<libMesh::dof_id_type>       di;
+    std::vector<libMesh::boundary_id_type>  bc_ids;
+    
+    libMesh::MeshBase::const_element_iterator       el     =
+    mesh.active_local_elements_begin();
+    const libMesh::MeshBase::const_element_iterator end_el =
+    mesh.active_local_elements_end();
+    
+    for ( ; el != end_el; ++el) {
+        
+        const libMesh::Elem* elem = *el;
+        
+        _elem_index[elem->id()] = (unsigned int)_elems.size();
+        _elems.push_back(elem);
+        
+        _dof_map->dof_indices(elem, di);
+        _dofs.insert(_dofs.end(), di.begin(), di.end());
+        _dof_offset.push_back((unsigned int)_dofs.size());
+        
+        bool constrained = false;
+        for (unsigned int i=0; i<di.size() && !constrained; i++)
+            constrained = _dof_map->is_constrained_dof(di[i]);
+        _constrained.push_back(constrained);
+        
+        for (unsigned short int n=0; n<elem->n_sides(); n++) {
+            
+            if (_binfo->n_boundary_ids(elem, n)) {
+                
+                bc_ids = _binfo->boundary_ids(elem, n);
+                _bc_ids.insert(_bc_ids.end(), bc_ids.begin(), bc_ids.end());
+            }
+            _bc_offset.push_back((unsigned int)_bc_ids.size());
+        }
+        _side_offset.push_back((unsigned int)_bc_offset.size()-1);
+    }
+}
+
+
+
+void
+MAST::ElementTopologyCache::clear() {
+    
+    _dof_map = nullptr;
+    _binfo   = nullptr;
+    
+    _elem_index.clear();
+    _elems.clear();
+    _dof_offset.clear();
+    _dofs.clear();
+    _constrained.clear();
+    _side_offset.clear();
+    _bc_offset.clear();
+    _bc_ids.clear();
+}
+
+
+
+void
+MAST::ElementTopologyCache::
+dof_indices(const libMesh::Elem* e,
+            std::vector<libMesh::dof_id_type>& di) const {
+    
+    libmesh_assert(_dof_map);
+    
+    const unsigned int
+    i = elem_index(*e);
+    
+    if (i == libMesh::invalid_uint)
+        _dof_map->dof_indices(e, di);
+    else
+        di.assign(_dofs.begin() + _dof_offset[i],
+                  _dofs.begin() + _dof_offset[i+1]);
+}
+
+
+
+bool
+MAST::ElementTopologyCache::has_constrained_dofs(const libMesh::Elem& e) const {
+    
+    const unsigned int
+    i = elem_index(e);
+    
+    if (i == libMesh::invalid_uint)
+        return true;
+    
+    return _constrained[i];
+}
+
+
+
+unsigned int
+MAST::ElementTopologyCache::n_boundary_ids(const libMesh::Elem& e,
+                                           unsigned int s) const {
+    
+    libmesh_assert(_binfo);
+    
+    const unsigned int
+    i = elem_index(e);
+    
+    if (i == libMesh::invalid_uint)
+        return _binfo->n_boundary_ids(&e, s);
+    
+    const unsigned int
+    j = _side_offset[i] + s;
+    
+    libmesh_assert_less(j, _side_offset[i+1]);
+    
+    return _bc_offset[j+1] - _bc_offset[j];
+}
+
+
+
+std::vector<libMesh::boundary_id_type>
+MAST::ElementTopologyCache::boundary_ids(const libMesh::Elem& e,
+                                         unsigned int s) const {
+    
+    libmesh_assert(_binfo);
+    
+    const unsigned int
+    i = elem_index(e);
+    
+    if (i == libMesh::invalid_uint)
+        return _binfo->boundary_ids(&e, s);
+    
+    const unsigned int
+    j = _side_offset[i] + s;
+    
+    libmesh_assert_less(j, _side_offset[i+1]);
+    
+    return std::vector<libMesh::boundary_id_type>(_bc_ids.begin() + _bc_offset[j],
+                                                  _bc_ids.begin() + _bc_offset[j+1]);
+}
+
+
+
+std::size_t
+MAST::ElementTopologyCache::memory() const {
+    
+    return
+    _elem_index.size()  * (sizeof(libMesh::dof_id_type) + sizeof(unsigned int)) +
+    _elems.size()       * sizeof(const libMesh::Elem*) +
+    _dof_offset.size()  * sizeof(unsigned int) +
+    _dofs.size()        * sizeof(libMesh::dof_id_type) +
+    _constrained.size() / 8 +
+    _side_offset.size() * sizeof(unsigned int) +
+    _bc_offset.size()   * sizeof(unsigned int) +
+    _bc_ids.size()      * sizeof(libMesh::boundary_id_type);
+}
+
+
+
+unsigned int
+MAST::ElementTopologyCache::elem_index(const libMesh::Elem& e) const {
+    
+    std::unordered_map<libMesh::dof_id_type, unsigned int>::const_iterator
+    it = _elem_index.find(e.id());
+    
+    // elements with the same id from a different mesh are not in the
+    // cache
+    if (it == _elem_index.end() ||
+        _elems[it->second] != &e)
+        return libMesh::invalid_uint;
+    
+    return it->second;
+}
+
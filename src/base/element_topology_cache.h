@@ -0,0 +1,220 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2017  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+#ifndef __mast__element_topology_cache__
+#define __mast__element_topology_cache__
+
+// C++ includes
+#include <vector>
+#include <unordered_map>
+
+
+// MAST includes
+#include "base/mast_data_types.h"
+
+
+// libMesh includes
+#include "libmesh/id_types.h"
+#include "libmesh/elem.h"
+
+
+namespace libMesh {
+    
+    // Forward declerations
+    class System;
+    class DofMap;
+    class BoundaryInfo;
+}
+
+
+namespace MAST {
+    
+    /*!
+     *    Flat storage of the dof indices and of the side boundary ids of
+     *    the active local elements of a system, which are read by the
+     *    element loops of the assemblies and by the side load calculations
+     *    of the elements instead of querying the libMesh::DofMap and
+     *    libMesh::BoundaryInfo for each element and side. The data is built
+     *    by init(), after which the object is only read, and can be used
+     *    from multiple threads. For elements that are not in the cache, the
+     *    queries are forwarded to the DofMap and BoundaryInfo of the
+     *    system. The cache must be rebuilt when the mesh, its boundary ids
+     *    or the dof numbering changes, which is done by
+     *    MAST::NonlinearSystem in init_data() and reinit().
+     */
+    class ElementTopologyCache {
+        
+    public:
+        
+        ElementTopologyCache();
+        
+        virtual ~ElementTopologyCache();
+        
+        
+        /*!
+         *   builds the data for the active local elements of \p sys
+         */
+        void init(const libMesh::System& sys);
+        
+        
+        /*!
+         *   clears the data
+         */
+        void clear();
+        
+        
+        /*!
+         *   @returns \p true if the cache has been initialized
+         */
+        bool initialized() const {
+            return _dof_map != nullptr;
+        }
+        
+        
+        /*!
+         *   @returns the number of elements in the cache
+         */
+        unsigned int n_elems() const {
+            return (unsigned int)_elem_index.size();
+        }
+        
+        
+        /*!
+         *   sets \p di to the dof indices of all variables of \p e, in the
+         *   order of libMesh::DofMap::dof_indices()
+         */
+        void dof_indices(const libMesh::Elem* e,
+                         std::vector<libMesh::dof_id_type>& di) const;
+        
+        
+        /*!
+         *   @returns \p true if any dof of \p e is constrained in the
+         *   DofMap, for example by a Dirichlet boundary condition or a
+         *   hanging node. The assemblies skip the constraint of the
+         *   element quantities, which is a no-op for the other elements.
+         *   Elements that are not in the cache return \p true.
+         */
+        bool has_constrained_dofs(const libMesh::Elem& e) const;
+        
+        
+        /*!
+         *   @returns the number of boundary ids of side \p s of \p e
+         */
+        unsigned int n_boundary_ids(const libMesh::Elem& e,
+                                    unsigned int s) const;
+        
+        
+        /*!
+         *   @returns the boundary ids of side \p s of \p e
+         */
+        std::vector<libMesh::boundary_id_type>
+        boundary_ids(const libMesh::Elem& e,
+                     unsigned int s) const;
+        
+        
+        /*!
+         *   @returns the number of bytes used by the cache
+         */
+        std::size_t memory() const;
+        
+        
+        /*!
+         *   @returns the index of \p e in the cache, or
+         *   \p libMesh::invalid_uint if the element is not in the cache
+         */
+        unsigned int elem_index(const libMesh::Elem& e) const;
+        
+        
+        /*!
+         *   @returns the element with index \p i
+         */
+        const libMesh::Elem* elem(unsigned int i) const {
+            
+            libmesh_assert_less(i, _elems.size());
+            return _elems[i];
+        }
+        
+        
+        /*!
+         *   @returns the number of dofs of the element with index \p i
+         */
+        unsigned int n_elem_dofs(unsigned int i) const {
+            
+            libmesh_assert_less(i, _elems.size());
+            return _dof_offset[i+1] - _dof_offset[i];
+        }
+        
+        
+        /*!
+         *   @returns the dof indices of the element with index \p i,
+         *   of size n_elem_dofs()
+         */
+        const libMesh::dof_id_type* elem_dofs(unsigned int i) const {
+            
+            libmesh_assert_less(i, _elems.size());
+            return _dofs.data() + _dof_offset[i];
+        }
+        
+    protected:
+        
+        
+        /*!
+         *   dof map and boundary info of the system, used for elements that
+         *   are not in the cache
+         */
+        const libMesh::DofMap*                                        _dof_map;
+        
+        const libMesh::BoundaryInfo*                                  _binfo;
+        
+        /*!
+         *   index of the elements by their id, and the elements
+         */
+        std::unordered_map<libMesh::dof_id_type, unsigned int>       _elem_index;
+        
+        std::vector<const libMesh::Elem*>                             _elems;
+        
+        /*!
+         *   dof indices of element \p i are in
+         *   [_dof_offset[i], _dof_offset[i+1]) of \p _dofs
+         */
+        std::vector<unsigned int>                                     _dof_offset;
+        
+        std::vector<libMesh::dof_id_type>                             _dofs;
+        
+        /*!
+         *   flag for elements with at least one constrained dof
+         */
+        std::vector<bool>                                             _constrained;
+        
+        /*!
+         *   sides of element \p i are numbered from \p _side_offset[i], and
+         *   the boundary ids of side \p j are in
+         *   [_bc_offset[j], _bc_offset[j+1]) of \p _bc_ids
+         */
+        std::vector<unsigned int>                                     _side_offset;
+        
+        std::vector<unsigned int>                                     _bc_offset;
+        
+        std::vector<libMesh::boundary_id_type>                        _bc_ids;
+    };
+}
+
+
+#endif // __mast__element_topology_cache__
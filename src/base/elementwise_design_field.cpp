@@ -0,0 +1,216 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2017  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+// C++ includes
+#include <cmath>
+
+
+// MAST includes
+#include "base/elementwise_design_field.h"
+
+
+// libMesh includes
+#include "libmesh/numeric_vector.h"
+
+
+thread_local const libMesh::Elem*
+MAST::ElementwiseDesignField::_current_elem = nullptr;
+
+
+
+MAST::ElementwiseDesignField::
+ElementwiseDesignField(const std::string& nm,
+                       libMesh::System& sys,
+                       unsigned int var,
+                       Real v0):
+MAST::FieldFunction<Real>(nm),
+_sys(sys),
+_var(var),
+_v0(v0),
+_type(MAST::ElementwiseDesignField::SIMP),
+_penalty(1.),
+_v_min(0.) {
+    
+}
+
+
+
+MAST::ElementwiseDesignField::~ElementwiseDesignField() {
+    
+}
+
+
+
+void
+MAST::ElementwiseDesignField::
+set_interpolation(MAST::ElementwiseDesignField::InterpolationType t,
+                  Real p,
+                  Real v_min) {
+    
+    libmesh_assert_greater_equal(p, 0.);
+    libmesh_assert_greater_equal(v_min, 0.);
+    libmesh_assert_less(v_min, 1.);
+    
+    _type    = t;
+    _penalty = p;
+    _v_min   = v_min;
+    
+    _increment_version();
+}
+
+
+
+void
+MAST::ElementwiseDesignField::update() {
+    
+    _sys.solution->close();
+    _sys.update();
+    
+    _increment_version();
+}
+
+
+
+Real
+MAST::ElementwiseDesignField::elem_design_value(const libMesh::Elem& e) const {
+    
+    return (*_sys.current_local_solution)(this->dof_index(e));
+}
+
+
+
+Real
+MAST::ElementwiseDesignField::elem_value(const libMesh::Elem& e) const {
+    
+    Real dv = 0.;
+    return _interpolate(this->elem_design_value(e), dv);
+}
+
+
+
+Real
+MAST::ElementwiseDesignField::elem_derivative(const libMesh::Elem& e) const {
+    
+    Real dv = 0.;
+    _interpolate(this->elem_design_value(e), dv);
+    return dv;
+}
+
+
+
+void
+MAST::ElementwiseDesignField::operator() (const libMesh::Point& p,
+                                          const Real t,
+                                          Real& v) const {
+    
+    libmesh_assert_msg(_current_elem,
+                       "Element not set for evaluation of: " + _name);
+    
+    v = this->elem_value(*_current_elem);
+}
+
+
+
+void
+MAST::ElementwiseDesignField::derivative (const MAST::FunctionBase& f,
+                                          const libMesh::Point& p,
+                                          const Real t,
+                                          Real& v) const {
+    
+    if (&f != this) {
+        
+        v = 0.;
+        return;
+    }
+    
+    libmesh_assert_msg(_current_elem,
+                       "Element not set for evaluation of: " + _name);
+    
+    v = this->elem_derivative(*_current_elem);
+}
+
+
+
+void
+MAST::ElementwiseDesignField::operator() (const std::vector<libMesh::Point>& pts,
+                                          const Real t,
+                                          std::vector<Real>& v) const {
+    
+    libmesh_assert_msg(_current_elem,
+                       "Element not set for evaluation of: " + _name);
+    
+    v.assign(pts.size(), this->elem_value(*_current_elem));
+}
+
+
+
+void
+MAST::ElementwiseDesignField::derivative (const MAST::FunctionBase& f,
+                                          const std::vector<libMesh::Point>& pts,
+                                          const Real t,
+                                          std::vector<Real>& v) const {
+    
+    if (&f != this) {
+        
+        v.assign(pts.size(), 0.);
+        return;
+    }
+    
+    libmesh_assert_msg(_current_elem,
+                       "Element not set for evaluation of: " + _name);
+    
+    v.assign(pts.size(), this->elem_derivative(*_current_elem));
+}
+
+
+
+Real
+MAST::ElementwiseDesignField::_interpolate(Real rho, Real& dv) const {
+    
+    Real
+    g  = 0.,
+    dg = 0.;
+    
+    switch (_type) {
+            
+        case MAST::ElementwiseDesignField::SIMP: {
+            
+            g  = pow(rho, _penalty);
+            dg = (_penalty == 0.)? 0. : _penalty * pow(rho, _penalty-1.);
+        }
+            break;
+            
+        case MAST::ElementwiseDesignField::RAMP: {
+            
+            const Real
+            d = 1. + _penalty * (1. - rho);
+            
+            g  = rho / d;
+            dg = (1. + _penalty) / d / d;
+        }
+            break;
+            
+        default:
+            libmesh_error();
+    }
+    
+    dv = _v0 * (1. - _v_min) * dg;
+    
+    return _v0 * (_v_min + (1. - _v_min) * g);
+}
@@ -0,0 +1,236 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2017  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef __mast__elementwise_design_field__
+#define __mast__elementwise_design_field__
+
+// MAST includes
+#include "base/field_function_base.h"
+
+
+// libMesh includes
+#include "libmesh/system.h"
+#include "libmesh/elem.h"
+
+
+namespace MAST {
+    
+    /*!
+     *    Provides a property that is defined by a design value on each
+     *    element, for example the density of topology optimization. The
+     *    design values are the element-constant dofs of variable \p var
+     *    in a libMesh::System, typically a MONOMIAL CONSTANT variable in
+     *    an ExplicitSystem, so that they are stored in a distributed
+     *    vector with no objects created per element. A single property
+     *    card with this function can then be used for all elements.
+     *
+     *    The value on an element with design value \f$ \rho \f$ is
+     *    \f$ v_0 (v_{min} + (1 - v_{min}) g(\rho)) \f$, where
+     *    \f$ g(\rho) = \rho^p \f$ for SIMP and
+     *    \f$ g(\rho) = \rho/(1 + p(1 - \rho)) \f$ for RAMP interpolation.
+     *    The element on which the function is evaluated is identified by
+     *    current_elem(), which is set for the calling thread by
+     *    MAST::AssemblyBase before the element calculations.
+     *
+     *    The design value of each element is treated as a separate
+     *    parameter that only affects its element. The derivative of the
+     *    function with respect to \p this therefore is the derivative of
+     *    the value of an element with respect to its own design value,
+     *    so that element sensitivity calculations with \p this as the
+     *    sensitivity parameter return the element-local derivatives.
+     */
+    class ElementwiseDesignField:
+    public MAST::FieldFunction<Real> {
+        
+    public:
+
+        /*!
+         *   interpolation of the value from the design value
+         */
+        enum InterpolationType {
+            SIMP,
+            RAMP
+        };
+        
+        
+        /*!
+         *   creates the function with the base value \p v0 and a SIMP
+         *   interpolation with unit penalty, which is linear in the
+         *   design value.
+         */
+        ElementwiseDesignField(const std::string& nm,
+                               libMesh::System& sys,
+                               unsigned int var,
+                               Real v0);
+        
+        
+        virtual ~ElementwiseDesignField();
+        
+        
+        /*!
+         *   sets the interpolation type, the penalty \p p, and the
+         *   ratio \p v_min of the minimum value to the base value.
+         */
+        void set_interpolation(MAST::ElementwiseDesignField::InterpolationType t,
+                               Real p,
+                               Real v_min = 0.);
+        
+        
+        /*!
+         *   @returns the system that stores the design values
+         */
+        libMesh::System& system() {
+            return _sys;
+        }
+        
+        
+        /*!
+         *   @returns the index of the design value of \p e in the
+         *   solution vector of system()
+         */
+        libMesh::dof_id_type dof_index(const libMesh::Elem& e) const {
+            return e.dof_number(_sys.number(), _var, 0);
+        }
+        
+        
+        /*!
+         *   localizes the design values from the solution of system().
+         *   This must be called on all processors after the solution
+         *   is modified, and before the function is evaluated.
+         */
+        void update();
+        
+        
+        /*!
+         *   @returns the design value of element \p e
+         */
+        Real elem_design_value(const libMesh::Elem& e) const;
+        
+        
+        /*!
+         *   @returns the value on element \p e
+         */
+        Real elem_value(const libMesh::Elem& e) const;
+        
+        
+        /*!
+         *   @returns the derivative of the value on element \p e with
+         *   respect to its design value
+         */
+        Real elem_derivative(const libMesh::Elem& e) const;
+        
+        
+        /*!
+         *  @returns  \p true if \p f is this.
+         */
+        virtual bool depends_on(const MAST::FunctionBase& f) const {
+            return (&f == this);
+        }
+        
+        
+        /*!
+         *   calculates the value on current_elem()
+         */
+        virtual void operator() (const libMesh::Point& p,
+                                 const Real t,
+                                 Real& v) const;
+        
+        
+        /*!
+         *   calculates the derivative on current_elem() with respect to
+         *   its design value if \p f is this, and zero otherwise.
+         */
+        virtual void derivative (const MAST::FunctionBase& f,
+                                 const libMesh::Point& p,
+                                 const Real t,
+                                 Real& v) const;
+        
+        
+        /*!
+         *   fills \p v with the value on current_elem(), which is computed
+         *   once for all points in \p pts.
+         */
+        virtual void operator() (const std::vector<libMesh::Point>& pts,
+                                 const Real t,
+                                 std::vector<Real>& v) const;
+        
+        
+        /*!
+         *   fills \p v with the derivative on current_elem(), which is
+         *   computed once for all points in \p pts.
+         */
+        virtual void derivative (const MAST::FunctionBase& f,
+                                 const std::vector<libMesh::Point>& pts,
+                                 const Real t,
+                                 std::vector<Real>& v) const;
+        
+        
+        /*!
+         *   sets the element on which the functions are evaluated by the
+         *   calling thread
+         */
+        static void set_current_elem(const libMesh::Elem* e) {
+            _current_elem = e;
+        }
+        
+        
+        /*!
+         *   @returns the element on which the functions are evaluated
+         *   by the calling thread
+         */
+        static const libMesh::Elem* current_elem() {
+            return _current_elem;
+        }
+        
+    protected:
+        
+        /*!
+         *   @returns the value for design value \p rho, and its derivative
+         *   in \p dv
+         */
+        Real _interpolate(Real rho, Real& dv) const;
+        
+        
+        /*!
+         *   system and variable of the design values
+         */
+        libMesh::System&                         _sys;
+        
+        const unsigned int                       _var;
+        
+        /*!
+         *   base value, interpolation type, penalty and minimum value ratio
+         */
+        Real                                     _v0;
+        
+        MAST::ElementwiseDesignField::InterpolationType _type;
+        
+        Real                                     _penalty;
+        
+        Real                                     _v_min;
+        
+        /*!
+         *   element on which the calling thread evaluates the functions
+         */
+        static thread_local const libMesh::Elem* _current_elem;
+    };
+}
+
+
+#endif // __mast__elementwise_design_field__
@@ -23,6 +23,7 @@
 
 // C++ includes
 #include <memory>
+#include <vector>
 
 // MAST includes
 #include "base/function_base.h"
@@ -120,6 +121,64 @@ namespace MAST {
             libmesh_error(); // must be implemented in derived class
         }
         
+        
+        /*!
+         *    calculates the value of the function at all points in \p pts,
+         *    for example the quadrature points of an element, at time \p t
+         *    and returns them in \p v. This is a single call per element
+         *    in place of one virtual call per point. The default
+         *    implementation evaluates the function once if it is constant,
+         *    and otherwise at each point. Derived classes can reimplement
+         *    this to evaluate the points together.
+         */
+        virtual void operator() (const std::vector<libMesh::Point>& pts,
+                                 const Real t,
+                                 std::vector<ValType>& v) const {
+            
+            v.resize(pts.size());
+            
+            if (pts.empty())
+                return;
+            
+            if (this->is_constant()) {
+                
+                (*this)(pts[0], t, v[0]);
+                for (unsigned int i=1; i<pts.size(); i++)
+                    v[i] = v[0];
+            }
+            else
+                for (unsigned int i=0; i<pts.size(); i++)
+                    (*this)(pts[i], t, v[i]);
+        }
+        
+        
+        /*!
+         *    calculates the derivative of the function with respect to
+         *    \p f at all points in \p pts at time \p t and returns them
+         *    in \p v. The default implementation is the same as that of
+         *    the value.
+         */
+        virtual void derivative (const MAST::FunctionBase& f,
+                                 const std::vector<libMesh::Point>& pts,
+                                 const Real t,
+                                 std::vector<ValType>& v) const {
+            
+            v.resize(pts.size());
+            
+            if (pts.empty())
+                return;
+            
+            if (this->is_constant()) {
+                
+                this->derivative(f, pts[0], t, v[0]);
+                for (unsigned int i=1; i<pts.size(); i++)
+                    v[i] = v[0];
+            }
+            else
+                for (unsigned int i=0; i<pts.size(); i++)
+                    this->derivative(f, pts[i], t, v[i]);
+        }
+        
     protected:
     
     };
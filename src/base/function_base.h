@@ -41,7 +41,8 @@ namespace MAST
         FunctionBase(const std::string& nm ,
                      const bool is_field_func):
         _name(nm),
-        _is_field_func(is_field_func)
+        _is_field_func(is_field_func),
+        _version(0)
         { }
 
         
@@ -50,7 +51,8 @@ namespace MAST
          */
         FunctionBase(const MAST::FunctionBase& f):
         _name(f._name),
-        _is_field_func(f._is_field_func)
+        _is_field_func(f._is_field_func),
+        _version(f._version)
         { }
 
         
@@ -97,8 +99,93 @@ namespace MAST
             return false;
         }
         
+        
+        /*!
+         *  @returns true if the value of the function does not depend on
+         *  the spatial location or time, so that it may be evaluated once
+         *  for a given set of parameter values. False by default.
+         */
+        virtual bool is_constant() const {
+            return false;
+        }
+        
+        
+        /*!
+         *  adds to \p f the functions that \p this depends on, directly
+         *  or through other functions, and that themselves do not depend
+         *  on any function. For a function defined in terms of parameters,
+         *  these are the parameters.
+         */
+        void get_independent_functions(std::set<const MAST::FunctionBase*>& f) const {
+            
+            std::set<const MAST::FunctionBase*>::const_iterator
+            it = _functions.begin(), end = _functions.end();
+            
+            for ( ; it != end; it++) {
+                if ((*it)->_functions.empty())
+                    f.insert(*it);
+                else
+                    (*it)->get_independent_functions(f);
+            }
+        }
+        
+        
+        /*!
+         *  @returns a counter that changes whenever the value of this
+         *  function may have changed for a given location and time. This
+         *  is the sum of the own changes of the function, for example due
+         *  to an update of a solution it interpolates, and of the versions
+         *  of all functions that it depends on. A parameter changes its
+         *  version when its value is modified. Caches of values computed
+         *  from a function can store its version, and are valid as long
+         *  as the version is unchanged.
+         */
+        virtual unsigned long long version() const {
+            
+            unsigned long long v = _version;
+            
+            std::set<const MAST::FunctionBase*>::const_iterator
+            it = _functions.begin(), end = _functions.end();
+            for ( ; it != end; it++)
+                v += (*it)->version();
+            
+            return v;
+        }
+        
+        
     protected:
         
+        /*!
+         *  increments the own version of this function. This should be
+         *  called by derived classes when their value changes in a way
+         *  other than through the functions in \p _functions.
+         */
+        void _increment_version() {
+            _version++;
+        }
+        
+        
+        /*!
+         *  @returns true if \p this depends on at least one function, and
+         *  all of them are constant. Functions whose value is defined
+         *  entirely by the functions in \p _functions can use this to
+         *  implement is_constant().
+         */
+        bool _if_dependent_functions_constant() const {
+            
+            if (_functions.empty())
+                return false;
+            
+            std::set<const MAST::FunctionBase*>::const_iterator
+            it = _functions.begin(), end = _functions.end();
+            for ( ; it != end; it++)
+                if (!(*it)->is_constant())
+                    return false;
+            
+            return true;
+        }
+        
+        
         /*!
          *    name of this parameter
          */
@@ -113,6 +200,12 @@ namespace MAST
          *   set of functions that \p this function depends on
          */
         std::set<const MAST::FunctionBase*> _functions;
+        
+        /*!
+         *   number of own changes of this function. This is mutable since
+         *   the version of a parameter is updated when it is queried.
+         */
+        mutable unsigned long long _version;
     };
     
 }
@@ -72,3 +72,18 @@ MAST::FunctionSetBase::depends_on(const MAST::FunctionBase& f) const {
     // if it gets here, then there is no dependency
     return false;
 }
+
+
+
+bool
+MAST::FunctionSetBase::is_constant() const {
+    
+    std::map<std::string, MAST::FunctionBase*>::const_iterator
+    it = _properties.begin(), end = _properties.end();
+    for ( ; it!=end; it++) {
+        if (!it->second->is_constant())
+            return false;
+    }
+    
+    return true;
+}
@@ -96,6 +96,13 @@ namespace MAST {
          *  returns true if the property card depends on the function \p f
          */
         virtual bool depends_on(const MAST::FunctionBase& f) const;
+        
+        
+        /*!
+         *  @returns true if all functions in this card are independent of
+         *  location and time.
+         */
+        virtual bool is_constant() const;
 
         
     protected:
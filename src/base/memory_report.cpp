@@ -0,0 +1,418 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2017  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+// C++ includes
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+#include <sys/resource.h>
+#include <unistd.h>
+
+// MAST includes
+#include "base/memory_report.h"
+#include "base/nonlinear_system.h"
+#include "base/assembly_base.h"
+#include "elasticity/stress_output_base.h"
+#include "elasticity/gaf_database.h"
+#include "aeroelasticity/flutter_solver_base.h"
+
+// libMesh includes
+#include "libmesh/numeric_vector.h"
+#include "libmesh/petsc_vector.h"
+#include "libmesh/petsc_matrix.h"
+
+
+MAST::MemoryReport::
+MemoryReport(const libMesh::Parallel::Communicator& comm_in):
+libMesh::ParallelObject (comm_in),
+_peak_total             (0) {
+    
+}
+
+
+
+MAST::MemoryReport::~MemoryReport() {
+    
+}
+
+
+
+void
+MAST::MemoryReport::add_system(MAST::NonlinearSystem& sys) {
+    
+    _systems.push_back(&sys);
+}
+
+
+
+void
+MAST::MemoryReport::add_assembly(const std::string& nm,
+                                 MAST::AssemblyBase& assembly) {
+    
+    _assemblies.push_back(std::make_pair(nm, &assembly));
+}
+
+
+
+void
+MAST::MemoryReport::add_stress_output(const std::string& nm,
+                                      MAST::StressStrainOutputBase& output) {
+    
+    _stress_outputs.push_back(std::make_pair(nm, &output));
+}
+
+
+
+void
+MAST::MemoryReport::add_flutter_solver(const std::string& nm,
+                                       MAST::FlutterSolverBase& solver) {
+    
+    _flutter_solvers.push_back(std::make_pair(nm, &solver));
+}
+
+
+
+void
+MAST::MemoryReport::add_gaf_database(const std::string& nm,
+                                     MAST::GAFDatabase& gaf) {
+    
+    _gaf_databases.push_back(std::make_pair(nm, &gaf));
+}
+
+
+
+void
+MAST::MemoryReport::clear() {
+    
+    _systems.clear();
+    _assemblies.clear();
+    _stress_outputs.clear();
+    _flutter_solvers.clear();
+    _gaf_databases.clear();
+    _current.clear();
+    _peak.clear();
+    _phases.clear();
+    _peak_total = 0;
+}
+
+
+
+void
+MAST::MemoryReport::add(const std::string& obj,
+                        const std::string& item,
+                        std::size_t bytes) {
+    
+    _current[std::make_pair(obj, item)] += bytes;
+}
+
+
+
+void
+MAST::MemoryReport::record_phase(const std::string& nm) {
+    
+    _current.clear();
+    
+    for (unsigned int i=0; i<_systems.size(); i++)
+        _systems[i]->report_memory(*this);
+    
+    for (unsigned int i=0; i<_assemblies.size(); i++)
+        _assemblies[i].second->report_memory(*this, _assemblies[i].first);
+    
+    for (unsigned int i=0; i<_stress_outputs.size(); i++)
+        _stress_outputs[i].second->report_memory(*this, _stress_outputs[i].first);
+    
+    for (unsigned int i=0; i<_flutter_solvers.size(); i++)
+        _flutter_solvers[i].second->report_memory(*this, _flutter_solvers[i].first);
+    
+    for (unsigned int i=0; i<_gaf_databases.size(); i++)
+        _gaf_databases[i].second->report_memory(*this, _gaf_databases[i].first);
+    
+    PhaseData d;
+    d.nm            = nm;
+    d.bytes         = this->current_bytes();
+    d.resident      = MAST::MemoryReport::resident_bytes();
+    d.peak_resident = MAST::MemoryReport::peak_resident_bytes();
+    _phases.push_back(d);
+    
+    std::map<ItemType, std::size_t>::const_iterator
+    it   = _current.begin(),
+    end  = _current.end();
+    
+    for ( ; it != end; it++) {
+        
+        std::size_t& v = _peak[it->first];
+        v = std::max(v, it->second);
+    }
+    
+    _peak_total = std::max(_peak_total, d.bytes);
+}
+
+
+
+std::size_t
+MAST::MemoryReport::current_bytes() const {
+    
+    std::size_t v = 0;
+    
+    std::map<ItemType, std::size_t>::const_iterator
+    it   = _current.begin(),
+    end  = _current.end();
+    
+    for ( ; it != end; it++)
+        v += it->second;
+    
+    return v;
+}
+
+
+
+namespace MAST {
+    
+    /*!
+     *   writes the minimum, maximum and sum over the processors of \p v
+     *   in MB
+     */
+    inline void
+    __write_memory_stats(std::ostream& o,
+                         const libMesh::Parallel::Communicator& comm,
+                         std::size_t v) {
+        
+        const Real
+        mb    = 1024.*1024.;
+        
+        Real
+        v_min = v/mb,
+        v_max = v/mb,
+        v_sum = v/mb;
+        
+        comm.min(v_min);
+        comm.max(v_max);
+        comm.sum(v_sum);
+        
+        o
+        << std::setw(14) << v_min
+        << std::setw(14) << v_max
+        << std::setw(14) << v_sum;
+    }
+}
+
+
+
+void
+MAST::MemoryReport::print(std::ostream& o) const {
+    
+    // all processors must have the same items and phases
+    libmesh_assert(this->comm().verify(_peak.size()));
+    libmesh_assert(this->comm().verify(_phases.size()));
+    
+    const bool
+    write = this->comm().rank() == 0;
+    
+    std::streamsize p = o.precision();
+    o.precision(4);
+    
+    if (write)
+        o
+        << "Memory (MB) on " << this->comm().size() << " processors" << std::endl
+        << std::setw(50) << std::left << "object: item" << std::right
+        << std::setw(42) << "at end of last phase: min / max / sum"
+        << std::setw(42) << "peak: min / max / sum"
+        << std::endl;
+    
+    std::map<ItemType, std::size_t>::const_iterator
+    it   = _peak.begin(),
+    end  = _peak.end();
+    
+    for ( ; it != end; it++) {
+        
+        std::map<ItemType, std::size_t>::const_iterator
+        c_it = _current.find(it->first);
+        
+        std::ostringstream s;
+        
+        MAST::__write_memory_stats(s, this->comm(),
+                                   c_it != _current.end()? c_it->second: 0);
+        MAST::__write_memory_stats(s, this->comm(), it->second);
+        
+        if (write)
+            o
+            << std::setw(50) << std::left
+            << (it->first.first + ": " + it->first.second) << std::right
+            << s.str() << std::endl;
+    }
+    
+    
+    if (write)
+        o
+        << std::endl
+        << std::setw(50) << std::left << "phase" << std::right
+        << std::setw(42) << "objects: min / max / sum"
+        << std::setw(42) << "resident: min / max / sum"
+        << std::setw(42) << "peak resident: min / max / sum"
+        << std::endl;
+    
+    for (unsigned int i=0; i<_phases.size(); i++) {
+        
+        std::ostringstream s;
+        
+        MAST::__write_memory_stats(s, this->comm(), _phases[i].bytes);
+        MAST::__write_memory_stats(s, this->comm(), _phases[i].resident);
+        MAST::__write_memory_stats(s, this->comm(), _phases[i].peak_resident);
+        
+        if (write)
+            o
+            << std::setw(50) << std::left << _phases[i].nm << std::right
+            << s.str() << std::endl;
+    }
+    
+    o.precision(p);
+}
+
+
+
+std::size_t
+MAST::MemoryReport::bytes(const libMesh::NumericVector<Real>& v) {
+    
+    const libMesh::PetscVector<Real>*
+    pv = dynamic_cast<const libMesh::PetscVector<Real>*>(&v);
+    
+    if (!pv || !v.initialized())
+        return v.initialized()? v.local_size()*sizeof(Real): 0;
+    
+    PetscErrorCode ierr = 0;
+    Vec            vec  = const_cast<libMesh::PetscVector<Real>*>(pv)->vec();
+    Vec            local_form;
+    PetscInt       n    = 0;
+    
+    // the local form of a ghosted vector includes the ghost values
+    ierr = VecGhostGetLocalForm(vec, &local_form); CHKERRABORT(v.comm().get(), ierr);
+    
+    if (local_form) {
+        ierr = VecGetLocalSize(local_form, &n);    CHKERRABORT(v.comm().get(), ierr);
+    }
+    else {
+        ierr = VecGetLocalSize(vec, &n);           CHKERRABORT(v.comm().get(), ierr);
+    }
+    
+    ierr = VecGhostRestoreLocalForm(vec, &local_form); CHKERRABORT(v.comm().get(), ierr);
+    
+    return n * sizeof(Real);
+}
+
+
+
+std::size_t
+MAST::MemoryReport::bytes(const libMesh::SparseMatrix<Real>& m) {
+    
+    const libMesh::PetscMatrix<Real>*
+    pm = dynamic_cast<const libMesh::PetscMatrix<Real>*>(&m);
+    
+    if (!pm || !m.initialized())
+        return 0;
+    
+    return MAST::MemoryReport::bytes(const_cast<libMesh::PetscMatrix<Real>*>(pm)->mat());
+}
+
+
+
+std::size_t
+MAST::MemoryReport::bytes(Mat m) {
+    
+    if (!m)
+        return 0;
+    
+    MatInfo info;
+    PetscErrorCode ierr = MatGetInfo(m, MAT_LOCAL, &info);
+    CHKERRABORT(PetscObjectComm((PetscObject)m), ierr);
+    
+    return (std::size_t)info.memory;
+}
+
+
+
+std::size_t
+MAST::MemoryReport::factorization_bytes(KSP ksp) {
+    
+    if (!ksp)
+        return 0;
+    
+    PetscErrorCode ierr = 0;
+    PC             pc;
+    PetscBool      if_factor = PETSC_FALSE;
+    Mat            F         = nullptr;
+    
+    ierr = KSPGetPC(ksp, &pc);  CHKERRABORT(PetscObjectComm((PetscObject)ksp), ierr);
+    ierr = PetscObjectTypeCompareAny((PetscObject)pc, &if_factor,
+                                     PCLU, PCILU, PCCHOLESKY, PCICC, "");
+    CHKERRABORT(PetscObjectComm((PetscObject)ksp), ierr);
+    
+    if (!if_factor)
+        return 0;
+    
+    // the factored matrix is not available before the preconditioner is
+    // setup, which is not an error for this report
+    ierr = PetscPushErrorHandler(PetscReturnErrorHandler, nullptr);
+    CHKERRABORT(PetscObjectComm((PetscObject)ksp), ierr);
+    
+    PetscErrorCode ierr_f = PCFactorGetMatrix(pc, &F);
+    
+    ierr = PetscPopErrorHandler();
+    CHKERRABORT(PetscObjectComm((PetscObject)ksp), ierr);
+    
+    if (ierr_f)
+        return 0;
+    
+    return MAST::MemoryReport::bytes(F);
+}
+
+
+
+std::size_t
+MAST::MemoryReport::resident_bytes() {
+    
+    std::size_t
+    pages    = 0,
+    resident = 0;
+    
+    std::ifstream statm("/proc/self/statm");
+    
+    if (statm >> pages >> resident)
+        return resident * (std::size_t)sysconf(_SC_PAGESIZE);
+    
+    return 0;
+}
+
+
+
+std::size_t
+MAST::MemoryReport::peak_resident_bytes() {
+    
+    struct rusage usage;
+    
+    if (getrusage(RUSAGE_SELF, &usage))
+        return 0;
+    
+#ifdef __APPLE__
+    return (std::size_t)usage.ru_maxrss;
+#else
+    return (std::size_t)usage.ru_maxrss * 1024;
+#endif
+}
+
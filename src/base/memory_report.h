@@ -0,0 +1,263 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2017  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef __mast__memory_report_h__
+#define __mast__memory_report_h__
+
+// C++ includes
+#include <string>
+#include <vector>
+#include <map>
+#include <iostream>
+
+// MAST includes
+#include "base/mast_data_types.h"
+
+// libMesh includes
+#include "libmesh/parallel_object.h"
+
+// PETSc includes
+#include <petscmat.h>
+#include <petscksp.h>
+
+
+namespace libMesh {
+    
+    // Forward declerations
+    template <typename T> class NumericVector;
+    template <typename T> class SparseMatrix;
+}
+
+
+namespace MAST {
+    
+    // Forward declerations
+    class NonlinearSystem;
+    class AssemblyBase;
+    class StressStrainOutputBase;
+    class FlutterSolverBase;
+    class GAFDatabase;
+    
+    
+    /*!
+     *   Reports the memory used on each processor by the data stored in
+     *   MAST objects: the system matrices and vectors, the stored stress
+     *   data, the flutter solutions, the GAF databases and the element
+     *   caches of the assemblies. The objects are registered with the
+     *   add_* methods. record_phase() asks each registered object to
+     *   report its data, and stores the total and the process memory at
+     *   the end of the phase, along with the peak of each item over all
+     *   phases. A system that has this report attached with
+     *   NonlinearSystem::set_memory_report() records a phase at the end of
+     *   each of its solves.
+     *
+     *   The bytes of the sparse matrices and of the factorizations are
+     *   provided by PETSc. For the dense and vector data, the size of the
+     *   values is reported.
+     */
+    class MemoryReport:
+    public libMesh::ParallelObject {
+        
+    public:
+        
+        MemoryReport(const libMesh::Parallel::Communicator& comm_in);
+        
+        virtual ~MemoryReport();
+        
+        
+        /*!
+         *   registers the objects that report their memory in
+         *   record_phase(). \p nm identifies the object in the report. The
+         *   objects must exist as long as phases are recorded.
+         */
+        void add_system(MAST::NonlinearSystem& sys);
+        
+        void add_assembly(const std::string& nm,
+                          MAST::AssemblyBase& assembly);
+        
+        void add_stress_output(const std::string& nm,
+                               MAST::StressStrainOutputBase& output);
+        
+        void add_flutter_solver(const std::string& nm,
+                                MAST::FlutterSolverBase& solver);
+        
+        void add_gaf_database(const std::string& nm,
+                              MAST::GAFDatabase& gaf);
+        
+        
+        /*!
+         *   clears the registered objects and the recorded phases
+         */
+        void clear();
+        
+        
+        /*!
+         *   adds \p bytes to \p item of the object \p obj for the phase
+         *   being recorded. This is called by the report_memory() methods
+         *   of the objects, which must add the same items on all
+         *   processors.
+         */
+        void add(const std::string& obj,
+                 const std::string& item,
+                 std::size_t bytes);
+        
+        
+        /*!
+         *   collects the memory of all registered objects, and records it
+         *   as the memory at the end of phase \p nm
+         */
+        void record_phase(const std::string& nm);
+        
+        
+        /*!
+         *   @returns the bytes of all items at the end of the last phase
+         *   on this processor
+         */
+        std::size_t current_bytes() const;
+        
+        
+        /*!
+         *   @returns the maximum of the bytes of all items at the end of
+         *   the phases recorded on this processor
+         */
+        std::size_t peak_bytes() const {
+            return _peak_total;
+        }
+        
+        
+        /*!
+         *   writes the bytes of each item at the end of the last phase and
+         *   its peak over all phases, followed by the total of each phase,
+         *   as the minimum, maximum and sum over the processors. This must
+         *   be called on all processors.
+         */
+        void print(std::ostream& o) const;
+        
+        
+        /*!
+         *   @returns the bytes of the local values, including ghosts, of
+         *   \p v
+         */
+        static std::size_t bytes(const libMesh::NumericVector<Real>& v);
+        
+        
+        /*!
+         *   @returns the bytes used by PETSc for the local rows of \p m.
+         *   Zero is returned for matrices that are not PETSc matrices.
+         */
+        static std::size_t bytes(const libMesh::SparseMatrix<Real>& m);
+        
+        
+        /*!
+         *   @returns the bytes used by PETSc for the local rows of \p m
+         */
+        static std::size_t bytes(Mat m);
+        
+        
+        /*!
+         *   @returns the bytes of the factored matrix of the preconditioner
+         *   of \p ksp if it uses a factorization that has been computed,
+         *   and zero otherwise.
+         */
+        static std::size_t factorization_bytes(KSP ksp);
+        
+        
+        /*!
+         *   @returns the bytes of the values of a vector
+         */
+        template <typename ValType>
+        static std::size_t bytes(const std::vector<ValType>& v) {
+            return v.capacity() * sizeof(ValType);
+        }
+        
+        
+        /*!
+         *   @returns the bytes of the values of a dense matrix or vector
+         */
+        template <typename Derived>
+        static std::size_t dense_bytes(const Eigen::EigenBase<Derived>& m) {
+            return m.size() * sizeof(typename Derived::Scalar);
+        }
+        
+        
+        /*!
+         *   @returns the resident memory of this process, and the maximum
+         *   resident memory since the start of the process
+         */
+        static std::size_t resident_bytes();
+        
+        static std::size_t peak_resident_bytes();
+        
+    protected:
+        
+        /*!
+         *   object and item names
+         */
+        typedef std::pair<std::string, std::string> ItemType;
+        
+        
+        /*!
+         *   data recorded at the end of a phase
+         */
+        struct PhaseData {
+            
+            PhaseData(): bytes(0), resident(0), peak_resident(0) { }
+            
+            std::string  nm;
+            std::size_t  bytes, resident, peak_resident;
+        };
+        
+        
+        /*!
+         *   registered objects
+         */
+        std::vector<MAST::NonlinearSystem*>                         _systems;
+        
+        std::vector<std::pair<std::string, MAST::AssemblyBase*> >   _assemblies;
+        
+        std::vector<std::pair<std::string, MAST::StressStrainOutputBase*> >
+        _stress_outputs;
+        
+        std::vector<std::pair<std::string, MAST::FlutterSolverBase*> >
+        _flutter_solvers;
+        
+        std::vector<std::pair<std::string, MAST::GAFDatabase*> >    _gaf_databases;
+        
+        /*!
+         *   bytes of each item at the end of the last phase, and the
+         *   maximum over all phases
+         */
+        std::map<ItemType, std::size_t>                             _current;
+        
+        std::map<ItemType, std::size_t>                             _peak;
+        
+        /*!
+         *   maximum total bytes over all phases
+         */
+        std::size_t                                                 _peak_total;
+        
+        /*!
+         *   recorded phases
+         */
+        std::vector<PhaseData>                                      _phases;
+    };
+}
+
+
+#endif // __mast__memory_report_h__
@@ -21,6 +21,7 @@
 #include "base/mesh_field_function.h"
 #include "base/system_initialization.h"
 #include "base/nonlinear_system.h"
+#include "base/mesh_field_transfer_operator.h"
 
 // libMesh includes
 #include "libmesh/dof_map.h"
@@ -30,13 +31,17 @@ MAST::MeshFieldFunction::
 MeshFieldFunction(MAST::SystemInitialization& sys,
                   const std::string& nm):
 MAST::FieldFunction<RealVectorX>(nm),
+_initialized(false),
+_local_interpolation(false),
 _use_qp_sol(false),
 _qp_sol(),
 _system(&sys),
 _sol(nullptr),
 _dsol(nullptr),
 _function(nullptr),
-_perturbed_function(nullptr)
+_perturbed_function(nullptr),
+_transfer(nullptr),
+_point_value_cache(false)
 { }
 
 
@@ -45,6 +50,19 @@ _perturbed_function(nullptr)
 MAST::MeshFieldFunction::~MeshFieldFunction() {
  
     this->clear();
+    this->clear_localized_data();
+}
+
+
+
+
+void
+MAST::MeshFieldFunction::set_local_interpolation(bool f) {
+    
+    libmesh_assert(!_initialized);
+    
+    this->clear_localized_data();
+    _local_interpolation = f;
 }
 
 
@@ -65,20 +83,47 @@ MAST::MeshFieldFunction::operator() (const libMesh::Point& p,
         return;
     }
     
-    // make sure that the object was initialized
-    libmesh_assert(_function);
-    
-    DenseRealVector v1;
-    (*_function)(p, t, v1);
+    if (_point_value_cache) {
+        
+        std::lock_guard<std::mutex> lock(_cache_mutex);
+        
+        std::map<libMesh::Point, RealVectorX>::const_iterator
+        it = _point_values.find(p);
+        
+        if (it != _point_values.end()) {
+            v = it->second;
+            return;
+        }
+    }
     
-    // make sure that the mesh function was able to find the element
-    // and a solution
-    libmesh_assert(v1.size());
+    if (_transfer) {
+        
+        libmesh_assert(_sol);
+        _transfer->interpolate(p, *_sol, v);
+    }
+    else {
+        
+        // make sure that the object was initialized
+        libmesh_assert(_function);
+        
+        DenseRealVector v1;
+        (*_function)(p, t, v1);
+        
+        // make sure that the mesh function was able to find the element
+        // and a solution
+        libmesh_assert(v1.size());
+        
+        // now copy this to the output vector
+        v = RealVectorX::Zero(v1.size());
+        for (unsigned int i=0; i<v1.size(); i++)
+            v(i) = v1(i);
+    }
     
-    // now copy this to the output vector
-    v = RealVectorX::Zero(v1.size());
-    for (unsigned int i=0; i<v1.size(); i++)
-        v(i) = v1(i);
+    if (_point_value_cache) {
+        
+        std::lock_guard<std::mutex> lock(_cache_mutex);
+        _point_values[p] = v;
+    }
 }
 
 
@@ -98,6 +143,13 @@ MAST::MeshFieldFunction::perturbation(const libMesh::Point& p,
         return;
     }
     
+    if (_transfer) {
+        
+        libmesh_assert(_dsol);
+        _transfer->interpolate(p, *_dsol, v);
+        return;
+    }
+    
     // make sure that the object was initialized
     libmesh_assert(_perturbed_function);
     
@@ -117,6 +169,64 @@ MAST::MeshFieldFunction::perturbation(const libMesh::Point& p,
 
 
 
+void
+MAST::MeshFieldFunction::gradient(const libMesh::Point& p,
+                                  const Real t,
+                                  RealMatrixX& dv) const {
+    
+    if (_transfer) {
+        
+        libmesh_assert(_sol);
+        _transfer->interpolate_gradient(p, *_sol, dv);
+        return;
+    }
+    
+    // make sure that the object was initialized
+    libmesh_assert(_function);
+    
+    std::vector<libMesh::Gradient> g;
+    _function->gradient(p, t, g);
+    
+    libmesh_assert(g.size());
+    
+    dv = RealMatrixX::Zero(g.size(), 3);
+    for (unsigned int i=0; i<g.size(); i++)
+        for (unsigned int j=0; j<3; j++)
+            dv(i, j) = g[i](j);
+}
+
+
+
+
+void
+MAST::MeshFieldFunction::perturbation_gradient(const libMesh::Point& p,
+                                               const Real t,
+                                               RealMatrixX& dv) const {
+    
+    if (_transfer) {
+        
+        libmesh_assert(_dsol);
+        _transfer->interpolate_gradient(p, *_dsol, dv);
+        return;
+    }
+    
+    // make sure that the object was initialized
+    libmesh_assert(_perturbed_function);
+    
+    std::vector<libMesh::Gradient> g;
+    _perturbed_function->gradient(p, t, g);
+    
+    libmesh_assert(g.size());
+    
+    dv = RealMatrixX::Zero(g.size(), 3);
+    for (unsigned int i=0; i<g.size(); i++)
+        for (unsigned int j=0; j<3; j++)
+            dv(i, j) = g[i](j);
+}
+
+
+
+
 void
 MAST::MeshFieldFunction::derivative (const MAST::FunctionBase& f,
                                      const libMesh::Point& p,
@@ -138,56 +248,143 @@ init(const libMesh::NumericVector<Real>& sol,
     
     
     // first make sure that the object is not already initialized
-    libmesh_assert(!_function);
+    libmesh_assert(!_initialized);
+    
+    // the interpolated solution changes with each initialization
+    _increment_version();
+    
+    _initialized = true;
+    
+    {
+        std::lock_guard<std::mutex> lock(_cache_mutex);
+        _point_values.clear();
+    }
+    
+    // the retained vectors and mesh functions only need the new values
+    if (_local_interpolation) {
+        
+        _localize_retained(sol, _sol, _function);
+        if (dsol)
+            _localize_retained(*dsol, _dsol, _perturbed_function);
+        
+        return;
+    }
     
     MAST::NonlinearSystem& system = _system->system();
     
-    // next, clone this solution and localize to the sendlist
-    _sol = libMesh::NumericVector<Real>::build(system.comm()).release();
-
-    const std::vector<libMesh::dof_id_type>& send_list =
-    system.get_dof_map().get_send_list();
-    
-    // initialize and then localize the vector with the provided solution
-    /*_sol->init(system.n_dofs(),
-                       system.n_local_dofs(),
-                       send_list,
-                       false,
-                       libMesh::GHOSTED);
-    sol.localize(*_sol, send_list);*/
-    _sol->init(sol.size(), true, libMesh::SERIAL);
-    sol.localize(*_sol);
-    
-    // finally, create the mesh interpolation function
-    _function = new libMesh::MeshFunction(system.get_equation_systems(),
-                                                       *_sol,
-                                                       system.get_dof_map(),
-                                                       _system->vars());
-    _function->init();
+    // the vector stores the values needed for interpolation, which is
+    // only the ghosted part of the solution for a distributed mesh
+    _sol = MAST::build_localized_interpolation_vector(*_system, sol, _transfer);
+    
+    // finally, create the mesh interpolation function, unless the
+    // transfer operator is used
+    if (!_transfer) {
+        _function = new libMesh::MeshFunction(system.get_equation_systems(),
+                                              *_sol,
+                                              system.get_dof_map(),
+                                              _system->vars());
+        _function->init();
+    }
     
     if (dsol) {
 
-        _dsol = libMesh::NumericVector<Real>::build(system.comm()).release();
+        _dsol = MAST::build_localized_interpolation_vector(*_system, *dsol, _transfer);
+        
+        // finally, create the mesh interpolation function
+        if (!_transfer) {
+            _perturbed_function =
+            new libMesh::MeshFunction(system.get_equation_systems(),
+                                      *_dsol,
+                                      system.get_dof_map(),
+                                      _system->vars());
+            _perturbed_function->init();
+        }
+
+    }
+}
+
+
+
 
-        /*_dsol->init(system.n_dofs(),
-                            system.n_local_dofs(),
-                            send_list,
-                            false,
-                            libMesh::GHOSTED);
-         dsol->localize(*_dsol, send_list);*/
-        _dsol->init(dsol->size(), true, libMesh::SERIAL);
-        dsol->localize(*_sol);
+bool
+MAST::MeshFieldFunction::
+update(const libMesh::NumericVector<Real>& sol,
+       const libMesh::NumericVector<Real>* dsol) {
+    
+    libmesh_assert(_initialized);
+    libmesh_assert(_sol);
+    libmesh_assert(!dsol || _dsol);
+    
+    bool
+    changed = MAST::update_localized_interpolation_vector(*_system, sol, *_sol, _transfer);
+    
+    if (dsol &&
+        MAST::update_localized_interpolation_vector(*_system, *dsol, *_dsol, _transfer))
+        changed = true;
+    
+    if (changed) {
         
+        _increment_version();
         
-        // finally, create the mesh interpolation function
-        _perturbed_function =
-        new libMesh::MeshFunction(system.get_equation_systems(),
-                                  *_dsol,
-                                  system.get_dof_map(),
-                                  _system->vars());
-        _perturbed_function->init();
+        std::lock_guard<std::mutex> lock(_cache_mutex);
+        _point_values.clear();
+    }
+    
+    return changed;
+}
+
 
+
+
+void
+MAST::MeshFieldFunction::
+_localize_retained(const libMesh::NumericVector<Real>& sol,
+                   libMesh::NumericVector<Real>*& vec,
+                   libMesh::MeshFunction*& func) {
+    
+    MAST::NonlinearSystem& system = _system->system();
+    
+    // the retained data is rebuilt if the dof numbering has changed
+    if (vec &&
+        (vec->size()       != system.n_dofs() ||
+         vec->local_size() != system.n_local_dofs())) {
+        
+        delete func;
+        delete vec;
+        func = nullptr;
+        vec  = nullptr;
     }
+    
+    std::vector<libMesh::dof_id_type>
+    ghost_dofs;
+    
+    if (_transfer)
+        _transfer->get_ghost_dof_indices(ghost_dofs);
+    else
+        ghost_dofs = system.get_dof_map().get_send_list();
+    
+    if (!vec) {
+        
+        vec = libMesh::NumericVector<Real>::build(system.comm()).release();
+        vec->init(system.n_dofs(),
+                  system.n_local_dofs(),
+                  ghost_dofs,
+                  false,
+                  libMesh::GHOSTED);
+        
+        // the mesh function keeps a reference to the vector, and its
+        // point locator, for the subsequent initializations
+        if (!_transfer) {
+            
+            func = new libMesh::MeshFunction(system.get_equation_systems(),
+                                             *vec,
+                                             system.get_dof_map(),
+                                             _system->vars());
+            func->init();
+        }
+    }
+    
+    sol.localize(*vec, ghost_dofs);
 }
 
 
@@ -196,12 +393,34 @@ init(const libMesh::NumericVector<Real>& sol,
 void
 MAST::MeshFieldFunction::clear() {
     
+    // the localized data is deleted, unless it is retained for the
+    // next initialization
+    if (!_local_interpolation)
+        this->clear_localized_data();
+    
+    _initialized = false;
+    
+    // clear flags for quadrature point solution
+    _use_qp_sol = false;
+    
+    std::lock_guard<std::mutex> lock(_cache_mutex);
+    _point_values.clear();
+}
+
+
+
+
+void
+MAST::MeshFieldFunction::clear_localized_data() {
+    
     // if a pointer has been attached, then delete it and the
     // associated vector, and clear the associated system
     if (_function) {
         delete _function;
         _function = nullptr;
-        
+    }
+    
+    if (_sol) {
         delete _sol;
         _sol = nullptr;
     }
@@ -209,14 +428,12 @@ MAST::MeshFieldFunction::clear() {
     if (_perturbed_function) {
         delete _perturbed_function;
         _perturbed_function = nullptr;
-        
+    }
+    
+    if (_dsol) {
         delete _dsol;
         _dsol = nullptr;
     }
-
-    
-    // clear flags for quadrature point solution
-    _use_qp_sol = false;
 }
 
 
@@ -20,6 +20,11 @@
 #ifndef __mast__mesh_field_function__
 #define __mast__mesh_field_function__
 
+// C++ includes
+#include <map>
+#include <mutex>
+
+
 // MAST includes
 #include "base/field_function_base.h"
 
@@ -34,6 +39,7 @@ namespace MAST {
 
     // Forward declerations
     class SystemInitialization;
+    class MeshFieldTransferOperator;
     
     
     /*!
@@ -86,6 +92,60 @@ namespace MAST {
                                  RealVectorX& v) const;
         
         
+        /*!
+         *    calculates the spatial gradient of the function at the 
+         *    specified point, \par p, and time, \par t, and returns it in 
+         *    \p dv. Row i of \p dv is the gradient of variable i.
+         */
+        void gradient (const libMesh::Point& p,
+                       const Real t,
+                       RealMatrixX& dv) const;
+        
+        
+        /*!
+         *    calculates the spatial gradient of the perturbation in the
+         *    function at the specified point, \par p, and time, \par t, 
+         *    and returns it in \p dv.
+         */
+        void perturbation_gradient (const libMesh::Point& p,
+                                    const Real t,
+                                    RealMatrixX& dv) const;
+        
+        
+        /*!
+         *   tells the function to interpolate with the sparse interpolation
+         *   data of \p op, instead of libMesh::MeshFunction objects. 
+         *   This avoids the point search and FE reinitialization for points
+         *   that were evaluated before, for example with solutions
+         *   provided in prior calls to init(). \p op must be created for
+         *   the system of this function. This should be called before 
+         *   init(), and a nullptr restores the use of libMesh::MeshFunction.
+         */
+        void set_transfer_operator(MAST::MeshFieldTransferOperator* op) {
+            
+            libmesh_assert(!_initialized);
+            this->clear_localized_data();
+            _transfer = op;
+        }
+        
+        
+        /*!
+         *   if \p f is true, the function is only evaluated at points in
+         *   the local elements and in the elements ghosted on this
+         *   processor, for example at the quadrature points of the elements
+         *   of the same system during assembly. The solution is then
+         *   localized to a vector ghosted with the send list of the dof
+         *   map, instead of a serial vector on a replicated mesh. The
+         *   localized vectors and the libMesh::MeshFunction objects, with
+         *   their point locators, are also retained by clear(), and init()
+         *   only updates the values of the vectors. They are rebuilt if
+         *   the number of dofs changes, and clear_localized_data() must
+         *   be called if the mesh or the dof numbering changes otherwise.
+         *   This is \p false by default.
+         */
+        void set_local_interpolation(bool f);
+        
+        
         /*!
          *   initializes the data structures to perform the interpolation 
          *   function of \par sol. If \p dsol is provided, then it is used
@@ -93,6 +153,41 @@ namespace MAST {
          */
         void init(const libMesh::NumericVector<Real>& sol,
                   const libMesh::NumericVector<Real>* dsol = nullptr);
+        
+        
+        /*!
+         *   replaces the interpolated solution of an initialized function
+         *   with \p sol, and its perturbation with \p dsol if provided,
+         *   which must have the layout of the vectors passed to init().
+         *   The localized vectors, their ghosting, and the
+         *   libMesh::MeshFunction objects or the transfer operator data are
+         *   retained, and only the values are copied. If the values are the
+         *   same as those already interpolated, nothing is communicated
+         *   beyond the comparison, and the version of the function and the
+         *   cached point values are retained. This is intended for the
+         *   coupling iterations of multiphysics problems, where the
+         *   function is updated with a new iterate of the other discipline.
+         *   @returns \p true if the values have changed.
+         */
+        bool update(const libMesh::NumericVector<Real>& sol,
+                    const libMesh::NumericVector<Real>* dsol = nullptr);
+        
+        
+        /*!
+         *   if \p f is true, the values interpolated by operator() are
+         *   stored for each point, and returned for subsequent evaluations
+         *   at the same point until the solution is changed by init() or
+         *   update(). This is useful when the function is evaluated at the
+         *   same points, for example at the quadrature points of a
+         *   discipline's elements, across coupling iterations in which the
+         *   solution does not change. This is \p false by default.
+         */
+        void set_point_value_cache(bool f) {
+            
+            std::lock_guard<std::mutex> lock(_cache_mutex);
+            _point_value_cache = f;
+            _point_values.clear();
+        }
 
         
         /*!
@@ -133,12 +228,38 @@ namespace MAST {
 
         
         /*!
-         *   clear the solution of
+         *   clears the solution. The localized data is retained if the
+         *   local interpolation is used.
          */
         void clear();
+        
+        
+        /*!
+         *   deletes the localized vectors and the libMesh::MeshFunction
+         *   objects, including those retained for local interpolation
+         */
+        void clear_localized_data();
 
     protected:
-
+        
+        /*!
+         *   localizes \p sol to the retained ghosted vector \p vec, which
+         *   is created along with the mesh function \p func if needed
+         */
+        void _localize_retained(const libMesh::NumericVector<Real>& sol,
+                                libMesh::NumericVector<Real>*& vec,
+                                libMesh::MeshFunction*& func);
+        
+        /*!
+         *   flag is set to true between init() and clear()
+         */
+        bool _initialized;
+        
+        /*!
+         *   flag to use the local interpolation
+         */
+        bool _local_interpolation;
+        
         /*!
          *  flag is set to true when the quadrature point solution is 
          *  provided by an element
@@ -165,6 +286,21 @@ namespace MAST {
          *   the MeshFunction object that performs the interpolation
          */
         libMesh::MeshFunction *_function, *_perturbed_function;
+        
+        /*!
+         *   operator that performs the interpolation, if provided
+         */
+        MAST::MeshFieldTransferOperator* _transfer;
+        
+        /*!
+         *   flag to store the values interpolated at points, the stored
+         *   values, and the mutex for their access from multiple threads
+         */
+        bool _point_value_cache;
+        
+        mutable std::map<libMesh::Point, RealVectorX> _point_values;
+        
+        mutable std::mutex _cache_mutex;
     };
 }
 
@@ -0,0 +1,605 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2017  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+// C++ includes
+#include <algorithm>
+
+
+// MAST includes
+#include "base/mesh_field_transfer_operator.h"
+#include "base/system_initialization.h"
+#include "base/nonlinear_system.h"
+#include "base/performance_log.h"
+#include "base/boundary_side_index.h"
+
+
+// libMesh includes
+#include "libmesh/dof_map.h"
+#include "libmesh/mesh_base.h"
+#include "libmesh/elem.h"
+#include "libmesh/fe_base.h"
+#include "libmesh/fe_interface.h"
+#include "libmesh/parallel.h"
+
+
+MAST::MeshFieldTransferOperator::
+MeshFieldTransferOperator(MAST::SystemInitialization& sys):
+_system(sys),
+_boundary_index(nullptr)
+{ }
+
+
+
+MAST::MeshFieldTransferOperator::~MeshFieldTransferOperator() {
+    
+    this->clear();
+}
+
+
+
+void
+MAST::MeshFieldTransferOperator::clear() {
+    
+    std::lock_guard<std::mutex> lock(_mutex);
+    
+    _rows.clear();
+    _point_locator.reset();
+}
+
+
+
+void
+MAST::MeshFieldTransferOperator::
+add_points(const std::vector<libMesh::Point>& pts) {
+    
+    if (!_system.system().get_mesh().is_serial()) {
+        
+        _add_points_distributed(pts);
+        return;
+    }
+    
+    for (unsigned int i=0; i<pts.size(); i++)
+        _get_row(pts[i]);
+}
+
+
+
+void
+MAST::MeshFieldTransferOperator::
+get_ghost_dof_indices(std::vector<libMesh::dof_id_type>& dofs) const {
+    
+    std::lock_guard<std::mutex> lock(_mutex);
+    
+    const libMesh::DofMap&
+    dof_map = _system.system().get_dof_map();
+    
+    const libMesh::dof_id_type
+    first_dof = dof_map.first_dof(),
+    end_dof   = dof_map.end_dof();
+    
+    dofs = dof_map.get_send_list();
+    
+    std::map<libMesh::Point, MAST::MeshFieldTransferOperator::Row>::const_iterator
+    it  = _rows.begin(),
+    end = _rows.end();
+    
+    for ( ; it != end; it++)
+        for (unsigned int i=0; i<it->second.dof_indices.size(); i++) {
+            
+            const libMesh::dof_id_type
+            dof = it->second.dof_indices[i];
+            
+            if (dof < first_dof || dof >= end_dof)
+                dofs.push_back(dof);
+        }
+    
+    std::sort(dofs.begin(), dofs.end());
+    dofs.erase(std::unique(dofs.begin(), dofs.end()), dofs.end());
+}
+
+
+
+unsigned int
+MAST::MeshFieldTransferOperator::n_points() const {
+    
+    std::lock_guard<std::mutex> lock(_mutex);
+    
+    return (unsigned int)_rows.size();
+}
+
+
+
+void
+MAST::MeshFieldTransferOperator::
+interpolate(const libMesh::Point& p,
+            const libMesh::NumericVector<Real>& sol,
+            RealVectorX& v) const {
+    
+    const MAST::MeshFieldTransferOperator::Row&
+    row = _get_row(p);
+    
+    const unsigned int
+    n_vars = (unsigned int)row.var_offset.size()-1;
+    
+    // values of all dofs in the row are read in a single call
+    std::vector<Real> vals(row.dof_indices.size(), 0.);
+    if (vals.size())
+        sol.get(row.dof_indices, &vals[0]);
+    
+    v.setZero(n_vars);
+    
+    for (unsigned int i=0; i<n_vars; i++)
+        for (unsigned int j=row.var_offset[i]; j<row.var_offset[i+1]; j++)
+            v(i) += row.weights[j] * vals[j];
+}
+
+
+
+void
+MAST::MeshFieldTransferOperator::
+interpolate(const libMesh::Point& p,
+            const libMesh::NumericVector<Real>& sol_re,
+            const libMesh::NumericVector<Real>& sol_im,
+            ComplexVectorX& v) const {
+    
+    RealVectorX
+    v_re,
+    v_im;
+    
+    this->interpolate(p, sol_re, v_re);
+    this->interpolate(p, sol_im, v_im);
+    
+    v = ComplexVectorX::Zero(v_re.size());
+    for (unsigned int i=0; i<v_re.size(); i++)
+        v(i) = Complex(v_re(i), v_im(i));
+}
+
+
+
+void
+MAST::MeshFieldTransferOperator::
+interpolate_gradient(const libMesh::Point& p,
+                     const libMesh::NumericVector<Real>& sol,
+                     RealMatrixX& dv) const {
+    
+    const MAST::MeshFieldTransferOperator::Row&
+    row = _get_row(p);
+    
+    const unsigned int
+    n_vars = (unsigned int)row.var_offset.size()-1;
+    
+    std::vector<Real> vals(row.dof_indices.size(), 0.);
+    if (vals.size())
+        sol.get(row.dof_indices, &vals[0]);
+    
+    dv.setZero(n_vars, 3);
+    
+    for (unsigned int i=0; i<n_vars; i++)
+        for (unsigned int j=row.var_offset[i]; j<row.var_offset[i+1]; j++)
+            for (unsigned int k=0; k<3; k++)
+                dv(i, k) += row.grad_weights[3*j+k] * vals[j];
+}
+
+
+
+void
+MAST::MeshFieldTransferOperator::
+interpolate_gradient(const libMesh::Point& p,
+                     const libMesh::NumericVector<Real>& sol_re,
+                     const libMesh::NumericVector<Real>& sol_im,
+                     ComplexMatrixX& dv) const {
+    
+    RealMatrixX
+    dv_re,
+    dv_im;
+    
+    this->interpolate_gradient(p, sol_re, dv_re);
+    this->interpolate_gradient(p, sol_im, dv_im);
+    
+    dv = ComplexMatrixX::Zero(dv_re.rows(), dv_re.cols());
+    for (unsigned int i=0; i<dv_re.rows(); i++)
+        for (unsigned int j=0; j<dv_re.cols(); j++)
+            dv(i, j) = Complex(dv_re(i, j), dv_im(i, j));
+}
+
+
+
+void
+MAST::MeshFieldTransferOperator::
+add_interpolation_transpose(const libMesh::Point& p,
+                            const ComplexVectorX& v,
+                            libMesh::NumericVector<Real>& vec_re,
+                            libMesh::NumericVector<Real>& vec_im) const {
+    
+    const MAST::MeshFieldTransferOperator::Row&
+    row = _get_row(p);
+    
+    const unsigned int
+    n_vars = (unsigned int)row.var_offset.size()-1;
+    
+    libmesh_assert_equal_to(v.size(), n_vars);
+    
+    if (!row.dof_indices.size())
+        return;
+    
+    std::vector<Real>
+    vals_re(row.dof_indices.size(), 0.),
+    vals_im(row.dof_indices.size(), 0.);
+    
+    for (unsigned int i=0; i<n_vars; i++)
+        for (unsigned int j=row.var_offset[i]; j<row.var_offset[i+1]; j++) {
+            
+            vals_re[j] = row.weights[j] * std::real(v(i));
+            vals_im[j] = row.weights[j] * std::imag(v(i));
+        }
+    
+    vec_re.add_vector(vals_re, row.dof_indices);
+    vec_im.add_vector(vals_im, row.dof_indices);
+}
+
+
+
+const MAST::MeshFieldTransferOperator::Row&
+MAST::MeshFieldTransferOperator::_get_row(const libMesh::Point& p) const {
+    
+    std::lock_guard<std::mutex> lock(_mutex);
+    
+    std::map<libMesh::Point, MAST::MeshFieldTransferOperator::Row>::iterator
+    it = _rows.find(p);
+    
+    if (it == _rows.end()) {
+        
+        // references to map entries remain valid after insertion of
+        // other entries
+        it = _rows.insert
+        (std::pair<libMesh::Point, MAST::MeshFieldTransferOperator::Row>
+         (p, MAST::MeshFieldTransferOperator::Row())).first;
+        
+        const libMesh::Elem*
+        elem = _find_elem(p);
+        
+        // with a distributed mesh, points in elements of other processors
+        // must be provided with add_points() on all processors
+        if (!elem)
+            libmesh_error_msg("Error! Point not found in the mesh.");
+        
+        _compute_row(*elem, p, it->second);
+    }
+    
+    return it->second;
+}
+
+
+
+const libMesh::Elem*
+MAST::MeshFieldTransferOperator::_find_elem(const libMesh::Point& p) const {
+    
+    if (_boundary_index)
+        return _boundary_index->find_elem(p);
+    
+    if (!_point_locator.get()) {
+        
+        const libMesh::MeshBase&
+        mesh = _system.system().get_mesh();
+        
+        _point_locator.reset(mesh.sub_point_locator().release());
+        
+        // points outside of the local and ghost elements of a distributed
+        // mesh are located on the other processors
+        if (!mesh.is_serial())
+            _point_locator->enable_out_of_mesh_mode();
+    }
+    
+    return (*_point_locator)(p);
+}
+
+
+
+void
+MAST::MeshFieldTransferOperator::
+_compute_row(const libMesh::Elem& elem,
+             const libMesh::Point& p,
+             MAST::MeshFieldTransferOperator::Row& row) const {
+    
+    MAST_LOG_SCOPE("_compute_row()", "MeshFieldTransferOperator");
+    
+    MAST::NonlinearSystem& sys = _system.system();
+    
+    const libMesh::DofMap&
+    dof_map = sys.get_dof_map();
+    
+    const std::vector<unsigned int>
+    vars = _system.vars();
+    
+    std::vector<libMesh::dof_id_type>
+    dof_indices;
+    
+    row.var_offset.resize(vars.size()+1, 0);
+    row.dof_indices.clear();
+    row.weights.clear();
+    row.grad_weights.clear();
+    
+    for (unsigned int i=0; i<vars.size(); i++) {
+        
+        const libMesh::FEType&
+        fe_type = dof_map.variable_type(vars[i]);
+        
+        std::auto_ptr<libMesh::FEBase>
+        fe(libMesh::FEBase::build(elem.dim(), fe_type).release());
+        
+        const std::vector<std::vector<Real> >&
+        phi = fe->get_phi();
+        
+        const std::vector<std::vector<libMesh::RealGradient> >&
+        dphi = fe->get_dphi();
+        
+        // location of the point in the reference element
+        std::vector<libMesh::Point>
+        ref_pts(1, libMesh::FEInterface::inverse_map(elem.dim(),
+                                                     fe_type,
+                                                     &elem,
+                                                     p));
+        fe->reinit(&elem, &ref_pts);
+        
+        dof_map.dof_indices(&elem, dof_indices, vars[i]);
+        libmesh_assert_equal_to(dof_indices.size(), phi.size());
+        
+        row.var_offset[i] = (unsigned int)row.dof_indices.size();
+        for (unsigned int j=0; j<dof_indices.size(); j++) {
+            row.dof_indices.push_back(dof_indices[j]);
+            row.weights.push_back(phi[j][0]);
+            for (unsigned int k=0; k<3; k++)
+                row.grad_weights.push_back(dphi[j][0](k));
+        }
+    }
+    
+    row.var_offset[vars.size()] = (unsigned int)row.dof_indices.size();
+}
+
+
+
+void
+MAST::MeshFieldTransferOperator::
+_add_points_distributed(const std::vector<libMesh::Point>& pts) {
+    
+    MAST_LOG_SCOPE("add_points_distributed()", "MeshFieldTransferOperator");
+    
+    std::lock_guard<std::mutex> lock(_mutex);
+    
+    const libMesh::Parallel::Communicator&
+    comm = _system.system().comm();
+    
+    const unsigned int
+    rank   = comm.rank(),
+    n_vars = (unsigned int)_system.vars().size();
+    
+    // coordinates of the points that are not available in the elements
+    // of this processor
+    std::vector<libMesh::Point>
+    remote_pts;
+    std::vector<Real>
+    coords;
+    
+    for (unsigned int i=0; i<pts.size(); i++) {
+        
+        if (_rows.count(pts[i]))
+            continue;
+        
+        const libMesh::Elem*
+        elem = _find_elem(pts[i]);
+        
+        if (elem)
+            _compute_row(*elem, pts[i], _rows[pts[i]]);
+        else {
+            
+            remote_pts.push_back(pts[i]);
+            for (unsigned int k=0; k<3; k++)
+                coords.push_back(pts[i](k));
+        }
+    }
+    
+    // the offset of the points of this processor in the gathered points
+    const unsigned int
+    n_local_remote = (unsigned int)remote_pts.size();
+    std::vector<unsigned int>
+    n_remote;
+    comm.allgather(n_local_remote, n_remote);
+    comm.allgather(coords);
+    
+    unsigned int
+    first_pt = 0;
+    for (unsigned int i=0; i<rank; i++)
+        first_pt += n_remote[i];
+    
+    // rows for the points in the local elements of this processor,
+    // stored as the index of the point, the offsets of the variables, the
+    // dof indices, and the weights followed by the gradient weights of
+    // each entry
+    std::vector<unsigned int>
+    pt_index,
+    offsets;
+    std::vector<libMesh::dof_id_type>
+    dofs;
+    std::vector<Real>
+    weights;
+    
+    MAST::MeshFieldTransferOperator::Row
+    row;
+    
+    for (unsigned int i=0; i<coords.size()/3; i++) {
+        
+        if (i >= first_pt && i < first_pt+n_remote[rank])
+            continue;
+        
+        const libMesh::Point
+        p(coords[3*i], coords[3*i+1], coords[3*i+2]);
+        
+        const libMesh::Elem*
+        elem = _find_elem(p);
+        
+        if (!elem || elem->processor_id() != rank)
+            continue;
+        
+        _compute_row(*elem, p, row);
+        
+        pt_index.push_back(i);
+        offsets.insert(offsets.end(), row.var_offset.begin(), row.var_offset.end());
+        dofs.insert(dofs.end(), row.dof_indices.begin(), row.dof_indices.end());
+        for (unsigned int j=0; j<row.weights.size(); j++) {
+            weights.push_back(row.weights[j]);
+            for (unsigned int k=0; k<3; k++)
+                weights.push_back(row.grad_weights[3*j+k]);
+        }
+    }
+    
+    comm.allgather(pt_index);
+    comm.allgather(offsets);
+    comm.allgather(dofs);
+    comm.allgather(weights);
+    
+    // the rows of the points of this processor are retained. A point on
+    // the boundary of elements of two processors is returned by both,
+    // and the first is used.
+    unsigned int
+    dof_pos = 0;
+    
+    for (unsigned int i=0; i<pt_index.size(); i++) {
+        
+        const unsigned int
+        n = offsets[i*(n_vars+1)+n_vars];
+        
+        if (pt_index[i] >= first_pt &&
+            pt_index[i] <  first_pt+n_remote[rank]) {
+            
+            const libMesh::Point&
+            p = remote_pts[pt_index[i]-first_pt];
+            
+            if (!_rows.count(p)) {
+                
+                MAST::MeshFieldTransferOperator::Row&
+                r = _rows[p];
+                
+                r.var_offset.assign(offsets.begin()+i*(n_vars+1),
+                                    offsets.begin()+(i+1)*(n_vars+1));
+                r.dof_indices.assign(dofs.begin()+dof_pos,
+                                     dofs.begin()+dof_pos+n);
+                r.weights.resize(n);
+                r.grad_weights.resize(3*n);
+                for (unsigned int j=0; j<n; j++) {
+                    r.weights[j] = weights[4*(dof_pos+j)];
+                    for (unsigned int k=0; k<3; k++)
+                        r.grad_weights[3*j+k] = weights[4*(dof_pos+j)+1+k];
+                }
+            }
+        }
+        
+        dof_pos += n;
+    }
+    
+    for (unsigned int i=0; i<remote_pts.size(); i++)
+        if (!_rows.count(remote_pts[i]))
+            libmesh_error_msg("Error! Point not found in the mesh.");
+}
+
+
+
+libMesh::NumericVector<Real>*
+MAST::build_localized_interpolation_vector(MAST::SystemInitialization& sys,
+                                           const libMesh::NumericVector<Real>& sol,
+                                           const MAST::MeshFieldTransferOperator* op) {
+    
+    MAST::NonlinearSystem& system = sys.system();
+    
+    libMesh::NumericVector<Real>*
+    vec = libMesh::NumericVector<Real>::build(system.comm()).release();
+    
+    // points can be located in any element of a replicated mesh
+    if (system.get_mesh().is_serial()) {
+        
+        vec->init(sol.size(), true, libMesh::SERIAL);
+        sol.localize(*vec);
+        return vec;
+    }
+    
+    std::vector<libMesh::dof_id_type>
+    ghost_dofs;
+    
+    if (op)
+        op->get_ghost_dof_indices(ghost_dofs);
+    else
+        ghost_dofs = system.get_dof_map().get_send_list();
+    
+    vec->init(system.n_dofs(),
+              system.n_local_dofs(),
+              ghost_dofs,
+              false,
+              libMesh::GHOSTED);
+    sol.localize(*vec, ghost_dofs);
+    
+    return vec;
+}
+
+
+
+bool
+MAST::update_localized_interpolation_vector(MAST::SystemInitialization& sys,
+                                            const libMesh::NumericVector<Real>& sol,
+                                            libMesh::NumericVector<Real>& vec,
+                                            const MAST::MeshFieldTransferOperator* op) {
+    
+    MAST::NonlinearSystem& system = sys.system();
+    
+    libmesh_assert_equal_to(sol.size(), vec.size());
+    
+    // the local values are compared before any communication
+    bool
+    changed = false;
+    
+    const libMesh::numeric_index_type
+    first = sol.first_local_index(),
+    last  = sol.last_local_index();
+    
+    for (libMesh::numeric_index_type i=first; i<last && !changed; i++)
+        changed = (sol(i) != vec(i));
+    
+    system.comm().max(changed);
+    
+    if (!changed)
+        return false;
+    
+    if (vec.type() == libMesh::SERIAL) {
+        
+        sol.localize(vec);
+        return true;
+    }
+    
+    std::vector<libMesh::dof_id_type>
+    ghost_dofs;
+    
+    if (op)
+        op->get_ghost_dof_indices(ghost_dofs);
+    else
+        ghost_dofs = system.get_dof_map().get_send_list();
+    
+    sol.localize(vec, ghost_dofs);
+    
+    return true;
+}
+
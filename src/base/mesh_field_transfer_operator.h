@@ -0,0 +1,293 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2017  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+#ifndef __mast__mesh_field_transfer_operator__
+#define __mast__mesh_field_transfer_operator__
+
+// C++ includes
+#include <map>
+#include <vector>
+#include <memory>
+#include <mutex>
+
+
+// MAST includes
+#include "base/mast_data_types.h"
+
+
+// libMesh includes
+#include "libmesh/point.h"
+#include "libmesh/numeric_vector.h"
+#include "libmesh/point_locator_base.h"
+
+
+namespace MAST {
+    
+    // Forward declerations
+    class SystemInitialization;
+    class BoundarySideIndex;
+    
+    
+    /*!
+     *    Sparse interpolation operator from the dofs of a system to a set of
+     *    points, for example the quadrature points of another mesh where
+     *    the solution of this system is transferred. For each point,
+     *    the element containing the point is located and the shape
+     *    functions of each variable are evaluated only once. The dof
+     *    indices and shape function values are stored as the rows of a
+     *    compressed sparse matrix, so that interpolating a new solution
+     *    at the point is a sparse dot product with the localized solution,
+     *    without the point locator search and FE reinitialization of 
+     *    libMesh::MeshFunction.
+     *
+     *    Rows are computed on the first request for a point, or in advance
+     *    using add_points(), and are retained until clear() is called.
+     *    The operator can be shared by all functions that interpolate
+     *    solutions of the same system, and clear() must be called if
+     *    the mesh of the system changes. Points are matched exactly, which
+     *    works for quadrature points that are recomputed identically
+     *    in each assembly.
+     *
+     *    With a distributed mesh, a point is found only if it lies in an
+     *    element available on this processor. add_points() must then be
+     *    called on all processors, and the elements for points not found
+     *    locally are searched on the processors that own them, which
+     *    return the interpolation data of the point. The solution
+     *    vectors only need the values of the dofs returned by
+     *    get_ghost_dof_indices(), so that the memory scales with the
+     *    partition instead of the size of the global mesh.
+     */
+    class MeshFieldTransferOperator {
+        
+    public:
+        
+        MeshFieldTransferOperator(MAST::SystemInitialization& sys);
+        
+        
+        virtual ~MeshFieldTransferOperator();
+        
+        
+        /*!
+         *   clears the interpolation data for all points
+         */
+        void clear();
+        
+        
+        /*!
+         *   restricts the search of elements for new points to the
+         *   elements with sides in \p index, for example when the points
+         *   are on the fluid-structure interface. This avoids building
+         *   a point locator for the whole mesh. A nullptr restores the use
+         *   of the point locator.
+         */
+        void set_boundary_index(const MAST::BoundarySideIndex* index) {
+            
+            _boundary_index = index;
+        }
+        
+        
+        /*!
+         *   computes the interpolation data for points in \p pts for
+         *   which it was not computed before. With a distributed mesh this
+         *   must be called on all processors, and the points not found in
+         *   the local elements are located on the other processors.
+         */
+        void add_points(const std::vector<libMesh::Point>& pts);
+        
+        
+        /*!
+         *   returns in \p dofs the sorted indices of dofs that are not
+         *   local to this processor, but are needed for interpolation.
+         *   These are the dofs in the send list of the system, and the 
+         *   dofs of points located in elements of other processors.
+         */
+        void get_ghost_dof_indices(std::vector<libMesh::dof_id_type>& dofs) const;
+        
+        
+        /*!
+         *   @returns the number of points for which the interpolation 
+         *   data is available
+         */
+        unsigned int n_points() const;
+        
+        
+        /*!
+         *   interpolates the variables of the system at point \p p from the
+         *   localized solution \p sol, and returns them in \p v. \p sol
+         *   must store the values of all dofs of the element containing
+         *   \p p.
+         */
+        void interpolate(const libMesh::Point& p,
+                         const libMesh::NumericVector<Real>& sol,
+                         RealVectorX& v) const;
+        
+        
+        /*!
+         *   interpolates the complex solution with real and imaginary
+         *   parts in \p sol_re and \p sol_im at point \p p.
+         */
+        void interpolate(const libMesh::Point& p,
+                         const libMesh::NumericVector<Real>& sol_re,
+                         const libMesh::NumericVector<Real>& sol_im,
+                         ComplexVectorX& v) const;
+        
+        
+        /*!
+         *   interpolates the spatial gradient of the variables of the 
+         *   system at point \p p from the localized solution \p sol. 
+         *   Row i of \p dv is the gradient of variable i.
+         */
+        void interpolate_gradient(const libMesh::Point& p,
+                                  const libMesh::NumericVector<Real>& sol,
+                                  RealMatrixX& dv) const;
+        
+        
+        /*!
+         *   interpolates the gradient of the complex solution with real
+         *   and imaginary parts in \p sol_re and \p sol_im at point \p p.
+         */
+        void interpolate_gradient(const libMesh::Point& p,
+                                  const libMesh::NumericVector<Real>& sol_re,
+                                  const libMesh::NumericVector<Real>& sol_im,
+                                  ComplexMatrixX& dv) const;
+        
+        
+        /*!
+         *   adds the transpose of the interpolation at point \p p applied
+         *   to the complex values \p v of the variables to the dof values
+         *   in \p vec_re and \p vec_im. This is the adjoint of
+         *   interpolate(), and is used to compute the derivative of a 
+         *   linear functional of the interpolated values with respect to
+         *   the dofs. The vectors must be closed after all contributions
+         *   are added.
+         */
+        void add_interpolation_transpose(const libMesh::Point& p,
+                                         const ComplexVectorX& v,
+                                         libMesh::NumericVector<Real>& vec_re,
+                                         libMesh::NumericVector<Real>& vec_im) const;
+        
+    protected:
+        
+        /*!
+         *   interpolation data for a point, stored as n_vars compressed 
+         *   rows. The entries of variable i are from var_offset[i] to
+         *   var_offset[i+1]. The x, y, z derivatives of the shape function
+         *   of entry j are grad_weights[3*j], grad_weights[3*j+1] and
+         *   grad_weights[3*j+2].
+         */
+        struct Row {
+            
+            std::vector<unsigned int>          var_offset;
+            std::vector<libMesh::dof_id_type>  dof_indices;
+            std::vector<Real>                  weights;
+            std::vector<Real>                  grad_weights;
+        };
+        
+        
+        /*!
+         *   @returns the row for \p p, which is computed if it is not 
+         *   already available.
+         */
+        const MAST::MeshFieldTransferOperator::Row&
+        _get_row(const libMesh::Point& p) const;
+        
+        
+        /*!
+         *   @returns the element containing \p p, or nullptr if \p p is not
+         *   in the elements available on this processor.
+         */
+        const libMesh::Elem* _find_elem(const libMesh::Point& p) const;
+        
+        
+        /*!
+         *   computes the interpolation data for \p p in element \p elem
+         *   in \p row.
+         */
+        void _compute_row(const libMesh::Elem& elem,
+                          const libMesh::Point& p,
+                          MAST::MeshFieldTransferOperator::Row& row) const;
+        
+        
+        /*!
+         *   computes the interpolation data for the points in \p pts
+         *   on a distributed mesh, with the help of the processors that
+         *   own the elements of points not found locally.
+         */
+        void _add_points_distributed(const std::vector<libMesh::Point>& pts);
+        
+        
+        /*!
+         *   system whose solution is interpolated
+         */
+        MAST::SystemInitialization& _system;
+        
+        /*!
+         *   index of boundary sides used to locate the points, if provided
+         */
+        const MAST::BoundarySideIndex* _boundary_index;
+        
+        /*!
+         *   point locator used to find the elements for new points
+         */
+        mutable std::auto_ptr<libMesh::PointLocatorBase> _point_locator;
+        
+        /*!
+         *   interpolation data for each point
+         */
+        mutable std::map<libMesh::Point, MAST::MeshFieldTransferOperator::Row> _rows;
+        
+        /*!
+         *   mutex for computation of new rows, since the functions using 
+         *   this operator can be evaluated from threaded assembly loops
+         */
+        mutable std::mutex _mutex;
+    };
+    
+    
+    /*!
+     *   @returns a new vector with the values of \p sol needed to
+     *   interpolate the solution of \p sys, with the operator \p op if
+     *   provided. For a replicated mesh all values are localized, since 
+     *   points can be located in any element. Otherwise, the vector is 
+     *   ghosted with the send list of the system, or the ghost dofs of 
+     *   \p op. The caller owns the returned vector.
+     */
+    libMesh::NumericVector<Real>*
+    build_localized_interpolation_vector(MAST::SystemInitialization& sys,
+                                         const libMesh::NumericVector<Real>& sol,
+                                         const MAST::MeshFieldTransferOperator* op);
+    
+    
+    /*!
+     *   updates the vector \p vec created by
+     *   build_localized_interpolation_vector() with the values of \p sol,
+     *   with the same layout and ghost dofs. The values are compared on
+     *   the local dofs first, and the vector is localized only if a value
+     *   has changed on any processor. @returns \p true if the values have
+     *   changed.
+     */
+    bool
+    update_localized_interpolation_vector(MAST::SystemInitialization& sys,
+                                          const libMesh::NumericVector<Real>& sol,
+                                          libMesh::NumericVector<Real>& vec,
+                                          const MAST::MeshFieldTransferOperator* op);
+}
+
+#endif // __mast__mesh_field_transfer_operator__
@@ -0,0 +1,146 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2017  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+// MAST includes
+#include "base/node_shared_memory.h"
+#include "base/performance_log.h"
+
+
+// libMesh includes
+#include "libmesh/parallel.h"
+
+
+MAST::NodeSharedMemory::
+NodeSharedMemory(const libMesh::Parallel::Communicator& comm_in):
+libMesh::ParallelObject(comm_in),
+_node_comm(MPI_COMM_NULL),
+_node_rank(0),
+_node_size(1) {
+    
+    int
+    ierr = MPI_Comm_split_type(comm_in.get(),
+                               MPI_COMM_TYPE_SHARED,
+                               comm_in.rank(),
+                               MPI_INFO_NULL,
+                               &_node_comm);
+    if (ierr != MPI_SUCCESS)
+        libmesh_error_msg("Error: could not create the node communicator.");
+    
+    int
+    r = 0,
+    s = 0;
+    MPI_Comm_rank(_node_comm, &r);
+    MPI_Comm_size(_node_comm, &s);
+    
+    _node_rank = r;
+    _node_size = s;
+}
+
+
+
+MAST::NodeSharedMemory::~NodeSharedMemory() {
+    
+    this->clear();
+    
+    if (_node_comm != MPI_COMM_NULL)
+        MPI_Comm_free(&_node_comm);
+}
+
+
+
+void*
+MAST::NodeSharedMemory::allocate(std::size_t bytes) {
+    
+    MAST_LOG_SCOPE("allocate()", "NodeSharedMemory");
+    
+    // only the node leader contributes memory to the window
+    const MPI_Aint
+    n = this->is_node_leader() ? (MPI_Aint)bytes : 0;
+    
+    void
+    *p = nullptr;
+    
+    MPI_Win
+    win;
+    
+    int
+    ierr = MPI_Win_allocate_shared(n, 1, MPI_INFO_NULL, _node_comm, &p, &win);
+    if (ierr != MPI_SUCCESS)
+        libmesh_error_msg("Error: could not allocate "
+                          << bytes << " bytes of node-shared memory.");
+    
+    // the address of the memory of the node leader
+    MPI_Aint
+    sz = 0;
+    int
+    disp = 0;
+    MPI_Win_shared_query(win, 0, &sz, &disp, &p);
+    
+    // passive target access is needed for MPI_Win_sync
+    MPI_Win_lock_all(MPI_MODE_NOCHECK, win);
+    
+    _windows.push_back(win);
+    _sizes.push_back((std::size_t)sz);
+    
+    return p;
+}
+
+
+
+void
+MAST::NodeSharedMemory::synchronize() {
+    
+    for (unsigned int i=0; i<_windows.size(); i++)
+        MPI_Win_sync(_windows[i]);
+    
+    MPI_Barrier(_node_comm);
+    
+    for (unsigned int i=0; i<_windows.size(); i++)
+        MPI_Win_sync(_windows[i]);
+}
+
+
+
+void
+MAST::NodeSharedMemory::clear() {
+    
+    for (unsigned int i=0; i<_windows.size(); i++) {
+        
+        MPI_Win_unlock_all(_windows[i]);
+        MPI_Win_free(&_windows[i]);
+    }
+    
+    _windows.clear();
+    _sizes.clear();
+}
+
+
+
+std::size_t
+MAST::NodeSharedMemory::bytes() const {
+    
+    std::size_t
+    v = 0;
+    
+    for (unsigned int i=0; i<_sizes.size(); i++)
+        v += _sizes[i];
+    
+    return v;
+}
+
@@ -0,0 +1,141 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2017  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef __mast__node_shared_memory_h__
+#define __mast__node_shared_memory_h__
+
+// C++ includes
+#include <vector>
+
+// MAST includes
+#include "base/mast_data_types.h"
+
+// libMesh includes
+#include "libmesh/parallel.h"
+#include "libmesh/parallel_object.h"
+
+
+namespace MAST {
+    
+    /*!
+     *   Allocates memory in MPI-3 shared-memory windows, with one copy for
+     *   all processors of a compute node. The processors of the
+     *   communicator are grouped by node, and allocate() reserves the
+     *   memory on the first processor of each node, the node leader, with
+     *   all processors of the node receiving the address of the same
+     *   memory. This is meant for read-only data that would otherwise be
+     *   replicated on each processor: the node leader writes the data, after
+     *   which synchronize() makes it visible to the other processors of the
+     *   node. The memory is released when this object is destroyed or
+     *   cleared.
+     */
+    class NodeSharedMemory:
+    public libMesh::ParallelObject {
+        
+    public:
+        
+        NodeSharedMemory(const libMesh::Parallel::Communicator& comm_in);
+        
+        virtual ~NodeSharedMemory();
+        
+        
+        /*!
+         *   @returns the rank of this processor among the processors on
+         *   its node, and the number of these processors.
+         */
+        unsigned int node_rank() const {
+            return _node_rank;
+        }
+        
+        unsigned int node_size() const {
+            return _node_size;
+        }
+        
+        
+        /*!
+         *   @returns \p true if this processor writes the data of its node
+         */
+        bool is_node_leader() const {
+            return _node_rank == 0;
+        }
+        
+        
+        /*!
+         *   allocates \p bytes on each node, and @returns the address of the
+         *   memory on this processor. This must be called on all processors
+         *   of the communicator, and the value of \p bytes on the node leader
+         *   is used.
+         */
+        void* allocate(std::size_t bytes);
+        
+        
+        /*!
+         *   allocates \p n values of type \p T on each node
+         */
+        template <typename T>
+        T* allocate(std::size_t n) {
+            return static_cast<T*>(this->allocate(n * sizeof(T)));
+        }
+        
+        
+        /*!
+         *   makes the data written by the node leader visible to all
+         *   processors of the node. This must be called on all processors
+         *   of the communicator after the node leader writes the data and
+         *   before it is read by the other processors.
+         */
+        void synchronize();
+        
+        
+        /*!
+         *   releases the allocated memory. This must be called on all
+         *   processors of the communicator.
+         */
+        void clear();
+        
+        
+        /*!
+         *   @returns the bytes allocated on the node of this processor
+         */
+        std::size_t bytes() const;
+        
+    protected:
+        
+        /*!
+         *   communicator of the processors on the node
+         */
+        MPI_Comm                 _node_comm;
+        
+        /*!
+         *   rank of this processor on the node, and number of processors
+         *   on the node
+         */
+        unsigned int             _node_rank, _node_size;
+        
+        /*!
+         *   windows of the allocated memory, and their sizes
+         */
+        std::vector<MPI_Win>     _windows;
+        
+        std::vector<std::size_t> _sizes;
+    };
+}
+
+
+#endif // __mast__node_shared_memory_h__
@@ -17,6 +17,11 @@
  * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
  */
 
+// C++ includes
+#include <set>
+#include <chrono>
+#include <limits>
+
 // MAST includes
 #include "base/nonlinear_implicit_assembly.h"
 #include "base/system_initialization.h"
@@ -25,6 +30,11 @@
 #include "numerics/utility.h"
 #include "base/mesh_field_function.h"
 #include "base/nonlinear_system.h"
+#include "base/output_assembly_base.h"
+#include "base/elementwise_design_field.h"
+#include "base/performance_log.h"
+#include "base/memory_report.h"
+#include "mesh/element_cost_model.h"
 
 // libMesh includes
 #include "libmesh/nonlinear_solver.h"
@@ -32,12 +42,31 @@
 #include "libmesh/sparse_matrix.h"
 #include "libmesh/dof_map.h"
 #include "libmesh/parameter_vector.h"
+#include "libmesh/petsc_vector.h"
+#include "libmesh/petsc_matrix.h"
+#include "libmesh/petsc_nonlinear_solver.h"
 
 
 
 MAST::NonlinearImplicitAssembly::
 NonlinearImplicitAssembly():
-MAST::AssemblyBase() {
+MAST::AssemblyBase(),
+_threaded_assembly(false),
+_deferred_close(false),
+_deferred_R(nullptr),
+_deferred_J(nullptr),
+_overlapped_communication(false),
+_deferred_assembly_begun(false),
+_jacobian_lag(1),
+_jacobian_stagnation_ratio(0.),
+_force_jacobian_update(true),
+_n_jacobian_requests_since_update(0),
+_residual_l2(0.),
+_residual_l2_previous(0.),
+_incremental_assembly(false),
+_solution_independent_jacobian(false),
+_jacobian_key_matrix(nullptr),
+_fd_jacobian_all(false) {
     
 }
 
@@ -62,6 +91,10 @@ attach_discipline_and_system(MAST::PhysicsDisciplineBase &discipline,
     _system     = &system;
     
     _system->system().nonlinear_solver->residual_and_jacobian_object = this;
+    
+    // the Jacobian of the new system has not been assembled yet
+    this->request_jacobian_update();
+    this->_update_jacobian_zero_out();
 }
 
 
@@ -72,6 +105,10 @@ MAST::NonlinearImplicitAssembly::reattach_to_system() {
     libmesh_assert(_system);
     
     _system->system().nonlinear_solver->residual_and_jacobian_object = this;
+    
+    // the matrix may have been modified by another assembly
+    this->request_jacobian_update();
+    this->_update_jacobian_zero_out();
 }
 
 
@@ -80,9 +117,26 @@ void
 MAST::NonlinearImplicitAssembly::
 clear_discipline_and_system( ) {
     
+    // the element objects, localized vectors and output element lists
+    // refer to the system, and are no longer valid
+    this->clear_elem_objects();
+    this->clear_output_elems();
+    this->clear_localized_vectors();
+    this->clear_incremental_assembly_cache();
+    _interior_elems.clear();
+    _boundary_elems.clear();
+    
     if (_system && _discipline) {
 
         _system->system().nonlinear_solver->residual_and_jacobian_object = nullptr;
+        
+        // the default of libMesh is restored for other assemblies
+        libMesh::PetscNonlinearSolver<Real>*
+        solver = dynamic_cast<libMesh::PetscNonlinearSolver<Real>*>
+        (_system->system().nonlinear_solver.get());
+        
+        if (solver)
+            solver->set_jacobian_zero_out(true);
     }
     
     _discipline = nullptr;
@@ -151,6 +205,27 @@ namespace MAST {
     }
 }
 
+void
+MAST::NonlinearImplicitAssembly::
+_elem_parameter_sensitivity_calculations(MAST::ElementBase& elem,
+                                         const std::vector<const MAST::FunctionBase*>& f,
+                                         std::vector<RealVectorX>& vec) {
+    
+    libmesh_assert_equal_to(vec.size(), f.size());
+    
+    RealMatrixX mat;
+    
+    for (unsigned int i=0; i<f.size(); i++) {
+        
+        mat.setZero(vec[i].size(), vec[i].size());
+        
+        elem.sensitivity_param = f[i];
+        _elem_sensitivity_calculations(elem, false, vec[i], mat);
+    }
+}
+
+
+
 void
 MAST::NonlinearImplicitAssembly::
 _check_element_numerical_jacobian(MAST::ElementBase& e,
@@ -202,273 +277,1456 @@ _check_element_numerical_jacobian(MAST::ElementBase& e,
 
 void
 MAST::NonlinearImplicitAssembly::
-residual_and_jacobian (const libMesh::NumericVector<Real>& X,
-                       libMesh::NumericVector<Real>* R,
-                       libMesh::SparseMatrix<Real>*  J,
-                       libMesh::NonlinearImplicitSystem& S) {
+set_finite_difference_jacobian(bool f) {
     
-    MAST::NonlinearSystem& nonlin_sys = _system->system();
+    _fd_jacobian_all = f;
     
-    // make sure that the system for which this object was created,
-    // and the system passed through the function call are the same
-    libmesh_assert_equal_to(&S, &(nonlin_sys));
+    if (!f)
+        _fd_jacobian_subdomains.clear();
+}
+
+
+
+void
+MAST::NonlinearImplicitAssembly::
+set_finite_difference_jacobian(libMesh::subdomain_id_type sid,
+                               bool f) {
     
-    if (R) R->zero();
-    if (J) J->zero();
+    if (f)
+        _fd_jacobian_subdomains.insert(sid);
+    else
+        _fd_jacobian_subdomains.erase(sid);
+}
+
+
+
+void
+MAST::NonlinearImplicitAssembly::
+set_finite_difference_jacobian_coupling(const libMesh::CouplingMatrix& c) {
     
-    // iterate over each element, initialize it and get the relevant
-    // analysis quantities
-    RealVectorX vec, sol;
-    RealMatrixX mat;
+    _fd_jacobian_coupling.reset(new libMesh::CouplingMatrix(c));
+}
+
+
+
+bool
+MAST::NonlinearImplicitAssembly::
+if_finite_difference_jacobian(const libMesh::Elem& e) const {
     
-    std::vector<libMesh::dof_id_type> dof_indices;
-    const libMesh::DofMap& dof_map = _system->system().get_dof_map();
-    std::auto_ptr<MAST::ElementBase> physics_elem;
+    return (_fd_jacobian_all ||
+            (!_fd_jacobian_subdomains.empty() &&
+             _fd_jacobian_subdomains.count(e.subdomain_id())));
+}
+
+
+
+void
+MAST::NonlinearImplicitAssembly::
+_elem_finite_difference_jacobian(const libMesh::Elem& elem,
+                                 MAST::ElementBase& e,
+                                 const RealVectorX& sol,
+                                 RealVectorX& vec,
+                                 RealMatrixX& mat) {
     
-    std::auto_ptr<libMesh::NumericVector<Real> > localized_solution;
-    localized_solution.reset(_build_localized_vector(nonlin_sys,
-                                                     X).release());
+    MAST_LOG_SCOPE("elem_finite_difference_jacobian()", "NonlinearImplicitAssembly");
     
+    const libMesh::DofMap& dof_map = _system->system().get_dof_map();
     
-    // if a solution function is attached, initialize it
-    if (_sol_function)
-        _sol_function->init( X);
+    const unsigned int
+    ndofs  = (unsigned int)sol.size(),
+    n_vars = _system->system().n_vars();
     
+    // the element dofs are ordered by variable, so that the variable of
+    // each dof is identified from the number of dofs of each variable
+    std::vector<libMesh::dof_id_type> var_dofs;
+    std::vector<unsigned int> n_var_dofs(n_vars, 0), var_first(n_vars, 0);
     
-    libMesh::MeshBase::const_element_iterator       el     =
-    nonlin_sys.get_mesh().active_local_elements_begin();
-    const libMesh::MeshBase::const_element_iterator end_el =
-    nonlin_sys.get_mesh().active_local_elements_end();
-        
-
-    for ( ; el != end_el; ++el) {
-        
-        const libMesh::Elem* elem = *el;
-        
-        dof_map.dof_indices (elem, dof_indices);
-        
-        physics_elem.reset(_build_elem(*elem).release());
-        
-        // get the solution
-        unsigned int ndofs = (unsigned int)dof_indices.size();
-        sol.setZero(ndofs);
-        vec.setZero(ndofs);
-        mat.setZero(ndofs, ndofs);
+    for (unsigned int i=0; i<n_vars; i++) {
         
-        for (unsigned int i=0; i<dof_indices.size(); i++)
-            sol(i) = (*localized_solution)(dof_indices[i]);
+        dof_map.dof_indices(&elem, var_dofs, i);
+        n_var_dofs[i] = (unsigned int)var_dofs.size();
+        if (i)
+            var_first[i] = var_first[i-1] + n_var_dofs[i-1];
+    }
+    
+    libmesh_assert_equal_to(var_first[n_vars-1] + n_var_dofs[n_vars-1], ndofs);
+    
+    // variables i and j can be perturbed together if no variable depends
+    // on both. The variables are colored greedily with this condition.
+    std::vector<int> var_color(n_vars, -1);
+    unsigned int n_var_colors = 0;
+    
+    for (unsigned int i=0; i<n_vars; i++) {
         
-        physics_elem->set_solution(sol);
+        std::vector<bool> used(n_var_colors, false);
         
-        if (_sol_function)
-            physics_elem->attach_active_solution_function(*_sol_function);
+        for (unsigned int j=0; j<i; j++) {
+            
+            bool conflict = !_fd_jacobian_coupling.get();
+            
+            for (unsigned int k=0; !conflict && k<n_vars; k++)
+                conflict = ((*_fd_jacobian_coupling)(k, i) &&
+                            (*_fd_jacobian_coupling)(k, j));
+            
+            if (conflict)
+                used[var_color[j]] = true;
+        }
         
-        //_check_element_numerical_jacobian(*physics_elem, sol);
+        unsigned int c = 0;
+        while (c < n_var_colors && used[c])
+            c++;
         
-        // perform the element level calculations
-        _elem_calculations(*physics_elem,
-                           J!=nullptr?true:false,
-                           vec, mat);
+        var_color[i] = c;
+        if (c == n_var_colors)
+            n_var_colors++;
+    }
+    
+    // the geometric quadrature point data is stored in the first residual
+    // evaluation and shared by all perturbations
+    const bool
+    geometry_cache = e.if_geometry_cache();
+    e.set_geometry_cache(true);
+    
+    // residual about the unperturbed solution
+    vec.setZero(ndofs);
+    mat.setZero(ndofs, ndofs);
+    _set_elem_solution(e, sol);
+    _elem_residual_calculations(e, vec);
+    
+    const Real
+    eps = sqrt(std::numeric_limits<Real>::epsilon());
+    
+    RealVectorX
+    dsol,
+    dres  = RealVectorX::Zero(ndofs),
+    delta = RealVectorX::Zero(ndofs);
+    
+    // the k^th dof of all variables of a color are perturbed together
+    for (unsigned int c=0; c<n_var_colors; c++) {
         
-        physics_elem->detach_active_solution_function();
-
-        // copy to the libMesh matrix for further processing
-        DenseRealVector v;
-        DenseRealMatrix m;
-        if (R)
-            MAST::copy(v, vec);
-        if (J)
-            MAST::copy(m, mat);
-
-        // constrain the quantities to account for hanging dofs,
-        // Dirichlet constraints, etc.
-        if (R && J)
-            dof_map.constrain_element_matrix_and_vector(m, v, dof_indices);
-        else if (R)
-            dof_map.constrain_element_vector(v, dof_indices);
-        else
-            dof_map.constrain_element_matrix(m, dof_indices);
+        unsigned int n = 0;
+        for (unsigned int i=0; i<n_vars; i++)
+            if (var_color[i] == (int)c)
+                n = std::max(n, n_var_dofs[i]);
         
-        // add to the global matrices
-        if (R) R->add_vector(v, dof_indices);
-        if (J) J->add_matrix(m, dof_indices);
+        for (unsigned int k=0; k<n; k++) {
+            
+            dsol = sol;
+            delta.setZero();
+            
+            for (unsigned int i=0; i<n_vars; i++)
+                if (var_color[i] == (int)c && k < n_var_dofs[i]) {
+                    
+                    const unsigned int j = var_first[i] + k;
+                    delta(j)  = eps * (1. + std::fabs(sol(j)));
+                    dsol(j)  += delta(j);
+                }
+            
+            dres.setZero();
+            _set_elem_solution(e, dsol);
+            _elem_residual_calculations(e, dres);
+            dres -= vec;
+            
+            // rows of variable r depend on at most one perturbed dof
+            for (unsigned int i=0; i<n_vars; i++) {
+                
+                if (var_color[i] != (int)c || k >= n_var_dofs[i])
+                    continue;
+                
+                const unsigned int j = var_first[i] + k;
+                
+                for (unsigned int r=0; r<n_vars; r++) {
+                    
+                    if (_fd_jacobian_coupling.get() &&
+                        !(*_fd_jacobian_coupling)(r, i))
+                        continue;
+                    
+                    mat.block(var_first[r], j, n_var_dofs[r], 1) =
+                    dres.segment(var_first[r], n_var_dofs[r]) / delta(j);
+                }
+            }
+        }
     }
     
+    // restore the element
+    e.set_geometry_cache(geometry_cache);
+    _set_elem_solution(e, sol);
+}
 
-    // if a solution function is attached, clear it
-    if (_sol_function)
-        _sol_function->clear();
+
+
+MAST::NonlinearImplicitAssembly::ElemResidualAndJacobian::
+ElemResidualAndJacobian(MAST::NonlinearImplicitAssembly& assembly,
+                        const libMesh::NumericVector<Real>& sol,
+                        libMesh::NumericVector<Real>* R,
+                        libMesh::SparseMatrix<Real>*  J,
+                        MAST::NonlinearImplicitAssembly::ElemContributionMapType* cache):
+_assembly(assembly),
+_sol(sol),
+_R(R),
+_J(J),
+_cache(cache) {
     
-    if (R) R->close();
-    if (J) J->close();
 }
 
 
 
+MAST::NonlinearImplicitAssembly::ElemResidualAndJacobian::
+ElemResidualAndJacobian(ElemResidualAndJacobian& other,
+                        libMesh::Threads::split):
+_assembly(other._assembly),
+_sol(other._sol),
+_R(other._R),
+_J(other._J),
+_cache(other._cache) {
+    
+}
+
+
 
 void
-MAST::NonlinearImplicitAssembly::
-linearized_jacobian_solution_product (const libMesh::NumericVector<Real>& X,
-                                      const libMesh::NumericVector<Real>& dX,
-                                      libMesh::NumericVector<Real>& JdX,
-                                      libMesh::NonlinearImplicitSystem& S) {
-    
-    // zero the solution vector
-    JdX.zero();
+MAST::NonlinearImplicitAssembly::ElemResidualAndJacobian::
+operator() (const libMesh::ConstElemRange& range) {
     
-    MAST::NonlinearSystem& nonlin_sys = _system->system();
-    
-    // make sure that the system for which this object was created,
-    // and the system passed through the function call are the same
-    libmesh_assert_equal_to(&S, &(nonlin_sys));
-    
-    // iterate over each element, initialize it and get the relevant
-    // analysis quantities
-    RealVectorX vec, sol, dsol;
+    // these data structures are local to each thread
+    RealVectorX vec, sol;
     RealMatrixX mat;
+    DenseRealVector v;
+    DenseRealMatrix m;
     
     std::vector<libMesh::dof_id_type> dof_indices;
-    const libMesh::DofMap& dof_map = _system->system().get_dof_map();
-    std::auto_ptr<MAST::ElementBase> physics_elem;
-    
-    std::auto_ptr<libMesh::NumericVector<Real> >
-    localized_solution,
-    localized_perturbed_solution;
-    
-    localized_solution.reset(_build_localized_vector(nonlin_sys,
-                                                     X).release());
-    localized_perturbed_solution.reset(_build_localized_vector(nonlin_sys,
-                                                               dX).release());
-    
-    
-    // if a solution function is attached, initialize it
-    if (_sol_function)
-        _sol_function->init( X);
+    const libMesh::DofMap& dof_map = _assembly._system->system().get_dof_map();
+    const MAST::ElementTopologyCache& topology = _assembly._system->system().topology_cache();
+    std::auto_ptr<MAST::ElementBase> elem_storage;
+    MAST::ElementBase* physics_elem = nullptr;
     
+    // the time of each element is measured if the cost model requests it
+    MAST::ElementCostModel*
+    cost_model = _assembly._cost_model;
+    if (cost_model && !cost_model->measuring())
+        cost_model = nullptr;
     
-    libMesh::MeshBase::const_element_iterator       el     =
-    nonlin_sys.get_mesh().active_local_elements_begin();
-    const libMesh::MeshBase::const_element_iterator end_el =
-    nonlin_sys.get_mesh().active_local_elements_end();
+    std::chrono::steady_clock::time_point
+    t0;
     
+    libMesh::ConstElemRange::const_iterator
+    el     = range.begin(),
+    end_el = range.end();
     
     for ( ; el != end_el; ++el) {
         
         const libMesh::Elem* elem = *el;
         
-        dof_map.dof_indices (elem, dof_indices);
+        if (cost_model)
+            t0 = std::chrono::steady_clock::now();
+        
+        topology.dof_indices (elem, dof_indices);
         
-        physics_elem.reset(_build_elem(*elem).release());
+        physics_elem = &_assembly._get_elem(*elem, elem_storage);
         
         // get the solution
         unsigned int ndofs = (unsigned int)dof_indices.size();
         sol.setZero(ndofs);
-        dsol.setZero(ndofs);
         vec.setZero(ndofs);
-        mat.setZero(ndofs, ndofs);
+        if (_J)
+            mat.setZero(ndofs, ndofs);
         
-        for (unsigned int i=0; i<dof_indices.size(); i++) {
-            sol (i) = (*localized_solution)          (dof_indices[i]);
-            dsol(i) = (*localized_perturbed_solution)(dof_indices[i]);
-        }
+        _assembly._get_elem_values(_sol, dof_indices, sol);
         
-        physics_elem->set_solution(sol);
-        physics_elem->set_perturbed_solution(dsol);
+        _assembly._set_elem_solution(*physics_elem, sol);
         
-        if (_sol_function)
-            physics_elem->attach_active_solution_function(*_sol_function);
+        if (_assembly._sol_function)
+            physics_elem->attach_active_solution_function(*_assembly._sol_function);
         
         //_check_element_numerical_jacobian(*physics_elem, sol);
         
-        // perform the element level calculations
-        _elem_linearized_jacobian_solution_product(*physics_elem,
-                                                   vec);
+        // perform the element level calculations. The residual-only
+        // kernel avoids the Jacobian work when it is not requested.
+        {
+            MAST_LOG_SCOPE("elem_calculations()", "NonlinearImplicitAssembly");
+            
+            if (_J && _assembly.if_finite_difference_jacobian(*elem))
+                _assembly._elem_finite_difference_jacobian(*elem,
+                                                           *physics_elem,
+                                                           sol,
+                                                           vec, mat);
+            else if (_J)
+                _assembly._elem_calculations(*physics_elem,
+                                             true,
+                                             vec, mat);
+            else
+                _assembly._elem_residual_calculations(*physics_elem, vec);
+        }
         
         physics_elem->detach_active_solution_function();
         
         // copy to the libMesh matrix for further processing
-        DenseRealVector v;
-        MAST::copy(v, vec);
+        if (_R)
+            MAST::copy(v, vec);
+        if (_J)
+            MAST::copy(m, mat);
         
         // constrain the quantities to account for hanging dofs,
-        // Dirichlet constraints, etc.
-        dof_map.constrain_element_vector(v, dof_indices);
+        // Dirichlet constraints, etc. This is skipped for elements
+        // without constrained dofs, for which it does not change the
+        // element quantities.
+        if (topology.has_constrained_dofs(*elem)) {
+            
+            MAST_LOG_SCOPE("constrain_element()", "NonlinearImplicitAssembly");
+            
+            if (_R && _J)
+                dof_map.constrain_element_matrix_and_vector(m, v, dof_indices);
+            else if (_R)
+                dof_map.constrain_element_vector(v, dof_indices);
+            else
+                dof_map.constrain_element_matrix(m, dof_indices);
+        }
         
-        // add to the global matrices
-        JdX.add_vector(v, dof_indices);
+        if (cost_model)
+            cost_model->add_measured_cost
+            (*elem,
+             std::chrono::duration<Real>(std::chrono::steady_clock::now() - t0).count());
+        
+        // the retained entry of each element is modified by only one
+        // thread, and the global quantities are added by the caller
+        if (_cache) {
+            
+            MAST::NonlinearImplicitAssembly::ElemContributionMapType::iterator
+            it = _cache->find(elem);
+            libmesh_assert(it != _cache->end());
+            
+            it->second.dof_indices = dof_indices;
+            if (_R) it->second.vec = v;
+            if (_J) it->second.mat = m;
+            continue;
+        }
+        
+        // add to the global matrices. Only one thread at a time is
+        // allowed to modify the global data structures. The logged time
+        // includes the time spent waiting for the lock.
+        {
+            MAST_LOG_SCOPE("global_add()", "NonlinearImplicitAssembly");
+            
+            libMesh::Threads::spin_mutex::scoped_lock
+            lock(libMesh::Threads::spin_mtx);
+            
+            if (_R) _R->add_vector(v, dof_indices);
+            if (_J) _assembly._add_elem_matrix(*_J, m, dof_indices, elem);
+        }
     }
+}
+
+
+
+void
+MAST::NonlinearImplicitAssembly::
+_elem_residual_calculations(MAST::ElementBase& elem,
+                            RealVectorX& vec) {
     
+    RealMatrixX
+    mat = RealMatrixX::Zero(vec.size(), vec.size());
     
-    // if a solution function is attached, clear it
-    if (_sol_function)
-        _sol_function->clear();
+    _elem_calculations(elem, false, vec, mat);
+}
+
+
+
+void
+MAST::NonlinearImplicitAssembly::
+set_jacobian_lag(unsigned int n) {
     
-    JdX.close();
+    libmesh_assert_greater(n, 0);
+    
+    _jacobian_lag = n;
+    
+    this->_update_jacobian_zero_out();
 }
 
 
 
 void
 MAST::NonlinearImplicitAssembly::
-_elem_linearized_jacobian_solution_product(MAST::ElementBase& elem,
-                                           RealVectorX& vec) {
+set_jacobian_stagnation_ratio(Real r) {
     
-    // must be implemented in inherited class
-    libmesh_error();
+    libmesh_assert_greater_equal(r, 0.);
+    
+    _jacobian_stagnation_ratio = r;
 }
 
 
 
 bool
-MAST::NonlinearImplicitAssembly::
-sensitivity_assemble (const libMesh::ParameterVector& parameters,
-                      const unsigned int i,
-                      libMesh::NumericVector<Real>& sensitivity_rhs) {
+MAST::NonlinearImplicitAssembly::_if_update_jacobian() {
     
-    MAST::NonlinearSystem& nonlin_sys = _system->system();
+    bool
+    update = (_force_jacobian_update ||
+              _n_jacobian_requests_since_update+1 >= _jacobian_lag);
     
-    sensitivity_rhs.zero();
+    // reassemble if the residual has not decreased sufficiently since the
+    // previous residual evaluation
+    if (!update &&
+        _jacobian_stagnation_ratio > 0. &&
+        _residual_l2_previous > 0. &&
+        _residual_l2 > _jacobian_stagnation_ratio * _residual_l2_previous)
+        update = true;
     
-    // iterate over each element, initialize it and get the relevant
-    // analysis quantities
-    RealVectorX vec, sol;
-    RealMatrixX mat;
+    if (update) {
+        
+        _force_jacobian_update            = false;
+        _n_jacobian_requests_since_update = 0;
+    }
+    else
+        _n_jacobian_requests_since_update++;
     
-    std::vector<libMesh::dof_id_type> dof_indices;
-    const libMesh::DofMap& dof_map = nonlin_sys.get_dof_map();
-    std::auto_ptr<MAST::ElementBase> physics_elem;
+    return update;
+}
+
+
+
+void
+MAST::NonlinearImplicitAssembly::_update_jacobian_zero_out() {
     
-    std::auto_ptr<libMesh::NumericVector<Real> > localized_solution;
-    localized_solution.reset(_build_localized_vector(nonlin_sys,
-                                                     *nonlin_sys.solution).release());
+    if (!_system)
+        return;
     
-    // if a solution function is attached, initialize it
-    if (_sol_function)
-        _sol_function->init( *nonlin_sys.solution);
+    libMesh::PetscNonlinearSolver<Real>*
+    solver = dynamic_cast<libMesh::PetscNonlinearSolver<Real>*>
+    (_system->system().nonlinear_solver.get());
     
-    libMesh::MeshBase::const_element_iterator       el     =
-    nonlin_sys.get_mesh().active_local_elements_begin();
-    const libMesh::MeshBase::const_element_iterator end_el =
-    nonlin_sys.get_mesh().active_local_elements_end();
+    if (solver)
+        solver->set_jacobian_zero_out(_jacobian_lag == 1 &&
+                                      !_solution_independent_jacobian);
+}
+
+
+
+void
+MAST::NonlinearImplicitAssembly::
+set_solution_independent_jacobian(bool f) {
     
-    for ( ; el != end_el; ++el) {
-        
-        const libMesh::Elem* elem = *el;
-        
-        dof_map.dof_indices (elem, dof_indices);
-        
-        physics_elem.reset(_build_elem(*elem).release());
-        
-        // get the solution
-        unsigned int ndofs = (unsigned int)dof_indices.size();
+    _solution_independent_jacobian = f;
+    _jacobian_key_matrix           = nullptr;
+    _jacobian_key_params.clear();
+    
+    this->_update_jacobian_zero_out();
+}
+
+
+
+bool
+MAST::NonlinearImplicitAssembly::
+_if_jacobian_key_valid(const libMesh::SparseMatrix<Real>& J) {
+    
+    std::map<const Real*, Real> vals;
+    _get_parameter_values(vals);
+    
+    if (!_force_jacobian_update       &&
+        &J == _jacobian_key_matrix    &&
+        vals == _jacobian_key_params)
+        return true;
+    
+    // the matrix will be assembled for the current key
+    _force_jacobian_update = false;
+    _jacobian_key_matrix   = &J;
+    _jacobian_key_params   = vals;
+    
+    return false;
+}
+
+
+
+void
+MAST::NonlinearImplicitAssembly::
+set_incremental_assembly(bool f) {
+    
+    _incremental_assembly = f;
+    
+    if (!f)
+        this->clear_incremental_assembly_cache();
+}
+
+
+
+void
+MAST::NonlinearImplicitAssembly::
+clear_incremental_assembly_cache() {
+    
+    _elem_contributions.clear();
+    _elem_contributions_res.X.reset();
+    _elem_contributions_res.params.clear();
+    _elem_contributions_jac.X.reset();
+    _elem_contributions_jac.params.clear();
+}
+
+
+
+void
+MAST::NonlinearImplicitAssembly::clear_mesh_dependent_data() {
+    
+    MAST::AssemblyBase::clear_mesh_dependent_data();
+    this->clear_incremental_assembly_cache();
+    _interior_elems.clear();
+    _boundary_elems.clear();
+    
+    // the matrix retained by the solver was sized and assembled for the
+    // old mesh, so the next request must reassemble it, independent of
+    // the lag or the key of a solution independent Jacobian
+    _jacobian_key_matrix              = nullptr;
+    _jacobian_key_params.clear();
+    _n_jacobian_requests_since_update = 0;
+    this->request_jacobian_update();
+}
+
+
+
+void
+MAST::NonlinearImplicitAssembly::_init_interior_elems() {
+    
+    libmesh_assert(_system);
+    
+    MAST::NonlinearSystem& nonlin_sys = _system->system();
+    
+    if (_interior_elems.size() + _boundary_elems.size() ==
+        nonlin_sys.get_mesh().n_active_local_elem())
+        return;
+    
+    MAST_LOG_SCOPE("init_interior_elems()", "NonlinearImplicitAssembly");
+    
+    _interior_elems.clear();
+    _boundary_elems.clear();
+    
+    const libMesh::DofMap& dof_map = nonlin_sys.get_dof_map();
+    const MAST::ElementTopologyCache& topology = nonlin_sys.topology_cache();
+    
+    const libMesh::dof_id_type
+    first = dof_map.first_dof(),
+    last  = dof_map.end_dof();
+    
+    std::vector<libMesh::dof_id_type> dof_indices;
+    
+    libMesh::MeshBase::const_element_iterator
+    el     = nonlin_sys.get_mesh().active_local_elements_begin(),
+    end_el = nonlin_sys.get_mesh().active_local_elements_end();
+    
+    for ( ; el != end_el; ++el) {
+        
+        topology.dof_indices(*el, dof_indices);
+        
+        bool
+        owned = true;
+        
+        for (unsigned int i=0; i<dof_indices.size(); i++)
+            if (dof_indices[i] < first || dof_indices[i] >= last) {
+                owned = false;
+                break;
+            }
+        
+        if (owned) _interior_elems.push_back(*el);
+        else       _boundary_elems.push_back(*el);
+    }
+}
+
+
+
+void
+MAST::NonlinearImplicitAssembly::report_memory(MAST::MemoryReport& r,
+                                               const std::string& nm) const {
+    
+    MAST::AssemblyBase::report_memory(r, nm);
+    
+    std::size_t v = 0;
+    
+    MAST::NonlinearImplicitAssembly::ElemContributionMapType::const_iterator
+    it  = _elem_contributions.begin(),
+    end = _elem_contributions.end();
+    
+    for ( ; it != end; it++)
+        v +=
+        MAST::MemoryReport::bytes(it->second.dof_indices) +
+        MAST::MemoryReport::bytes(it->second.vec.get_values()) +
+        MAST::MemoryReport::bytes(it->second.mat.get_values());
+    
+    if (_elem_contributions_res.X.get())
+        v += MAST::MemoryReport::bytes(*_elem_contributions_res.X);
+    if (_elem_contributions_jac.X.get())
+        v += MAST::MemoryReport::bytes(*_elem_contributions_jac.X);
+    
+    r.add(nm, "element contributions", v);
+}
+
+
+
+bool
+MAST::NonlinearImplicitAssembly::
+_get_incremental_elems(const libMesh::NumericVector<Real>& X,
+                       const MAST::NonlinearImplicitAssembly::ElemContributionState& state,
+                       std::set<const libMesh::Elem*>& elems) {
+    
+    if (!state.X.get())
+        return false;
+    
+    // the element quantities depend on the solution
+    {
+        std::auto_ptr<libMesh::NumericVector<Real> >
+        dX(state.X->clone().release());
+        dX->add(-1., X);
+        
+        if (dX->linfty_norm() != 0.)
+            return false;
+    }
+    
+    // the parameter values are compared, instead of tracking the
+    // modifications of MAST::Parameter, since the values are also modified
+    // through the pointers held by libMesh::ParameterVector
+    const std::map<const Real*, const MAST::FunctionBase*>&
+    params = _discipline->get_parameter_map();
+    
+    if (params.size() != state.params.size())
+        return false;
+    
+    std::map<const Real*, const MAST::FunctionBase*>::const_iterator
+    it  = params.begin(),
+    end = params.end();
+    
+    for ( ; it != end; it++) {
+        
+        std::map<const Real*, Real>::const_iterator
+        p_it = state.params.find(it->first);
+        
+        if (p_it == state.params.end())
+            return false;
+        
+        if (*it->first == p_it->second)
+            continue;
+        
+        const std::vector<const libMesh::Elem*>&
+        dep_elems = _discipline->get_dependent_local_elems(*it->second);
+        
+        elems.insert(dep_elems.begin(), dep_elems.end());
+    }
+    
+    return true;
+}
+
+
+
+void
+MAST::NonlinearImplicitAssembly::
+_update_incremental_state(const libMesh::NumericVector<Real>& X,
+                          MAST::NonlinearImplicitAssembly::ElemContributionState& state) {
+    
+    if (!state.X.get())
+        state.X.reset(X.zero_clone().release());
+    
+    *state.X = X;
+    
+    _get_parameter_values(state.params);
+}
+
+
+
+void
+MAST::NonlinearImplicitAssembly::
+_set_elem_solution(MAST::ElementBase& elem,
+                   const RealVectorX& sol) {
+    
+    elem.set_solution(sol);
+}
+
+
+
+void
+MAST::NonlinearImplicitAssembly::
+residual_and_jacobian (const libMesh::NumericVector<Real>& X,
+                       libMesh::NumericVector<Real>* R,
+                       libMesh::SparseMatrix<Real>*  J,
+                       libMesh::NonlinearImplicitSystem& S) {
+    
+    MAST::NonlinearSystem& nonlin_sys = _system->system();
+    
+    // make sure that the system for which this object was created,
+    // and the system passed through the function call are the same
+    libmesh_assert_equal_to(&S, &(nonlin_sys));
+    
+    MAST_LOG_SCOPE("residual_and_jacobian()", "NonlinearImplicitAssembly");
+    
+    // if the lag policy, or the key of a solution independent Jacobian,
+    // does not require a new Jacobian, the matrix is left unchanged from
+    // its previous assembly
+    if (J) {
+        
+        if (_solution_independent_jacobian) {
+            if (_if_jacobian_key_valid(*J))
+                J = nullptr;
+        }
+        else if (!_if_update_jacobian())
+            J = nullptr;
+        
+        if (!J && !R)
+            return;
+    }
+    
+    if (R) R->zero();
+    if (J) J->zero();
+    
+    // with overlapped communication, the ghost update of the solution
+    // is only started here
+    bool
+    pending = false;
+    
+    std::auto_ptr<libMesh::NumericVector<Real> > localized_solution;
+    if (_overlapped_communication && !_incremental_assembly)
+        localized_solution.reset(_begin_localized_vector(nonlin_sys,
+                                                         X,
+                                                         pending).release());
+    else
+        localized_solution.reset(_build_localized_vector(nonlin_sys,
+                                                         X).release());
+    
+    
+    // if a solution function is attached, initialize it
+    if (_sol_function)
+        _sol_function->init( X);
+    
+    
+    if (pending) {
+        
+        this->_init_interior_elems();
+        
+        // the elements with only owned dofs read their solution from X,
+        // while the ghost values are communicated. The remaining elements
+        // are computed after the update.
+        for (unsigned int i=0; i<2; i++) {
+            
+            if (i == 1)
+                this->_end_localized_vector(*localized_solution);
+            
+            std::vector<const libMesh::Elem*>&
+            elems = i ? _boundary_elems : _interior_elems;
+            
+            if (!elems.size())
+                continue;
+            
+            libMesh::ConstElemRange elem_range(&elems);
+            
+            MAST::NonlinearImplicitAssembly::ElemResidualAndJacobian
+            elem_ops(*this, i ? *localized_solution : X, R, J);
+            
+            if (_threaded_assembly && !_sol_function)
+                libMesh::Threads::parallel_reduce(elem_range, elem_ops);
+            else
+                elem_ops(elem_range);
+        }
+    }
+    else if (!_incremental_assembly) {
+        
+        // iterate over each element, initialize it and get the relevant
+        // analysis quantities
+        libMesh::ConstElemRange
+        elem_range(nonlin_sys.get_mesh().active_local_elements_begin(),
+                   nonlin_sys.get_mesh().active_local_elements_end());
+        
+        MAST::NonlinearImplicitAssembly::ElemResidualAndJacobian
+        elem_ops(*this, *localized_solution, R, J);
+        
+        // the solution function is shared by all elements, which may set
+        // their quadrature point solution in it. So, the loop is serial
+        // if one is attached.
+        if (_threaded_assembly && !_sol_function)
+            libMesh::Threads::parallel_reduce(elem_range, elem_ops);
+        else
+            elem_ops(elem_range);
+    }
+    else {
+        
+        // the residual and Jacobian are checked separately, since a
+        // solver like SNES requests them in separate calls. The elements
+        // recomputed for one quantity are recomputed for both, if both
+        // are requested.
+        std::set<const libMesh::Elem*> elem_set;
+        
+        const bool
+        all_elems =
+        (R && !_get_incremental_elems(X, _elem_contributions_res, elem_set)) ||
+        (J && !_get_incremental_elems(X, _elem_contributions_jac, elem_set));
+        
+        std::vector<const libMesh::Elem*> elems;
+        
+        if (all_elems) {
+            
+            // the retained quantity that is not requested remains valid,
+            // unless the local elements have changed. The entries are
+            // created here, so that the threads only modify existing
+            // entries.
+            if (_elem_contributions.size() != nonlin_sys.get_mesh().n_active_local_elem())
+                this->clear_incremental_assembly_cache();
+            
+            libMesh::MeshBase::const_element_iterator
+            el     = nonlin_sys.get_mesh().active_local_elements_begin(),
+            end_el = nonlin_sys.get_mesh().active_local_elements_end();
+            
+            for ( ; el != end_el; ++el) {
+                elems.push_back(*el);
+                _elem_contributions[*el];
+            }
+        }
+        else
+            elems.assign(elem_set.begin(), elem_set.end());
+        
+        // recompute the elements that have changed. Only the requested
+        // quantities are updated for these elements.
+        if (elems.size()) {
+            
+            libMesh::ConstElemRange elem_range(&elems);
+            
+            MAST::NonlinearImplicitAssembly::ElemResidualAndJacobian
+            elem_ops(*this, *localized_solution, R, J, &_elem_contributions);
+            
+            if (_threaded_assembly && !_sol_function)
+                libMesh::Threads::parallel_reduce(elem_range, elem_ops);
+            else
+                elem_ops(elem_range);
+        }
+        
+        if (R) _update_incremental_state(X, _elem_contributions_res);
+        if (J) _update_incremental_state(X, _elem_contributions_jac);
+        
+        // add the retained quantities of all elements to the
+        // global quantities
+        {
+            MAST_LOG_SCOPE("global_add()", "NonlinearImplicitAssembly");
+            
+            MAST::NonlinearImplicitAssembly::ElemContributionMapType::const_iterator
+            it  = _elem_contributions.begin(),
+            end = _elem_contributions.end();
+            
+            for ( ; it != end; it++) {
+                
+                if (R) R->add_vector(it->second.vec, it->second.dof_indices);
+                if (J) _add_elem_matrix(*J, it->second.mat, it->second.dof_indices, it->first);
+            }
+        }
+    }
+    
+
+    // if a solution function is attached, clear it
+    if (_sol_function)
+        _sol_function->clear();
+    
+    this->_assemble_nodal_quantities(R, J);
+    
+    this->_close_residual_and_jacobian(R, J);
+}
+
+
+
+void
+MAST::NonlinearImplicitAssembly::
+_assemble_nodal_quantities(libMesh::NumericVector<Real>* R,
+                           libMesh::SparseMatrix<Real>*  J) {
+    
+    // nothing to be done by default
+}
+
+
+
+
+void
+MAST::NonlinearImplicitAssembly::
+_assemble_nodal_sensitivity(const MAST::FunctionBase& f,
+                            libMesh::NumericVector<Real>& sensitivity_rhs) {
+    
+    // nothing to be done by default
+}
+
+
+
+void
+MAST::NonlinearImplicitAssembly::
+_close_residual_and_jacobian(libMesh::NumericVector<Real>* R,
+                             libMesh::SparseMatrix<Real>*  J) {
+    
+    _deferred_R = R;
+    _deferred_J = J;
+    
+    if (!_deferred_close) {
+        this->close_residual_and_jacobian();
+        return;
+    }
+    
+    // the communication of the off-processor entries is started, and is
+    // completed in close_residual_and_jacobian()
+    libMesh::PetscVector<Real>*
+    r = dynamic_cast<libMesh::PetscVector<Real>*>(R);
+    libMesh::PetscMatrix<Real>*
+    j = dynamic_cast<libMesh::PetscMatrix<Real>*>(J);
+    
+    if (!_overlapped_communication || (R && !r) || (J && !j))
+        return;
+    
+    PetscErrorCode ierr = 0;
+    
+    if (r) {
+        ierr = VecAssemblyBegin(r->vec());
+        CHKERRABORT(r->comm().get(), ierr);
+    }
+    
+    if (j) {
+        ierr = MatAssemblyBegin(j->mat(), MAT_FINAL_ASSEMBLY);
+        CHKERRABORT(j->comm().get(), ierr);
+    }
+    
+    _deferred_assembly_begun = true;
+}
+
+
+
+void
+MAST::NonlinearImplicitAssembly::close_residual_and_jacobian() {
+    
+    libMesh::NumericVector<Real>* R = _deferred_R;
+    libMesh::SparseMatrix<Real>*  J = _deferred_J;
+    
+    _deferred_R = nullptr;
+    _deferred_J = nullptr;
+    
+    // the communication started in residual_and_jacobian() is completed
+    // before the closure, which then has no entries to communicate
+    if (_deferred_assembly_begun) {
+        
+        PetscErrorCode ierr = 0;
+        
+        if (R) {
+            ierr = VecAssemblyEnd(dynamic_cast<libMesh::PetscVector<Real>*>(R)->vec());
+            CHKERRABORT(R->comm().get(), ierr);
+        }
+        
+        if (J) {
+            ierr = MatAssemblyEnd(dynamic_cast<libMesh::PetscMatrix<Real>*>(J)->mat(),
+                                  MAT_FINAL_ASSEMBLY);
+            CHKERRABORT(J->comm().get(), ierr);
+        }
+        
+        _deferred_assembly_begun = false;
+    }
+    
+    if (R) R->close();
+    if (J) J->close();
+    
+    // the residual norms are needed only for the stagnation trigger
+    if (R && _jacobian_stagnation_ratio > 0.) {
+        
+        _residual_l2_previous = _residual_l2;
+        _residual_l2          = R->l2_norm();
+    }
+}
+
+
+
+
+void
+MAST::NonlinearImplicitAssembly::
+linearized_jacobian_solution_product (const libMesh::NumericVector<Real>& X,
+                                      const libMesh::NumericVector<Real>& dX,
+                                      libMesh::NumericVector<Real>& JdX,
+                                      libMesh::NonlinearImplicitSystem& S) {
+    
+    // zero the solution vector
+    JdX.zero();
+    
+    MAST::NonlinearSystem& nonlin_sys = _system->system();
+    
+    // make sure that the system for which this object was created,
+    // and the system passed through the function call are the same
+    libmesh_assert_equal_to(&S, &(nonlin_sys));
+    
+    MAST_LOG_SCOPE("linearized_jacobian_solution_product()", "NonlinearImplicitAssembly");
+    
+    // iterate over each element, initialize it and get the relevant
+    // analysis quantities
+    RealVectorX vec, sol, dsol;
+    RealMatrixX mat;
+    
+    std::vector<libMesh::dof_id_type> dof_indices;
+    const libMesh::DofMap& dof_map = _system->system().get_dof_map();
+    const MAST::ElementTopologyCache& topology = _system->system().topology_cache();
+    std::auto_ptr<MAST::ElementBase> elem_storage;
+    MAST::ElementBase* physics_elem = nullptr;
+    DenseRealVector v;
+    
+    std::auto_ptr<libMesh::NumericVector<Real> >
+    localized_solution,
+    localized_perturbed_solution;
+    
+    localized_solution.reset(_build_localized_vector(nonlin_sys,
+                                                     X).release());
+    localized_perturbed_solution.reset(_build_localized_vector(nonlin_sys,
+                                                               dX).release());
+    
+    
+    // if a solution function is attached, initialize it
+    if (_sol_function)
+        _sol_function->init( X);
+    
+    
+    libMesh::MeshBase::const_element_iterator       el     =
+    nonlin_sys.get_mesh().active_local_elements_begin();
+    const libMesh::MeshBase::const_element_iterator end_el =
+    nonlin_sys.get_mesh().active_local_elements_end();
+    
+    
+    for ( ; el != end_el; ++el) {
+        
+        const libMesh::Elem* elem = *el;
+        
+        topology.dof_indices (elem, dof_indices);
+        
+        physics_elem = &_get_elem(*elem, elem_storage);
+        
+        // get the solution
+        unsigned int ndofs = (unsigned int)dof_indices.size();
+        sol.setZero(ndofs);
+        dsol.setZero(ndofs);
+        vec.setZero(ndofs);
+        mat.setZero(ndofs, ndofs);
+        
+        _get_elem_values(*localized_solution, dof_indices, sol);
+        _get_elem_values(*localized_perturbed_solution, dof_indices, dsol);
+        
+        physics_elem->set_solution(sol);
+        physics_elem->set_perturbed_solution(dsol);
+        
+        if (_sol_function)
+            physics_elem->attach_active_solution_function(*_sol_function);
+        
+        //_check_element_numerical_jacobian(*physics_elem, sol);
+        
+        // perform the element level calculations
+        _elem_linearized_jacobian_solution_product(*physics_elem,
+                                                   vec);
+        
+        physics_elem->detach_active_solution_function();
+        
+        // copy to the libMesh matrix for further processing
+        MAST::copy(v, vec);
+        
+        // constrain the quantities to account for hanging dofs,
+        // Dirichlet constraints, etc.
+        if (topology.has_constrained_dofs(*elem))
+            dof_map.constrain_element_vector(v, dof_indices);
+        
+        // add to the global matrices
+        JdX.add_vector(v, dof_indices);
+    }
+    
+    
+    // if a solution function is attached, clear it
+    if (_sol_function)
+        _sol_function->clear();
+    
+    JdX.close();
+}
+
+
+
+void
+MAST::NonlinearImplicitAssembly::
+_elem_linearized_jacobian_solution_product(MAST::ElementBase& elem,
+                                           RealVectorX& vec) {
+    
+    // must be implemented in inherited class
+    libmesh_error();
+}
+
+
+
+void
+MAST::NonlinearImplicitAssembly::
+jacobian_transpose_solution_product(const libMesh::NumericVector<Real>& X,
+                                    const libMesh::NumericVector<Real>& w,
+                                    libMesh::NumericVector<Real>& res) {
+    
+    MAST_LOG_SCOPE("jacobian_transpose_solution_product()", "NonlinearImplicitAssembly");
+    
+    this->_jacobian_transpose_product(X, w, nullptr, res);
+}
+
+
+
+void
+MAST::NonlinearImplicitAssembly::
+residual_second_derivative_product(const libMesh::NumericVector<Real>& X,
+                                   const libMesh::NumericVector<Real>& dX,
+                                   const libMesh::NumericVector<Real>& w,
+                                   libMesh::NumericVector<Real>& res) {
+    
+    MAST_LOG_SCOPE("residual_second_derivative_product()", "NonlinearImplicitAssembly");
+    
+    res.zero();
+    
+    const Real
+    dX_norm = dX.l2_norm();
+    
+    if (dX_norm == 0.) {
+        
+        res.close();
+        return;
+    }
+    
+    // step of the central difference relative to the magnitude of the
+    // solution
+    const Real
+    h = sqrt(std::numeric_limits<Real>::epsilon()) * (1. + X.l2_norm()) / dX_norm;
+    
+    std::auto_ptr<libMesh::NumericVector<Real> >
+    X_p    (X.clone().release()),
+    res_m  (res.zero_clone().release());
+    
+    X_p->add(h, dX);
+    X_p->close();
+    this->_jacobian_transpose_product(*X_p, w, nullptr, res);
+    
+    X_p->add(-2.*h, dX);
+    X_p->close();
+    this->_jacobian_transpose_product(*X_p, w, nullptr, *res_m);
+    
+    res.add(-1., *res_m);
+    res.scale(0.5/h);
+    res.close();
+}
+
+
+
+void
+MAST::NonlinearImplicitAssembly::
+residual_mixed_second_derivative_product(const libMesh::ParameterVector& parameters,
+                                         const unsigned int i,
+                                         const libMesh::NumericVector<Real>& X,
+                                         const libMesh::NumericVector<Real>& w,
+                                         libMesh::NumericVector<Real>& res) {
+    
+    MAST_LOG_SCOPE("residual_mixed_second_derivative_product()", "NonlinearImplicitAssembly");
+    
+    const MAST::FunctionBase* f = _discipline->get_parameter(&(parameters[i].get()));
+    libmesh_assert(f);
+    
+    this->_jacobian_transpose_product(X, w, f, res);
+}
+
+
+
+void
+MAST::NonlinearImplicitAssembly::
+reduced_hessian_product(MAST::OutputAssemblyBase& output,
+                        libMesh::ParameterVector& parameters,
+                        const libMesh::NumericVector<Real>& adjoint,
+                        const RealVectorX& dp,
+                        RealVectorX& Hdp) {
+    
+    MAST_LOG_SCOPE("reduced_hessian_product()", "NonlinearImplicitAssembly");
+    
+    MAST::NonlinearSystem& nonlin_sys = _system->system();
+    
+    const unsigned int n_params = parameters.size();
+    
+    libmesh_assert_equal_to(dp.size(), n_params);
+    
+    Hdp.setZero(n_params);
+    
+    std::vector<libMesh::NumericVector<Real>*>
+    rhs(n_params, nullptr),
+    rhs_pert(n_params, nullptr);
+    
+    for (unsigned int j=0; j<n_params; j++) {
+        
+        rhs[j]      = nonlin_sys.solution->zero_clone().release();
+        rhs_pert[j] = nonlin_sys.solution->zero_clone().release();
+    }
+    
+    // the RHS of the sensitivity equations about the current solution,
+    // from which the solution sensitivity along dp is obtained:
+    //   [J] {dX} = - sum_j dp_j {dR/dp_j}
+    this->sensitivity_assemble(parameters, rhs);
+    
+    std::auto_ptr<libMesh::NumericVector<Real> >
+    X0     (nonlin_sys.solution->clone().release()),
+    dX     (nonlin_sys.solution->zero_clone().release()),
+    b      (nonlin_sys.solution->zero_clone().release()),
+    g_p    (nonlin_sys.solution->zero_clone().release()),
+    g_m    (nonlin_sys.solution->zero_clone().release()),
+    JTl    (nonlin_sys.solution->zero_clone().release()),
+    mu     (nonlin_sys.solution->zero_clone().release());
+    
+    for (unsigned int j=0; j<n_params; j++)
+        if (dp(j) != 0.)
+            b->add(dp(j), *rhs[j]);
+    b->close();
+    
+    {
+        std::vector<libMesh::NumericVector<Real>*>
+        b_vec(1, b.get()),
+        dX_vec(1, dX.get());
+        
+        nonlin_sys.multi_rhs_solve(b_vec, dX_vec);
+    }
+    
+    const Real
+    dir_norm = sqrt(dX->l2_norm()*dX->l2_norm() + dp.squaredNorm());
+    
+    if (dir_norm > 0.) {
+        
+        std::vector<Real> p0(n_params, 0.);
+        Real p_norm = 0.;
+        
+        for (unsigned int j=0; j<n_params; j++) {
+            
+            p0[j]   = parameters[j].get();
+            p_norm += p0[j]*p0[j];
+        }
+        
+        // step of the central difference relative to the magnitude of the
+        // solution and the parameters
+        const Real
+        h = sqrt(std::numeric_limits<Real>::epsilon()) *
+        (1. + sqrt(X0->l2_norm()*X0->l2_norm() + p_norm)) / dir_norm;
+        
+        // gradients of the Lagrangian with respect to the parameters at
+        // the perturbed points, for the fixed adjoint solution
+        RealVectorX
+        Lp_p = RealVectorX::Zero(n_params),
+        Lp_m = RealVectorX::Zero(n_params);
+        
+        for (unsigned int s=0; s<2; s++) {
+            
+            const Real
+            sign = s?-1.:1.;
+            
+            libMesh::NumericVector<Real>&
+            g = s?*g_m:*g_p;
+            
+            RealVectorX&
+            Lp = s?Lp_m:Lp_p;
+            
+            for (unsigned int j=0; j<n_params; j++)
+                parameters[j].set(p0[j] + sign*h*dp(j));
+            
+            // the residual sensitivity is assembled about the solution
+            // of the system
+            *nonlin_sys.solution = *X0;
+            nonlin_sys.solution->add(sign*h, *dX);
+            nonlin_sys.solution->close();
+            
+            //  g = dq/dX - [J]^T {lambda}
+            output.assemble_output_derivative(*nonlin_sys.solution, g);
+            this->jacobian_transpose_solution_product(*nonlin_sys.solution,
+                                                      adjoint,
+                                                      *JTl);
+            g.add(-1., *JTl);
+            g.close();
+            
+            // {lambda}^T (-dR/dp_j)
+            this->sensitivity_assemble(parameters, rhs_pert);
+            for (unsigned int j=0; j<n_params; j++)
+                Lp(j) = adjoint.dot(*rhs_pert[j]);
+        }
+        
+        // restore the parameters and the solution
+        for (unsigned int j=0; j<n_params; j++)
+            parameters[j].set(p0[j]);
+        
+        *nonlin_sys.solution = *X0;
+        nonlin_sys.solution->close();
+        
+        // the second order adjoint: [J]^T {mu} = d(g)/d(dp)
+        g_p->add(-1., *g_m);
+        g_p->scale(0.5/h);
+        g_p->close();
+        
+        nonlin_sys.transpose_solve(*g_p, *mu);
+        
+        for (unsigned int j=0; j<n_params; j++)
+            Hdp(j) = mu->dot(*rhs[j]) + 0.5*(Lp_p(j) - Lp_m(j))/h;
+    }
+    
+    for (unsigned int j=0; j<n_params; j++) {
+        
+        delete rhs[j];
+        delete rhs_pert[j];
+    }
+}
+
+
+
+void
+MAST::NonlinearImplicitAssembly::
+_jacobian_transpose_product(const libMesh::NumericVector<Real>& X,
+                            const libMesh::NumericVector<Real>& w,
+                            const MAST::FunctionBase* f,
+                            libMesh::NumericVector<Real>& res) {
+    
+    MAST::NonlinearSystem& nonlin_sys = _system->system();
+    
+    res.zero();
+    
+    RealVectorX vec, sol, w_e;
+    RealMatrixX mat;
+    
+    std::vector<libMesh::dof_id_type> dof_indices;
+    const libMesh::DofMap& dof_map = nonlin_sys.get_dof_map();
+    const MAST::ElementTopologyCache& topology = nonlin_sys.topology_cache();
+    std::auto_ptr<MAST::ElementBase> elem_storage;
+    MAST::ElementBase* physics_elem = nullptr;
+    DenseRealVector v;
+    
+    std::auto_ptr<libMesh::NumericVector<Real> >
+    localized_solution,
+    localized_w;
+    
+    localized_solution.reset(_build_localized_vector(nonlin_sys, X).release());
+    localized_w.reset(_build_localized_vector(nonlin_sys, w).release());
+    
+    // if a solution function is attached, initialize it
+    if (_sol_function)
+        _sol_function->init( X);
+    
+    // the Jacobian sensitivity is nonzero only on the elements that
+    // depend on the parameter
+    std::vector<const libMesh::Elem*> elems;
+    
+    if (f)
+        elems = _discipline->get_dependent_local_elems(*f);
+    else {
+        
+        libMesh::MeshBase::const_element_iterator       it     =
+        nonlin_sys.get_mesh().active_local_elements_begin();
+        const libMesh::MeshBase::const_element_iterator end_it =
+        nonlin_sys.get_mesh().active_local_elements_end();
+        
+        for ( ; it != end_it; ++it)
+            elems.push_back(*it);
+    }
+    
+    std::vector<const libMesh::Elem*>::const_iterator
+    el     = elems.begin(),
+    end_el = elems.end();
+    
+    for ( ; el != end_el; ++el) {
+        
+        const libMesh::Elem* elem = *el;
+        
+        topology.dof_indices (elem, dof_indices);
+        
+        physics_elem = &_get_elem(*elem, elem_storage);
+        
+        unsigned int ndofs = (unsigned int)dof_indices.size();
         sol.setZero(ndofs);
+        w_e.setZero(ndofs);
         vec.setZero(ndofs);
         mat.setZero(ndofs, ndofs);
         
-        for (unsigned int i=0; i<dof_indices.size(); i++)
-            sol(i) = (*localized_solution)(dof_indices[i]);
+        _get_elem_values(*localized_solution, dof_indices, sol);
+        _get_elem_values(*localized_w, dof_indices, w_e);
+        
+        if (f)
+            physics_elem->sensitivity_param = f;
+        _set_elem_solution(*physics_elem, sol);
+        
+        if (_sol_function)
+            physics_elem->attach_active_solution_function(*_sol_function);
+        
+        // perform the element level calculations
+        if (f)
+            _elem_sensitivity_calculations(*physics_elem, true, vec, mat);
+        else if (this->if_finite_difference_jacobian(*elem))
+            _elem_finite_difference_jacobian(*elem, *physics_elem, sol, vec, mat);
+        else
+            _elem_calculations(*physics_elem, true, vec, mat);
+        
+        physics_elem->detach_active_solution_function();
+        
+        vec = mat.transpose() * w_e;
+        
+        // copy to the libMesh matrix for further processing
+        MAST::copy(v, vec);
+        
+        // constrain the quantities to account for hanging dofs,
+        // Dirichlet constraints, etc.
+        if (topology.has_constrained_dofs(*elem))
+            dof_map.constrain_element_vector(v, dof_indices);
+        
+        // add to the global vector
+        res.add_vector(v, dof_indices);
+    }
+    
+    // if a solution function is attached, clear it
+    if (_sol_function)
+        _sol_function->clear();
+    
+    res.close();
+}
+
+
+
+bool
+MAST::NonlinearImplicitAssembly::
+sensitivity_assemble (const libMesh::ParameterVector& parameters,
+                      const unsigned int i,
+                      libMesh::NumericVector<Real>& sensitivity_rhs) {
+    
+    MAST::NonlinearSystem& nonlin_sys = _system->system();
+    
+    MAST_LOG_SCOPE("sensitivity_assemble()", "NonlinearImplicitAssembly");
+    
+    sensitivity_rhs.zero();
+    
+    // iterate over each element, initialize it and get the relevant
+    // analysis quantities
+    RealVectorX vec, sol;
+    RealMatrixX mat;
+    
+    std::vector<libMesh::dof_id_type> dof_indices;
+    const libMesh::DofMap& dof_map = nonlin_sys.get_dof_map();
+    const MAST::ElementTopologyCache& topology = nonlin_sys.topology_cache();
+    std::auto_ptr<MAST::ElementBase> elem_storage;
+    MAST::ElementBase* physics_elem = nullptr;
+    DenseRealVector v;
+    
+    std::auto_ptr<libMesh::NumericVector<Real> > localized_solution;
+    localized_solution.reset(_build_localized_vector(nonlin_sys,
+                                                     *nonlin_sys.solution).release());
+    
+    // if a solution function is attached, initialize it
+    if (_sol_function)
+        _sol_function->init( *nonlin_sys.solution);
+    
+    const MAST::FunctionBase* f = _discipline->get_parameter(&(parameters[i].get()));
+    
+    // only the elements that depend on the parameter contribute to the
+    // sensitivity RHS
+    const std::vector<const libMesh::Elem*>&
+    elems = _discipline->get_dependent_local_elems(*f);
+    
+    std::vector<const libMesh::Elem*>::const_iterator
+    el     = elems.begin(),
+    end_el = elems.end();
+    
+    for ( ; el != end_el; ++el) {
+        
+        const libMesh::Elem* elem = *el;
+        
+        topology.dof_indices (elem, dof_indices);
+        
+        physics_elem = &_get_elem(*elem, elem_storage);
+        
+        // get the solution
+        unsigned int ndofs = (unsigned int)dof_indices.size();
+        sol.setZero(ndofs);
+        vec.setZero(ndofs);
+        mat.setZero(ndofs, ndofs);
+        
+        _get_elem_values(*localized_solution, dof_indices, sol);
         
-        physics_elem->sensitivity_param = _discipline->get_parameter(&(parameters[i].get()));
+        physics_elem->sensitivity_param = f;
         physics_elem->set_solution(sol);
         
         if (_sol_function)
@@ -485,12 +1743,12 @@ sensitivity_assemble (const libMesh::ParameterVector& parameters,
         physics_elem->detach_active_solution_function();
         
         // copy to the libMesh matrix for further processing
-        DenseRealVector v;
         MAST::copy(v, vec);
 
         // constrain the quantities to account for hanging dofs,
         // Dirichlet constraints, etc.
-        dof_map.constrain_element_vector(v, dof_indices);
+        if (topology.has_constrained_dofs(*elem))
+            dof_map.constrain_element_vector(v, dof_indices);
         
         // add to the global matrices
         sensitivity_rhs.add_vector(v, dof_indices);
@@ -500,9 +1758,277 @@ sensitivity_assemble (const libMesh::ParameterVector& parameters,
     if (_sol_function)
         _sol_function->clear();
     
+    this->_assemble_nodal_sensitivity(*f, sensitivity_rhs);
+    
     sensitivity_rhs.close();
     
     return true;
 }
 
 
+
+
+bool
+MAST::NonlinearImplicitAssembly::
+sensitivity_assemble (const libMesh::ParameterVector& parameters,
+                      std::vector<libMesh::NumericVector<Real>*>& sensitivity_rhs) {
+    
+    libmesh_assert_equal_to(sensitivity_rhs.size(), parameters.size());
+    
+    MAST::NonlinearSystem& nonlin_sys = _system->system();
+    
+    MAST_LOG_SCOPE("sensitivity_assemble_batch()", "NonlinearImplicitAssembly");
+    
+    const unsigned int n_params = parameters.size();
+    
+    std::vector<const MAST::FunctionBase*> f(n_params, nullptr);
+    
+    for (unsigned int i=0; i<n_params; i++) {
+        
+        f[i] = _discipline->get_parameter(&(parameters[i].get()));
+        sensitivity_rhs[i]->zero();
+    }
+    
+    // iterate over each element, initialize it and get the relevant
+    // analysis quantities
+    RealVectorX vec, sol;
+    
+    std::vector<libMesh::dof_id_type> dof_indices, param_dof_indices;
+    const libMesh::DofMap& dof_map = nonlin_sys.get_dof_map();
+    const MAST::ElementTopologyCache& topology = nonlin_sys.topology_cache();
+    std::auto_ptr<MAST::ElementBase> elem_storage;
+    MAST::ElementBase* physics_elem = nullptr;
+    DenseRealVector v;
+    
+    std::auto_ptr<libMesh::NumericVector<Real> > localized_solution;
+    localized_solution.reset(_build_localized_vector(nonlin_sys,
+                                                     *nonlin_sys.solution).release());
+    
+    // if a solution function is attached, initialize it
+    if (_sol_function)
+        _sol_function->init( *nonlin_sys.solution);
+    
+    // parameters that each element depends on. Elements that do not
+    // depend on any parameter are not visited.
+    std::map<const libMesh::Elem*, std::vector<unsigned int> > elem_params;
+    
+    for (unsigned int i=0; i<n_params; i++) {
+        
+        const std::vector<const libMesh::Elem*>&
+        elems = _discipline->get_dependent_local_elems(*f[i]);
+        
+        for (unsigned int j=0; j<elems.size(); j++)
+            elem_params[elems[j]].push_back(i);
+    }
+    
+    std::vector<const MAST::FunctionBase*> elem_f;
+    std::vector<RealVectorX>               elem_vecs;
+    
+    std::map<const libMesh::Elem*, std::vector<unsigned int> >::const_iterator
+    el     = elem_params.begin(),
+    end_el = elem_params.end();
+    
+    for ( ; el != end_el; ++el) {
+        
+        const libMesh::Elem* elem = el->first;
+        const std::vector<unsigned int>& params = el->second;
+        
+        topology.dof_indices (elem, dof_indices);
+        
+        physics_elem = &_get_elem(*elem, elem_storage);
+        
+        // the solution is the same for all parameters
+        unsigned int ndofs = (unsigned int)dof_indices.size();
+        sol.setZero(ndofs);
+        
+        _get_elem_values(*localized_solution, dof_indices, sol);
+        
+        _set_elem_solution(*physics_elem, sol);
+        
+        if (_sol_function)
+            physics_elem->attach_active_solution_function(*_sol_function);
+        
+        // perform the element level calculations for all parameters
+        // together
+        elem_f.resize(params.size());
+        elem_vecs.assign(params.size(), RealVectorX::Zero(ndofs));
+        
+        for (unsigned int p=0; p<params.size(); p++)
+            elem_f[p] = f[params[p]];
+        
+        _elem_parameter_sensitivity_calculations(*physics_elem, elem_f, elem_vecs);
+        
+        for (unsigned int p=0; p<params.size(); p++) {
+            
+            const unsigned int i = params[p];
+            
+            // the sensitivity method provides sensitivity of the residual.
+            // Hence, this is multiplied with -1 to make it the RHS of the
+            // sensitivity equations.
+            vec = -elem_vecs[p];
+            
+            // copy to the libMesh matrix for further processing
+            MAST::copy(v, vec);
+            
+            // constrain the quantities to account for hanging dofs,
+            // Dirichlet constraints, etc. The constraint may modify the
+            // dof indices, so a copy is used for each parameter.
+            param_dof_indices = dof_indices;
+            dof_map.constrain_element_vector(v, param_dof_indices);
+            
+            // add to the global matrices
+            sensitivity_rhs[i]->add_vector(v, param_dof_indices);
+        }
+        
+        physics_elem->detach_active_solution_function();
+    }
+    
+    // if a solution function is attached, initialize it
+    if (_sol_function)
+        _sol_function->clear();
+    
+    for (unsigned int i=0; i<n_params; i++) {
+        
+        this->_assemble_nodal_sensitivity(*f[i], *sensitivity_rhs[i]);
+        sensitivity_rhs[i]->close();
+    }
+    
+    return true;
+}
+
+
+
+
+
+void
+MAST::NonlinearImplicitAssembly::
+calculate_elementwise_output_sensitivity
+(const std::vector<MAST::OutputAssemblyBase*>& outputs,
+ const MAST::ElementwiseDesignField& f,
+ std::vector<libMesh::NumericVector<Real>*>& sens) {
+    
+    libmesh_assert_equal_to(sens.size(), outputs.size());
+    
+    MAST::NonlinearSystem& nonlin_sys = _system->system();
+    
+    MAST_LOG_SCOPE("elementwise_output_sensitivity()", "NonlinearImplicitAssembly");
+    
+    const unsigned int n_outputs = (unsigned int)outputs.size();
+    
+    if (!n_outputs)
+        return;
+    
+    // the adjoint solutions of all outputs
+    nonlin_sys.adjoint_solve(outputs);
+    
+    // the partial derivatives of the outputs
+    for (unsigned int i=0; i<n_outputs; i++) {
+        
+        sens[i]->zero();
+        outputs[i]->add_elementwise_output_partial_sensitivity(*nonlin_sys.solution,
+                                                               f,
+                                                               *sens[i]);
+        sens[i]->close();
+    }
+    
+    RealVectorX vec, sol;
+    RealMatrixX mat;
+    
+    std::vector<libMesh::dof_id_type> dof_indices, constrained_dof_indices;
+    const libMesh::DofMap& dof_map = nonlin_sys.get_dof_map();
+    const MAST::ElementTopologyCache& topology = nonlin_sys.topology_cache();
+    std::auto_ptr<MAST::ElementBase> elem_storage;
+    MAST::ElementBase* physics_elem = nullptr;
+    DenseRealVector v;
+    
+    std::auto_ptr<libMesh::NumericVector<Real> > localized_solution;
+    localized_solution.reset(_build_localized_vector(nonlin_sys,
+                                                     *nonlin_sys.solution).release());
+    
+    std::vector<libMesh::NumericVector<Real>*> localized_adjoint(n_outputs, nullptr);
+    for (unsigned int i=0; i<n_outputs; i++)
+        localized_adjoint[i] =
+        _build_localized_vector(nonlin_sys,
+                                nonlin_sys.get_adjoint_solution(i)).release();
+    
+    // if a solution function is attached, initialize it
+    if (_sol_function)
+        _sol_function->init( *nonlin_sys.solution);
+    
+    const std::vector<const libMesh::Elem*>&
+    elems = _discipline->get_dependent_local_elems(f);
+    
+    std::vector<const libMesh::Elem*>::const_iterator
+    el     = elems.begin(),
+    end_el = elems.end();
+    
+    for ( ; el != end_el; ++el) {
+        
+        const libMesh::Elem* elem = *el;
+        
+        topology.dof_indices (elem, dof_indices);
+        
+        physics_elem = &_get_elem(*elem, elem_storage);
+        
+        unsigned int ndofs = (unsigned int)dof_indices.size();
+        sol.setZero(ndofs);
+        vec.setZero(ndofs);
+        mat.setZero(ndofs, ndofs);
+        
+        _get_elem_values(*localized_solution, dof_indices, sol);
+        
+        _set_elem_solution(*physics_elem, sol);
+        physics_elem->sensitivity_param = &f;
+        
+        if (_sol_function)
+            physics_elem->attach_active_solution_function(*_sol_function);
+        
+        // derivative of the element residual with respect to the design
+        // value of this element
+        _elem_sensitivity_calculations(*physics_elem, false, vec, mat);
+        
+        physics_elem->detach_active_solution_function();
+        
+        // the constraints are applied as for the RHS of the sensitivity
+        // equations, which may modify the dof indices
+        MAST::copy(v, vec);
+        constrained_dof_indices = dof_indices;
+        dof_map.constrain_element_vector(v, constrained_dof_indices);
+        
+        const libMesh::dof_id_type
+        dof = f.dof_index(*elem);
+        
+        for (unsigned int i=0; i<n_outputs; i++) {
+            
+            Real val = 0.;
+            for (unsigned int j=0; j<constrained_dof_indices.size(); j++)
+                val += v(j) * (*localized_adjoint[i])(constrained_dof_indices[j]);
+            
+            sens[i]->add(dof, -val);
+        }
+    }
+    
+    // if a solution function is attached, clear it
+    if (_sol_function)
+        _sol_function->clear();
+    
+    for (unsigned int i=0; i<n_outputs; i++) {
+        
+        delete localized_adjoint[i];
+        sens[i]->close();
+    }
+}
+
+
+
+void
+MAST::NonlinearImplicitAssembly::
+calculate_elementwise_output_sensitivity(MAST::OutputAssemblyBase& output,
+                                         const MAST::ElementwiseDesignField& f,
+                                         libMesh::NumericVector<Real>& sens) {
+    
+    std::vector<libMesh::NumericVector<Real>*> s(1, &sens);
+    
+    this->calculate_elementwise_output_sensitivity
+    (std::vector<MAST::OutputAssemblyBase*>(1, &output), f, s);
+}
@@ -20,15 +20,28 @@
 #ifndef __mast__nonlinear_implicit_assembly__
 #define __mast__nonlinear_implicit_assembly__
 
+// C++ includes
+#include <set>
+
+
 // MAST includes
 #include "base/assembly_base.h"
 
 // libMesh includes
 #include "libmesh/nonlinear_implicit_system.h"
+#include "libmesh/elem_range.h"
+#include "libmesh/threads.h"
+#include "libmesh/coupling_matrix.h"
 
 
 namespace MAST {
     
+    // Forward declerations
+    class OutputAssemblyBase;
+    class ElementwiseDesignField;
+    class FunctionBase;
+    
+    
     class NonlinearImplicitAssembly:
     public MAST::AssemblyBase,
     public libMesh::NonlinearImplicitSystem::ComputeResidualandJacobian {
@@ -72,9 +85,238 @@ namespace MAST {
         clear_discipline_and_system( );
 
         
+        /*!
+         *   tells the assembly to distribute the element loop in
+         *   residual_and_jacobian() over the libMesh threads (as specified
+         *   by \p --n_threads). The element kernels of the inherited class,
+         *   and any field functions used by them, must be safe for
+         *   concurrent evaluation on distinct elements. The loop remains
+         *   serial while a solution function is attached, since elements
+         *   provide their quadrature point solution to it. This is \p false
+         *   by default.
+         */
+        void set_threaded_assembly(bool f) {
+            _threaded_assembly = f;
+        }
+        
+        
+        /*!
+         *   @returns \p true if the element loop in residual_and_jacobian() is
+         *   distributed over the libMesh threads.
+         */
+        bool if_threaded_assembly() const {
+            return _threaded_assembly;
+        }
+        
+        
+        /*!
+         *   if \p f is true, residual_and_jacobian() does not close the
+         *   residual and Jacobian, which requires global communication,
+         *   and close_residual_and_jacobian() must be called to do so. This
+         *   is used to assemble several disciplines with disjoint processor
+         *   sets concurrently: the element loops of all disciplines run
+         *   before the first global synchronization. This is \p false by
+         *   default.
+         */
+        void set_deferred_close(bool f) {
+            _deferred_close = f;
+        }
+        
+        
+        /*!
+         *   @returns \p true if the closure of the residual and Jacobian is
+         *   deferred to close_residual_and_jacobian().
+         */
+        bool if_deferred_close() const {
+            return _deferred_close;
+        }
+        
+        
+        /*!
+         *   if \p f is true, residual_and_jacobian() overlaps the global
+         *   communication with the element calculations: the ghost update
+         *   of the solution is started, the elements with only owned dofs
+         *   are computed from the owned values, and the elements with ghost
+         *   dofs after the update is completed. With deferred closure, the
+         *   assembly communication of the residual and Jacobian is started
+         *   at the end of residual_and_jacobian() and completed in
+         *   close_residual_and_jacobian(), so that the caller can do other
+         *   work in between. This is not used for incremental assembly.
+         *   This is \p false by default.
+         */
+        void set_overlapped_communication(bool f) {
+            _overlapped_communication = f;
+        }
+        
+        
+        /*!
+         *   @returns \p true if the communication is overlapped with the
+         *   element calculations
+         */
+        bool if_overlapped_communication() const {
+            return _overlapped_communication;
+        }
+        
+        
+        /*!
+         *   closes the residual and Jacobian of the last call to
+         *   residual_and_jacobian() with deferred closure. This must be
+         *   called on all processors, and does nothing if no quantity is
+         *   pending.
+         */
+        virtual void close_residual_and_jacobian();
+        
+        
+        /*!
+         *   sets the Jacobian lag: the Jacobian is reassembled only on every
+         *   \p n th request from the solver, and is otherwise left unchanged
+         *   from its previous assembly. This is 1 by default, so that the
+         *   Jacobian is reassembled on every request.
+         */
+        void set_jacobian_lag(unsigned int n);
+        
+        
+        /*!
+         *   if \p r is positive, a lagged Jacobian is reassembled whenever
+         *   the residual norm is greater than \p r times the norm of the
+         *   previous residual evaluation, which indicates stagnation of the
+         *   Newton iterations. This is 0 by default, which turns off the
+         *   trigger.
+         */
+        void set_jacobian_stagnation_ratio(Real r);
+        
+        
+        /*!
+         *   forces reassembly of the Jacobian on the next request from the
+         *   solver, independent of the lag. This should be called, for
+         *   example, when the load increment changes during continuation.
+         */
+        void request_jacobian_update() {
+            _force_jacobian_update = true;
+        }
+        
+        
+        /*!
+         *   tells residual_and_jacobian() that the Jacobian does not depend
+         *   on the solution or the loads, as is the case for linear
+         *   structural analysis. The Jacobian is then assembled only on the
+         *   first request, and reassembled only if the values of the
+         *   parameters added to the discipline have changed, a different
+         *   matrix is provided, or request_jacobian_update() is called.
+         *   Subsequent solves for different load cases then only assemble
+         *   the residual. The Jacobian lag is not used in this case. This
+         *   is \p false by default.
+         */
+        void set_solution_independent_jacobian(bool f);
+        
+        
+        /*!
+         *   tells the assembly to compute the element Jacobians of all
+         *   elements by finite differences of the element residual, instead
+         *   of calling _elem_calculations() with \p if_jac = true. This is
+         *   intended for prototype physics for which only the residual is
+         *   implemented. The dofs are colored with the variable coupling of
+         *   set_finite_difference_jacobian_coupling(), so that dofs of
+         *   uncoupled variables are perturbed together, and the geometric
+         *   quadrature point data of the element is reused for all
+         *   perturbations. This is \p false by default.
+         */
+        void set_finite_difference_jacobian(bool f);
+        
+        
+        /*!
+         *   tells the assembly to compute the element Jacobians of the
+         *   elements of subdomain \p sid by finite differences, so that
+         *   the analytical Jacobians are used for the other element
+         *   kernels.
+         */
+        void set_finite_difference_jacobian(libMesh::subdomain_id_type sid,
+                                            bool f);
+        
+        
+        /*!
+         *   sets the coupling of the system variables used to color the
+         *   dofs for the finite difference Jacobians. Entry \p (i,j) is
+         *   nonzero if the residual of the i^th variable depends on the
+         *   j^th variable. Without a coupling matrix, all variables are
+         *   assumed to be coupled.
+         */
+        void
+        set_finite_difference_jacobian_coupling(const libMesh::CouplingMatrix& c);
+        
+        
+        /*!
+         *   @returns true if the Jacobian of \p e is computed by finite
+         *   differences
+         */
+        bool if_finite_difference_jacobian(const libMesh::Elem& e) const;
+        
+        
+        /*!
+         *   @returns \p true if the Jacobian is assumed to be independent
+         *   of the solution and loads.
+         */
+        bool if_solution_independent_jacobian() const {
+            return _solution_independent_jacobian;
+        }
+        
+        
+        /*!
+         *   tells residual_and_jacobian() to retain the constrained element
+         *   residual and Jacobian of each local element. If the solution
+         *   is unchanged from the previous assembly of a quantity, only the
+         *   elements that depend on the parameters with modified values are
+         *   recomputed (see
+         *   MAST::PhysicsDisciplineBase::get_dependent_local_elems()), and
+         *   the global quantity is rebuilt from the retained element
+         *   quantities. The residual and Jacobian are tracked separately,
+         *   so that this also applies when a solver requests them in
+         *   separate calls, as PETSc SNES does. Only the parameters added to the discipline with
+         *   MAST::PhysicsDisciplineBase::add_parameter() are tracked, and
+         *   clear_incremental_assembly_cache() must be called if any other
+         *   data used by the elements is modified. This is \p false by
+         *   default.
+         */
+        void set_incremental_assembly(bool f);
+        
+        
+        /*!
+         *   @returns \p true if the element quantities are retained for
+         *   incremental reassembly.
+         */
+        bool if_incremental_assembly() const {
+            return _incremental_assembly;
+        }
+        
+        
+        /*!
+         *   deletes the element quantities retained for incremental
+         *   reassembly, so that the next call to residual_and_jacobian()
+         *   recomputes all elements.
+         */
+        void clear_incremental_assembly_cache();
+        
+        
+        /*!
+         *   clears the element quantities retained for incremental
+         *   reassembly along with the data of the parent class. The
+         *   Jacobian is reassembled on the next request from the solver.
+         */
+        virtual void clear_mesh_dependent_data();
+        
+        
+        /*!
+         *   adds the bytes of the element quantities retained for
+         *   incremental reassembly to those reported by the parent class
+         */
+        virtual void report_memory(MAST::MemoryReport& r,
+                                   const std::string& nm) const;
+        
+
         /*!
          *    function that assembles the matrices and vectors quantities for
-         *    nonlinear solution
+         *    nonlinear solution. If the Jacobian lag policy does not require
+         *    an update, \p J is left unchanged.
          */
         virtual void
         residual_and_jacobian (const libMesh::NumericVector<Real>& X,
@@ -97,6 +339,73 @@ namespace MAST {
                                              libMesh::NumericVector<Real>& JdX,
                                              libMesh::NonlinearImplicitSystem& S);
         
+        
+        /*!
+         *   calculates \f$ [J(X)]^T \{w\} \f$ in \p res from the element
+         *   Jacobians about \p X, without assembling the global Jacobian.
+         *   \p w is assumed to satisfy the homogeneous constraints, and the
+         *   constrained rows of \p res are zero.
+         */
+        void
+        jacobian_transpose_solution_product(const libMesh::NumericVector<Real>& X,
+                                            const libMesh::NumericVector<Real>& w,
+                                            libMesh::NumericVector<Real>& res);
+        
+        
+        /*!
+         *   calculates the second derivative product
+         *   \f$ \sum_k w_k \frac{\partial^2 R_k}{\partial X^2} \{dX\} \f$,
+         *   which is the derivative of \f$ [J(X)]^T \{w\} \f$ along \p dX,
+         *   in \p res. This is computed with a central difference of
+         *   jacobian_transpose_solution_product() along \p dX, so that only
+         *   the analytical element Jacobians are needed.
+         */
+        void
+        residual_second_derivative_product(const libMesh::NumericVector<Real>& X,
+                                           const libMesh::NumericVector<Real>& dX,
+                                           const libMesh::NumericVector<Real>& w,
+                                           libMesh::NumericVector<Real>& res);
+        
+        
+        /*!
+         *   calculates the mixed second derivative product
+         *   \f$ [\partial J/\partial p_i]^T \{w\} =
+         *   \sum_k w_k \frac{\partial^2 R_k}{\partial X \partial p_i} \f$
+         *   for the \p i^th parameter in \p parameters in \p res from the
+         *   element Jacobian sensitivities about \p X. Only the elements
+         *   that depend on the parameter are visited.
+         */
+        void
+        residual_mixed_second_derivative_product(const libMesh::ParameterVector& parameters,
+                                                 const unsigned int i,
+                                                 const libMesh::NumericVector<Real>& X,
+                                                 const libMesh::NumericVector<Real>& w,
+                                                 libMesh::NumericVector<Real>& res);
+        
+        
+        /*!
+         *   calculates the product of the reduced Hessian of \p output
+         *   with respect to \p parameters and the parameter direction
+         *   \p dp in \p Hdp, using the current solution of the system
+         *   and the \p adjoint solution of \p output about it. This
+         *   requires a linearized solve for the solution sensitivity
+         *   along \p dp, followed by a transpose solve for the second
+         *   order adjoint. The second derivatives of the residual and the
+         *   output are obtained from a central difference of the gradient
+         *   of the Lagrangian along \p dp and the solution sensitivity,
+         *   which requires two residual sensitivity and output derivative
+         *   assemblies. The output is assumed to depend on the parameters
+         *   only through the solution. The parameter values are perturbed
+         *   during the calculation, and are restored before the method
+         *   returns.
+         */
+        void
+        reduced_hessian_product(MAST::OutputAssemblyBase& output,
+                                libMesh::ParameterVector& parameters,
+                                const libMesh::NumericVector<Real>& adjoint,
+                                const RealVectorX& dp,
+                                RealVectorX& Hdp);
+        
         /**
          * Assembly function.  This function will be called
          * to assemble the RHS of the sensitivity equations (which is -1 times
@@ -113,8 +422,146 @@ namespace MAST {
                               const unsigned int i,
                               libMesh::NumericVector<Real>& sensitivity_rhs);
         
+        
+        /*!
+         *   assembles the RHS of the sensitivity equations for all
+         *   parameters in \p parameters in a single pass over the elements,
+         *   and returns the RHS for the i^th parameter in
+         *   \p sensitivity_rhs[i]. The element solution is set once for
+         *   each element, and the element sensitivity is evaluated only
+         *   for the parameters that the element depends on (see
+         *   MAST::PhysicsDisciplineBase::get_dependent_local_elems()). Inherited
+         *   classes that reimplement the single parameter version with a
+         *   different element setup should reimplement this method as well.
+         */
+        virtual bool
+        sensitivity_assemble (const libMesh::ParameterVector& parameters,
+                              std::vector<libMesh::NumericVector<Real>*>& sensitivity_rhs);
+        
+        
+        /*!
+         *   computes the sensitivity of each output in \p outputs about the
+         *   current solution of the system with respect to the design value
+         *   of each local element of \p f. The adjoint problems of all
+         *   outputs are solved with MAST::NonlinearSystem::adjoint_solve(),
+         *   which sets up the preconditioner once, after which a single
+         *   pass over the elements computes
+         *   \f$ dq_i/d\rho_e = \partial q_i/\partial \rho_e -
+         *   \{\lambda_i\}^T \{\partial R/\partial \rho_e\} \f$ for all
+         *   elements. The residual derivative is computed once for each
+         *   element, and the partial derivative of an output is provided by
+         *   MAST::OutputAssemblyBase::add_elementwise_output_partial_sensitivity().
+         *   The sensitivity of the i^th output is returned in \p sens[i],
+         *   which must be a vector of the design system of \p f, at
+         *   MAST::ElementwiseDesignField::dof_index() of each element.
+         */
+        void
+        calculate_elementwise_output_sensitivity
+        (const std::vector<MAST::OutputAssemblyBase*>& outputs,
+         const MAST::ElementwiseDesignField& f,
+         std::vector<libMesh::NumericVector<Real>*>& sens);
+        
+        
+        /*!
+         *   computes the sensitivity of \p output with respect to the
+         *   design value of each local element of \p f in \p sens.
+         */
+        void
+        calculate_elementwise_output_sensitivity(MAST::OutputAssemblyBase& output,
+                                                 const MAST::ElementwiseDesignField& f,
+                                                 libMesh::NumericVector<Real>& sens);
+        
     protected:
         
+        /*!
+         *   constrained element residual and Jacobian retained for
+         *   incremental reassembly, along with the constrained dof indices
+         *   used to add them to the global quantities.
+         */
+        struct ElemContribution {
+            
+            std::vector<libMesh::dof_id_type>  dof_indices;
+            DenseRealVector                    vec;
+            DenseRealMatrix                    mat;
+        };
+        
+        
+        typedef std::map<const libMesh::Elem*,
+        MAST::NonlinearImplicitAssembly::ElemContribution> ElemContributionMapType;
+        
+        
+        /*!
+         *   solution and parameter values for which one of the retained
+         *   element quantities was computed. The residual and Jacobian
+         *   are tracked separately, since a nonlinear solver usually
+         *   requests them in separate calls.
+         */
+        struct ElemContributionState {
+            
+            std::auto_ptr<libMesh::NumericVector<Real> > X;
+            std::map<const Real*, Real>                  params;
+        };
+        
+        
+        /*!
+         *   Functor that performs the element residual and Jacobian
+         *   calculations over a range of elements and adds them to the
+         *   global vector and matrix. Each thread works on its own copy of
+         *   this object, so that the element data structures are not shared
+         *   between threads. Addition of the element quantities to the global
+         *   data-structures is serialized. If \p cache is provided, the
+         *   element quantities are stored in its entry for each element
+         *   instead of being added to the global quantities. The entries
+         *   must exist before the functor is called.
+         */
+        class ElemResidualAndJacobian {
+        public:
+            
+            ElemResidualAndJacobian(MAST::NonlinearImplicitAssembly& assembly,
+                                    const libMesh::NumericVector<Real>& sol,
+                                    libMesh::NumericVector<Real>* R,
+                                    libMesh::SparseMatrix<Real>*  J,
+                                    MAST::NonlinearImplicitAssembly::ElemContributionMapType* cache = nullptr);
+            
+            /*!
+             *   splitting constructor used by libMesh::Threads::parallel_reduce
+             */
+            ElemResidualAndJacobian(ElemResidualAndJacobian& other,
+                                    libMesh::Threads::split);
+            
+            /*!
+             *   performs the element calculations over all elements in
+             *   \p range
+             */
+            void operator() (const libMesh::ConstElemRange& range);
+            
+            /*!
+             *   all quantities are directly added to the global data
+             *   structures. So, nothing is done here.
+             */
+            void join(const ElemResidualAndJacobian& other) { }
+            
+        protected:
+            
+            MAST::NonlinearImplicitAssembly&     _assembly;
+            const libMesh::NumericVector<Real>&  _sol;
+            libMesh::NumericVector<Real>*        _R;
+            libMesh::SparseMatrix<Real>*         _J;
+            MAST::NonlinearImplicitAssembly::ElemContributionMapType* _cache;
+        };
+        
+        
+        /*!
+         *   sets the local solution \p sol for the element \p elem before the
+         *   element calculations are performed. Inherited classes can
+         *   reimplement this to provide additional data needed by the
+         *   element. If threaded assembly is turned on, this method will be
+         *   called concurrently for different elements.
+         */
+        virtual void _set_elem_solution(MAST::ElementBase& elem,
+                                        const RealVectorX& sol);
+        
+        
         /*!
          *   performs the element calculations over \par elem, and returns
          *   the element vector and matrix quantities in \par mat and
@@ -127,6 +574,18 @@ namespace MAST {
                                         RealMatrixX& mat) = 0;
 
         
+        /*!
+         *   performs the element calculations over \par elem, and returns
+         *   only the element residual in \par vec. This is used when the
+         *   Jacobian is not requested. The default implementation calls
+         *   _elem_calculations() with \p if_jac = false, and inherited
+         *   classes can reimplement it to avoid the setup of the Jacobian
+         *   data structures.
+         */
+        virtual void _elem_residual_calculations(MAST::ElementBase& elem,
+                                                 RealVectorX& vec);
+
+        
         /*!
          *   performs the element calculations over \par elem, and returns
          *   the element vector quantity in \par vec. The vector quantity only
@@ -138,6 +597,18 @@ namespace MAST {
         _elem_linearized_jacobian_solution_product(MAST::ElementBase& elem,
                                                    RealVectorX& vec);
         
+        
+        /*!
+         *   calculates \f$ [J(X)]^T \{w\} \f$ in \p res, or
+         *   \f$ [\partial J/\partial f]^T \{w\} \f$ over the elements that
+         *   depend on \p f if \p f is not null.
+         */
+        void
+        _jacobian_transpose_product(const libMesh::NumericVector<Real>& X,
+                                    const libMesh::NumericVector<Real>& w,
+                                    const MAST::FunctionBase* f,
+                                    libMesh::NumericVector<Real>& res);
+        
 
         /*!
          *   performs the element sensitivity calculations over \par elem,
@@ -149,12 +620,230 @@ namespace MAST {
                                                     RealMatrixX& mat) = 0;
         
         
+        /*!
+         *   performs the element sensitivity calculations over \par elem
+         *   for each parameter in \par f, and returns the element residual
+         *   sensitivity for the i^th parameter in \par vec[i], which must
+         *   be initialized to zero vectors of the element size. The default
+         *   implementation calls _elem_sensitivity_calculations() for each
+         *   parameter.
+         */
+        virtual void
+        _elem_parameter_sensitivity_calculations(MAST::ElementBase& elem,
+                                                 const std::vector<const MAST::FunctionBase*>& f,
+                                                 std::vector<RealVectorX>& vec);
+        
+        
         /*!
          *    a helper function to evaluate the numerical Jacobian 
          *    and compare it with the analytical Jacobian.
          */
         void _check_element_numerical_jacobian(MAST::ElementBase& e,
                                                RealVectorX& sol);
+        
+        
+        /*!
+         *   computes the residual of \p e in \p vec and its finite
+         *   difference Jacobian in \p mat about \p sol, with one residual
+         *   evaluation for each color of the element dofs. \p elem is the
+         *   geometric element with which the dofs of each variable are
+         *   identified.
+         */
+        void _elem_finite_difference_jacobian(const libMesh::Elem& elem,
+                                              MAST::ElementBase& e,
+                                              const RealVectorX& sol,
+                                              RealVectorX& vec,
+                                              RealMatrixX& mat);
+        
+        
+        /*!
+         *   @returns true if the Jacobian should be reassembled for the
+         *   current request from the solver, and updates the lag counters.
+         */
+        bool _if_update_jacobian();
+        
+        
+        /*!
+         *   @returns \p true if the solution independent Jacobian in \p J
+         *   was assembled for the current parameter values. Otherwise, the
+         *   key is updated for the assembly that follows.
+         */
+        bool _if_jacobian_key_valid(const libMesh::SparseMatrix<Real>& J);
+        
+        
+        /*!
+         *   the PETSc nonlinear solver of libMesh zeroes the Jacobian before
+         *   it calls residual_and_jacobian(). This is turned off while a
+         *   Jacobian lag or a solution independent Jacobian is used, so that
+         *   a Jacobian that is not reassembled retains its values. The
+         *   Jacobian is zeroed by residual_and_jacobian() before it is
+         *   assembled.
+         */
+        void _update_jacobian_zero_out();
+        
+        
+        /*!
+         *   adds to \p elems the elements whose retained quantity, computed
+         *   for \p state, needs to be recomputed for incremental reassembly
+         *   about \p X. @returns \p false if the retained quantity cannot
+         *   be used, in which case all elements must be recomputed.
+         */
+        bool _get_incremental_elems(const libMesh::NumericVector<Real>& X,
+                                    const MAST::NonlinearImplicitAssembly::ElemContributionState& state,
+                                    std::set<const libMesh::Elem*>& elems);
+        
+        
+        /*!
+         *   stores in \p state the solution and parameter values for which
+         *   a retained element quantity was computed
+         */
+        void _update_incremental_state(const libMesh::NumericVector<Real>& X,
+                                       MAST::NonlinearImplicitAssembly::ElemContributionState& state);
+        
+        
+        /*!
+         *   adds the contributions to \p R and \p J that are not computed
+         *   by the elements, for example nodal loads, after the element
+         *   loop of residual_and_jacobian() and before the closure. Only
+         *   owned entries should be added. Either pointer may be null. The
+         *   default implementation does nothing.
+         */
+        virtual void
+        _assemble_nodal_quantities(libMesh::NumericVector<Real>* R,
+                                   libMesh::SparseMatrix<Real>*  J);
+        
+        
+        /*!
+         *   adds the contributions to the RHS of the sensitivity equations
+         *   with respect to \p f that are not computed by the elements,
+         *   before the closure of \p sensitivity_rhs. The default
+         *   implementation does nothing.
+         */
+        virtual void
+        _assemble_nodal_sensitivity(const MAST::FunctionBase& f,
+                                    libMesh::NumericVector<Real>& sensitivity_rhs);
+        
+        
+        /*!
+         *   closes \p R and \p J at the end of residual_and_jacobian(),
+         *   or keeps them for close_residual_and_jacobian() if the closure
+         *   is deferred
+         */
+        void _close_residual_and_jacobian(libMesh::NumericVector<Real>* R,
+                                          libMesh::SparseMatrix<Real>*  J);
+        
+        
+        /*!
+         *   sorts the active local elements into those whose dofs are all
+         *   owned by this processor, and the others, if not already done
+         *   for the current mesh.
+         */
+        void _init_interior_elems();
+        
+        
+        /*!
+         *   flag to distribute the element loop over threads
+         */
+        bool _threaded_assembly;
+        
+        /*!
+         *   flag to defer the closure of the residual and Jacobian, and
+         *   the quantities waiting to be closed
+         */
+        bool _deferred_close;
+        
+        libMesh::NumericVector<Real>* _deferred_R;
+        
+        libMesh::SparseMatrix<Real>*  _deferred_J;
+        
+        /*!
+         *   flag to overlap the communication with the element calculations,
+         *   and \p true if the assembly communication of the deferred
+         *   quantities has been started
+         */
+        bool _overlapped_communication;
+        
+        bool _deferred_assembly_begun;
+        
+        /*!
+         *   active local elements with only owned dofs, and the other
+         *   active local elements
+         */
+        std::vector<const libMesh::Elem*> _interior_elems;
+        
+        std::vector<const libMesh::Elem*> _boundary_elems;
+        
+        /*!
+         *   the Jacobian is reassembled on every \p _jacobian_lag requests
+         */
+        unsigned int _jacobian_lag;
+        
+        /*!
+         *   ratio of successive residual norms above which the Jacobian is
+         *   reassembled
+         */
+        Real _jacobian_stagnation_ratio;
+        
+        /*!
+         *   flag to force reassembly of the Jacobian on the next request
+         */
+        bool _force_jacobian_update;
+        
+        /*!
+         *   number of Jacobian requests since the last reassembly
+         */
+        unsigned int _n_jacobian_requests_since_update;
+        
+        /*!
+         *   norms of the last two residual evaluations
+         */
+        Real _residual_l2, _residual_l2_previous;
+        
+        /*!
+         *   flag to retain the element quantities for incremental
+         *   reassembly
+         */
+        bool _incremental_assembly;
+        
+        /*!
+         *   element quantities retained for incremental reassembly
+         */
+        MAST::NonlinearImplicitAssembly::ElemContributionMapType _elem_contributions;
+        
+        /*!
+         *   solution and parameter values for which the residuals and
+         *   Jacobians in \p _elem_contributions were computed
+         */
+        MAST::NonlinearImplicitAssembly::ElemContributionState
+        _elem_contributions_res,
+        _elem_contributions_jac;
+        
+        /*!
+         *   flag to assemble the Jacobian only when its key changes
+         */
+        bool _solution_independent_jacobian;
+        
+        /*!
+         *   matrix and parameter values for which the solution independent
+         *   Jacobian was last assembled
+         */
+        const libMesh::SparseMatrix<Real>* _jacobian_key_matrix;
+        std::map<const Real*, Real>        _jacobian_key_params;
+        
+        /*!
+         *   flag to compute the Jacobians of all elements by finite
+         *   differences, and the subdomains for which this is done
+         *   otherwise
+         */
+        bool _fd_jacobian_all;
+        
+        std::set<libMesh::subdomain_id_type> _fd_jacobian_subdomains;
+        
+        /*!
+         *   variable coupling used to color the dofs of the finite
+         *   difference Jacobians
+         */
+        std::auto_ptr<libMesh::CouplingMatrix> _fd_jacobian_coupling;
 
     };
 }
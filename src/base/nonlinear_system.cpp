@@ -19,14 +19,28 @@
 
 // C++ includes
 #include <vector>
+#include <algorithm>
+#include <fstream>
+#include <sstream>
 
 // MAST includes
 #include "base/nonlinear_system.h"
 #include "base/physics_discipline_base.h"
 #include "base/eigensystem_assembly.h"
 #include "base/nonlinear_implicit_assembly.h"
+#include "base/output_assembly_base.h"
 #include "base/parameter.h"
+#include "solver/geometric_multigrid.h"
+#include "solver/single_precision_ilu.h"
+#include "solver/bddc_preconditioner.h"
+#include "solver/hybrid_parallel_configuration.h"
+#include "solver/petsc_options.h"
+#include "base/performance_log.h"
 #include "solver/slepc_eigen_solver.h"
+#include "base/memory_report.h"
+#include "base/element_matrix_scatter.h"
+#include "base/solver_telemetry.h"
+#include "base/wetted_surface.h"
 
 // libMesh includes
 #include "libmesh/numeric_vector.h"
@@ -35,6 +49,126 @@
 #include "libmesh/sparse_matrix.h"
 #include "libmesh/dof_map.h"
 #include "libmesh/nonlinear_solver.h"
+#include "libmesh/petsc_nonlinear_solver.h"
+#include "libmesh/petsc_matrix.h"
+#include "libmesh/petsc_vector.h"
+
+
+
+//---------------------------------------------------------------
+// this function is called by PETSc to compute the matrix-free Jacobian
+// action y = J x
+PetscErrorCode
+__mast_nonlinear_system_mf_mat_mult(Mat mat, Vec x, Vec y) {
+    
+    PetscErrorCode ierr=0;
+    
+    void * ctx = PETSC_NULL;
+    ierr = MatShellGetContext(mat, &ctx);
+    
+    MAST::NonlinearSystem
+    *sys = static_cast<MAST::NonlinearSystem*>(ctx);
+    
+    libMesh::PetscVector<Real>
+    dX  (x, sys->comm()),
+    JdX (y, sys->comm());
+    
+    sys->matrix_free_jacobian_product(dX, JdX);
+    
+    return ierr;
+}
+
+
+
+//---------------------------------------------------------------
+// this function is called by PETSc to update the linearization point of
+// the matrix-free Jacobian and to assemble the preconditioner at X
+PetscErrorCode
+__mast_nonlinear_system_mf_jacobian(SNES snes, Vec x, Mat jac, Mat pc, void * ctx) {
+    
+    PetscErrorCode ierr=0;
+    
+    MAST::NonlinearSystem
+    *sys = static_cast<MAST::NonlinearSystem*>(ctx);
+    
+    libMesh::PetscVector<Real>
+    X  (x, sys->comm());
+    
+    sys->update_matrix_free_linearization(X);
+    
+    ierr = MatAssemblyBegin(jac, MAT_FINAL_ASSEMBLY);  CHKERRABORT(sys->comm().get(), ierr);
+    ierr = MatAssemblyEnd(jac, MAT_FINAL_ASSEMBLY);    CHKERRABORT(sys->comm().get(), ierr);
+    
+    return ierr;
+}
+
+
+
+namespace MAST {
+    
+    /*!
+     *   replaces the Jacobian registered by libMesh with the shell matrix
+     *   of the system, and uses the system matrix as the preconditioner.
+     *   libMesh calls this after its own setup of the SNES and before
+     *   SNESSolve.
+     */
+    class MatrixFreeSolverConfiguration:
+    public libMesh::SolverConfiguration {
+        
+    public:
+        
+        MatrixFreeSolverConfiguration(MAST::NonlinearSystem& sys,
+                                      Mat& mf_jac):
+        _sys     (sys),
+        _mf_jac  (mf_jac) { }
+        
+        virtual ~MatrixFreeSolverConfiguration() { }
+        
+        virtual void configure_solver() libmesh_override {
+            
+            if (!_sys.if_matrix_free_jacobian())
+                return;
+            
+            PetscErrorCode ierr = 0;
+            
+            // recreate the shell matrix, in case the dofs have changed
+            if (_mf_jac) {
+                ierr = MatDestroy(&_mf_jac);  CHKERRABORT(_sys.comm().get(), ierr);
+            }
+            
+            ierr = MatCreateShell(_sys.comm().get(),
+                                  _sys.n_local_dofs(),
+                                  _sys.n_local_dofs(),
+                                  _sys.n_dofs(),
+                                  _sys.n_dofs(),
+                                  &_sys,
+                                  &_mf_jac);
+            CHKERRABORT(_sys.comm().get(), ierr);
+            
+            ierr = MatShellSetOperation(_mf_jac,
+                                        MATOP_MULT,
+                                        (void(*)(void))__mast_nonlinear_system_mf_mat_mult);
+            CHKERRABORT(_sys.comm().get(), ierr);
+            
+            SNES snes =
+            dynamic_cast<libMesh::PetscNonlinearSolver<Real>&>
+            (*_sys.nonlinear_solver).snes();
+            
+            ierr = SNESSetJacobian(snes,
+                                   _mf_jac,
+                                   dynamic_cast<libMesh::PetscMatrix<Real>*>(_sys.matrix)->mat(),
+                                   __mast_nonlinear_system_mf_jacobian,
+                                   &_sys);
+            CHKERRABORT(_sys.comm().get(), ierr);
+        }
+        
+    protected:
+        
+        MAST::NonlinearSystem& _sys;
+        
+        Mat&                   _mf_jac;
+    };
+}
 
 
 MAST::NonlinearSystem::NonlinearSystem(libMesh::EquationSystems& es,
@@ -55,7 +189,30 @@ _n_iterations                         (0),
 _is_generalized_eigenproblem          (false),
 _eigen_problem_type                   (libMesh::NHEP),
 _eigenproblem_assemble_system_object  (nullptr),
-_output                               (nullptr) {
+_matrix_free_jacobian                 (false),
+_preconditioner_assembly              (nullptr),
+_mf_jac                               (PETSC_NULL),
+_direct_matrix_insertion              (false),
+_reuse_matrix_structure               (false),
+_setup_snapshot_loaded                (false),
+_setup_snapshot_used                  (false),
+_symmetric_matrices                   (false),
+_blocked_matrices                     (false),
+_near_null_space_function             (nullptr),
+_near_null_space                      (PETSC_NULL),
+_multigrid                            (nullptr),
+_single_precision_pc                  (nullptr),
+_bddc_pc                              (nullptr),
+_parallel_config                      (nullptr),
+_reuse_sensitivity_factorization      (false),
+_mat_mat_sensitivity_solve            (false),
+_sensitivity_ksp                      (PETSC_NULL),
+_krylov_recycling                     (false),
+_n_recycle                            (20),
+_adjoint_ksp                          (PETSC_NULL),
+_reanalysis_ksp                       (PETSC_NULL),
+_memory_report                        (nullptr),
+_wetted_surface                       (nullptr) {
     
 }
 
@@ -73,6 +230,9 @@ MAST::NonlinearSystem::~NonlinearSystem() {
 void
 MAST::NonlinearSystem::clear() {
     
+    // the matrix objects get their original handles back before they are
+    // deleted or cleared
+    this->_clear_matrix_storage();
     
     // delete the matricies
     if (matrix_A) delete matrix_A;
@@ -82,13 +242,207 @@ MAST::NonlinearSystem::clear() {
     matrix_A = nullptr;
     matrix_B = nullptr;
     
+    _condensed_matrix_A.reset();
+    _condensed_matrix_B.reset();
+    
+    _setup_snapshot_loaded = false;
+    _setup_snapshot_used   = false;
+    
     // clear the solver
     eigen_solver->clear();
     
+    // clear the matrix-free Jacobian data
+    if (_mf_jac) {
+        PetscErrorCode ierr = MatDestroy(&_mf_jac);
+        CHKERRABORT(this->comm().get(), ierr);
+    }
+    _mf_X.reset();
+    
+    // clear the sensitivity solver
+    this->clear_sensitivity_factorization();
+    
+    if (_adjoint_ksp) {
+        PetscErrorCode ierr = KSPDestroy(&_adjoint_ksp);
+        CHKERRABORT(this->comm().get(), ierr);
+    }
+    
+    this->clear_eigenproblem_reanalysis_data();
+    
+    if (_near_null_space) {
+        PetscErrorCode ierr = MatNullSpaceDestroy(&_near_null_space);
+        CHKERRABORT(this->comm().get(), ierr);
+    }
+    
+    _topology_cache.clear();
+    
     libMesh::NonlinearImplicitSystem::clear();
 }
 
 
+void
+MAST::NonlinearSystem::
+set_matrix_free_jacobian(bool f,
+                         MAST::NonlinearImplicitAssembly* pc_assembly) {
+    
+    _matrix_free_jacobian    = f;
+    _preconditioner_assembly = pc_assembly;
+    
+    if (f) {
+        
+        if (!_mf_solver_configuration.get())
+            _mf_solver_configuration.reset
+            (new MAST::MatrixFreeSolverConfiguration(*this, _mf_jac));
+        
+        this->nonlinear_solver->set_solver_configuration(*_mf_solver_configuration);
+    }
+    
+    // if the flag is turned off, the configuration object remains attached
+    // to the solver but leaves the Jacobian registered by libMesh unchanged.
+}
+
+
+
+void
+MAST::NonlinearSystem::
+update_matrix_free_linearization(const libMesh::NumericVector<Real>& X) {
+    
+    START_LOG("mf_linearization()", "NonlinearSystem");
+    
+    if (!_mf_X.get())
+        _mf_X.reset(this->solution->zero_clone().release());
+    
+    *_mf_X = X;
+    
+    // the residual assembly is also used for the preconditioner,
+    // unless a separate one was provided
+    libMesh::NonlinearImplicitSystem::ComputeResidualandJacobian*
+    pc_assembly = _preconditioner_assembly;
+    if (!pc_assembly)
+        pc_assembly = this->nonlinear_solver->residual_and_jacobian_object;
+    
+    libmesh_assert(pc_assembly);
+    
+    this->get_dof_map().enforce_constraints_exactly(*this, _mf_X.get());
+    pc_assembly->residual_and_jacobian(*_mf_X, nullptr, this->matrix, *this);
+    this->matrix->close();
+    
+    STOP_LOG("mf_linearization()", "NonlinearSystem");
+}
+
+
+
+void
+MAST::NonlinearSystem::
+matrix_free_jacobian_product(const libMesh::NumericVector<Real>& dX,
+                             libMesh::NumericVector<Real>& JdX) {
+    
+    // the linearization point must have been provided
+    libmesh_assert(_mf_X.get());
+    
+    MAST::NonlinearImplicitAssembly& assembly =
+    dynamic_cast<MAST::NonlinearImplicitAssembly&>
+    (*this->nonlinear_solver->residual_and_jacobian_object);
+    
+    // copy the perturbation so that homogeneous constraints can be applied,
+    // since the PETSc vector is locked
+    std::auto_ptr<libMesh::NumericVector<Real> >
+    dsol(_mf_X->zero_clone().release());
+    *dsol = dX;
+    this->get_dof_map().enforce_constraints_exactly(*this, dsol.get(), true);
+    
+    assembly.linearized_jacobian_solution_product(*_mf_X, *dsol, JdX, *this);
+}
+
+
+
+void
+MAST::NonlinearSystem::solve() {
+    
+    MAST_LOG_SCOPE("solve()", "NonlinearSystem");
+    
+    // the Jacobian of the sensitivity solver, if retained, is no longer
+    // valid once the system matrix is modified by the nonlinear solver
+    _sensitivity_X.reset();
+    
+    this->attach_near_null_space();
+    
+    if (_multigrid || _single_precision_pc || _bddc_pc || _parallel_config ||
+        _krylov_recycling) {
+        
+        SNES snes =
+        dynamic_cast<libMesh::PetscNonlinearSolver<Real>&>
+        (*this->nonlinear_solver).snes();
+        
+        KSP ksp;
+        PC  pc;
+        
+        PetscErrorCode ierr = SNESGetKSP(snes, &ksp); CHKERRABORT(this->comm().get(), ierr);
+        ierr = KSPGetPC(ksp, &pc);                    CHKERRABORT(this->comm().get(), ierr);
+        
+        if (_multigrid)
+            _multigrid->configure_preconditioner(pc);
+        else if (_single_precision_pc)
+            _single_precision_pc->configure_preconditioner(pc);
+        else if (_bddc_pc)
+            _bddc_pc->configure_preconditioner(pc);
+        else if (_parallel_config)
+            _parallel_config->configure_direct_solver(pc);
+        
+        // the same KSP is used for all Newton steps and nonlinear solves,
+        // so that the subspace is carried over between them
+        if (_krylov_recycling)
+            _configure_krylov_recycling(ksp);
+    }
+    
+    const bool
+    telemetry = MAST::solver_telemetry.active();
+    
+    std::chrono::steady_clock::time_point
+    t0 = std::chrono::steady_clock::now();
+    
+    libMesh::NonlinearImplicitSystem::solve();
+    
+    if (telemetry) {
+        
+        MAST::SolverTelemetry::Event
+        e(MAST::SolverTelemetry::NONLINEAR_SOLVE, this->name());
+        
+        e.iteration   = this->n_nonlinear_iterations();
+        e.residual_l2 = this->final_nonlinear_residual();
+        e.time        = this->time;
+        e.wall_time   = MAST::SolverTelemetry::elapsed(t0);
+        
+        libMesh::PetscNonlinearSolver<Real>*
+        solver = dynamic_cast<libMesh::PetscNonlinearSolver<Real>*>
+        (this->nonlinear_solver.get());
+        
+        if (solver) {
+            
+            SNES snes = solver->snes();
+            
+            PetscInt
+            n_lin = 0;
+            SNESConvergedReason
+            reason = SNES_CONVERGED_ITERATING;
+            
+            PetscErrorCode ierr = SNESGetLinearSolveIterations(snes, &n_lin);
+            CHKERRABORT(this->comm().get(), ierr);
+            ierr = SNESGetConvergedReason(snes, &reason);
+            CHKERRABORT(this->comm().get(), ierr);
+            
+            e.linear_iterations = (unsigned int)n_lin;
+            e.converged         = reason > 0;
+        }
+        
+        MAST::solver_telemetry.emit(e);
+    }
+    
+    if (_memory_report)
+        _memory_report->record_phase(this->name() + ": solve()");
+}
+
+
+
 void
 MAST::NonlinearSystem::set_eigenproblem_type (libMesh::EigenProblemType ept) {
     
@@ -105,6 +459,11 @@ MAST::NonlinearSystem::init_data () {
     // initialize parent data
     libMesh::NonlinearImplicitSystem::init_data();
     
+    // the element dofs and side boundary ids used by the assembly loops
+    _topology_cache.init(*this);
+    if (_wetted_surface)
+        _wetted_surface->init(_topology_cache);
+    
     // define the type of eigenproblem
     if (_eigen_problem_type == libMesh::GNHEP ||
         _eigen_problem_type == libMesh::GHEP  ||
@@ -113,19 +472,26 @@ MAST::NonlinearSystem::init_data () {
     
     
     libMesh::DofMap& dof_map = this->get_dof_map();
-    dof_map.compute_sparsity(this->get_mesh());
+    if (!_setup_snapshot_used)
+        dof_map.compute_sparsity(this->get_mesh());
     
     // build the system matrix
     matrix_A = libMesh::SparseMatrix<Real>::build(this->comm()).release();
     dof_map.attach_matrix(*matrix_A);
-    matrix_A->init();
+    if (_setup_snapshot_used)
+        _init_matrix_from_setup_snapshot(*matrix_A);
+    else
+        matrix_A->init();
     matrix_A->zero();
     
     if (_is_generalized_eigenproblem || _initialize_B_matrix) {
         
         matrix_B = libMesh::SparseMatrix<Real>::build(this->comm()).release();
         dof_map.attach_matrix(*matrix_B);
-        matrix_B->init();
+        if (_setup_snapshot_used)
+            _init_matrix_from_setup_snapshot(*matrix_B);
+        else
+            matrix_B->init();
         matrix_B->zero();
     }
     
@@ -138,15 +504,151 @@ MAST::NonlinearSystem::init_data () {
     }
     eigen_solver->set_eigenproblem_type(_eigen_problem_type);
     
+    if (this->_custom_matrix_storage()) {
+        
+        _init_matrix_storage(*this->matrix);
+        _init_matrix_storage(*matrix_A);
+        if (matrix_B)
+            _init_matrix_storage(*matrix_B);
+    }
+    
+    if (_reuse_matrix_structure)
+        _dof_distribution_signature(_matrix_structure_signature);
+}
+
+
+
+
+void
+MAST::NonlinearSystem::init_matrices () {
+    
+    _setup_snapshot_used = false;
+    
+    if (!_setup_snapshot_loaded || this->matrix->initialized()) {
+        
+        libMesh::NonlinearImplicitSystem::init_matrices();
+        return;
+    }
+    
+    // the dofs are distributed before the matrices are initialized, and
+    // the snapshot is used only for the same distribution
+    std::vector<libMesh::dof_id_type> sig;
+    _dof_distribution_signature(sig);
+    
+    libMesh::DofMap& dof_map = this->get_dof_map();
+    
+    _setup_snapshot_loaded = false;
+    
+    if (sig != _snapshot_signature ||
+        dof_map.get_send_list() != _snapshot_send_list) {
+        
+        libMesh::out
+        << "*** Warning: setup snapshot does not match the dof distribution of "
+        << this->name() << ", computing the sparsity pattern" << std::endl;
+        
+        libMesh::NonlinearImplicitSystem::init_matrices();
+        return;
+    }
+    
+    MAST_LOG_SCOPE("init_matrices()", "NonlinearSystem");
+    
+    _setup_snapshot_used = true;
+    
+    _storage_d_nnz.assign(_snapshot_storage_d_nnz.begin(), _snapshot_storage_d_nnz.end());
+    _storage_o_nnz.assign(_snapshot_storage_o_nnz.begin(), _snapshot_storage_o_nnz.end());
+    
+    // the system matrix is the only matrix added to this system
+    dof_map.attach_matrix(*this->matrix);
+    _init_matrix_from_setup_snapshot(*this->matrix);
+    this->matrix->zero();
+}
+
+
+
+void
+MAST::NonlinearSystem::
+_init_matrix_from_setup_snapshot(libMesh::SparseMatrix<Real>& m) {
+    
+    const libMesh::DofMap& dof_map = this->get_dof_map();
+    
+    const libMesh::dof_id_type
+    n_l = dof_map.n_local_dofs(),
+    n_g = dof_map.n_dofs();
+    
+    libmesh_assert_equal_to(_snapshot_n_nz.size(), n_l);
+    
+    const std::vector<libMesh::numeric_index_type>
+    n_nz(_snapshot_n_nz.begin(), _snapshot_n_nz.end()),
+    n_oz(_snapshot_n_oz.begin(), _snapshot_n_oz.end());
+    
+    dynamic_cast<libMesh::PetscMatrix<Real>&>(m).init(n_g, n_g, n_l, n_l,
+                                                     n_nz, n_oz);
 }
 
 
 
+void
+MAST::NonlinearSystem::set_wetted_surface(MAST::WettedSurface* ws) {
+    
+    _wetted_surface = ws;
+    
+    if (_wetted_surface && _topology_cache.initialized())
+        _wetted_surface->init(_topology_cache);
+}
+
+
 
 void MAST::NonlinearSystem::reinit () {
+    
+    // the sensitivity solver refers to the old matrix
+    this->clear_sensitivity_factorization();
+    
+    if (_reuse_matrix_structure) {
+        
+        std::vector<libMesh::dof_id_type> sig;
+        _dof_distribution_signature(sig);
+        
+        // all processors must agree on reusing the matrices
+        bool same = (sig == _matrix_structure_signature);
+        this->comm().min(same);
+        
+        if (same) {
+            
+            // the vectors are reinitialized without the sparsity pattern
+            // and the matrices of the implicit system
+            this->nonlinear_solver->clear();
+            libMesh::System::reinit();
+            _topology_cache.init(*this);
+            if (_wetted_surface)
+                _wetted_surface->init(_topology_cache);
+            _clear_matrix_scatter();
+            
+            _zero_matrices_with_fixed_structure();
+            return;
+        }
+    }
+    
+    // the matrices are reinitialized by libMesh with their original handles
+    this->_clear_matrix_storage();
+    
+    // the condensed matrices are recreated for the new dofs
+    _condensed_matrix_A.reset();
+    _condensed_matrix_B.reset();
+    
+    // the near null space is recomputed for the new dofs
+    if (_near_null_space) {
+        PetscErrorCode ierr = MatNullSpaceDestroy(&_near_null_space);
+        CHKERRABORT(this->comm().get(), ierr);
+    }
+    
     // initialize parent data
     libMesh::NonlinearImplicitSystem::reinit();
     
+    // the element dofs and side boundary ids for the new mesh and dofs
+    _topology_cache.init(*this);
+    if (_wetted_surface)
+        _wetted_surface->init(_topology_cache);
+    
     // Clear the matrices
     matrix_A->clear();
     
@@ -171,59 +673,564 @@ void MAST::NonlinearSystem::reinit () {
         matrix_B->init();
         matrix_B->zero();
     }
+    
+    if (this->_custom_matrix_storage()) {
+        
+        _init_matrix_storage(*this->matrix);
+        _init_matrix_storage(*matrix_A);
+        if (matrix_B)
+            _init_matrix_storage(*matrix_B);
+    }
+    
+    if (_reuse_matrix_structure)
+        _dof_distribution_signature(_matrix_structure_signature);
 }
 
 
 
+void
+MAST::NonlinearSystem::
+_dof_distribution_signature(std::vector<libMesh::dof_id_type>& sig) const {
+    
+    const libMesh::DofMap& dof_map = this->get_dof_map();
+    
+    sig.resize(6);
+    sig[0] = dof_map.n_dofs();
+    sig[1] = dof_map.first_dof();
+    sig[2] = dof_map.end_dof();
+    sig[3] = dof_map.n_constrained_dofs();
+    sig[4] = this->get_mesh().n_active_local_elem();
+    
+    // FNV-1a hash of the element ids and their dof indices
+    libMesh::dof_id_type h = 2166136261u;
+    std::vector<libMesh::dof_id_type> dof_indices;
+    
+    libMesh::MeshBase::const_element_iterator
+    it  = this->get_mesh().active_local_elements_begin(),
+    end = this->get_mesh().active_local_elements_end();
+    
+    for ( ; it != end; it++) {
+        
+        h = (h ^ (*it)->id()) * 16777619u;
+        dof_map.dof_indices(*it, dof_indices);
+        for (unsigned int i=0; i<dof_indices.size(); i++)
+            h = (h ^ dof_indices[i]) * 16777619u;
+    }
+    
+    sig[5] = h;
+}
+
+
 
 void
-MAST::NonlinearSystem::eigenproblem_solve() {
+MAST::NonlinearSystem::_zero_matrices_with_fixed_structure() {
     
+    libMesh::SparseMatrix<Real>* mats[3] = {this->matrix, matrix_A, matrix_B};
     
-    START_LOG("eigensolve()", "NonlinearSystem");
+    for (unsigned int i=0; i<3; i++) {
+        
+        if (!mats[i] || !mats[i]->initialized())
+            continue;
+        
+        libMesh::PetscMatrix<Real>&
+        pm = dynamic_cast<libMesh::PetscMatrix<Real>&>(*mats[i]);
+        
+        // the values are zeroed with the nonzero structure retained
+        pm.zero();
+        
+        PetscErrorCode ierr = MatSetOption(pm.mat(),
+                                           MAT_NEW_NONZERO_LOCATION_ERR,
+                                           PETSC_TRUE);
+        CHKERRABORT(this->comm().get(), ierr);
+    }
+}
+
+
+
+void
+MAST::NonlinearSystem::set_symmetric_matrices(bool f) {
     
-    // A reference to the EquationSystems
-    libMesh::EquationSystems& es = this->get_equation_systems();
+    // the matrices are created with the sparsity computed in
+    // EquationSystems::init()
+    libmesh_assert(!matrix_A);
     
-    // check that necessary parameters have been set
-    libmesh_assert(_n_requested_eigenpairs);
+    _symmetric_matrices = f;
     
-    es.parameters.set<unsigned int>("eigenpairs")    =   _n_requested_eigenpairs;
-    es.parameters.set<unsigned int>("basis vectors") = 5*_n_requested_eigenpairs;
+    if (this->_custom_matrix_storage())
+        this->get_dof_map().attach_extra_sparsity_function
+        (MAST::NonlinearSystem::_matrix_sparsity, this);
+    else
+        this->get_dof_map().attach_extra_sparsity_function(nullptr, nullptr);
+}
+
+
+
+void
+MAST::NonlinearSystem::set_matrix_type(const std::string& t) {
     
-    // Get the tolerance for the solver and the maximum
-    // number of iterations. Here, we simply adopt the linear solver
-    // specific parameters.
-    const Real
-    tol    = es.parameters.get<Real>("linear solver tolerance");
+    libmesh_assert(!matrix_A);
     
-    const unsigned int
-    maxits = es.parameters.get<unsigned int>("linear solver maximum iterations"),
-    nev    = es.parameters.get<unsigned int>("eigenpairs"),
-    ncv    = es.parameters.get<unsigned int>("basis vectors");
+    _matrix_type = t;
     
-    std::pair<unsigned int, unsigned int> solve_data;
+    if (this->_custom_matrix_storage())
+        this->get_dof_map().attach_extra_sparsity_function
+        (MAST::NonlinearSystem::_matrix_sparsity, this);
+    else
+        this->get_dof_map().attach_extra_sparsity_function(nullptr, nullptr);
+}
+
+
+
+void
+MAST::NonlinearSystem::set_blocked_matrices(bool f) {
     
-    libMesh::SparseMatrix<Real>
-    *eig_A  = nullptr,
-    *eig_B  = nullptr;
+    libmesh_assert(!matrix_A);
     
-    // assemble the matrices
-    this->assemble_eigensystem();
+    _blocked_matrices = f;
     
-    // If we haven't initialized any condensed dofs,
-    // just use the default eigen_system
-    if (!_condensed_dofs_initialized) {
-        
-        // call the solver depending on the type of eigenproblem
-        if (generalized())  {
-            
-            //in case of a generalized eigenproblem
-            
-            // exchange the matrices if requested by the user
-            if (!_exchange_A_and_B) {
-                eig_A  =  matrix_A;
-                eig_B  =  matrix_B;
+    if (this->_custom_matrix_storage())
+        this->get_dof_map().attach_extra_sparsity_function
+        (MAST::NonlinearSystem::_matrix_sparsity, this);
+    else
+        this->get_dof_map().attach_extra_sparsity_function(nullptr, nullptr);
+}
+
+
+
+void
+MAST::NonlinearSystem::
+_matrix_sparsity(libMesh::SparsityPattern::Graph& sparsity,
+                 std::vector<libMesh::dof_id_type>& n_nz,
+                 std::vector<libMesh::dof_id_type>& n_oz,
+                 void* ctx) {
+    
+    MAST::NonlinearSystem&
+    sys = *static_cast<MAST::NonlinearSystem*>(ctx);
+    
+    const libMesh::DofMap& dof_map = sys.get_dof_map();
+    
+    const libMesh::dof_id_type
+    first = dof_map.first_dof(),
+    end   = dof_map.end_dof();
+    
+    const unsigned int
+    bs    = sys.matrix_block_size();
+    
+    // the graph has one row per local dof. The dofs of a node are
+    // numbered contiguously only if all variables are in one group.
+    libmesh_assert_equal_to(sparsity.size(), end-first);
+    if (bs > 1 &&
+        (dof_map.n_variable_groups() != 1 || sparsity.size()%bs != 0))
+        libmesh_error_msg("Blocked matrices require variables of the same FE type");
+    
+    const unsigned int
+    nb    = (unsigned int)sparsity.size()/bs;
+    
+    sys._storage_d_nnz.assign(nb, 0);
+    sys._storage_o_nnz.assign(nb, 0);
+    
+    // all rows of a block have the same columns, so the first row of
+    // each block is counted
+    for (unsigned int i=0; i<nb; i++) {
+        
+        const libMesh::dof_id_type row = first+i*bs;
+        
+        for (unsigned int j=0; j<sparsity[i*bs].size(); j++) {
+            
+            const libMesh::dof_id_type col = sparsity[i*bs][j];
+            
+            // only the upper triangle is stored in the symmetric format.
+            // Columns before the local block are always below the diagonal.
+            if (sys._symmetric_matrices && col < row)
+                continue;
+            else if (col >= first && col < end)
+                sys._storage_d_nnz[i]++;
+            else
+                sys._storage_o_nnz[i]++;
+        }
+        
+        sys._storage_d_nnz[i] /= bs;
+        sys._storage_o_nnz[i] /= bs;
+    }
+}
+
+
+
+void
+MAST::NonlinearSystem::_init_matrix_storage(libMesh::SparseMatrix<Real>& m) {
+    
+    libMesh::PetscMatrix<Real>&
+    pm = dynamic_cast<libMesh::PetscMatrix<Real>&>(m);
+    
+    const libMesh::DofMap& dof_map = this->get_dof_map();
+    
+    const PetscInt
+    bs  = this->matrix_block_size(),
+    n_l = dof_map.n_local_dofs(),
+    n_g = dof_map.n_dofs();
+    
+    libmesh_assert_equal_to(_storage_d_nnz.size(), n_l/bs);
+    
+    const PetscInt
+    *d_nnz = n_l? &_storage_d_nnz[0]: PETSC_NULL,
+    *o_nnz = n_l? &_storage_o_nnz[0]: PETSC_NULL;
+    
+    PetscErrorCode ierr;
+    Mat            mat;
+    
+    ierr = MatCreate(this->comm().get(), &mat);
+    CHKERRABORT(this->comm().get(), ierr);
+    ierr = MatSetSizes(mat, n_l, n_l, n_g, n_g);
+    CHKERRABORT(this->comm().get(), ierr);
+    
+    // the device types are set with the error handler that returns, so
+    // that the host type is used if PETSc is not configured with the type
+    bool
+    if_custom_type = false,
+    if_matis       = (_matrix_type == MATIS);
+    
+    if (_symmetric_matrices && !_matrix_type.empty())
+        libmesh_error_msg("Matrix type " << _matrix_type
+                          << " cannot be used with symmetric matrices");
+    
+    if (if_matis) {
+        
+        // the subdomain of this processor has the dofs of its local
+        // elements, including the dofs that constrain them
+        std::vector<libMesh::dof_id_type> dofs, elem_dofs;
+        
+        libMesh::MeshBase::const_element_iterator
+        el     = this->get_mesh().active_local_elements_begin(),
+        end_el = this->get_mesh().active_local_elements_end();
+        
+        for ( ; el != end_el; el++) {
+            
+            dof_map.dof_indices(*el, elem_dofs);
+            dof_map.find_connected_dofs(elem_dofs);
+            dofs.insert(dofs.end(), elem_dofs.begin(), elem_dofs.end());
+        }
+        
+        std::sort(dofs.begin(), dofs.end());
+        dofs.erase(std::unique(dofs.begin(), dofs.end()), dofs.end());
+        
+        std::vector<PetscInt>
+        idx(dofs.begin(), dofs.end());
+        
+        ISLocalToGlobalMapping l2g;
+        ierr = ISLocalToGlobalMappingCreate(this->comm().get(),
+                                            1,
+                                            (PetscInt)idx.size(),
+                                            idx.size()? &idx[0]: PETSC_NULL,
+                                            PETSC_COPY_VALUES,
+                                            &l2g);
+        CHKERRABORT(this->comm().get(), ierr);
+        
+        ierr = MatSetType(mat, MATIS);
+        CHKERRABORT(this->comm().get(), ierr);
+        ierr = MatSetLocalToGlobalMapping(mat, l2g, l2g);
+        CHKERRABORT(this->comm().get(), ierr);
+        ierr = ISLocalToGlobalMappingDestroy(&l2g);
+        CHKERRABORT(this->comm().get(), ierr);
+        
+        // the preallocation of the subdomain matrix is estimated by PETSc
+        // from that of the assembled rows
+        std::vector<PetscInt>
+        d_nnz_r(n_l, 0),
+        o_nnz_r(n_l, 0);
+        for (PetscInt i=0; i<n_l; i++) {
+            d_nnz_r[i] = bs*_storage_d_nnz[i/bs];
+            o_nnz_r[i] = bs*_storage_o_nnz[i/bs];
+        }
+        
+        ierr = MatISSetPreallocation(mat,
+                                     0, n_l? &d_nnz_r[0]: PETSC_NULL,
+                                     0, n_l? &o_nnz_r[0]: PETSC_NULL);
+        CHKERRABORT(this->comm().get(), ierr);
+    }
+    else if (!_matrix_type.empty()) {
+        
+        ierr = PetscPushErrorHandler(PetscReturnErrorHandler, nullptr);
+        CHKERRABORT(this->comm().get(), ierr);
+        
+        PetscErrorCode ierr_t = MatSetType(mat, _matrix_type.c_str());
+        
+        ierr = PetscPopErrorHandler();
+        CHKERRABORT(this->comm().get(), ierr);
+        
+        if_custom_type = (ierr_t == 0);
+        
+        if (!if_custom_type)
+            libMesh::out
+            << "*** Warning: PETSc matrix type " << _matrix_type
+            << " is not available, using the host storage for "
+            << this->name() << std::endl;
+    }
+    
+    if (if_matis) {
+        
+        // the subdomain matrix has been created above
+    }
+    else if (if_custom_type) {
+        
+        // the AIJ class types use the block size for blocked insertion,
+        // and the preallocation is given per block row
+        ierr = MatSetBlockSize(mat, bs);
+        CHKERRABORT(this->comm().get(), ierr);
+        ierr = MatXAIJSetPreallocation(mat, bs, d_nnz, o_nnz, PETSC_NULL, PETSC_NULL);
+        CHKERRABORT(this->comm().get(), ierr);
+    }
+    else if (_symmetric_matrices) {
+        
+        ierr = MatSetType(mat, MATSBAIJ);
+        CHKERRABORT(this->comm().get(), ierr);
+        ierr = MatSeqSBAIJSetPreallocation(mat, bs, 0, d_nnz);
+        CHKERRABORT(this->comm().get(), ierr);
+        ierr = MatMPISBAIJSetPreallocation(mat, bs, 0, d_nnz, 0, o_nnz);
+        CHKERRABORT(this->comm().get(), ierr);
+        
+        // the element matrices are added in full, and the entries below
+        // the diagonal are dropped
+        ierr = MatSetOption(mat, MAT_IGNORE_LOWER_TRIANGULAR, PETSC_TRUE);
+        CHKERRABORT(this->comm().get(), ierr);
+    }
+    else {
+        
+        ierr = MatSetType(mat, MATBAIJ);
+        CHKERRABORT(this->comm().get(), ierr);
+        ierr = MatSeqBAIJSetPreallocation(mat, bs, 0, d_nnz);
+        CHKERRABORT(this->comm().get(), ierr);
+        ierr = MatMPIBAIJSetPreallocation(mat, bs, 0, d_nnz, 0, o_nnz);
+        CHKERRABORT(this->comm().get(), ierr);
+    }
+    
+    ierr = MatSetOption(mat, MAT_NEW_NONZERO_ALLOCATION_ERR, PETSC_TRUE);
+    CHKERRABORT(this->comm().get(), ierr);
+    
+    // the original handle is moved to a separate object, which frees
+    // its values. The object is retained so that the handle can be
+    // given back to the matrix before libMesh clears it.
+    libMesh::PetscMatrix<Real>*
+    orig = new libMesh::PetscMatrix<Real>(mat, this->comm());
+    pm.swap(*orig);
+    orig->clear();
+    
+    _storage_mats.push_back(std::make_pair(&m, orig));
+}
+
+
+
+void
+MAST::NonlinearSystem::_clear_matrix_storage() {
+    
+    // the scatter refers to the matrices and the element dofs
+    this->_clear_matrix_scatter();
+    
+    for (unsigned int i=0; i<_storage_mats.size(); i++) {
+        
+        libMesh::PetscMatrix<Real>
+        &pm   = dynamic_cast<libMesh::PetscMatrix<Real>&>(*_storage_mats[i].first),
+        &orig = dynamic_cast<libMesh::PetscMatrix<Real>&>(*_storage_mats[i].second);
+        
+        Mat mat = pm.mat();
+        pm.swap(orig);
+        
+        PetscErrorCode ierr = MatDestroy(&mat);
+        CHKERRABORT(this->comm().get(), ierr);
+        
+        delete _storage_mats[i].second;
+    }
+    
+    _storage_mats.clear();
+}
+
+
+
+void
+MAST::NonlinearSystem::_clear_matrix_scatter() {
+    
+    std::map<const libMesh::SparseMatrix<Real>*, MAST::ElementMatrixScatter*>::iterator
+    it   = _matrix_scatter.begin(),
+    end  = _matrix_scatter.end();
+    
+    for ( ; it != end; it++)
+        delete it->second;
+    
+    _matrix_scatter.clear();
+}
+
+
+
+void
+MAST::NonlinearSystem::set_direct_matrix_insertion(bool f) {
+    
+    _direct_matrix_insertion = f;
+    
+    if (!f)
+        this->_clear_matrix_scatter();
+}
+
+
+
+MAST::ElementMatrixScatter*
+MAST::NonlinearSystem::matrix_scatter(libMesh::SparseMatrix<Real>& m) {
+    
+    if (!_direct_matrix_insertion)
+        return nullptr;
+    
+    libMesh::PetscMatrix<Real>*
+    pm = dynamic_cast<libMesh::PetscMatrix<Real>*>(&m);
+    
+    if (!pm)
+        return nullptr;
+    
+    // the matrix must be assembled for the nonzero structure to be
+    // available, so that the first assembly uses MatSetValues()
+    Mat mat = pm->mat();
+    if (!MAST::ElementMatrixScatter::supported(mat))
+        return nullptr;
+    
+    MAST::ElementMatrixScatter*& s = _matrix_scatter[&m];
+    
+    if (s && !s->valid(mat)) {
+        
+        delete s;
+        s = nullptr;
+    }
+    
+    if (!s) {
+        
+        MAST_LOG_SCOPE("matrix_scatter()", "NonlinearSystem");
+        s = new MAST::ElementMatrixScatter(_topology_cache, mat);
+    }
+    
+    return s;
+}
+
+
+
+
+void
+MAST::NonlinearSystem::
+set_near_null_space_function(libMesh::NonlinearImplicitSystem::ComputeVectorSubspace* f) {
+    
+    _near_null_space_function = f;
+    
+    if (_near_null_space) {
+        PetscErrorCode ierr = MatNullSpaceDestroy(&_near_null_space);
+        CHKERRABORT(this->comm().get(), ierr);
+    }
+}
+
+
+
+void
+MAST::NonlinearSystem::attach_near_null_space() {
+    
+    if (!_near_null_space_function)
+        return;
+    
+    PetscErrorCode ierr = 0;
+    
+    if (!_near_null_space) {
+        
+        MAST_LOG_SCOPE("near_null_space()", "NonlinearSystem");
+        
+        std::vector<libMesh::NumericVector<Real>*> sp;
+        (*_near_null_space_function)(sp, *this);
+        
+        // PETSc requires an orthonormal basis
+        std::vector<Vec> vecs;
+        
+        for (unsigned int i=0; i<sp.size(); i++) {
+            
+            for (unsigned int j=0; j<i; j++)
+                sp[i]->add(-sp[j]->dot(*sp[i]), *sp[j]);
+            
+            const Real
+            nrm = sp[i]->l2_norm();
+            
+            // linearly dependent vectors are not included
+            if (nrm > 0.) {
+                sp[i]->scale(1./nrm);
+                vecs.push_back(dynamic_cast<libMesh::PetscVector<Real>*>(sp[i])->vec());
+            }
+            else
+                sp[i]->zero();
+        }
+        
+        ierr = MatNullSpaceCreate(this->comm().get(),
+                                  PETSC_FALSE,
+                                  (PetscInt)vecs.size(),
+                                  vecs.size()? &vecs[0]: PETSC_NULL,
+                                  &_near_null_space);
+        CHKERRABORT(this->comm().get(), ierr);
+    }
+    
+    libMesh::SparseMatrix<Real>*
+    mats[3] = {this->matrix, matrix_A, matrix_B};
+    
+    for (unsigned int i=0; i<3; i++)
+        if (mats[i] && mats[i]->initialized()) {
+            
+            Mat mat = dynamic_cast<libMesh::PetscMatrix<Real>*>(mats[i])->mat();
+            ierr = MatSetNearNullSpace(mat, _near_null_space);
+            CHKERRABORT(this->comm().get(), ierr);
+        }
+}
+
+
+
+void
+MAST::NonlinearSystem::eigenproblem_solve() {
+    
+    
+    START_LOG("eigensolve()", "NonlinearSystem");
+    MAST_LOG_SCOPE("eigenproblem_solve()", "NonlinearSystem");
+    
+    // A reference to the EquationSystems
+    libMesh::EquationSystems& es = this->get_equation_systems();
+    
+    // check that necessary parameters have been set
+    libmesh_assert(_n_requested_eigenpairs);
+    
+    es.parameters.set<unsigned int>("eigenpairs")    =   _n_requested_eigenpairs;
+    es.parameters.set<unsigned int>("basis vectors") = 5*_n_requested_eigenpairs;
+    
+    // Get the tolerance for the solver and the maximum
+    // number of iterations. Here, we simply adopt the linear solver
+    // specific parameters.
+    const Real
+    tol    = es.parameters.get<Real>("linear solver tolerance");
+    
+    const unsigned int
+    maxits = es.parameters.get<unsigned int>("linear solver maximum iterations"),
+    nev    = es.parameters.get<unsigned int>("eigenpairs"),
+    ncv    = es.parameters.get<unsigned int>("basis vectors");
+    
+    std::pair<unsigned int, unsigned int> solve_data;
+    
+    libMesh::SparseMatrix<Real>
+    *eig_A  = nullptr,
+    *eig_B  = nullptr;
+    
+    // assemble the matrices
+    this->assemble_eigensystem();
+    
+    this->attach_near_null_space();
+    
+    // If we haven't initialized any condensed dofs,
+    // just use the default eigen_system
+    if (!_condensed_dofs_initialized) {
+        
+        // call the solver depending on the type of eigenproblem
+        if (generalized())  {
+            
+            //in case of a generalized eigenproblem
+            
+            // exchange the matrices if requested by the user
+            if (!_exchange_A_and_B) {
+                eig_A  =  matrix_A;
+                eig_B  =  matrix_B;
             }
             else {
                 eig_B  =  matrix_A;
@@ -254,23 +1261,43 @@ MAST::NonlinearSystem::eigenproblem_solve() {
         // If we reach here, then there should be some non-condensed dofs
         libmesh_assert(!_local_non_condensed_dofs_vector.empty());
         
-        std::auto_ptr<libMesh::SparseMatrix<Real> >
-        condensed_matrix_A(libMesh::SparseMatrix<Real>::build(this->comm()).release()),
-        condensed_matrix_B(libMesh::SparseMatrix<Real>::build(this->comm()).release());
-
-        // Now condense the matrices
-        matrix_A->create_submatrix(*condensed_matrix_A,
-                                   _local_non_condensed_dofs_vector,
-                                   _local_non_condensed_dofs_vector);
+        // Now condense the matrices. The condensed matrices are retained,
+        // and their values are replaced for subsequent solves, since the
+        // sparsity pattern does not change between solves.
+        if (!_condensed_matrix_A.get()) {
+            
+            _condensed_matrix_A.reset
+            (libMesh::SparseMatrix<Real>::build(this->comm()).release());
+            matrix_A->create_submatrix(*_condensed_matrix_A,
+                                       _local_non_condensed_dofs_vector,
+                                       _local_non_condensed_dofs_vector);
+        }
+        else
+            matrix_A->reinit_submatrix(*_condensed_matrix_A,
+                                       _local_non_condensed_dofs_vector,
+                                       _local_non_condensed_dofs_vector);
         
         
         if (generalized()) {
             
-            matrix_B->create_submatrix(*condensed_matrix_B,
-                                       _local_non_condensed_dofs_vector,
-                                       _local_non_condensed_dofs_vector);
+            if (!_condensed_matrix_B.get()) {
+                
+                _condensed_matrix_B.reset
+                (libMesh::SparseMatrix<Real>::build(this->comm()).release());
+                matrix_B->create_submatrix(*_condensed_matrix_B,
+                                           _local_non_condensed_dofs_vector,
+                                           _local_non_condensed_dofs_vector);
+            }
+            else
+                matrix_B->reinit_submatrix(*_condensed_matrix_B,
+                                           _local_non_condensed_dofs_vector,
+                                           _local_non_condensed_dofs_vector);
         }
         
+        libMesh::SparseMatrix<Real>
+        *condensed_matrix_A = _condensed_matrix_A.get(),
+        *condensed_matrix_B = _condensed_matrix_B.get();
+        
         // call the solver depending on the type of eigenproblem
         if ( generalized() ) {
             
@@ -278,12 +1305,12 @@ MAST::NonlinearSystem::eigenproblem_solve() {
             
             // exchange the matrices if requested by the user
             if (!_exchange_A_and_B) {
-                eig_A  =  condensed_matrix_A.get();
-                eig_B  =  condensed_matrix_B.get();
+                eig_A  =  condensed_matrix_A;
+                eig_B  =  condensed_matrix_B;
             }
             else {
-                eig_B  =  condensed_matrix_A.get();
-                eig_A  =  condensed_matrix_B.get();
+                eig_B  =  condensed_matrix_A;
+                eig_A  =  condensed_matrix_B;
             }
             
             solve_data = eigen_solver->solve_generalized(*eig_A,
@@ -309,6 +1336,9 @@ MAST::NonlinearSystem::eigenproblem_solve() {
     _n_converged_eigenpairs = solve_data.first;
     _n_iterations           = solve_data.second;
     
+    if (_memory_report)
+        _memory_report->record_phase(this->name() + ": eigenproblem_solve()");
+    
     STOP_LOG("eigensolve()", "NonlinearSystem");
     
     return;
@@ -538,6 +1568,34 @@ eigenproblem_sensitivity_solve (const libMesh::ParameterVector& parameters,
     unsigned int
     num = 0;
     
+    // the products with the sensitivity matrices are first requested from
+    // the assembly object for all parameters together. For the HEP, the
+    // term with the eigenvalue is added here using x^H x.
+    std::vector<Real>
+    prod_eig(eig);
+    if (_eigen_problem_type == libMesh::HEP)
+        std::fill(prod_eig.begin(), prod_eig.end(), 0.);
+    
+    if (_eigenproblem_assemble_system_object->eigenproblem_sensitivity_products
+        (parameters, prod_eig, x_right, sens)) {
+        
+        for (unsigned int p=0; p<parameters.size(); p++)
+            for (unsigned int i=0; i<nconv; i++) {
+                
+                num = p*nconv+i;
+                
+                if (_eigen_problem_type == libMesh::HEP)
+                    sens[num]-= eig[i] * denom[i];                      // - lambda x^H x
+                sens[num] /= denom[i];
+            }
+        
+        // now delete the x_right vectors
+        for (unsigned int i=0; i<x_right.size(); i++)
+            delete x_right[i];
+        
+        return;
+    }
+    
     for (unsigned int p=0; p<parameters.size(); p++) {
         
         // calculate sensitivity of matrix quantities
@@ -584,44 +1642,275 @@ eigenproblem_sensitivity_solve (const libMesh::ParameterVector& parameters,
 
 
 
-
-void
+bool
 MAST::NonlinearSystem::
-assemble_eigensystem () {
-    
-    libmesh_assert(_eigenproblem_assemble_system_object);
-    
-    _eigenproblem_assemble_system_object->eigenproblem_assemble(matrix_A,
-                                                                matrix_B);
+eigenproblem_reanalysis(std::vector<libMesh::NumericVector<Real>*>& basis,
+                        std::vector<Real>& eig,
+                        Real tol,
+                        unsigned int max_iters) {
     
-}
-
-
-
-void
-MAST::NonlinearSystem::
-assemble_eigensystem_sensitivity(const libMesh::ParameterVector& parameters,
-                                 const unsigned int p) {
+    MAST_LOG_SCOPE("eigenproblem_reanalysis()", "NonlinearSystem");
     
-    libmesh_assert(_eigenproblem_assemble_system_object);
+    const unsigned int
+    n = (unsigned int)basis.size();
     
-    _eigenproblem_assemble_system_object->eigenproblem_sensitivity_assemble
-    (parameters, p, matrix_A, matrix_B);
+    libmesh_assert_greater(n, 0);
     
-}
-
-
-
-
-void
-MAST::NonlinearSystem::
-attach_eigenproblem_assemble_object(MAST::EigenSystemAssembly& assemble) {
+    eig.resize(n, 0.);
     
-    libmesh_assert(!_eigenproblem_assemble_system_object);
+    bool
+    accepted = false;
     
-    _eigenproblem_assemble_system_object = &assemble;
-}
-
+    if (_eigen_problem_type == libMesh::GHEP) {
+        
+        this->assemble_eigensystem();
+        
+        PetscErrorCode ierr = 0;
+        
+        Mat mat = dynamic_cast<libMesh::PetscMatrix<Real>*>(matrix_A)->mat();
+        
+        // the preconditioner is setup for the current design only if it
+        // is not available from a previous call
+        if (!_reanalysis_ksp) {
+            
+            ierr = KSPCreate(this->comm().get(), &_reanalysis_ksp);
+            CHKERRABORT(this->comm().get(), ierr);
+            
+            if (libMesh::on_command_line("--solver_system_names")) {
+                
+                std::string nm = this->name() + "_reanalysis_";
+                KSPSetOptionsPrefix(_reanalysis_ksp, nm.c_str());
+            }
+            
+            ierr = KSPSetOperators(_reanalysis_ksp, mat, mat);
+            CHKERRABORT(this->comm().get(), ierr);
+            ierr = KSPSetFromOptions(_reanalysis_ksp);
+            CHKERRABORT(this->comm().get(), ierr);
+            
+            {
+                MAST_LOG_SCOPE("KSPSetUp", "NonlinearSystem");
+                ierr = KSPSetUp(_reanalysis_ksp);
+                CHKERRABORT(this->comm().get(), ierr);
+            }
+        }
+        else {
+            
+            ierr = KSPSetOperators(_reanalysis_ksp, mat, mat);
+            CHKERRABORT(this->comm().get(), ierr);
+        }
+        
+        ierr = KSPSetReusePreconditioner(_reanalysis_ksp, PETSC_TRUE);
+        CHKERRABORT(this->comm().get(), ierr);
+        
+        // the subspace is made of the current vectors and their
+        // inverse iterates
+        std::vector<libMesh::NumericVector<Real>*>
+        S(2*n, nullptr),
+        AS(2*n, nullptr),
+        BS(2*n, nullptr);
+        
+        for (unsigned int i=0; i<2*n; i++) {
+            
+            S[i]  = basis[0]->zero_clone().release();
+            AS[i] = basis[0]->zero_clone().release();
+            BS[i] = basis[0]->zero_clone().release();
+        }
+        
+        for (unsigned int i=0; i<n; i++)
+            *S[i] = *basis[i];
+        
+        std::auto_ptr<libMesh::NumericVector<Real> >
+        r(basis[0]->zero_clone().release());
+        
+        std::vector<Real>
+        lambda(n, 0.);
+        
+        for (unsigned int it=0; !accepted && it<max_iters; it++) {
+            
+            // inverse iterates with the retained preconditioner
+            for (unsigned int i=0; i<n; i++) {
+                
+                matrix_B->vector_mult(*r, *S[i]);
+                
+                libMesh::PetscVector<Real>
+                &b = dynamic_cast<libMesh::PetscVector<Real>&>(*r),
+                &x = dynamic_cast<libMesh::PetscVector<Real>&>(*S[n+i]);
+                
+                MAST_LOG_SCOPE("KSPSolve", "NonlinearSystem");
+                ierr = KSPSolve(_reanalysis_ksp, b.vec(), x.vec());
+                CHKERRABORT(this->comm().get(), ierr);
+                
+                S[n+i]->close();
+            }
+            
+            // reduced matrices on the subspace
+            RealMatrixX
+            A_r = RealMatrixX::Zero(2*n, 2*n),
+            B_r = RealMatrixX::Zero(2*n, 2*n);
+            
+            for (unsigned int i=0; i<2*n; i++) {
+                
+                matrix_A->vector_mult(*AS[i], *S[i]);
+                matrix_B->vector_mult(*BS[i], *S[i]);
+            }
+            
+            for (unsigned int i=0; i<2*n; i++)
+                for (unsigned int j=0; j<=i; j++) {
+                    
+                    A_r(i, j) = A_r(j, i) = S[i]->dot(*AS[j]);
+                    B_r(i, j) = B_r(j, i) = S[i]->dot(*BS[j]);
+                }
+            
+            // the subspace vectors may be nearly linearly dependent as the
+            // iterations converge. Hence, the Rayleigh-Ritz problem is
+            // solved on the range of the reduced B matrix.
+            Eigen::SelfAdjointEigenSolver<RealMatrixX> eig_b(B_r);
+            
+            const RealVectorX& d = eig_b.eigenvalues();
+            const Real d_tol = 1.e-12 * d.maxCoeff();
+            
+            unsigned int n_r = 0;
+            for (unsigned int i=0; i<2*n; i++)
+                if (d(i) > d_tol)
+                    n_r++;
+            
+            if (n_r < n)
+                break;
+            
+            RealMatrixX
+            T = RealMatrixX::Zero(2*n, n_r);
+            
+            for (unsigned int i=0, k=0; i<2*n; i++)
+                if (d(i) > d_tol) {
+                    
+                    T.col(k) = eig_b.eigenvectors().col(i) / sqrt(d(i));
+                    k++;
+                }
+            
+            Eigen::SelfAdjointEigenSolver<RealMatrixX>
+            eig_a(T.transpose() * A_r * T);
+            
+            const RealMatrixX
+            Y = T * eig_a.eigenvectors();
+            
+            // the Ritz vectors of the n lowest eigenvalues, which are
+            // scaled to a unit inner product with B
+            accepted = true;
+            
+            for (unsigned int i=0; i<n; i++) {
+                
+                lambda[i] = eig_a.eigenvalues()(i);
+                
+                basis[i]->zero();
+                for (unsigned int j=0; j<2*n; j++)
+                    basis[i]->add(Y(j, i), *S[j]);
+                basis[i]->close();
+                
+                // the residual of the eigenpair is obtained from the
+                // products of the subspace vectors
+                r->zero();
+                for (unsigned int j=0; j<2*n; j++)
+                    r->add(Y(j, i), *AS[j]);
+                r->close();
+                
+                const Real
+                Ax_norm = r->l2_norm();
+                
+                for (unsigned int j=0; j<2*n; j++)
+                    r->add(-lambda[i]*Y(j, i), *BS[j]);
+                r->close();
+                
+                if (r->l2_norm() > tol * Ax_norm)
+                    accepted = false;
+            }
+            
+            for (unsigned int i=0; i<n; i++)
+                *S[i] = *basis[i];
+        }
+        
+        for (unsigned int i=0; i<2*n; i++) {
+            
+            delete S[i];
+            delete AS[i];
+            delete BS[i];
+        }
+        
+        if (accepted)
+            for (unsigned int i=0; i<n; i++)
+                eig[i] = lambda[i];
+    }
+    
+    if (!accepted) {
+        
+        // full eigen solve, after which the preconditioner will be setup
+        // for the current design on the next call
+        this->clear_eigenproblem_reanalysis_data();
+        
+        this->eigenproblem_solve();
+        
+        libmesh_assert_less_equal(n, _n_converged_eigenpairs);
+        
+        Real im = 0.;
+        
+        for (unsigned int i=0; i<n; i++)
+            this->get_eigenpair(i, eig[i], im, *basis[i], nullptr);
+    }
+    
+    return accepted;
+}
+
+
+
+void
+MAST::NonlinearSystem::clear_eigenproblem_reanalysis_data() {
+    
+    if (_reanalysis_ksp) {
+        
+        PetscErrorCode ierr = KSPDestroy(&_reanalysis_ksp);
+        CHKERRABORT(this->comm().get(), ierr);
+    }
+}
+
+
+
+
+void
+MAST::NonlinearSystem::
+assemble_eigensystem () {
+    
+    libmesh_assert(_eigenproblem_assemble_system_object);
+    
+    _eigenproblem_assemble_system_object->eigenproblem_assemble(matrix_A,
+                                                                matrix_B);
+    
+}
+
+
+
+void
+MAST::NonlinearSystem::
+assemble_eigensystem_sensitivity(const libMesh::ParameterVector& parameters,
+                                 const unsigned int p) {
+    
+    libmesh_assert(_eigenproblem_assemble_system_object);
+    
+    _eigenproblem_assemble_system_object->eigenproblem_sensitivity_assemble
+    (parameters, p, matrix_A, matrix_B);
+    
+}
+
+
+
+
+void
+MAST::NonlinearSystem::
+attach_eigenproblem_assemble_object(MAST::EigenSystemAssembly& assemble) {
+    
+    libmesh_assert(!_eigenproblem_assemble_system_object);
+    
+    _eigenproblem_assemble_system_object = &assemble;
+}
+
 
 
 
@@ -675,6 +1964,10 @@ initialize_condensed_dofs(MAST::PhysicsDisciplineBase& physics) {
     for ( ; iter != iter_end; ++iter)
         _local_non_condensed_dofs_vector.push_back(*iter);
     
+    // the condensed matrices are recreated for the new set of dofs
+    _condensed_matrix_A.reset();
+    _condensed_matrix_B.reset();
+    
     _condensed_dofs_initialized = true;
 }
 
@@ -692,7 +1985,473 @@ MAST::NonlinearSystem::assemble_residual_derivatives
     dynamic_cast<MAST::NonlinearImplicitAssembly&>
     (*this->nonlinear_solver->residual_and_jacobian_object);
     
-    assembly.sensitivity_assemble(parameters, 0, this->add_sensitivity_rhs());
+    // the RHS for all parameters are assembled in a single pass over
+    // the elements
+    std::vector<libMesh::NumericVector<Real>*> rhs(parameters.size(), nullptr);
+    for (unsigned int i=0; i<parameters.size(); i++)
+        rhs[i] = &this->add_sensitivity_rhs(i);
+    
+    assembly.sensitivity_assemble(parameters, rhs);
+}
+
+
+
+void
+MAST::NonlinearSystem::set_reuse_sensitivity_factorization(bool f) {
+    
+    _reuse_sensitivity_factorization = f;
+    
+    if (!f)
+        this->clear_sensitivity_factorization();
+}
+
+
+
+void
+MAST::NonlinearSystem::clear_sensitivity_factorization() {
+    
+    if (_sensitivity_ksp) {
+        
+        PetscErrorCode ierr = KSPDestroy(&_sensitivity_ksp);
+        CHKERRABORT(this->comm().get(), ierr);
+    }
+    
+    _sensitivity_X.reset();
+}
+
+
+
+void
+MAST::NonlinearSystem::set_krylov_recycling(bool f, unsigned int n_recycle) {
+    
+#if !defined(PETSC_HAVE_HPDDM) || PETSC_VERSION_LESS_THAN(3,14,0)
+    if (f)
+        libmesh_error_msg("Krylov recycling requires PETSc 3.14 or later configured with HPDDM");
+#endif
+    
+    libmesh_assert_greater(n_recycle, 0);
+    
+    // the retained KSPs were created with the previous options
+    this->clear_sensitivity_factorization();
+    
+    if (_adjoint_ksp) {
+        PetscErrorCode ierr = KSPDestroy(&_adjoint_ksp);
+        CHKERRABORT(this->comm().get(), ierr);
+    }
+    
+    _krylov_recycling = f;
+    _n_recycle        = n_recycle;
+}
+
+
+
+void
+MAST::NonlinearSystem::_release_sensitivity_ksp() {
+    
+    if (_reuse_sensitivity_factorization)
+        return;
+    
+    if (_krylov_recycling)
+        _sensitivity_X.reset();
+    else
+        this->clear_sensitivity_factorization();
+}
+
+
+
+void
+MAST::NonlinearSystem::_configure_krylov_recycling(KSP ksp) {
+    
+#if defined(PETSC_HAVE_HPDDM) && !PETSC_VERSION_LESS_THAN(3,14,0)
+    
+    PetscErrorCode ierr = 0;
+    
+    // the size of the subspace is set as default for the prefix of the
+    // KSP, so that it can be changed from the command line
+    const char* prefix = PETSC_NULL;
+    ierr = KSPGetOptionsPrefix(ksp, &prefix);   CHKERRABORT(this->comm().get(), ierr);
+    
+    const std::string
+    nm = std::string("-") + (prefix? prefix: "") + "ksp_hpddm_recycle";
+    
+    std::ostringstream oss;
+    oss << _n_recycle;
+    MAST::set_default_petsc_option(nm, oss.str());
+    
+    ierr = KSPSetType(ksp, KSPHPDDM);           CHKERRABORT(this->comm().get(), ierr);
+    ierr = KSPHPDDMSetType(ksp, KSP_HPDDM_TYPE_GCRODR);
+    CHKERRABORT(this->comm().get(), ierr);
+    ierr = KSPSetFromOptions(ksp);              CHKERRABORT(this->comm().get(), ierr);
+    
+#else
+    
+    libmesh_error_msg("Krylov recycling requires PETSc 3.14 or later configured with HPDDM");
+    
+#endif
+}
+
+
+
+std::pair<unsigned int, Real>
+MAST::NonlinearSystem::
+sensitivity_solve (const libMesh::ParameterVector& parameters) {
+    
+    MAST_LOG_SCOPE("sensitivity_solve()", "NonlinearSystem");
+    
+    const unsigned int n_params = parameters.size();
+    
+    std::pair<unsigned int, Real> rval = std::make_pair(0, 0.);
+    
+    if (!n_params)
+        return rval;
+    
+    // the Jacobian and KSP about the current solution
+    this->_setup_sensitivity_ksp();
+    
+    // the RHS for all parameters
+    this->assemble_residual_derivatives(parameters);
+    
+    std::vector<libMesh::NumericVector<Real>*>
+    rhs(n_params, nullptr),
+    sol(n_params, nullptr);
+    
+    for (unsigned int i=0; i<n_params; i++) {
+        
+        rhs[i] = &this->get_sensitivity_rhs(i);
+        sol[i] = &this->add_sensitivity_solution(i);
+    }
+    
+    rval = this->_solve_with_sensitivity_ksp(rhs, sol);
+    
+    // recorded before the factorization is cleared, so that it is included
+    // in the report
+    if (_memory_report)
+        _memory_report->record_phase(this->name() + ": sensitivity_solve()");
+    
+    this->_release_sensitivity_ksp();
+    
+    return rval;
+}
+
+
+
+void
+MAST::NonlinearSystem::_setup_sensitivity_ksp() {
+    
+    // nothing to be done if the KSP was setup about the current solution
+    if (_sensitivity_ksp && _sensitivity_X.get()) {
+        
+        std::auto_ptr<libMesh::NumericVector<Real> >
+        dX(_sensitivity_X->clone().release());
+        dX->add(-1., *this->solution);
+        
+        if (dX->linfty_norm() == 0.)
+            return;
+    }
+    
+    MAST_LOG_SCOPE("setup_sensitivity_ksp()", "NonlinearSystem");
+    
+    // assemble the Jacobian about the current solution. The residual
+    // assembly is used directly, since the system matrix only stores
+    // the preconditioner if the Jacobian is matrix-free.
+    libmesh_assert(this->nonlinear_solver->residual_and_jacobian_object);
+    
+    // with a Jacobian lag, the assembly would otherwise leave the matrix
+    // of an earlier Newton step in place
+    MAST::NonlinearImplicitAssembly*
+    assembly = dynamic_cast<MAST::NonlinearImplicitAssembly*>
+    (this->nonlinear_solver->residual_and_jacobian_object);
+    
+    if (assembly)
+        assembly->request_jacobian_update();
+    
+    this->nonlinear_solver->residual_and_jacobian_object->residual_and_jacobian
+    (*this->solution, nullptr, this->matrix, *this);
+    this->matrix->close();
+    
+    PetscErrorCode ierr = 0;
+    PC             pc;
+    
+    if (!_sensitivity_ksp) {
+        
+        ierr = KSPCreate(this->comm().get(), &_sensitivity_ksp);
+        CHKERRABORT(this->comm().get(), ierr);
+        
+        if (libMesh::on_command_line("--solver_system_names")) {
+            
+            std::string nm = this->name() + "_sensitivity_";
+            KSPSetOptionsPrefix(_sensitivity_ksp, nm.c_str());
+        }
+        
+        if (_krylov_recycling)
+            _configure_krylov_recycling(_sensitivity_ksp);
+    }
+    
+    this->attach_near_null_space();
+    
+    Mat mat = dynamic_cast<libMesh::PetscMatrix<Real>*>(this->matrix)->mat();
+    
+    // the tolerances of the libMesh linear solver are used, unless
+    // they are changed from the command line
+    std::pair<unsigned int, Real>
+    solver_params = this->get_linear_solve_parameters();
+    
+    ierr = KSPSetOperators(_sensitivity_ksp, mat, mat);
+    CHKERRABORT(this->comm().get(), ierr);
+    ierr = KSPSetTolerances(_sensitivity_ksp,
+                            solver_params.second,
+                            PETSC_DEFAULT,
+                            PETSC_DEFAULT,
+                            solver_params.first);
+    CHKERRABORT(this->comm().get(), ierr);
+    ierr = KSPSetFromOptions(_sensitivity_ksp);  CHKERRABORT(this->comm().get(), ierr);
+    
+    ierr = KSPGetPC(_sensitivity_ksp, &pc);      CHKERRABORT(this->comm().get(), ierr);
+    
+    if (_multigrid)
+        _multigrid->configure_preconditioner(pc);
+    else if (_single_precision_pc)
+        _single_precision_pc->configure_preconditioner(pc);
+    else if (_bddc_pc)
+        _bddc_pc->configure_preconditioner(pc);
+    else {
+        
+        // LU is not available for the symmetric format
+        if (_symmetric_matrices) {
+            ierr = PCSetType(pc, PCCHOLESKY);    CHKERRABORT(this->comm().get(), ierr);
+        }
+        ierr = PCSetFromOptions(pc);             CHKERRABORT(this->comm().get(), ierr);
+        
+        if (_parallel_config)
+            _parallel_config->configure_direct_solver(pc);
+    }
+    
+    {
+        MAST_LOG_SCOPE("KSPSetUp", "NonlinearSystem");
+        ierr = KSPSetUp(_sensitivity_ksp);       CHKERRABORT(this->comm().get(), ierr);
+    }
+    
+    // store the solution for which the KSP was setup
+    if (!_sensitivity_X.get())
+        _sensitivity_X.reset(this->solution->zero_clone().release());
+    
+    *_sensitivity_X = *this->solution;
+}
+
+
+
+std::pair<unsigned int, Real>
+MAST::NonlinearSystem::
+multi_rhs_solve(const std::vector<libMesh::NumericVector<Real>*>& rhs,
+                std::vector<libMesh::NumericVector<Real>*>& sol) {
+    
+    MAST_LOG_SCOPE("multi_rhs_solve()", "NonlinearSystem");
+    
+    libmesh_assert_equal_to(rhs.size(), sol.size());
+    
+    std::pair<unsigned int, Real> rval = std::make_pair(0, 0.);
+    
+    if (rhs.empty())
+        return rval;
+    
+    // the Jacobian and KSP about the current solution, which are shared
+    // by all RHS vectors
+    this->_setup_sensitivity_ksp();
+    
+    rval = this->_solve_with_sensitivity_ksp(rhs, sol);
+    
+    // recorded before the factorization is cleared, so that it is included
+    // in the report
+    if (_memory_report)
+        _memory_report->record_phase(this->name() + ": multi_rhs_solve()");
+    
+    this->_release_sensitivity_ksp();
+    
+    return rval;
+}
+
+
+
+std::pair<unsigned int, Real>
+MAST::NonlinearSystem::
+transpose_solve(const libMesh::NumericVector<Real>& rhs,
+                libMesh::NumericVector<Real>& sol) {
+    
+    MAST_LOG_SCOPE("transpose_solve()", "NonlinearSystem");
+    
+    this->_setup_sensitivity_ksp();
+    
+    PetscErrorCode ierr = 0;
+    PetscInt       its  = 0;
+    PetscReal      res  = 0.;
+    
+    const libMesh::PetscVector<Real>
+    &b = dynamic_cast<const libMesh::PetscVector<Real>&>(rhs);
+    libMesh::PetscVector<Real>
+    &x = dynamic_cast<libMesh::PetscVector<Real>&>(sol);
+    
+    {
+        MAST_LOG_SCOPE("KSPSolveTranspose", "NonlinearSystem");
+        ierr = KSPSolveTranspose(_sensitivity_ksp, b.vec(), x.vec());
+        CHKERRABORT(this->comm().get(), ierr);
+    }
+    
+    ierr = KSPGetIterationNumber(_sensitivity_ksp, &its);
+    CHKERRABORT(this->comm().get(), ierr);
+    ierr = KSPGetResidualNorm(_sensitivity_ksp, &res);
+    CHKERRABORT(this->comm().get(), ierr);
+    
+    // the linear solver may not have fit the constraints exactly
+    sol.close();
+    this->get_dof_map().enforce_constraints_exactly(*this, &sol, true);
+    
+    this->_release_sensitivity_ksp();
+    
+    return std::make_pair((unsigned int)its, (Real)res);
+}
+
+
+
+std::pair<unsigned int, Real>
+MAST::NonlinearSystem::
+_solve_with_sensitivity_ksp(const std::vector<libMesh::NumericVector<Real>*>& rhs,
+                            std::vector<libMesh::NumericVector<Real>*>& sol) {
+    
+    libmesh_assert(_sensitivity_ksp);
+    libmesh_assert_equal_to(rhs.size(), sol.size());
+    
+    const unsigned int n = (unsigned int)rhs.size();
+    
+    std::pair<unsigned int, Real> rval = std::make_pair(0, 0.);
+    
+    PetscErrorCode ierr = 0;
+    PC             pc;
+    PetscBool      if_lu = PETSC_FALSE, if_cholesky = PETSC_FALSE;
+    
+    ierr = KSPGetPC(_sensitivity_ksp, &pc);     CHKERRABORT(this->comm().get(), ierr);
+    ierr = PetscObjectTypeCompare((PetscObject)pc, PCLU, &if_lu);
+    CHKERRABORT(this->comm().get(), ierr);
+    ierr = PetscObjectTypeCompare((PetscObject)pc, PCCHOLESKY, &if_cholesky);
+    CHKERRABORT(this->comm().get(), ierr);
+    
+    if (_mat_mat_sensitivity_solve && n > 1 && (if_lu || if_cholesky)) {
+        
+        Mat F;
+        ierr = PCFactorGetMatrix(pc, &F);       CHKERRABORT(this->comm().get(), ierr);
+        
+        _mat_mat_solve_all(F, rhs, sol);
+    }
+    else {
+        
+        PetscInt  its = 0;
+        PetscReal res = 0.;
+        
+        for (unsigned int i=0; i<n; i++) {
+            
+            libMesh::PetscVector<Real>
+            &b = dynamic_cast<libMesh::PetscVector<Real>&>(*rhs[i]),
+            &x = dynamic_cast<libMesh::PetscVector<Real>&>(*sol[i]);
+            
+            {
+                MAST_LOG_SCOPE("KSPSolve", "NonlinearSystem");
+                ierr = KSPSolve(_sensitivity_ksp, b.vec(), x.vec());
+                CHKERRABORT(this->comm().get(), ierr);
+            }
+            
+            ierr = KSPGetIterationNumber(_sensitivity_ksp, &its);
+            CHKERRABORT(this->comm().get(), ierr);
+            ierr = KSPGetResidualNorm(_sensitivity_ksp, &res);
+            CHKERRABORT(this->comm().get(), ierr);
+            
+            rval.first  += its;
+            rval.second += res;
+        }
+    }
+    
+    // the linear solver may not have fit the constraints exactly
+    for (unsigned int i=0; i<n; i++) {
+        
+        sol[i]->close();
+        this->get_dof_map().enforce_constraints_exactly(*this, sol[i], true);
+    }
+    
+    return rval;
+}
+
+
+
+void
+MAST::NonlinearSystem::
+_mat_mat_solve_all(Mat F,
+                   const std::vector<libMesh::NumericVector<Real>*>& rhs,
+                   std::vector<libMesh::NumericVector<Real>*>& sol) {
+    
+    PetscErrorCode ierr = 0;
+    
+    libmesh_assert_equal_to(rhs.size(), sol.size());
+    
+    const unsigned int
+    n = (unsigned int)rhs.size();
+    
+    const PetscInt
+    n_local = (PetscInt)this->n_local_dofs(),
+    n_dofs  = (PetscInt)this->n_dofs();
+    
+    Mat
+    B,
+    X;
+    
+    PetscScalar       *vals = nullptr;
+    const PetscScalar *v    = nullptr;
+    
+    ierr = MatCreateDense(this->comm().get(), n_local, PETSC_DECIDE, n_dofs, n, PETSC_NULL, &B);
+    CHKERRABORT(this->comm().get(), ierr);
+    ierr = MatCreateDense(this->comm().get(), n_local, PETSC_DECIDE, n_dofs, n, PETSC_NULL, &X);
+    CHKERRABORT(this->comm().get(), ierr);
+    
+    // copy the RHS vectors to the columns of B. The local block of the
+    // dense matrix is stored in column major order.
+    ierr = MatDenseGetArray(B, &vals);          CHKERRABORT(this->comm().get(), ierr);
+    
+    for (unsigned int i=0; i<n; i++) {
+        
+        libMesh::PetscVector<Real>&
+        b = dynamic_cast<libMesh::PetscVector<Real>&>(*rhs[i]);
+        
+        ierr = VecGetArrayRead(b.vec(), &v);    CHKERRABORT(this->comm().get(), ierr);
+        std::copy(v, v+n_local, vals+i*n_local);
+        ierr = VecRestoreArrayRead(b.vec(), &v); CHKERRABORT(this->comm().get(), ierr);
+    }
+    
+    ierr = MatDenseRestoreArray(B, &vals);      CHKERRABORT(this->comm().get(), ierr);
+    ierr = MatAssemblyBegin(B, MAT_FINAL_ASSEMBLY); CHKERRABORT(this->comm().get(), ierr);
+    ierr = MatAssemblyEnd(B, MAT_FINAL_ASSEMBLY);   CHKERRABORT(this->comm().get(), ierr);
+    ierr = MatAssemblyBegin(X, MAT_FINAL_ASSEMBLY); CHKERRABORT(this->comm().get(), ierr);
+    ierr = MatAssemblyEnd(X, MAT_FINAL_ASSEMBLY);   CHKERRABORT(this->comm().get(), ierr);
+    
+    {
+        MAST_LOG_SCOPE("MatMatSolve", "NonlinearSystem");
+        ierr = MatMatSolve(F, B, X);            CHKERRABORT(this->comm().get(), ierr);
+    }
+    
+    // copy the columns of X to the solution vectors
+    ierr = MatDenseGetArray(X, &vals);          CHKERRABORT(this->comm().get(), ierr);
+    
+    for (unsigned int i=0; i<n; i++) {
+        
+        libMesh::PetscVector<Real>&
+        x = dynamic_cast<libMesh::PetscVector<Real>&>(*sol[i]);
+        
+        PetscScalar* s = nullptr;
+        ierr = VecGetArray(x.vec(), &s);        CHKERRABORT(this->comm().get(), ierr);
+        std::copy(vals+i*n_local, vals+(i+1)*n_local, s);
+        ierr = VecRestoreArray(x.vec(), &s);    CHKERRABORT(this->comm().get(), ierr);
+    }
+    
+    ierr = MatDenseRestoreArray(X, &vals);      CHKERRABORT(this->comm().get(), ierr);
+    
+    ierr = MatDestroy(&B);                      CHKERRABORT(this->comm().get(), ierr);
+    ierr = MatDestroy(&X);                      CHKERRABORT(this->comm().get(), ierr);
 }
 
 
@@ -700,13 +2459,131 @@ MAST::NonlinearSystem::assemble_residual_derivatives
 void
 MAST::NonlinearSystem::adjoint_solve(MAST::OutputAssemblyBase &output) {
     
-    libmesh_assert(!_output);
+    this->adjoint_solve(std::vector<MAST::OutputAssemblyBase*>(1, &output));
+}
+
+
+
+void
+MAST::NonlinearSystem::
+adjoint_solve(const std::vector<MAST::OutputAssemblyBase*>& outputs) {
+    
+    libmesh_assert(_outputs.empty());
+    
+    MAST_LOG_SCOPE("adjoint_solve()", "NonlinearSystem");
+    
+    const unsigned int n_outputs = (unsigned int)outputs.size();
+    
+    if (!n_outputs)
+        return;
+    
+    _outputs = outputs;
+    
+    // one QoI for each output, so that the adjoint vectors are available
+    if (this->qoi.size() < n_outputs)
+        this->qoi.resize(n_outputs, 0.);
+    
+    for (unsigned int i=0; i<n_outputs; i++)
+        this->add_adjoint_solution(i);
+    
+    // assemble the Jacobian about the current solution. The residual
+    // assembly is used directly, since the system matrix only stores
+    // the preconditioner if the Jacobian is matrix-free.
+    libmesh_assert(this->nonlinear_solver->residual_and_jacobian_object);
     
-    _output = &output;
+    // with a Jacobian lag, the matrix may still hold the Jacobian of an
+    // earlier Newton step. So, the assembly is forced at the converged
+    // solution.
+    MAST::NonlinearImplicitAssembly*
+    assembly = dynamic_cast<MAST::NonlinearImplicitAssembly*>
+    (this->nonlinear_solver->residual_and_jacobian_object);
     
-    libMesh::NonlinearImplicitSystem::adjoint_solve();
+    if (assembly)
+        assembly->request_jacobian_update();
     
-    _output = nullptr;
+    this->nonlinear_solver->residual_and_jacobian_object->residual_and_jacobian
+    (*this->solution, nullptr, this->matrix, *this);
+    this->matrix->close();
+    
+    // the RHS of the adjoint problems
+    this->assemble_qoi_derivative(libMesh::QoISet(), false, true);
+    
+    // setup the KSP once so that the preconditioner, or factorization for
+    // direct solvers, is reused for all outputs
+    PetscErrorCode ierr = 0;
+    KSP        ksp = _adjoint_ksp;
+    PC         pc;
+    
+    this->attach_near_null_space();
+    
+    Mat mat = dynamic_cast<libMesh::PetscMatrix<Real>*>(this->matrix)->mat();
+    
+    // with Krylov recycling, the KSP of the previous adjoint solve is
+    // reused along with its subspace
+    if (!ksp) {
+        
+        ierr = KSPCreate(this->comm().get(), &ksp); CHKERRABORT(this->comm().get(), ierr);
+        
+        if (libMesh::on_command_line("--solver_system_names")) {
+            
+            std::string nm = this->name() + "_adjoint_";
+            KSPSetOptionsPrefix(ksp, nm.c_str());
+        }
+        
+        if (_krylov_recycling)
+            _configure_krylov_recycling(ksp);
+    }
+    
+    ierr = KSPSetOperators(ksp, mat, mat);      CHKERRABORT(this->comm().get(), ierr);
+    ierr = KSPSetFromOptions(ksp);              CHKERRABORT(this->comm().get(), ierr);
+    
+    ierr = KSPGetPC(ksp, &pc);                  CHKERRABORT(this->comm().get(), ierr);
+    if (_multigrid)
+        _multigrid->configure_preconditioner(pc);
+    else if (_single_precision_pc)
+        _single_precision_pc->configure_preconditioner(pc);
+    else if (_bddc_pc)
+        _bddc_pc->configure_preconditioner(pc);
+    else {
+        ierr = PCSetFromOptions(pc);            CHKERRABORT(this->comm().get(), ierr);
+        
+        if (_parallel_config)
+            _parallel_config->configure_direct_solver(pc);
+    }
+    
+    {
+        MAST_LOG_SCOPE("KSPSetUp", "NonlinearSystem");
+        ierr = KSPSetUp(ksp);                   CHKERRABORT(this->comm().get(), ierr);
+    }
+    
+    for (unsigned int i=0; i<n_outputs; i++) {
+        
+        libMesh::PetscVector<Real>
+        &rhs = dynamic_cast<libMesh::PetscVector<Real>&>(this->get_adjoint_rhs(i)),
+        &sol = dynamic_cast<libMesh::PetscVector<Real>&>(this->get_adjoint_solution(i));
+        
+        {
+            MAST_LOG_SCOPE("KSPSolveTranspose", "NonlinearSystem");
+            ierr = KSPSolveTranspose(ksp, rhs.vec(), sol.vec());
+            CHKERRABORT(this->comm().get(), ierr);
+        }
+        
+        sol.close();
+        
+        // the linear solver may not have fit the constraints exactly
+        this->get_dof_map().enforce_adjoint_constraints_exactly(sol, i);
+    }
+    
+    if (_memory_report)
+        _memory_report->record_phase(this->name() + ": adjoint_solve()");
+    
+    if (_krylov_recycling)
+        _adjoint_ksp = ksp;
+    else {
+        ierr = KSPDestroy(&ksp);                CHKERRABORT(this->comm().get(), ierr);
+    }
+    
+    _outputs.clear();
 }
 
 
@@ -717,9 +2594,416 @@ assemble_qoi_derivative (const libMesh::QoISet & qoi_indices,
                          bool include_liftfunc,
                          bool apply_constraints) {
     
-    // make sure the output object has been set
-    libmesh_assert(_output);
+    // make sure the output objects have been set
+    libmesh_assert(!_outputs.empty());
+    
+    for (unsigned int i=0; i<_outputs.size(); i++)
+        if (qoi_indices.has_index(i)) {
+            
+            libMesh::NumericVector<Real>& rhs = this->add_adjoint_rhs(i);
+            
+            rhs.zero();
+            _outputs[i]->assemble_output_derivative(*this->solution, rhs);
+            rhs.close();
+        }
+}
+
+
+
+
+namespace MAST {
+    
+    // identifies the checkpoint files written by NonlinearSystem
+    static const char nonlinear_system_checkpoint_id[8] =
+    {'M', 'A', 'S', 'T', 'C', 'K', 'P', 'T'};
+    
+    
+    static std::string
+    nonlinear_system_checkpoint_name(const std::string& prefix,
+                                     unsigned int rank) {
+        
+        std::ostringstream oss;
+        oss << prefix << "." << rank;
+        return oss.str();
+    }
+}
+
+
+
+void
+MAST::NonlinearSystem::write_checkpoint(const std::string& prefix,
+                                        const std::vector<Real>& data) const {
+    
+    MAST_LOG_SCOPE("write_checkpoint()", "NonlinearSystem");
+    
+    const std::string
+    fname = MAST::nonlinear_system_checkpoint_name(prefix, this->comm().rank());
+    
+    std::ofstream out(fname.c_str(), std::ios::out | std::ios::binary);
+    if (!out.good())
+        libmesh_error_msg("Unable to open file: " << fname);
+    
+    const unsigned int
+    n_procs  = this->comm().size(),
+    n_data   = (unsigned int)data.size(),
+    n_vecs   = (unsigned int)this->n_vectors() + 1;
+    
+    const unsigned long long
+    first    = this->solution->first_local_index(),
+    n_local  = this->solution->local_size();
+    
+    out.write(MAST::nonlinear_system_checkpoint_id, 8);
+    out.write((const char*)&n_procs, sizeof(unsigned int));
+    out.write((const char*)&first,   sizeof(unsigned long long));
+    out.write((const char*)&n_local, sizeof(unsigned long long));
+    out.write((const char*)&this->time, sizeof(Real));
+    out.write((const char*)&n_data,  sizeof(unsigned int));
+    if (n_data)
+        out.write((const char*)&data[0], n_data*sizeof(Real));
+    out.write((const char*)&n_vecs,  sizeof(unsigned int));
+    
+    // the solution is written first, followed by the vectors of the system
+    std::vector<std::pair<std::string, libMesh::NumericVector<Real>*> > vecs;
+    vecs.push_back(std::make_pair(std::string("solution"), this->solution.get()));
+    
+    libMesh::System::const_vectors_iterator
+    it  = this->vectors_begin(),
+    end = this->vectors_end();
+    
+    for ( ; it != end; it++)
+        vecs.push_back(std::make_pair(it->first, it->second));
+    
+    PetscErrorCode ierr;
+    
+    for (unsigned int i=0; i<vecs.size(); i++) {
+        
+        libMesh::PetscVector<Real>&
+        v = dynamic_cast<libMesh::PetscVector<Real>&>(*vecs[i].second);
+        libmesh_assert_equal_to(v.local_size(), n_local);
+        
+        const unsigned int
+        n_chars = (unsigned int)vecs[i].first.size();
+        out.write((const char*)&n_chars, sizeof(unsigned int));
+        out.write(vecs[i].first.c_str(), n_chars);
+        
+        // the array of a ghosted vector only includes the local values
+        const PetscScalar* vals = nullptr;
+        ierr = VecGetArrayRead(v.vec(), &vals);  CHKERRABORT(this->comm().get(), ierr);
+        if (n_local)
+            out.write((const char*)vals, n_local*sizeof(Real));
+        ierr = VecRestoreArrayRead(v.vec(), &vals); CHKERRABORT(this->comm().get(), ierr);
+    }
+    
+    if (!out.good())
+        libmesh_error_msg("Error writing file: " << fname);
+}
+
+
+
+void
+MAST::NonlinearSystem::read_checkpoint(const std::string& prefix,
+                                       std::vector<Real>* data) {
+    
+    MAST_LOG_SCOPE("read_checkpoint()", "NonlinearSystem");
+    
+    const std::string
+    fname = MAST::nonlinear_system_checkpoint_name(prefix, this->comm().rank());
+    
+    std::ifstream in(fname.c_str(), std::ios::in | std::ios::binary);
+    if (!in.good())
+        libmesh_error_msg("Unable to open file: " << fname);
+    
+    char id[8];
+    unsigned int
+    n_procs  = 0,
+    n_data   = 0,
+    n_vecs   = 0;
+    
+    unsigned long long
+    first    = 0,
+    n_local  = 0;
+    
+    in.read(id, 8);
+    if (!std::equal(id, id+8, MAST::nonlinear_system_checkpoint_id))
+        libmesh_error_msg("Not a NonlinearSystem checkpoint: " << fname);
+    
+    in.read((char*)&n_procs, sizeof(unsigned int));
+    in.read((char*)&first,   sizeof(unsigned long long));
+    in.read((char*)&n_local, sizeof(unsigned long long));
+    
+    if (n_procs != this->comm().size() ||
+        first   != this->solution->first_local_index() ||
+        n_local != this->solution->local_size())
+        libmesh_error_msg("Checkpoint " << fname
+                          << " was written with a different partitioning");
+    
+    in.read((char*)&this->time, sizeof(Real));
+    in.read((char*)&n_data,  sizeof(unsigned int));
+    
+    std::vector<Real> vals(n_data);
+    if (n_data)
+        in.read((char*)&vals[0], n_data*sizeof(Real));
+    if (data)
+        data->assign(vals.begin(), vals.begin()+n_data);
+    
+    in.read((char*)&n_vecs,  sizeof(unsigned int));
+    
+    PetscErrorCode ierr;
+    std::string nm;
+    
+    for (unsigned int i=0; i<n_vecs; i++) {
+        
+        unsigned int n_chars = 0;
+        in.read((char*)&n_chars, sizeof(unsigned int));
+        nm.resize(n_chars);
+        if (n_chars)
+            in.read(&nm[0], n_chars);
+        
+        libMesh::NumericVector<Real>*
+        vec = nullptr;
+        
+        if (i == 0) {
+            libmesh_assert_equal_to(nm, "solution");
+            vec = this->solution.get();
+        }
+        else if (this->have_vector(nm))
+            vec = &this->get_vector(nm);
+        else
+            vec = &this->add_vector(nm);
+        
+        libMesh::PetscVector<Real>&
+        v = dynamic_cast<libMesh::PetscVector<Real>&>(*vec);
+        
+        PetscScalar* v_vals = nullptr;
+        ierr = VecGetArray(v.vec(), &v_vals);  CHKERRABORT(this->comm().get(), ierr);
+        if (n_local)
+            in.read((char*)v_vals, n_local*sizeof(Real));
+        ierr = VecRestoreArray(v.vec(), &v_vals); CHKERRABORT(this->comm().get(), ierr);
+        
+        // updates the ghost values
+        v.close();
+    }
+    
+    if (!in.good())
+        libmesh_error_msg("Error reading file: " << fname);
+    
+    this->update();
+}
+
+
+
+namespace MAST {
+    
+    // identifies the setup snapshot files written by NonlinearSystem
+    static const char nonlinear_system_snapshot_id[8] =
+    {'M', 'A', 'S', 'T', 'S', 'E', 'T', 'P'};
+    
+    
+    static void
+    write_snapshot_ids(std::ostream& out,
+                       const std::vector<libMesh::dof_id_type>& v) {
+        
+        const unsigned long long n = v.size();
+        out.write((const char*)&n, sizeof(unsigned long long));
+        if (n)
+            out.write((const char*)&v[0], n*sizeof(libMesh::dof_id_type));
+    }
+    
+    
+    static void
+    read_snapshot_ids(std::istream& in,
+                      std::vector<libMesh::dof_id_type>& v) {
+        
+        unsigned long long n = 0;
+        in.read((char*)&n, sizeof(unsigned long long));
+        v.resize(n);
+        if (n)
+            in.read((char*)&v[0], n*sizeof(libMesh::dof_id_type));
+    }
+}
+
+
+
+void
+MAST::NonlinearSystem::write_setup_snapshot(const std::string& prefix) const {
+    
+    MAST_LOG_SCOPE("write_setup_snapshot()", "NonlinearSystem");
+    
+    const std::string
+    fname = MAST::nonlinear_system_checkpoint_name(prefix, this->comm().rank());
+    
+    std::ofstream out(fname.c_str(), std::ios::out | std::ios::binary);
+    if (!out.good())
+        libmesh_error_msg("Unable to open file: " << fname);
+    
+    const libMesh::DofMap& dof_map = this->get_dof_map();
+    
+    const unsigned int
+    n_procs  = this->comm().size(),
+    id_size  = sizeof(libMesh::dof_id_type);
+    
+    std::vector<libMesh::dof_id_type> sig;
+    _dof_distribution_signature(sig);
+    
+    out.write(MAST::nonlinear_system_snapshot_id, 8);
+    out.write((const char*)&n_procs, sizeof(unsigned int));
+    out.write((const char*)&id_size, sizeof(unsigned int));
+    
+    MAST::write_snapshot_ids(out, sig);
+    MAST::write_snapshot_ids(out, dof_map.get_send_list());
+    
+    // the number of nonzeros are retained by the dof map after the
+    // sparsity is computed, or are those from the snapshot read earlier
+    if (_setup_snapshot_used) {
+        
+        MAST::write_snapshot_ids(out, _snapshot_n_nz);
+        MAST::write_snapshot_ids(out, _snapshot_n_oz);
+    }
+    else {
+        
+        MAST::write_snapshot_ids(out, dof_map.get_n_nz());
+        MAST::write_snapshot_ids(out, dof_map.get_n_oz());
+    }
+    
+    MAST::write_snapshot_ids
+    (out, std::vector<libMesh::dof_id_type>(_storage_d_nnz.begin(), _storage_d_nnz.end()));
+    MAST::write_snapshot_ids
+    (out, std::vector<libMesh::dof_id_type>(_storage_o_nnz.begin(), _storage_o_nnz.end()));
+    
+    if (!out.good())
+        libmesh_error_msg("Error writing file: " << fname);
+}
+
+
+
+void
+MAST::NonlinearSystem::read_setup_snapshot(const std::string& prefix) {
+    
+    MAST_LOG_SCOPE("read_setup_snapshot()", "NonlinearSystem");
+    
+    const std::string
+    fname = MAST::nonlinear_system_checkpoint_name(prefix, this->comm().rank());
+    
+    std::ifstream in(fname.c_str(), std::ios::in | std::ios::binary);
+    if (!in.good())
+        libmesh_error_msg("Unable to open file: " << fname);
+    
+    char id[8];
+    unsigned int
+    n_procs  = 0,
+    id_size  = 0;
+    
+    in.read(id, 8);
+    if (!std::equal(id, id+8, MAST::nonlinear_system_snapshot_id))
+        libmesh_error_msg("Not a NonlinearSystem setup snapshot: " << fname);
+    
+    in.read((char*)&n_procs, sizeof(unsigned int));
+    in.read((char*)&id_size, sizeof(unsigned int));
+    
+    if (n_procs != this->comm().size())
+        libmesh_error_msg("Setup snapshot " << fname
+                          << " was written with a different number of processors");
+    if (id_size != sizeof(libMesh::dof_id_type))
+        libmesh_error_msg("Setup snapshot " << fname
+                          << " was written with a different dof_id_type");
+    
+    MAST::read_snapshot_ids(in, _snapshot_signature);
+    MAST::read_snapshot_ids(in, _snapshot_send_list);
+    MAST::read_snapshot_ids(in, _snapshot_n_nz);
+    MAST::read_snapshot_ids(in, _snapshot_n_oz);
+    MAST::read_snapshot_ids(in, _snapshot_storage_d_nnz);
+    MAST::read_snapshot_ids(in, _snapshot_storage_o_nnz);
+    
+    if (!in.good())
+        libmesh_error_msg("Error reading file: " << fname);
+    
+    _setup_snapshot_loaded = true;
+}
+
+
+
+void
+MAST::NonlinearSystem::report_memory(MAST::MemoryReport& r) const {
+    
+    const std::string& nm = this->name();
+    
+    r.add(nm, "Jacobian",
+          this->matrix? MAST::MemoryReport::bytes(*this->matrix): 0);
+    r.add(nm, "matrix_A",
+          matrix_A? MAST::MemoryReport::bytes(*matrix_A): 0);
+    r.add(nm, "matrix_B",
+          matrix_B? MAST::MemoryReport::bytes(*matrix_B): 0);
+    r.add(nm, "condensed matrix_A",
+          _condensed_matrix_A.get()? MAST::MemoryReport::bytes(*_condensed_matrix_A): 0);
+    r.add(nm, "condensed matrix_B",
+          _condensed_matrix_B.get()? MAST::MemoryReport::bytes(*_condensed_matrix_B): 0);
+    
+    // the factorization of the preconditioner of the nonlinear solver,
+    // which is only available after the solver has been initialized
+    std::size_t v = 0;
+    
+    libMesh::PetscNonlinearSolver<Real>*
+    solver = dynamic_cast<libMesh::PetscNonlinearSolver<Real>*>
+    (this->nonlinear_solver.get());
+    
+    if (solver && solver->initialized()) {
+        
+        KSP ksp;
+        PetscErrorCode ierr = SNESGetKSP(solver->snes(), &ksp);
+        CHKERRABORT(this->comm().get(), ierr);
+        
+        v = MAST::MemoryReport::factorization_bytes(ksp);
+    }
+    
+    if (_single_precision_pc)
+        v += _single_precision_pc->memory_bytes();
+    
+    r.add(nm, "preconditioner", v);
+    r.add(nm, "sensitivity factorization",
+          MAST::MemoryReport::factorization_bytes(_sensitivity_ksp));
+    r.add(nm, "element topology", _topology_cache.memory());
+    if (_wetted_surface)
+        r.add(nm, "wetted surface", _wetted_surface->memory());
+    
+    v = 0;
+    std::map<const libMesh::SparseMatrix<Real>*, MAST::ElementMatrixScatter*>::const_iterator
+    s_it  = _matrix_scatter.begin(),
+    s_end = _matrix_scatter.end();
+    for ( ; s_it != s_end; s_it++)
+        v += s_it->second->memory();
+    r.add(nm, "matrix scatter", v);
+    
+    // vectors of the system
+    std::size_t
+    v_sol   = MAST::MemoryReport::bytes(*this->solution) +
+    MAST::MemoryReport::bytes(*this->current_local_solution),
+    v_sens  = 0,
+    v_adj   = 0,
+    v_other = 0;
+    
+    libMesh::System::const_vectors_iterator
+    it   = this->vectors_begin(),
+    end  = this->vectors_end();
+    
+    for ( ; it != end; it++) {
+        
+        const std::size_t
+        b = MAST::MemoryReport::bytes(*it->second);
+        
+        if (it->first.find("sensitivity") == 0)
+            v_sens  += b;
+        else if (it->first.find("adjoint") == 0)
+            v_adj   += b;
+        else
+            v_other += b;
+    }
     
+    if (_sensitivity_X.get()) v_other += MAST::MemoryReport::bytes(*_sensitivity_X);
+    if (_mf_X.get())          v_other += MAST::MemoryReport::bytes(*_mf_X);
     
+    r.add(nm, "solution vectors",    v_sol);
+    r.add(nm, "sensitivity vectors", v_sens);
+    r.add(nm, "adjoint vectors",     v_adj);
+    r.add(nm, "other vectors",       v_other);
 }
 
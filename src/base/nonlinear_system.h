@@ -22,14 +22,25 @@
 
 // C++ includes
 #include <memory>
+#include <string>
+#include <map>
+#include <vector>
+#include <utility>
 
 // MAST includes
 #include "base/mast_data_types.h"
+#include "base/element_topology_cache.h"
 
 // libMesh includes
 #include "libmesh/nonlinear_implicit_system.h"
 #include "libmesh/enum_eigen_solver_type.h"
 #include "libmesh/eigen_system.h"
+#include "libmesh/solver_configuration.h"
+#include "libmesh/sparsity_pattern.h"
+
+// PETSc includes
+#include <petscmat.h>
+#include <petscksp.h>
 
 
 namespace MAST {
@@ -41,6 +52,14 @@ namespace MAST {
     class EigenSystemAssembly;
     class PhysicsDisciplineBase;
     class OutputAssemblyBase;
+    class NonlinearImplicitAssembly;
+    class GeometricMultigrid;
+    class SinglePrecisionILU;
+    class BDDCPreconditioner;
+    class HybridParallelConfiguration;
+    class MemoryReport;
+    class ElementMatrixScatter;
+    class WettedSurface;
     
     
     /*!
@@ -75,6 +94,300 @@ namespace MAST {
         }
         
         
+        /*!
+         *    if \p f is true, the system matrix and the eigenproblem
+         *    matrices are stored in the PETSc symmetric format (SBAIJ),
+         *    which stores only the upper triangle. Element matrices are
+         *    added as before, and their entries below the diagonal are
+         *    ignored. This is meant for symmetric operators, such as the
+         *    linear stiffness, mass and geometric stiffness matrices of
+         *    linear static, modal and buckling analyses, and must not be
+         *    used when the Jacobian is not symmetric, for example with
+         *    follower forces or aerodynamic loads. Factorizations must use
+         *    a Cholesky or ICC class preconditioner, for example
+         *    \p -pc_type cholesky for the nonlinear solver and
+         *    \p -st_pc_type cholesky for the eigensolver. The sensitivity
+         *    KSP uses Cholesky by default. Must be called before
+         *    EquationsSystems::init(). This is false by default.
+         */
+        void set_symmetric_matrices(bool f);
+        
+        
+        /*!
+         *   @returns true if the matrices use the symmetric storage
+         */
+        bool if_symmetric_matrices() const {
+            return _symmetric_matrices;
+        }
+        
+        
+        /*!
+         *    if \p f is true, the system matrix and the eigenproblem
+         *    matrices are stored in the PETSc block format (BAIJ, or SBAIJ
+         *    with set_symmetric_matrices()), with one block for all
+         *    variables of a node. This requires that all variables of the
+         *    system use the same FE type, so that libMesh numbers the dofs
+         *    of a node contiguously. The assemblies add element matrices
+         *    to these matrices with blocked insertion. Must be called
+         *    before EquationsSystems::init(). This is false by default.
+         */
+        void set_blocked_matrices(bool f);
+        
+        
+        /*!
+         *   @returns true if the matrices use the blocked storage
+         */
+        bool if_blocked_matrices() const {
+            return _blocked_matrices;
+        }
+        
+        
+        /*!
+         *   @returns the block size of the matrices, which is the number
+         *   of variables if the blocked storage is used, and 1 otherwise.
+         */
+        unsigned int matrix_block_size() const {
+            return _blocked_matrices? this->n_vars(): 1;
+        }
+        
+        
+        /*!
+         *    sets the PETSc type of the system matrix and the eigenproblem
+         *    matrices to an AIJ class type \p t, for example
+         *    \p aijcusparse or \p aijkokkos to store the matrices on a GPU.
+         *    The element quantities are computed and added on the host,
+         *    and PETSc copies the assembled values to the device, where
+         *    the preconditioner and the matrix products of the solvers are
+         *    evaluated if the solver options select device
+         *    implementations. If PETSc is not configured with \p t, a
+         *    message is printed and the host storage is used. This can be
+         *    combined with set_blocked_matrices(), but not with
+         *    set_symmetric_matrices(). Must be called before
+         *    EquationsSystems::init(). An empty string, which is the
+         *    default, uses the libMesh or blocked host storage.
+         *
+         *    \p MATIS stores the matrices unassembled: each processor
+         *    stores the matrix of its local elements on the dofs of these
+         *    elements, for the domain decomposition preconditioner
+         *    MAST::BDDCPreconditioner. The element matrices are added with
+         *    the global dof indices, as for the other types.
+         */
+        void set_matrix_type(const std::string& t);
+        
+        
+        /*!
+         *   @returns the PETSc type of the matrices set with
+         *   set_matrix_type()
+         */
+        const std::string& matrix_type() const {
+            return _matrix_type;
+        }
+        
+        
+        /*!
+         *    if \p f is true, reinit() keeps the sparsity pattern and the
+         *    PETSc matrices of the system when the dof distribution is the
+         *    same as at the last initialization, which is the case for
+         *    design iterations and parameter sweeps that do not change the
+         *    mesh topology. The matrices are then only zeroed, and a new
+         *    nonzero location during assembly is an error. The dof
+         *    distribution is compared with a checksum of the dof indices
+         *    of the local elements. This is false by default.
+         */
+        void set_reuse_matrix_structure(bool f) {
+            _reuse_matrix_structure = f;
+        }
+        
+        
+        /*!
+         *   @returns true if the matrix structure is reused by reinit()
+         */
+        bool if_reuse_matrix_structure() const {
+            return _reuse_matrix_structure;
+        }
+        
+        
+        /*!
+         *   @returns the dof indices and side boundary ids of the local
+         *   elements, which are rebuilt in init_data() and reinit()
+         */
+        const MAST::ElementTopologyCache& topology_cache() const {
+            return _topology_cache;
+        }
+        
+        
+        /*!
+         *   sets the list of loaded element sides used by the side load
+         *   calculations of the elements, which is rebuilt with the
+         *   topology cache. The object is not owned by this system, and
+         *   \p nullptr detaches it.
+         */
+        void set_wetted_surface(MAST::WettedSurface* ws);
+        
+        
+        /*!
+         *   @returns the list of loaded element sides, or \p nullptr if
+         *   none is attached
+         */
+        const MAST::WettedSurface* wetted_surface() const {
+            return _wetted_surface;
+        }
+        
+        
+        /*!
+         *    if \p f is true, the element matrices of the assemblies are
+         *    added to the system matrices by direct addition to the CSR
+         *    values, with the positions of the element entries computed
+         *    once for the nonzero structure of each matrix. This applies
+         *    to assembled \p MATSEQAIJ and \p MATMPIAIJ matrices, and
+         *    requires memory for the position of each entry of each
+         *    element matrix. This is false by default.
+         */
+        void set_direct_matrix_insertion(bool f);
+        
+        
+        /*!
+         *   @returns true if direct matrix insertion is enabled
+         */
+        bool if_direct_matrix_insertion() const {
+            return _direct_matrix_insertion;
+        }
+        
+        
+        /*!
+         *   @returns the object that adds element matrices to \p m by
+         *   direct insertion, or \p nullptr if direct insertion is not
+         *   enabled or not supported for \p m, or if \p m has not been
+         *   assembled. The object is computed on the first call for the
+         *   current nonzero structure of \p m.
+         */
+        MAST::ElementMatrixScatter*
+        matrix_scatter(libMesh::SparseMatrix<Real>& m);
+        
+        
+        /*!
+         *    sets the function that computes the near null space of the
+         *    operators of this system, for example the rigid-body modes of
+         *    a structural model. The vectors are computed at the first
+         *    solve and attached to the system and eigenproblem matrices
+         *    with MatSetNearNullSpace(), so that algebraic multigrid
+         *    preconditioners, such as GAMG, can use them in the nonlinear,
+         *    eigen, sensitivity and adjoint solves. The object must exist
+         *    as long as the system is used. \p nullptr removes the
+         *    function.
+         */
+        void
+        set_near_null_space_function(libMesh::NonlinearImplicitSystem::ComputeVectorSubspace* f);
+        
+        
+        /*!
+         *    computes the near null space, if not already available, and
+         *    attaches it to the matrices of this system. Nothing is done
+         *    if no function has been set. This is called by the solves of
+         *    this system, and by solvers that use the system matrix
+         *    outside of these solves.
+         */
+        void attach_near_null_space();
+        
+        
+        /*!
+         *    sets the geometric multigrid preconditioner that is used by
+         *    the nonlinear, sensitivity and adjoint solves of this system.
+         *    The object must be initialized, and must exist as long as it
+         *    is attached to the system. \p nullptr removes it, after which
+         *    the preconditioner is defined by the PETSc options.
+         */
+        void set_multigrid_preconditioner(MAST::GeometricMultigrid* mg) {
+            _multigrid = mg;
+        }
+        
+        
+        /*!
+         *    sets the single precision ILU preconditioner that is used by
+         *    the nonlinear, sensitivity and adjoint solves of this system,
+         *    unless a multigrid preconditioner is set. The object must
+         *    exist as long as it is attached to the system. \p nullptr
+         *    removes it, after which the preconditioner is defined by the
+         *    PETSc options.
+         */
+        void
+        set_single_precision_preconditioner(MAST::SinglePrecisionILU* pc) {
+            _single_precision_pc = pc;
+        }
+        
+        
+        /*!
+         *    sets the BDDC preconditioner that is used by the nonlinear,
+         *    sensitivity and adjoint solves of this system, unless a
+         *    multigrid or single precision preconditioner is set. This
+         *    requires the \p MATIS storage set with set_matrix_type(). The
+         *    object must exist as long as it is attached to the system.
+         *    \p nullptr removes it.
+         */
+        void set_bddc_preconditioner(MAST::BDDCPreconditioner* pc) {
+            _bddc_pc = pc;
+        }
+        
+        
+        /*!
+         *    sets the configuration that chooses the threaded direct solver
+         *    of the nonlinear, sensitivity and adjoint solves of this
+         *    system, if these use an LU or Cholesky preconditioner. The
+         *    object must exist as long as it is attached to the system.
+         *    \p nullptr removes it.
+         */
+        void
+        set_parallel_configuration(const MAST::HybridParallelConfiguration* c) {
+            _parallel_config = c;
+        }
+        
+        
+        /*!
+         *    if \p f is true, the Newton solves of this system use a PETSc
+         *    shell matrix for the Jacobian, whose action on a vector is
+         *    computed by
+         *    NonlinearImplicitAssembly::linearized_jacobian_solution_product
+         *    of the residual assembly attached to this system. The system
+         *    matrix is then only used to store the preconditioner, which is
+         *    assembled by \p pc_assembly, if provided, or by the residual
+         *    assembly otherwise. \p pc_assembly can be a cheaper
+         *    approximation of the Jacobian, for example the linear stiffness
+         *    matrix. Since initialization of an assembly object attaches it
+         *    to the system as the residual assembly, \p pc_assembly must be
+         *    initialized before the residual assembly. Combine with
+         *    \p -snes_lag_preconditioner to reuse the preconditioner over
+         *    several Newton iterations. This is false by default.
+         */
+        void
+        set_matrix_free_jacobian(bool f,
+                                 MAST::NonlinearImplicitAssembly* pc_assembly = nullptr);
+        
+        
+        /*!
+         *   @returns true if the Jacobian is applied in a matrix-free manner
+         */
+        bool if_matrix_free_jacobian() const {
+            return _matrix_free_jacobian;
+        }
+        
+        
+        /*!
+         *   stores \p X as the point about which the matrix-free Jacobian
+         *   is linearized, and assembles the preconditioner matrix at
+         *   \p X. This is called by the SNES Jacobian callback.
+         */
+        void update_matrix_free_linearization(const libMesh::NumericVector<Real>& X);
+        
+        
+        /*!
+         *   computes \f$ [J] \{dX\} \f$ about the solution provided to the
+         *   last call to update_matrix_free_linearization(). This is called
+         *   by the shell matrix multiplication.
+         */
+        void matrix_free_jacobian_product(const libMesh::NumericVector<Real>& dX,
+                                          libMesh::NumericVector<Real>& JdX);
+        
+        
         /*!
          * Clear all the data structures associated with
          * the system.
@@ -89,11 +402,17 @@ namespace MAST {
         virtual void reinit () libmesh_override;
         
         
+        /*!
+         *   solves the nonlinear system. Same as the parent class method,
+         *   with the time recorded in \p MAST::perf_log.
+         */
+        virtual void solve () libmesh_override;
+        
+        
         /**
-         *   calculates and stores the sensitivity RHS in System::add_sensitivity_rhs(0).
-         *   This assumes that \p parameters is of size 1. For solving sensitivity
-         *   wrt multiple parameters, the user should call this method multiple 
-         *   times with the parameter vector modified.
+         *   calculates and stores the sensitivity RHS for the i^th parameter
+         *   in \p parameters in System::add_sensitivity_rhs(i). The RHS for
+         *   all parameters are assembled in a single pass over the elements.
          *   The RHS is \f$ - \frac{\partial R(U,p)}{\partial p}\f$
          */
         virtual void
@@ -111,11 +430,133 @@ namespace MAST {
 
         
         /*!
-         *   solves the adjoint problem for the provided output function
+         *   if \p f is true, the KSP used by sensitivity_solve(), along with
+         *   the Jacobian and its preconditioner (or LU factorization, for
+         *   direct solvers), is retained after the solve and reused for
+         *   subsequent sensitivity solves about the same solution. The KSP
+         *   is setup again if the solution changes, or after a call to
+         *   solve(). The Jacobian is assumed to depend on the parameters
+         *   only through the solution. This is false by default.
+         */
+        void set_reuse_sensitivity_factorization(bool f);
+        
+        
+        /*!
+         *   @returns true if the sensitivity KSP is retained between
+         *   sensitivity solves.
+         */
+        bool if_reuse_sensitivity_factorization() const {
+            return _reuse_sensitivity_factorization;
+        }
+        
+        
+        /*!
+         *   if \p f is true and the sensitivity KSP uses a LU or Cholesky
+         *   preconditioner, sensitivity_solve() solves for all parameters
+         *   with a single MatMatSolve on the factored matrix, instead of
+         *   one KSPSolve per parameter. This also applies to the RHS
+         *   vectors of multi_rhs_solve(). This is false by default.
+         */
+        void set_mat_mat_sensitivity_solve(bool f) {
+            _mat_mat_sensitivity_solve = f;
+        }
+        
+        
+        /*!
+         *   if \p f is true, the Krylov solvers of the nonlinear, sensitivity
+         *   and adjoint solves of this system use the GCRO-DR method of the
+         *   PETSc \p KSPHPDDM, which retains a deflation subspace of size
+         *   \p n_recycle between solves. The subspace is updated with each
+         *   solve, so that a sequence of related systems, such as Newton
+         *   steps, the sensitivity of multiple parameters, or successive
+         *   design iterations, start from the subspace of the previous
+         *   solves. The sensitivity and adjoint KSPs are then retained
+         *   between solves, and only their operators are setup again. This
+         *   requires PETSc configured with HPDDM, and is false by default.
+         *   The options of \p KSPHPDDM can be changed on the command line
+         *   with the prefix of each KSP.
+         */
+        void set_krylov_recycling(bool f, unsigned int n_recycle = 20);
+        
+        
+        /*!
+         *   @returns true if a deflation subspace is retained between the
+         *   Krylov solves of this system.
+         */
+        bool if_krylov_recycling() const {
+            return _krylov_recycling;
+        }
+        
+        
+        /*!
+         *   deletes the KSP retained for sensitivity solves
+         */
+        void clear_sensitivity_factorization();
+        
+        
+        /*!
+         *   solves the sensitivity system for all parameters in
+         *   \p parameters about the current solution, and returns the
+         *   sensitivity solution of the i^th parameter in
+         *   get_sensitivity_solution(i). The Jacobian is assembled and
+         *   the KSP is setup once for all parameters. The KSP uses the
+         *   options prefix \p <system name>_sensitivity_ if
+         *   \p --solver_system_names is given.
+         */
+        virtual std::pair<unsigned int, Real>
+        sensitivity_solve (const libMesh::ParameterVector& parameters) libmesh_override;
+        
+        
+        /*!
+         *   solves \f$ [J] \{x_i\} = \{b_i\} \f$ for each vector
+         *   \f$ b_i \f$ in \p rhs, where \f$ [J] \f$ is the Jacobian about
+         *   the current solution, and returns \f$ x_i \f$ in \p sol. The
+         *   Jacobian is assembled and factorized once for all vectors, with
+         *   the same KSP and options as sensitivity_solve(), and is retained
+         *   if set_reuse_sensitivity_factorization() is true. For a linear
+         *   static analysis with multiple load cases, \p rhs are the load
+         *   vectors and \p sol the corresponding displacements. The
+         *   homogeneous constraints are enforced on the solutions.
+         */
+        std::pair<unsigned int, Real>
+        multi_rhs_solve(const std::vector<libMesh::NumericVector<Real>*>& rhs,
+                        std::vector<libMesh::NumericVector<Real>*>& sol);
+        
+        
+        /*!
+         *   solves \f$ [J]^T \{x\} = \{b\} \f$ about the current solution
+         *   for \p rhs = \f$ b \f$, and returns \f$ x \f$ in \p sol. The
+         *   KSP of sensitivity_solve() is used, so that the factorization
+         *   is shared with the solves of multi_rhs_solve() if
+         *   set_reuse_sensitivity_factorization() is true. This is used
+         *   for the second order adjoint of
+         *   MAST::NonlinearImplicitAssembly::reduced_hessian_product().
+         *   The homogeneous constraints are enforced on the solution.
+         */
+        std::pair<unsigned int, Real>
+        transpose_solve(const libMesh::NumericVector<Real>& rhs,
+                        libMesh::NumericVector<Real>& sol);
+        
+        
+        /*!
+         *   solves the adjoint problem for the provided output function.
+         *   The adjoint solution is returned in get_adjoint_solution(0).
          */
         void adjoint_solve(MAST::OutputAssemblyBase& output);
         
         
+        /*!
+         *   solves the adjoint problem for each output in \p outputs about
+         *   the current solution, and returns the adjoint solution of the
+         *   i^th output in get_adjoint_solution(i). The Jacobian is assembled
+         *   and the preconditioner (or factorization, for a direct solver)
+         *   is setup only once, and is reused for the transpose solves of
+         *   all outputs. The KSP uses the options prefix
+         *   \p <system name>_adjoint_ if \p --solver_system_names is given.
+         */
+        void adjoint_solve(const std::vector<MAST::OutputAssemblyBase*>& outputs);
+        
+        
         /**
          * Assembles & solves the eigen system.
          */
@@ -133,6 +574,42 @@ namespace MAST {
                                         std::vector<Real>& sens) ;
         
         
+        /*!
+         *   updates the eigenpairs in \p basis and \p eig, computed for a
+         *   previous design, to the current design without a full eigen
+         *   solve. The eigenproblem matrices are assembled, and in each of
+         *   at most \p max_iters subspace iterations the vectors
+         *   \f$ [A]^{-1} [B] \{x_i\} \f$ are computed and
+         *   added to the current vectors for a Rayleigh-Ritz solution on the
+         *   combined subspace. The solves use the preconditioner, or the
+         *   factorization for a direct solver, of the matrix \f$ [A] \f$
+         *   for the design of the first call, or of the first call after a
+         *   full solve, which is retained between calls. The lowest eigenpairs are accepted if the relative
+         *   residual \f$ \| [A] \{x\} - \lambda [B] \{x\} \| /
+         *   \| [A] \{x\} \| \f$ of each is below \p tol. Otherwise, the
+         *   eigenpairs are obtained from eigenproblem_solve() and
+         *   get_eigenpair(), and the retained preconditioner is cleared.
+         *   The vectors are scaled to a unit inner
+         *   product with \f$ [B] \f$. This is only implemented for the
+         *   GHEP problem type.
+         *
+         *   @returns true if the reanalysis was accepted, and false if the
+         *   full eigen solve was used.
+         */
+        bool
+        eigenproblem_reanalysis(std::vector<libMesh::NumericVector<Real>*>& basis,
+                                std::vector<Real>& eig,
+                                Real tol               = 1.e-6,
+                                unsigned int max_iters = 3);
+        
+        
+        /*!
+         *   clears the preconditioner retained by eigenproblem_reanalysis(),
+         *   so that it is setup again for the design of the next call
+         */
+        void clear_eigenproblem_reanalysis_data();
+        
+        
         /*!
          *  Assembles the matrix_A and matrix_B for eigensolution
          */
@@ -260,6 +737,79 @@ namespace MAST {
          */
         unsigned int n_global_non_condensed_dofs() const;
         
+        
+        /*!
+         *   writes the time, the values in \p data, and the local values of
+         *   the solution and of all vectors added to the system to the
+         *   binary file \p prefix.<rank>. This includes the solution history
+         *   stored by the transient solvers. Each processor writes only its
+         *   own file, so that no data is communicated and the cost does
+         *   not grow with the number of processors.
+         */
+        void write_checkpoint(const std::string& prefix,
+                              const std::vector<Real>& data = std::vector<Real>()) const;
+        
+        
+        /*!
+         *   reads the checkpoint written by write_checkpoint() into the
+         *   solution, the time and the vectors of the system. Vectors that do
+         *   not exist in the system are added. The checkpoint must have been
+         *   written with the same number of processors and the same
+         *   partitioning of the dofs. If \p data is provided, it is set to
+         *   the values given to write_checkpoint().
+         */
+        void read_checkpoint(const std::string& prefix,
+                             std::vector<Real>* data = nullptr);
+        
+        
+        /*!
+         *   writes the setup of the initialized system to the binary file
+         *   \p prefix.<rank>: the checksum of the dof distribution, the send
+         *   list, and the number of nonzeros in the local rows of the
+         *   matrices. See MAST::SetupSnapshot.
+         */
+        void write_setup_snapshot(const std::string& prefix) const;
+        
+        
+        /*!
+         *   reads the setup written by write_setup_snapshot(), and must be
+         *   called before the system is initialized. If the dof
+         *   distribution and send list at initialization are the same as
+         *   in the snapshot, the matrices are preallocated from the stored
+         *   nonzeros, and the sparsity pattern is not computed. Otherwise,
+         *   the snapshot is discarded with a warning. The snapshot must
+         *   have been written with the same number of processors.
+         */
+        void read_setup_snapshot(const std::string& prefix);
+        
+        
+        /*!
+         *   @returns true if the matrices were preallocated from a setup
+         *   snapshot at the last initialization
+         */
+        bool if_setup_snapshot_used() const {
+            return _setup_snapshot_used;
+        }
+        
+        
+        /*!
+         *   sets the memory report in which a phase is recorded at the end
+         *   of solve(), eigenproblem_solve(), sensitivity_solve() and
+         *   adjoint_solve(). The report must exist as long as it is
+         *   attached, and \p nullptr detaches it.
+         */
+        void set_memory_report(MAST::MemoryReport* r) {
+            _memory_report = r;
+        }
+        
+        
+        /*!
+         *   adds the bytes of the matrices, the preconditioner and
+         *   sensitivity factorizations, and the vectors of this system to
+         *   \p r, with the name of the system as the name of the object.
+         */
+        virtual void report_memory(MAST::MemoryReport& r) const;
+        
     protected:
         
         
@@ -270,6 +820,21 @@ namespace MAST {
         virtual void init_data () libmesh_override;
         
         
+        /*!
+         *   initializes the matrices of the parent class, with the
+         *   preallocation of the setup snapshot if it matches the dof
+         *   distribution
+         */
+        virtual void init_matrices () libmesh_override;
+        
+        
+        /*!
+         *   initializes \p m with the number of nonzeros of the setup
+         *   snapshot
+         */
+        void _init_matrix_from_setup_snapshot(libMesh::SparseMatrix<Real>& m);
+        
+        
         /**
          * Set the _n_converged_eigenpairs member, useful for
          * subclasses of EigenSystem.
@@ -335,10 +900,11 @@ namespace MAST {
         MAST::EigenSystemAssembly *        _eigenproblem_assemble_system_object;
 
         /*!
-         *    OutputAssemblyBase object for which the adjoint calculation
-         *    is being solved
+         *    OutputAssemblyBase objects for which the adjoint calculation
+         *    is being solved. The i^th object provides the RHS of the
+         *    i^th adjoint problem.
          */
-        MAST::OutputAssemblyBase*       _output;
+        std::vector<MAST::OutputAssemblyBase*>  _outputs;
         
         /**
          * Vector storing the local dof indices that will not be condensed.
@@ -347,6 +913,290 @@ namespace MAST {
          */
         std::vector<libMesh::dof_id_type>  _local_non_condensed_dofs_vector;
         
+        /*!
+         *   condensed eigenproblem matrices, which are created at the first
+         *   solve with condensed dofs and updated in place with
+         *   \p MAT_REUSE_MATRIX for subsequent solves
+         */
+        std::auto_ptr<libMesh::SparseMatrix<Real> >
+        _condensed_matrix_A,
+        _condensed_matrix_B;
+        
+        /*!
+         *   flag to apply the Jacobian in a matrix-free manner
+         */
+        bool                               _matrix_free_jacobian;
+        
+        /*!
+         *   assembly used for the preconditioner when the Jacobian is
+         *   matrix-free. If nullptr, the residual assembly is used.
+         */
+        MAST::NonlinearImplicitAssembly*   _preconditioner_assembly;
+        
+        /*!
+         *   shell matrix for the matrix-free Jacobian
+         */
+        Mat                                _mf_jac;
+        
+        /*!
+         *   solution about which the matrix-free Jacobian is linearized
+         */
+        std::auto_ptr<libMesh::NumericVector<Real> > _mf_X;
+        
+        /*!
+         *   object that replaces the Jacobian of the nonlinear solver
+         *   with the shell matrix before each solve
+         */
+        std::auto_ptr<libMesh::SolverConfiguration>  _mf_solver_configuration;
+        
+        /*!
+         *   assembles the Jacobian about the current solution and sets up
+         *   \p _sensitivity_ksp, unless it was already setup about the
+         *   same solution.
+         */
+        void _setup_sensitivity_ksp();
+        
+        /*!
+         *   releases \p _sensitivity_ksp after a solve, unless it is
+         *   retained with set_reuse_sensitivity_factorization(). With
+         *   Krylov recycling, the KSP is kept for its deflation subspace,
+         *   and only its operator is setup again for the next solve.
+         */
+        void _release_sensitivity_ksp();
+        
+        /*!
+         *   sets \p ksp to the GCRO-DR method of \p KSPHPDDM with the
+         *   recycled subspace size of this system, unless a different
+         *   type or size is set on the command line for its prefix.
+         */
+        void _configure_krylov_recycling(KSP ksp);
+        
+        /*!
+         *   solves the system with \p _sensitivity_ksp for each vector in
+         *   \p rhs, and returns the solutions in the vectors of \p sol,
+         *   on which the homogeneous constraints are enforced. A single
+         *   MatMatSolve is used for all vectors if enabled with
+         *   set_mat_mat_sensitivity_solve(). The KSP must be setup.
+         */
+        std::pair<unsigned int, Real>
+        _solve_with_sensitivity_ksp(const std::vector<libMesh::NumericVector<Real>*>& rhs,
+                                    std::vector<libMesh::NumericVector<Real>*>& sol);
+        
+        /*!
+         *   solves for all vectors in \p rhs with a single MatMatSolve on
+         *   the factored matrix \p F, and returns the solutions in \p sol
+         */
+        void _mat_mat_solve_all(Mat F,
+                                const std::vector<libMesh::NumericVector<Real>*>& rhs,
+                                std::vector<libMesh::NumericVector<Real>*>& sol);
+        
+        /*!
+         *   called by the DofMap with the sparsity pattern of the system,
+         *   from which the number of nonzero blocks in each local block
+         *   row is stored in the system passed in \p ctx. Only the upper
+         *   triangle is counted for the symmetric format.
+         */
+        static void
+        _matrix_sparsity(libMesh::SparsityPattern::Graph& sparsity,
+                         std::vector<libMesh::dof_id_type>& n_nz,
+                         std::vector<libMesh::dof_id_type>& n_oz,
+                         void* ctx);
+        
+        /*!
+         *   replaces the PETSc matrix of \p m with a matrix in the
+         *   blocked and/or symmetric format, preallocated from the
+         *   sparsity pattern
+         */
+        void _init_matrix_storage(libMesh::SparseMatrix<Real>& m);
+        
+        /*!
+         *   destroys the matrices created by _init_matrix_storage() and
+         *   gives the matrix objects back their original PETSc matrix
+         *   handle, so that libMesh can clear or reinitialize them
+         */
+        void _clear_matrix_storage();
+        
+        /*!
+         *   deletes the objects for direct insertion of element matrices
+         */
+        void _clear_matrix_scatter();
+        
+        /*!
+         *   computes the checksum of the dof distribution in \p sig, which
+         *   is used to identify an unchanged matrix structure
+         */
+        void _dof_distribution_signature(std::vector<libMesh::dof_id_type>& sig) const;
+        
+        /*!
+         *   zeroes the matrices and sets \p MAT_NEW_NONZERO_LOCATION_ERR,
+         *   so that the assembly can only add to existing nonzeros
+         */
+        void _zero_matrices_with_fixed_structure();
+        
+        /*!
+         *   dof indices and side boundary ids of the local elements
+         */
+        MAST::ElementTopologyCache         _topology_cache;
+        
+        /*!
+         *   list of loaded element sides, rebuilt with the topology cache
+         */
+        MAST::WettedSurface*               _wetted_surface;
+        
+        /*!
+         *   flag for direct insertion of the element matrices, and the
+         *   positions of the element entries in each matrix
+         */
+        bool                               _direct_matrix_insertion;
+        
+        std::map<const libMesh::SparseMatrix<Real>*, MAST::ElementMatrixScatter*>
+        _matrix_scatter;
+        
+        /*!
+         *   flag to reuse the matrix structure in reinit()
+         */
+        bool                               _reuse_matrix_structure;
+        
+        /*!
+         *   checksum of the dof distribution for which the matrices
+         *   were initialized
+         */
+        std::vector<libMesh::dof_id_type>  _matrix_structure_signature;
+        
+        /*!
+         *   data read by read_setup_snapshot(): the checksum of the dof
+         *   distribution, the send list, the number of nonzeros of the
+         *   local rows in the diagonal and off-diagonal blocks, and the
+         *   number of nonzero blocks of the blocked or symmetric storage
+         */
+        std::vector<libMesh::dof_id_type>  _snapshot_signature,
+        _snapshot_send_list,
+        _snapshot_n_nz,
+        _snapshot_n_oz,
+        _snapshot_storage_d_nnz,
+        _snapshot_storage_o_nnz;
+        
+        /*!
+         *   flags for a setup snapshot that was read, and that was used
+         *   for the current matrices
+         */
+        bool                               _setup_snapshot_loaded;
+        
+        bool                               _setup_snapshot_used;
+        
+        /*!
+         *   flag to store the matrices in the symmetric format
+         */
+        bool                               _symmetric_matrices;
+        
+        /*!
+         *   flag to store the matrices in the blocked format
+         */
+        bool                               _blocked_matrices;
+        
+        /*!
+         *   PETSc type of the matrices, or empty for the default storage
+         */
+        std::string                        _matrix_type;
+        
+        /*!
+         *   @returns true if the matrices are created by
+         *   _init_matrix_storage() instead of libMesh
+         */
+        bool _custom_matrix_storage() const {
+            return _symmetric_matrices || _blocked_matrices || !_matrix_type.empty();
+        }
+        
+        /*!
+         *   number of nonzero blocks in each local block row, in the
+         *   diagonal and off-diagonal parts of the matrix
+         */
+        std::vector<PetscInt>              _storage_d_nnz, _storage_o_nnz;
+        
+        /*!
+         *   matrices that use the blocked or symmetric format, along with
+         *   the object that holds their original PETSc matrix handle
+         */
+        std::vector<std::pair<libMesh::SparseMatrix<Real>*, libMesh::SparseMatrix<Real>*> >
+        _storage_mats;
+        
+        /*!
+         *   function that computes the near null space vectors
+         */
+        libMesh::NonlinearImplicitSystem::ComputeVectorSubspace* _near_null_space_function;
+        
+        /*!
+         *   near null space attached to the matrices, created at the
+         *   first solve after initialization
+         */
+        MatNullSpace                       _near_null_space;
+        
+        /*!
+         *   geometric multigrid preconditioner, if provided
+         */
+        MAST::GeometricMultigrid*          _multigrid;
+        
+        /*!
+         *   single precision ILU preconditioner, if provided
+         */
+        MAST::SinglePrecisionILU*          _single_precision_pc;
+        
+        /*!
+         *   BDDC preconditioner, if provided
+         */
+        MAST::BDDCPreconditioner*          _bddc_pc;
+        
+        /*!
+         *   configuration of the direct solver, if provided
+         */
+        const MAST::HybridParallelConfiguration* _parallel_config;
+        
+        /*!
+         *   flag to retain the sensitivity KSP between sensitivity solves
+         */
+        bool                               _reuse_sensitivity_factorization;
+        
+        /*!
+         *   flag to solve for all sensitivity RHS with a MatMatSolve
+         */
+        bool                               _mat_mat_sensitivity_solve;
+        
+        /*!
+         *   KSP used for the sensitivity solves
+         */
+        KSP                                _sensitivity_ksp;
+        
+        /*!
+         *   solution about which the Jacobian of \p _sensitivity_ksp was
+         *   assembled
+         */
+        std::auto_ptr<libMesh::NumericVector<Real> > _sensitivity_X;
+        
+        /*!
+         *   flag to retain a deflation subspace between Krylov solves, and
+         *   the size of the subspace
+         */
+        bool                               _krylov_recycling;
+        
+        unsigned int                       _n_recycle;
+        
+        /*!
+         *   KSP used for the adjoint solves, which is retained between
+         *   solves for Krylov recycling
+         */
+        KSP                                _adjoint_ksp;
+        
+        /*!
+         *   KSP used by eigenproblem_reanalysis(), whose preconditioner is
+         *   retained from the design for which it was setup
+         */
+        KSP                                _reanalysis_ksp;
+        
+        /*!
+         *   memory report in which the solves are recorded
+         */
+        MAST::MemoryReport*                _memory_report;
+        
     };
 }
 
@@ -17,11 +17,19 @@
  * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
  */
 
+// C++ includes
+#include <limits>
+
+
 // MAST includes
 #include "base/output_assembly_base.h"
 #include "base/system_initialization.h"
 
 
+// libMesh includes
+#include "libmesh/numeric_vector.h"
+
+
 
 
 MAST::OutputAssemblyBase::OutputAssemblyBase():
@@ -42,6 +50,12 @@ void
 MAST::OutputAssemblyBase::
 clear_discipline_and_system() {
     
+    // the element objects, localized vectors and output element lists
+    // refer to the system, and are no longer valid
+    this->clear_elem_objects();
+    this->clear_output_elems();
+    this->clear_localized_vectors();
+    
     if (_system && _discipline) {
         MAST::NonlinearSystem& sys = _system->system();
         
@@ -53,5 +67,42 @@ clear_discipline_and_system() {
 
 
 
-
+void
+MAST::OutputAssemblyBase::
+assemble_output_hessian_product(const libMesh::NumericVector<Real>& X,
+                                const libMesh::NumericVector<Real>& dX,
+                                libMesh::NumericVector<Real>& res) {
+    
+    res.zero();
+    
+    const Real
+    dX_norm = dX.l2_norm();
+    
+    if (dX_norm == 0.) {
+        
+        res.close();
+        return;
+    }
+    
+    // step of the central difference relative to the magnitude of the
+    // solution
+    const Real
+    h = sqrt(std::numeric_limits<Real>::epsilon()) * (1. + X.l2_norm()) / dX_norm;
+    
+    std::auto_ptr<libMesh::NumericVector<Real> >
+    X_p    (X.clone().release()),
+    res_m  (res.zero_clone().release());
+    
+    X_p->add(h, dX);
+    X_p->close();
+    this->assemble_output_derivative(*X_p, res);
+    
+    X_p->add(-2.*h, dX);
+    X_p->close();
+    this->assemble_output_derivative(*X_p, *res_m);
+    
+    res.add(-1., *res_m);
+    res.scale(0.5/h);
+    res.close();
+}
 
@@ -26,6 +26,9 @@
 
 namespace MAST {
     
+    // Forward declerations
+    class ElementwiseDesignField;
+    
     
     class OutputAssemblyBase:
     public MAST::AssemblyBase {
@@ -43,6 +46,46 @@ namespace MAST {
         clear_discipline_and_system( );
         
         
+        /*!
+         *   assembles the derivative of the output with respect to the
+         *   solution \p X in \p dq_dX. This is used as the RHS of the
+         *   adjoint problem in MAST::NonlinearSystem::adjoint_solve().
+         *   The constraints on the dofs should be applied to the element
+         *   vectors before they are added to \p dq_dX.
+         */
+        virtual void
+        assemble_output_derivative(const libMesh::NumericVector<Real>& X,
+                                   libMesh::NumericVector<Real>& dq_dX) = 0;
+        
+        
+        /*!
+         *   calculates the product of the Hessian of the output with respect
+         *   to the solution about \p X and \p dX in \p res. The default
+         *   implementation uses a central difference of
+         *   assemble_output_derivative() along \p dX. Outputs with an
+         *   analytical second derivative can reimplement this.
+         */
+        virtual void
+        assemble_output_hessian_product(const libMesh::NumericVector<Real>& X,
+                                        const libMesh::NumericVector<Real>& dX,
+                                        libMesh::NumericVector<Real>& res);
+        
+        
+        /*!
+         *   adds to \p sens the partial derivative of the output about the
+         *   solution \p X with respect to the design value of each local
+         *   element of \p f, at MAST::ElementwiseDesignField::dof_index() of
+         *   the element. This is used by
+         *   MAST::NonlinearImplicitAssembly::calculate_elementwise_output_sensitivity().
+         *   The default implementation adds nothing, which is the case for
+         *   outputs that depend on the design values only through the
+         *   solution.
+         */
+        virtual void
+        add_elementwise_output_partial_sensitivity(const libMesh::NumericVector<Real>& X,
+                                                   const MAST::ElementwiseDesignField& f,
+                                                   libMesh::NumericVector<Real>& sens) { }
+        
         
     protected:
         
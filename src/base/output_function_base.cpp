@@ -22,7 +22,9 @@
 
 MAST::OutputFunctionBase::OutputFunctionBase(MAST::OutputQuantityType t):
 _type(t),
-_eval_mode(MAST::CENTROID) {
+_eval_mode(MAST::CENTROID),
+_if_sensitivity_active(true),
+_elem_subset_modification_count(0) {
     
 }
 
@@ -22,6 +22,8 @@
 
 // C++ includes
 #include <vector>
+#include <set>
+#include <memory>
 
 // MAST includes
 
@@ -29,6 +31,11 @@
 #include "libmesh/point.h"
 
 
+namespace libMesh {
+    class Elem;
+}
+
+
 
 namespace MAST {
     
@@ -98,6 +105,80 @@ namespace MAST {
             return _eval_mode;
         }
         
+        
+        /*!
+         *   @returns a pointer to the set of elements for which this output
+         *   is evaluated, or \p nullptr if it is evaluated for all elements
+         *   in its subdomain. This is used by the assembly to visit only
+         *   these elements when evaluating the outputs.
+         */
+        virtual const std::set<const libMesh::Elem*>*
+        get_elem_subset_for_evaluation() const {
+            
+            return nullptr;
+        }
+        
+        
+        /*!
+         *   @returns the number of modifications of the element subset
+         *   returned by get_elem_subset_for_evaluation(). The assembly
+         *   uses this to find out if its list of elements for this output
+         *   is still valid.
+         */
+        unsigned int elem_subset_modification_count() const {
+            
+            return _elem_subset_modification_count;
+        }
+        
+        
+        /*!
+         *   if \p f is false, the sensitivity of this output is not
+         *   computed by the output sensitivity analysis of the assembly,
+         *   for example for inactive constraints of an optimization. The
+         *   values of the output are still computed. This is true by
+         *   default.
+         */
+        void set_sensitivity_active(bool f) {
+            
+            _if_sensitivity_active = f;
+        }
+        
+        
+        /*!
+         *   @returns true if the sensitivity of this output is computed
+         */
+        bool if_sensitivity_active() const {
+            
+            return _if_sensitivity_active;
+        }
+        
+        
+        /*!
+         *   @returns a new output object with the settings of this output
+         *   and no data, in which a thread stores the data of the elements
+         *   that it evaluates. This is used by the threaded evaluation of
+         *   outputs in MAST::AssemblyBase::calculate_outputs(). The default
+         *   implementation returns an empty pointer, for outputs that do not
+         *   support this, and the outputs are then evaluated serially.
+         */
+        virtual std::auto_ptr<MAST::OutputFunctionBase>
+        build_thread_local_copy() const {
+            
+            return std::auto_ptr<MAST::OutputFunctionBase>();
+        }
+        
+        
+        /*!
+         *   adds the data of element \p e from \p local, which was created
+         *   by build_thread_local_copy(), to this output, as if the element
+         *   had been evaluated for this output.
+         */
+        virtual void
+        add_thread_local_data(const MAST::OutputFunctionBase& local,
+                              const libMesh::Elem& e) {
+            
+            libmesh_error();
+        }
 
         
         
@@ -114,6 +195,17 @@ namespace MAST {
         
         MAST::PointwiseOutputEvaluationMode _eval_mode;
         
+        /*!
+         *   flag to compute the sensitivity of this output
+         */
+        bool _if_sensitivity_active;
+        
+        /*!
+         *   number of modifications of the element subset, which is
+         *   incremented by the derived classes that change the subset
+         */
+        unsigned int _elem_subset_modification_count;
+        
     };
 }
 
@@ -20,6 +20,9 @@
 #ifndef __mast__parameter__
 #define __mast__parameter__
 
+// C++ includes
+#include <mutex>
+
 
 // MAST includes
 #include "base/function_base.h"
@@ -38,13 +41,15 @@ namespace MAST {
         Parameter(const std::string& nm,
                   const Real& val):
         MAST::FunctionBase(nm, false),
-        _val(new Real)
+        _val(new Real),
+        _version_val(val)
         { *_val = val;}
 
         
         Parameter(const MAST::Parameter& f):
         MAST::FunctionBase(f),
-        _val(f._val)
+        _val(f._val),
+        _version_val(f._version_val)
         { }
         
 
@@ -94,8 +99,31 @@ namespace MAST {
         /*!
          *  sets the value of this function
          */
-        void operator =(const Real& val)
-        {   *_val = val; }
+        void operator =(const Real& val) {
+            
+            std::lock_guard<std::mutex> lock(_version_mutex);
+            if (*_val != val)
+                _version++;
+            *_val        = val;
+            _version_val = val;
+        }
+        
+        
+        /*!
+         *  @returns the version of this parameter, which changes with each
+         *  modification of the value. Since the value can also be modified
+         *  through the reference from operator() and through ptr(), the
+         *  value is compared with that of the last version.
+         */
+        virtual unsigned long long version() const {
+            
+            std::lock_guard<std::mutex> lock(_version_mutex);
+            if (*_val != _version_val) {
+                _version++;
+                _version_val = *_val;
+            }
+            return _version;
+        }
         
         
     protected:
@@ -104,6 +132,14 @@ namespace MAST {
          *    Pointer to the value of the parameter
          */
         Real* _val;
+        
+        /*!
+         *    value of the parameter for the current version, and the
+         *    mutex for the update of the version from parallel threads
+         */
+        mutable Real       _version_val;
+        
+        mutable std::mutex _version_mutex;
     };
 }
 
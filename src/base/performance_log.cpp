@@ -0,0 +1,164 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2017  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+// C++ includes
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+
+// MAST includes
+#include "base/performance_log.h"
+
+
+MAST::PerformanceLog MAST::perf_log;
+
+
+
+MAST::PerformanceLog::PerformanceLog():
+_enabled(false) {
+    
+}
+
+
+
+MAST::PerformanceLog::~PerformanceLog() {
+    
+}
+
+
+
+MAST::PerformanceLog::Event&
+MAST::PerformanceLog::register_event(const std::string& event,
+                                     const std::string& header) {
+    
+    std::lock_guard<std::mutex> lock(_mutex);
+    
+    std::deque<Event>::iterator
+    it   = _events.begin(),
+    end  = _events.end();
+    
+    for ( ; it != end; it++)
+        if (it->event == event && it->header == header)
+            return *it;
+    
+    _events.emplace_back(event, header);
+    
+    return _events.back();
+}
+
+
+
+void
+MAST::PerformanceLog::reset() {
+    
+    std::lock_guard<std::mutex> lock(_mutex);
+    
+    std::deque<Event>::iterator
+    it   = _events.begin(),
+    end  = _events.end();
+    
+    for ( ; it != end; it++) {
+        it->count.store(0);
+        it->ns.store(0);
+    }
+}
+
+
+
+void
+MAST::PerformanceLog::
+write_summary(std::ostream& out,
+              MAST::PerformanceLog::SummaryFormat format,
+              unsigned int rank) const {
+    
+    std::lock_guard<std::mutex> lock(_mutex);
+    
+    std::deque<Event>::const_iterator
+    it   = _events.begin(),
+    end  = _events.end();
+    
+    out << std::setprecision(9);
+    
+    switch (format) {
+            
+        case MAST::PerformanceLog::JSON: {
+            
+            out << "{\n"
+            << "  \"rank\": " << rank << ",\n"
+            << "  \"events\": [";
+            
+            bool first = true;
+            for ( ; it != end; it++) {
+                
+                // skip the events that were never recorded
+                if (!it->count.load())
+                    continue;
+                
+                out << (first?"\n":",\n")
+                << "    {\"header\": \"" << it->header << "\", "
+                << "\"event\": \"" << it->event << "\", "
+                << "\"count\": " << it->count.load() << ", "
+                << "\"time\": " << 1.e-9 * it->ns.load() << "}";
+                first = false;
+            }
+            
+            out << "\n  ]\n}" << std::endl;
+        }
+            break;
+            
+        case MAST::PerformanceLog::CSV: {
+            
+            out << "rank,header,event,count,time" << std::endl;
+            
+            for ( ; it != end; it++)
+                if (it->count.load())
+                    out
+                    << rank << ","
+                    << it->header << ","
+                    << it->event << ","
+                    << it->count.load() << ","
+                    << 1.e-9 * it->ns.load() << std::endl;
+        }
+            break;
+            
+        default:
+            libmesh_error(); // should not get here
+    }
+}
+
+
+
+void
+MAST::PerformanceLog::
+write_summary(const libMesh::Parallel::Communicator& comm,
+              const std::string& prefix,
+              MAST::PerformanceLog::SummaryFormat format) const {
+    
+    if (!this->enabled())
+        return;
+    
+    std::ostringstream nm;
+    nm << prefix << "." << comm.rank()
+    << ((format == MAST::PerformanceLog::JSON)? ".json" : ".csv");
+    
+    std::ofstream out(nm.str().c_str());
+    this->write_summary(out, format, comm.rank());
+    out.close();
+}
+
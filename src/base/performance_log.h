@@ -0,0 +1,225 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2017  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef __mast__performance_log__
+#define __mast__performance_log__
+
+// C++ includes
+#include <string>
+#include <deque>
+#include <atomic>
+#include <mutex>
+#include <chrono>
+#include <ostream>
+
+
+// libMesh includes
+#include "libmesh/parallel.h"
+
+
+namespace MAST {
+
+    /*!
+     *   Thread-safe, low overhead log of the time spent in the main phases
+     *   of a MAST analysis: element kernels, constraint application,
+     *   global assembly, localization, solver calls, etc. Unlike the
+     *   libMesh PerfLog, the scopes of this log can be used inside the
+     *   threaded element loops. Each event is registered once per
+     *   instrumented site (see \p MAST_LOG_SCOPE), and the log is disabled
+     *   by default, in which case a scope costs a single flag check.
+     *   A per-rank summary can be written in JSON or CSV format.
+     */
+    class PerformanceLog {
+
+    public:
+
+        /*!
+         *   format of the summary written by \p write_summary
+         */
+        enum SummaryFormat {
+            JSON,
+            CSV
+        };
+
+
+        /*!
+         *   accumulated data of a registered event
+         */
+        struct Event {
+
+            Event(const std::string& e, const std::string& h):
+            event(e), header(h), count(0), ns(0) { }
+
+            std::string                           event;
+            std::string                           header;
+            std::atomic<unsigned long long>       count;
+            std::atomic<unsigned long long>       ns;
+        };
+
+
+        PerformanceLog();
+
+
+        virtual ~PerformanceLog();
+
+
+        /*!
+         *   turns on/off the logging. Scopes that are entered while the log
+         *   is disabled are not recorded.
+         */
+        void enable(bool f = true) {
+            _enabled.store(f, std::memory_order_relaxed);
+        }
+
+
+        void disable() { this->enable(false); }
+
+
+        bool enabled() const {
+            return _enabled.load(std::memory_order_relaxed);
+        }
+
+
+        /*!
+         *   registers the \p event in \p header and returns the object used
+         *   to record its times. Registering an existing event returns the
+         *   existing object.
+         */
+        MAST::PerformanceLog::Event&
+        register_event(const std::string& event,
+                       const std::string& header);
+
+
+        /*!
+         *   adds \p ns nanoseconds to \p d and increments its count.
+         */
+        void add(MAST::PerformanceLog::Event& d, unsigned long long ns) {
+            d.count.fetch_add(1, std::memory_order_relaxed);
+            d.ns.fetch_add(ns, std::memory_order_relaxed);
+        }
+
+
+        /*!
+         *   zeros the counts and times of all events
+         */
+        void reset();
+
+
+        /*!
+         *   writes the summary of events on this processor to \p out.
+         *   \p rank is only used to label the output.
+         */
+        void write_summary(std::ostream& out,
+                           MAST::PerformanceLog::SummaryFormat format,
+                           unsigned int rank) const;
+
+
+        /*!
+         *   writes the summary on each processor of \p comm to the file
+         *   \p prefix.<rank>.json (or .csv). Nothing is written if the
+         *   log is disabled.
+         */
+        void write_summary(const libMesh::Parallel::Communicator& comm,
+                           const std::string& prefix,
+                           MAST::PerformanceLog::SummaryFormat format) const;
+
+
+    protected:
+
+        /*!
+         *   flag to turn the logging on/off
+         */
+        std::atomic<bool>        _enabled;
+
+        /*!
+         *   registered events. A deque is used so that references to
+         *   existing events stay valid when new ones are registered.
+         *   Access is guarded by \p _mutex.
+         */
+        std::deque<Event>        _events;
+
+        /*!
+         *   mutex for event registration
+         */
+        mutable std::mutex       _mutex;
+    };
+
+
+    /*!
+     *   the log used by all instrumented scopes in MAST
+     */
+    extern MAST::PerformanceLog perf_log;
+
+
+    /*!
+     *   records the time between construction and destruction in
+     *   \p MAST::perf_log, if the log is enabled at construction.
+     */
+    class PerformanceLogScope {
+
+    public:
+
+        PerformanceLogScope(MAST::PerformanceLog::Event& e):
+        _event(e),
+        _active(MAST::perf_log.enabled()) {
+
+            if (_active)
+                _t0 = std::chrono::steady_clock::now();
+        }
+
+
+        ~PerformanceLogScope() {
+
+            if (_active)
+                MAST::perf_log.add
+                (_event,
+                 std::chrono::duration_cast<std::chrono::nanoseconds>
+                 (std::chrono::steady_clock::now() - _t0).count());
+        }
+
+    protected:
+
+        MAST::PerformanceLog::Event&             _event;
+
+        bool                                     _active;
+
+        std::chrono::steady_clock::time_point    _t0;
+    };
+}
+
+
+
+#define MAST_LOG_CONCAT_IMPL_(a, b)     a##b
+#define MAST_LOG_CONCAT_(a, b)          MAST_LOG_CONCAT_IMPL_(a, b)
+
+/*!
+ *   records the time spent in the enclosing scope as \p event in
+ *   \p header. Both must be fixed for a given site, since the event is
+ *   registered only the first time the site is reached.
+ */
+#define MAST_LOG_SCOPE(event, header)                                       \
+static MAST::PerformanceLog::Event&                                         \
+MAST_LOG_CONCAT_(mast_log_event_, __LINE__) =                               \
+MAST::perf_log.register_event(event, header);                               \
+MAST::PerformanceLogScope                                                   \
+MAST_LOG_CONCAT_(mast_log_scope_, __LINE__)                                 \
+(MAST_LOG_CONCAT_(mast_log_event_, __LINE__))
+
+
+#endif // __mast__performance_log__
@@ -21,6 +21,8 @@
 #include "base/physics_discipline_base.h"
 #include "base/system_initialization.h"
 #include "base/parameter.h"
+#include "base/boundary_condition_base.h"
+#include "property_cards/element_property_card_base.h"
 #include "boundary_condition/dirichlet_boundary_condition.h"
 
 // libMesh includes
@@ -29,12 +31,14 @@
 #include "libmesh/fe_interface.h"
 #include "libmesh/dirichlet_boundaries.h"
 #include "libmesh/elem.h"
+#include "libmesh/boundary_info.h"
 
 
 void
 MAST::PhysicsDisciplineBase::clear_loads() {
     _side_bc_map.clear();
     _vol_bc_map.clear();
+    _parameter_dependency.clear();
 }
 
 
@@ -51,6 +55,7 @@ MAST::PhysicsDisciplineBase::add_side_load(libMesh::boundary_id_type bid,
     
     // displacement boundary condition needs to be hadled separately
     _side_bc_map.insert(MAST::SideBCMapType::value_type(bid, &load));
+    _parameter_dependency.clear();
 }
 
 
@@ -97,6 +102,7 @@ MAST::PhysicsDisciplineBase::add_volume_load(libMesh::subdomain_id_type sid,
         libmesh_assert(it.first->second != &load);
     
     _vol_bc_map.insert(MAST::VolumeBCMapType::value_type(sid, &load));
+    _parameter_dependency.clear();
 }
 
 
@@ -119,7 +125,7 @@ MAST::PhysicsDisciplineBase::add_volume_output(libMesh::subdomain_id_type sid,
 void
 MAST::PhysicsDisciplineBase::add_point_load(MAST::PointLoadCondition& load) {
 
-    libmesh_assert(_point_loads.count(&load));
+    libmesh_assert(!_point_loads.count(&load));
     
     _point_loads.insert(&load);
 }
@@ -135,6 +141,7 @@ MAST::PhysicsDisciplineBase::clear_volume_load(libMesh::subdomain_id_type bid,
     for ( ; it.first != it.second; it.first++)
         if (it.first->second == &load) {
             _vol_bc_map.erase(it.first);
+            _parameter_dependency.clear();
             return;
         }
     
@@ -153,6 +160,7 @@ set_property_for_subdomain(const libMesh::subdomain_id_type sid,
     libmesh_assert(elem_p_it == _element_property.end());
     
     _element_property[sid] = &prop;
+    _parameter_dependency.clear();
 }
 
 
@@ -205,8 +213,11 @@ MAST::PhysicsDisciplineBase::remove_parameter(MAST::Parameter& f) {
     std::map<const Real*, const MAST::FunctionBase*>::iterator
     it = _parameter_map.find(f.ptr());
     
-    if (it != _parameter_map.end())
+    if (it != _parameter_map.end()) {
+        
+        _parameter_dependency.erase(it->second);
         _parameter_map.erase(it);
+    }
 }
 
 
@@ -228,6 +239,256 @@ MAST::PhysicsDisciplineBase::get_parameter(const Real* par) const {
 
 
 
+bool
+MAST::PhysicsDisciplineBase::elem_depends_on(const libMesh::Elem& elem,
+                                             const MAST::FunctionBase& f) const {
+    
+    const MAST::PhysicsDisciplineBase::ParameterDependency&
+    dep = _get_parameter_dependency(f);
+    
+    if (dep.all_elems ||
+        dep.subdomains.count(elem.subdomain_id()))
+        return true;
+    
+    // check the boundaries of the element sides
+    if (dep.boundaries.size()) {
+        
+        const libMesh::BoundaryInfo&
+        binfo = *_eq_systems.get_mesh().boundary_info;
+        
+        for (unsigned short int n=0; n<elem.n_sides(); n++) {
+            
+            if (!binfo.n_boundary_ids(&elem, n))
+                continue;
+            
+            std::vector<libMesh::boundary_id_type> bc_ids = binfo.boundary_ids(&elem, n);
+            
+            for (unsigned int i=0; i<bc_ids.size(); i++)
+                if (dep.boundaries.count(bc_ids[i]))
+                    return true;
+        }
+    }
+    
+    return false;
+}
+
+
+
+const std::vector<const libMesh::Elem*>&
+MAST::PhysicsDisciplineBase::
+get_dependent_local_elems(const MAST::FunctionBase& f) const {
+    
+    return _get_parameter_dependency(f).local_elems;
+}
+
+
+
+void
+MAST::PhysicsDisciplineBase::init_parameter_dependency() const {
+    
+    std::lock_guard<std::mutex> lock(_parameter_dependency_mutex);
+    _init_all_parameter_dependency();
+}
+
+
+
+void
+MAST::PhysicsDisciplineBase::_init_all_parameter_dependency() const {
+    
+    // this is called with _parameter_dependency_mutex locked
+    std::vector<const MAST::FunctionBase*> fs;
+    
+    std::map<const Real*, const MAST::FunctionBase*>::const_iterator
+    it  = _parameter_map.begin(),
+    end = _parameter_map.end();
+    
+    for ( ; it != end; it++)
+        if (!_parameter_dependency.count(it->second))
+            fs.push_back(it->second);
+    
+    _init_parameter_dependency(fs);
+}
+
+
+
+const MAST::PhysicsDisciplineBase::ParameterDependency&
+MAST::PhysicsDisciplineBase::
+_get_parameter_dependency(const MAST::FunctionBase& f) const {
+    
+    // the map is filled on demand, possibly from the threads of an
+    // assembly loop. References to its entries remain valid as it grows.
+    std::lock_guard<std::mutex> lock(_parameter_dependency_mutex);
+    
+    std::map<const MAST::FunctionBase*,
+    MAST::PhysicsDisciplineBase::ParameterDependency>::const_iterator
+    it = _parameter_dependency.find(&f);
+    
+    if (it == _parameter_dependency.end()) {
+        
+        // the dependency is computed for all parameters together, since
+        // it requires a pass over all property cards and elements.
+        _init_all_parameter_dependency();
+        
+        // f may not be one of the parameters of this discipline
+        it = _parameter_dependency.find(&f);
+        if (it == _parameter_dependency.end()) {
+            
+            _init_parameter_dependency(std::vector<const MAST::FunctionBase*>(1, &f));
+            it = _parameter_dependency.find(&f);
+        }
+    }
+    
+    return it->second;
+}
+
+
+
+void
+MAST::PhysicsDisciplineBase::
+_init_parameter_dependency(const std::vector<const MAST::FunctionBase*>& fs) const {
+    
+    const unsigned int n_fs = (unsigned int)fs.size();
+    
+    if (!n_fs)
+        return;
+    
+    std::vector<MAST::PhysicsDisciplineBase::ParameterDependency*> deps(n_fs);
+    
+    // shape parameters change the geometry of all elements
+    std::vector<unsigned int> all_elem_fs;
+    
+    for (unsigned int i=0; i<n_fs; i++) {
+        
+        deps[i] = &_parameter_dependency[fs[i]];
+        deps[i]->all_elems = fs[i]->is_shape_parameter();
+        
+        if (deps[i]->all_elems)
+            all_elem_fs.push_back(i);
+    }
+    
+    // functions that the quantities on each subdomain and boundary
+    // depend on
+    std::map<libMesh::subdomain_id_type, std::set<unsigned int> > sid_fs;
+    std::map<libMesh::boundary_id_type, std::set<unsigned int> >  bid_fs;
+    
+    {
+        MAST::PropertyCardMapType::const_iterator
+        it  = _element_property.begin(),
+        end = _element_property.end();
+        
+        for ( ; it != end; it++)
+            for (unsigned int i=0; i<n_fs; i++)
+                if (it->second->depends_on(*fs[i]))
+                    sid_fs[it->first].insert(i);
+    }
+    
+    {
+        MAST::VolumeBCMapType::const_iterator
+        it  = _vol_bc_map.begin(),
+        end = _vol_bc_map.end();
+        
+        for ( ; it != end; it++)
+            for (unsigned int i=0; i<n_fs; i++)
+                if (it->second->depends_on(*fs[i]))
+                    sid_fs[it->first].insert(i);
+    }
+    
+    {
+        MAST::SideBCMapType::const_iterator
+        it  = _side_bc_map.begin(),
+        end = _side_bc_map.end();
+        
+        for ( ; it != end; it++)
+            for (unsigned int i=0; i<n_fs; i++)
+                if (it->second->depends_on(*fs[i]))
+                    bid_fs[it->first].insert(i);
+    }
+    
+    // now identify the local elements on these subdomains and boundaries.
+    // Elements without a property card are included for all functions,
+    // since their dependency cannot be determined.
+    const libMesh::MeshBase& mesh = _eq_systems.get_mesh();
+    const libMesh::BoundaryInfo& binfo = *mesh.boundary_info;
+    
+    std::set<unsigned int> elem_fs;
+    std::set<unsigned int>::const_iterator f_it, f_end;
+    
+    libMesh::MeshBase::const_element_iterator       el     =
+    mesh.active_local_elements_begin();
+    const libMesh::MeshBase::const_element_iterator end_el =
+    mesh.active_local_elements_end();
+    
+    for ( ; el != end_el; ++el) {
+        
+        const libMesh::Elem* elem = *el;
+        const libMesh::subdomain_id_type sid = elem->subdomain_id();
+        
+        elem_fs.clear();
+        elem_fs.insert(all_elem_fs.begin(), all_elem_fs.end());
+        
+        if (!_element_property.count(sid)) {
+            
+            for (unsigned int i=0; i<n_fs; i++) {
+                
+                elem_fs.insert(i);
+                deps[i]->subdomains.insert(sid);
+            }
+        }
+        else if (sid_fs.count(sid)) {
+            
+            const std::set<unsigned int>& s = sid_fs[sid];
+            elem_fs.insert(s.begin(), s.end());
+        }
+        
+        if (bid_fs.size()) {
+            
+            for (unsigned short int n=0; n<elem->n_sides(); n++) {
+                
+                if (!binfo.n_boundary_ids(elem, n))
+                    continue;
+                
+                std::vector<libMesh::boundary_id_type> bc_ids = binfo.boundary_ids(elem, n);
+                
+                for (unsigned int i=0; i<bc_ids.size(); i++)
+                    if (bid_fs.count(bc_ids[i])) {
+                        
+                        const std::set<unsigned int>& s = bid_fs[bc_ids[i]];
+                        elem_fs.insert(s.begin(), s.end());
+                    }
+            }
+        }
+        
+        f_it  = elem_fs.begin();
+        f_end = elem_fs.end();
+        
+        for ( ; f_it != f_end; f_it++)
+            deps[*f_it]->local_elems.push_back(elem);
+    }
+    
+    // finally, copy the subdomain and boundary ids
+    {
+        std::map<libMesh::subdomain_id_type, std::set<unsigned int> >::const_iterator
+        it  = sid_fs.begin(),
+        end = sid_fs.end();
+        
+        for ( ; it != end; it++)
+            for (f_it = it->second.begin(); f_it != it->second.end(); f_it++)
+                deps[*f_it]->subdomains.insert(it->first);
+    }
+    
+    {
+        std::map<libMesh::boundary_id_type, std::set<unsigned int> >::const_iterator
+        it  = bid_fs.begin(),
+        end = bid_fs.end();
+        
+        for ( ; it != end; it++)
+            for (f_it = it->second.begin(); f_it != it->second.end(); f_it++)
+                deps[*f_it]->boundaries.insert(it->first);
+    }
+}
+
+
+
 void
 MAST::PhysicsDisciplineBase::
 init_system_dirichlet_bc(libMesh::System& sys) const {
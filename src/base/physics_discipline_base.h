@@ -22,6 +22,9 @@
 
 // C++ includes
 #include <map>
+#include <mutex>
+#include <set>
+#include <vector>
 
 // MAST includes
 #include "base/mast_data_types.h"
@@ -263,8 +266,106 @@ namespace MAST {
         const MAST::FunctionBase* get_parameter(const Real* par) const;
         
         
+        /*!
+         *   @returns the map of parameter values and the corresponding
+         *   functions added to this discipline
+         */
+        const std::map<const Real*, const MAST::FunctionBase*>&
+        get_parameter_map() const {
+            return _parameter_map;
+        }
+        
+        
+        /*!
+         *   @returns true if the quantities of element \p elem can depend on
+         *   \p f through its property card, its volume or side loads, or
+         *   if \p f is a shape parameter. If no property card is
+         *   available for the element, true is returned since the dependency
+         *   cannot be determined.
+         */
+        bool elem_depends_on(const libMesh::Elem& elem,
+                             const MAST::FunctionBase& f) const;
+        
+        
+        /*!
+         *   @returns the active local elements of the mesh whose quantities
+         *   can depend on \p f, as defined in elem_depends_on(). The list is
+         *   computed the first time it is requested for \p f, and is reused
+         *   until the property cards, loads or parameters of this discipline
+         *   are modified.
+         */
+        const std::vector<const libMesh::Elem*>&
+        get_dependent_local_elems(const MAST::FunctionBase& f) const;
+        
+        
+        /*!
+         *   computes the parameter-element dependency used by
+         *   elem_depends_on() and get_dependent_local_elems() for all
+         *   parameters added to this discipline, with a single pass over
+         *   the property cards, loads and local elements. This is
+         *   otherwise done on the first request for a parameter, which
+         *   may come from a threaded assembly loop.
+         */
+        void init_parameter_dependency() const;
+        
+        
+        /*!
+         *   clears the parameter-element dependency. This must be called
+         *   if the mesh is modified, or if the functions of the property
+         *   cards or loads are changed after they are added to this
+         *   discipline. MAST::AssemblyBase::clear_mesh_dependent_data()
+         *   calls this for the discipline of the assembly. This must not
+         *   be called while the element lists are in use.
+         */
+        void clear_parameter_dependency() const {
+            std::lock_guard<std::mutex> lock(_parameter_dependency_mutex);
+            _parameter_dependency.clear();
+        }
+        
+        
     protected:
         
+        /*!
+         *   subdomains and boundaries with quantities that depend on a
+         *   parameter, along with the active local elements that lie
+         *   in these subdomains or on these boundaries.
+         */
+        struct ParameterDependency {
+            
+            ParameterDependency(): all_elems(false) { }
+            
+            bool                                   all_elems;
+            std::set<libMesh::subdomain_id_type>   subdomains;
+            std::set<libMesh::boundary_id_type>    boundaries;
+            std::vector<const libMesh::Elem*>      local_elems;
+        };
+        
+        
+        /*!
+         *   @returns the dependency of the quantities in this discipline
+         *   on \p f, which is computed if it does not already exist.
+         */
+        const MAST::PhysicsDisciplineBase::ParameterDependency&
+        _get_parameter_dependency(const MAST::FunctionBase& f) const;
+        
+        
+        /*!
+         *   computes the dependency for all parameters of this discipline
+         *   that do not have one yet. This is called with
+         *   \p _parameter_dependency_mutex locked.
+         */
+        void _init_all_parameter_dependency() const;
+        
+        
+        /*!
+         *   computes the dependency of the quantities in this discipline
+         *   on each function in \p fs. This is called with
+         *   \p _parameter_dependency_mutex locked.
+         */
+        void
+        _init_parameter_dependency(const std::vector<const MAST::FunctionBase*>& fs) const;
+        
+        
         /*!
          *    libMesh::System for which analysis is to be performed
          */
@@ -281,6 +382,19 @@ namespace MAST {
          */
         std::map<const Real*, const MAST::FunctionBase*> _parameter_map;
         
+        /*!
+         *   dependency of the quantities in this discipline on the
+         *   parameters, computed on demand
+         */
+        mutable std::map<const MAST::FunctionBase*,
+        MAST::PhysicsDisciplineBase::ParameterDependency> _parameter_dependency;
+        
+        /*!
+         *   mutex for the computation of the dependency, which is
+         *   requested from the threaded assembly loops
+         */
+        mutable std::mutex _parameter_dependency_mutex;
+        
         /*!
          *   side boundary condition map of boundary id and load
          */
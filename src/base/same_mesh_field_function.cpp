@@ -0,0 +1,187 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2017  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+// MAST includes
+#include "base/same_mesh_field_function.h"
+#include "base/system_initialization.h"
+#include "base/nonlinear_system.h"
+#include "base/mesh_field_transfer_operator.h"
+
+
+// libMesh includes
+#include "libmesh/dof_map.h"
+#include "libmesh/mesh_base.h"
+
+
+MAST::SameMeshFieldFunction::
+SameMeshFieldFunction(MAST::SystemInitialization& sys,
+                      const std::string& nm,
+                      unsigned int var):
+MAST::FieldFunction<Real>(nm),
+_system(sys),
+_var(var),
+_sol(nullptr),
+_transfer(nullptr) {
+    
+    libmesh_assert_less(var, sys.n_vars());
+}
+
+
+
+MAST::SameMeshFieldFunction::~SameMeshFieldFunction() {
+    
+    this->clear();
+    
+    if (_transfer)
+        delete _transfer;
+}
+
+
+
+void
+MAST::SameMeshFieldFunction::init(const libMesh::NumericVector<Real>& sol) {
+    
+    // first make sure that the object is not already initialized
+    libmesh_assert(!_sol);
+    
+    // the values of the local and ghosted dofs are sufficient for a
+    // distributed mesh, since the function is evaluated on the elements
+    // of this processor
+    _sol = MAST::build_localized_interpolation_vector(_system, sol, nullptr);
+}
+
+
+
+void
+MAST::SameMeshFieldFunction::clear() {
+    
+    if (_sol) {
+        delete _sol;
+        _sol = nullptr;
+    }
+}
+
+
+
+void
+MAST::SameMeshFieldFunction::clear_dof_indices() {
+    
+    std::lock_guard<std::mutex> lock(_mutex);
+    
+    _dofs.clear();
+    
+    if (_transfer)
+        _transfer->clear();
+}
+
+
+
+const libMesh::FEType&
+MAST::SameMeshFieldFunction::fe_type() const {
+    
+    return _system.fetype(_var);
+}
+
+
+
+bool
+MAST::SameMeshFieldFunction::element_values(const libMesh::Elem& e,
+                                            const libMesh::FEType& t,
+                                            RealVectorX& v) const {
+    
+    if (t != this->fe_type())
+        return false;
+    
+    libmesh_assert(_sol);
+    
+    const std::vector<libMesh::dof_id_type>&
+    dofs = _dof_indices(e);
+    
+    std::vector<Real> vals(dofs.size(), 0.);
+    if (vals.size())
+        _sol->get(dofs, &vals[0]);
+    
+    v.setZero(dofs.size());
+    for (unsigned int i=0; i<dofs.size(); i++)
+        v(i) = vals[i];
+    
+    return true;
+}
+
+
+
+void
+MAST::SameMeshFieldFunction::operator() (const libMesh::Point& p,
+                                         const Real t,
+                                         Real& v) const {
+    
+    libmesh_assert(_sol);
+    
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        
+        if (!_transfer)
+            _transfer = new MAST::MeshFieldTransferOperator(_system);
+    }
+    
+    RealVectorX vals;
+    _transfer->interpolate(p, *_sol, vals);
+    v = vals(_var);
+}
+
+
+
+void
+MAST::SameMeshFieldFunction::derivative (const MAST::FunctionBase& f,
+                                         const libMesh::Point& p,
+                                         const Real t,
+                                         Real& v) const {
+    
+    v = 0.;
+}
+
+
+
+const std::vector<libMesh::dof_id_type>&
+MAST::SameMeshFieldFunction::_dof_indices(const libMesh::Elem& e) const {
+    
+    std::lock_guard<std::mutex> lock(_mutex);
+    
+    std::map<libMesh::dof_id_type, std::vector<libMesh::dof_id_type> >::iterator
+    it = _dofs.find(e.id());
+    
+    if (it == _dofs.end()) {
+        
+        MAST::NonlinearSystem& system = _system.system();
+        
+        // the element of this system with the same id
+        const libMesh::Elem*
+        elem = system.get_mesh().elem_ptr(e.id());
+        libmesh_assert(elem);
+        libmesh_assert_equal_to(elem->type(), e.type());
+        
+        it = _dofs.insert
+        (std::pair<libMesh::dof_id_type, std::vector<libMesh::dof_id_type> >
+         (e.id(), std::vector<libMesh::dof_id_type>())).first;
+        system.get_dof_map().dof_indices(elem, it->second, _system.vars()[_var]);
+    }
+    
+    return it->second;
+}
+
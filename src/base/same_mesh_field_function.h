@@ -0,0 +1,178 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2017  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef __mast__same_mesh_field_function__
+#define __mast__same_mesh_field_function__
+
+// C++ includes
+#include <map>
+#include <vector>
+#include <mutex>
+
+
+// MAST includes
+#include "base/field_function_base.h"
+
+
+// libMesh includes
+#include "libmesh/numeric_vector.h"
+#include "libmesh/fe_type.h"
+#include "libmesh/elem.h"
+
+
+namespace MAST {
+    
+    // Forward declerations
+    class SystemInitialization;
+    class MeshFieldTransferOperator;
+    
+    
+    /*!
+     *    Provides a variable of a system, for example the temperature of
+     *    a heat conduction system, to the elements of another system on the
+     *    same mesh, for one-way coupled analyses like thermal stress. An
+     *    element of the other system with the same FE type can read the
+     *    values of the variable at its nodes with element_values() and 
+     *    evaluate the variable with its own shape functions, without the
+     *    point location and interpolation of MAST::MeshFieldFunction. The
+     *    dof indices of the variable are computed once for each element
+     *    and retained until clear_dof_indices() is called, which is
+     *    needed if the mesh or the dof numbering changes.
+     *
+     *    Elements of the other system on the same mesh are identified by
+     *    their ids, which requires both systems to use the same mesh 
+     *    object, or copies with the same element numbering. Evaluation at
+     *    a point with operator() uses a MAST::MeshFieldTransferOperator
+     *    for elements that cannot use the direct path.
+     */
+    class SameMeshFieldFunction:
+    public MAST::FieldFunction<Real> {
+        
+    public:
+        
+        /*!
+         *   constructor for variable \p var of the system
+         */
+        SameMeshFieldFunction(MAST::SystemInitialization& sys,
+                              const std::string& nm,
+                              unsigned int var = 0);
+        
+        
+        virtual ~SameMeshFieldFunction();
+        
+        
+        /*!
+         *   initializes the function with the solution \p sol of the 
+         *   system, which is localized on all processors.
+         */
+        void init(const libMesh::NumericVector<Real>& sol);
+        
+        
+        /*!
+         *   clears the solution. The dof indices are retained.
+         */
+        void clear();
+        
+        
+        /*!
+         *   clears the retained dof indices of the elements, and the
+         *   interpolation data for points.
+         */
+        void clear_dof_indices();
+        
+        
+        /*!
+         *   @returns the FE type of the variable
+         */
+        const libMesh::FEType& fe_type() const;
+        
+        
+        /*!
+         *   copies the values of the variable at the dofs of the element
+         *   with the id of \p e to \p v, in the order of the shape 
+         *   functions of the element. @returns \p false without
+         *   modifying \p v if \p t is not the FE type of the variable.
+         */
+        bool element_values(const libMesh::Elem& e,
+                            const libMesh::FEType& t,
+                            RealVectorX& v) const;
+        
+        
+        /*!
+         *   interpolates the variable at \p p.
+         */
+        virtual void operator() (const libMesh::Point& p,
+                                 const Real t,
+                                 Real& v) const;
+        
+        
+        /*!
+         *   the solution is not a function of the parameters, so the 
+         *   sensitivity of the solution is not included and zero is
+         *   returned.
+         */
+        virtual void derivative (const MAST::FunctionBase& f,
+                                 const libMesh::Point& p,
+                                 const Real t,
+                                 Real& v) const;
+        
+    protected:
+        
+        /*!
+         *   @returns the dof indices of the variable for element \p e,
+         *   which are computed if not already available.
+         */
+        const std::vector<libMesh::dof_id_type>&
+        _dof_indices(const libMesh::Elem& e) const;
+        
+        
+        /*!
+         *   system of the variable
+         */
+        MAST::SystemInitialization& _system;
+        
+        /*!
+         *   variable number in the system
+         */
+        unsigned int _var;
+        
+        /*!
+         *   localized solution
+         */
+        libMesh::NumericVector<Real>* _sol;
+        
+        /*!
+         *   interpolation for evaluation at points
+         */
+        mutable MAST::MeshFieldTransferOperator* _transfer;
+        
+        /*!
+         *   dof indices of the variable for each element id
+         */
+        mutable std::map<libMesh::dof_id_type, std::vector<libMesh::dof_id_type> > _dofs;
+        
+        /*!
+         *   mutex for computation of new dof indices, since the elements
+         *   can be evaluated from threaded assembly loops
+         */
+        mutable std::mutex _mutex;
+    };
+}
+
+#endif // __mast__same_mesh_field_function__
@@ -0,0 +1,222 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2017  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+// C++ includes
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+
+
+// MAST includes
+#include "base/setup_snapshot.h"
+#include "base/nonlinear_system.h"
+#include "base/parameter.h"
+#include "base/performance_log.h"
+
+
+// libMesh includes
+#include "libmesh/mesh_base.h"
+#include "libmesh/checkpoint_io.h"
+#include "libmesh/parallel.h"
+
+
+MAST::SetupSnapshot::
+SetupSnapshot(const libMesh::Parallel::Communicator& comm_in,
+              const std::string& prefix):
+libMesh::ParallelObject(comm_in),
+_prefix(prefix) {
+    
+}
+
+
+
+MAST::SetupSnapshot::~SetupSnapshot() {
+    
+}
+
+
+
+void
+MAST::SetupSnapshot::add_system(MAST::NonlinearSystem& sys) {
+    
+    libmesh_assert(std::find(_systems.begin(), _systems.end(), &sys) ==
+                   _systems.end());
+    
+    _systems.push_back(&sys);
+}
+
+
+
+void
+MAST::SetupSnapshot::add_parameter(MAST::Parameter& p) {
+    
+    libmesh_assert(std::find(_parameters.begin(), _parameters.end(), &p) ==
+                   _parameters.end());
+    
+    _parameters.push_back(&p);
+}
+
+
+
+bool
+MAST::SetupSnapshot::exists() const {
+    
+    // the parameters are written by processor 0, and the system data by
+    // each processor
+    unsigned int
+    found = 1;
+    
+    if (this->comm().rank() == 0) {
+        
+        std::ifstream in((_prefix + ".params").c_str());
+        found = in.good();
+    }
+    
+    for (unsigned int i=0; i<_systems.size() && found; i++) {
+        
+        std::ostringstream oss;
+        oss << _system_prefix(*_systems[i]) << "." << this->comm().rank();
+        std::ifstream in(oss.str().c_str());
+        found = in.good();
+    }
+    
+    this->comm().min(found);
+    
+    return found;
+}
+
+
+
+void
+MAST::SetupSnapshot::write(const libMesh::MeshBase& mesh) const {
+    
+    MAST_LOG_SCOPE("write()", "SetupSnapshot");
+    
+    // the mesh with the processor ids of the elements and nodes
+    libMesh::CheckpointIO io(const_cast<libMesh::MeshBase&>(mesh), true);
+    io.write(_prefix + ".cpr");
+    
+    // parameters
+    if (this->comm().rank() == 0) {
+        
+        const std::string fname = _prefix + ".params";
+        
+        std::ofstream out(fname.c_str(), std::ios::out | std::ios::binary);
+        if (!out.good())
+            libmesh_error_msg("Unable to open file: " << fname);
+        
+        const unsigned int
+        n = (unsigned int)_parameters.size();
+        
+        out.write((const char*)&n, sizeof(unsigned int));
+        
+        for (unsigned int i=0; i<n; i++) {
+            
+            const std::string& nm = _parameters[i]->name();
+            const unsigned int n_chars = (unsigned int)nm.size();
+            const Real         v       = (*_parameters[i])();
+            
+            out.write((const char*)&n_chars, sizeof(unsigned int));
+            out.write(nm.c_str(), n_chars);
+            out.write((const char*)&v, sizeof(Real));
+        }
+        
+        if (!out.good())
+            libmesh_error_msg("Error writing file: " << fname);
+    }
+    
+    // systems
+    for (unsigned int i=0; i<_systems.size(); i++)
+        _systems[i]->write_setup_snapshot(_system_prefix(*_systems[i]));
+}
+
+
+
+void
+MAST::SetupSnapshot::read(libMesh::MeshBase& mesh) {
+    
+    MAST_LOG_SCOPE("read()", "SetupSnapshot");
+    
+    // the mesh is read with the stored partitioning, which is retained
+    // by prepare_for_use()
+    libMesh::CheckpointIO io(mesh, true);
+    io.read(_prefix + ".cpr");
+    
+    const bool skip = mesh.skip_partitioning();
+    mesh.skip_partitioning(true);
+    mesh.prepare_for_use();
+    mesh.skip_partitioning(skip);
+    
+    // parameters
+    std::vector<Real> vals(_parameters.size(), 0.);
+    
+    if (this->comm().rank() == 0) {
+        
+        const std::string fname = _prefix + ".params";
+        
+        std::ifstream in(fname.c_str(), std::ios::in | std::ios::binary);
+        if (!in.good())
+            libmesh_error_msg("Unable to open file: " << fname);
+        
+        unsigned int
+        n = 0;
+        
+        in.read((char*)&n, sizeof(unsigned int));
+        if (n != _parameters.size())
+            libmesh_error_msg("Setup snapshot has " << n << " parameters, expected "
+                              << _parameters.size());
+        
+        std::string nm;
+        
+        for (unsigned int i=0; i<n; i++) {
+            
+            unsigned int n_chars = 0;
+            in.read((char*)&n_chars, sizeof(unsigned int));
+            nm.resize(n_chars);
+            if (n_chars)
+                in.read(&nm[0], n_chars);
+            in.read((char*)&vals[i], sizeof(Real));
+            
+            if (nm != _parameters[i]->name())
+                libmesh_error_msg("Setup snapshot parameter " << nm
+                                  << " does not match " << _parameters[i]->name());
+        }
+        
+        if (!in.good())
+            libmesh_error_msg("Error reading file: " << fname);
+    }
+    
+    this->comm().broadcast(vals);
+    
+    for (unsigned int i=0; i<_parameters.size(); i++)
+        (*_parameters[i]) = vals[i];
+    
+    // systems
+    for (unsigned int i=0; i<_systems.size(); i++)
+        _systems[i]->read_setup_snapshot(_system_prefix(*_systems[i]));
+}
+
+
+
+std::string
+MAST::SetupSnapshot::_system_prefix(const MAST::NonlinearSystem& sys) const {
+    
+    return _prefix + "_" + sys.name();
+}
+
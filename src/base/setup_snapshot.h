@@ -0,0 +1,159 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2017  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef __mast__setup_snapshot__
+#define __mast__setup_snapshot__
+
+// C++ includes
+#include <string>
+#include <vector>
+
+
+// MAST includes
+#include "base/mast_data_types.h"
+
+
+// libMesh includes
+#include "libmesh/parallel_object.h"
+
+
+namespace libMesh {
+    
+    // Forward declerations
+    class MeshBase;
+}
+
+
+namespace MAST {
+    
+    // Forward declerations
+    class NonlinearSystem;
+    class Parameter;
+    
+    
+    /*!
+     *    Snapshot of the setup of a model, which is used to restart
+     *    analyses of the same configuration without repeating the
+     *    partitioning of the mesh and the computation of the sparsity
+     *    patterns. write() stores the partitioned mesh in the binary
+     *    checkpoint format of libMesh, the values of the registered
+     *    parameters, and for each registered system the per-processor
+     *    data of NonlinearSystem::write_setup_snapshot(). read() restores
+     *    the mesh with its partitioning, the parameter values, and the
+     *    system data, after which the equation systems are initialized
+     *    as usual. The snapshot must be read with the same number of
+     *    processors with which it was written.
+     *
+     *    The dofs are distributed by libMesh from the restored mesh, and
+     *    the systems use the stored sparsity only if the distribution is
+     *    the same as in the snapshot. The property cards, materials and
+     *    boundary conditions are objects created by the application, and
+     *    are therefore created again on restart. Only the values of the
+     *    parameters from which they are defined are restored.
+     *
+     *    A typical use is
+     *    \code
+     *       MAST::SetupSnapshot snapshot(comm, "model");
+     *       snapshot.add_system(sys);
+     *       snapshot.add_parameter(th);
+     *
+     *       if (snapshot.exists()) {
+     *          snapshot.read(mesh);
+     *          eq_sys.init();
+     *       }
+     *       else {
+     *          // create the mesh
+     *          eq_sys.init();
+     *          snapshot.write(mesh);
+     *       }
+     *    \endcode
+     */
+    class SetupSnapshot:
+    public libMesh::ParallelObject {
+        
+    public:
+        
+        SetupSnapshot(const libMesh::Parallel::Communicator& comm_in,
+                      const std::string& prefix);
+        
+        virtual ~SetupSnapshot();
+        
+        
+        /*!
+         *    adds \p sys to the systems of the snapshot. The system must
+         *    be added before the snapshot is read or written.
+         */
+        void add_system(MAST::NonlinearSystem& sys);
+        
+        
+        /*!
+         *    adds \p p to the parameters of the snapshot. The parameters
+         *    are identified by their names, which must be unique.
+         */
+        void add_parameter(MAST::Parameter& p);
+        
+        
+        /*!
+         *    @returns true if the files of the snapshot are available on
+         *    all processors.
+         */
+        bool exists() const;
+        
+        
+        /*!
+         *    writes the snapshot after the equation systems are
+         *    initialized. This must be called on all processors.
+         */
+        void write(const libMesh::MeshBase& mesh) const;
+        
+        
+        /*!
+         *    reads the snapshot into the empty \p mesh, the parameters
+         *    and the systems. This must be called on all processors before
+         *    the equation systems are initialized.
+         */
+        void read(libMesh::MeshBase& mesh);
+        
+    protected:
+        
+        /*!
+         *    @returns the name of the files of \p sys
+         */
+        std::string _system_prefix(const MAST::NonlinearSystem& sys) const;
+        
+        
+        /*!
+         *    prefix of the file names
+         */
+        const std::string                   _prefix;
+        
+        /*!
+         *    systems of the snapshot
+         */
+        std::vector<MAST::NonlinearSystem*> _systems;
+        
+        /*!
+         *    parameters of the snapshot
+         */
+        std::vector<MAST::Parameter*>       _parameters;
+    };
+}
+
+
+#endif // __mast__setup_snapshot__
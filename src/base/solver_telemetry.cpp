@@ -0,0 +1,100 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2017  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+// C++ includes
+#include <algorithm>
+
+// MAST includes
+#include "base/solver_telemetry.h"
+
+// libMesh includes
+#include "libmesh/libmesh_common.h"
+
+
+MAST::SolverTelemetry MAST::solver_telemetry;
+
+
+
+MAST::SolverTelemetry::SolverTelemetry():
+_n_callbacks(0) {
+
+}
+
+
+
+MAST::SolverTelemetry::~SolverTelemetry() {
+
+}
+
+
+
+void
+MAST::SolverTelemetry::add_callback(MAST::SolverTelemetry::Callback& c) {
+
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    libmesh_assert(std::find(_callbacks.begin(), _callbacks.end(), &c) ==
+                   _callbacks.end());
+
+    _callbacks.push_back(&c);
+    _n_callbacks.store((unsigned int)_callbacks.size(), std::memory_order_relaxed);
+}
+
+
+
+void
+MAST::SolverTelemetry::remove_callback(MAST::SolverTelemetry::Callback& c) {
+
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    std::vector<MAST::SolverTelemetry::Callback*>::iterator
+    it = std::find(_callbacks.begin(), _callbacks.end(), &c);
+
+    if (it != _callbacks.end())
+        _callbacks.erase(it);
+
+    _n_callbacks.store((unsigned int)_callbacks.size(), std::memory_order_relaxed);
+}
+
+
+
+void
+MAST::SolverTelemetry::emit(const MAST::SolverTelemetry::Event& e) {
+
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    for (unsigned int i=0; i<_callbacks.size(); i++)
+        _callbacks[i]->event(e);
+}
+
+
+
+Real
+MAST::SolverTelemetry::elapsed(std::chrono::steady_clock::time_point& t0) {
+
+    const std::chrono::steady_clock::time_point
+    t = std::chrono::steady_clock::now();
+
+    const Real
+    dt = std::chrono::duration<Real>(t - t0).count();
+
+    t0 = t;
+
+    return dt;
+}
@@ -0,0 +1,198 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2017  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef __mast__solver_telemetry__
+#define __mast__solver_telemetry__
+
+// C++ includes
+#include <string>
+#include <vector>
+#include <atomic>
+#include <mutex>
+#include <chrono>
+
+
+// MAST includes
+#include "base/mast_data_types.h"
+
+
+namespace MAST {
+
+    /*!
+     *   Stream of structured events from the solvers, so that an
+     *   application can monitor the convergence and the cost of an
+     *   analysis without parsing the standard output. The events are
+     *   passed to the callbacks registered with add_callback(). The
+     *   nonlinear iterations of MAST::MultiphysicsNonlinearSolverBase, the
+     *   solves of MAST::NonlinearSystem, the coupling iterations of
+     *   MAST::PartitionedCouplingSolver, the time steps of the transient
+     *   solvers and the roots of the flutter solvers are reported. An
+     *   event is emitted on all processors with the same data, so a
+     *   callback that writes the events should do so only on one
+     *   processor. Without callbacks, a reporting site costs a single
+     *   flag check, and no event data is computed.
+     */
+    class SolverTelemetry {
+
+    public:
+
+        /*!
+         *   type of an event
+         */
+        enum EventType {
+            NONLINEAR_ITERATION,   // iteration of a nonlinear solver
+            NONLINEAR_SOLVE,       // completed nonlinear solve
+            COUPLING_ITERATION,    // iteration of a partitioned coupling solve
+            TIME_STEP,             // completed time step
+            FLUTTER_ROOT           // converged flutter root
+        };
+
+
+        /*!
+         *   data of an event. Only the fields that apply to the type of
+         *   the event are set, and the others are zero.
+         */
+        struct Event {
+
+            Event(MAST::SolverTelemetry::EventType t,
+                  const std::string& s):
+            type(t), solver(s), iteration(0), linear_iterations(0),
+            residual_l2(0.), time(0.), dt(0.), wall_time(0.),
+            converged(false), V(0.), kr(0.), g(0.), omega(0.) { }
+
+            MAST::SolverTelemetry::EventType  type;
+
+            /*!
+             *   name of the solver or system that emitted the event
+             */
+            std::string                       solver;
+
+            /*!
+             *   iteration, or time step, number, and the number of linear
+             *   iterations of the nonlinear solve up to this event
+             */
+            unsigned int                      iteration;
+            unsigned int                      linear_iterations;
+
+            /*!
+             *   l2 norm of the residual, and of the residual of each
+             *   discipline for the multiphysics solver
+             */
+            Real                              residual_l2;
+            std::vector<Real>                 discipline_l2;
+
+            /*!
+             *   simulation time and time step of a time step event
+             */
+            Real                              time, dt;
+
+            /*!
+             *   wall time in seconds since the previous event of the same
+             *   site, or of the solve for NONLINEAR_SOLVE
+             */
+            Real                              wall_time;
+
+            bool                              converged;
+
+            /*!
+             *   velocity, reduced frequency, damping and frequency of a
+             *   flutter root
+             */
+            Real                              V, kr, g, omega;
+        };
+
+
+        /*!
+         *   interface of the objects that receive the events
+         */
+        class Callback {
+
+        public:
+
+            virtual ~Callback() { }
+
+            virtual void event(const MAST::SolverTelemetry::Event& e) = 0;
+        };
+
+
+        SolverTelemetry();
+
+
+        virtual ~SolverTelemetry();
+
+
+        /*!
+         *   adds \p c to the callbacks. The object must exist until it
+         *   is removed with remove_callback().
+         */
+        void add_callback(MAST::SolverTelemetry::Callback& c);
+
+
+        /*!
+         *   removes \p c from the callbacks
+         */
+        void remove_callback(MAST::SolverTelemetry::Callback& c);
+
+
+        /*!
+         *   @returns \p true if any callback is registered. The reporting
+         *   sites check this before computing the data of an event.
+         */
+        bool active() const {
+            return _n_callbacks.load(std::memory_order_relaxed) > 0;
+        }
+
+
+        /*!
+         *   passes \p e to all callbacks, which are called one at a time
+         */
+        void emit(const MAST::SolverTelemetry::Event& e);
+
+
+        /*!
+         *   @returns the wall time in seconds since \p t0, and sets
+         *   \p t0 to the current time
+         */
+        static Real
+        elapsed(std::chrono::steady_clock::time_point& t0);
+
+    protected:
+
+        /*!
+         *   number of callbacks, which is read without the mutex
+         */
+        std::atomic<unsigned int>                  _n_callbacks;
+
+        /*!
+         *   registered callbacks. Access is guarded by \p _mutex.
+         */
+        std::vector<MAST::SolverTelemetry::Callback*> _callbacks;
+
+        std::mutex                                 _mutex;
+    };
+
+
+    /*!
+     *   the telemetry used by all solvers in MAST
+     */
+    extern MAST::SolverTelemetry solver_telemetry;
+}
+
+
+#endif // __mast__solver_telemetry__
@@ -0,0 +1,246 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2017  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+// C++ includes
+#include <algorithm>
+
+
+// MAST includes
+#include "base/table_interpolation_function.h"
+#include "base/constant_field_function.h"
+#include "base/parameter.h"
+
+
+MAST::TableInterpolationFunction::
+TableInterpolationFunction(const std::string& nm,
+                           const std::map<Real, MAST::FieldFunction<Real>*>& values):
+MAST::FieldFunction<Real>(nm),
+_if_all_parameters(true) {
+    
+    // make sure that the size of the provided values is finite
+    libmesh_assert(values.size() > 0);
+    
+    _x.reserve(values.size());
+    _f.reserve(values.size());
+    _p.reserve(values.size());
+    
+    // the map provides the breakpoints in sorted order
+    std::map<Real, MAST::FieldFunction<Real>*>::const_iterator
+    it = values.begin(), end = values.end();
+    
+    for ( ; it != end; it++) {
+        
+        const MAST::ConstantFieldFunction*
+        c = dynamic_cast<const MAST::ConstantFieldFunction*>(it->second);
+        
+        _x.push_back(it->first);
+        _f.push_back(it->second);
+        _p.push_back(c ? &c->parameter() : nullptr);
+        
+        if (!c) _if_all_parameters = false;
+        
+        // tell the function that it is dependent on the provided functions
+        _functions.insert(it->second);
+    }
+}
+
+
+
+MAST::TableInterpolationFunction::~TableInterpolationFunction() {
+    
+}
+
+
+
+void
+MAST::TableInterpolationFunction::operator() (const libMesh::Point& p,
+                                              const Real t,
+                                              Real& v) const {
+    
+    unsigned int
+    i = 0;
+    Real
+    f = 0.;
+    
+    this->_interval(p(0), i, f);
+    
+    v = this->_value(i, nullptr, p, t);
+    if (f > 0.)
+        v += f * (this->_value(i+1, nullptr, p, t) - v);
+}
+
+
+
+void
+MAST::TableInterpolationFunction::derivative (const MAST::FunctionBase& df,
+                                              const libMesh::Point& p,
+                                              const Real t,
+                                              Real& v) const {
+    
+    unsigned int
+    i = 0;
+    Real
+    f = 0.;
+    
+    this->_interval(p(0), i, f);
+    
+    v = this->_value(i, &df, p, t);
+    if (f > 0.)
+        v += f * (this->_value(i+1, &df, p, t) - v);
+}
+
+
+
+void
+MAST::TableInterpolationFunction::
+operator() (const std::vector<libMesh::Point>& pts,
+            const Real t,
+            std::vector<Real>& v) const {
+    
+    this->_evaluate(nullptr, pts, t, v);
+}
+
+
+
+void
+MAST::TableInterpolationFunction::
+derivative (const MAST::FunctionBase& df,
+            const std::vector<libMesh::Point>& pts,
+            const Real t,
+            std::vector<Real>& v) const {
+    
+    this->_evaluate(&df, pts, t, v);
+}
+
+
+
+void
+MAST::TableInterpolationFunction::_interval(Real x,
+                                            unsigned int& i,
+                                            Real& f) const {
+    
+    const unsigned int
+    n = (unsigned int)_x.size();
+    
+    f = 0.;
+    
+    // the values of the first and last functions are used outside of
+    // the breakpoints
+    if (x <= _x[0]) {
+        i = 0;
+        return;
+    }
+    
+    if (x >= _x[n-1]) {
+        i = n-1;
+        return;
+    }
+    
+    // the hint is used if x is in the same interval
+    if (i >= n-1 || x < _x[i] || x >= _x[i+1])
+        i = (unsigned int)(std::upper_bound(_x.begin(), _x.end(), x) -
+                           _x.begin()) - 1;
+    
+    f = (x - _x[i]) / (_x[i+1] - _x[i]);
+}
+
+
+
+Real
+MAST::TableInterpolationFunction::_value(unsigned int i,
+                                         const MAST::FunctionBase* df,
+                                         const libMesh::Point& p,
+                                         const Real t) const {
+    
+    Real
+    v = 0.;
+    
+    if (_p[i])
+        v = df ? (_p[i]->depends_on(*df)?1.:0.) : (*_p[i])();
+    else if (df)
+        _f[i]->derivative(*df, p, t, v);
+    else
+        (*_f[i])(p, t, v);
+    
+    return v;
+}
+
+
+
+void
+MAST::TableInterpolationFunction::
+_evaluate(const MAST::FunctionBase* df,
+          const std::vector<libMesh::Point>& pts,
+          const Real t,
+          std::vector<Real>& v) const {
+    
+    const unsigned int
+    n = (unsigned int)pts.size();
+    
+    v.resize(n);
+    
+    if (!n)
+        return;
+    
+    // the points of an element are usually in the same or neighboring
+    // intervals, so that the interval of the previous point is checked
+    // first
+    std::vector<unsigned int>
+    idx(n, 0);
+    std::vector<Real>
+    frac(n, 0.);
+    
+    unsigned int
+    i = 0;
+    
+    for (unsigned int j=0; j<n; j++) {
+        
+        this->_interval(pts[j](0), i, frac[j]);
+        idx[j] = i;
+    }
+    
+    if (_if_all_parameters) {
+        
+        // values at the breakpoints are read once for all points
+        std::vector<Real>
+        vals(_x.size(), 0.);
+        
+        for (unsigned int k=0; k<_x.size(); k++)
+            vals[k] = df ? (_p[k]->depends_on(*df)?1.:0.) : (*_p[k])();
+        
+        // the upper breakpoint is not read if the fraction is zero, which
+        // is the case for the last breakpoint
+        for (unsigned int j=0; j<n; j++) {
+            
+            const Real
+            v0 = vals[idx[j]],
+            v1 = frac[j] > 0. ? vals[idx[j]+1] : v0;
+            
+            v[j] = v0 + frac[j] * (v1 - v0);
+        }
+    }
+    else
+        for (unsigned int j=0; j<n; j++) {
+            
+            v[j] = this->_value(idx[j], df, pts[j], t);
+            if (frac[j] > 0.)
+                v[j] += frac[j] * (this->_value(idx[j]+1, df, pts[j], t) - v[j]);
+        }
+}
+
@@ -0,0 +1,143 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2017  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef __mast__table_interpolation_function_h__
+#define __mast__table_interpolation_function_h__
+
+// C++ includes
+#include <map>
+#include <vector>
+
+// MAST includes
+#include "base/field_function_base.h"
+
+
+namespace MAST {
+    
+    // Forward declerations
+    class Parameter;
+    
+    
+    /*!
+     *   Interpolates linearly in the x-coordinate between field functions
+     *   tabulated at a set of breakpoints, and uses the values of the first
+     *   and last functions outside of the breakpoints. The breakpoints are
+     *   stored in a sorted vector and searched in O(log n). The evaluation
+     *   over a vector of points, for example the quadrature points of an
+     *   element, first checks the interval of the previous point. The
+     *   values of functions that are a MAST::ConstantFieldFunction are read
+     *   from their parameter, without a virtual call to the function, and if
+     *   all tabulated functions are constant the values of the breakpoints
+     *   are read once for all points.
+     */
+    class TableInterpolationFunction:
+    public MAST::FieldFunction<Real> {
+        
+    public:
+        
+        TableInterpolationFunction(const std::string& nm,
+                                   const std::map<Real, MAST::FieldFunction<Real>*>& values);
+        
+        virtual ~TableInterpolationFunction();
+        
+        
+        /*!
+         *   @returns the number of breakpoints
+         */
+        unsigned int n_breakpoints() const {
+            return (unsigned int)_x.size();
+        }
+        
+        
+        virtual void operator() (const libMesh::Point& p,
+                                 const Real t,
+                                 Real& v) const;
+        
+        
+        virtual void derivative (const MAST::FunctionBase& f,
+                                 const libMesh::Point& p,
+                                 const Real t,
+                                 Real& v) const;
+        
+        
+        virtual void operator() (const std::vector<libMesh::Point>& pts,
+                                 const Real t,
+                                 std::vector<Real>& v) const;
+        
+        
+        virtual void derivative (const MAST::FunctionBase& f,
+                                 const std::vector<libMesh::Point>& pts,
+                                 const Real t,
+                                 std::vector<Real>& v) const;
+        
+    protected:
+        
+        /*!
+         *   computes the index \p i of the lower breakpoint of the interval
+         *   that contains \p x and the fraction \p f of the interval at
+         *   \p x, with \p f = 0 outside of the breakpoints. The interval
+         *   \p i is checked before the search.
+         */
+        void _interval(Real x,
+                       unsigned int& i,
+                       Real& f) const;
+        
+        
+        /*!
+         *   @returns the value of the function, or its derivative with
+         *   respect to \p df if \p df is not \p nullptr, at breakpoint \p i
+         */
+        Real _value(unsigned int i,
+                    const MAST::FunctionBase* df,
+                    const libMesh::Point& p,
+                    const Real t) const;
+        
+        
+        /*!
+         *   evaluates the function or its derivative with respect to \p df
+         *   at \p pts
+         */
+        void _evaluate(const MAST::FunctionBase* df,
+                       const std::vector<libMesh::Point>& pts,
+                       const Real t,
+                       std::vector<Real>& v) const;
+        
+        
+        /*!
+         *   sorted breakpoints and the tabulated functions
+         */
+        std::vector<Real>                              _x;
+        
+        std::vector<const MAST::FieldFunction<Real>*>  _f;
+        
+        /*!
+         *   parameters of the tabulated functions that are constant field
+         *   functions, and \p nullptr for the other functions
+         */
+        std::vector<const MAST::Parameter*>            _p;
+        
+        /*!
+         *   \p true if all tabulated functions are constant field functions
+         */
+        bool                                           _if_all_parameters;
+    };
+}
+
+
+#endif // __mast__table_interpolation_function_h__
@@ -26,6 +26,7 @@
 #include "numerics/utility.h"
 #include "base/mesh_field_function.h"
 #include "base/nonlinear_system.h"
+#include "base/performance_log.h"
 
 // libMesh includes
 #include "libmesh/nonlinear_solver.h"
@@ -87,6 +88,12 @@ void
 MAST::TransientAssembly::
 clear_discipline_and_system( ) {
     
+    // the element objects, localized vectors and output element lists
+    // refer to the system, and are no longer valid
+    this->clear_elem_objects();
+    this->clear_output_elems();
+    this->clear_localized_vectors();
+    
     if (_system && _discipline) {
 
         _system->system().nonlinear_solver->residual_and_jacobian_object = nullptr;
@@ -115,19 +122,11 @@ residual_and_jacobian (const libMesh::NumericVector<Real>& X,
     // and the system passed through the function call are the same
     libmesh_assert_equal_to(&S, &transient_sys);
     
+    MAST_LOG_SCOPE("residual_and_jacobian()", "TransientAssembly");
+    
     if (R) R->zero();
     if (J) J->zero();
     
-    // iterate over each element, initialize it and get the relevant
-    // analysis quantities
-    RealVectorX vec;
-    RealMatrixX mat;
-    
-    std::vector<libMesh::dof_id_type> dof_indices;
-    const libMesh::DofMap& dof_map = transient_sys.get_dof_map();
-    std::auto_ptr<MAST::ElementBase> physics_elem;
-    
-    
     // stores the localized solution, velocity, acceleration, etc. vectors.
     // These pointers will have to be deleted
     std::vector<libMesh::NumericVector<Real>*>
@@ -140,74 +139,163 @@ residual_and_jacobian (const libMesh::NumericVector<Real>& X,
     // ask the solver to localize the relevant solutions
     _transient_solver->build_local_quantities(X, local_qtys);
     
-    libMesh::MeshBase::const_element_iterator       el     =
-    transient_sys.get_mesh().active_local_elements_begin();
-    const libMesh::MeshBase::const_element_iterator end_el =
-    transient_sys.get_mesh().active_local_elements_end();
+    // iterate over each element, initialize it and get the relevant
+    // analysis quantities
+    libMesh::ConstElemRange
+    elem_range(transient_sys.get_mesh().active_local_elements_begin(),
+               transient_sys.get_mesh().active_local_elements_end());
+    
+    MAST::TransientAssembly::ElemTransientResidualAndJacobian
+    elem_ops(*this, local_qtys, R, J);
+    
+    // the solution function is shared by all elements, which set their
+    // quadrature point solution in it. So, the loop is serial if one
+    // is attached. The per-element data of the solvers and operators,
+    // for example the local time steps of MAST::PseudoTransientSolver,
+    // must be created before this loop, so that the threads only assign
+    // the values of existing entries.
+    if (_threaded_assembly && !_sol_function)
+        libMesh::Threads::parallel_reduce(elem_range, elem_ops);
+    else
+        elem_ops(elem_range);
+    
+    // delete pointers to the local solutions
+    for (unsigned int i=0; i<local_qtys.size(); i++)
+        delete local_qtys[i];
+    
+    // if a solution function is attached, clear it
+    if (_sol_function)
+        _sol_function->clear();
+    
+    this->_close_residual_and_jacobian(R, J);
+}
+
+
+
+
+MAST::TransientAssembly::ElemTransientResidualAndJacobian::
+ElemTransientResidualAndJacobian
+(MAST::TransientAssembly& assembly,
+ const std::vector<libMesh::NumericVector<Real>*>& local_qtys,
+ libMesh::NumericVector<Real>* R,
+ libMesh::SparseMatrix<Real>*  J):
+_assembly(assembly),
+_local_qtys(local_qtys),
+_R(R),
+_J(J) {
+    
+}
+
+
+
+MAST::TransientAssembly::ElemTransientResidualAndJacobian::
+ElemTransientResidualAndJacobian(ElemTransientResidualAndJacobian& other,
+                                 libMesh::Threads::split):
+_assembly(other._assembly),
+_local_qtys(other._local_qtys),
+_R(other._R),
+_J(other._J) {
+    
+}
+
+
+
+void
+MAST::TransientAssembly::ElemTransientResidualAndJacobian::
+operator() (const libMesh::ConstElemRange& range) {
+    
+    // these data structures are local to each thread
+    RealVectorX vec;
+    RealMatrixX mat;
+    DenseRealVector v;
+    DenseRealMatrix m;
+    
+    std::vector<libMesh::dof_id_type> dof_indices;
+    const libMesh::DofMap& dof_map = _assembly._system->system().get_dof_map();
+    const MAST::ElementTopologyCache& topology = _assembly._system->system().topology_cache();
+    std::auto_ptr<MAST::ElementBase> elem_storage;
+    MAST::ElementBase* physics_elem = nullptr;
+    
+    libMesh::ConstElemRange::const_iterator
+    el     = range.begin(),
+    end_el = range.end();
     
     for ( ; el != end_el; ++el) {
         
         const libMesh::Elem* elem = *el;
         
-        dof_map.dof_indices (elem, dof_indices);
+        topology.dof_indices (elem, dof_indices);
         
-        physics_elem.reset(_build_elem(*elem).release());
+        physics_elem = &_assembly._get_elem(*elem, elem_storage);
         
         // get the solution
         unsigned int ndofs = (unsigned int)dof_indices.size();
         vec.setZero(ndofs);
         mat.setZero(ndofs, ndofs);
         
-        _transient_solver->_set_element_data(dof_indices,
-                                             local_qtys,
-                                             *physics_elem);
-        
-        if (_sol_function)
-            physics_elem->attach_active_solution_function(*_sol_function);
-        
         // perform the element level calculations
-        _transient_solver->_elem_calculations(*physics_elem,
-                                              dof_indices,
-                                              J!=nullptr?true:false,
-                                              vec, mat);
+        _assembly._transient_elem_calculations(*physics_elem,
+                                               dof_indices,
+                                               _local_qtys,
+                                               _J!=nullptr?true:false,
+                                               vec, mat);
         
         // copy to the libMesh matrix for further processing
-        DenseRealVector v;
-        DenseRealMatrix m;
-        if (R)
+        if (_R)
             MAST::copy(v, vec);
-        if (J)
+        if (_J)
             MAST::copy(m, mat);
         
         // constrain the quantities to account for hanging dofs,
         // Dirichlet constraints, etc.
-        if (R && J)
-            dof_map.constrain_element_matrix_and_vector(m, v, dof_indices);
-        else if (R)
-            dof_map.constrain_element_vector(v, dof_indices);
-        else
-            dof_map.constrain_element_matrix(m, dof_indices);
+        if (topology.has_constrained_dofs(*elem)) {
+            
+            if (_R && _J)
+                dof_map.constrain_element_matrix_and_vector(m, v, dof_indices);
+            else if (_R)
+                dof_map.constrain_element_vector(v, dof_indices);
+            else
+                dof_map.constrain_element_matrix(m, dof_indices);
+        }
         
-        // add to the global matrices
-        if (R) R->add_vector(v, dof_indices);
-        if (J) J->add_matrix(m, dof_indices);
+        // add to the global matrices. Only one thread at a time is
+        // allowed to modify the global data structures.
+        {
+            libMesh::Threads::spin_mutex::scoped_lock
+            lock(libMesh::Threads::spin_mtx);
+            
+            if (_R) _R->add_vector(v, dof_indices);
+            if (_J) _assembly._add_elem_matrix(*_J, m, dof_indices, elem);
+        }
     }
+}
+
+
+
+void
+MAST::TransientAssembly::
+_transient_elem_calculations(MAST::ElementBase& elem,
+                             const std::vector<libMesh::dof_id_type>& dof_indices,
+                             const std::vector<libMesh::NumericVector<Real>*>& local_qtys,
+                             bool if_jac,
+                             RealVectorX& vec,
+                             RealMatrixX& mat) {
     
-    // delete pointers to the local solutions
-    for (unsigned int i=0; i<local_qtys.size(); i++)
-        delete local_qtys[i];
+    _transient_solver->_set_element_data(dof_indices,
+                                         local_qtys,
+                                         elem);
     
-    // if a solution function is attached, clear it
     if (_sol_function)
-        _sol_function->clear();
+        elem.attach_active_solution_function(*_sol_function);
     
-    if (R) R->close();
-    if (J) J->close();
+    _transient_solver->_elem_calculations(elem,
+                                          dof_indices,
+                                          if_jac,
+                                          vec, mat);
 }
 
 
 
-
 void
 MAST::TransientAssembly::
 linearized_jacobian_solution_product (const libMesh::NumericVector<Real>& X,
@@ -229,7 +317,10 @@ linearized_jacobian_solution_product (const libMesh::NumericVector<Real>& X,
     
     std::vector<libMesh::dof_id_type> dof_indices;
     const libMesh::DofMap& dof_map = transient_sys.get_dof_map();
-    std::auto_ptr<MAST::ElementBase> physics_elem;
+    const MAST::ElementTopologyCache& topology = transient_sys.topology_cache();
+    std::auto_ptr<MAST::ElementBase> elem_storage;
+    MAST::ElementBase* physics_elem = nullptr;
+    DenseRealVector v;
     
     // stores the localized solution, velocity, acceleration, etc. vectors.
     // These pointers will have to be deleted
@@ -254,9 +345,9 @@ linearized_jacobian_solution_product (const libMesh::NumericVector<Real>& X,
         
         const libMesh::Elem* elem = *el;
         
-        dof_map.dof_indices (elem, dof_indices);
+        topology.dof_indices (elem, dof_indices);
         
-        physics_elem.reset(_build_elem(*elem).release());
+        physics_elem = &_get_elem(*elem, elem_storage);
         
         // get the solution
         unsigned int ndofs = (unsigned int)dof_indices.size();
@@ -279,7 +370,6 @@ linearized_jacobian_solution_product (const libMesh::NumericVector<Real>& X,
                                                                       vec);
         
         // copy to the libMesh matrix for further processing
-        DenseRealVector v;
         MAST::copy(v, vec);
 
         // constrain the quantities to account for hanging dofs,
@@ -306,6 +396,236 @@ linearized_jacobian_solution_product (const libMesh::NumericVector<Real>& X,
 
 
 
+void
+MAST::TransientAssembly::
+derivative_jacobian_transpose_product(const libMesh::NumericVector<Real>& X,
+                                      const libMesh::NumericVector<Real>& lambda,
+                                      std::vector<libMesh::NumericVector<Real>*>& products) {
+    
+    MAST::NonlinearSystem& transient_sys = _system->system();
+    
+    MAST_LOG_SCOPE("derivative_jacobian_transpose_product()", "TransientAssembly");
+    
+    const unsigned int
+    order = _transient_solver->ode_order();
+    
+    libmesh_assert_equal_to(products.size(), order);
+    
+    for (unsigned int k=0; k<order; k++)
+        products[k]->zero();
+    
+    // iterate over each element, initialize it and get the relevant
+    // analysis quantities
+    RealVectorX vec, lam;
+    std::vector<RealMatrixX> jacs;
+    
+    std::vector<libMesh::dof_id_type> dof_indices;
+    const libMesh::DofMap& dof_map = transient_sys.get_dof_map();
+    const MAST::ElementTopologyCache& topology = transient_sys.topology_cache();
+    std::auto_ptr<MAST::ElementBase> elem_storage;
+    MAST::ElementBase* physics_elem = nullptr;
+    DenseRealVector v;
+    
+    // stores the localized solution, velocity, acceleration, etc. vectors.
+    // These pointers will have to be deleted
+    std::vector<libMesh::NumericVector<Real>*>
+    local_qtys;
+    
+    std::auto_ptr<libMesh::NumericVector<Real> >
+    localized_lambda(_build_localized_vector(transient_sys, lambda).release());
+    
+    // if a solution function is attached, initialize it
+    if (_sol_function)
+        _sol_function->init( X);
+    
+    // ask the solver to localize the relevant solutions
+    _transient_solver->build_local_quantities(X, local_qtys);
+    
+    libMesh::MeshBase::const_element_iterator       el     =
+    transient_sys.get_mesh().active_local_elements_begin();
+    const libMesh::MeshBase::const_element_iterator end_el =
+    transient_sys.get_mesh().active_local_elements_end();
+    
+    for ( ; el != end_el; ++el) {
+        
+        const libMesh::Elem* elem = *el;
+        
+        topology.dof_indices (elem, dof_indices);
+        
+        physics_elem = &_get_elem(*elem, elem_storage);
+        
+        unsigned int ndofs = (unsigned int)dof_indices.size();
+        lam.setZero(ndofs);
+        
+        _get_elem_values(*localized_lambda, dof_indices, lam);
+        
+        _transient_solver->_set_element_data(dof_indices,
+                                             local_qtys,
+                                             *physics_elem);
+        
+        if (_sol_function)
+            physics_elem->attach_active_solution_function(*_sol_function);
+        
+        // perform the element level calculations
+        _transient_solver->_elem_derivative_jacobians(*physics_elem,
+                                                      dof_indices,
+                                                      jacs);
+        
+        for (unsigned int k=0; k<order; k++) {
+            
+            vec = jacs[k].transpose() * lam;
+            
+            // copy to the libMesh matrix for further processing
+            MAST::copy(v, vec);
+            
+            // constrain the quantities to account for hanging dofs,
+            // Dirichlet constraints, etc.
+            dof_map.constrain_element_vector(v, dof_indices);
+            
+            // add to the global vectors
+            products[k]->add_vector(v, dof_indices);
+        }
+    }
+    
+    // delete pointers to the local solutions
+    for (unsigned int i=0; i<local_qtys.size(); i++)
+        delete local_qtys[i];
+    
+    // if a solution function is attached, clear it
+    if (_sol_function)
+        _sol_function->clear();
+    
+    for (unsigned int k=0; k<order; k++)
+        products[k]->close();
+}
+
+
+
+void
+MAST::TransientAssembly::
+assemble_first_order_quantities(const libMesh::NumericVector<Real>& X,
+                                libMesh::NumericVector<Real>* R,
+                                libMesh::SparseMatrix<Real>*  C,
+                                libMesh::SparseMatrix<Real>*  K) {
+    
+    MAST::NonlinearSystem& transient_sys = _system->system();
+    
+    MAST_LOG_SCOPE("assemble_first_order_quantities()", "TransientAssembly");
+    
+    if (R) R->zero();
+    if (C) C->zero();
+    if (K) K->zero();
+    
+    const bool
+    if_jac = (C || K);
+    
+    RealVectorX sol, vel, f_m, f_x;
+    RealMatrixX f_m_jac_xdot, f_m_jac, f_x_jac;
+    DenseRealVector v;
+    DenseRealMatrix m;
+    
+    std::vector<libMesh::dof_id_type> dof_indices;
+    const libMesh::DofMap& dof_map = transient_sys.get_dof_map();
+    const MAST::ElementTopologyCache& topology = transient_sys.topology_cache();
+    std::auto_ptr<MAST::ElementBase> elem_storage;
+    MAST::ElementBase* physics_elem = nullptr;
+    
+    std::auto_ptr<libMesh::NumericVector<Real> >
+    localized_solution(_build_localized_vector(transient_sys, X).release());
+    
+    // if a solution function is attached, initialize it
+    if (_sol_function)
+        _sol_function->init( X);
+    
+    libMesh::MeshBase::const_element_iterator       el     =
+    transient_sys.get_mesh().active_local_elements_begin();
+    const libMesh::MeshBase::const_element_iterator end_el =
+    transient_sys.get_mesh().active_local_elements_end();
+    
+    for ( ; el != end_el; ++el) {
+        
+        const libMesh::Elem* elem = *el;
+        
+        topology.dof_indices (elem, dof_indices);
+        
+        physics_elem = &_get_elem(*elem, elem_storage);
+        
+        const unsigned int
+        ndofs = (unsigned int)dof_indices.size();
+        
+        sol.setZero(ndofs);
+        vel.setZero(ndofs);
+        f_m.setZero(ndofs);
+        f_x.setZero(ndofs);
+        f_m_jac_xdot.setZero(ndofs, ndofs);
+        f_m_jac.setZero(ndofs, ndofs);
+        f_x_jac.setZero(ndofs, ndofs);
+        
+        _get_elem_values(*localized_solution, dof_indices, sol);
+        
+        physics_elem->set_solution(sol);
+        physics_elem->set_velocity(vel);     // set to zero value
+        
+        if (_sol_function)
+            physics_elem->attach_active_solution_function(*_sol_function);
+        
+        _elem_calculations(*physics_elem,
+                           if_jac,
+                           f_m, f_x,
+                           f_m_jac_xdot, f_m_jac, f_x_jac);
+        
+        physics_elem->detach_active_solution_function();
+        
+        const bool
+        constrained = topology.has_constrained_dofs(*elem);
+        
+        if (R) {
+            
+            f_m += f_x;
+            MAST::copy(v, f_m);
+            if (constrained)
+                dof_map.constrain_element_vector(v, dof_indices);
+            R->add_vector(v, dof_indices);
+        }
+        
+        if (C) {
+            
+            MAST::copy(m, f_m_jac_xdot);
+            if (constrained) {
+                
+                dof_map.constrain_element_matrix(m, dof_indices);
+                
+                // the unit diagonal of the constraint is retained only for
+                // the conductance matrix
+                for (unsigned int i=0; i<ndofs; i++)
+                    if (dof_map.is_constrained_dof(dof_indices[i]))
+                        m(i, i) = 0.;
+            }
+            _add_elem_matrix(*C, m, dof_indices);
+        }
+        
+        if (K) {
+            
+            f_m_jac += f_x_jac;
+            MAST::copy(m, f_m_jac);
+            if (constrained)
+                dof_map.constrain_element_matrix(m, dof_indices);
+            _add_elem_matrix(*K, m, dof_indices);
+        }
+    }
+    
+    // if a solution function is attached, clear it
+    if (_sol_function)
+        _sol_function->clear();
+    
+    if (R) R->close();
+    if (C) C->close();
+    if (K) K->close();
+}
+
+
+
+
 bool
 MAST::TransientAssembly::
 sensitivity_assemble (const libMesh::ParameterVector& parameters,
@@ -318,12 +638,15 @@ sensitivity_assemble (const libMesh::ParameterVector& parameters,
     
     // iterate over each element, initialize it and get the relevant
     // analysis quantities
-    RealVectorX vec, sol, vel;
+    RealVectorX vec, sol, vel, acc;
     RealMatrixX mat;
     
     std::vector<libMesh::dof_id_type> dof_indices;
     const libMesh::DofMap& dof_map = transient_sys.get_dof_map();
-    std::auto_ptr<MAST::ElementBase> physics_elem;
+    const MAST::ElementTopologyCache& topology = transient_sys.topology_cache();
+    std::auto_ptr<MAST::ElementBase> elem_storage;
+    MAST::ElementBase* physics_elem = nullptr;
+    DenseRealVector v;
     
     // localize the solution and velocity for element assembly
     std::auto_ptr<libMesh::NumericVector<Real> >
@@ -333,6 +656,14 @@ sensitivity_assemble (const libMesh::ParameterVector& parameters,
                                                _transient_solver->velocity(0)).release());
     
     
+    // the acceleration is needed for second order systems
+    std::auto_ptr<libMesh::NumericVector<Real> >
+    localized_acceleration;
+    if (_transient_solver->ode_order() > 1)
+        localized_acceleration.reset
+        (_build_localized_vector(transient_sys,
+                                 _transient_solver->acceleration(0)).release());
+    
     // ask the solver to provide the velocity estimate
     const libMesh::NumericVector<Real>
     &solution = *localized_solution,
@@ -351,9 +682,9 @@ sensitivity_assemble (const libMesh::ParameterVector& parameters,
         
         const libMesh::Elem* elem = *el;
         
-        dof_map.dof_indices (elem, dof_indices);
+        topology.dof_indices (elem, dof_indices);
         
-        physics_elem.reset(_build_elem(*elem).release());
+        physics_elem = &_get_elem(*elem, elem_storage);
         
         // get the solution
         unsigned int ndofs = (unsigned int)dof_indices.size();
@@ -362,13 +693,18 @@ sensitivity_assemble (const libMesh::ParameterVector& parameters,
         vec.setZero(ndofs);
         mat.setZero(ndofs, ndofs);
         
-        for (unsigned int i=0; i<dof_indices.size(); i++) {
-            sol(i) = solution(dof_indices[i]);
-            vel(i) = velocity(dof_indices[i]);
-        }
+        _get_elem_values(solution, dof_indices, sol);
+        _get_elem_values(velocity, dof_indices, vel);
         
         physics_elem->set_solution(sol);
         physics_elem->set_velocity(vel);
+        
+        if (localized_acceleration.get()) {
+            
+            acc.setZero(ndofs);
+            _get_elem_values(*localized_acceleration, dof_indices, acc);
+            physics_elem->set_acceleration(acc);
+        }
 
         if (_sol_function)
             physics_elem->attach_active_solution_function(*_sol_function);
@@ -379,7 +715,13 @@ sensitivity_assemble (const libMesh::ParameterVector& parameters,
         // perform the element level calculations
         _transient_solver->_elem_sensitivity_calculations(*physics_elem, dof_indices, vec);
         
-        DenseRealVector v;
+        // the sensitivity method provides sensitivity of the residual.
+        // Hence, this is multiplied with -1 to make it the RHS of the
+        // sensitivity equations.
+        vec *= -1.;
+        
+        physics_elem->detach_active_solution_function();
+        
         MAST::copy(v, vec);
         
         // constrain the quantities to account for hanging dofs,
@@ -401,3 +743,22 @@ sensitivity_assemble (const libMesh::ParameterVector& parameters,
 }
 
 
+
+
+bool
+MAST::TransientAssembly::
+sensitivity_assemble (const libMesh::ParameterVector& parameters,
+                      std::vector<libMesh::NumericVector<Real>*>& sensitivity_rhs) {
+    
+    libmesh_assert_equal_to(sensitivity_rhs.size(), parameters.size());
+    
+    bool if_sens = true;
+    
+    for (unsigned int i=0; i<parameters.size(); i++)
+        if_sens = (this->sensitivity_assemble(parameters, i, *sensitivity_rhs[i]) &&
+                   if_sens);
+    
+    return if_sens;
+}
+
+
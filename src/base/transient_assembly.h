@@ -107,11 +107,45 @@ namespace MAST {
                                              libMesh::NumericVector<Real>& JdX,
                                              libMesh::NonlinearImplicitSystem& S);
         
+        
+        /*!
+         *    calculates \f$ [\partial R/\partial d_k]^T \{\lambda\} \f$ in
+         *    \p products[k-1] about the solution \p X, where \f$ d_k \f$ is
+         *    the k^th time derivative of the solution, for
+         *    k = 1, ..., ode_order() of the transient solver. The time
+         *    derivatives are updated from \p X by the solver. This is used
+         *    by MAST::TransientSolverBase::adjoint_sensitivity().
+         */
+        virtual void
+        derivative_jacobian_transpose_product(const libMesh::NumericVector<Real>& X,
+                                              const libMesh::NumericVector<Real>& lambda,
+                                              std::vector<libMesh::NumericVector<Real>*>& products);
+        
+        
+        /*!
+         *    assembles the quantities of the first order system
+         *    $ f_m(x,\dot{x}) + f_x(x) = 0 $ about the solution \p X
+         *    and zero velocity, at the current time of the system: the
+         *    residual $ R = f_m + f_x $, the capacitance
+         *    $ C = \partial f_m/\partial \dot{x} $ and the conductance
+         *    $ K = \partial (f_m + f_x)/\partial x $. Any of \p R,
+         *    \p C and \p K can be \p nullptr. The constrained dofs have a
+         *    unit diagonal in \p K and a zero diagonal in \p C. This does
+         *    not require a transient solver, and is used by
+         *    MAST::ReducedOrderThermalTransientSolver.
+         */
+        void
+        assemble_first_order_quantities(const libMesh::NumericVector<Real>& X,
+                                        libMesh::NumericVector<Real>* R,
+                                        libMesh::SparseMatrix<Real>*  C,
+                                        libMesh::SparseMatrix<Real>*  K);
+        
         /**
          * Assembly function.  This function will be called
          * to assemble the sensitivity of system residual prior to a solve and must
-         * be provided by the user in a derived class. The method provides dR/dp_i
-         * for \par i ^th parameter in the vector \par parameters.
+         * be provided by the user in a derived class. The method provides -dR/dp_i
+         * for \par i ^th parameter in the vector \par parameters, about the
+         * current solution and time derivatives of the transient solver.
          *
          * If the routine is not able to provide sensitivity for this parameter,
          * then it should return false, and the system will attempt to use
@@ -123,6 +157,17 @@ namespace MAST {
                               libMesh::NumericVector<Real>& sensitivity_rhs);
         
         
+        /*!
+         *   assembles the sensitivity RHS for all parameters by calling the
+         *   single parameter version above for each parameter, since the
+         *   element setup of the transient residual differs from that of
+         *   the parent class.
+         */
+        virtual bool
+        sensitivity_assemble (const libMesh::ParameterVector& parameters,
+                              std::vector<libMesh::NumericVector<Real>*>& sensitivity_rhs);
+        
+        
         
         //**************************************************************
         //these methods are provided for use by the solvers
@@ -177,6 +222,21 @@ namespace MAST {
                                         RealMatrixX& f_x_jac_xdot,
                                         RealMatrixX& f_x_jac) = 0;
         
+        /*!
+         *   @returns the local time step for \par elem for the CFL number
+         *   \par cfl, using the current solution of the element. This is
+         *   used for local time stepping in pseudo-transient continuation
+         *   by MAST::PseudoTransientSolver, and is not available by default.
+         */
+        virtual Real
+        _elem_local_time_step(MAST::ElementBase& elem,
+                              const Real cfl) {
+            
+            libmesh_error_msg("Error! Local time step not implemented for this assembly.");
+            return 0.;
+        }
+        
+        
         /*!
          *   Calculates the product of Jacobian-solution, and Jacobian-velocity
          *   over the element for a system of the form
@@ -200,6 +260,62 @@ namespace MAST {
         
     protected:
         
+        /*!
+         *   Functor that performs the element calculations of the transient
+         *   residual and Jacobian over a range of elements, analogous to
+         *   MAST::NonlinearImplicitAssembly::ElemResidualAndJacobian. The
+         *   localized solution and time derivatives in \p local_qtys are
+         *   only read by the threads.
+         */
+        class ElemTransientResidualAndJacobian {
+        public:
+            
+            ElemTransientResidualAndJacobian
+            (MAST::TransientAssembly& assembly,
+             const std::vector<libMesh::NumericVector<Real>*>& local_qtys,
+             libMesh::NumericVector<Real>* R,
+             libMesh::SparseMatrix<Real>*  J);
+            
+            /*!
+             *   splitting constructor used by libMesh::Threads::parallel_reduce
+             */
+            ElemTransientResidualAndJacobian(ElemTransientResidualAndJacobian& other,
+                                             libMesh::Threads::split);
+            
+            /*!
+             *   performs the element calculations over all elements in
+             *   \p range
+             */
+            void operator() (const libMesh::ConstElemRange& range);
+            
+            /*!
+             *   all quantities are directly added to the global data
+             *   structures. So, nothing is done here.
+             */
+            void join(const ElemTransientResidualAndJacobian& other) { }
+            
+        protected:
+            
+            MAST::TransientAssembly&                          _assembly;
+            const std::vector<libMesh::NumericVector<Real>*>& _local_qtys;
+            libMesh::NumericVector<Real>*                     _R;
+            libMesh::SparseMatrix<Real>*                      _J;
+        };
+        
+        
+        /*!
+         *   sets the transient data of \p elem from \p local_qtys, and
+         *   performs the element calculations of the transient solver
+         */
+        void
+        _transient_elem_calculations(MAST::ElementBase& elem,
+                                     const std::vector<libMesh::dof_id_type>& dof_indices,
+                                     const std::vector<libMesh::NumericVector<Real>*>& local_qtys,
+                                     bool if_jac,
+                                     RealVectorX& vec,
+                                     RealMatrixX& mat);
+        
+        
         /*!
          *   performs the element calculations over \par elem, and returns
          *   the element vector and matrix quantities in \par mat and
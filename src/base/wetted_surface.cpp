@@ -0,0 +1,145 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2017  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+// MAST includes
+#include "base/wetted_surface.h"
+#include "base/element_topology_cache.h"
+#include "base/boundary_condition_base.h"
+#include "base/performance_log.h"
+
+
+MAST::WettedSurface::WettedSurface(const MAST::SideBCMapType& bc):
+_bc(bc),
+_topology(nullptr) {
+    
+}
+
+
+
+MAST::WettedSurface::~WettedSurface() {
+    
+}
+
+
+
+void
+MAST::WettedSurface::init(const MAST::ElementTopologyCache& topology) {
+    
+    MAST_LOG_SCOPE("init()", "WettedSurface");
+    
+    this->clear();
+    
+    libmesh_assert(topology.initialized());
+    
+    _topology = &topology;
+    
+    const unsigned int
+    n_elems = topology.n_elems();
+    
+    _offset.reserve(n_elems+1);
+    _offset.push_back(0);
+    
+    typedef MAST::SideBCMapType maptype;
+    std::pair<maptype::const_iterator, maptype::const_iterator> it;
+    
+    std::vector<libMesh::boundary_id_type> bc_ids;
+    SideLoad l;
+    
+    for (unsigned int i=0; i<n_elems; i++) {
+        
+        const libMesh::Elem& elem = *topology.elem(i);
+        
+        for (unsigned short int n=0; n<elem.n_sides(); n++) {
+            
+            if (!topology.n_boundary_ids(elem, n))
+                continue;
+            
+            bc_ids = topology.boundary_ids(elem, n);
+            
+            for (unsigned int j=0; j<bc_ids.size(); j++) {
+                
+                it = _bc.equal_range(bc_ids[j]);
+                
+                for ( ; it.first != it.second; it.first++) {
+                    
+                    if (it.first->second->type() == MAST::DIRICHLET)
+                        continue;
+                    
+                    l.side = n;
+                    l.bc   = it.first->second;
+                    _loads.push_back(l);
+                }
+            }
+        }
+        
+        if (_loads.size() > _offset.back())
+            _wetted_elems.push_back(i);
+        
+        _offset.push_back((unsigned int)_loads.size());
+    }
+}
+
+
+
+void
+MAST::WettedSurface::clear() {
+    
+    _topology = nullptr;
+    
+    _offset.clear();
+    _loads.clear();
+    _wetted_elems.clear();
+}
+
+
+
+bool
+MAST::WettedSurface::side_loads(const libMesh::Elem& e,
+                                const MAST::SideBCMapType& bc,
+                                const SideLoad*& begin,
+                                const SideLoad*& end) const {
+    
+    begin = end = nullptr;
+    
+    if (!_topology || &bc != &_bc)
+        return false;
+    
+    const unsigned int
+    i = _topology->elem_index(e);
+    
+    if (i == libMesh::invalid_uint)
+        return false;
+    
+    begin = _loads.data() + _offset[i];
+    end   = _loads.data() + _offset[i+1];
+    
+    return true;
+}
+
+
+
+std::size_t
+MAST::WettedSurface::memory() const {
+    
+    return
+    _offset.size()       * sizeof(unsigned int) +
+    _loads.size()        * sizeof(MAST::WettedSurface::SideLoad) +
+    _wetted_elems.size() * sizeof(unsigned int);
+}
+
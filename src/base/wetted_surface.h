@@ -0,0 +1,167 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2017  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef __mast__wetted_surface__
+#define __mast__wetted_surface__
+
+// C++ includes
+#include <vector>
+
+
+// MAST includes
+#include "base/mast_data_types.h"
+#include "base/physics_discipline_base.h"
+
+
+// libMesh includes
+#include "libmesh/elem.h"
+
+
+namespace MAST {
+    
+    // Forward declerations
+    class ElementTopologyCache;
+    class BoundaryConditionBase;
+    
+    
+    /*!
+     *    List of the sides of the local elements on which the side loads
+     *    of a discipline, for example the surface pressure and piston
+     *    theory loads on the wetted surface of a panel, are applied. The
+     *    list is computed from the boundary ids of the
+     *    MAST::ElementTopologyCache and the side load map, after which the
+     *    side load calculations of the elements read the loads of their
+     *    sides from this list. This avoids the search of the boundary ids
+     *    of every side of every element in the load map, which for a
+     *    stiffened panel is done on the stiffener and interior elements
+     *    without any load. Dirichlet conditions are not included, since
+     *    they do not contribute to the element residual.
+     *
+     *    The object is attached to a system with
+     *    MAST::NonlinearSystem::set_wetted_surface(), which rebuilds it
+     *    whenever the topology cache is rebuilt. It is used by the elements
+     *    only for the side load map from which it was built, and elements
+     *    that are not in the list use the search of the load map. The
+     *    list must be rebuilt with init() if the load map is modified.
+     */
+    class WettedSurface {
+        
+    public:
+        
+        /*!
+         *   load on a side of an element
+         */
+        struct SideLoad {
+            
+            SideLoad(): side(0), bc(nullptr) { }
+            
+            unsigned int                  side;
+            MAST::BoundaryConditionBase*  bc;
+        };
+        
+        
+        WettedSurface(const MAST::SideBCMapType& bc);
+        
+        virtual ~WettedSurface();
+        
+        
+        /*!
+         *   builds the list of loaded sides of the elements in \p topology
+         */
+        void init(const MAST::ElementTopologyCache& topology);
+        
+        
+        /*!
+         *   clears the data
+         */
+        void clear();
+        
+        
+        /*!
+         *   @returns the load map from which the list is built
+         */
+        const MAST::SideBCMapType& side_loads() const {
+            return _bc;
+        }
+        
+        
+        /*!
+         *   @returns the number of local elements with at least one
+         *   loaded side
+         */
+        unsigned int n_wetted_elems() const {
+            return (unsigned int)_wetted_elems.size();
+        }
+        
+        
+        /*!
+         *   @returns the number of loaded sides
+         */
+        unsigned int n_side_loads() const {
+            return (unsigned int)_loads.size();
+        }
+        
+        
+        /*!
+         *   sets [\p begin, \p end) to the loads on the sides of \p e,
+         *   which are in the order of the sides, of the boundary ids of a
+         *   side, and of the loads of a boundary id in \p bc. @returns
+         *   \p false if the list is not built from \p bc or \p e is not in
+         *   the list, in which case the load map should be searched.
+         */
+        bool side_loads(const libMesh::Elem& e,
+                        const MAST::SideBCMapType& bc,
+                        const SideLoad*& begin,
+                        const SideLoad*& end) const;
+        
+        
+        /*!
+         *   @returns the number of bytes used by the list
+         */
+        std::size_t memory() const;
+        
+    protected:
+        
+        /*!
+         *   load map from which the list is built
+         */
+        const MAST::SideBCMapType&                  _bc;
+        
+        /*!
+         *   topology cache that provides the element indices
+         */
+        const MAST::ElementTopologyCache*           _topology;
+        
+        /*!
+         *   loads of the element with index \p i in the topology
+         *   cache are in [_offset[i], _offset[i+1]) of \p _loads
+         */
+        std::vector<unsigned int>                   _offset;
+        
+        std::vector<MAST::WettedSurface::SideLoad>  _loads;
+        
+        /*!
+         *   topology cache indices of the elements with loads
+         */
+        std::vector<unsigned int>                   _wetted_elems;
+    };
+}
+
+
+#endif // __mast__wetted_surface__
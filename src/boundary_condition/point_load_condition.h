@@ -34,7 +34,15 @@ namespace MAST {
     /*!
      *   This class allows for the specification of load associated with 
      *   specified nodes in a user-provided set. The user is responsible for
-     *   maintaining consistency of the nodes during mesh-refinement.
+     *   maintaining consistency of the nodes during mesh-refinement. The
+     *   load is the function \p "load" of type
+     *   MAST::FieldFunction<RealVectorX>, with three components of force
+     *   for MAST::POINT_LOAD and of moment for MAST::POINT_MOMENT, which is
+     *   evaluated at the location of the nodes. The loads are added to the
+     *   residual by MAST::StructuralNonlinearAssembly. The dofs of the
+     *   nodes are collected once, and the nodes must not be changed
+     *   afterwards without a call to clear_mesh_dependent_data() of the
+     *   assembly.
      */
     class PointLoadCondition:
     public MAST::BoundaryConditionBase {
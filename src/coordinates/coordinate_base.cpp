@@ -22,7 +22,9 @@
 
 
 MAST::CoordinateBase::CoordinateBase(const std::string& nm):
-MAST::FieldFunction<RealMatrixX>(nm) {
+MAST::FieldFunction<RealMatrixX>(nm),
+_transformation_cache(false),
+_transformation_version(0) {
     
 }
 
@@ -102,3 +104,149 @@ stress_strain_transformation_matrix_sens(const RealMatrixX& T,
 }
 
 
+
+void
+MAST::CoordinateBase::set_transformation_cache(bool f) {
+    
+    std::lock_guard<std::mutex> lock(_transformation_mutex);
+    
+    _transformation_cache   = f;
+    _transformation_version = this->version();
+    _transformation.clear();
+    _transformation_sens.clear();
+}
+
+
+
+void
+MAST::CoordinateBase::clear_transformation_cache() {
+    
+    std::lock_guard<std::mutex> lock(_transformation_mutex);
+    
+    _transformation.clear();
+    _transformation_sens.clear();
+}
+
+
+
+void
+MAST::CoordinateBase::
+transformation_matrices(const libMesh::Point& p,
+                        const Real t,
+                        RealMatrixX& A,
+                        RealMatrixX& Tinv) const {
+    
+    if (!_transformation_cache) {
+        
+        (*this)(p, t, A);
+        this->stress_strain_transformation_matrix(A.transpose(), Tinv);
+        return;
+    }
+    
+    const std::pair<libMesh::Point, Real>
+    key = this->is_constant()?
+    std::make_pair(libMesh::Point(), 0.): std::make_pair(p, t);
+    
+    {
+        std::lock_guard<std::mutex> lock(_transformation_mutex);
+        
+        _check_transformation_version();
+        
+        std::map<std::pair<libMesh::Point, Real>, TransformationData>::const_iterator
+        it = _transformation.find(key);
+        
+        if (it != _transformation.end()) {
+            
+            A    = it->second.A;
+            Tinv = it->second.Tinv;
+            return;
+        }
+    }
+    
+    // the matrices are computed outside the lock
+    (*this)(p, t, A);
+    this->stress_strain_transformation_matrix(A.transpose(), Tinv);
+    
+    std::lock_guard<std::mutex> lock(_transformation_mutex);
+    
+    TransformationData& d = _transformation[key];
+    d.A    = A;
+    d.Tinv = Tinv;
+}
+
+
+
+void
+MAST::CoordinateBase::
+transformation_matrices_sens(const MAST::FunctionBase& f,
+                             const libMesh::Point& p,
+                             const Real t,
+                             RealMatrixX& dA,
+                             RealMatrixX& dTinv) const {
+    
+    if (!this->depends_on(f)) {
+        
+        dA    = RealMatrixX::Zero(3, 3);
+        dTinv = RealMatrixX::Zero(6, 6);
+        return;
+    }
+    
+    const std::pair<const MAST::FunctionBase*, std::pair<libMesh::Point, Real> >
+    key = std::make_pair(&f, this->is_constant()?
+                         std::make_pair(libMesh::Point(), 0.): std::make_pair(p, t));
+    
+    if (_transformation_cache) {
+        
+        std::lock_guard<std::mutex> lock(_transformation_mutex);
+        
+        _check_transformation_version();
+        
+        std::map<std::pair<const MAST::FunctionBase*, std::pair<libMesh::Point, Real> >,
+        TransformationData>::const_iterator
+        it = _transformation_sens.find(key);
+        
+        if (it != _transformation_sens.end()) {
+            
+            dA    = it->second.A;
+            dTinv = it->second.Tinv;
+            return;
+        }
+    }
+    
+    RealMatrixX
+    A,
+    Tinv;
+    
+    this->transformation_matrices(p, t, A, Tinv);
+    this->derivative(f, p, t, dA);
+    this->stress_strain_transformation_matrix_sens(A.transpose(),
+                                                   dA.transpose(),
+                                                   dTinv);
+    
+    if (!_transformation_cache)
+        return;
+    
+    std::lock_guard<std::mutex> lock(_transformation_mutex);
+    
+    TransformationData& d = _transformation_sens[key];
+    d.A    = dA;
+    d.Tinv = dTinv;
+}
+
+
+
+void
+MAST::CoordinateBase::_check_transformation_version() const {
+    
+    // this is called with _transformation_mutex locked
+    const unsigned long long
+    v = this->version();
+    
+    if (v != _transformation_version) {
+        
+        _transformation_version = v;
+        _transformation.clear();
+        _transformation_sens.clear();
+    }
+}
+
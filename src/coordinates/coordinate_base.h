@@ -21,6 +21,10 @@
 #ifndef __mast__coordinate_base__
 #define __mast__coordinate_base__
 
+// C++ includes
+#include <map>
+#include <mutex>
+
 
 // MAST includes
 #include "base/field_function_base.h"
@@ -54,8 +58,101 @@ namespace MAST {
         void stress_strain_transformation_matrix_sens(const RealMatrixX& T,
                                                       const RealMatrixX& dT,
                                                       RealMatrixX& mat) const;
+        
+        
+        /*!
+         *   tells the coordinate to store the orientation matrix and the
+         *   stress-strain transformation matrix, and their sensitivities,
+         *   for each point and time at which they are evaluated with
+         *   transformation_matrices(). The stored values are discarded
+         *   when the version() of this coordinate changes. This is \p false
+         *   by default.
+         */
+        void set_transformation_cache(bool f);
+        
+        
+        /*!
+         *   @returns \p true if the transformation matrices are stored
+         */
+        bool if_transformation_cache() const {
+            return _transformation_cache;
+        }
+        
+        
+        /*!
+         *   discards the stored transformation matrices
+         */
+        void clear_transformation_cache();
+        
+        
+        /*!
+         *   computes the orientation matrix \p A at \p p and \p t, and the
+         *   matrix \p Tinv from stress_strain_transformation_matrix() for
+         *   \p A^T, which rotates the constitutive matrices of orthotropic
+         *   materials to the global coordinate system. These are taken from
+         *   the cache, if enabled.
+         */
+        void transformation_matrices(const libMesh::Point& p,
+                                     const Real t,
+                                     RealMatrixX& A,
+                                     RealMatrixX& Tinv) const;
+        
+        
+        /*!
+         *   computes the sensitivities of the matrices of
+         *   transformation_matrices() with respect to \p f. These are zero
+         *   if the coordinate does not depend on \p f, which is the case
+         *   for most design variables.
+         */
+        void transformation_matrices_sens(const MAST::FunctionBase& f,
+                                          const libMesh::Point& p,
+                                          const Real t,
+                                          RealMatrixX& dA,
+                                          RealMatrixX& dTinv) const;
+        
     protected:
         
+        /*!
+         *   orientation and transformation matrices stored for a point
+         */
+        struct TransformationData {
+            RealMatrixX A, Tinv;
+        };
+        
+        
+        /*!
+         *   clears the stored values if the version of this coordinate
+         *   has changed since they were computed. This is called with
+         *   \p _transformation_mutex locked.
+         */
+        void _check_transformation_version() const;
+        
+        
+        /*!
+         *   flag to store the transformation matrices
+         */
+        bool _transformation_cache;
+        
+        /*!
+         *   version of this coordinate for which the stored matrices were
+         *   computed
+         */
+        mutable unsigned long long _transformation_version;
+        
+        /*!
+         *   stored values, and sensitivities for each function
+         */
+        mutable std::map<std::pair<libMesh::Point, Real>, TransformationData>
+        _transformation;
+        
+        mutable std::map<std::pair<const MAST::FunctionBase*, std::pair<libMesh::Point, Real> >,
+        TransformationData> _transformation_sens;
+        
+        /*!
+         *   the cache is shared by the functions of all elements that use
+         *   this coordinate, which can be evaluated in parallel threads
+         */
+        mutable std::mutex _transformation_mutex;
     };
 }
 
@@ -20,79 +20,83 @@
 #ifndef mast_dkt_bending_operator_h
 #define mast_dkt_bending_operator_h
 
+// C++ includes
+#include <memory>
+
+
 // MAST includes
 #include "elasticity/bending_operator.h"
 
 
 // libMesh includes
 #include "libmesh/elem.h"
-#include "libmesh/face_tri3.h"
 #include "libmesh/face_tri6.h"
 #include "libmesh/node.h"
 #include "libmesh/fe.h"
-#include "libmesh/quadrature.h"
 
 
 namespace MAST
 {
+    /*!
+     *   Discrete Kirchhoff triangle bending operator. The rotations are
+     *   interpolated with the quadratic shape functions of a TRI6 element
+     *   defined on the corner nodes, and are written in terms of the
+     *   nodal deflections and rotations with the transformation of Batoz,
+     *   which depends only on the edge lengths and normals. The bending
+     *   strain operator at each point is therefore computed once on
+     *   construction, and is only scaled by the z-location when requested.
+     */
     class DKTBendingOperator:
     public MAST::BendingOperator2D {
     public:
         DKTBendingOperator(MAST::StructuralElementBase& elem,
                            const std::vector<libMesh::Point>& pts):
-        MAST::BendingOperator2D(elem),
-        _fe(nullptr),
-        _tri6(nullptr),
-        _nodes(3)
+        MAST::BendingOperator2D(elem)
         {
             libmesh_assert(_elem.type() == libMesh::TRI3);
             
-            _tri6 = new libMesh::Tri6;
+            libMesh::Tri6 tri6;
             
             // next three nodes are created using the corner nodes
-            for (unsigned int i=0; i<3; i++)
-                _nodes[i] = new libMesh::Node;
+            libMesh::Node nodes[3];
             
             // first edge
             libMesh::Point p;
             p = *_elem.get_node(0); p += *_elem.get_node(1); p*= 0.5;
-            (*_nodes[0]) = p;
-            _nodes[0]->set_id(3);
+            nodes[0] = p;
+            nodes[0].set_id(3);
             
             // second edge
             p = *_elem.get_node(1); p += *_elem.get_node(2); p*= 0.5;
-            (*_nodes[1]) = p;
-            _nodes[1]->set_id(4);
+            nodes[1] = p;
+            nodes[1].set_id(4);
             
             // third edge
             p = *_elem.get_node(2); p += *_elem.get_node(0); p*= 0.5;
-            (*_nodes[2]) = p;
-            _nodes[2]->set_id(5);
+            nodes[2] = p;
+            nodes[2].set_id(5);
             
             // first three nodes are same as that of the original element
             for (unsigned int i=0; i<3; i++) {
-                _tri6->set_node(  i) = _elem.get_node(i);
-                _tri6->set_node(i+3) = _nodes[i];
+                tri6.set_node(  i) = _elem.get_node(i);
+                tri6.set_node(i+3) = &nodes[i];
             }
             
             // now setup the shape functions
-            _fe = libMesh::FEBase::build(2, libMesh::FEType(libMesh::SECOND,
-                                                            libMesh::LAGRANGE)).release();
-            _fe->get_phi();
-            _fe->get_dphi();
-            _fe->reinit(_tri6, &pts);
+            std::auto_ptr<libMesh::FEBase>
+            fe(libMesh::FEBase::build(2, libMesh::FEType(libMesh::SECOND,
+                                                         libMesh::LAGRANGE)).release());
+            fe->get_dphi();
+            fe->reinit(&tri6, &pts);
+            
+            _init_bending_strain_operators(*fe);
         }
         
         
         /*!
          *   destructor
          */
-        virtual ~DKTBendingOperator() {
-            delete _fe;
-            delete _tri6;
-            for (unsigned int i=0; i<3; i++)
-                delete _nodes[i];
-        }
+        virtual ~DKTBendingOperator() { }
         
         /*!
          *   returns true if this bending operator supports a transverse shear component
@@ -125,6 +129,12 @@ namespace MAST
         
     protected:
         
+        /*!
+         *   computes the bending strain operator at all points of \p fe,
+         *   which is the TRI6 finite element initialized at these points
+         */
+        void _init_bending_strain_operators(const libMesh::FEBase& fe);
+        
         /*!
          *   returns the length of the side defined by vector from node i to j
          */
@@ -145,19 +155,11 @@ namespace MAST
         
         
         /*!
-         *   FE object to get shape functions for this element
-         */
-        libMesh::FEBase* _fe;
-        
-        /*!
-         *   6 noded triangle that is used to calculate the shape functions
+         *   bending strain operator at each point, with the rows for the
+         *   x, y and xy curvatures, and columns for the w, thetax and
+         *   thetay dofs of the three nodes
          */
-        libMesh::Elem* _tri6;
-        
-        /*!
-         *    vector to store node pointers for the mid-sized nodes
-         */
-        std::vector<libMesh::Node*> _nodes;
+        std::vector<RealMatrixX> _B;
     };
 }
 
@@ -183,76 +185,78 @@ initialize_bending_strain_operator_for_z (const libMesh::FEBase& fe,
                                           const Real z,
                                           FEMOperatorMatrix& Bmat) {
     
-    // the DKT operator uses its own fe object, and not the one from this argument
-    const std::vector<std::vector<libMesh::RealVectorValue> >& dphi = _fe->get_dphi();
-    const unsigned int n_phi = (unsigned int)dphi.size();
+    // the DKT operator uses its own shape functions, and not the ones
+    // from this argument
+    libmesh_assert_less(qp, _B.size());
     
-    RealVectorX
-    phi       = RealVectorX::Zero(n_phi),
-    dbetaxdx  = RealVectorX::Zero(9),
-    dbetaxdy  = RealVectorX::Zero(9),
-    dbetaydx  = RealVectorX::Zero(9),
-    dbetaydy  = RealVectorX::Zero(9),
-    w         = RealVectorX::Zero(3),
-    thetax    = RealVectorX::Zero(3),
-    thetay    = RealVectorX::Zero(3);
-
-    
-    for ( unsigned int i_nd=0; i_nd<n_phi; i_nd++ )
-        phi(i_nd) = dphi[i_nd][qp](0);  // dphi/dx
-    _calculate_dkt_shape_functions(phi, dbetaxdx, dbetaydx);
-    
-    for ( unsigned int i_nd=0; i_nd<n_phi; i_nd++ )
-        phi(i_nd) = dphi[i_nd][qp](1);  // dphi/dy
-    _calculate_dkt_shape_functions(phi, dbetaxdy, dbetaydy);
-    
-    // add the shear components together
-    dbetaxdy += dbetaydx;
+    const RealMatrixX& B = _B[qp];
     
+    RealVectorX
+    phi = RealVectorX::Zero(3);
     
-    // now set values for individual dofs
-    for (unsigned int i=0; i<3; i++) {
-        w(i)      = dbetaxdx(  i);
-        thetax(i) = dbetaxdx(3+i);
-        thetay(i) = dbetaxdx(6+i);
-    }
+    // the rows are epsilon-x, epsilon-y and gamma-xy, and the columns
+    // are the w, tx and ty dofs
+    for (unsigned int i=0; i<3; i++)
+        for (unsigned int j=0; j<3; j++) {
+            
+            phi = z * B.block(i, 3*j, 1, 3).transpose();
+            Bmat.set_shape_function(i, 2+j, phi);
+        }
+}
+
+
+
+inline
+void
+MAST::DKTBendingOperator::
+_init_bending_strain_operators(const libMesh::FEBase& fe) {
     
-    w       *= z;
-    thetax  *= z;
-    thetay  *= z;
+    const std::vector<std::vector<libMesh::RealVectorValue> >& dphi = fe.get_dphi();
+    const unsigned int
+    n_phi = (unsigned int)dphi.size(),
+    n_qp  = n_phi ? (unsigned int)dphi[0].size() : 0;
     
-    Bmat.set_shape_function(0, 2,      w); // epsilon-x: w
-    Bmat.set_shape_function(0, 3, thetax); // epsilon-x: tx
-    Bmat.set_shape_function(0, 4, thetay); // epsilon-x: ty
+    // the rotations are linear in the TRI6 shape functions, and the
+    // transformation matrices are obtained from the shape functions
+    // of each node
+    RealMatrixX
+    Hx = RealMatrixX::Zero(9, n_phi),
+    Hy = RealMatrixX::Zero(9, n_phi);
     
+    RealVectorX
+    phi    = RealVectorX::Zero(n_phi),
+    betax  = RealVectorX::Zero(9),
+    betay  = RealVectorX::Zero(9);
     
-    for (unsigned int i=0; i<3; i++) {
-        w(i)      = dbetaydy(  i);
-        thetax(i) = dbetaydy(3+i);
-        thetay(i) = dbetaydy(6+i);
+    for (unsigned int i_nd=0; i_nd<n_phi; i_nd++) {
+        
+        phi.setZero();
+        phi(i_nd) = 1.;
+        _calculate_dkt_shape_functions(phi, betax, betay);
+        Hx.col(i_nd) = betax;
+        Hy.col(i_nd) = betay;
     }
     
-    w       *= z;
-    thetax  *= z;
-    thetay  *= z;
+    RealVectorX
+    dphidx = RealVectorX::Zero(n_phi),
+    dphidy = RealVectorX::Zero(n_phi);
     
-    Bmat.set_shape_function(1, 2,      w); // epsilon-x: w
-    Bmat.set_shape_function(1, 3, thetax); // epsilon-x: tx
-    Bmat.set_shape_function(1, 4, thetay); // epsilon-x: ty
+    _B.resize(n_qp);
     
-    for (unsigned int i=0; i<3; i++) {
-        w(i)      = dbetaxdy(  i);
-        thetax(i) = dbetaxdy(3+i);
-        thetay(i) = dbetaxdy(6+i);
+    for (unsigned int qp=0; qp<n_qp; qp++) {
+        
+        for ( unsigned int i_nd=0; i_nd<n_phi; i_nd++ ) {
+            dphidx(i_nd) = dphi[i_nd][qp](0);
+            dphidy(i_nd) = dphi[i_nd][qp](1);
+        }
+        
+        RealMatrixX& B = _B[qp];
+        B = RealMatrixX::Zero(3, 9);
+        
+        B.row(0) = (Hx * dphidx).transpose();                  // dbetax/dx
+        B.row(1) = (Hy * dphidy).transpose();                  // dbetay/dy
+        B.row(2) = (Hx * dphidy + Hy * dphidx).transpose();    // shear
     }
-    
-    w       *= z;
-    thetax  *= z;
-    thetay  *= z;
-    
-    Bmat.set_shape_function(2, 2,      w); // epsilon-x: w
-    Bmat.set_shape_function(2, 3, thetax); // epsilon-x: tx
-    Bmat.set_shape_function(2, 4, thetay); // epsilon-x: ty
 }
 
 
@@ -261,8 +265,8 @@ inline
 Real
 MAST::DKTBendingOperator::_get_edge_length(unsigned int i, unsigned int j)
 {
-    libMesh::Point l = *_tri6->get_node(j);
-    l -= *_tri6->get_node(i);
+    libMesh::Point l = *_elem.get_node(j);
+    l -= *_elem.get_node(i);
     
     return l.size();
 }
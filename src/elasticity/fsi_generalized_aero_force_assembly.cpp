@@ -26,6 +26,7 @@
 #include "base/complex_mesh_field_function.h"
 #include "fluid/pressure_function.h"
 #include "fluid/frequency_domain_pressure_function.h"
+#include "fluid/frequency_domain_fluid_rom.h"
 #include "base/complex_assembly_base.h"
 #include "base/physics_discipline_base.h"
 #include "base/system_initialization.h"
@@ -33,6 +34,7 @@
 #include "property_cards/element_property_card_base.h"
 #include "numerics/utility.h"
 #include "base/nonlinear_system.h"
+#include "base/performance_log.h"
 
 
 // libMesh includes
@@ -52,7 +54,10 @@ MAST::StructuralFluidInteractionAssembly(),
 _fluid_complex_solver           (nullptr),
 _pressure_function              (nullptr),
 _freq_domain_pressure_function  (nullptr),
-_complex_displ                  (nullptr)
+_complex_displ                  (nullptr),
+_multiple_rhs_solve             (false),
+_fluid_rom                      (nullptr),
+_fluid_rom_tol                  (1.e-3)
 { }
 
 
@@ -110,6 +115,9 @@ assemble_generalized_aerodynamic_force_matrix
  ComplexMatrixX& mat,
  MAST::Parameter* p) {
     
+    MAST_LOG_SCOPE("assemble_generalized_aerodynamic_force_matrix()",
+                   "FSIGeneralizedAeroForceAssembly");
+    
     // make sure the data provided is sane
     libmesh_assert(_complex_displ);
     
@@ -118,17 +126,7 @@ assemble_generalized_aerodynamic_force_matrix
     unsigned int
     n_basis = (unsigned int)basis.size();
     
-
-    // iterate over each element, initialize it and get the relevant
-    // analysis quantities
-    RealVectorX    sol;
-    ComplexVectorX vec;
-    RealMatrixX    basis_mat;
-
     mat.setZero(n_basis, n_basis);
-
-    std::vector<libMesh::dof_id_type> dof_indices;
-    std::auto_ptr<MAST::ElementBase> physics_elem;
     
     std::auto_ptr<libMesh::NumericVector<Real> >
     localized_solution,
@@ -151,6 +149,57 @@ assemble_generalized_aerodynamic_force_matrix
         _sol_function->init( *_base_sol);
     
     
+    // with the multiple right-hand side solve, the fluid boundary-motion
+    // right-hand sides for all modes are assembled first, and are then
+    // solved together with one matrix assembly and preconditioner setup.
+    const bool
+    if_rom          = _fluid_rom && !p,
+    if_multiple_rhs = _multiple_rhs_solve && !p && !if_rom;
+    
+    // storage of the ROM solution
+    std::auto_ptr<libMesh::NumericVector<Real> >
+    rom_R,
+    rom_I;
+    
+    bool
+    new_snapshots = false;
+    
+    if (if_rom) {
+        
+        rom_R.reset(_fluid_complex_solver->real_solution().zero_clone().release());
+        rom_I.reset(_fluid_complex_solver->imag_solution().zero_clone().release());
+    }
+    
+    std::vector<libMesh::NumericVector<Real>*>
+    fluid_sol_R,
+    fluid_sol_I;
+    
+    if (if_multiple_rhs) {
+        
+        std::vector<libMesh::NumericVector<Real>*>
+        rhs(n_basis, nullptr);
+        fluid_sol_R.resize(n_basis, nullptr);
+        fluid_sol_I.resize(n_basis, nullptr);
+        
+        for (unsigned int i=0; i<n_basis; i++) {
+            
+            _complex_displ->clear();
+            _complex_displ->init(*localized_basis[i], *localized_zero);
+            
+            rhs[i]         = _fluid_complex_solver->assemble_block_rhs().release();
+            fluid_sol_R[i] = _fluid_complex_solver->real_solution().zero_clone().release();
+            fluid_sol_I[i] = _fluid_complex_solver->imag_solution().zero_clone().release();
+        }
+        
+        _fluid_complex_solver->solve_block_matrix_multiple_rhs(rhs,
+                                                               fluid_sol_R,
+                                                               fluid_sol_I);
+        
+        for (unsigned int i=0; i<n_basis; i++)
+            delete rhs[i];
+    }
+    
+    
     // iterate over each structural mode to calculate the
     // fluid small-disturbance solution
     for (unsigned int i=0; i<n_basis; i++) {
@@ -160,99 +209,468 @@ assemble_generalized_aerodynamic_force_matrix
         _complex_displ->init(*localized_basis[i], *localized_zero);
         
         
-        // solve the complex smamll-disturbance fluid-equations
-        _fluid_complex_solver->solve_block_matrix(p);
-        
-        // use this solution to initialize the structural boundary conditions
-        _pressure_function->init(_fluid_complex_solver->get_assembly().base_sol());
-        
-        // use this solution to initialize the structural boundary conditions
-        _freq_domain_pressure_function->init
-        (_fluid_complex_solver->get_assembly().base_sol(),
-         _fluid_complex_solver->real_solution(p != nullptr),
-         _fluid_complex_solver->imag_solution(p != nullptr));
-
-        
-        const libMesh::DofMap& dof_map = _system->system().get_dof_map();
+        // the ROM solution is used if its error indicator is small enough
+        bool
+        rom_solution = false;
         
-        // assemble the complex small-disturbance force vector force vector
-        libMesh::MeshBase::const_element_iterator       el     =
-        _system->system().get_mesh().active_local_elements_begin();
-        const libMesh::MeshBase::const_element_iterator end_el =
-        _system->system().get_mesh().active_local_elements_end();
-        
-        
-        for ( ; el != end_el; ++el) {
+        if (if_rom && _fluid_rom->n_basis()) {
             
-            const libMesh::Elem* elem = *el;
+            const Real
+            err = _fluid_rom->solve(*rom_R, *rom_I);
             
-            dof_map.dof_indices (elem, dof_indices);
+            rom_solution = err <= _fluid_rom_tol;
+            
+            libMesh::out
+            << "Fluid ROM mode: " << i
+            << " : error indicator = " << err
+            << (rom_solution? "": " : resampling") << std::endl;
+        }
+        
+        // solve the complex smamll-disturbance fluid-equations
+        if (!if_multiple_rhs && !rom_solution) {
             
-            physics_elem.reset(_build_elem(*elem).release());
+            // the sensitivity solve is linearized about the fluid solution
+            // of this mode, which is not available from an earlier solve
+            if (p)
+                _fluid_complex_solver->solve_block_matrix();
             
-            // get the solution
-            unsigned int ndofs = (unsigned int)dof_indices.size();
-            sol.setZero(ndofs);
-            vec.setZero(ndofs);
-            basis_mat.setZero(ndofs, n_basis);
+            _fluid_complex_solver->solve_block_matrix(p);
             
-            for (unsigned int i=0; i<dof_indices.size(); i++) {
+            if (if_rom) {
                 
-                if (_base_sol)
-                    sol(i) = (*localized_solution)(dof_indices[i]);
-                
-                for (unsigned int j=0; j<n_basis; j++)
-                    basis_mat(i,j) = (*localized_basis[j])(dof_indices[i]);
+                _fluid_rom->add_snapshot(_fluid_complex_solver->real_solution(),
+                                         _fluid_complex_solver->imag_solution());
+                new_snapshots = true;
             }
+        }
+        
+        const libMesh::NumericVector<Real>
+        &dsol_R = rom_solution? *rom_R:
+        (if_multiple_rhs? *fluid_sol_R[i]: _fluid_complex_solver->real_solution(p != nullptr)),
+        &dsol_I = rom_solution? *rom_I:
+        (if_multiple_rhs? *fluid_sol_I[i]: _fluid_complex_solver->imag_solution(p != nullptr));
+        
+        this->_add_generalized_force_column(localized_solution.get(),
+                                            localized_basis,
+                                            dsol_R,
+                                            dsol_I,
+                                            i,
+                                            mat);
+    }
+    
+    
+    
+    // if a solution function is attached, clear it
+    if (_sol_function)
+        _sol_function->clear();
+    
+    
+    // delete the localized basis vectors
+    for (unsigned int i=0; i<basis.size(); i++)
+        delete localized_basis[i];
+    
+    // the basis is updated with the new snapshots for the next evaluation
+    if (new_snapshots)
+        _fluid_rom->build_basis();
+    
+    // delete the fluid solutions of the multiple right-hand side solve
+    for (unsigned int i=0; i<fluid_sol_R.size(); i++) {
+        delete fluid_sol_R[i];
+        delete fluid_sol_I[i];
+    }
+    
+    // sum the matrix and provide it to each processor
+    // this assumes that the structural comm is a subset of fluid comm
+    MAST::parallel_sum(_system->system().comm(), mat);
+}
+
+
+
+void
+MAST::FSIGeneralizedAeroForceAssembly::
+assemble_generalized_aerodynamic_force_matrices
+(std::vector<libMesh::NumericVector<Real>*>& basis,
+ const std::vector<Real>& omega,
+ std::vector<ComplexMatrixX>& mats) {
+    
+    MAST_LOG_SCOPE("assemble_generalized_aerodynamic_force_matrices()",
+                   "FSIGeneralizedAeroForceAssembly");
+    
+    // make sure the data provided is sane
+    libmesh_assert(_complex_displ);
+    
+    const unsigned int
+    n_basis = (unsigned int)basis.size(),
+    n_freq  = (unsigned int)omega.size();
+    
+    mats.resize(n_freq);
+    for (unsigned int k=0; k<n_freq; k++)
+        mats[k].setZero(n_basis, n_basis);
+    
+    std::auto_ptr<libMesh::NumericVector<Real> >
+    localized_solution,
+    localized_zero;
+    std::vector<libMesh::NumericVector<Real>*> localized_basis(n_basis);
+    
+    if (_base_sol)
+        localized_solution.reset(_build_localized_vector(_system->system(),
+                                                         *_base_sol).release());
+    
+    for (unsigned int i=0; i<n_basis; i++)
+        localized_basis[i] = _build_localized_vector(_system->system(), *basis[i]).release();
+    
+    //create a zero-clone copy for the imaginary component of the solution
+    localized_zero.reset(localized_basis[0]->zero_clone().release());
+    
+    
+    // if a solution function is attached, initialize it
+    if (_sol_function && _base_sol)
+        _sol_function->init( *_base_sol);
+    
+    
+    // fluid solutions of a basis vector at all frequencies
+    std::vector<libMesh::NumericVector<Real>*>
+    fluid_sol_R(n_freq, nullptr),
+    fluid_sol_I(n_freq, nullptr);
+    
+    for (unsigned int k=0; k<n_freq; k++) {
+        
+        fluid_sol_R[k] = _fluid_complex_solver->real_solution().zero_clone().release();
+        fluid_sol_I[k] = _fluid_complex_solver->imag_solution().zero_clone().release();
+    }
+    
+    
+    for (unsigned int i=0; i<n_basis; i++) {
+        
+        // set up the fluid flexible-surface boundary condition for this mode
+        _complex_displ->clear();
+        _complex_displ->init(*localized_basis[i], *localized_zero);
+        
+        _fluid_complex_solver->solve_block_matrix_multi_frequency(omega,
+                                                                  fluid_sol_R,
+                                                                  fluid_sol_I);
+        
+        for (unsigned int k=0; k<n_freq; k++)
+            this->_add_generalized_force_column(localized_solution.get(),
+                                                localized_basis,
+                                                *fluid_sol_R[k],
+                                                *fluid_sol_I[k],
+                                                i,
+                                                mats[k]);
+    }
+    
+    
+    // if a solution function is attached, clear it
+    if (_sol_function)
+        _sol_function->clear();
+    
+    for (unsigned int i=0; i<n_basis; i++)
+        delete localized_basis[i];
+    
+    for (unsigned int k=0; k<n_freq; k++) {
+        
+        delete fluid_sol_R[k];
+        delete fluid_sol_I[k];
+        
+        // sum the matrix and provide it to each processor
+        MAST::parallel_sum(_system->system().comm(), mats[k]);
+    }
+}
+
+
+
+void
+MAST::FSIGeneralizedAeroForceAssembly::
+_add_generalized_force_column(const libMesh::NumericVector<Real>* localized_solution,
+                              std::vector<libMesh::NumericVector<Real>*>& localized_basis,
+                              const libMesh::NumericVector<Real>& dsol_R,
+                              const libMesh::NumericVector<Real>& dsol_I,
+                              unsigned int i,
+                              ComplexMatrixX& mat) {
+    
+    const unsigned int
+    n_basis = (unsigned int)localized_basis.size();
+    
+    RealVectorX    sol;
+    ComplexVectorX vec;
+    RealMatrixX    basis_mat;
+    
+    std::vector<libMesh::dof_id_type> dof_indices;
+    std::auto_ptr<MAST::ElementBase> elem_storage;
+    MAST::ElementBase* physics_elem = nullptr;
+    DenseRealVector v1;
+    
+    // use this solution to initialize the structural boundary conditions
+    _pressure_function->init(_fluid_complex_solver->get_assembly().base_sol());
+    
+    // use this solution to initialize the structural boundary conditions
+    _freq_domain_pressure_function->init
+    (_fluid_complex_solver->get_assembly().base_sol(),
+     dsol_R,
+     dsol_I);
+    
+    
+    const libMesh::DofMap& dof_map = _system->system().get_dof_map();
+    const MAST::ElementTopologyCache& topology = _system->system().topology_cache();
+    
+    // assemble the complex small-disturbance force vector force vector
+    libMesh::MeshBase::const_element_iterator       el     =
+    _system->system().get_mesh().active_local_elements_begin();
+    const libMesh::MeshBase::const_element_iterator end_el =
+    _system->system().get_mesh().active_local_elements_end();
+    
+    
+    for ( ; el != end_el; ++el) {
+        
+        const libMesh::Elem* elem = *el;
+        
+        topology.dof_indices (elem, dof_indices);
+        
+        physics_elem = &_get_elem(*elem, elem_storage);
+        
+        // get the solution
+        unsigned int ndofs = (unsigned int)dof_indices.size();
+        sol.setZero(ndofs);
+        vec.setZero(ndofs);
+        basis_mat.setZero(ndofs, n_basis);
+        
+        if (localized_solution)
+            _get_elem_values(*localized_solution, dof_indices, sol);
+        
+        _get_elem_values(localized_basis, dof_indices, basis_mat);
+        
+        
+        physics_elem->set_solution(sol);
+        sol.setZero();
+        physics_elem->set_velocity(sol);     // set to zero value
+        physics_elem->set_acceleration(sol); // set to zero value
+        
+        
+        if (_sol_function)
+            physics_elem->attach_active_solution_function(*_sol_function);
+        
+        _elem_aerodynamic_force_calculations(*physics_elem, vec);
+        
+        RealVectorX     v2;
+        
+        // constrain and set the real component
+        MAST::copy(v1, vec.real());
+        dof_map.constrain_element_vector(v1, dof_indices);
+        MAST::copy(v2, v1);
+        vec.real() =  v2;
+        
+        // constrain and set the imag component
+        MAST::copy(v1, vec.imag());
+        dof_map.constrain_element_vector(v1, dof_indices);
+        MAST::copy(v2, v1);
+        vec.imag() =  v2;
+        
+        // project the force vector on all the structural modes for the
+        // i^th column of the generalized aerodynamic force matrix
+        mat.col(i) += basis_mat.transpose() * vec;
+        
+        physics_elem->detach_active_solution_function();
+    }
+}
+
+
+
+void
+MAST::FSIGeneralizedAeroForceAssembly::
+assemble_generalized_aerodynamic_force_adjoint_sensitivity
+(std::vector<libMesh::NumericVector<Real>*>& basis,
+ const ComplexVectorX& psi,
+ const ComplexVectorX& phi,
+ const std::vector<MAST::Parameter*>& params,
+ ComplexVectorX& dq) {
+    
+    MAST_LOG_SCOPE("assemble_generalized_aerodynamic_force_adjoint_sensitivity()",
+                   "FSIGeneralizedAeroForceAssembly");
+    
+    // make sure the data provided is sane
+    libmesh_assert(_complex_displ);
+    libmesh_assert(_freq_domain_pressure_function);
+    
+    unsigned int
+    n_basis = (unsigned int)basis.size();
+    
+    libmesh_assert_equal_to(psi.size(), n_basis);
+    libmesh_assert_equal_to(phi.size(), n_basis);
+    
+    RealVectorX    sol;
+    ComplexVectorX vec, w;
+    RealMatrixX    basis_mat;
+    
+    std::vector<libMesh::dof_id_type> dof_indices;
+    std::auto_ptr<MAST::ElementBase> elem_storage;
+    MAST::ElementBase* physics_elem = nullptr;
+    DenseRealVector v1;
+    
+    std::auto_ptr<libMesh::NumericVector<Real> >
+    localized_solution,
+    motion_R,
+    motion_I;
+    std::vector<libMesh::NumericVector<Real>*> localized_basis(n_basis);
+    
+    if (_base_sol)
+        localized_solution.reset(_build_localized_vector(_system->system(),
+                                                         *_base_sol).release());
+    
+    for (unsigned int i=0; i<n_basis; i++)
+        localized_basis[i] = _build_localized_vector(_system->system(), *basis[i]).release();
+    
+    // the structural motion of the right eigenvector
+    motion_R.reset(localized_basis[0]->zero_clone().release());
+    motion_I.reset(localized_basis[0]->zero_clone().release());
+    
+    for (unsigned int i=0; i<n_basis; i++) {
+        
+        motion_R->add(std::real(phi(i)), *localized_basis[i]);
+        motion_I->add(std::imag(phi(i)), *localized_basis[i]);
+    }
+    
+    motion_R->close();
+    motion_I->close();
+    
+    
+    // if a solution function is attached, initialize it
+    if (_sol_function && _base_sol)
+        _sol_function->init( *_base_sol);
+    
+    _pressure_function->init(_fluid_complex_solver->get_assembly().base_sol());
+    
+    
+    // psi^T A phi is the sum over the structural quadrature points of the
+    // small-disturbance pressure times a weight. The structural force is
+    // linear in the pressure at each point, so the weights are obtained by
+    // evaluating the element force with a unit pressure at one point at a
+    // time, which is inexpensive compared to a fluid solve.
+    std::vector<libMesh::Point>
+    pts;
+    std::vector<Complex>
+    weights;
+    
+    const libMesh::DofMap& dof_map = _system->system().get_dof_map();
+    const MAST::ElementTopologyCache& topology = _system->system().topology_cache();
+    
+    libMesh::MeshBase::const_element_iterator       el     =
+    _system->system().get_mesh().active_local_elements_begin();
+    const libMesh::MeshBase::const_element_iterator end_el =
+    _system->system().get_mesh().active_local_elements_end();
+    
+    for ( ; el != end_el; ++el) {
+        
+        const libMesh::Elem* elem = *el;
+        
+        topology.dof_indices (elem, dof_indices);
+        
+        physics_elem = &_get_elem(*elem, elem_storage);
+        
+        unsigned int ndofs = (unsigned int)dof_indices.size();
+        sol.setZero(ndofs);
+        vec.setZero(ndofs);
+        basis_mat.setZero(ndofs, n_basis);
+        
+        if (_base_sol)
+            _get_elem_values(*localized_solution, dof_indices, sol);
+        
+        _get_elem_values(localized_basis, dof_indices, basis_mat);
+        
+        // the left eigenvector on the element dofs
+        w = basis_mat.cast<Complex>() * psi;
+        
+        physics_elem->set_solution(sol);
+        sol.setZero();
+        physics_elem->set_velocity(sol);     // set to zero value
+        physics_elem->set_acceleration(sol); // set to zero value
+        
+        if (_sol_function)
+            physics_elem->attach_active_solution_function(*_sol_function);
+        
+        unsigned int
+        n_pts = 1;
+        
+        for (unsigned int k=0; k<n_pts; k++) {
             
-            
-            physics_elem->set_solution(sol);
-            sol.setZero();
-            physics_elem->set_velocity(sol);     // set to zero value
-            physics_elem->set_acceleration(sol); // set to zero value
-            
-            
-            if (_sol_function)
-                physics_elem->attach_active_solution_function(*_sol_function);
+            _freq_domain_pressure_function->set_probe(true, k);
             
             _elem_aerodynamic_force_calculations(*physics_elem, vec);
             
-            DenseRealVector v1;
             RealVectorX     v2;
             
-            // constrain and set the real component
+            // constrain the real and imag components
             MAST::copy(v1, vec.real());
             dof_map.constrain_element_vector(v1, dof_indices);
             MAST::copy(v2, v1);
             vec.real() =  v2;
             
-            // constrain and set the imag component
             MAST::copy(v1, vec.imag());
             dof_map.constrain_element_vector(v1, dof_indices);
             MAST::copy(v2, v1);
             vec.imag() =  v2;
             
-            // project the force vector on all the structural modes for the
-            // i^th column of the generalized aerodynamic force matrix
-            mat.col(i) += basis_mat.transpose() * vec;
+            if (k == 0) {
+                
+                const std::vector<libMesh::Point>&
+                p = _freq_domain_pressure_function->probe_points();
+                
+                n_pts = (unsigned int)p.size();
+                pts.insert(pts.end(), p.begin(), p.end());
+            }
             
-            physics_elem->detach_active_solution_function();
+            if (n_pts)
+                weights.push_back((w.array() * vec.array()).sum());
         }
+        
+        physics_elem->detach_active_solution_function();
     }
     
-    
+    _freq_domain_pressure_function->set_probe(false);
     
     // if a solution function is attached, clear it
     if (_sol_function)
         _sol_function->clear();
     
     
+    // the adjoint load is the derivative of the functional with respect
+    // to the small-disturbance fluid solution
+    libMesh::NumericVector<Real>
+    &fluid_sol = _fluid_complex_solver->real_solution();
+    
+    std::auto_ptr<libMesh::NumericVector<Real> >
+    b_R(fluid_sol.zero_clone().release()),
+    b_I(fluid_sol.zero_clone().release()),
+    lambda_R(fluid_sol.zero_clone().release()),
+    lambda_I(fluid_sol.zero_clone().release());
+    
+    _freq_domain_pressure_function->init
+    (_fluid_complex_solver->get_assembly().base_sol(), *b_R, *b_I);
+    
+    ComplexVectorX
+    a = ComplexVectorX::Zero(weights.size());
+    for (unsigned int i=0; i<weights.size(); i++)
+        a(i) = weights[i];
+    
+    _freq_domain_pressure_function->add_adjoint_load(pts, a, *b_R, *b_I);
+    
+    b_R->close();
+    b_I->close();
+    
+    
+    // the fluid solution for the motion of the right eigenvector, about
+    // which the residual sensitivity is computed
+    _complex_displ->clear();
+    _complex_displ->init(*motion_R, *motion_I);
+    
+    _fluid_complex_solver->solve_block_matrix();
+    
+    _fluid_complex_solver->solve_block_matrix_transpose(*b_R, *b_I,
+                                                        *lambda_R, *lambda_I);
+    
+    _fluid_complex_solver->adjoint_sensitivity_product(*lambda_R, *lambda_I,
+                                                       params, dq);
+    
     // delete the localized basis vectors
     for (unsigned int i=0; i<basis.size(); i++)
         delete localized_basis[i];
-    
-    // sum the matrix and provide it to each processor
-    // this assumes that the structural comm is a subset of fluid comm
-    MAST::parallel_sum(_system->system().comm(), mat);
 }
-
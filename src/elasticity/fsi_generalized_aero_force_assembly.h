@@ -35,6 +35,7 @@ namespace MAST {
     class ComplexMeshFieldFunction;
     class StructuralFluidInteractionAssembly;
     class Parameter;
+    class FrequencyDomainFluidROM;
     
     class FSIGeneralizedAeroForceAssembly:
     public MAST::StructuralFluidInteractionAssembly {
@@ -87,8 +88,109 @@ namespace MAST {
          ComplexMatrixX& mat,
          MAST::Parameter* p = nullptr);
         
+        
+        /*!
+         *   calculates the generalized aerodynamic force matrix on
+         *   \p basis for each frequency in \p omega in \p mats. For
+         *   each basis vector, the fluid system is solved for all
+         *   frequencies with
+         *   MAST::ComplexSolverBase::solve_block_matrix_multi_frequency(),
+         *   which assembles the fluid operators once per basis vector
+         *   instead of once per frequency. \p omega is the value of the
+         *   frequency function of the fluid assembly, which must support
+         *   MAST::ComplexAssemblyBase::set_frequency_operator(). The
+         *   structural loads may depend on the frequency only through the
+         *   fluid solution. The ROM and the multiple right-hand side solve
+         *   are not used.
+         */
+        void
+        assemble_generalized_aerodynamic_force_matrices
+        (std::vector<libMesh::NumericVector<Real>*>& basis,
+         const std::vector<Real>& omega,
+         std::vector<ComplexMatrixX>& mats);
+        
+        
+        /*!
+         *   computes \f$ \psi^T [dA/dp] \phi \f$ in \p dq for each
+         *   parameter in \p params, where \f$ A \f$ is the generalized
+         *   aerodynamic force matrix on \p basis, and \p psi and \p phi
+         *   are the left and right eigenvectors of a flutter root in the
+         *   coordinates of the basis. The product is a linear functional
+         *   of the fluid solution for the structural motion 
+         *   \f$ \sum_j \phi_j u_j \f$, and its sensitivity is obtained 
+         *   with one fluid solve for this motion and one adjoint solve 
+         *   with MAST::ComplexSolverBase::solve_block_matrix_transpose(),
+         *   followed by an assembly of the fluid residual sensitivity for 
+         *   each parameter. This is independent of the number of basis 
+         *   vectors, while the direct sensitivity with 
+         *   assemble_generalized_aerodynamic_force_matrix() requires a 
+         *   fluid solve for each basis vector and parameter. As with the 
+         *   direct sensitivity, the dependence of the matrix on the 
+         *   parameters is through the small-disturbance fluid solution. 
+         *   The frequency domain pressure function must use a 
+         *   MAST::MeshFieldTransferOperator. The fluid solution of the 
+         *   complex solver is replaced by the solution for 
+         *   \f$ \sum_j \phi_j u_j \f$.
+         */
+        void
+        assemble_generalized_aerodynamic_force_adjoint_sensitivity
+        (std::vector<libMesh::NumericVector<Real>*>& basis,
+         const ComplexVectorX& psi,
+         const ComplexVectorX& phi,
+         const std::vector<MAST::Parameter*>& params,
+         ComplexVectorX& dq);
+        
+        
+        /*!
+         *   tells assemble_generalized_aerodynamic_force_matrix() to
+         *   assemble the fluid right-hand sides for all basis vectors first,
+         *   and to solve them with one matrix assembly and preconditioner
+         *   setup using MAST::ComplexSolverBase::solve_block_matrix_multiple_rhs().
+         *   This keeps the fluid solution for all basis vectors in memory,
+         *   and is not used for sensitivity analysis. This is \p false by
+         *   default.
+         */
+        void set_multiple_rhs_solve(bool f) {
+            _multiple_rhs_solve = f;
+        }
+        
+        
+        /*!
+         *   tells assemble_generalized_aerodynamic_force_matrix() to use
+         *   \p rom for the fluid solutions. For each basis vector, the ROM
+         *   is solved first, and its solution is used if the error
+         *   indicator of the ROM is at most \p tol. Otherwise, the full
+         *   fluid system is solved and its solution is added to the ROM
+         *   snapshots, and the POD basis is rebuilt at the end of the
+         *   assembly. Without a POD basis, all fluid solutions are full
+         *   solves that become snapshots. The ROM is not used for
+         *   sensitivity analysis or with the multiple right-hand side
+         *   solve. A nullptr disables the ROM.
+         */
+        void set_fluid_rom(MAST::FrequencyDomainFluidROM* rom,
+                           Real tol = 1.e-3) {
+            _fluid_rom     = rom;
+            _fluid_rom_tol = tol;
+        }
+        
     protected:
         
+        /*!
+         *   adds the projection of the structural force from the fluid
+         *   solution \p dsol_R, \p dsol_I on the localized basis vectors
+         *   \p localized_basis to column \p i of \p mat, for the local
+         *   elements. \p localized_solution is the localized structural
+         *   base solution, or \p nullptr.
+         */
+        void
+        _add_generalized_force_column(const libMesh::NumericVector<Real>* localized_solution,
+                                      std::vector<libMesh::NumericVector<Real>*>& localized_basis,
+                                      const libMesh::NumericVector<Real>& dsol_R,
+                                      const libMesh::NumericVector<Real>& dsol_I,
+                                      unsigned int i,
+                                      ComplexMatrixX& mat);
+        
+        
         /*!
          *   complex solver
          */
@@ -112,6 +214,22 @@ namespace MAST {
          *   flexible surface motion for fluid and structure
          */
         MAST::ComplexMeshFieldFunction             *_complex_displ;
+
+        
+        /*!
+         *   flag to solve the fluid equations for all basis vectors with
+         *   multiple right-hand sides
+         */
+        bool                                        _multiple_rhs_solve;
+        
+        
+        /*!
+         *   reduced-order model of the fluid, and the tolerance on its
+         *   error indicator
+         */
+        MAST::FrequencyDomainFluidROM              *_fluid_rom;
+        
+        Real                                        _fluid_rom_tol;
     };
 }
 
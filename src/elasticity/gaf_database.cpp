@@ -0,0 +1,748 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2017  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+// C++ includes
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <cmath>
+#include <cstring>
+
+
+// MAST includes
+#include "elasticity/gaf_database.h"
+#include "base/parameter.h"
+#include "aeroelasticity/frequency_function.h"
+#include "base/memory_report.h"
+#include "elasticity/gaf_table.h"
+#include "numerics/basis_alignment.h"
+#include "base/performance_log.h"
+
+// libMesh includes
+#include "libmesh/parallel.h"
+
+
+MAST::GAFDatabase::GAFDatabase(const unsigned int n_modes):
+MAST::FSIGeneralizedAeroForceAssembly(),
+_freq(nullptr),
+_if_evaluate(true),
+_if_adaptive(false),
+_kr_tol(0.),
+_n_modes(n_modes),
+_rfa_valid(false) { }
+
+
+
+void
+MAST::GAFDatabase::init(MAST::FrequencyFunction*                        freq,
+                        MAST::ComplexSolverBase*                complex_solver,
+                        MAST::PressureFunction*                 pressure_func,
+                        MAST::FrequencyDomainPressureFunction*  freq_pressure_func,
+                        MAST::ComplexMeshFieldFunction*         displ_func) {
+    
+    _freq = freq;
+    MAST::FSIGeneralizedAeroForceAssembly::init(complex_solver,
+                                                pressure_func,
+                                                freq_pressure_func,
+                                                displ_func);
+}
+
+
+
+void
+MAST::GAFDatabase::set_evaluate_mode(bool f) {
+    
+    _if_evaluate = f;
+}
+
+
+
+void
+MAST::GAFDatabase::set_adaptive_mode(bool f, Real kr_tol) {
+    
+    libmesh_assert_greater_equal(kr_tol, 0.);
+    
+    _if_adaptive = f;
+    _kr_tol      = kr_tol;
+}
+
+
+
+void
+MAST::GAFDatabase::
+set_rational_function_approximation(const std::vector<Real>& lag_roots) {
+    
+    for (unsigned int i=0; i<lag_roots.size(); i++)
+        libmesh_assert_greater(lag_roots[i], 0.);
+    
+    _rfa_lag_roots = lag_roots;
+    _rfa_coeffs.clear();
+    _rfa_valid     = false;
+}
+
+
+
+void
+MAST::GAFDatabase::clear_gaf_data() {
+    
+    _kr_to_gaf_map.clear();
+    _kr_to_gaf_kr_sens_map.clear();
+    _rfa_coeffs.clear();
+    _rfa_valid = false;
+}
+
+
+
+bool
+MAST::GAFDatabase::transform_gaf_data(const MAST::BasisAlignment& alignment,
+                                      Real tol) {
+    
+    MAST_LOG_SCOPE("transform_gaf_data()", "GAFDatabase");
+    
+    if (alignment.n_old() != _n_modes ||
+        alignment.n_new() != _n_modes ||
+        alignment.subspace_residual() > tol) {
+        
+        clear_gaf_data();
+        return false;
+    }
+    
+    std::map<Real, ComplexMatrixX>::iterator
+    it   = _kr_to_gaf_map.begin(),
+    end  = _kr_to_gaf_map.end();
+    for ( ; it != end; it++)
+        it->second = alignment.transform(it->second);
+    
+    it   = _kr_to_gaf_kr_sens_map.begin();
+    end  = _kr_to_gaf_kr_sens_map.end();
+    for ( ; it != end; it++)
+        it->second = alignment.transform(it->second);
+    
+    // the rational function approximation is fitted again on the next
+    // interpolation
+    _rfa_coeffs.clear();
+    _rfa_valid = false;
+    
+    return true;
+}
+
+
+
+void
+MAST::GAFDatabase::report_memory(MAST::MemoryReport& r,
+                                 const std::string& nm) const {
+    
+    std::size_t v = 0;
+    
+    std::map<Real, ComplexMatrixX>::const_iterator
+    it   = _kr_to_gaf_map.begin(),
+    end  = _kr_to_gaf_map.end();
+    for ( ; it != end; it++)
+        v += MAST::MemoryReport::dense_bytes(it->second);
+    
+    it   = _kr_to_gaf_kr_sens_map.begin();
+    end  = _kr_to_gaf_kr_sens_map.end();
+    for ( ; it != end; it++)
+        v += MAST::MemoryReport::dense_bytes(it->second);
+    
+    r.add(nm, "GAF matrices", v);
+    
+    v = 0;
+    for (unsigned int i=0; i<_rfa_coeffs.size(); i++)
+        v += MAST::MemoryReport::dense_bytes(_rfa_coeffs[i]);
+    
+    r.add(nm, "rational function approximation", v);
+}
+
+
+
+namespace MAST {
+    
+    /*!
+     *   identifies the binary GAF files, followed by the format version
+     */
+    const char         gaf_binary_file_id[8] = "MASTGAF";
+    const unsigned int gaf_binary_file_version = 1;
+    
+    
+    void
+    write_binary_gaf_map(std::ofstream& out,
+                         const std::map<Real, ComplexMatrixX>& data,
+                         const unsigned int n_modes) {
+        
+        const unsigned int n = (unsigned int)data.size();
+        out.write(reinterpret_cast<const char*>(&n), sizeof(unsigned int));
+        
+        std::map<Real, ComplexMatrixX>::const_iterator
+        it  = data.begin(),
+        end = data.end();
+        
+        for ( ; it != end; it++) {
+            
+            libmesh_assert_equal_to(it->second.rows(), n_modes);
+            libmesh_assert_equal_to(it->second.cols(), n_modes);
+            
+            out.write(reinterpret_cast<const char*>(&it->first), sizeof(Real));
+            out.write(reinterpret_cast<const char*>(it->second.data()),
+                      sizeof(Complex)*n_modes*n_modes);
+        }
+    }
+    
+    
+    void
+    read_binary_gaf_map(std::ifstream& input,
+                        std::map<Real, ComplexMatrixX>& data,
+                        const unsigned int n_modes) {
+        
+        unsigned int n = 0;
+        input.read(reinterpret_cast<char*>(&n), sizeof(unsigned int));
+        
+        Real kr = 0.;
+        ComplexMatrixX mat(ComplexMatrixX::Zero(n_modes, n_modes));
+        
+        for (unsigned int i=0; i<n; i++) {
+            
+            input.read(reinterpret_cast<char*>(&kr), sizeof(Real));
+            input.read(reinterpret_cast<char*>(mat.data()),
+                       sizeof(Complex)*n_modes*n_modes);
+            
+            if (!input.good())
+                libmesh_error_msg("Error: reading binary GAF file failed.");
+            
+            data[kr] = mat;
+        }
+    }
+}
+
+
+
+void
+MAST::GAFDatabase::
+write_binary_gaf_file(const std::string& nm,
+                      const libMesh::Parallel::Communicator& comm) const {
+    
+    if (comm.rank() == 0) {
+        
+        std::ofstream out;
+        out.open(nm.c_str(), std::ofstream::out | std::ofstream::binary);
+        
+        if (!out.good())
+            libmesh_error_msg("Error: could not open " << nm << " for writing.");
+        
+        out.write(MAST::gaf_binary_file_id, sizeof(MAST::gaf_binary_file_id));
+        out.write(reinterpret_cast<const char*>(&MAST::gaf_binary_file_version),
+                  sizeof(unsigned int));
+        out.write(reinterpret_cast<const char*>(&_n_modes), sizeof(unsigned int));
+        
+        MAST::write_binary_gaf_map(out, _kr_to_gaf_map, _n_modes);
+        MAST::write_binary_gaf_map(out, _kr_to_gaf_kr_sens_map, _n_modes);
+    }
+    
+    comm.barrier();
+}
+
+
+
+void
+MAST::GAFDatabase::read_binary_gaf_file(const std::string& nm) {
+    
+    std::ifstream input;
+    input.open(nm.c_str(), std::ifstream::in | std::ifstream::binary);
+    
+    if (!input.good())
+        libmesh_error_msg("Error: could not open " << nm << " for reading.");
+    
+    char         id[sizeof(MAST::gaf_binary_file_id)];
+    unsigned int
+    version = 0,
+    n_modes = 0;
+    
+    input.read(id, sizeof(id));
+    input.read(reinterpret_cast<char*>(&version), sizeof(unsigned int));
+    input.read(reinterpret_cast<char*>(&n_modes), sizeof(unsigned int));
+    
+    if (!input.good() ||
+        std::memcmp(id, MAST::gaf_binary_file_id, sizeof(id)) != 0 ||
+        version != MAST::gaf_binary_file_version)
+        libmesh_error_msg("Error: " << nm << " is not a binary GAF file.");
+    
+    if (n_modes != _n_modes)
+        libmesh_error_msg("Error: " << nm << " has GAF matrices for "
+                          << n_modes << " modes, expected " << _n_modes);
+    
+    MAST::read_binary_gaf_map(input, _kr_to_gaf_map, _n_modes);
+    MAST::read_binary_gaf_map(input, _kr_to_gaf_kr_sens_map, _n_modes);
+    
+    _rfa_valid = false;
+}
+
+
+
+void
+MAST::GAFDatabase::read_gaf_table(const MAST::GAFTable& table,
+                                  const Real mach) {
+    
+    if (table.n_modes() != _n_modes)
+        libmesh_error_msg("Error: GAF table has matrices for "
+                          << table.n_modes() << " modes, expected " << _n_modes);
+    
+    _kr_to_gaf_map.clear();
+    _kr_to_gaf_kr_sens_map.clear();
+    
+    for (unsigned int i=0; i<table.n_kr(); i++) {
+        
+        _kr_to_gaf_map[table.kr(i)]         = table.interpolate(mach, table.kr(i), false);
+        _kr_to_gaf_kr_sens_map[table.kr(i)] = table.interpolate(mach, table.kr(i), true);
+    }
+    
+    _rfa_valid = false;
+}
+
+
+void
+MAST::GAFDatabase::write_gaf_file(const std::string& nm,
+                                  std::vector<libMesh::NumericVector<Real>*>& modes) {
+    
+    libMesh::out
+    << " **** Writing GAF database to : " << nm
+    << "   ....  ";
+    
+    std::ofstream out;
+    
+    const unsigned int
+    my_rank = modes[0]->comm().rank();
+    
+    if (my_rank == 0) {
+        out.open(nm, std::ofstream::out);
+    }
+    
+    const unsigned int
+    n_vec_dofs = modes[0]->size(),
+    n_kr       = _kr_to_gaf_map.size();
+    
+    
+    if (my_rank == 0) {
+        
+        out
+        << _n_modes   << std::endl
+        << n_vec_dofs << std::endl
+        << n_kr       << std::endl;
+        
+	//out.precision(std::numeric_limits<Real>::max_digits10);
+        
+        // write the GAFs at each kr first
+        {
+            std::map<Real, ComplexMatrixX>::const_iterator
+            it  = _kr_to_gaf_map.begin(),
+            end = _kr_to_gaf_map.end();
+            
+            for ( ; it != end; it++) {
+                
+                out << it->first << std::endl;
+                
+                const ComplexMatrixX& mat = it->second;
+                libmesh_assert(mat.rows() == _n_modes);
+                libmesh_assert(mat.cols() == _n_modes);
+                
+                for (unsigned int i=0; i<_n_modes; i++) {
+                    for (unsigned int j=0; j<_n_modes; j++)
+                        out
+                        << std::setw(35) << mat(i,j).real()
+                        << std::setw(35) << mat(i,j).imag();
+                    out << std::endl;
+                }
+            }
+        }
+        
+        
+        // next, write the GAF sensitivity wrt kr at each kr
+        {
+            std::map<Real, ComplexMatrixX>::const_iterator
+            it  = _kr_to_gaf_kr_sens_map.begin(),
+            end = _kr_to_gaf_kr_sens_map.end();
+            
+            for ( ; it != end; it++) {
+                
+                out << it->first << std::endl;
+                
+                const ComplexMatrixX& mat = it->second;
+                libmesh_assert_equal_to(mat.rows(), _n_modes);
+                libmesh_assert_equal_to(mat.cols(), _n_modes);
+                
+                for (unsigned int i=0; i<_n_modes; i++) {
+                    for (unsigned int j=0; j<_n_modes; j++)
+                        out
+                        << std::setw(35) << mat(i,j).real()
+                        << std::setw(35) << mat(i,j).imag();
+                    out << std::endl;
+                }
+            }
+        }
+    }
+    
+    // now write the modes. These are gathered only on processor 0, so
+    // that the other processors do not store the global vectors
+    std::vector<Real> mode_vec;
+    
+    for (unsigned int i=0; i<_n_modes; i++) {
+        libMesh::NumericVector<Real>&
+        vec = *modes[i];
+        
+        libmesh_assert_equal_to(vec.size(), n_vec_dofs);
+        vec.localize_to_one(mode_vec, 0);
+        
+        if (my_rank == 0) {
+            
+            for (unsigned int i=0; i<n_vec_dofs; i++)
+                out
+                << std::setw(35) << mode_vec[i] << std::endl;
+            out << std::endl;
+        }
+    }
+    
+    libMesh::out
+    << "   Done! " << std::endl;
+    
+}
+
+
+
+void
+MAST::GAFDatabase::read_gaf_file(const std::string& nm,
+                                 std::vector<libMesh::NumericVector<Real>*>& modes) {
+    
+    libMesh::out
+    << " **** Reading GAF database from : " << nm
+    << "   ....  ";
+    
+    std::ifstream input;
+    input.open(nm, std::ofstream::in);
+    
+    unsigned int
+    n_vec_dofs = 0,
+    n_kr       = 0;
+    
+    input >> _n_modes >> n_vec_dofs >> n_kr;
+    
+    Real
+    kr = 0.,
+    re = 0.,
+    im = 0.;
+    
+    ComplexMatrixX
+    mat (ComplexMatrixX::Zero(_n_modes, _n_modes));
+    
+    
+    // read the GAFs at each kr first
+    for (unsigned int i=0; i<n_kr; i++) {
+        
+        mat.setZero();
+        
+        input >> kr;
+        
+        for (unsigned int j=0; j<_n_modes; j++)
+            for (unsigned int k=0; k<_n_modes; k++) {
+                
+                input >> re >> im;
+                mat(j,k) = std::complex<Real>(re, im);
+            }
+        
+        _kr_to_gaf_map[kr] = mat;
+    }
+    
+    
+    // next, read the GAF sensitivity wrt kr at each kr
+    for (unsigned int i=0; i<n_kr; i++) {
+        
+        mat.setZero();
+        
+        input >> kr;
+        
+        for (unsigned int j=0; j<_n_modes; j++)
+            for (unsigned int k=0; k<_n_modes; k++) {
+                
+                input >> re >> im;
+                mat(j,k) = std::complex<Real>(re, im);
+            }
+        
+        _kr_to_gaf_kr_sens_map[kr] = mat;
+    }
+    
+    
+    // now read the modes
+    /*{
+        std::vector<Real> mode_vec(n_vec_dofs, 0.);
+        
+        for (unsigned int i=0; i<_n_modes; i++) {
+            libMesh::NumericVector<Real>&
+            vec = *modes[i];
+            
+            libmesh_assert(vec.size() == n_vec_dofs);
+            std::fill(mode_vec.begin(), mode_vec.end(), 0.);
+            
+            for (unsigned int i=0; i<n_vec_dofs; i++)
+                input >> mode_vec[i];
+            
+            vec = mode_vec;
+        }
+    }*/
+    
+    _rfa_valid = false;
+    
+    this->set_evaluate_mode(false);
+    libMesh::out
+    << "   Done! " << std::endl;
+}
+
+
+void
+MAST::GAFDatabase::add_kr_mats(std::vector<libMesh::NumericVector<Real>*>& basis,
+                               const std::vector<Real>& kr) {
+    
+    std::vector<ComplexMatrixX> mats;
+    
+    MAST::FSIGeneralizedAeroForceAssembly::
+    assemble_generalized_aerodynamic_force_matrices(basis, kr, mats);
+    
+    for (unsigned int i=0; i<kr.size(); i++)
+        this->add_kr_mat(kr[i], mats[i], false);
+}
+
+
+
+ComplexMatrixX&
+MAST::GAFDatabase::add_kr_mat(const Real kr,
+                              const ComplexMatrixX& mat,
+                              const bool if_kr_sens) {
+    
+    libmesh_assert_equal_to(mat.rows(), _n_modes);
+    libmesh_assert_equal_to(mat.cols(), _n_modes);
+    
+    if (!if_kr_sens) {
+        
+        // the returned matrix may be modified by the caller
+        _rfa_valid = false;
+        _kr_to_gaf_map[kr] = mat;
+        return _kr_to_gaf_map[kr];
+    }
+    else {
+        
+        _kr_to_gaf_kr_sens_map[kr] = mat;
+        return _kr_to_gaf_kr_sens_map[kr];
+    }
+}
+
+
+ComplexMatrixX
+MAST::GAFDatabase::get_kr_mat(const Real kr,
+                              const std::map<Real, ComplexMatrixX>& data) {
+    
+    //
+    // the following is used for calculation of the return value
+    //   f(x) is defined for x for each x0 < x < x1
+    //   if   x <= x0,      f(x) = f(x0)
+    //   if   x0 < x < x1,  f(x) is interpolated
+    //   if   x >= x1,      f(x) = f(x1)
+    //
+    
+    ComplexMatrixX
+    mat = ComplexMatrixX::Zero(_n_modes, _n_modes);
+    
+    std::map<Real, ComplexMatrixX>::const_iterator
+    it1, it2;
+    std::map<Real, ComplexMatrixX>::const_reverse_iterator
+    rit  = data.rbegin();
+    it1  = data.begin();
+    
+    // check the lower bound
+    if (kr <=  it1->first) {
+        mat = it1->second;
+    }
+    // check the upper bound
+    else if (kr >=  rit->first) {
+        mat = rit->second;
+    }
+    else {
+        // if it gets here, the ordinate is in between the provided range
+        it2 = data.lower_bound(kr);
+        // this cannot be the first element of the map
+        libmesh_assert(it2 != data.begin());
+        // it2 provides the upper bound. The lower bound is provided by the
+        // preceding iterator
+        it1 = it2--;
+        // now interpolate
+        mat =  it1->second +
+        (kr - it1->first)/(it2->first - it1->first) *
+        (it2->second - it1->second);
+    }
+    
+    return mat;
+}
+
+
+ComplexMatrixX
+MAST::GAFDatabase::_interpolate_kr_mat(const Real kr,
+                                       const bool if_kr_sens) {
+    
+    if (if_kr_sens)
+        return this->get_kr_mat(kr, _kr_to_gaf_kr_sens_map);
+    
+    if (!_rfa_lag_roots.size()                      ||
+        (!_rfa_valid && !_fit_rational_function_approximation()))
+        return this->get_kr_mat(kr, _kr_to_gaf_map);
+    
+    const Complex ik(0., kr);
+    
+    ComplexMatrixX
+    mat = (_rfa_coeffs[0].cast<Complex>()           +
+           ik * _rfa_coeffs[1].cast<Complex>()      +
+           ik * ik * _rfa_coeffs[2].cast<Complex>());
+    
+    for (unsigned int j=0; j<_rfa_lag_roots.size(); j++)
+        mat += ik/(ik + _rfa_lag_roots[j]) * _rfa_coeffs[j+3].cast<Complex>();
+    
+    return mat;
+}
+
+
+
+bool
+MAST::GAFDatabase::
+_if_within_tolerance(const Real kr,
+                     const std::map<Real, ComplexMatrixX>& data) const {
+    
+    if (!data.size())
+        return false;
+    
+    // the nearest stored frequencies are on either side of kr
+    std::map<Real, ComplexMatrixX>::const_iterator
+    it = data.lower_bound(kr);
+    
+    if (it != data.end() &&
+        it->first - kr <= _kr_tol)
+        return true;
+    
+    if (it != data.begin() &&
+        kr - (--it)->first <= _kr_tol)
+        return true;
+    
+    return false;
+}
+
+
+
+bool
+MAST::GAFDatabase::_fit_rational_function_approximation() {
+    
+    const unsigned int
+    n_kr     = (unsigned int)_kr_to_gaf_map.size(),
+    n_terms  = 3 + (unsigned int)_rfa_lag_roots.size(),
+    n_entries= _n_modes * _n_modes;
+    
+    // the real and imaginary parts of each frequency provide two
+    // equations for the real coefficients
+    if (2*n_kr < n_terms)
+        return false;
+    
+    RealMatrixX
+    D   = RealMatrixX::Zero(2*n_kr, n_terms),
+    rhs = RealMatrixX::Zero(2*n_kr, n_entries);
+    
+    std::map<Real, ComplexMatrixX>::const_iterator
+    it  = _kr_to_gaf_map.begin(),
+    end = _kr_to_gaf_map.end();
+    
+    for (unsigned int i=0; it != end; it++, i++) {
+        
+        const Complex ik(0., it->first);
+        
+        ComplexVectorX phi = ComplexVectorX::Zero(n_terms);
+        phi(0) = 1.;
+        phi(1) = ik;
+        phi(2) = ik * ik;
+        for (unsigned int j=0; j<_rfa_lag_roots.size(); j++)
+            phi(j+3) = ik/(ik + _rfa_lag_roots[j]);
+        
+        D.row(2*i)   = phi.real().transpose();
+        D.row(2*i+1) = phi.imag().transpose();
+        
+        // the matrix entries are stored column-major in each row of rhs
+        const ComplexMatrixX& mat = it->second;
+        for (unsigned int k=0; k<n_entries; k++) {
+            
+            rhs(2*i,   k) = mat.data()[k].real();
+            rhs(2*i+1, k) = mat.data()[k].imag();
+        }
+    }
+    
+    // the same least-squares system is solved for all entries
+    RealMatrixX c = D.colPivHouseholderQr().solve(rhs);
+    
+    _rfa_coeffs.resize(n_terms);
+    for (unsigned int j=0; j<n_terms; j++) {
+        
+        _rfa_coeffs[j].setZero(_n_modes, _n_modes);
+        for (unsigned int k=0; k<n_entries; k++)
+            _rfa_coeffs[j].data()[k] = c(j, k);
+    }
+    
+    _rfa_valid = true;
+    
+    return true;
+}
+
+
+
+void
+MAST::GAFDatabase::assemble_generalized_aerodynamic_force_matrix
+(std::vector<libMesh::NumericVector<Real>*>& basis,
+ ComplexMatrixX& mat,
+ MAST::Parameter* p) {
+    
+    if (_if_adaptive) {
+        
+        Real kr = 0.;
+        (*_freq)(kr);
+        
+        const bool if_kr_sens = p != nullptr;
+        
+        if (_if_within_tolerance(kr, if_kr_sens?
+                                 _kr_to_gaf_kr_sens_map:_kr_to_gaf_map))
+            mat = this->_interpolate_kr_mat(kr, if_kr_sens);
+        else {
+            
+            MAST::FSIGeneralizedAeroForceAssembly::
+            assemble_generalized_aerodynamic_force_matrix(basis, mat, p);
+            this->add_kr_mat(kr, mat, if_kr_sens);
+        }
+    }
+    else if (_if_evaluate) {
+        
+        MAST::FSIGeneralizedAeroForceAssembly::
+        assemble_generalized_aerodynamic_force_matrix(basis, mat, p);
+    }
+    else {
+        
+        Real kr = 0.;
+        (*_freq)(kr);
+        mat = this->_interpolate_kr_mat(kr, p != nullptr);
+    }
+}
+
@@ -0,0 +1,298 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2017  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef __mast__gaf_database_h__
+#define __mast__gaf_database_h__
+
+// C++ includes
+#include <vector>
+#include <map>
+#include <string>
+
+// MAST includes
+#include "base/mast_data_types.h"
+#include "elasticity/fsi_generalized_aero_force_assembly.h"
+
+// libMesh includes
+#include "libmesh/numeric_vector.h"
+
+
+namespace MAST{
+    
+    // Forward decleraitons
+    class Parameter;
+    class FrequencyFunction;
+    class MemoryReport;
+    class GAFTable;
+    class BasisAlignment;
+    
+    /*!
+     *   Stores the generalized aerodynamic force (GAF) matrices at
+     *   discrete reduced frequencies, and provides the matrix at
+     *   intermediate frequencies by interpolation. The matrices can
+     *   be computed in advance and stored in text or binary files, or
+     *   computed on demand in the adaptive mode, where a fluid solution is
+     *   performed only if the requested reduced frequency is farther than
+     *   a tolerance from the frequencies already stored. The GAF
+     *   sensitivity (identified by a non-null parameter in
+     *   assemble_generalized_aerodynamic_force_matrix()) is assumed to be
+     *   with respect to the frequency parameter.
+     *
+     *   The stored matrices are valid only for the basis and fluid
+     *   solution for which they were computed, and clear_gaf_data() must
+     *   be called if either of these change. After a change of the basis
+     *   alone, transform_gaf_data() can instead transform the stored
+     *   matrices to the new basis.
+     */
+    class GAFDatabase:
+    public MAST::FSIGeneralizedAeroForceAssembly {
+        
+    public:
+        
+        GAFDatabase(const unsigned int n_modes);
+        
+        ~GAFDatabase() { }
+        
+        void init(MAST::FrequencyFunction*                        freq,
+                  MAST::ComplexSolverBase*                complex_solver,
+                  MAST::PressureFunction*                 pressure_func,
+                  MAST::FrequencyDomainPressureFunction*  freq_pressure_func,
+                  MAST::ComplexMeshFieldFunction*         displ_func);
+
+        
+        /*!
+         *   if \p f is \p true, the GAF matrices are computed by the fluid
+         *   solver for each call, otherwise they are interpolated from the
+         *   stored data.
+         */
+        void
+        set_evaluate_mode(bool f);
+        
+        
+        /*!
+         *   if \p f is \p true, the GAF matrices are computed by the fluid
+         *   solver and added to the stored data only if the requested
+         *   reduced frequency is farther than \p kr_tol from the nearest
+         *   stored frequency, and are otherwise interpolated from the
+         *   stored data. This takes precedence over the evaluate mode.
+         */
+        void
+        set_adaptive_mode(bool f, Real kr_tol);
+        
+        
+        /*!
+         *   tells the database to interpolate the GAF matrices with the
+         *   rational function approximation of Roger,
+         *   \f[ A(k) = A_0 + A_1 (ik) + A_2 (ik)^2 +
+         *      \sum_j A_{j+2} \frac{ik}{ik + \beta_j}, \f]
+         *   with real coefficient matrices fitted in the least-squares
+         *   sense to all stored frequencies, and the lag roots \f$ \beta_j
+         *   \f$ given in \p lag_roots. An empty vector restores the
+         *   default piecewise linear interpolation. The linear interpolation
+         *   is also used if there are not enough stored frequencies for the
+         *   fit, and for the GAF sensitivity.
+         */
+        void
+        set_rational_function_approximation(const std::vector<Real>& lag_roots);
+        
+        
+        /*!
+         *   deletes the stored GAF matrices
+         */
+        void
+        clear_gaf_data();
+        
+        
+        /*!
+         *   transforms the stored GAF matrices to the new basis of
+         *   \p alignment, which must have been computed with the basis of
+         *   the stored data as the old basis, so that the fluid solutions
+         *   need not be repeated after a change of the modes. The
+         *   transformation is exact if the new modes are in the span of
+         *   the old modes, and the data is transformed only if the
+         *   subspace residual of \p alignment is not more than \p tol.
+         *   Otherwise the data is deleted. @returns \p true if the data
+         *   was transformed.
+         */
+        bool
+        transform_gaf_data(const MAST::BasisAlignment& alignment,
+                           Real tol);
+        
+        
+        /*!
+         *   @returns the number of reduced frequencies with stored GAF
+         *   matrices
+         */
+        unsigned int n_kr() const {
+            return (unsigned int)_kr_to_gaf_map.size();
+        }
+        
+        
+        /*!
+         *   @returns the number of modes of the GAF matrices
+         */
+        unsigned int n_modes() const {
+            return _n_modes;
+        }
+        
+        
+        /*!
+         *   @returns the stored GAF matrices, and their sensitivity with
+         *   respect to the reduced frequency, by reduced frequency
+         */
+        const std::map<Real, ComplexMatrixX>& gaf_data() const {
+            return _kr_to_gaf_map;
+        }
+        
+        const std::map<Real, ComplexMatrixX>& gaf_kr_sens_data() const {
+            return _kr_to_gaf_kr_sens_map;
+        }
+        
+        
+        /*!
+         *   adds the bytes of the stored generalized aerodynamic force
+         *   matrices and of the rational function approximation to \p r,
+         *   with \p nm as the name of this object.
+         */
+        void
+        report_memory(MAST::MemoryReport& r,
+                      const std::string& nm) const;
+        
+        
+        void
+        write_gaf_file(const std::string& nm,
+                       std::vector<libMesh::NumericVector<Real>*>& modes);
+        
+        
+        
+        void
+        read_gaf_file(const std::string& nm,
+                      std::vector<libMesh::NumericVector<Real>*>& modes);
+        
+        
+        /*!
+         *   writes the stored GAF matrices and their sensitivity in binary
+         *   format to the file \p nm on the first processor of \p comm.
+         *   Unlike write_gaf_file(), the modes are not written.
+         */
+        void
+        write_binary_gaf_file(const std::string& nm,
+                              const libMesh::Parallel::Communicator& comm) const;
+        
+        
+        /*!
+         *   reads the GAF matrices and their sensitivity from the binary
+         *   file \p nm written by write_binary_gaf_file() and adds them to
+         *   the stored data.
+         */
+        void
+        read_binary_gaf_file(const std::string& nm);
+        
+        
+        /*!
+         *   replaces the stored data with the GAF matrices and their
+         *   sensitivity at the reduced frequencies of \p table, interpolated
+         *   to Mach number \p mach.
+         */
+        void
+        read_gaf_table(const MAST::GAFTable& table,
+                       const Real mach);
+        
+        
+        /*!
+         *   computes the GAF matrices on \p basis at the reduced
+         *   frequencies \p kr with
+         *   assemble_generalized_aerodynamic_force_matrices(), so that the
+         *   fluid operators are assembled once per basis vector for all
+         *   frequencies, and stores them. The sensitivity with respect to
+         *   the reduced frequency is not computed.
+         */
+        void
+        add_kr_mats(std::vector<libMesh::NumericVector<Real>*>& basis,
+                    const std::vector<Real>& kr);
+        
+        
+        ComplexMatrixX&
+        add_kr_mat(const Real kr,
+                   const ComplexMatrixX& mat,
+                   const bool if_kr_sens);
+        
+        ComplexMatrixX
+        get_kr_mat(const Real kr,
+                   const std::map<Real, ComplexMatrixX>& data);
+        
+        
+        virtual void
+        assemble_generalized_aerodynamic_force_matrix
+        (std::vector<libMesh::NumericVector<Real>*>& basis,
+         ComplexMatrixX& mat,
+         MAST::Parameter* p = nullptr);
+        
+        
+        
+    protected:
+
+        /*!
+         *   @returns the GAF matrix (or its sensitivity if \p if_kr_sens
+         *   is \p true) at \p kr, interpolated from the stored data.
+         */
+        ComplexMatrixX
+        _interpolate_kr_mat(const Real kr,
+                            const bool if_kr_sens);
+        
+        
+        /*!
+         *   @returns \p true if \p data has a frequency within the adaptive
+         *   tolerance of \p kr.
+         */
+        bool
+        _if_within_tolerance(const Real kr,
+                             const std::map<Real, ComplexMatrixX>& data) const;
+        
+        
+        /*!
+         *   fits the coefficient matrices of the rational function
+         *   approximation to the stored GAF matrices. @returns \p false if
+         *   there are not enough stored frequencies for the fit.
+         */
+        bool
+        _fit_rational_function_approximation();
+        
+        
+        MAST::FrequencyFunction*                    _freq;
+        bool                                _if_evaluate;
+        bool                                _if_adaptive;
+        Real                                _kr_tol;
+        unsigned int                        _n_modes;
+        std::map<Real, ComplexMatrixX>      _kr_to_gaf_map;
+        std::map<Real, ComplexMatrixX>      _kr_to_gaf_kr_sens_map;
+        
+        /*!
+         *   lag roots of the rational function approximation, and the
+         *   fitted coefficient matrices. \p _rfa_valid is \p false if the
+         *   stored data has changed since the last fit.
+         */
+        std::vector<Real>                   _rfa_lag_roots;
+        std::vector<RealMatrixX>            _rfa_coeffs;
+        bool                                _rfa_valid;
+    };
+}
+
+
+#endif  // __mast__gaf_database_h__
@@ -0,0 +1,374 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2017  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+// C++ includes
+#include <fstream>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+
+// MAST includes
+#include "elasticity/gaf_table.h"
+#include "elasticity/gaf_database.h"
+#include "base/node_shared_memory.h"
+#include "base/performance_log.h"
+
+
+namespace MAST {
+    
+    /*!
+     *   identifies the GAF table files, followed by the format version
+     */
+    const char         gaf_table_file_id[8] = "MASTGFT";
+    const unsigned int gaf_table_file_version = 1;
+    
+    /*!
+     *   size of the header of the file, which keeps the data that follows
+     *   aligned to the size of Real
+     */
+    const std::size_t  gaf_table_header_size =
+    sizeof(gaf_table_file_id) + 4*sizeof(unsigned int);
+}
+
+
+
+MAST::GAFTable::GAFTable():
+_data(nullptr),
+_size(0),
+_mapped(false),
+_n_modes(0),
+_n_mach(0),
+_n_kr(0),
+_mach(nullptr),
+_kr(nullptr),
+_gaf(nullptr),
+_gaf_kr_sens(nullptr) {
+    
+}
+
+
+
+MAST::GAFTable::~GAFTable() {
+    
+    this->close();
+}
+
+
+
+void
+MAST::GAFTable::write(const std::string& nm,
+                      const std::vector<Real>& mach,
+                      const std::vector<Real>& kr,
+                      const std::vector<MAST::GAFDatabase*>& gaf,
+                      const libMesh::Parallel::Communicator& comm) {
+    
+    MAST_LOG_SCOPE("write()", "GAFTable");
+    
+    libmesh_assert(mach.size());
+    libmesh_assert(kr.size());
+    libmesh_assert_equal_to(mach.size(), gaf.size());
+    
+    if (comm.rank() == 0) {
+        
+        const unsigned int
+        n_modes = gaf[0]->n_modes(),
+        n_mach  = (unsigned int)mach.size(),
+        n_kr    = (unsigned int)kr.size();
+        
+        std::ofstream out;
+        out.open(nm.c_str(), std::ofstream::out | std::ofstream::binary);
+        
+        if (!out.good())
+            libmesh_error_msg("Error: could not open " << nm << " for writing.");
+        
+        out.write(MAST::gaf_table_file_id, sizeof(MAST::gaf_table_file_id));
+        out.write(reinterpret_cast<const char*>(&MAST::gaf_table_file_version),
+                  sizeof(unsigned int));
+        out.write(reinterpret_cast<const char*>(&n_modes), sizeof(unsigned int));
+        out.write(reinterpret_cast<const char*>(&n_mach),  sizeof(unsigned int));
+        out.write(reinterpret_cast<const char*>(&n_kr),    sizeof(unsigned int));
+        
+        out.write(reinterpret_cast<const char*>(&mach[0]), sizeof(Real)*n_mach);
+        out.write(reinterpret_cast<const char*>(&kr[0]),   sizeof(Real)*n_kr);
+        
+        ComplexMatrixX
+        mat;
+        
+        for (unsigned int s=0; s<2; s++)
+            for (unsigned int i=0; i<n_mach; i++) {
+                
+                libmesh_assert_equal_to(gaf[i]->n_modes(), n_modes);
+                if (i) libmesh_assert_greater(mach[i], mach[i-1]);
+                
+                const std::map<Real, ComplexMatrixX>&
+                data = s ? gaf[i]->gaf_kr_sens_data() : gaf[i]->gaf_data();
+                
+                if (!data.size())
+                    libmesh_error_msg("Error: no GAF data at Mach " << mach[i]);
+                
+                for (unsigned int j=0; j<n_kr; j++) {
+                    
+                    mat = gaf[i]->get_kr_mat(kr[j], data);
+                    out.write(reinterpret_cast<const char*>(mat.data()),
+                              sizeof(Complex)*n_modes*n_modes);
+                }
+            }
+        
+        if (!out.good())
+            libmesh_error_msg("Error: writing GAF table " << nm << " failed.");
+    }
+    
+    comm.barrier();
+}
+
+
+
+void
+MAST::GAFTable::open(const std::string& nm) {
+    
+    MAST_LOG_SCOPE("open()", "GAFTable");
+    
+    this->close();
+    
+    int
+    fd = ::open(nm.c_str(), O_RDONLY);
+    
+    if (fd < 0)
+        libmesh_error_msg("Error: could not open " << nm << " for reading.");
+    
+    struct stat st;
+    if (fstat(fd, &st) ||
+        (std::size_t)st.st_size < MAST::gaf_table_header_size) {
+        
+        ::close(fd);
+        libmesh_error_msg("Error: " << nm << " is not a GAF table file.");
+    }
+    
+    _size = (std::size_t)st.st_size;
+    _data = mmap(nullptr, _size, PROT_READ, MAP_SHARED, fd, 0);
+    
+    // the mapping is retained after the file is closed
+    ::close(fd);
+    
+    if (_data == MAP_FAILED) {
+        
+        _data = nullptr;
+        _size = 0;
+        libmesh_error_msg("Error: could not map " << nm);
+    }
+    
+    _mapped = true;
+    
+    this->_init(nm);
+}
+
+
+
+void
+MAST::GAFTable::open(const std::string& nm,
+                     MAST::NodeSharedMemory& shm) {
+    
+    MAST_LOG_SCOPE("open()", "GAFTable");
+    
+    this->close();
+    
+    // all processors read the size of the file to check the header
+    struct stat st;
+    if (stat(nm.c_str(), &st) ||
+        (std::size_t)st.st_size < MAST::gaf_table_header_size)
+        libmesh_error_msg("Error: " << nm << " is not a GAF table file.");
+    
+    _size = (std::size_t)st.st_size;
+    _data = shm.allocate(_size);
+    
+    if (shm.is_node_leader()) {
+        
+        std::ifstream input;
+        input.open(nm.c_str(), std::ifstream::in | std::ifstream::binary);
+        input.read(static_cast<char*>(_data), _size);
+        
+        if (!input.good())
+            libmesh_error_msg("Error: reading GAF table " << nm << " failed.");
+    }
+    
+    shm.synchronize();
+    
+    _mapped = false;
+    
+    this->_init(nm);
+}
+
+
+
+void
+MAST::GAFTable::_init(const std::string& nm) {
+    
+    const char*
+    p = static_cast<const char*>(_data);
+    
+    const unsigned int*
+    h = reinterpret_cast<const unsigned int*>(p + sizeof(MAST::gaf_table_file_id));
+    
+    if (std::string(p, sizeof(MAST::gaf_table_file_id)-1) !=
+        std::string(MAST::gaf_table_file_id) ||
+        h[0] != MAST::gaf_table_file_version) {
+        
+        this->close();
+        libmesh_error_msg("Error: " << nm << " is not a GAF table file.");
+    }
+    
+    _n_modes = h[1];
+    _n_mach  = h[2];
+    _n_kr    = h[3];
+    
+    const std::size_t
+    offset  = MAST::gaf_table_header_size,
+    n_mats  = 2 * (std::size_t)_n_mach * _n_kr,
+    n_vals  = (std::size_t)_n_modes * _n_modes;
+    
+    if (_size != offset + sizeof(Real)*(_n_mach + _n_kr) +
+        sizeof(Complex)*n_mats*n_vals) {
+        
+        this->close();
+        libmesh_error_msg("Error: size of " << nm << " does not match its header.");
+    }
+    
+    _mach        = reinterpret_cast<const Real*>(p + offset);
+    _kr          = _mach + _n_mach;
+    _gaf         = reinterpret_cast<const Complex*>(_kr + _n_kr);
+    _gaf_kr_sens = _gaf + n_mats/2 * n_vals;
+}
+
+
+
+void
+MAST::GAFTable::close() {
+    
+    if (_data && _mapped)
+        munmap(_data, _size);
+    
+    _data        = nullptr;
+    _size        = 0;
+    _mapped      = false;
+    _n_modes     = 0;
+    _n_mach      = 0;
+    _n_kr        = 0;
+    _mach        = nullptr;
+    _kr          = nullptr;
+    _gaf         = nullptr;
+    _gaf_kr_sens = nullptr;
+}
+
+
+
+Eigen::Map<const ComplexMatrixX>
+MAST::GAFTable::kr_mat(unsigned int i_mach,
+                       unsigned int i_kr,
+                       bool if_kr_sens) const {
+    
+    libmesh_assert(_data);
+    libmesh_assert_less(i_mach, _n_mach);
+    libmesh_assert_less(i_kr,   _n_kr);
+    
+    const Complex*
+    p = (if_kr_sens? _gaf_kr_sens : _gaf) +
+    ((std::size_t)i_mach * _n_kr + i_kr) * _n_modes * _n_modes;
+    
+    return Eigen::Map<const ComplexMatrixX>(p, _n_modes, _n_modes);
+}
+
+
+
+ComplexMatrixX
+MAST::GAFTable::interpolate(Real m,
+                            Real k,
+                            bool if_kr_sens) const {
+    
+    libmesh_assert(_data);
+    
+    unsigned int
+    i = 0,
+    j = 0;
+    
+    Real
+    fm = 0.,
+    fk = 0.;
+    
+    _bracket(_mach, _n_mach, m, i, fm);
+    _bracket(_kr,   _n_kr,   k, j, fk);
+    
+    // the second point of the interval is used only with a nonzero fraction,
+    // so that it need not exist at the bounds of the table
+    ComplexMatrixX
+    mat = (1.-fm) * (1.-fk) * this->kr_mat(i, j, if_kr_sens);
+    
+    if (fk > 0.)
+        mat += (1.-fm) * fk * this->kr_mat(i, j+1, if_kr_sens);
+    
+    if (fm > 0.) {
+        
+        mat += fm * (1.-fk) * this->kr_mat(i+1, j, if_kr_sens);
+        
+        if (fk > 0.)
+            mat += fm * fk * this->kr_mat(i+1, j+1, if_kr_sens);
+    }
+    
+    return mat;
+}
+
+
+
+void
+MAST::GAFTable::_bracket(const Real* vals,
+                         unsigned int n,
+                         Real v,
+                         unsigned int& i,
+                         Real& f) {
+    
+    libmesh_assert_greater(n, 0);
+    
+    i = 0;
+    f = 0.;
+    
+    if (v <= vals[0])
+        return;
+    
+    if (v >= vals[n-1]) {
+        i = n-1;
+        return;
+    }
+    
+    // binary search for vals[i] <= v < vals[i+1]
+    unsigned int
+    hi = n-1;
+    
+    while (hi - i > 1) {
+        
+        const unsigned int
+        mid = (i + hi)/2;
+        
+        if (vals[mid] <= v) i  = mid;
+        else                hi = mid;
+    }
+    
+    f = (v - vals[i]) / (vals[i+1] - vals[i]);
+}
+
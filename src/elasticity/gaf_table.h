@@ -0,0 +1,214 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2017  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef __mast__gaf_table_h__
+#define __mast__gaf_table_h__
+
+// C++ includes
+#include <vector>
+#include <string>
+
+// MAST includes
+#include "base/mast_data_types.h"
+
+// libMesh includes
+#include "libmesh/parallel.h"
+
+
+namespace MAST {
+    
+    // Forward declerations
+    class GAFDatabase;
+    class NodeSharedMemory;
+    
+    
+    /*!
+     *   Table of generalized aerodynamic force (GAF) matrices on a grid of
+     *   Mach numbers and reduced frequencies, stored in a binary file that
+     *   is memory-mapped read-only by open(). The matrices are not copied
+     *   on reading, so that the processes that open the same file share
+     *   the pages of the file. kr_mat() returns a view of the stored
+     *   matrix at a grid point, and interpolate() the bilinear
+     *   interpolation in the Mach number and the reduced frequency, where
+     *   values outside the grid are clamped to its bounds as in
+     *   GAFDatabase::get_kr_mat().
+     *
+     *   The file is written by write() from one GAFDatabase for each Mach
+     *   number, whose matrices are interpolated to the reduced frequencies
+     *   of the table. The file stores an identifier, the format version,
+     *   the number of modes, Mach numbers and reduced frequencies, followed
+     *   by the Mach numbers and reduced frequencies, and the GAF matrices
+     *   and their sensitivity with respect to the reduced frequency, each
+     *   ordered with the reduced frequency varying fastest.
+     */
+    class GAFTable {
+        
+    public:
+        
+        GAFTable();
+        
+        /*!
+         *   unmaps the file
+         */
+        virtual ~GAFTable();
+        
+        
+        /*!
+         *   writes the table file \p nm on the first processor of \p comm
+         *   from \p gaf, which provides the GAF data at Mach number
+         *   \p mach[i] in \p gaf[i]. The Mach numbers \p mach and the reduced
+         *   frequencies \p kr must be in increasing order. The databases
+         *   must have GAF matrices and their sensitivity stored for at least
+         *   one reduced frequency.
+         */
+        static void
+        write(const std::string& nm,
+              const std::vector<Real>& mach,
+              const std::vector<Real>& kr,
+              const std::vector<MAST::GAFDatabase*>& gaf,
+              const libMesh::Parallel::Communicator& comm);
+        
+        
+        /*!
+         *   maps the table file \p nm, after unmapping the file currently
+         *   open, if any.
+         */
+        void open(const std::string& nm);
+        
+        
+        /*!
+         *   reads the table file \p nm into memory allocated by \p shm, so
+         *   that the table is stored once on each node. The file is read by
+         *   the node leaders. This is an alternative to open() for file
+         *   systems that do not share the pages of mapped files, and must be
+         *   called on all processors of the communicator of \p shm. The
+         *   memory is owned by \p shm, which must exist as long as the table
+         *   is used.
+         */
+        void open(const std::string& nm,
+                  MAST::NodeSharedMemory& shm);
+        
+        
+        /*!
+         *   unmaps the file
+         */
+        void close();
+        
+        
+        /*!
+         *   @returns the number of modes, Mach numbers and reduced
+         *   frequencies of the table
+         */
+        unsigned int n_modes() const {
+            return _n_modes;
+        }
+        
+        unsigned int n_mach() const {
+            return _n_mach;
+        }
+        
+        unsigned int n_kr() const {
+            return _n_kr;
+        }
+        
+        
+        /*!
+         *   @returns the i^th Mach number and reduced frequency of the
+         *   table
+         */
+        Real mach(unsigned int i) const {
+            libmesh_assert_less(i, _n_mach);
+            return _mach[i];
+        }
+        
+        Real kr(unsigned int i) const {
+            libmesh_assert_less(i, _n_kr);
+            return _kr[i];
+        }
+        
+        
+        /*!
+         *   @returns a view of the GAF matrix, or its sensitivity if
+         *   \p if_kr_sens is \p true, at Mach number \p i_mach and reduced
+         *   frequency \p i_kr. The view is valid as long as the file is open.
+         */
+        Eigen::Map<const ComplexMatrixX>
+        kr_mat(unsigned int i_mach,
+               unsigned int i_kr,
+               bool if_kr_sens = false) const;
+        
+        
+        /*!
+         *   @returns the GAF matrix, or its sensitivity if \p if_kr_sens
+         *   is \p true, at Mach number \p m and reduced frequency \p k,
+         *   interpolated from the table.
+         */
+        ComplexMatrixX
+        interpolate(Real m,
+                    Real k,
+                    bool if_kr_sens = false) const;
+        
+    protected:
+        
+        /*!
+         *   sets the table data from the contents of the file \p nm, which
+         *   are stored in \p _data
+         */
+        void _init(const std::string& nm);
+        
+        
+        /*!
+         *   computes the index \p i of the lower bound of the interval of
+         *   \p vals that contains \p v, and the fraction \p f of the
+         *   interval at \p v, after clamping \p v to the range of \p vals.
+         */
+        static void
+        _bracket(const Real* vals,
+                 unsigned int n,
+                 Real v,
+                 unsigned int& i,
+                 Real& f);
+        
+        /*!
+         *   contents of the file and its size. \p _mapped is \p true if the
+         *   file is mapped by this object, and \p false if it is stored in
+         *   node-shared memory.
+         */
+        void*                 _data;
+        std::size_t           _size;
+        bool                  _mapped;
+        
+        /*!
+         *   number of modes, Mach numbers and reduced frequencies
+         */
+        unsigned int          _n_modes, _n_mach, _n_kr;
+        
+        /*!
+         *   Mach numbers, reduced frequencies, and the GAF matrices and
+         *   their sensitivity in the mapped file
+         */
+        const Real*           _mach;
+        const Real*           _kr;
+        const Complex*        _gaf;
+        const Complex*        _gaf_kr_sens;
+    };
+}
+
+
+#endif // __mast__gaf_table_h__
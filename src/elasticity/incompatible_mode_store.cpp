@@ -0,0 +1,178 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2017  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+// C++ includes
+#include <algorithm>
+
+
+// MAST includes
+#include "elasticity/incompatible_mode_store.h"
+
+
+namespace MAST {
+    
+    // number of values allocated in each chunk of the arena. Entries
+    // larger than this are given a chunk of their own.
+    static const unsigned int
+    incompatible_mode_chunk_size = 1<<16;
+}
+
+
+
+MAST::IncompatibleModeStore::IncompatibleModeStore() {
+    
+}
+
+
+
+MAST::IncompatibleModeStore::~IncompatibleModeStore() {
+    
+}
+
+
+
+MAST::IncompatibleModeData&
+MAST::IncompatibleModeStore::entry(const libMesh::Elem& elem,
+                                   unsigned int n) {
+    
+    std::lock_guard<std::mutex> lock(_mutex);
+    
+    std::map<const libMesh::Elem*, MAST::IncompatibleModeData>::iterator
+    it = _data.find(&elem);
+    
+    if (it != _data.end()) {
+        
+        libmesh_assert_equal_to(it->second.n, n);
+        return it->second;
+    }
+    
+    MAST::IncompatibleModeData& d = _data[&elem];
+    
+    // the solution is followed by the condensed matrix
+    d.n               = n;
+    d.alpha           = _allocate(n*(n+1));
+    d.condensed       = d.alpha + n;
+    d.condensed_valid = false;
+    
+    return d;
+}
+
+
+
+void
+MAST::IncompatibleModeStore::invalidate() {
+    
+    std::lock_guard<std::mutex> lock(_mutex);
+    
+    std::map<const libMesh::Elem*, MAST::IncompatibleModeData>::iterator
+    it  = _data.begin(),
+    end = _data.end();
+    
+    for ( ; it != end; it++)
+        it->second.condensed_valid = false;
+}
+
+
+
+void
+MAST::IncompatibleModeStore::clear() {
+    
+    std::lock_guard<std::mutex> lock(_mutex);
+    
+    _data.clear();
+    _chunks.clear();
+}
+
+
+
+void
+MAST::IncompatibleModeStore::write(std::ostream& out) const {
+    
+    const unsigned int
+    n_elems = (unsigned int)_data.size();
+    
+    out.write((const char*)&n_elems, sizeof(unsigned int));
+    
+    std::map<const libMesh::Elem*, MAST::IncompatibleModeData>::const_iterator
+    it  = _data.begin(),
+    end = _data.end();
+    
+    for ( ; it != end; it++) {
+        
+        const unsigned long long
+        id = it->first->id();
+        
+        out.write((const char*)&id,           sizeof(unsigned long long));
+        out.write((const char*)&it->second.n, sizeof(unsigned int));
+        out.write((const char*)it->second.alpha, it->second.n*sizeof(Real));
+    }
+}
+
+
+
+void
+MAST::IncompatibleModeStore::read(std::istream& in,
+                                  const libMesh::MeshBase& mesh) {
+    
+    unsigned int
+    n_elems = 0,
+    n       = 0;
+    
+    unsigned long long
+    id      = 0;
+    
+    in.read((char*)&n_elems, sizeof(unsigned int));
+    
+    for (unsigned int i=0; i<n_elems; i++) {
+        
+        in.read((char*)&id, sizeof(unsigned long long));
+        in.read((char*)&n,  sizeof(unsigned int));
+        
+        MAST::IncompatibleModeData&
+        d = this->entry(*mesh.elem_ptr(id), n);
+        
+        in.read((char*)d.alpha, n*sizeof(Real));
+        d.condensed_valid = false;
+    }
+}
+
+
+
+Real*
+MAST::IncompatibleModeStore::_allocate(unsigned int n) {
+    
+    // pick the last chunk if it has enough space, otherwise create
+    // a new one
+    if (_chunks.empty() ||
+        _chunks.back().capacity() - _chunks.back().size() < n) {
+        
+        _chunks.push_back(std::vector<Real>());
+        _chunks.back().reserve(std::max(n, MAST::incompatible_mode_chunk_size));
+    }
+    
+    std::vector<Real>& c = _chunks.back();
+    
+    // resizing within the reserved capacity does not move the values
+    const unsigned int i0 = (unsigned int)c.size();
+    c.resize(i0+n, 0.);
+    
+    return &c[i0];
+}
+
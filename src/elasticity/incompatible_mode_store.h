@@ -0,0 +1,157 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2017  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+#ifndef __mast__incompatible_mode_store__
+#define __mast__incompatible_mode_store__
+
+// C++ includes
+#include <map>
+#include <deque>
+#include <vector>
+#include <mutex>
+#include <iostream>
+
+
+// MAST includes
+#include "base/mast_data_types.h"
+
+
+// libMesh includes
+#include "libmesh/elem.h"
+#include "libmesh/mesh_base.h"
+
+
+namespace MAST {
+    
+    /*!
+     *   incompatible mode data of an element in the
+     *   MAST::IncompatibleModeStore. \p alpha points to the n incompatible
+     *   mode solution values, and \p condensed to the n x n inverse of the
+     *   incompatible mode stiffness matrix in column-major order, which is
+     *   valid only if \p condensed_valid is \p true.
+     */
+    struct IncompatibleModeData {
+        
+        IncompatibleModeData():
+        n               (0),
+        alpha           (nullptr),
+        condensed       (nullptr),
+        condensed_valid (false) { }
+        
+        unsigned int   n;
+        Real*          alpha;
+        Real*          condensed;
+        bool           condensed_valid;
+    };
+    
+    
+    /*!
+     *   Persistent per-element storage of the incompatible mode solution
+     *   and the inverse of the incompatible mode stiffness used for its
+     *   static condensation. The values of all elements are allocated in
+     *   a few large contiguous chunks, which are never reallocated, so
+     *   that the pointers stored in MAST::IncompatibleModeData stay valid
+     *   while entries are added by concurrent threads.
+     */
+    class IncompatibleModeStore {
+        
+    public:
+        
+        IncompatibleModeStore();
+        
+        virtual ~IncompatibleModeStore();
+        
+        
+        /*!
+         *   @returns the data for \p elem, which is created with \p n
+         *   zero incompatible mode values on first request. This can be
+         *   called concurrently from multiple threads.
+         */
+        MAST::IncompatibleModeData&
+        entry(const libMesh::Elem& elem, unsigned int n);
+        
+        
+        /*!
+         *   marks the condensed matrices of all elements as invalid, so
+         *   that they are recomputed at the next element evaluation. The
+         *   incompatible mode solutions are retained.
+         */
+        void invalidate();
+        
+        
+        /*!
+         *   deletes the data of all elements
+         */
+        void clear();
+        
+        
+        /*!
+         *   writes the element ids and incompatible mode solutions of all
+         *   elements in the store to \p out. The condensed matrices are
+         *   not written. This must not be called concurrently with entry().
+         */
+        void write(std::ostream& out) const;
+        
+        
+        /*!
+         *   reads the incompatible mode solutions written by write(), and
+         *   sets them for the elements of \p mesh with the same ids. The
+         *   condensed matrices of these elements are marked as invalid.
+         */
+        void read(std::istream& in, const libMesh::MeshBase& mesh);
+        
+        
+        /*!
+         *   @returns the number of elements in the store
+         */
+        unsigned int n_elems() const {
+            return (unsigned int)_data.size();
+        }
+        
+    protected:
+        
+        /*!
+         *   @returns a pointer to \p n zero values in the arena
+         */
+        Real* _allocate(unsigned int n);
+        
+        
+        /*!
+         *   data for each element
+         */
+        std::map<const libMesh::Elem*, MAST::IncompatibleModeData> _data;
+        
+        
+        /*!
+         *   chunks of the arena. The capacity of each chunk is reserved
+         *   at creation and the chunk is never resized beyond it.
+         */
+        std::deque<std::vector<Real> >                       _chunks;
+        
+        
+        /*!
+         *   mutex for creation of new entries
+         */
+        std::mutex                                           _mutex;
+    };
+}
+
+
+#endif // __mast__incompatible_mode_store__
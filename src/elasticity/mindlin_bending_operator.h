@@ -41,8 +41,7 @@ namespace MAST {
     public:
         
         MindlinBendingOperator(MAST::StructuralElementBase& elem):
-        MAST::BendingOperator2D(elem),
-        _shear_quadrature_reduction(2)
+        MAST::BendingOperator2D(elem)
         { }
         
         virtual ~MindlinBendingOperator() { }
@@ -82,13 +81,6 @@ namespace MAST {
                                             RealVectorX& local_f,
                                             RealMatrixX& local_jac,
                                             const MAST::FunctionBase* sens_params );
-        
-    protected:
-        
-        /*!
-         *   reduction in quadrature for shear energy
-         */
-        unsigned int _shear_quadrature_reduction;
     };
 }
 
@@ -161,7 +153,7 @@ calculate_transverse_shear_residual(bool request_jacobian,
     qrule.reset(fe_type.default_quadrature_rule
                 (_elem.dim(),
                  property.extra_quadrature_order(_elem, fe->get_fe_type())
-                 - _shear_quadrature_reduction).release());
+                 - (int)property.transverse_shear_quadrature_reduction()).release());
     fe->attach_quadrature_rule(qrule.get());
     fe->get_phi();
     fe->get_JxW();
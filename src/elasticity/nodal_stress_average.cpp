@@ -0,0 +1,171 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2017  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+// C++ includes
+#include <cmath>
+#include <algorithm>
+
+
+// MAST includes
+#include "elasticity/nodal_stress_average.h"
+#include "base/performance_log.h"
+
+
+// libMesh includes
+#include "libmesh/system.h"
+#include "libmesh/elem.h"
+#include "libmesh/node.h"
+#include "libmesh/numeric_vector.h"
+
+
+MAST::NodalStressAverage::
+NodalStressAverage(libMesh::System& sys,
+                   const std::vector<unsigned int>& vars):
+_sys(sys),
+_vars(vars),
+_elem(nullptr),
+_vals(RealVectorX::Zero(13)),
+_elem_JxW(0.) {
+    
+    libmesh_assert_equal_to(vars.size(), 13);
+}
+
+
+
+MAST::NodalStressAverage::~NodalStressAverage() {
+    
+}
+
+
+
+void
+MAST::NodalStressAverage::zero() {
+    
+    // the vector is recreated if the dofs of the system have changed
+    if (!_weight.get() ||
+        _weight->size()       != _sys.solution->size() ||
+        _weight->local_size() != _sys.solution->local_size())
+        _weight.reset(_sys.solution->zero_clone().release());
+    else
+        _weight->zero();
+    
+    _sys.solution->zero();
+    
+    _elem     = nullptr;
+    _vals.setZero();
+    _elem_JxW = 0.;
+}
+
+
+
+void
+MAST::NodalStressAverage::add_point(const libMesh::Elem& e,
+                                    const RealVectorX& strain,
+                                    const RealVectorX& stress,
+                                    const Real vm,
+                                    const Real JxW) {
+    
+    libmesh_assert(_weight.get());
+    
+    if (&e != _elem) {
+        
+        _add_elem();
+        _elem = &e;
+    }
+    
+    // the component with the largest magnitude is used for the element
+    for (unsigned int i=0; i<6; i++) {
+        
+        if (fabs(strain(i)) > fabs(_vals(i)))    _vals(i)   = strain(i);
+        if (fabs(stress(i)) > fabs(_vals(i+6)))  _vals(i+6) = stress(i);
+    }
+    
+    _vals(12)  = std::max(_vals(12), vm);
+    _elem_JxW += JxW;
+}
+
+
+
+void
+MAST::NodalStressAverage::close() {
+    
+    MAST_LOG_SCOPE("close()", "NodalStressAverage");
+    
+    libmesh_assert(_weight.get());
+    
+    _add_elem();
+    
+    // the contributions to the dofs of other processors are sent to
+    // their owners
+    _sys.solution->close();
+    _weight->close();
+    
+    const libMesh::dof_id_type
+    first = _sys.solution->first_local_index(),
+    last  = _sys.solution->last_local_index();
+    
+    std::vector<Real>
+    vals(last-first, 0.);
+    
+    for (libMesh::dof_id_type i=first; i<last; i++) {
+        
+        const Real w = (*_weight)(i);
+        if (w > 0.)
+            vals[i-first] = (*_sys.solution)(i) / w;
+    }
+    
+    for (libMesh::dof_id_type i=first; i<last; i++)
+        _sys.solution->set(i, vals[i-first]);
+    
+    _sys.solution->close();
+    
+    // the ghosted values of the shared nodes are updated for output
+    _sys.update();
+}
+
+
+
+void
+MAST::NodalStressAverage::_add_elem() {
+    
+    if (!_elem)
+        return;
+    
+    const unsigned int
+    sys_num = _sys.number();
+    
+    for (unsigned int v=0; v<_elem->n_vertices(); v++) {
+        
+        const libMesh::Node& n = *_elem->get_node(v);
+        
+        for (unsigned int i=0; i<13; i++) {
+            
+            const libMesh::dof_id_type
+            dof = n.dof_number(sys_num, _vars[i], 0);
+            
+            _sys.solution->add(dof, _elem_JxW * _vals(i));
+            _weight->add(dof, _elem_JxW);
+        }
+    }
+    
+    _elem     = nullptr;
+    _vals.setZero();
+    _elem_JxW = 0.;
+}
+
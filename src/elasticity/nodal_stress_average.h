@@ -0,0 +1,147 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2017  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef __mast__nodal_stress_average__
+#define __mast__nodal_stress_average__
+
+// C++ includes
+#include <vector>
+#include <memory>
+
+
+// MAST includes
+#include "base/mast_data_types.h"
+
+
+namespace libMesh {
+    
+    // Forward declerations
+    class System;
+    class Elem;
+    template <typename T> class NumericVector;
+}
+
+
+namespace MAST {
+    
+    /*!
+     *   Averages the strain, stress and von Mises stress at the nodes of
+     *   the mesh as the stress data of the elements is recovered, for
+     *   visualization of a continuous stress field. The points of an element
+     *   give the element values in the manner of
+     *   MAST::StructuralDiscipline::plot_stress_strain_data(): the
+     *   components with the largest magnitude, and the largest von Mises
+     *   stress. These are added to the vertices of the element with the sum
+     *   of the JxW of its points as the weight. The weighted sums and weights
+     *   are accumulated in parallel vectors of an auxiliary system with
+     *   first order Lagrange variables. close() sums the contributions of all
+     *   processors at the shared nodes, and stores the averages in the
+     *   solution of the system, from which the field can be written, for
+     *   example to an Exodus file.
+     *
+     *   The points are added by MAST::StressStrainOutputBase if this object
+     *   is set with MAST::StressStrainOutputBase::set_nodal_stress_average().
+     *   The output then does not retain the data of all points.
+     */
+    class NodalStressAverage {
+        
+    public:
+        
+        /*!
+         *   \p vars are the 13 variables of \p sys for the six strain
+         *   components, the six stress components and the von Mises stress.
+         *   The variables must use first order Lagrange shape functions.
+         */
+        NodalStressAverage(libMesh::System& sys,
+                           const std::vector<unsigned int>& vars);
+        
+        virtual ~NodalStressAverage();
+        
+        
+        /*!
+         *   @returns a reference to the system in which the averages are
+         *   stored
+         */
+        libMesh::System& system() {
+            return _sys;
+        }
+        
+        
+        /*!
+         *   zeroes the accumulated sums. This must be called before the
+         *   points of a new solution are added.
+         */
+        void zero();
+        
+        
+        /*!
+         *   adds the data of a point of element \p e. The points of an
+         *   element must be added one after the other.
+         */
+        void add_point(const libMesh::Elem& e,
+                       const RealVectorX& strain,
+                       const RealVectorX& stress,
+                       const Real vm,
+                       const Real JxW);
+        
+        
+        /*!
+         *   combines the sums of all processors and computes the nodal
+         *   averages in the solution of the system. Nodes without any
+         *   contribution are set to zero. This must be called on all
+         *   processors after all points are added.
+         */
+        void close();
+        
+    protected:
+        
+        /*!
+         *   adds the values of the current element to its vertices
+         */
+        void _add_elem();
+        
+        /*!
+         *   system with the nodal variables
+         */
+        libMesh::System&                                 _sys;
+        
+        /*!
+         *   variables of the strain, stress and von Mises stress
+         */
+        std::vector<unsigned int>                        _vars;
+        
+        /*!
+         *   element for which the points are being added, its values, and
+         *   the sum of the JxW of its points
+         */
+        const libMesh::Elem*                             _elem;
+        
+        RealVectorX                                      _vals;
+        
+        Real                                             _elem_JxW;
+        
+        /*!
+         *   sum of the weights for each dof of the system
+         */
+        std::auto_ptr<libMesh::NumericVector<Real> >     _weight;
+    };
+}
+
+
+#endif // __mast__nodal_stress_average__
@@ -39,21 +39,12 @@ MAST::NormalRotationMeshFunction::operator()(const libMesh::Point& p,
     
     
     dn_rot.setZero();
-    dn_rot.setZero();
-    
-    libMesh::MeshFunction&
-    function = _func.get_function();
-    
-    // translation is obtained by direct interpolation of the u,v,w vars
-    
-    DenseRealVector v;
-    function(p, 0., v);
-    
     
     // perturbation of the normal requires calculation of the curl of
-    // displacement at the given point
-    std::vector<libMesh::Gradient> gradients;
-    function.gradient(p, 0., gradients);
+    // displacement at the given point. This uses the sparse interpolation
+    // data of the transfer operator if one is attached to the function.
+    RealMatrixX gradients;
+    _func.gradient(p, t, gradients);
     
     // TODO: these need to be mapped from local 2D to 3D space
     
@@ -61,9 +52,9 @@ MAST::NormalRotationMeshFunction::operator()(const libMesh::Point& p,
     RealVectorX
     rot = RealVectorX::Zero(3);
     
-    rot(0) = gradients[2](1) - gradients[1](2); // dwz/dy - dwy/dz
-    rot(1) = gradients[0](2) - gradients[2](0); // dwx/dz - dwz/dx
-    rot(2) = gradients[1](0) - gradients[0](1); // dwy/dx - dwx/dy
+    rot(0) = gradients(2, 1) - gradients(1, 2); // dwz/dy - dwy/dz
+    rot(1) = gradients(0, 2) - gradients(2, 0); // dwx/dz - dwz/dx
+    rot(2) = gradients(1, 0) - gradients(0, 1); // dwy/dx - dwx/dy
     
     // now do the cross-products
     dn_rot(0) =   rot(1) * n(2) - rot(2) * n(1);
@@ -81,21 +72,11 @@ MAST::NormalRotationMeshFunction::perturbation(const libMesh::Point& p,
     
     
     dn_rot.setZero();
-    dn_rot.setZero();
-    
-    libMesh::MeshFunction&
-    perturbed_function = _func.get_perturbed_function();
-    
-    // translation is obtained by direct interpolation of the u,v,w vars
-    
-    DenseRealVector v;
-    perturbed_function(p, 0., v);
-    
     
     // perturbation of the normal requires calculation of the curl of
     // displacement at the given point
-    std::vector<libMesh::Gradient> gradients;
-    perturbed_function.gradient(p, 0., gradients);
+    RealMatrixX gradients;
+    _func.perturbation_gradient(p, t, gradients);
     
     // TODO: these need to be mapped from local 2D to 3D space
     
@@ -103,9 +84,9 @@ MAST::NormalRotationMeshFunction::perturbation(const libMesh::Point& p,
     RealVectorX
     rot = RealVectorX::Zero(3);
     
-    rot(0) = gradients[2](1) - gradients[1](2); // dwz/dy - dwy/dz
-    rot(1) = gradients[0](2) - gradients[2](0); // dwx/dz - dwz/dx
-    rot(2) = gradients[1](0) - gradients[0](1); // dwy/dx - dwx/dy
+    rot(0) = gradients(2, 1) - gradients(1, 2); // dwz/dy - dwy/dz
+    rot(1) = gradients(0, 2) - gradients(2, 0); // dwx/dz - dwz/dx
+    rot(2) = gradients(1, 0) - gradients(0, 1); // dwy/dx - dwx/dy
     
     // now do the cross-products
     dn_rot(0) =   rot(1) * n(2) - rot(2) * n(1);
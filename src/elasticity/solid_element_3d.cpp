@@ -26,17 +26,53 @@
 #include "base/system_initialization.h"
 #include "elasticity/stress_output_base.h"
 #include "base/nonlinear_system.h"
+#include "base/performance_log.h"
+#include "elasticity/incompatible_mode_store.h"
+
+
+// libMesh includes
+#include "libmesh/quadrature_gauss.h"
 
 
 MAST::StructuralElement3D::
 StructuralElement3D(MAST::SystemInitialization& sys,
                     const libMesh::Elem& elem,
                     const MAST::ElementPropertyCardBase& p):
-MAST::StructuralElementBase(sys, elem, p) {
+MAST::StructuralElementBase(sys, elem, p),
+_reduced_fe(nullptr),
+_reduced_qrule(nullptr) {
     
     // now initialize the finite element data structures
     _init_fe_and_qrule(get_elem_for_quadrature(), &_fe, &_qrule);
     
+    // the strain energy with reduced integration is evaluated at the
+    // element center. The remaining element quantities use the full
+    // quadrature.
+    if (p.integration_scheme() == MAST::REDUCED_INTEGRATION) {
+        
+        const libMesh::Elem& e = get_elem_for_quadrature();
+        
+        if (e.type() != libMesh::HEX8)
+            libmesh_error_msg("Reduced integration is only implemented for HEX8 elements.");
+        
+        _reduced_fe    = libMesh::FEBase::build(3, _fe->get_fe_type()).release();
+        _reduced_qrule = new libMesh::QGauss(3, libMesh::CONSTANT);
+        
+        _reduced_fe->get_phi();
+        _reduced_fe->get_xyz();
+        _reduced_fe->get_JxW();
+        _reduced_fe->get_dphi();
+        _reduced_fe->attach_quadrature_rule(_reduced_qrule);
+        _reduced_fe->reinit(&e);
+    }
+}
+
+
+
+MAST::StructuralElement3D::~StructuralElement3D() {
+    
+    if (_reduced_fe)     delete _reduced_fe;
+    if (_reduced_qrule)  delete _reduced_qrule;
 }
 
 
@@ -47,6 +83,8 @@ MAST::StructuralElement3D::inertial_residual (bool request_jacobian,
                                               RealMatrixX& jac_xdot,
                                               RealMatrixX& jac) {
     
+    MAST_LOG_SCOPE("inertial_residual()", "StructuralElement3D");
+    
     const std::vector<Real>& JxW               = _fe->get_JxW();
     const std::vector<libMesh::Point>& xyz     = _fe->get_xyz();
     const std::vector<std::vector<Real> >& phi = _fe->get_phi();
@@ -71,7 +109,11 @@ MAST::StructuralElement3D::inertial_residual (bool request_jacobian,
     libMesh::Point p;
     MAST::FEMOperatorMatrix Bmat;
     
-    if (_property.if_diagonal_mass_matrix()) {
+    const bool
+    if_diagonal = _property.if_diagonal_mass_matrix();
+    
+    if (if_diagonal &&
+        _property.mass_lumping_scheme() == MAST::NODAL_VOLUME_LUMPING) {
         
         // as an approximation, get matrix at the first quadrature point
         _local_elem->global_coordinates_location(xyz[0], p);
@@ -93,6 +135,11 @@ MAST::StructuralElement3D::inertial_residual (bool request_jacobian,
     else {
         libMesh::Point p;
         
+        RealMatrixX
+        local_jac     = RealMatrixX::Zero(n2, n2);
+        RealVectorX
+        local_f       = RealVectorX::Zero(n2);
+        
         for (unsigned int qp=0; qp<JxW.size(); qp++) {
             
             _local_elem->global_coordinates_location(xyz[0], p);
@@ -110,15 +157,26 @@ MAST::StructuralElement3D::inertial_residual (bool request_jacobian,
             vec1_n1 = mat1_n1n2 * _local_accel;
             Bmat.vector_mult_transpose(vec2_n2, vec1_n1);
             
-            f.topRows(n2) += JxW[qp] * vec2_n2;
+            local_f += JxW[qp] * vec2_n2;
             
-            if (request_jacobian) {
+            // the consistent matrix is also needed for the lumped matrix
+            if (request_jacobian || if_diagonal) {
                 
                 Bmat.right_multiply_transpose(mat2_n2n2,
                                               mat1_n1n2);
-                jac_xddot.topLeftCorner(n2, n2) += JxW[qp]*mat2_n2n2;
+                local_jac += JxW[qp]*mat2_n2n2;
             }
         }
+        
+        if (if_diagonal) {
+            
+            _lump_mass_matrix(_property.mass_lumping_scheme(), n_phi, local_jac);
+            local_f = local_jac * _local_accel.topRows(n2);
+        }
+        
+        f.topRows(n2) += local_f;
+        if (request_jacobian)
+            jac_xddot.topLeftCorner(n2, n2) += local_jac;
     }
     
     return request_jacobian;
@@ -132,16 +190,22 @@ MAST::StructuralElement3D::internal_residual(bool request_jacobian,
                                              RealVectorX& f,
                                              RealMatrixX& jac) {
     
-    const std::vector<Real>& JxW            = _fe->get_JxW();
-    const std::vector<libMesh::Point>& xyz  = _fe->get_xyz();
+    MAST_LOG_SCOPE("internal_residual()", "StructuralElement3D");
+    
+    // with reduced integration the strain energy is integrated at the
+    // element center without incompatible modes
+    const bool
+    reduced                                 = (_reduced_fe != nullptr);
+    const libMesh::FEBase& fe               = reduced? *_reduced_fe: *_fe;
+    const std::vector<Real>& JxW            = fe.get_JxW();
+    const std::vector<libMesh::Point>& xyz  = fe.get_xyz();
     const unsigned int
-    n_phi              = (unsigned int)_fe->n_shape_functions(),
+    n_phi              = (unsigned int)fe.n_shape_functions(),
     n1                 =6,
     n2                 =3*n_phi,
     n3                 =30;
     
     RealMatrixX
-    material_mat,
     mat_x        = RealMatrixX::Zero(6,3),
     mat_y        = RealMatrixX::Zero(6,3),
     mat_z        = RealMatrixX::Zero(6,3),
@@ -163,8 +227,9 @@ MAST::StructuralElement3D::internal_residual(bool request_jacobian,
     vec2_n2   = RealVectorX::Zero(n2),
     vec3_3    = RealVectorX::Zero(3),
     local_disp= RealVectorX::Zero(n2),
-    f_alpha   = RealVectorX::Zero(n3),
-    &alpha    = *_incompatible_sol;
+    f_alpha   = RealVectorX::Zero(n3);
+    Eigen::Map<RealVectorX>
+    alpha(reduced? nullptr: _incompatible_mode_values(), n3);
     
     // copy the values from the global to the local element
     local_disp.topRows(n2) = _local_sol.topRows(n2);
@@ -172,7 +237,14 @@ MAST::StructuralElement3D::internal_residual(bool request_jacobian,
     std::auto_ptr<MAST::FieldFunction<RealMatrixX> > mat_stiff =
     _property.stiffness_A_matrix(*this);
     
-    libMesh::Point p;
+    // the material matrices are evaluated for all quadrature points
+    // with a single call, and used by both loops below
+    std::vector<libMesh::Point> qp_xyz(JxW.size());
+    std::vector<RealMatrixX>    material_mats;
+    for (unsigned int qp=0; qp<JxW.size(); qp++)
+        _local_elem->global_coordinates_location(xyz[qp], qp_xyz[qp]);
+    (*mat_stiff)(qp_xyz, _time, material_mats);
+    
     MAST::FEMOperatorMatrix
     Bmat_lin,
     Bmat_nl_x,
@@ -193,78 +265,49 @@ MAST::StructuralElement3D::internal_residual(bool request_jacobian,
     Bmat_inc.reinit(n1, n3, 1);            // six stress-strain components
 
     // initialize the incompatible mode mapping at element mid-point
-    _init_incompatible_fe_mapping(_elem);
+    if (!reduced)
+        _init_incompatible_fe_mapping(_elem);
     
     ///////////////////////////////////////////////////////////////////
-    // first for loop to evaluate alpha
-    for (unsigned int qp=0; qp<JxW.size(); qp++) {
-        
-        _local_elem->global_coordinates_location(xyz[qp], p);
-        
-        // get the material matrix
-        (*mat_stiff)(p, _time, material_mat);
-        
-        this->initialize_green_lagrange_strain_operator(qp,
-                                                        *_fe,
-                                                        local_disp,
-                                                        strain,
-                                                        mat_x, mat_y, mat_z,
-                                                        Bmat_lin,
-                                                        Bmat_nl_x,
-                                                        Bmat_nl_y,
-                                                        Bmat_nl_z,
-                                                        Bmat_nl_u,
-                                                        Bmat_nl_v,
-                                                        Bmat_nl_w);
-        this->initialize_incompatible_strain_operator(qp, *_fe, Bmat_inc, Gmat);
-        
-        // calculate the incompatible mode matrices
-        // incompatible mode diagonal stiffness matrix
-        mat5_n1n3    =  material_mat * Gmat;
-        K_alphaalpha += JxW[qp] * ( Gmat.transpose() * mat5_n1n3);
-        
-        // off-diagonal coupling matrix
-        // linear strain term
-        Bmat_lin.right_multiply_transpose(mat6_n2n3, mat5_n1n3);
-        K_ualpha  += JxW[qp] * mat6_n2n3;
+    // the incompatible mode stiffness depends only on the material and
+    // the element geometry. Its inverse is reused from the persistent
+    // data, if available, and is otherwise computed here.
+    if (!reduced &&
+        _incompatible_data && _incompatible_data->condensed_valid)
+        K_alphaalpha = Eigen::Map<const RealMatrixX>(_incompatible_data->condensed, n3, n3);
+    else if (!reduced) {
         
-        // nonlinear component
-        // along x
-        mat7_3n3  = mat_x.transpose() * mat5_n1n3;
-        Bmat_nl_x.right_multiply_transpose(mat6_n2n3, mat7_3n3);
-        K_ualpha  += JxW[qp] * mat6_n2n3;
+        for (unsigned int qp=0; qp<JxW.size(); qp++) {
+            
+            // get the material matrix
+            const RealMatrixX& material_mat = material_mats[qp];
+            
+            this->initialize_incompatible_strain_operator(qp, *_fe, Bmat_inc, Gmat);
+            
+            // incompatible mode diagonal stiffness matrix
+            mat5_n1n3    =  material_mat * Gmat;
+            K_alphaalpha += JxW[qp] * ( Gmat.transpose() * mat5_n1n3);
+        }
         
-        // along y
-        mat7_3n3  = mat_y.transpose() * mat5_n1n3;
-        Bmat_nl_y.right_multiply_transpose(mat6_n2n3, mat7_3n3);
-        K_ualpha  += JxW[qp] * mat6_n2n3;
+        K_alphaalpha = K_alphaalpha.inverse();
         
-        // along z
-        mat7_3n3  = mat_z.transpose() * mat5_n1n3;
-        Bmat_nl_z.right_multiply_transpose(mat6_n2n3, mat7_3n3);
-        K_ualpha  += JxW[qp] * mat6_n2n3;
+        if (_incompatible_data) {
+            
+            Eigen::Map<RealMatrixX>(_incompatible_data->condensed, n3, n3) = K_alphaalpha;
+            _incompatible_data->condensed_valid = true;
+        }
     }
     
     
-    // incompatible mode corrections
-    K_alphaalpha = K_alphaalpha.inverse();
-    K_corr = K_ualpha * K_alphaalpha * K_ualpha.transpose();
-    
-    if (request_jacobian)
-        jac.topLeftCorner(n2, n2) -= K_corr;
-
-    
     ///////////////////////////////////////////////////////////////////////
     // second for loop to calculate the residual and stiffness contributions
     for (unsigned int qp=0; qp<JxW.size(); qp++) {
         
-        _local_elem->global_coordinates_location(xyz[qp], p);
-        
         // get the material matrix
-        (*mat_stiff)(p, _time, material_mat);
+        const RealMatrixX& material_mat = material_mats[qp];
         
         this->initialize_green_lagrange_strain_operator(qp,
-                                                        *_fe,
+                                                        fe,
                                                         local_disp,
                                                         strain,
                                                         mat_x, mat_y, mat_z,
@@ -275,13 +318,41 @@ MAST::StructuralElement3D::internal_residual(bool request_jacobian,
                                                         Bmat_nl_u,
                                                         Bmat_nl_v,
                                                         Bmat_nl_w);
-        this->initialize_incompatible_strain_operator(qp, *_fe, Bmat_inc, Gmat);
-        
-        // calculate the stress
-        stress = material_mat * (strain + Gmat * alpha);
         
-        // residual from incompatible modes
-        f_alpha += JxW[qp] * Gmat.transpose() * stress;
+        if (reduced)
+            stress = material_mat * strain;
+        else {
+            
+            this->initialize_incompatible_strain_operator(qp, *_fe, Bmat_inc, Gmat);
+            
+            // calculate the stress
+            stress = material_mat * (strain + Gmat * alpha);
+            
+            // residual from incompatible modes
+            f_alpha += JxW[qp] * Gmat.transpose() * stress;
+            
+            // off-diagonal coupling matrix
+            // linear strain term
+            mat5_n1n3    =  material_mat * Gmat;
+            Bmat_lin.right_multiply_transpose(mat6_n2n3, mat5_n1n3);
+            K_ualpha  += JxW[qp] * mat6_n2n3;
+            
+            // nonlinear component
+            // along x
+            mat7_3n3  = mat_x.transpose() * mat5_n1n3;
+            Bmat_nl_x.right_multiply_transpose(mat6_n2n3, mat7_3n3);
+            K_ualpha  += JxW[qp] * mat6_n2n3;
+            
+            // along y
+            mat7_3n3  = mat_y.transpose() * mat5_n1n3;
+            Bmat_nl_y.right_multiply_transpose(mat6_n2n3, mat7_3n3);
+            K_ualpha  += JxW[qp] * mat6_n2n3;
+            
+            // along z
+            mat7_3n3  = mat_z.transpose() * mat5_n1n3;
+            Bmat_nl_z.right_multiply_transpose(mat6_n2n3, mat7_3n3);
+            K_ualpha  += JxW[qp] * mat6_n2n3;
+        }
         
         // calculate contribution to the residual
         // linear strain operator
@@ -397,14 +468,27 @@ MAST::StructuralElement3D::internal_residual(bool request_jacobian,
         }
     }
     
+    if (reduced)
+        // stabilization of the zero energy modes
+        _hourglass_residual(request_jacobian, local_disp, material_mats.back(), f, jac);
+    else {
+        
+        // incompatible mode corrections
+        if (request_jacobian) {
+            
+            K_corr = K_ualpha * K_alphaalpha * K_ualpha.transpose();
+            jac.topLeftCorner(n2, n2) -= K_corr;
+        }
+        
+        // correction to the residual from incompatible mode
+        f.topRows(n2) -= K_ualpha * (K_alphaalpha * f_alpha);
+    }
+    
     // if jacobian is requested, add a small diagonal value for the
     // rotational dofs
     if (request_jacobian)
         jac.bottomRightCorner(n2, n2) += RealMatrixX::Identity(n2, n2) *
         1.0e-20 * jac.diagonal().maxCoeff();
-
-    // correction to the residual from incompatible mode
-    f.topRows(n2) -= K_ualpha * (K_alphaalpha * f_alpha);
     
     return request_jacobian;
 }
@@ -448,8 +532,14 @@ update_incompatible_mode_solution(const RealVectorX& dsol) {
     vec2_n2   = RealVectorX::Zero(n2),
     vec3_3    = RealVectorX::Zero(3),
     local_disp= RealVectorX::Zero(n2),
-    &alpha    = *_incompatible_sol,
     f         = RealVectorX::Zero(n3);
+    Eigen::Map<RealVectorX>
+    alpha(_incompatible_mode_values(), n3);
+    
+    // the inverse of the incompatible mode stiffness is reused from
+    // the persistent data, if available
+    const bool
+    if_condensed = (_incompatible_data && _incompatible_data->condensed_valid);
     
     // copy the values from the global to the local element
     local_disp.topRows(n2) = _local_sol.topRows(n2);
@@ -513,7 +603,8 @@ update_incompatible_mode_solution(const RealVectorX& dsol) {
         // calculate the incompatible mode matrices
         // incompatible mode diagonal stiffness matrix
         mat5_n1n3    =  material_mat * Gmat;
-        K_alphaalpha += JxW[qp] * ( Gmat.transpose() * mat5_n1n3);
+        if (!if_condensed)
+            K_alphaalpha += JxW[qp] * ( Gmat.transpose() * mat5_n1n3);
 
         // off-diagonal coupling matrix
         // linear strain term
@@ -539,7 +630,18 @@ update_incompatible_mode_solution(const RealVectorX& dsol) {
     
     
     // incompatible mode Jacobian inverse
-    K_alphaalpha = K_alphaalpha.inverse();
+    if (if_condensed)
+        K_alphaalpha = Eigen::Map<const RealMatrixX>(_incompatible_data->condensed, n3, n3);
+    else {
+        
+        K_alphaalpha = K_alphaalpha.inverse();
+        
+        if (_incompatible_data) {
+            
+            Eigen::Map<RealMatrixX>(_incompatible_data->condensed, n3, n3) = K_alphaalpha;
+            _incompatible_data->condensed_valid = true;
+        }
+    }
     
     // update the alpha values
     alpha += K_alphaalpha * (-f - K_ualpha.transpose() * dsol.topRows(n2));
@@ -587,6 +689,8 @@ surface_pressure_residual(bool request_jacobian,
                           const unsigned int side,
                           MAST::BoundaryConditionBase& bc) {
     
+    MAST_LOG_SCOPE("surface_pressure_residual()", "StructuralElement3D");
+    
     libmesh_assert(!follower_forces); // not implemented yet for follower forces
     
     // prepare the side finite element
@@ -749,6 +853,8 @@ MAST::StructuralElement3D::thermal_residual(bool request_jacobian,
                                             RealMatrixX& jac,
                                             MAST::BoundaryConditionBase& bc) {
     
+    MAST_LOG_SCOPE("thermal_residual()", "StructuralElement3D");
+    
     const std::vector<Real>& JxW            = _fe->get_JxW();
     const std::vector<libMesh::Point>& xyz  = _fe->get_xyz();
     
@@ -795,25 +901,51 @@ MAST::StructuralElement3D::thermal_residual(bool request_jacobian,
     Bmat_nl_v.reinit(3, 3, _elem.n_nodes());
     Bmat_nl_w.reinit(3, 3, _elem.n_nodes());
 
+    // the thermal stress does not depend on the solution, and is reused
+    // from the retained data if available. The load is computed with the
+    // Green-Lagrange strain operators, which depend on the solution.
+    MAST::ThermalLoadData*
+    data       = this->_thermal_load_data(bc);
+    const bool
+    if_cached  = data && data->valid;
+    
     std::auto_ptr<MAST::FieldFunction<RealMatrixX> >
-    mat = _property.thermal_expansion_A_matrix(*this);
+    mat;
+    
+    if (!if_cached) {
+        mat = _property.thermal_expansion_A_matrix(*this);
+        if (data) data->stress.resize(n1, JxW.size());
+    }
     
     const MAST::FieldFunction<Real>
     &temp_func     = bc.get<MAST::FieldFunction<Real> >("temperature"),
     &ref_temp_func = bc.get<MAST::FieldFunction<Real> >("ref_temperature");
     
+    // temperature from the nodal values of a thermal system on the
+    // same mesh, if available
+    std::vector<Real> qp_temp;
+    const bool
+    if_direct_temp = !if_cached && this->_direct_qp_temperature(temp_func, *_fe, qp_temp);
+    
     Real t, t0;
     
     for (unsigned int qp=0; qp<JxW.size(); qp++) {
         
-        _local_elem->global_coordinates_location(xyz[qp], p);
-        
-        (*mat)       (p, _time, material_exp_A_mat);
-        temp_func    (p, _time, t);
-        ref_temp_func(p, _time, t0);
-        delta_t(0) = t-t0;
-        
-        vec1_n1 = material_exp_A_mat * delta_t; // [C]{alpha (T - T0)}
+        if (if_cached)
+            vec1_n1 = data->stress.col(qp);
+        else {
+            
+            _local_elem->global_coordinates_location(xyz[qp], p);
+            
+            (*mat)       (p, _time, material_exp_A_mat);
+            if (if_direct_temp) t = qp_temp[qp];
+            else temp_func(p, _time, t);
+            ref_temp_func(p, _time, t0);
+            delta_t(0) = t-t0;
+            
+            vec1_n1 = material_exp_A_mat * delta_t; // [C]{alpha (T - T0)}
+            if (data) data->stress.col(qp) = vec1_n1;
+        }
         
         this->initialize_green_lagrange_strain_operator(qp,
                                                         *_fe,
@@ -876,6 +1008,12 @@ MAST::StructuralElement3D::thermal_residual(bool request_jacobian,
             jac.topLeftCorner(n2, n2) -= JxW[qp] * mat2_n2n2;
         }
     }
+    
+    if (data && !if_cached) {
+        data->f.resize(0);
+        data->time  = _time;
+        data->valid = true;
+    }
 
     // Jacobian contribution from von Karman strain
     return request_jacobian;
@@ -907,6 +1045,8 @@ piston_theory_residual(bool request_jacobian,
                        const unsigned int side,
                        MAST::BoundaryConditionBase& bc) {
     
+    MAST_LOG_SCOPE("piston_theory_residual()", "StructuralElement3D");
+    
     
     libmesh_error(); // to be implemented
     
@@ -998,8 +1138,9 @@ MAST::StructuralElement3D::calculate_stress(bool request_derivative,
     RealVectorX
     strain    = RealVectorX::Zero(6),
     stress    = RealVectorX::Zero(6),
-    local_disp= RealVectorX::Zero(n2),
-    &alpha    = *_incompatible_sol;
+    local_disp= RealVectorX::Zero(n2);
+    Eigen::Map<RealVectorX>
+    alpha(if_incompatible_modes()? _incompatible_mode_values(): nullptr, n3);
     
     // copy the values from the global to the local element
     local_disp.topRows(n2) = _local_sol.topRows(n2);
@@ -1032,7 +1173,8 @@ MAST::StructuralElement3D::calculate_stress(bool request_derivative,
     dynamic_cast<MAST::StressStrainOutputBase&>(output);
     
     // initialize the incompatible mode mapping at element mid-point
-    _init_incompatible_fe_mapping(_elem);
+    if (if_incompatible_modes())
+        _init_incompatible_fe_mapping(_elem);
     
     ///////////////////////////////////////////////////////////////////////
     // second for loop to calculate the residual and stiffness contributions
@@ -1055,10 +1197,13 @@ MAST::StructuralElement3D::calculate_stress(bool request_derivative,
                                                         Bmat_nl_u,
                                                         Bmat_nl_v,
                                                         Bmat_nl_w);
-        this->initialize_incompatible_strain_operator(qp, *fe, Bmat_inc, Gmat);
+        if (if_incompatible_modes()) {
+            
+            this->initialize_incompatible_strain_operator(qp, *fe, Bmat_inc, Gmat);
+            strain += Gmat * alpha;
+        }
         
         // calculate the stress
-        strain += Gmat * alpha;
         stress = material_mat * strain;
         
         stress_output.add_stress_strain_at_qp_location(&_elem,
@@ -1082,6 +1227,75 @@ MAST::StructuralElement3D::calculate_stress(bool request_derivative,
 
 
 
+void
+MAST::StructuralElement3D::
+_hourglass_residual(bool request_jacobian,
+                    const RealVectorX& local_disp,
+                    const RealMatrixX& material_mat,
+                    RealVectorX& f,
+                    RealMatrixX& jac) {
+    
+    MAST_LOG_SCOPE("_hourglass_residual()", "StructuralElement3D");
+    
+    // hourglass base vectors of the HEX8 element in the libMesh node
+    // ordering: xi*eta, eta*zeta, zeta*xi and xi*eta*zeta
+    static const Real
+    h[4][8] = {
+        { 1., -1.,  1., -1.,  1., -1.,  1., -1.},
+        { 1.,  1., -1., -1., -1., -1.,  1.,  1.},
+        { 1., -1., -1.,  1., -1.,  1.,  1., -1.},
+        {-1.,  1., -1.,  1.,  1., -1.,  1., -1.}};
+    
+    const libMesh::Elem& e = get_elem_for_quadrature();
+    const std::vector<std::vector<libMesh::RealVectorValue> >&
+    dphi = _reduced_fe->get_dphi();
+    
+    RealMatrixX
+    x     = RealMatrixX::Zero(8, 3),
+    b     = RealMatrixX::Zero(8, 3),
+    gamma = RealMatrixX::Zero(8, 4),
+    K_hg;
+    RealVectorX
+    h_vec = RealVectorX::Zero(8);
+    
+    // nodal coordinates and the shape function gradients at the center
+    for (unsigned int i=0; i<8; i++)
+        for (unsigned int j=0; j<3; j++) {
+            x(i, j) = e.point(i)(j);
+            b(i, j) = dphi[i][0](j);
+        }
+    
+    // the hourglass shape vectors are orthogonal to the linear field
+    for (unsigned int i=0; i<4; i++) {
+        
+        for (unsigned int j=0; j<8; j++)
+            h_vec(j) = h[i][j];
+        
+        gamma.col(i) = h_vec - b * (x.transpose() * h_vec);
+    }
+    
+    // the stabilization is scaled with the largest dilatational
+    // modulus of the material and the element size
+    const Real
+    vol   = _reduced_fe->get_JxW()[0],
+    c     = _property.hourglass_coefficient() *
+    material_mat.topLeftCorner(3, 3).diagonal().maxCoeff() *
+    vol * b.squaredNorm() / 3.;
+    
+    K_hg = c * gamma * gamma.transpose();
+    
+    // the same stiffness is used for each displacement component
+    for (unsigned int i=0; i<3; i++) {
+        
+        f.segment(i*8, 8) += K_hg * local_disp.segment(i*8, 8);
+        
+        if (request_jacobian)
+            jac.block(i*8, i*8, 8, 8) += K_hg;
+    }
+}
+
+
+
 void
 MAST::StructuralElement3D::initialize_strain_operator (const unsigned int qp,
                                                        const libMesh::FEBase& fe,
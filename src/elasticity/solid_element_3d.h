@@ -41,6 +41,8 @@ namespace MAST {
                             const MAST::ElementPropertyCardBase& p);
         
         
+        virtual ~StructuralElement3D();
+        
         
         /*!
          *   Calculates the inertial force and the Jacobian matrices
@@ -95,11 +97,11 @@ namespace MAST {
         
         
         /*!
-         *  @returns false since this element formulation does not use
-         *  incompatible modes
+         *  @returns true since this element formulation uses incompatible
+         *  modes, unless the element uses reduced integration
          */
         virtual bool if_incompatible_modes() const {
-            return true;
+            return _reduced_fe == nullptr;
         }
 
         
@@ -307,6 +309,29 @@ namespace MAST {
          *   Jacobian matrix at element center needed for incompatible modes
          */
         RealMatrixX _T0_inv_tr;
+        
+        
+        /*!
+         *   adds the Flanagan-Belytschko hourglass stabilization of the
+         *   one-point reduced integration of HEX8 elements to \p f and
+         *   \p jac. \p material_mat is the material stiffness matrix at
+         *   the element center.
+         */
+        void _hourglass_residual(bool request_jacobian,
+                                 const RealVectorX& local_disp,
+                                 const RealMatrixX& material_mat,
+                                 RealVectorX& f,
+                                 RealMatrixX& jac);
+        
+        
+        /*!
+         *   finite element and single point quadrature rule used for the
+         *   strain energy with reduced integration. These are nullptr if
+         *   the element uses full integration.
+         */
+        libMesh::FEBase* _reduced_fe;
+        
+        libMesh::QBase*  _reduced_qrule;
 
     };
 }
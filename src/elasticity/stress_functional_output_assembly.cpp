@@ -0,0 +1,335 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2017  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+// C++ includes
+#include <map>
+
+
+// MAST includes
+#include "elasticity/stress_functional_output_assembly.h"
+#include "elasticity/stress_output_base.h"
+#include "elasticity/structural_element_base.h"
+#include "property_cards/element_property_card_base.h"
+#include "base/physics_discipline_base.h"
+#include "base/system_initialization.h"
+#include "base/nonlinear_system.h"
+#include "base/nonlinear_implicit_assembly.h"
+#include "base/elementwise_design_field.h"
+#include "base/mesh_field_function.h"
+#include "base/performance_log.h"
+#include "numerics/utility.h"
+
+
+// libMesh includes
+#include "libmesh/numeric_vector.h"
+#include "libmesh/dof_map.h"
+
+
+
+MAST::StressFunctionalOutputAssembly::
+StressFunctionalOutputAssembly(MAST::StressStrainOutputBase& output):
+MAST::OutputAssemblyBase(),
+_output(output) {
+    
+    libmesh_assert_msg(output.stress_functional() != MAST::NO_STRESS_FUNCTIONAL,
+                       "Error: stress functional not set for the output.");
+}
+
+
+
+MAST::StressFunctionalOutputAssembly::~StressFunctionalOutputAssembly() {
+    
+}
+
+
+
+void
+MAST::StressFunctionalOutputAssembly::
+attach_discipline_and_system(MAST::PhysicsDisciplineBase& discipline,
+                             MAST::SystemInitialization& system) {
+    
+    libmesh_assert_msg(!_discipline && !_system,
+                       "Error: Assembly should be cleared before attaching System.");
+    
+    _discipline = &discipline;
+    _system     = &system;
+}
+
+
+
+Real
+MAST::StressFunctionalOutputAssembly::
+calculate_output(const libMesh::NumericVector<Real>& X) {
+    
+    MAST_LOG_SCOPE("calculate_output()", "StressFunctionalOutputAssembly");
+    
+    std::vector<const libMesh::Elem*> elems;
+    
+    this->_evaluate(X, false, nullptr, nullptr, elems);
+    
+    return _output.aggregated_stress_functional();
+}
+
+
+
+Real
+MAST::StressFunctionalOutputAssembly::
+calculate_output_sensitivity(const libMesh::NumericVector<Real>& X,
+                             const MAST::FunctionBase& f,
+                             const libMesh::NumericVector<Real>* dX) {
+    
+    MAST_LOG_SCOPE("calculate_output_sensitivity()", "StressFunctionalOutputAssembly");
+    
+    std::vector<const libMesh::Elem*> elems;
+    
+    this->_evaluate(X, false, &f, dX, elems);
+    
+    return _output.aggregated_stress_functional_sensitivity(&f,
+                                                            _system->system().comm());
+}
+
+
+
+Real
+MAST::StressFunctionalOutputAssembly::
+calculate_adjoint_sensitivity(MAST::NonlinearImplicitAssembly& assembly,
+                              const libMesh::ParameterVector& params,
+                              const unsigned int i,
+                              const libMesh::NumericVector<Real>& adjoint) {
+    
+    libmesh_assert(_system);
+    libmesh_assert_equal_to(&assembly.system(), &_system->system());
+    
+    MAST::NonlinearSystem& sys = _system->system();
+    
+    const MAST::FunctionBase* f = _discipline->get_parameter(&(params[i].get()));
+    libmesh_assert(f);
+    
+    // partial sensitivity of the output
+    const Real
+    dq_dp = this->calculate_output_sensitivity(*sys.solution, *f);
+    
+    // -dR/dp, with the constraints applied
+    std::auto_ptr<libMesh::NumericVector<Real> >
+    rhs(sys.solution->zero_clone().release());
+    
+    assembly.sensitivity_assemble(params, i, *rhs);
+    
+    return dq_dp + rhs->dot(adjoint);
+}
+
+
+
+void
+MAST::StressFunctionalOutputAssembly::
+assemble_output_derivative(const libMesh::NumericVector<Real>& X,
+                           libMesh::NumericVector<Real>& dq_dX) {
+    
+    MAST_LOG_SCOPE("assemble_output_derivative()", "StressFunctionalOutputAssembly");
+    
+    MAST::NonlinearSystem& sys = _system->system();
+    
+    dq_dX.zero();
+    
+    std::vector<const libMesh::Elem*> elems;
+    
+    this->_evaluate(X, true, nullptr, nullptr, elems);
+    
+    RealVectorX vec, vec_global;
+    
+    std::vector<libMesh::dof_id_type> dof_indices;
+    const libMesh::DofMap& dof_map = sys.get_dof_map();
+    const MAST::ElementTopologyCache& topology = sys.topology_cache();
+    std::auto_ptr<MAST::ElementBase> elem_storage;
+    DenseRealVector v;
+    
+    std::vector<const libMesh::Elem*>::const_iterator
+    el     = elems.begin(),
+    end_el = elems.end();
+    
+    for ( ; el != end_el; ++el) {
+        
+        const libMesh::Elem* elem = *el;
+        
+        vec = _output.aggregated_stress_functional_state_derivative_for_elem(elem);
+        
+        if (!vec.size())
+            continue;
+        
+        // the derivative of the stress of 1D and 2D elements is with
+        // respect to the solution in the element coordinate system
+        if (elem->dim() < 3) {
+            
+            MAST::StructuralElementBase& e =
+            dynamic_cast<MAST::StructuralElementBase&>(_get_elem(*elem, elem_storage));
+            
+            vec_global.setZero(vec.size());
+            e.transform_vector_to_global_system(vec, vec_global);
+            vec = vec_global;
+        }
+        
+        topology.dof_indices (elem, dof_indices);
+        
+        MAST::copy(v, vec);
+        
+        // constrain the quantities to account for hanging dofs,
+        // Dirichlet constraints, etc.
+        if (topology.has_constrained_dofs(*elem))
+            dof_map.constrain_element_vector(v, dof_indices);
+        
+        dq_dX.add_vector(v, dof_indices);
+    }
+    
+    dq_dX.close();
+}
+
+
+
+void
+MAST::StressFunctionalOutputAssembly::
+add_elementwise_output_partial_sensitivity(const libMesh::NumericVector<Real>& X,
+                                           const MAST::ElementwiseDesignField& f,
+                                           libMesh::NumericVector<Real>& sens) {
+    
+    MAST_LOG_SCOPE("elementwise_output_partial_sensitivity()", "StressFunctionalOutputAssembly");
+    
+    std::vector<const libMesh::Elem*> elems;
+    
+    // the functional of all elements is needed for the derivative, and
+    // the points of each element contribute only to the sensitivity with
+    // respect to its own design value
+    this->_evaluate(X, false, &f, nullptr, elems);
+    
+    const std::vector<const libMesh::Elem*>&
+    dep_elems = _discipline->get_dependent_local_elems(f);
+    
+    std::vector<const libMesh::Elem*>::const_iterator
+    el     = dep_elems.begin(),
+    end_el = dep_elems.end();
+    
+    for ( ; el != end_el; ++el)
+        sens.add(f.dof_index(**el),
+                 _output.aggregated_stress_functional_sensitivity_for_elem(&f, *el));
+}
+
+
+
+std::auto_ptr<MAST::ElementBase>
+MAST::StressFunctionalOutputAssembly::_build_elem(const libMesh::Elem& elem) {
+    
+    const MAST::ElementPropertyCardBase& p =
+    dynamic_cast<const MAST::ElementPropertyCardBase&>(_discipline->get_property_card(elem));
+    
+    MAST::ElementBase* rval =
+    MAST::build_structural_element(*_system, elem, p).release();
+    
+    return std::auto_ptr<MAST::ElementBase>(rval);
+}
+
+
+
+void
+MAST::StressFunctionalOutputAssembly::
+_evaluate(const libMesh::NumericVector<Real>& X,
+          bool if_derivative,
+          const MAST::FunctionBase* f,
+          const libMesh::NumericVector<Real>* dX,
+          std::vector<const libMesh::Elem*>& elems) {
+    
+    libmesh_assert(_system);
+    
+    MAST::NonlinearSystem& sys = _system->system();
+    
+    _output.clear(false);
+    elems.clear();
+    
+    RealVectorX sol, sol_sens;
+    
+    std::vector<libMesh::dof_id_type> dof_indices;
+    const MAST::ElementTopologyCache& topology = sys.topology_cache();
+    std::auto_ptr<MAST::ElementBase> elem_storage;
+    MAST::ElementBase* physics_elem = nullptr;
+    
+    std::multimap<libMesh::subdomain_id_type, MAST::OutputFunctionBase*>
+    output_map;
+    
+    std::auto_ptr<libMesh::NumericVector<Real> >
+    localized_solution,
+    localized_solution_sensitivity;
+    
+    localized_solution.reset(_build_localized_vector(sys, X).release());
+    if (dX)
+        localized_solution_sensitivity.reset(_build_localized_vector(sys, *dX).release());
+    
+    // if a solution function is attached, initialize it
+    if (_sol_function)
+        _sol_function->init( X);
+    
+    libMesh::MeshBase::const_element_iterator
+    el     = sys.get_mesh().active_local_elements_begin(),
+    end_el = sys.get_mesh().active_local_elements_end();
+    
+    for ( ; el != end_el; ++el) {
+        
+        const libMesh::Elem* elem = *el;
+        
+        if (!_output.evaluate_for_element(*elem))
+            continue;
+        
+        elems.push_back(elem);
+        
+        topology.dof_indices (elem, dof_indices);
+        
+        physics_elem = &_get_elem(*elem, elem_storage);
+        
+        // get the solution
+        unsigned int ndofs = (unsigned int)dof_indices.size();
+        sol.setZero(ndofs);
+        sol_sens.setZero(ndofs);
+        
+        _get_elem_values(*localized_solution, dof_indices, sol);
+        
+        if (localized_solution_sensitivity.get())
+            _get_elem_values(*localized_solution_sensitivity, dof_indices, sol_sens);
+        
+        physics_elem->sensitivity_param = f;
+        physics_elem->set_solution(sol);
+        physics_elem->set_solution(sol_sens, true);
+        
+        if (_sol_function)
+            physics_elem->attach_active_solution_function(*_sol_function);
+        
+        output_map.clear();
+        output_map.insert(std::make_pair(elem->subdomain_id(),
+                                         (MAST::OutputFunctionBase*)&_output));
+        
+        physics_elem->volume_output_quantity(if_derivative,
+                                             f != nullptr,
+                                             output_map);
+        
+        physics_elem->detach_active_solution_function();
+    }
+    
+    // if a solution function is attached, clear it
+    if (_sol_function)
+        _sol_function->clear();
+    
+    _output.synchronize_aggregated_stress_functional(sys.comm());
+}
+
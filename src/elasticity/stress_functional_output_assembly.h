@@ -0,0 +1,181 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2017  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef __mast__stress_functional_output_assembly__
+#define __mast__stress_functional_output_assembly__
+
+// C++ includes
+#include <vector>
+
+// MAST includes
+#include "base/output_assembly_base.h"
+
+// libMesh includes
+#include "libmesh/parameter_vector.h"
+
+
+namespace MAST {
+    
+    // Forward declarations
+    class StressStrainOutputBase;
+    class FunctionBase;
+    class NonlinearImplicitAssembly;
+    
+    
+    /*!
+     *   Evaluates the aggregated von Mises stress functional of a
+     *   MAST::StressStrainOutputBase object, and provides its derivatives
+     *   for the adjoint sensitivity analysis with
+     *   MAST::NonlinearSystem::adjoint_solve() and
+     *   MAST::NonlinearImplicitAssembly::calculate_elementwise_output_sensitivity().
+     *   The functional must be set on the output with
+     *   MAST::StressStrainOutputBase::set_stress_functional(), and is
+     *   evaluated on the active local elements for which the output
+     *   is evaluated. The output is cleared before each evaluation.
+     *
+     *   The object only refers to the discipline and system, so that the
+     *   nonlinear assembly attached to the same system remains the
+     *   residual and Jacobian object of the solver.
+     */
+    class StressFunctionalOutputAssembly:
+    public MAST::OutputAssemblyBase {
+        
+    public:
+        
+        StressFunctionalOutputAssembly(MAST::StressStrainOutputBase& output);
+        
+        virtual ~StressFunctionalOutputAssembly();
+        
+        
+        /*!
+         *   attaches the discipline and system to this object.
+         */
+        virtual void
+        attach_discipline_and_system(MAST::PhysicsDisciplineBase& discipline,
+                                     MAST::SystemInitialization& system);
+        
+        
+        /*!
+         *   nothing is done here since this object does not provide the
+         *   residual or Jacobian of the system
+         */
+        virtual void
+        reattach_to_system() { }
+        
+        
+        /*!
+         *   @returns the output object
+         */
+        MAST::StressStrainOutputBase& output() {
+            return _output;
+        }
+        
+        
+        /*!
+         *   @returns the aggregated functional about the solution \p X.
+         *   This must be called on all processors.
+         */
+        Real calculate_output(const libMesh::NumericVector<Real>& X);
+        
+        
+        /*!
+         *   @returns the sensitivity of the aggregated functional about the
+         *   solution \p X with respect to \p f. The total sensitivity is
+         *   returned if the sensitivity of the solution \p dX is given,
+         *   and the partial sensitivity otherwise. This must be called on
+         *   all processors.
+         */
+        Real calculate_output_sensitivity(const libMesh::NumericVector<Real>& X,
+                                          const MAST::FunctionBase& f,
+                                          const libMesh::NumericVector<Real>* dX = nullptr);
+        
+        
+        /*!
+         *   @returns the total sensitivity of the aggregated functional
+         *   about the current solution of the system with respect to the
+         *   i^th parameter in \p params, computed with the adjoint solution
+         *   in \p adjoint as \f$ \partial q/\partial p +
+         *   \{\lambda\}^T \{-\partial R/\partial p\} \f$. The right hand
+         *   side of the sensitivity equations
+         *   \f$ -\partial R/\partial p \f$ is assembled by \p assembly,
+         *   which must be attached to the same system. The parameters
+         *   must be added to the discipline.
+         */
+        Real
+        calculate_adjoint_sensitivity(MAST::NonlinearImplicitAssembly& assembly,
+                                      const libMesh::ParameterVector& params,
+                                      const unsigned int i,
+                                      const libMesh::NumericVector<Real>& adjoint);
+        
+        
+        /*!
+         *   assembles the derivative of the aggregated functional with
+         *   respect to the solution \p X in \p dq_dX.
+         */
+        virtual void
+        assemble_output_derivative(const libMesh::NumericVector<Real>& X,
+                                   libMesh::NumericVector<Real>& dq_dX);
+        
+        
+        /*!
+         *   adds to \p sens the partial derivative of the aggregated
+         *   functional with respect to the design value of each local
+         *   element of \p f.
+         */
+        virtual void
+        add_elementwise_output_partial_sensitivity(const libMesh::NumericVector<Real>& X,
+                                                   const MAST::ElementwiseDesignField& f,
+                                                   libMesh::NumericVector<Real>& sens);
+        
+    protected:
+        
+        
+        /*!
+         *   @returns the structural element for \p elem
+         */
+        virtual std::auto_ptr<MAST::ElementBase>
+        _build_elem(const libMesh::Elem& elem);
+        
+        
+        /*!
+         *   clears the output and evaluates it on all elements about the
+         *   solution \p X. The derivative with respect to the solution is
+         *   calculated if \p if_derivative is \p true, and the sensitivity
+         *   with respect to \p f if it is not \p nullptr, for which the
+         *   solution sensitivity \p dX is used if it is given. The
+         *   aggregated functional is then synchronized across processors,
+         *   and \p elems is set to the elements on which the output was
+         *   evaluated.
+         */
+        void _evaluate(const libMesh::NumericVector<Real>& X,
+                       bool if_derivative,
+                       const MAST::FunctionBase* f,
+                       const libMesh::NumericVector<Real>* dX,
+                       std::vector<const libMesh::Elem*>& elems);
+        
+        
+        /*!
+         *   output object that computes the functional
+         */
+        MAST::StressStrainOutputBase& _output;
+    };
+}
+
+
+#endif // __mast__stress_functional_output_assembly__
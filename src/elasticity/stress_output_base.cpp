@@ -18,27 +18,23 @@
  */
 
 
+// C++ includes
+#include <algorithm>
+
+
 // MAST includes
 #include "elasticity/stress_output_base.h"
+#include "elasticity/nodal_stress_average.h"
 #include "base/boundary_condition_base.h"
+#include "base/memory_report.h"
 
 
-MAST::StressStrainOutputBase::Data::Data(const RealVectorX& stress,
-                                         const RealVectorX& strain,
-                                         const libMesh::Point& qp,
-                                         const libMesh::Point& xyz,
-                                         Real JxW):
-_stress(stress),
-_strain(strain),
-_qp(qp),
-_xyz(xyz),
-_JxW(JxW) {
+MAST::StressStrainOutputBase::Data::Data(MAST::StressStrainOutputBase& output,
+                                         unsigned int index):
+_output(&output),
+_index(index) {
 
-    // make sure that both the stress and strain are for a 3D configuration,
-    // which is the default for this data structure
-    libmesh_assert_equal_to(stress.size(), 6);
-    libmesh_assert_equal_to(strain.size(), 6);
-    
+    libmesh_assert_less(index, output.n_stress_strain_data());
 }
 
 
@@ -47,21 +43,22 @@ const libMesh::Point&
 MAST::StressStrainOutputBase::Data::
 point_location_in_element_coordinate() const {
 
-    return _qp;
+    return _output->point_location_in_element_coordinate(_index);
 }
 
 
-const RealVectorX&
+Eigen::Map<const RealVectorX>
 MAST::StressStrainOutputBase::Data::stress() const {
     
-    return _stress;
+    return _output->stress(_index);
 }
 
 
 
-const RealVectorX&
+Eigen::Map<const RealVectorX>
 MAST::StressStrainOutputBase::Data::strain() const {
-    return _strain;
+    
+    return _output->strain(_index);
 }
 
 
@@ -70,34 +67,29 @@ void
 MAST::StressStrainOutputBase::Data::set_derivatives(const RealMatrixX& dstress_dX,
                                                     const RealMatrixX& dstrain_dX) {
     
-    // make sure that the number of rows is 6.
-    libmesh_assert_equal_to(dstress_dX.rows(), 6);
-    libmesh_assert_equal_to(dstrain_dX.rows(), 6);
-    
-    _dstress_dX = dstress_dX;
-    _dstrain_dX = dstrain_dX;
+    _output->set_derivatives(_index, dstress_dX, dstrain_dX);
 }
 
 
 
-const RealMatrixX&
+Eigen::Map<const RealMatrixX>
 MAST::StressStrainOutputBase::Data::get_dstress_dX() const {
     
-    return _dstress_dX;
+    return _output->get_dstress_dX(_index);
 }
 
 
-const RealMatrixX&
+Eigen::Map<const RealMatrixX>
 MAST::StressStrainOutputBase::Data::get_dstrain_dX() const {
     
-    return _dstrain_dX;
+    return _output->get_dstrain_dX(_index);
 }
 
 
 Real
 MAST::StressStrainOutputBase::Data::quadrature_point_JxW() const {
     
-    return _JxW;
+    return _output->quadrature_point_JxW(_index);
 }
 
 
@@ -106,45 +98,25 @@ MAST::StressStrainOutputBase::Data::set_sensitivity(const MAST::FunctionBase* f,
                                                     const RealVectorX& dstress_df,
                                                     const RealVectorX& dstrain_df) {
 
-    // make sure that both the stress and strain are for a 3D configuration,
-    // which is the default for this data structure
-    libmesh_assert_equal_to(dstress_df.size(), 6);
-    libmesh_assert_equal_to(dstrain_df.size(), 6);
-    
-    _stress_sensitivity[f] = dstress_df;
-    _strain_sensitivity[f] = dstrain_df;
+    _output->set_sensitivity(_index, f, dstress_df, dstrain_df);
 }
 
 
 
-const RealVectorX&
+Eigen::Map<const RealVectorX>
 MAST::StressStrainOutputBase::Data::
 get_stress_sensitivity(const MAST::FunctionBase* f) const {
     
-    // make sure that the data exists
-    std::map<const MAST::FunctionBase*, RealVectorX>::const_iterator
-    it = _stress_sensitivity.find(f);
-    
-    libmesh_assert(it != _stress_sensitivity.end());
-    
-    
-    return it->second;
+    return _output->get_stress_sensitivity(_index, f);
 }
 
 
 
-const RealVectorX&
+Eigen::Map<const RealVectorX>
 MAST::StressStrainOutputBase::Data::
 get_strain_sensitivity(const MAST::FunctionBase* f) const {
     
-    // make sure that the data exists
-    std::map<const MAST::FunctionBase*, RealVectorX>::const_iterator
-    it = _strain_sensitivity.find(f);
-    
-    libmesh_assert(it != _strain_sensitivity.end());
-    
-    
-    return it->second;
+    return _output->get_strain_sensitivity(_index, f);
 }
 
 
@@ -152,16 +124,7 @@ get_strain_sensitivity(const MAST::FunctionBase* f) const {
 Real
 MAST::StressStrainOutputBase::Data::von_Mises_stress() const {
     
-    // make sure that the data is available
-    libmesh_assert_equal_to(_stress.size(), 6);
-    
-    return
-    pow(0.5 * (pow(_stress(0)-_stress(1),2) +    //(((sigma_xx - sigma_yy)^2    +
-               pow(_stress(1)-_stress(2),2) +    //  (sigma_yy - sigma_zz)^2    +
-               pow(_stress(2)-_stress(0),2)) +   //  (sigma_zz - sigma_xx)^2)/2 +
-        3.0 * (pow(_stress(3), 2) +              // 3* (tau_xx^2 +
-               pow(_stress(4), 2) +              //     tau_yy^2 +
-               pow(_stress(5), 2)), 0.5);        //     tau_zz^2))^.5
+    return _output->von_Mises_stress(_index);
 }
 
 
@@ -169,34 +132,7 @@ MAST::StressStrainOutputBase::Data::von_Mises_stress() const {
 RealVectorX
 MAST::StressStrainOutputBase::Data::dvon_Mises_stress_dX() const {
     
-    // make sure that the data is available
-    libmesh_assert_equal_to(_stress.size(), 6);
-    libmesh_assert_equal_to(_dstress_dX.rows(), 6);
-    
-    Real
-    p =
-    0.5 * (pow(_stress(0)-_stress(1),2) +    //((sigma_xx - sigma_yy)^2    +
-           pow(_stress(1)-_stress(2),2) +    // (sigma_yy - sigma_zz)^2    +
-           pow(_stress(2)-_stress(0),2)) +   // (sigma_zz - sigma_xx)^2)/2 +
-    3.0 * (pow(_stress(3), 2) +              // 3* (tau_xx^2 +
-           pow(_stress(4), 2) +              //     tau_yy^2 +
-           pow(_stress(5), 2));              //     tau_zz^2)
-
-    RealVectorX
-    dp = RealVectorX::Zero(_dstress_dX.cols());
-    
-    // if p == 0, then the sensitivity returns nan
-    // Hennce, we are avoiding this by setting it to zero whenever p = 0.
-    if (fabs(p) > 0.)
-        dp =
-        (((_dstress_dX.row(0) - _dstress_dX.row(1)) * (_stress(0) - _stress(1)) +
-          (_dstress_dX.row(1) - _dstress_dX.row(2)) * (_stress(1) - _stress(2)) +
-          (_dstress_dX.row(2) - _dstress_dX.row(0)) * (_stress(2) - _stress(0))) +
-         6.0 * (_dstress_dX.row(3) * _stress(3)+
-                _dstress_dX.row(4) * _stress(4)+
-                _dstress_dX.row(5) * _stress(5))) * 0.5 * pow(p, -0.5);
-    
-    return dp;
+    return _output->dvon_Mises_stress_dX(_index);
 }
 
 
@@ -206,41 +142,22 @@ Real
 MAST::StressStrainOutputBase::Data::
 dvon_Mises_stress_dp(const MAST::FunctionBase* f) const {
     
-    // make sure that the data is available
-    libmesh_assert_equal_to(_stress.size(), 6);
-    
-    // get the stress sensitivity data
-    const RealVectorX dstress_dp = this->get_stress_sensitivity(f);
-    
-    
-    Real
-    p =
-    0.5 * (pow(_stress(0)-_stress(1),2) +    //((sigma_xx - sigma_yy)^2    +
-           pow(_stress(1)-_stress(2),2) +    // (sigma_yy - sigma_zz)^2    +
-           pow(_stress(2)-_stress(0),2)) +   // (sigma_zz - sigma_xx)^2)/2 +
-    3.0 * (pow(_stress(3), 2) +              // 3* (tau_xx^2 +
-           pow(_stress(4), 2) +              //     tau_yy^2 +
-           pow(_stress(5), 2)),              //     tau_zz^2)
-    dp = 0.;
-    
-    // if p == 0, then the sensitivity returns nan
-    // Hennce, we are avoiding this by setting it to zero whenever p = 0.
-    if (fabs(p) > 0.)
-        dp =
-        (((dstress_dp(0) - dstress_dp(1)) * (_stress(0) - _stress(1)) +
-          (dstress_dp(1) - dstress_dp(2)) * (_stress(1) - _stress(2)) +
-          (dstress_dp(2) - dstress_dp(0)) * (_stress(2) - _stress(0))) +
-         6.0 * (dstress_dp(3) * _stress(3)+
-                dstress_dp(4) * _stress(4)+
-                dstress_dp(5) * _stress(5))) * 0.5 * pow(p, -0.5);
-    
-    return dp;
+    return _output->dvon_Mises_stress_dp(_index, f);
 }
 
 
 
 MAST::StressStrainOutputBase::StressStrainOutputBase():
 MAST::OutputFunctionBase(MAST::STRAIN_STRESS_TENSOR),
+_n_points(0),
+_nodal_average(nullptr),
+_functional(MAST::NO_STRESS_FUNCTIONAL),
+_functional_p(0.),
+_functional_n_points(0),
+_functional_ref(0.),
+_functional_sum(0.),
+_functional_JxW(0.),
+_functional_elem(nullptr),
 _vol_loads(nullptr) {
     
 }
@@ -259,28 +176,45 @@ MAST::StressStrainOutputBase::~StressStrainOutputBase() {
 void
 MAST::StressStrainOutputBase::clear(bool clear_elem_subset) {
     
-    std::map<const libMesh::Elem*, std::vector<MAST::StressStrainOutputBase::Data*> >::iterator
-    map_it  =  _stress_data.begin(),
-    map_end =  _stress_data.end();
-    
-    for ( ; map_it != map_end; map_it++) {
-        
-        // iterate over all the data and delete them
-        std::vector<MAST::StressStrainOutputBase::Data*>::iterator
-        it   =  map_it->second.begin(),
-        end  =  map_it->second.end();
-        
-        for ( ; it != end; it++)
-            delete *it;
-        
-        map_it->second.clear();
+    // the arrays retain their capacity, so that the data for the next
+    // evaluation can be stored without reallocation
+    _elem_data_range.clear();
+    _qp.clear();
+    _xyz.clear();
+    _JxW.clear();
+    _stress.clear();
+    _strain.clear();
+    _dX_offset.clear();
+    _dX_cols.clear();
+    _dstress_dX.clear();
+    _dstrain_dX.clear();
+    
+    std::map<const MAST::FunctionBase*, SensitivityBlock>::iterator
+    it  = _sensitivity.begin(),
+    end = _sensitivity.end();
+    
+    for ( ; it != end; it++) {
+        it->second.stress.clear();
+        it->second.strain.clear();
     }
     
-    _stress_data.clear();
+    _n_points            = 0;
+    _functional_n_points = 0;
+    _functional_ref      = 0.;
+    _functional_sum      = 0.;
+    _functional_JxW      = 0.;
+    _functional_elem     = nullptr;
+    _functional_sens.clear();
+    _functional_dX.clear();
+    _functional_elem_sens.clear();
     
     if (clear_elem_subset) {
+        _sensitivity.clear();
+        _sensitivity_functions.clear();
         _elem_subset.clear();
-        _vol_loads = nullptr;
+        _vol_loads     = nullptr;
+        _nodal_average = nullptr;
+        _elem_subset_modification_count++;
     }
     
 }
@@ -311,10 +245,11 @@ MAST::StressStrainOutputBase::
 set_elements_in_domain(const std::set<const libMesh::Elem*>& elems) {
     
     // make sure that the no data exists
-    libmesh_assert(_stress_data.size() == 0);
+    libmesh_assert(_elem_data_range.size() == 0);
     libmesh_assert(_elem_subset.size() == 0);
     
     _elem_subset = elems;
+    _elem_subset_modification_count++;
 }
 
 
@@ -328,7 +263,7 @@ MAST::StressStrainOutputBase::get_elem_subset() const {
 
 
 
-MAST::StressStrainOutputBase::Data&
+MAST::StressStrainOutputBase::Data
 MAST::StressStrainOutputBase::
 add_stress_strain_at_qp_location(const libMesh::Elem* e,
                                  const libMesh::Point& quadrature_pt,
@@ -342,36 +277,87 @@ add_stress_strain_at_qp_location(const libMesh::Elem* e,
     if (_elem_subset.size())
         libmesh_assert(_elem_subset.count(e));
     
+    // make sure that both the stress and strain are for a 3D configuration,
+    // which is the default for this data structure
+    libmesh_assert_equal_to(stress.size(), 6);
+    libmesh_assert_equal_to(strain.size(), 6);
+    
+    // with an aggregated functional or nodal averages only the most
+    // recent point is stored
+    if (!_if_store_all_points()) {
+        
+        _qp.clear();
+        _xyz.clear();
+        _JxW.clear();
+        _stress.clear();
+        _strain.clear();
+        _dX_offset.clear();
+        _dX_cols.clear();
+        _dstress_dX.clear();
+        _dstrain_dX.clear();
+        
+        std::map<const MAST::FunctionBase*, SensitivityBlock>::iterator
+        s_it  = _sensitivity.begin(),
+        s_end = _sensitivity.end();
+        
+        for ( ; s_it != s_end; s_it++) {
+            s_it->second.stress.clear();
+            s_it->second.strain.clear();
+        }
+    }
     
-    MAST::StressStrainOutputBase::Data* d =
-    new MAST::StressStrainOutputBase::Data (stress,
-                                            strain,
-                                            quadrature_pt,
-                                            physical_pt,
-                                            JxW);
-
+    const unsigned int
+    index = _if_store_all_points()? (unsigned int)_JxW.size() : _n_points;
     
     // check if the specified element exists in the map. If not, add it
-    std::map<const libMesh::Elem*, std::vector<MAST::StressStrainOutputBase::Data*> >::iterator
-    it = _stress_data.find(e);
+    std::map<const libMesh::Elem*, std::pair<unsigned int, unsigned int> >::iterator
+    it = _elem_data_range.find(e);
+    
+    if (it == _elem_data_range.end())
+        _elem_data_range.insert(std::make_pair(e, std::make_pair(index, 1u)));
+    else {
+        
+        // the points of an element are stored contiguously
+        libmesh_assert_equal_to(it->second.first + it->second.second, index);
+        it->second.second++;
+    }
+    
+    _qp.push_back(quadrature_pt);
+    _xyz.push_back(physical_pt);
+    _JxW.push_back(JxW);
+    _stress.insert(_stress.end(), stress.data(), stress.data()+6);
+    _strain.insert(_strain.end(), strain.data(), strain.data()+6);
+    _dX_offset.push_back((unsigned int)-1);
+    _dX_cols.push_back(0);
+    
+    if (_functional != MAST::NO_STRESS_FUNCTIONAL) {
+        
+        _functional_elem = e;
+        _add_to_functional(_von_Mises_stress(stress.data()), JxW);
+    }
     
-    // if the element does not exist in the map, add it to the map.
-    if (it == _stress_data.end())
-        it =
-        _stress_data.insert(std::pair<const libMesh::Elem*, std::vector<MAST::StressStrainOutputBase::Data*> >
-                            (e, std::vector<MAST::StressStrainOutputBase::Data*>())).first;
+    if (_nodal_average)
+        _nodal_average->add_point(*e,
+                                  strain,
+                                  stress,
+                                  _von_Mises_stress(stress.data()),
+                                  JxW);
     
-    it->second.push_back(d);
+    _n_points++;
     
-    return *d;
+    return MAST::StressStrainOutputBase::Data(*this, (unsigned int)_JxW.size()-1);
 }
 
 
 
-const std::map<const libMesh::Elem*, std::vector<MAST::StressStrainOutputBase::Data*> >&
-MAST::StressStrainOutputBase::get_stress_strain_data() const {
+const std::map<const libMesh::Elem*, std::pair<unsigned int, unsigned int> >&
+MAST::StressStrainOutputBase::get_stress_strain_data_range() const {
     
-    return _stress_data;
+    // the data is not stored for an aggregated functional or nodal
+    // averages
+    libmesh_assert(_if_store_all_points());
+    
+    return _elem_data_range;
 }
 
 
@@ -380,7 +366,7 @@ unsigned int
 MAST::StressStrainOutputBase::
 n_elem_in_storage() const {
     
-    return (unsigned int)_stress_data.size();
+    return (unsigned int)_elem_data_range.size();
 }
 
 
@@ -390,288 +376,1105 @@ n_stress_strain_data_for_elem(const libMesh::Elem* e) const {
     
     unsigned int n = 0;
     
-    std::map<const libMesh::Elem*, std::vector<MAST::StressStrainOutputBase::Data*> >::const_iterator
-    it = _stress_data.find(e);
+    std::map<const libMesh::Elem*, std::pair<unsigned int, unsigned int> >::const_iterator
+    it = _elem_data_range.find(e);
     
-    if ( it != _stress_data.end())
-        n = (unsigned int)it->second.size();
+    if ( it != _elem_data_range.end())
+        n = it->second.second;
     
     return n;
 }
 
 
 
-const std::vector<MAST::StressStrainOutputBase::Data*>&
+std::vector<MAST::StressStrainOutputBase::Data>
 MAST::StressStrainOutputBase::
-get_stress_strain_data_for_elem(const libMesh::Elem *e) const {
+get_stress_strain_data_for_elem(const libMesh::Elem *e) {
     
-    // check if the specified element exists in the map. If not, add it
-    std::map<const libMesh::Elem*, std::vector<MAST::StressStrainOutputBase::Data*> >::const_iterator
-    it = _stress_data.find(e);
+    std::map<const libMesh::Elem*, std::pair<unsigned int, unsigned int> >::const_iterator
+    it = _elem_data_range.find(e);
 
     // make sure that the specified elem exists in the map
-    libmesh_assert(it != _stress_data.end());
+    libmesh_assert(it != _elem_data_range.end());
     
-    return it->second;
+    // the data is not stored for an aggregated functional or nodal
+    // averages
+    libmesh_assert(_if_store_all_points());
+    
+    std::vector<MAST::StressStrainOutputBase::Data> rval;
+    rval.reserve(it->second.second);
+    
+    for (unsigned int i=0; i<it->second.second; i++)
+        rval.push_back(MAST::StressStrainOutputBase::Data(*this, it->second.first+i));
+    
+    return rval;
 }
 
 
 
-void
-MAST::StressStrainOutputBase::set_volume_loads(MAST::VolumeBCMapType& vol_loads) {
+Real
+MAST::StressStrainOutputBase::_von_Mises_stress(const Real* s) {
     
-    // make sure that no existing objects are related
-    libmesh_assert(!_vol_loads);
+    return
+    sqrt(0.5 * ((s[0]-s[1])*(s[0]-s[1]) +  //(((sigma_xx - sigma_yy)^2    +
+                (s[1]-s[2])*(s[1]-s[2]) +  //  (sigma_yy - sigma_zz)^2    +
+                (s[2]-s[0])*(s[2]-s[0])) + //  (sigma_zz - sigma_xx)^2)/2 +
+         3.0 * (s[3]*s[3] +                // 3* (tau_xx^2 +
+                s[4]*s[4] +                //     tau_yy^2 +
+                s[5]*s[5]));               //     tau_zz^2))^.5
+}
+
+
+
+const Eigen::Matrix<Real, 6, 6>&
+MAST::StressStrainOutputBase::_von_Mises_quadratic_form() {
     
-    _vol_loads  =  &vol_loads;
+    static const Eigen::Matrix<Real, 6, 6>
+    q = (Eigen::Matrix<Real, 6, 6>() <<
+         1.0, -0.5, -0.5, 0.0, 0.0, 0.0,
+        -0.5,  1.0, -0.5, 0.0, 0.0, 0.0,
+        -0.5, -0.5,  1.0, 0.0, 0.0, 0.0,
+         0.0,  0.0,  0.0, 3.0, 0.0, 0.0,
+         0.0,  0.0,  0.0, 0.0, 3.0, 0.0,
+         0.0,  0.0,  0.0, 0.0, 0.0, 3.0).finished();
     
+    return q;
 }
 
 
 
-MAST::BoundaryConditionBase*
-MAST::StressStrainOutputBase::get_thermal_load_for_elem(const libMesh::Elem& elem) {
+Real
+MAST::StressStrainOutputBase::
+_von_Mises_stress_gradient(const Real* s,
+                           Eigen::Matrix<Real, 6, 1>& dvm_ds) {
+    
+    Eigen::Map<const Eigen::Matrix<Real, 6, 1> > sv(s);
+    
+    // vm^2 = s^T Q s, so that d vm/ds = Q s / vm
+    dvm_ds.noalias() = _von_Mises_quadratic_form() * sv;
+    
+    const Real
+    vm = sqrt(sv.dot(dvm_ds));
+    
+    // if vm == 0, then the sensitivity returns nan
+    // Hennce, we are avoiding this by setting it to zero whenever vm = 0.
+    if (vm > 0.)
+        dvm_ds /= vm;
+    else
+        dvm_ds.setZero();
+    
+    return vm;
+}
 
-    MAST::BoundaryConditionBase *rval = nullptr;
+
+
+void
+MAST::StressStrainOutputBase::von_Mises_stress_batch(const Real* s,
+                                                     unsigned int n,
+                                                     RealVectorX& vm) {
     
-    if (_vol_loads) {
-        
-        std::pair<std::multimap<libMesh::subdomain_id_type, MAST::BoundaryConditionBase*>::const_iterator,
-        std::multimap<libMesh::subdomain_id_type, MAST::BoundaryConditionBase*>::const_iterator> it;
-        
-        it =  _vol_loads->equal_range(elem.subdomain_id());
+    vm.resize(n);
+    
+    if (!n)
+        return;
+    
+    Eigen::Map<const Eigen::Matrix<Real, 6, Eigen::Dynamic> > sm(s, 6, n);
+    
+    // vm^2 = s^T Q s for each column of sm
+    vm =
+    (sm.array() * (_von_Mises_quadratic_form() * sm).array())
+    .colwise().sum().sqrt().transpose();
+}
 
-        for ( ; it.first != it.second; it.first++)
-            if (it.first->second->type() == MAST::TEMPERATURE) {
-                
-                // make sure that only one thermal load exists for an element
-                libmesh_assert(!rval);
-                
-                rval = it.first->second;
-            }
-    }
+
+
+void
+MAST::StressStrainOutputBase::
+von_Mises_stress_gradient_batch(const Real* s,
+                                unsigned int n,
+                                RealVectorX& vm,
+                                RealMatrixX& dvm_ds) {
     
+    vm.resize(n);
+    dvm_ds.resize(6, n);
     
-    return rval;
+    if (!n)
+        return;
+    
+    Eigen::Map<const Eigen::Matrix<Real, 6, Eigen::Dynamic> > sm(s, 6, n);
+    
+    // vm^2 = s^T Q s, so that d vm/ds = Q s / vm
+    dvm_ds.noalias() = _von_Mises_quadratic_form() * sm;
+    vm = (sm.array() * dvm_ds.array()).colwise().sum().sqrt().transpose();
+    
+    // the derivative is zero for points with zero von Mises stress
+    const RealVectorX
+    vm_inv = (vm.array() > 0.).select(vm.array().inverse(), 0.).matrix();
+    
+    dvm_ds.array().rowwise() *= vm_inv.transpose().array();
+}
+
+
+
+Real
+MAST::StressStrainOutputBase::von_Mises_stress(unsigned int i) const {
+    
+    libmesh_assert_less(i, _JxW.size());
+    
+    return _von_Mises_stress(&_stress[6*i]);
 }
 
 
 
+RealVectorX
+MAST::StressStrainOutputBase::dvon_Mises_stress_dX(unsigned int i) const {
+    
+    libmesh_assert_less(i, _JxW.size());
+    
+    Eigen::Matrix<Real, 6, 1> dvm_ds;
+    _von_Mises_stress_gradient(&_stress[6*i], dvm_ds);
+    
+    return this->get_dstress_dX(i).transpose() * dvm_ds;
+}
+
+
 
 Real
 MAST::StressStrainOutputBase::
-von_Mises_p_norm_functional_for_all_elems(const Real p) const {
+dvon_Mises_stress_dp(unsigned int i,
+                     const MAST::FunctionBase* f) const {
     
-    Real
-    max_val  = 0.,
-    e_val    = 0.,
-    JxW_val  = 0.,
-    JxW      = 0.,
-    val      = 0.;
+    libmesh_assert_less(i, _JxW.size());
+    
+    Eigen::Matrix<Real, 6, 1> dvm_ds;
+    _von_Mises_stress_gradient(&_stress[6*i], dvm_ds);
+    
+    return dvm_ds.dot(this->get_stress_sensitivity(i, f));
+}
+
+
+
+void
+MAST::StressStrainOutputBase::set_derivatives(unsigned int i,
+                                              const RealMatrixX& dstress_dX,
+                                              const RealMatrixX& dstrain_dX) {
     
-    // first find the data with the maximum value, to be used for scaling
+    libmesh_assert_less(i, _JxW.size());
     
-    // iterate over all element data
-    std::map<const libMesh::Elem*, std::vector<MAST::StressStrainOutputBase::Data*> >::const_iterator
-    map_it   =  _stress_data.begin(),
-    map_end  =  _stress_data.end();
+    // make sure that the number of rows is 6.
+    libmesh_assert_equal_to(dstress_dX.rows(), 6);
+    libmesh_assert_equal_to(dstrain_dX.rows(), 6);
+    libmesh_assert_equal_to(dstress_dX.cols(), dstrain_dX.cols());
     
+    const unsigned int
+    n = (unsigned int)dstress_dX.size();
     
-    for ( ; map_it != map_end; map_it++) {
-        
-        std::vector<MAST::StressStrainOutputBase::Data*>::const_iterator
-        vec_it   = map_it->second.begin(),
-        vec_end  = map_it->second.end();
+    // the data is appended when it is first set for this point, which is
+    // usually right after the point is added
+    if (_dX_offset[i] == (unsigned int)-1) {
         
-        for ( ; vec_it != vec_end; vec_it++) {
-            
-            // ask this data point for the von Mises stress value
-            e_val    =   (*vec_it)->von_Mises_stress();
-            
-            (e_val > max_val) ?  max_val = e_val: 0; // to find the maximum value
-        }
+        _dX_offset[i] = (unsigned int)_dstress_dX.size();
+        _dX_cols[i]   = (unsigned int)dstress_dX.cols();
+        _dstress_dX.resize(_dstress_dX.size()+n);
+        _dstrain_dX.resize(_dstrain_dX.size()+n);
     }
     
-    // If the maximum value is very small, then set it to 1.0.
-    if (max_val <= 1.0e-6)  max_val = 1.;
+    libmesh_assert_equal_to(_dX_cols[i], dstress_dX.cols());
     
-    // now that we have the maximum value, we evaluate the p-norm
-    map_it   =  _stress_data.begin();
+    std::copy(dstress_dX.data(), dstress_dX.data()+n, &_dstress_dX[_dX_offset[i]]);
+    std::copy(dstrain_dX.data(), dstrain_dX.data()+n, &_dstrain_dX[_dX_offset[i]]);
     
-    for ( ; map_it != map_end; map_it++) {
+    if (_functional != MAST::NO_STRESS_FUNCTIONAL) {
         
-        std::vector<MAST::StressStrainOutputBase::Data*>::const_iterator
-        vec_it   = map_it->second.begin(),
-        vec_end  = map_it->second.end();
+        // accumulate the contribution of this point to the derivative
+        // of the functional for the element
+        const Real
+        w = _functional_point_weight(this->von_Mises_stress(i), _JxW[i]);
         
-        for ( ; vec_it != vec_end; vec_it++) {
-            
-            // ask this data point for the von Mises stress value
-            e_val    =   (*vec_it)->von_Mises_stress();
-            JxW      =   (*vec_it)->quadrature_point_JxW();
-            
-            // we do not use absolute value here, since von Mises stress
-            // is >= 0.
-            val     +=   pow(e_val/max_val, p) * JxW;
-            JxW_val +=   JxW;
-        }
+        std::pair<Real, RealVectorX>&
+        v = _functional_dX[_functional_elem];
+        
+        if (v.second.size() == 0)
+            v.second = RealVectorX::Zero(dstress_dX.cols());
+        else if (v.first != _functional_ref)
+            v.second *= _functional_rescale_factor(v.first, _functional_ref);
+        
+        v.first   = _functional_ref;
+        v.second += w * this->dvon_Mises_stress_dX(i);
     }
+}
+
+
+
+Eigen::Map<const RealMatrixX>
+MAST::StressStrainOutputBase::get_dstress_dX(unsigned int i) const {
     
-    val   = max_val * pow(val/JxW_val, 1./p);
+    libmesh_assert_less(i, _JxW.size());
     
-    return val;
+    // make sure that the data exists
+    libmesh_assert(_dX_offset[i] != (unsigned int)-1);
+    
+    return Eigen::Map<const RealMatrixX>(&_dstress_dX[_dX_offset[i]], 6, _dX_cols[i]);
 }
 
 
 
-Real
-MAST::StressStrainOutputBase::
-von_Mises_p_norm_functional_sensitivity_for_all_elems
-(const Real p,
- const MAST::FunctionBase* f) const {
+Eigen::Map<const RealMatrixX>
+MAST::StressStrainOutputBase::get_dstrain_dX(unsigned int i) const {
     
+    libmesh_assert_less(i, _JxW.size());
     
-    Real
-    max_val  = 0.,
-    de_val   = 0.,
-    e_val    = 0.,
-    JxW_val  = 0.,
-    JxW      = 0.,
-    val      = 0.,
-    dval     = 0.;
+    // make sure that the data exists
+    libmesh_assert(_dX_offset[i] != (unsigned int)-1);
     
-    // first find the data with the maximum value, to be used for scaling
+    return Eigen::Map<const RealMatrixX>(&_dstrain_dX[_dX_offset[i]], 6, _dX_cols[i]);
+}
+
+
+
+void
+MAST::StressStrainOutputBase::set_sensitivity(unsigned int i,
+                                              const MAST::FunctionBase* f,
+                                              const RealVectorX& dstress_df,
+                                              const RealVectorX& dstrain_df) {
     
-    // iterate over all element data
-    std::map<const libMesh::Elem*, std::vector<MAST::StressStrainOutputBase::Data*> >::const_iterator
-    map_it   =  _stress_data.begin(),
-    map_end  =  _stress_data.end();
+    libmesh_assert_less(i, _JxW.size());
     
+    // make sure that both the stress and strain are for a 3D configuration,
+    // which is the default for this data structure
+    libmesh_assert_equal_to(dstress_df.size(), 6);
+    libmesh_assert_equal_to(dstrain_df.size(), 6);
     
-    for ( ; map_it != map_end; map_it++) {
-        
-        std::vector<MAST::StressStrainOutputBase::Data*>::const_iterator
-        vec_it   = map_it->second.begin(),
-        vec_end  = map_it->second.end();
-        
-        for ( ; vec_it != vec_end; vec_it++) {
-            
-            // ask this data point for the von Mises stress value
-            e_val    =   (*vec_it)->von_Mises_stress();
-            
-            (e_val > max_val) ?  max_val = e_val: 0; // to find the maximum value
-        }
-    }
+    SensitivityBlock& b = _sensitivity[f];
     
+    // the block grows with the number of points. Points for which the
+    // sensitivity is not set have zero values.
+    if (b.stress.size() < 6*(i+1)) {
+        b.stress.resize(6*_JxW.size(), 0.);
+        b.strain.resize(6*_JxW.size(), 0.);
+    }
     
-    // If the maximum value is very small, then set it to 1.0.
-    if (max_val <= 1.0e-6)  max_val = 1.;
-
-    // now that we have the maximum value, we evaluate the p-norm
-    map_it   =  _stress_data.begin();
+    std::copy(dstress_df.data(), dstress_df.data()+6, &b.stress[6*i]);
+    std::copy(dstrain_df.data(), dstrain_df.data()+6, &b.strain[6*i]);
     
-
-    for ( ; map_it != map_end; map_it++) {
+    // accumulate the contribution of this point to the sensitivity
+    // of the functional
+    if (_functional != MAST::NO_STRESS_FUNCTIONAL) {
         
-        std::vector<MAST::StressStrainOutputBase::Data*>::const_iterator
-        vec_it   = map_it->second.begin(),
-        vec_end  = map_it->second.end();
+        const Real
+        ds = (_functional_point_weight(this->von_Mises_stress(i), _JxW[i]) *
+              this->dvon_Mises_stress_dp(i, f));
         
-        for ( ; vec_it != vec_end; vec_it++) {
-            
-            // ask this data point for the von Mises stress value
-            e_val    =   (*vec_it)->von_Mises_stress();
-            de_val   =   (*vec_it)->dvon_Mises_stress_dp(f);
-            JxW      =   (*vec_it)->quadrature_point_JxW();
-            
-            // we do not use absolute value here, since von Mises stress
-            // is >= 0.
-            val     +=   pow(e_val/max_val, p) * JxW;
-            dval    +=   p * pow(e_val/max_val, p-1.) * JxW * de_val/max_val;
-            JxW_val +=   JxW;
-        }
+        _functional_sens[f] += ds;
+        
+        // the contribution of the element is stored separately, and is
+        // rescaled when it is accessed
+        std::pair<Real, Real>&
+        v = _functional_elem_sens[f].insert
+        (std::make_pair(_functional_elem,
+                        std::make_pair(_functional_ref, 0.))).first->second;
+        
+        if (v.first != _functional_ref)
+            v.second *= _functional_rescale_factor(v.first, _functional_ref);
+        
+        v.first   = _functional_ref;
+        v.second += ds;
     }
-    
-    if (val > 0.)
-        val   = 1./p * max_val / pow(JxW_val, 1./p) * pow(val, 1./p-1.) * dval;
-
-    return val;
 }
 
 
 
+Eigen::Map<const RealVectorX>
+MAST::StressStrainOutputBase::
+get_stress_sensitivity(unsigned int i,
+                       const MAST::FunctionBase* f) const {
+    
+    // make sure that the data exists
+    std::map<const MAST::FunctionBase*, SensitivityBlock>::const_iterator
+    it = _sensitivity.find(f);
+    
+    libmesh_assert(it != _sensitivity.end());
+    libmesh_assert_less(6*i, it->second.stress.size());
+    
+    return Eigen::Map<const RealVectorX>(&it->second.stress[6*i], 6);
+}
+
+
 
-RealVectorX
+Eigen::Map<const RealVectorX>
 MAST::StressStrainOutputBase::
-von_Mises_p_norm_functional_state_derivartive_for_all_elems(const Real p) const {
+get_strain_sensitivity(unsigned int i,
+                       const MAST::FunctionBase* f) const {
     
+    // make sure that the data exists
+    std::map<const MAST::FunctionBase*, SensitivityBlock>::const_iterator
+    it = _sensitivity.find(f);
     
-    Real
-    max_val  = 0.,
-    e_val    = 0.,
-    JxW_val  = 0.,
-    JxW      = 0.,
-    val      = 0.;
+    libmesh_assert(it != _sensitivity.end());
+    libmesh_assert_less(6*i, it->second.strain.size());
+    
+    return Eigen::Map<const RealVectorX>(&it->second.strain[6*i], 6);
+}
+
+
+
+void
+MAST::StressStrainOutputBase::set_volume_loads(MAST::VolumeBCMapType& vol_loads) {
     
-    unsigned int
-    n_dofs   = 0;
+    // make sure that no existing objects are related
+    libmesh_assert(!_vol_loads);
     
+    _vol_loads  =  &vol_loads;
     
-    // first find the data with the maximum value, to be used for scaling
+}
+
+
+
+std::auto_ptr<MAST::OutputFunctionBase>
+MAST::StressStrainOutputBase::build_thread_local_copy() const {
     
-    // iterate over all element data
-    std::map<const libMesh::Elem*, std::vector<MAST::StressStrainOutputBase::Data*> >::const_iterator
-    map_it   =  _stress_data.begin(),
-    map_end  =  _stress_data.end();
+    MAST::StressStrainOutputBase* rval = new MAST::StressStrainOutputBase;
     
+    rval->_eval_mode             = _eval_mode;
+    rval->_eval_points           = _eval_points;
+    rval->_if_sensitivity_active = _if_sensitivity_active;
+    rval->_elem_subset           = _elem_subset;
+    rval->_sensitivity_functions = _sensitivity_functions;
+    rval->_vol_loads             = _vol_loads;
     
-    for ( ; map_it != map_end; map_it++) {
-        
-        std::vector<MAST::StressStrainOutputBase::Data*>::const_iterator
-        vec_it   = map_it->second.begin(),
-        vec_end  = map_it->second.end();
-        
-        for ( ; vec_it != vec_end; vec_it++) {
-            
-            // ask this data point for the von Mises stress value
-            e_val    =   (*vec_it)->von_Mises_stress();
-            (e_val > max_val) ?  max_val = e_val: 0; // to find the maximum value
-            (n_dofs==0)? n_dofs = (unsigned int)(*vec_it)->dvon_Mises_stress_dX().size(): 0;
-        }
-    }
+    return std::auto_ptr<MAST::OutputFunctionBase>(rval);
+}
+
+
+
+void
+MAST::StressStrainOutputBase::
+add_thread_local_data(const MAST::OutputFunctionBase& local,
+                      const libMesh::Elem& e) {
     
-    // If the maximum value is very small, then set it to 1.0.
-    if (max_val <= 1.0e-6)  max_val = 1.;
+    const MAST::StressStrainOutputBase&
+    o = dynamic_cast<const MAST::StressStrainOutputBase&>(local);
+    
+    libmesh_assert(o._if_store_all_points());
+    
+    std::map<const libMesh::Elem*, std::pair<unsigned int, unsigned int> >::const_iterator
+    it = o._elem_data_range.find(&e);
+    
+    if (it == o._elem_data_range.end())
+        return;
     
-    // now create the vector with the correct dimensions
     RealVectorX
-    de_val     = RealVectorX::Zero(n_dofs),
-    dval       = RealVectorX::Zero(n_dofs);
-
-    // now that we have the maximum value, we evaluate the p-norm
-    map_it   =  _stress_data.begin();
+    stress, strain;
     
+    RealMatrixX
+    dstress_dX,
+    dstrain_dX;
     
-    for ( ; map_it != map_end; map_it++) {
+    for (unsigned int i=it->second.first;
+         i<it->second.first+it->second.second; i++) {
+        
+        stress = o.stress(i);
+        strain = o.strain(i);
         
-        std::vector<MAST::StressStrainOutputBase::Data*>::const_iterator
-        vec_it   = map_it->second.begin(),
-        vec_end  = map_it->second.end();
+        MAST::StressStrainOutputBase::Data
+        d = this->add_stress_strain_at_qp_location(&e,
+                                                   o._qp[i],
+                                                   o._xyz[i],
+                                                   stress,
+                                                   strain,
+                                                   o._JxW[i]);
         
-        for ( ; vec_it != vec_end; vec_it++) {
+        if (o._dX_offset[i] != (unsigned int)-1) {
             
-            // ask this data point for the von Mises stress value
-            e_val    =   (*vec_it)->von_Mises_stress();
-            de_val   =   (*vec_it)->dvon_Mises_stress_dX();
-            JxW      =   (*vec_it)->quadrature_point_JxW();
+            dstress_dX = o.get_dstress_dX(i);
+            dstrain_dX = o.get_dstrain_dX(i);
+            d.set_derivatives(dstress_dX, dstrain_dX);
+        }
+        
+        std::map<const MAST::FunctionBase*, SensitivityBlock>::const_iterator
+        s_it  = o._sensitivity.begin(),
+        s_end = o._sensitivity.end();
+        
+        for ( ; s_it != s_end; s_it++)
+            if (s_it->second.stress.size() >= 6*(i+1)) {
+                
+                stress = o.get_stress_sensitivity(i, s_it->first);
+                strain = o.get_strain_sensitivity(i, s_it->first);
+                d.set_sensitivity(s_it->first, stress, strain);
+            }
+    }
+}
+
+
+
+MAST::BoundaryConditionBase*
+MAST::StressStrainOutputBase::get_thermal_load_for_elem(const libMesh::Elem& elem) {
+
+    MAST::BoundaryConditionBase *rval = nullptr;
+    
+    if (_vol_loads) {
+        
+        std::pair<std::multimap<libMesh::subdomain_id_type, MAST::BoundaryConditionBase*>::const_iterator,
+        std::multimap<libMesh::subdomain_id_type, MAST::BoundaryConditionBase*>::const_iterator> it;
+        
+        it =  _vol_loads->equal_range(elem.subdomain_id());
+
+        for ( ; it.first != it.second; it.first++)
+            if (it.first->second->type() == MAST::TEMPERATURE) {
+                
+                // make sure that only one thermal load exists for an element
+                libmesh_assert(!rval);
+                
+                rval = it.first->second;
+            }
+    }
+    
+    
+    return rval;
+}
+
+
+
+
+void
+MAST::StressStrainOutputBase::set_nodal_stress_average(MAST::NodalStressAverage* avg) {
+    
+    // make sure that the no data exists
+    libmesh_assert(_elem_data_range.size() == 0);
+    
+    _nodal_average = avg;
+}
+
+
+
+void
+MAST::StressStrainOutputBase::set_stress_functional(MAST::StressFunctionalType t,
+                                                    const Real p) {
+    
+    // make sure that the no data exists
+    libmesh_assert(_elem_data_range.size() == 0);
+    libmesh_assert(t == MAST::NO_STRESS_FUNCTIONAL || p > 0.);
+    
+    _functional   = t;
+    _functional_p = p;
+}
+
+
+
+Real
+MAST::StressStrainOutputBase::
+_functional_rescale_factor(const Real s_old,
+                           const Real s_new) const {
+    
+    switch (_functional) {
+            
+        case MAST::VON_MISES_P_NORM_FUNCTIONAL:
+            // the sums are zero if the reference stress was zero
+            return (s_old > 0.)? pow(s_old/s_new, _functional_p): 0.;
+            
+        case MAST::VON_MISES_KS_FUNCTIONAL:
+            return exp(_functional_p * (s_old-s_new));
+            
+        default:
+            libmesh_error();
+    }
+    
+    return 0.;
+}
+
+
+
+Real
+MAST::StressStrainOutputBase::
+_functional_point_weight(const Real vm,
+                         const Real JxW) const {
+    
+    const Real
+    p   = _functional_p,
+    ref = _functional_ref;
+    
+    switch (_functional) {
+            
+        case MAST::VON_MISES_P_NORM_FUNCTIONAL:
+            return (ref > 0.)? p * pow(vm/ref, p-1.) * JxW/ref: 0.;
+            
+        case MAST::VON_MISES_KS_FUNCTIONAL:
+            return p * JxW * exp(p * (vm-ref));
+            
+        default:
+            libmesh_error();
+    }
+    
+    return 0.;
+}
+
+
+
+void
+MAST::StressStrainOutputBase::_add_to_functional(const Real vm,
+                                                 const Real JxW) {
+    
+    // the reference stress is the maximum value seen so far. All sums are
+    // rescaled when it changes, so that the terms do not overflow.
+    if (_functional_n_points == 0)
+        _functional_ref = vm;
+    else if (vm > _functional_ref) {
+        
+        const Real
+        f = _functional_rescale_factor(_functional_ref, vm);
+        
+        _functional_sum *= f;
+        
+        std::map<const MAST::FunctionBase*, Real>::iterator
+        it  = _functional_sens.begin(),
+        end = _functional_sens.end();
+        
+        for ( ; it != end; it++)
+            it->second *= f;
+        
+        // the element derivatives are rescaled when they are accessed
+        _functional_ref = vm;
+    }
+    
+    switch (_functional) {
             
+        case MAST::VON_MISES_P_NORM_FUNCTIONAL:
             // we do not use absolute value here, since von Mises stress
             // is >= 0.
-            val     +=   pow(e_val/max_val, p) * JxW;
-            dval    +=   p * pow(e_val/max_val, p-1.) * JxW * de_val/max_val;
-            JxW_val +=   JxW;
+            if (_functional_ref > 0.)
+                _functional_sum += pow(vm/_functional_ref, _functional_p) * JxW;
+            break;
+            
+        case MAST::VON_MISES_KS_FUNCTIONAL:
+            _functional_sum += exp(_functional_p * (vm-_functional_ref)) * JxW;
+            break;
+            
+        default:
+            libmesh_error();
+    }
+    
+    _functional_JxW += JxW;
+    _functional_n_points++;
+}
+
+
+
+Real
+MAST::StressStrainOutputBase::_functional_derivative_factor() const {
+    
+    const Real
+    p   = _functional_p;
+    
+    switch (_functional) {
+            
+        case MAST::VON_MISES_P_NORM_FUNCTIONAL: {
+            
+            // If the maximum value is very small, then it is set to 1.0.
+            const Real
+            ref = (_functional_ref > 1.0e-6)? _functional_ref: 1.,
+            c   = _functional_rescale_factor(_functional_ref, ref),
+            val = _functional_sum * c;
+            
+            if (val > 0.)
+                return 1./p * ref / pow(_functional_JxW, 1./p) * pow(val, 1./p-1.) * c;
+            else
+                return 0.;
         }
+            
+        case MAST::VON_MISES_KS_FUNCTIONAL:
+            return (_functional_sum > 0.)? 1./(p * _functional_sum): 0.;
+            
+        default:
+            libmesh_error();
     }
     
-    return 1./p * max_val / pow(JxW_val, 1./p) * pow(val, 1./p-1.) * dval;
+    return 0.;
 }
+
+
+
+Real
+MAST::StressStrainOutputBase::aggregated_stress_functional() const {
+    
+    libmesh_assert(_functional != MAST::NO_STRESS_FUNCTIONAL);
+    
+    if (_functional_n_points == 0)
+        return 0.;
+    
+    const Real
+    p   = _functional_p;
+    
+    switch (_functional) {
+            
+        case MAST::VON_MISES_P_NORM_FUNCTIONAL: {
+            
+            // If the maximum value is very small, then it is set to 1.0.
+            const Real
+            ref = (_functional_ref > 1.0e-6)? _functional_ref: 1.,
+            val = _functional_sum * _functional_rescale_factor(_functional_ref, ref);
+            
+            return ref * pow(val/_functional_JxW, 1./p);
+        }
+            
+        case MAST::VON_MISES_KS_FUNCTIONAL:
+            return _functional_ref + log(_functional_sum/_functional_JxW)/p;
+            
+        default:
+            libmesh_error();
+    }
+    
+    return 0.;
+}
+
+
+
+Real
+MAST::StressStrainOutputBase::
+aggregated_stress_functional_sensitivity(const MAST::FunctionBase* f) const {
+    
+    libmesh_assert(_functional != MAST::NO_STRESS_FUNCTIONAL);
+    
+    std::map<const MAST::FunctionBase*, Real>::const_iterator
+    it = _functional_sens.find(f);
+    
+    if (it == _functional_sens.end())
+        return 0.;
+    
+    return _functional_derivative_factor() * it->second;
+}
+
+
+
+RealVectorX
+MAST::StressStrainOutputBase::
+aggregated_stress_functional_state_derivative_for_elem(const libMesh::Elem* e) const {
+    
+    libmesh_assert(_functional != MAST::NO_STRESS_FUNCTIONAL);
+    
+    std::map<const libMesh::Elem*, std::pair<Real, RealVectorX> >::const_iterator
+    it = _functional_dX.find(e);
+    
+    if (it == _functional_dX.end())
+        return RealVectorX();
+    
+    return
+    (_functional_derivative_factor() *
+     _functional_rescale_factor(it->second.first, _functional_ref)) *
+    it->second.second;
+}
+
+
+
+Real
+MAST::StressStrainOutputBase::
+aggregated_stress_functional_sensitivity_for_elem(const MAST::FunctionBase* f,
+                                                  const libMesh::Elem* e) const {
+    
+    libmesh_assert(_functional != MAST::NO_STRESS_FUNCTIONAL);
+    
+    std::map<const MAST::FunctionBase*,
+    std::map<const libMesh::Elem*, std::pair<Real, Real> > >::const_iterator
+    it = _functional_elem_sens.find(f);
+    
+    if (it == _functional_elem_sens.end())
+        return 0.;
+    
+    std::map<const libMesh::Elem*, std::pair<Real, Real> >::const_iterator
+    e_it = it->second.find(e);
+    
+    if (e_it == it->second.end())
+        return 0.;
+    
+    return
+    (_functional_derivative_factor() *
+     _functional_rescale_factor(e_it->second.first, _functional_ref)) *
+    e_it->second.second;
+}
+
+
+
+void
+MAST::StressStrainOutputBase::
+synchronize_aggregated_stress_functional(const libMesh::Parallel::Communicator& comm) {
+    
+    libmesh_assert(_functional != MAST::NO_STRESS_FUNCTIONAL);
+    
+    // processors without points do not contribute to the reference
+    // stress, and von Mises stress is >= 0.
+    Real
+    ref = _functional_n_points? _functional_ref: 0.;
+    comm.max(ref);
+    
+    if (_functional_n_points && ref != _functional_ref) {
+        
+        const Real
+        f = _functional_rescale_factor(_functional_ref, ref);
+        
+        _functional_sum *= f;
+        
+        std::map<const MAST::FunctionBase*, Real>::iterator
+        it  = _functional_sens.begin(),
+        end = _functional_sens.end();
+        
+        for ( ; it != end; it++)
+            it->second *= f;
+    }
+    
+    // the element derivatives are rescaled when they are accessed
+    _functional_ref = ref;
+    
+    comm.sum(_functional_sum);
+    comm.sum(_functional_JxW);
+    comm.sum(_functional_n_points);
+}
+
+
+
+Real
+MAST::StressStrainOutputBase::
+aggregated_stress_functional_sensitivity(const MAST::FunctionBase* f,
+                                         const libMesh::Parallel::Communicator& comm) const {
+    
+    Real
+    val = this->aggregated_stress_functional_sensitivity(f);
+    comm.sum(val);
+    
+    return val;
+}
+
+
+
+Real
+MAST::StressStrainOutputBase::
+von_Mises_p_norm_functional_for_all_elems(const Real p) const {
+    
+    const unsigned int
+    n_pts    = (unsigned int)_JxW.size();
+    
+    if (!n_pts)
+        return 0.;
+    
+    Eigen::Map<const RealVectorX>
+    JxW(&_JxW[0], n_pts);
+    
+    // von Mises stress at all points
+    RealVectorX
+    vm;
+    von_Mises_stress_batch(&_stress[0], n_pts, vm);
+    
+    // the maximum value is used for scaling
+    Real
+    max_val  = vm.maxCoeff();
+    
+    // If the maximum value is very small, then set it to 1.0.
+    if (max_val <= 1.0e-6)  max_val = 1.;
+    
+    // we do not use absolute value here, since von Mises stress
+    // is >= 0.
+    const Real
+    val      = ((vm.array()/max_val).pow(p) * JxW.array()).sum();
+    
+    return max_val * pow(val/JxW.sum(), 1./p);
+}
+
+
+
+Real
+MAST::StressStrainOutputBase::
+von_Mises_p_norm_functional_sensitivity_for_all_elems
+(const Real p,
+ const MAST::FunctionBase* f) const {
+    
+    const unsigned int
+    n_pts    = (unsigned int)_JxW.size();
+    
+    if (!n_pts)
+        return 0.;
+    
+    // make sure that the data exists
+    std::map<const MAST::FunctionBase*, SensitivityBlock>::const_iterator
+    it = _sensitivity.find(f);
+    libmesh_assert(it != _sensitivity.end());
+    
+    // points for which the sensitivity was not set have zero values.
+    const unsigned int
+    n_sens   = std::min(n_pts, (unsigned int)it->second.stress.size()/6);
+    
+    Eigen::Map<const RealVectorX>
+    JxW(&_JxW[0], n_pts);
+    
+    // von Mises stress at all points, and its derivative wrt the stress
+    RealVectorX
+    vm,
+    dvm      = RealVectorX::Zero(n_pts);
+    RealMatrixX
+    dvm_ds;
+    von_Mises_stress_gradient_batch(&_stress[0], n_pts, vm, dvm_ds);
+    
+    if (n_sens)
+        dvm.head(n_sens) =
+        (dvm_ds.leftCols(n_sens).array() *
+         Eigen::Map<const RealMatrixX>(&it->second.stress[0], 6, n_sens).array())
+        .colwise().sum().transpose();
+    
+    // the maximum value is used for scaling
+    Real
+    max_val  = vm.maxCoeff();
+    
+    // If the maximum value is very small, then set it to 1.0.
+    if (max_val <= 1.0e-6)  max_val = 1.;
+    
+    // we do not use absolute value here, since von Mises stress
+    // is >= 0.
+    const RealVectorX
+    scaled   = vm/max_val;
+    
+    Real
+    val      = (scaled.array().pow(p) * JxW.array()).sum(),
+    dval     = p * (scaled.array().pow(p-1.) * JxW.array() * dvm.array()).sum()/max_val;
+    
+    if (val > 0.)
+        val   = 1./p * max_val / pow(JxW.sum(), 1./p) * pow(val, 1./p-1.) * dval;
+
+    return val;
+}
+
+
+
+
+RealVectorX
+MAST::StressStrainOutputBase::
+von_Mises_p_norm_functional_state_derivartive_for_all_elems(const Real p) const {
+    
+    const unsigned int
+    n_pts    = (unsigned int)_JxW.size();
+    
+    if (!n_pts)
+        return RealVectorX();
+    
+    Eigen::Map<const RealVectorX>
+    JxW(&_JxW[0], n_pts);
+    
+    // von Mises stress at all points, and its derivative wrt the stress
+    RealVectorX
+    vm;
+    RealMatrixX
+    dvm_ds;
+    von_Mises_stress_gradient_batch(&_stress[0], n_pts, vm, dvm_ds);
+    
+    // the maximum value is used for scaling
+    Real
+    max_val  = vm.maxCoeff();
+    
+    // If the maximum value is very small, then set it to 1.0.
+    if (max_val <= 1.0e-6)  max_val = 1.;
+    
+    // we do not use absolute value here, since von Mises stress
+    // is >= 0.
+    const RealVectorX
+    scaled   = vm/max_val;
+    
+    const Real
+    val      = (scaled.array().pow(p) * JxW.array()).sum();
+    
+    // weight of the derivative of von Mises stress at each point
+    const RealVectorX
+    w        = (p/max_val * scaled.array().pow(p-1.) * JxW.array()).matrix();
+    
+    // now create the vector with the correct dimensions
+    RealVectorX
+    dval     = RealVectorX::Zero(_dX_cols[0]),
+    dvm_dsw;
+
+    for (unsigned int i=0; i<n_pts; i++) {
+        
+        dvm_dsw  = w(i) * dvm_ds.col(i);
+        dval    += this->get_dstress_dX(i).transpose() * dvm_dsw;
+    }
+    
+    return 1./p * max_val / pow(JxW.sum(), 1./p) * pow(val, 1./p-1.) * dval;
+}
+
+
+
+Real
+MAST::StressStrainOutputBase::
+von_Mises_p_norm_functional_for_all_elems
+(const Real p,
+ const libMesh::Parallel::Communicator& comm) const {
+    
+    const unsigned int
+    n_pts    = (unsigned int)_JxW.size();
+    
+    // von Mises stress at the points of this processor
+    RealVectorX
+    vm;
+    
+    Real
+    max_val  = 0.,
+    val      = 0.,
+    JxW_sum  = 0.;
+    
+    if (n_pts) {
+        
+        von_Mises_stress_batch(&_stress[0], n_pts, vm);
+        max_val = vm.maxCoeff();
+    }
+    
+    // the maximum value of all processors is used for scaling
+    comm.max(max_val);
+    
+    // If the maximum value is very small, then set it to 1.0.
+    if (max_val <= 1.0e-6)  max_val = 1.;
+    
+    if (n_pts) {
+        
+        Eigen::Map<const RealVectorX>
+        JxW(&_JxW[0], n_pts);
+        
+        val     = ((vm.array()/max_val).pow(p) * JxW.array()).sum();
+        JxW_sum = JxW.sum();
+    }
+    
+    comm.sum(val);
+    comm.sum(JxW_sum);
+    
+    if (JxW_sum <= 0.)
+        return 0.;
+    
+    return max_val * pow(val/JxW_sum, 1./p);
+}
+
+
+
+Real
+MAST::StressStrainOutputBase::
+von_Mises_p_norm_functional_sensitivity_for_all_elems
+(const Real p,
+ const MAST::FunctionBase* f,
+ const libMesh::Parallel::Communicator& comm) const {
+    
+    const unsigned int
+    n_pts    = (unsigned int)_JxW.size();
+    
+    // von Mises stress at the points of this processor, and its
+    // sensitivity
+    RealVectorX
+    vm,
+    dvm;
+    RealMatrixX
+    dvm_ds;
+    
+    Real
+    max_val  = 0.,
+    val      = 0.,
+    dval     = 0.,
+    JxW_sum  = 0.;
+    
+    if (n_pts) {
+        
+        // make sure that the data exists
+        std::map<const MAST::FunctionBase*, SensitivityBlock>::const_iterator
+        it = _sensitivity.find(f);
+        libmesh_assert(it != _sensitivity.end());
+        
+        // points for which the sensitivity was not set have zero values.
+        const unsigned int
+        n_sens   = std::min(n_pts, (unsigned int)it->second.stress.size()/6);
+        
+        von_Mises_stress_gradient_batch(&_stress[0], n_pts, vm, dvm_ds);
+        
+        dvm      = RealVectorX::Zero(n_pts);
+        if (n_sens)
+            dvm.head(n_sens) =
+            (dvm_ds.leftCols(n_sens).array() *
+             Eigen::Map<const RealMatrixX>(&it->second.stress[0], 6, n_sens).array())
+            .colwise().sum().transpose();
+        
+        max_val  = vm.maxCoeff();
+    }
+    
+    // the maximum value of all processors is used for scaling
+    comm.max(max_val);
+    
+    // If the maximum value is very small, then set it to 1.0.
+    if (max_val <= 1.0e-6)  max_val = 1.;
+    
+    if (n_pts) {
+        
+        Eigen::Map<const RealVectorX>
+        JxW(&_JxW[0], n_pts);
+        
+        const RealVectorX
+        scaled   = vm/max_val;
+        
+        val      = (scaled.array().pow(p) * JxW.array()).sum();
+        dval     = p * (scaled.array().pow(p-1.) * JxW.array() * dvm.array()).sum()/max_val;
+        JxW_sum  = JxW.sum();
+    }
+    
+    comm.sum(val);
+    comm.sum(dval);
+    comm.sum(JxW_sum);
+    
+    if (val <= 0. || JxW_sum <= 0.)
+        return 0.;
+    
+    return 1./p * max_val / pow(JxW_sum, 1./p) * pow(val, 1./p-1.) * dval;
+}
+
+
+
+void
+MAST::StressStrainOutputBase::report_memory(MAST::MemoryReport& r,
+                                            const std::string& nm) const {
+    
+    r.add(nm, "stress data",
+          _elem_data_range.size() *
+          (sizeof(const libMesh::Elem*) + 2*sizeof(unsigned int)) +
+          MAST::MemoryReport::bytes(_qp) +
+          MAST::MemoryReport::bytes(_xyz) +
+          MAST::MemoryReport::bytes(_JxW) +
+          MAST::MemoryReport::bytes(_stress) +
+          MAST::MemoryReport::bytes(_strain));
+    
+    r.add(nm, "stress derivative data",
+          MAST::MemoryReport::bytes(_dX_offset) +
+          MAST::MemoryReport::bytes(_dX_cols) +
+          MAST::MemoryReport::bytes(_dstress_dX) +
+          MAST::MemoryReport::bytes(_dstrain_dX));
+    
+    std::size_t v = 0;
+    
+    std::map<const MAST::FunctionBase*, SensitivityBlock>::const_iterator
+    it   = _sensitivity.begin(),
+    end  = _sensitivity.end();
+    
+    for ( ; it != end; it++)
+        v +=
+        MAST::MemoryReport::bytes(it->second.stress) +
+        MAST::MemoryReport::bytes(it->second.strain);
+    
+    r.add(nm, "stress sensitivity data", v);
+    
+    v = 0;
+    
+    std::map<const libMesh::Elem*, std::pair<Real, RealVectorX> >::const_iterator
+    f_it   = _functional_dX.begin(),
+    f_end  = _functional_dX.end();
+    
+    for ( ; f_it != f_end; f_it++)
+        v += MAST::MemoryReport::dense_bytes(f_it->second.second);
+    
+    std::map<const MAST::FunctionBase*,
+    std::map<const libMesh::Elem*, std::pair<Real, Real> > >::const_iterator
+    fs_it  = _functional_elem_sens.begin(),
+    fs_end = _functional_elem_sens.end();
+    
+    for ( ; fs_it != fs_end; fs_it++)
+        v += fs_it->second.size() *
+        (sizeof(const libMesh::Elem*) + 2*sizeof(Real));
+    
+    r.add(nm, "functional derivative data", v);
+}
+
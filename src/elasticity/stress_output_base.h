@@ -23,6 +23,7 @@
 // C++ includes
 #include <map>
 #include <vector>
+#include <set>
 
 // MAST includes
 #include "base/mast_data_types.h"
@@ -32,12 +33,24 @@
 
 // libMesh includes
 #include "libmesh/elem.h"
+#include "libmesh/parallel.h"
 
 namespace MAST {
 
 
     // Forward declerations
     class FunctionBase;
+    class MemoryReport;
+    class NodalStressAverage;
+    
+    
+    // identifies the aggregated stress functional that is accumulated
+    // while the stress data is added
+    enum StressFunctionalType {
+        NO_STRESS_FUNCTIONAL,
+        VON_MISES_P_NORM_FUNCTIONAL, // p-norm of the von Mises stress
+        VON_MISES_KS_FUNCTIONAL      // Kreisselmeier-Steinhauser function
+    };
     
 
     /*!
@@ -65,20 +78,28 @@ namespace MAST {
     
         
         /*!
-         *    This class provides a mechanism to store stress/strain values,
-         *    their derivatives and sensitivity values corresponding to a 
-         *    specific quadrature point on the element.
+         *    This class provides access to the stress/strain values,
+         *    their derivatives and sensitivity values corresponding to a
+         *    specific quadrature point on the element. The values are
+         *    stored in the contiguous arrays of the output object, and
+         *    this object only refers to the index of the point in them.
+         *    It stays valid until the output object is cleared.
          */
         class Data {
             
         public:
-            Data(const RealVectorX& stress,
-                 const RealVectorX& strain,
-                 const libMesh::Point& qp,
-                 const libMesh::Point& xyz,
-                 Real JxW);
+            Data(MAST::StressStrainOutputBase& output,
+                 unsigned int index);
  
             
+            /*!
+             *   @returns the index of this point in the output object
+             */
+            unsigned int index() const {
+                return _index;
+            }
+            
+            
             /*!
              *   @returns the point at which stress is evaluated, in the
              *   element coordinate system.
@@ -89,13 +110,13 @@ namespace MAST {
             /*!
              *   @returns stress
              */
-            const RealVectorX& stress() const;
+            Eigen::Map<const RealVectorX> stress() const;
 
             
             /*!
              *   @returns strain
              */
-            const RealVectorX& strain() const;
+            Eigen::Map<const RealVectorX> strain() const;
             
             
             /*!
@@ -131,13 +152,13 @@ namespace MAST {
             /*!
              *   @return the derivative data
              */
-            const RealMatrixX& get_dstress_dX() const;
+            Eigen::Map<const RealMatrixX> get_dstress_dX() const;
 
             
             /*!
              *   @return the derivative data
              */
-            const RealMatrixX& get_dstrain_dX() const;
+            Eigen::Map<const RealMatrixX> get_dstrain_dX() const;
 
             
             /*!
@@ -152,7 +173,7 @@ namespace MAST {
              *   @ returns the sensitivity of the data with respect to a 
              *   function
              */
-            const RealVectorX&
+            Eigen::Map<const RealVectorX>
             get_stress_sensitivity(const MAST::FunctionBase* f) const;
 
             
@@ -160,64 +181,21 @@ namespace MAST {
              *   @ returns the sensitivity of the data with respect to a
              *   function
              */
-            const RealVectorX&
+            Eigen::Map<const RealVectorX>
             get_strain_sensitivity(const MAST::FunctionBase* f) const;
 
             
         protected:
 
             /*!
-             *   stress data
+             *   output object that stores the data
              */
-            RealVectorX                   _stress;
-            
+            MAST::StressStrainOutputBase* _output;
             
             /*!
-             *  strain data
+             *   index of the point in the output object
              */
-            RealVectorX                   _strain;
-            
-            
-            /*!
-             *  map of sensitivity of the stress with respect to a parameter
-             */
-            std::map<const MAST::FunctionBase*, RealVectorX> _stress_sensitivity;
-
-            
-            /*!
-             *  map of sensitivity of the strain with respect to a parameter
-             */
-            std::map<const MAST::FunctionBase*, RealVectorX> _strain_sensitivity;
-
-            
-            /*!
-             *   derivative of stress wrt state vector
-             */
-            RealMatrixX   _dstress_dX;
-
-            /*!
-             *   derivative of strain data wrt state vector
-             */
-            RealMatrixX   _dstrain_dX;
-
-            
-            /*!
-             *   quadrature point location in element coordinates
-             */
-            libMesh::Point            _qp;
-            
-            
-            /*!
-             *   quadrature point location in physical coordinates
-             */
-            libMesh::Point            _xyz;
-            
-            
-            /*!
-             *   quadrature point JxW (product of transformation Jacobian and
-             *   quadrature weight) for use in definition of functionals
-             */
-            Real _JxW;
+            unsigned int _index;
         };
         
 
@@ -257,6 +235,42 @@ namespace MAST {
         void set_elements_in_domain(const std::set<const libMesh::Elem*>& elems);
 
         
+        /*!
+         *   @returns the subset of elements specified using
+         *   \p set_elements_in_domain, or \p nullptr if no subset was 
+         *   specified.
+         */
+        virtual const std::set<const libMesh::Elem*>*
+        get_elem_subset_for_evaluation() const {
+            
+            return _elem_subset.size()? &_elem_subset: nullptr;
+        }
+        
+        
+        /*!
+         *   sets the functions for which the elements evaluate the
+         *   sensitivity of the stress and strain data. For other
+         *   functions, only the values are evaluated in a sensitivity
+         *   evaluation. If this method is not called, the sensitivity is
+         *   evaluated for all functions.
+         */
+        void set_sensitivity_functions(const std::set<const MAST::FunctionBase*>& f) {
+            
+            _sensitivity_functions = f;
+        }
+        
+        
+        /*!
+         *   @returns \p true if the sensitivity of the data with respect
+         *   to \p f should be evaluated.
+         */
+        bool if_evaluate_sensitivity(const MAST::FunctionBase& f) const {
+            
+            return (_sensitivity_functions.empty() ||
+                    _sensitivity_functions.count(&f));
+        }
+        
+        
         /*!
          *   If the discipline includes loads such as thermal stresses and
          *   prestresses in the analysis, then those need to be included in 
@@ -264,6 +278,29 @@ namespace MAST {
          *   that the elements can use for stress calculations.
          */
         void set_volume_loads(MAST::VolumeBCMapType& vol_loads);
+        
+        
+        /*!
+         *   @returns a new object with the evaluation points, element
+         *   subset, sensitivity functions and volume loads of this object.
+         *   The new object stores the data of all points, even if this
+         *   object accumulates an aggregated functional, so that the data
+         *   can be added to this object with add_thread_local_data().
+         */
+        virtual std::auto_ptr<MAST::OutputFunctionBase>
+        build_thread_local_copy() const;
+        
+        
+        /*!
+         *   adds the points of element \p e stored in \p local, along with
+         *   their derivatives and sensitivities, in the order in which they
+         *   were added to \p local. For an aggregated functional, the
+         *   values accumulated from the elements are therefore identical
+         *   to those of a serial evaluation in the same order of elements.
+         */
+        virtual void
+        add_thread_local_data(const MAST::OutputFunctionBase& local,
+                              const libMesh::Elem& e);
 
         
         /*!
@@ -283,6 +320,16 @@ namespace MAST {
         n_elem_in_storage() const;
 
         
+        /*!
+         *   @returns the total number of points for which stress-strain data
+         *   is stored in this object.
+         */
+        unsigned int
+        n_stress_strain_data() const {
+            return (unsigned int)_JxW.size();
+        }
+        
+        
         /*!
          *    @returns the set of elements for which data will be stored. This 
          *    is set using the \par set_elements_in_domain method.
@@ -301,33 +348,276 @@ namespace MAST {
         
         
         /*!
-         *   add the stress tensor associated with the qp. @returns a reference
-         *   to \p Data.
+         *   add the stress tensor associated with the qp. All points of
+         *   an element must be added one after the other. @returns the
+         *   \p Data object for the point.
          */
-        MAST::StressStrainOutputBase::Data&
-        add_stress_strain_at_qp_location(const libMesh::Elem*,
+        MAST::StressStrainOutputBase::Data
+        add_stress_strain_at_qp_location(const libMesh::Elem* e,
                                          const libMesh::Point& quadrature_pt,
                                          const libMesh::Point& physical_pt,
-                                         const RealVectorX& strain,
                                          const RealVectorX& stress,
+                                         const RealVectorX& strain,
                                          Real JxW);
         
         
         /*!
-         *    @returns the map of stress/strain data for all elems
+         *    @returns the map of the index of the first point and the
+         *    number of points stored for each element.
          */
-        const std::map<const libMesh::Elem*,
-        std::vector<MAST::StressStrainOutputBase::Data*> >&
-        get_stress_strain_data() const;
+        const std::map<const libMesh::Elem*, std::pair<unsigned int, unsigned int> >&
+        get_stress_strain_data_range() const;
 
         
         /*!
          *    @returns the vector of stress/strain data for specified elem.
          */
-        const std::vector<MAST::StressStrainOutputBase::Data*>&
-        get_stress_strain_data_for_elem(const libMesh::Elem* e) const;
+        std::vector<MAST::StressStrainOutputBase::Data>
+        get_stress_strain_data_for_elem(const libMesh::Elem* e);
+        
+        
+        /*!
+         *   @returns the point at which stress is evaluated for point \p i,
+         *   in the element coordinate system.
+         */
+        const libMesh::Point&
+        point_location_in_element_coordinate(unsigned int i) const {
+            return _qp[i];
+        }
+        
+        
+        /*!
+         *   @returns the stress at point \p i
+         */
+        Eigen::Map<const RealVectorX> stress(unsigned int i) const {
+            return Eigen::Map<const RealVectorX>(&_stress[6*i], 6);
+        }
         
         
+        /*!
+         *   @returns the strain at point \p i
+         */
+        Eigen::Map<const RealVectorX> strain(unsigned int i) const {
+            return Eigen::Map<const RealVectorX>(&_strain[6*i], 6);
+        }
+        
+        
+        /*!
+         *   @returns the JxW of point \p i
+         */
+        Real quadrature_point_JxW(unsigned int i) const {
+            return _JxW[i];
+        }
+        
+        
+        /*!
+         *   @returns the von Mises stress at point \p i
+         */
+        Real von_Mises_stress(unsigned int i) const;
+        
+        
+        /*!
+         *   @returns the derivative of von Mises stress at point \p i wrt
+         *   state vector
+         */
+        RealVectorX dvon_Mises_stress_dX(unsigned int i) const;
+        
+        
+        /*!
+         *   @returns the derivative of von Mises stress at point \p i wrt
+         *   sensitivity parameter \p f
+         */
+        Real dvon_Mises_stress_dp(unsigned int i,
+                                  const MAST::FunctionBase* f) const;
+        
+        
+        /*!
+         *   computes in \p vm the von Mises stress of \p n points, for
+         *   which the six stress components are stored contiguously in
+         *   \p s. The points are processed together as a 6 x n matrix, so
+         *   that the evaluation reduces to vectorized Eigen kernels over
+         *   all points.
+         */
+        static void von_Mises_stress_batch(const Real* s,
+                                           unsigned int n,
+                                           RealVectorX& vm);
+        
+        
+        /*!
+         *   computes the von Mises stress \p vm of \p n points in \p s,
+         *   along with its derivative wrt the six stress components of
+         *   each point in the columns of the 6 x n matrix \p dvm_ds. The
+         *   derivative is set to zero for points with zero von Mises stress.
+         */
+        static void von_Mises_stress_gradient_batch(const Real* s,
+                                                    unsigned int n,
+                                                    RealVectorX& vm,
+                                                    RealMatrixX& dvm_ds);
+        
+        
+        /*!
+         *   sets the derivative of stress and strain at point \p i wrt
+         *   the state vector
+         */
+        void set_derivatives(unsigned int i,
+                             const RealMatrixX& dstress_dX,
+                             const RealMatrixX& dstrain_dX);
+        
+        
+        /*!
+         *   @returns the derivative of stress at point \p i wrt the state
+         *   vector
+         */
+        Eigen::Map<const RealMatrixX> get_dstress_dX(unsigned int i) const;
+        
+        
+        /*!
+         *   @returns the derivative of strain at point \p i wrt the state
+         *   vector
+         */
+        Eigen::Map<const RealMatrixX> get_dstrain_dX(unsigned int i) const;
+        
+        
+        /*!
+         *   sets the sensitivity of stress and strain at point \p i with
+         *   respect to the function \p f
+         */
+        void set_sensitivity(unsigned int i,
+                             const MAST::FunctionBase* f,
+                             const RealVectorX& dstress_df,
+                             const RealVectorX& dstrain_df);
+        
+        
+        /*!
+         *   @returns the sensitivity of stress at point \p i with respect
+         *   to the function \p f
+         */
+        Eigen::Map<const RealVectorX>
+        get_stress_sensitivity(unsigned int i,
+                               const MAST::FunctionBase* f) const;
+        
+        
+        /*!
+         *   @returns the sensitivity of strain at point \p i with respect
+         *   to the function \p f
+         */
+        Eigen::Map<const RealVectorX>
+        get_strain_sensitivity(unsigned int i,
+                               const MAST::FunctionBase* f) const;
+        
+        
+        /*!
+         *   tells the object to accumulate the aggregated von Mises stress 
+         *   functional \p t, with the p-norm or KS parameter \p p, as the
+         *   stress data is added, instead of storing the data for all 
+         *   points. Only the most recently added point is stored, so that
+         *   the elements can set its derivative and sensitivity, which 
+         *   are accumulated right away. The derivative of the functional 
+         *   wrt the state vector is stored for each element. This allows
+         *   evaluation of a single stress constraint for a large number of
+         *   points without storing the data at each point. The default is
+         *   \p NO_STRESS_FUNCTIONAL, in which case all data is stored.
+         */
+        void set_stress_functional(MAST::StressFunctionalType t,
+                                   const Real p);
+        
+        
+        /*!
+         *   tells the object to add the data of each point to the nodal
+         *   averages of \p avg as the point is added. Only the most recent
+         *   point is then stored, as with an aggregated functional, so that
+         *   the nodal stress field can be obtained without the memory of the
+         *   data at all points. A \p nullptr stores the data of all points
+         *   again, unless an aggregated functional is accumulated. This
+         *   object does not zero or close \p avg, see
+         *   MAST::NodalStressAverage.
+         */
+        void set_nodal_stress_average(MAST::NodalStressAverage* avg);
+        
+        
+        /*!
+         *   @returns the object to which the data of the points is added,
+         *   or \p nullptr if none is set
+         */
+        MAST::NodalStressAverage* nodal_stress_average() {
+            return _nodal_average;
+        }
+        
+        
+        /*!
+         *   @returns the aggregated functional that is accumulated
+         */
+        MAST::StressFunctionalType stress_functional() const {
+            return _functional;
+        }
+        
+        
+        /*!
+         *   @returns the aggregated von Mises stress functional accumulated
+         *   for all the points added since the last clear()
+         */
+        Real aggregated_stress_functional() const;
+        
+        
+        /*!
+         *   @returns the sensitivity of the aggregated von Mises stress 
+         *   functional wrt \p f, accumulated from the sensitivities set
+         *   for the points added since the last clear()
+         */
+        Real aggregated_stress_functional_sensitivity(const MAST::FunctionBase* f) const;
+        
+        
+        /*!
+         *   @returns the derivative of the aggregated von Mises stress 
+         *   functional wrt the state vector of element \p e, with the same
+         *   ordering as the columns of the stress derivative set for the
+         *   points of \p e. This is the contribution of the element to
+         *   the adjoint right hand side. An empty vector is returned if no
+         *   derivative was set for the element.
+         */
+        RealVectorX
+        aggregated_stress_functional_state_derivative_for_elem(const libMesh::Elem* e) const;
+        
+        
+        /*!
+         *   @returns the contribution of the points of element \p e to the
+         *   sensitivity of the aggregated von Mises stress functional wrt
+         *   \p f. For a design field with one value per element this is
+         *   the partial sensitivity wrt the value of \p e. Zero is returned
+         *   if no sensitivity was set for the points of \p e.
+         */
+        Real
+        aggregated_stress_functional_sensitivity_for_elem(const MAST::FunctionBase* f,
+                                                          const libMesh::Elem* e) const;
+        
+        
+        /*!
+         *   combines the aggregated functional accumulated on all
+         *   processors of \p comm for their local elements, so that
+         *   aggregated_stress_functional() and the element derivatives
+         *   return the functional of the global domain. The reference
+         *   stress is the maximum of all processors, and the local sums
+         *   are rescaled to it before they are added. This must be called
+         *   on all processors of \p comm after all points have been added,
+         *   and only once after clear(). The sensitivities returned by
+         *   aggregated_stress_functional_sensitivity() are then the local
+         *   contributions, which are summed by the overload of that method
+         *   with the communicator.
+         */
+        void
+        synchronize_aggregated_stress_functional(const libMesh::Parallel::Communicator& comm);
+        
+        
+        /*!
+         *   @returns the sensitivity of the aggregated functional wrt \p f
+         *   summed over all processors of \p comm. This must be called on
+         *   all processors after
+         *   synchronize_aggregated_stress_functional().
+         */
+        Real
+        aggregated_stress_functional_sensitivity(const MAST::FunctionBase* f,
+                                                 const libMesh::Parallel::Communicator& comm) const;
+        
         
         /*!
          *   calculates and returns the von Mises p-norm functional for 
@@ -357,15 +647,251 @@ namespace MAST {
         von_Mises_p_norm_functional_state_derivartive_for_all_elems(const Real p) const;
 
         
+        /*!
+         *   calculates and returns the von Mises p-norm functional for
+         *   the elements that this object stores data for on all 
+         *   processors of \p comm, for example when the outputs are 
+         *   evaluated for the local elements of a distributed mesh. This
+         *   must be called on all processors of \p comm.
+         */
+        Real
+        von_Mises_p_norm_functional_for_all_elems
+        (const Real p,
+         const libMesh::Parallel::Communicator& comm) const;
+        
+        
+        /*!
+         *   calculates and returns the sensitivity of the von Mises p-norm
+         *   functional for the elements that this object stores data for
+         *   on all processors of \p comm. This must be called on all 
+         *   processors of \p comm.
+         */
+        Real
+        von_Mises_p_norm_functional_sensitivity_for_all_elems
+        (const Real p,
+         const MAST::FunctionBase* f,
+         const libMesh::Parallel::Communicator& comm) const;
+
+        
+        /*!
+         *   adds the bytes of the stored stress and strain data, of their
+         *   derivatives and sensitivities, and of the functional
+         *   derivative data to \p r, with \p nm as the name of this object.
+         */
+        virtual void report_memory(MAST::MemoryReport& r,
+                                   const std::string& nm) const;
+        
         
     protected:
 
+        /*!
+         *   stress and strain sensitivity with respect to a function, with
+         *   six values per point
+         */
+        struct SensitivityBlock {
+            
+            std::vector<Real> stress;
+            
+            std::vector<Real> strain;
+        };
+        
+        
+        /*!
+         *   @returns the von Mises stress for the six components in \p s
+         */
+        static Real _von_Mises_stress(const Real* s);
+        
+        
+        /*!
+         *   @returns the von Mises stress for the six components in \p s,
+         *   and computes its derivative wrt these components in \p dvm_ds.
+         */
+        static Real _von_Mises_stress_gradient(const Real* s,
+                                               Eigen::Matrix<Real, 6, 1>& dvm_ds);
+        
+        
+        /*!
+         *   @returns the 6 x 6 matrix [Q] for which the square of von Mises
+         *   stress is {s}^T [Q] {s}.
+         */
+        static const Eigen::Matrix<Real, 6, 6>& _von_Mises_quadratic_form();
+        
         
         /*!
-         *    vector of stress with the associated location details
+         *   @returns the factor by which the accumulated sums of the 
+         *   aggregated functional are scaled when the reference stress is
+         *   changed from \p s_old to \p s_new.
          */
-        std::map<const libMesh::Elem*, std::vector<MAST::StressStrainOutputBase::Data*> >
-        _stress_data;
+        Real _functional_rescale_factor(const Real s_old,
+                                        const Real s_new) const;
+        
+        
+        /*!
+         *   @returns the factor by which the derivative of the von Mises
+         *   stress at a point with von Mises stress \p vm is multiplied
+         *   for its contribution to the accumulated sums.
+         */
+        Real _functional_point_weight(const Real vm,
+                                      const Real JxW) const;
+        
+        
+        /*!
+         *   @returns the factor by which the accumulated derivative sums
+         *   are multiplied to obtain the derivative of the functional.
+         */
+        Real _functional_derivative_factor() const;
+        
+        
+        /*!
+         *   @returns \p true if the data of all points is stored, which is
+         *   the case without an aggregated functional or nodal averages
+         */
+        bool _if_store_all_points() const {
+            return (_functional == MAST::NO_STRESS_FUNCTIONAL &&
+                    !_nodal_average);
+        }
+        
+        
+        /*!
+         *   adds the von Mises stress \p vm at a point with weight \p JxW
+         *   to the aggregated functional
+         */
+        void _add_to_functional(const Real vm,
+                                const Real JxW);
+        
+        
+        /*!
+         *    index of the first point and number of points stored for
+         *    each element
+         */
+        std::map<const libMesh::Elem*, std::pair<unsigned int, unsigned int> >
+        _elem_data_range;
+        
+        /*!
+         *    quadrature point location in element coordinates, for each
+         *    point
+         */
+        std::vector<libMesh::Point> _qp;
+        
+        /*!
+         *    quadrature point location in physical coordinates, for each
+         *    point
+         */
+        std::vector<libMesh::Point> _xyz;
+        
+        /*!
+         *    quadrature point JxW (product of transformation Jacobian and
+         *    quadrature weight) for each point, for use in definition of
+         *    functionals
+         */
+        std::vector<Real> _JxW;
+        
+        /*!
+         *    stress data, six components per point
+         */
+        std::vector<Real> _stress;
+        
+        /*!
+         *    strain data, six components per point
+         */
+        std::vector<Real> _strain;
+        
+        /*!
+         *    offset of the derivative data of each point in
+         *    \p _dstress_dX and \p _dstrain_dX, or \p -1 if the
+         *    derivative has not been set
+         */
+        std::vector<unsigned int> _dX_offset;
+        
+        /*!
+         *    number of columns of the derivative data of each point
+         */
+        std::vector<unsigned int> _dX_cols;
+        
+        /*!
+         *    derivative of stress wrt state vector, stored as 6 x n
+         *    column major matrices
+         */
+        std::vector<Real> _dstress_dX;
+        
+        /*!
+         *    derivative of strain wrt state vector, stored as 6 x n
+         *    column major matrices
+         */
+        std::vector<Real> _dstrain_dX;
+        
+        /*!
+         *    sensitivity of stress and strain for each function
+         */
+        std::map<const MAST::FunctionBase*, SensitivityBlock> _sensitivity;
+        
+        
+        /*!
+         *    number of points added since the last clear()
+         */
+        unsigned int _n_points;
+        
+        /*!
+         *    nodal averages to which the data of the points is added
+         */
+        MAST::NodalStressAverage* _nodal_average;
+        
+        /*!
+         *    aggregated functional accumulated while the data is added
+         */
+        MAST::StressFunctionalType _functional;
+        
+        /*!
+         *    p-norm or KS parameter of the aggregated functional
+         */
+        Real _functional_p;
+        
+        /*!
+         *    number of points added to the aggregated functional
+         */
+        unsigned int _functional_n_points;
+        
+        /*!
+         *    reference stress for the accumulated sums, which is the
+         *    maximum von Mises stress of the added points
+         */
+        Real _functional_ref;
+        
+        /*!
+         *    accumulated sum of the point values, scaled by the reference
+         *    stress
+         */
+        Real _functional_sum;
+        
+        /*!
+         *    accumulated JxW of the points
+         */
+        Real _functional_JxW;
+        
+        /*!
+         *    element for which the points are being added
+         */
+        const libMesh::Elem* _functional_elem;
+        
+        /*!
+         *    accumulated sensitivity sums for each function
+         */
+        std::map<const MAST::FunctionBase*, Real> _functional_sens;
+        
+        /*!
+         *    accumulated derivative sums wrt the state vector of each
+         *    element, along with the reference stress at which they were
+         *    accumulated
+         */
+        std::map<const libMesh::Elem*, std::pair<Real, RealVectorX> > _functional_dX;
+        
+        /*!
+         *    accumulated sensitivity sums of the points of each element for
+         *    each function, along with the reference stress at which they
+         *    were accumulated
+         */
+        std::map<const MAST::FunctionBase*,
+        std::map<const libMesh::Elem*, std::pair<Real, Real> > > _functional_elem_sens;
         
         
         /*!
@@ -374,6 +900,12 @@ namespace MAST {
          */
         std::set<const libMesh::Elem*> _elem_subset;
         
+        /*!
+         *    functions for which the sensitivity is evaluated. If this is
+         *    empty, then the sensitivity is evaluated for all functions.
+         */
+        std::set<const MAST::FunctionBase*> _sensitivity_functions;
+        
         /*!
          *    Volume loads used in the analysis
          */
@@ -0,0 +1,218 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2017  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+// C++ includes
+#include <map>
+#include <algorithm>
+#include <cmath>
+
+
+// MAST includes
+#include "elasticity/stress_recovery_error_indicator.h"
+#include "elasticity/stress_output_base.h"
+#include "base/performance_log.h"
+
+
+// libMesh includes
+#include "libmesh/mesh_base.h"
+#include "libmesh/elem.h"
+
+
+MAST::StressRecoveryErrorIndicator::
+StressRecoveryErrorIndicator(const libMesh::MeshBase& mesh,
+                             MAST::StressStrainOutputBase& output):
+MAST::ErrorIndicatorBase(),
+_mesh(mesh),
+_output(output) {
+    
+}
+
+
+
+MAST::StressRecoveryErrorIndicator::~StressRecoveryErrorIndicator() {
+    
+}
+
+
+
+void
+MAST::StressRecoveryErrorIndicator::estimate_error(libMesh::ErrorVector& err) {
+    
+    MAST_LOG_SCOPE("estimate_error()", "StressRecoveryErrorIndicator");
+    
+    const unsigned int
+    n_elem = (unsigned int)_mesh.max_elem_id();
+    
+    err.assign(n_elem, 0.);
+    
+    const std::map<const libMesh::Elem*, std::pair<unsigned int, unsigned int> >&
+    range = _output.get_stress_strain_data_range();
+    
+    std::map<const libMesh::Elem*, std::pair<unsigned int, unsigned int> >::const_iterator
+    r_it   = range.begin(),
+    r_end  = range.end();
+    
+    // the section location of a point is given by its coordinates
+    // beyond the dimension of the element. The locations of each
+    // element are numbered in increasing order.
+    std::map<const libMesh::Elem*, std::vector<unsigned int> >
+    point_loc;
+    
+    unsigned int
+    n_loc = 1;
+    
+    for ( ; r_it != r_end; r_it++) {
+        
+        const unsigned int
+        dim = r_it->first->dim();
+        
+        std::map<std::vector<Real>, unsigned int> locs;
+        std::vector<std::vector<Real> > keys(r_it->second.second);
+        
+        for (unsigned int i=0; i<r_it->second.second; i++) {
+            
+            const libMesh::Point&
+            p = _output.point_location_in_element_coordinate(r_it->second.first+i);
+            
+            for (unsigned int j=dim; j<3; j++)
+                keys[i].push_back(p(j));
+            locs[keys[i]] = 0;
+        }
+        
+        unsigned int
+        n = 0;
+        std::map<std::vector<Real>, unsigned int>::iterator
+        l_it   = locs.begin(),
+        l_end  = locs.end();
+        for ( ; l_it != l_end; l_it++)
+            l_it->second = n++;
+        
+        n_loc = std::max(n_loc, n);
+        
+        std::vector<unsigned int>& loc = point_loc[r_it->first];
+        loc.resize(keys.size());
+        for (unsigned int i=0; i<keys.size(); i++)
+            loc[i] = locs[keys[i]];
+    }
+    
+    _mesh.comm().max(n_loc);
+    
+    // stress averaged over the points of each location of the local
+    // elements, and the volume of the elements
+    std::vector<Real>
+    avg(6*n_loc*n_elem, 0.),
+    vol(n_elem, 0.),
+    w(n_loc, 0.);
+    
+    for (r_it = range.begin(); r_it != r_end; r_it++) {
+        
+        const libMesh::dof_id_type
+        id = r_it->first->id();
+        
+        const std::vector<unsigned int>& loc = point_loc[r_it->first];
+        
+        std::fill(w.begin(), w.end(), 0.);
+        
+        for (unsigned int i=0; i<r_it->second.second; i++) {
+            
+            const unsigned int
+            pt = r_it->second.first+i;
+            
+            const Real
+            JxW = _output.quadrature_point_JxW(pt);
+            
+            Eigen::Map<const RealVectorX> s = _output.stress(pt);
+            for (unsigned int c=0; c<6; c++)
+                avg[(id*n_loc+loc[i])*6+c] += JxW * s(c);
+            
+            w[loc[i]] += JxW;
+            vol[id]   += JxW;
+        }
+        
+        for (unsigned int l=0; l<n_loc; l++)
+            if (w[l] > 0.)
+                for (unsigned int c=0; c<6; c++)
+                    avg[(id*n_loc+l)*6+c] /= w[l];
+    }
+    
+    _mesh.comm().sum(avg);
+    _mesh.comm().sum(vol);
+    
+    // recovered stress at the vertices, from all active elements on this
+    // processor, which include the neighbors of the local elements
+    std::map<libMesh::dof_id_type, std::pair<Real, std::vector<Real> > >
+    recovered;
+    
+    libMesh::MeshBase::const_element_iterator
+    e_it   = _mesh.active_elements_begin(),
+    e_end  = _mesh.active_elements_end();
+    
+    for ( ; e_it != e_end; e_it++) {
+        
+        const libMesh::Elem* e = *e_it;
+        const libMesh::dof_id_type id = e->id();
+        
+        if (vol[id] <= 0.)
+            continue;
+        
+        for (unsigned int v=0; v<e->n_vertices(); v++) {
+            
+            std::pair<Real, std::vector<Real> >&
+            r = recovered[e->get_node(v)->id()];
+            
+            if (!r.second.size())
+                r.second.resize(6*n_loc, 0.);
+            
+            r.first += vol[id];
+            for (unsigned int i=0; i<6*n_loc; i++)
+                r.second[i] += vol[id] * avg[id*n_loc*6+i];
+        }
+    }
+    
+    // difference of the element stress and the recovered stress
+    e_it   = _mesh.active_local_elements_begin();
+    e_end  = _mesh.active_local_elements_end();
+    
+    for ( ; e_it != e_end; e_it++) {
+        
+        const libMesh::Elem* e = *e_it;
+        const libMesh::dof_id_type id = e->id();
+        
+        if (vol[id] <= 0.)
+            continue;
+        
+        Real
+        eta = 0.;
+        
+        for (unsigned int v=0; v<e->n_vertices(); v++) {
+            
+            const std::pair<Real, std::vector<Real> >&
+            r = recovered[e->get_node(v)->id()];
+            
+            for (unsigned int i=0; i<6*n_loc; i++)
+                eta += pow(r.second[i]/r.first - avg[id*n_loc*6+i], 2);
+        }
+        
+        err[id] = sqrt(vol[id] * eta / e->n_vertices() / n_loc);
+    }
+    
+    _mesh.comm().sum(static_cast<std::vector<libMesh::ErrorVectorReal>&>(err));
+}
+
@@ -0,0 +1,93 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2017  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+#ifndef __mast__stress_recovery_error_indicator__
+#define __mast__stress_recovery_error_indicator__
+
+
+// MAST includes
+#include "mesh/error_indicator_base.h"
+
+
+namespace libMesh {
+    
+    // Forward declerations
+    class MeshBase;
+}
+
+
+namespace MAST {
+    
+    // Forward declerations
+    class StressStrainOutputBase;
+    
+    
+    /*!
+     *   Error indicator for structural analysis based on the recovery of
+     *   a continuous stress field in the manner of Zienkiewicz and Zhu.
+     *   The stress of an element is averaged over its stress evaluation
+     *   points, and the recovered stress at a vertex is the volume
+     *   weighted mean of the averages of the elements that share the
+     *   vertex. The error of an element is
+     *   \f[ \eta_e^2 = \frac{V_e}{n_v} \sum_{n=1}^{n_v}
+     *       | \sigma^*_n - \bar{\sigma}_e |^2, \f]
+     *   which measures the stress jump between the element and its
+     *   neighbors. For beams and shells, the points of an element are
+     *   grouped by their location in the section, and the
+     *   recovery is done for each location, so that the bending stresses
+     *   are not averaged out through the thickness.
+     *
+     *   The stresses are taken from the output, which must have been
+     *   evaluated for the current solution. Elements without data in the
+     *   output have zero error. The averaged stresses of all elements are
+     *   replicated on all processors for the recovery.
+     */
+    class StressRecoveryErrorIndicator:
+    public MAST::ErrorIndicatorBase {
+        
+    public:
+        
+        StressRecoveryErrorIndicator(const libMesh::MeshBase& mesh,
+                                     MAST::StressStrainOutputBase& output);
+        
+        virtual ~StressRecoveryErrorIndicator();
+        
+        
+        /*!
+         *   computes the stress recovery error of the active elements
+         */
+        virtual void estimate_error(libMesh::ErrorVector& err);
+        
+    protected:
+        
+        /*!
+         *   mesh for which the error is computed
+         */
+        const libMesh::MeshBase&           _mesh;
+        
+        /*!
+         *   output with the stresses of the elements
+         */
+        MAST::StressStrainOutputBase&      _output;
+    };
+}
+
+
+#endif // __mast__stress_recovery_error_indicator__
@@ -17,6 +17,9 @@
  * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
  */
 
+// C++ includes
+#include <algorithm>
+
 
 // MAST includes
 #include "elasticity/structural_assembly.h"
@@ -25,6 +28,7 @@
 #include "base/system_initialization.h"
 #include "boundary_condition/point_load_condition.h"
 #include "base/nonlinear_system.h"
+#include "base/performance_log.h"
 
 
 // libMesh includes
@@ -88,7 +92,8 @@ MAST::_snes_structural_nonlinear_assembly_monitor_function(SNES snes,
 
 
 
-MAST::StructuralAssembly::StructuralAssembly() {
+MAST::StructuralAssembly::StructuralAssembly():
+_point_loads_initialized(false) {
     
 }
 
@@ -100,44 +105,172 @@ MAST::StructuralAssembly::~StructuralAssembly() {
 
 void
 MAST::StructuralAssembly::
-_assemble_point_loads(MAST::PhysicsDisciplineBase& discipline,
-                      MAST::SystemInitialization& system,
-                      libMesh::NumericVector<Real>& res) {
+_init_point_loads(MAST::PhysicsDisciplineBase& discipline,
+                  MAST::SystemInitialization& system) {
     
-    // get a reference to the system, mesh and dof map
+    this->_clear_point_loads();
+    
+    // get a reference to the system and dof map
     MAST::NonlinearSystem& sys     = system.system();
-    libMesh::DofMap& dof_map       = sys.get_dof_map();
+    const libMesh::DofMap& dof_map = sys.get_dof_map();
+    
+    const unsigned int
+    sys_num = sys.number(),
+    n_vars  = sys.n_vars();
+    
+    const libMesh::dof_id_type
+    first_dof = dof_map.first_dof(),
+    end_dof   = dof_map.end_dof();
     
     // get a reference to the set of loads
     const MAST::PointLoadSetType& point_loads = discipline.point_loads();
     
+    _point_load_data.reserve(point_loads.size());
+    
     // iterate over the loads and process them
     MAST::PointLoadSetType::const_iterator
     load_it   = point_loads.begin(),
     load_end  = point_loads.end();
     
     for ( ; load_it != load_end; load_it++) {
+        
         const MAST::PointLoadCondition& load = **load_it;
         const std::set<libMesh::Node*>& nodes = load.get_nodes();
         
+        // the forces are applied to the displacement and the moments to
+        // the rotation variables
+        const unsigned int
+        first_var = (load.type() == MAST::POINT_MOMENT)? 3 : 0;
+        
+        _point_load_data.push_back(PointLoadData());
+        PointLoadData& data = _point_load_data.back();
+        
+        data.func = &load.get<MAST::FieldFunction<RealVectorX> >("load");
+        data.offset.push_back((unsigned int)_point_load_dofs.size());
+        
         std::set<libMesh::Node*>::const_iterator
         n_it  = nodes.begin(),
         n_end = nodes.end();
         
         for ( ; n_it != n_end; n_it++) {
             
-            // iterate over the nodes and the variables on them
-            
-            // get the dof id for the var on node
+            const libMesh::Node& node = **n_it;
             
-            // if the dof is not constrained, then add the
+            // iterate over the variables on the node, and add the dofs
+            // that are local and not constrained
+            for (unsigned int i=0; i<3 && first_var+i<n_vars; i++) {
+                
+                if (!node.n_comp(sys_num, first_var+i))
+                    continue;
+                
+                const libMesh::dof_id_type
+                dof = node.dof_number(sys_num, first_var+i, 0);
+                
+                if (dof < first_dof ||
+                    dof >= end_dof  ||
+                    dof_map.is_constrained_dof(dof))
+                    continue;
+                
+                _point_load_dofs.push_back(dof);
+                _point_load_comp.push_back(i);
+            }
             
-            // load to the residual vector
+            // nodes without local dofs are not evaluated
+            if (_point_load_dofs.size() > data.offset.back()) {
+                
+                data.pts.push_back(node);
+                data.offset.push_back((unsigned int)_point_load_dofs.size());
+            }
         }
+    }
+    
+    _point_load_values.resize(_point_load_dofs.size());
+    _point_loads_initialized = true;
+}
+
+
+
+void
+MAST::StructuralAssembly::_clear_point_loads() {
+    
+    _point_load_data.clear();
+    _point_load_dofs.clear();
+    _point_load_comp.clear();
+    _point_load_values.clear();
+    _point_loads_initialized = false;
+}
+
+
+
+void
+MAST::StructuralAssembly::
+_assemble_point_loads(MAST::PhysicsDisciplineBase& discipline,
+                      MAST::SystemInitialization& system,
+                      libMesh::NumericVector<Real>& res) {
+    
+    MAST_LOG_SCOPE("assemble_point_loads()", "StructuralAssembly");
+    
+    if (!_point_loads_initialized)
+        _init_point_loads(discipline, system);
+    
+    const Real
+    t = system.system().time;
+    
+    std::vector<RealVectorX> vals;
+    
+    // the loads of all nodes of a condition are evaluated together
+    for (unsigned int i=0; i<_point_load_data.size(); i++) {
+        
+        const PointLoadData& data = _point_load_data[i];
+        
+        (*data.func)(data.pts, t, vals);
+        
+        for (unsigned int j=0; j<data.pts.size(); j++)
+            for (unsigned int k=data.offset[j]; k<data.offset[j+1]; k++)
+                _point_load_values[k] = -vals[j](_point_load_comp[k]);
+    }
+    
+    if (_point_load_dofs.size())
+        res.add_vector(_point_load_values, _point_load_dofs);
+}
+
+
+
+void
+MAST::StructuralAssembly::
+_assemble_point_load_sensitivity(MAST::PhysicsDisciplineBase& discipline,
+                                 MAST::SystemInitialization& system,
+                                 const MAST::FunctionBase& f,
+                                 libMesh::NumericVector<Real>& res) {
+    
+    MAST_LOG_SCOPE("assemble_point_load_sensitivity()", "StructuralAssembly");
+    
+    if (!_point_loads_initialized)
+        _init_point_loads(discipline, system);
+    
+    const Real
+    t = system.system().time;
+    
+    std::vector<RealVectorX> vals;
+    
+    std::fill(_point_load_values.begin(), _point_load_values.end(), 0.);
+    
+    for (unsigned int i=0; i<_point_load_data.size(); i++) {
+        
+        const PointLoadData& data = _point_load_data[i];
+        
+        if (!data.func->depends_on(f))
+            continue;
+        
+        data.func->derivative(f, data.pts, t, vals);
         
+        for (unsigned int j=0; j<data.pts.size(); j++)
+            for (unsigned int k=data.offset[j]; k<data.offset[j+1]; k++)
+                _point_load_values[k] = vals[j](_point_load_comp[k]);
     }
     
-    res.close();
+    if (_point_load_dofs.size())
+        res.add_vector(_point_load_values, _point_load_dofs);
 }
 
 
@@ -20,11 +20,17 @@
 #ifndef __mast__structural_assembly__
 #define __mast__structural_assembly__
 
+// C++ includes
+#include <vector>
+
 // MAST includes
 #include "base/mast_data_types.h"
+#include "base/field_function_base.h"
 
 // libMesh includes
 #include "libmesh/petsc_nonlinear_solver.h"
+#include "libmesh/point.h"
+#include "libmesh/id_types.h"
 
 
 
@@ -33,6 +39,7 @@ namespace MAST {
     // Forward declerations
     class PhysicsDisciplineBase;
     class SystemInitialization;
+    class FunctionBase;
 
     // monitor function for PETSc solver so that
     // the incompatible solution can be updated after each converged iterate
@@ -46,6 +53,16 @@ namespace MAST {
     /*!
      *   This class provides some routines that are common to
      *   structural assembly routines.
+     *
+     *   The point loads of the discipline are added directly to the
+     *   residual vector, without traversing the elements. The load of a
+     *   MAST::PointLoadCondition is the function \p "load" of type
+     *   MAST::FieldFunction<RealVectorX>, with one value for each of the
+     *   displacement variables (u, v, w) for MAST::POINT_LOAD, and for each
+     *   of the rotation variables (tx, ty, tz) for MAST::POINT_MOMENT. The
+     *   dof indices, node locations and load functions are collected once,
+     *   after which the loads are evaluated together for all nodes of a
+     *   condition and added to the vector in a single call.
      */
     class StructuralAssembly {
         
@@ -60,12 +77,81 @@ namespace MAST {
         
         
         /*!
-         *   assembles the point loas
+         *   collects the dof indices of the point loads of \p discipline
+         *   on \p system. Only the dofs that are owned by this processor
+         *   and are not constrained are used. This is called by
+         *   _assemble_point_loads() if needed, and must be called again
+         *   after _clear_point_loads() if the loads, the mesh or the dof
+         *   numbering change.
+         */
+        void _init_point_loads(MAST::PhysicsDisciplineBase& discipline,
+                               MAST::SystemInitialization& system);
+        
+        
+        /*!
+         *   clears the data of the point loads
+         */
+        void _clear_point_loads();
+        
+        
+        /*!
+         *   adds the point loads of \p discipline at the time of the
+         *   system to the residual \p res. Since the residual is the
+         *   internal force minus the external force, the loads are
+         *   subtracted. Only owned entries are added, and \p res is not
+         *   closed.
          */
         void _assemble_point_loads(MAST::PhysicsDisciplineBase& discipline,
                                    MAST::SystemInitialization& system,
                                    libMesh::NumericVector<Real>& res);
         
+        
+        /*!
+         *   adds the sensitivity of the point loads with respect to \p f
+         *   to the RHS of the sensitivity equations \p res, which is -1
+         *   times the sensitivity of the residual. Only the loads that
+         *   depend on \p f are evaluated, and \p res is not closed.
+         */
+        void
+        _assemble_point_load_sensitivity(MAST::PhysicsDisciplineBase& discipline,
+                                         MAST::SystemInitialization& system,
+                                         const MAST::FunctionBase& f,
+                                         libMesh::NumericVector<Real>& res);
+        
+        
+        /*!
+         *   nodes and load function of a point load condition. The dofs
+         *   of node \p i are in [offset[i], offset[i+1]) of
+         *   \p _point_load_dofs.
+         */
+        struct PointLoadData {
+            
+            const MAST::FieldFunction<RealVectorX>*  func;
+            std::vector<libMesh::Point>              pts;
+            std::vector<unsigned int>                offset;
+        };
+        
+        
+        /*!
+         *   flag to indicate if the point load data has been initialized
+         */
+        bool                                         _point_loads_initialized;
+        
+        /*!
+         *   data of each point load condition
+         */
+        std::vector<PointLoadData>                   _point_load_data;
+        
+        /*!
+         *   dof indices of the point loads, the component of the load
+         *   value added to each dof, and the values added to the vector
+         */
+        std::vector<libMesh::dof_id_type>            _point_load_dofs;
+        
+        std::vector<unsigned int>                    _point_load_comp;
+        
+        std::vector<Real>                            _point_load_values;
+        
     };
 }
 
@@ -30,6 +30,7 @@
 // libMesh includes
 #include "libmesh/numeric_vector.h"
 #include "libmesh/sparse_matrix.h"
+#include "libmesh/petsc_matrix.h"
 #include "libmesh/dof_map.h"
 #include "libmesh/parameter_vector.h"
 
@@ -42,7 +43,14 @@ _load_param(nullptr),
 _lambda1(0.),
 _lambda2(0.),
 _sol1(nullptr),
-_sol2(nullptr) {
+_sol2(nullptr),
+_matrix_cache(false),
+_K1(nullptr),
+_mK2(nullptr),
+_cache_load_param(nullptr),
+_cache_lambda1(0.),
+_cache_lambda2(0.),
+_cache_version(0) {
     
 }
 
@@ -50,8 +58,10 @@ _sol2(nullptr) {
 
 
 MAST::StructuralBucklingEigenproblemAssembly::
-~StructuralBucklingEigenproblemAssembly()
-{ }
+~StructuralBucklingEigenproblemAssembly() {
+    
+    this->clear_matrix_cache();
+}
 
 
 
@@ -84,11 +94,130 @@ MAST::StructuralBucklingEigenproblemAssembly::clear_discipline_and_system() {
     _sol1                       = nullptr;
     _sol2                       = nullptr;
     
+    this->clear_matrix_cache();
+    
     MAST::EigenproblemAssembly::clear_discipline_and_system();
 }
 
 
 
+void
+MAST::StructuralBucklingEigenproblemAssembly::set_matrix_cache(bool f) {
+    
+    _matrix_cache = f;
+    this->clear_matrix_cache();
+}
+
+
+
+void
+MAST::StructuralBucklingEigenproblemAssembly::clear_matrix_cache() {
+    
+    PetscErrorCode ierr;
+    
+    if (_K1) {
+        ierr = MatDestroy(&_K1);  CHKERRABORT(PETSC_COMM_WORLD, ierr);
+    }
+    if (_mK2) {
+        ierr = MatDestroy(&_mK2); CHKERRABORT(PETSC_COMM_WORLD, ierr);
+    }
+    
+    _K1               = nullptr;
+    _mK2              = nullptr;
+    _cache_load_param = nullptr;
+    _cache_sol1.reset();
+    _cache_sol2.reset();
+}
+
+
+
+void
+MAST::StructuralBucklingEigenproblemAssembly::clear_mesh_dependent_data() {
+    
+    MAST::EigenproblemAssembly::clear_mesh_dependent_data();
+    
+    this->clear_matrix_cache();
+    _incompatible_sol.clear();
+}
+
+
+
+unsigned long long
+MAST::StructuralBucklingEigenproblemAssembly::_parameter_version() const {
+    
+    unsigned long long v = 0;
+    
+    std::map<const Real*, const MAST::FunctionBase*>::const_iterator
+    it  = _discipline->get_parameter_map().begin(),
+    end = _discipline->get_parameter_map().end();
+    
+    for ( ; it != end; it++)
+        if (it->second != _load_param)
+            v += it->second->version();
+    
+    return v;
+}
+
+
+
+bool
+MAST::StructuralBucklingEigenproblemAssembly::_if_matrix_cache_valid() const {
+    
+    if (!_K1                               ||
+        _cache_load_param != _load_param   ||
+        _cache_lambda1    != _lambda1      ||
+        _cache_lambda2    != _lambda2      ||
+        _cache_version    != _parameter_version())
+        return false;
+    
+    // the solutions are compared on all processors
+    std::auto_ptr<libMesh::NumericVector<Real> >
+    d(_sol1->clone().release());
+    
+    d->add(-1., *_cache_sol1);
+    if (d->linfty_norm() != 0.)
+        return false;
+    
+    *d = *_sol2;
+    d->add(-1., *_cache_sol2);
+    
+    return d->linfty_norm() == 0.;
+}
+
+
+
+void
+MAST::StructuralBucklingEigenproblemAssembly::
+_store_matrices(libMesh::SparseMatrix<Real>& A,
+                libMesh::SparseMatrix<Real>& B) {
+    
+    this->clear_matrix_cache();
+    
+    PetscErrorCode ierr;
+    
+    Mat
+    a = dynamic_cast<libMesh::PetscMatrix<Real>&>(A).mat(),
+    b = dynamic_cast<libMesh::PetscMatrix<Real>&>(B).mat();
+    
+    ierr = MatDuplicate(a, MAT_COPY_VALUES, &_K1);  CHKERRABORT(A.comm().get(), ierr);
+    ierr = MatDuplicate(b, MAT_COPY_VALUES, &_mK2); CHKERRABORT(A.comm().get(), ierr);
+    
+    // B = -K2 + K1 for the linearized formulation
+    if (_use_linearized_formulation) {
+        ierr = MatAXPY(_mK2, -1., _K1, DIFFERENT_NONZERO_PATTERN);
+        CHKERRABORT(A.comm().get(), ierr);
+    }
+    
+    _cache_load_param = _load_param;
+    _cache_lambda1    = _lambda1;
+    _cache_lambda2    = _lambda2;
+    _cache_version    = _parameter_version();
+    _cache_sol1.reset(_sol1->clone().release());
+    _cache_sol2.reset(_sol2->clone().release());
+}
+
+
+
 void
 MAST::StructuralBucklingEigenproblemAssembly::
 eigenproblem_assemble(libMesh::SparseMatrix<Real> *A,
@@ -96,6 +225,30 @@ eigenproblem_assemble(libMesh::SparseMatrix<Real> *A,
     
     MAST::NonlinearSystem& eigen_sys =
     dynamic_cast<MAST::NonlinearSystem&>(_system->system());
+    
+    // form the matrices from the stored stiffness matrices, if available
+    if (_matrix_cache && _if_matrix_cache_valid()) {
+        
+        PetscErrorCode ierr;
+        
+        Mat
+        a = dynamic_cast<libMesh::PetscMatrix<Real>*>(A)->mat(),
+        b = dynamic_cast<libMesh::PetscMatrix<Real>*>(B)->mat();
+        
+        ierr = MatCopy(_K1,  a, SAME_NONZERO_PATTERN); CHKERRABORT(A->comm().get(), ierr);
+        ierr = MatCopy(_mK2, b, SAME_NONZERO_PATTERN); CHKERRABORT(A->comm().get(), ierr);
+        
+        if (_use_linearized_formulation) {
+            ierr = MatAXPY(b, 1., _K1, SAME_NONZERO_PATTERN);
+            CHKERRABORT(A->comm().get(), ierr);
+        }
+        
+        // the load parameter is left at the second load factor, as
+        // by the assembly
+        (*_load_param) = _lambda2;
+        
+        return;
+    }
 
     // create the localized solution vectors
     std::auto_ptr<libMesh::NumericVector<Real> >
@@ -120,7 +273,10 @@ eigenproblem_assemble(libMesh::SparseMatrix<Real> *A,
     RealMatrixX mat_A, mat_B;
     std::vector<libMesh::dof_id_type> dof_indices;
     const libMesh::DofMap& dof_map = eigen_sys.get_dof_map();
-    std::auto_ptr<MAST::ElementBase> physics_elem;
+    const MAST::ElementTopologyCache& topology = eigen_sys.topology_cache();
+    std::auto_ptr<MAST::ElementBase> elem_storage;
+    MAST::ElementBase* physics_elem = nullptr;
+    DenseRealMatrix AA, BB;
     
     libMesh::MeshBase::const_element_iterator       el     =
     eigen_sys.get_mesh().active_local_elements_begin();
@@ -131,9 +287,9 @@ eigenproblem_assemble(libMesh::SparseMatrix<Real> *A,
         
         const libMesh::Elem* elem = *el;
         
-        dof_map.dof_indices (elem, dof_indices);
+        topology.dof_indices (elem, dof_indices);
         
-        physics_elem.reset(_build_elem(*elem).release());
+        physics_elem = &_get_elem(*elem, elem_storage);
         
         // get the solution
         unsigned int ndofs = (unsigned int)dof_indices.size();
@@ -147,8 +303,7 @@ eigenproblem_assemble(libMesh::SparseMatrix<Real> *A,
         // first load factor and solution
         ////////////////////////////////////////////////////////////////
         (*_load_param) = _lambda1;
-        for (unsigned int i=0; i<dof_indices.size(); i++)
-            sol(i) = (*localized_solution1)(dof_indices[i]);
+        _get_elem_values(*localized_solution1, dof_indices, sol);
     
         physics_elem->set_solution(sol);
         
@@ -165,12 +320,11 @@ eigenproblem_assemble(libMesh::SparseMatrix<Real> *A,
             p_elem.set_incompatible_mode_solution(_incompatible_sol[elem]);
         }
 
-        DenseRealMatrix AA, BB;
         _elem_calculations(*physics_elem, mat_A);
         
         MAST::copy(AA, mat_A); // copy to the libMesh matrix for further processing
         dof_map.constrain_element_matrix(AA, dof_indices); // constrain the element matrices.
-        matrix_A.add_matrix (AA, dof_indices); // add to the global matrices
+        _add_elem_matrix(matrix_A, AA, dof_indices, elem); // add to the global matrices
         
         
         
@@ -180,8 +334,7 @@ eigenproblem_assemble(libMesh::SparseMatrix<Real> *A,
         // second load factor and solution
         ////////////////////////////////////////////////////////////////
         (*_load_param) = _lambda2;
-        for (unsigned int i=0; i<dof_indices.size(); i++)
-            sol(i) = (*localized_solution2)(dof_indices[i]);
+        _get_elem_values(*localized_solution2, dof_indices, sol);
         
         physics_elem->set_solution(sol);
         
@@ -204,12 +357,15 @@ eigenproblem_assemble(libMesh::SparseMatrix<Real> *A,
         
         MAST::copy(BB, mat_B); // copy to the libMesh matrix for further processing
         dof_map.constrain_element_matrix(BB, dof_indices); // constrain the element matrices.
-        matrix_B.add_matrix (BB, dof_indices); // add to the global matrices
+        _add_elem_matrix(matrix_B, BB, dof_indices, elem); // add to the global matrices
     }
     
     // finalize the matrices for futher use.
     A->close();
     B->close();
+    
+    if (_matrix_cache)
+        _store_matrices(*A, *B);
 }
 
 
@@ -253,7 +409,10 @@ eigenproblem_sensitivity_assemble (const libMesh::ParameterVector& parameters,
     RealMatrixX mat_A, mat_B;
     std::vector<libMesh::dof_id_type> dof_indices;
     const libMesh::DofMap& dof_map = eigen_sys.get_dof_map();
-    std::auto_ptr<MAST::ElementBase> physics_elem;
+    const MAST::ElementTopologyCache& topology = eigen_sys.topology_cache();
+    std::auto_ptr<MAST::ElementBase> elem_storage;
+    MAST::ElementBase* physics_elem = nullptr;
+    DenseRealMatrix A, B;
     
     libMesh::MeshBase::const_element_iterator       el     =
     eigen_sys.get_mesh().active_local_elements_begin();
@@ -264,9 +423,9 @@ eigenproblem_sensitivity_assemble (const libMesh::ParameterVector& parameters,
         
         const libMesh::Elem* elem = *el;
         
-        dof_map.dof_indices (elem, dof_indices);
+        topology.dof_indices (elem, dof_indices);
         
-        physics_elem.reset(_build_elem(*elem).release());
+        physics_elem = &_get_elem(*elem, elem_storage);
         
         // get the solution
         unsigned int ndofs = (unsigned int)dof_indices.size();
@@ -277,8 +436,7 @@ eigenproblem_sensitivity_assemble (const libMesh::ParameterVector& parameters,
         
         // if the base solution is provided, then tell the element about it
         if (_base_sol) {
-            for (unsigned int i=0; i<dof_indices.size(); i++)
-                sol(i) = (*localized_solution)(dof_indices[i]);
+            _get_elem_values(*localized_solution, dof_indices, sol);
         }
         
         physics_elem->sensitivity_param = _discipline->get_parameter(&(parameters[i].get()));
@@ -299,7 +457,6 @@ eigenproblem_sensitivity_assemble (const libMesh::ParameterVector& parameters,
         _elem_sensitivity_calculations(*physics_elem, mat_A, mat_B);
         
         // copy to the libMesh matrix for further processing
-        DenseRealMatrix A, B;
         MAST::copy(A, mat_A);
         MAST::copy(B, mat_B);
         
@@ -308,8 +465,8 @@ eigenproblem_sensitivity_assemble (const libMesh::ParameterVector& parameters,
         dof_map.constrain_element_matrix(B, dof_indices);
         
         // add to the global matrices
-        matrix_A.add_matrix (A, dof_indices); // load independent
-        matrix_B.add_matrix (B, dof_indices); // load dependent
+        _add_elem_matrix(matrix_A, A, dof_indices, elem); // load independent
+        _add_elem_matrix(matrix_B, B, dof_indices, elem); // load dependent
     }
     
     // finalize the matrices for futher use.
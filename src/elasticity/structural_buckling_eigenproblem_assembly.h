@@ -25,6 +25,10 @@
 #include "base/eigenproblem_assembly.h"
 
 
+// PETSc includes
+#include <petscmat.h>
+
+
 namespace MAST {
 
     // Forward declerations
@@ -98,6 +102,34 @@ namespace MAST {
                                 libMesh::NumericVector<Real>& x2);
 
         
+        /*!
+         *   tells the assembly to store the tangent stiffness matrix
+         *   \f$ K_1 \f$ and \f$ -K_2 \f$ at the two load factors after
+         *   they are assembled. The eigenproblem matrices are then formed
+         *   from the stored matrices, without element calculations, as
+         *   long as the buckling data, the solutions \p x1 and \p x2, and
+         *   the versions of the parameters of the discipline other than
+         *   the load parameter are unchanged. This includes a change of
+         *   the formulation with set_buckling_data(). If the structure
+         *   changes in any other way, clear_matrix_cache() must be called.
+         *   This is \p false by default.
+         */
+        void set_matrix_cache(bool f);
+        
+        
+        /*!
+         *   discards the stored matrices
+         */
+        void clear_matrix_cache();
+        
+        
+        /*!
+         *   discards the stored matrices and incompatible mode solutions
+         *   along with the data of the parent class
+         */
+        virtual void clear_mesh_dependent_data();
+        
+        
         /*!
          *   calculates the critical load factor based on the eigensolution
          */
@@ -162,6 +194,27 @@ namespace MAST {
         _elem_sensitivity_calculations(MAST::ElementBase& elem,
                                        RealMatrixX& mat_A);
         
+        /*!
+         *   @returns the sum of the versions of the parameters of the
+         *   discipline, except the load parameter
+         */
+        unsigned long long _parameter_version() const;
+        
+        
+        /*!
+         *   @returns true if the stored matrices were computed for the
+         *   current buckling data and solutions
+         */
+        bool _if_matrix_cache_valid() const;
+        
+        
+        /*!
+         *   stores the matrices \p A and \p B of the current buckling data
+         */
+        void _store_matrices(libMesh::SparseMatrix<Real>& A,
+                             libMesh::SparseMatrix<Real>& B);
+        
+        
         /*!
          *   map of local incompatible mode solution per 3D elements
          */
@@ -196,6 +249,30 @@ namespace MAST {
          *   the equilibrium solution sensitivity
          */
         libMesh::NumericVector<Real> *_sol1_sens, *_sol2_sens;
+        
+        
+        /*!
+         *   flag to store the stiffness matrices
+         */
+        bool _matrix_cache;
+        
+        /*!
+         *   stored \f$ K_1 \f$ and \f$ -K_2 \f$, or \p nullptr if not
+         *   available
+         */
+        Mat _K1, _mK2;
+        
+        /*!
+         *   load parameter, load factors, solutions and parameter version
+         *   for which the matrices were stored
+         */
+        const MAST::Parameter*                        _cache_load_param;
+        
+        Real                                          _cache_lambda1, _cache_lambda2;
+        
+        std::auto_ptr<libMesh::NumericVector<Real> >  _cache_sol1, _cache_sol2;
+        
+        unsigned long long                            _cache_version;
     };
     
 }
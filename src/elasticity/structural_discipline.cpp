@@ -19,6 +19,7 @@
 
 // C++ includes
 #include <set>
+#include <algorithm>
 
 
 // MAST includes
@@ -37,7 +38,8 @@
 MAST::StructuralDiscipline::
 StructuralDiscipline(libMesh::EquationSystems& eq_sys):
 MAST::PhysicsDisciplineBase(eq_sys),
-_stress_output_sys(nullptr) {
+_stress_output_sys(nullptr),
+_nodal_stress_output_sys(nullptr) {
 
     _stress_output_sys  =
     &(eq_sys.add_system<libMesh::ExplicitSystem>("StressOutput"));
@@ -73,8 +75,64 @@ MAST::StructuralDiscipline::~StructuralDiscipline()
 { }
 
 
+
+void
+MAST::StructuralDiscipline::add_nodal_stress_output_system() {
+    
+    // the system is added only once
+    if (_nodal_stress_output_sys)
+        return;
+    
+    _nodal_stress_output_sys  =
+    &(_eq_systems.add_system<libMesh::ExplicitSystem>("NodalStressOutput"));
+    
+    libMesh::FEType
+    fetype(libMesh::FIRST, libMesh::LAGRANGE); // continuous nodal field
+    
+    _nodal_stress_vars.resize(13);
+    
+    libMesh::System& sys = *_nodal_stress_output_sys;
+    
+    _nodal_stress_vars[0]  = sys.add_variable("epsilon-xx", fetype);
+    _nodal_stress_vars[1]  = sys.add_variable("epsilon-yy", fetype);
+    _nodal_stress_vars[2]  = sys.add_variable("epsilon-zz", fetype);
+    _nodal_stress_vars[3]  = sys.add_variable("epsilon-xy", fetype);
+    _nodal_stress_vars[4]  = sys.add_variable("epsilon-yz", fetype);
+    _nodal_stress_vars[5]  = sys.add_variable("epsilon-zx", fetype);
+    
+    _nodal_stress_vars[6]  = sys.add_variable("sigma-xx",    fetype);
+    _nodal_stress_vars[7]  = sys.add_variable("sigma-yy",    fetype);
+    _nodal_stress_vars[8]  = sys.add_variable("sigma-zz",    fetype);
+    _nodal_stress_vars[9]  = sys.add_variable("sigma-xy",    fetype);
+    _nodal_stress_vars[10] = sys.add_variable("sigma-yz",    fetype);
+    _nodal_stress_vars[11] = sys.add_variable("sigma-zx",    fetype);
+    
+    _nodal_stress_vars[12] = sys.add_variable("sigma-vm",    fetype);
+}
+
+
+
+MAST::NodalStressAverage&
+MAST::StructuralDiscipline::nodal_stress_average() {
+    
+    // the system must have been added before initialization
+    libmesh_assert(_nodal_stress_output_sys);
+    
+    if (!_nodal_stress_average.get()) {
+        
+        _nodal_stress_average.reset
+        (new MAST::NodalStressAverage(*_nodal_stress_output_sys,
+                                      _nodal_stress_vars));
+        _nodal_stress_average->zero();
+    }
+    
+    return *_nodal_stress_average;
+}
+
+
 void
-get_max_stress_strain_values(const std::vector<MAST::StressStrainOutputBase::Data*>& data,
+get_max_stress_strain_values(const MAST::StressStrainOutputBase& output,
+                             const std::pair<unsigned int, unsigned int>& range,
                              RealVectorX&           max_strain,
                              RealVectorX&           max_stress,
                              Real&                  max_vm,
@@ -86,38 +144,35 @@ get_max_stress_strain_values(const std::vector<MAST::StressStrainOutputBase::Dat
     
     // if there is only one data point, the simply copy the value to the output
     // routines
-    if (data.size() == 1) {
+    if (range.second == 1) {
         if (p == nullptr) {
-            max_strain  = data[0]->strain();
-            max_stress  = data[0]->stress();
-            max_vm      = data[0]->von_Mises_stress();
+            max_strain  = output.strain(range.first);
+            max_stress  = output.stress(range.first);
+            max_vm      = output.von_Mises_stress(range.first);
         }
         else {
-            max_strain  = data[0]->get_strain_sensitivity(p);
-            max_stress  = data[0]->get_stress_sensitivity(p);
-            max_vm      = data[0]->dvon_Mises_stress_dp  (p);
+            max_strain  = output.get_strain_sensitivity(range.first, p);
+            max_stress  = output.get_stress_sensitivity(range.first, p);
+            max_vm      = output.dvon_Mises_stress_dp  (range.first, p);
         }
         
         return;
     }
     
-    // if multiple values are provided for an element, then we need to compare
-    std::vector<MAST::StressStrainOutputBase::Data*>::const_iterator
-    it        = data.begin(),
-    end       = data.end();
-    
-    Real
-    vm        = 0.;
+    // if multiple values are provided for an element, then we need to compare.
+    // The von Mises stress of all points of the element are evaluated
+    // together, since the data of the element is stored contiguously
+    RealVectorX
+    vm;
+    MAST::StressStrainOutputBase::von_Mises_stress_batch
+    (output.stress(range.first).data(), range.second, vm);
+    max_vm    = std::max(max_vm, vm.maxCoeff());
     
-    for ( ; it != end; it++) {
+    for (unsigned int j=range.first; j<range.first+range.second; j++) {
         
         // get the strain value at this point
-        const RealVectorX& strain =  (*it)->strain();
-        const RealVectorX& stress =  (*it)->stress();
-        vm                        =  (*it)->von_Mises_stress();
-        
-        // now compare
-        if (vm > max_vm)                      max_vm        = vm;
+        Eigen::Map<const RealVectorX> strain =  output.strain(j);
+        Eigen::Map<const RealVectorX> stress =  output.stress(j);
         
         for ( unsigned int i=0; i<6; i++) {
             if (fabs(strain(i)) > max_strain(i))  max_strain(i) = strain(i);
@@ -168,19 +223,20 @@ plot_stress_strain_data(const std::string& file_nm,
         
         // get the stress-strain data map from the object
         const std::map<const libMesh::Elem*,
-        std::vector<MAST::StressStrainOutputBase::Data*> >& output_map =
-        output.get_stress_strain_data();
+        std::pair<unsigned int, unsigned int> >& output_map =
+        output.get_stress_strain_data_range();
         
         // now iteragtove over all the elements and set the value in the
         // new system used for output
         std::map<const libMesh::Elem*,
-        std::vector<MAST::StressStrainOutputBase::Data*> >::const_iterator
+        std::pair<unsigned int, unsigned int> >::const_iterator
         e_it    =  output_map.begin(),
         e_end   =  output_map.end();
         
         for ( ; e_it != e_end; e_it++) {
             
-            get_max_stress_strain_values(e_it->second,
+            get_max_stress_strain_values(output,
+                                         e_it->second,
                                          max_strain_vals,
                                          max_stress_vals,
                                          max_vm_stress,
@@ -213,8 +269,27 @@ plot_stress_strain_data(const std::string& file_nm,
 
 
 
+template <typename ValType>
+void MAST::StructuralDiscipline::
+plot_nodal_stress_strain_data(const std::string& file_nm) {
+    
+    MAST::NodalStressAverage& avg = this->nodal_stress_average();
+    
+    avg.close();
+    
+    // now output
+    std::set<std::string> nm;
+    nm.insert(_nodal_stress_output_sys->name());
+    ValType(_eq_systems.get_mesh()).write_equation_systems(file_nm, _eq_systems, &nm);
+}
+
+
+
 // explicit instantiation
 template void MAST::StructuralDiscipline::
 plot_stress_strain_data<libMesh::ExodusII_IO>(const std::string&     file_nm,
                                               const MAST::Parameter* p) const;
 
+template void MAST::StructuralDiscipline::
+plot_nodal_stress_strain_data<libMesh::ExodusII_IO>(const std::string& file_nm);
+
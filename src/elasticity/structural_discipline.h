@@ -20,8 +20,13 @@
 #ifndef __mast__structural_discipline__
 #define __mast__structural_discipline__
 
+// C++ includes
+#include <memory>
+
+
 // MAST includes
 #include "base/physics_discipline_base.h"
+#include "elasticity/nodal_stress_average.h"
 
 
 
@@ -55,6 +60,34 @@ namespace MAST {
                                      const MAST::Parameter* p = nullptr) const;
 
         
+        /*!
+         *   adds the system \p NodalStressOutput with first order Lagrange
+         *   variables for the nodal averages of the strain, stress and von
+         *   Mises stress. This must be called before the equation systems
+         *   are initialized.
+         */
+        void add_nodal_stress_output_system();
+        
+        
+        /*!
+         *   @returns the nodal averages stored in the system added by
+         *   add_nodal_stress_output_system(), which can be set for the
+         *   stress outputs with
+         *   MAST::StressStrainOutputBase::set_nodal_stress_average(). The
+         *   object is created on the first call, after the equation
+         *   systems are initialized.
+         */
+        MAST::NodalStressAverage& nodal_stress_average();
+        
+        
+        /*!
+         *   computes the nodal averages of the points added since the last
+         *   MAST::NodalStressAverage::zero() and writes them to \p file_nm.
+         *   This must be called on all processors.
+         */
+        template <typename ValType>
+        void plot_nodal_stress_strain_data(const std::string& file_nm);
+        
         
     protected:
         
@@ -62,6 +95,18 @@ namespace MAST {
         
         std::vector<unsigned int>  _stress_vars;
         
+        /*!
+         *   system and variables of the nodal stress averages
+         */
+        libMesh::System*           _nodal_stress_output_sys;
+        
+        std::vector<unsigned int>  _nodal_stress_vars;
+        
+        /*!
+         *   nodal averages of the stress outputs
+         */
+        std::auto_ptr<MAST::NodalStressAverage> _nodal_stress_average;
+        
     };
 }
 
@@ -30,6 +30,7 @@
 #include "base/boundary_condition_base.h"
 #include "base/parameter.h"
 #include "base/constant_field_function.h"
+#include "base/performance_log.h"
 
 
 
@@ -286,6 +287,15 @@ MAST::StructuralElement1D::calculate_stress(bool request_derivative,
     // a reference to the stress output data structure
     MAST::StressStrainOutputBase& stress_output =
     dynamic_cast<MAST::StressStrainOutputBase&>(output);
+    
+    // the sensitivity is evaluated only for the parameters requested by
+    // the output, and the derivative wrt the state vector is needed for
+    // the sensitivity only if the solution sensitivity is non-zero.
+    const bool
+    if_sens = (request_sensitivity &&
+               stress_output.if_evaluate_sensitivity(*sensitivity_param)),
+    if_dX   = (request_derivative ||
+               (if_sens && (_local_sol_sens.array() != 0.).any()));
 
     // check to see if the element has any thermal loads specified
     // The object returns null
@@ -383,7 +393,7 @@ MAST::StructuralElement1D::calculate_stress(bool request_derivative,
         stress_3D(0)  =   stress(0);
         
         // set the stress and strain data
-        MAST::StressStrainOutputBase::Data&
+        MAST::StressStrainOutputBase::Data
         data = stress_output.add_stress_strain_at_qp_location(&_elem,
                                                               qp_loc[qp],
                                                               xyz[qp],
@@ -392,39 +402,42 @@ MAST::StructuralElement1D::calculate_stress(bool request_derivative,
                                                               JxW[qp]);
 
         // calculate the derivative if requested
-        if (request_derivative || request_sensitivity) {
+        if (if_dX || if_sens) {
             
-            Bmat_mem.left_multiply(dstrain_dX, eye);  // membrane strain is linear
+            if (if_dX) {
+                
+                Bmat_mem.left_multiply(dstrain_dX, eye);  // membrane strain is linear
             
-            if (if_bending) {
+                if (if_bending) {
                 
-                // von Karman strain
-                if (if_vk) {
+                    // von Karman strain
+                    if (if_vk) {
                     
-                    Bmat_v_vk.left_multiply(mat_n1n2, vk_dvdxi_mat);
-                    dstrain_dX   +=  mat_n1n2;
+                        Bmat_v_vk.left_multiply(mat_n1n2, vk_dvdxi_mat);
+                        dstrain_dX   +=  mat_n1n2;
 
-                    Bmat_w_vk.left_multiply(mat_n1n2, vk_dwdxi_mat);
-                    dstrain_dX   +=  mat_n1n2;
-                }
+                        Bmat_w_vk.left_multiply(mat_n1n2, vk_dwdxi_mat);
+                        dstrain_dX   +=  mat_n1n2;
+                    }
                 
-                // bending strain
-                Bmat_bend.left_multiply(mat_n1n2, eye);
-                dstrain_dX  +=   mat_n1n2;
-            }
+                    // bending strain
+                    Bmat_bend.left_multiply(mat_n1n2, eye);
+                    dstrain_dX  +=   mat_n1n2;
+                }
             
-            // note: this assumes linear material laws
-            dstress_dX  = material_mat * dstrain_dX;
+                // note: this assumes linear material laws
+                dstress_dX  = material_mat * dstrain_dX;
             
-            // copy to the 3D structure
-            dstress_dX_3D.row(0)  = dstress_dX.row(0);
-            dstrain_dX_3D.row(0)  = dstrain_dX.row(0);
+                // copy to the 3D structure
+                dstress_dX_3D.row(0)  = dstress_dX.row(0);
+                dstrain_dX_3D.row(0)  = dstrain_dX.row(0);
             
-            if (request_derivative)
-                data.set_derivatives(dstress_dX_3D, dstrain_dX_3D);
+                if (request_derivative)
+                    data.set_derivatives(dstress_dX_3D, dstrain_dX_3D);
+            }
                 
 
-            if (request_sensitivity) {
+            if (if_sens) {
                 // sensitivity of the response, s, is
                 //   ds/dp   = partial s/partial p  +
                 //             partial s/partial X   dX/dp
@@ -499,8 +512,10 @@ MAST::StructuralElement1D::calculate_stress(bool request_derivative,
                 // sensitivity
                 //
                 
-                dstress_dp  += dstress_dX * _local_sol_sens;
-                dstrain_dp  += dstrain_dX * _local_sol_sens;
+                if (if_dX) {
+                    dstress_dp  += dstress_dX * _local_sol_sens;
+                    dstrain_dp  += dstrain_dX * _local_sol_sens;
+                }
                 
                 // copy the 3D object
                 stress_3D(0) = dstress_dp(0);
@@ -533,6 +548,22 @@ MAST::StructuralElement1D::internal_residual (bool request_jacobian,
                                               RealVectorX& f,
                                               RealMatrixX& jac)
 {
+    MAST_LOG_SCOPE("internal_residual()", "StructuralElement1D");
+    
+    std::auto_ptr<MAST::FieldFunction<RealMatrixX > >
+    mat_stiff_A  = _property.stiffness_A_matrix(*this),
+    mat_stiff_B  = _property.stiffness_B_matrix(*this),
+    mat_stiff_D  = _property.stiffness_D_matrix(*this);
+    
+    // linear elements with constant section properties do not need
+    // the quadrature loop
+    if (_closed_form_internal_residual(request_jacobian, f, jac,
+                                       *mat_stiff_A,
+                                       *mat_stiff_B,
+                                       *mat_stiff_D,
+                                       nullptr))
+        return request_jacobian;
+    
     MAST::FEMOperatorMatrix Bmat_mem, Bmat_bend, Bmat_v_vk, Bmat_w_vk;
     
     const std::vector<Real>& JxW           = _fe->get_JxW();
@@ -576,24 +607,74 @@ MAST::StructuralElement1D::internal_residual (bool request_jacobian,
     bool if_vk = (_property.strain_type() == MAST::VON_KARMAN_STRAIN),
     if_bending = (_property.bending_model(_elem, _fe->get_fe_type()) != MAST::NO_BENDING);
     
-    std::auto_ptr<MAST::FieldFunction<RealMatrixX > >
-    mat_stiff_A  = _property.stiffness_A_matrix(*this),
-    mat_stiff_B  = _property.stiffness_B_matrix(*this),
-    mat_stiff_D  = _property.stiffness_D_matrix(*this);
-    
+    // section properties that are independent of location and time are
+    // evaluated only at the first quadrature point
+    const bool
+    const_A  = mat_stiff_A->is_constant(),
+    const_B  = mat_stiff_B->is_constant(),
+    const_D  = mat_stiff_D->is_constant();
     
     libMesh::Point p;
     
+    // if the element retains its linear stiffness, then only the von
+    // Karman terms are computed at the quadrature points. The linear
+    // stiffness is computed here on the first call.
+    MAST::LinearStiffnessData*
+    lin = (if_vk && if_bending)? this->_linear_stiffness_data(): nullptr;
+    
+    if (lin && !lin->valid) {
+        
+        RealVectorX
+        lin_f = RealVectorX::Zero(n2);
+        
+        lin->jac.setZero(n2, n2);
+        
+        for (unsigned int qp=0; qp<JxW.size(); qp++) {
+            
+            this->_global_qp_location(*_fe, qp, p);
+            
+            if (qp == 0 || !const_A)
+                (*mat_stiff_A)(p, _time, material_A_mat);
+            if (qp == 0 || !const_B)
+                (*mat_stiff_B)(p, _time, material_B_mat);
+            if (qp == 0 || !const_D)
+                (*mat_stiff_D)(p, _time, material_D_mat);
+            
+            _internal_residual_operation(if_bending, false, n2, qp, *_fe, JxW,
+                                         true,
+                                         lin_f, lin->jac,
+                                         Bmat_mem, Bmat_bend, Bmat_v_vk, Bmat_w_vk,
+                                         stress, stress_l, vk_dvdxi_mat, vk_dwdxi_mat,
+                                         material_A_mat,
+                                         material_B_mat, material_D_mat, vec1_n1,
+                                         vec2_n1, vec3_n2, vec4_n3,
+                                         vec5_n3, mat1_n1n2, mat2_n2n2,
+                                         mat3, mat4_n3n2);
+        }
+        
+        if (_bending_operator->include_transverse_shear_energy())
+            _bending_operator->calculate_transverse_shear_residual(true,
+                                                                   lin_f,
+                                                                   lin->jac,
+                                                                   nullptr);
+        
+        lin->valid = true;
+        lin->time  = _time;
+    }
+    
     for (unsigned int qp=0; qp<JxW.size(); qp++) {
         
-        this->local_elem().global_coordinates_location(xyz[qp], p);
+        this->_global_qp_location(*_fe, qp, p);
         
         // get the material matrix
-        (*mat_stiff_A)(p, _time, material_A_mat);
+        if (qp == 0 || !const_A)
+            (*mat_stiff_A)(p, _time, material_A_mat);
         
         if (if_bending) {
-            (*mat_stiff_B)(p, _time, material_B_mat);
-            (*mat_stiff_D)(p, _time, material_D_mat);
+            if (qp == 0 || !const_B)
+                (*mat_stiff_B)(p, _time, material_B_mat);
+            if (!lin && (qp == 0 || !const_D))
+                (*mat_stiff_D)(p, _time, material_D_mat);
         }
         
         // now calculte the quantity for these matrices
@@ -606,19 +687,29 @@ MAST::StructuralElement1D::internal_residual (bool request_jacobian,
                                      material_B_mat, material_D_mat, vec1_n1,
                                      vec2_n1, vec3_n2, vec4_n3,
                                      vec5_n3, mat1_n1n2, mat2_n2n2,
-                                     mat3, mat4_n3n2);
+                                     mat3, mat4_n3n2,
+                                     lin != nullptr);
         
     }
     
     
     // now calculate the transverse shear contribution if appropriate for the
     // element
-    if (if_bending && _bending_operator->include_transverse_shear_energy())
+    if (!lin &&
+        if_bending &&
+        _bending_operator->include_transverse_shear_energy())
         _bending_operator->calculate_transverse_shear_residual(request_jacobian,
                                                                local_f,
                                                                local_jac,
                                                                nullptr);
     
+    // add the retained linear stiffness
+    if (lin) {
+        local_f += lin->jac * _local_sol;
+        if (request_jacobian)
+            local_jac += lin->jac;
+    }
+    
     
     // now transform to the global coorodinate system
     transform_vector_to_global_system(local_f, vec3_n2);
@@ -704,12 +795,19 @@ MAST::StructuralElement1D::internal_residual_sensitivity (bool request_jacobian,
     mat_stiff_B = _property.stiffness_B_matrix(*this),
     mat_stiff_D = _property.stiffness_D_matrix(*this);
     
+    if (_closed_form_internal_residual(request_jacobian, f, jac,
+                                       *mat_stiff_A,
+                                       *mat_stiff_B,
+                                       *mat_stiff_D,
+                                       this->sensitivity_param))
+        return request_jacobian;
+    
     libMesh::Point p;
     
     // first calculate the sensitivity due to the parameter
     for (unsigned int qp=0; qp<JxW.size(); qp++) {
         
-        this->local_elem().global_coordinates_location(xyz[qp], p);
+        this->_global_qp_location(*_fe, qp, p);
         
         // get the material matrix
         mat_stiff_A->derivative(*this->sensitivity_param,
@@ -837,7 +935,7 @@ internal_residual_jac_dot_state_sensitivity (RealMatrixX& jac) {
     
     for (unsigned int qp=0; qp<JxW.size(); qp++) {
         
-        this->local_elem().global_coordinates_location(xyz[qp], p);
+        this->_global_qp_location(*_fe, qp, p);
         
         // get the material matrix
         (*mat_stiff_A)(p, _time, material_A_mat);
@@ -1015,6 +1113,265 @@ internal_residual_jac_dot_state_sensitivity (RealMatrixX& jac) {
 
 
 
+bool
+MAST::StructuralElement1D::
+_closed_form_internal_residual(bool request_jacobian,
+                               RealVectorX& f,
+                               RealMatrixX& jac,
+                               const MAST::FieldFunction<RealMatrixX>& A,
+                               const MAST::FieldFunction<RealMatrixX>& B,
+                               const MAST::FieldFunction<RealMatrixX>& D,
+                               const MAST::FunctionBase* p) {
+    
+    const libMesh::FEType& fe_type = _fe->get_fe_type();
+    
+    if (_property.strain_type() != MAST::LINEAR_STRAIN ||
+        _elem.type()            != libMesh::EDGE2      ||
+        fe_type.family          != libMesh::LAGRANGE   ||
+        fe_type.order           != libMesh::FIRST)
+        return false;
+    
+    const MAST::BendingOperatorType
+    bending_model = _property.bending_model(_elem, fe_type);
+    
+    if ((bending_model != MAST::BERNOULLI &&
+         bending_model != MAST::TIMOSHENKO) ||
+        !A.is_constant() ||
+        !B.is_constant() ||
+        !D.is_constant())
+        return false;
+    
+    std::auto_ptr<MAST::FieldFunction<RealMatrixX> > G;
+    
+    if (bending_model == MAST::TIMOSHENKO) {
+        
+        G.reset(_property.transverse_shear_stiffness_matrix(*this).release());
+        if (!G->is_constant())
+            return false;
+    }
+    
+    MAST_LOG_SCOPE("closed_form_internal_residual()", "StructuralElement1D");
+    
+    const unsigned int
+    n2 = 12;
+    
+    RealMatrixX
+    material_A_mat,
+    material_B_mat,
+    material_D_mat,
+    material_G_mat,
+    local_jac,
+    mat_n2n2      = RealMatrixX::Zero(n2, n2);
+    
+    RealVectorX
+    vec_n2        = RealVectorX::Zero(n2),
+    local_f;
+    
+    // the properties are constant, and are evaluated at the first
+    // quadrature point
+    libMesh::Point pt;
+    this->_global_qp_location(*_fe, 0, pt);
+    
+    if (!p) {
+        
+        A(pt, _time, material_A_mat);
+        B(pt, _time, material_B_mat);
+        D(pt, _time, material_D_mat);
+        if (G.get())
+            (*G)(pt, _time, material_G_mat);
+    }
+    else {
+        
+        A.derivative(*p, pt, _time, material_A_mat);
+        B.derivative(*p, pt, _time, material_B_mat);
+        D.derivative(*p, pt, _time, material_D_mat);
+        if (G.get())
+            G->derivative(*p, pt, _time, material_G_mat);
+    }
+    
+    _closed_form_linear_stiffness(material_A_mat,
+                                  material_B_mat,
+                                  material_D_mat,
+                                  G.get()?&material_G_mat:nullptr,
+                                  local_jac);
+    
+    // the strain is linear in the solution
+    local_f = local_jac * _local_sol;
+    
+    // now transform to the global coorodinate system
+    transform_vector_to_global_system(local_f, vec_n2);
+    f += vec_n2;
+    
+    if (request_jacobian) {
+        transform_matrix_to_global_system(local_jac, mat_n2n2);
+        jac += mat_n2n2;
+    }
+    
+    return true;
+}
+
+
+
+
+void
+MAST::StructuralElement1D::
+_closed_form_linear_stiffness(const RealMatrixX& A,
+                              const RealMatrixX& B,
+                              const RealMatrixX& D,
+                              const RealMatrixX* G,
+                              RealMatrixX& k) {
+    
+    const std::vector<Real>& JxW            = _fe->get_JxW();
+    const std::vector<std::vector<libMesh::RealVectorValue> >& dphi = _fe->get_dphi();
+    const std::vector<libMesh::Point>& qpts = _qrule->get_points();
+    
+    libmesh_assert_equal_to(dphi.size(), 2);
+    
+    const unsigned int
+    n2 = 12;
+    
+    // element length used by the Bernoulli bending operator, and the
+    // derivatives of the shape functions, which are constant
+    const Real
+    L    = this->get_elem_for_quadrature().volume(),
+    dN0  = dphi[0][0](0),
+    dN1  = dphi[1][0](0);
+    
+    // moments of the element coordinate for the quadrature rule
+    Real
+    m0 = 0.,
+    m1 = 0.,
+    m2 = 0.;
+    
+    for (unsigned int qp=0; qp<JxW.size(); qp++) {
+        
+        const Real xi = qpts[qp](0);
+        m0 += JxW[qp];
+        m1 += JxW[qp] * xi;
+        m2 += JxW[qp] * xi * xi;
+    }
+    
+    // the first two rows of the strain operator are the axial and
+    // torsion strains, followed by the two bending strains. The dofs are
+    // ordered by variable: u, v, w, theta_x, theta_y, theta_z
+    RealMatrixX
+    E0 = RealMatrixX::Zero(4, n2),
+    E1 = RealMatrixX::Zero(4, n2),
+    C  = RealMatrixX::Zero(4, 4);
+    
+    E0(0, 0) = dN0;   E0(0, 1) = dN1;   // epsilon_xx = du/dx
+    E0(1, 6) = dN0;   E0(1, 7) = dN1;   // torsion    = dtheta_x/dx
+    
+    if (_property.bending_model(_elem, _fe->get_fe_type()) == MAST::BERNOULLI) {
+        
+        // same as BernoulliBendingOperator
+        E1(2,  2) = -6./L/L;  E1(2,  3) =  6./L/L;  // v-disp
+        E0(2, 10) =  1./L;    E0(2, 11) = -1./L;    // theta-z
+        E1(2, 10) = -3./L;    E1(2, 11) = -3./L;
+        
+        E1(3,  4) = -6./L/L;  E1(3,  5) =  6./L/L;  // w-disp
+        E0(3,  8) = -1./L;    E0(3,  9) =  1./L;    // theta-y
+        E1(3,  8) =  3./L;    E1(3,  9) =  3./L;
+    }
+    else {
+        
+        // same as TimoshenkoBendingOperator
+        E0(2, 10) = -dN0;     E0(2, 11) = -dN1;     // theta-z
+        E0(3,  8) =  dN0;     E0(3,  9) =  dN1;     // theta-y
+    }
+    
+    C.topLeftCorner    (2, 2) = A;
+    C.topRightCorner   (2, 2) = B;
+    C.bottomLeftCorner (2, 2) = B.transpose();
+    C.bottomRightCorner(2, 2) = D;
+    
+    k =
+    m0 * E0.transpose() * C * E0 +
+    m1 * (E0.transpose() * C * E1 + E1.transpose() * C * E0) +
+    m2 * E1.transpose() * C * E1;
+    
+    if (!G)
+        return;
+    
+    // transverse shear with the quadrature rule used by
+    // TimoshenkoBendingOperator, for which phi = (1 -/+ xi)/2
+    const libMesh::FEType& fe_type = _fe->get_fe_type();
+    
+    std::auto_ptr<libMesh::QBase>
+    qrule(fe_type.default_quadrature_rule
+          (1,
+           _property.extra_quadrature_order(this->get_elem_for_quadrature(), fe_type)
+           - (int)_property.transverse_shear_quadrature_reduction()).release());
+    qrule->init(libMesh::EDGE2);
+    
+    const std::vector<Real>& w              = qrule->get_weights();
+    const std::vector<libMesh::Point>& xi_s = qrule->get_points();
+    
+    // the Jacobian of the EDGE2 map is constant, and the weights of the
+    // rule add up to two
+    const Real
+    detJ = 0.5 * m0;
+    
+    m0 = 0.; m1 = 0.; m2 = 0.;
+    for (unsigned int qp=0; qp<w.size(); qp++) {
+        
+        const Real xi = xi_s[qp](0);
+        m0 += detJ * w[qp];
+        m1 += detJ * w[qp] * xi;
+        m2 += detJ * w[qp] * xi * xi;
+    }
+    
+    RealMatrixX
+    T0 = RealMatrixX::Zero(2, n2),
+    T1 = RealMatrixX::Zero(2, n2);
+    
+    T0(0,  2) = dN0;   T0(0,  3) = dN1;    // gamma-xy: v
+    T0(0, 10) = -0.5;  T0(0, 11) = -0.5;   // gamma-xy: theta-z
+    T1(0, 10) =  0.5;  T1(0, 11) = -0.5;
+    
+    T0(1,  4) = dN0;   T0(1,  5) = dN1;    // gamma-xz: w
+    T0(1,  8) =  0.5;  T0(1,  9) =  0.5;   // gamma-xz: theta-y
+    T1(1,  8) = -0.5;  T1(1,  9) =  0.5;
+    
+    k +=
+    m0 * T0.transpose() * (*G) * T0 +
+    m1 * (T0.transpose() * (*G) * T1 + T1.transpose() * (*G) * T0) +
+    m2 * T1.transpose() * (*G) * T1;
+}
+
+
+
+
+void
+MAST::StructuralElement1D::_shape_function_mass_matrix(RealMatrixX& m) {
+    
+    const libMesh::FEType& fe_type = _fe->get_fe_type();
+    
+    // the closed form is used if the quadrature rule integrates the
+    // product of the linear shape functions exactly
+    if (_elem.type()   != libMesh::EDGE2    ||
+        fe_type.family != libMesh::LAGRANGE ||
+        fe_type.order  != libMesh::FIRST    ||
+        _qrule->get_order() < libMesh::SECOND) {
+        
+        MAST::StructuralElementBase::_shape_function_mass_matrix(m);
+        return;
+    }
+    
+    const std::vector<Real>& JxW = _fe->get_JxW();
+    
+    Real L = 0.;
+    for (unsigned int qp=0; qp<JxW.size(); qp++)
+        L += JxW[qp];
+    
+    m = RealMatrixX::Zero(2, 2);
+    m(0, 0) = m(1, 1) = L/3.;
+    m(0, 1) = m(1, 0) = L/6.;
+}
+
+
+
+
 void
 MAST::StructuralElement1D::
 _internal_residual_operation(bool if_bending,
@@ -1045,7 +1402,8 @@ _internal_residual_operation(bool if_bending,
                              RealMatrixX& mat1_n1n2,
                              RealMatrixX& mat2_n2n2,
                              RealMatrixX& mat3,
-                             RealMatrixX& mat4_2n2)
+                             RealMatrixX& mat4_2n2,
+                             bool if_vk_only)
 {
     this->initialize_direct_strain_operator(qp, fe, Bmat_mem);
     
@@ -1053,6 +1411,12 @@ _internal_residual_operation(bool if_bending,
     Bmat_mem.vector_mult(vec1_n1, _local_sol);
     vec2_n1 = material_A_mat * vec1_n1; // linear direct stress
     
+    // linear axial strain and torsion force, which are excluded if only
+    // the von Karman terms are computed
+    const Real
+    axial_strain_l = vec1_n1(0),
+    torsion_l      = vec2_n1(1);
+    
     // copy the stress values to a matrix
     stress_l(0,0) = vec2_n1(0); // sigma_xx
     stress(0,0)   = vec2_n1(0);
@@ -1094,11 +1458,23 @@ _internal_residual_operation(bool if_bending,
     vec1_n1(1)   = stress(0,1); // use the torsion strain from the temporary location
     stress(0, 1) = 0.;   // zero out the temporary value storing the torsion strain
     
+    // without the linear terms, only the stress from the von Karman
+    // strain is used with the membrane strain operator
+    if (if_vk_only) {
+        vec1_n1(0) -= stress_l(0,0);
+        vec1_n1(1)  = 0.;
+    }
+    
     // now the internal force vector
     // this includes the membrane strain operator with all A and B material operators
     Bmat_mem.vector_mult_transpose(vec3_n2, vec1_n1);
     local_f += JxW[qp] * vec3_n2;
     
+    if (if_vk_only) {
+        vec1_n1(0) = stress(0,0);
+        vec1_n1(1) = torsion_l;
+    }
+    
     if (if_bending) {
         if (if_vk) {
             // von Karman strain: direct stress
@@ -1113,7 +1489,7 @@ _internal_residual_operation(bool if_bending,
         }
         
         // use the direct strain from the temprary storage
-        vec2_n1(0)  = stress(1,1);
+        vec2_n1(0)  = stress(1,1) - (if_vk_only? axial_strain_l: 0.);
         stress(1,1) = 0.;
         // now coupling with the bending strain
         // B_bend^T [B] B_mem
@@ -1122,17 +1498,21 @@ _internal_residual_operation(bool if_bending,
         local_f += JxW[qp] * vec3_n2;
         
         // now bending stress
-        Bmat_bend.vector_mult(vec2_n1, _local_sol);
-        vec1_n1 = material_D_mat * vec2_n1;
-        Bmat_bend.vector_mult_transpose(vec3_n2, vec1_n1);
-        local_f += JxW[qp] * vec3_n2;
+        if (!if_vk_only) {
+            Bmat_bend.vector_mult(vec2_n1, _local_sol);
+            vec1_n1 = material_D_mat * vec2_n1;
+            Bmat_bend.vector_mult_transpose(vec3_n2, vec1_n1);
+            local_f += JxW[qp] * vec3_n2;
+        }
     }
     
     if (request_jacobian) {
         // membrane - membrane
-        Bmat_mem.left_multiply(mat1_n1n2, material_A_mat);
-        Bmat_mem.right_multiply_transpose(mat2_n2n2, mat1_n1n2);
-        local_jac += JxW[qp] * mat2_n2n2;
+        if (!if_vk_only) {
+            Bmat_mem.left_multiply(mat1_n1n2, material_A_mat);
+            Bmat_mem.right_multiply_transpose(mat2_n2n2, mat1_n1n2);
+            local_jac += JxW[qp] * mat2_n2n2;
+        }
                 
         if (if_bending) {
             if (if_vk) {
@@ -1246,21 +1626,24 @@ _internal_residual_operation(bool if_bending,
                 local_jac += JxW[qp] * mat2_n2n2;
             }
             
-            // bending - membrane
-            mat3 = material_B_mat.transpose();
-            Bmat_mem.left_multiply(mat1_n1n2, mat3);
-            Bmat_bend.right_multiply_transpose(mat2_n2n2, mat1_n1n2);
-            local_jac += JxW[qp] * mat2_n2n2;
-            
-            // membrane - bending
-            Bmat_bend.left_multiply(mat1_n1n2, material_B_mat);
-            Bmat_mem.right_multiply_transpose(mat2_n2n2, mat1_n1n2);
-            local_jac += JxW[qp] * mat2_n2n2;
-            
-            // bending - bending
-            Bmat_bend.left_multiply(mat1_n1n2, material_D_mat);
-            Bmat_bend.right_multiply_transpose(mat2_n2n2, mat1_n1n2);
-            local_jac += JxW[qp] * mat2_n2n2;
+            if (!if_vk_only) {
+                
+                // bending - membrane
+                mat3 = material_B_mat.transpose();
+                Bmat_mem.left_multiply(mat1_n1n2, mat3);
+                Bmat_bend.right_multiply_transpose(mat2_n2n2, mat1_n1n2);
+                local_jac += JxW[qp] * mat2_n2n2;
+                
+                // membrane - bending
+                Bmat_bend.left_multiply(mat1_n1n2, material_B_mat);
+                Bmat_mem.right_multiply_transpose(mat2_n2n2, mat1_n1n2);
+                local_jac += JxW[qp] * mat2_n2n2;
+                
+                // bending - bending
+                Bmat_bend.left_multiply(mat1_n1n2, material_D_mat);
+                Bmat_bend.right_multiply_transpose(mat2_n2n2, mat1_n1n2);
+                local_jac += JxW[qp] * mat2_n2n2;
+            }
         }
     }
 }
@@ -1463,7 +1846,7 @@ MAST::StructuralElement1D::prestress_residual (bool request_jacobian,
     // now calculate the quantity
     for (unsigned int qp=0; qp<JxW.size(); qp++) {
         
-        this->local_elem().global_coordinates_location(xyz[qp], p);
+        this->_global_qp_location(*_fe, qp, p);
         
         (*prestress_A)(p, _time, prestress_mat_A);
         (*prestress_B)(p, _time, prestress_mat_B);
@@ -1599,7 +1982,7 @@ MAST::StructuralElement1D::prestress_residual_sensitivity (bool request_jacobian
     // transform to the local coordinate system
     for (unsigned int qp=0; qp<JxW.size(); qp++) {
         
-        this->local_elem().global_coordinates_location(xyz[qp], p);
+        this->_global_qp_location(*_fe, qp, p);
         
         prestress_A->derivative(*this->sensitivity_param,
                                 p, _time, prestress_mat_A);
@@ -1689,6 +2072,8 @@ surface_pressure_residual(bool request_jacobian,
                           const unsigned int side,
                           MAST::BoundaryConditionBase& bc) {
     
+    MAST_LOG_SCOPE("surface_pressure_residual()", "StructuralElement1D");
+    
     libmesh_assert(!follower_forces); // not implemented yet for follower forces
     
     // prepare the side finite element
@@ -1876,6 +2261,8 @@ MAST::StructuralElement1D::thermal_residual (bool request_jacobian,
                                              RealMatrixX& jac,
                                              MAST::BoundaryConditionBase& bc)
 {
+    MAST_LOG_SCOPE("thermal_residual()", "StructuralElement1D");
+    
     MAST::FEMOperatorMatrix Bmat_mem, Bmat_bend, Bmat_v_vk, Bmat_w_vk;
     
     const std::vector<Real>& JxW           = _fe->get_JxW();
@@ -1904,6 +2291,7 @@ MAST::StructuralElement1D::thermal_residual (bool request_jacobian,
     vec4_2     = RealVectorX::Zero(2),
     vec5_n3    = RealVectorX::Zero(n3),
     local_f    = RealVectorX::Zero(n2),
+    local_vk_f = RealVectorX::Zero(n2),
     delta_t    = RealVectorX::Zero(1);
     
     local_f.setZero();
@@ -1917,69 +2305,103 @@ MAST::StructuralElement1D::thermal_residual (bool request_jacobian,
     bool if_vk = (_property.strain_type() == MAST::VON_KARMAN_STRAIN),
     if_bending = (_property.bending_model(_elem, _fe->get_fe_type()) != MAST::NO_BENDING);
     
+    // the thermal stress and the load from the membrane and bending
+    // strains do not depend on the solution, and are reused from the
+    // retained data if available
+    MAST::ThermalLoadData*
+    data       = this->_thermal_load_data(bc);
+    const bool
+    if_cached  = data && data->valid;
+    
+    if (if_cached && !(if_bending && if_vk)) {
+        
+        f -= data->f;
+        return request_jacobian;
+    }
+    
     std::auto_ptr<MAST::FieldFunction<RealMatrixX > >
-    expansion_A = _property.thermal_expansion_A_matrix(*this),
-    expansion_B = _property.thermal_expansion_B_matrix(*this);
+    expansion_A,
+    expansion_B;
+    
+    if (!if_cached) {
+        expansion_A = _property.thermal_expansion_A_matrix(*this);
+        expansion_B = _property.thermal_expansion_B_matrix(*this);
+        if (data) data->stress.resize(n1, JxW.size());
+    }
     
     // temperature function
     const MAST::FieldFunction<Real>
     &temp_func     = bc.get<MAST::FieldFunction<Real> >("temperature"),
     &ref_temp_func = bc.get<MAST::FieldFunction<Real> >("ref_temperature");
     
+    // temperature from the nodal values of a thermal system on the
+    // same mesh, if available
+    std::vector<Real> qp_temp;
+    const bool
+    if_direct_temp = !if_cached && this->_direct_qp_temperature(temp_func, *_fe, qp_temp);
+    
     Real t, t0;
     libMesh::Point pt;
     
     for (unsigned int qp=0; qp<JxW.size(); qp++) {
         
-        this->local_elem().global_coordinates_location(xyz[qp], pt);
-        
-        // get the material property
-        (*expansion_A)(pt, _time, material_exp_A_mat);
-        (*expansion_B)(pt, _time, material_exp_B_mat);
-        
-        // get the temperature function
-        temp_func    (pt, _time, t);
-        ref_temp_func(pt, _time, t0);
-        delta_t(0) = t-t0;
-        
-        vec1_n1 = material_exp_A_mat * delta_t; // [C]{alpha (T - T0)} (with membrane strain)
-        stress(0,0) = vec1_n1(0); // sigma_xx
-        vec2_n1 = material_exp_B_mat * delta_t; // [C]{alpha (T - T0)} (with bending strain)
-        
-        this->initialize_direct_strain_operator(qp, *_fe, Bmat_mem);
-        
-        // membrane strain
-        Bmat_mem.vector_mult_transpose(vec3_n2, vec1_n1);
-        local_f += JxW[qp] * vec3_n2;
-        
-        if (if_bending) {
-            // bending strain
-            _bending_operator->initialize_bending_strain_operator(*_fe, qp, Bmat_bend);
-            Bmat_bend.vector_mult_transpose(vec3_n2, vec2_n1);
+        if (if_cached)
+            vec1_n1 = data->stress.col(qp);
+        else {
+            
+            this->_global_qp_location(*_fe, qp, pt);
+            
+            // get the material property
+            (*expansion_A)(pt, _time, material_exp_A_mat);
+            (*expansion_B)(pt, _time, material_exp_B_mat);
+            
+            // get the temperature function
+            if (if_direct_temp) t = qp_temp[qp];
+            else temp_func(pt, _time, t);
+            ref_temp_func(pt, _time, t0);
+            delta_t(0) = t-t0;
+            
+            vec1_n1 = material_exp_A_mat * delta_t; // [C]{alpha (T - T0)} (with membrane strain)
+            vec2_n1 = material_exp_B_mat * delta_t; // [C]{alpha (T - T0)} (with bending strain)
+            if (data) data->stress.col(qp) = vec1_n1;
+            
+            this->initialize_direct_strain_operator(qp, *_fe, Bmat_mem);
+            
+            // membrane strain
+            Bmat_mem.vector_mult_transpose(vec3_n2, vec1_n1);
             local_f += JxW[qp] * vec3_n2;
             
-            // von Karman strain
-            if (if_vk) {
-                // get the vonKarman strain operator if needed
-                this->initialize_von_karman_strain_operator(qp,
-                                                            *_fe,
-                                                            vec2_n1, // epsilon_vk
-                                                            vk_dvdxi_mat,
-                                                            vk_dwdxi_mat,
-                                                            Bmat_v_vk,
-                                                            Bmat_w_vk);
-                // von Karman strain: v-displacement
-                vec4_2 = vk_dvdxi_mat.transpose() * vec1_n1;
-                Bmat_v_vk.vector_mult_transpose(vec3_n2, vec4_2);
-                local_f += JxW[qp] * vec3_n2;
-                
-                // von Karman strain: w-displacement
-                vec4_2 = vk_dwdxi_mat.transpose() * vec1_n1;
-                Bmat_w_vk.vector_mult_transpose(vec3_n2, vec4_2);
+            if (if_bending) {
+                // bending strain
+                _bending_operator->initialize_bending_strain_operator(*_fe, qp, Bmat_bend);
+                Bmat_bend.vector_mult_transpose(vec3_n2, vec2_n1);
                 local_f += JxW[qp] * vec3_n2;
             }
+        }
+        
+        stress(0,0) = vec1_n1(0); // sigma_xx
+        
+        if (if_bending && if_vk) {
             
-            if (request_jacobian && if_vk) { // Jacobian only for vk strain
+            // get the vonKarman strain operator if needed
+            this->initialize_von_karman_strain_operator(qp,
+                                                        *_fe,
+                                                        vec2_n1, // epsilon_vk
+                                                        vk_dvdxi_mat,
+                                                        vk_dwdxi_mat,
+                                                        Bmat_v_vk,
+                                                        Bmat_w_vk);
+            // von Karman strain: v-displacement
+            vec4_2 = vk_dvdxi_mat.transpose() * vec1_n1;
+            Bmat_v_vk.vector_mult_transpose(vec3_n2, vec4_2);
+            local_vk_f += JxW[qp] * vec3_n2;
+            
+            // von Karman strain: w-displacement
+            vec4_2 = vk_dwdxi_mat.transpose() * vec1_n1;
+            Bmat_w_vk.vector_mult_transpose(vec3_n2, vec4_2);
+            local_vk_f += JxW[qp] * vec3_n2;
+            
+            if (request_jacobian) { // Jacobian only for vk strain
                 
                 // vk - vk: v-displacement
                 mat3 = RealMatrixX::Zero(2, n2);
@@ -1998,8 +2420,25 @@ MAST::StructuralElement1D::thermal_residual (bool request_jacobian,
     
     
     // now transform to the global coorodinate system
-    transform_vector_to_global_system(local_f, vec3_n2);
-    f -= vec3_n2;
+    if (if_cached)
+        f -= data->f;
+    else {
+        
+        transform_vector_to_global_system(local_f, vec3_n2);
+        f -= vec3_n2;
+        
+        if (data) {
+            data->f     = vec3_n2;
+            data->time  = _time;
+            data->valid = true;
+        }
+    }
+    
+    if (if_bending && if_vk) {
+        transform_vector_to_global_system(local_vk_f, vec3_n2);
+        f -= vec3_n2;
+    }
+    
     if (request_jacobian && if_vk) {
         transform_matrix_to_global_system(local_jac, mat2_n2n2);
         jac -= mat2_n2n2;
@@ -2073,7 +2512,7 @@ MAST::StructuralElement1D::thermal_residual_sensitivity (bool request_jacobian,
     
     for (unsigned int qp=0; qp<JxW.size(); qp++) {
         
-        this->local_elem().global_coordinates_location(xyz[qp], pt);
+        this->_global_qp_location(*_fe, qp, pt);
         
         // get the material property
         (*expansion_A)(pt, _time, material_exp_A_mat);
@@ -2179,6 +2618,8 @@ piston_theory_residual(bool request_jacobian,
                        RealMatrixX& jac,
                        MAST::BoundaryConditionBase& bc) {
     
+    MAST_LOG_SCOPE("piston_theory_residual()", "StructuralElement1D");
+    
     libmesh_assert(!follower_forces); // not implemented yet for follower forces
     
     
@@ -106,6 +106,56 @@ namespace MAST {
     protected:
         
         
+        /*!
+         *    adds the internal residual and Jacobian computed with
+         *    _closed_form_linear_stiffness() to \p f and \p jac, if this is
+         *    applicable to the element. This is the case for a linear
+         *    strain EDGE2 element with first order Lagrange shape functions
+         *    and Bernoulli or Timoshenko bending, for which the section
+         *    stiffness matrices \p A, \p B, \p D and, for Timoshenko
+         *    bending, the transverse shear stiffness do not depend on
+         *    location or time. The sensitivity with respect to \p p is
+         *    computed if \p p is provided. @returns false if the closed
+         *    form is not applicable, in which case nothing is computed.
+         */
+        bool
+        _closed_form_internal_residual(bool request_jacobian,
+                                       RealVectorX& f,
+                                       RealMatrixX& jac,
+                                       const MAST::FieldFunction<RealMatrixX>& A,
+                                       const MAST::FieldFunction<RealMatrixX>& B,
+                                       const MAST::FieldFunction<RealMatrixX>& D,
+                                       const MAST::FunctionBase* p);
+        
+        
+        /*!
+         *    computes the linear stiffness matrix of the element in the
+         *    local coordinate system in \p k from the constant section
+         *    stiffness matrices, without a quadrature loop. The strain
+         *    operators of the element are linear in the element
+         *    coordinate \f$ \xi \f$, \f$ [E] = [E_0] + \xi [E_1] \f$,
+         *    so that the stiffness only needs the moments
+         *    \f$ \int \xi^k dx, k=0,1,2 \f$ of the quadrature rule, which
+         *    gives the same matrix as the quadrature loop. \p G is the
+         *    transverse shear stiffness, which is used only for Timoshenko
+         *    bending with the moments of its reduced quadrature rule.
+         */
+        void
+        _closed_form_linear_stiffness(const RealMatrixX& A,
+                                      const RealMatrixX& B,
+                                      const RealMatrixX& D,
+                                      const RealMatrixX* G,
+                                      RealMatrixX& k);
+        
+        
+        /*!
+         *    computes the mass matrix of the shape functions of an EDGE2
+         *    element with first order Lagrange shape functions in closed
+         *    form, and uses the quadrature rule otherwise.
+         */
+        virtual void _shape_function_mass_matrix(RealMatrixX& m);
+        
+        
         /*!
          *    Calculates the force vector and Jacobian due to surface pressure.
          */
@@ -291,7 +341,9 @@ namespace MAST {
         /*!
          *   performs integration at the quadrature point for the provided
          *   matrices. The temperature vector and matrix entities are provided for
-         *   integration
+         *   integration. If \p if_vk_only is \p true, only the terms that
+         *   depend on the von Karman strain are computed, which are added
+         *   to the linear stiffness retained by the element.
          */
         virtual void _internal_residual_operation(bool if_bending,
                                                   bool if_vk,
@@ -321,7 +373,8 @@ namespace MAST {
                                                   RealMatrixX& mat1_n1n2,
                                                   RealMatrixX& mat2_n2n2,
                                                   RealMatrixX& mat3,
-                                                  RealMatrixX& mat4_2n2);
+                                                  RealMatrixX& mat4_2n2,
+                                                  bool if_vk_only = false);
         
         
         /*!
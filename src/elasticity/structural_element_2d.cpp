@@ -21,6 +21,7 @@
 #include "elasticity/structural_element_2d.h"
 #include "property_cards/element_property_card_2D.h"
 #include "numerics/fem_operator_matrix.h"
+#include "numerics/element_workspace.h"
 #include "mesh/local_elem_base.h"
 #include "elasticity/piston_theory_boundary_condition.h"
 #include "elasticity/stress_output_base.h"
@@ -30,6 +31,7 @@
 #include "base/boundary_condition_base.h"
 #include "base/parameter.h"
 #include "base/constant_field_function.h"
+#include "base/performance_log.h"
 
 
 
@@ -51,6 +53,96 @@ MAST::BendingStructuralElem(sys, elem, p) {
 
 
 
+MAST::StructuralElement2D::~StructuralElement2D() {
+    
+    this->clear_geometry_cache();
+}
+
+
+
+void
+MAST::StructuralElement2D::clear_geometry_cache() {
+    
+    MAST::StructuralElementBase::clear_geometry_cache();
+    
+    for (unsigned int i=0; i<_qp_Bmat_mem.size(); i++)
+        if (_qp_Bmat_mem[i]) delete _qp_Bmat_mem[i];
+    
+    for (unsigned int i=0; i<_qp_Bmat_bend.size(); i++)
+        if (_qp_Bmat_bend[i]) delete _qp_Bmat_bend[i];
+    
+    _qp_Bmat_mem.clear();
+    _qp_Bmat_bend.clear();
+}
+
+
+
+const MAST::FEMOperatorMatrix&
+MAST::StructuralElement2D::
+_direct_strain_operator(const unsigned int qp,
+                        const libMesh::FEBase& fe,
+                        MAST::FEMOperatorMatrix& Bmat) {
+    
+    if (!_use_geometry_cache(fe)) {
+        
+        this->initialize_direct_strain_operator(qp, fe, Bmat);
+        return Bmat;
+    }
+    
+    const unsigned int
+    n_qp  = (unsigned int)fe.get_JxW().size(),
+    n_phi = (unsigned int)fe.get_phi().size();
+    
+    if (_qp_Bmat_mem.size() != n_qp)
+        _qp_Bmat_mem.resize(n_qp, nullptr);
+    
+    if (!_qp_Bmat_mem[qp]) {
+        
+        // the operator has the same dimensions as the one provided
+        MAST::FEMOperatorMatrix* B = new MAST::FEMOperatorMatrix;
+        B->reinit(Bmat.m(), Bmat.n()/n_phi, n_phi);
+        this->initialize_direct_strain_operator(qp, fe, *B);
+        _qp_Bmat_mem[qp] = B;
+    }
+    
+    return *_qp_Bmat_mem[qp];
+}
+
+
+
+const MAST::FEMOperatorMatrix&
+MAST::StructuralElement2D::
+_bending_strain_operator(const unsigned int qp,
+                         const libMesh::FEBase& fe,
+                         MAST::FEMOperatorMatrix& Bmat) {
+    
+    if (!_use_geometry_cache(fe)) {
+        
+        _bending_operator->initialize_bending_strain_operator(fe, qp, Bmat);
+        return Bmat;
+    }
+    
+    const unsigned int
+    n_qp  = (unsigned int)fe.get_JxW().size(),
+    n_phi = (unsigned int)fe.get_phi().size();
+    
+    if (_qp_Bmat_bend.size() != n_qp)
+        _qp_Bmat_bend.resize(n_qp, nullptr);
+    
+    if (!_qp_Bmat_bend[qp]) {
+        
+        // the operator has the same dimensions as the one provided
+        MAST::FEMOperatorMatrix* B = new MAST::FEMOperatorMatrix;
+        B->reinit(Bmat.m(), Bmat.n()/n_phi, n_phi);
+        _bending_operator->initialize_bending_strain_operator(fe, qp, *B);
+        _qp_Bmat_bend[qp] = B;
+    }
+    
+    return *_qp_Bmat_bend[qp];
+}
+
+
+
 void
 MAST::StructuralElement2D::
 initialize_direct_strain_operator(const unsigned int qp,
@@ -297,6 +389,15 @@ MAST::StructuralElement2D::calculate_stress(bool request_derivative,
     MAST::StressStrainOutputBase& stress_output =
     dynamic_cast<MAST::StressStrainOutputBase&>(output);
     
+    // the sensitivity is evaluated only for the parameters requested by
+    // the output, and the derivative wrt the state vector is needed for
+    // the sensitivity only if the solution sensitivity is non-zero.
+    const bool
+    if_sens = (request_sensitivity &&
+               stress_output.if_evaluate_sensitivity(*sensitivity_param)),
+    if_dX   = (request_derivative ||
+               (if_sens && (_local_sol_sens.array() != 0.).any()));
+    
     // check to see if the element has any thermal loads specified
     // The object returns null
     MAST::BoundaryConditionBase *thermal_load =
@@ -388,7 +489,7 @@ MAST::StructuralElement2D::calculate_stress(bool request_derivative,
         strain_3D(3) = strain(2);  // gamma-xy
         
         // set the stress and strain data
-        MAST::StressStrainOutputBase::Data&
+        MAST::StressStrainOutputBase::Data
         data = stress_output.add_stress_strain_at_qp_location(&_elem,
                                                               qp_loc[qp],
                                                               xyz[qp],
@@ -397,40 +498,43 @@ MAST::StructuralElement2D::calculate_stress(bool request_derivative,
                                                               JxW[qp]);
         
         // calculate the derivative if requested
-        if (request_derivative || request_sensitivity) {
+        if (if_dX || if_sens) {
             
-            Bmat_mem.left_multiply(dstrain_dX, eye);  // membrane strain is linear
+            if (if_dX) {
+                
+                Bmat_mem.left_multiply(dstrain_dX, eye);  // membrane strain is linear
             
-            if (if_bending) {
+                if (if_bending) {
                 
-                // von Karman strain
-                if (if_vk) {
+                    // von Karman strain
+                    if (if_vk) {
                     
-                    Bmat_vk.left_multiply(mat_n1n2, vk_dwdxi_mat);
-                    dstrain_dX   +=  mat_n1n2;
-                }
+                        Bmat_vk.left_multiply(mat_n1n2, vk_dwdxi_mat);
+                        dstrain_dX   +=  mat_n1n2;
+                    }
                 
-                // bending strain
-                Bmat_bend.left_multiply(mat_n1n2, eye);
-                dstrain_dX  +=   mat_n1n2;
-            }
+                    // bending strain
+                    Bmat_bend.left_multiply(mat_n1n2, eye);
+                    dstrain_dX  +=   mat_n1n2;
+                }
             
-            // note: this assumes linear material laws
-            dstress_dX  = material_mat * dstrain_dX;
+                // note: this assumes linear material laws
+                dstress_dX  = material_mat * dstrain_dX;
             
-            // copy to the 3D structure
-            dstress_dX_3D.row(0) = dstress_dX.row(0);  // sigma-xx
-            dstress_dX_3D.row(1) = dstress_dX.row(1);  // sigma-yy
-            dstress_dX_3D.row(3) = dstress_dX.row(2);  // tau-xy
-            dstrain_dX_3D.row(0) = dstrain_dX.row(0);  // epsilon-xx
-            dstrain_dX_3D.row(1) = dstrain_dX.row(1);  // epsilon-yy
-            dstrain_dX_3D.row(3) = dstrain_dX.row(2);  // gamma-xy
+                // copy to the 3D structure
+                dstress_dX_3D.row(0) = dstress_dX.row(0);  // sigma-xx
+                dstress_dX_3D.row(1) = dstress_dX.row(1);  // sigma-yy
+                dstress_dX_3D.row(3) = dstress_dX.row(2);  // tau-xy
+                dstrain_dX_3D.row(0) = dstrain_dX.row(0);  // epsilon-xx
+                dstrain_dX_3D.row(1) = dstrain_dX.row(1);  // epsilon-yy
+                dstrain_dX_3D.row(3) = dstrain_dX.row(2);  // gamma-xy
             
-            if (request_derivative)
-                data.set_derivatives(dstress_dX_3D, dstrain_dX_3D);
+                if (request_derivative)
+                    data.set_derivatives(dstress_dX_3D, dstrain_dX_3D);
+            }
             
             
-            if (request_sensitivity) {
+            if (if_sens) {
                 // sensitivity of the response, s, is
                 //   ds/dp   = partial s/partial p  +
                 //             partial s/partial X   dX/dp
@@ -502,8 +606,10 @@ MAST::StructuralElement2D::calculate_stress(bool request_derivative,
                 // use the derivative data to evaluate the second term in the
                 // sensitivity
                 //
-                dstress_dp  += dstress_dX * _local_sol_sens;
-                dstrain_dp  += dstrain_dX * _local_sol_sens;
+                if (if_dX) {
+                    dstress_dp  += dstress_dX * _local_sol_sens;
+                    dstrain_dp  += dstrain_dX * _local_sol_sens;
+                }
                 
                 // copy the 3D object
                 stress_3D(0) = dstress_dp(0);  // sigma-xx
@@ -537,6 +643,62 @@ bool
 MAST::StructuralElement2D::internal_residual (bool request_jacobian,
                                               RealVectorX& f,
                                               RealMatrixX& jac)
+{
+    MAST_LOG_SCOPE("internal_residual()", "StructuralElement2D");
+    
+    // jac_xdot is not used without the piston theory load
+    return _internal_residual(request_jacobian, f, jac, jac, nullptr);
+}
+
+
+
+
+bool
+MAST::StructuralElement2D::
+internal_and_volume_external_residual
+(bool request_jacobian,
+ RealVectorX& f,
+ RealMatrixX& jac_xdot,
+ RealMatrixX& jac,
+ std::multimap<libMesh::subdomain_id_type, MAST::BoundaryConditionBase*>& bc) {
+    
+    // look for the piston theory load on the subdomain of this element
+    std::pair<std::multimap<libMesh::subdomain_id_type, MAST::BoundaryConditionBase*>::const_iterator,
+    std::multimap<libMesh::subdomain_id_type, MAST::BoundaryConditionBase*>::const_iterator> it;
+    
+    it = bc.equal_range(_elem.subdomain_id());
+    
+    const MAST::PistonTheoryBoundaryCondition* piston_bc = nullptr;
+    unsigned int n_piston = 0;
+    
+    for ( ; it.first != it.second; it.first++)
+        if (it.first->second->type() == MAST::PISTON_THEORY) {
+            piston_bc = dynamic_cast<MAST::PistonTheoryBoundaryCondition*>(it.first->second);
+            n_piston++;
+        }
+    
+    if (!piston_bc || n_piston > 1 || follower_forces)
+        return MAST::StructuralElementBase::internal_and_volume_external_residual
+        (request_jacobian, f, jac_xdot, jac, bc);
+    
+    MAST_LOG_SCOPE("internal_and_piston_theory_residual()", "StructuralElement2D");
+    
+    _internal_residual(request_jacobian, f, jac_xdot, jac, piston_bc);
+    this->volume_external_residual(request_jacobian, f, jac_xdot, jac, bc, false);
+    
+    return request_jacobian;
+}
+
+
+
+
+bool
+MAST::StructuralElement2D::
+_internal_residual(bool request_jacobian,
+                   RealVectorX& f,
+                   RealMatrixX& jac_xdot,
+                   RealMatrixX& jac,
+                   const MAST::PistonTheoryBoundaryCondition* piston_bc)
 {
     const std::vector<Real>& JxW           = _fe->get_JxW();
     const std::vector<libMesh::Point>& xyz = _fe->get_xyz();
@@ -547,31 +709,35 @@ MAST::StructuralElement2D::internal_residual (bool request_jacobian,
     n2       =6*n_phi,
     n3       = this->n_von_karman_strain_components();
     
+    // the temporaries are taken from the workspace of the thread, which
+    // retains their memory from the previous elements
+    MAST::ElementWorkspace::Scope ws(MAST::ElementWorkspace::local());
+    
     RealMatrixX
-    material_A_mat,
-    material_B_mat,
-    material_D_mat,
-    mat1_n1n2     = RealMatrixX::Zero(n1,n2),
-    mat2_n2n2     = RealMatrixX::Zero(n2,n2),
-    mat3,
-    mat4_n3n2     = RealMatrixX::Zero(n3,n2),
-    vk_dwdxi_mat  = RealMatrixX::Zero(n1,n3),
-    stress        = RealMatrixX::Zero(2,2),
-    stress_l      = RealMatrixX::Zero(2,2),
-    local_jac     = RealMatrixX::Zero(n2,n2);
+    &material_A_mat = ws.matrix(),
+    &material_B_mat = ws.matrix(),
+    &material_D_mat = ws.matrix(),
+    &mat1_n1n2      = ws.matrix(n1,n2),
+    &mat2_n2n2      = ws.matrix(n2,n2),
+    &mat3           = ws.matrix(),
+    &mat4_n3n2      = ws.matrix(n3,n2),
+    &vk_dwdxi_mat   = ws.matrix(n1,n3),
+    &stress         = ws.matrix(2,2),
+    &stress_l       = ws.matrix(2,2),
+    &local_jac      = ws.matrix(n2,n2);
 
     RealVectorX
-    vec1_n1    = RealVectorX::Zero(n1),
-    vec2_n1    = RealVectorX::Zero(n1),
-    vec3_n2    = RealVectorX::Zero(n2),
-    vec4_n3    = RealVectorX::Zero(n3),
-    vec5_n3    = RealVectorX::Zero(n3),
-    local_f    = RealVectorX::Zero(n2);
+    &vec1_n1    = ws.vector(n1),
+    &vec2_n1    = ws.vector(n1),
+    &vec3_n2    = ws.vector(n2),
+    &vec4_n3    = ws.vector(n3),
+    &vec5_n3    = ws.vector(n3),
+    &local_f    = ws.vector(n2);
     
-    local_f.setZero();
-    local_jac.setZero();
-    
-    FEMOperatorMatrix Bmat_mem, Bmat_bend, Bmat_vk;
+    MAST::FEMOperatorMatrix
+    &Bmat_mem   = ws.fem_operator(),
+    &Bmat_bend  = ws.fem_operator(),
+    &Bmat_vk    = ws.fem_operator();
     
     Bmat_mem.reinit(n1, _system.n_vars(), n_phi); // three stress-strain components
     Bmat_bend.reinit(n1, _system.n_vars(), n_phi);
@@ -585,19 +751,103 @@ MAST::StructuralElement2D::internal_residual (bool request_jacobian,
     mat_stiff_B  = _property.stiffness_B_matrix(*this),
     mat_stiff_D  = _property.stiffness_D_matrix(*this);
     
+    // section properties that are independent of location and time are
+    // evaluated only at the first quadrature point
+    const bool
+    const_A  = mat_stiff_A->is_constant(),
+    const_B  = mat_stiff_B->is_constant(),
+    const_D  = mat_stiff_D->is_constant();
     
     libMesh::Point p;
     
+    // if the element retains its linear stiffness, then only the von
+    // Karman terms are computed at the quadrature points. The linear
+    // stiffness is computed here on the first call.
+    MAST::LinearStiffnessData*
+    lin = (if_vk && if_bending)? this->_linear_stiffness_data(): nullptr;
+    
+    if (lin && !lin->valid) {
+        
+        RealVectorX
+        &lin_f = ws.vector(n2);
+        
+        lin->jac.setZero(n2, n2);
+        
+        for (unsigned int qp=0; qp<JxW.size(); qp++) {
+            
+            this->_global_qp_location(*_fe, qp, p);
+            
+            if (qp == 0 || !const_A)
+                (*mat_stiff_A)(p, _time, material_A_mat);
+            if (qp == 0 || !const_B)
+                (*mat_stiff_B)(p, _time, material_B_mat);
+            if (qp == 0 || !const_D)
+                (*mat_stiff_D)(p, _time, material_D_mat);
+            
+            _internal_residual_operation(if_bending, false, n2, qp, *_fe, JxW,
+                                         true,
+                                         lin_f, lin->jac,
+                                         Bmat_mem, Bmat_bend, Bmat_vk,
+                                         stress, stress_l, vk_dwdxi_mat, material_A_mat,
+                                         material_B_mat, material_D_mat, vec1_n1,
+                                         vec2_n1, vec3_n2, vec4_n3,
+                                         vec5_n3, mat1_n1n2, mat2_n2n2,
+                                         mat3, mat4_n3n2);
+        }
+        
+        if (_bending_operator->include_transverse_shear_energy())
+            _bending_operator->calculate_transverse_shear_residual(true,
+                                                                   lin_f,
+                                                                   lin->jac,
+                                                                   nullptr);
+        
+        lin->valid = true;
+        lin->time  = _time;
+    }
+    
+    // the piston theory pressure functions take the w-slope and velocity
+    // from constant field functions that are updated at each
+    // quadrature point
+    MAST::Parameter
+    dwdx_p  ("dwdx", 0.),
+    dwdt_p  ("dwdt", 0.);
+    
+    MAST::ConstantFieldFunction
+    dwdx_f  ("dwdx", dwdx_p),
+    dwdt_f  ("dwdt", dwdt_p);
+    
+    std::auto_ptr<MAST::FieldFunction<Real> >
+    pressure, dpressure_dx, dpressure_dxdot;
+    
+    RealVectorX
+    &vel_vec        = ws.vector(3);
+    
+    RealMatrixX
+    &local_jac_xdot = ws.matrix(piston_bc?n2:0, piston_bc?n2:0);
+    
+    if (piston_bc) {
+        
+        pressure.reset(piston_bc->get_pressure_function(dwdx_f, dwdt_f).release());
+        dpressure_dx.reset(piston_bc->get_dpdx_function(dwdx_f, dwdt_f).release());
+        dpressure_dxdot.reset(piston_bc->get_dpdxdot_function(dwdx_f, dwdt_f).release());
+        
+        // velocity vector in the local coordinate system
+        vel_vec = this->local_elem().T_matrix().transpose() * piston_bc->vel_vec();
+    }
+    
     for (unsigned int qp=0; qp<JxW.size(); qp++) {
-                
-        this->local_elem().global_coordinates_location(xyz[qp], p);
+        
+        this->_global_qp_location(*_fe, qp, p);
         
         // get the material matrix
-        (*mat_stiff_A)(p, _time, material_A_mat);
+        if (qp == 0 || !const_A)
+            (*mat_stiff_A)(p, _time, material_A_mat);
         
         if (if_bending) {
-            (*mat_stiff_B)(p, _time, material_B_mat);
-            (*mat_stiff_D)(p, _time, material_D_mat);
+            if (qp == 0 || !const_B)
+                (*mat_stiff_B)(p, _time, material_B_mat);
+            if (!lin && (qp == 0 || !const_D))
+                (*mat_stiff_D)(p, _time, material_D_mat);
         }
         
         // now calculte the quantity for these matrices
@@ -609,20 +859,39 @@ MAST::StructuralElement2D::internal_residual (bool request_jacobian,
                                      material_B_mat, material_D_mat, vec1_n1,
                                      vec2_n1, vec3_n2, vec4_n3,
                                      vec5_n3, mat1_n1n2, mat2_n2n2,
-                                     mat3, mat4_n3n2);
-        
+                                     mat3, mat4_n3n2,
+                                     lin != nullptr);
+        
+        if (piston_bc)
+            _piston_theory_residual_operation(qp, *_fe, JxW, p, vel_vec,
+                                              dwdx_p, dwdt_p,
+                                              *pressure,
+                                              *dpressure_dx,
+                                              *dpressure_dxdot,
+                                              request_jacobian,
+                                              local_f,
+                                              local_jac_xdot,
+                                              local_jac);
     }
     
     
     // now calculate the transverse shear contribution if appropriate for the
     // element
-    if (if_bending &&
+    if (!lin &&
+        if_bending &&
         _bending_operator->include_transverse_shear_energy())
         _bending_operator->calculate_transverse_shear_residual(request_jacobian,
                                                                local_f,
                                                                local_jac,
                                                                nullptr);
     
+    // add the retained linear stiffness
+    if (lin) {
+        local_f += lin->jac * _local_sol;
+        if (request_jacobian)
+            local_jac += lin->jac;
+    }
+    
     
     // now transform to the global coorodinate system
     transform_vector_to_global_system(local_f, vec3_n2);
@@ -637,6 +906,11 @@ MAST::StructuralElement2D::internal_residual (bool request_jacobian,
         }
         transform_matrix_to_global_system(local_jac, mat2_n2n2);
         jac += mat2_n2n2;
+        
+        if (piston_bc) {
+            transform_matrix_to_global_system(local_jac_xdot, mat2_n2n2);
+            jac_xdot += mat2_n2n2;
+        }
     }
     
     return request_jacobian;
@@ -715,7 +989,7 @@ MAST::StructuralElement2D::internal_residual_sensitivity (bool request_jacobian,
     // first calculate the sensitivity due to the parameter
     for (unsigned int qp=0; qp<JxW.size(); qp++) {
         
-        this->local_elem().global_coordinates_location(xyz[qp], p);
+        this->_global_qp_location(*_fe, qp, p);
         
         // get the material matrix
         mat_stiff_A->derivative(*this->sensitivity_param,
@@ -787,6 +1061,145 @@ MAST::StructuralElement2D::internal_residual_sensitivity (bool request_jacobian,
 
 
 
+void
+MAST::StructuralElement2D::
+internal_residual_sensitivities(const std::vector<const MAST::FunctionBase*>& params,
+                                bool request_jacobian,
+                                std::vector<RealVectorX>& f,
+                                std::vector<RealMatrixX>& jac)
+{
+    libmesh_assert_equal_to(f.size(),   params.size());
+    libmesh_assert_equal_to(jac.size(), params.size());
+    
+    // parameters that the section properties depend on
+    std::vector<unsigned int> dep;
+    
+    for (unsigned int i=0; i<params.size(); i++) {
+        
+        libmesh_assert(!params[i]->is_shape_parameter()); // this is not implemented for now
+        if (_property.depends_on(*params[i]))
+            dep.push_back(i);
+    }
+    
+    // nothing to be calculated if the element does not depend on the
+    // sensitivity parameters
+    if (!dep.size())
+        return;
+    
+    MAST_LOG_SCOPE("internal_residual_sensitivities()", "StructuralElement2D");
+    
+    const std::vector<Real>& JxW = _fe->get_JxW();
+    
+    const unsigned int
+    n_phi    = (unsigned int)_fe->get_phi().size(),
+    n1       = this->n_direct_strain_components(),
+    n2       =6*n_phi,
+    n3       = this->n_von_karman_strain_components(),
+    n_dep    = (unsigned int)dep.size();
+    
+    MAST::ElementWorkspace::Scope ws(MAST::ElementWorkspace::local());
+    
+    RealMatrixX
+    &material_A_mat = ws.matrix(),
+    &material_B_mat = ws.matrix(),
+    &material_D_mat = ws.matrix(),
+    &mat1_n1n2      = ws.matrix(n1,n2),
+    &mat2_n2n2      = ws.matrix(n2,n2),
+    &mat3           = ws.matrix(),
+    &mat4_n3n2      = ws.matrix(n3,n2),
+    &vk_dwdxi_mat   = ws.matrix(n1,n3),
+    &stress         = ws.matrix(2,2),
+    &stress_l       = ws.matrix(2,2);
+    
+    RealVectorX
+    &vec1_n1    = ws.vector(n1),
+    &vec2_n1    = ws.vector(n1),
+    &vec3_n2    = ws.vector(n2),
+    &vec4_n3    = ws.vector(n3),
+    &vec5_n3    = ws.vector(n3);
+    
+    // local quantities of each parameter
+    std::vector<RealVectorX>
+    local_f  (n_dep, RealVectorX::Zero(n2));
+    std::vector<RealMatrixX>
+    local_jac(n_dep, RealMatrixX::Zero(request_jacobian?n2:0,
+                                       request_jacobian?n2:0));
+    
+    MAST::FEMOperatorMatrix
+    &Bmat_mem   = ws.fem_operator(),
+    &Bmat_bend  = ws.fem_operator(),
+    &Bmat_vk    = ws.fem_operator();
+    
+    Bmat_mem.reinit(n1, _system.n_vars(), n_phi); // three stress-strain components
+    Bmat_bend.reinit(n1, _system.n_vars(), n_phi);
+    Bmat_vk.reinit(n3, _system.n_vars(), n_phi); // only dw/dx and dw/dy
+    
+    bool if_vk = (_property.strain_type() == MAST::VON_KARMAN_STRAIN),
+    if_bending = (_property.bending_model(_elem, _fe->get_fe_type()) != MAST::NO_BENDING);
+    
+    std::auto_ptr<MAST::FieldFunction<RealMatrixX > >
+    mat_stiff_A = _property.stiffness_A_matrix(*this),
+    mat_stiff_B = _property.stiffness_B_matrix(*this),
+    mat_stiff_D = _property.stiffness_D_matrix(*this);
+    
+    libMesh::Point p;
+    
+    // the quadrature point location and the strain operators are shared
+    // by all parameters
+    for (unsigned int qp=0; qp<JxW.size(); qp++) {
+        
+        this->_global_qp_location(*_fe, qp, p);
+        
+        for (unsigned int k=0; k<n_dep; k++) {
+            
+            const MAST::FunctionBase& f_p = *params[dep[k]];
+            
+            mat_stiff_A->derivative(f_p, p, _time, material_A_mat);
+            
+            if (if_bending) {
+                
+                mat_stiff_B->derivative(f_p, p, _time, material_B_mat);
+                mat_stiff_D->derivative(f_p, p, _time, material_D_mat);
+            }
+            
+            _internal_residual_operation(if_bending, if_vk, n2, qp, *_fe, JxW,
+                                         request_jacobian,
+                                         local_f[k], local_jac[k],
+                                         Bmat_mem, Bmat_bend, Bmat_vk,
+                                         stress, stress_l, vk_dwdxi_mat, material_A_mat,
+                                         material_B_mat, material_D_mat, vec1_n1,
+                                         vec2_n1, vec3_n2, vec4_n3,
+                                         vec5_n3, mat1_n1n2, mat2_n2n2,
+                                         mat3, mat4_n3n2);
+        }
+    }
+    
+    for (unsigned int k=0; k<n_dep; k++) {
+        
+        const unsigned int i = dep[k];
+        
+        // now calculate the transverse shear contribution if appropriate
+        // for the element
+        if (if_bending && _bending_operator->include_transverse_shear_energy())
+            _bending_operator->calculate_transverse_shear_residual(request_jacobian,
+                                                                   local_f[k],
+                                                                   local_jac[k],
+                                                                   params[i]);
+        
+        // now transform to the global coorodinate system
+        transform_vector_to_global_system(local_f[k], vec3_n2);
+        f[i] += vec3_n2;
+        
+        if (request_jacobian) {
+            transform_matrix_to_global_system(local_jac[k], mat2_n2n2);
+            jac[i] += mat2_n2n2;
+        }
+    }
+}
+
+
+
+
 bool
 MAST::StructuralElement2D::
 internal_residual_jac_dot_state_sensitivity (RealMatrixX& jac) {
@@ -839,7 +1252,7 @@ internal_residual_jac_dot_state_sensitivity (RealMatrixX& jac) {
     
     for (unsigned int qp=0; qp<JxW.size(); qp++) {
         
-        this->local_elem().global_coordinates_location(xyz[qp], p);
+        this->_global_qp_location(*_fe, qp, p);
         
         // get the material matrix
         (*mat_stiff_A)(p, _time, material_A_mat);
@@ -961,8 +1374,8 @@ MAST::StructuralElement2D::_internal_residual_operation
  bool request_jacobian,
  RealVectorX& local_f,
  RealMatrixX& local_jac,
- FEMOperatorMatrix& Bmat_mem,
- FEMOperatorMatrix& Bmat_bend,
+ FEMOperatorMatrix& Bmat_mem_in,
+ FEMOperatorMatrix& Bmat_bend_in,
  FEMOperatorMatrix& Bmat_vk,
  RealMatrixX& stress,
  RealMatrixX& stress_l,
@@ -978,9 +1391,16 @@ MAST::StructuralElement2D::_internal_residual_operation
  RealMatrixX& mat1_n1n2,
  RealMatrixX& mat2_n2n2,
  RealMatrixX& mat3,
- RealMatrixX& mat4_2n2)
+ RealMatrixX& mat4_2n2,
+ bool if_vk_only)
 {
-    this->initialize_direct_strain_operator(qp, fe, Bmat_mem);
+    // the strain operators only depend on the element geometry, and are
+    // reused from prior calculations if the element stores them
+    const MAST::FEMOperatorMatrix
+    &Bmat_mem  = this->_direct_strain_operator(qp, fe, Bmat_mem_in),
+    &Bmat_bend = (if_bending?
+                  this->_bending_strain_operator(qp, fe, Bmat_bend_in):
+                  Bmat_bend_in);
     
     // first handle constant throught the thickness stresses: membrane and vonKarman
     Bmat_mem.vector_mult(vec1_n1, _local_sol);
@@ -994,11 +1414,15 @@ MAST::StructuralElement2D::_internal_residual_operation
     
     stress = stress_l;
     
+    // the membrane and bending strains are uncoupled for sections with
+    // a zero B matrix, for example symmetric laminates without offset, in
+    // which case the coupling terms are not computed
+    const bool
+    if_coupling = if_bending && !(material_B_mat.array() == 0.).all();
+    
     // get the bending strain operator
     vec2_n1.setZero(); // used to store vk strain, if applicable
-    if (if_bending) {
-        _bending_operator->initialize_bending_strain_operator(fe, qp, Bmat_bend);
-        
+    if (if_coupling) {
         Bmat_bend.vector_mult(vec2_n1, _local_sol);
         vec1_n1 = material_B_mat * vec2_n1;
         stress_l(0,0) += vec1_n1(0); // sigma_xx
@@ -1010,6 +1434,9 @@ MAST::StructuralElement2D::_internal_residual_operation
         stress(0,1) += vec1_n1(2); // sigma_xy
         stress(1,0) += vec1_n1(2); // sigma_yx
         stress(1,1) += vec1_n1(1); // sigma_yy
+    }
+    
+    if (if_bending) {
         
         // set vec2_n1 to zero, because we need to store only the vk-strain
         // in it for the next operation
@@ -1031,19 +1458,29 @@ MAST::StructuralElement2D::_internal_residual_operation
     }
     
     // add the linear and nonlinear direct strains
-    Bmat_mem.vector_mult(vec1_n1, _local_sol);
-    vec2_n1 += vec1_n1;  // epsilon_mem + epsilon_vk
+    if (!if_vk_only) {
+        Bmat_mem.vector_mult(vec1_n1, _local_sol);
+        vec2_n1 += vec1_n1;  // epsilon_mem + epsilon_vk
+    }
 
-    // copy the total integrated stress to the vector
-    vec1_n1(0) = stress(0,0);
-    vec1_n1(1) = stress(1,1);
-    vec1_n1(2) = stress(0,1);
+    // copy the total integrated stress to the vector. Without the linear
+    // terms, only the stress from the von Karman strain is used with
+    // the membrane strain operator
+    vec1_n1(0) = stress(0,0) - (if_vk_only? stress_l(0,0): 0.);
+    vec1_n1(1) = stress(1,1) - (if_vk_only? stress_l(1,1): 0.);
+    vec1_n1(2) = stress(0,1) - (if_vk_only? stress_l(0,1): 0.);
     
     // now the internal force vector
     // this includes the membrane strain operator with all A and B material operators
     Bmat_mem.vector_mult_transpose(vec3_n2, vec1_n1);
     local_f += JxW[qp] * vec3_n2;
     
+    if (if_vk_only) {
+        vec1_n1(0) = stress(0,0);
+        vec1_n1(1) = stress(1,1);
+        vec1_n1(2) = stress(0,1);
+    }
+    
     
     if (if_bending) {
         if (if_vk) {
@@ -1055,22 +1492,25 @@ MAST::StructuralElement2D::_internal_residual_operation
         
         // now coupling with the bending strain
         // B_bend^T [B] B_mem
-        vec1_n1 = material_B_mat.transpose() * vec2_n1;
-        Bmat_bend.vector_mult_transpose(vec3_n2, vec1_n1);
-        local_f += JxW[qp] * vec3_n2;
+        if (if_coupling) {
+            vec1_n1 = material_B_mat.transpose() * vec2_n1;
+            Bmat_bend.vector_mult_transpose(vec3_n2, vec1_n1);
+            local_f += JxW[qp] * vec3_n2;
+        }
         
         // now bending stress
-        Bmat_bend.vector_mult(vec2_n1, _local_sol);
-        vec1_n1 = material_D_mat * vec2_n1;
-        Bmat_bend.vector_mult_transpose(vec3_n2, vec1_n1);
-        local_f += JxW[qp] * vec3_n2;
+        if (!if_vk_only) {
+            Bmat_bend.vector_mult(vec2_n1, _local_sol);
+            vec1_n1 = material_D_mat * vec2_n1;
+            Bmat_bend.vector_mult_transpose(vec3_n2, vec1_n1);
+            local_f += JxW[qp] * vec3_n2;
+        }
     }
     
     if (request_jacobian) {
         // membrane - membrane
-        Bmat_mem.left_multiply(mat1_n1n2, material_A_mat);
-        Bmat_mem.right_multiply_transpose(mat2_n2n2, mat1_n1n2);
-        local_jac += JxW[qp] * mat2_n2n2;
+        if (!if_vk_only)
+            Bmat_mem.add_transpose_product(local_jac, JxW[qp], material_A_mat, Bmat_mem);
         
         if (if_bending) {
             if (if_vk) {
@@ -1126,21 +1566,19 @@ MAST::StructuralElement2D::_internal_residual_operation
                 local_jac += JxW[qp] * mat2_n2n2;
             }
             
-            // bending - membrane
-            mat3 = material_B_mat.transpose();
-            Bmat_mem.left_multiply(mat1_n1n2, mat3);
-            Bmat_bend.right_multiply_transpose(mat2_n2n2, mat1_n1n2);
-            local_jac += JxW[qp] * mat2_n2n2;
-            
-            // membrane - bending
-            Bmat_bend.left_multiply(mat1_n1n2, material_B_mat);
-            Bmat_mem.right_multiply_transpose(mat2_n2n2, mat1_n1n2);
-            local_jac += JxW[qp] * mat2_n2n2;
+            if (if_coupling && !if_vk_only) {
+                
+                // bending - membrane
+                mat3 = material_B_mat.transpose();
+                Bmat_bend.add_transpose_product(local_jac, JxW[qp], mat3, Bmat_mem);
+                
+                // membrane - bending
+                Bmat_mem.add_transpose_product(local_jac, JxW[qp], material_B_mat, Bmat_bend);
+            }
             
             // bending - bending
-            Bmat_bend.left_multiply(mat1_n1n2, material_D_mat);
-            Bmat_bend.right_multiply_transpose(mat2_n2n2, mat1_n1n2);
-            local_jac += JxW[qp] * mat2_n2n2;
+            if (!if_vk_only)
+                Bmat_bend.add_transpose_product(local_jac, JxW[qp], material_D_mat, Bmat_bend);
         }
     }
 }
@@ -1311,7 +1749,7 @@ MAST::StructuralElement2D::prestress_residual (bool request_jacobian,
     // now calculate the quantity
     for (unsigned int qp=0; qp<JxW.size(); qp++) {
         
-        this->local_elem().global_coordinates_location(xyz[qp], p);
+        this->_global_qp_location(*_fe, qp, p);
         
         (*prestress_A)(p, _time, prestress_mat_A);
         (*prestress_B)(p, _time, prestress_mat_B);
@@ -1431,7 +1869,7 @@ MAST::StructuralElement2D::prestress_residual_sensitivity (bool request_jacobian
     // transform to the local coordinate system
     for (unsigned int qp=0; qp<JxW.size(); qp++) {
         
-        this->local_elem().global_coordinates_location(xyz[qp], p);
+        this->_global_qp_location(*_fe, qp, p);
         
         prestress_A->derivative(*this->sensitivity_param,
                                 p,
@@ -1512,6 +1950,8 @@ surface_pressure_residual(bool request_jacobian,
                           const unsigned int side,
                           MAST::BoundaryConditionBase& bc) {
     
+    MAST_LOG_SCOPE("surface_pressure_residual()", "StructuralElement2D");
+    
     libmesh_assert(!follower_forces); // not implemented yet for follower forces
     
     // prepare the side finite element
@@ -1693,6 +2133,8 @@ MAST::StructuralElement2D::thermal_residual (bool request_jacobian,
                                              RealMatrixX& jac,
                                              MAST::BoundaryConditionBase& bc)
 {
+    MAST_LOG_SCOPE("thermal_residual()", "StructuralElement2D");
+    
     FEMOperatorMatrix Bmat_mem, Bmat_bend, Bmat_vk;
     
     const std::vector<Real>& JxW = _fe->get_JxW();
@@ -1717,6 +2159,7 @@ MAST::StructuralElement2D::thermal_residual (bool request_jacobian,
     vec4_2      = RealVectorX::Zero(2),
     vec5_n3     = RealVectorX::Zero(n3),
     local_f     = RealVectorX::Zero(n2),
+    local_vk_f  = RealVectorX::Zero(n2),
     delta_t     = RealVectorX::Zero(1);
     
     local_f.setZero();
@@ -1729,65 +2172,99 @@ MAST::StructuralElement2D::thermal_residual (bool request_jacobian,
     bool if_vk = (_property.strain_type() == MAST::VON_KARMAN_STRAIN),
     if_bending = (_property.bending_model(_elem, _fe->get_fe_type()) != MAST::NO_BENDING);
     
+    // the thermal stress and the load from the membrane and bending
+    // strains do not depend on the solution, and are reused from the
+    // retained data if available
+    MAST::ThermalLoadData*
+    data       = this->_thermal_load_data(bc);
+    const bool
+    if_cached  = data && data->valid;
+    
+    if (if_cached && !(if_bending && if_vk)) {
+        
+        f -= data->f;
+        return request_jacobian;
+    }
+    
     std::auto_ptr<MAST::FieldFunction<RealMatrixX > >
-    expansion_A = _property.thermal_expansion_A_matrix(*this),
-    expansion_B = _property.thermal_expansion_B_matrix(*this);
+    expansion_A,
+    expansion_B;
+    
+    if (!if_cached) {
+        expansion_A = _property.thermal_expansion_A_matrix(*this);
+        expansion_B = _property.thermal_expansion_B_matrix(*this);
+        if (data) data->stress.resize(n1, JxW.size());
+    }
     
     const MAST::FieldFunction<Real>
     &temp_func     = bc.get<MAST::FieldFunction<Real> >("temperature"),
     &ref_temp_func = bc.get<MAST::FieldFunction<Real> >("ref_temperature");
     
+    // temperature from the nodal values of a thermal system on the
+    // same mesh, if available
+    std::vector<Real> qp_temp;
+    const bool
+    if_direct_temp = !if_cached && this->_direct_qp_temperature(temp_func, *_fe, qp_temp);
+    
     Real t, t0;
     libMesh::Point pt;
     
     for (unsigned int qp=0; qp<JxW.size(); qp++) {
         
-        this->local_elem().global_coordinates_location(xyz[qp], pt);
-        
-        // this is moved inside the domain since
-        (*expansion_A)(pt, _time, material_exp_A_mat);
-        (*expansion_B)(pt, _time, material_exp_B_mat);
-        
-        // get the temperature function
-        temp_func(pt, _time, t);
-        ref_temp_func(pt, _time, t0);
-        delta_t(0) = t-t0;
+        if (if_cached)
+            vec1_n1 = data->stress.col(qp);
+        else {
+            
+            this->_global_qp_location(*_fe, qp, pt);
+            
+            // this is moved inside the domain since
+            (*expansion_A)(pt, _time, material_exp_A_mat);
+            (*expansion_B)(pt, _time, material_exp_B_mat);
+            
+            // get the temperature function
+            if (if_direct_temp) t = qp_temp[qp];
+            else temp_func(pt, _time, t);
+            ref_temp_func(pt, _time, t0);
+            delta_t(0) = t-t0;
+            
+            vec1_n1 = material_exp_A_mat * delta_t; // [C]{alpha (T - T0)} (with membrane strain)
+            vec2_n1 = material_exp_B_mat * delta_t; // [C]{alpha (T - T0)} (with bending strain)
+            if (data) data->stress.col(qp) = vec1_n1;
+            
+            this->initialize_direct_strain_operator(qp, *_fe, Bmat_mem);
+            
+            // membrane strain
+            Bmat_mem.vector_mult_transpose(vec3_n2, vec1_n1);
+            local_f += JxW[qp] * vec3_n2;
+            
+            if (if_bending) {
+                // bending strain
+                _bending_operator->initialize_bending_strain_operator(*_fe, qp, Bmat_bend);
+                Bmat_bend.vector_mult_transpose(vec3_n2, vec2_n1);
+                local_f += JxW[qp] * vec3_n2;
+            }
+        }
         
-        vec1_n1 = material_exp_A_mat * delta_t; // [C]{alpha (T - T0)} (with membrane strain)
-        vec2_n1 = material_exp_B_mat * delta_t; // [C]{alpha (T - T0)} (with bending strain)
         stress(0,0) = vec1_n1(0); // sigma_xx
         stress(0,1) = vec1_n1(2); // sigma_xy
         stress(1,0) = vec1_n1(2); // sigma_yx
         stress(1,1) = vec1_n1(1); // sigma_yy
         
-        this->initialize_direct_strain_operator(qp, *_fe, Bmat_mem);
-        
-        // membrane strain
-        Bmat_mem.vector_mult_transpose(vec3_n2, vec1_n1);
-        local_f += JxW[qp] * vec3_n2;
-        
-        if (if_bending) {
-            // bending strain
-            _bending_operator->initialize_bending_strain_operator(*_fe, qp, Bmat_bend);
-            Bmat_bend.vector_mult_transpose(vec3_n2, vec2_n1);
-            local_f += JxW[qp] * vec3_n2;
+        if (if_bending && if_vk) {
             
+            // get the vonKarman strain operator if needed
+            this->initialize_von_karman_strain_operator(qp,
+                                                        *_fe,
+                                                        vec2_n1, // epsilon_vk
+                                                        vk_dwdxi_mat,
+                                                        Bmat_vk);
             // von Karman strain
-            if (if_vk) {
-                // get the vonKarman strain operator if needed
-                this->initialize_von_karman_strain_operator(qp,
-                                                            *_fe,
-                                                            vec2_n1, // epsilon_vk
-                                                            vk_dwdxi_mat,
-                                                            Bmat_vk);
-                // von Karman strain
-                vec4_2 = vk_dwdxi_mat.transpose() * vec1_n1;
-                Bmat_vk.vector_mult_transpose(vec3_n2, vec4_2);
-                local_f += JxW[qp] * vec3_n2;
-            }
+            vec4_2 = vk_dwdxi_mat.transpose() * vec1_n1;
+            Bmat_vk.vector_mult_transpose(vec3_n2, vec4_2);
+            local_vk_f += JxW[qp] * vec3_n2;
             
-            if (request_jacobian && if_vk) { // Jacobian only for vk strain
-                                             // vk - vk
+            if (request_jacobian) { // Jacobian only for vk strain
+                                    // vk - vk
                 mat3 = RealMatrixX::Zero(2, n2);
                 Bmat_vk.left_multiply(mat3, stress);
                 Bmat_vk.right_multiply_transpose(mat2_n2n2, mat3);
@@ -1797,8 +2274,25 @@ MAST::StructuralElement2D::thermal_residual (bool request_jacobian,
     }
     
     // now transform to the global coorodinate system
-    transform_vector_to_global_system(local_f, vec3_n2);
-    f -= vec3_n2;
+    if (if_cached)
+        f -= data->f;
+    else {
+        
+        transform_vector_to_global_system(local_f, vec3_n2);
+        f -= vec3_n2;
+        
+        if (data) {
+            data->f     = vec3_n2;
+            data->time  = _time;
+            data->valid = true;
+        }
+    }
+    
+    if (if_bending && if_vk) {
+        transform_vector_to_global_system(local_vk_f, vec3_n2);
+        f -= vec3_n2;
+    }
+    
     if (request_jacobian && if_vk) {
         transform_matrix_to_global_system(local_jac, mat2_n2n2);
         jac -= mat2_n2n2;
@@ -1868,7 +2362,7 @@ thermal_residual_sensitivity (bool request_jacobian,
     
     for (unsigned int qp=0; qp<JxW.size(); qp++) {
         
-        this->local_elem().global_coordinates_location(xyz[qp], pt);
+        this->_global_qp_location(*_fe, qp, pt);
         
         // this is moved inside the domain since
         (*expansion_A)(pt, _time, material_exp_A_mat);
@@ -1974,6 +2468,8 @@ piston_theory_residual(bool request_jacobian,
                        const unsigned int side,
                        MAST::BoundaryConditionBase& bc) {
     
+    MAST_LOG_SCOPE("piston_theory_residual()", "StructuralElement2D");
+    
     libmesh_assert(false); // to be implemented
     
     return (request_jacobian);
@@ -2008,26 +2504,19 @@ piston_theory_residual(bool request_jacobian,
                        RealMatrixX& jac,
                        MAST::BoundaryConditionBase& bc) {
     
+    MAST_LOG_SCOPE("piston_theory_residual()", "StructuralElement2D");
+    
     libmesh_assert(_elem.dim() < 3); // only applicable for lower dimensional elements
     libmesh_assert(!follower_forces); // not implemented yet for follower forces
     
     
     const std::vector<Real> &JxW                = _fe->get_JxW();
     const std::vector<libMesh::Point>& qpoint   = _fe->get_xyz();
-    const std::vector<std::vector<Real> >& phi  = _fe->get_phi();
     const unsigned int
-    n_phi = (unsigned int)phi.size(),
-    n1    = 2,
+    n_phi = (unsigned int)_fe->get_phi().size(),
     n2    = _system.n_vars()*n_phi;
     
     
-    // normal for face integration
-    libMesh::Point normal, pt;
-    // direction of pressure assumed to be normal (along local z-axis)
-    // to the element face for 2D and along local y-axis for 1D element.
-    normal(_elem.dim()) = -1.;
-    
-    
     // convert to piston theory boundary condition so that the necessary
     // flow properties can be obtained
     const MAST::PistonTheoryBoundaryCondition& piston_bc =
@@ -2042,7 +2531,7 @@ piston_theory_residual(bool request_jacobian,
     
     MAST::ConstantFieldFunction
     dwdx_f  ("dwdx", dwdx_p),
-    dwdt_f  ("dwdx", dwdt_p);
+    dwdt_f  ("dwdt", dwdt_p);
     
     
     std::auto_ptr<MAST::FieldFunction<Real> >
@@ -2050,127 +2539,50 @@ piston_theory_residual(bool request_jacobian,
     dpressure_dx    (piston_bc.get_dpdx_function    (dwdx_f, dwdt_f).release()),
     dpressure_dxdot (piston_bc.get_dpdxdot_function (dwdx_f, dwdt_f).release());
     
-    FEMOperatorMatrix
-    Bmat_w,         // operator matrix for the w-displacement
-    dBmat;          // operator matrix to calculate the derivativ of w wrt x and y
-    
-    dBmat.reinit(n1, _system.n_vars(), n_phi);
-    
     RealVectorX
-    phi_vec  = RealVectorX::Zero(n_phi),
-    force    = RealVectorX::Zero(n1),
     local_f  = RealVectorX::Zero(n2),
-    vec_n1   = RealVectorX::Zero(n1),
     vec_n2   = RealVectorX::Zero(n2),
-    vel_vec  = RealVectorX::Zero(3),
-    dummy    = RealVectorX::Zero(3);
+    vel_vec  = RealVectorX::Zero(3);
 
     RealMatrixX
-    dwdx            = RealMatrixX::Zero(3,2),
     local_jac_xdot  = RealMatrixX::Zero(n2,n2),
     local_jac       = RealMatrixX::Zero(n2,n2),
-    mat_n2n2        = RealMatrixX::Zero(n2,n2),
-    mat_n1n2        = RealMatrixX::Zero(n1,n2),
-    mat_22          = RealMatrixX::Zero(2,2);
+    mat_n2n2        = RealMatrixX::Zero(n2,n2);
     
     // we need the velocity vector in the local coordinate system so that
     // the appropriate component of the w-derivative can be used
     vel_vec = this->local_elem().T_matrix().transpose() * piston_bc.vel_vec();
     
-    Real
-    dwdt_val = 0.,
-    dwdx_val = 0.,
-    p_val    = 0.;
-    
+    libMesh::Point pt;
     
-    for (unsigned int qp=0; qp<qpoint.size(); qp++)
-    {
+    for (unsigned int qp=0; qp<qpoint.size(); qp++) {
 
         _local_elem->global_coordinates_location(qpoint[qp], pt);
 
-        // now set the shape function values
-        for ( unsigned int i_nd=0; i_nd<n_phi; i_nd++ )
-            phi_vec(i_nd) = phi[i_nd][qp];
-        
-        // initialize the B matrix for only the w-displacement
-        Bmat_w.reinit(n1, _system.n_vars(), n_phi);
-        Bmat_w.set_shape_function(0, 2, phi_vec);  // interpolates w-displacement
-        
-        // use the Bmat to calculate the velocity vector. Only the w-displacement
-        // is of interest in the local coordinate, since that is the only
-        // component normal to the surface.
-        Bmat_w.right_multiply(vec_n1, _local_vel);
-        dwdt_val = vec_n1(0);
-        
-        // get the operators for dw/dx and dw/dy to calculate the
-        // normal velocity. We will use the von Karman strain operators
-        // for this
-        this->initialize_von_karman_strain_operator(qp,
-                                                    *_fe,
-                                                    dummy,
-                                                    dwdx,
-                                                    dBmat);
-
-        // the diagonal of dwdx matrix stores the
-        dwdx_val = 0.;
-        for (unsigned int i=0; i<2; i++)
-            dwdx_val  +=  dwdx(i,i) * vel_vec(i);   // (dw/dx_i)*U_inf . n_i
-        
-        // calculate the pressure value
-        dwdx_p = dwdx_val;
-        dwdt_p = dwdt_val;
-        (*pressure)(pt, _time, p_val);
-        
-        // calculate force
-        force(0) = p_val * normal(2);
-        
-        
-        Bmat_w.vector_mult_transpose(vec_n2, force);
-        local_f += JxW[qp] * vec_n2;
-        
-
-        // calculate the Jacobian if requested
-        if (request_jacobian) {
-            
-            // we need the derivative of cp wrt normal velocity
-            (*dpressure_dxdot)(pt, _time, p_val);
-            
-            // calculate the component of Jacobian due to w-velocity
-            Bmat_w.right_multiply_transpose(mat_n2n2, Bmat_w);
-            local_jac_xdot += (JxW[qp] * p_val * normal(2)) * mat_n2n2;
-
-            // now calculate the component of Jacobian
-            (*dpressure_dx)(pt, _time, p_val);
-            
-            // derivative wrt x
-            mat_22.setZero(2,2);
-            mat_22(0,0)  =  vel_vec(0);
-            dBmat.left_multiply(mat_n1n2, mat_22);
-            Bmat_w.right_multiply_transpose(mat_n2n2, mat_n1n2);  // v: B^T dB/dx
-            local_jac += (JxW[qp] * p_val * normal(2)) * mat_n2n2;
-            
-            // derivative wrt y
-            mat_22.setZero(2,2);
-            mat_22(1,1)  =  vel_vec(1);
-            dBmat.left_multiply(mat_n1n2, mat_22);
-            Bmat_w.right_multiply_transpose(mat_n2n2, mat_n1n2);  // v: B^T dB/dy
-            local_jac += (JxW[qp] * p_val * normal(2)) * mat_n2n2;
-        }
+        _piston_theory_residual_operation(qp, *_fe, JxW, pt, vel_vec,
+                                          dwdx_p, dwdt_p,
+                                          *pressure,
+                                          *dpressure_dx,
+                                          *dpressure_dxdot,
+                                          request_jacobian,
+                                          local_f,
+                                          local_jac_xdot,
+                                          local_jac);
     }
     
     
     // now transform to the global system and add
     transform_vector_to_global_system(local_f, vec_n2);
-    f -= vec_n2;
+    f += vec_n2;
     
     // if the Jacobian was requested, then transform it and add to the
     // global Jacobian
     if (request_jacobian) {
         transform_matrix_to_global_system(local_jac_xdot, mat_n2n2);
-        jac_xdot -= mat_n2n2;
+        jac_xdot += mat_n2n2;
         
         transform_matrix_to_global_system(local_jac, mat_n2n2);
-        jac      -= mat_n2n2;
+        jac      += mat_n2n2;
     }
     
     return request_jacobian;
@@ -2179,6 +2591,81 @@ piston_theory_residual(bool request_jacobian,
 
 
 
+void
+MAST::StructuralElement2D::
+_piston_theory_residual_operation(const unsigned int qp,
+                                  const libMesh::FEBase& fe,
+                                  const std::vector<Real>& JxW,
+                                  const libMesh::Point& p,
+                                  const RealVectorX& vel_vec,
+                                  MAST::Parameter& dwdx_p,
+                                  MAST::Parameter& dwdt_p,
+                                  const MAST::FieldFunction<Real>& pressure,
+                                  const MAST::FieldFunction<Real>& dpressure_dx,
+                                  const MAST::FieldFunction<Real>& dpressure_dxdot,
+                                  bool request_jacobian,
+                                  RealVectorX& local_f,
+                                  RealMatrixX& local_jac_xdot,
+                                  RealMatrixX& local_jac) {
+    
+    const std::vector<std::vector<Real> >& phi  = fe.get_phi();
+    const std::vector<std::vector<libMesh::RealVectorValue> >& dphi = fe.get_dphi();
+    const unsigned int
+    n_phi = (unsigned int)phi.size();
+    
+    // only the w-displacement is of interest in the local coordinate,
+    // since that is the only component normal to the surface. Its
+    // velocity and its slope along the flow, (dw/dx_i)*U_inf . n_i, are
+    // interpolated directly from the shape functions.
+    Real
+    dwdt_val = 0.,
+    dwdx_val = 0.,
+    p_val    = 0.;
+    
+    for (unsigned int i=0; i<n_phi; i++) {
+        
+        dwdt_val += phi[i][qp] * _local_vel(2*n_phi+i);
+        dwdx_val += (dphi[i][qp](0) * vel_vec(0) +
+                     dphi[i][qp](1) * vel_vec(1)) * _local_sol(2*n_phi+i);
+    }
+    
+    // calculate the pressure value
+    dwdx_p = dwdx_val;
+    dwdt_p = dwdt_val;
+    pressure(p, _time, p_val);
+    
+    // the pressure acts along the negative local z-axis, and the
+    // resulting force is subtracted from the residual. Hence, the
+    // pressure is added to the w-dofs.
+    for (unsigned int i=0; i<n_phi; i++)
+        local_f(2*n_phi+i) += JxW[qp] * p_val * phi[i][qp];
+    
+    if (request_jacobian) {
+        
+        Real
+        dp_dxdot = 0.,
+        dp_dx    = 0.;
+        
+        dpressure_dxdot(p, _time, dp_dxdot);
+        dpressure_dx   (p, _time, dp_dx);
+        
+        // Jacobians with respect to the w-velocity and the w-slope
+        for (unsigned int i=0; i<n_phi; i++)
+            for (unsigned int j=0; j<n_phi; j++) {
+                
+                local_jac_xdot(2*n_phi+i, 2*n_phi+j) +=
+                JxW[qp] * dp_dxdot * phi[i][qp] * phi[j][qp];
+                
+                local_jac(2*n_phi+i, 2*n_phi+j) +=
+                JxW[qp] * dp_dx * phi[i][qp] *
+                (dphi[j][qp](0) * vel_vec(0) + dphi[j][qp](1) * vel_vec(1));
+            }
+    }
+}
+
+
+
+
 bool
 MAST::StructuralElement2D::
 piston_theory_residual_sensitivity(bool request_jacobian,
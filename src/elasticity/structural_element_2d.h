@@ -22,6 +22,7 @@
 
 // C++ includes
 #include <memory>
+#include <vector>
 
 
 // MAST includes
@@ -35,6 +36,8 @@ namespace MAST {
     // Forward declerations
     class BoundaryCondition;
     class FEMOperatorMatrix;
+    class PistonTheoryBoundaryCondition;
+    class Parameter;
     
     
     
@@ -46,6 +49,15 @@ namespace MAST {
                             const libMesh::Elem& elem,
                             const MAST::ElementPropertyCardBase& p);
         
+        virtual ~StructuralElement2D();
+        
+        
+        /*!
+         *   clears the stored quadrature point locations and strain
+         *   operators
+         */
+        virtual void clear_geometry_cache();
+        
         
         /*!
          *    row dimension of the direct strain matrix, also used for the
@@ -70,6 +82,22 @@ namespace MAST {
                                        RealVectorX& f,
                                        RealMatrixX& jac);
         
+        /*!
+         *    Calculates the internal residual vector and Jacobian, and the
+         *    contributions of the loads in \p bc. If the subdomain of the
+         *    element has a single piston theory load, and follower forces
+         *    are not used, the piston theory pressure is integrated in the
+         *    quadrature loop of the internal residual. The other loads are
+         *    evaluated with volume_external_residual().
+         */
+        virtual bool
+        internal_and_volume_external_residual
+        (bool request_jacobian,
+         RealVectorX& f,
+         RealMatrixX& jac_xdot,
+         RealMatrixX& jac,
+         std::multimap<libMesh::subdomain_id_type, MAST::BoundaryConditionBase*>& bc);
+        
         /*!
          *    Calculates the sensitivity internal residual vector and Jacobian due to
          *    strain energy
@@ -77,6 +105,18 @@ namespace MAST {
         virtual bool internal_residual_sensitivity(bool request_jacobian,
                                                    RealVectorX& f,
                                                    RealMatrixX& jac);
+        
+        /*!
+         *    Calculates the sensitivity of the internal residual vector and
+         *    Jacobian for all parameters in \p params that the section
+         *    properties depend on, in one pass over the quadrature points
+         */
+        virtual void
+        internal_residual_sensitivities(const std::vector<const MAST::FunctionBase*>& params,
+                                        bool request_jacobian,
+                                        std::vector<RealVectorX>& f,
+                                        std::vector<RealMatrixX>& jac);
+        
         /*!
          *   calculates d[J]/d{x} . d{x}/dp
          */
@@ -262,6 +302,29 @@ namespace MAST {
                                           const libMesh::FEBase& fe,
                                           MAST::FEMOperatorMatrix& Bmat);
         
+        /*!
+         *   @returns the membrane strain operator at \p qp. If the geometric
+         *   data is stored, the operator is computed on first use and the
+         *   stored operator is returned. Otherwise, \p Bmat is initialized
+         *   and returned.
+         */
+        const MAST::FEMOperatorMatrix&
+        _direct_strain_operator(const unsigned int qp,
+                                const libMesh::FEBase& fe,
+                                MAST::FEMOperatorMatrix& Bmat);
+        
+        
+        /*!
+         *   @returns the bending strain operator at \p qp. If the geometric
+         *   data is stored, the operator is computed on first use and the
+         *   stored operator is returned. Otherwise, \p Bmat is initialized
+         *   and returned.
+         */
+        const MAST::FEMOperatorMatrix&
+        _bending_strain_operator(const unsigned int qp,
+                                 const libMesh::FEBase& fe,
+                                 MAST::FEMOperatorMatrix& Bmat);
+        
         /*!
          *   initialze the von Karman strain in \par vK_strain, the operator
          *   matrices needed for Jacobian calculation.
@@ -285,10 +348,51 @@ namespace MAST {
                                                           const libMesh::FEBase& fe,
                                                           RealMatrixX& vk_dwdxi_mat_sens);
         
+        /*!
+         *   internal residual and Jacobian. If \p piston_bc is provided, the
+         *   piston theory pressure is added to the residual at each
+         *   quadrature point, and its Jacobian with respect to the velocity
+         *   is added to \p jac_xdot. Otherwise, \p jac_xdot is not used.
+         */
+        bool
+        _internal_residual(bool request_jacobian,
+                           RealVectorX& f,
+                           RealMatrixX& jac_xdot,
+                           RealMatrixX& jac,
+                           const MAST::PistonTheoryBoundaryCondition* piston_bc);
+        
+        /*!
+         *   adds the piston theory pressure at quadrature point \p qp, with
+         *   global location \p p, to the local residual \p local_f. The
+         *   pressure is computed from the w-displacement and velocity and
+         *   the slope of w along the flow direction \p vel_vec, which are
+         *   set in the parameters \p dwdx_p and \p dwdt_p of the pressure
+         *   functions. The Jacobians with respect to the velocity and
+         *   displacement are added to \p local_jac_xdot and \p local_jac
+         *   if requested.
+         */
+        void
+        _piston_theory_residual_operation(const unsigned int qp,
+                                          const libMesh::FEBase& fe,
+                                          const std::vector<Real>& JxW,
+                                          const libMesh::Point& p,
+                                          const RealVectorX& vel_vec,
+                                          MAST::Parameter& dwdx_p,
+                                          MAST::Parameter& dwdt_p,
+                                          const MAST::FieldFunction<Real>& pressure,
+                                          const MAST::FieldFunction<Real>& dpressure_dx,
+                                          const MAST::FieldFunction<Real>& dpressure_dxdot,
+                                          bool request_jacobian,
+                                          RealVectorX& local_f,
+                                          RealMatrixX& local_jac_xdot,
+                                          RealMatrixX& local_jac);
+        
         /*!
          *   performs integration at the quadrature point for the provided
          *   matrices. The temperature vector and matrix entities are provided for
-         *   integration
+         *   integration. If \p if_vk_only is \p true, only the terms that
+         *   depend on the von Karman strain are computed, which are added
+         *   to the linear stiffness retained by the element.
          */
         virtual void
         _internal_residual_operation(bool if_bending,
@@ -317,7 +421,8 @@ namespace MAST {
                                      RealMatrixX& mat1_n1n2,
                                      RealMatrixX& mat2_n2n2,
                                      RealMatrixX& mat3,
-                                     RealMatrixX& mat4_2n2);
+                                     RealMatrixX& mat4_2n2,
+                                     bool if_vk_only = false);
         
         /*!
          *   sensitivity of linear part of the geometric stiffness matrix
@@ -354,6 +459,15 @@ namespace MAST {
          */
         void _convert_prestress_B_mat_to_vector(const RealMatrixX& mat,
                                                 RealVectorX& vec) const;
+        
+        
+        /*!
+         *   membrane and bending strain operators at each quadrature point,
+         *   if the geometric data is stored. For an element with \p n_phi
+         *   shape functions the membrane operator stores 4 n_phi Reals per
+         *   quadrature point, and the bending operator a similar amount.
+         */
+        std::vector<MAST::FEMOperatorMatrix*> _qp_Bmat_mem, _qp_Bmat_bend;
 
     };
 }
@@ -22,6 +22,7 @@
 #include "elasticity/structural_element_1d.h"
 #include "elasticity/structural_element_2d.h"
 #include "elasticity/solid_element_3d.h"
+#include "elasticity/incompatible_mode_store.h"
 #include "base/system_initialization.h"
 #include "base/boundary_condition_base.h"
 #include "property_cards/element_property_card_1D.h"
@@ -30,9 +31,13 @@
 #include "mesh/local_2d_elem.h"
 #include "mesh/local_3d_elem.h"
 #include "numerics/fem_operator_matrix.h"
+#include "numerics/fem_operator_matrix_batch.h"
 #include "numerics/utility.h"
 #include "elasticity/stress_output_base.h"
 #include "base/nonlinear_system.h"
+#include "base/function_base.h"
+#include "base/performance_log.h"
+#include "base/same_mesh_field_function.h"
 
 
 
@@ -42,7 +47,10 @@ MAST::StructuralElementBase::StructuralElementBase(MAST::SystemInitialization& s
 MAST::ElementBase(sys, elem),
 follower_forces(false),
 _property(p),
-_incompatible_sol(nullptr) {
+_incompatible_sol(nullptr),
+_incompatible_data(nullptr),
+_thermal_load_cache(nullptr),
+_linear_stiffness(nullptr) {
     
     MAST::LocalElemBase* rval = nullptr;
     
@@ -80,6 +88,274 @@ MAST::StructuralElementBase::~StructuralElementBase() {
 
 
 
+void
+MAST::StructuralElementBase::clear_geometry_cache() {
+    
+    _qp_global_xyz.clear();
+}
+
+
+
+bool
+MAST::StructuralElementBase::
+_use_geometry_cache(const libMesh::FEBase& fe) const {
+    
+    return (_geometry_cache &&
+            &fe == _fe &&
+            (!sensitivity_param || !sensitivity_param->is_shape_parameter()));
+}
+
+
+
+void
+MAST::StructuralElementBase::
+_side_loads(const MAST::SideBCMapType& bc,
+            std::vector<MAST::WettedSurface::SideLoad>& storage,
+            const MAST::WettedSurface::SideLoad*& begin,
+            const MAST::WettedSurface::SideLoad*& end) const {
+    
+    const MAST::WettedSurface* ws = _system.system().wetted_surface();
+    
+    if (ws && ws->side_loads(_elem, bc, begin, end))
+        return;
+    
+    typedef MAST::SideBCMapType maptype;
+    
+    // iterate over the boundary ids given in the provided force map
+    std::pair<maptype::const_iterator, maptype::const_iterator> it;
+    
+    const MAST::ElementTopologyCache& topology = _system.system().topology_cache();
+    
+    MAST::WettedSurface::SideLoad l;
+    storage.clear();
+    
+    for (unsigned short int n=0; n<_elem.n_sides(); n++) {
+        
+        // if no boundary ids have been specified for the side, then
+        // move to the next side.
+        if (!topology.n_boundary_ids(_elem, n))
+            continue;
+        
+        std::vector<libMesh::boundary_id_type> bc_ids = topology.boundary_ids(_elem, n);
+        std::vector<libMesh::boundary_id_type>::const_iterator bc_it = bc_ids.begin();
+        
+        for ( ; bc_it != bc_ids.end(); bc_it++) {
+            
+            it = bc.equal_range(*bc_it);
+            
+            for ( ; it.first != it.second; it.first++) {
+                
+                if (it.first->second->type() == MAST::DIRICHLET)
+                    continue;
+                
+                l.side = n;
+                l.bc   = it.first->second;
+                storage.push_back(l);
+            }
+        }
+    }
+    
+    begin = storage.data();
+    end   = storage.data() + storage.size();
+}
+
+
+
+Real*
+MAST::StructuralElementBase::_incompatible_mode_values() {
+    
+    libmesh_assert(_incompatible_sol || _incompatible_data);
+    
+    if (_incompatible_data)
+        return _incompatible_data->alpha;
+    else
+        return _incompatible_sol->data();
+}
+
+
+MAST::ThermalLoadData*
+MAST::StructuralElementBase::
+_thermal_load_data(const MAST::BoundaryConditionBase& bc) {
+    
+    if (!_thermal_load_cache)
+        return nullptr;
+    
+    MAST::ThermalLoadData& d = (*_thermal_load_cache)[&bc];
+    
+    if (d.valid && d.time != _time)
+        d.valid = false;
+    
+    return &d;
+}
+
+
+
+void
+MAST::StructuralElementBase::
+internal_residual_sensitivities(const std::vector<const MAST::FunctionBase*>& params,
+                                bool request_jacobian,
+                                std::vector<RealVectorX>& f,
+                                std::vector<RealMatrixX>& jac) {
+    
+    libmesh_assert_equal_to(f.size(),   params.size());
+    libmesh_assert_equal_to(jac.size(), params.size());
+    
+    const MAST::FunctionBase*
+    sens_param = this->sensitivity_param;
+    
+    for (unsigned int i=0; i<params.size(); i++) {
+        
+        this->sensitivity_param = params[i];
+        this->internal_residual_sensitivity(request_jacobian, f[i], jac[i]);
+    }
+    
+    this->sensitivity_param = sens_param;
+}
+
+
+
+MAST::LinearStiffnessData*
+MAST::StructuralElementBase::_linear_stiffness_data() {
+    
+    if (!_linear_stiffness)
+        return nullptr;
+    
+    if (_linear_stiffness->valid && _linear_stiffness->time != _time)
+        _linear_stiffness->valid = false;
+    
+    return _linear_stiffness;
+}
+
+
+
+void
+MAST::StructuralElementBase::_shape_function_mass_matrix(RealMatrixX& m) {
+    
+    const std::vector<Real>& JxW               = _fe->get_JxW();
+    const std::vector<std::vector<Real> >& phi = _fe->get_phi();
+    
+    const unsigned int
+    n_phi    = (unsigned int)phi.size();
+    
+    RealVectorX
+    phi_vec  = RealVectorX::Zero(n_phi);
+    
+    m = RealMatrixX::Zero(n_phi, n_phi);
+    
+    for (unsigned int qp=0; qp<JxW.size(); qp++) {
+        
+        for ( unsigned int i_nd=0; i_nd<n_phi; i_nd++ )
+            phi_vec(i_nd) = phi[i_nd][qp];
+        
+        m += JxW[qp] * phi_vec * phi_vec.transpose();
+    }
+}
+
+
+
+void
+MAST::StructuralElementBase::
+_lump_mass_matrix(MAST::MassLumpingScheme s,
+                  unsigned int n_phi,
+                  RealMatrixX& m) const {
+    
+    const unsigned int
+    n = (unsigned int)m.rows();
+    
+    RealVectorX
+    d = RealVectorX::Zero(n);
+    
+    switch (s) {
+            
+        case MAST::ROW_SUM_LUMPING:
+            d = m.rowwise().sum();
+            break;
+            
+        case MAST::HRZ_LUMPING: {
+            
+            // the dofs of each variable are stored contiguously, and the
+            // diagonal of each variable is scaled to its total mass
+            for (unsigned int i=0; i<n/n_phi; i++) {
+                
+                const Real
+                total = m.block(i*n_phi, i*n_phi, n_phi, n_phi).sum(),
+                diag  = m.diagonal().segment(i*n_phi, n_phi).sum();
+                
+                if (diag != 0.)
+                    d.segment(i*n_phi, n_phi) =
+                    (total/diag) * m.diagonal().segment(i*n_phi, n_phi);
+            }
+        }
+            break;
+            
+        default:
+            // nodal volume lumping is computed by the element
+            libmesh_error();
+    }
+    
+    m = d.asDiagonal();
+}
+
+
+
+bool
+MAST::StructuralElementBase::
+_direct_qp_temperature(const MAST::FieldFunction<Real>& temp_func,
+                       const libMesh::FEBase& fe,
+                       std::vector<Real>& temp) const {
+    
+    const MAST::SameMeshFieldFunction*
+    f = dynamic_cast<const MAST::SameMeshFieldFunction*>(&temp_func);
+    
+    if (!f)
+        return false;
+    
+    RealVectorX v;
+    if (!f->element_values(_elem, fe.get_fe_type(), v))
+        return false;
+    
+    const std::vector<std::vector<Real> >&
+    phi = fe.get_phi();
+    
+    libmesh_assert_equal_to(phi.size(), v.size());
+    
+    temp.assign(phi.size() ? phi[0].size() : 0, 0.);
+    
+    for (unsigned int i=0; i<phi.size(); i++)
+        for (unsigned int qp=0; qp<phi[i].size(); qp++)
+            temp[qp] += phi[i][qp] * v(i);
+    
+    return true;
+}
+
+
+
+void
+MAST::StructuralElementBase::_global_qp_location(const libMesh::FEBase& fe,
+                                                 unsigned int qp,
+                                                 libMesh::Point& p) {
+    
+    const std::vector<libMesh::Point>& xyz = fe.get_xyz();
+    
+    if (!_use_geometry_cache(fe)) {
+        
+        _local_elem->global_coordinates_location(xyz[qp], p);
+        return;
+    }
+    
+    // compute the locations for all quadrature points on first use
+    if (_qp_global_xyz.size() != xyz.size()) {
+        
+        _qp_global_xyz.resize(xyz.size());
+        for (unsigned int i=0; i<xyz.size(); i++)
+            _local_elem->global_coordinates_location(xyz[i], _qp_global_xyz[i]);
+    }
+    
+    p = _qp_global_xyz[qp];
+}
+
+
+
 void
 MAST::StructuralElementBase::set_solution(const RealVectorX& vec,
                                           bool if_sens) {
@@ -289,24 +565,22 @@ MAST::StructuralElementBase::inertial_residual (bool request_jacobian,
                                                 RealMatrixX& jac_xdot,
                                                 RealMatrixX& jac) {
     
+    MAST_LOG_SCOPE("inertial_residual()", "StructuralElementBase");
+    
     const std::vector<Real>& JxW               = _fe->get_JxW();
     const std::vector<libMesh::Point>& xyz     = _fe->get_xyz();
     const std::vector<std::vector<Real> >& phi = _fe->get_phi();
     
     const unsigned int
     n_phi    = (unsigned int)phi.size(),
-    n_vars   = _system.system().n_vars(),
     n1       =6,
     n2       =6*n_phi;
     
     RealMatrixX
     material_mat,
-    mat1_n1n2     = RealMatrixX::Zero(n1, n2),
     mat2_n2n2     = RealMatrixX::Zero(n2, n2),
     local_jac     = RealMatrixX::Zero(n2, n2);
     RealVectorX
-    phi_vec    = RealVectorX::Zero(n_phi),
-    vec1_n1    = RealVectorX::Zero(n1),
     vec2_n2    = RealVectorX::Zero(n2),
     local_f    = RealVectorX::Zero(n2);
     
@@ -314,9 +588,12 @@ MAST::StructuralElementBase::inertial_residual (bool request_jacobian,
     mat_inertia  = _property.inertia_matrix(*this);
     
     libMesh::Point p;
-    MAST::FEMOperatorMatrix Bmat;
     
-    if (_property.if_diagonal_mass_matrix()) {
+    const bool
+    if_diagonal = _property.if_diagonal_mass_matrix();
+    
+    if (if_diagonal &&
+        _property.mass_lumping_scheme() == MAST::NODAL_VOLUME_LUMPING) {
         
         // as an approximation, get matrix at the first quadrature point
         _local_elem->global_coordinates_location(xyz[0], p);
@@ -336,33 +613,49 @@ MAST::StructuralElementBase::inertial_residual (bool request_jacobian,
         local_f =  local_jac * _local_accel;
     }
     else {
-        libMesh::Point p;
         
-        for (unsigned int qp=0; qp<JxW.size(); qp++) {
-            
-            _local_elem->global_coordinates_location(xyz[0], p);
-            
-            (*mat_inertia)(p, _time, material_mat);
-            
-            // now set the shape function values
-            for ( unsigned int i_nd=0; i_nd<n_phi; i_nd++ )
-                phi_vec(i_nd) = phi[i_nd][qp];
-            
-            Bmat.reinit(n_vars, phi_vec);
+        // the inertia matrix is evaluated at the first quadrature point,
+        // so that the consistent mass matrix is the product of the
+        // inertia matrix with the scalar mass matrix of the shape
+        // functions, M(i_var*n+a, j_var*n+b) = I(i_var, j_var) m(a, b).
+        // This requires only one pass over the quadrature points with
+        // the shape functions.
+        _local_elem->global_coordinates_location(xyz[0], p);
+        
+        (*mat_inertia)(p, _time, material_mat);
+        
+        libmesh_assert_equal_to(_system.system().n_vars(), n1);
+        
+        RealMatrixX
+        phi_mass;
+        
+        _shape_function_mass_matrix(phi_mass);
+        
+        // the consistent matrix is also needed for the lumped matrix
+        if (request_jacobian || if_diagonal) {
             
-            Bmat.left_multiply(mat1_n1n2, material_mat);
+            for (unsigned int i=0; i<n1; i++)
+                for (unsigned int j=0; j<n1; j++)
+                    if (material_mat(i, j) != 0.)
+                        local_jac.block(i*n_phi, j*n_phi, n_phi, n_phi) =
+                        material_mat(i, j) * phi_mass;
+        }
+        
+        if (if_diagonal) {
             
-            vec1_n1 = mat1_n1n2 * _local_accel;
-            Bmat.vector_mult_transpose(vec2_n2, vec1_n1);
+            _lump_mass_matrix(_property.mass_lumping_scheme(), n_phi, local_jac);
+            local_f = local_jac * _local_accel;
+        }
+        else {
             
-            local_f += JxW[qp] * vec2_n2;
+            // with the accelerations of the variables as the columns of
+            // A, the residual is m A I^T
+            Eigen::Map<const RealMatrixX>
+            accel(_local_accel.data(), n_phi, n1);
+            Eigen::Map<RealMatrixX>
+            f_mat(local_f.data(), n_phi, n1);
             
-            if (request_jacobian) {
-                
-                Bmat.right_multiply_transpose(mat2_n2n2,
-                                              mat1_n1n2);
-                local_jac += JxW[qp]*mat2_n2n2;
-            }
+            f_mat = phi_mass * accel * material_mat.transpose();
         }
     }
     
@@ -553,65 +846,40 @@ side_external_residual(bool request_jacobian,
                        RealMatrixX& jac,
                        std::multimap<libMesh::boundary_id_type, MAST::BoundaryConditionBase*>& bc) {
     
-    typedef std::multimap<libMesh::boundary_id_type, MAST::BoundaryConditionBase*> maptype;
+    MAST_LOG_SCOPE("side_external_residual()", "StructuralElementBase");
     
-    // iterate over the boundary ids given in the provided force map
-    std::pair<maptype::const_iterator, maptype::const_iterator> it;
-    
-    const libMesh::BoundaryInfo& binfo = *_system.system().get_mesh().boundary_info;
+    // the loads on the sides of this element
+    std::vector<MAST::WettedSurface::SideLoad> loads;
+    const MAST::WettedSurface::SideLoad *it = nullptr, *end = nullptr;
     
-    // for each boundary id, check if any of the sides on the element
-    // has the associated boundary
+    this->_side_loads(bc, loads, it, end);
     
-    for (unsigned short int n=0; n<_elem.n_sides(); n++) {
-        
-        // if no boundary ids have been specified for the side, then
-        // move to the next side.
-        if (!binfo.n_boundary_ids(&_elem, n))
-            continue;
-        
-        // check to see if any of the specified boundary ids has a boundary
-        // condition associated with them
-        std::vector<libMesh::boundary_id_type> bc_ids = binfo.boundary_ids(&_elem, n);
-        std::vector<libMesh::boundary_id_type>::const_iterator bc_it = bc_ids.begin();
+    for ( ; it != end; it++) {
         
-        for ( ; bc_it != bc_ids.end(); bc_it++) {
-            
-            // find the loads on this boundary and evaluate the f and jac
-            it = bc.equal_range(*bc_it);
-            
-            for ( ; it.first != it.second; it.first++) {
+        // apply all the types of loading
+        switch (it->bc->type()) {
+            case MAST::SURFACE_PRESSURE:
+                surface_pressure_residual(request_jacobian,
+                                          f, jac,
+                                          it->side,
+                                          *it->bc);
+                break;
                 
-                // apply all the types of loading
-                switch (it.first->second->type()) {
-                    case MAST::SURFACE_PRESSURE:
-                        surface_pressure_residual(request_jacobian,
-                                                  f, jac,
-                                                  n,
-                                                  *it.first->second);
-                        break;
-
-                        
-                    case MAST::PISTON_THEORY:
-                        piston_theory_residual(request_jacobian,
-                                               f,
-                                               jac_xdot,
-                                               jac,
-                                               n,
-                                               *it.first->second);
-                        break;
-
-                        
-                    case MAST::DIRICHLET:
-                        // nothing to be done here
-                        break;
-                        
-                    default:
-                        // not implemented yet
-                        libmesh_error();
-                        break;
-                }
-            }
+                
+            case MAST::PISTON_THEORY:
+                piston_theory_residual(request_jacobian,
+                                       f,
+                                       jac_xdot,
+                                       jac,
+                                       it->side,
+                                       *it->bc);
+                break;
+                
+                
+            default:
+                // not implemented yet
+                libmesh_error();
+                break;
         }
     }
     return request_jacobian;
@@ -633,7 +901,7 @@ linearized_side_external_residual
     // iterate over the boundary ids given in the provided force map
     std::pair<maptype::const_iterator, maptype::const_iterator> it;
     
-    const libMesh::BoundaryInfo& binfo = *_system.system().get_mesh().boundary_info;
+    const MAST::ElementTopologyCache& topology = _system.system().topology_cache();
     
     // for each boundary id, check if any of the sides on the element
     // has the associated boundary
@@ -642,12 +910,12 @@ linearized_side_external_residual
         
         // if no boundary ids have been specified for the side, then
         // move to the next side.
-        if (!binfo.n_boundary_ids(&_elem, n))
+        if (!topology.n_boundary_ids(_elem, n))
             continue;
         
         // check to see if any of the specified boundary ids has a boundary
         // condition associated with them
-        std::vector<libMesh::boundary_id_type> bc_ids = binfo.boundary_ids(&_elem, n);
+        std::vector<libMesh::boundary_id_type> bc_ids = topology.boundary_ids(_elem, n);
         std::vector<libMesh::boundary_id_type>::const_iterator bc_it = bc_ids.begin();
         
         for ( ; bc_it != bc_ids.end(); bc_it++) {
@@ -686,58 +954,31 @@ linearized_frequency_domain_side_external_residual
  ComplexMatrixX& jac,
  std::multimap<libMesh::boundary_id_type, MAST::BoundaryConditionBase*>& bc) {
     
-    typedef std::multimap<libMesh::boundary_id_type, MAST::BoundaryConditionBase*> maptype;
-    
-    // iterate over the boundary ids given in the provided force map
-    std::pair<maptype::const_iterator, maptype::const_iterator> it;
+    // the loads on the sides of this element
+    std::vector<MAST::WettedSurface::SideLoad> loads;
+    const MAST::WettedSurface::SideLoad *it = nullptr, *end = nullptr;
     
-    const libMesh::BoundaryInfo& binfo = *_system.system().get_mesh().boundary_info;
+    this->_side_loads(bc, loads, it, end);
     
-    // for each boundary id, check if any of the sides on the element
-    // has the associated boundary
-    
-    for (unsigned short int n=0; n<_elem.n_sides(); n++) {
-        
-        // if no boundary ids have been specified for the side, then
-        // move to the next side.
-        if (!binfo.n_boundary_ids(&_elem, n))
-            continue;
-        
-        // check to see if any of the specified boundary ids has a boundary
-        // condition associated with them
-        std::vector<libMesh::boundary_id_type> bc_ids = binfo.boundary_ids(&_elem, n);
-        std::vector<libMesh::boundary_id_type>::const_iterator bc_it = bc_ids.begin();
+    for ( ; it != end; it++) {
         
-        for ( ; bc_it != bc_ids.end(); bc_it++) {
-            
-            // find the loads on this boundary and evaluate the f and jac
-            it = bc.equal_range(*bc_it);
-            
-            for ( ; it.first != it.second; it.first++) {
+        // apply all the types of loading
+        switch (it->bc->type()) {
                 
-                // apply all the types of loading
-                switch (it.first->second->type()) {
-
-                    case MAST::SURFACE_PRESSURE:
-                        
-                        linearized_frequency_domain_surface_pressure_residual
-                        (request_jacobian,
-                         f, jac,
-                         n,
-                         *it.first->second);
-                        break;
-                        
-                        
-                    case MAST::DIRICHLET:
-                        // nothing to be done here
-                        break;
-                        
-                    default:
-                        // not implemented yet
-                        libmesh_error();
-                        break;
-                }
-            }
+            case MAST::SURFACE_PRESSURE:
+                
+                linearized_frequency_domain_surface_pressure_residual
+                (request_jacobian,
+                 f, jac,
+                 it->side,
+                 *it->bc);
+                break;
+                
+                
+            default:
+                // not implemented yet
+                libmesh_error();
+                break;
         }
     }
     return request_jacobian;
@@ -746,13 +987,34 @@ linearized_frequency_domain_side_external_residual
 
 
 
+bool
+MAST::StructuralElementBase::
+internal_and_volume_external_residual
+(bool request_jacobian,
+ RealVectorX& f,
+ RealMatrixX& jac_xdot,
+ RealMatrixX& jac,
+ std::multimap<libMesh::subdomain_id_type, MAST::BoundaryConditionBase*>& bc) {
+    
+    this->internal_residual(request_jacobian, f, jac);
+    this->volume_external_residual(request_jacobian, f, jac_xdot, jac, bc);
+    
+    return request_jacobian;
+}
+
+
+
+
 bool
 MAST::StructuralElementBase::
 volume_external_residual (bool request_jacobian,
                           RealVectorX& f,
                           RealMatrixX& jac_xdot,
                           RealMatrixX& jac,
-                          std::multimap<libMesh::subdomain_id_type, MAST::BoundaryConditionBase*>& bc) {
+                          std::multimap<libMesh::subdomain_id_type, MAST::BoundaryConditionBase*>& bc,
+                          bool if_piston_theory) {
+    
+    MAST_LOG_SCOPE("volume_external_residual()", "StructuralElementBase");
     
     // iterate over the boundary ids given in the provided force map
     std::pair<std::multimap<libMesh::subdomain_id_type, MAST::BoundaryConditionBase*>::const_iterator,
@@ -776,11 +1038,12 @@ volume_external_residual (bool request_jacobian,
                 break;
 
             case MAST::PISTON_THEORY:
-                piston_theory_residual(request_jacobian,
-                                       f,
-                                       jac_xdot,
-                                       jac,
-                                       *it.first->second);
+                if (if_piston_theory)
+                    piston_theory_residual(request_jacobian,
+                                           f,
+                                           jac_xdot,
+                                           jac,
+                                           *it.first->second);
                 break;
 
             case MAST::TEMPERATURE:
@@ -906,65 +1169,38 @@ side_external_residual_sensitivity(bool request_jacobian,
                                    RealMatrixX& jac,
                                    std::multimap<libMesh::boundary_id_type, MAST::BoundaryConditionBase*>& bc) {
     
-    typedef std::multimap<libMesh::boundary_id_type, MAST::BoundaryConditionBase*> maptype;
-    
-    // iterate over the boundary ids given in the provided force map
-    std::pair<maptype::const_iterator, maptype::const_iterator> it;
+    // the loads on the sides of this element
+    std::vector<MAST::WettedSurface::SideLoad> loads;
+    const MAST::WettedSurface::SideLoad *it = nullptr, *end = nullptr;
     
-    const libMesh::BoundaryInfo& binfo = *_system.system().get_mesh().boundary_info;
+    this->_side_loads(bc, loads, it, end);
     
-    // for each boundary id, check if any of the sides on the element
-    // has the associated boundary
-    
-    for (unsigned short int n=0; n<_elem.n_sides(); n++) {
+    for ( ; it != end; it++) {
         
-        // if no boundary ids have been specified for the side, then
-        // move to the next side.
-        if (!binfo.n_boundary_ids(&_elem, n))
-            continue;
-        
-        // check to see if any of the specified boundary ids has a boundary
-        // condition associated with them
-        std::vector<libMesh::boundary_id_type> bc_ids = binfo.boundary_ids(&_elem, n);
-        std::vector<libMesh::boundary_id_type>::const_iterator bc_it = bc_ids.begin();
-        
-        for ( ; bc_it != bc_ids.end(); bc_it++) {
-            
-            // find the loads on this boundary and evaluate the f and jac
-            it = bc.equal_range(*bc_it);
-            
-            for ( ; it.first != it.second; it.first++) {
+        // apply all the types of loading
+        switch (it->bc->type()) {
+            case MAST::SURFACE_PRESSURE:
+                surface_pressure_residual_sensitivity(request_jacobian,
+                                                      f, jac,
+                                                      it->side,
+                                                      *it->bc);
+                break;
                 
-                // apply all the types of loading
-                switch (it.first->second->type()) {
-                    case MAST::SURFACE_PRESSURE:
-                        surface_pressure_residual_sensitivity(request_jacobian,
-                                                              f, jac,
-                                                              n,
-                                                              *it.first->second);
-                        break;
-                        
-                        
-                    case MAST::PISTON_THEORY:
-                        piston_theory_residual_sensitivity(request_jacobian,
-                                                           f,
-                                                           jac_xdot,
-                                                           jac,
-                                                           n,
-                                                           *it.first->second);
-                        break;
-                        
-                        
-                    case MAST::DIRICHLET:
-                        // nothing to be done here
-                        break;
-                        
-                    default:
-                        // not implemented yet
-                        libmesh_error();
-                        break;
-                }
-            }
+                
+            case MAST::PISTON_THEORY:
+                piston_theory_residual_sensitivity(request_jacobian,
+                                                   f,
+                                                   jac_xdot,
+                                                   jac,
+                                                   it->side,
+                                                   *it->bc);
+                break;
+                
+                
+            default:
+                // not implemented yet
+                libmesh_error();
+                break;
         }
     }
     return request_jacobian;
@@ -1106,6 +1342,8 @@ surface_pressure_residual(bool request_jacobian,
                           RealMatrixX &jac,
                           MAST::BoundaryConditionBase& bc) {
     
+    MAST_LOG_SCOPE("surface_pressure_residual()", "StructuralElementBase");
+    
     libmesh_assert(_elem.dim() < 3); // only applicable for lower dimensional elements
     libmesh_assert(!follower_forces); // not implemented yet for follower forces
     
@@ -1130,18 +1368,29 @@ surface_pressure_residual(bool request_jacobian,
     MAST::FieldFunction<Real>& func =
     bc.get<MAST::FieldFunction<Real> >("pressure");
     
+    const unsigned int
+    n_qp  = (unsigned int)qpoint.size();
+    
     Real press;
-    FEMOperatorMatrix Bmat;
     libMesh::Point pt;
     
+    // the operators at all quadrature points share the same sparsity,
+    // so the quadrature sum is computed with a single batch product
+    std::vector<MAST::FEMOperatorMatrix>         Bmat(n_qp);
+    std::vector<const MAST::FEMOperatorMatrix*>  Bmat_ptr(n_qp);
+    MAST::FEMOperatorMatrixBatch                 Bmat_batch;
+    
     RealVectorX
     phi_vec  = RealVectorX::Zero(n_phi),
-    force    = RealVectorX::Zero(2*n1),
+    w        = RealVectorX::Zero(n_qp),
     local_f  = RealVectorX::Zero(n2),
     vec_n2   = RealVectorX::Zero(n2);
     
+    RealMatrixX
+    force    = RealMatrixX::Zero(2*n1, n_qp);
     
-    for (unsigned int qp=0; qp<qpoint.size(); qp++)
+    
+    for (unsigned int qp=0; qp<n_qp; qp++)
     {
         
         _local_elem->global_coordinates_location(qpoint[qp], pt);
@@ -1150,20 +1399,22 @@ surface_pressure_residual(bool request_jacobian,
         for ( unsigned int i_nd=0; i_nd<n_phi; i_nd++ )
             phi_vec(i_nd) = phi[i_nd][qp];
         
-        Bmat.reinit(2*n1, phi_vec);
+        Bmat[qp].reinit(2*n1, phi_vec);
+        Bmat_ptr[qp] = &Bmat[qp];
         
         // get pressure value
         func(pt, _time, press);
         
         // calculate force
         for (unsigned int i_dim=0; i_dim<n1; i_dim++)
-            force(i_dim) = press * normal(i_dim);
+            force(i_dim, qp) = press * normal(i_dim);
         
-        Bmat.vector_mult_transpose(vec_n2, force);
-        
-        local_f += JxW[qp] * vec_n2;
+        w(qp) = JxW[qp];
     }
     
+    Bmat_batch.reinit(Bmat_ptr);
+    Bmat_batch.vector_mult_transpose_sum(local_f, force, w);
+    
     // now transform to the global system and add
     transform_vector_to_global_system(local_f, vec_n2);
     f -= vec_n2;
@@ -1431,24 +1682,37 @@ transform_matrix_to_global_system(const ValType& local_mat,
     libmesh_assert_equal_to(global_mat.rows(), global_mat.cols());
     libmesh_assert_equal_to( local_mat.rows(), global_mat.rows());
     
-    const unsigned int n_dofs = _fe->n_shape_functions();
-
-    ValType mat(6*n_dofs, 6*n_dofs);
-    
-    mat.setZero();
-    global_mat.setZero();
+    typedef typename ValType::Scalar ScalarType;
     
-    const RealMatrixX& Tmat = this->local_elem().T_matrix();
-    // now initialize the global T matrix
-    for (unsigned int i=0; i<n_dofs; i++)
-        for (unsigned int j=0; j<3; j++)
-            for (unsigned int k=0; k<3; k++) {
-                mat(j*n_dofs+i, k*n_dofs+i) = Tmat(j,k); // for u,v,w
-                mat((j+3)*n_dofs+i, (k+3)*n_dofs+i) = Tmat(j,k); // for tx,ty,tz
-            }
+    const unsigned int n_dofs = _fe->n_shape_functions();
     
-    // right multiply with T^tr, and left multiply with T.
-    global_mat = mat * local_mat * mat.transpose();
+    libmesh_assert_equal_to(local_mat.rows(), 6*n_dofs);
+    
+    // the transformation matrix is block-diagonal, with the 3x3 matrix T
+    // coupling the u,v,w and the tx,ty,tz dofs at each node. So, the
+    // product T [local] T^tr is computed one 3x3 block at a time with
+    // fixed-size matrices, instead of a product with 6n x 6n matrices.
+    const Matrix<ScalarType, 3, 3>
+    T = this->local_elem().T_matrix().cast<ScalarType>();
+    
+    Matrix<ScalarType, 3, 3>
+    blk;
+    
+    for (unsigned int p=0; p<2; p++)     // translation/rotation rows
+        for (unsigned int q=0; q<2; q++) // translation/rotation columns
+            for (unsigned int i=0; i<n_dofs; i++)
+                for (unsigned int l=0; l<n_dofs; l++) {
+                    
+                    for (unsigned int j=0; j<3; j++)
+                        for (unsigned int k=0; k<3; k++)
+                            blk(j,k) = local_mat((3*p+j)*n_dofs+i, (3*q+k)*n_dofs+l);
+                    
+                    blk = (T * blk * T.transpose()).eval();
+                    
+                    for (unsigned int j=0; j<3; j++)
+                        for (unsigned int k=0; k<3; k++)
+                            global_mat((3*p+j)*n_dofs+i, (3*q+k)*n_dofs+l) = blk(j,k);
+                }
 }
 
 
@@ -1461,22 +1725,30 @@ transform_vector_to_local_system(const ValType& global_vec,
     
     libmesh_assert_equal_to( local_vec.size(),  global_vec.size());
     
+    typedef typename ValType::Scalar ScalarType;
+    
     const unsigned int n_dofs = _fe->n_shape_functions();
-    RealMatrixX mat  = RealMatrixX::Zero(6*n_dofs, 6*n_dofs);
     
-    local_vec.setZero();
-
-    const RealMatrixX& Tmat = this->local_elem().T_matrix();
-    // now initialize the global T matrix
-    for (unsigned int i=0; i<n_dofs; i++)
-        for (unsigned int j=0; j<3; j++)
-            for (unsigned int k=0; k<3; k++) {
-                mat(j*n_dofs+i, k*n_dofs+i) = Tmat(j,k); // for u,v,w
-                mat((j+3)*n_dofs+i, (k+3)*n_dofs+i) = Tmat(j,k); // for tx,ty,tz
-            }
+    libmesh_assert_equal_to(global_vec.size(), 6*n_dofs);
     
-    // left multiply with T^tr
-    local_vec = mat.transpose() * global_vec;
+    // left multiply with T^tr, one node and 3-vector at a time
+    const Matrix<ScalarType, 3, 3>
+    T = this->local_elem().T_matrix().cast<ScalarType>();
+    
+    Matrix<ScalarType, 3, 1>
+    v;
+    
+    for (unsigned int p=0; p<2; p++)   // translation/rotation
+        for (unsigned int i=0; i<n_dofs; i++) {
+            
+            for (unsigned int j=0; j<3; j++)
+                v(j) = global_vec((3*p+j)*n_dofs+i);
+            
+            v = (T.transpose() * v).eval();
+            
+            for (unsigned int j=0; j<3; j++)
+                local_vec((3*p+j)*n_dofs+i) = v(j);
+        }
 }
 
 
@@ -1489,23 +1761,30 @@ transform_vector_to_global_system(const ValType& local_vec,
     
     libmesh_assert_equal_to( local_vec.size(),  global_vec.size());
     
+    typedef typename ValType::Scalar ScalarType;
+    
     const unsigned int n_dofs = _fe->n_shape_functions();
-
-    RealMatrixX mat  = RealMatrixX::Zero(6*n_dofs, 6*n_dofs);
-
-    global_vec.setZero();
     
-    const RealMatrixX& Tmat = this->local_elem().T_matrix();
-    // now initialize the global T matrix
-    for (unsigned int i=0; i<n_dofs; i++)
-        for (unsigned int j=0; j<3; j++)
-            for (unsigned int k=0; k<3; k++) {
-                mat(j*n_dofs+i, k*n_dofs+i) = Tmat(j,k); // for u,v,w
-                mat((j+3)*n_dofs+i, (k+3)*n_dofs+i) = Tmat(j,k); // for tx,ty,tz
-            }
+    libmesh_assert_equal_to(local_vec.size(), 6*n_dofs);
     
-    // left multiply with T
-    global_vec = mat* local_vec;
+    // left multiply with T, one node and 3-vector at a time
+    const Matrix<ScalarType, 3, 3>
+    T = this->local_elem().T_matrix().cast<ScalarType>();
+    
+    Matrix<ScalarType, 3, 1>
+    v;
+    
+    for (unsigned int p=0; p<2; p++)   // translation/rotation
+        for (unsigned int i=0; i<n_dofs; i++) {
+            
+            for (unsigned int j=0; j<3; j++)
+                v(j) = local_vec((3*p+j)*n_dofs+i);
+            
+            v = (T * v).eval();
+            
+            for (unsigned int j=0; j<3; j++)
+                global_vec((3*p+j)*n_dofs+i) = v(j);
+        }
 }
 
 
@@ -26,6 +26,8 @@
 
 // MAST includes
 #include "base/elem_base.h"
+#include "property_cards/element_property_card_base.h"
+#include "base/wetted_surface.h"
 
 
 namespace MAST {
@@ -36,6 +38,81 @@ namespace MAST {
     class BoundaryConditionBase;
     class FEMOperatorMatrix;
     class OutputFunctionBase;
+    struct IncompatibleModeData;
+    template <typename ValType> class FieldFunction;
+    
+    
+    /*!
+     *   thermal load of an element for a temperature boundary condition,
+     *   retained between assembly calls while the temperature field does
+     *   not change. See MAST::StructuralNonlinearAssembly::set_thermal_load_cache()
+     */
+    struct ThermalLoadData {
+        
+        ThermalLoadData(): valid(false), time(0.) { }
+        
+        /*!
+         *   \p true if the data below was computed for the current
+         *   temperature field
+         */
+        bool          valid;
+        
+        /*!
+         *   time at which the data was computed
+         */
+        Real          time;
+        
+        /*!
+         *   thermal stress [C]{alpha (T - T0)} at each quadrature point,
+         *   stored column-wise. For 1D and 2D elements this is the
+         *   membrane stress resultant.
+         */
+        RealMatrixX   stress;
+        
+        /*!
+         *   part of the thermal load that does not depend on the solution,
+         *   in the global coordinate system. This is empty if all of the
+         *   thermal load depends on the solution.
+         */
+        RealVectorX   f;
+    };
+    
+    
+    /*!
+     *   thermal load data of an element for each temperature boundary
+     *   condition
+     */
+    typedef std::map<const MAST::BoundaryConditionBase*, MAST::ThermalLoadData>
+    ThermalLoadCache;
+    
+    
+    /*!
+     *   linear part of the internal stiffness of an element with von
+     *   Karman strain, retained between evaluations of internal_residual()
+     *   while the section properties do not change. See
+     *   MAST::StructuralNonlinearAssembly::set_linear_stiffness_cache()
+     */
+    struct LinearStiffnessData {
+        
+        LinearStiffnessData(): valid(false), time(0.) { }
+        
+        /*!
+         *   \p true if the matrix below was computed for the current
+         *   section properties
+         */
+        bool          valid;
+        
+        /*!
+         *   time at which the matrix was computed
+         */
+        Real          time;
+        
+        /*!
+         *   membrane, bending, coupling and transverse shear stiffness in
+         *   the local coordinate system of the element
+         */
+        RealMatrixX   jac;
+    };
     
     
     class StructuralElementBase:
@@ -120,6 +197,12 @@ namespace MAST {
         }
         
         
+        /*!
+         *   clears the stored global locations of the quadrature points
+         */
+        virtual void clear_geometry_cache();
+        
+        
         /*!
          *   internal force contribution to system residual
          */
@@ -127,6 +210,21 @@ namespace MAST {
                                         RealVectorX& f,
                                         RealMatrixX& jac) = 0;
 
+        /*!
+         *   internal force and volume external force contributions to
+         *   system residual. The default implementation calls
+         *   internal_residual() and volume_external_residual(). Elements
+         *   can reimplement this to evaluate some of the loads in the
+         *   quadrature loop of the internal residual.
+         */
+        virtual bool
+        internal_and_volume_external_residual
+        (bool request_jacobian,
+         RealVectorX& f,
+         RealMatrixX& jac_xdot,
+         RealMatrixX& jac,
+         std::multimap<libMesh::subdomain_id_type, MAST::BoundaryConditionBase*>& bc);
+
         /*!
          *   internal force contribution to system residual of the linearized
          *   problem
@@ -242,13 +340,16 @@ namespace MAST {
          *   volume external force contribution to system residual. If 
          *   requested, the Jacobians of the residual due to xdot will be 
          *   returned in \p jac_xdot and the Jacobian due to x is
-         *   returned in jac.
+         *   returned in jac. The piston theory loads are skipped if
+         *   \p if_piston_theory is false, which is used by elements that
+         *   evaluate these with the internal residual.
          */
         bool volume_external_residual (bool request_jacobian,
                                        RealVectorX& f,
                                        RealMatrixX& jac_xdot,
                                        RealMatrixX& jac,
-                                       std::multimap<libMesh::subdomain_id_type, MAST::BoundaryConditionBase*>& bc);
+                                       std::multimap<libMesh::subdomain_id_type, MAST::BoundaryConditionBase*>& bc,
+                                       bool if_piston_theory = true);
 
         /*!
          *   volume external force contribution to system residual. If
@@ -295,6 +396,22 @@ namespace MAST {
         virtual bool internal_residual_sensitivity (bool request_jacobian,
                                                     RealVectorX& f,
                                                     RealMatrixX& jac) = 0;
+        
+        /*!
+         *   sensitivity of the internal force contribution to system
+         *   residual for each parameter in \p params, which is added to
+         *   \p f[i] and, if \p request_jacobian is \p true, to \p jac[i]
+         *   for the i^th parameter. \p f and \p jac must have the size of
+         *   \p params. The default implementation calls
+         *   internal_residual_sensitivity() for each parameter. Elements
+         *   can reimplement this to compute the sensitivities for all
+         *   parameters in one pass over the quadrature points.
+         */
+        virtual void
+        internal_residual_sensitivities (const std::vector<const MAST::FunctionBase*>& params,
+                                         bool request_jacobian,
+                                         std::vector<RealVectorX>& f,
+                                         std::vector<RealMatrixX>& jac);
 
         /*!
          *   sensitivity of the damping force contribution to system residual
@@ -364,7 +481,45 @@ namespace MAST {
          *  original vector
          */
         void set_incompatible_mode_solution(RealVectorX& vec) {
-            _incompatible_sol = &vec;
+            _incompatible_sol  = &vec;
+            _incompatible_data = nullptr;
+        }
+        
+        
+        /*!
+         *  sets the pointer to the persistent incompatible mode data of
+         *  this element, which provides the incompatible mode solution
+         *  along with the condensed incompatible mode stiffness retained
+         *  from prior evaluations. This replaces the vector provided by
+         *  set_incompatible_mode_solution().
+         */
+        void set_incompatible_mode_data(MAST::IncompatibleModeData& d) {
+            _incompatible_sol  = nullptr;
+            _incompatible_data = &d;
+        }
+        
+        
+        /*!
+         *  sets the pointer to the thermal load data retained for this
+         *  element from prior evaluations of thermal_residual(). The
+         *  data is used by thermal_residual() if it is valid, and is
+         *  computed otherwise. Setting \p nullptr evaluates the thermal
+         *  load without the retained data.
+         */
+        void set_thermal_load_cache(MAST::ThermalLoadCache* c) {
+            _thermal_load_cache = c;
+        }
+        
+        
+        /*!
+         *  sets the pointer to the linear stiffness retained for this
+         *  element from prior evaluations of internal_residual(). For von
+         *  Karman strain, elements that support this compute the linear
+         *  stiffness once and later evaluate only the solution dependent
+         *  terms. Setting \p nullptr evaluates all terms.
+         */
+        void set_linear_stiffness_cache(MAST::LinearStiffnessData* d) {
+            _linear_stiffness = d;
         }
         
         
@@ -399,6 +554,97 @@ namespace MAST {
         
     protected:
         
+        /*!
+         *   @returns \p true if the stored geometric data can be used for
+         *   quadrature point data of \p fe. This is the case only for the
+         *   element domain finite element, and if the sensitivity is not
+         *   being computed for a shape parameter.
+         */
+        bool _use_geometry_cache(const libMesh::FEBase& fe) const;
+        
+        
+        /*!
+         *   sets [\p begin, \p end) to the loads of \p bc on the sides of
+         *   this element, other than Dirichlet conditions. The loads are
+         *   read from the wetted surface of the system if it was built from
+         *   \p bc, and are otherwise found from the boundary ids of the
+         *   sides and stored in \p storage.
+         */
+        void _side_loads(const MAST::SideBCMapType& bc,
+                         std::vector<MAST::WettedSurface::SideLoad>& storage,
+                         const MAST::WettedSurface::SideLoad*& begin,
+                         const MAST::WettedSurface::SideLoad*& end) const;
+        
+        
+        /*!
+         *   @returns a pointer to the incompatible mode solution values,
+         *   which are provided either by the persistent incompatible mode
+         *   data or the incompatible mode solution vector.
+         */
+        Real* _incompatible_mode_values();
+        
+        
+        /*!
+         *   @returns a pointer to the retained thermal load data of this
+         *   element for \p bc, or \p nullptr if the data is not retained.
+         *   The data is marked invalid if it was computed at a different
+         *   time.
+         */
+        MAST::ThermalLoadData*
+        _thermal_load_data(const MAST::BoundaryConditionBase& bc);
+        
+        
+        /*!
+         *   @returns a pointer to the retained linear stiffness of this
+         *   element, or \p nullptr if it is not retained. The data is
+         *   marked invalid if it was computed at a different time.
+         */
+        MAST::LinearStiffnessData* _linear_stiffness_data();
+        
+        
+        /*!
+         *   replaces the consistent mass matrix \p m of the element with
+         *   the diagonal matrix of lumping scheme \p s. \p n_phi is the
+         *   number of shape functions of each variable.
+         */
+        void _lump_mass_matrix(MAST::MassLumpingScheme s,
+                               unsigned int n_phi,
+                               RealMatrixX& m) const;
+        
+        
+        /*!
+         *   computes the mass matrix of the shape functions of a variable,
+         *   \f$ m_{ab} = \int_\Omega \phi_a \phi_b d\Omega \f$, in
+         *   \p m. The default implementation integrates this with the
+         *   quadrature rule of the element. Elements can reimplement this
+         *   with a closed form expression.
+         */
+        virtual void _shape_function_mass_matrix(RealMatrixX& m);
+        
+        
+        /*!
+         *   computes the temperature at the quadrature points of \p fe in
+         *   \p temp directly from the nodal values of the thermal system,
+         *   if \p temp_func is a MAST::SameMeshFieldFunction with the FE
+         *   type of \p fe. @returns \p false otherwise, in which case
+         *   \p temp_func should be evaluated at the quadrature point
+         *   locations.
+         */
+        bool _direct_qp_temperature(const MAST::FieldFunction<Real>& temp_func,
+                                    const libMesh::FEBase& fe,
+                                    std::vector<Real>& temp) const;
+        
+        
+        /*!
+         *   calculates the location \p p of quadrature point \p qp of
+         *   \p fe in the global coordinate system, using the stored value
+         *   if the geometric data is being stored.
+         */
+        void _global_qp_location(const libMesh::FEBase& fe,
+                                 unsigned int qp,
+                                 libMesh::Point& p);
+        
+        
         /*!
          *    Calculates the force vector and Jacobian due to surface pressure.
          */
@@ -625,6 +871,13 @@ namespace MAST {
         const MAST::ElementPropertyCardBase& _property;
         
         
+        /*!
+         *   global locations of the quadrature points of the element
+         *   domain finite element, if the geometric data is stored
+         */
+        std::vector<libMesh::Point> _qp_global_xyz;
+        
+        
         /*!
          *   local solution
          */
@@ -702,6 +955,24 @@ namespace MAST {
          */
         RealVectorX* _incompatible_sol;
         
+        
+        /*!
+         *   persistent incompatible mode data, if provided
+         */
+        MAST::IncompatibleModeData* _incompatible_data;
+        
+        
+        /*!
+         *   retained thermal load data, if provided
+         */
+        MAST::ThermalLoadCache* _thermal_load_cache;
+        
+        
+        /*!
+         *   retained linear stiffness, if provided
+         */
+        MAST::LinearStiffnessData* _linear_stiffness;
+        
     };
     
     
@@ -29,6 +29,7 @@
 #include "numerics/utility.h"
 #include "base/real_output_function.h"
 #include "base/nonlinear_system.h"
+#include "base/performance_log.h"
 
 
 // libMesh includes
@@ -120,6 +121,32 @@ MAST::StructuralFluidInteractionAssembly::clear_base_solution(bool if_sens) {
 
 
 
+bool
+MAST::StructuralFluidInteractionAssembly::
+if_linearized_about_nonzero_solution() const {
+    
+    return _base_sol != nullptr;
+}
+
+
+
+const libMesh::NumericVector<Real>&
+MAST::StructuralFluidInteractionAssembly::base_sol(bool if_sens) const {
+    
+    if (!if_sens) {
+        
+        libmesh_assert(_base_sol);
+        return *_base_sol;
+    }
+    else {
+        
+        libmesh_assert(_base_sol_sensitivity);
+        return *_base_sol_sensitivity;
+    }
+}
+
+
+
 
 void
 MAST::StructuralFluidInteractionAssembly::
@@ -140,6 +167,8 @@ assemble_reduced_order_quantity
 (std::vector<libMesh::NumericVector<Real>*>& basis,
  std::map<MAST::StructuralQuantityType, RealMatrixX*>& mat_qty_map) {
     
+    MAST_LOG_SCOPE("assemble_reduced_order_quantity()", "StructuralFluidInteractionAssembly");
+    
     MAST::NonlinearSystem& nonlin_sys = _system->system();
     
     unsigned int
@@ -156,21 +185,23 @@ assemble_reduced_order_quantity
     // iterate over each element, initialize it and get the relevant
     // analysis quantities
     RealVectorX vec, sol;
-    RealMatrixX mat, basis_mat;
+    RealMatrixX mat, basis_mat, stacked_mat;
     
-    std::vector<libMesh::dof_id_type> dof_indices;
+    std::vector<libMesh::dof_id_type> dof_indices, c_dof_indices;
     const libMesh::DofMap& dof_map = nonlin_sys.get_dof_map();
-    std::auto_ptr<MAST::ElementBase> physics_elem;
+    const MAST::ElementTopologyCache& topology = nonlin_sys.topology_cache();
+    std::auto_ptr<MAST::ElementBase> elem_storage;
+    MAST::ElementBase* physics_elem = nullptr;
+    DenseRealMatrix m;
     
     std::auto_ptr<libMesh::NumericVector<Real> > localized_solution;
     if (_base_sol)
         localized_solution.reset(_build_localized_vector(nonlin_sys,
                                                          *_base_sol).release());
     
-    // also create localized solution vectos for the bassis vectors
-    std::vector<libMesh::NumericVector<Real>*> localized_basis(n_basis);
-    for (unsigned int i=0; i<n_basis; i++)
-        localized_basis[i] = _build_localized_vector(nonlin_sys, *basis[i]).release();
+    // the basis vectors are localized together
+    MAST::AssemblyBase::LocalizedBasis localized_basis;
+    _build_localized_basis(nonlin_sys, basis, localized_basis);
     
     
     // if a solution function is attached, initialize it
@@ -183,32 +214,145 @@ assemble_reduced_order_quantity
     const libMesh::MeshBase::const_element_iterator end_el =
     nonlin_sys.get_mesh().active_local_elements_end();
     
+    std::vector<RealMatrixX*> qty_mats;
     
     for ( ; el != end_el; ++el) {
         
         const libMesh::Elem* elem = *el;
         
-        dof_map.dof_indices (elem, dof_indices);
+        topology.dof_indices (elem, dof_indices);
         
-        physics_elem.reset(_build_elem(*elem).release());
+        physics_elem = &_get_elem(*elem, elem_storage);
         
         // get the solution
         unsigned int ndofs = (unsigned int)dof_indices.size();
         sol.setZero(ndofs);
         vec.setZero(ndofs);
         mat.setZero(ndofs, ndofs);
-        basis_mat.setZero(ndofs, n_basis);
         
-        for (unsigned int i=0; i<dof_indices.size(); i++) {
+        if (_base_sol)
+            _get_elem_values(*localized_solution, dof_indices, sol);
+        
+        physics_elem->set_solution(sol);
+        physics_elem->set_velocity(vec);     // set to zero value
+        physics_elem->set_acceleration(vec); // set to zero value
+        
+        
+        if (_sol_function)
+            physics_elem->attach_active_solution_function(*_sol_function);
+        
+        // the constrained matrices of all qty types in the map are
+        // stacked, and projected together
+        qty_mats.clear();
+        unsigned int nq = 0;
+        
+        it   = mat_qty_map.begin(),
+        end  = mat_qty_map.end();
+        
+        for ( ; it != end; it++, nq++) {
             
-            if (_base_sol)
-                sol(i) = (*localized_solution)(dof_indices[i]);
+            _qty_type = it->first;
+            _elem_calculations(*physics_elem, true, vec, mat);
             
+            c_dof_indices = dof_indices;
+            MAST::copy(m, mat);
+            dof_map.constrain_element_matrix(m, c_dof_indices);
+            MAST::copy(mat, m);
             
-            for (unsigned int j=0; j<n_basis; j++)
-                basis_mat(i,j) = (*localized_basis[j])(dof_indices[i]);
+            if (!nq)
+                stacked_mat.setZero(mat.rows()*mat_qty_map.size(), mat.cols());
+            stacked_mat.middleRows(nq*mat.rows(), mat.rows()) = mat;
+            qty_mats.push_back(it->second);
         }
         
+        physics_elem->detach_active_solution_function();
+        
+        if (nq)
+            _add_reduced_order_quantities(localized_basis, c_dof_indices,
+                                          stacked_mat, basis_mat, qty_mats);
+    }
+    
+    
+    // if a solution function is attached, clear it
+    if (_sol_function)
+        _sol_function->clear();
+    
+
+    // sum the matrix and provide it to each processor
+    it  = mat_qty_map.begin(),
+    end = mat_qty_map.end();
+    
+    
+    for ( ; it != end; it++)
+        MAST::parallel_sum(_system->system().comm(), *(it->second));
+}
+
+
+
+
+
+void
+MAST::StructuralFluidInteractionAssembly::
+assemble_quantity
+(std::map<MAST::StructuralQuantityType, libMesh::SparseMatrix<Real>*>& mat_qty_map) {
+    
+    MAST_LOG_SCOPE("assemble_quantity()", "StructuralFluidInteractionAssembly");
+    
+    MAST::NonlinearSystem& nonlin_sys = _system->system();
+    
+    // initialize the quantities to zero matrices
+    std::map<MAST::StructuralQuantityType, libMesh::SparseMatrix<Real>*>::iterator
+    it  = mat_qty_map.begin(),
+    end = mat_qty_map.end();
+    
+    for ( ; it != end; it++)
+        it->second->zero();
+    
+    // iterate over each element, initialize it and get the relevant
+    // analysis quantities
+    RealVectorX vec, sol;
+    RealMatrixX mat;
+    
+    std::vector<libMesh::dof_id_type> dof_indices;
+    const libMesh::DofMap& dof_map = nonlin_sys.get_dof_map();
+    const MAST::ElementTopologyCache& topology = nonlin_sys.topology_cache();
+    std::auto_ptr<MAST::ElementBase> elem_storage;
+    MAST::ElementBase* physics_elem = nullptr;
+    DenseRealMatrix m;
+    
+    std::auto_ptr<libMesh::NumericVector<Real> > localized_solution;
+    if (_base_sol)
+        localized_solution.reset(_build_localized_vector(nonlin_sys,
+                                                         *_base_sol).release());
+    
+    // if a solution function is attached, initialize it
+    if (_sol_function && _base_sol)
+        _sol_function->init( *_base_sol);
+    
+    
+    libMesh::MeshBase::const_element_iterator       el     =
+    nonlin_sys.get_mesh().active_local_elements_begin();
+    const libMesh::MeshBase::const_element_iterator end_el =
+    nonlin_sys.get_mesh().active_local_elements_end();
+    
+    
+    for ( ; el != end_el; ++el) {
+        
+        const libMesh::Elem* elem = *el;
+        
+        topology.dof_indices (elem, dof_indices);
+        
+        physics_elem = &_get_elem(*elem, elem_storage);
+        
+        // get the solution
+        unsigned int ndofs = (unsigned int)dof_indices.size();
+        sol.setZero(ndofs);
+        vec.setZero(ndofs);
+        mat.setZero(ndofs, ndofs);
+        
+        if (_base_sol)
+            _get_elem_values(*localized_solution, dof_indices, sol);
+        
         physics_elem->set_solution(sol);
         physics_elem->set_velocity(vec);     // set to zero value
         physics_elem->set_acceleration(vec); // set to zero value
@@ -226,13 +370,17 @@ assemble_reduced_order_quantity
             _qty_type = it->first;
             _elem_calculations(*physics_elem, true, vec, mat);
             
-            DenseRealMatrix m;
             MAST::copy(m, mat);
             dof_map.constrain_element_matrix(m, dof_indices);
-            MAST::copy(mat, m);
             
-            // now add to the reduced order matrix
-            (*it->second) += basis_mat.transpose() * mat * basis_mat;
+            // the constraint puts a unit diagonal on the constrained
+            // dofs, which is retained only for the stiffness matrix
+            if (_qty_type != MAST::STIFFNESS)
+                for (unsigned int i=0; i<ndofs; i++)
+                    if (dof_map.is_constrained_dof(dof_indices[i]))
+                        m(i, i) = 0.;
+            
+            it->second->add_matrix(m, dof_indices);
         }
         
         physics_elem->detach_active_solution_function();
@@ -245,17 +393,11 @@ assemble_reduced_order_quantity
         _sol_function->clear();
     
     
-    // delete the localized basis vectors
-    for (unsigned int i=0; i<basis.size(); i++)
-        delete localized_basis[i];
-
-    // sum the matrix and provide it to each processor
     it  = mat_qty_map.begin(),
     end = mat_qty_map.end();
     
-    
     for ( ; it != end; it++)
-        MAST::parallel_sum(_system->system().comm(), *(it->second));
+        it->second->close();
 }
 
 
@@ -270,6 +412,7 @@ assemble_reduced_order_quantity_sensitivity
  std::vector<libMesh::NumericVector<Real>*>& basis,
  std::map<MAST::StructuralQuantityType, RealMatrixX*>& mat_qty_map) {
     
+    MAST_LOG_SCOPE("assemble_reduced_order_quantity_sensitivity()", "StructuralFluidInteractionAssembly");
     
     MAST::NonlinearSystem& nonlin_sys = _system->system();
     
@@ -288,11 +431,14 @@ assemble_reduced_order_quantity_sensitivity
     // iterate over each element, initialize it and get the relevant
     // analysis quantities
     RealVectorX vec, sol, dsol;
-    RealMatrixX mat, basis_mat;
+    RealMatrixX mat, basis_mat, stacked_mat;
     
-    std::vector<libMesh::dof_id_type> dof_indices;
+    std::vector<libMesh::dof_id_type> dof_indices, c_dof_indices;
     const libMesh::DofMap& dof_map = _system->system().get_dof_map();
-    std::auto_ptr<MAST::ElementBase> physics_elem;
+    const MAST::ElementTopologyCache& topology = _system->system().topology_cache();
+    std::auto_ptr<MAST::ElementBase> elem_storage;
+    MAST::ElementBase* physics_elem = nullptr;
+    DenseRealMatrix m;
     
     std::auto_ptr<libMesh::NumericVector<Real> >
     localized_solution,
@@ -309,10 +455,9 @@ assemble_reduced_order_quantity_sensitivity
                                                               *_base_sol_sensitivity).release());
     }
     
-    // also create localized solution vectos for the bassis vectors
-    std::vector<libMesh::NumericVector<Real>*> localized_basis(n_basis);
-    for (unsigned int i=0; i<n_basis; i++)
-        localized_basis[i] = _build_localized_vector(nonlin_sys, *basis[i]).release();
+    // the basis vectors are localized together
+    MAST::AssemblyBase::LocalizedBasis localized_basis;
+    _build_localized_basis(nonlin_sys, basis, localized_basis);
     
     
     // if a solution function is attached, initialize it
@@ -320,19 +465,40 @@ assemble_reduced_order_quantity_sensitivity
         _sol_function->init( *_base_sol);
     
     
-    libMesh::MeshBase::const_element_iterator       el     =
-    nonlin_sys.get_mesh().active_local_elements_begin();
-    const libMesh::MeshBase::const_element_iterator end_el =
-    nonlin_sys.get_mesh().active_local_elements_end();
+    const MAST::FunctionBase* f = _discipline->get_parameter(&(parameters[i].get()));
+    
+    // without a base solution only the elements that depend on the
+    // parameter contribute to the sensitivity. Otherwise, the base solution
+    // sensitivity contributes on all elements.
+    std::vector<const libMesh::Elem*> all_elems;
+    
+    if (_base_sol) {
+        
+        libMesh::MeshBase::const_element_iterator       el     =
+        nonlin_sys.get_mesh().active_local_elements_begin();
+        const libMesh::MeshBase::const_element_iterator end_el =
+        nonlin_sys.get_mesh().active_local_elements_end();
+        
+        for ( ; el != end_el; ++el)
+            all_elems.push_back(*el);
+    }
+    
+    const std::vector<const libMesh::Elem*>&
+    elems = _base_sol ? all_elems : _discipline->get_dependent_local_elems(*f);
+    
+    std::vector<const libMesh::Elem*>::const_iterator
+    el     = elems.begin(),
+    end_el = elems.end();
     
+    std::vector<RealMatrixX*> qty_mats;
     
     for ( ; el != end_el; ++el) {
         
         const libMesh::Elem* elem = *el;
         
-        dof_map.dof_indices (elem, dof_indices);
+        topology.dof_indices (elem, dof_indices);
         
-        physics_elem.reset(_build_elem(*elem).release());
+        physics_elem = &_get_elem(*elem, elem_storage);
         
         // get the solution
         unsigned int ndofs = (unsigned int)dof_indices.size();
@@ -340,21 +506,14 @@ assemble_reduced_order_quantity_sensitivity
         dsol.setZero(ndofs);
         vec.setZero(ndofs);
         mat.setZero(ndofs, ndofs);
-        basis_mat.setZero(ndofs, n_basis);
         
-        for (unsigned int i=0; i<dof_indices.size(); i++) {
+        if (_base_sol) {
             
-            if (_base_sol) {
-                
-                sol(i)  = (*localized_solution)(dof_indices[i]);
-                dsol(i) = (*localized_solution_sens)(dof_indices[i]);
-            }
-            
-            for (unsigned int j=0; j<n_basis; j++)
-                basis_mat(i,j) = (*localized_basis[j])(dof_indices[i]);
+            _get_elem_values(*localized_solution,      dof_indices, sol);
+            _get_elem_values(*localized_solution_sens, dof_indices, dsol);
         }
         
-        physics_elem->sensitivity_param  = _discipline->get_parameter(&(parameters[i].get()));
+        physics_elem->sensitivity_param  = f;
         physics_elem->set_solution(sol);
         physics_elem->set_solution(dsol, true);
         physics_elem->set_velocity(vec);     // set to zero value
@@ -364,26 +523,35 @@ assemble_reduced_order_quantity_sensitivity
         if (_sol_function)
             physics_elem->attach_active_solution_function(*_sol_function);
         
-        // now iterative over all qty types in the map and assemble them
+        // the constrained matrices of all qty types in the map are
+        // stacked, and projected together
+        qty_mats.clear();
+        unsigned int nq = 0;
+        
         it   = mat_qty_map.begin(),
         end  = mat_qty_map.end();
         
-        for ( ; it != end; it++) {
+        for ( ; it != end; it++, nq++) {
             
             _qty_type = it->first;
             _elem_sensitivity_calculations(*physics_elem, true, vec, mat);
 
-            DenseRealMatrix m;
+            c_dof_indices = dof_indices;
             MAST::copy(m, mat);
-            dof_map.constrain_element_matrix(m, dof_indices);
+            dof_map.constrain_element_matrix(m, c_dof_indices);
             MAST::copy(mat, m);
             
-            // now add to the reduced order matrix
-            (*it->second) += basis_mat.transpose() * mat * basis_mat;
+            if (!nq)
+                stacked_mat.setZero(mat.rows()*mat_qty_map.size(), mat.cols());
+            stacked_mat.middleRows(nq*mat.rows(), mat.rows()) = mat;
+            qty_mats.push_back(it->second);
         }
         
         physics_elem->detach_active_solution_function();
         
+        if (nq)
+            _add_reduced_order_quantities(localized_basis, c_dof_indices,
+                                          stacked_mat, basis_mat, qty_mats);
     }
     
     
@@ -392,10 +560,6 @@ assemble_reduced_order_quantity_sensitivity
         _sol_function->clear();
     
     
-    // delete the localized basis vectors
-    for (unsigned int i=0; i<basis.size(); i++)
-        delete localized_basis[i];
-    
     // sum the matrix and provide it to each processor
     it  = mat_qty_map.begin(),
     end = mat_qty_map.end();
@@ -409,6 +573,239 @@ assemble_reduced_order_quantity_sensitivity
 
 
 
+void
+MAST::StructuralFluidInteractionAssembly::
+assemble_reduced_order_quantity_sensitivity
+(const libMesh::ParameterVector& parameters,
+ std::vector<libMesh::NumericVector<Real>*>& basis,
+ const std::vector<const libMesh::NumericVector<Real>*>& dX_dp,
+ std::vector<std::map<MAST::StructuralQuantityType, RealMatrixX*> >& mat_qty_maps) {
+    
+    MAST_LOG_SCOPE("assemble_reduced_order_quantity_sensitivity_batch()",
+                   "StructuralFluidInteractionAssembly");
+    
+    libmesh_assert_equal_to(mat_qty_maps.size(), parameters.size());
+    libmesh_assert(!dX_dp.size() || dX_dp.size() == parameters.size());
+    
+    MAST::NonlinearSystem& nonlin_sys = _system->system();
+    
+    const unsigned int
+    n_basis  = (unsigned int)basis.size(),
+    n_params = parameters.size();
+    
+    std::vector<const MAST::FunctionBase*> f(n_params, nullptr);
+    
+    // initialize the quantities to zero matrices
+    std::map<MAST::StructuralQuantityType, RealMatrixX*>::iterator it, end;
+    
+    for (unsigned int i=0; i<n_params; i++) {
+        
+        f[i] = _discipline->get_parameter(&(parameters[i].get()));
+        
+        it  = mat_qty_maps[i].begin();
+        end = mat_qty_maps[i].end();
+        
+        for ( ; it != end; it++)
+            *it->second = RealMatrixX::Zero(n_basis, n_basis);
+    }
+    
+    // iterate over each element, initialize it and get the relevant
+    // analysis quantities
+    RealVectorX vec, sol, dsol;
+    RealMatrixX mat, basis_mat, stacked_mat;
+    
+    std::vector<libMesh::dof_id_type> dof_indices, param_dof_indices;
+    const libMesh::DofMap& dof_map = nonlin_sys.get_dof_map();
+    const MAST::ElementTopologyCache& topology = nonlin_sys.topology_cache();
+    std::auto_ptr<MAST::ElementBase> elem_storage;
+    MAST::ElementBase* physics_elem = nullptr;
+    DenseRealMatrix m;
+    
+    std::auto_ptr<libMesh::NumericVector<Real> > localized_solution;
+    std::vector<libMesh::NumericVector<Real>*>
+    localized_solution_sens(n_params, nullptr);
+    
+    if (_base_sol) {
+        
+        localized_solution.reset(_build_localized_vector(nonlin_sys,
+                                                         *_base_sol).release());
+        
+        for (unsigned int i=0; i<dX_dp.size(); i++)
+            if (dX_dp[i])
+                localized_solution_sens[i] =
+                _build_localized_vector(nonlin_sys, *dX_dp[i]).release();
+    }
+    
+    // the basis vectors are localized together
+    MAST::AssemblyBase::LocalizedBasis localized_basis;
+    _build_localized_basis(nonlin_sys, basis, localized_basis);
+    
+    
+    // if a solution function is attached, initialize it
+    if (_sol_function && _base_sol)
+        _sol_function->init( *_base_sol);
+    
+    
+    // parameters that each element contributes to. Without a base
+    // solution sensitivity, only the elements that depend on the
+    // parameter contribute. Otherwise, the base solution sensitivity
+    // contributes on all elements.
+    std::map<const libMesh::Elem*, std::vector<unsigned int> > elem_params;
+    
+    for (unsigned int i=0; i<n_params; i++) {
+        
+        if (localized_solution_sens[i]) {
+            
+            libMesh::MeshBase::const_element_iterator       el     =
+            nonlin_sys.get_mesh().active_local_elements_begin();
+            const libMesh::MeshBase::const_element_iterator end_el =
+            nonlin_sys.get_mesh().active_local_elements_end();
+            
+            for ( ; el != end_el; ++el)
+                elem_params[*el].push_back(i);
+        }
+        else {
+            
+            const std::vector<const libMesh::Elem*>&
+            elems = _discipline->get_dependent_local_elems(*f[i]);
+            
+            for (unsigned int j=0; j<elems.size(); j++)
+                elem_params[elems[j]].push_back(i);
+        }
+    }
+    
+    std::map<const libMesh::Elem*, std::vector<unsigned int> >::const_iterator
+    el     = elem_params.begin(),
+    end_el = elem_params.end();
+    
+    std::vector<RealMatrixX*> qty_mats;
+    
+    for ( ; el != end_el; ++el) {
+        
+        const libMesh::Elem* elem = el->first;
+        const std::vector<unsigned int>& params = el->second;
+        
+        topology.dof_indices (elem, dof_indices);
+        
+        physics_elem = &_get_elem(*elem, elem_storage);
+        
+        // the solution is the same for all parameters
+        unsigned int ndofs = (unsigned int)dof_indices.size();
+        sol.setZero(ndofs);
+        vec.setZero(ndofs);
+        
+        if (_base_sol)
+            _get_elem_values(*localized_solution, dof_indices, sol);
+        
+        physics_elem->set_solution(sol);
+        physics_elem->set_velocity(vec);     // set to zero value
+        physics_elem->set_acceleration(vec); // set to zero value
+        
+        if (_sol_function)
+            physics_elem->attach_active_solution_function(*_sol_function);
+        
+        for (unsigned int p=0; p<params.size(); p++) {
+            
+            const unsigned int i = params[p];
+            
+            dsol.setZero(ndofs);
+            if (localized_solution_sens[i])
+                _get_elem_values(*localized_solution_sens[i], dof_indices, dsol);
+            
+            physics_elem->sensitivity_param  = f[i];
+            physics_elem->set_solution(dsol, true);
+            
+            // the constrained matrices of all qty types in the map are
+            // stacked, and projected together
+            qty_mats.clear();
+            unsigned int nq = 0;
+            
+            it   = mat_qty_maps[i].begin();
+            end  = mat_qty_maps[i].end();
+            
+            for ( ; it != end; it++, nq++) {
+                
+                vec.setZero(ndofs);
+                mat.setZero(ndofs, ndofs);
+                
+                _qty_type = it->first;
+                _elem_sensitivity_calculations(*physics_elem, true, vec, mat);
+                
+                // the constraint may modify the dof indices, so a copy
+                // is used for each quantity.
+                param_dof_indices = dof_indices;
+                MAST::copy(m, mat);
+                dof_map.constrain_element_matrix(m, param_dof_indices);
+                MAST::copy(mat, m);
+                
+                if (!nq)
+                    stacked_mat.setZero(mat.rows()*mat_qty_maps[i].size(), mat.cols());
+                stacked_mat.middleRows(nq*mat.rows(), mat.rows()) = mat;
+                qty_mats.push_back(it->second);
+            }
+            
+            if (nq)
+                _add_reduced_order_quantities(localized_basis, param_dof_indices,
+                                              stacked_mat, basis_mat, qty_mats);
+        }
+        
+        physics_elem->detach_active_solution_function();
+    }
+    
+    
+    // if a solution function is attached, clear it
+    if (_sol_function)
+        _sol_function->clear();
+    
+    
+    // delete the localized vectors
+    for (unsigned int i=0; i<n_params; i++)
+        delete localized_solution_sens[i];
+    
+    // sum the matrix and provide it to each processor
+    for (unsigned int i=0; i<n_params; i++) {
+        
+        it  = mat_qty_maps[i].begin();
+        end = mat_qty_maps[i].end();
+        
+        for ( ; it != end; it++)
+            MAST::parallel_sum(_system->system().comm(), *(it->second));
+    }
+}
+
+
+
+
+
+void
+MAST::StructuralFluidInteractionAssembly::
+_add_reduced_order_quantities(const MAST::AssemblyBase::LocalizedBasis& basis,
+                              const std::vector<libMesh::dof_id_type>& dof_indices,
+                              const RealMatrixX& stacked_mat,
+                              RealMatrixX& basis_mat,
+                              std::vector<RealMatrixX*>& qty_mats) const {
+    
+    const unsigned int
+    n = (unsigned int)dof_indices.size();
+    
+    libmesh_assert_equal_to(stacked_mat.rows(), n*qty_mats.size());
+    libmesh_assert_equal_to(stacked_mat.cols(), n);
+    
+    // the basis is gathered for the constrained dofs, which are the same
+    // for all quantities
+    _get_elem_values(basis, dof_indices, basis_mat);
+    
+    // one product of the stacked matrices with the basis, followed by
+    // the projection of each block
+    const RealMatrixX
+    k_phi = stacked_mat * basis_mat;
+    
+    for (unsigned int i=0; i<qty_mats.size(); i++)
+        qty_mats[i]->noalias() += basis_mat.transpose() * k_phi.middleRows(i*n, n);
+}
+
+
+
 std::auto_ptr<MAST::ElementBase>
 MAST::StructuralFluidInteractionAssembly::_build_elem(const libMesh::Elem& elem) {
     
@@ -470,18 +867,17 @@ _elem_calculations(MAST::ElementBase& elem,
 
             // create
             
-            e.internal_residual(true, vec, mat);
+            e.internal_and_volume_external_residual(true,
+                                                    vec,
+                                                    dummy,
+                                                    mat,
+                                                    _discipline->volume_loads());
             e.inertial_residual(true, vec, dummy, dummy, mat);
             e.side_external_residual(true,
                                      vec,
                                      dummy,
                                      mat,
                                      _discipline->side_loads());
-            e.volume_external_residual(true,
-                                       vec,
-                                       dummy,
-                                       mat,
-                                       _discipline->volume_loads());
         }
             break;
             
@@ -151,6 +151,19 @@ namespace MAST {
         
 
         
+        /*!
+         *   assembles the full order sparse matrices of the quantities in
+         *   \p mat_qty_map about the base solution. The matrices must be
+         *   initialized with the sparsity of the system dof map. The
+         *   constrained dofs have a unit diagonal in the stiffness matrix,
+         *   and a zero diagonal in the mass and damping matrices, so that
+         *   they do not contribute finite eigenvalues.
+         */
+        virtual void
+        assemble_quantity
+        (std::map<MAST::StructuralQuantityType, libMesh::SparseMatrix<Real>*>& mat_qty_map);
+        
+        
         /*!
          *   calculates the sensitivity of reduced order matrix given the basis 
          *   provided in \par basis. \par X is the steady state solution about which
@@ -165,9 +178,43 @@ namespace MAST {
          std::map<MAST::StructuralQuantityType, RealMatrixX*>& mat_qty_map);
 
         
+        /*!
+         *   calculates the sensitivity of the reduced order matrices with
+         *   respect to all parameters in \p parameters with a single pass
+         *   over the elements. The matrices for \p parameters[i] are
+         *   returned in \p mat_qty_maps[i]. If the eigenproblem is
+         *   linearized about a base solution, \p dX_dp[i] is the
+         *   sensitivity of the base solution for \p parameters[i], and
+         *   a nullptr entry (or an empty vector) is treated as a zero
+         *   sensitivity. Each element is initialized once and evaluated
+         *   only for the parameters that can change its quantities.
+         */
+        virtual void
+        assemble_reduced_order_quantity_sensitivity
+        (const libMesh::ParameterVector& parameters,
+         std::vector<libMesh::NumericVector<Real>*>& basis,
+         const std::vector<const libMesh::NumericVector<Real>*>& dX_dp,
+         std::vector<std::map<MAST::StructuralQuantityType, RealMatrixX*> >& mat_qty_maps);
+
+        
     protected:
         
         
+        /*!
+         *   gathers the basis for the constrained \p dof_indices of an
+         *   element into \p basis_mat, and adds the projection of each
+         *   element matrix stacked in \p stacked_mat to the reduced
+         *   matrix of the same index in \p qty_mats. The stacked matrices
+         *   are multiplied with the basis in one product.
+         */
+        void
+        _add_reduced_order_quantities(const MAST::AssemblyBase::LocalizedBasis& basis,
+                                      const std::vector<libMesh::dof_id_type>& dof_indices,
+                                      const RealMatrixX& stacked_mat,
+                                      RealMatrixX& basis_mat,
+                                      std::vector<RealMatrixX*>& qty_mats) const;
+        
+        
         /*!
          *   @returns a smart-pointer to a newly created element for
          *   calculation of element quantities.
@@ -25,6 +25,7 @@
 #include "base/nonlinear_system.h"
 #include "numerics/utility.h"
 #include "base/system_initialization.h"
+#include "base/performance_log.h"
 
 // libMesh includes
 #include "libmesh/numeric_vector.h"
@@ -51,6 +52,11 @@ MAST::StructuralModalEigenproblemAssembly::
 eigenproblem_assemble(libMesh::SparseMatrix<Real> *A,
                       libMesh::SparseMatrix<Real> *B)  {
     
+    // nothing to be done if the matrices were assembled for the
+    // current key
+    if (_if_matrix_key_valid(*A, *B))
+        return;
+    
     MAST::NonlinearSystem& eigen_sys =
     dynamic_cast<MAST::NonlinearSystem&>(_system->system());
     
@@ -75,7 +81,10 @@ eigenproblem_assemble(libMesh::SparseMatrix<Real> *A,
     RealMatrixX mat_A, mat_B;
     std::vector<libMesh::dof_id_type> dof_indices;
     const libMesh::DofMap& dof_map = eigen_sys.get_dof_map();
-    std::auto_ptr<MAST::ElementBase> physics_elem;
+    const MAST::ElementTopologyCache& topology = eigen_sys.topology_cache();
+    std::auto_ptr<MAST::ElementBase> elem_storage;
+    MAST::ElementBase* physics_elem = nullptr;
+    DenseRealMatrix A, B;
     
     libMesh::MeshBase::const_element_iterator       el     =
     eigen_sys.get_mesh().active_local_elements_begin();
@@ -86,9 +95,9 @@ eigenproblem_assemble(libMesh::SparseMatrix<Real> *A,
         
         const libMesh::Elem* elem = *el;
 
-        dof_map.dof_indices (elem, dof_indices);
+        topology.dof_indices (elem, dof_indices);
         
-        physics_elem.reset(_build_elem(*elem).release());
+        physics_elem = &_get_elem(*elem, elem_storage);
         
         // get the solution
         unsigned int ndofs = (unsigned int)dof_indices.size();
@@ -99,8 +108,7 @@ eigenproblem_assemble(libMesh::SparseMatrix<Real> *A,
         
         // if the base solution is provided, then tell the element about it
         if (_base_sol) {
-            for (unsigned int i=0; i<dof_indices.size(); i++)
-                sol(i) = (*localized_solution)(dof_indices[i]);
+            _get_elem_values(*localized_solution, dof_indices, sol);
         }
         
         physics_elem->set_solution(sol);
@@ -122,7 +130,6 @@ eigenproblem_assemble(libMesh::SparseMatrix<Real> *A,
         _elem_calculations(*physics_elem, mat_A, mat_B);
         
         // copy to the libMesh matrix for further processing
-        DenseRealMatrix A, B;
         MAST::copy(A, mat_A);
         MAST::copy(B, mat_B);
         
@@ -131,8 +138,8 @@ eigenproblem_assemble(libMesh::SparseMatrix<Real> *A,
         dof_map.constrain_element_matrix(B, dof_indices);
         
         // add to the global matrices
-        matrix_A.add_matrix (A, dof_indices); // load independent
-        matrix_B.add_matrix (B, dof_indices); // load dependent
+        _add_elem_matrix(matrix_A, A, dof_indices, elem); // load independent
+        _add_elem_matrix(matrix_B, B, dof_indices, elem); // load dependent
     }
     
     // finalize the data structures
@@ -151,6 +158,10 @@ eigenproblem_sensitivity_assemble (const libMesh::ParameterVector& parameters,
                                    libMesh::SparseMatrix<Real>* sensitivity_A,
                                    libMesh::SparseMatrix<Real>* sensitivity_B)  {
     
+    // the sensitivity matrices are assembled in the matrices of the
+    // eigenproblem
+    this->clear_matrix_cache();
+    
     MAST::NonlinearSystem& eigen_sys =
     dynamic_cast<MAST::NonlinearSystem&>(_system->system());
     
@@ -183,7 +194,10 @@ eigenproblem_sensitivity_assemble (const libMesh::ParameterVector& parameters,
     RealMatrixX mat_A, mat_B;
     std::vector<libMesh::dof_id_type> dof_indices;
     const libMesh::DofMap& dof_map = eigen_sys.get_dof_map();
-    std::auto_ptr<MAST::ElementBase> physics_elem;
+    const MAST::ElementTopologyCache& topology = eigen_sys.topology_cache();
+    std::auto_ptr<MAST::ElementBase> elem_storage;
+    MAST::ElementBase* physics_elem = nullptr;
+    DenseRealMatrix A, B;
     
     libMesh::MeshBase::const_element_iterator       el     =
     eigen_sys.get_mesh().active_local_elements_begin();
@@ -194,9 +208,9 @@ eigenproblem_sensitivity_assemble (const libMesh::ParameterVector& parameters,
         
         const libMesh::Elem* elem = *el;
         
-        dof_map.dof_indices (elem, dof_indices);
+        topology.dof_indices (elem, dof_indices);
         
-        physics_elem.reset(_build_elem(*elem).release());
+        physics_elem = &_get_elem(*elem, elem_storage);
         
         // get the solution
         unsigned int ndofs = (unsigned int)dof_indices.size();
@@ -208,8 +222,7 @@ eigenproblem_sensitivity_assemble (const libMesh::ParameterVector& parameters,
         // if the base solution is provided, then tell the element about it
         if (_base_sol) {
             
-            for (unsigned int i=0; i<dof_indices.size(); i++)
-                sol(i) = (*localized_solution)(dof_indices[i]);
+            _get_elem_values(*localized_solution, dof_indices, sol);
         }
         
         physics_elem->sensitivity_param = _discipline->get_parameter(&(parameters[i].get()));
@@ -220,8 +233,7 @@ eigenproblem_sensitivity_assemble (const libMesh::ParameterVector& parameters,
         // set the element's base solution sensitivity
         if (_base_sol) {
             
-            for (unsigned int i=0; i<dof_indices.size(); i++)
-                sol(i) = (*localized_solution_sens)(dof_indices[i]);
+            _get_elem_values(*localized_solution_sens, dof_indices, sol);
         }
         physics_elem->set_solution(sol, true);
         
@@ -239,7 +251,6 @@ eigenproblem_sensitivity_assemble (const libMesh::ParameterVector& parameters,
         _elem_sensitivity_calculations(*physics_elem, mat_A, mat_B);
         
         // copy to the libMesh matrix for further processing
-        DenseRealMatrix A, B;
         MAST::copy(A, mat_A);
         MAST::copy(B, mat_B);
         
@@ -248,8 +259,8 @@ eigenproblem_sensitivity_assemble (const libMesh::ParameterVector& parameters,
         dof_map.constrain_element_matrix(B, dof_indices);
         
         // add to the global matrices
-        matrix_A.add_matrix (A, dof_indices); // load independent
-        matrix_B.add_matrix (B, dof_indices); // load dependent
+        _add_elem_matrix(matrix_A, A, dof_indices, elem); // load independent
+        _add_elem_matrix(matrix_B, B, dof_indices, elem); // load dependent
     }
     
     // finalize the data structures
@@ -261,6 +272,138 @@ eigenproblem_sensitivity_assemble (const libMesh::ParameterVector& parameters,
 
 
 
+bool
+MAST::StructuralModalEigenproblemAssembly::
+eigenproblem_sensitivity_products(const libMesh::ParameterVector& parameters,
+                                  const std::vector<Real>& eig,
+                                  const std::vector<libMesh::NumericVector<Real>*>& x,
+                                  std::vector<Real>& sens) {
+    
+    // the base solution sensitivity is only available for one parameter
+    if (_base_sol)
+        return false;
+    
+    MAST_LOG_SCOPE("eigenproblem_sensitivity_products()",
+                   "StructuralModalEigenproblemAssembly");
+    
+    libmesh_assert_equal_to(eig.size(), x.size());
+    
+    MAST::NonlinearSystem& eigen_sys =
+    dynamic_cast<MAST::NonlinearSystem&>(_system->system());
+    
+    const unsigned int
+    n_eig    = (unsigned int)x.size(),
+    n_params = parameters.size();
+    
+    sens.assign(n_eig*n_params, 0.);
+    
+    // localized eigenvectors
+    std::vector<libMesh::NumericVector<Real>*>
+    localized_x(n_eig, nullptr);
+    
+    for (unsigned int i=0; i<n_eig; i++)
+        localized_x[i] = _build_localized_vector(eigen_sys, *x[i]).release();
+    
+    // parameters that each element depends on. Elements that do not
+    // depend on any parameter are not visited.
+    std::vector<const MAST::FunctionBase*> f(n_params, nullptr);
+    std::map<const libMesh::Elem*, std::vector<unsigned int> > elem_params;
+    
+    for (unsigned int j=0; j<n_params; j++) {
+        
+        f[j] = _discipline->get_parameter(&(parameters[j].get()));
+        
+        const std::vector<const libMesh::Elem*>&
+        elems = _discipline->get_dependent_local_elems(*f[j]);
+        
+        for (unsigned int k=0; k<elems.size(); k++)
+            elem_params[elems[k]].push_back(j);
+    }
+    
+    RealVectorX sol;
+    RealMatrixX mat_A, mat_B, x_e;
+    std::vector<libMesh::dof_id_type> dof_indices;
+    const MAST::ElementTopologyCache& topology = eigen_sys.topology_cache();
+    std::auto_ptr<MAST::ElementBase> elem_storage;
+    MAST::ElementBase* physics_elem = nullptr;
+    
+    std::map<const libMesh::Elem*, std::vector<unsigned int> >::const_iterator
+    el     = elem_params.begin(),
+    end_el = elem_params.end();
+    
+    for ( ; el != end_el; ++el) {
+        
+        const libMesh::Elem* elem = el->first;
+        const std::vector<unsigned int>& params = el->second;
+        
+        topology.dof_indices (elem, dof_indices);
+        
+        physics_elem = &_get_elem(*elem, elem_storage);
+        
+        unsigned int ndofs = (unsigned int)dof_indices.size();
+        sol.setZero(ndofs);
+        mat_A.setZero(ndofs, ndofs);
+        mat_B.setZero(ndofs, ndofs);
+        x_e.setZero(ndofs, n_eig);
+        
+        // the eigenproblem is defined about a zero solution
+        physics_elem->set_solution(sol);
+        physics_elem->set_velocity(sol);
+        physics_elem->set_acceleration(sol);
+        physics_elem->set_solution(sol, true);
+        
+        // set the incompatible mode solution if required by the
+        // element
+        MAST::StructuralElementBase& p_elem =
+        dynamic_cast<MAST::StructuralElementBase&>(*physics_elem);
+        if (p_elem.if_incompatible_modes()) {
+            // check if the vector exists in the map
+            if (!_incompatible_sol.count(elem))
+                _incompatible_sol[elem] = RealVectorX::Zero(p_elem.incompatible_mode_size());
+            p_elem.set_incompatible_mode_solution(_incompatible_sol[elem]);
+        }
+        
+        // element values of the eigenvectors
+        for (unsigned int i=0; i<n_eig; i++) {
+            
+            _get_elem_values(*localized_x[i], dof_indices, sol);
+            x_e.col(i) = sol;
+        }
+        
+        for (unsigned int p=0; p<params.size(); p++) {
+            
+            const unsigned int j = params[p];
+            
+            physics_elem->sensitivity_param = f[j];
+            
+            _elem_sensitivity_calculations(*physics_elem, mat_A, mat_B);
+            
+            for (unsigned int i=0; i<n_eig; i++)
+                sens[j*n_eig+i] +=
+                x_e.col(i).dot((mat_A - eig[i] * mat_B) * x_e.col(i));
+        }
+    }
+    
+    for (unsigned int i=0; i<n_eig; i++)
+        delete localized_x[i];
+    
+    // add the contributions of all processors
+    eigen_sys.comm().sum(sens);
+    
+    return true;
+}
+
+
+
+void
+MAST::StructuralModalEigenproblemAssembly::clear_mesh_dependent_data() {
+    
+    MAST::EigenproblemAssembly::clear_mesh_dependent_data();
+    _incompatible_sol.clear();
+}
+
+
+
 std::auto_ptr<MAST::ElementBase>
 MAST::StructuralModalEigenproblemAssembly::_build_elem(const libMesh::Elem& elem) {
     
@@ -67,7 +67,32 @@ namespace MAST {
                                            libMesh::SparseMatrix<Real>* sensitivity_A,
                                            libMesh::SparseMatrix<Real>* sensitivity_B);
         
+        
+        /*!
+         *   computes the products
+         *   \f$ x_i^T (dA/dp_j - \lambda_i dB/dp_j) x_i \f$ for all
+         *   eigenvectors and parameters with a single pass over the
+         *   elements that depend on the parameters. The element
+         *   sensitivity matrices are multiplied with the element values of
+         *   the eigenvectors, which satisfy the constraints, and the global
+         *   sensitivity matrices are not assembled. This returns false if
+         *   the eigenproblem is linearized about a base solution, since the
+         *   sensitivity of the base solution is provided for one parameter
+         *   at a time.
+         */
+        virtual bool
+        eigenproblem_sensitivity_products(const libMesh::ParameterVector& parameters,
+                                          const std::vector<Real>& eig,
+                                          const std::vector<libMesh::NumericVector<Real>*>& x,
+                                          std::vector<Real>& sens);
+        
 
+        /*!
+         *   clears the incompatible mode solutions along with the data
+         *   of the parent class
+         */
+        virtual void clear_mesh_dependent_data();
+        
     protected:
         
         /*!
@@ -18,6 +18,11 @@
  */
 
 
+// C++ includes
+#include <fstream>
+#include <sstream>
+
+
 // MAST includes
 #include "elasticity/structural_nonlinear_assembly.h"
 #include "elasticity/structural_element_base.h"
@@ -29,6 +34,8 @@
 #include "numerics/utility.h"
 #include "base/real_output_function.h"
 #include "base/nonlinear_system.h"
+#include "base/elementwise_design_field.h"
+#include "base/performance_log.h"
 
 
 // libMesh includes
@@ -43,7 +50,10 @@
 
 MAST::StructuralNonlinearAssembly::
 StructuralNonlinearAssembly():
-MAST::NonlinearImplicitAssembly() {
+MAST::NonlinearImplicitAssembly(),
+_incompatible_mode_cache(false),
+_thermal_load_cache(false),
+_linear_stiffness_cache(false) {
     
 }
 
@@ -58,121 +68,253 @@ MAST::StructuralNonlinearAssembly::
 
 void
 MAST::StructuralNonlinearAssembly::
-residual_and_jacobian (const libMesh::NumericVector<Real>& X,
-                       libMesh::NumericVector<Real>* R,
-                       libMesh::SparseMatrix<Real>*  J,
-                       libMesh::NonlinearImplicitSystem& S) {
+_set_elem_solution(MAST::ElementBase& elem,
+                   const RealVectorX& sol) {
     
-    MAST::NonlinearSystem& nonlin_sys = _system->system();
+    MAST::StructuralElementBase& p_elem =
+    dynamic_cast<MAST::StructuralElementBase&>(elem);
     
-    // make sure that the system for which this object was created,
-    // and the system passed through the function call are the same
-    libmesh_assert_equal_to(&S, &(nonlin_sys));
+    RealVectorX
+    zero = RealVectorX::Zero(sol.size());
     
-    if (R) R->zero();
-    if (J) J->zero();
+    p_elem.set_solution    (sol);
+    p_elem.set_velocity    (zero); // set to zero vector for a quasi-steady analysis
+    p_elem.set_acceleration(zero); // set to zero vector for a quasi-steady analysis
     
-    // iterate over each element, initialize it and get the relevant
-    // analysis quantities
-    RealVectorX vec, sol;
-    RealMatrixX mat;
     
-    std::vector<libMesh::dof_id_type> dof_indices;
-    const libMesh::DofMap& dof_map = nonlin_sys.get_dof_map();
-    std::auto_ptr<MAST::ElementBase> physics_elem;
+    // set the incompatible mode solution if required by the
+    // element
+    if (p_elem.if_incompatible_modes())
+        _set_elem_incompatible_mode_solution(p_elem);
     
-    std::auto_ptr<libMesh::NumericVector<Real> > localized_solution;
-    localized_solution.reset(_build_localized_vector(nonlin_sys,
-                                                     X).release());
+    // provide the retained thermal loads
+    if (_thermal_load_cache) {
+        
+        // the map may be modified by concurrent threads
+        libMesh::Threads::spin_mutex::scoped_lock
+        lock(libMesh::Threads::spin_mtx);
+        
+        p_elem.set_thermal_load_cache(&_thermal_loads[&p_elem.elem()]);
+    }
+    else
+        p_elem.set_thermal_load_cache(nullptr);
     
+    // provide the retained linear stiffness
+    if (_linear_stiffness_cache) {
+        
+        // the map may be modified by concurrent threads
+        libMesh::Threads::spin_mutex::scoped_lock
+        lock(libMesh::Threads::spin_mtx);
+        
+        p_elem.set_linear_stiffness_cache(&_linear_stiffness[&p_elem.elem()]);
+    }
+    else
+        p_elem.set_linear_stiffness_cache(nullptr);
+}
+
+
+
+void
+MAST::StructuralNonlinearAssembly::
+_set_elem_incompatible_mode_solution(MAST::StructuralElementBase& elem) {
     
-    // if a solution function is attached, initialize it
-    if (_sol_function)
-        _sol_function->init( X);
+    const libMesh::Elem& e = elem.elem();
     
+    if (_incompatible_mode_cache) {
+        
+        // the store is guarded by its own mutex
+        elem.set_incompatible_mode_data
+        (_incompatible_store.entry(e, elem.incompatible_mode_size()));
+        return;
+    }
     
-    libMesh::MeshBase::const_element_iterator       el     =
-    nonlin_sys.get_mesh().active_local_elements_begin();
-    const libMesh::MeshBase::const_element_iterator end_el =
-    nonlin_sys.get_mesh().active_local_elements_end();
+    // the map may be modified by concurrent threads
+    libMesh::Threads::spin_mutex::scoped_lock
+    lock(libMesh::Threads::spin_mtx);
     
+    // check if the vector exists in the map
+    if (!_incompatible_sol.count(&e))
+        _incompatible_sol[&e] = RealVectorX::Zero(elem.incompatible_mode_size());
+    elem.set_incompatible_mode_solution(_incompatible_sol[&e]);
+}
+
+
+
+void
+MAST::StructuralNonlinearAssembly::
+set_incompatible_mode_cache(bool f) {
     
-    for ( ; el != end_el; ++el) {
-        
-        const libMesh::Elem* elem = *el;
-        
-        dof_map.dof_indices (elem, dof_indices);
-        
-        physics_elem.reset(_build_elem(*elem).release());
+    _incompatible_mode_cache = f;
+    _incompatible_store.clear();
+    _incompatible_store_params.clear();
+}
 
-        MAST::StructuralElementBase& p_elem =
-        dynamic_cast<MAST::StructuralElementBase&>(*physics_elem);
 
+
+void
+MAST::StructuralNonlinearAssembly::
+clear_incompatible_mode_cache() {
+    
+    _incompatible_store.invalidate();
+}
+
+
+
+void
+MAST::StructuralNonlinearAssembly::clear_mesh_dependent_data() {
+    
+    MAST::NonlinearImplicitAssembly::clear_mesh_dependent_data();
+    
+    _incompatible_sol.clear();
+    _incompatible_store.clear();
+    this->clear_thermal_load_cache();
+    _linear_stiffness.clear();
+    this->_clear_point_loads();
+}
+
+
+
+void
+MAST::StructuralNonlinearAssembly::
+set_thermal_load_cache(bool f) {
+    
+    _thermal_load_cache = f;
+    _thermal_loads.clear();
+    _thermal_load_params.clear();
+}
+
+
+
+void
+MAST::StructuralNonlinearAssembly::
+clear_thermal_load_cache() {
+    
+    std::map<const libMesh::Elem*, MAST::ThermalLoadCache>::iterator
+    it  = _thermal_loads.begin(),
+    end = _thermal_loads.end();
+    
+    for ( ; it != end; it++) {
         
-        // get the solution
-        unsigned int ndofs = (unsigned int)dof_indices.size();
-        sol.setZero(ndofs);
-        vec.setZero(ndofs);
-        mat.setZero(ndofs, ndofs);
-        
-        for (unsigned int i=0; i<dof_indices.size(); i++)
-            sol(i) = (*localized_solution)(dof_indices[i]);
+        MAST::ThermalLoadCache::iterator
+        d_it  = it->second.begin(),
+        d_end = it->second.end();
         
-        physics_elem->set_solution    (sol);
-        physics_elem->set_velocity    (vec); // set to zero vector for a quasi-steady analysis
-        physics_elem->set_acceleration(vec); // set to zero vector for a quasi-steady analysis
+        for ( ; d_it != d_end; d_it++)
+            d_it->second.valid = false;
+    }
+}
+
+
+
+void
+MAST::StructuralNonlinearAssembly::
+set_linear_stiffness_cache(bool f) {
+    
+    _linear_stiffness_cache = f;
+    _linear_stiffness.clear();
+    _linear_stiffness_params.clear();
+}
+
+
+
+void
+MAST::StructuralNonlinearAssembly::
+clear_linear_stiffness_cache() {
+    
+    std::map<const libMesh::Elem*, MAST::LinearStiffnessData>::iterator
+    it  = _linear_stiffness.begin(),
+    end = _linear_stiffness.end();
+    
+    for ( ; it != end; it++)
+        it->second.valid = false;
+}
+
+
+
+void
+MAST::StructuralNonlinearAssembly::_update_element_data_cache() {
+    
+    if (_incompatible_mode_cache) {
         
+        // the condensed matrices depend on the parameter values through
+        // the material stiffness
+        std::map<const Real*, Real> params;
+        _get_parameter_values(params);
         
-        // set the incompatible mode solution if required by the
-        // element
-        if (p_elem.if_incompatible_modes()) {
-            // check if the vector exists in the map
-            if (!_incompatible_sol.count(elem))
-                _incompatible_sol[elem] = RealVectorX::Zero(p_elem.incompatible_mode_size());
-            p_elem.set_incompatible_mode_solution(_incompatible_sol[elem]);
+        if (params != _incompatible_store_params) {
+            
+            _incompatible_store.invalidate();
+            _incompatible_store_params = params;
         }
+    }
+    
+    if (_thermal_load_cache) {
         
-        if (_sol_function)
-            physics_elem->attach_active_solution_function(*_sol_function);
-        
-        //_check_element_numerical_jacobian(*physics_elem, sol);
-        
-        // perform the element level calculations
-        _elem_calculations(*physics_elem,
-                           J!=nullptr?true:false,
-                           vec, mat);
-        
-        physics_elem->detach_active_solution_function();
+        // the thermal loads depend on the parameter values through the
+        // material properties and the temperature
+        std::map<const Real*, Real> params;
+        _get_parameter_values(params);
         
-        // copy to the libMesh matrix for further processing
-        DenseRealVector v;
-        DenseRealMatrix m;
-        if (R)
-            MAST::copy(v, vec);
-        if (J)
-            MAST::copy(m, mat);
+        if (params != _thermal_load_params) {
+            
+            this->clear_thermal_load_cache();
+            _thermal_load_params = params;
+        }
+    }
+    
+    if (_linear_stiffness_cache) {
         
-        // constrain the quantities to account for hanging dofs,
-        // Dirichlet constraints, etc.
-        if (R && J)
-            dof_map.constrain_element_matrix_and_vector(m, v, dof_indices);
-        else if (R)
-            dof_map.constrain_element_vector(v, dof_indices);
-        else
-            dof_map.constrain_element_matrix(m, dof_indices);
+        // the stiffness depends on the parameter values through the
+        // section properties
+        std::map<const Real*, Real> params;
+        _get_parameter_values(params);
         
-        // add to the global matrices
-        if (R) R->add_vector(v, dof_indices);
-        if (J) J->add_matrix(m, dof_indices);
+        if (params != _linear_stiffness_params) {
+            
+            this->clear_linear_stiffness_cache();
+            _linear_stiffness_params = params;
+        }
     }
+}
+
+
+
+void
+MAST::StructuralNonlinearAssembly::
+residual_and_jacobian (const libMesh::NumericVector<Real>& X,
+                       libMesh::NumericVector<Real>* R,
+                       libMesh::SparseMatrix<Real>*  J,
+                       libMesh::NonlinearImplicitSystem& S) {
     
+    _update_element_data_cache();
     
-    // if a solution function is attached, clear it
-    if (_sol_function)
-        _sol_function->clear();
+    MAST::NonlinearImplicitAssembly::residual_and_jacobian(X, R, J, S);
+}
+
+
+
+
+void
+MAST::StructuralNonlinearAssembly::
+_assemble_nodal_quantities(libMesh::NumericVector<Real>* R,
+                           libMesh::SparseMatrix<Real>*  J) {
+    
+    // the point loads do not depend on the solution, and only change
+    // the residual
+    if (R && _discipline->point_loads().size())
+        _assemble_point_loads(*_discipline, *_system, *R);
+}
+
+
+
+
+void
+MAST::StructuralNonlinearAssembly::
+_assemble_nodal_sensitivity(const MAST::FunctionBase& f,
+                            libMesh::NumericVector<Real>& sensitivity_rhs) {
     
-    if (R) R->close();
-    if (J) J->close();
+    if (_discipline->point_loads().size())
+        _assemble_point_load_sensitivity(*_discipline, *_system, f, sensitivity_rhs);
 }
 
 
@@ -196,7 +338,10 @@ sensitivity_assemble (const libMesh::ParameterVector& parameters,
     
     std::vector<libMesh::dof_id_type> dof_indices;
     const libMesh::DofMap& dof_map = nonlin_sys.get_dof_map();
-    std::auto_ptr<MAST::ElementBase> physics_elem;
+    const MAST::ElementTopologyCache& topology = nonlin_sys.topology_cache();
+    std::auto_ptr<MAST::ElementBase> elem_storage;
+    MAST::ElementBase* physics_elem = nullptr;
+    DenseRealVector v;
     
     std::auto_ptr<libMesh::NumericVector<Real> > localized_solution;
     localized_solution.reset(_build_localized_vector(nonlin_sys,
@@ -206,18 +351,24 @@ sensitivity_assemble (const libMesh::ParameterVector& parameters,
     if (_sol_function)
         _sol_function->init( *nonlin_sys.solution);
     
-    libMesh::MeshBase::const_element_iterator       el     =
-    nonlin_sys.get_mesh().active_local_elements_begin();
-    const libMesh::MeshBase::const_element_iterator end_el =
-    nonlin_sys.get_mesh().active_local_elements_end();
+    const MAST::FunctionBase* f = _discipline->get_parameter(&(parameters[i].get()));
+    
+    // only the elements that depend on the parameter contribute to the
+    // sensitivity RHS
+    const std::vector<const libMesh::Elem*>&
+    elems = _discipline->get_dependent_local_elems(*f);
+    
+    std::vector<const libMesh::Elem*>::const_iterator
+    el     = elems.begin(),
+    end_el = elems.end();
     
     for ( ; el != end_el; ++el) {
         
         const libMesh::Elem* elem = *el;
         
-        dof_map.dof_indices (elem, dof_indices);
+        topology.dof_indices (elem, dof_indices);
         
-        physics_elem.reset(_build_elem(*elem).release());
+        physics_elem = &_get_elem(*elem, elem_storage);
         
         MAST::StructuralElementBase& p_elem =
         dynamic_cast<MAST::StructuralElementBase&>(*physics_elem);
@@ -228,22 +379,17 @@ sensitivity_assemble (const libMesh::ParameterVector& parameters,
         vec.setZero(ndofs);
         mat.setZero(ndofs, ndofs);
         
-        for (unsigned int i=0; i<dof_indices.size(); i++)
-            sol(i) = (*localized_solution)(dof_indices[i]);
+        _get_elem_values(*localized_solution, dof_indices, sol);
         
-        physics_elem->sensitivity_param = _discipline->get_parameter(&(parameters[i].get()));
+        physics_elem->sensitivity_param = f;
         physics_elem->set_solution    (sol);
         physics_elem->set_velocity    (vec); // set to zero vector for a quasi-steady analysis
         physics_elem->set_acceleration(vec); // set to zero vector for a quasi-steady analysis
         
         // set the incompatible mode solution if required by the
         // element
-        if (p_elem.if_incompatible_modes()) {
-            // check if the vector exists in the map
-            if (!_incompatible_sol.count(elem))
-                _incompatible_sol[elem] = RealVectorX::Zero(p_elem.incompatible_mode_size());
-            p_elem.set_incompatible_mode_solution(_incompatible_sol[elem]);
-        }
+        if (p_elem.if_incompatible_modes())
+            _set_elem_incompatible_mode_solution(p_elem);
 
         if (_sol_function)
             physics_elem->attach_active_solution_function(*_sol_function);
@@ -259,7 +405,6 @@ sensitivity_assemble (const libMesh::ParameterVector& parameters,
         physics_elem->detach_active_solution_function();
         
         // copy to the libMesh matrix for further processing
-        DenseRealVector v;
         MAST::copy(v, vec);
         
         // constrain the quantities to account for hanging dofs,
@@ -274,6 +419,8 @@ sensitivity_assemble (const libMesh::ParameterVector& parameters,
     if (_sol_function)
         _sol_function->clear();
     
+    this->_assemble_nodal_sensitivity(*f, sensitivity_rhs);
+    
     sensitivity_rhs.close();
     
     return true;
@@ -283,6 +430,95 @@ sensitivity_assemble (const libMesh::ParameterVector& parameters,
 
 
 
+void
+MAST::StructuralNonlinearAssembly::
+write_incompatible_mode_checkpoint(const std::string& prefix) const {
+    
+    libmesh_assert(_system);
+    
+    std::ostringstream oss;
+    oss << prefix << "." << _system->system().comm().rank();
+    
+    std::ofstream out(oss.str().c_str(), std::ios::out | std::ios::binary);
+    if (!out.good())
+        libmesh_error_msg("Unable to open file: " << oss.str());
+    
+    if (_incompatible_mode_cache)
+        _incompatible_store.write(out);
+    else {
+        
+        // same format as MAST::IncompatibleModeStore::write()
+        const unsigned int
+        n_elems = (unsigned int)_incompatible_sol.size();
+        out.write((const char*)&n_elems, sizeof(unsigned int));
+        
+        std::map<const libMesh::Elem*, RealVectorX>::const_iterator
+        it  = _incompatible_sol.begin(),
+        end = _incompatible_sol.end();
+        
+        for ( ; it != end; it++) {
+            
+            const unsigned long long
+            id = it->first->id();
+            const unsigned int
+            n  = (unsigned int)it->second.size();
+            
+            out.write((const char*)&id, sizeof(unsigned long long));
+            out.write((const char*)&n,  sizeof(unsigned int));
+            out.write((const char*)it->second.data(), n*sizeof(Real));
+        }
+    }
+    
+    if (!out.good())
+        libmesh_error_msg("Error writing file: " << oss.str());
+}
+
+
+
+void
+MAST::StructuralNonlinearAssembly::
+read_incompatible_mode_checkpoint(const std::string& prefix) {
+    
+    libmesh_assert(_system);
+    
+    std::ostringstream oss;
+    oss << prefix << "." << _system->system().comm().rank();
+    
+    std::ifstream in(oss.str().c_str(), std::ios::in | std::ios::binary);
+    if (!in.good())
+        libmesh_error_msg("Unable to open file: " << oss.str());
+    
+    const libMesh::MeshBase& mesh = _system->system().get_mesh();
+    
+    if (_incompatible_mode_cache)
+        _incompatible_store.read(in, mesh);
+    else {
+        
+        unsigned int
+        n_elems = 0,
+        n       = 0;
+        unsigned long long
+        id      = 0;
+        
+        in.read((char*)&n_elems, sizeof(unsigned int));
+        
+        for (unsigned int i=0; i<n_elems; i++) {
+            
+            in.read((char*)&id, sizeof(unsigned long long));
+            in.read((char*)&n,  sizeof(unsigned int));
+            
+            RealVectorX& v = _incompatible_sol[mesh.elem_ptr(id)];
+            v.setZero(n);
+            in.read((char*)v.data(), n*sizeof(Real));
+        }
+    }
+    
+    if (!in.good())
+        libmesh_error_msg("Error reading file: " << oss.str());
+}
+
+
+
 void
 MAST::StructuralNonlinearAssembly::StructuralNonlinearAssembly::
 update_incompatible_solution(libMesh::NumericVector<Real>& X,
@@ -300,8 +536,9 @@ update_incompatible_solution(libMesh::NumericVector<Real>& X,
     RealVectorX sol, dsol;
     
     std::vector<libMesh::dof_id_type> dof_indices;
-    const libMesh::DofMap& dof_map = _system->system().get_dof_map();
-    std::auto_ptr<MAST::ElementBase> physics_elem;
+    const MAST::ElementTopologyCache& topology = _system->system().topology_cache();
+    std::auto_ptr<MAST::ElementBase> elem_storage;
+    MAST::ElementBase* physics_elem = nullptr;
     
     std::auto_ptr<libMesh::NumericVector<Real> >
     localized_solution(_build_localized_vector(nonlin_sys,
@@ -325,27 +562,25 @@ update_incompatible_solution(libMesh::NumericVector<Real>& X,
         
         const libMesh::Elem* elem = *el;
         
-        physics_elem.reset(_build_elem(*elem).release());
+        physics_elem = &_get_elem(*elem, elem_storage);
         
         MAST::StructuralElementBase& p_elem =
         dynamic_cast<MAST::StructuralElementBase&>(*physics_elem);
 
         if (p_elem.if_incompatible_modes()) {
             
-            dof_map.dof_indices (elem, dof_indices);
+            topology.dof_indices (elem, dof_indices);
             
             // get the solution
             unsigned int ndofs = (unsigned int)dof_indices.size();
             sol.setZero(ndofs);
             dsol.setZero(ndofs);
             
-            for (unsigned int i=0; i<dof_indices.size(); i++) {
-                sol(i)  = (*localized_solution) (dof_indices[i]);
-                dsol(i) = (*localized_dsolution)(dof_indices[i]);
-            }
+            _get_elem_values(*localized_solution, dof_indices, sol);
+            _get_elem_values(*localized_dsolution, dof_indices, dsol);
             
             p_elem.set_solution(sol);
-            p_elem.set_incompatible_mode_solution(_incompatible_sol[elem]);
+            _set_elem_incompatible_mode_solution(p_elem);
             
             if (_sol_function)
                 p_elem.attach_active_solution_function(*_sol_function);
@@ -366,6 +601,234 @@ update_incompatible_solution(libMesh::NumericVector<Real>& X,
 
 
 
+void
+MAST::StructuralNonlinearAssembly::
+load_case_assemble(const std::vector<MAST::StructuralLoadCase>& cases,
+                   std::vector<libMesh::NumericVector<Real>*>& rhs) {
+    
+    libmesh_assert_equal_to(cases.size(), rhs.size());
+    
+    MAST_LOG_SCOPE("load_case_assemble()", "StructuralNonlinearAssembly");
+    
+    MAST::NonlinearSystem& nonlin_sys = _system->system();
+    
+    _update_element_data_cache();
+    
+    const unsigned int n_cases = (unsigned int)cases.size();
+    
+    for (unsigned int i=0; i<n_cases; i++)
+        rhs[i]->zero();
+    
+    // the Jacobian quantities are not accessed by the element kernels
+    // when request_jacobian is false, so empty matrices are passed.
+    RealVectorX vec, vec_int, sol;
+    RealMatrixX dummy;
+    
+    std::vector<libMesh::dof_id_type> dof_indices, case_dof_indices;
+    const libMesh::DofMap& dof_map = nonlin_sys.get_dof_map();
+    const MAST::ElementTopologyCache& topology = nonlin_sys.topology_cache();
+    std::auto_ptr<MAST::ElementBase> elem_storage;
+    MAST::ElementBase* physics_elem = nullptr;
+    DenseRealVector v;
+    
+    std::auto_ptr<libMesh::NumericVector<Real> > localized_solution;
+    localized_solution.reset(_build_localized_vector(nonlin_sys,
+                                                     *nonlin_sys.solution).release());
+    
+    // if a solution function is attached, initialize it
+    if (_sol_function)
+        _sol_function->init( *nonlin_sys.solution);
+    
+    // maps used for cases without side or volume loads
+    MAST::SideBCMapType   no_side_loads;
+    MAST::VolumeBCMapType no_volume_loads;
+    
+    libMesh::MeshBase::const_element_iterator       el     =
+    nonlin_sys.get_mesh().active_local_elements_begin();
+    const libMesh::MeshBase::const_element_iterator end_el =
+    nonlin_sys.get_mesh().active_local_elements_end();
+    
+    for ( ; el != end_el; ++el) {
+        
+        const libMesh::Elem* elem = *el;
+        
+        topology.dof_indices (elem, dof_indices);
+        
+        physics_elem = &_get_elem(*elem, elem_storage);
+        
+        MAST::StructuralElementBase& p_elem =
+        dynamic_cast<MAST::StructuralElementBase&>(*physics_elem);
+        
+        // the solution is the same for all load cases
+        unsigned int ndofs = (unsigned int)dof_indices.size();
+        sol.setZero(ndofs);
+        vec_int.setZero(ndofs);
+        
+        _get_elem_values(*localized_solution, dof_indices, sol);
+        
+        _set_elem_solution(*physics_elem, sol);
+        
+        if (_sol_function)
+            physics_elem->attach_active_solution_function(*_sol_function);
+        
+        // the internal residual is shared by all load cases
+        p_elem.internal_residual(false, vec_int, dummy);
+        
+        for (unsigned int i=0; i<n_cases; i++) {
+            
+            vec = vec_int;
+            
+            p_elem.volume_external_residual(false,
+                                            vec,
+                                            dummy,
+                                            dummy,
+                                            cases[i].volume_loads?
+                                            *cases[i].volume_loads:no_volume_loads);
+            p_elem.side_external_residual(false,
+                                          vec,
+                                          dummy,
+                                          dummy,
+                                          cases[i].side_loads?
+                                          *cases[i].side_loads:no_side_loads);
+            
+            // the RHS is the negative of the residual
+            vec *= -1.;
+            
+            // copy to the libMesh matrix for further processing
+            MAST::copy(v, vec);
+            
+            // constrain the quantities to account for hanging dofs,
+            // Dirichlet constraints, etc. The constraint may modify the
+            // dof indices, so a copy is used for each load case.
+            case_dof_indices = dof_indices;
+            dof_map.constrain_element_vector(v, case_dof_indices);
+            
+            // add to the global vectors
+            rhs[i]->add_vector(v, case_dof_indices);
+        }
+        
+        physics_elem->detach_active_solution_function();
+    }
+    
+    // if a solution function is attached, clear it
+    if (_sol_function)
+        _sol_function->clear();
+    
+    for (unsigned int i=0; i<n_cases; i++)
+        rhs[i]->close();
+}
+
+
+
+void
+MAST::StructuralNonlinearAssembly::
+solve_load_cases(const std::vector<MAST::StructuralLoadCase>& cases,
+                 std::vector<libMesh::NumericVector<Real>*>& X) {
+    
+    libmesh_assert_equal_to(cases.size(), X.size());
+    
+    MAST_LOG_SCOPE("solve_load_cases()", "StructuralNonlinearAssembly");
+    
+    MAST::NonlinearSystem& nonlin_sys = _system->system();
+    
+    const unsigned int n_cases = (unsigned int)cases.size();
+    
+    if (!n_cases)
+        return;
+    
+    std::vector<libMesh::NumericVector<Real>*> rhs(n_cases, nullptr);
+    
+    for (unsigned int i=0; i<n_cases; i++)
+        rhs[i] = nonlin_sys.solution->zero_clone().release();
+    
+    // all load vectors are assembled in one pass over the elements
+    this->load_case_assemble(cases, rhs);
+    
+    // and solved with a single factorization of the stiffness matrix
+    nonlin_sys.multi_rhs_solve(rhs, X);
+    
+    for (unsigned int i=0; i<n_cases; i++) {
+        
+        X[i]->add(1., *nonlin_sys.solution);
+        X[i]->close();
+        delete rhs[i];
+    }
+}
+
+
+
+void
+MAST::StructuralNonlinearAssembly::
+calculate_load_case_outputs(const std::vector<MAST::StructuralLoadCase>& cases,
+                            const std::vector<libMesh::NumericVector<Real>*>& X) {
+    
+    libmesh_assert_equal_to(cases.size(), X.size());
+    
+    MAST_LOG_SCOPE("calculate_load_case_outputs()", "StructuralNonlinearAssembly");
+    
+    MAST::NonlinearSystem& nonlin_sys = _system->system();
+    
+    const unsigned int n_cases = (unsigned int)cases.size();
+    
+    // maps used for cases without side or volume outputs
+    MAST::SideOutputMapType   no_side_output;
+    MAST::VolumeOutputMapType no_volume_output;
+    
+    // the localized solutions of the cases with outputs
+    std::vector<libMesh::NumericVector<Real>*> localized_solution(n_cases, nullptr);
+    
+    for (unsigned int i=0; i<n_cases; i++)
+        if (cases[i].side_output || cases[i].volume_output)
+            localized_solution[i] =
+            _build_localized_vector(nonlin_sys, *X[i]).release();
+    
+    RealVectorX sol;
+    
+    std::vector<libMesh::dof_id_type> dof_indices;
+    const MAST::ElementTopologyCache& topology = nonlin_sys.topology_cache();
+    std::auto_ptr<MAST::ElementBase> elem_storage;
+    MAST::ElementBase* physics_elem = nullptr;
+    
+    libMesh::MeshBase::const_element_iterator       el     =
+    nonlin_sys.get_mesh().active_local_elements_begin();
+    const libMesh::MeshBase::const_element_iterator end_el =
+    nonlin_sys.get_mesh().active_local_elements_end();
+    
+    for ( ; el != end_el; ++el) {
+        
+        const libMesh::Elem* elem = *el;
+        
+        // the element is initialized once for all load cases
+        topology.dof_indices (elem, dof_indices);
+        
+        physics_elem = &_get_elem(*elem, elem_storage);
+        
+        unsigned int ndofs = (unsigned int)dof_indices.size();
+        
+        for (unsigned int i=0; i<n_cases; i++) {
+            
+            if (!localized_solution[i])
+                continue;
+            
+            sol.setZero(ndofs);
+            _get_elem_values(*localized_solution[i], dof_indices, sol);
+            
+            physics_elem->set_solution(sol);
+            
+            _elem_outputs(*physics_elem,
+                          cases[i].volume_output?
+                          *cases[i].volume_output:no_volume_output,
+                          cases[i].side_output?
+                          *cases[i].side_output:no_side_output);
+        }
+    }
+    
+    for (unsigned int i=0; i<n_cases; i++)
+        delete localized_solution[i];
+}
+
+
+
 void
 MAST::StructuralNonlinearAssembly::
 calculate_outputs(const libMesh::NumericVector<Real>& X) {
@@ -379,7 +842,8 @@ calculate_outputs(const libMesh::NumericVector<Real>& X) {
     
     
     for ( ; it != end; it++)
-        if (it->second->type() == MAST::STRUCTURAL_COMPLIANCE) {
+        if (it->second->type() == MAST::STRUCTURAL_COMPLIANCE &&
+            it->second->if_sensitivity_active()) {
             
             MAST::NonlinearSystem& sys = _system->system();
             
@@ -416,7 +880,8 @@ calculate_output_sensitivity(libMesh::ParameterVector& params,
     localized_solution_sensitivity;
     
     for ( ; it != end; it++)
-        if (it->second->type() == MAST::STRUCTURAL_COMPLIANCE) {
+        if (it->second->type() == MAST::STRUCTURAL_COMPLIANCE &&
+            it->second->if_sensitivity_active()) {
             
             MAST::NonlinearSystem& sys = _system->system();
             
@@ -484,15 +949,16 @@ _calculate_compliance (const libMesh::NumericVector<Real>& X,
     Real        val;
     
     std::vector<libMesh::dof_id_type> dof_indices;
-    const libMesh::DofMap& dof_map = _system->system().get_dof_map();
-    std::auto_ptr<MAST::ElementBase> physics_elem;
+    const MAST::ElementTopologyCache& topology = _system->system().topology_cache();
+    std::auto_ptr<MAST::ElementBase> elem_storage;
+    MAST::ElementBase* physics_elem = nullptr;
     
     std::auto_ptr<libMesh::NumericVector<Real> >
     localized_solution,
     localized_solution_sens;
     localized_solution.reset(_build_localized_vector(nonlin_sys,
                                                      X).release());
-    if (f)
+    if (f && dX)
         localized_solution_sens.reset(_build_localized_vector(nonlin_sys,
                                                               *dX).release());
 
@@ -512,9 +978,14 @@ _calculate_compliance (const libMesh::NumericVector<Real>& X,
         
         const libMesh::Elem* elem = *el;
         
-        dof_map.dof_indices (elem, dof_indices);
+        // the partial sensitivity is zero for elements that do not
+        // depend on the parameter
+        if (f && !dX && !_discipline->elem_depends_on(*elem, *f))
+            continue;
+        
+        topology.dof_indices (elem, dof_indices);
         
-        physics_elem.reset(_build_elem(*elem).release());
+        physics_elem = &_get_elem(*elem, elem_storage);
         
         MAST::StructuralElementBase& p_elem =
         dynamic_cast<MAST::StructuralElementBase&>(*physics_elem);
@@ -527,15 +998,14 @@ _calculate_compliance (const libMesh::NumericVector<Real>& X,
         vec.setZero (ndofs);
         mat.setZero (ndofs, ndofs);
         
-        for (unsigned int i=0; i<dof_indices.size(); i++)
-            sol(i) = (*localized_solution)(dof_indices[i]);
+        _get_elem_values(*localized_solution, dof_indices, sol);
 
         physics_elem->set_solution(sol, false);  // primal solution
 
         if (f) {
             
-            for (unsigned int i=0; i<dof_indices.size(); i++)
-                dsol(i) = (*localized_solution_sens)(dof_indices[i]);
+            if (dX)
+                _get_elem_values(*localized_solution_sens, dof_indices, dsol);
             
             physics_elem->set_solution(dsol, true);  // sensitivity solution
             physics_elem->sensitivity_param = f;
@@ -543,12 +1013,8 @@ _calculate_compliance (const libMesh::NumericVector<Real>& X,
         
         // set the incompatible mode solution if required by the
         // element
-        if (p_elem.if_incompatible_modes()) {
-            // check if the vector exists in the map
-            if (!_incompatible_sol.count(elem))
-                _incompatible_sol[elem] = RealVectorX::Zero(p_elem.incompatible_mode_size());
-            p_elem.set_incompatible_mode_solution(_incompatible_sol[elem]);
-        }
+        if (p_elem.if_incompatible_modes())
+            _set_elem_incompatible_mode_solution(p_elem);
         
         if (_sol_function)
             physics_elem->attach_active_solution_function(*_sol_function);
@@ -591,6 +1057,87 @@ _calculate_compliance (const libMesh::NumericVector<Real>& X,
 
 
 
+void
+MAST::StructuralNonlinearAssembly::
+calculate_elementwise_compliance_sensitivity(const libMesh::NumericVector<Real>& X,
+                                             const MAST::ElementwiseDesignField& f,
+                                             libMesh::NumericVector<Real>& sens) {
+    
+    MAST_LOG_SCOPE("elementwise_compliance_sensitivity()", "StructuralNonlinearAssembly");
+    
+    MAST::NonlinearSystem& nonlin_sys = _system->system();
+    
+    RealVectorX vec, sol;
+    RealMatrixX mat;
+    
+    std::vector<libMesh::dof_id_type> dof_indices;
+    const MAST::ElementTopologyCache& topology = nonlin_sys.topology_cache();
+    std::auto_ptr<MAST::ElementBase> elem_storage;
+    MAST::ElementBase* physics_elem = nullptr;
+    
+    std::auto_ptr<libMesh::NumericVector<Real> >
+    localized_solution(_build_localized_vector(nonlin_sys, X).release());
+    
+    // if a solution function is attached, initialize it
+    if (_sol_function)
+        _sol_function->init( X);
+    
+    sens.zero();
+    
+    libMesh::MeshBase::const_element_iterator       el     =
+    nonlin_sys.get_mesh().active_local_elements_begin();
+    const libMesh::MeshBase::const_element_iterator end_el =
+    nonlin_sys.get_mesh().active_local_elements_end();
+    
+    for ( ; el != end_el; ++el) {
+        
+        const libMesh::Elem* elem = *el;
+        
+        if (!_discipline->elem_depends_on(*elem, f))
+            continue;
+        
+        topology.dof_indices (elem, dof_indices);
+        
+        physics_elem = &_get_elem(*elem, elem_storage);
+        
+        MAST::StructuralElementBase& p_elem =
+        dynamic_cast<MAST::StructuralElementBase&>(*physics_elem);
+        
+        unsigned int ndofs = (unsigned int)dof_indices.size();
+        sol.setZero (ndofs);
+        vec.setZero (ndofs);
+        mat.setZero (ndofs, ndofs);
+        
+        _get_elem_values(*localized_solution, dof_indices, sol);
+        
+        physics_elem->set_solution(sol, false);
+        physics_elem->set_solution(RealVectorX::Zero(ndofs), true);
+        physics_elem->sensitivity_param = &f;
+        
+        if (p_elem.if_incompatible_modes())
+            _set_elem_incompatible_mode_solution(p_elem);
+        
+        if (_sol_function)
+            physics_elem->attach_active_solution_function(*_sol_function);
+        
+        // the derivative of the element Jacobian with respect to the
+        // design value of this element
+        _elem_sensitivity_calculations(*physics_elem, true, vec, mat);
+        
+        sens.set(f.dof_index(*elem), -sol.dot(mat * sol));
+        
+        physics_elem->detach_active_solution_function();
+    }
+    
+    if (_sol_function)
+        _sol_function->clear();
+    
+    sens.close();
+}
+
+
+
+
 std::auto_ptr<MAST::ElementBase>
 MAST::StructuralNonlinearAssembly::_build_elem(const libMesh::Elem& elem) {
     
@@ -622,17 +1169,45 @@ _elem_calculations(MAST::ElementBase& elem,
     RealMatrixX
     dummy = RealMatrixX::Zero(mat.rows(), mat.cols());
     
-    e.internal_residual(if_jac, vec, mat);
+    e.internal_and_volume_external_residual(if_jac,
+                                            vec,
+                                            dummy,
+                                            mat,
+                                            _discipline->volume_loads());
     e.side_external_residual(if_jac,
                              vec,
                              dummy,
                              mat,
                              _discipline->side_loads());
-    e.volume_external_residual(if_jac,
-                               vec,
-                               dummy,
-                               mat,
-                               _discipline->volume_loads());
+}
+
+
+
+void
+MAST::StructuralNonlinearAssembly::
+_elem_residual_calculations(MAST::ElementBase& elem,
+                            RealVectorX& vec) {
+    
+    MAST::StructuralElementBase& e =
+    dynamic_cast<MAST::StructuralElementBase&>(elem);
+    
+    vec.setZero();
+    
+    // the Jacobian quantities are not accessed by the element kernels
+    // when request_jacobian is false, so empty matrices are passed.
+    RealMatrixX
+    dummy;
+    
+    e.internal_and_volume_external_residual(false,
+                                            vec,
+                                            dummy,
+                                            dummy,
+                                            _discipline->volume_loads());
+    e.side_external_residual(false,
+                             vec,
+                             dummy,
+                             dummy,
+                             _discipline->side_loads());
 }
 
 
@@ -696,6 +1271,46 @@ _elem_sensitivity_calculations(MAST::ElementBase& elem,
 
 
 
+void
+MAST::StructuralNonlinearAssembly::
+_elem_parameter_sensitivity_calculations(MAST::ElementBase& elem,
+                                         const std::vector<const MAST::FunctionBase*>& f,
+                                         std::vector<RealVectorX>& vec) {
+    
+    libmesh_assert_equal_to(vec.size(), f.size());
+    
+    MAST::StructuralElementBase& e =
+    dynamic_cast<MAST::StructuralElementBase&>(elem);
+    
+    const unsigned int
+    n = vec.size()? (unsigned int)vec[0].size(): 0;
+    
+    // the Jacobian is not requested
+    std::vector<RealMatrixX>
+    mats(f.size());
+    RealMatrixX
+    dummy = RealMatrixX::Zero(n, n);
+    
+    e.internal_residual_sensitivities(f, false, vec, mats);
+    
+    for (unsigned int i=0; i<f.size(); i++) {
+        
+        e.sensitivity_param = f[i];
+        e.side_external_residual_sensitivity(false,
+                                             vec[i],
+                                             dummy,
+                                             dummy,
+                                             _discipline->side_loads());
+        e.volume_external_residual_sensitivity(false,
+                                               vec[i],
+                                               dummy,
+                                               dummy,
+                                               _discipline->volume_loads());
+    }
+}
+
+
+
 
 void
 MAST::StructuralNonlinearAssembly::
@@ -749,6 +1364,12 @@ clear_discipline_and_system( ) {
     SNESMonitorCancel(snes);
     libmesh_assert(!ierr);
     
+    _incompatible_store.clear();
+    _incompatible_store_params.clear();
+    _thermal_loads.clear();
+    _thermal_load_params.clear();
+    this->_clear_point_loads();
+    
     // call the parent's method firts
     MAST::NonlinearImplicitAssembly::clear_discipline_and_system();
     
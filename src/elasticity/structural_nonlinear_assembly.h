@@ -22,6 +22,10 @@
 
 // MAST includes
 #include "base/nonlinear_implicit_assembly.h"
+#include "elasticity/structural_assembly.h"
+#include "elasticity/incompatible_mode_store.h"
+#include "elasticity/structural_element_base.h"
+#include "base/physics_discipline_base.h"
 
 
 namespace MAST {
@@ -30,10 +34,41 @@ namespace MAST {
     // Forward declerations
     class RealOutputFunction;
     class FunctionBase;
+    class StructuralElementBase;
+    class ElementwiseDesignField;
+    
+    
+    /*!
+     *   loads and outputs of a load case of a linear static analysis with
+     *   StructuralNonlinearAssembly::solve_load_cases(). The maps of loads
+     *   replace the side and volume loads of the discipline, and a null
+     *   map is treated as having no loads. The Dirichlet conditions and
+     *   the stiffness are those of the discipline, and are shared by all
+     *   load cases.
+     */
+    struct StructuralLoadCase {
+        
+        StructuralLoadCase():
+        side_loads     (nullptr),
+        volume_loads   (nullptr),
+        side_output    (nullptr),
+        volume_output  (nullptr) { }
+        
+        MAST::SideBCMapType*          side_loads;
+        MAST::VolumeBCMapType*        volume_loads;
+        
+        /*!
+         *   outputs evaluated for the solution of the load case by
+         *   StructuralNonlinearAssembly::calculate_load_case_outputs()
+         */
+        MAST::SideOutputMapType*      side_output;
+        MAST::VolumeOutputMapType*    volume_output;
+    };
     
     
     class StructuralNonlinearAssembly:
-    public MAST::NonlinearImplicitAssembly {
+    public MAST::NonlinearImplicitAssembly,
+    public MAST::StructuralAssembly {
         
     public:
         
@@ -64,16 +99,6 @@ namespace MAST {
         virtual void
         clear_discipline_and_system( );
 
-        /*!
-         *    function that assembles the matrices and vectors quantities for
-         *    nonlinear solution
-         */
-        virtual void
-        residual_and_jacobian (const libMesh::NumericVector<Real>& X,
-                               libMesh::NumericVector<Real>* R,
-                               libMesh::SparseMatrix<Real>*  J,
-                               libMesh::NonlinearImplicitSystem& S);
-        
         /**
          * Assembly function.  This function will be called
          * to assemble the RHS of the sensitivity equations (which is -1 times
@@ -90,6 +115,147 @@ namespace MAST {
                               const unsigned int i,
                               libMesh::NumericVector<Real>& sensitivity_rhs);
         
+        /*!
+         *   the batched sensitivity assembly of the parent class is used
+         *   for multiple parameters.
+         */
+        using MAST::NonlinearImplicitAssembly::sensitivity_assemble;
+        
+        
+        /*!
+         *    function that assembles the matrices and vectors quantities for
+         *    nonlinear solution. This reimplements the virtual method from
+         *    the parent class to invalidate the condensed incompatible mode
+         *    matrices if the parameter values have changed.
+         */
+        virtual void
+        residual_and_jacobian (const libMesh::NumericVector<Real>& X,
+                               libMesh::NumericVector<Real>* R,
+                               libMesh::SparseMatrix<Real>*  J,
+                               libMesh::NonlinearImplicitSystem& S);
+        
+        
+        /*!
+         *   tells the assembly to store the incompatible mode solution of
+         *   the elements in a MAST::IncompatibleModeStore along with the
+         *   inverse of the incompatible mode stiffness, which is then
+         *   reused across nonlinear iterations instead of being computed
+         *   at each element evaluation. This assumes that the material
+         *   stiffness does not depend on the solution. The condensed
+         *   matrices are recomputed if the values of the discipline
+         *   parameters change, and clear_incompatible_mode_cache() must be
+         *   called if the material changes otherwise. This is \p false
+         *   by default, and should be set before the first assembly.
+         */
+        void set_incompatible_mode_cache(bool f);
+        
+        
+        /*!
+         *   @returns \p true if the incompatible mode data is stored in
+         *   a MAST::IncompatibleModeStore.
+         */
+        bool if_incompatible_mode_cache() const {
+            return _incompatible_mode_cache;
+        }
+        
+        
+        /*!
+         *   marks the condensed incompatible mode matrices stored for all
+         *   elements as invalid. The incompatible mode solution is retained.
+         */
+        void clear_incompatible_mode_cache();
+        
+        
+        /*!
+         *   clears the incompatible mode solution and condensed matrices,
+         *   the thermal loads stored for the elements and the dofs of the
+         *   point loads, along with the data of the parent class
+         */
+        virtual void clear_mesh_dependent_data();
+        
+        
+        /*!
+         *   writes the incompatible mode solution of the local elements to
+         *   the binary file \p prefix.<rank>, to be written along with
+         *   the checkpoint of the system solution. Each processor writes
+         *   only its own file.
+         */
+        void write_incompatible_mode_checkpoint(const std::string& prefix) const;
+        
+        
+        /*!
+         *   reads the incompatible mode solution written by
+         *   write_incompatible_mode_checkpoint(). The same number of
+         *   processors and partitioning of the mesh must be used.
+         */
+        void read_incompatible_mode_checkpoint(const std::string& prefix);
+        
+        
+        /*!
+         *   tells the assembly to retain the thermal load of the elements
+         *   between assembly calls, so that the temperature field and the
+         *   thermal expansion matrices are evaluated once per temperature
+         *   state instead of at every nonlinear iteration. This is intended
+         *   for one-way coupled thermal-structural analysis, where the
+         *   temperature does not change during the structural solution.
+         *   The solution independent part of the load is reused across
+         *   nonlinear iterations and load cases, and only the von Karman
+         *   or Green-Lagrange contributions are recomputed. The retained
+         *   loads are recomputed if the values of the discipline parameters
+         *   or the time change, and clear_thermal_load_cache() must be
+         *   called if the temperature field changes otherwise, for example
+         *   with a new thermal solution. This is \p false by default, and
+         *   should be set before the first assembly.
+         */
+        void set_thermal_load_cache(bool f);
+        
+        
+        /*!
+         *   @returns \p true if the thermal loads of the elements are
+         *   retained between assembly calls.
+         */
+        bool if_thermal_load_cache() const {
+            return _thermal_load_cache;
+        }
+        
+        
+        /*!
+         *   marks the thermal loads retained for all elements as invalid,
+         *   so that they are recomputed in the next assembly.
+         */
+        void clear_thermal_load_cache();
+        
+        
+        /*!
+         *   tells the assembly to retain the linear stiffness of 1D and 2D
+         *   elements with von Karman strain between assembly calls. The
+         *   membrane, bending, coupling and transverse shear stiffness is
+         *   computed in the first evaluation of an element, after which
+         *   only the terms that depend on the von Karman strain and the
+         *   stress stiffening are computed at the quadrature points. The
+         *   retained stiffness is recomputed if the values of the
+         *   discipline parameters or the time change, and
+         *   clear_linear_stiffness_cache() must be called if the section
+         *   properties change otherwise. This is \p false by default.
+         */
+        void set_linear_stiffness_cache(bool f);
+        
+        
+        /*!
+         *   @returns \p true if the linear stiffness of the elements is
+         *   retained between assembly calls.
+         */
+        bool if_linear_stiffness_cache() const {
+            return _linear_stiffness_cache;
+        }
+        
+        
+        /*!
+         *   marks the linear stiffness retained for all elements as
+         *   invalid, so that it is recomputed in the next assembly.
+         */
+        void clear_linear_stiffness_cache();
+        
         
         /*!
          *   asks the system to update the nonlinear incompatible mode solution
@@ -98,6 +264,42 @@ namespace MAST {
                                           libMesh::NumericVector<Real>& dX);
  
         
+        /*!
+         *   assembles the RHS \f$ -\{R_i(X)\} \f$ of each load case in
+         *   \p cases about the current solution \f$ X \f$ in \p rhs, where
+         *   \f$ R_i \f$ is the residual with the loads of the i^th case.
+         *   The elements are visited once, and their internal residual is
+         *   computed once and shared by all load cases.
+         */
+        void load_case_assemble(const std::vector<MAST::StructuralLoadCase>& cases,
+                                std::vector<libMesh::NumericVector<Real>*>& rhs);
+        
+        
+        /*!
+         *   solves the linear static problem for each load case in \p cases
+         *   and returns the solutions in \p X, which must have been
+         *   created for the system. The stiffness matrix is assembled and
+         *   factorized once about the current solution, which is usually
+         *   zero for a linear analysis, with
+         *   MAST::NonlinearSystem::multi_rhs_solve(). The solution of the
+         *   i^th case is the current solution plus the linear response to
+         *   the RHS of the case.
+         */
+        void solve_load_cases(const std::vector<MAST::StructuralLoadCase>& cases,
+                              std::vector<libMesh::NumericVector<Real>*>& X);
+        
+        
+        /*!
+         *   evaluates the outputs of each load case in \p cases for the
+         *   solution of the case in \p X, in a single pass over the
+         *   elements. The outputs of cases without outputs are skipped.
+         *   A solution function attached to this assembly is not used,
+         *   since it is initialized for a single solution.
+         */
+        void calculate_load_case_outputs(const std::vector<MAST::StructuralLoadCase>& cases,
+                                         const std::vector<libMesh::NumericVector<Real>*>& X);
+        
+        
         /*!
          *   Evaluates the volume and boundary outputs for the specified
          *   solution. This reimplements the virtual method from the parent 
@@ -115,8 +317,41 @@ namespace MAST {
                                           const libMesh::NumericVector<Real>& X);
 
         
+        /*!
+         *   computes the sensitivity of the compliance about the solution
+         *   \p X with respect to the design value of each local element
+         *   of \p f, and sets it in \p sens at MAST::ElementwiseDesignField::dof_index()
+         *   of the element. \p sens must be a vector of the design system of
+         *   \p f. For a linear analysis the compliance is self-adjoint, and
+         *   the sensitivity on element \f$ e \f$ is
+         *   \f$ -\{u_e\}^T [\partial K_e/\partial \rho_e] \{u_e\} \f$, which
+         *   is computed in a single pass over the elements without any
+         *   sensitivity solves.
+         */
+        void
+        calculate_elementwise_compliance_sensitivity(const libMesh::NumericVector<Real>& X,
+                                                     const MAST::ElementwiseDesignField& f,
+                                                     libMesh::NumericVector<Real>& sens);
+        
+        
     protected:
         
+        /*!
+         *   adds the point loads of the discipline to the residual
+         */
+        virtual void
+        _assemble_nodal_quantities(libMesh::NumericVector<Real>* R,
+                                   libMesh::SparseMatrix<Real>*  J);
+        
+        
+        /*!
+         *   adds the sensitivity of the point loads of the discipline
+         */
+        virtual void
+        _assemble_nodal_sensitivity(const MAST::FunctionBase& f,
+                                    libMesh::NumericVector<Real>& sensitivity_rhs);
+        
+        
         /*!
          *  calculates the elastic compliance of the system \p S about the
          *  solution defined by \p X. If sensitivity of the quantity is
@@ -134,6 +369,14 @@ namespace MAST {
         
         
 
+        /*!
+         *   invalidates the condensed incompatible mode matrices and the
+         *   retained thermal loads if the values of the discipline
+         *   parameters have changed since they were computed
+         */
+        void _update_element_data_cache();
+        
+        
         /*!
          *   @returns a smart-pointer to a newly created element for
          *   calculation of element quantities.
@@ -141,6 +384,14 @@ namespace MAST {
         virtual std::auto_ptr<MAST::ElementBase>
         _build_elem(const libMesh::Elem& elem);
         
+        /*!
+         *   sets the local solution for the element, along with zero 
+         *   velocity and acceleration for a quasi-steady analysis, and 
+         *   the incompatible mode solution if required by the element.
+         */
+        virtual void _set_elem_solution(MAST::ElementBase& elem,
+                                        const RealVectorX& sol);
+        
         /*!
          *   performs the element calculations over \par elem, and returns
          *   the element vector and matrix quantities in \par mat and
@@ -152,6 +403,14 @@ namespace MAST {
                                         RealVectorX& vec,
                                         RealMatrixX& mat);
         
+        
+        /*!
+         *   performs the element residual calculations over \par elem
+         *   without the setup of the Jacobian matrices.
+         */
+        virtual void _elem_residual_calculations(MAST::ElementBase& elem,
+                                                 RealVectorX& vec);
+        
         /*!
          *   performs the element calculations over \par elem, and returns
          *   the element vector quantity in \par vec. The vector quantity only
@@ -172,10 +431,92 @@ namespace MAST {
                                                     RealVectorX& vec,
                                                     RealMatrixX& mat);
         
+        /*!
+         *   performs the element sensitivity calculations over \par elem
+         *   for all parameters in \par f, with the internal residual
+         *   sensitivity of all parameters computed in one call of the
+         *   element.
+         */
+        virtual void
+        _elem_parameter_sensitivity_calculations(MAST::ElementBase& elem,
+                                                 const std::vector<const MAST::FunctionBase*>& f,
+                                                 std::vector<RealVectorX>& vec);
+        
+        /*!
+         *   provides the incompatible mode solution to \p elem, either
+         *   from the incompatible mode store or the map of solution
+         *   vectors. This can be called concurrently from multiple threads.
+         */
+        void _set_elem_incompatible_mode_solution(MAST::StructuralElementBase& elem);
+        
+        
         /*!
          *   map of local incompatible mode solution per 3D elements
          */
         std::map<const libMesh::Elem*, RealVectorX> _incompatible_sol;
+        
+        
+        /*!
+         *   flag to store the incompatible mode data in \p _incompatible_store
+         */
+        bool _incompatible_mode_cache;
+        
+        
+        /*!
+         *   incompatible mode solution and condensed matrices per 3D
+         *   elements, used if \p _incompatible_mode_cache is \p true
+         */
+        MAST::IncompatibleModeStore _incompatible_store;
+        
+        
+        /*!
+         *   values of the discipline parameters for which the condensed
+         *   matrices in \p _incompatible_store were computed
+         */
+        std::map<const Real*, Real> _incompatible_store_params;
+        
+        
+        /*!
+         *   flag to retain the element thermal loads in \p _thermal_loads
+         */
+        bool _thermal_load_cache;
+        
+        
+        /*!
+         *   thermal loads retained per element, used if
+         *   \p _thermal_load_cache is \p true. Entries are only added, so
+         *   that the pointers provided to the elements remain valid.
+         */
+        std::map<const libMesh::Elem*, MAST::ThermalLoadCache> _thermal_loads;
+        
+        
+        /*!
+         *   values of the discipline parameters for which the loads in
+         *   \p _thermal_loads were computed
+         */
+        std::map<const Real*, Real> _thermal_load_params;
+        
+        
+        /*!
+         *   flag to retain the element linear stiffness in
+         *   \p _linear_stiffness
+         */
+        bool _linear_stiffness_cache;
+        
+        
+        /*!
+         *   linear stiffness retained per element, used if
+         *   \p _linear_stiffness_cache is \p true. Entries are only added,
+         *   so that the pointers provided to the elements remain valid.
+         */
+        std::map<const libMesh::Elem*, MAST::LinearStiffnessData> _linear_stiffness;
+        
+        
+        /*!
+         *   values of the discipline parameters for which the matrices in
+         *   \p _linear_stiffness were computed
+         */
+        std::map<const Real*, Real> _linear_stiffness_params;
     };
 }
 
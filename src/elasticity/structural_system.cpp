@@ -23,6 +23,7 @@
 // MAST includes
 #include "elasticity/structural_system.h"
 #include "base/parameter.h"
+#include "base/performance_log.h"
 
 // libMesh includes
 #include "libmesh/numeric_vector.h"
@@ -135,6 +136,7 @@ MAST::StructuralSystem::solve() {
     //  or, dp = - (g + (dg/dx)^T dx1) / ((dg/dx)^T dx2 + dg/dp)
     
     START_LOG("solve()", "StructuralSystem");
+    MAST_LOG_SCOPE("solve()", "StructuralSystem");
 
     //  the computations outlined above are repeated unless the
     //  nonlinear convergence criteria are satisfied.
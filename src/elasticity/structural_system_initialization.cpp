@@ -50,6 +50,9 @@ MAST::SystemInitialization(sys, prefix) {
     nm = prefix + "_tz";
     _vars[5] = sys.add_variable(nm, fe_type);
 
+    // the rigid-body modes, including the rotations, are used by
+    // multigrid preconditioners of all solves of the system
+    sys.set_near_null_space_function(&_near_null_space);
 }
 
 
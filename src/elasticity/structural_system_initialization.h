@@ -22,6 +22,7 @@
 
 // MAST includes
 #include "base/system_initialization.h"
+#include "elasticity/structural_near_null_vector_space.h"
 
 
 namespace MAST {
@@ -41,6 +42,11 @@ namespace MAST {
         
     protected:
         
+        /*!
+         *   rigid-body modes of the structural model, which are set as the
+         *   near null space of the system
+         */
+        MAST::StructuralNearNullVectorSpace _near_null_space;
     };
 }
 
@@ -23,6 +23,7 @@
 #include "elasticity/structural_element_base.h"
 #include "property_cards/element_property_card_base.h"
 #include "base/physics_discipline_base.h"
+#include "solver/transient_solver_base.h"
 
 
 MAST::StructuralTransientAssembly::
@@ -61,17 +62,16 @@ _elem_calculations(MAST::ElementBase& elem,
     f_x_jac.setZero();
     
     // assembly of the flux terms
-    e.internal_residual(if_jac, f_x, f_x_jac);
+    e.internal_and_volume_external_residual(if_jac,
+                                            f_x,
+                                            f_m_jac_xdot,
+                                            f_x_jac,
+                                            _discipline->volume_loads());
     e.side_external_residual(if_jac,
                              f_x,
                              f_m_jac_xdot,
                              f_x_jac,
                              _discipline->side_loads());
-    e.volume_external_residual(if_jac,
-                               f_x,
-                               f_m_jac_xdot,
-                               f_x_jac,
-                               _discipline->volume_loads());
     
     //assembly of the capacitance term
     e.damping_residual(if_jac, f_m, f_m_jac_xdot, f_m_jac);
@@ -104,18 +104,17 @@ _elem_calculations(MAST::ElementBase& elem,
     f_x_jac.setZero();
     
     // assembly of the flux terms
-    e.internal_residual(if_jac, f_x, f_x_jac);
+    e.internal_and_volume_external_residual(if_jac,
+                                            f_x,
+                                            f_m_jac_xdot,
+                                            f_x_jac,
+                                            _discipline->volume_loads());
     e.damping_residual(if_jac, f_x, f_x_jac_xdot, f_x_jac);
     e.side_external_residual(if_jac,
                              f_x,
                              f_m_jac_xdot,
                              f_x_jac,
                              _discipline->side_loads());
-    e.volume_external_residual(if_jac,
-                               f_x,
-                               f_m_jac_xdot,
-                               f_x_jac,
-                               _discipline->volume_loads());
     
     //assembly of the capacitance term
     e.inertial_residual(if_jac, f_m, f_m_jac_xddot, f_m_jac_xdot, f_m_jac);
@@ -165,8 +164,30 @@ MAST::StructuralTransientAssembly::
 _elem_sensitivity_calculations(MAST::ElementBase& elem,
                                RealVectorX& vec) {
     
-    libmesh_error(); // to be implemented
+    MAST::StructuralElementBase& e =
+    dynamic_cast<MAST::StructuralElementBase&>(elem);
     
+    vec.setZero();
+    RealMatrixX
+    dummy = RealMatrixX::Zero(vec.size(), vec.size());
+    
+    e.internal_residual_sensitivity(false, vec, dummy);
+    e.side_external_residual_sensitivity(false,
+                                         vec,
+                                         dummy,
+                                         dummy,
+                                         _discipline->side_loads());
+    e.volume_external_residual_sensitivity(false,
+                                           vec,
+                                           dummy,
+                                           dummy,
+                                           _discipline->volume_loads());
+    
+    // the sensitivity of the damping term is not available from the
+    // elements, so only the inertial term is added for second order
+    // systems
+    if (_transient_solver->ode_order() > 1)
+        e.inertial_residual_sensitivity(false, vec, dummy, dummy, dummy);
 }
 
 
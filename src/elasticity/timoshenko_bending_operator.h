@@ -42,8 +42,7 @@ namespace MAST {
         
     public:
         TimoshenkoBendingOperator(MAST::StructuralElementBase& elem):
-        MAST::BendingOperator1D(elem),
-        _shear_quadrature_reduction(2)
+        MAST::BendingOperator1D(elem)
         { }
         
         virtual ~TimoshenkoBendingOperator() { }
@@ -85,13 +84,6 @@ namespace MAST {
                                             RealVectorX& local_f,
                                             RealMatrixX& local_jac,
                                             const MAST::FunctionBase* sens_params );
-        
-    protected:
-        
-        /*!
-         *   reduction in quadrature for shear energy
-         */
-        unsigned int _shear_quadrature_reduction;
     };
 }
 
@@ -158,7 +150,7 @@ calculate_transverse_shear_residual(bool request_jacobian,
     qrule.reset(fe_type.default_quadrature_rule
                 (_elem.dim(),
                  property.extra_quadrature_order(_elem, fe->get_fe_type())
-                 - _shear_quadrature_reduction).release());
+                 - (int)property.transverse_shear_quadrature_reduction()).release());
     fe->attach_quadrature_rule(qrule.get());
     fe->get_phi();
     fe->get_JxW();
@@ -20,6 +20,7 @@
 // MAST includes
 #include "fluid/conservative_fluid_element_base.h"
 #include "fluid/primitive_fluid_solution.h"
+#include "fluid/primitive_fluid_solution_batch.h"
 #include "fluid/small_disturbance_primitive_fluid_solution.h"
 #include "fluid/flight_condition.h"
 #include "base/boundary_condition_base.h"
@@ -28,6 +29,9 @@
 #include "elasticity/normal_rotation_function_base.h"
 #include "fluid/surface_integrated_pressure_output.h"
 #include "base/nonlinear_system.h"
+#include "fluid/lagged_discontinuity_operator.h"
+#include "numerics/tensor_product_kernel.h"
+#include "base/performance_log.h"
 
 
 MAST::ConservativeFluidElementBase::
@@ -35,7 +39,11 @@ ConservativeFluidElementBase(MAST::SystemInitialization& sys,
                              const libMesh::Elem& elem,
                              const MAST::FlightCondition& f):
 MAST::FluidElemBase(elem.dim(), f),
-MAST::ElementBase(sys, elem) {
+MAST::ElementBase(sys, elem),
+_if_volume_states(false),
+_if_volume_diffusion_jacobian(false),
+_lagged_dc(nullptr),
+_if_sum_factorization(false) {
     
     // initialize the finite element data structures
     _init_fe_and_qrule(elem, &_fe, &_qrule);
@@ -49,11 +57,63 @@ MAST::ConservativeFluidElementBase::~ConservativeFluidElementBase() {
 
 
 
+void
+MAST::ConservativeFluidElementBase::set_solution(const RealVectorX& vec,
+                                                 bool if_sens) {
+    
+    MAST::ElementBase::set_solution(vec, if_sens);
+    
+    if (!if_sens) {
+        
+        _if_volume_states             = false;
+        _if_volume_diffusion_jacobian = false;
+        _side_states.clear();
+    }
+}
+
+
+
+
+Real
+MAST::ConservativeFluidElementBase::max_spectral_radius() {
+    
+    const std::vector<MAST::ConservativeFluidElementBase::VolumeQPState>&
+    states = _volume_qp_states(false);
+    
+    Real
+    val = 0.;
+    
+    for (unsigned int qp=0; qp<states.size(); qp++) {
+        
+        const MAST::PrimitiveSolution& p = states[qp].primitive_sol;
+        
+        val = std::max(val,
+                       sqrt(p.u1*p.u1 + p.u2*p.u2 + p.u3*p.u3) + p.a);
+    }
+    
+    return val;
+}
+
+
 
 bool
 MAST::ConservativeFluidElementBase::internal_residual (bool request_jacobian,
                                                        RealVectorX& f,
                                                        RealMatrixX& jac) {
+    MAST_LOG_SCOPE("internal_residual()", "ConservativeFluidElementBase");
+    
+    if (!request_jacobian) {
+        
+        const MAST::TensorProductKernel*
+        k = _tensor_product_kernel();
+        
+        if (k) {
+            
+            _sum_factorized_internal_residual(*k, f);
+            return false;
+        }
+    }
+    
     const std::vector<Real>& JxW                  = _fe->get_JxW();
     const std::vector<std::vector<Real> >& phi    = _fe->get_phi();
     const unsigned int
@@ -63,114 +123,41 @@ MAST::ConservativeFluidElementBase::internal_residual (bool request_jacobian,
     nphi   = _fe->n_shape_functions();
     
     RealMatrixX
-    mat1_n1n1       = RealMatrixX::Zero(   n1,    n1),
-    mat2_n1n1       = RealMatrixX::Zero(   n1,    n1),
     mat3_n1n2       = RealMatrixX::Zero(   n1,    n2),
     mat4_n2n2       = RealMatrixX::Zero(   n2,    n2),
-    AiBi_adv        = RealMatrixX::Zero(   n1,    n2),
-    A_sens          = RealMatrixX::Zero(   n1,    n2),
-    LS              = RealMatrixX::Zero(   n1,    n2),
-    LS_sens         = RealMatrixX::Zero(   n2,    n2),
-    stress          = RealMatrixX::Zero(  dim,   dim),
-    dprim_dcons     = RealMatrixX::Zero(   n1,    n1),
-    dcons_dprim     = RealMatrixX::Zero(   n1,    n1);
+    A_sens          = RealMatrixX::Zero(   n1,    n2);
     
     RealVectorX
     vec1_n1   = RealVectorX::Zero(n1),
     vec2_n1   = RealVectorX::Zero(n1),
-    vec3_n2   = RealVectorX::Zero(n2),
-    dc        = RealVectorX::Zero(dim),
-    temp_grad = RealVectorX::Zero(dim);
-
-    
-    std::vector<RealMatrixX>
-    Ai_adv  (dim);
-    
-    std::vector<std::vector<RealMatrixX> >
-    Ai_sens  (dim);
-    
-    
-    for (unsigned int i=0; i<dim; i++) {
-        Ai_sens [i].resize(n1);
-        Ai_adv  [i].setZero(n1, n1);
-        for (unsigned int j=0; j<n1; j++)
-            Ai_sens[i][j].setZero(n1, n1);
-    }
+    vec3_n2   = RealVectorX::Zero(n2);
     
     
     std::vector<MAST::FEMOperatorMatrix> dBmat(dim);
     MAST::FEMOperatorMatrix Bmat;
-    MAST::PrimitiveSolution      primitive_sol;
+    
+    // the primitive solution, flux Jacobians and stabilization operators
+    // at the quadrature points are computed once for the current solution
+    const std::vector<MAST::ConservativeFluidElementBase::VolumeQPState>&
+    states = _volume_qp_states(request_jacobian);
     
     
     for (unsigned int qp=0; qp<JxW.size(); qp++) {
         
+        const MAST::ConservativeFluidElementBase::VolumeQPState&
+        state = states[qp];
+        
         // initialize the Bmat operator for this term
         _initialize_fem_interpolation_operator(qp, dim, *_fe, Bmat);
         
-        // calculate the local element solution
-        Bmat.right_multiply(vec1_n1, _sol);
-        
-        primitive_sol.zero();
-        primitive_sol.init(dim,
-                           vec1_n1,
-                           flight_condition->gas_property.cp,
-                           flight_condition->gas_property.cv,
-                           if_viscous());
-        
         // initialize the FEM derivative operator
         _initialize_fem_gradient_operator(qp, dim, *_fe, dBmat);
         
-        if (if_viscous()) {
-            
-            calculate_conservative_variable_jacobian(primitive_sol,
-                                                     dcons_dprim,
-                                                     dprim_dcons);
-            calculate_diffusion_tensors(_sol,
-                                        dBmat,
-                                        dprim_dcons,
-                                        primitive_sol,
-                                        stress,
-                                        temp_grad);
-        }
-        
-        AiBi_adv.setZero();
-        for (unsigned int i_dim=0; i_dim<dim; i_dim++) {
-            calculate_advection_flux_jacobian(i_dim, primitive_sol, Ai_adv[i_dim]);
-            calculate_advection_flux_jacobian_sensitivity_for_conservative_variable
-            (i_dim, primitive_sol, Ai_sens[i_dim]);
-            
-            dBmat[i_dim].left_multiply(mat3_n1n2, Ai_adv[i_dim]);
-            AiBi_adv += mat3_n1n2;
-        }
-        
-        // intrinsic time operator for this quadrature point
-        calculate_differential_operator_matrix(qp,
-                                               *_fe,
-                                               _sol,
-                                               primitive_sol,
-                                               Bmat,
-                                               dBmat,
-                                               Ai_adv,
-                                               AiBi_adv,
-                                               Ai_sens,
-                                               LS,
-                                               LS_sens);
-        
-        // discontinuity capturing operator for this quadrature point
-        calculate_aliabadi_discontinuity_operator(qp,
-                                                  *_fe,
-                                                  primitive_sol,
-                                                  _sol,
-                                                  dBmat,
-                                                  AiBi_adv,
-                                                  dc);
-        
         // assemble the residual due to flux operator
         for (unsigned int i_dim=0; i_dim<dim; i_dim++) {
             
             // first the flux
-            calculate_advection_flux(i_dim, primitive_sol, vec1_n1);
+            calculate_advection_flux(i_dim, state.primitive_sol, vec1_n1);
             dBmat[i_dim].vector_mult_transpose(vec3_n2, vec1_n1);
             f -= JxW[qp] * vec3_n2;
             
@@ -178,9 +165,9 @@ MAST::ConservativeFluidElementBase::internal_residual (bool request_jacobian,
             if (if_viscous()) {
                 
                 calculate_diffusion_flux(i_dim,
-                                         primitive_sol,
-                                         stress,
-                                         temp_grad,
+                                         state.primitive_sol,
+                                         state.stress,
+                                         state.temp_grad,
                                          vec1_n1);
                 dBmat[i_dim].vector_mult_transpose(vec3_n2, vec1_n1);
                 f += JxW[qp] * vec3_n2;
@@ -190,11 +177,11 @@ MAST::ConservativeFluidElementBase::internal_residual (bool request_jacobian,
             // use this to calculate the discontinuity capturing term
             dBmat[i_dim].vector_mult(vec1_n1, _sol);
             dBmat[i_dim].vector_mult_transpose(vec3_n2, vec1_n1);
-            f += JxW[qp] * dc(i_dim) * vec3_n2;
+            f += JxW[qp] * state.dc(i_dim) * vec3_n2;
         }
         
         // stabilization term
-        f += JxW[qp] * LS.transpose() * (AiBi_adv * _sol);
+        f += JxW[qp] * state.LS.transpose() * (state.AiBi_adv * _sol);
         
         
         if (request_jacobian) {
@@ -204,7 +191,7 @@ MAST::ConservativeFluidElementBase::internal_residual (bool request_jacobian,
             // contribution from flux Jacobian
             for (unsigned int i_dim=0; i_dim<dim; i_dim++) {
                 // flux term
-                Bmat.left_multiply(mat3_n1n2, Ai_adv[i_dim]);                        // A_i B
+                Bmat.left_multiply(mat3_n1n2, state.Ai_adv[i_dim]);                  // A_i B
                 dBmat[i_dim].right_multiply_transpose(mat4_n2n2, mat3_n1n2);          // dB_i^T A_i B
                 jac -= JxW[qp]*mat4_n2n2;
                 
@@ -212,7 +199,7 @@ MAST::ConservativeFluidElementBase::internal_residual (bool request_jacobian,
                 dBmat[i_dim].vector_mult(vec1_n1, _sol);
                 for (unsigned int i_cvar=0; i_cvar<n1; i_cvar++) {
                     
-                    vec2_n1 = Ai_sens[i_dim][i_cvar] * vec1_n1;
+                    vec2_n1 = state.Ai_sens[i_dim][i_cvar] * vec1_n1;
                     for (unsigned int i_phi=0; i_phi<nphi; i_phi++)
                         A_sens.col(nphi*i_cvar+i_phi) += phi[i_phi][qp] *vec2_n1; // assuming that all variables have same n_phi
                 }
@@ -222,12 +209,7 @@ MAST::ConservativeFluidElementBase::internal_residual (bool request_jacobian,
                     
                     for (unsigned int j_dim=0; j_dim<dim; j_dim++) {
                         
-                        calculate_diffusion_flux_jacobian(i_dim,
-                                                          j_dim,
-                                                          primitive_sol,
-                                                          mat1_n1n1);
-                        
-                        dBmat[j_dim].left_multiply(mat3_n1n2, mat1_n1n1);                     // Kij dB_j
+                        dBmat[j_dim].left_multiply(mat3_n1n2, state.Kij[i_dim*dim+j_dim]);  // Kij dB_j
                         dBmat[i_dim].right_multiply_transpose(mat4_n2n2, mat3_n1n2);          // dB_i^T Kij dB_j
                         jac += JxW[qp]*mat4_n2n2;
                     }
@@ -235,16 +217,16 @@ MAST::ConservativeFluidElementBase::internal_residual (bool request_jacobian,
                 
                 // discontinuity capturing term
                 dBmat[i_dim].right_multiply_transpose(mat4_n2n2, dBmat[i_dim]);   // dB_i^T dc dB_i
-                jac += JxW[qp] * dc(i_dim) * mat4_n2n2;
+                jac += JxW[qp] * state.dc(i_dim) * mat4_n2n2;
             }
             
             // stabilization term
-            jac  += JxW[qp] * LS.transpose() * AiBi_adv;                          // A_i dB_i
+            jac  += JxW[qp] * state.LS.transpose() * state.AiBi_adv;              // A_i dB_i
 
             // linearization of the Jacobian terms
-            jac += JxW[qp] * LS.transpose() * A_sens; // LS^T tau d^2F^adv_i / dx dU  (Ai sensitivity)
+            jac += JxW[qp] * state.LS.transpose() * A_sens; // LS^T tau d^2F^adv_i / dx dU  (Ai sensitivity)
                                           // linearization of the LS terms
-            jac += JxW[qp] * LS_sens;
+            jac += JxW[qp] * state.LS_sens;
             
         }
     }
@@ -255,6 +237,7 @@ MAST::ConservativeFluidElementBase::internal_residual (bool request_jacobian,
 
 
 
+
 bool
 MAST::ConservativeFluidElementBase::
 linearized_internal_residual (bool request_jacobian,
@@ -296,6 +279,8 @@ MAST::ConservativeFluidElementBase::velocity_residual (bool request_jacobian,
                                                        RealVectorX& f,
                                                        RealMatrixX& jac_xdot,
                                                        RealMatrixX& jac) {
+    MAST_LOG_SCOPE("velocity_residual()", "ConservativeFluidElementBase");
+    
     const std::vector<Real>& JxW           = _fe->get_JxW();
     const unsigned int
     dim    = _elem.dim(),
@@ -303,76 +288,24 @@ MAST::ConservativeFluidElementBase::velocity_residual (bool request_jacobian,
     n2     = _fe->n_shape_functions()*n1;
     
     RealMatrixX
-    tau              = RealMatrixX::Zero(n1, n1),
-    mat1_n1n1        = RealMatrixX::Zero(n1, n1),
-    mat2_n1n2        = RealMatrixX::Zero(n1, n2),
     mat3_n2n2        = RealMatrixX::Zero(n2, n2),
-    mat4_n2n1        = RealMatrixX::Zero(n2, n1),
-    AiBi_adv         = RealMatrixX::Zero(n1, n2),
-    A_sens           = RealMatrixX::Zero(n1, n2),
-    LS               = RealMatrixX::Zero(n1, n2),
-    LS_sens          = RealMatrixX::Zero(n2, n2);
+    mat4_n2n1        = RealMatrixX::Zero(n2, n1);
     RealVectorX
     vec1_n1          = RealVectorX::Zero(n1),
-    vec2_n1          = RealVectorX::Zero(n1),
     vec3_n2          = RealVectorX::Zero(n2);
     
-    std::vector<MAST::FEMOperatorMatrix> dBmat(dim);
     MAST::FEMOperatorMatrix      Bmat;
-    MAST::PrimitiveSolution      primitive_sol;
-    
-    std::vector<RealMatrixX>
-    Ai_adv  (dim);
     
-    std::vector<std::vector<RealMatrixX> >
-    Ai_sens  (dim);
-    
-    
-    for (unsigned int i=0; i<dim; i++) {
-        Ai_sens [i].resize(n1);
-        Ai_adv  [i].setZero(n1, n1);
-        for (unsigned int j=0; j<n1; j++)
-            Ai_sens[i][j].setZero(n1, n1);
-    }
+    // the stabilization operator is shared with the internal residual
+    const std::vector<MAST::ConservativeFluidElementBase::VolumeQPState>&
+    states = _volume_qp_states(false);
     
     
     for (unsigned int qp=0; qp<JxW.size(); qp++) {
         
-        // first need to set the solution of the conservative operator
-        _initialize_fem_interpolation_operator(qp, dim, *_fe, Bmat);
-        Bmat.right_multiply(vec1_n1, _sol);                                     //  B * U
-        
-        // initialize the primitive solution
-        primitive_sol.zero();
-        primitive_sol.init(dim,
-                           vec1_n1,
-                           flight_condition->gas_property.cp,
-                           flight_condition->gas_property.cv,
-                           if_viscous());
+        const RealMatrixX& LS = states[qp].LS;
         
-        // initialize the FEM derivative operator
-        _initialize_fem_gradient_operator(qp, dim, *_fe, dBmat);
-        
-        AiBi_adv.setZero();
-        for (unsigned int i_dim=0; i_dim<dim; i_dim++) {
-            calculate_advection_flux_jacobian(i_dim, primitive_sol, Ai_adv[i_dim]);
-            
-            dBmat[i_dim].left_multiply(mat2_n1n2, Ai_adv[i_dim]);
-            AiBi_adv += mat2_n1n2;
-        }
-        
-        // intrinsic time operator for this quadrature point
-        calculate_differential_operator_matrix(qp,
-                                               *_fe,
-                                               _sol,
-                                               primitive_sol,
-                                               Bmat,
-                                               dBmat,
-                                               Ai_adv,
-                                               AiBi_adv,
-                                               Ai_sens,
-                                               LS,
-                                               LS_sens);
+        _initialize_fem_interpolation_operator(qp, dim, *_fe, Bmat);
         
         // now evaluate the Jacobian due to the velocity term
         Bmat.right_multiply(vec1_n1, _vel);                                     //  B * U_dot
@@ -451,12 +384,14 @@ side_external_residual (bool request_jacobian,
                         RealMatrixX& jac,
                         std::multimap<libMesh::boundary_id_type, MAST::BoundaryConditionBase*>& bc) {
     
+    MAST_LOG_SCOPE("side_external_residual()", "ConservativeFluidElementBase");
+    
     typedef std::multimap<libMesh::boundary_id_type, MAST::BoundaryConditionBase*> maptype;
     
     // iterate over the boundary ids given in the provided force map
     std::pair<maptype::const_iterator, maptype::const_iterator> it;
     
-    const libMesh::BoundaryInfo& binfo = *_system.system().get_mesh().boundary_info;
+    const MAST::ElementTopologyCache& topology = _system.system().topology_cache();
     
     // for each boundary id, check if any of the sides on the element
     // has the associated boundary
@@ -465,12 +400,12 @@ side_external_residual (bool request_jacobian,
         
         // if no boundary ids have been specified for the side, then
         // move to the next side.
-        if (!binfo.n_boundary_ids(&_elem, n))
+        if (!topology.n_boundary_ids(_elem, n))
             continue;
         
         // check to see if any of the specified boundary ids has a boundary
         // condition associated with them
-        std::vector<libMesh::boundary_id_type> bc_ids = binfo.boundary_ids(&_elem, n);
+        std::vector<libMesh::boundary_id_type> bc_ids = topology.boundary_ids(_elem, n);
         std::vector<libMesh::boundary_id_type>::const_iterator bc_it = bc_ids.begin();
         
         for ( ; bc_it != bc_ids.end(); bc_it++) {
@@ -557,7 +492,7 @@ linearized_side_external_residual (bool request_jacobian,
     // iterate over the boundary ids given in the provided force map
     std::pair<maptype::const_iterator, maptype::const_iterator> it;
     
-    const libMesh::BoundaryInfo& binfo = *_system.system().get_mesh().boundary_info;
+    const MAST::ElementTopologyCache& topology = _system.system().topology_cache();
     
     // for each boundary id, check if any of the sides on the element
     // has the associated boundary
@@ -566,12 +501,12 @@ linearized_side_external_residual (bool request_jacobian,
         
         // if no boundary ids have been specified for the side, then
         // move to the next side.
-        if (!binfo.n_boundary_ids(&_elem, n))
+        if (!topology.n_boundary_ids(_elem, n))
             continue;
         
         // check to see if any of the specified boundary ids has a boundary
         // condition associated with them
-        std::vector<libMesh::boundary_id_type> bc_ids = binfo.boundary_ids(&_elem, n);
+        std::vector<libMesh::boundary_id_type> bc_ids = topology.boundary_ids(_elem, n);
         std::vector<libMesh::boundary_id_type>::const_iterator bc_it = bc_ids.begin();
         
         for ( ; bc_it != bc_ids.end(); bc_it++) {
@@ -675,7 +610,7 @@ side_external_residual_sensitivity (bool request_jacobian,
     // iterate over the boundary ids given in the provided force map
     std::pair<maptype::const_iterator, maptype::const_iterator> it;
     
-    const libMesh::BoundaryInfo& binfo = *_system.system().get_mesh().boundary_info;
+    const MAST::ElementTopologyCache& topology = _system.system().topology_cache();
     
     // for each boundary id, check if any of the sides on the element
     // has the associated boundary
@@ -684,12 +619,12 @@ side_external_residual_sensitivity (bool request_jacobian,
         
         // if no boundary ids have been specified for the side, then
         // move to the next side.
-        if (!binfo.n_boundary_ids(&_elem, n))
+        if (!topology.n_boundary_ids(_elem, n))
             continue;
         
         // check to see if any of the specified boundary ids has a boundary
         // condition associated with them
-        std::vector<libMesh::boundary_id_type> bc_ids = binfo.boundary_ids(&_elem, n);
+        std::vector<libMesh::boundary_id_type> bc_ids = topology.boundary_ids(_elem, n);
         std::vector<libMesh::boundary_id_type>::const_iterator bc_it = bc_ids.begin();
         
         for ( ; bc_it != bc_ids.end(); bc_it++) {
@@ -805,22 +740,18 @@ symmetry_surface_residual(bool request_jacobian,
     libMesh::Point pt;
     MAST::FEMOperatorMatrix Bmat;
     
-    // create objects to calculate the primitive solution, flux, and Jacobian
-    MAST::PrimitiveSolution      primitive_sol;
+    // solution at the side quadrature points
+    const std::vector<MAST::ConservativeFluidElementBase::SideQPState>&
+    states = _side_qp_states(s, *fe, false);
     
     for (unsigned int qp=0; qp<JxW.size(); qp++) {
         
         // initialize the Bmat operator for this term
         _initialize_fem_interpolation_operator(qp, dim, *fe, Bmat);
-        Bmat.right_multiply(vec1_n1, _sol);
+        vec1_n1 = states[qp].conservative_sol;
         
-        // initialize the primitive solution
-        primitive_sol.zero();
-        primitive_sol.init(dim,
-                           vec1_n1,
-                           flight_condition->gas_property.cp,
-                           flight_condition->gas_property.cv,
-                           if_viscous());
+        // primitive solution for the current element solution
+        const MAST::PrimitiveSolution& primitive_sol = states[qp].primitive_sol;
         
         
         vec1_n1.setZero();
@@ -926,10 +857,6 @@ slip_wall_surface_residual(bool request_jacobian,
     libMesh::Point pt;
     MAST::FEMOperatorMatrix Bmat;
     
-    // create objects to calculate the primitive solution, flux, and Jacobian
-    MAST::PrimitiveSolution      primitive_sol;
-    
-    
     // get the surface motion object from the boundary condition object
     MAST::FieldFunction<RealVectorX>
     *vel   = nullptr;
@@ -948,19 +875,18 @@ slip_wall_surface_residual(bool request_jacobian,
     // if displ is provided then n_rot must also be provided
     if (vel) libmesh_assert(n_rot);
     
+    // solution at the side quadrature points
+    const std::vector<MAST::ConservativeFluidElementBase::SideQPState>&
+    states = _side_qp_states(s, *fe, false);
+    
     for (unsigned int qp=0; qp<JxW.size(); qp++)
     {
         // initialize the Bmat operator for this term
         _initialize_fem_interpolation_operator(qp, dim, *fe, Bmat);
-        Bmat.right_multiply(vec1_n1, _sol);
+        vec1_n1 = states[qp].conservative_sol;
         
-        // initialize the primitive solution
-        primitive_sol.zero();
-        primitive_sol.init(dim,
-                           vec1_n1,
-                           flight_condition->gas_property.cp,
-                           flight_condition->gas_property.cv,
-                           if_viscous());
+        // primitive solution for the current element solution
+        const MAST::PrimitiveSolution& primitive_sol = states[qp].primitive_sol;
         
         ////////////////////////////////////////////////////////////
         //   Calculation of the surface velocity term.
@@ -1074,7 +1000,6 @@ linearized_slip_wall_surface_residual(bool request_jacobian,
     MAST::FEMOperatorMatrix Bmat;
     
     // create objects to calculate the primitive solution, flux, and Jacobian
-    MAST::PrimitiveSolution                            primitive_sol;
     MAST::SmallPerturbationPrimitiveSolution<Real>  sd_primitive_sol;
     
     Real
@@ -1100,20 +1025,19 @@ linearized_slip_wall_surface_residual(bool request_jacobian,
     // if displ is provided then n_rot must also be provided
     if (vel) libmesh_assert(n_rot);
 
+    // solution at the side quadrature points
+    const std::vector<MAST::ConservativeFluidElementBase::SideQPState>&
+    states = _side_qp_states(s, *fe, false);
+    
     for (unsigned int qp=0; qp<JxW.size(); qp++) {
         
         // initialize the Bmat operator for this term
         _initialize_fem_interpolation_operator(qp, dim, *fe, Bmat);
-        Bmat.right_multiply(vec1_n1,         _sol);  // conservative sol
+        vec1_n1 = states[qp].conservative_sol;  // conservative sol
         Bmat.right_multiply(vec2_n1,   _delta_sol);  // perturbation sol
         
-        // initialize the primitive solution
-        primitive_sol.zero();
-        primitive_sol.init(dim,
-                           vec1_n1,
-                           flight_condition->gas_property.cp,
-                           flight_condition->gas_property.cv,
-                           if_viscous());
+        // primitive solution for the current element solution
+        const MAST::PrimitiveSolution& primitive_sol = states[qp].primitive_sol;
         
         // initialize the small-disturbance primitive sol
         sd_primitive_sol.zero();
@@ -1274,10 +1198,6 @@ noslip_wall_surface_residual(bool request_jacobian,
     MAST::FEMOperatorMatrix Bmat;
     std::vector<MAST::FEMOperatorMatrix> dBmat(dim);
     
-    // create objects to calculate the primitive solution, flux, and Jacobian
-    MAST::PrimitiveSolution      primitive_sol;
-    
-    
     // get the surface motion object from the boundary condition object
     MAST::FieldFunction<RealVectorX>
     *vel   = nullptr;
@@ -1294,21 +1214,20 @@ noslip_wall_surface_residual(bool request_jacobian,
     }
 
     
+    // solution at the side quadrature points
+    const std::vector<MAST::ConservativeFluidElementBase::SideQPState>&
+    states = _side_qp_states(s, *fe, false);
+    
     for (unsigned int qp=0; qp<JxW.size(); qp++)
     {
         // initialize the Bmat operator for this term
         _initialize_fem_interpolation_operator(qp, dim, *fe, Bmat);
         _initialize_fem_gradient_operator(qp, dim, *fe, dBmat);
         
-        Bmat.right_multiply(vec1_n1, _sol);
+        vec1_n1 = states[qp].conservative_sol;
         
-        // initialize the primitive solution
-        primitive_sol.zero();
-        primitive_sol.init(dim,
-                           vec1_n1,
-                           flight_condition->gas_property.cp,
-                           flight_condition->gas_property.cv,
-                           if_viscous());
+        // primitive solution for the current element solution
+        const MAST::PrimitiveSolution& primitive_sol = states[qp].primitive_sol;
 
         // copy the surface normal
         for (unsigned int i_dim=0; i_dim<dim; i_dim++)
@@ -1442,7 +1361,6 @@ far_field_surface_residual(bool request_jacobian,
     std::auto_ptr<libMesh::QBase>  qrule(qrule_ptr);
     
     const std::vector<Real> &JxW                 = fe->get_JxW();
-    const std::vector<libMesh::Point>& normals   = fe->get_normals();
     
     const unsigned int
     dim    = _elem.dim(),
@@ -1454,22 +1372,19 @@ far_field_surface_residual(bool request_jacobian,
     vec2_n1   = RealVectorX::Zero(n1),
     vec3_n2   = RealVectorX::Zero(n2),
     flux      = RealVectorX::Zero(n1),
-    eig_val   = RealVectorX::Zero(n1),
     dnormal   = RealVectorX::Zero(dim);
     
     RealMatrixX
     mat1_n1n1        = RealMatrixX::Zero( n1, n1),
     mat2_n1n2        = RealMatrixX::Zero( n1, n2),
-    mat3_n2n2        = RealMatrixX::Zero( n2, n2),
-    leig_vec         = RealMatrixX::Zero( n1, n1),
-    leig_vec_inv_tr  = RealMatrixX::Zero( n1, n1);
+    mat3_n2n2        = RealMatrixX::Zero( n2, n2);
     
     libMesh::Point pt;
     MAST::FEMOperatorMatrix Bmat;
     
-    // create objects to calculate the primitive solution, flux, and Jacobian
-    MAST::PrimitiveSolution      primitive_sol;
-    
+    // solution at the side quadrature points
+    const std::vector<MAST::ConservativeFluidElementBase::SideQPState>&
+    states = _side_qp_states(s, *fe, true);
     
     for (unsigned int qp=0; qp<JxW.size(); qp++) {
         
@@ -1477,22 +1392,17 @@ far_field_surface_residual(bool request_jacobian,
         // first update the variables at the current quadrature point
         // initialize the Bmat operator for this term
         _initialize_fem_interpolation_operator(qp, dim, *fe, Bmat);
-        Bmat.right_multiply(vec1_n1, _sol);
-        
-        // initialize the primitive solution
-        primitive_sol.zero();
-        primitive_sol.init(dim,
-                           vec1_n1,
-                           flight_condition->gas_property.cp,
-                           flight_condition->gas_property.cv,
-                           if_viscous());
-
-        this->calculate_advection_left_eigenvector_and_inverse_for_normal
-        (primitive_sol,
-         normals[qp],
-         eig_val,
-         leig_vec,
-         leig_vec_inv_tr);
+        vec1_n1 = states[qp].conservative_sol;
+        
+        // primitive solution for the current element solution
+        const MAST::PrimitiveSolution& primitive_sol = states[qp].primitive_sol;
+
+        // eigen-decomposition of the advection flux Jacobian along the normal
+        const RealVectorX
+        &eig_val          = states[qp].eig_val;
+        const RealMatrixX
+        &leig_vec         = states[qp].leig_vec,
+        &leig_vec_inv_tr  = states[qp].leig_vec_inv_tr;
         
         // for all eigenalues that are less than 0, the characteristics are coming into the domain, hence,
         // evaluate them using the given solution.
@@ -1595,7 +1505,7 @@ side_output_quantity (bool request_derivative,
     // iterate over the boundary ids given in the provided force map
     std::pair<maptype::const_iterator, maptype::const_iterator> it;
     
-    const libMesh::BoundaryInfo& binfo = *_system.system().get_mesh().boundary_info;
+    const MAST::ElementTopologyCache& topology = _system.system().topology_cache();
     
     // for each boundary id, check if any of the sides on the element
     // has the associated boundary
@@ -1604,12 +1514,12 @@ side_output_quantity (bool request_derivative,
         
         // if no boundary ids have been specified for the side, then
         // move to the next side.
-        if (!binfo.n_boundary_ids(&_elem, n))
+        if (!topology.n_boundary_ids(_elem, n))
             continue;
         
         // check to see if any of the specified boundary ids has a boundary
         // condition associated with them
-        std::vector<libMesh::boundary_id_type> bc_ids = binfo.boundary_ids(&_elem, n);
+        std::vector<libMesh::boundary_id_type> bc_ids = topology.boundary_ids(_elem, n);
         std::vector<libMesh::boundary_id_type>::const_iterator bc_it = bc_ids.begin();
         
         for ( ; bc_it != bc_ids.end(); bc_it++) {
@@ -1678,22 +1588,20 @@ _calculate_surface_integrated_load(bool request_derivative,
     MAST::FEMOperatorMatrix Bmat;
     
     // create objects to calculate the primitive solution, flux, and Jacobian
-    MAST::PrimitiveSolution      primitive_sol;
     MAST::SmallPerturbationPrimitiveSolution<Real>  primitive_sol_sens;
     
+    // solution at the side quadrature points
+    const std::vector<MAST::ConservativeFluidElementBase::SideQPState>&
+    states = _side_qp_states(s, *fe, false);
+    
     for (unsigned int qp=0; qp<JxW.size(); qp++) {
         
         // initialize the Bmat operator for this term
         _initialize_fem_interpolation_operator(qp, dim, *fe, Bmat);
-        Bmat.right_multiply(vec1_n1, _sol);
+        vec1_n1 = states[qp].conservative_sol;
         
-        // initialize the primitive solution
-        primitive_sol.zero();
-        primitive_sol.init(dim,
-                           vec1_n1,
-                           flight_condition->gas_property.cp,
-                           flight_condition->gas_property.cv,
-                           if_viscous());
+        // primitive solution for the current element solution
+        const MAST::PrimitiveSolution& primitive_sol = states[qp].primitive_sol;
         
         
         for (unsigned int i_dim=0; i_dim<dim; i_dim++)
@@ -1783,3 +1691,387 @@ _initialize_fem_gradient_operator(const unsigned int qp,
 }
 
 
+
+
+
+
+const MAST::TensorProductKernel*
+MAST::ConservativeFluidElementBase::_tensor_product_kernel() const {
+    
+    if (!_if_sum_factorization || !_qrule)
+        return nullptr;
+    
+    return MAST::TensorProductKernel::get(_fe->get_fe_type(),
+                                          _elem.type(),
+                                          *_qrule);
+}
+
+
+
+void
+MAST::ConservativeFluidElementBase::
+_sum_factorized_internal_residual(const MAST::TensorProductKernel& k,
+                                  RealVectorX& f) {
+    
+    MAST_LOG_SCOPE("sum_factorized_internal_residual()", "ConservativeFluidElementBase");
+    
+    const std::vector<Real>& JxW                  = _fe->get_JxW();
+    const unsigned int
+    dim    = _elem.dim(),
+    n1     = dim+2,
+    nqp    = (unsigned int)JxW.size();
+    
+    libmesh_assert_equal_to(k.dim(), dim);
+    libmesh_assert_equal_to(k.n_qp(), nqp);
+    
+    // derivatives of the reference coordinates wrt the physical
+    // coordinates, dxi[k][i] = d xi_k / d x_i
+    const std::vector<Real>* dxi[3][3] = {
+        {&_fe->get_dxidx(),   &_fe->get_dxidy(),   &_fe->get_dxidz()},
+        {&_fe->get_detadx(),  &_fe->get_detady(),  &_fe->get_detadz()},
+        {&_fe->get_dzetadx(), &_fe->get_dzetady(), &_fe->get_dzetadz()}};
+    
+    RealVectorX
+    vec1_n1   = RealVectorX::Zero(n1),
+    vec2_n1   = RealVectorX::Zero(n1),
+    vec3_n1   = RealVectorX::Zero(n1);
+    
+    RealMatrixX
+    sol_qp;
+    
+    std::vector<RealMatrixX>
+    dsol_ref,
+    flux_ref(dim, RealMatrixX::Zero(n1, nqp));
+    
+    std::vector<RealVectorX>
+    dsol(dim, RealVectorX::Zero(n1));
+    
+    const std::vector<MAST::ConservativeFluidElementBase::VolumeQPState>&
+    states = _volume_qp_states(false);
+    
+    // solution and its derivatives wrt the reference coordinates
+    k.interpolate(_sol, n1, sol_qp, &dsol_ref);
+    
+    for (unsigned int qp=0; qp<nqp; qp++) {
+        
+        const MAST::ConservativeFluidElementBase::VolumeQPState&
+        state = states[qp];
+        
+        // solution derivative in the physical directions
+        for (unsigned int i_dim=0; i_dim<dim; i_dim++) {
+            
+            dsol[i_dim].setZero();
+            for (unsigned int k_dim=0; k_dim<dim; k_dim++)
+                dsol[i_dim] += (*dxi[k_dim][i_dim])[qp] * dsol_ref[k_dim].col(qp);
+        }
+        
+        vec2_n1.setZero();
+        
+        for (unsigned int i_dim=0; i_dim<dim; i_dim++) {
+            
+            // the advection, diffusion and discontinuity capturing
+            // fluxes in the i^th direction, which are integrated
+            // against the shape function derivatives
+            calculate_advection_flux(i_dim, state.primitive_sol, vec1_n1);
+            vec1_n1 *= -1.;
+            
+            if (if_viscous()) {
+                
+                calculate_diffusion_flux(i_dim,
+                                         state.primitive_sol,
+                                         state.stress,
+                                         state.temp_grad,
+                                         vec3_n1);
+                vec1_n1 += vec3_n1;
+            }
+            
+            vec1_n1 += state.dc(i_dim) * dsol[i_dim];
+            vec1_n1 *= JxW[qp];
+            
+            for (unsigned int k_dim=0; k_dim<dim; k_dim++)
+                flux_ref[k_dim].col(qp) += (*dxi[k_dim][i_dim])[qp] * vec1_n1;
+            
+            // A_i dU/dx_i for the stabilization term
+            vec2_n1 += state.Ai_adv[i_dim] * dsol[i_dim];
+        }
+        
+        // stabilization term
+        f += JxW[qp] * state.LS.transpose() * vec2_n1;
+    }
+    
+    k.integrate(nullptr, &flux_ref, f);
+}
+
+
+
+const std::vector<MAST::ConservativeFluidElementBase::VolumeQPState>&
+MAST::ConservativeFluidElementBase::
+_volume_qp_states(bool if_diffusion_jacobian) {
+    
+    const std::vector<std::vector<Real> >& phi    = _fe->get_phi();
+    const unsigned int
+    dim    = _elem.dim(),
+    n1     = dim+2,
+    n2     = _fe->n_shape_functions()*n1,
+    nphi   = _fe->n_shape_functions(),
+    nqp    = (unsigned int)_fe->get_JxW().size();
+    
+    if (!_if_volume_states) {
+        
+        MAST_LOG_SCOPE("_volume_qp_states()", "ConservativeFluidElementBase");
+        
+        RealMatrixX
+        mat3_n1n2       = RealMatrixX::Zero(   n1,    n2),
+        dprim_dcons     = RealMatrixX::Zero(   n1,    n1),
+        dcons_dprim     = RealMatrixX::Zero(   n1,    n1);
+        std::vector<MAST::FEMOperatorMatrix> dBmat(dim);
+        MAST::FEMOperatorMatrix Bmat;
+        
+        // the conservative solution at all quadrature points is computed
+        // with a single product of the nodal values and the shape functions,
+        // so that the flux Jacobians can be evaluated for all quadrature
+        // points with the fixed size kernels of MAST::FluidFluxJacobianBatch.
+        // This assumes that all variables have the same n_phi.
+        // With a sum-factorization kernel the same values are obtained
+        // without the shape function table.
+        const MAST::TensorProductKernel*
+        k = _tensor_product_kernel();
+        
+        RealMatrixX
+        sol_qp;
+        
+        if (k)
+            k->interpolate(_sol, n1, sol_qp);
+        else {
+            
+            RealMatrixX
+            phi_mat = RealMatrixX::Zero(nphi, nqp);
+            for (unsigned int i_phi=0; i_phi<nphi; i_phi++)
+                for (unsigned int qp=0; qp<nqp; qp++)
+                    phi_mat(i_phi, qp) = phi[i_phi][qp];
+            
+            sol_qp = Eigen::Map<const RealMatrixX>(_sol.data(), nphi, n1).transpose() * phi_mat;
+        }
+        
+        // frozen discontinuity capturing coefficients, if available
+        const std::vector<RealVectorX>*
+        frozen_dc = _lagged_dc? _lagged_dc->values(_elem): nullptr;
+        libmesh_assert(!frozen_dc || frozen_dc->size() == nqp);
+        
+        // the primitive variables of all quadrature points are computed
+        // together
+        MAST::PrimitiveSolutionBatch primitive_batch;
+        primitive_batch.init(dim,
+                             sol_qp,
+                             flight_condition->gas_property.cp,
+                             flight_condition->gas_property.cv,
+                             if_viscous());
+        
+        std::vector<MAST::PrimitiveSolution> primitive_sols(nqp);
+        for (unsigned int qp=0; qp<nqp; qp++)
+            primitive_batch.get_solution(qp, primitive_sols[qp]);
+        
+        std::vector<RealMatrixX>
+        Ai_adv_qp;
+        calculate_advection_flux_jacobian(primitive_sols, Ai_adv_qp);
+        
+        _volume_states.resize(nqp);
+        
+        for (unsigned int qp=0; qp<nqp; qp++) {
+            
+            MAST::ConservativeFluidElementBase::VolumeQPState&
+            state = _volume_states[qp];
+            
+            state.primitive_sol = primitive_sols[qp];
+            state.Kij.clear();
+            
+            _initialize_fem_interpolation_operator(qp, dim, *_fe, Bmat);
+            _initialize_fem_gradient_operator(qp, dim, *_fe, dBmat);
+            
+            state.stress.setZero(dim, dim);
+            state.temp_grad.setZero(dim);
+            
+            if (if_viscous()) {
+                
+                calculate_conservative_variable_jacobian(state.primitive_sol,
+                                                         dcons_dprim,
+                                                         dprim_dcons);
+                calculate_diffusion_tensors(_sol,
+                                            dBmat,
+                                            dprim_dcons,
+                                            state.primitive_sol,
+                                            state.stress,
+                                            state.temp_grad);
+            }
+            
+            state.Ai_adv.resize(dim);
+            state.Ai_sens.resize(dim);
+            state.AiBi_adv.setZero(n1, n2);
+            
+            for (unsigned int i_dim=0; i_dim<dim; i_dim++) {
+                
+                state.Ai_adv[i_dim] = flux_jacobian(Ai_adv_qp[i_dim], qp);
+                
+                state.Ai_sens[i_dim].resize(n1);
+                for (unsigned int j=0; j<n1; j++)
+                    state.Ai_sens[i_dim][j].setZero(n1, n1);
+                calculate_advection_flux_jacobian_sensitivity_for_conservative_variable
+                (i_dim, state.primitive_sol, state.Ai_sens[i_dim]);
+                
+                dBmat[i_dim].left_multiply(mat3_n1n2, state.Ai_adv[i_dim]);
+                state.AiBi_adv += mat3_n1n2;
+            }
+            
+            // intrinsic time operator for this quadrature point
+            state.LS.setZero(n1, n2);
+            state.LS_sens.setZero(n2, n2);
+            calculate_differential_operator_matrix(qp,
+                                                   *_fe,
+                                                   _sol,
+                                                   state.primitive_sol,
+                                                   Bmat,
+                                                   dBmat,
+                                                   state.Ai_adv,
+                                                   state.AiBi_adv,
+                                                   state.Ai_sens,
+                                                   state.LS,
+                                                   state.LS_sens);
+            
+            // discontinuity capturing operator for this quadrature point.
+            // calculate_hartmann_discontinuity_operator() uses the
+            // same inputs.
+            if (frozen_dc)
+                state.dc = (*frozen_dc)[qp];
+            else {
+                
+                state.dc.setZero(dim);
+                calculate_aliabadi_discontinuity_operator(qp,
+                                                          *_fe,
+                                                          state.primitive_sol,
+                                                          _sol,
+                                                          dBmat,
+                                                          state.AiBi_adv,
+                                                          state.dc);
+            }
+        }
+        
+        if (_lagged_dc && !frozen_dc) {
+            
+            std::vector<RealVectorX> dc(nqp);
+            for (unsigned int qp=0; qp<nqp; qp++)
+                dc[qp] = _volume_states[qp].dc;
+            _lagged_dc->set_values(_elem, dc);
+        }
+        
+        _if_volume_states             = true;
+        _if_volume_diffusion_jacobian = false;
+    }
+    
+    
+    if (if_diffusion_jacobian &&
+        if_viscous()          &&
+        !_if_volume_diffusion_jacobian) {
+        
+        std::vector<MAST::PrimitiveSolution> primitive_sols(nqp);
+        for (unsigned int qp=0; qp<nqp; qp++)
+            primitive_sols[qp] = _volume_states[qp].primitive_sol;
+        
+        std::vector<RealMatrixX>
+        Kij_qp;
+        calculate_diffusion_flux_jacobian(primitive_sols, Kij_qp);
+        
+        for (unsigned int qp=0; qp<nqp; qp++) {
+            
+            _volume_states[qp].Kij.resize(dim*dim);
+            for (unsigned int i=0; i<dim*dim; i++)
+                _volume_states[qp].Kij[i] = flux_jacobian(Kij_qp[i], qp);
+        }
+        
+        _if_volume_diffusion_jacobian = true;
+    }
+    
+    return _volume_states;
+}
+
+
+
+
+const std::vector<MAST::ConservativeFluidElementBase::SideQPState>&
+MAST::ConservativeFluidElementBase::
+_side_qp_states(const unsigned int s,
+                const libMesh::FEBase& fe,
+                bool if_eigen_decomposition) {
+    
+    const std::vector<libMesh::Point>& normals   = fe.get_normals();
+    const unsigned int
+    dim    = _elem.dim(),
+    n1     = dim+2,
+    nqp    = (unsigned int)fe.get_JxW().size();
+    
+    std::map<unsigned int,
+    std::pair<bool, std::vector<MAST::ConservativeFluidElementBase::SideQPState> > >::iterator
+    it = _side_states.find(s);
+    
+    if (it == _side_states.end()) {
+        
+        MAST_LOG_SCOPE("_side_qp_states()", "ConservativeFluidElementBase");
+        
+        it = _side_states.insert
+        (std::make_pair(s,
+                        std::make_pair
+                        (false,
+                         std::vector<MAST::ConservativeFluidElementBase::SideQPState>(nqp)))).first;
+        
+        MAST::FEMOperatorMatrix Bmat;
+        RealMatrixX sol_qp = RealMatrixX::Zero(n1, nqp);
+        
+        for (unsigned int qp=0; qp<nqp; qp++) {
+            
+            MAST::ConservativeFluidElementBase::SideQPState&
+            state = it->second.second[qp];
+            
+            _initialize_fem_interpolation_operator(qp, dim, fe, Bmat);
+            state.conservative_sol.setZero(n1);
+            Bmat.right_multiply(state.conservative_sol, _sol);
+            sol_qp.col(qp) = state.conservative_sol;
+        }
+        
+        // the primitive variables of all quadrature points are computed
+        // together
+        MAST::PrimitiveSolutionBatch primitive_batch;
+        primitive_batch.init(dim,
+                             sol_qp,
+                             flight_condition->gas_property.cp,
+                             flight_condition->gas_property.cv,
+                             if_viscous());
+        
+        for (unsigned int qp=0; qp<nqp; qp++)
+            primitive_batch.get_solution(qp, it->second.second[qp].primitive_sol);
+    }
+    
+    libmesh_assert_equal_to(it->second.second.size(), nqp);
+    
+    if (if_eigen_decomposition && !it->second.first) {
+        
+        for (unsigned int qp=0; qp<nqp; qp++) {
+            
+            MAST::ConservativeFluidElementBase::SideQPState&
+            state = it->second.second[qp];
+            
+            state.eig_val.setZero(n1);
+            state.leig_vec.setZero(n1, n1);
+            state.leig_vec_inv_tr.setZero(n1, n1);
+            
+            this->calculate_advection_left_eigenvector_and_inverse_for_normal
+            (state.primitive_sol,
+             normals[qp],
+             state.eig_val,
+             state.leig_vec,
+             state.leig_vec_inv_tr);
+        }
+        
+        it->second.first = true;
+    }
+    
+    return it->second.second;
+}
@@ -21,9 +21,15 @@
 #define __mast__conservative_fluid_element_base__
 
 
+// C++ includes
+#include <map>
+#include <vector>
+
+
 // MAST includes
 #include "base/elem_base.h"
 #include "fluid/fluid_elem_base.h"
+#include "fluid/primitive_fluid_solution.h"
 
 
 namespace MAST {
@@ -33,6 +39,8 @@ namespace MAST {
     class LocalElemBase;
     class BoundaryConditionBase;
     class FEMOperatorMatrix;
+    class LaggedDiscontinuityOperator;
+    class TensorProductKernel;
 
     
     /*!
@@ -52,6 +60,51 @@ namespace MAST {
         virtual ~ConservativeFluidElementBase();
         
         
+        /*!
+         *   stores \p vec as solution for element level calculations,
+         *   or its sensitivity if \p if_sens is true. A new solution
+         *   clears the quadrature point states computed for the
+         *   previous solution.
+         */
+        virtual void set_solution(const RealVectorX& vec,
+                                  bool if_sens = false);
+        
+        
+        /*!
+         *   tells the element to use the discontinuity capturing 
+         *   coefficients stored in \p op, unless these are being updated,
+         *   in which case the computed coefficients are stored in \p op.
+         *   A nullptr computes the coefficients for each solution.
+         */
+        void set_lagged_discontinuity_operator(MAST::LaggedDiscontinuityOperator* op) {
+            
+            _lagged_dc = op;
+        }
+        
+        
+        /*!
+         *   if \p f is \p true, the residual without the Jacobian is
+         *   computed with the sum-factorized kernels of
+         *   MAST::TensorProductKernel for elements of tensor-product type
+         *   (QUAD4/QUAD9 and HEX8/HEX27 with Lagrange shape functions
+         *   and Gauss quadrature). Other elements, and the Jacobian,
+         *   always use the full shape function tables. This is \p false
+         *   by default.
+         */
+        void set_sum_factorization(bool f) {
+            
+            _if_sum_factorization = f;
+        }
+        
+        
+        /*!
+         *   @returns the maximum over the element quadrature points of the
+         *   spectral radius of the advection flux Jacobian,
+         *   \f$ |u| + a \f$, for the current solution.
+         */
+        Real max_spectral_radius();
+        
+        
         /*!
          *   internal force contribution to system residual
          */
@@ -269,6 +322,162 @@ namespace MAST {
                                                const libMesh::FEBase& fe,
                                                std::vector<MAST::FEMOperatorMatrix>& dBmat);
         
+        
+        /*!
+         *   quantities at a volume quadrature point that depend only on
+         *   the element solution, and are shared by the residual and
+         *   Jacobian routines.
+         */
+        struct VolumeQPState {
+            
+            /*!
+             *   primitive solution at the quadrature point
+             */
+            MAST::PrimitiveSolution                  primitive_sol;
+            
+            /*!
+             *   advection flux Jacobians A_i
+             */
+            std::vector<RealMatrixX>                 Ai_adv;
+            
+            /*!
+             *   sensitivity of A_i wrt the conservative variables,
+             *   Ai_sens[i][j] = dA_i/dU_j
+             */
+            std::vector<std::vector<RealMatrixX> >   Ai_sens;
+            
+            /*!
+             *   diffusion flux Jacobians, Kij[i*dim+j] = K_ij. This is
+             *   empty unless the diffusion Jacobians have been requested
+             *   for a viscous element.
+             */
+            std::vector<RealMatrixX>                 Kij;
+            
+            /*!
+             *   sum A_i dB_i, used as input to the stabilization and
+             *   discontinuity capturing operators
+             */
+            RealMatrixX                              AiBi_adv;
+            
+            /*!
+             *   least-squares stabilization operator and its linearization
+             */
+            RealMatrixX                              LS;
+            RealMatrixX                              LS_sens;
+            
+            /*!
+             *   viscous stress tensor and temperature gradient
+             */
+            RealMatrixX                              stress;
+            RealVectorX                              temp_grad;
+            
+            /*!
+             *   discontinuity capturing coefficients
+             */
+            RealVectorX                              dc;
+        };
+        
+        
+        /*!
+         *   quantities at a side quadrature point that depend only on
+         *   the element solution.
+         */
+        struct SideQPState {
+            
+            /*!
+             *   conservative and primitive solution at the quadrature point
+             */
+            RealVectorX                              conservative_sol;
+            MAST::PrimitiveSolution                  primitive_sol;
+            
+            /*!
+             *   eigenvalues, left eigenvectors and inverse transpose of
+             *   the left eigenvectors of the advection flux Jacobian along
+             *   the side normal
+             */
+            RealVectorX                              eig_val;
+            RealMatrixX                              leig_vec;
+            RealMatrixX                              leig_vec_inv_tr;
+        };
+        
+        
+        /*!
+         *   @returns the sum-factorization kernel for this element, or
+         *   \p nullptr if sum factorization is not requested or not
+         *   supported for the element
+         */
+        const MAST::TensorProductKernel* _tensor_product_kernel() const;
+        
+        
+        /*!
+         *   adds the internal residual to \p f with the sum-factorization
+         *   kernel \p k. The flux and discontinuity capturing terms are
+         *   integrated with the reference derivatives of the shape
+         *   functions, and the solution gradient is interpolated with
+         *   \p k. The stabilization term uses the operators of the
+         *   quadrature point states.
+         */
+        void _sum_factorized_internal_residual(const MAST::TensorProductKernel& k,
+                                               RealVectorX& f);
+        
+        
+        /*!
+         *   @returns the states at the volume quadrature points of \p _fe
+         *   for the current solution. These are computed on the first call
+         *   after set_solution(). The diffusion flux Jacobians are
+         *   included if \p if_diffusion_jacobian is \p true.
+         */
+        const std::vector<MAST::ConservativeFluidElementBase::VolumeQPState>&
+        _volume_qp_states(bool if_diffusion_jacobian);
+        
+        
+        /*!
+         *   @returns the states at the quadrature points of side \p s,
+         *   for which \p fe has been initialized, for the current solution.
+         *   The eigen-decomposition along the side normal is included if
+         *   \p if_eigen_decomposition is \p true.
+         */
+        const std::vector<MAST::ConservativeFluidElementBase::SideQPState>&
+        _side_qp_states(const unsigned int s,
+                        const libMesh::FEBase& fe,
+                        bool if_eigen_decomposition);
+        
+        
+        /*!
+         *   \p true if \p _volume_states holds the states for the current
+         *   solution
+         */
+        bool                                    _if_volume_states;
+        
+        /*!
+         *   \p true if \p _volume_states includes the diffusion 
+         *   flux Jacobians
+         */
+        bool                                    _if_volume_diffusion_jacobian;
+        
+        /*!
+         *   states at the volume quadrature points
+         */
+        std::vector<MAST::ConservativeFluidElementBase::VolumeQPState>   _volume_states;
+        
+        /*!
+         *   states at the side quadrature points for each side, and
+         *   whether the eigen-decomposition has been computed for it.
+         */
+        std::map<unsigned int,
+        std::pair<bool, std::vector<MAST::ConservativeFluidElementBase::SideQPState> > >
+        _side_states;
+        
+        /*!
+         *   store of the frozen discontinuity capturing coefficients,
+         *   if provided
+         */
+        MAST::LaggedDiscontinuityOperator*      _lagged_dc;
+        
+        /*!
+         *   flag to compute the residual with sum factorization
+         */
+        bool                                    _if_sum_factorization;
     };
 }
 
@@ -21,13 +21,24 @@
 #include "fluid/conservative_fluid_transient_assembly.h"
 #include "fluid/conservative_fluid_discipline.h"
 #include "fluid/conservative_fluid_element_base.h"
+#include "fluid/lagged_discontinuity_operator.h"
+#include "fluid/surface_integrated_pressure_output.h"
+#include "base/boundary_side_index.h"
+#include "base/system_initialization.h"
+#include "base/nonlinear_system.h"
 #include "property_cards/element_property_card_base.h"
 #include "base/physics_discipline_base.h"
 
 
+// libMesh includes
+#include "libmesh/numeric_vector.h"
+
+
 MAST::ConservativeFluidTransientAssembly::
 ConservativeFluidTransientAssembly():
-MAST::TransientAssembly() {
+MAST::TransientAssembly(),
+_lagged_dc(nullptr),
+_if_sum_factorization(false) {
     
 }
 
@@ -37,6 +48,131 @@ MAST::TransientAssembly() {
 MAST::ConservativeFluidTransientAssembly::
 ~ConservativeFluidTransientAssembly() {
     
+    _clear_side_indices();
+}
+
+
+
+void
+MAST::ConservativeFluidTransientAssembly::
+residual_and_jacobian (const libMesh::NumericVector<Real>& X,
+                       libMesh::NumericVector<Real>* R,
+                       libMesh::SparseMatrix<Real>*  J,
+                       libMesh::NonlinearImplicitSystem& S) {
+    
+    if (_lagged_dc)
+        _lagged_dc->begin_assembly(S.get_mesh(), R != nullptr, J != nullptr);
+    
+    // the operator is notified of the end of the assembly when the
+    // residual is closed, which may be deferred
+    MAST::TransientAssembly::residual_and_jacobian(X, R, J, S);
+}
+
+
+
+void
+MAST::ConservativeFluidTransientAssembly::close_residual_and_jacobian() {
+    
+    // nothing is pending
+    if (!_deferred_R && !_deferred_J)
+        return;
+    
+    libMesh::NumericVector<Real>* R = _deferred_R;
+    
+    MAST::TransientAssembly::close_residual_and_jacobian();
+    
+    if (_lagged_dc)
+        _lagged_dc->end_assembly(R != nullptr, R? R->l2_norm(): 0.);
+}
+
+
+
+void
+MAST::ConservativeFluidTransientAssembly::clear_mesh_dependent_data() {
+    
+    MAST::TransientAssembly::clear_mesh_dependent_data();
+    
+    if (_lagged_dc)
+        _lagged_dc->clear();
+    
+    _clear_side_indices();
+}
+
+
+
+void
+MAST::ConservativeFluidTransientAssembly::
+calculate_outputs(const libMesh::NumericVector<Real>& X) {
+    
+    MAST::TransientAssembly::calculate_outputs(X);
+    
+    // boundary ids of each surface integrated pressure output
+    std::map<MAST::OutputFunctionBase*, std::set<libMesh::boundary_id_type> >
+    outputs;
+    
+    MAST::SideOutputMapType::const_iterator
+    it    = _discipline->side_output().begin(),
+    end   = _discipline->side_output().end();
+    
+    for ( ; it != end; it++)
+        if (it->second->type() == MAST::SURFACE_INTEGRATED_LIFT)
+            outputs[it->second].insert(it->first);
+    
+    if (!outputs.size())
+        return;
+    
+    MAST::NonlinearSystem& sys = _system->system();
+    
+    std::auto_ptr<libMesh::NumericVector<Real> >
+    localized_solution(_build_localized_vector(sys, X).release());
+    
+    const MAST::FlightCondition& flt =
+    dynamic_cast<const MAST::ConservativeFluidDiscipline&>(*_discipline).flight_condition();
+    
+    std::map<MAST::OutputFunctionBase*, std::set<libMesh::boundary_id_type> >::iterator
+    o_it   = outputs.begin(),
+    o_end  = outputs.end();
+    
+    for ( ; o_it != o_end; o_it++) {
+        
+        MAST::BoundarySideIndex*& index = _side_indices[o_it->first];
+        
+        if (!index) {
+            
+            index = new MAST::BoundarySideIndex;
+            index->init(*_system, o_it->second);
+        }
+        
+        dynamic_cast<MAST::SurfaceIntegratedPressureOutput&>(*o_it->first).
+        calculate_load(*index,
+                       *localized_solution,
+                       flt,
+                       sys.get_mesh().mesh_dimension());
+    }
+}
+
+
+
+bool
+MAST::ConservativeFluidTransientAssembly::
+_if_elem_side_output(const MAST::OutputFunctionBase& o) const {
+    
+    return o.type() != MAST::SURFACE_INTEGRATED_LIFT;
+}
+
+
+
+void
+MAST::ConservativeFluidTransientAssembly::_clear_side_indices() {
+    
+    std::map<const MAST::OutputFunctionBase*, MAST::BoundarySideIndex*>::iterator
+    it   = _side_indices.begin(),
+    end  = _side_indices.end();
+    
+    for ( ; it != end; it++)
+        delete it->second;
+    
+    _side_indices.clear();
 }
 
 
@@ -60,6 +196,9 @@ _elem_calculations(MAST::ElementBase& elem,
     f_m_jac.setZero();
     f_x_jac.setZero();
     
+    e.set_lagged_discontinuity_operator(_lagged_dc);
+    e.set_sum_factorization(_if_sum_factorization);
+    
     // assembly of the flux terms
     e.internal_residual(if_jac, f_x, f_x_jac);
     e.side_external_residual(if_jac, f_x, f_x_jac, _discipline->side_loads());
@@ -97,6 +236,19 @@ _linearized_jacobian_solution_product(MAST::ElementBase& elem,
 
 
 
+Real
+MAST::ConservativeFluidTransientAssembly::
+_elem_local_time_step(MAST::ElementBase& elem,
+                      const Real cfl) {
+    
+    MAST::ConservativeFluidElementBase& e =
+    dynamic_cast<MAST::ConservativeFluidElementBase&>(elem);
+    
+    return cfl * elem.elem().hmin() / e.max_spectral_radius();
+}
+
+
+
 void
 MAST::ConservativeFluidTransientAssembly::
 _elem_sensitivity_calculations(MAST::ElementBase& elem,
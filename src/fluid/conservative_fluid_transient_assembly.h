@@ -20,6 +20,10 @@
 #ifndef __mast__conservative_fluid_transient_assembly_h__
 #define __mast__conservative_fluid_transient_assembly_h__
 
+// C++ includes
+#include <map>
+#include <set>
+
 // MAST includes
 #include "base/transient_assembly.h"
 
@@ -27,6 +31,10 @@
 
 namespace MAST {
     
+    // Forward declarations
+    class LaggedDiscontinuityOperator;
+    class BoundarySideIndex;
+    
     
     class ConservativeFluidTransientAssembly:
     public MAST::TransientAssembly {
@@ -44,6 +52,67 @@ namespace MAST {
          */
         virtual ~ConservativeFluidTransientAssembly();
         
+        
+        /*!
+         *   tells the assembly to freeze the discontinuity capturing
+         *   coefficients of the elements in \p op between the updates
+         *   defined by \p op. A nullptr recomputes the coefficients in
+         *   each assembly, which is the default.
+         */
+        void set_lagged_discontinuity_operator(MAST::LaggedDiscontinuityOperator* op) {
+            
+            _lagged_dc = op;
+        }
+        
+        
+        /*!
+         *   if \p f is \p true, the element residuals without the
+         *   Jacobian are computed with sum factorization for elements of
+         *   tensor-product type, see
+         *   MAST::ConservativeFluidElementBase::set_sum_factorization().
+         *   This is \p false by default.
+         */
+        void set_sum_factorization(bool f) {
+            
+            _if_sum_factorization = f;
+        }
+        
+        
+        /*!
+         *   clears the coefficients of the lagged discontinuity operator,
+         *   if provided, along with the data of the parent class
+         */
+        virtual void clear_mesh_dependent_data();
+        
+        
+        /*!
+         *   evaluates the outputs of the discipline. The surface integrated
+         *   pressure outputs are evaluated over a
+         *   MAST::BoundarySideIndex of their boundary ids, which is built
+         *   in the first call and reused until the mesh changes. The other
+         *   outputs are evaluated by the parent class.
+         */
+        virtual void calculate_outputs(const libMesh::NumericVector<Real>& X);
+        
+        
+        /*!
+         *    function that assembles the matrices and vectors quantities for
+         *    nonlinear solution. This notifies the lagged discontinuity
+         *    operator, if provided, before and after the assembly.
+         */
+        virtual void
+        residual_and_jacobian (const libMesh::NumericVector<Real>& X,
+                               libMesh::NumericVector<Real>* R,
+                               libMesh::SparseMatrix<Real>*  J,
+                               libMesh::NonlinearImplicitSystem& S);
+        
+        
+        /*!
+         *    closes the residual and Jacobian, and then notifies the lagged
+         *    discontinuity operator, if provided, of the end of the assembly.
+         */
+        virtual void close_residual_and_jacobian();
+        
         //**************************************************************
         //these methods are provided for use by the solvers
         //**************************************************************
@@ -95,6 +164,17 @@ namespace MAST {
         
         
         
+        /*!
+         *   @returns the local time step for \par elem as
+         *   \f$ CFL h_{min} / \lambda_{max} \f$, where \f$ \lambda_{max} \f$
+         *   is the maximum spectral radius of the advection flux Jacobian
+         *   over the element quadrature points.
+         */
+        virtual Real
+        _elem_local_time_step(MAST::ElementBase& elem,
+                              const Real cfl);
+        
+        
         /*!
          *   performs the element sensitivity calculations over \par elem,
          *   and returns the element residual sensitivity in \par vec .
@@ -113,6 +193,36 @@ namespace MAST {
         virtual std::auto_ptr<MAST::ElementBase>
         _build_elem(const libMesh::Elem& elem);
         
+        
+        /*!
+         *   @returns \p false for the surface integrated pressure outputs,
+         *   which are evaluated in calculate_outputs() over the boundary
+         *   side index instead of the element side loop.
+         */
+        virtual bool _if_elem_side_output(const MAST::OutputFunctionBase& o) const;
+        
+        
+        /*!
+         *   deletes the boundary side indices of the outputs
+         */
+        void _clear_side_indices();
+        
+        /*!
+         *   store of the frozen discontinuity capturing coefficients
+         */
+        MAST::LaggedDiscontinuityOperator* _lagged_dc;
+        
+        /*!
+         *   flag to use sum factorization for the element residuals
+         */
+        bool                               _if_sum_factorization;
+        
+        /*!
+         *   boundary side index of each surface integrated pressure output
+         */
+        std::map<const MAST::OutputFunctionBase*, MAST::BoundarySideIndex*>
+        _side_indices;
+        
     };
     
     
@@ -0,0 +1,375 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2017  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+// C++ includes
+#include <fstream>
+#include <sstream>
+#include <cstdio>
+
+
+// MAST includes
+#include "fluid/fluid_base_solution_cache.h"
+#include "fluid/flight_condition.h"
+#include "base/performance_log.h"
+
+
+MAST::FluidBaseSolutionCache::
+FluidBaseSolutionCache(const libMesh::Parallel::Communicator& comm_in,
+                       unsigned int max_entries):
+libMesh::ParallelObject(comm_in),
+tol(1.e-10),
+_max_entries(max_entries),
+_next_id(0),
+_n_hits(0),
+_n_misses(0) {
+    
+}
+
+
+
+MAST::FluidBaseSolutionCache::~FluidBaseSolutionCache() {
+    
+    this->clear();
+}
+
+
+
+void
+MAST::FluidBaseSolutionCache::set_max_entries(unsigned int n) {
+    
+    _max_entries = n;
+    this->_evict();
+}
+
+
+
+void
+MAST::FluidBaseSolutionCache::set_spill_directory(const std::string& dir) {
+    
+    _spill_dir = dir;
+}
+
+
+
+bool
+MAST::FluidBaseSolutionCache::find(const MAST::FlightCondition& flt,
+                                   unsigned int version,
+                                   libMesh::NumericVector<Real>& sol) {
+    
+    std::vector<Real> key;
+    this->_key(flt, key);
+    
+    std::list<Entry>::iterator
+    it  = _entries.begin(),
+    end = _entries.end();
+    
+    for ( ; it != end; it++) {
+        
+        if (it->version != version)
+            continue;
+        
+        bool
+        same = true;
+        
+        for (unsigned int i=0; i<key.size(); i++)
+            if (std::fabs(it->key[i] - key[i]) >
+                tol * std::max(std::fabs(key[i]), 1.)) {
+                same = false;
+                break;
+            }
+        
+        if (same) {
+            
+            this->_load(it, sol);
+            _n_hits++;
+            return true;
+        }
+    }
+    
+    _n_misses++;
+    return false;
+}
+
+
+
+bool
+MAST::FluidBaseSolutionCache::nearest(const MAST::FlightCondition& flt,
+                                      unsigned int version,
+                                      libMesh::NumericVector<Real>& sol) {
+    
+    std::vector<Real> key;
+    this->_key(flt, key);
+    
+    std::list<Entry>::iterator
+    it   = _entries.begin(),
+    end  = _entries.end(),
+    near = end;
+    
+    Real
+    d     = 0.,
+    d_min = 0.;
+    
+    for ( ; it != end; it++) {
+        
+        if (it->version != version)
+            continue;
+        
+        d = this->_distance(key, it->key);
+        
+        if (near == end || d < d_min) {
+            
+            near  = it;
+            d_min = d;
+        }
+    }
+    
+    if (near == end)
+        return false;
+    
+    this->_load(near, sol);
+    return true;
+}
+
+
+
+void
+MAST::FluidBaseSolutionCache::add(const MAST::FlightCondition& flt,
+                                  unsigned int version,
+                                  const libMesh::NumericVector<Real>& sol) {
+    
+    MAST_LOG_SCOPE("add()", "FluidBaseSolutionCache");
+    
+    std::vector<Real> key;
+    this->_key(flt, key);
+    
+    // replace the entry of the same key, if it exists
+    std::list<Entry>::iterator
+    it  = _entries.begin(),
+    end = _entries.end();
+    
+    for ( ; it != end; it++)
+        if (it->version == version &&
+            this->_distance(key, it->key) <= tol)
+            break;
+    
+    if (it == end) {
+        
+        _entries.push_front(Entry());
+        it          = _entries.begin();
+        it->key     = key;
+        it->version = version;
+        it->id      = _next_id++;
+    }
+    else
+        _entries.splice(_entries.begin(), _entries, it);
+    
+    if (!it->sol)
+        it->sol = sol.clone().release();
+    else
+        *it->sol = sol;
+    it->sol->close();
+    
+    this->_evict();
+}
+
+
+
+void
+MAST::FluidBaseSolutionCache::clear() {
+    
+    std::list<Entry>::iterator
+    it  = _entries.begin(),
+    end = _entries.end();
+    
+    for ( ; it != end; it++) {
+        
+        if (it->sol)
+            delete it->sol;
+        else
+            std::remove(this->_file_name(it->id).c_str());
+    }
+    
+    _entries.clear();
+}
+
+
+
+void
+MAST::FluidBaseSolutionCache::_key(const MAST::FlightCondition& flt,
+                                   std::vector<Real>& key) const {
+    
+    key.resize(7);
+    key[0] = flt.mach;
+    key[1] = flt.altitude;
+    key[2] = flt.gas_property.rho;
+    key[3] = flt.gas_property.T;
+    key[4] = flt.body_euler_angles(0);
+    key[5] = flt.body_euler_angles(1);
+    key[6] = flt.body_euler_angles(2);
+}
+
+
+
+Real
+MAST::FluidBaseSolutionCache::_distance(const std::vector<Real>& k0,
+                                        const std::vector<Real>& k1) const {
+    
+    libmesh_assert_equal_to(k0.size(), k1.size());
+    
+    Real
+    v = 0.,
+    d = 0.;
+    
+    for (unsigned int i=0; i<k0.size(); i++) {
+        
+        v  = (k1[i] - k0[i]) / std::max(std::fabs(k0[i]), 1.);
+        d += v * v;
+    }
+    
+    return std::sqrt(d);
+}
+
+
+
+std::string
+MAST::FluidBaseSolutionCache::_file_name(unsigned int id) const {
+    
+    std::ostringstream oss;
+    oss << _spill_dir << "/fluid_base_solution_" << id
+    << "." << this->comm().rank() << ".bin";
+    
+    return oss.str();
+}
+
+
+
+void
+MAST::FluidBaseSolutionCache::_load(std::list<Entry>::iterator e,
+                                    libMesh::NumericVector<Real>& sol) {
+    
+    MAST_LOG_SCOPE("load()", "FluidBaseSolutionCache");
+    
+    if (!e->sol) {
+        
+        // read the local values of the spilled solution
+        const libMesh::numeric_index_type
+        first = sol.first_local_index(),
+        last  = sol.last_local_index();
+        
+        const std::string
+        nm = this->_file_name(e->id);
+        
+        std::ifstream in(nm.c_str(), std::ios::in | std::ios::binary);
+        if (!in.good())
+            libmesh_error_msg("Unable to open file: " << nm);
+        
+        unsigned long long
+        n = 0;
+        in.read((char*)&n, sizeof(unsigned long long));
+        
+        if (n != last - first)
+            libmesh_error_msg
+            ("Local size of spilled solution does not match the vector: " << nm);
+        
+        std::vector<Real> vals(n);
+        if (n)
+            in.read((char*)&vals[0], n*sizeof(Real));
+        in.close();
+        std::remove(nm.c_str());
+        
+        e->sol = sol.zero_clone().release();
+        for (libMesh::numeric_index_type i=first; i<last; i++)
+            e->sol->set(i, vals[i-first]);
+        e->sol->close();
+    }
+    
+    sol = *e->sol;
+    sol.close();
+    
+    _entries.splice(_entries.begin(), _entries, e);
+    
+    this->_evict();
+}
+
+
+
+void
+MAST::FluidBaseSolutionCache::_evict() {
+    
+    unsigned int
+    n = 0;
+    
+    std::list<Entry>::iterator
+    it  = _entries.begin(),
+    end = _entries.end();
+    
+    for ( ; it != end; ) {
+        
+        if (!it->sol) {
+            it++;
+            continue;
+        }
+        
+        n++;
+        
+        if (n <= _max_entries) {
+            it++;
+            continue;
+        }
+        
+        if (_spill_dir.empty()) {
+            
+            delete it->sol;
+            it = _entries.erase(it);
+            continue;
+        }
+        
+        MAST_LOG_SCOPE("spill()", "FluidBaseSolutionCache");
+        
+        // each processor writes its local values
+        const libMesh::numeric_index_type
+        first = it->sol->first_local_index(),
+        last  = it->sol->last_local_index();
+        
+        std::vector<Real>
+        vals(last - first);
+        for (libMesh::numeric_index_type i=first; i<last; i++)
+            vals[i-first] = (*it->sol)(i);
+        
+        const std::string
+        nm = this->_file_name(it->id);
+        
+        std::ofstream out(nm.c_str(), std::ios::out | std::ios::binary);
+        if (!out.good())
+            libmesh_error_msg("Unable to open file: " << nm);
+        
+        const unsigned long long
+        n_vals = vals.size();
+        
+        out.write((const char*)&n_vals, sizeof(unsigned long long));
+        if (n_vals)
+            out.write((const char*)&vals[0], n_vals*sizeof(Real));
+        out.close();
+        
+        delete it->sol;
+        it->sol = nullptr;
+        it++;
+    }
+}
+
@@ -0,0 +1,257 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2017  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef __mast__fluid_base_solution_cache_h__
+#define __mast__fluid_base_solution_cache_h__
+
+// C++ includes
+#include <string>
+#include <vector>
+#include <list>
+#include <map>
+
+
+// MAST includes
+#include "base/mast_data_types.h"
+
+
+// libMesh includes
+#include "libmesh/parallel_object.h"
+#include "libmesh/numeric_vector.h"
+
+
+namespace MAST {
+    
+    // Forward declerations
+    class FlightCondition;
+    
+    
+    /*!
+     *   Least-recently-used cache of the steady fluid base solutions of
+     *   flight conditions. The key of a solution is the Mach number,
+     *   altitude, ambient density and temperature, and the body Euler
+     *   angles of the flight condition, along with a version number provided
+     *   by the user, which is changed when the mesh or the design changes the
+     *   base flow. At most max_entries() solutions are kept in memory. If a
+     *   directory is given with set_spill_directory(), the least recently
+     *   used solution is written to the directory instead of being deleted,
+     *   and is read back when it is requested again. Each processor writes
+     *   its local values, so that a spilled solution can only be read with
+     *   the same partitioning of the vector, which is the case for the same
+     *   version of the mesh.
+     *
+     *   The frequency-domain linearization about a base solution is
+     *   computed by the elements from the base solution, so a cached base
+     *   solution is all that is needed to restore it.
+     */
+    class FluidBaseSolutionCache:
+    public libMesh::ParallelObject {
+        
+    public:
+        
+        FluidBaseSolutionCache(const libMesh::Parallel::Communicator& comm_in,
+                               unsigned int max_entries = 10);
+        
+        virtual ~FluidBaseSolutionCache();
+        
+        
+        /*!
+         *   sets the maximum number of solutions kept in memory, after
+         *   spilling or deleting the least recently used solutions in
+         *   excess of \p n.
+         */
+        void set_max_entries(unsigned int n);
+        
+        
+        /*!
+         *   @returns the maximum number of solutions kept in memory
+         */
+        unsigned int max_entries() const {
+            return _max_entries;
+        }
+        
+        
+        /*!
+         *   sets the directory to which the solutions evicted from memory
+         *   are written. An empty name, which is the default, deletes the
+         *   evicted solutions. The directory must exist.
+         */
+        void set_spill_directory(const std::string& dir);
+        
+        
+        /*!
+         *   relative tolerance on the components of the key for two flight
+         *   conditions to be considered the same. The default is 1.e-10.
+         */
+        Real tol;
+        
+        
+        /*!
+         *   copies to \p sol the base solution of \p flt at \p version if
+         *   available in memory or on disk, and marks it as the most
+         *   recently used. @returns \p false if the solution is not
+         *   available.
+         */
+        bool find(const MAST::FlightCondition& flt,
+                  unsigned int version,
+                  libMesh::NumericVector<Real>& sol);
+        
+        
+        /*!
+         *   copies to \p sol the solution at the same \p version in memory
+         *   or on disk that is nearest to \p flt, which can be used as the
+         *   initial guess for the solution of \p flt. The distance is
+         *   measured over the components of the key relative to those of
+         *   \p flt. @returns \p false if no solution exists at \p version.
+         */
+        bool nearest(const MAST::FlightCondition& flt,
+                     unsigned int version,
+                     libMesh::NumericVector<Real>& sol);
+        
+        
+        /*!
+         *   adds a copy of \p sol as the base solution of \p flt at
+         *   \p version, replacing the solution of the same key if one
+         *   exists.
+         */
+        void add(const MAST::FlightCondition& flt,
+                 unsigned int version,
+                 const libMesh::NumericVector<Real>& sol);
+        
+        
+        /*!
+         *   deletes the solutions in memory and the files of the spilled
+         *   solutions
+         */
+        void clear();
+        
+        
+        /*!
+         *   @returns the number of solutions in memory and on disk
+         */
+        unsigned int n_entries() const {
+            return (unsigned int)(_entries.size());
+        }
+        
+        
+        /*!
+         *   @returns the number of calls to find() that returned a solution
+         *   and the number that did not.
+         */
+        unsigned int n_hits() const {
+            return _n_hits;
+        }
+        
+        unsigned int n_misses() const {
+            return _n_misses;
+        }
+        
+    protected:
+        
+        /*!
+         *   data of a cached solution
+         */
+        struct Entry {
+            
+            Entry(): version(0), sol(nullptr), id(0) { }
+            
+            /*!
+             *   key of the flight condition
+             */
+            std::vector<Real>                 key;
+            
+            unsigned int                      version;
+            
+            /*!
+             *   solution in memory, which is \p nullptr if the solution
+             *   has been written to the file of \p id
+             */
+            libMesh::NumericVector<Real>*     sol;
+            
+            unsigned int                      id;
+        };
+        
+        
+        /*!
+         *   computes the key of \p flt in \p key
+         */
+        void _key(const MAST::FlightCondition& flt,
+                  std::vector<Real>& key) const;
+        
+        
+        /*!
+         *   @returns the distance between the keys \p k0 and \p k1,
+         *   relative to \p k0.
+         */
+        Real _distance(const std::vector<Real>& k0,
+                       const std::vector<Real>& k1) const;
+        
+        
+        /*!
+         *   @returns the name of the file of the local values of entry
+         *   \p id on this processor.
+         */
+        std::string _file_name(unsigned int id) const;
+        
+        
+        /*!
+         *   copies the solution of \p e to \p sol, reading it from its
+         *   file if it has been spilled, and moves \p e to the front of
+         *   the list. The solution is then kept in memory.
+         */
+        void _load(std::list<Entry>::iterator e,
+                   libMesh::NumericVector<Real>& sol);
+        
+        
+        /*!
+         *   spills or deletes the least-recently-used solutions in memory
+         *   in excess of the maximum number of entries
+         */
+        void _evict();
+        
+        
+        /*!
+         *   maximum number of solutions in memory
+         */
+        unsigned int            _max_entries;
+        
+        /*!
+         *   directory of the spilled solutions
+         */
+        std::string             _spill_dir;
+        
+        /*!
+         *   entries, with the most recently used first
+         */
+        std::list<Entry>        _entries;
+        
+        /*!
+         *   id of the next entry, which is used for the file names
+         */
+        unsigned int            _next_id;
+        
+        /*!
+         *   number of hits and misses of find()
+         */
+        unsigned int            _n_hits, _n_misses;
+    };
+}
+
+
+#endif // __mast__fluid_base_solution_cache_h__
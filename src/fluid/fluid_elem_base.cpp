@@ -25,6 +25,7 @@
 #include "fluid/primitive_fluid_solution.h"
 #include "fluid/small_disturbance_primitive_fluid_solution.h"
 #include "fluid/flight_condition.h"
+#include "fluid/fluid_flux_jacobian_batch.h"
 
 // Basic include files
 #include "libmesh/mesh.h"
@@ -738,6 +739,136 @@ calculate_diffusion_flux_jacobian (const unsigned int flux_dim,
 
 
 
+namespace MAST {
+    
+    template <unsigned int Dim>
+    void
+    advection_flux_jacobian_batch(const std::vector<MAST::PrimitiveSolution>& sol,
+                                  const MAST::GasProperty& gas,
+                                  std::vector<RealMatrixX>& mat) {
+        
+        typedef MAST::FluidFluxJacobianBatch<Dim> Batch;
+        
+        Batch batch;
+        batch.reinit(sol, gas);
+        
+        const unsigned int n = (unsigned int)sol.size();
+        mat.resize(Dim);
+        
+        // the kernels write directly to the storage of mat
+        for (unsigned int i=0; i<Dim; i++) {
+            
+            mat[i].resize(n, Batch::N1*Batch::N1);
+            typename Batch::BatchMatrix m(mat[i].data(), n, Batch::N1*Batch::N1);
+            batch.advection_flux_jacobian(i, m);
+        }
+    }
+    
+    
+    template <unsigned int Dim>
+    void
+    diffusion_flux_jacobian_batch(const std::vector<MAST::PrimitiveSolution>& sol,
+                                  const MAST::GasProperty& gas,
+                                  std::vector<RealMatrixX>& mat) {
+        
+        typedef MAST::FluidFluxJacobianBatch<Dim> Batch;
+        
+        Batch batch;
+        batch.reinit(sol, gas);
+        
+        const unsigned int n = (unsigned int)sol.size();
+        mat.resize(Dim*Dim);
+        
+        for (unsigned int i=0; i<Dim; i++)
+            for (unsigned int j=0; j<Dim; j++) {
+                
+                mat[i*Dim+j].resize(n, Batch::N1*Batch::N1);
+                typename Batch::BatchMatrix m(mat[i*Dim+j].data(), n, Batch::N1*Batch::N1);
+                batch.diffusion_flux_jacobian(i, j, m);
+            }
+    }
+}
+
+
+
+void
+MAST::FluidElemBase::
+calculate_advection_flux_jacobian(const std::vector<MAST::PrimitiveSolution>& sol,
+                                  std::vector<RealMatrixX>& mat) {
+    
+    const MAST::GasProperty& gas = flight_condition->gas_property;
+    
+    switch (dim) {
+            
+        case 1:
+            MAST::advection_flux_jacobian_batch<1>(sol, gas, mat);
+            break;
+            
+        case 2:
+            MAST::advection_flux_jacobian_batch<2>(sol, gas, mat);
+            break;
+            
+        case 3:
+            MAST::advection_flux_jacobian_batch<3>(sol, gas, mat);
+            break;
+            
+        default:
+            libmesh_error_msg("Error: invalid dim " << dim);
+            break;
+    }
+}
+
+
+
+void
+MAST::FluidElemBase::
+calculate_diffusion_flux_jacobian(const std::vector<MAST::PrimitiveSolution>& sol,
+                                  std::vector<RealMatrixX>& mat) {
+    
+    const MAST::GasProperty& gas = flight_condition->gas_property;
+    
+    switch (dim) {
+            
+        case 1:
+            MAST::diffusion_flux_jacobian_batch<1>(sol, gas, mat);
+            break;
+            
+        case 2:
+            MAST::diffusion_flux_jacobian_batch<2>(sol, gas, mat);
+            break;
+            
+        case 3:
+            MAST::diffusion_flux_jacobian_batch<3>(sol, gas, mat);
+            break;
+            
+        default:
+            libmesh_error_msg("Error: invalid dim " << dim);
+            break;
+    }
+}
+
+
+
+MAST::FluidElemBase::FluxJacobianView
+MAST::FluidElemBase::flux_jacobian(const RealMatrixX& batch,
+                                   const unsigned int qp) const {
+    
+    const unsigned int
+    n1 = dim+2,
+    n  = (unsigned int)batch.rows();
+    
+    libmesh_assert_equal_to(batch.cols(), n1*n1);
+    libmesh_assert_less(qp, n);
+    
+    return FluxJacobianView(batch.data()+qp,
+                            n1,
+                            n1,
+                            Eigen::Stride<Eigen::Dynamic, Eigen::Dynamic>(n1*n, n));
+}
+
+
+
+
 void
 MAST::FluidElemBase::
 calculate_advection_flux_jacobian_sensitivity_for_conservative_variable
@@ -23,6 +23,7 @@
 // C++ includes
 #include <ostream>
 #include <map>
+#include <vector>
 
 // MAST includes
 #include "base/mast_data_types.h"
@@ -198,6 +199,44 @@ namespace MAST {
                                                const MAST::PrimitiveSolution& sol,
                                                RealMatrixX& mat);
         
+        /*!
+         *   calculates the advection flux Jacobians for all primitive
+         *   solutions in \p sol with the fixed size kernels of
+         *   MAST::FluidFluxJacobianBatch. \p mat[i] stores the Jacobians
+         *   in the i^th direction for all points, and flux_jacobian()
+         *   returns the Jacobian of a point.
+         */
+        void
+        calculate_advection_flux_jacobian(const std::vector<MAST::PrimitiveSolution>& sol,
+                                          std::vector<RealMatrixX>& mat);
+        
+        /*!
+         *   calculates the diffusion flux Jacobians for all primitive
+         *   solutions in \p sol with the fixed size kernels of
+         *   MAST::FluidFluxJacobianBatch. \p mat[i*dim+j] stores the
+         *   Jacobians K_ij for all points, and flux_jacobian() returns the
+         *   Jacobian of a point.
+         */
+        void
+        calculate_diffusion_flux_jacobian(const std::vector<MAST::PrimitiveSolution>& sol,
+                                          std::vector<RealMatrixX>& mat);
+        
+        /*!
+         *   view of the Jacobian of one point in the storage of the
+         *   batched flux Jacobians
+         */
+        typedef Eigen::Map<const RealMatrixX, 0, Eigen::Stride<Eigen::Dynamic, Eigen::Dynamic> >
+        FluxJacobianView;
+        
+        /*!
+         *   @returns a view of the Jacobian of point \p qp in \p batch,
+         *   which is computed by the batched versions of
+         *   calculate_advection_flux_jacobian() and
+         *   calculate_diffusion_flux_jacobian(). The Jacobian is not copied.
+         */
+        FluxJacobianView flux_jacobian(const RealMatrixX& batch,
+                                       const unsigned int qp) const;
+        
         void calculate_advection_flux_jacobian_sensitivity_for_conservative_variable
         (const unsigned int calculate_dim,
          const MAST::PrimitiveSolution& sol,
@@ -0,0 +1,179 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2017  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+// C++ includes
+#include <cmath>
+
+
+// MAST includes
+#include "fluid/fluid_error_indicator.h"
+#include "fluid/flight_condition.h"
+#include "base/system_initialization.h"
+#include "base/nonlinear_system.h"
+#include "base/performance_log.h"
+
+
+// libMesh includes
+#include "libmesh/fe_base.h"
+#include "libmesh/quadrature.h"
+#include "libmesh/dof_map.h"
+#include "libmesh/elem.h"
+#include "libmesh/numeric_vector.h"
+
+
+MAST::FluidErrorIndicator::
+FluidErrorIndicator(MAST::SystemInitialization& sys,
+                    const MAST::FlightCondition& flt,
+                    MAST::FluidErrorIndicator::IndicatorType t):
+MAST::ErrorIndicatorBase(),
+_system(sys),
+_flight_condition(flt),
+_type(t) {
+    
+}
+
+
+
+MAST::FluidErrorIndicator::~FluidErrorIndicator() {
+    
+}
+
+
+
+void
+MAST::FluidErrorIndicator::estimate_error(libMesh::ErrorVector& err) {
+    
+    MAST_LOG_SCOPE("estimate_error()", "FluidErrorIndicator");
+    
+    MAST::NonlinearSystem& sys = _system.system();
+    const libMesh::MeshBase& mesh = sys.get_mesh();
+    const libMesh::DofMap& dof_map = sys.get_dof_map();
+    
+    const unsigned int
+    dim = mesh.mesh_dimension(),
+    n1  = dim+2;
+    
+    libmesh_assert_equal_to(_system.n_vars(), n1);
+    
+    err.assign(mesh.max_elem_id(), 0.);
+    
+    const Real
+    gamma = _flight_condition.gas_property.gamma,
+    s_inf = _flight_condition.gas_property.pressure /
+    pow(_flight_condition.gas_property.rho, gamma);
+    
+    std::auto_ptr<libMesh::FEBase>
+    fe(libMesh::FEBase::build(dim, _system.fetype(0)).release());
+    std::auto_ptr<libMesh::QBase>
+    qrule(_system.fetype(0).default_quadrature_rule(dim, sys.extra_quadrature_order).release());
+    fe->attach_quadrature_rule(qrule.get());
+    
+    const std::vector<Real>& JxW                          = fe->get_JxW();
+    const std::vector<std::vector<Real> >& phi            = fe->get_phi();
+    const std::vector<std::vector<libMesh::RealGradient> >& dphi = fe->get_dphi();
+    
+    std::vector<libMesh::dof_id_type> dof_indices;
+    
+    RealVectorX
+    u    = RealVectorX::Zero(n1),
+    dp   = RealVectorX::Zero(dim);
+    
+    RealMatrixX
+    du   = RealMatrixX::Zero(n1, dim);
+    
+    libMesh::MeshBase::const_element_iterator
+    e_it   = mesh.active_local_elements_begin(),
+    e_end  = mesh.active_local_elements_end();
+    
+    for ( ; e_it != e_end; e_it++) {
+        
+        const libMesh::Elem* e = *e_it;
+        
+        fe->reinit(e);
+        dof_map.dof_indices(e, dof_indices);
+        
+        const unsigned int
+        nphi = (unsigned int)phi.size();
+        
+        libmesh_assert_equal_to(dof_indices.size(), nphi*n1);
+        
+        Real
+        eta = 0.;
+        
+        for (unsigned int qp=0; qp<JxW.size(); qp++) {
+            
+            // conservative variables and their gradients
+            u.setZero();
+            du.setZero();
+            
+            for (unsigned int i_var=0; i_var<n1; i_var++)
+                for (unsigned int i_phi=0; i_phi<nphi; i_phi++) {
+                    
+                    const Real
+                    v = (*sys.current_local_solution)(dof_indices[i_var*nphi+i_phi]);
+                    
+                    u(i_var) += phi[i_phi][qp] * v;
+                    for (unsigned int i_dim=0; i_dim<dim; i_dim++)
+                        du(i_var, i_dim) += dphi[i_phi][qp](i_dim) * v;
+                }
+            
+            const Real
+            rho = u(0);
+            
+            Real
+            q2  = 0.;
+            for (unsigned int i_dim=0; i_dim<dim; i_dim++)
+                q2 += pow(u(i_dim+1)/rho, 2);
+            
+            const Real
+            p = (gamma-1.) * (u(n1-1) - 0.5 * rho * q2);
+            
+            switch (_type) {
+                    
+                case SHOCK: {
+                    
+                    // dp = (gamma-1) (d(rho e) - u_i d(rho u_i) + q^2/2 d(rho))
+                    dp = du.row(n1-1).transpose() + 0.5 * q2 * du.row(0).transpose();
+                    for (unsigned int i_dim=0; i_dim<dim; i_dim++)
+                        dp -= u(i_dim+1)/rho * du.row(i_dim+1).transpose();
+                    dp *= (gamma-1.);
+                    
+                    eta += JxW[qp] * dp.squaredNorm() / p / p;
+                }
+                    break;
+                    
+                case ENTROPY:
+                    eta += JxW[qp] * pow((p / pow(rho, gamma) - s_inf) / s_inf, 2);
+                    break;
+                    
+                default:
+                    libmesh_error();
+            }
+        }
+        
+        if (_type == SHOCK)
+            eta *= pow(e->hmax(), 2);
+        
+        err[e->id()] = sqrt(eta);
+    }
+    
+    mesh.comm().sum(static_cast<std::vector<libMesh::ErrorVectorReal>&>(err));
+}
+
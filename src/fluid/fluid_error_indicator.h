@@ -0,0 +1,97 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2017  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+#ifndef __mast__fluid_error_indicator__
+#define __mast__fluid_error_indicator__
+
+
+// MAST includes
+#include "mesh/error_indicator_base.h"
+
+
+namespace MAST {
+    
+    // Forward declerations
+    class SystemInitialization;
+    class FlightCondition;
+    
+    
+    /*!
+     *   Error indicators for the conservative fluid variables of a system,
+     *   which resolve the regions of the flow with large gradients.
+     *   With \p SHOCK, the error of an element is
+     *   \f[ \eta_e = h_e \left( \int_e \frac{|\nabla p|^2}{p^2} dV
+     *      \right)^{1/2} , \f]
+     *   the scaled pressure gradient over the element, which is largest
+     *   at shocks and expansions. With \p ENTROPY, the error is
+     *   \f[ \eta_e = \left( \int_e \left(\frac{s - s_\infty}{s_\infty}
+     *      \right)^2 dV \right)^{1/2} , \f]
+     *   with \f$ s = p / \rho^\gamma \f$. This is zero in isentropic flow,
+     *   and is large downstream of shocks and in the numerical entropy
+     *   production of unresolved regions. The far-field values are taken
+     *   from the flight condition. The variables of the system are the
+     *   density, the momentum components and the total energy per unit
+     *   volume, as in MAST::ConservativeFluidSystemInitialization.
+     */
+    class FluidErrorIndicator:
+    public MAST::ErrorIndicatorBase {
+        
+    public:
+        
+        enum IndicatorType {
+            SHOCK,
+            ENTROPY
+        };
+        
+        
+        FluidErrorIndicator(MAST::SystemInitialization& sys,
+                            const MAST::FlightCondition& flt,
+                            MAST::FluidErrorIndicator::IndicatorType t = SHOCK);
+        
+        virtual ~FluidErrorIndicator();
+        
+        
+        /*!
+         *   computes the error of the active elements from the current
+         *   solution of the system
+         */
+        virtual void estimate_error(libMesh::ErrorVector& err);
+        
+    protected:
+        
+        /*!
+         *   system with the fluid variables
+         */
+        MAST::SystemInitialization&                 _system;
+        
+        /*!
+         *   far-field condition and gas properties
+         */
+        const MAST::FlightCondition&                _flight_condition;
+        
+        /*!
+         *   indicator type
+         */
+        MAST::FluidErrorIndicator::IndicatorType    _type;
+    };
+}
+
+
+#endif // __mast__fluid_error_indicator__
@@ -0,0 +1,482 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2017  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef __mast__fluid_flux_jacobian_batch_h__
+#define __mast__fluid_flux_jacobian_batch_h__
+
+// C++ includes
+#include <vector>
+
+
+// MAST includes
+#include "base/mast_data_types.h"
+#include "fluid/primitive_fluid_solution.h"
+#include "fluid/gas_property.h"
+
+
+namespace MAST {
+    
+    /*!
+     *   Evaluates the advection and diffusion flux Jacobians of
+     *   \p FluidElemBase for a batch of quadrature points. The primitive
+     *   variables of all points are stored in structure-of-arrays layout,
+     *   and each entry of the \f$ (Dim+2) \times (Dim+2) \f$ Jacobian is
+     *   evaluated for all points with a single Eigen array expression, so
+     *   that the kernels vectorize over the points. The Jacobians are
+     *   written to a \p BatchMatrix, which maps storage of the caller
+     *   with one row per point. Column \f$ i + j (Dim+2) \f$ stores entry
+     *   \f$ (i,j) \f$ for all points, so that the Jacobian of a point
+     *   can be viewed in place with a strided map.
+     */
+    template <unsigned int Dim>
+    class FluidFluxJacobianBatch {
+        
+    public:
+        
+        /*!
+         *   number of conservative variables
+         */
+        static const unsigned int N1 = Dim+2;
+        
+        typedef Eigen::Matrix<Real, Dim+2, Dim+2>                      MatrixType;
+        
+        typedef Eigen::Map<Eigen::Array<Real, Eigen::Dynamic, (Dim+2)*(Dim+2)> >
+        BatchMatrix;
+        
+        
+        FluidFluxJacobianBatch():
+        _R     (0.),
+        _cv    (0.),
+        _gamma (0.)
+        { }
+        
+        
+        /*!
+         *   initializes the batch from the primitive solutions in \p sol
+         *   and the gas properties in \p gas
+         */
+        void reinit(const std::vector<MAST::PrimitiveSolution>& sol,
+                    const MAST::GasProperty& gas);
+        
+        
+        /*!
+         *   @returns the number of points in this batch
+         */
+        unsigned int n_batch() const {return (unsigned int)_u1.size();}
+        
+        
+        /*!
+         *   advection flux Jacobian d F_adv_i / dU for all points, with
+         *   i = \p calculate_dim. \p mat must have n_batch() rows.
+         */
+        void advection_flux_jacobian(const unsigned int calculate_dim,
+                                     BatchMatrix& mat) const;
+        
+        
+        /*!
+         *   diffusion flux Jacobian K_ij for all points, with
+         *   i = \p flux_dim and j = \p deriv_dim. \p mat must have
+         *   n_batch() rows.
+         */
+        void diffusion_flux_jacobian(const unsigned int flux_dim,
+                                     const unsigned int deriv_dim,
+                                     BatchMatrix& mat) const;
+        
+        
+    protected:
+        
+        /*!
+         *   @returns the column of \p mat that stores entry (i,j) for all
+         *   points
+         */
+        static typename BatchMatrix::ColXpr
+        _entry(BatchMatrix& mat, const unsigned int i, const unsigned int j) {
+            
+            return mat.col(j*N1+i);
+        }
+        
+        /*!
+         *   primitive variables at the points
+         */
+        Eigen::Array<Real, Eigen::Dynamic, 1>
+        _rho, _u1, _u2, _u3, _k, _e_tot, _T, _mu, _lambda, _kth;
+        
+        /*!
+         *   gas properties
+         */
+        Real _R, _cv, _gamma;
+    };
+}
+
+
+
+template <unsigned int Dim>
+inline
+void
+MAST::FluidFluxJacobianBatch<Dim>::
+reinit(const std::vector<MAST::PrimitiveSolution>& sol,
+       const MAST::GasProperty& gas) {
+    
+    const unsigned int n = (unsigned int)sol.size();
+    
+    _rho.resize(n);    _u1.resize(n);     _u2.resize(n);  _u3.resize(n);
+    _k.resize(n);      _e_tot.resize(n);  _T.resize(n);
+    _mu.resize(n);     _lambda.resize(n); _kth.resize(n);
+    
+    for (unsigned int q=0; q<n; q++) {
+        
+        _rho(q)    = sol[q].rho;
+        _u1(q)     = sol[q].u1;
+        _u2(q)     = sol[q].u2;
+        _u3(q)     = sol[q].u3;
+        _k(q)      = sol[q].k;
+        _e_tot(q)  = sol[q].e_tot;
+        _T(q)      = sol[q].T;
+        _mu(q)     = sol[q].mu;
+        _lambda(q) = sol[q].lambda;
+        _kth(q)    = sol[q].k_thermal;
+    }
+    
+    _R     = gas.R;
+    _cv    = gas.cv;
+    _gamma = gas.gamma;
+}
+
+
+
+template <unsigned int Dim>
+inline
+void
+MAST::FluidFluxJacobianBatch<Dim>::
+advection_flux_jacobian(const unsigned int calculate_dim,
+                        BatchMatrix& mat) const {
+    
+    // see FluidElemBase::calculate_advection_flux_jacobian() for the
+    // single point version of these expressions. The direction is
+    // checked here, since the entries of a higher dimension are outside
+    // the storage of this batch.
+    if (calculate_dim >= Dim)
+        libmesh_error_msg("Error: invalid dim " << calculate_dim
+                          << " for advection flux Jacobian of dimension " << Dim);
+    
+    const unsigned int
+    n1 = N1;
+    
+    libmesh_assert_equal_to(mat.rows(), n_batch());
+    mat.setZero();
+    
+    const Real
+    R     = _R,
+    cv    = _cv,
+    gamma = _gamma,
+    rcv   = _R/_cv;
+    
+    switch (calculate_dim)
+    {
+        case 0:
+        {
+            if (Dim > 2) {
+                
+                _entry(mat,    1,    3) = -_u3*rcv;
+                
+                _entry(mat,    3,    0) = -_u1*_u3;
+                _entry(mat,    3,    1) =  _u3;
+                _entry(mat,    3,    3) =  _u1;
+                
+                _entry(mat, n1-1,    3) = -_u1*_u3*rcv;
+            }
+            
+            if (Dim > 1) {
+                
+                _entry(mat,    1,    2) = -_u2*rcv;
+                
+                _entry(mat,    2,    0) = -_u1*_u2;
+                _entry(mat,    2,    1) =  _u2;
+                _entry(mat,    2,    2) =  _u1;
+                
+                _entry(mat, n1-1,    2) = -_u1*_u2*rcv;
+            }
+            
+            _entry(mat,    0,    1)     = 1.0; // d U / d (rho u1)
+            
+            _entry(mat,    1,    0)     = -_u1*_u1+rcv*_k;
+            _entry(mat,    1,    1)     = _u1*(2.0-rcv);
+            _entry(mat,    1, n1-1)     = rcv;
+            
+            _entry(mat, n1-1,    0)     = _u1*(R*(-_e_tot+2.0*_k)-_e_tot*cv)/cv;
+            _entry(mat, n1-1,    1)     = _e_tot+R*(_T-_u1*_u1/cv);
+            _entry(mat, n1-1, n1-1)     = _u1*gamma;
+        }
+            break;
+            
+        case 1:
+        {
+            if (Dim > 2) {
+                
+                _entry(mat,    2,    3) = -_u3*rcv;
+                
+                _entry(mat,    3,    0) = -_u2*_u3;
+                _entry(mat,    3,    2) =  _u3;
+                _entry(mat,    3,    3) =  _u2;
+                
+                _entry(mat, n1-1,    3) = -_u2*_u3*rcv;
+            }
+            
+            _entry(mat,    0,    2)     = 1.0; // d U / d (rho u2)
+            
+            _entry(mat,    1,    0)     = -_u1*_u2;
+            _entry(mat,    1,    1)     =  _u2;
+            _entry(mat,    1,    2)     =  _u1;
+            
+            _entry(mat,    2,    0)     = -_u2*_u2+rcv*_k;
+            _entry(mat,    2,    1)     = -_u1*rcv;
+            _entry(mat,    2,    2)     = _u2*(2.0-rcv);
+            _entry(mat,    2, n1-1)     = rcv;
+            
+            _entry(mat, n1-1,    0)     = _u2*(R*(-_e_tot+2.0*_k)-_e_tot*cv)/cv;
+            _entry(mat, n1-1,    1)     = -_u1*_u2*rcv;
+            _entry(mat, n1-1,    2)     = _e_tot+R*(_T-_u2*_u2/cv);
+            _entry(mat, n1-1, n1-1)     = _u2*gamma;
+        }
+            break;
+            
+        case 2:
+        {
+            _entry(mat,    0,    3)     = 1.0; // d U / d (rho u3)
+            
+            _entry(mat,    1,    0)     = -_u1*_u3;
+            _entry(mat,    1,    1)     =  _u3;
+            _entry(mat,    1,    3)     =  _u1;
+            
+            _entry(mat,    2,    0)     = -_u2*_u3;
+            _entry(mat,    2,    2)     =  _u3;
+            _entry(mat,    2,    3)     =  _u2;
+            
+            _entry(mat,    3,    0)     = -_u3*_u3+rcv*_k;
+            _entry(mat,    3,    1)     = -_u1*rcv;
+            _entry(mat,    3,    2)     = -_u2*rcv;
+            _entry(mat,    3,    3)     = _u3*(2.0-rcv);
+            _entry(mat,    3, n1-1)     = rcv;
+            
+            _entry(mat, n1-1,    0)     = _u3*(R*(-_e_tot+2.0*_k)-_e_tot*cv)/cv;
+            _entry(mat, n1-1,    1)     = -_u1*_u3*rcv;
+            _entry(mat, n1-1,    2)     = -_u2*_u3*rcv;
+            _entry(mat, n1-1,    3)     = _e_tot+R*(_T-_u3*_u3/cv);
+            _entry(mat, n1-1, n1-1)     = _u3*gamma;
+        }
+            break;
+    }
+}
+
+
+
+template <unsigned int Dim>
+inline
+void
+MAST::FluidFluxJacobianBatch<Dim>::
+diffusion_flux_jacobian(const unsigned int flux_dim,
+                        const unsigned int deriv_dim,
+                        BatchMatrix& mat) const {
+    
+    // see FluidElemBase::calculate_diffusion_flux_jacobian() for the
+    // single point version of these expressions
+    if (flux_dim >= Dim || deriv_dim >= Dim)
+        libmesh_error_msg("Error: invalid dims " << flux_dim << ", " << deriv_dim
+                          << " for diffusion flux Jacobian of dimension " << Dim);
+    
+    const unsigned int
+    n1 = N1;
+    
+    libmesh_assert_equal_to(mat.rows(), n_batch());
+    mat.setZero();
+    
+    const Real cv = _cv;
+    
+    // quantities shared by the entries
+    const Eigen::Array<Real, Eigen::Dynamic, 1>
+    mu_r    = _mu/_rho,
+    lam_r   = _lambda/_rho,
+    lm2_r   = (_lambda+2.*_mu)/_rho,
+    lpm_r   = (_lambda+_mu)/_rho,
+    kmu_r   = (-_kth+cv*_mu)/cv/_rho,
+    klm2_r  = (-_kth+cv*(_lambda+2.*_mu))/cv/_rho;
+    
+    switch (flux_dim*3+deriv_dim)
+    {
+        case 0: // K11
+        {
+            if (Dim > 2) {
+                
+                _entry(mat,    3,    0) = -_u3*mu_r;
+                _entry(mat,    3,    3) =  mu_r;
+                
+                _entry(mat, n1-1,    3) =  _u3*kmu_r;
+            }
+            
+            if (Dim > 1) {
+                
+                _entry(mat,    2,    0) = -_u2*mu_r;
+                _entry(mat,    2,    2) =  mu_r;
+                
+                _entry(mat, n1-1,    2) =  _u2*kmu_r;
+            }
+            
+            _entry(mat,    1,    0)     = -_u1*lm2_r;
+            _entry(mat,    1,    1)     =  lm2_r;
+            
+            _entry(mat, n1-1,    0)     =
+            (_kth*(2.*_k-_e_tot)-cv*(2.*_k*_mu+_u1*_u1*(_mu+_lambda)))/cv/_rho;
+            _entry(mat, n1-1,    1)     =  _u1*klm2_r;
+            _entry(mat, n1-1, n1-1)     =  _kth/cv/_rho;
+        }
+            break;
+            
+        case 1: // K12
+        {
+            _entry(mat,    1,    0)     = -_u2*lam_r;
+            _entry(mat,    1,    2)     =  lam_r;
+            
+            _entry(mat,    2,    0)     = -_u1*mu_r;
+            _entry(mat,    2,    1)     =  mu_r;
+            
+            _entry(mat, n1-1,    0)     = -_u1*_u2*lpm_r;
+            _entry(mat, n1-1,    1)     =  _u2*mu_r;
+            _entry(mat, n1-1,    2)     =  _u1*lam_r;
+        }
+            break;
+            
+        case 2: // K13
+        {
+            _entry(mat,    1,    0)     = -_u3*lam_r;
+            _entry(mat,    1,    3)     =  lam_r;
+            
+            _entry(mat,    3,    0)     = -_u1*mu_r;
+            _entry(mat,    3,    1)     =  mu_r;
+            
+            _entry(mat, n1-1,    0)     = -_u1*_u3*lpm_r;
+            _entry(mat, n1-1,    1)     =  _u3*mu_r;
+            _entry(mat, n1-1,    3)     =  _u1*lam_r;
+        }
+            break;
+            
+        case 3: // K21
+        {
+            _entry(mat,    1,    0)     = -_u2*mu_r;
+            _entry(mat,    1,    2)     =  mu_r;
+            
+            _entry(mat,    2,    0)     = -_u1*lam_r;
+            _entry(mat,    2,    1)     =  lam_r;
+            
+            _entry(mat, n1-1,    0)     = -_u1*_u2*lpm_r;
+            _entry(mat, n1-1,    1)     =  _u2*lam_r;
+            _entry(mat, n1-1,    2)     =  _u1*mu_r;
+        }
+            break;
+            
+        case 4: // K22
+        {
+            if (Dim > 2) {
+                
+                _entry(mat,    3,    0) = -_u3*mu_r;
+                _entry(mat,    3,    3) =  mu_r;
+                
+                _entry(mat, n1-1,    3) =  _u3*kmu_r;
+            }
+            
+            _entry(mat,    1,    0)     = -_u1*mu_r;
+            _entry(mat,    1,    1)     =  mu_r;
+            
+            _entry(mat,    2,    0)     = -_u2*lm2_r;
+            _entry(mat,    2,    2)     =  lm2_r;
+            
+            _entry(mat, n1-1,    0)     =
+            (_kth*(2.*_k-_e_tot)-cv*(2.*_k*_mu+_u2*_u2*(_mu+_lambda)))/cv/_rho;
+            _entry(mat, n1-1,    1)     =  _u1*kmu_r;
+            _entry(mat, n1-1,    2)     =  _u2*klm2_r;
+            _entry(mat, n1-1, n1-1)     =  _kth/cv/_rho;
+        }
+            break;
+            
+        case 5: // K23
+        {
+            _entry(mat,    2,    0)     = -_u3*lam_r;
+            _entry(mat,    2,    3)     =  lam_r;
+            
+            _entry(mat,    3,    0)     = -_u2*mu_r;
+            _entry(mat,    3,    2)     =  mu_r;
+            
+            _entry(mat, n1-1,    0)     = -_u2*_u3*lpm_r;
+            _entry(mat, n1-1,    2)     =  _u3*mu_r;
+            _entry(mat, n1-1,    3)     =  _u2*lam_r;
+        }
+            break;
+            
+        case 6: // K31
+        {
+            _entry(mat,    1,    0)     = -_u3*mu_r;
+            _entry(mat,    1,    3)     =  mu_r;
+            
+            _entry(mat,    3,    0)     = -_u1*lam_r;
+            _entry(mat,    3,    1)     =  lam_r;
+            
+            _entry(mat, n1-1,    0)     = -_u1*_u3*lpm_r;
+            _entry(mat, n1-1,    1)     =  _u3*lam_r;
+            _entry(mat, n1-1,    3)     =  _u1*mu_r;
+        }
+            break;
+            
+        case 7: // K32
+        {
+            _entry(mat,    2,    0)     = -_u3*mu_r;
+            _entry(mat,    2,    3)     =  mu_r;
+            
+            _entry(mat,    3,    0)     = -_u2*lam_r;
+            _entry(mat,    3,    2)     =  lam_r;
+            
+            _entry(mat, n1-1,    0)     = -_u2*_u3*lpm_r;
+            _entry(mat, n1-1,    2)     =  _u3*lam_r;
+            _entry(mat, n1-1,    3)     =  _u2*mu_r;
+        }
+            break;
+            
+        case 8: // K33
+        {
+            _entry(mat,    1,    0)     = -_u1*mu_r;
+            _entry(mat,    1,    1)     =  mu_r;
+            
+            _entry(mat,    2,    0)     = -_u2*mu_r;
+            _entry(mat,    2,    2)     =  mu_r;
+            
+            _entry(mat,    3,    0)     = -_u3*lm2_r;
+            _entry(mat,    3,    3)     =  lm2_r;
+            
+            _entry(mat, n1-1,    0)     =
+            (_kth*(2.*_k-_e_tot)-cv*(2.*_k*_mu+_u3*_u3*(_mu+_lambda)))/cv/_rho;
+            _entry(mat, n1-1,    1)     =  _u1*kmu_r;
+            _entry(mat, n1-1,    2)     =  _u2*kmu_r;
+            _entry(mat, n1-1,    3)     =  _u3*klm2_r;
+            _entry(mat, n1-1, n1-1)     =  _kth/cv/_rho;
+        }
+            break;
+    }
+}
+
+
+
+#endif // __mast__fluid_flux_jacobian_batch_h__
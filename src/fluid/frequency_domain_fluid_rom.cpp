@@ -0,0 +1,415 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2017  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+// C++ includes
+#include <cmath>
+#include <algorithm>
+#include <limits>
+
+
+// MAST includes
+#include "fluid/frequency_domain_fluid_rom.h"
+#include "solver/complex_solver_base.h"
+#include "base/complex_assembly_base.h"
+#include "base/nonlinear_system.h"
+#include "aeroelasticity/frequency_function.h"
+#include "base/performance_log.h"
+
+
+// libMesh includes
+#include "libmesh/petsc_matrix.h"
+#include "libmesh/petsc_vector.h"
+
+
+MAST::FrequencyDomainFluidROM::
+FrequencyDomainFluidROM(MAST::ComplexSolverBase& solver,
+                        MAST::FrequencyFunction& freq):
+projection(MAST::FrequencyDomainFluidROM::LEAST_SQUARES),
+energy_tol(1.e-8),
+max_basis_size(0),
+_solver(solver),
+_freq(freq) {
+    
+}
+
+
+
+MAST::FrequencyDomainFluidROM::~FrequencyDomainFluidROM() {
+    
+    this->clear();
+}
+
+
+
+void
+MAST::FrequencyDomainFluidROM::
+add_snapshot(const libMesh::NumericVector<Real>& sol_R,
+             const libMesh::NumericVector<Real>& sol_I) {
+    
+    _snapshots_R.push_back(sol_R.clone().release());
+    _snapshots_I.push_back(sol_I.clone().release());
+}
+
+
+
+void
+MAST::FrequencyDomainFluidROM::clear() {
+    
+    for (unsigned int i=0; i<_snapshots_R.size(); i++) {
+        delete _snapshots_R[i];
+        delete _snapshots_I[i];
+    }
+    
+    _snapshots_R.clear();
+    _snapshots_I.clear();
+    
+    this->_clear_basis();
+}
+
+
+
+void
+MAST::FrequencyDomainFluidROM::build_basis() {
+    
+    MAST_LOG_SCOPE("build_basis()", "FrequencyDomainFluidROM");
+    
+    libmesh_assert(_snapshots_R.size());
+    
+    this->_clear_basis();
+    
+    // the real and imaginary parts are separate snapshots of the real basis
+    std::vector<libMesh::NumericVector<Real>*>
+    s(_snapshots_R);
+    s.insert(s.end(), _snapshots_I.begin(), _snapshots_I.end());
+    
+    const unsigned int
+    ns = (unsigned int)s.size();
+    
+    // method of snapshots with the correlation matrix
+    RealMatrixX
+    C = RealMatrixX::Zero(ns, ns);
+    
+    for (unsigned int i=0; i<ns; i++)
+        for (unsigned int j=i; j<ns; j++) {
+            C(i,j) = s[i]->dot(*s[j]);
+            C(j,i) = C(i,j);
+        }
+    
+    Eigen::SelfAdjointEigenSolver<RealMatrixX> eig(C);
+    
+    const RealVectorX
+    &sigma = eig.eigenvalues();
+    
+    const Real
+    total  = sigma.cwiseMax(0.).sum();
+    
+    if (total <= 0.)
+        return;
+    
+    // the eigenvalues are in ascending order
+    Real
+    retained = 0.;
+    
+    std::vector<Real> energy;
+    
+    for (int k=(int)ns-1; k>=0; k--) {
+        
+        if (sigma(k) <= ns * std::numeric_limits<Real>::epsilon() * sigma(ns-1) ||
+            (max_basis_size && _basis.size() == max_basis_size) ||
+            retained >= (1.-energy_tol) * total)
+            break;
+        
+        libMesh::NumericVector<Real>*
+        phi = s[0]->zero_clone().release();
+        
+        for (unsigned int i=0; i<ns; i++)
+            phi->add(eig.eigenvectors()(i,k)/std::sqrt(sigma(k)), *s[i]);
+        phi->close();
+        
+        _basis.push_back(phi);
+        energy.push_back(sigma(k)/total);
+        retained += sigma(k);
+    }
+    
+    _energy.resize(energy.size());
+    for (unsigned int k=0; k<energy.size(); k++)
+        _energy(k) = energy[k];
+    
+    libMesh::out
+    << "POD basis with " << _basis.size() << " modes from "
+    << ns << " snapshots, retained energy fraction: "
+    << retained/total << std::endl;
+    
+    this->_build_operators();
+}
+
+
+
+Real
+MAST::FrequencyDomainFluidROM::solve(libMesh::NumericVector<Real>& sol_R,
+                                     libMesh::NumericVector<Real>& sol_I) {
+    
+    MAST_LOG_SCOPE("solve()", "FrequencyDomainFluidROM");
+    
+    libmesh_assert(_basis.size());
+    
+    MAST::ComplexAssemblyBase& assembly = _solver.get_assembly();
+    
+    MAST::NonlinearSystem& sys =
+    dynamic_cast<MAST::NonlinearSystem&>(assembly.system());
+    
+    PetscErrorCode   ierr;
+    Vec              r0_vec, r1_vec, x_vec;
+    
+    ierr = VecDuplicate(_W[0], &r0_vec);       CHKERRABORT(sys.comm().get(), ierr);
+    ierr = VecDuplicate(_W[0], &r1_vec);       CHKERRABORT(sys.comm().get(), ierr);
+    ierr = VecDuplicate(_W[0], &x_vec);        CHKERRABORT(sys.comm().get(), ierr);
+    
+    // only the two residual terms are assembled for the current boundary
+    // conditions
+    {
+        libMesh::PetscVector<Real>
+        r0(r0_vec, sys.comm()),
+        r1(r1_vec, sys.comm()),
+        x (x_vec,  sys.comm());
+        
+        x.zero();
+        x.close();
+        
+        assembly.set_frequency_operator(MAST::FREQUENCY_INDEPENDENT_OPERATOR);
+        assembly.residual_and_jacobian_blocked(x, r0, nullptr, sys);
+        
+        assembly.set_frequency_operator(MAST::FREQUENCY_COEFFICIENT_OPERATOR);
+        assembly.residual_and_jacobian_blocked(x, r1, nullptr, sys);
+        
+        assembly.set_frequency_operator(MAST::FULL_FREQUENCY_OPERATOR);
+    }
+    
+    Real
+    omega = 0.;
+    _freq(omega);
+    
+    const unsigned int
+    n = (unsigned int)_W.size();
+    
+    // projections of the residual terms
+    RealVectorX
+    p00 = RealVectorX::Zero(n),
+    p01 = RealVectorX::Zero(n),
+    p10 = RealVectorX::Zero(n),
+    p11 = RealVectorX::Zero(n),
+    q0  = RealVectorX::Zero(n),
+    q1  = RealVectorX::Zero(n);
+    
+    ierr = VecMDot(r0_vec, n, &_A0W[0], p00.data());   CHKERRABORT(sys.comm().get(), ierr);
+    ierr = VecMDot(r1_vec, n, &_A0W[0], p01.data());   CHKERRABORT(sys.comm().get(), ierr);
+    ierr = VecMDot(r0_vec, n, &_A1W[0], p10.data());   CHKERRABORT(sys.comm().get(), ierr);
+    ierr = VecMDot(r1_vec, n, &_A1W[0], p11.data());   CHKERRABORT(sys.comm().get(), ierr);
+    ierr = VecMDot(r0_vec, n, &_W[0],   q0.data());    CHKERRABORT(sys.comm().get(), ierr);
+    ierr = VecMDot(r1_vec, n, &_W[0],   q1.data());    CHKERRABORT(sys.comm().get(), ierr);
+    
+    PetscScalar
+    rr00 = 0., rr01 = 0., rr11 = 0.;
+    
+    ierr = VecDot(r0_vec, r0_vec, &rr00);              CHKERRABORT(sys.comm().get(), ierr);
+    ierr = VecDot(r0_vec, r1_vec, &rr01);              CHKERRABORT(sys.comm().get(), ierr);
+    ierr = VecDot(r1_vec, r1_vec, &rr11);              CHKERRABORT(sys.comm().get(), ierr);
+    
+    ierr = VecDestroy(&r0_vec);                        CHKERRABORT(sys.comm().get(), ierr);
+    ierr = VecDestroy(&r1_vec);                        CHKERRABORT(sys.comm().get(), ierr);
+    ierr = VecDestroy(&x_vec);                         CHKERRABORT(sys.comm().get(), ierr);
+    
+    // least-squares normal equations at this frequency
+    const RealMatrixX
+    G   = _G00 + omega * (_G01 + _G01.transpose()) + omega * omega * _G11;
+    const RealVectorX
+    f   = p00 + omega * (p01 + p10) + omega * omega * p11;
+    RealVectorX
+    c;
+    
+    switch (projection) {
+            
+        case LEAST_SQUARES:
+            c = G.ldlt().solve(f);
+            break;
+            
+        case GALERKIN:
+            c = (_H0 + omega * _H1).partialPivLu().solve(q0 + omega * q1);
+            break;
+            
+        default:
+            libmesh_error();
+    }
+    
+    // relative residual || r - A W c || / || r ||
+    const Real
+    rr   = rr00 + 2. * omega * rr01 + omega * omega * rr11,
+    res2 = rr - 2. * c.dot(f) + c.dot(G * c);
+    
+    // the full-order solution
+    sol_R.zero();
+    sol_I.zero();
+    
+    for (unsigned int k=0; k<_basis.size(); k++) {
+        
+        sol_R.add(c(2*k),   *_basis[k]);
+        sol_I.add(c(2*k+1), *_basis[k]);
+    }
+    
+    sol_R.close();
+    sol_I.close();
+    
+    return rr > 0.? std::sqrt(std::max(res2, 0.)/rr): 0.;
+}
+
+
+
+void
+MAST::FrequencyDomainFluidROM::_build_operators() {
+    
+    MAST_LOG_SCOPE("build_operators()", "FrequencyDomainFluidROM");
+    
+    MAST::ComplexAssemblyBase& assembly = _solver.get_assembly();
+    
+    MAST::NonlinearSystem& sys =
+    dynamic_cast<MAST::NonlinearSystem&>(assembly.system());
+    
+    PetscErrorCode   ierr;
+    Mat              mat0, mat1;
+    Vec              res_vec, sol_vec;
+    
+    _solver._create_block_matrix(mat0);
+    _solver._create_block_matrix(mat1);
+    
+    ierr = MatCreateVecs(mat0, &res_vec, PETSC_NULL);   CHKERRABORT(sys.comm().get(), ierr);
+    ierr = MatCreateVecs(mat0, &sol_vec, PETSC_NULL);   CHKERRABORT(sys.comm().get(), ierr);
+    
+    {
+        std::auto_ptr<libMesh::SparseMatrix<Real> >
+        jac0(new libMesh::PetscMatrix<Real>(mat0, sys.comm())),
+        jac1(new libMesh::PetscMatrix<Real>(mat1, sys.comm()));
+        
+        libMesh::PetscVector<Real>
+        res(res_vec, sys.comm()),
+        sol(sol_vec, sys.comm());
+        
+        sol.zero();
+        sol.close();
+        
+        assembly.set_frequency_operator(MAST::FREQUENCY_INDEPENDENT_OPERATOR);
+        assembly.residual_and_jacobian_blocked(sol, res, jac0.get(), sys);
+        
+        assembly.set_frequency_operator(MAST::FREQUENCY_COEFFICIENT_OPERATOR);
+        assembly.residual_and_jacobian_blocked(sol, res, jac1.get(), sys);
+        
+        assembly.set_frequency_operator(MAST::FULL_FREQUENCY_OPERATOR);
+    }
+    
+    const unsigned int
+    n = 2*(unsigned int)_basis.size();
+    
+    _W.resize(n);
+    _A0W.resize(n);
+    _A1W.resize(n);
+    
+    for (unsigned int k=0; k<_basis.size(); k++) {
+        
+        const libMesh::NumericVector<Real>& phi = *_basis[k];
+        
+        for (unsigned int j=0; j<2; j++) {
+            
+            Vec& w = _W[2*k+j];
+            
+            ierr = VecDuplicate(sol_vec, &w);           CHKERRABORT(sys.comm().get(), ierr);
+            ierr = VecDuplicate(sol_vec, &_A0W[2*k+j]); CHKERRABORT(sys.comm().get(), ierr);
+            ierr = VecDuplicate(sol_vec, &_A1W[2*k+j]); CHKERRABORT(sys.comm().get(), ierr);
+            
+            // the real and imaginary components are interleaved in the
+            // block vector
+            libMesh::PetscVector<Real> wv(w, sys.comm());
+            wv.zero();
+            
+            for (libMesh::numeric_index_type i=phi.first_local_index();
+                 i<phi.last_local_index(); i++)
+                wv.set(2*i+j, phi(i));
+            wv.close();
+            
+            ierr = MatMult(mat0, w, _A0W[2*k+j]);       CHKERRABORT(sys.comm().get(), ierr);
+            ierr = MatMult(mat1, w, _A1W[2*k+j]);       CHKERRABORT(sys.comm().get(), ierr);
+        }
+    }
+    
+    ierr = MatDestroy(&mat0);                          CHKERRABORT(sys.comm().get(), ierr);
+    ierr = MatDestroy(&mat1);                          CHKERRABORT(sys.comm().get(), ierr);
+    ierr = VecDestroy(&res_vec);                       CHKERRABORT(sys.comm().get(), ierr);
+    ierr = VecDestroy(&sol_vec);                       CHKERRABORT(sys.comm().get(), ierr);
+    
+    // reduced matrices, which are computed one row at a time
+    _G00.setZero(n, n);
+    _G01.setZero(n, n);
+    _G11.setZero(n, n);
+    _H0.setZero(n, n);
+    _H1.setZero(n, n);
+    
+    RealVectorX v(n);
+    
+    for (unsigned int i=0; i<n; i++) {
+        
+        ierr = VecMDot(_A0W[i], n, &_A0W[0], v.data()); CHKERRABORT(sys.comm().get(), ierr);
+        _G00.row(i) = v;
+        ierr = VecMDot(_A0W[i], n, &_A1W[0], v.data()); CHKERRABORT(sys.comm().get(), ierr);
+        _G01.row(i) = v;
+        ierr = VecMDot(_A1W[i], n, &_A1W[0], v.data()); CHKERRABORT(sys.comm().get(), ierr);
+        _G11.row(i) = v;
+        
+        // W^T A W has W_i as the row vector
+        ierr = VecMDot(_W[i],   n, &_A0W[0], v.data()); CHKERRABORT(sys.comm().get(), ierr);
+        _H0.row(i) = v;
+        ierr = VecMDot(_W[i],   n, &_A1W[0], v.data()); CHKERRABORT(sys.comm().get(), ierr);
+        _H1.row(i) = v;
+    }
+}
+
+
+
+void
+MAST::FrequencyDomainFluidROM::_clear_basis() {
+    
+    for (unsigned int i=0; i<_basis.size(); i++)
+        delete _basis[i];
+    _basis.clear();
+    _energy.resize(0);
+    
+    PetscErrorCode ierr = 0;
+    
+    for (unsigned int i=0; i<_W.size(); i++) {
+        
+        MPI_Comm comm = PetscObjectComm((PetscObject)_W[i]);
+        
+        ierr = VecDestroy(&_W[i]);                  CHKERRABORT(comm, ierr);
+        ierr = VecDestroy(&_A0W[i]);                CHKERRABORT(comm, ierr);
+        ierr = VecDestroy(&_A1W[i]);                CHKERRABORT(comm, ierr);
+    }
+    
+    _W.clear();
+    _A0W.clear();
+    _A1W.clear();
+}
+
@@ -0,0 +1,229 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2017  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+#ifndef __mast__frequency_domain_fluid_rom_h__
+#define __mast__frequency_domain_fluid_rom_h__
+
+// C++ includes
+#include <vector>
+
+
+// MAST includes
+#include "base/mast_data_types.h"
+
+
+// libMesh includes
+#include "libmesh/numeric_vector.h"
+
+
+// PETSc includes
+#include <petscvec.h>
+
+
+namespace MAST {
+    
+    // Forward declerations
+    class ComplexSolverBase;
+    class FrequencyFunction;
+    
+    
+    /*!
+     *   Reduced-order model of the frequency-domain small-disturbance fluid
+     *   equations solved by MAST::ComplexSolverBase::solve_block_matrix().
+     *   Fluid solutions from full solves at sampled reduced frequencies
+     *   and structural modes are added as snapshots. A proper orthogonal
+     *   decomposition (POD) of the real and imaginary parts of the
+     *   snapshots, computed with the method of snapshots, gives a real
+     *   basis \f$ \Phi \f$, and the fluid solution is approximated as
+     *   \f$ \Phi a \f$ with complex coefficients \f$ a \f$.
+     *
+     *   The assembly must support the frequency operator split
+     *   \f$ A(\omega) = A_0 + \omega A_1 \f$,
+     *   \f$ r(\omega) = r_0 + \omega r_1 \f$ of
+     *   MAST::ComplexAssemblyBase::set_frequency_operator(). The products
+     *   of \f$ A_0 \f$ and \f$ A_1 \f$ with the basis, and their projections
+     *   on the basis, are computed once in build_basis(). A ROM solve for
+     *   a new frequency or boundary motion then assembles only the two
+     *   residual terms, and solves a dense system of twice the basis size,
+     *   obtained either from the Galerkin projection
+     *   \f$ \Phi^T (A \Phi a - r) = 0 \f$ or from the least-squares problem
+     *   \f$ \min_a \| A \Phi a - r \| \f$. The returned error indicator is
+     *   the relative norm of the full-order residual,
+     *   \f$ \| r - A \Phi a\| / \|r\| \f$, which is evaluated from the
+     *   precomputed inner products and is accurate down to about the
+     *   square root of the machine precision. A large value indicates that
+     *   the ROM should be resampled with a full solve.
+     */
+    class FrequencyDomainFluidROM {
+        
+    public:
+        
+        /*!
+         *   projection used for the ROM solution
+         */
+        enum ProjectionType {
+            GALERKIN,
+            LEAST_SQUARES
+        };
+        
+        
+        /*!
+         *   the ROM uses the system and assembly of \p solver, and the
+         *   frequency from \p freq
+         */
+        FrequencyDomainFluidROM(MAST::ComplexSolverBase& solver,
+                                MAST::FrequencyFunction& freq);
+        
+        
+        virtual ~FrequencyDomainFluidROM();
+        
+        
+        /*!
+         *   projection used by solve(). This is \p LEAST_SQUARES by default.
+         */
+        ProjectionType projection;
+        
+        /*!
+         *   fraction of the snapshot energy that may be discarded by the
+         *   POD basis. This is 1.e-8 by default.
+         */
+        Real           energy_tol;
+        
+        /*!
+         *   maximum number of POD modes, or zero for no limit, which is
+         *   the default
+         */
+        unsigned int   max_basis_size;
+        
+        
+        /*!
+         *   adds copies of the real and imaginary parts of a fluid solution
+         *   to the snapshots. The basis is not changed until build_basis()
+         *   is called.
+         */
+        void add_snapshot(const libMesh::NumericVector<Real>& sol_R,
+                          const libMesh::NumericVector<Real>& sol_I);
+        
+        
+        /*!
+         *   @returns the number of snapshots
+         */
+        unsigned int n_snapshots() const {
+            return (unsigned int)_snapshots_R.size();
+        }
+        
+        
+        /*!
+         *   deletes the snapshots and the basis
+         */
+        void clear();
+        
+        
+        /*!
+         *   computes the POD basis with the modes required to retain a
+         *   fraction \p 1-energy_tol of the snapshot energy, up to
+         *   \p max_basis_size modes, and assembles the reduced operators.
+         *   This must be called again if the base solution or the flight
+         *   condition of the fluid changes.
+         */
+        void build_basis();
+        
+        
+        /*!
+         *   @returns the number of POD modes
+         */
+        unsigned int n_basis() const {
+            return (unsigned int)_basis.size();
+        }
+        
+        
+        /*!
+         *   @returns the fraction of the snapshot energy of each POD mode
+         */
+        const RealVectorX& energy_fractions() const {
+            return _energy;
+        }
+        
+        
+        /*!
+         *   computes the ROM solution for the current boundary conditions
+         *   of the assembly and the current frequency, and returns the
+         *   real and imaginary parts in \p sol_R and \p sol_I, which must
+         *   have the layout of the system solution.
+         *   @returns the relative full-order residual of the solution.
+         */
+        Real solve(libMesh::NumericVector<Real>& sol_R,
+                   libMesh::NumericVector<Real>& sol_I);
+        
+    protected:
+        
+        /*!
+         *   assembles \f$ A_0 \f$ and \f$ A_1 \f$ and computes their products
+         *   with the basis and the reduced matrices
+         */
+        void _build_operators();
+        
+        
+        /*!
+         *   deletes the basis and the reduced operators
+         */
+        void _clear_basis();
+        
+        
+        /*!
+         *   complex solver that provides the system and assembly
+         */
+        MAST::ComplexSolverBase&                    _solver;
+        
+        /*!
+         *   frequency at which the ROM is solved
+         */
+        MAST::FrequencyFunction&                    _freq;
+        
+        /*!
+         *   real and imaginary parts of the snapshots
+         */
+        std::vector<libMesh::NumericVector<Real>*>  _snapshots_R, _snapshots_I;
+        
+        /*!
+         *   POD modes and their energy fractions
+         */
+        std::vector<libMesh::NumericVector<Real>*>  _basis;
+        
+        RealVectorX                                 _energy;
+        
+        /*!
+         *   block vectors of the real and imaginary components of the
+         *   basis, with the real and imaginary parts of mode \p k at
+         *   \p 2k and \p 2k+1, and their products with
+         *   \f$ A_0 \f$ and \f$ A_1 \f$
+         */
+        std::vector<Vec>                            _W, _A0W, _A1W;
+        
+        /*!
+         *   Gram matrices \f$ (A_i W)^T (A_j W) \f$ of the least-squares
+         *   problem, and the Galerkin matrices \f$ W^T A_i W \f$
+         */
+        RealMatrixX                                 _G00, _G01, _G11, _H0, _H1;
+    };
+}
+
+
+#endif // __mast__frequency_domain_fluid_rom_h__
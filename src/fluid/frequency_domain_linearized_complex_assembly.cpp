@@ -26,11 +26,17 @@
 #include "base/physics_discipline_base.h"
 
 
+// libMesh includes
+#include "libmesh/threads.h"
+
+
 
 MAST::FrequencyDomainLinearizedComplexAssembly::
 FrequencyDomainLinearizedComplexAssembly():
 MAST::ComplexAssemblyBase(),
-_frequency(nullptr) {
+_frequency(nullptr),
+_freq_operator(MAST::FULL_FREQUENCY_OPERATOR),
+_if_store_base_state_operators(false) {
     
 }
 
@@ -61,7 +67,9 @@ set_frequency_function(MAST::FrequencyFunction& f) {
 void
 MAST::FrequencyDomainLinearizedComplexAssembly::clear_discipline_and_system() {
 
-    _frequency = nullptr;
+    _frequency     = nullptr;
+    _freq_operator = MAST::FULL_FREQUENCY_OPERATOR;
+    this->clear_base_state_operators();
     
     // call the parent's function
     MAST::ComplexAssemblyBase::clear_discipline_and_system();
@@ -82,6 +90,9 @@ _elem_calculations(MAST::ElementBase& elem,
     vec.setZero();
     mat.setZero();
     
+    e.freq_operator = _freq_operator;
+    _set_base_state_operators(e);
+    
     // assembly of the flux terms
     e.internal_residual(if_jac, vec, mat);
     e.side_external_residual(if_jac, vec, mat, _discipline->side_loads());
@@ -103,6 +114,8 @@ _elem_sensitivity_calculations(MAST::ElementBase& elem,
     vec.setZero();
     mat.setZero();
     
+    _set_base_state_operators(e);
+    
     // assembly of the flux terms
     e.internal_residual_sensitivity(if_jac, vec, mat);
     e.side_external_residual_sensitivity(if_jac, vec, mat, _discipline->side_loads());
@@ -110,6 +123,23 @@ _elem_sensitivity_calculations(MAST::ElementBase& elem,
 
 
 
+void
+MAST::FrequencyDomainLinearizedComplexAssembly::
+_set_base_state_operators(MAST::FrequencyDomainLinearizedConservativeFluidElem& e) {
+    
+    e.base_state_operators = nullptr;
+    
+    if (!_if_store_base_state_operators)
+        return;
+    
+    libMesh::Threads::spin_mutex::scoped_lock
+    lock(libMesh::Threads::spin_mtx);
+    
+    e.base_state_operators = &_base_state_operators[&e.elem()];
+}
+
+
+
 std::auto_ptr<MAST::ElementBase>
 MAST::FrequencyDomainLinearizedComplexAssembly::_build_elem(const libMesh::Elem& elem) {
     
@@ -20,8 +20,13 @@
 #ifndef __mast__frequency_domain_linearized_complex_assembly_h__
 #define __mast__frequency_domain_linearized_complex_assembly_h__
 
+// C++ includes
+#include <map>
+
+
 // MAST includes
 #include "base/complex_assembly_base.h"
+#include "fluid/frequency_domain_linearized_conservative_fluid_elem.h"
 
 
 
@@ -62,6 +67,48 @@ namespace MAST {
         virtual void clear_discipline_and_system( );
 
         
+        /*!
+         *   tells the assembly to compute the part \p op of the
+         *   frequency-domain operator and residual.
+         */
+        virtual void set_frequency_operator(MAST::FrequencyDomainOperator op) {
+            _freq_operator = op;
+        }
+        
+        
+        /*!
+         *   if \p f is true, the operators of each element that depend only
+         *   on the base solution, and not on the frequency, are computed in
+         *   the first assembly and stored for the assemblies at other
+         *   frequencies and for other right-hand sides. The stored operators
+         *   must be cleared with clear_base_state_operators() if the base
+         *   solution or the flight condition changes. This is false by
+         *   default.
+         */
+        void set_store_base_state_operators(bool f) {
+            _if_store_base_state_operators = f;
+            if (!f) this->clear_base_state_operators();
+        }
+        
+        
+        /*!
+         *   clears the stored base-state operators of the elements
+         */
+        void clear_base_state_operators() {
+            _base_state_operators.clear();
+        }
+        
+        
+        /*!
+         *   clears the stored base-state operators along with the data of
+         *   the parent class
+         */
+        virtual void clear_mesh_dependent_data() {
+            MAST::ComplexAssemblyBase::clear_mesh_dependent_data();
+            this->clear_base_state_operators();
+        }
+        
+        
     protected:
         
         /*!
@@ -92,11 +139,35 @@ namespace MAST {
         _build_elem(const libMesh::Elem& elem);
 
         
+        /*!
+         *   sets the storage of the base-state operators of \p e, if
+         *   these are stored
+         */
+        void
+        _set_base_state_operators(MAST::FrequencyDomainLinearizedConservativeFluidElem& e);
+
+        
         /*!
          *   frequency function used to define the oscillatory frequency
          */
         MAST::FrequencyFunction*  _frequency;
         
+        /*!
+         *   part of the frequency-domain operator computed by the elements
+         */
+        MAST::FrequencyDomainOperator _freq_operator;
+        
+        /*!
+         *   flag to store the base-state operators of the elements
+         */
+        bool _if_store_base_state_operators;
+        
+        /*!
+         *   base-state operators of the local elements
+         */
+        std::map<const libMesh::Elem*,
+        MAST::FrequencyDomainLinearizedConservativeFluidElem::BaseStateOperators>
+        _base_state_operators;
     };
 }
 
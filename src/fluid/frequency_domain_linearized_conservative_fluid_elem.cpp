@@ -36,7 +36,9 @@ FrequencyDomainLinearizedConservativeFluidElem(MAST::SystemInitialization& sys,
                                                const libMesh::Elem& elem,
                                                const MAST::FlightCondition& f):
 MAST::ConservativeFluidElementBase(sys, elem, f),
-freq(nullptr) {
+freq(nullptr),
+freq_operator(MAST::FULL_FREQUENCY_OPERATOR),
+base_state_operators(nullptr) {
     
     
 }
@@ -54,6 +56,163 @@ MAST::FrequencyDomainLinearizedConservativeFluidElem::
 
 
 
+void
+MAST::FrequencyDomainLinearizedConservativeFluidElem::
+_frequency_values(Real& omega, Real& b_V) const {
+    
+    omega = 0.;
+    b_V   = 0.;
+    
+    switch (freq_operator) {
+            
+        case MAST::FULL_FREQUENCY_OPERATOR:
+            (*freq)(omega);
+            freq->nondimensionalizing_factor(b_V);
+            break;
+            
+        case MAST::FREQUENCY_INDEPENDENT_OPERATOR:
+            freq->nondimensionalizing_factor(b_V);
+            break;
+            
+        case MAST::FREQUENCY_COEFFICIENT_OPERATOR:
+            omega = 1.;
+            break;
+            
+        default:
+            libmesh_error(); // should not get here
+    }
+}
+
+
+
+
+const MAST::FrequencyDomainLinearizedConservativeFluidElem::BaseStateOperators&
+MAST::FrequencyDomainLinearizedConservativeFluidElem::
+_internal_base_state_operators(MAST::FrequencyDomainLinearizedConservativeFluidElem::BaseStateOperators& local) {
+    
+    MAST::FrequencyDomainLinearizedConservativeFluidElem::BaseStateOperators&
+    ops = base_state_operators? *base_state_operators : local;
+    
+    if (ops.if_internal)
+        return ops;
+    
+    const unsigned int
+    n2     = _fe->n_shape_functions()*(_elem.dim()+2);
+    
+    RealVectorX
+    local_f    = RealVectorX::Zero(n2);
+    
+    ops.f_jac_x     = RealMatrixX::Zero(n2, n2);
+    ops.fm_jac_xdot = RealMatrixX::Zero(n2, n2);
+    
+    // df/dx. We always need the Jacobian, since it is used to calculate
+    // the residual
+    MAST::ConservativeFluidElementBase::internal_residual(true,
+                                                          local_f,
+                                                          ops.f_jac_x);
+    
+    // dfm/dxdot. We always need the Jacobian, since it is used to calculate
+    // the residual
+    MAST::ConservativeFluidElementBase::velocity_residual(true,
+                                                          local_f,
+                                                          ops.fm_jac_xdot,
+                                                          ops.f_jac_x);
+    
+    ops.if_internal = true;
+    
+    return ops;
+}
+
+
+
+
+const MAST::FrequencyDomainLinearizedConservativeFluidElem::BaseStateOperators&
+MAST::FrequencyDomainLinearizedConservativeFluidElem::
+_side_base_state_operators(std::multimap<libMesh::boundary_id_type, MAST::BoundaryConditionBase*>& bc,
+                           MAST::FrequencyDomainLinearizedConservativeFluidElem::BaseStateOperators& local) {
+    
+    MAST::FrequencyDomainLinearizedConservativeFluidElem::BaseStateOperators&
+    ops = base_state_operators? *base_state_operators : local;
+    
+    if (ops.if_side)
+        return ops;
+    
+    const unsigned int
+    n2      = _fe->n_shape_functions()*(_elem.dim()+2);
+    
+    RealMatrixX
+    f_jac_x = RealMatrixX::Zero(n2, n2);
+    
+    RealVectorX
+    local_f = RealVectorX::Zero(n2);
+    
+    ops.side_f_jac_x = RealMatrixX::Zero(n2, n2);
+    
+    typedef std::multimap<libMesh::boundary_id_type, MAST::BoundaryConditionBase*> maptype;
+    
+    // iterate over the boundary ids given in the provided force map
+    std::pair<maptype::const_iterator, maptype::const_iterator> it;
+    
+    const MAST::ElementTopologyCache& topology = _system.system().topology_cache();
+    
+    for (unsigned short int n=0; n<_elem.n_sides(); n++) {
+        
+        if (!topology.n_boundary_ids(_elem, n))
+            continue;
+        
+        std::vector<libMesh::boundary_id_type> bc_ids = topology.boundary_ids(_elem, n);
+        std::vector<libMesh::boundary_id_type>::const_iterator bc_it = bc_ids.begin();
+        
+        for ( ; bc_it != bc_ids.end(); bc_it++) {
+            
+            it = bc.equal_range(*bc_it);
+            
+            for ( ; it.first != it.second; it.first++) {
+                
+                f_jac_x.setZero();
+                local_f.setZero();
+                
+                // We always need the Jacobian, since it is used to
+                // calculate the residual
+                switch (it.first->second->type()) {
+                        
+                    case MAST::SYMMETRY_WALL:
+                        MAST::ConservativeFluidElementBase::
+                        symmetry_surface_residual(true,
+                                                  local_f,
+                                                  f_jac_x,
+                                                  n,
+                                                  *it.first->second);
+                        break;
+                        
+                    case MAST::FAR_FIELD:
+                        MAST::ConservativeFluidElementBase::
+                        far_field_surface_residual(true,
+                                                   local_f,
+                                                   f_jac_x,
+                                                   n,
+                                                   *it.first->second);
+                        break;
+                        
+                    default:
+                        // other boundaries depend on the frequency, and
+                        // are computed by the residual routines
+                        continue;
+                }
+                
+                ops.side_f_jac_x += f_jac_x;
+            }
+        }
+    }
+    
+    ops.if_side = true;
+    
+    return ops;
+}
+
+
+
+
 bool
 MAST::FrequencyDomainLinearizedConservativeFluidElem::
 internal_residual (bool request_jacobian,
@@ -72,9 +231,6 @@ internal_residual (bool request_jacobian,
     n2     = _fe->n_shape_functions()*n1;
     //nphi   = _fe->n_shape_functions();
     
-    RealMatrixX
-    f_jac_x         = RealMatrixX::Zero(   n2,    n2),
-    fm_jac_xdot     = RealMatrixX::Zero(   n2,    n2);
     /*mat1_n1n1       = RealMatrixX::Zero(   n1,    n1),
     mat2_n1n1       = RealMatrixX::Zero(   n1,    n1),
     mat3_n1n2       = RealMatrixX::Zero(   n1,    n2),
@@ -89,10 +245,9 @@ internal_residual (bool request_jacobian,
     local_jac       = ComplexMatrixX::Zero(   n2,    n2);
     
     
-    RealVectorX
+    //RealVectorX
     //vec1_n1  = RealVectorX::Zero(n1),
     //vec2_n1  = RealVectorX::Zero(n1),
-    local_f    = RealVectorX::Zero(n2);
     //dc       = RealVectorX::Zero(dim);
     
     const Complex
@@ -102,26 +257,18 @@ internal_residual (bool request_jacobian,
     omega   = 0.,
     b_V     = 0.;
     
-    (*freq)(omega);
-    freq->nondimensionalizing_factor(b_V);
+    _frequency_values(omega, b_V);
     
-    // df/dx. We always need the Jacobian, since it is used to calculate
-    // the residual
-    MAST::ConservativeFluidElementBase::internal_residual(true,
-                                                          local_f,
-                                                          f_jac_x);
-    
-    // dfm/dxdot. We always need the Jacobian, since it is used to calculate
-    // the residual
-    MAST::ConservativeFluidElementBase::velocity_residual(true,
-                                                          local_f,
-                                                          fm_jac_xdot,
-                                                          f_jac_x);
+    // df/dx and dfm/dxdot at the base solution
+    MAST::FrequencyDomainLinearizedConservativeFluidElem::BaseStateOperators
+    local_ops;
+    const MAST::FrequencyDomainLinearizedConservativeFluidElem::BaseStateOperators&
+    ops = _internal_base_state_operators(local_ops);
     
     // now, combine the two to return the complex Jacobian
     
-    local_jac = (f_jac_x.cast<Complex>() * b_V +  // multiply stiffness with nondim factor
-                 iota * omega * fm_jac_xdot.cast<Complex>());
+    local_jac = (ops.f_jac_x.cast<Complex>() * b_V +  // multiply stiffness with nondim factor
+                 iota * omega * ops.fm_jac_xdot.cast<Complex>());
     
     if (request_jacobian)
         jac      +=  local_jac;
@@ -153,9 +300,6 @@ internal_residual_sensitivity (bool request_jacobian,
     n2     = _fe->n_shape_functions()*n1;
     //nphi   = _fe->n_shape_functions();
     
-    RealMatrixX
-    f_jac_x         = RealMatrixX::Zero(   n2,    n2),
-    fm_jac_xdot     = RealMatrixX::Zero(   n2,    n2);
     /*mat1_n1n1       = RealMatrixX::Zero(   n1,    n1),
      mat2_n1n1       = RealMatrixX::Zero(   n1,    n1),
      mat3_n1n2       = RealMatrixX::Zero(   n1,    n2),
@@ -171,10 +315,9 @@ internal_residual_sensitivity (bool request_jacobian,
     local_jac_sens  = ComplexMatrixX::Zero(   n2,    n2);
     
     
-    RealVectorX
+    //RealVectorX
     //vec1_n1  = RealVectorX::Zero(n1),
     //vec2_n1  = RealVectorX::Zero(n1),
-    local_f    = RealVectorX::Zero(n2);
     //dc       = RealVectorX::Zero(dim);
     
     const Complex
@@ -190,25 +333,18 @@ internal_residual_sensitivity (bool request_jacobian,
     freq->nondimensionalizing_factor(b_V);
     
     
-    // df/dx. We always need the Jacobian, since it is used to calculate
-    // the residual
-    MAST::ConservativeFluidElementBase::internal_residual(true,
-                                                          local_f,
-                                                          f_jac_x);
-    
-    // dfm/dxdot. We always need the Jacobian, since it is used to calculate
-    // the residual
-    MAST::ConservativeFluidElementBase::velocity_residual(true,
-                                                          local_f,
-                                                          fm_jac_xdot,
-                                                          f_jac_x);
+    // df/dx and dfm/dxdot at the base solution
+    MAST::FrequencyDomainLinearizedConservativeFluidElem::BaseStateOperators
+    local_ops;
+    const MAST::FrequencyDomainLinearizedConservativeFluidElem::BaseStateOperators&
+    ops = _internal_base_state_operators(local_ops);
     
     // now, combine the two to return the complex Jacobian
     
-    local_jac      = (f_jac_x.cast<Complex>() * b_V +  // multiply stiffness with nondim factor
-                      iota * omega * fm_jac_xdot.cast<Complex>());
+    local_jac      = (ops.f_jac_x.cast<Complex>() * b_V +  // multiply stiffness with nondim factor
+                      iota * omega * ops.fm_jac_xdot.cast<Complex>());
 
-    local_jac_sens = (iota * domega * fm_jac_xdot.cast<Complex>());
+    local_jac_sens = (iota * domega * ops.fm_jac_xdot.cast<Complex>());
 
     
     if (request_jacobian)
@@ -234,28 +370,31 @@ side_external_residual (bool request_jacobian,
     // we will use the parent class's methods for these two. The
     // slip wall, which may be oscillating, is implemented for this element.
     
-    const unsigned int
-    dim     = _elem.dim(),
-    n1      = dim+2,
-    n2      = _fe->n_shape_functions()*n1;
-    
-    RealMatrixX
-    f_jac_x = RealMatrixX::Zero(n2, n2);
-    
-    RealVectorX
-    local_f = RealVectorX::Zero(n2);
-    
     Real
+    omega   = 0.,
     b_V     = 0.;
-    freq->nondimensionalizing_factor(b_V);
+    _frequency_values(omega, b_V);
 
+    // Jacobian of the symmetry and far-field boundaries at the base
+    // solution. The multiplication with the nondimensionalizing factor
+    // (V/b for flutter analysis) gives the contribution to the residual
+    // and Jacobian
+    MAST::FrequencyDomainLinearizedConservativeFluidElem::BaseStateOperators
+    local_ops;
+    const RealMatrixX&
+    side_jac = _side_base_state_operators(bc, local_ops).side_f_jac_x;
+    
+    if (request_jacobian)
+        jac  += side_jac.cast<Complex>() * b_V;
+    f    += side_jac.cast<Complex>() * b_V * _complex_sol;
+    
     
     typedef std::multimap<libMesh::boundary_id_type, MAST::BoundaryConditionBase*> maptype;
     
     // iterate over the boundary ids given in the provided force map
     std::pair<maptype::const_iterator, maptype::const_iterator> it;
     
-    const libMesh::BoundaryInfo& binfo = *_system.system().get_mesh().boundary_info;
+    const MAST::ElementTopologyCache& topology = _system.system().topology_cache();
     
     // for each boundary id, check if any of the sides on the element
     // has the associated boundary
@@ -264,12 +403,12 @@ side_external_residual (bool request_jacobian,
         
         // if no boundary ids have been specified for the side, then
         // move to the next side.
-        if (!binfo.n_boundary_ids(&_elem, n))
+        if (!topology.n_boundary_ids(_elem, n))
             continue;
         
         // check to see if any of the specified boundary ids has a boundary
         // condition associated with them
-        std::vector<libMesh::boundary_id_type> bc_ids = binfo.boundary_ids(&_elem, n);
+        std::vector<libMesh::boundary_id_type> bc_ids = topology.boundary_ids(_elem, n);
         std::vector<libMesh::boundary_id_type>::const_iterator bc_it = bc_ids.begin();
         
         for ( ; bc_it != bc_ids.end(); bc_it++) {
@@ -281,27 +420,8 @@ side_external_residual (bool request_jacobian,
                 
                 // apply all the types of loading
                 switch (it.first->second->type()) {
-                    case MAST::SYMMETRY_WALL: {
-                        
-                        f_jac_x.setZero();
-                        local_f.setZero();
-                        
-                        // We always need the Jacobian, since it is used to
-                        // calculate the residual
-                        
-                         MAST::ConservativeFluidElementBase::
-                         symmetry_surface_residual(true,
-                                                   local_f,
-                                                   f_jac_x,
-                                                   n,
-                                                   *it.first->second);
-                        
-                        // multiply jacobian with the nondimensionalizing
-                        // factor (V/b for flutter analysis)
-                        if (request_jacobian)
-                            jac  += f_jac_x.cast<Complex>() * b_V;
-                        f    += f_jac_x.cast<Complex>() * b_V * _complex_sol;
-                    }
+                    case MAST::SYMMETRY_WALL:
+                        // included in the base-state side Jacobian
                         break;
                         
                     case MAST::SLIP_WALL: {
@@ -316,28 +436,8 @@ side_external_residual (bool request_jacobian,
                     }
                         break;
                         
-                    case MAST::FAR_FIELD: {
-                        
-                        f_jac_x.setZero();
-                        local_f.setZero();
-
-                        // We always need the Jacobian, since it is used to
-                        // calculate the residual
-
-                        MAST::ConservativeFluidElementBase::
-                        far_field_surface_residual(true,
-                                                   local_f,
-                                                   f_jac_x,
-                                                   n,
-                                                   *it.first->second);
-                        
-                        // multiply jacobian with the nondimensionalizing
-                        // factor (V/b for flutter analysis)
-                        if (request_jacobian)
-                            jac  += f_jac_x.cast<Complex>() * b_V;
-                        
-                        f    += f_jac_x.cast<Complex>() * b_V * _complex_sol;
-                    }
+                    case MAST::FAR_FIELD:
+                        // included in the base-state side Jacobian
                         break;
                         
                     case MAST::DIRICHLET:
@@ -374,28 +474,27 @@ side_external_residual_sensitivity (bool request_jacobian,
     // we will use the parent class's methods for these two. The
     // slip wall, which may be oscillating, is implemented for this element.
     
-    const unsigned int
-    dim     = _elem.dim(),
-    n1      = dim+2,
-    n2      = _fe->n_shape_functions()*n1;
-    
-    RealMatrixX
-    f_jac_x = RealMatrixX::Zero(n2, n2);
-    
-    RealVectorX
-    local_f = RealVectorX::Zero(n2);
-    
     Real
     b_V     = 0.;
     freq->nondimensionalizing_factor(b_V);
     
+    // the Jacobian of the symmetry and far-field boundaries does not
+    // depend on the parameter, and contributes only through the
+    // sensitivity of the complex solution
+    MAST::FrequencyDomainLinearizedConservativeFluidElem::BaseStateOperators
+    local_ops;
+    const RealMatrixX&
+    side_jac = _side_base_state_operators(bc, local_ops).side_f_jac_x;
+    
+    f    += side_jac.cast<Complex>() * b_V * _complex_sol_sens;
+    
     
     typedef std::multimap<libMesh::boundary_id_type, MAST::BoundaryConditionBase*> maptype;
     
     // iterate over the boundary ids given in the provided force map
     std::pair<maptype::const_iterator, maptype::const_iterator> it;
     
-    const libMesh::BoundaryInfo& binfo = *_system.system().get_mesh().boundary_info;
+    const MAST::ElementTopologyCache& topology = _system.system().topology_cache();
     
     // for each boundary id, check if any of the sides on the element
     // has the associated boundary
@@ -404,12 +503,12 @@ side_external_residual_sensitivity (bool request_jacobian,
         
         // if no boundary ids have been specified for the side, then
         // move to the next side.
-        if (!binfo.n_boundary_ids(&_elem, n))
+        if (!topology.n_boundary_ids(_elem, n))
             continue;
         
         // check to see if any of the specified boundary ids has a boundary
         // condition associated with them
-        std::vector<libMesh::boundary_id_type> bc_ids = binfo.boundary_ids(&_elem, n);
+        std::vector<libMesh::boundary_id_type> bc_ids = topology.boundary_ids(_elem, n);
         std::vector<libMesh::boundary_id_type>::const_iterator bc_it = bc_ids.begin();
         
         for ( ; bc_it != bc_ids.end(); bc_it++) {
@@ -421,27 +520,8 @@ side_external_residual_sensitivity (bool request_jacobian,
                 
                 // apply all the types of loading
                 switch (it.first->second->type()) {
-                    case MAST::SYMMETRY_WALL: {
-                        
-                        f_jac_x.setZero();
-                        local_f.setZero();
-                        
-                        // We always need the Jacobian, since it is used to
-                        // calculate the residual
-                        
-                        MAST::ConservativeFluidElementBase::
-                        symmetry_surface_residual(true,
-                                                  local_f,
-                                                  f_jac_x,
-                                                  n,
-                                                  *it.first->second);
-                        
-                        // multiply jacobian with the nondimensionalizing
-                        // factor (V/b for flutter analysis)
-                        //if (request_jacobian)
-                        //    jac  += f_jac_x.cast<Complex>() * b_V;
-                        f    += f_jac_x.cast<Complex>() * b_V * _complex_sol_sens;
-                    }
+                    case MAST::SYMMETRY_WALL:
+                        // included in the base-state side Jacobian
                         break;
                         
                     case MAST::SLIP_WALL: {
@@ -456,28 +536,8 @@ side_external_residual_sensitivity (bool request_jacobian,
                     }
                         break;
                         
-                    case MAST::FAR_FIELD: {
-                        
-                        f_jac_x.setZero();
-                        local_f.setZero();
-                        
-                        // We always need the Jacobian, since it is used to
-                        // calculate the residual
-                        
-                        MAST::ConservativeFluidElementBase::
-                        far_field_surface_residual(true,
-                                                   local_f,
-                                                   f_jac_x,
-                                                   n,
-                                                   *it.first->second);
-                        
-                        // multiply jacobian with the nondimensionalizing
-                        // factor (V/b for flutter analysis)
-                        //if (request_jacobian)
-                        //    jac  += f_jac_x.cast<Complex>() * b_V;
-                        
-                        f    += f_jac_x.cast<Complex>() * b_V * _complex_sol_sens;
-                    }
+                    case MAST::FAR_FIELD:
+                        // included in the base-state side Jacobian
                         break;
                         
                     case MAST::DIRICHLET:
@@ -608,8 +668,7 @@ slip_wall_surface_residual(bool request_jacobian,
     
 
     
-    (*freq)(omega);
-    freq->nondimensionalizing_factor(b_V);
+    _frequency_values(omega, b_V);
     
     
     for (unsigned int qp=0; qp<JxW.size(); qp++) {
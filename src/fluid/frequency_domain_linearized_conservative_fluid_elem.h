@@ -23,6 +23,7 @@
 
 // MAST includes
 #include "fluid/conservative_fluid_element_base.h"
+#include "base/complex_assembly_base.h"
 
 
 namespace MAST {
@@ -92,7 +93,73 @@ namespace MAST {
         MAST::FrequencyFunction*  freq;
         
         
+        /*!
+         *  part of the frequency-domain operator computed by the residual
+         *  routines. For MAST::FREQUENCY_INDEPENDENT_OPERATOR the frequency
+         *  is taken to be zero, and for MAST::FREQUENCY_COEFFICIENT_OPERATOR
+         *  the frequency is taken to be one while the frequency independent
+         *  terms are dropped. This is MAST::FULL_FREQUENCY_OPERATOR by default.
+         */
+        MAST::FrequencyDomainOperator freq_operator;
+        
+        
+        /*!
+         *  real operators of the element that depend only on the base
+         *  solution and the flight condition, and not on the frequency:
+         *  the Jacobians of the internal flux with respect to the solution,
+         *  including the stabilization terms, and with respect to the
+         *  solution velocity, and the Jacobian of the symmetry and
+         *  far-field boundaries.
+         */
+        struct BaseStateOperators {
+            
+            BaseStateOperators(): if_internal(false), if_side(false) { }
+            
+            bool         if_internal;
+            bool         if_side;
+            RealMatrixX  f_jac_x;
+            RealMatrixX  fm_jac_xdot;
+            RealMatrixX  side_f_jac_x;
+        };
+        
+        
+        /*!
+         *  if provided, the base-state operators are computed in the first
+         *  call to the residual routines and stored in this object, from
+         *  which subsequent calls read them. This is \p nullptr by default,
+         *  in which case the operators are computed in each call.
+         */
+        BaseStateOperators* base_state_operators;
+        
+        
     protected:
+        
+        /*!
+         *   @returns the internal base-state operators from
+         *   \p base_state_operators, after computing them if they are not
+         *   yet available. If \p base_state_operators is \p nullptr, the
+         *   operators are computed in \p local.
+         */
+        const BaseStateOperators&
+        _internal_base_state_operators(BaseStateOperators& local);
+        
+        
+        /*!
+         *   @returns the side base-state operators for the boundary
+         *   conditions in \p bc, similar to
+         *   _internal_base_state_operators().
+         */
+        const BaseStateOperators&
+        _side_base_state_operators(std::multimap<libMesh::boundary_id_type, MAST::BoundaryConditionBase*>& bc,
+                                   BaseStateOperators& local);
+        
+        
+        /*!
+         *   provides the frequency, \p omega, and the nondimensionalizing
+         *   factor, \p b_V, used by the residual routines for
+         *   \p freq_operator.
+         */
+        void _frequency_values(Real& omega, Real& b_V) const;
 
         
         /*!
@@ -23,7 +23,9 @@
 #include "fluid/conservative_fluid_system_initialization.h"
 #include "numerics/utility.h"
 #include "fluid/primitive_fluid_solution.h"
+#include "fluid/primitive_fluid_solution_batch.h"
 #include "fluid/small_disturbance_primitive_fluid_solution.h"
+#include "base/mesh_field_transfer_operator.h"
 #include "fluid/flight_condition.h"
 #include "base/nonlinear_system.h"
 
@@ -40,7 +42,10 @@ FrequencyDomainPressureFunction(MAST::SystemInitialization& sys,
 MAST::FieldFunction<Complex>("frequency_domain_pressure"),
 _if_cp(false),
 _system(sys),
-_flt_cond(flt) {
+_flt_cond(flt),
+_transfer(nullptr),
+_probe(false),
+_probe_index(0) {
     
 }
 
@@ -62,25 +67,27 @@ init(const libMesh::NumericVector<Real>& steady_sol,
     
     MAST::NonlinearSystem& sys = _system.system();
     
-    // first initialize the solution to the given vector
-    // steady state solution
-    _sol.reset(libMesh::NumericVector<Real>::build(sys.comm()).release());
-    _sol->init(steady_sol.size(), true, libMesh::SERIAL);
+    // the solutions are localized to the values needed for interpolation,
+    // which is only the ghosted part for a distributed mesh
+    _sol.reset(MAST::build_localized_interpolation_vector(_system,
+                                                          steady_sol,
+                                                          _transfer));
+    _dsol_real.reset(MAST::build_localized_interpolation_vector(_system,
+                                                                small_dist_sol_real,
+                                                                _transfer));
+    _dsol_imag.reset(MAST::build_localized_interpolation_vector(_system,
+                                                                small_dist_sol_imag,
+                                                                _transfer));
     
-    // solution real part
-    _dsol_real.reset(libMesh::NumericVector<Real>::build(sys.comm()).release());
-    _dsol_real->init(steady_sol.size(), true, libMesh::SERIAL);
-    
-    // solution complex part
-    _dsol_imag.reset(libMesh::NumericVector<Real>::build(sys.comm()).release());
-    _dsol_imag->init(steady_sol.size(), true, libMesh::SERIAL);
-    
-    
-    // now localize the give solution to this objects's vector
-    steady_sol.localize(*_sol);
-    small_dist_sol_real.localize(*_dsol_real);
-    small_dist_sol_imag.localize(*_dsol_imag);
     
+    // the mesh functions are not needed if the transfer operator is used
+    if (_transfer) {
+        
+        _sol_function.reset();
+        _dsol_re_function.reset();
+        _dsol_im_function.reset();
+        return;
+    }
     
     // if the mesh function has not been created so far, initialize it
     _sol_function.reset(new libMesh::MeshFunction(sys.get_equation_systems(),
@@ -116,10 +123,19 @@ operator () (const libMesh::Point& p,
              Complex&              dpress) const {
     
     
-    libmesh_assert(_sol_function.get()); // should be initialized before this call
-    
     dpress = 0.;
     
+    if (_probe) {
+        
+        if (_probe_points.size() == _probe_index)
+            dpress = 1.;
+        
+        _probe_points.push_back(p);
+        return;
+    }
+    
+    libmesh_assert(_sol.get()); // should be initialized before this call
+    
     
     // get the nonlinear and linearized solution
     DenseRealVector
@@ -131,21 +147,29 @@ operator () (const libMesh::Point& p,
     dsol   = ComplexVectorX::Zero(_system.system().n_vars());
     
     
-    // first copy the real and imaginary solutions
-    (*_dsol_re_function)(p, 0., v);
-    MAST::copy(sol, v);
-    dsol.real() = sol;
-    
-    
-    // now the imaginary part
-    (*_dsol_im_function)(p, 0., v);
-    MAST::copy(sol, v);
-    dsol.imag() = sol;
-    
-    
-    // now the steady state function itself
-    (*_sol_function)(p, 0., v);
-    MAST::copy(sol, v);
+    if (_transfer) {
+        
+        _transfer->interpolate(p, *_dsol_real, *_dsol_imag, dsol);
+        _transfer->interpolate(p, *_sol, sol);
+    }
+    else {
+        
+        // first copy the real and imaginary solutions
+        (*_dsol_re_function)(p, 0., v);
+        MAST::copy(sol, v);
+        dsol.real() = sol;
+        
+        
+        // now the imaginary part
+        (*_dsol_im_function)(p, 0., v);
+        MAST::copy(sol, v);
+        dsol.imag() = sol;
+        
+        
+        // now the steady state function itself
+        (*_sol_function)(p, 0., v);
+        MAST::copy(sol, v);
+    }
     
     
     MAST::PrimitiveSolution                     p_sol;
@@ -166,3 +190,164 @@ operator () (const libMesh::Point& p,
         dpress    =  delta_p_sol.dp;
 }
 
+
+
+
+void
+MAST::FrequencyDomainPressureFunction::
+operator () (const std::vector<libMesh::Point>& pts,
+             const Real                         t,
+             ComplexVectorX&                    dpress) const {
+    
+    if (_probe) {
+        
+        dpress.setZero(pts.size());
+        
+        for (unsigned int i=0; i<pts.size(); i++) {
+            
+            if (_probe_points.size() == _probe_index)
+                dpress(i) = 1.;
+            
+            _probe_points.push_back(pts[i]);
+        }
+        return;
+    }
+    
+    libmesh_assert(_sol.get()); // should be initialized before this call
+    
+    RealMatrixX
+    sol,
+    dsol_re,
+    dsol_im;
+    
+    _interpolate(pts,       *_sol,     _sol_function.get(), sol);
+    _interpolate(pts, *_dsol_real, _dsol_re_function.get(), dsol_re);
+    _interpolate(pts, *_dsol_imag, _dsol_im_function.get(), dsol_im);
+    
+    ComplexMatrixX
+    dsol   = ComplexMatrixX::Zero(sol.rows(), sol.cols());
+    dsol.real() = dsol_re;
+    dsol.imag() = dsol_im;
+    
+    MAST::PrimitiveSolutionBatch                             p_sol;
+    MAST::SmallPerturbationPrimitiveSolutionBatch<Complex>   delta_p_sol;
+    
+    p_sol.init(dynamic_cast<MAST::ConservativeFluidSystemInitialization&>(_system).dim(),
+               sol,
+               _flt_cond.gas_property.cp,
+               _flt_cond.gas_property.cv,
+               false);
+    delta_p_sol.init(p_sol, dsol);
+    
+    if (_if_cp)
+        dpress    = delta_p_sol.c_pressure(_flt_cond.q0()).matrix();
+    else
+        dpress    = delta_p_sol.dp.matrix();
+}
+
+
+
+
+void
+MAST::FrequencyDomainPressureFunction::set_probe(bool f, unsigned int k) {
+    
+    _probe       = f;
+    _probe_index = k;
+    _probe_points.clear();
+}
+
+
+
+
+void
+MAST::FrequencyDomainPressureFunction::
+add_adjoint_load(const std::vector<libMesh::Point>& pts,
+                 const ComplexVectorX& a,
+                 libMesh::NumericVector<Real>& vec_re,
+                 libMesh::NumericVector<Real>& vec_im) const {
+    
+    libmesh_assert(_sol.get()); // should be initialized before this call
+    libmesh_assert_equal_to(a.size(), pts.size());
+    
+    if (!_transfer)
+        libmesh_error_msg("Adjoint load requires the transfer operator.");
+    
+    const unsigned int
+    n_vars = _system.system().n_vars();
+    
+    RealVectorX
+    sol    = RealVectorX::Zero(n_vars);
+    ComplexVectorX
+    dsol   = ComplexVectorX::Zero(n_vars),
+    dp_dx  = ComplexVectorX::Zero(n_vars);
+    
+    for (unsigned int i=0; i<pts.size(); i++) {
+        
+        if (a(i) == 0.)
+            continue;
+        
+        _transfer->interpolate(pts[i], *_sol, sol);
+        
+        MAST::PrimitiveSolution                     p_sol;
+        SmallPerturbationPrimitiveSolution<Complex> delta_p_sol;
+        
+        p_sol.init(dynamic_cast<MAST::ConservativeFluidSystemInitialization&>(_system).dim(),
+                   sol,
+                   _flt_cond.gas_property.cp,
+                   _flt_cond.gas_property.cv,
+                   false);
+        
+        // the pressure is linear in the small-disturbance variables, and
+        // its derivative is obtained with a unit perturbation of each
+        for (unsigned int j=0; j<n_vars; j++) {
+            
+            dsol.setZero();
+            dsol(j) = 1.;
+            delta_p_sol.init(p_sol, dsol);
+            
+            if (_if_cp)
+                dp_dx(j) = delta_p_sol.c_pressure(_flt_cond.q0());
+            else
+                dp_dx(j) = delta_p_sol.dp;
+        }
+        
+        dp_dx *= a(i);
+        
+        _transfer->add_interpolation_transpose(pts[i], dp_dx, vec_re, vec_im);
+    }
+}
+
+
+
+
+void
+MAST::FrequencyDomainPressureFunction::
+_interpolate(const std::vector<libMesh::Point>& pts,
+             const libMesh::NumericVector<Real>& v,
+             libMesh::MeshFunction*              f,
+             RealMatrixX&                        sol) const {
+    
+    const unsigned int
+    n_vars = _system.system().n_vars();
+    
+    DenseRealVector
+    dv;
+    
+    RealVectorX
+    vec    = RealVectorX::Zero(n_vars);
+    
+    sol.setZero(n_vars, pts.size());
+    
+    for (unsigned int i=0; i<pts.size(); i++) {
+        
+        if (_transfer)
+            _transfer->interpolate(pts[i], v, vec);
+        else {
+            (*f)(pts[i], 0., dv);
+            MAST::copy(vec, dv);
+        }
+        
+        sol.col(i) = vec;
+    }
+}
+
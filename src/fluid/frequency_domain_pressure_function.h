@@ -37,6 +37,7 @@ namespace MAST {
     class FrequencyFunction;
     class SystemInitialization;
     class FlightCondition;
+    class MeshFieldTransferOperator;
     
     
     class FrequencyDomainPressureFunction:
@@ -60,6 +61,18 @@ namespace MAST {
         }
 
         
+        /*!
+         *   evaluates the steady and small-disturbance solutions with the
+         *   interpolation data of \p op, which is shared between the
+         *   frequencies and modes for which this function is initialized.
+         *   See MAST::PressureFunction::set_transfer_operator().
+         */
+        void set_transfer_operator(MAST::MeshFieldTransferOperator* op) {
+            
+            _transfer = op;
+        }
+        
+        
         /*!
          *   initiate the mesh function for this solution
          */
@@ -77,8 +90,65 @@ namespace MAST {
                     Complex& dp) const;
         
         
+        /*!
+         *   provides the complex pressure perturbation at all points in
+         *   \p pts. The primitive variables of all points are computed
+         *   together with MAST::PrimitiveSolutionBatch.
+         */
+        void
+        operator() (const std::vector<libMesh::Point>& pts,
+                    const Real t,
+                    ComplexVectorX& dp) const;
+        
+        
+        /*!
+         *   if \p f is true, the function does not use the fluid solution,
+         *   and returns a unit pressure for the \p k-th evaluation after
+         *   this call and zero for all other evaluations. The points of
+         *   all evaluations are stored, and are returned by probe_points().
+         *   Since the structural loads are linear in the pressure, this
+         *   gives the weight of the pressure at each point in a load. 
+         */
+        void set_probe(bool f, unsigned int k = 0);
+        
+        
+        /*!
+         *   @returns the points at which the function was evaluated
+         *   since the last call to set_probe()
+         */
+        const std::vector<libMesh::Point>& probe_points() const {
+            
+            return _probe_points;
+        }
+        
+        
+        /*!
+         *   adds the derivative of \f$ \sum_i a_i \delta p(x_i) \f$ with 
+         *   respect to the small-disturbance solution to \p vec_re and 
+         *   \p vec_im, where \f$ x_i \f$ and \f$ a_i \f$ are the points 
+         *   in \p pts and the complex weights in \p a. The pressure is 
+         *   linear in the small-disturbance solution about the steady 
+         *   solution provided to init(). This requires the transfer 
+         *   operator, which also provides the transpose of the 
+         *   interpolation. The vectors must be closed after this call.
+         */
+        void add_adjoint_load(const std::vector<libMesh::Point>& pts,
+                              const ComplexVectorX& a,
+                              libMesh::NumericVector<Real>& vec_re,
+                              libMesh::NumericVector<Real>& vec_im) const;
+        
+        
     protected:
         
+        /*!
+         *   interpolates \p v, with \p f if the transfer operator is not
+         *   used, at all points in \p pts into the columns of \p sol
+         */
+        void _interpolate(const std::vector<libMesh::Point>& pts,
+                          const libMesh::NumericVector<Real>& v,
+                          libMesh::MeshFunction* f,
+                          RealMatrixX& sol) const;
+        
         /*!
          *    the function will return cp instead of pressure if this option is
          *    true.
@@ -97,6 +167,12 @@ namespace MAST {
         MAST::FlightCondition&              _flt_cond;
         
         
+        /*!
+         *   operator used to interpolate the solution, if provided
+         */
+        MAST::MeshFieldTransferOperator*    _transfer;
+        
+        
         /*!
          *   mesh function that interpolates the solution
          */
@@ -120,6 +196,18 @@ namespace MAST {
          */
         std::auto_ptr<libMesh::NumericVector<Real> > _dsol_imag;
 
+        /*!
+         *   probe mode, and the index of the evaluation with a unit 
+         *   pressure
+         */
+        bool                                         _probe;
+        
+        unsigned int                                 _probe_index;
+        
+        /*!
+         *   points of the evaluations in probe mode
+         */
+        mutable std::vector<libMesh::Point>          _probe_points;
     };
 }
 
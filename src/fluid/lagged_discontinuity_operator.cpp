@@ -0,0 +1,135 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2017  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+// MAST includes
+#include "fluid/lagged_discontinuity_operator.h"
+
+
+MAST::LaggedDiscontinuityOperator::LaggedDiscontinuityOperator():
+update_interval(5),
+residual_reduction(1.e-2),
+_if_update(false),
+_if_update_due(true),
+_n_jac(0),
+_update_residual_norm(-1.)
+{ }
+
+
+
+MAST::LaggedDiscontinuityOperator::~LaggedDiscontinuityOperator()
+{ }
+
+
+
+void
+MAST::LaggedDiscontinuityOperator::clear() {
+    
+    _dc.clear();
+    _if_update            = false;
+    _if_update_due        = true;
+    _n_jac                = 0;
+    _update_residual_norm = -1.;
+}
+
+
+
+void
+MAST::LaggedDiscontinuityOperator::begin_assembly(const libMesh::MeshBase& mesh,
+                                                  bool if_residual,
+                                                  bool if_jac) {
+    
+    if (if_jac)
+        _n_jac++;
+    
+    if (_n_jac > update_interval)
+        _if_update_due = true;
+    
+    // the coefficients are only updated with a residual evaluation, so
+    // that the next Jacobian is consistent with the residual
+    _if_update = (_if_update_due && if_residual) || _dc.empty();
+    
+    if (_if_update) {
+        
+        _dc.clear();
+        
+        // the elements only assign the values of these entries, which
+        // does not modify the map
+        libMesh::MeshBase::const_element_iterator
+        el     = mesh.active_local_elements_begin(),
+        end_el = mesh.active_local_elements_end();
+        
+        for ( ; el != end_el; el++)
+            _dc[*el];
+        
+        _if_update_due        = false;
+        _n_jac                = if_jac? 1: 0;
+        _update_residual_norm = -1.;
+    }
+}
+
+
+
+void
+MAST::LaggedDiscontinuityOperator::end_assembly(bool if_residual,
+                                                Real residual_norm) {
+    
+    _if_update = false;
+    
+    if (!if_residual)
+        return;
+    
+    if (_update_residual_norm < 0.)
+        _update_residual_norm = residual_norm;
+    else if (residual_norm <= residual_reduction * _update_residual_norm)
+        _if_update_due = true;
+}
+
+
+
+const std::vector<RealVectorX>*
+MAST::LaggedDiscontinuityOperator::values(const libMesh::Elem& e) const {
+    
+    if (_if_update)
+        return nullptr;
+    
+    std::map<const libMesh::Elem*, std::vector<RealVectorX> >::const_iterator
+    it = _dc.find(&e);
+    
+    if (it == _dc.end() || it->second.empty())
+        return nullptr;
+    
+    return &it->second;
+}
+
+
+
+void
+MAST::LaggedDiscontinuityOperator::set_values(const libMesh::Elem& e,
+                                              const std::vector<RealVectorX>& dc) {
+    
+    std::map<const libMesh::Elem*, std::vector<RealVectorX> >::iterator
+    it = _dc.find(&e);
+    
+    if (it == _dc.end())
+        libmesh_error_msg("Error: no entry for element in lagged discontinuity operator.");
+    
+    it->second = dc;
+}
+
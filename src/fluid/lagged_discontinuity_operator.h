@@ -0,0 +1,152 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2017  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+#ifndef __mast__lagged_discontinuity_operator__
+#define __mast__lagged_discontinuity_operator__
+
+// C++ includes
+#include <map>
+#include <vector>
+
+
+// MAST includes
+#include "base/mast_data_types.h"
+
+
+// libMesh includes
+#include "libmesh/elem.h"
+#include "libmesh/mesh_base.h"
+
+
+namespace MAST {
+    
+    
+    /*!
+     *    Stores the discontinuity capturing coefficients at the quadrature
+     *    points of the fluid elements, so that they can be frozen between
+     *    nonlinear iterations. The coefficients are recomputed by the
+     *    elements in the first residual evaluation after \p update_interval
+     *    Jacobian evaluations since the last update, or after the residual
+     *    norm has dropped below \p residual_reduction times its value at
+     *    the last update. In all other evaluations the stored values are
+     *    used, so that the residual is a smooth function of the solution, 
+     *    and the Jacobian, which does not include the derivatives of the
+     *    coefficients, is exact for the frozen operator.
+     *
+     *    The assembly calls begin_assembly() and end_assembly() around each
+     *    residual and Jacobian evaluation, see
+     *    MAST::ConservativeFluidTransientAssembly::set_lagged_discontinuity_operator().
+     *    clear() must be called if the mesh changes.
+     */
+    class LaggedDiscontinuityOperator {
+        
+    public:
+        
+        LaggedDiscontinuityOperator();
+        
+        virtual ~LaggedDiscontinuityOperator();
+        
+        /*!
+         *   number of Jacobian evaluations after which the coefficients
+         *   are updated. This is 5 by default.
+         */
+        unsigned int update_interval;
+        
+        /*!
+         *   the coefficients are updated if the residual norm is reduced by
+         *   this factor since the last update. This is 1.e-2 by default.
+         */
+        Real residual_reduction;
+        
+        /*!
+         *   clears the stored coefficients, so that they are recomputed in
+         *   the next residual evaluation
+         */
+        void clear();
+        
+        /*!
+         *   to be called at the beginning of an assembly on the elements
+         *   of \p mesh. \p if_residual and \p if_jac identify the
+         *   quantities being assembled. If the coefficients are updated,
+         *   the entries of all local elements are created here, so that
+         *   set_values() can be called from the threads of the assembly.
+         */
+        void begin_assembly(const libMesh::MeshBase& mesh,
+                            bool if_residual,
+                            bool if_jac);
+        
+        /*!
+         *   to be called at the end of an assembly with the norm of the
+         *   assembled residual, if a residual was assembled.
+         */
+        void end_assembly(bool if_residual, Real residual_norm);
+        
+        /*!
+         *   @returns \p true if the coefficients are being recomputed in 
+         *   the current assembly
+         */
+        bool if_update() const {
+            return _if_update;
+        }
+        
+        /*!
+         *   @returns a pointer to the coefficients stored for \p e, or
+         *   nullptr if these are not available or are being updated.
+         */
+        const std::vector<RealVectorX>* values(const libMesh::Elem& e) const;
+        
+        /*!
+         *   stores the coefficients computed by the element for \p e in
+         *   the entry created by begin_assembly().
+         */
+        void set_values(const libMesh::Elem& e,
+                        const std::vector<RealVectorX>& dc);
+        
+    protected:
+        
+        /*!
+         *   \p true if the coefficients are updated in the current assembly
+         */
+        bool _if_update;
+        
+        /*!
+         *   \p true if an update is due in the next residual evaluation
+         */
+        bool _if_update_due;
+        
+        /*!
+         *   number of Jacobian evaluations since the last update
+         */
+        unsigned int _n_jac;
+        
+        /*!
+         *   residual norm at the last update. This is negative before the
+         *   first residual evaluation after an update.
+         */
+        Real _update_residual_norm;
+        
+        /*!
+         *   coefficients at the quadrature points of each element
+         */
+        std::map<const libMesh::Elem*, std::vector<RealVectorX> > _dc;
+    };
+}
+
+#endif // __mast__lagged_discontinuity_operator__
@@ -23,9 +23,11 @@
 #include "fluid/conservative_fluid_system_initialization.h"
 #include "numerics/utility.h"
 #include "fluid/primitive_fluid_solution.h"
+#include "fluid/primitive_fluid_solution_batch.h"
 #include "fluid/small_disturbance_primitive_fluid_solution.h"
 #include "fluid/flight_condition.h"
 #include "base/nonlinear_system.h"
+#include "base/mesh_field_transfer_operator.h"
 
 
 // libMesh includes
@@ -41,7 +43,8 @@ MAST::FieldFunction<Real>("pressure"),
 _if_cp            (false),
 _ref_pressure     (0.),
 _system           (sys),
-_flt_cond         (flt) {
+_flt_cond         (flt),
+_transfer         (nullptr) {
     
 }
 
@@ -62,36 +65,42 @@ init(const libMesh::NumericVector<Real>& steady_sol,
     
     MAST::NonlinearSystem& sys = _system.system();
     
-    // first initialize the solution to the given vector
-    // steady state solution
-    _sol.reset(libMesh::NumericVector<Real>::build(sys.comm()).release());
-    _sol->init(steady_sol.size(), true, libMesh::SERIAL);
-    
-    // now localize the give solution to this objects's vector
-    steady_sol.localize(*_sol);
-    
-    
-    // if the mesh function has not been created so far, initialize it
-    _sol_function.reset(new libMesh::MeshFunction(sys.get_equation_systems(),
-                                                  *_sol,
-                                                  sys.get_dof_map(),
-                                                  _system.vars()));
-    _sol_function->init();
+    // first localize the steady state solution to the values needed for
+    // interpolation, which is only the ghosted part for a distributed mesh
+    _sol.reset(MAST::build_localized_interpolation_vector(_system,
+                                                          steady_sol,
+                                                          _transfer));
+    
+    
+    // if the mesh function has not been created so far, initialize it.
+    // This is not needed if the transfer operator is used.
+    if (!_transfer) {
+        _sol_function.reset(new libMesh::MeshFunction(sys.get_equation_systems(),
+                                                      *_sol,
+                                                      sys.get_dof_map(),
+                                                      _system.vars()));
+        _sol_function->init();
+    }
+    else
+        _sol_function.reset();
     
     
     if (small_dist_sol) {
         
         // solution real part
-        _dsol.reset(libMesh::NumericVector<Real>::build(sys.comm()).release());
-        _dsol->init(steady_sol.size(), true, libMesh::SERIAL);
+        _dsol.reset(MAST::build_localized_interpolation_vector(_system,
+                                                               *small_dist_sol,
+                                                               _transfer));
         
-        small_dist_sol->localize(*_dsol);
-        
-        _dsol_function.reset(new libMesh::MeshFunction(sys.get_equation_systems(),
-                                                       *_dsol,
-                                                       sys.get_dof_map(),
-                                                       _system.vars()));
-        _dsol_function->init();
+        if (!_transfer) {
+            _dsol_function.reset(new libMesh::MeshFunction(sys.get_equation_systems(),
+                                                           *_dsol,
+                                                           sys.get_dof_map(),
+                                                           _system.vars()));
+            _dsol_function->init();
+        }
+        else
+            _dsol_function.reset();
     }
     else {
         
@@ -112,7 +121,7 @@ operator() (const libMesh::Point& p,
             Real                  &press) const {
     
     
-    libmesh_assert(_sol_function.get()); // should be initialized before this call
+    libmesh_assert(_sol.get()); // should be initialized before this call
     
     press  = 0.;
     
@@ -126,8 +135,12 @@ operator() (const libMesh::Point& p,
     
     
     // now the steady state function itself
-    (*_sol_function)(p, 0., v);
-    MAST::copy(sol, v);
+    if (_transfer)
+        _transfer->interpolate(p, *_sol, sol);
+    else {
+        (*_sol_function)(p, 0., v);
+        MAST::copy(sol, v);
+    }
     
     
     MAST::PrimitiveSolution                     p_sol;
@@ -156,8 +169,8 @@ perturbation(const libMesh::Point& p,
              Real                  &dpress) const {
     
     
-    libmesh_assert(_sol_function.get()); // should be initialized before this call
-    libmesh_assert(_dsol_function.get()); // should be initialized before this call
+    libmesh_assert(_sol.get()); // should be initialized before this call
+    libmesh_assert(_dsol.get()); // should be initialized before this call
     
     dpress = 0.;
     
@@ -172,13 +185,21 @@ perturbation(const libMesh::Point& p,
     
     
     // first copy the real and imaginary solutions
-    (*_dsol_function)(p, 0., v);
-    MAST::copy(sol, v);
-    dsol = sol;
-    
-    // now the steady state function itself
-    (*_sol_function)(p, 0., v);
-    MAST::copy(sol, v);
+    if (_transfer) {
+        
+        _transfer->interpolate(p, *_dsol, dsol);
+        _transfer->interpolate(p, *_sol, sol);
+    }
+    else {
+        
+        (*_dsol_function)(p, 0., v);
+        MAST::copy(sol, v);
+        dsol = sol;
+        
+        // now the steady state function itself
+        (*_sol_function)(p, 0., v);
+        MAST::copy(sol, v);
+    }
     
     
     MAST::PrimitiveSolution                     p_sol;
@@ -199,3 +220,102 @@ perturbation(const libMesh::Point& p,
         dpress    =  delta_p_sol.dp;
 }
 
+
+
+
+void
+MAST::PressureFunction::
+operator() (const std::vector<libMesh::Point>& pts,
+            const Real                         t,
+            RealVectorX&                       press) const {
+    
+    libmesh_assert(_sol.get()); // should be initialized before this call
+    
+    RealMatrixX
+    sol;
+    
+    _interpolate(pts, *_sol, _sol_function.get(), sol);
+    
+    MAST::PrimitiveSolutionBatch                p_sol;
+    
+    p_sol.init(dynamic_cast<MAST::ConservativeFluidSystemInitialization&>(_system).dim(),
+               sol,
+               _flt_cond.gas_property.cp,
+               _flt_cond.gas_property.cv,
+               false);
+    
+    if (_if_cp)
+        press     = p_sol.c_pressure(_flt_cond.p0(), _flt_cond.q0()).matrix();
+    else
+        press     = (p_sol.p - _ref_pressure).matrix();
+}
+
+
+
+
+void
+MAST::PressureFunction::
+perturbation(const std::vector<libMesh::Point>& pts,
+             const Real                         t,
+             RealVectorX&                       dpress) const {
+    
+    libmesh_assert(_sol.get()); // should be initialized before this call
+    libmesh_assert(_dsol.get()); // should be initialized before this call
+    
+    RealMatrixX
+    sol,
+    dsol;
+    
+    _interpolate(pts,  *_sol,  _sol_function.get(), sol);
+    _interpolate(pts, *_dsol, _dsol_function.get(), dsol);
+    
+    MAST::PrimitiveSolutionBatch                             p_sol;
+    MAST::SmallPerturbationPrimitiveSolutionBatch<Real>      delta_p_sol;
+    
+    p_sol.init(dynamic_cast<MAST::ConservativeFluidSystemInitialization&>(_system).dim(),
+               sol,
+               _flt_cond.gas_property.cp,
+               _flt_cond.gas_property.cv,
+               false);
+    delta_p_sol.init(p_sol, dsol);
+    
+    if (_if_cp)
+        dpress    = delta_p_sol.c_pressure(_flt_cond.q0()).matrix();
+    else
+        dpress    = delta_p_sol.dp.matrix();
+}
+
+
+
+
+void
+MAST::PressureFunction::
+_interpolate(const std::vector<libMesh::Point>& pts,
+             const libMesh::NumericVector<Real>& v,
+             libMesh::MeshFunction*              f,
+             RealMatrixX&                        sol) const {
+    
+    const unsigned int
+    n_vars = _system.system().n_vars();
+    
+    DenseRealVector
+    dv;
+    
+    RealVectorX
+    vec    = RealVectorX::Zero(n_vars);
+    
+    sol.setZero(n_vars, pts.size());
+    
+    for (unsigned int i=0; i<pts.size(); i++) {
+        
+        if (_transfer)
+            _transfer->interpolate(pts[i], v, vec);
+        else {
+            (*f)(pts[i], 0., dv);
+            MAST::copy(vec, dv);
+        }
+        
+        sol.col(i) = vec;
+    }
+}
+
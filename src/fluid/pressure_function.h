@@ -37,6 +37,7 @@ namespace MAST {
     class FrequencyFunction;
     class SystemInitialization;
     class FlightCondition;
+    class MeshFieldTransferOperator;
     
     
     class PressureFunction:
@@ -72,6 +73,20 @@ namespace MAST {
         }
 
         
+        /*!
+         *   tells the function to interpolate the fluid solution with
+         *   \p op, instead of libMesh::MeshFunction. The operator retains
+         *   the interpolation data of the points between calls to init(),
+         *   and must be for the same system as this function. A nullptr
+         *   restores the use of libMesh::MeshFunction. This takes effect
+         *   at the next call to init().
+         */
+        void set_transfer_operator(MAST::MeshFieldTransferOperator* op) {
+            
+            _transfer = op;
+        }
+        
+        
         /*!
          *   initiate the mesh function for this solution
          */
@@ -98,8 +113,39 @@ namespace MAST {
                      Real& dpress) const;
 
         
+        /*!
+         *   provides the pressure at all points in \p pts. The primitive
+         *   variables of all points are computed together with
+         *   MAST::PrimitiveSolutionBatch.
+         */
+        void
+        operator() (const std::vector<libMesh::Point>& pts,
+                    const Real t,
+                    RealVectorX& press) const;
+        
+        
+        /*!
+         *   provides the pressure perturbation at all points in \p pts.
+         *   The user must have initialized the perturbed solution using
+         *   the appropriate init routine.
+         */
+        void
+        perturbation(const std::vector<libMesh::Point>& pts,
+                     const Real t,
+                     RealVectorX& dpress) const;
+        
+        
     protected:
 
+        /*!
+         *   interpolates \p v, with \p f if the transfer operator is not
+         *   used, at all points in \p pts into the columns of \p sol
+         */
+        void _interpolate(const std::vector<libMesh::Point>& pts,
+                          const libMesh::NumericVector<Real>& v,
+                          libMesh::MeshFunction* f,
+                          RealMatrixX& sol) const;
+
         /*!
          *    the function will return cp instead of pressure if this option is
          *    true.
@@ -124,6 +170,12 @@ namespace MAST {
         MAST::FlightCondition&              _flt_cond;
         
         
+        /*!
+         *   operator used to interpolate the solution, if provided
+         */
+        MAST::MeshFieldTransferOperator*    _transfer;
+        
+        
         /*!
          *   mesh function that interpolates the solution
          */
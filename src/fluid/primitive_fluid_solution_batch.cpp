@@ -0,0 +1,264 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2017  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+// MAST includes
+#include "fluid/primitive_fluid_solution_batch.h"
+#include "fluid/primitive_fluid_solution.h"
+#include "fluid/small_disturbance_primitive_fluid_solution.h"
+
+
+MAST::PrimitiveSolutionBatch::PrimitiveSolutionBatch():
+dimension  (0),
+if_viscous (false),
+cp         (0.),
+cv         (0.),
+Pr         (0.72) {
+    
+}
+
+
+
+void
+MAST::PrimitiveSolutionBatch::init(const unsigned int dim,
+                                   const RealMatrixX& conservative_sol,
+                                   const Real cp_val,
+                                   const Real cv_val,
+                                   bool if_visc) {
+    
+    libmesh_assert_equal_to(conservative_sol.rows(), dim+2);
+    
+    dimension  = dim;
+    if_viscous = if_visc;
+    cp         = cp_val;
+    cv         = cv_val;
+    
+    const unsigned int
+    n1 = dim+2,
+    n  = (unsigned int)conservative_sol.cols();
+    
+    const Real
+    R     = cp-cv,
+    gamma = cp/cv;
+    
+    rho = conservative_sol.row(0).transpose().array();
+    
+    // the inverse of the density is shared by the conversions
+    const ArrayType
+    rho_inv = rho.inverse();
+    
+    u1 = conservative_sol.row(1).transpose().array() * rho_inv;
+    k  = u1.square();
+    
+    if (dim > 1) {
+        u2  = conservative_sol.row(2).transpose().array() * rho_inv;
+        k  += u2.square();
+    }
+    else
+        u2.setZero(n);
+    
+    if (dim > 2) {
+        u3  = conservative_sol.row(3).transpose().array() * rho_inv;
+        k  += u3.square();
+    }
+    else
+        u3.setZero(n);
+    
+    k *= 0.5;
+    
+    e_tot   = conservative_sol.row(n1-1).transpose().array() * rho_inv;
+    T       = (e_tot - k)/cv;
+    p       = R*T*rho;
+    a       = (gamma*R*T).sqrt();
+    mach    = (2.*k).sqrt()/a;
+    entropy = p.log() - gamma*rho.log();
+    
+    // viscous quantities
+    if (if_viscous) {
+        
+        mu        = 1.458e-6 * T * T.sqrt()/(T+110.4);
+        lambda    = -2./3.*mu;
+        k_thermal = mu*cp/Pr;
+    }
+    else {
+        
+        mu.setZero(n);
+        lambda.setZero(n);
+        k_thermal.setZero(n);
+    }
+}
+
+
+
+void
+MAST::PrimitiveSolutionBatch::get_solution(const unsigned int i,
+                                           MAST::PrimitiveSolution& sol) const {
+    
+    libmesh_assert_less(i, n_points());
+    
+    const unsigned int n1 = dimension+2;
+    
+    sol.dimension = dimension;
+    sol.cp        = cp;
+    sol.cv        = cv;
+    sol.rho       = rho(i);
+    sol.u1        = u1(i);
+    sol.u2        = u2(i);
+    sol.u3        = u3(i);
+    sol.T         = T(i);
+    sol.p         = p(i);
+    sol.a         = a(i);
+    sol.e_tot     = e_tot(i);
+    sol.k         = k(i);
+    sol.entropy   = entropy(i);
+    sol.mach      = mach(i);
+    sol.Pr        = Pr;
+    sol.k_thermal = k_thermal(i);
+    sol.mu        = mu(i);
+    sol.lambda    = lambda(i);
+    
+    sol.primitive_sol.resize(n1);
+    sol.primitive_sol(0) = rho(i);
+    sol.primitive_sol(1) = u1(i);
+    if (dimension > 1)
+        sol.primitive_sol(2) = u2(i);
+    if (dimension > 2)
+        sol.primitive_sol(3) = u3(i);
+    sol.primitive_sol(n1-1) = T(i);
+}
+
+
+
+
+template <typename ValType>
+MAST::SmallPerturbationPrimitiveSolutionBatch<ValType>::
+SmallPerturbationPrimitiveSolutionBatch():
+primitive_sol(nullptr) {
+    
+}
+
+
+
+template <typename ValType>
+void
+MAST::SmallPerturbationPrimitiveSolutionBatch<ValType>::
+init(const MAST::PrimitiveSolutionBatch& sol,
+     const typename MatrixType<ValType>::return_type& delta_sol) {
+    
+    primitive_sol = &sol;
+    
+    const unsigned int
+    dim = sol.dimension,
+    n1  = dim+2,
+    n   = sol.n_points();
+    
+    libmesh_assert_equal_to(delta_sol.rows(), n1);
+    libmesh_assert_equal_to(delta_sol.cols(), n);
+    
+    const Real
+    R     = sol.cp-sol.cv,
+    gamma = sol.cp/sol.cv;
+    
+    // the real quantities of the base solution are cast once to the
+    // scalar type of the perturbation
+    const ArrayType
+    rho_inv = sol.rho.inverse().template cast<ValType>(),
+    rho     = sol.rho.template cast<ValType>(),
+    u1      = sol.u1.template cast<ValType>(),
+    u2      = sol.u2.template cast<ValType>(),
+    u3      = sol.u3.template cast<ValType>(),
+    T       = sol.T.template cast<ValType>(),
+    e_tot   = sol.e_tot.template cast<ValType>(),
+    sqrt_2k = (2.*sol.k).sqrt().template cast<ValType>(),
+    a       = sol.a.template cast<ValType>(),
+    da_dT   = (0.5*(gamma*R/sol.T).sqrt()).template cast<ValType>();
+    
+    drho = delta_sol.row(0).transpose().array();
+    
+    du1  = (delta_sol.row(1).transpose().array() - drho * u1) * rho_inv;
+    dk   = u1 * du1;
+    
+    if (dim > 1) {
+        du2  = (delta_sol.row(2).transpose().array() - drho * u2) * rho_inv;
+        dk  += u2 * du2;
+    }
+    else
+        du2.setZero(n);
+    
+    if (dim > 2) {
+        du3  = (delta_sol.row(3).transpose().array() - drho * u3) * rho_inv;
+        dk  += u3 * du3;
+    }
+    else
+        du3.setZero(n);
+    
+    de_tot   = (delta_sol.row(n1-1).transpose().array() - drho * e_tot) * rho_inv;
+    dT       = (de_tot - dk)/sol.cv;
+    dp       = R*(dT*rho + T*drho);
+    da       = da_dT*dT;
+    dmach    = dk/sqrt_2k/a - sqrt_2k/a.square() * da;
+    
+    // d(log(p/rho^gamma)) = dp/p - gamma drho/rho
+    dentropy = dp/sol.p.template cast<ValType>() - gamma*drho*rho_inv;
+}
+
+
+
+template <typename ValType>
+void
+MAST::SmallPerturbationPrimitiveSolutionBatch<ValType>::
+get_solution(const unsigned int i,
+             const MAST::PrimitiveSolution& sol,
+             MAST::SmallPerturbationPrimitiveSolution<ValType>& dsol) const {
+    
+    libmesh_assert_less(i, n_points());
+    
+    const unsigned int
+    dim = primitive_sol->dimension,
+    n1  = dim+2;
+    
+    dsol.primitive_sol = &sol;
+    dsol.drho          = drho(i);
+    dsol.du1           = du1(i);
+    dsol.du2           = du2(i);
+    dsol.du3           = du3(i);
+    dsol.dT            = dT(i);
+    dsol.dp            = dp(i);
+    dsol.da            = da(i);
+    dsol.de_tot        = de_tot(i);
+    dsol.dk            = dk(i);
+    dsol.dentropy      = dentropy(i);
+    dsol.dmach         = dmach(i);
+    
+    dsol.perturb_primitive_sol.resize(n1);
+    dsol.perturb_primitive_sol(0) = drho(i);
+    dsol.perturb_primitive_sol(1) = du1(i);
+    if (dim > 1)
+        dsol.perturb_primitive_sol(2) = du2(i);
+    if (dim > 2)
+        dsol.perturb_primitive_sol(3) = du3(i);
+    dsol.perturb_primitive_sol(n1-1) = dT(i);
+}
+
+
+
+// explicit instantiations for real and complex type
+template class MAST::SmallPerturbationPrimitiveSolutionBatch<Real>;
+template class MAST::SmallPerturbationPrimitiveSolutionBatch<Complex>;
+
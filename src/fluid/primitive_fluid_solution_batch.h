@@ -0,0 +1,197 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2017  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+#ifndef __mast__primitive_fluid_solution_batch_h__
+#define __mast__primitive_fluid_solution_batch_h__
+
+// MAST includes
+#include "base/mast_data_types.h"
+
+
+namespace MAST {
+    
+    // Forward declerations
+    class PrimitiveSolution;
+    template <typename ValType> class SmallPerturbationPrimitiveSolution;
+    
+    
+    /*!
+     *   Computes the primitive variables of \p MAST::PrimitiveSolution
+     *   for a batch of points, for example all quadrature points of an
+     *   element. Each quantity is stored as an array over the points
+     *   (structure-of-arrays), and is computed for all points with a
+     *   single Eigen array expression, so that the divisions, square roots
+     *   and logarithms of the conversion vectorize over the points. The
+     *   solution at point \p i is copied to a \p MAST::PrimitiveSolution
+     *   with get_solution() for the routines that operate on one point.
+     */
+    class PrimitiveSolutionBatch {
+        
+    public:
+        
+        typedef Eigen::Array<Real, Eigen::Dynamic, 1> ArrayType;
+        
+        PrimitiveSolutionBatch();
+        
+        /*!
+         *   initializes the primitive variables from the conservative
+         *   solution \p conservative_sol, which has \p dim+2 rows and one
+         *   column for each point.
+         */
+        void init(const unsigned int dim,
+                  const RealMatrixX& conservative_sol,
+                  const Real cp_val,
+                  const Real cv_val,
+                  bool if_viscous);
+        
+        /*!
+         *   @returns the number of points in the batch
+         */
+        unsigned int n_points() const {
+            return (unsigned int)rho.size();
+        }
+        
+        /*!
+         *   copies the primitive solution at point \p i to \p sol
+         */
+        void get_solution(const unsigned int i,
+                          MAST::PrimitiveSolution& sol) const;
+        
+        /*!
+         *   @returns the pressure coefficient at all points
+         */
+        ArrayType c_pressure(const Real p0, const Real q0) const {
+            return (p-p0)/q0;
+        }
+        
+        unsigned int dimension;
+        
+        bool         if_viscous;
+        
+        Real cp;
+        
+        Real cv;
+        
+        Real Pr;
+        
+        ArrayType rho;
+        
+        ArrayType u1;
+        
+        ArrayType u2;
+        
+        ArrayType u3;
+        
+        ArrayType T;
+        
+        ArrayType p;
+        
+        ArrayType a;
+        
+        ArrayType e_tot;
+        
+        ArrayType k;
+        
+        ArrayType entropy;
+        
+        ArrayType mach;
+        
+        // viscous quantities
+        ArrayType k_thermal;
+        
+        ArrayType mu;
+        
+        ArrayType lambda;
+    };
+    
+    
+    
+    /*!
+     *   Computes the small disturbance primitive variables of
+     *   \p MAST::SmallPerturbationPrimitiveSolution for a batch of points
+     *   about the primitive solution of a \p MAST::PrimitiveSolutionBatch,
+     *   with one array expression per quantity.
+     */
+    template <typename ValType>
+    class SmallPerturbationPrimitiveSolutionBatch {
+        
+    public:
+        
+        typedef Eigen::Array<ValType, Eigen::Dynamic, 1> ArrayType;
+        
+        SmallPerturbationPrimitiveSolutionBatch();
+        
+        /*!
+         *   initializes the perturbation about \p sol from the perturbation
+         *   in the conservative solution, \p delta_sol, which has one column
+         *   for each point of \p sol.
+         */
+        void init(const MAST::PrimitiveSolutionBatch& sol,
+                  const typename MatrixType<ValType>::return_type& delta_sol);
+        
+        /*!
+         *   @returns the number of points in the batch
+         */
+        unsigned int n_points() const {
+            return (unsigned int)drho.size();
+        }
+        
+        /*!
+         *   copies the perturbation at point \p i to \p dsol, which refers
+         *   to \p sol for the primitive solution at the point
+         */
+        void get_solution(const unsigned int i,
+                          const MAST::PrimitiveSolution& sol,
+                          MAST::SmallPerturbationPrimitiveSolution<ValType>& dsol) const;
+        
+        /*!
+         *   @returns the pressure coefficient perturbation at all points
+         */
+        ArrayType c_pressure(const Real q0) const {
+            return dp/q0;
+        }
+        
+        ArrayType drho;
+        
+        ArrayType du1;
+        
+        ArrayType du2;
+        
+        ArrayType du3;
+        
+        ArrayType dT;
+        
+        ArrayType dp;
+        
+        ArrayType da;
+        
+        ArrayType de_tot;
+        
+        ArrayType dk;
+        
+        ArrayType dentropy;
+        
+        ArrayType dmach;
+        
+        const MAST::PrimitiveSolutionBatch* primitive_sol;
+    };
+}
+
+#endif // __mast__primitive_fluid_solution_batch_h__
@@ -20,6 +20,13 @@
 
 // MAST includes
 #include "fluid/surface_integrated_pressure_output.h"
+#include "fluid/primitive_fluid_solution.h"
+#include "fluid/flight_condition.h"
+#include "base/boundary_side_index.h"
+
+
+// libMesh includes
+#include "libmesh/numeric_vector.h"
 
 
 
@@ -72,6 +79,58 @@ set_output_mode(MAST::SurfaceIntegratedPressureOutput::OutputMode o,
 
     
 
+void
+MAST::SurfaceIntegratedPressureOutput::
+calculate_load(const MAST::BoundarySideIndex& index,
+               const libMesh::NumericVector<Real>& sol,
+               const MAST::FlightCondition& flt,
+               const unsigned int dim) {
+    
+    _load.setZero(3);
+    
+    RealMatrixX
+    qp_sol;
+    
+    RealVectorX
+    vec1_n1;
+    
+    MAST::PrimitiveSolution
+    primitive_sol;
+    
+    for (unsigned int i=0; i<index.n_sides(); i++) {
+        
+        const MAST::BoundarySideIndex::Side& side = index.side(i);
+        
+        // the load is summed over processors after this loop
+        if (!side.local)
+            continue;
+        
+        index.qp_values(i, sol, qp_sol);
+        
+        for (unsigned int qp=0; qp<side.JxW.size(); qp++) {
+            
+            vec1_n1 = qp_sol.col(qp);
+            
+            primitive_sol.zero();
+            primitive_sol.init(dim,
+                               vec1_n1,
+                               flt.gas_property.cp,
+                               flt.gas_property.cv,
+                               false);
+            
+            for (unsigned int i_dim=0; i_dim<dim; i_dim++)
+                _load(i_dim) += side.JxW[qp] * primitive_sol.p * side.normals[qp](i_dim);
+        }
+    }
+    
+    std::vector<Real> v(_load.data(), _load.data()+3);
+    sol.comm().sum(v);
+    for (unsigned int i=0; i<3; i++)
+        _load(i) = v[i];
+}
+
+
+
 Real
 MAST::SurfaceIntegratedPressureOutput::
 value() const {
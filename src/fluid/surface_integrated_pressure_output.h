@@ -34,6 +34,8 @@ namespace MAST {
     
     // Forward declerations
     class FunctionBase;
+    class BoundarySideIndex;
+    class FlightCondition;
     
     
     /*!
@@ -89,6 +91,20 @@ namespace MAST {
         }
         
 
+        /*!
+         *   calculates the load integrated over the local sides of
+         *   \p index from the localized solution \p sol, and sums it over
+         *   all processors of \p sol. This only visits the boundary sides
+         *   stored in the index, instead of all elements of the mesh.
+         *   \p dim is the spatial dimension of the fluid system. This is
+         *   called by MAST::ConservativeFluidTransientAssembly::calculate_outputs().
+         */
+        void calculate_load(const MAST::BoundarySideIndex& index,
+                            const libMesh::NumericVector<Real>& sol,
+                            const MAST::FlightCondition& flt,
+                            const unsigned int dim);
+        
+
         /*!
          *    @returns the output functional
          */
@@ -32,6 +32,7 @@
 #include "mesh/local_3d_elem.h"
 #include "base/mesh_field_function.h"
 #include "base/nonlinear_system.h"
+#include "base/performance_log.h"
 
 
 MAST::HeatConductionElementBase::
@@ -85,6 +86,8 @@ MAST::HeatConductionElementBase::internal_residual (bool request_jacobian,
                                                     RealVectorX& f,
                                                     RealMatrixX& jac) {
     
+    MAST_LOG_SCOPE("internal_residual()", "HeatConductionElementBase");
+    
     const std::vector<Real>& JxW           = _fe->get_JxW();
     const std::vector<libMesh::Point>& xyz = _fe->get_xyz();
     const unsigned int
@@ -185,11 +188,162 @@ MAST::HeatConductionElementBase::internal_residual (bool request_jacobian,
 
 
 
+bool
+MAST::HeatConductionElementBase::
+internal_and_velocity_residual (bool request_jacobian,
+                                RealVectorX& f_x,
+                                RealMatrixX& jac_x,
+                                RealVectorX& f_m,
+                                RealMatrixX& jac_xdot,
+                                RealMatrixX& jac_m) {
+    
+    MAST_LOG_SCOPE("internal_and_velocity_residual()", "HeatConductionElementBase");
+    
+    const std::vector<Real>& JxW           = _fe->get_JxW();
+    const std::vector<libMesh::Point>& xyz = _fe->get_xyz();
+    const unsigned int
+    n_phi  = _fe->n_shape_functions(),
+    dim    = _elem.dim();
+    
+    RealMatrixX
+    material_mat   = RealMatrixX::Zero(dim, dim),
+    dmaterial_mat  = RealMatrixX::Zero(dim, dim),
+    mat_n2n2       = RealMatrixX::Zero(n_phi, n_phi),
+    cap            = RealMatrixX::Zero(n_phi, n_phi),
+    dcap           = RealMatrixX::Zero(n_phi, n_phi);
+    RealVectorX
+    vec1     = RealVectorX::Zero(1),
+    T        = RealVectorX::Zero(1),
+    vec2_n2  = RealVectorX::Zero(n_phi),
+    flux     = RealVectorX::Zero(dim),
+    dT       = RealVectorX::Zero(dim);
+    
+    std::auto_ptr<MAST::FieldFunction<RealMatrixX> >
+    conductance = _property.thermal_conductance_matrix(*this),
+    capacitance = _property.thermal_capacitance_matrix(*this);
+    
+    libMesh::Point p;
+    std::vector<MAST::FEMOperatorMatrix> dBmat(dim);
+    MAST::FEMOperatorMatrix Bmat;
+    
+    for (unsigned int qp=0; qp<JxW.size(); qp++) {
+        
+        // the operators, the solution and its gradient, and the location
+        // are shared by the conductance and capacitance terms
+        _initialize_mass_fem_operator(qp, *_fe, Bmat);
+        Bmat.right_multiply(T, _sol);
+        
+        if (_active_sol_function)
+            dynamic_cast<MAST::MeshFieldFunction*>
+            (_active_sol_function)->set_element_quadrature_point_solution(T);
+        
+        _local_elem->global_coordinates_location(xyz[qp], p);
+        
+        _initialize_fem_gradient_operator(qp, dim, *_fe, dBmat);
+        
+        for (unsigned int j=0; j<dim; j++) {
+            dBmat[j].right_multiply(vec1, _sol);        // dT_dxj
+            dT(j) = vec1(0);
+        }
+        
+        // conductance term
+        (*conductance)(p, _time, material_mat);
+        
+        flux = material_mat * dT;                       // q_i = k_ij dT_dxj
+        
+        for (unsigned int i=0; i<dim; i++) {
+            vec1(0)  = flux(i);
+            dBmat[i].vector_mult_transpose(vec2_n2, vec1);
+            f_x += JxW[qp] * vec2_n2;
+        }
+        
+        if (request_jacobian) {
+            
+            // Jacobian contribution from int_omega dB_dxi^T k_ij dB_dxj
+            for (unsigned int i=0; i<dim; i++)
+                for (unsigned int j=0; j<dim; j++) {
+                    
+                    dBmat[i].right_multiply_transpose(mat_n2n2, dBmat[j]);
+                    jac_x += JxW[qp] * material_mat(i,j) * mat_n2n2;
+                }
+            
+            // Jacobian contribution from int_omega dB_dxi dT_dxj dk_ij/dT B
+            if (_active_sol_function) {
+                
+                conductance->derivative(        *_active_sol_function,
+                                        p,
+                                        _time, dmaterial_mat);
+                
+                for (unsigned int j=0; j<dim; j++)
+                    for (unsigned int i=0; i<dim; i++)
+                        if (dmaterial_mat(i,j) != 0.) { // no need to process for zero terms
+                            // dB_dxi^T B
+                            dBmat[i].right_multiply_transpose(mat_n2n2, Bmat);
+                            // dB_dxi^T (dT_dxj dk_ij/dT) B
+                            jac_x += JxW[qp] * dT(j) * dmaterial_mat(i,j) * mat_n2n2;
+                        }
+            }
+        }
+        
+        // capacitance term
+        (*capacitance)(p, _time, material_mat);
+        
+        Bmat.right_multiply_transpose(mat_n2n2, Bmat);  // B^T B
+        cap += JxW[qp] * material_mat(0,0) * mat_n2n2;  // B^T B * JxW (rho*cp)
+        
+        // Jacobian contribution from int_omega B T d(rho*cp)/dT B
+        if (request_jacobian && _active_sol_function) {
+            
+            capacitance->derivative(        *_active_sol_function,
+                                    p,
+                                    _time, material_mat);
+            
+            if (material_mat(0,0) != 0.) // no need to process for zero terms
+                dcap += JxW[qp] * T(0) * material_mat(0,0) * mat_n2n2;
+        }
+    }
+    
+    // row-sum lumping of the capacitance, as in velocity_residual()
+    if (_property.if_diagonal_mass_matrix()) {
+        
+        for (unsigned int i=0; i<n_phi; i++) {
+            
+            const Real
+            c  = cap.row(i).sum(),
+            dc = dcap.row(i).sum();
+            
+            cap.row(i).setZero();
+            dcap.row(i).setZero();
+            cap(i, i)  = c;
+            dcap(i, i) = dc;
+        }
+    }
+    
+    f_m += cap * _vel;
+    
+    if (request_jacobian) {
+        
+        jac_xdot += cap;
+        jac_m    += dcap;
+    }
+    
+    if (_active_sol_function)
+        dynamic_cast<MAST::MeshFieldFunction*>
+        (_active_sol_function)->clear_element_quadrature_point_solution();
+    
+    return request_jacobian;
+}
+
+
+
+
 bool
 MAST::HeatConductionElementBase::velocity_residual (bool request_jacobian,
                                                     RealVectorX& f,
                                                     RealMatrixX& jac_xdot,
                                                     RealMatrixX& jac) {
+    MAST_LOG_SCOPE("velocity_residual()", "HeatConductionElementBase");
+    
     MAST::FEMOperatorMatrix Bmat;
     
     const std::vector<Real>& JxW                 = _fe->get_JxW();
@@ -201,10 +355,11 @@ MAST::HeatConductionElementBase::velocity_residual (bool request_jacobian,
     
     RealMatrixX
     material_mat    = RealMatrixX::Zero(dim, dim),
-    mat_n2n2        = RealMatrixX::Zero(n_phi, n_phi);
+    mat_n2n2        = RealMatrixX::Zero(n_phi, n_phi),
+    cap             = RealMatrixX::Zero(n_phi, n_phi),
+    dcap            = RealMatrixX::Zero(n_phi, n_phi);
     RealVectorX
-    vec1    = RealVectorX::Zero(1),
-    vec2_n2 = RealVectorX::Zero(n_phi);
+    vec1    = RealVectorX::Zero(1);
     
     std::auto_ptr<MAST::FieldFunction<RealMatrixX> > capacitance =
     _property.thermal_capacitance_matrix(*this);
@@ -224,32 +379,48 @@ MAST::HeatConductionElementBase::velocity_residual (bool request_jacobian,
         
         (*capacitance)(p, _time, material_mat);
         
-        Bmat.right_multiply(vec1, _vel);               //  B * T_dot
-        Bmat.vector_mult_transpose(vec2_n2, vec1);     //  B^T * B * T_dot
+        Bmat.right_multiply_transpose(mat_n2n2, Bmat);  // B^T B
+        cap += JxW[qp] * material_mat(0,0) * mat_n2n2;  // B^T B * JxW (rho*cp)
         
-        f      += JxW[qp] * material_mat(0,0) * vec2_n2; // (rho*cp)*JxW B^T B T_dot
-        
-        if (request_jacobian) {
+        // Jacobian contribution from int_omega B T d(rho*cp)/dT B
+        if (request_jacobian && _active_sol_function) {
+            // get derivative of the conductance matrix wrt temperature
+            capacitance->derivative(        *_active_sol_function,
+                                    p,
+                                    _time, material_mat);
             
-            Bmat.right_multiply_transpose(mat_n2n2, Bmat);  // B^T B
-            jac_xdot += JxW[qp] * material_mat(0,0) * mat_n2n2;  // B^T B * JxW (rho*cp)
-            
-            // Jacobian contribution from int_omega B T d(rho*cp)/dT B
-            if (_active_sol_function) {
-                // get derivative of the conductance matrix wrt temperature
-                capacitance->derivative(        *_active_sol_function,
-                                        p,
-                                        _time, material_mat);
+            if (material_mat(0,0) != 0.) { // no need to process for zero terms
                 
-                if (material_mat(0,0) != 0.) { // no need to process for zero terms
-                    
-                    // B^T (T d(rho cp)/dT) B
-                    jac += JxW[qp] * vec1(0) * material_mat(0,0) * mat_n2n2;
-                }
+                // B^T (T d(rho cp)/dT) B
+                dcap += JxW[qp] * vec1(0) * material_mat(0,0) * mat_n2n2;
             }
         }
     }
     
+    // row-sum lumping of the capacitance, which gives a diagonal
+    // capacitance for explicit time integration
+    if (_property.if_diagonal_mass_matrix()) {
+        
+        for (unsigned int i=0; i<n_phi; i++) {
+            
+            const Real
+            c  = cap.row(i).sum(),
+            dc = dcap.row(i).sum();
+            
+            cap.row(i).setZero();
+            dcap.row(i).setZero();
+            cap(i, i)  = c;
+            dcap(i, i) = dc;
+        }
+    }
+    
+    f      += cap * _vel;                              // (rho*cp)*JxW B^T B T_dot
+    
+    if (request_jacobian) {
+        
+        jac_xdot += cap;
+        jac      += dcap;
+    }
     
     if (_active_sol_function)
         dynamic_cast<MAST::MeshFieldFunction*>
@@ -268,12 +439,14 @@ side_external_residual (bool request_jacobian,
                         RealMatrixX& jac,
                         std::multimap<libMesh::boundary_id_type, MAST::BoundaryConditionBase*>& bc) {
     
+    MAST_LOG_SCOPE("side_external_residual()", "HeatConductionElementBase");
+    
     typedef std::multimap<libMesh::boundary_id_type, MAST::BoundaryConditionBase*> maptype;
     
     // iterate over the boundary ids given in the provided force map
     std::pair<maptype::const_iterator, maptype::const_iterator> it;
     
-    const libMesh::BoundaryInfo& binfo = *_system.system().get_mesh().boundary_info;
+    const MAST::ElementTopologyCache& topology = _system.system().topology_cache();
     
     // for each boundary id, check if any of the sides on the element
     // has the associated boundary
@@ -282,12 +455,12 @@ side_external_residual (bool request_jacobian,
         
         // if no boundary ids have been specified for the side, then
         // move to the next side.
-        if (!binfo.n_boundary_ids(&_elem, n))
+        if (!topology.n_boundary_ids(_elem, n))
             continue;
         
         // check to see if any of the specified boundary ids has a boundary
         // condition associated with them
-        std::vector<libMesh::boundary_id_type> bc_ids = binfo.boundary_ids(&_elem, n);
+        std::vector<libMesh::boundary_id_type> bc_ids = topology.boundary_ids(_elem, n);
         std::vector<libMesh::boundary_id_type>::const_iterator bc_it = bc_ids.begin();
         
         for ( ; bc_it != bc_ids.end(); bc_it++) {
@@ -346,6 +519,8 @@ volume_external_residual (bool request_jacobian,
                           RealMatrixX& jac,
                           std::multimap<libMesh::subdomain_id_type, MAST::BoundaryConditionBase*>& bc) {
     
+    MAST_LOG_SCOPE("volume_external_residual()", "HeatConductionElementBase");
+    
     typedef std::multimap<libMesh::subdomain_id_type, MAST::BoundaryConditionBase*> maptype;
     
     // iterate over the boundary ids given in the provided force map
@@ -410,7 +585,7 @@ side_external_residual_sensitivity (bool request_jacobian,
     // iterate over the boundary ids given in the provided force map
     std::pair<maptype::const_iterator, maptype::const_iterator> it;
     
-    const libMesh::BoundaryInfo& binfo = *_system.system().get_mesh().boundary_info;
+    const MAST::ElementTopologyCache& topology = _system.system().topology_cache();
     
     // for each boundary id, check if any of the sides on the element
     // has the associated boundary
@@ -419,12 +594,12 @@ side_external_residual_sensitivity (bool request_jacobian,
         
         // if no boundary ids have been specified for the side, then
         // move to the next side.
-        if (!binfo.n_boundary_ids(&_elem, n))
+        if (!topology.n_boundary_ids(_elem, n))
             continue;
         
         // check to see if any of the specified boundary ids has a boundary
         // condition associated with them
-        std::vector<libMesh::boundary_id_type> bc_ids = binfo.boundary_ids(&_elem, n);
+        std::vector<libMesh::boundary_id_type> bc_ids = topology.boundary_ids(_elem, n);
         std::vector<libMesh::boundary_id_type>::const_iterator bc_it = bc_ids.begin();
         
         for ( ; bc_it != bc_ids.end(); bc_it++) {
@@ -92,6 +92,23 @@ namespace MAST {
                            RealMatrixX& jac_xdot,
                            RealMatrixX& jac);
         
+        
+        /*!
+         *   computes the contributions of internal_residual() to \p f_x
+         *   and \p jac_x, and of velocity_residual() to \p f_m,
+         *   \p jac_xdot and \p jac_m in a single loop over the quadrature
+         *   points, which shares the shape function operators, quadrature
+         *   point solution and locations between the conductance and
+         *   capacitance terms. This is used by the transient assembly.
+         */
+        virtual bool
+        internal_and_velocity_residual (bool request_jacobian,
+                                        RealVectorX& f_x,
+                                        RealMatrixX& jac_x,
+                                        RealVectorX& f_m,
+                                        RealMatrixX& jac_xdot,
+                                        RealMatrixX& jac_m);
+        
         /*!
          *   side external force contribution to system residual
          */
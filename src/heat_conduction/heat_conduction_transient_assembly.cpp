@@ -59,13 +59,13 @@ _elem_calculations(MAST::ElementBase& elem,
     f_m_jac.setZero();
     f_x_jac.setZero();
     
-    // assembly of the flux terms
-    e.internal_residual(if_jac, f_x, f_x_jac);
+    // assembly of the flux and capacitance terms in one pass over the
+    // quadrature points
+    e.internal_and_velocity_residual(if_jac,
+                                     f_x, f_x_jac,
+                                     f_m, f_m_jac_xdot, f_m_jac);
     e.side_external_residual(if_jac, f_x, f_x_jac, _discipline->side_loads());
     e.volume_external_residual(if_jac, f_x, f_x_jac, _discipline->volume_loads());
-    
-    //assembly of the capacitance term
-    e.velocity_residual(if_jac, f_m, f_m_jac_xdot, f_m_jac);
 }
 
 
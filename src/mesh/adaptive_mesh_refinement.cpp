@@ -0,0 +1,233 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2017  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+// C++ includes
+#include <set>
+
+
+// MAST includes
+#include "mesh/adaptive_mesh_refinement.h"
+#include "mesh/error_indicator_base.h"
+#include "base/assembly_base.h"
+#include "base/elementwise_design_field.h"
+#include "elasticity/stress_output_base.h"
+#include "base/performance_log.h"
+
+
+// libMesh includes
+#include "libmesh/equation_systems.h"
+#include "libmesh/mesh_base.h"
+#include "libmesh/elem.h"
+
+
+MAST::AdaptiveMeshRefinement::
+AdaptiveMeshRefinement(libMesh::EquationSystems& eq_sys):
+_eq_sys(eq_sys),
+_refinement(eq_sys.get_mesh()),
+_error_norm(0.) {
+    
+}
+
+
+
+MAST::AdaptiveMeshRefinement::~AdaptiveMeshRefinement() {
+    
+}
+
+
+
+void
+MAST::AdaptiveMeshRefinement::add_assembly(MAST::AssemblyBase& a) {
+    
+    _assemblies.push_back(&a);
+}
+
+
+
+void
+MAST::AdaptiveMeshRefinement::add_stress_output(MAST::StressStrainOutputBase& o) {
+    
+    _stress_outputs.push_back(&o);
+}
+
+
+
+void
+MAST::AdaptiveMeshRefinement::add_design_field(MAST::ElementwiseDesignField& f) {
+    
+    _design_fields.push_back(&f);
+}
+
+
+
+bool
+MAST::AdaptiveMeshRefinement::adapt(const libMesh::ErrorVector& err) {
+    
+    MAST_LOG_SCOPE("adapt()", "AdaptiveMeshRefinement");
+    
+    _error_norm = err.l2_norm();
+    
+    // the element subsets of the outputs, along with the parents of the
+    // elements that may be deleted by coarsening
+    std::vector<std::vector<std::pair<const libMesh::Elem*, const libMesh::Elem*> > >
+    subsets(_stress_outputs.size());
+    
+    for (unsigned int i=0; i<_stress_outputs.size(); i++) {
+        
+        const std::set<const libMesh::Elem*>&
+        s = _stress_outputs[i]->get_elem_subset();
+        
+        std::set<const libMesh::Elem*>::const_iterator
+        it  = s.begin(),
+        end = s.end();
+        
+        for ( ; it != end; it++)
+            subsets[i].push_back(std::make_pair(*it, (*it)->parent()));
+    }
+    
+    _refinement.flag_elements_by_error_fraction(err);
+    
+    if (!_refinement.refine_and_coarsen_elements())
+        return false;
+    
+    // projects the system vectors on the new mesh
+    _eq_sys.reinit();
+    
+    _update_objects(subsets);
+    
+    return true;
+}
+
+
+
+bool
+MAST::AdaptiveMeshRefinement::adapt(MAST::ErrorIndicatorBase& ind) {
+    
+    libMesh::ErrorVector err;
+    ind.estimate_error(err);
+    
+    return this->adapt(err);
+}
+
+
+
+unsigned int
+MAST::AdaptiveMeshRefinement::
+adapt_and_solve(MAST::AdaptiveMeshRefinement::SolveFunction& s,
+                MAST::ErrorIndicatorBase& ind,
+                unsigned int max_steps,
+                Real tol) {
+    
+    unsigned int
+    n_adapt = 0;
+    
+    s.solve();
+    
+    while (n_adapt < max_steps) {
+        
+        libMesh::ErrorVector err;
+        ind.estimate_error(err);
+        
+        if (err.l2_norm() <= tol) {
+            
+            _error_norm = err.l2_norm();
+            break;
+        }
+        
+        if (!this->adapt(err))
+            break;
+        
+        n_adapt++;
+        
+        libMesh::out
+        << "Adaptation " << n_adapt
+        << ": error = " << _error_norm
+        << ", active elements = " << _eq_sys.get_mesh().n_active_elem()
+        << std::endl;
+        
+        s.solve();
+    }
+    
+    return n_adapt;
+}
+
+
+
+void
+MAST::AdaptiveMeshRefinement::_update_objects
+(const std::vector<std::vector<std::pair<const libMesh::Elem*, const libMesh::Elem*> > >& subsets) {
+    
+    for (unsigned int i=0; i<_assemblies.size(); i++)
+        _assemblies[i]->clear_mesh_dependent_data();
+    
+    for (unsigned int i=0; i<_design_fields.size(); i++)
+        _design_fields[i]->update();
+    
+    if (!_stress_outputs.size())
+        return;
+    
+    // elements of the new mesh, which identify the elements of the
+    // subsets that were deleted by coarsening
+    const libMesh::MeshBase& mesh = _eq_sys.get_mesh();
+    
+    std::set<const libMesh::Elem*> elems;
+    
+    libMesh::MeshBase::const_element_iterator
+    e_it   = mesh.elements_begin(),
+    e_end  = mesh.elements_end();
+    
+    for ( ; e_it != e_end; e_it++)
+        elems.insert(*e_it);
+    
+    for (unsigned int i=0; i<_stress_outputs.size(); i++) {
+        
+        MAST::StressStrainOutputBase& o = *_stress_outputs[i];
+        
+        if (!subsets[i].size()) {
+            
+            o.clear(true);
+            continue;
+        }
+        
+        std::set<const libMesh::Elem*> s;
+        std::vector<const libMesh::Elem*> family;
+        
+        for (unsigned int j=0; j<subsets[i].size(); j++) {
+            
+            const libMesh::Elem
+            *e = subsets[i][j].first,
+            *p = subsets[i][j].second;
+            
+            if (elems.count(e)) {
+                
+                // the element or its refined children
+                family.clear();
+                e->active_family_tree(family);
+                s.insert(family.begin(), family.end());
+            }
+            else if (p && elems.count(p) && p->active())
+                s.insert(p);
+        }
+        
+        o.clear(true);
+        o.set_elements_in_domain(s);
+    }
+}
+
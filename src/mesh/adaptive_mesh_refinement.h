@@ -0,0 +1,206 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2017  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+#ifndef __mast__adaptive_mesh_refinement__
+#define __mast__adaptive_mesh_refinement__
+
+// C++ includes
+#include <vector>
+
+
+// MAST includes
+#include "base/mast_data_types.h"
+
+
+// libMesh includes
+#include "libmesh/mesh_refinement.h"
+#include "libmesh/error_vector.h"
+
+
+namespace libMesh {
+    
+    // Forward declerations
+    class EquationSystems;
+    class Elem;
+}
+
+
+namespace MAST {
+    
+    // Forward declerations
+    class AssemblyBase;
+    class StressStrainOutputBase;
+    class ElementwiseDesignField;
+    class ErrorIndicatorBase;
+    
+    
+    /*!
+     *   Refines and coarsens the mesh of a set of equation systems with
+     *   libMesh::MeshRefinement on the basis of the element errors of a
+     *   MAST::ErrorIndicatorBase, for example the stress recovery error
+     *   of a structure or the shock and entropy indicators of a fluid.
+     *   After the mesh is changed, the equation systems are reinitialized,
+     *   which projects the solution and the vectors of the systems, for
+     *   example the sensitivity solutions, on the new mesh. The data that
+     *   the registered objects store for the old mesh is then cleared:
+     *   - the element caches of the assemblies, with
+     *     MAST::AssemblyBase::clear_mesh_dependent_data(),
+     *   - the element data of the stress outputs. An element subset of an
+     *     output is replaced by the active elements of the new mesh that
+     *     descend from it, or by the parent of a coarsened element.
+     *   - the localized design values of the elementwise design fields.
+     *
+     *   The projected sensitivity solutions are only an approximation,
+     *   and the sensitivities must be computed again on the new mesh.
+     *   The refinement and coarsening fractions and the maximum level of
+     *   the elements are set with mesh_refinement().
+     */
+    class AdaptiveMeshRefinement {
+        
+    public:
+        
+        /*!
+         *   solution of the systems on the current mesh, which is called
+         *   by adapt_and_solve() before each error estimate
+         */
+        class SolveFunction {
+            
+        public:
+            
+            SolveFunction() { }
+            
+            virtual ~SolveFunction() { }
+            
+            virtual void solve() = 0;
+        };
+        
+        
+        AdaptiveMeshRefinement(libMesh::EquationSystems& eq_sys);
+        
+        
+        virtual ~AdaptiveMeshRefinement();
+        
+        
+        /*!
+         *   @returns a reference to the object that flags and refines
+         *   the elements, which is used to set the refinement parameters
+         */
+        libMesh::MeshRefinement& mesh_refinement() {
+            return _refinement;
+        }
+        
+        
+        /*!
+         *   adds \p a to the assemblies whose mesh dependent data is
+         *   cleared after the mesh is changed
+         */
+        void add_assembly(MAST::AssemblyBase& a);
+        
+        
+        /*!
+         *   adds \p o to the stress outputs that are updated after the
+         *   mesh is changed
+         */
+        void add_stress_output(MAST::StressStrainOutputBase& o);
+        
+        
+        /*!
+         *   adds \p f to the design fields that are updated after the
+         *   mesh is changed
+         */
+        void add_design_field(MAST::ElementwiseDesignField& f);
+        
+        
+        /*!
+         *   flags the elements for refinement and coarsening by the
+         *   fractions of the error in \p err, changes the mesh and updates
+         *   the systems and registered objects. @returns \p true if the
+         *   mesh was changed. This must be called on all processors.
+         */
+        bool adapt(const libMesh::ErrorVector& err);
+        
+        
+        /*!
+         *   computes the error with \p ind and adapts the mesh. @returns
+         *   \p true if the mesh was changed.
+         */
+        bool adapt(MAST::ErrorIndicatorBase& ind);
+        
+        
+        /*!
+         *   solves with \p s and adapts the mesh with the error of \p ind
+         *   until the l2 norm of the element errors is below \p tol, the
+         *   mesh is unchanged by an adaptation, or \p max_steps
+         *   adaptations have been done. The solution on the final mesh
+         *   is always computed. @returns the number of adaptations.
+         */
+        unsigned int adapt_and_solve(MAST::AdaptiveMeshRefinement::SolveFunction& s,
+                                     MAST::ErrorIndicatorBase& ind,
+                                     unsigned int max_steps,
+                                     Real tol = 0.);
+        
+        
+        /*!
+         *   @returns the l2 norm of the element errors of the last call
+         *   to adapt()
+         */
+        Real error_norm() const {
+            return _error_norm;
+        }
+        
+    protected:
+        
+        /*!
+         *   updates the registered objects after the mesh is changed.
+         *   \p subsets are the element subsets of the stress outputs with
+         *   the parents of their elements before the change.
+         */
+        void _update_objects
+        (const std::vector<std::vector<std::pair<const libMesh::Elem*, const libMesh::Elem*> > >& subsets);
+        
+        
+        /*!
+         *   equation systems whose mesh is adapted
+         */
+        libMesh::EquationSystems&                    _eq_sys;
+        
+        /*!
+         *   flagging and refinement of the elements
+         */
+        libMesh::MeshRefinement                      _refinement;
+        
+        /*!
+         *   objects updated after the mesh is changed
+         */
+        std::vector<MAST::AssemblyBase*>             _assemblies;
+        
+        std::vector<MAST::StressStrainOutputBase*>   _stress_outputs;
+        
+        std::vector<MAST::ElementwiseDesignField*>   _design_fields;
+        
+        /*!
+         *   l2 norm of the element errors of the last adaptation
+         */
+        Real                                         _error_norm;
+    };
+}
+
+
+#endif // __mast__adaptive_mesh_refinement__
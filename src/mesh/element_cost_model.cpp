@@ -0,0 +1,297 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2017  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+// C++ includes
+#include <cmath>
+#include <algorithm>
+
+
+// MAST includes
+#include "mesh/element_cost_model.h"
+#include "base/system_initialization.h"
+#include "base/nonlinear_system.h"
+#include "base/assembly_base.h"
+#include "base/performance_log.h"
+
+
+// libMesh includes
+#include "libmesh/mesh_base.h"
+#include "libmesh/elem.h"
+#include "libmesh/partitioner.h"
+#include "libmesh/quadrature.h"
+#include "libmesh/fe_interface.h"
+#include "libmesh/equation_systems.h"
+
+
+MAST::ElementCostModel::ElementCostModel(MAST::SystemInitialization& sys):
+_system(sys),
+_measure(false),
+_scale(1.) {
+    
+}
+
+
+
+MAST::ElementCostModel::~ElementCostModel() {
+    
+    // the assemblies remove themselves from the set
+    std::set<MAST::AssemblyBase*> assemblies(_assemblies);
+    
+    std::set<MAST::AssemblyBase*>::iterator
+    it  = assemblies.begin(),
+    end = assemblies.end();
+    
+    for ( ; it != end; it++)
+        (*it)->set_element_cost_model(nullptr);
+}
+
+
+
+Real
+MAST::ElementCostModel::estimated_cost(const libMesh::Elem& e) const {
+    
+    std::map<libMesh::ElemType, Real>::const_iterator
+    it = _type_cost.find(e.type());
+    
+    if (it != _type_cost.end())
+        return it->second;
+    
+    // same quadrature as MAST::ElementBase
+    const libMesh::FEType&
+    fe_type = _system.fetype(0);
+    
+    std::auto_ptr<libMesh::QBase>
+    qrule(fe_type.default_quadrature_rule
+          (e.dim(), _system.system().extra_quadrature_order).release());
+    qrule->init(e.type());
+    
+    const Real
+    n_dofs = _system.n_vars() *
+    libMesh::FEInterface::n_dofs(e.dim(), fe_type, e.type()),
+    c      = qrule->n_points() * n_dofs * n_dofs;
+    
+    _type_cost[e.type()] = c;
+    
+    return c;
+}
+
+
+
+void
+MAST::ElementCostModel::add_measured_cost(const libMesh::Elem& e, Real t) {
+    
+    std::lock_guard<std::mutex> lock(_mutex);
+    
+    _measured[e.id()] += t;
+}
+
+
+
+void
+MAST::ElementCostModel::clear_measured_costs() {
+    
+    std::lock_guard<std::mutex> lock(_mutex);
+    
+    _measured.clear();
+    _scale = 1.;
+}
+
+
+
+void
+MAST::ElementCostModel::add_assembly(MAST::AssemblyBase& a) {
+    
+    _assemblies.insert(&a);
+}
+
+
+
+void
+MAST::ElementCostModel::remove_assembly(MAST::AssemblyBase& a) {
+    
+    _assemblies.erase(&a);
+}
+
+
+
+Real
+MAST::ElementCostModel::load_imbalance() {
+    
+    const libMesh::MeshBase&
+    mesh = _system.system().get_mesh();
+    
+    this->_update_scale();
+    
+    Real
+    local = 0.;
+    
+    libMesh::MeshBase::const_element_iterator
+    it  = mesh.active_local_elements_begin(),
+    end = mesh.active_local_elements_end();
+    
+    for ( ; it != end; it++)
+        local += _cost(**it);
+    
+    Real
+    max_cost = local,
+    total    = local;
+    mesh.comm().max(max_cost);
+    mesh.comm().sum(total);
+    
+    if (total <= 0.)
+        return 0.;
+    
+    return max_cost * mesh.n_processors() / total - 1.;
+}
+
+
+
+void
+MAST::ElementCostModel::attach_weights(libMesh::Partitioner& p) {
+    
+    MAST_LOG_SCOPE("attach_weights()", "ElementCostModel");
+    
+    const libMesh::MeshBase&
+    mesh = _system.system().get_mesh();
+    
+    this->_update_scale();
+    
+    _weights.assign(mesh.max_elem_id(), 0.);
+    
+    Real
+    max_cost = 0.;
+    
+    libMesh::MeshBase::const_element_iterator
+    it  = mesh.active_local_elements_begin(),
+    end = mesh.active_local_elements_end();
+    
+    for ( ; it != end; it++) {
+        
+        const Real
+        c = _cost(**it);
+        
+        _weights[(*it)->id()] = c;
+        max_cost = std::max(max_cost, c);
+    }
+    
+    mesh.comm().max(max_cost);
+    
+    // the weights are scaled to integers, such that the sum of the weights
+    // does not overflow the METIS integers. Each element has a weight of
+    // at least one.
+    const Real
+    w_max = std::min(1000., 1.e9/std::max(1., (Real)mesh.n_active_elem()));
+    
+    for (unsigned int i=0; i<_weights.size(); i++)
+        if (_weights[i] > 0.)
+            _weights[i] = std::max(1., std::floor(w_max * _weights[i]/max_cost + 0.5));
+    
+    // the whole graph is partitioned on each processor for a replicated
+    // mesh, which needs the weights of all elements
+    if (mesh.is_serial())
+        mesh.comm().sum(static_cast<std::vector<libMesh::ErrorVectorReal>&>(_weights));
+    
+    p.attach_weights(&_weights);
+}
+
+
+
+bool
+MAST::ElementCostModel::rebalance(Real tol) {
+    
+    MAST_LOG_SCOPE("rebalance()", "ElementCostModel");
+    
+    if (this->load_imbalance() <= tol)
+        return false;
+    
+    libMesh::MeshBase&
+    mesh = _system.system().get_mesh();
+    
+    libMesh::Partitioner*
+    p = mesh.partitioner().get();
+    
+    if (!p)
+        libmesh_error_msg("Error! Mesh does not have a partitioner.");
+    
+    this->attach_weights(*p);
+    p->partition(mesh);
+    
+    // the weights are not valid for later changes of the mesh
+    p->attach_weights(nullptr);
+    _weights.clear();
+    
+    this->clear_measured_costs();
+    
+    _system.system().get_equation_systems().reinit();
+    
+    // the element objects, localized vectors and element lists of the
+    // assemblies refer to the old partitioning
+    std::set<MAST::AssemblyBase*>::iterator
+    it  = _assemblies.begin(),
+    end = _assemblies.end();
+    
+    for ( ; it != end; it++)
+        (*it)->clear_mesh_dependent_data();
+    
+    return true;
+}
+
+
+
+void
+MAST::ElementCostModel::_update_scale() {
+    
+    const libMesh::MeshBase&
+    mesh = _system.system().get_mesh();
+    
+    Real
+    measured  = 0.,
+    estimated = 0.;
+    
+    std::map<libMesh::dof_id_type, Real>::const_iterator
+    it  = _measured.begin(),
+    end = _measured.end();
+    
+    for ( ; it != end; it++) {
+        
+        measured  += it->second;
+        estimated += this->estimated_cost(*mesh.elem_ptr(it->first));
+    }
+    
+    mesh.comm().sum(measured);
+    mesh.comm().sum(estimated);
+    
+    _scale = (measured > 0. && estimated > 0.)? measured/estimated : 1.;
+}
+
+
+
+Real
+MAST::ElementCostModel::_cost(const libMesh::Elem& e) const {
+    
+    std::map<libMesh::dof_id_type, Real>::const_iterator
+    it = _measured.find(e.id());
+    
+    if (it != _measured.end())
+        return it->second;
+    
+    return _scale * this->estimated_cost(e);
+}
+
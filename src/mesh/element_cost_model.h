@@ -0,0 +1,229 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2017  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+#ifndef __mast__element_cost_model__
+#define __mast__element_cost_model__
+
+// C++ includes
+#include <map>
+#include <mutex>
+#include <set>
+
+
+// MAST includes
+#include "base/mast_data_types.h"
+
+
+// libMesh includes
+#include "libmesh/enum_elem_type.h"
+#include "libmesh/error_vector.h"
+
+
+namespace libMesh {
+    
+    // Forward declerations
+    class Elem;
+    class Partitioner;
+}
+
+
+namespace MAST {
+    
+    // Forward declerations
+    class SystemInitialization;
+    class AssemblyBase;
+    
+    
+    /*!
+     *   Cost of the elements of a system, which is used as the element
+     *   weights for partitioning of its mesh with METIS or ParMETIS, so that
+     *   the processors have similar assembly costs instead of similar
+     *   numbers of elements. This matters for meshes that mix element
+     *   types or orders, for example the beam stiffeners and shells of a
+     *   stiffened panel.
+     *
+     *   The estimated cost of an element is the number of quadrature
+     *   points times the square of the number of dofs, which is the leading
+     *   cost of the element Jacobian. If the model is attached to an
+     *   assembly with MAST::AssemblyBase::set_element_cost_model() and the
+     *   measurement is enabled, the time of each element in the residual
+     *   and Jacobian assembly is added to its measured cost, which is then
+     *   used instead of the estimate. The estimates of elements without
+     *   measurements are scaled to the measured times. rebalance()
+     *   repartitions the mesh with these costs if the load imbalance
+     *   exceeds a tolerance, which can be called after a first timed
+     *   assembly or solve.
+     */
+    class ElementCostModel {
+        
+    public:
+        
+        ElementCostModel(MAST::SystemInitialization& sys);
+        
+        
+        virtual ~ElementCostModel();
+        
+        
+        /*!
+         *   @returns the estimated cost of \p e, which is the number of
+         *   quadrature points times the square of the number of dofs of
+         *   the element. The estimate is computed once for each element
+         *   type.
+         */
+        Real estimated_cost(const libMesh::Elem& e) const;
+        
+        
+        /*!
+         *   turns on/off the measurement of element costs by the assemblies
+         *   that use this model. This is off by default.
+         */
+        void enable_measurement(bool f = true) {
+            _measure = f;
+        }
+        
+        
+        /*!
+         *   @returns true if the element costs are measured
+         */
+        bool measuring() const {
+            return _measure;
+        }
+        
+        
+        /*!
+         *   adds the time \p t in seconds to the measured cost of \p e.
+         *   This can be called from threaded assembly loops.
+         */
+        void add_measured_cost(const libMesh::Elem& e, Real t);
+        
+        
+        /*!
+         *   clears the measured element costs
+         */
+        void clear_measured_costs();
+        
+        
+        /*!
+         *   adds \p a to the assemblies that use this model, whose mesh
+         *   dependent data is cleared by rebalance(). This is called by
+         *   MAST::AssemblyBase::set_element_cost_model().
+         */
+        void add_assembly(MAST::AssemblyBase& a);
+        
+        
+        /*!
+         *   removes \p a from the assemblies that use this model
+         */
+        void remove_assembly(MAST::AssemblyBase& a);
+        
+        
+        /*!
+         *   @returns the load imbalance of the current partitioning, which
+         *   is the ratio of the maximum to the mean of the costs of the
+         *   local elements of the processors, minus one. This must be
+         *   called on all processors.
+         */
+        Real load_imbalance();
+        
+        
+        /*!
+         *   computes the weights of the elements from their costs and 
+         *   attaches them to \p p. The weights are scaled to integers of at
+         *   most 1000, since METIS uses integer vertex weights. The weights
+         *   are stored in this object, which must exist as long as \p p
+         *   uses them. This must be called on all processors.
+         */
+        void attach_weights(libMesh::Partitioner& p);
+        
+        
+        /*!
+         *   repartitions the mesh with the element costs, if the load
+         *   imbalance is larger than \p tol, and reinitializes the equation
+         *   systems of the mesh. The mesh must have a partitioner that
+         *   supports weights. The measured costs refer to the elements of
+         *   the old partitioning, and are cleared along with the mesh
+         *   dependent data of the assemblies that use this model. @returns true if the 
+         *   mesh was repartitioned. This must be called on all processors.
+         */
+        bool rebalance(Real tol = 0.1);
+        
+    protected:
+        
+        /*!
+         *   computes the factor that scales the estimated costs to the
+         *   measured costs, from the elements with measurements on all
+         *   processors
+         */
+        void _update_scale();
+        
+        
+        /*!
+         *   @returns the cost of \p e, which is the measured cost if 
+         *   available, or the scaled estimate
+         */
+        Real _cost(const libMesh::Elem& e) const;
+        
+        
+        /*!
+         *   system for which the costs are computed
+         */
+        MAST::SystemInitialization&              _system;
+        
+        /*!
+         *   flag to measure the element costs
+         */
+        bool                                     _measure;
+        
+        /*!
+         *   factor that scales the estimated costs to the measured costs
+         */
+        Real                                     _scale;
+        
+        /*!
+         *   estimated cost for each element type
+         */
+        mutable std::map<libMesh::ElemType, Real> _type_cost;
+        
+        /*!
+         *   measured cost of the local elements, by element id
+         */
+        std::map<libMesh::dof_id_type, Real>     _measured;
+        
+        /*!
+         *   mutex for the measured costs added by the threaded assembly
+         */
+        std::mutex                               _mutex;
+        
+        /*!
+         *   weights of the elements, by element id, attached to the
+         *   partitioner
+         */
+        libMesh::ErrorVector                     _weights;
+        
+        /*!
+         *   assemblies that use this model
+         */
+        std::set<MAST::AssemblyBase*>            _assemblies;
+    };
+}
+
+
+#endif // __mast__element_cost_model__
+
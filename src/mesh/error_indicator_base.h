@@ -0,0 +1,61 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2017  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+#ifndef __mast__error_indicator_base__
+#define __mast__error_indicator_base__
+
+
+// MAST includes
+#include "base/mast_data_types.h"
+
+
+// libMesh includes
+#include "libmesh/error_vector.h"
+
+
+namespace MAST {
+    
+    /*!
+     *   Interface of the error indicators used by
+     *   MAST::AdaptiveMeshRefinement. An indicator computes a
+     *   non-negative value of the error for each active element from the
+     *   current solution or outputs of its system.
+     */
+    class ErrorIndicatorBase {
+        
+    public:
+        
+        ErrorIndicatorBase() { }
+        
+        virtual ~ErrorIndicatorBase() { }
+        
+        
+        /*!
+         *   computes the error of the active elements in \p err, which is
+         *   resized to the maximum element id of the mesh and is the same
+         *   on all processors. The value of the inactive elements is zero.
+         *   This must be called on all processors.
+         */
+        virtual void estimate_error(libMesh::ErrorVector& err) = 0;
+    };
+}
+
+
+#endif // __mast__error_indicator_base__
@@ -0,0 +1,70 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2017  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+// MAST includes
+#include "mesh/rank_range_partitioner.h"
+
+
+// libMesh includes
+#include "libmesh/mesh_base.h"
+#include "libmesh/elem.h"
+#include "libmesh/metis_partitioner.h"
+
+
+
+MAST::RankRangePartitioner::RankRangePartitioner(unsigned int first,
+                                                 unsigned int n):
+libMesh::Partitioner(),
+_first(first),
+_n(n),
+_weights(nullptr) {
+
+    libmesh_assert_greater(n, 0);
+}
+
+
+
+MAST::RankRangePartitioner::~RankRangePartitioner() {
+
+}
+
+
+
+void
+MAST::RankRangePartitioner::_do_partition(libMesh::MeshBase& mesh,
+                                          const unsigned int n) {
+
+    libmesh_assert_less_equal(_first+_n, n);
+    libmesh_assert(mesh.is_serial());
+
+    // partition into the requested number of parts, and then shift
+    // the parts to the processor range. The processor ids of the nodes
+    // are set by libMesh::Partitioner::partition() after this.
+    libMesh::MetisPartitioner metis;
+    if (_weights)
+        metis.attach_weights(_weights);
+    metis.partition(mesh, _n);
+
+    libMesh::MeshBase::element_iterator
+    it  = mesh.elements_begin(),
+    end = mesh.elements_end();
+
+    for ( ; it != end; it++)
+        (*it)->processor_id() += _first;
+}
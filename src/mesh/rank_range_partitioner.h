@@ -0,0 +1,89 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2017  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef __mast__rank_range_partitioner__
+#define __mast__rank_range_partitioner__
+
+
+// MAST includes
+#include "base/mast_data_types.h"
+
+
+// libMesh includes
+#include "libmesh/partitioner.h"
+
+
+namespace MAST {
+
+    /*!
+     *   partitions a replicated mesh with METIS over the \p n processors
+     *   starting at \p first, so that the dofs of the system are owned
+     *   only by these processors. This allows disciplines with very
+     *   different costs, for example a small structural mesh and a large
+     *   fluid mesh, to be placed on disjoint sets of processors of the
+     *   same communicator. Set it on the mesh before it is prepared, with
+     *   \p mesh.partitioner().reset(new MAST::RankRangePartitioner(first, n)).
+     *   Element weights attached with attach_weights(), for example by
+     *   MAST::ElementCostModel, are passed to METIS.
+     */
+    class RankRangePartitioner:
+    public libMesh::Partitioner {
+
+    public:
+
+        RankRangePartitioner(unsigned int first,
+                             unsigned int n);
+
+        virtual ~RankRangePartitioner();
+
+        virtual libMesh::UniquePtr<libMesh::Partitioner> clone () const libmesh_override {
+            return libMesh::UniquePtr<libMesh::Partitioner>(new MAST::RankRangePartitioner(*this));
+        }
+
+        /*!
+         *   attaches the weights of the elements, indexed by element id,
+         *   that are used by METIS. A nullptr removes the weights.
+         */
+        virtual void attach_weights(libMesh::ErrorVector* weights) libmesh_override {
+            _weights = weights;
+        }
+
+    protected:
+
+        /*!
+         *   partitions the elements in \p _n parts, which are assigned to
+         *   the processors starting at \p _first
+         */
+        virtual void _do_partition (libMesh::MeshBase& mesh,
+                                    const unsigned int n) libmesh_override;
+
+        /*!
+         *   first processor, and number of processors
+         */
+        unsigned int _first, _n;
+
+        /*!
+         *   weights of the elements, if provided
+         */
+        libMesh::ErrorVector* _weights;
+    };
+}
+
+
+#endif // __mast__rank_range_partitioner__
@@ -0,0 +1,217 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2017  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+// C++ includes
+#include <cmath>
+#include <algorithm>
+
+
+// MAST includes
+#include "numerics/basis_alignment.h"
+#include "base/performance_log.h"
+
+
+MAST::BasisAlignment::BasisAlignment():
+_residual(0.) {
+    
+}
+
+
+
+MAST::BasisAlignment::~BasisAlignment() {
+    
+}
+
+
+
+void
+MAST::BasisAlignment::
+compute(const std::vector<libMesh::NumericVector<Real>*>& old_basis,
+        const std::vector<libMesh::NumericVector<Real>*>& new_basis,
+        const libMesh::SparseMatrix<Real>* M) {
+    
+    MAST_LOG_SCOPE("compute()", "BasisAlignment");
+    
+    libmesh_assert(old_basis.size());
+    libmesh_assert(new_basis.size());
+    
+    const unsigned int
+    n0 = (unsigned int)old_basis.size(),
+    n1 = (unsigned int)new_basis.size();
+    
+    _G0.setZero(n0, n0);
+    _G1.setZero(n1, n1);
+    _cross.setZero(n0, n1);
+    
+    // products of the new vectors with the matrix, if provided
+    std::vector<libMesh::NumericVector<Real>*>
+    M_new(n1, nullptr);
+    
+    std::auto_ptr<libMesh::NumericVector<Real> >
+    tmp(old_basis[0]->zero_clone().release());
+    
+    for (unsigned int j=0; j<n1; j++) {
+        
+        if (M) {
+            
+            M_new[j] = new_basis[j]->zero_clone().release();
+            M->vector_mult(*M_new[j], *new_basis[j]);
+        }
+        else
+            M_new[j] = new_basis[j];
+        
+        for (unsigned int i=0; i<=j; i++) {
+            
+            _G1(i,j) = new_basis[i]->dot(*M_new[j]);
+            _G1(j,i) = _G1(i,j);
+        }
+        
+        for (unsigned int i=0; i<n0; i++)
+            _cross(i,j) = old_basis[i]->dot(*M_new[j]);
+    }
+    
+    for (unsigned int j=0; j<n0; j++) {
+        
+        const libMesh::NumericVector<Real>* v = old_basis[j];
+        
+        if (M) {
+            
+            M->vector_mult(*tmp, *old_basis[j]);
+            v = tmp.get();
+        }
+        
+        for (unsigned int i=0; i<=j; i++) {
+            
+            _G0(i,j) = old_basis[i]->dot(*v);
+            _G0(j,i) = _G0(i,j);
+        }
+    }
+    
+    if (M)
+        for (unsigned int j=0; j<n1; j++)
+            delete M_new[j];
+    
+    _update();
+}
+
+
+
+void
+MAST::BasisAlignment::
+rotate_basis(std::vector<libMesh::NumericVector<Real>*>& new_basis) {
+    
+    libmesh_assert_equal_to(new_basis.size(), n_new());
+    libmesh_assert_equal_to(n_old(), n_new());
+    
+    const unsigned int
+    n = n_new();
+    
+    std::vector<libMesh::NumericVector<Real>*>
+    copies(n, nullptr);
+    
+    for (unsigned int i=0; i<n; i++)
+        copies[i] = new_basis[i]->clone().release();
+    
+    for (unsigned int j=0; j<n; j++) {
+        
+        new_basis[j]->zero();
+        
+        for (unsigned int i=0; i<n; i++)
+            new_basis[j]->add(_R(i,j), *copies[i]);
+        
+        new_basis[j]->close();
+    }
+    
+    for (unsigned int i=0; i<n; i++)
+        delete copies[i];
+    
+    // the inner products of the rotated basis
+    _G1    = _R.transpose() * _G1 * _R;
+    _cross = _cross * _R;
+    
+    _update();
+}
+
+
+
+RealMatrixX
+MAST::BasisAlignment::transform(const RealMatrixX& A) const {
+    
+    libmesh_assert_equal_to(A.rows(), n_old());
+    libmesh_assert_equal_to(A.cols(), n_old());
+    
+    return _T.transpose() * A * _T;
+}
+
+
+
+ComplexMatrixX
+MAST::BasisAlignment::transform(const ComplexMatrixX& A) const {
+    
+    libmesh_assert_equal_to(A.rows(), n_old());
+    libmesh_assert_equal_to(A.cols(), n_old());
+    
+    const ComplexMatrixX
+    T = _T.cast<Complex>();
+    
+    return T.transpose() * A * T;
+}
+
+
+
+void
+MAST::BasisAlignment::_update() {
+    
+    const unsigned int
+    n0 = n_old(),
+    n1 = n_new();
+    
+    // coordinates of the new vectors in the old basis
+    _T = _G0.partialPivLu().solve(_cross);
+    
+    _mac.setZero(n0, n1);
+    _residual = 0.;
+    
+    for (unsigned int j=0; j<n1; j++) {
+        
+        for (unsigned int i=0; i<n0; i++)
+            if (_G0(i,i) > 0. && _G1(j,j) > 0.)
+                _mac(i,j) = _cross(i,j) * _cross(i,j) / (_G0(i,i) * _G1(j,j));
+        
+        // the squared norm of the projection on the old basis is
+        // t^T G0 t = t^T cross_j
+        if (_G1(j,j) > 0.)
+            _residual =
+            std::max(_residual,
+                     sqrt(std::max(0., 1. - _T.col(j).dot(_cross.col(j))/_G1(j,j))));
+    }
+    
+    // Procrustes rotation from the SVD of the transpose of the inner
+    // products
+    if (n0 == n1) {
+        
+        Eigen::JacobiSVD<RealMatrixX>
+        svd(_cross.transpose(), Eigen::ComputeFullU | Eigen::ComputeFullV);
+        
+        _R = svd.matrixU() * svd.matrixV().transpose();
+    }
+    else
+        _R.resize(0, 0);
+}
+
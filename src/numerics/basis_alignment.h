@@ -0,0 +1,183 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2017  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef __mast__basis_alignment_h__
+#define __mast__basis_alignment_h__
+
+// C++ includes
+#include <vector>
+
+// MAST includes
+#include "base/mast_data_types.h"
+
+// libMesh includes
+#include "libmesh/numeric_vector.h"
+#include "libmesh/sparse_matrix.h"
+
+
+namespace MAST {
+    
+    /*!
+     *   Compares a new basis \f$ \Phi_1 \f$, for example the structural
+     *   modes of a new design iteration, with an old basis \f$ \Phi_0 \f$ for
+     *   which reduced quantities were computed, using the inner product
+     *   \f$ \langle u, v \rangle = u^T [M] v \f$ with an optional matrix
+     *   \f$ M \f$, such as the mass matrix. compute() evaluates
+     *   - the modal assurance criterion (MAC) of each pair of old and new
+     *     vectors;
+     *   - the coordinates \f$ T \f$ of the new vectors in the old basis,
+     *     from the projection
+     *     \f$ \Phi_1 \approx \Phi_0 T \f$ with
+     *     \f$ T = (\Phi_0^T M \Phi_0)^{-1} \Phi_0^T M \Phi_1 \f$;
+     *   - the largest relative norm of the part of a new vector that is
+     *     not in the span of the old basis, which measures how far the
+     *     subspace has moved;
+     *   - for bases of equal size, the orthogonal Procrustes rotation
+     *     \f$ R = U V^T \f$ from the singular value decomposition
+     *     \f$ \Phi_1^T M \Phi_0 = U S V^T \f$, which minimizes
+     *     \f$ \| \Phi_1 R - \Phi_0 \| \f$ and thereby aligns the new vectors
+     *     with the old ones, including their order and sign.
+     *
+     *   A reduced quantity \f$ A_0 = \Phi_0^T F(\Phi_0) \f$ with a linear
+     *   operator \f$ F \f$ that does not depend on the basis, such as the
+     *   generalized aerodynamic forces of a fixed flow, is then
+     *   approximated for the new basis by transform(),
+     *   \f$ A_1 \approx T^T A_0 T \f$, which is exact if the new vectors are
+     *   in the span of the old basis. Quantities whose operator changes
+     *   with the design, such as the reduced structural stiffness, must
+     *   still be computed again.
+     */
+    class BasisAlignment {
+        
+    public:
+        
+        BasisAlignment();
+        
+        virtual ~BasisAlignment();
+        
+        
+        /*!
+         *   computes the alignment of \p new_basis with \p old_basis, with the
+         *   inner product of \p M, or the Euclidean inner product if \p M
+         *   is \p nullptr. The vectors must have the same layout, and the
+         *   old basis must be linearly independent.
+         */
+        void compute(const std::vector<libMesh::NumericVector<Real>*>& old_basis,
+                     const std::vector<libMesh::NumericVector<Real>*>& new_basis,
+                     const libMesh::SparseMatrix<Real>* M = nullptr);
+        
+        
+        /*!
+         *   @returns the number of old and new vectors
+         */
+        unsigned int n_old() const {
+            return (unsigned int)_cross.rows();
+        }
+        
+        unsigned int n_new() const {
+            return (unsigned int)_cross.cols();
+        }
+        
+        
+        /*!
+         *   @returns the MAC of old vector \p i and new vector \p j in
+         *   entry \p (i,j)
+         */
+        const RealMatrixX& mac() const {
+            return _mac;
+        }
+        
+        
+        /*!
+         *   @returns the coordinates of the new vectors in the old basis
+         *   in the columns of the matrix
+         */
+        const RealMatrixX& coordinates() const {
+            return _T;
+        }
+        
+        
+        /*!
+         *   @returns the Procrustes rotation of the new basis onto the old
+         *   basis. This is available only for bases of the same size.
+         */
+        const RealMatrixX& rotation() const {
+            libmesh_assert_equal_to(n_old(), n_new());
+            return _R;
+        }
+        
+        
+        /*!
+         *   @returns the largest relative norm of the part of a new vector
+         *   that is orthogonal to the old basis, which is zero if the new
+         *   basis spans a subspace of the old basis
+         */
+        Real subspace_residual() const {
+            return _residual;
+        }
+        
+        
+        /*!
+         *   replaces the vectors of \p new_basis, which must be the new basis
+         *   given to compute(), with \f$ \Phi_1 R \f$, so that each vector is
+         *   aligned with the old vector of the same index. The MAC, the
+         *   coordinates and the rotation are updated for the rotated basis,
+         *   for which the rotation is the identity.
+         */
+        void rotate_basis(std::vector<libMesh::NumericVector<Real>*>& new_basis);
+        
+        
+        /*!
+         *   @returns \f$ T^T A T \f$, the approximation for the new basis of
+         *   the reduced quantity \p A of the old basis
+         */
+        RealMatrixX transform(const RealMatrixX& A) const;
+        
+        ComplexMatrixX transform(const ComplexMatrixX& A) const;
+        
+        
+    protected:
+        
+        /*!
+         *   computes the MAC, coordinates, residual and rotation from the
+         *   inner products
+         */
+        void _update();
+        
+        /*!
+         *   inner products of the old vectors, of the new vectors, and of
+         *   the old and new vectors, with the old vectors in the rows
+         */
+        RealMatrixX   _G0, _G1, _cross;
+        
+        /*!
+         *   MAC, coordinates of the new vectors and Procrustes rotation
+         */
+        RealMatrixX   _mac, _T, _R;
+        
+        /*!
+         *   largest relative norm of the parts of the new vectors outside
+         *   the span of the old basis
+         */
+        Real          _residual;
+    };
+}
+
+
+#endif // __mast__basis_alignment_h__
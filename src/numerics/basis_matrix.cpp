@@ -21,17 +21,210 @@
 // MAST includes
 #include "base/mast_data_types.h"
 #include "numerics/basis_matrix.h"
+#include "numerics/utility.h"
+#include "base/performance_log.h"
+
+// libMesh includes
+#include "libmesh/petsc_matrix.h"
+
 
 template <typename T>
 MAST::BasisMatrix<T>::BasisMatrix(const libMesh::Parallel::Communicator &comm_in):
-libMesh::ShellMatrix<T>(comm_in)
+libMesh::ShellMatrix<T>(comm_in),
+_V(PETSC_NULL)
 { }
 
+
+
 template <typename T>
-MAST::BasisMatrix<T>::~BasisMatrix()
-{ }
+MAST::BasisMatrix<T>::~BasisMatrix() {
+    
+    this->clear_dense_storage();
+}
+
+
+
+template <typename T>
+void
+MAST::BasisMatrix<T>::init_dense_storage() {
+    
+    MAST_LOG_SCOPE("init_dense_storage()", "BasisMatrix");
+    
+    libmesh_assert(modes.size() > 0);
+    
+    this->clear_dense_storage();
+    
+    const PetscInt
+    n_l = modes[0]->local_size(),
+    m_g = modes[0]->size(),
+    n   = (PetscInt)modes.size();
+    
+    PetscErrorCode ierr;
+    ierr = MatCreateDense(this->comm().get(), n_l, PETSC_DECIDE, m_g, n,
+                          PETSC_NULL, &_V);
+    CHKERRABORT(this->comm().get(), ierr);
+    
+    std::vector<libMesh::numeric_index_type> idx(n_l);
+    std::vector<T>                           vals;
+    for (PetscInt i=0; i<n_l; i++)
+        idx[i] = modes[0]->first_local_index() + i;
+    
+    // the local rows are stored column-wise in the array
+    PetscScalar* arr = PETSC_NULL;
+    Eigen::Map<RealMatrixX> v_l = _local_rows(_V, arr);
+    
+    for (unsigned int i=0; i<modes.size(); i++) {
+        
+        libmesh_assert_equal_to(modes[i]->local_size(), n_l);
+        
+        modes[i]->get(idx, vals);
+        for (PetscInt j=0; j<n_l; j++)
+            v_l(j, i) = vals[j];
+    }
+    
+    ierr = MatDenseRestoreArray(_V, &arr);
+    CHKERRABORT(this->comm().get(), ierr);
+    ierr = MatAssemblyBegin(_V, MAT_FINAL_ASSEMBLY);
+    CHKERRABORT(this->comm().get(), ierr);
+    ierr = MatAssemblyEnd(_V, MAT_FINAL_ASSEMBLY);
+    CHKERRABORT(this->comm().get(), ierr);
+}
+
+
+
+template <typename T>
+void
+MAST::BasisMatrix<T>::clear_dense_storage() {
+    
+    if (_V) {
+        
+        PetscErrorCode ierr = MatDestroy(&_V);
+        CHKERRABORT(this->comm().get(), ierr);
+    }
+}
+
+
+
+template <typename T>
+void
+MAST::BasisMatrix<T>::project(const libMesh::SparseMatrix<T>& A,
+                              RealMatrixX& a_r) const {
+    
+    MAST_LOG_SCOPE("project()", "BasisMatrix");
+    
+    libmesh_assert(_V);
+    
+    Mat
+    a  = dynamic_cast<const libMesh::PetscMatrix<T>&>(A).mat(),
+    av = PETSC_NULL;
+    
+    PetscErrorCode ierr;
+    ierr = MatMatMult(a, _V, MAT_INITIAL_MATRIX, PETSC_DEFAULT, &av);
+    CHKERRABORT(this->comm().get(), ierr);
+    
+    PetscScalar
+    *v_arr  = PETSC_NULL,
+    *av_arr = PETSC_NULL;
+    
+    Eigen::Map<RealMatrixX>
+    v_l  = _local_rows(_V, v_arr),
+    av_l = _local_rows(av, av_arr);
+    
+    a_r = v_l.transpose() * av_l;
+    
+    ierr = MatDenseRestoreArray(_V, &v_arr);
+    CHKERRABORT(this->comm().get(), ierr);
+    ierr = MatDenseRestoreArray(av, &av_arr);
+    CHKERRABORT(this->comm().get(), ierr);
+    ierr = MatDestroy(&av);
+    CHKERRABORT(this->comm().get(), ierr);
+    
+    MAST::parallel_sum(this->comm(), a_r);
+}
+
+
+
+template <typename T>
+void
+MAST::BasisMatrix<T>::project(const libMesh::NumericVector<T>& v,
+                              RealVectorX& v_r) const {
+    
+    libmesh_assert(_V);
+    
+    std::vector<libMesh::numeric_index_type> idx(v.local_size());
+    std::vector<T>                           vals;
+    for (unsigned int i=0; i<idx.size(); i++)
+        idx[i] = v.first_local_index() + i;
+    v.get(idx, vals);
+    
+    PetscScalar* arr = PETSC_NULL;
+    Eigen::Map<RealMatrixX> v_l = _local_rows(_V, arr);
+    
+    libmesh_assert_equal_to(v_l.rows(), idx.size());
+    
+    RealMatrixX
+    r = v_l.transpose() * Eigen::Map<const RealVectorX>(idx.size()? &vals[0]: nullptr,
+                                                        idx.size());
+    
+    PetscErrorCode ierr = MatDenseRestoreArray(_V, &arr);
+    CHKERRABORT(this->comm().get(), ierr);
+    
+    MAST::parallel_sum(this->comm(), r);
+    v_r = r.col(0);
+}
+
+
+
+template <typename T>
+void
+MAST::BasisMatrix<T>::reconstruct(const RealVectorX& v_r,
+                                  libMesh::NumericVector<T>& v) const {
+    
+    libmesh_assert(_V);
+    
+    PetscScalar* arr = PETSC_NULL;
+    Eigen::Map<RealMatrixX> v_l = _local_rows(_V, arr);
+    
+    libmesh_assert_equal_to(v_l.cols(), v_r.size());
+    libmesh_assert_equal_to(v_l.rows(), v.local_size());
+    
+    const RealVectorX
+    v_vals = v_l * v_r;
+    
+    PetscErrorCode ierr = MatDenseRestoreArray(_V, &arr);
+    CHKERRABORT(this->comm().get(), ierr);
+    
+    std::vector<libMesh::numeric_index_type> idx(v_vals.size());
+    std::vector<T>                           vals(v_vals.size());
+    for (unsigned int i=0; i<idx.size(); i++) {
+        idx[i]  = v.first_local_index() + i;
+        vals[i] = v_vals(i);
+    }
+    
+    v.insert(vals, idx);
+    v.close();
+}
+
+
+
+template <typename T>
+Eigen::Map<RealMatrixX>
+MAST::BasisMatrix<T>::_local_rows(Mat mat, PetscScalar*& arr) const {
+    
+    PetscInt m_l, n;
+    
+    PetscErrorCode ierr;
+    ierr = MatGetLocalSize(mat, &m_l, PETSC_NULL);
+    CHKERRABORT(this->comm().get(), ierr);
+    ierr = MatGetSize(mat, PETSC_NULL, &n);
+    CHKERRABORT(this->comm().get(), ierr);
+    ierr = MatDenseGetArray(mat, &arr);
+    CHKERRABORT(this->comm().get(), ierr);
+    
+    return Eigen::Map<RealMatrixX>(arr, m_l, n);
+}
 
 
 // explicit instantiations
-template MAST::BasisMatrix<Real>::BasisMatrix(const libMesh::Parallel::Communicator &comm_in);
+template class MAST::BasisMatrix<Real>;
 
@@ -24,9 +24,16 @@
 // C++ includes
 #include <vector>
 
+// MAST includes
+#include "base/mast_data_types.h"
+
 // libmesh includes
 #include "libmesh/shell_matrix.h"
 #include "libmesh/numeric_vector.h"
+#include "libmesh/sparse_matrix.h"
+
+// PETSc includes
+#include <petscmat.h>
 
 
 namespace MAST {
@@ -38,6 +45,10 @@ namespace MAST {
     public:
         BasisMatrix(const libMesh::Parallel::Communicator &comm_in);
         
+        /*!
+         *   deletes the dense matrix, if initialized. The vectors in
+         *   \p modes are not owned by this object.
+         */
         virtual ~BasisMatrix();
         
         
@@ -160,10 +171,74 @@ namespace MAST {
             return *(modes[i]);
         }
         
+        /*!
+         *   copies the vectors in \p modes to a distributed dense matrix
+         *   \f$ [V] \f$ in one contiguous allocation, with the rows
+         *   distributed as the entries of the vectors. This must be called
+         *   after the modes are set, and again if they are changed. The
+         *   dense matrix is used by the projections below.
+         */
+        void init_dense_storage();
+        
+        
+        /*!
+         *   deletes the dense matrix
+         */
+        void clear_dense_storage();
+        
+        
+        /*!
+         *   @returns true if the dense matrix is initialized
+         */
+        bool if_dense_storage() const {
+            return _V != PETSC_NULL;
+        }
+        
+        
+        /*!
+         *   computes the reduced matrix \f$ [V]^T [A] [V] \f$ in \p a_r,
+         *   with one product of the sparse \p A with the dense basis
+         *   followed by a dense product of the local rows, which is summed
+         *   over the processors. \p a_r is the same on all processors.
+         */
+        void project(const libMesh::SparseMatrix<T>& A,
+                     RealMatrixX& a_r) const;
+        
+        
+        /*!
+         *   computes \f$ [V]^T \{v\} \f$ in \p v_r with a product of the
+         *   local rows, which is summed over the processors.
+         */
+        void project(const libMesh::NumericVector<T>& v,
+                     RealVectorX& v_r) const;
+        
+        
+        /*!
+         *   computes \f$ \{v\} = [V] \{v_r\} \f$ from the local rows of
+         *   the dense matrix.
+         */
+        void reconstruct(const RealVectorX& v_r,
+                         libMesh::NumericVector<T>& v) const;
+        
+        
         /*!
          *   vector of modes
          */
         std::vector<libMesh::NumericVector<T>*> modes;
+        
+    protected:
+        
+        /*!
+         *   @returns the map of the local rows of the dense matrix
+         *   \p mat. \p arr is the array of \p mat, which must be restored
+         *   after use.
+         */
+        Eigen::Map<RealMatrixX> _local_rows(Mat mat, PetscScalar*& arr) const;
+        
+        /*!
+         *   distributed dense matrix of the modes, if initialized
+         */
+        Mat  _V;
     };
     
 }
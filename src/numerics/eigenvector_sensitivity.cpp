@@ -0,0 +1,251 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2017  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+// C++ includes
+#include <cmath>
+#include <algorithm>
+
+// MAST includes
+#include "numerics/eigenvector_sensitivity.h"
+#include "base/performance_log.h"
+
+
+template <typename ValType>
+MAST::EigenvectorSensitivity<ValType>::EigenvectorSensitivity():
+_initialized(false),
+_method(MAST::EigenvectorSensitivity<ValType>::NELSON),
+_norm_factor(1.),
+_lambda(0.),
+_yBx(0.),
+_k(0),
+_i(0),
+_tol(0.) {
+    
+}
+
+
+
+template <typename ValType>
+MAST::EigenvectorSensitivity<ValType>::~EigenvectorSensitivity() {
+    
+}
+
+
+
+template <typename ValType>
+void
+MAST::EigenvectorSensitivity<ValType>::init_nelson(const MatType& A,
+                                                   const MatType& B,
+                                                   ValType        lambda,
+                                                   const VecType& x,
+                                                   const VecType& y,
+                                                   bool           symmetric) {
+    
+    MAST_LOG_SCOPE("init_nelson()", "EigenvectorSensitivity");
+    
+    const unsigned int
+    n = (unsigned int)A.rows();
+    
+    libmesh_assert_greater(n, 1);
+    libmesh_assert_equal_to(A.cols(), n);
+    libmesh_assert_equal_to(B.rows(), n);
+    libmesh_assert_equal_to(x.size(),  n);
+    libmesh_assert_equal_to(y.size(),  n);
+    
+    _method      = NELSON;
+    _norm_factor = symmetric? 0.5: 1.;
+    _lambda      = lambda;
+    _x           = x;
+    _y           = y;
+    _Bx          = B * x;
+    _BHy         = B.adjoint() * y;
+    _yBx         = y.dot(_Bx);
+    
+    libmesh_assert(std::abs(_yBx) > 0.);
+    
+    // the component with the largest product of the right and left
+    // eigenvectors is removed
+    (x.cwiseAbs().cwiseProduct(y.cwiseAbs())).maxCoeff(&_k);
+    
+    MatType
+    op = A - lambda * B,
+    op_r(n-1, n-1);
+    
+    const unsigned int
+    m = n-1-_k;
+    
+    op_r.topLeftCorner    (_k, _k) = op.topLeftCorner    (_k, _k);
+    op_r.topRightCorner   (_k,  m) = op.topRightCorner   (_k,  m);
+    op_r.bottomLeftCorner ( m, _k) = op.bottomLeftCorner ( m, _k);
+    op_r.bottomRightCorner( m,  m) = op.bottomRightCorner( m,  m);
+    
+    _lu.compute(op_r);
+    
+    _initialized = true;
+}
+
+
+
+template <typename ValType>
+void
+MAST::EigenvectorSensitivity<ValType>::
+init_modal_expansion(const MatType& B,
+                     const VecType& lambdas,
+                     const MatType& X,
+                     const MatType& Y,
+                     unsigned int   i,
+                     bool           symmetric,
+                     Real           tol) {
+    
+    libmesh_assert_less(i, lambdas.size());
+    libmesh_assert_equal_to(X.cols(), lambdas.size());
+    libmesh_assert_equal_to(Y.cols(), lambdas.size());
+    libmesh_assert_equal_to(X.rows(), B.rows());
+    
+    _method      = MODAL_EXPANSION;
+    _norm_factor = symmetric? 0.5: 1.;
+    _lambdas     = lambdas;
+    _lambda      = lambdas(i);
+    _X           = X;
+    _Y           = Y;
+    _i           = i;
+    _tol         = tol;
+    _x           = X.col(i);
+    _y           = Y.col(i);
+    _Bx          = B * _x;
+    _BHy         = B.adjoint() * _y;
+    
+    // diagonal of the B-inner products of the modes
+    _d           = (Y.adjoint() * B * X).diagonal();
+    _yBx         = _d(i);
+    
+    libmesh_assert(std::abs(_yBx) > 0.);
+    
+    _initialized = true;
+}
+
+
+
+template <typename ValType>
+void
+MAST::EigenvectorSensitivity<ValType>::
+sensitivity(const std::vector<const MatType*>& dA,
+            const std::vector<const MatType*>& dB,
+            VecType&                           dlambda,
+            MatType&                           dx) const {
+    
+    MAST_LOG_SCOPE("sensitivity()", "EigenvectorSensitivity");
+    
+    libmesh_assert(_initialized);
+    libmesh_assert_equal_to(dA.size(), dB.size());
+    
+    const unsigned int
+    n  = (unsigned int)_x.size(),
+    np = (unsigned int)dA.size();
+    
+    // (A' - lambda B') x, and the normalization terms
+    MatType
+    g  = MatType::Zero(n, np);
+    VecType
+    c  = VecType::Zero(np);
+    
+    for (unsigned int p=0; p<np; p++) {
+        
+        if (dA[p])
+            g.col(p) = (*dA[p]) * _x;
+        
+        if (dB[p]) {
+            
+            VecType dBx = (*dB[p]) * _x;
+            g.col(p) -= _lambda * dBx;
+            c(p)      = -_norm_factor * _y.dot(dBx);
+        }
+    }
+    
+    dlambda = (_y.adjoint() * g).transpose() / _yBx;
+    dx.setZero(n, np);
+    
+    switch (_method) {
+            
+        case NELSON: {
+            
+            // right hand sides for all parameters, without the k^th row
+            const unsigned int
+            m = n-1-_k;
+            
+            MatType
+            f   = _Bx * dlambda.transpose() - g,
+            f_r (n-1, np);
+            
+            f_r.topRows   (_k) = f.topRows   (_k);
+            f_r.bottomRows( m) = f.bottomRows( m);
+            
+            MatType
+            v_r = _lu.solve(f_r);
+            
+            dx.topRows   (_k) = v_r.topRows   (_k);
+            dx.bottomRows( m) = v_r.bottomRows( m);
+            
+            // the normalization gives the component along x
+            for (unsigned int p=0; p<np; p++) {
+                
+                const ValType
+                a = (c(p) - _BHy.dot(dx.col(p))) / _yBx;
+                
+                dx.col(p) += a * _x;
+            }
+        }
+            break;
+            
+        case MODAL_EXPANSION: {
+            
+            const unsigned int
+            nm = (unsigned int)_lambdas.size();
+            
+            // modal participations y_j^H (A' - lambda B') x
+            MatType
+            a = _Y.adjoint() * g;
+            
+            for (unsigned int j=0; j<nm; j++) {
+                
+                if (j == _i)
+                    a.row(j) = c.transpose() / _d(j);
+                else if (std::abs(_lambda - _lambdas(j)) >
+                         _tol * std::max(std::abs(_lambda), 1.))
+                    a.row(j) /= (_d(j) * (_lambda - _lambdas(j)));
+                else
+                    a.row(j).setZero();
+            }
+            
+            dx = _X * a;
+        }
+            break;
+            
+        default:
+            libmesh_error();
+    }
+}
+
+
+
+// explicit instantiations
+template class MAST::EigenvectorSensitivity<Real>;
+template class MAST::EigenvectorSensitivity<Complex>;
+
@@ -0,0 +1,187 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2017  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+#ifndef __mast__eigenvector_sensitivity_h__
+#define __mast__eigenvector_sensitivity_h__
+
+// C++ includes
+#include <vector>
+
+// MAST includes
+#include "base/mast_data_types.h"
+
+
+namespace MAST {
+    
+    /*!
+     *   Computes the sensitivity of a simple eigenvalue \f$ \lambda \f$ and
+     *   the associated right eigenvector \f$ x \f$ of the dense generalized
+     *   eigenproblem \f$ A x = \lambda B x \f$ with respect to a set of
+     *   parameters, given the sensitivities of \f$ A \f$ and \f$ B \f$.
+     *   This is meant for the reduced-order problems of the flutter
+     *   solvers and of modal analyses. The eigenvalue sensitivity is
+     *   \f[ \frac{d\lambda}{dp} = \frac{y^H (A' - \lambda B') x}{y^H B x}, \f]
+     *   where \f$ y \f$ is the left eigenvector. The eigenvector is
+     *   normalized with \f$ y^H B x = \mbox{const} \f$. For symmetric problems,
+     *   \f$ y = x \f$ changes with the parameter, while \f$ y \f$ is held
+     *   fixed for non-symmetric problems, so that
+     *   \f$ y^H B x' = -c\ y^H B' x \f$ with \f$ c = 1/2 \f$ and \f$ c = 1 \f$,
+     *   respectively.
+     *
+     *   With Nelson's method the singular system
+     *   \f$ (A - \lambda B) x' = -(A' - \lambda B' - \lambda' B) x \f$ is solved
+     *   with the component of \f$ x' \f$ for which \f$ |x_k| |y_k| \f$ is
+     *   largest set to zero, after which the multiple of \f$ x \f$ that
+     *   satisfies the normalization is added. The reduced matrix is
+     *   factorized once in init_nelson(), and the sensitivities for all
+     *   parameters are obtained from one solve with multiple right hand
+     *   sides. With the modal expansion, \f$ x' \f$ is approximated in the
+     *   span of a set of eigenvectors, which requires no factorization,
+     *   but is exact only if all eigenvectors are provided.
+     *
+     *   \p ValType is either Real or Complex.
+     */
+    template <typename ValType>
+    class EigenvectorSensitivity {
+        
+    public:
+        
+        typedef Eigen::Matrix<ValType, Eigen::Dynamic, Eigen::Dynamic> MatType;
+        typedef Eigen::Matrix<ValType, Eigen::Dynamic, 1>              VecType;
+        
+        /*!
+         *   method used for the eigenvector sensitivity
+         */
+        enum MethodType {
+            NELSON,
+            MODAL_EXPANSION
+        };
+        
+        EigenvectorSensitivity();
+        
+        virtual ~EigenvectorSensitivity();
+        
+        
+        /*!
+         *   initializes Nelson's method for the eigenpair \p lambda, with
+         *   right and left eigenvectors \p x and \p y, of the problem
+         *   defined by \p A and \p B. For symmetric problems, \p y must be
+         *   the same as \p x. The reduced matrix is factorized here.
+         */
+        void init_nelson(const MatType& A,
+                         const MatType& B,
+                         ValType        lambda,
+                         const VecType& x,
+                         const VecType& y,
+                         bool           symmetric);
+        
+        
+        /*!
+         *   initializes the modal expansion for the \p i^th eigenpair of the
+         *   set of eigenvalues \p lambdas with right and left eigenvectors
+         *   stored as columns of \p X and \p Y. The eigenvectors must be
+         *   B-orthogonal, \f$ y_j^H B x_k = 0 \f$ for \f$ j \ne k \f$, which is
+         *   the case for the eigenvectors of distinct eigenvalues. The
+         *   contributions of eigenvalues within a relative distance of
+         *   \p tol of \p lambdas(i) are not included.
+         */
+        void init_modal_expansion(const MatType& B,
+                                  const VecType& lambdas,
+                                  const MatType& X,
+                                  const MatType& Y,
+                                  unsigned int   i,
+                                  bool           symmetric,
+                                  Real           tol = 1.e-10);
+        
+        
+        /*!
+         *   @returns the method for which this object was initialized
+         */
+        MethodType method() const {
+            return _method;
+        }
+        
+        
+        /*!
+         *   computes the eigenvalue and eigenvector sensitivities with
+         *   respect to each parameter \p p, for which \p dA[p] and \p dB[p]
+         *   are the matrix sensitivities. A nullptr is a zero matrix. The
+         *   eigenvalue sensitivities are returned in \p dlambda, and the
+         *   eigenvector sensitivities as the columns of \p dx.
+         */
+        void sensitivity(const std::vector<const MatType*>& dA,
+                         const std::vector<const MatType*>& dB,
+                         VecType&                           dlambda,
+                         MatType&                           dx) const;
+        
+    protected:
+        
+        /*!
+         *   flag to indicate that the object is initialized, and the method
+         */
+        bool                            _initialized;
+        
+        MethodType                      _method;
+        
+        /*!
+         *   factor \f$ c \f$ of the normalization
+         */
+        Real                            _norm_factor;
+        
+        /*!
+         *   eigenvalue and eigenvectors
+         */
+        ValType                         _lambda;
+        
+        VecType                         _x, _y;
+        
+        /*!
+         *   \f$ B x \f$, \f$ B^H y \f$ and \f$ y^H B x \f$
+         */
+        VecType                         _Bx, _BHy;
+        
+        ValType                         _yBx;
+        
+        /*!
+         *   index of the component removed for Nelson's method, and the
+         *   factorization of the reduced matrix
+         */
+        unsigned int                    _k;
+        
+        Eigen::PartialPivLU<MatType>    _lu;
+        
+        /*!
+         *   eigenvalues, eigenvectors and B-inner products of the modal
+         *   expansion, and the index of the eigenpair
+         */
+        VecType                         _lambdas;
+        
+        MatType                         _X, _Y;
+        
+        VecType                         _d;
+        
+        unsigned int                    _i;
+        
+        Real                            _tol;
+    };
+}
+
+
+#endif // __mast__eigenvector_sensitivity_h__
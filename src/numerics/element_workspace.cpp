@@ -0,0 +1,119 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2017  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+// MAST includes
+#include "numerics/element_workspace.h"
+
+
+MAST::ElementWorkspace::ElementWorkspace():
+_n_matrices_used(0),
+_n_vectors_used(0),
+_n_operators_used(0) {
+    
+}
+
+
+
+MAST::ElementWorkspace::~ElementWorkspace() {
+    
+}
+
+
+
+MAST::ElementWorkspace&
+MAST::ElementWorkspace::local() {
+    
+    static thread_local MAST::ElementWorkspace w;
+    return w;
+}
+
+
+
+MAST::ElementWorkspace::Scope::Scope(MAST::ElementWorkspace& w):
+_w(w),
+_n_matrices0(w._n_matrices_used),
+_n_vectors0(w._n_vectors_used),
+_n_operators0(w._n_operators_used) {
+    
+}
+
+
+
+MAST::ElementWorkspace::Scope::~Scope() {
+    
+    // scopes are destroyed in the reverse order of their creation, so
+    // that the objects taken after this scope was created are all
+    // taken by this scope
+    libmesh_assert_greater_equal(_w._n_matrices_used,  _n_matrices0);
+    libmesh_assert_greater_equal(_w._n_vectors_used,   _n_vectors0);
+    libmesh_assert_greater_equal(_w._n_operators_used, _n_operators0);
+    
+    _w._n_matrices_used  = _n_matrices0;
+    _w._n_vectors_used   = _n_vectors0;
+    _w._n_operators_used = _n_operators0;
+}
+
+
+
+RealMatrixX&
+MAST::ElementWorkspace::Scope::matrix() {
+    
+    if (_w._n_matrices_used == _w._matrices.size())
+        _w._matrices.push_back(RealMatrixX());
+    
+    return _w._matrices[_w._n_matrices_used++];
+}
+
+
+
+RealMatrixX&
+MAST::ElementWorkspace::Scope::matrix(unsigned int m, unsigned int n) {
+    
+    // the memory is only reallocated if the number of entries changes
+    RealMatrixX& mat = this->matrix();
+    mat.setZero(m, n);
+    return mat;
+}
+
+
+
+RealVectorX&
+MAST::ElementWorkspace::Scope::vector(unsigned int n) {
+    
+    if (_w._n_vectors_used == _w._vectors.size())
+        _w._vectors.push_back(RealVectorX());
+    
+    RealVectorX& vec = _w._vectors[_w._n_vectors_used++];
+    vec.setZero(n);
+    return vec;
+}
+
+
+
+MAST::FEMOperatorMatrix&
+MAST::ElementWorkspace::Scope::fem_operator() {
+    
+    // deque::resize default-constructs the new element in place, since
+    // the operator matrix owns its shape function vectors
+    if (_w._n_operators_used == _w._operators.size())
+        _w._operators.resize(_w._operators.size()+1);
+    
+    return _w._operators[_w._n_operators_used++];
+}
+
@@ -0,0 +1,129 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2017  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef __mast__element_workspace__
+#define __mast__element_workspace__
+
+// C++ includes
+#include <deque>
+
+
+// MAST includes
+#include "base/mast_data_types.h"
+#include "numerics/fem_operator_matrix.h"
+
+
+namespace MAST {
+    
+    /*!
+     *    Provides the temporary matrices, vectors and operator matrices
+     *    used by element calculations. Each thread has its own workspace,
+     *    obtained with local(). The objects are taken from the workspace
+     *    with a Scope, and are returned to it when the scope is destroyed.
+     *    Since the objects retain their memory, the element calculations
+     *    do not allocate memory once the objects have reached the size
+     *    needed for the element type. Scopes can be nested, for example
+     *    when an element calculation calls another one, and must be
+     *    destroyed in the reverse order of their creation.
+     */
+    class ElementWorkspace {
+        
+    public:
+        
+        ElementWorkspace();
+        
+        virtual ~ElementWorkspace();
+        
+        
+        /*!
+         *    @returns the workspace of the calling thread
+         */
+        static MAST::ElementWorkspace& local();
+        
+        
+        /*!
+         *    Takes objects from a workspace, and returns them on
+         *    destruction. The references returned by the scope are valid
+         *    until it is destroyed.
+         */
+        class Scope {
+            
+        public:
+            
+            Scope(MAST::ElementWorkspace& w);
+            
+            ~Scope();
+            
+            /*!
+             *   @returns a matrix with zero values of size \p m x \p n
+             */
+            RealMatrixX& matrix(unsigned int m, unsigned int n);
+            
+            /*!
+             *   @returns a matrix, the size and values of which are set
+             *   by the caller, for example by the evaluation of a property.
+             */
+            RealMatrixX& matrix();
+            
+            /*!
+             *   @returns a vector with zero values of size \p n
+             */
+            RealVectorX& vector(unsigned int n);
+            
+            /*!
+             *   @returns an operator matrix that must be initialized by the
+             *   caller
+             */
+            MAST::FEMOperatorMatrix& fem_operator();
+            
+        protected:
+            
+            MAST::ElementWorkspace& _w;
+            
+            /*!
+             *   number of objects of each type in use when the scope
+             *   was created
+             */
+            const unsigned int _n_matrices0, _n_vectors0, _n_operators0;
+        };
+        
+    protected:
+        
+        /*!
+         *    objects of the workspace, of which the first \p _n_*_used
+         *    are taken by the existing scopes. A deque does not move its
+         *    elements when it grows, so that the references given out
+         *    by the scopes remain valid.
+         */
+        std::deque<RealMatrixX>                 _matrices;
+        
+        std::deque<RealVectorX>                 _vectors;
+        
+        std::deque<MAST::FEMOperatorMatrix>     _operators;
+        
+        unsigned int                            _n_matrices_used;
+        
+        unsigned int                            _n_vectors_used;
+        
+        unsigned int                            _n_operators_used;
+    };
+}
+
+
+#endif // __mast__element_workspace__
@@ -33,6 +33,9 @@ _n_dofs_per_var(0)
 MAST::FEMOperatorMatrix::~FEMOperatorMatrix()
 {
     this->clear();
+    
+    for (unsigned int i=0; i<_free_shape_functions.size(); i++)
+        delete _free_shape_functions[i];
 }
 
 
@@ -32,6 +32,10 @@
 
 namespace MAST {
     
+    // Forward declarations
+    class FEMOperatorMatrixBatch;
+    
+    
     class FEMOperatorMatrix
     {
     public:
@@ -42,7 +46,10 @@ namespace MAST {
         
         
         /*!
-         *   clears the data structures
+         *   clears the data structures. The shape function vectors are
+         *   retained for reuse by the next reinit(), so that an operator
+         *   reinitialized for each element or quadrature point does not
+         *   allocate memory once it has reached its size.
          */
         void clear();
         
@@ -116,6 +123,23 @@ namespace MAST {
         void right_multiply_transpose(T& r, const MAST::FEMOperatorMatrix& m) const;
         
         
+        /*!
+         *   [R] += a * [this]^T * [D] * [B]. Only the blocks of [R] for
+         *   pairs of discrete variables with non-zero shape functions in
+         *   both operators are computed, and zero entries of [D] are
+         *   skipped. This is used for the element matrices of operators
+         *   that couple only a subset of the variables, for example the
+         *   membrane and bending strains of a plate, and does not need the
+         *   intermediate products of left_multiply() and
+         *   right_multiply_transpose().
+         */
+        template <typename T>
+        void add_transpose_product(T& r,
+                                   const Real a,
+                                   const T& d,
+                                   const MAST::FEMOperatorMatrix& b) const;
+        
+        
         /*!
          *   [R] = [M] * [this]
          */
@@ -132,6 +156,14 @@ namespace MAST {
         
     protected:
         
+        friend class MAST::FEMOperatorMatrixBatch;
+        
+        /*!
+         *   @returns a shape function vector from the retained vectors,
+         *   or a new vector if none is available
+         */
+        RealVectorX* _new_shape_function();
+        
         /*!
          *    number of rows of the operator
          */
@@ -154,6 +186,11 @@ namespace MAST {
          *    value is set in the vector.
          */
         std::vector<RealVectorX*>  _var_shape_functions;
+        
+        /*!
+         *    vectors retained from earlier initializations for reuse
+         */
+        std::vector<RealVectorX*>  _free_shape_functions;
     };
     
 }
@@ -168,19 +205,34 @@ MAST::FEMOperatorMatrix::clear() {
     _n_discrete_vars     = 0;
     _n_dofs_per_var      = 0;
     
-    // iterate over the shape function entries and delete the non-nullptr values
+    // iterate over the shape function entries and retain the non-nullptr
+    // values for reuse
     std::vector<RealVectorX*>::iterator it = _var_shape_functions.begin(),
     end = _var_shape_functions.end();
     
     for ( ; it!=end; it++)
         if ( *it != nullptr)
-            delete *it;
+            _free_shape_functions.push_back(*it);
     
     _var_shape_functions.clear();
 }
 
 
 
+inline
+RealVectorX*
+MAST::FEMOperatorMatrix::_new_shape_function() {
+    
+    if (_free_shape_functions.empty())
+        return new RealVectorX;
+    
+    RealVectorX* vec = _free_shape_functions.back();
+    _free_shape_functions.pop_back();
+    return vec;
+}
+
+
+
 
 inline
 void
@@ -219,7 +271,7 @@ set_shape_function(unsigned int interpolated_var,
     
     if (!vec)
     {
-        vec = new RealVectorX;
+        vec = _new_shape_function();
         _var_shape_functions[discrete_var*_n_interpolated_vars+interpolated_var] = vec;
     }
     
@@ -243,7 +295,7 @@ reinit(unsigned int n_vars,
     
     for (unsigned int i=0; i<n_vars; i++)
     {
-        RealVectorX*  vec = new RealVectorX;
+        RealVectorX*  vec = _new_shape_function();
         *vec = shape_func;
         _var_shape_functions[i*n_vars+i] = vec;
     }
@@ -386,6 +438,50 @@ right_multiply_transpose(T& r, const MAST::FEMOperatorMatrix& m) const {
 
 
 
+template <typename T>
+inline
+void
+MAST::FEMOperatorMatrix::
+add_transpose_product(T& r,
+                      const Real a,
+                      const T& d,
+                      const MAST::FEMOperatorMatrix& b) const {
+    
+    libmesh_assert_equal_to(r.rows(), n());
+    libmesh_assert_equal_to(r.cols(), b.n());
+    libmesh_assert_equal_to(d.rows(), _n_interpolated_vars);
+    libmesh_assert_equal_to(d.cols(), b._n_interpolated_vars);
+    
+    unsigned int index_i, index_j = 0;
+    
+    // each non-zero entry d(k,l) contributes the outer product of the
+    // shape functions of row k of this and row l of b to the block of
+    // the discrete variables i and j
+    for (unsigned int i=0; i<_n_discrete_vars; i++)
+        for (unsigned int j=0; j<b._n_discrete_vars; j++)
+            for (unsigned int k=0; k<_n_interpolated_vars; k++) {
+                
+                index_i = i*_n_interpolated_vars+k;
+                if (!_var_shape_functions[index_i])
+                    continue;
+                
+                for (unsigned int l=0; l<b._n_interpolated_vars; l++) {
+                    
+                    index_j = j*b._n_interpolated_vars+l;
+                    if (!b._var_shape_functions[index_j] || d(k,l) == 0.)
+                        continue;
+                    
+                    r.block(i*_n_dofs_per_var, j*b._n_dofs_per_var,
+                            _n_dofs_per_var, b._n_dofs_per_var).noalias() +=
+                    (a * d(k,l)) *
+                    (*_var_shape_functions[index_i]) *
+                    b._var_shape_functions[index_j]->transpose();
+                }
+            }
+}
+
+
+
 template <typename T>
 inline
 void
@@ -0,0 +1,105 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2017  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+// MAST includes
+#include "numerics/fem_operator_matrix_batch.h"
+
+
+MAST::FEMOperatorMatrixBatch::FEMOperatorMatrixBatch():
+_n_batch(0),
+_n_interpolated_vars(0),
+_n_discrete_vars(0),
+_n_dofs_per_var(0)
+{
+    
+}
+
+
+MAST::FEMOperatorMatrixBatch::~FEMOperatorMatrixBatch()
+{
+    this->clear();
+}
+
+
+
+void
+MAST::FEMOperatorMatrixBatch::clear() {
+    
+    _n_batch             = 0;
+    _n_interpolated_vars = 0;
+    _n_discrete_vars     = 0;
+    _n_dofs_per_var      = 0;
+    
+    // iterate over the block entries and delete the non-nullptr values
+    std::vector<RealMatrixX*>::iterator it = _block_shape_functions.begin(),
+    end = _block_shape_functions.end();
+    
+    for ( ; it!=end; it++)
+        if ( *it != nullptr)
+            delete *it;
+    
+    _block_shape_functions.clear();
+}
+
+
+
+void
+MAST::FEMOperatorMatrixBatch::
+reinit(const std::vector<const MAST::FEMOperatorMatrix*>& ops) {
+    
+    this->clear();
+    
+    // nothing to be done for an empty batch
+    if (!ops.size())
+        return;
+    
+    const MAST::FEMOperatorMatrix& op0 = *ops[0];
+    
+    _n_batch             = (unsigned int)ops.size();
+    _n_interpolated_vars = op0._n_interpolated_vars;
+    _n_discrete_vars     = op0._n_discrete_vars;
+    _n_dofs_per_var      = op0._n_dofs_per_var;
+    
+    _block_shape_functions.resize(op0._var_shape_functions.size(), nullptr);
+    
+    for (unsigned int i=0; i<_block_shape_functions.size(); i++)
+        if (op0._var_shape_functions[i])
+            _block_shape_functions[i] =
+            new RealMatrixX(RealMatrixX::Zero(_n_dofs_per_var, _n_batch));
+    
+    for (unsigned int q=0; q<_n_batch; q++) {
+        
+        const MAST::FEMOperatorMatrix& op = *ops[q];
+        
+        // all operators must have the same dimensions and sparsity
+        libmesh_assert_equal_to(op._n_interpolated_vars, _n_interpolated_vars);
+        libmesh_assert_equal_to(op._n_discrete_vars, _n_discrete_vars);
+        libmesh_assert_equal_to(op._n_dofs_per_var, _n_dofs_per_var);
+        
+        for (unsigned int i=0; i<_block_shape_functions.size(); i++) {
+            
+            libmesh_assert_equal_to(op._var_shape_functions[i] == nullptr,
+                                    _block_shape_functions[i] == nullptr);
+            
+            if (_block_shape_functions[i])
+                _block_shape_functions[i]->col(q) = *op._var_shape_functions[i];
+        }
+    }
+}
+
@@ -0,0 +1,326 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2017  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef __mast__fem_operator_matrix_batch__
+#define __mast__fem_operator_matrix_batch__
+
+// C++ includes
+#include <vector>
+
+
+// MAST includes
+#include "base/mast_data_types.h"
+#include "numerics/fem_operator_matrix.h"
+
+
+
+
+namespace MAST {
+
+    /*!
+     *   Stores a set of \p FEMOperatorMatrix objects with identical
+     *   block sparsity, for example the strain operator at all quadrature
+     *   points of an element, or the operator at the same quadrature point
+     *   of several elements. The shape functions for each block are packed
+     *   in a contiguous column-major matrix with one column per operator,
+     *   so that the products below reduce to Eigen GEMV/GEMM kernels over
+     *   the whole batch instead of scalar loops over one operator at a time.
+     *
+     *   In the methods below, operator \p q of the batch is referred to
+     *   as \f$ [B_q] \f$.
+     */
+    class FEMOperatorMatrixBatch
+    {
+    public:
+        FEMOperatorMatrixBatch();
+
+
+        virtual ~FEMOperatorMatrixBatch();
+
+
+        /*!
+         *   clears the data structures
+         */
+        void clear();
+
+
+        /*!
+         *   initializes the batch from the operators in \p ops. All
+         *   operators must have the same dimensions and the same
+         *   non-zero blocks.
+         */
+        void reinit(const std::vector<const MAST::FEMOperatorMatrix*>& ops);
+
+
+        /*!
+         *   @returns the number of operators in this batch
+         */
+        unsigned int n_batch() const {return _n_batch;}
+
+        unsigned int m() const {return _n_interpolated_vars;}
+
+        unsigned int n() const {return _n_discrete_vars*_n_dofs_per_var;}
+
+
+        /*!
+         *   column q of res = [B_q] * v. \p v is either a single vector
+         *   (same for all operators), or a matrix with one column per
+         *   operator. \p res is resized to m() x n_batch().
+         */
+        template <typename T1, typename T2>
+        void vector_mult(T1& res, const T2& v) const;
+
+
+        /*!
+         *   column q of res = [B_q]^T * v_q, where v_q is column q of \p v.
+         *   \p res is resized to n() x n_batch().
+         */
+        template <typename T1, typename T2>
+        void vector_mult_transpose(T1& res, const T2& v) const;
+
+
+        /*!
+         *   res += sum_q w_q [B_q]^T * v_q, where v_q is column q of \p v.
+         *   This is the quadrature sum used for element residuals, with
+         *   \p w being the JxW values.
+         */
+        template <typename T1, typename T2>
+        void vector_mult_transpose_sum(T1& res,
+                                       const T2& v,
+                                       const RealVectorX& w) const;
+
+
+        /*!
+         *   [R_q] = [B_q] * [M], for a matrix \p m shared by all operators.
+         *   \p r is resized to n_batch() matrices of size m() x m.cols().
+         */
+        template <typename T>
+        void right_multiply(std::vector<T>& r, const T& m) const;
+
+
+        /*!
+         *   [R_q] = [M_q] * [B_q]^T
+         */
+        template <typename T>
+        void left_multiply_transpose(std::vector<T>& r,
+                                     const std::vector<T>& m) const;
+
+
+    protected:
+
+        /*!
+         *    number of operators in the batch
+         */
+        unsigned int _n_batch;
+
+        /*!
+         *    number of rows of the operator
+         */
+        unsigned int _n_interpolated_vars;
+
+        /*!
+         *    number of discrete variables in the system
+         */
+        unsigned int _n_discrete_vars;
+
+        /*!
+         *    number of dofs for each variable
+         */
+        unsigned int _n_dofs_per_var;
+
+        /*!
+         *    shape function values of the i_th interpolated var and j_th
+         *    discrete var for all operators, stored in column major order
+         *    of blocks, same as \p FEMOperatorMatrix. Each entry is a
+         *    _n_dofs_per_var x _n_batch matrix, nullptr if the block is zero.
+         */
+        std::vector<RealMatrixX*>  _block_shape_functions;
+    };
+
+}
+
+
+
+template <typename T1, typename T2>
+inline
+void
+MAST::FEMOperatorMatrixBatch::
+vector_mult(T1& res, const T2& v) const {
+
+    typedef typename T1::Scalar ScalarType;
+
+    libmesh_assert_equal_to(v.rows(), n());
+    libmesh_assert(v.cols() == 1 || v.cols() == _n_batch);
+
+    res.setZero(_n_interpolated_vars, _n_batch);
+    const unsigned int nd = _n_dofs_per_var;
+    unsigned int index = 0;
+
+    for (unsigned int i=0; i<_n_interpolated_vars; i++) // row
+        for (unsigned int j=0; j<_n_discrete_vars; j++) { // column
+            index = j*_n_interpolated_vars+i;
+            if (_block_shape_functions[index]) { // check if this is non-nullptr
+                const RealMatrixX& N = *_block_shape_functions[index];
+                if (v.cols() == 1)
+                    // same vector for all operators: one GEMV
+                    res.row(i) +=
+                    v.block(j*nd, 0, nd, 1).transpose() *
+                    N.template cast<ScalarType>();
+                else
+                    res.row(i) +=
+                    (N.template cast<ScalarType>().array() *
+                     v.block(j*nd, 0, nd, _n_batch).array()).colwise().sum().matrix();
+            }
+        }
+}
+
+
+
+template <typename T1, typename T2>
+inline
+void
+MAST::FEMOperatorMatrixBatch::
+vector_mult_transpose(T1& res, const T2& v) const {
+
+    typedef typename T1::Scalar ScalarType;
+
+    libmesh_assert_equal_to(v.rows(), _n_interpolated_vars);
+    libmesh_assert_equal_to(v.cols(), _n_batch);
+
+    res.setZero(n(), _n_batch);
+    const unsigned int nd = _n_dofs_per_var;
+    unsigned int index = 0;
+
+    for (unsigned int i=0; i<_n_interpolated_vars; i++) // row
+        for (unsigned int j=0; j<_n_discrete_vars; j++) { // column
+            index = j*_n_interpolated_vars+i;
+            if (_block_shape_functions[index]) // check if this is non-nullptr
+                res.block(j*nd, 0, nd, _n_batch).array() +=
+                _block_shape_functions[index]->template cast<ScalarType>().array().rowwise() *
+                v.row(i).array();
+        }
+}
+
+
+
+template <typename T1, typename T2>
+inline
+void
+MAST::FEMOperatorMatrixBatch::
+vector_mult_transpose_sum(T1& res,
+                          const T2& v,
+                          const RealVectorX& w) const {
+
+    typedef typename T1::Scalar ScalarType;
+
+    libmesh_assert_equal_to(res.size(), n());
+    libmesh_assert_equal_to(v.rows(), _n_interpolated_vars);
+    libmesh_assert_equal_to(v.cols(), _n_batch);
+    libmesh_assert_equal_to(w.size(), _n_batch);
+
+    const unsigned int nd = _n_dofs_per_var;
+    unsigned int index = 0;
+
+    for (unsigned int i=0; i<_n_interpolated_vars; i++) { // row
+
+        // weighted values of this row for all operators
+        const Eigen::Matrix<ScalarType, Eigen::Dynamic, 1>
+        vw = (v.row(i).transpose().array() *
+              w.template cast<ScalarType>().array()).matrix();
+
+        for (unsigned int j=0; j<_n_discrete_vars; j++) { // column
+            index = j*_n_interpolated_vars+i;
+            if (_block_shape_functions[index]) // check if this is non-nullptr
+                res.segment(j*nd, nd) +=
+                _block_shape_functions[index]->template cast<ScalarType>() * vw;
+        }
+    }
+}
+
+
+
+template <typename T>
+inline
+void
+MAST::FEMOperatorMatrixBatch::
+right_multiply(std::vector<T>& r, const T& m) const {
+
+    libmesh_assert_equal_to(m.rows(), n());
+
+    typedef typename T::Scalar ScalarType;
+
+    r.resize(_n_batch);
+    for (unsigned int q=0; q<_n_batch; q++)
+        r[q].setZero(_n_interpolated_vars, m.cols());
+
+    const unsigned int nd = _n_dofs_per_var;
+    unsigned int index = 0;
+    T prod;
+
+    for (unsigned int i=0; i<_n_interpolated_vars; i++) // row
+        for (unsigned int j=0; j<_n_discrete_vars; j++) { // column of operator
+            index = j*_n_interpolated_vars+i;
+            if (_block_shape_functions[index]) { // check if this is non-nullptr
+                // row q of prod is row i of R_q contributed by this block
+                prod.noalias() =
+                _block_shape_functions[index]->template cast<ScalarType>().transpose() *
+                m.block(j*nd, 0, nd, m.cols());
+                for (unsigned int q=0; q<_n_batch; q++)
+                    r[q].row(i) += prod.row(q);
+            }
+        }
+}
+
+
+
+template <typename T>
+inline
+void
+MAST::FEMOperatorMatrixBatch::
+left_multiply_transpose(std::vector<T>& r,
+                        const std::vector<T>& m) const {
+
+    libmesh_assert_equal_to(m.size(), _n_batch);
+
+    typedef typename T::Scalar ScalarType;
+
+    r.resize(_n_batch);
+
+    const unsigned int nd = _n_dofs_per_var;
+    unsigned int index = 0;
+
+    for (unsigned int q=0; q<_n_batch; q++) {
+
+        libmesh_assert_equal_to(m[q].cols(), n());
+        r[q].setZero(m[q].rows(), _n_interpolated_vars);
+
+        for (unsigned int i=0; i<_n_interpolated_vars; i++) // row
+            for (unsigned int j=0; j<_n_discrete_vars; j++) { // column of operator
+                index = j*_n_interpolated_vars+i;
+                if (_block_shape_functions[index]) // check if this is non-nullptr
+                    r[q].col(i) +=
+                    m[q].block(0, j*nd, m[q].rows(), nd) *
+                    _block_shape_functions[index]->col(q).template cast<ScalarType>();
+            }
+    }
+}
+
+
+
+#endif // __mast__fem_operator_matrix_batch__
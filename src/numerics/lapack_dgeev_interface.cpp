@@ -18,6 +18,10 @@
  */
 
 
+// C++ includes
+#include <algorithm>
+
+
 // MAST includes
 #include "numerics/lapack_dgeev_interface.h"
 
@@ -30,48 +34,114 @@ MAST::LAPACK_DGEEV::compute(const RealMatrixX &A,
     
     _A = A;
     
-    RealMatrixX
-    Amat = A;
+    // the working copy keeps its storage if the size is unchanged
+    _Amat = A;
+    
+    _compute(_Amat, computeEigenvectors);
+    _if_matrices = true;
+}
+
+
+
+void
+MAST::LAPACK_DGEEV::compute_in_place(RealMatrixX &A,
+                                     bool computeEigenvectors) {
+    
+    libmesh_assert(A.cols() == A.rows());
+    
+    _if_matrices = false;
+    _compute(A, computeEigenvectors);
+}
+
+
+
+void
+MAST::LAPACK_DGEEV::
+compute_batch(const std::vector<MAST::LAPACK_DGEEV*>& solvers,
+              const std::vector<const RealMatrixX*>& A,
+              bool computeEigenvectors) {
+    
+    libmesh_assert_equal_to(solvers.size(), A.size());
+    
+    libMesh::Threads::parallel_for
+    (libMesh::Threads::BlockedRange<unsigned int>(0, (unsigned int)solvers.size(), 1),
+     MAST::LAPACK_DGEEV::BatchCompute(solvers, A, computeEigenvectors));
+}
+
+
+
+void
+MAST::LAPACK_DGEEV::BatchCompute::
+operator() (const libMesh::Threads::BlockedRange<unsigned int>& range) const {
+    
+    for (unsigned int i=range.begin(); i<range.end(); i++)
+        _solvers[i]->compute(*_A[i], _vecs);
+}
+
+
+
+void
+MAST::LAPACK_DGEEV::_compute(RealMatrixX &Amat,
+                             bool computeEigenvectors) {
     
-    int n = (int)A.cols();
+    int n = (int)Amat.cols();
     
     char L='N',R='N';
     
     if (computeEigenvectors) {
         
         L = 'V'; R = 'V';
-        VL.setZero(n, n);
-        VR.setZero(n, n);
+        VL.resize(n, n);
+        VR.resize(n, n);
     }
     
     int
-    lwork=16*n;
+    lwork=0;
     
     info_val=-1;
     
-    RealVectorX
-    work,
-    w_r,
-    w_i;
+    W.resize(n);
+    _w_r.resize(n);
+    _w_i.resize(n);
+    _vecl.resize(n,n);
+    _vecr.resize(n,n);
+    
+    Real
+    *a_vals    = Amat.data(),
+    *w_r_v     = _w_r.data(),
+    *w_i_v     = _w_i.data(),
+    *vecl_v    = _vecl.data(),
+    *vecr_v    = _vecr.data();
     
-    RealMatrixX
-    vecl,
-    vecr;
+    // query the optimal workspace size for this problem
+    if (n != _work_n || computeEigenvectors != _work_vecs) {
+        
+        Real
+        opt        = 0.;
+        lwork      = -1;
+        
+        dgeev_(&L, &R, &n,
+               &(a_vals[0]), &n,
+               &(w_r_v[0]), &(w_i_v[0]),
+               &(vecl_v[0]), &n, &(vecr_v[0]), &n,
+               &opt, &lwork,
+               &info_val);
+        
+        if (info_val == 0)
+            lwork = std::max((int)opt, std::max(1, 4*n));
+        else
+            lwork = 16*n;
+        
+        _work.setZero(lwork);
+        _work_n    = n;
+        _work_vecs = computeEigenvectors;
+        info_val   = -1;
+    }
     
-    W.setZero(n);
-    work.setZero(lwork);
-    w_r.setZero(n);
-    w_i.setZero(n);
-    vecl.setZero(n,n);
-    vecr.setZero(n,n);
+    lwork = (int)_work.size();
     
     Real
-    *a_vals    = Amat.data(),
-    *w_r_v     = w_r.data(),
-    *w_i_v     = w_i.data(),
-    *vecl_v    = vecl.data(),
-    *vecr_v    = vecr.data(),
-    *work_v    = work.data();
+    *work_v    = _work.data();
     
     
     dgeev_(&L, &R, &n,
@@ -87,24 +157,24 @@ MAST::LAPACK_DGEEV::compute(const RealMatrixX &A,
         
         // if the imaginary part of the eigenvalue is non-zero, it is a
         // complex conjugate
-        if (w_i(n_located) != 0.) { // complex conjugate
+        if (_w_i(n_located) != 0.) { // complex conjugate
             
-            W(  n_located) = std::complex<double>(w_r(n_located),  w_i(n_located));
-            W(1+n_located) = std::complex<double>(w_r(n_located), -w_i(n_located));
+            W(  n_located) = std::complex<double>(_w_r(n_located),  _w_i(n_located));
+            W(1+n_located) = std::complex<double>(_w_r(n_located), -_w_i(n_located));
             
             // copy the eigenvectors if they were requested
             if (computeEigenvectors) {
                 
                 std::complex<double> iota = std::complex<double>(0, 1.);
                 
-                VL.col(  n_located) = (vecl.col(  n_located).cast<Complex>() +
-                                       vecl.col(1+n_located).cast<Complex>() * iota);
-                VL.col(1+n_located) = (vecl.col(  n_located).cast<Complex>() -
-                                       vecl.col(1+n_located).cast<Complex>() * iota);
-                VR.col(  n_located) = (vecr.col(  n_located).cast<Complex>() +
-                                       vecr.col(1+n_located).cast<Complex>() * iota);
-                VR.col(1+n_located) = (vecr.col(  n_located).cast<Complex>() -
-                                       vecr.col(1+n_located).cast<Complex>() * iota);
+                VL.col(  n_located) = (_vecl.col(  n_located).cast<Complex>() +
+                                       _vecl.col(1+n_located).cast<Complex>() * iota);
+                VL.col(1+n_located) = (_vecl.col(  n_located).cast<Complex>() -
+                                       _vecl.col(1+n_located).cast<Complex>() * iota);
+                VR.col(  n_located) = (_vecr.col(  n_located).cast<Complex>() +
+                                       _vecr.col(1+n_located).cast<Complex>() * iota);
+                VR.col(1+n_located) = (_vecr.col(  n_located).cast<Complex>() -
+                                       _vecr.col(1+n_located).cast<Complex>() * iota);
             }
             
             // two complex conjugate roots were found
@@ -112,13 +182,13 @@ MAST::LAPACK_DGEEV::compute(const RealMatrixX &A,
         }
         else {
             
-            W(  n_located) = std::complex<double>(w_r(n_located),  0.);
+            W(  n_located) = std::complex<double>(_w_r(n_located),  0.);
             
             // copy the eigenvectors if they were requested
             if (computeEigenvectors) {
                 
-                VL.col(n_located) = vecl.col(n_located).cast<Complex>();
-                VR.col(n_located) = vecr.col(n_located).cast<Complex>();
+                VL.col(n_located) = _vecl.col(n_located).cast<Complex>();
+                VR.col(n_located) = _vecr.col(n_located).cast<Complex>();
             }
             
             // only one real root was found
@@ -131,5 +201,3 @@ MAST::LAPACK_DGEEV::compute(const RealMatrixX &A,
         << "Warning!!  DGEEV returned with nonzero info = "
         << info_val << std::endl;
 }
-
-
@@ -21,10 +21,18 @@
 #define __mast__lapack_dgeev_interface_h__
 
 
+// C++ includes
+#include <vector>
+
+
 // MAST includes
 #include "base/mast_data_types.h"
 
 
+// libMesh includes
+#include "libmesh/threads.h"
+
+
 extern "C" {
 
     /*
@@ -152,20 +160,46 @@ namespace MAST {
     public:
 
         LAPACK_DGEEV():
-        info_val(-1)
+        info_val(-1),
+        _if_matrices(false),
+        _work_n(-1),
+        _work_vecs(false)
         { }
 
         /*!
-         *    computes the eigensolution for A x = \lambda I x. A & B will be
-         *    overwritten
+         *    computes the eigensolution for A x = \lambda I x. A is
+         *    retained, and is available through A(). The working
+         *    copy given to LAPACK and the workspace are stored in this
+         *    object, and are reallocated only if the size of the matrix
+         *    changes.
          */
         void compute(const RealMatrixX& A,
                      bool computeEigenvectors = true);
 
+        /*!
+         *    computes the eigensolution for A x = \lambda I x without
+         *    copying the matrix. A will be overwritten, and A(),
+         *    scale_eigenvectors_to_identity_innerproduct() and
+         *    print_inner_product() cannot be used for this solution.
+         */
+        void compute_in_place(RealMatrixX& A,
+                              bool computeEigenvectors = true);
+
+        /*!
+         *    computes the eigensolution of each matrix *A[i] with
+         *    solvers[i]->compute(). The solutions are independent of each
+         *    other and are distributed over the libMesh threads. Each
+         *    object in \p solvers must be distinct.
+         */
+        static void compute_batch(const std::vector<MAST::LAPACK_DGEEV*>& solvers,
+                                  const std::vector<const RealMatrixX*>& A,
+                                  bool computeEigenvectors = true);
+
         ComputationInfo info() const;
 
         const RealMatrixX& A() const {
             libmesh_assert(info_val == 0);
+            libmesh_assert(_if_matrices);
             return this->_A;
         }
 
@@ -192,6 +226,7 @@ namespace MAST {
          */
         void scale_eigenvectors_to_identity_innerproduct() {
             libmesh_assert(info_val == 0);
+            libmesh_assert(_if_matrices);
 
             // this product should be an identity matrix
             ComplexMatrixX r = this->VL.conjugate().transpose() * this->VR;
@@ -208,6 +243,7 @@ namespace MAST {
 
         void print_inner_product(std::ostream& out) const {
             libmesh_assert(info_val == 0);
+            libmesh_assert(_if_matrices);
             ComplexMatrixX r;
             r = this->VL.conjugate().transpose() * _A * this->VR;
             out << "conj(VL)' * A * VR" << std::endl
@@ -230,6 +266,67 @@ namespace MAST {
         ComplexVectorX W;
 
         int info_val;
+
+        /*!
+         *    calls DGEEV for \p Amat, which is overwritten. The optimal
+         *    workspace is queried if the size of the matrix or the
+         *    eigenvector option has changed since the last call.
+         */
+        void _compute(RealMatrixX& Amat,
+                      bool computeEigenvectors);
+
+        /*!
+         *   \p true if _A stores the matrix of the last solution
+         */
+        bool           _if_matrices;
+
+        /*!
+         *   working copy of the matrix given to LAPACK by compute()
+         */
+        RealMatrixX    _Amat;
+
+        /*!
+         *   output arrays of DGEEV, before the complex conjugate pairs
+         *   are combined
+         */
+        RealVectorX    _w_r;
+
+        RealVectorX    _w_i;
+
+        RealMatrixX    _vecl;
+
+        RealMatrixX    _vecr;
+
+        /*!
+         *   workspace, and the matrix size and eigenvector option
+         *   for which the optimal workspace size was queried
+         */
+        RealVectorX    _work;
+
+        int            _work_n;
+
+        bool           _work_vecs;
+
+
+        /*!
+         *   Functor used by compute_batch()
+         */
+        class BatchCompute {
+        public:
+
+            BatchCompute(const std::vector<MAST::LAPACK_DGEEV*>& solvers,
+                         const std::vector<const RealMatrixX*>&  A,
+                         bool computeEigenvectors):
+            _solvers(solvers), _A(A), _vecs(computeEigenvectors) { }
+
+            void operator() (const libMesh::Threads::BlockedRange<unsigned int>& range) const;
+
+        protected:
+
+            const std::vector<MAST::LAPACK_DGEEV*>& _solvers;
+            const std::vector<const RealMatrixX*>&  _A;
+            bool                                    _vecs;
+        };
     };
 
 }
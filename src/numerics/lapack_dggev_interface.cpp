@@ -18,6 +18,10 @@
  */
 
 
+// C++ includes
+#include <algorithm>
+
+
 // MAST includes
 #include "numerics/lapack_dggev_interface.h"
 
@@ -34,55 +38,127 @@ MAST::LAPACK_DGGEV::compute(const RealMatrixX &A,
     _A = A;
     _B = B;
     
-    RealMatrixX
-    Amat = A,
-    Bmat = B;
+    // the working copies keep their storage if the size is unchanged
+    _Amat = A;
+    _Bmat = B;
     
-    int n = (int)A.cols();
+    _compute(_Amat, _Bmat, computeEigenvectors);
+    _if_matrices = true;
+}
+
+
+
+void
+MAST::LAPACK_DGGEV::compute_in_place(RealMatrixX &A,
+                                     RealMatrixX &B,
+                                     bool computeEigenvectors) {
+    
+    libmesh_assert(A.cols() == A.rows() &&
+                   B.cols() == A.rows() &&
+                   B.cols() == B.rows());
+    
+    _if_matrices = false;
+    _compute(A, B, computeEigenvectors);
+}
+
+
+
+void
+MAST::LAPACK_DGGEV::
+compute_batch(const std::vector<MAST::LAPACK_DGGEV*>& solvers,
+              const std::vector<const RealMatrixX*>& A,
+              const std::vector<const RealMatrixX*>& B,
+              bool computeEigenvectors) {
+    
+    libmesh_assert_equal_to(solvers.size(), A.size());
+    libmesh_assert_equal_to(solvers.size(), B.size());
+    
+    libMesh::Threads::parallel_for
+    (libMesh::Threads::BlockedRange<unsigned int>(0, (unsigned int)solvers.size(), 1),
+     MAST::LAPACK_DGGEV::BatchCompute(solvers, A, B, computeEigenvectors));
+}
+
+
+
+void
+MAST::LAPACK_DGGEV::BatchCompute::
+operator() (const libMesh::Threads::BlockedRange<unsigned int>& range) const {
+    
+    for (unsigned int i=range.begin(); i<range.end(); i++)
+        _solvers[i]->compute(*_A[i], *_B[i], _vecs);
+}
+
+
+
+void
+MAST::LAPACK_DGGEV::_compute(RealMatrixX &Amat,
+                             RealMatrixX &Bmat,
+                             bool computeEigenvectors) {
+    
+    int n = (int)Amat.cols();
     
     char L='N',R='N';
     
     if (computeEigenvectors) {
         
         L = 'V'; R = 'V';
-        VL.setZero(n, n);
-        VR.setZero(n, n);
+        VL.resize(n, n);
+        VR.resize(n, n);
     }
     
     int
-    lwork=16*n;
+    lwork=0;
     
     info_val=-1;
     
-    alpha.setZero(n);
-    beta.setZero(n);
-    
-    RealVectorX
-    work,
-    aval_r,
-    aval_i,
-    bval;
-    
-    RealMatrixX
-    vecl,
-    vecr;
+    alpha.resize(n);
+    beta.resize(n);
     
-    work.setZero(lwork);
-    aval_r.setZero(n);
-    aval_i.setZero(n);
-    bval.setZero(n);
-    vecl.setZero(n,n);
-    vecr.setZero(n,n);
+    _aval_r.resize(n);
+    _aval_i.resize(n);
+    _bval.resize(n);
+    _vecl.resize(n,n);
+    _vecr.resize(n,n);
     
     Real
     *a_vals    = Amat.data(),
     *b_vals    = Bmat.data(),
-    *alpha_r_v = aval_r.data(),
-    *alpha_i_v = aval_i.data(),
-    *beta_v    = bval.data(),
-    *vecl_v    = vecl.data(),
-    *vecr_v    = vecr.data(),
-    *work_v    = work.data();
+    *alpha_r_v = _aval_r.data(),
+    *alpha_i_v = _aval_i.data(),
+    *beta_v    = _bval.data(),
+    *vecl_v    = _vecl.data(),
+    *vecr_v    = _vecr.data();
+    
+    // query the optimal workspace size for this problem
+    if (n != _work_n || computeEigenvectors != _work_vecs) {
+        
+        Real
+        opt        = 0.;
+        lwork      = -1;
+        
+        dggev_(&L, &R, &n,
+               &(a_vals[0]), &n,
+               &(b_vals[0]), &n,
+               &(alpha_r_v[0]), &(alpha_i_v[0]), &(beta_v[0]),
+               &(vecl_v[0]), &n, &(vecr_v[0]), &n,
+               &opt, &lwork,
+               &info_val);
+        
+        if (info_val == 0)
+            lwork = std::max((int)opt, std::max(1, 8*n));
+        else
+            lwork = 16*n;
+        
+        _work.setZero(lwork);
+        _work_n    = n;
+        _work_vecs = computeEigenvectors;
+        info_val   = -1;
+    }
+    
+    lwork = (int)_work.size();
+    
+    Real
+    *work_v    = _work.data();
     
         
     dggev_(&L, &R, &n,
@@ -99,26 +175,26 @@ MAST::LAPACK_DGGEV::compute(const RealMatrixX &A,
         
         // if the imaginary part of the eigenvalue is non-zero, it is a
         // complex conjugate
-        if (aval_i(n_located) != 0.) { // complex conjugate
+        if (_aval_i(n_located) != 0.) { // complex conjugate
             
-            alpha(  n_located) = std::complex<double>(aval_r(n_located),  aval_i(n_located));
-            alpha(1+n_located) = std::complex<double>(aval_r(n_located), -aval_i(n_located));
-            beta (  n_located) = bval(n_located);
-            beta (1+n_located) = bval(n_located);
+            alpha(  n_located) = std::complex<double>(_aval_r(n_located),  _aval_i(n_located));
+            alpha(1+n_located) = std::complex<double>(_aval_r(n_located), -_aval_i(n_located));
+            beta (  n_located) = _bval(n_located);
+            beta (1+n_located) = _bval(n_located);
 
             // copy the eigenvectors if they were requested
             if (computeEigenvectors) {
                 
                 std::complex<double> iota = std::complex<double>(0, 1.);
                 
-                VL.col(  n_located) = (vecl.col(  n_located).cast<Complex>() +
-                                       vecl.col(1+n_located).cast<Complex>() * iota);
-                VL.col(1+n_located) = (vecl.col(  n_located).cast<Complex>() -
-                                       vecl.col(1+n_located).cast<Complex>() * iota);
-                VR.col(  n_located) = (vecr.col(  n_located).cast<Complex>() +
-                                       vecr.col(1+n_located).cast<Complex>() * iota);
-                VR.col(1+n_located) = (vecr.col(  n_located).cast<Complex>() -
-                                       vecr.col(1+n_located).cast<Complex>() * iota);
+                VL.col(  n_located) = (_vecl.col(  n_located).cast<Complex>() +
+                                       _vecl.col(1+n_located).cast<Complex>() * iota);
+                VL.col(1+n_located) = (_vecl.col(  n_located).cast<Complex>() -
+                                       _vecl.col(1+n_located).cast<Complex>() * iota);
+                VR.col(  n_located) = (_vecr.col(  n_located).cast<Complex>() +
+                                       _vecr.col(1+n_located).cast<Complex>() * iota);
+                VR.col(1+n_located) = (_vecr.col(  n_located).cast<Complex>() -
+                                       _vecr.col(1+n_located).cast<Complex>() * iota);
             }
             
             // two complex conjugate roots were found
@@ -126,14 +202,14 @@ MAST::LAPACK_DGGEV::compute(const RealMatrixX &A,
         }
         else {
             
-            alpha(  n_located) = std::complex<double>(aval_r(n_located),  0.);
-            beta (  n_located) = bval(n_located);
+            alpha(  n_located) = std::complex<double>(_aval_r(n_located),  0.);
+            beta (  n_located) = _bval(n_located);
             
             // copy the eigenvectors if they were requested
             if (computeEigenvectors) {
                 
-                VL.col(n_located) = vecl.col(n_located).cast<Complex>();
-                VR.col(n_located) = vecr.col(n_located).cast<Complex>();
+                VL.col(n_located) = _vecl.col(n_located).cast<Complex>();
+                VR.col(n_located) = _vecr.col(n_located).cast<Complex>();
             }
             
             // only one real root was found
@@ -146,5 +222,3 @@ MAST::LAPACK_DGGEV::compute(const RealMatrixX &A,
         << "Warning!!  DGGEV returned with nonzero info = "
         << info_val << std::endl;
 }
-
-
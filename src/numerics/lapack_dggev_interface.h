@@ -21,10 +21,18 @@
 #define __mast__lapack_dggev_interface_h__
 
 
+// C++ includes
+#include <vector>
+
+
 // MAST includes
 #include "base/mast_data_types.h"
 
 
+// libMesh includes
+#include "libmesh/threads.h"
+
+
 extern "C" {
     
     /*
@@ -182,27 +190,56 @@ namespace MAST {
     public:
         
         LAPACK_DGGEV():
-        info_val(-1)
+        info_val(-1),
+        _if_matrices(false),
+        _work_n(-1),
+        _work_vecs(false)
         { }
         
         /*!
-         *    computes the eigensolution for A x = \lambda B x. A & B will be
-         *    overwritten
+         *    computes the eigensolution for A x = \lambda B x. A & B are
+         *    retained, and are available through A() and B(). The working
+         *    copies given to LAPACK and the workspace are stored in this
+         *    object, and are reallocated only if the size of the matrices
+         *    changes.
          */
         void compute(const RealMatrixX& A,
                      const RealMatrixX& B,
                      bool computeEigenvectors = true);
         
+        /*!
+         *    computes the eigensolution for A x = \lambda B x without
+         *    copying the matrices. A & B will be overwritten, and
+         *    A(), B(), scale_eigenvectors_to_identity_innerproduct()
+         *    and print_inner_product() cannot be used for this solution.
+         */
+        void compute_in_place(RealMatrixX& A,
+                              RealMatrixX& B,
+                              bool computeEigenvectors = true);
+        
+        /*!
+         *    computes the eigensolution of each pair (*A[i], *B[i]) with
+         *    solvers[i]->compute(). The solutions are independent of each
+         *    other and are distributed over the libMesh threads. Each
+         *    object in \p solvers must be distinct.
+         */
+        static void compute_batch(const std::vector<MAST::LAPACK_DGGEV*>& solvers,
+                                  const std::vector<const RealMatrixX*>& A,
+                                  const std::vector<const RealMatrixX*>& B,
+                                  bool computeEigenvectors = true);
+        
         ComputationInfo info() const;
         
         const RealMatrixX& A() const {
             libmesh_assert(info_val == 0);
+            libmesh_assert(_if_matrices);
             return this->_A;
         }
         
         
         const RealMatrixX& B() const {
             libmesh_assert(info_val == 0);
+            libmesh_assert(_if_matrices);
             return this->_B;
         }
         
@@ -234,6 +271,7 @@ namespace MAST {
          */
         void scale_eigenvectors_to_identity_innerproduct() {
             libmesh_assert(info_val == 0);
+            libmesh_assert(_if_matrices);
             
             // this product should be an identity matrix
             ComplexMatrixX r = this->VL.conjugate().transpose() * _B * this->VR;
@@ -250,6 +288,7 @@ namespace MAST {
         
         void print_inner_product(std::ostream& out) const {
             libmesh_assert(info_val == 0);
+            libmesh_assert(_if_matrices);
             ComplexMatrixX r;
             r = this->VL.conjugate().transpose() * _A * this->VR;
             out << "conj(VL)' * A * VR" << std::endl
@@ -276,6 +315,74 @@ namespace MAST {
         RealVectorX    beta;
         
         int info_val;
+        
+        /*!
+         *    calls DGGEV for \p Amat and \p Bmat, which are overwritten.
+         *    The optimal workspace is queried if the size of the matrices
+         *    or the eigenvector option has changed since the last call.
+         */
+        void _compute(RealMatrixX& Amat,
+                      RealMatrixX& Bmat,
+                      bool computeEigenvectors);
+        
+        /*!
+         *   \p true if _A and _B store the matrices of the last solution
+         */
+        bool           _if_matrices;
+        
+        /*!
+         *   working copies of the matrices given to LAPACK by compute()
+         */
+        RealMatrixX    _Amat;
+        
+        RealMatrixX    _Bmat;
+        
+        /*!
+         *   output arrays of DGGEV, before the complex conjugate pairs
+         *   are combined
+         */
+        RealVectorX    _aval_r;
+        
+        RealVectorX    _aval_i;
+        
+        RealVectorX    _bval;
+        
+        RealMatrixX    _vecl;
+        
+        RealMatrixX    _vecr;
+        
+        /*!
+         *   workspace, and the matrix size and eigenvector option
+         *   for which the optimal workspace size was queried
+         */
+        RealVectorX    _work;
+        
+        int            _work_n;
+        
+        bool           _work_vecs;
+        
+        
+        /*!
+         *   Functor used by compute_batch()
+         */
+        class BatchCompute {
+        public:
+            
+            BatchCompute(const std::vector<MAST::LAPACK_DGGEV*>& solvers,
+                         const std::vector<const RealMatrixX*>&  A,
+                         const std::vector<const RealMatrixX*>&  B,
+                         bool computeEigenvectors):
+            _solvers(solvers), _A(A), _B(B), _vecs(computeEigenvectors) { }
+            
+            void operator() (const libMesh::Threads::BlockedRange<unsigned int>& range) const;
+            
+        protected:
+            
+            const std::vector<MAST::LAPACK_DGGEV*>& _solvers;
+            const std::vector<const RealMatrixX*>&  _A;
+            const std::vector<const RealMatrixX*>&  _B;
+            bool                                    _vecs;
+        };
     };
     
 }
@@ -0,0 +1,143 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2017  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+// C++ includes
+#include <algorithm>
+
+
+// MAST includes
+#include "numerics/lapack_dsygvd_interface.h"
+
+
+void
+MAST::LAPACK_DSYGVD::compute(const RealMatrixX &A,
+                             const RealMatrixX &B,
+                             bool computeEigenvectors) {
+    
+    libmesh_assert(A.cols() == A.rows() &&
+                   B.cols() == A.rows() &&
+                   B.cols() == B.rows());
+    
+    _A = A;
+    _B = B;
+    
+    // the eigenvectors are computed in place of the copy of A
+    Z     = A;
+    _Bmat = B;
+    
+    _compute(Z, _Bmat, computeEigenvectors);
+    _if_matrices = true;
+}
+
+
+
+void
+MAST::LAPACK_DSYGVD::compute_in_place(RealMatrixX &A,
+                                      RealMatrixX &B,
+                                      bool computeEigenvectors) {
+    
+    libmesh_assert(A.cols() == A.rows() &&
+                   B.cols() == A.rows() &&
+                   B.cols() == B.rows());
+    
+    _if_matrices = false;
+    _compute(A, B, computeEigenvectors);
+    
+    if (computeEigenvectors)
+        Z = A;
+}
+
+
+
+void
+MAST::LAPACK_DSYGVD::_compute(RealMatrixX &Amat,
+                              RealMatrixX &Bmat,
+                              bool computeEigenvectors) {
+    
+    int
+    n      = (int)Amat.cols(),
+    itype  = 1,
+    lwork  = 0,
+    liwork = 0;
+    
+    char
+    jobz   = computeEigenvectors? 'V': 'N',
+    uplo   = 'U';
+    
+    info_val = -1;
+    
+    W.resize(n);
+    
+    Real
+    *a_vals = Amat.data(),
+    *b_vals = Bmat.data(),
+    *w_v    = W.data();
+    
+    // query the optimal workspace size for this problem
+    if (n != _work_n || computeEigenvectors != _work_vecs) {
+        
+        Real
+        opt      = 0.;
+        int
+        iopt     = 0;
+        lwork    = -1;
+        liwork   = -1;
+        
+        dsygvd_(&itype, &jobz, &uplo, &n,
+                &(a_vals[0]), &n,
+                &(b_vals[0]), &n,
+                &(w_v[0]),
+                &opt, &lwork,
+                &iopt, &liwork,
+                &info_val);
+        
+        if (info_val == 0) {
+            lwork  = std::max((int)opt, 1);
+            liwork = std::max(iopt, 1);
+        }
+        else {
+            lwork  = 1 + 6*n + 2*n*n;
+            liwork = 3 + 5*n;
+        }
+        
+        _work.setZero(lwork);
+        _iwork.resize(liwork);
+        _work_n    = n;
+        _work_vecs = computeEigenvectors;
+        info_val   = -1;
+    }
+    
+    lwork  = (int)_work.size();
+    liwork = (int)_iwork.size();
+    
+    dsygvd_(&itype, &jobz, &uplo, &n,
+            &(a_vals[0]), &n,
+            &(b_vals[0]), &n,
+            &(w_v[0]),
+            &(_work.data()[0]), &lwork,
+            &(_iwork[0]), &liwork,
+            &info_val);
+    
+    if (info_val  != 0)
+        libMesh::out
+        << "Warning!!  DSYGVD returned with nonzero info = "
+        << info_val << std::endl;
+}
+
@@ -0,0 +1,274 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2017  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+#ifndef __mast__lapack_dsygvd_interface_h__
+#define __mast__lapack_dsygvd_interface_h__
+
+
+// C++ includes
+#include <vector>
+
+
+// MAST includes
+#include "base/mast_data_types.h"
+
+
+extern "C" {
+    
+    /*
+     *  =====================================================================
+     *  Purpose
+     *  =======
+     *
+     *  DSYGVD computes all the eigenvalues, and optionally, the eigenvectors
+     *  of a real generalized symmetric-definite eigenproblem, of the form
+     *  A*x=(lambda)*B*x,  A*Bx=(lambda)*x,  or B*A*x=(lambda)*x.  Here A and
+     *  B are assumed to be symmetric and B is also positive definite.
+     *  If eigenvectors are desired, it uses a divide and conquer algorithm.
+     *
+     *  Arguments
+     *  =========
+     *
+     *  ITYPE   (input) INTEGER
+     *          Specifies the problem type to be solved:
+     *          = 1:  A*x = (lambda)*B*x
+     *          = 2:  A*B*x = (lambda)*x
+     *          = 3:  B*A*x = (lambda)*x
+     *
+     *  JOBZ    (input) CHARACTER*1
+     *          = 'N':  Compute eigenvalues only;
+     *          = 'V':  Compute eigenvalues and eigenvectors.
+     *
+     *  UPLO    (input) CHARACTER*1
+     *          = 'U':  Upper triangles of A and B are stored;
+     *          = 'L':  Lower triangles of A and B are stored.
+     *
+     *  N       (input) INTEGER
+     *          The order of the matrices A and B.  N >= 0.
+     *
+     *  A       (input/output) DOUBLE PRECISION array, dimension (LDA, N)
+     *          On entry, the symmetric matrix A.
+     *          On exit, if JOBZ = 'V', then if INFO = 0, A contains the
+     *          matrix Z of eigenvectors.  The eigenvectors are normalized
+     *          as follows: if ITYPE = 1 or 2, Z**T*B*Z = I; if ITYPE = 3,
+     *          Z**T*inv(B)*Z = I. If JOBZ = 'N', then on exit the upper
+     *          triangle (if UPLO='U') or the lower triangle (if UPLO='L')
+     *          of A, including the diagonal, is destroyed.
+     *
+     *  LDA     (input) INTEGER
+     *          The leading dimension of the array A.  LDA >= max(1,N).
+     *
+     *  B       (input/output) DOUBLE PRECISION array, dimension (LDB, N)
+     *          On entry, the symmetric matrix B.
+     *          On exit, if INFO <= N, the part of B containing the matrix is
+     *          overwritten by the triangular factor U or L from the Cholesky
+     *          factorization B = U**T*U or B = L*L**T.
+     *
+     *  LDB     (input) INTEGER
+     *          The leading dimension of the array B.  LDB >= max(1,N).
+     *
+     *  W       (output) DOUBLE PRECISION array, dimension (N)
+     *          If INFO = 0, the eigenvalues in ascending order.
+     *
+     *  WORK    (workspace/output) DOUBLE PRECISION array, dimension (MAX(1,LWORK))
+     *          On exit, if INFO = 0, WORK(1) returns the optimal LWORK.
+     *
+     *  LWORK   (input) INTEGER
+     *          The dimension of the array WORK.
+     *          If N <= 1,               LWORK >= 1.
+     *          If JOBZ = 'N' and N > 1, LWORK >= 2*N+1.
+     *          If JOBZ = 'V' and N > 1, LWORK >= 1 + 6*N + 2*N**2.
+     *
+     *          If LWORK = -1, then a workspace query is assumed; the routine
+     *          only calculates the optimal sizes of the WORK and IWORK
+     *          arrays, returns these values as the first entries of the WORK
+     *          and IWORK arrays, and no error message related to LWORK or
+     *          LIWORK is issued by XERBLA.
+     *
+     *  IWORK   (workspace/output) INTEGER array, dimension (MAX(1,LIWORK))
+     *          On exit, if INFO = 0, IWORK(1) returns the optimal LIWORK.
+     *
+     *  LIWORK  (input) INTEGER
+     *          The dimension of the array IWORK.
+     *          If N <= 1,                LIWORK >= 1.
+     *          If JOBZ  = 'N' and N > 1, LIWORK >= 1.
+     *          If JOBZ  = 'V' and N > 1, LIWORK >= 3 + 5*N.
+     *
+     *  INFO    (output) INTEGER
+     *          = 0:  successful exit
+     *          < 0:  if INFO = -i, the i-th argument had an illegal value
+     *          > 0:  DPOTRF or DSYEVD returned an error code:
+     *             <= N:  if INFO = i and JOBZ = 'N', then the algorithm
+     *                    failed to converge; i off-diagonal elements of an
+     *                    intermediate tridiagonal form did not converge to
+     *                    zero; if INFO = i and JOBZ = 'V', then the
+     *                    algorithm failed to compute an eigenvalue while
+     *                    working on the submatrix lying in rows and columns
+     *                    INFO/(N+1) through mod(INFO,N+1);
+     *             > N:   if INFO = N + i, for 1 <= i <= N, then the leading
+     *                    minor of order i of B is not positive definite.
+     *                    The factorization of B could not be completed and
+     *                    no eigenvalues or eigenvectors were computed.
+     *
+     *  =====================================================================
+     */
+    extern int dsygvd_(int*     itype,
+                       char*    jobz,
+                       char*    uplo,
+                       int*     n,
+                       double*  a,
+                       int*     lda,
+                       double*  b,
+                       int*     ldb,
+                       double*  w,
+                       double*  work,
+                       int*     lwork,
+                       int*     iwork,
+                       int*     liwork,
+                       int*     info);
+    
+}
+
+
+namespace MAST {
+    
+    /*!
+     *    Solves the real symmetric-definite generalized eigenproblem
+     *    A x = \lambda B x, where A is symmetric and B is symmetric positive
+     *    definite, for example the reduced stiffness and mass matrices of
+     *    a structural model. Only the upper triangles of the matrices are
+     *    used. The eigenvalues are real and ascending, and the
+     *    eigenvectors are B-orthonormal, X^T B X = I.
+     */
+    class LAPACK_DSYGVD {
+        
+    public:
+        
+        LAPACK_DSYGVD():
+        info_val(-1),
+        _if_matrices(false),
+        _work_n(-1),
+        _work_vecs(false)
+        { }
+        
+        /*!
+         *    computes the eigensolution for A x = \lambda B x. A & B are
+         *    retained, and are available through A() and B(). The working
+         *    copies given to LAPACK and the workspace are stored in this
+         *    object, and are reallocated only if the size of the matrices
+         *    changes.
+         */
+        void compute(const RealMatrixX& A,
+                     const RealMatrixX& B,
+                     bool computeEigenvectors = true);
+        
+        /*!
+         *    computes the eigensolution for A x = \lambda B x without
+         *    copying the matrices. A & B will be overwritten, and A() and
+         *    B() cannot be used for this solution.
+         */
+        void compute_in_place(RealMatrixX& A,
+                              RealMatrixX& B,
+                              bool computeEigenvectors = true);
+        
+        /*!
+         *    @returns the info value returned by DSYGVD. A value greater
+         *    than the size of the matrices indicates that B is not
+         *    positive definite.
+         */
+        int info() const {
+            return info_val;
+        }
+        
+        const RealMatrixX& A() const {
+            libmesh_assert(info_val == 0);
+            libmesh_assert(_if_matrices);
+            return this->_A;
+        }
+        
+        
+        const RealMatrixX& B() const {
+            libmesh_assert(info_val == 0);
+            libmesh_assert(_if_matrices);
+            return this->_B;
+        }
+        
+        /*!
+         *    @returns the eigenvalues in ascending order
+         */
+        const RealVectorX& eigenvalues() const {
+            libmesh_assert(info_val == 0);
+            return this->W;
+        }
+        
+        /*!
+         *    @returns the B-orthonormal eigenvectors, stored as columns
+         */
+        const RealMatrixX& eigenvectors() const {
+            libmesh_assert(info_val == 0);
+            return this->Z;
+        }
+        
+    protected:
+        
+        /*!
+         *    calls DSYGVD for \p Amat and \p Bmat, which are overwritten.
+         *    The optimal workspace is queried if the size of the matrices
+         *    or the eigenvector option has changed since the last call.
+         */
+        void _compute(RealMatrixX& Amat,
+                      RealMatrixX& Bmat,
+                      bool computeEigenvectors);
+        
+        RealMatrixX    _A;
+        
+        RealMatrixX    _B;
+        
+        RealVectorX    W;
+        
+        RealMatrixX    Z;
+        
+        int info_val;
+        
+        /*!
+         *   \p true if _A and _B store the matrices of the last solution
+         */
+        bool           _if_matrices;
+        
+        /*!
+         *   working copy of B given to LAPACK by compute()
+         */
+        RealMatrixX    _Bmat;
+        
+        /*!
+         *   workspace arrays, and the matrix size and eigenvector option
+         *   for which the optimal workspace size was queried
+         */
+        RealVectorX    _work;
+        
+        std::vector<int> _iwork;
+        
+        int            _work_n;
+        
+        bool           _work_vecs;
+    };
+}
+
+#endif // __mast__lapack_dsygvd_interface_h__
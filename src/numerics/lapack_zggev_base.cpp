@@ -0,0 +1,49 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2017  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+// MAST includes
+#include "numerics/lapack_zggev_base.h"
+
+
+void
+MAST::LAPACK_ZGGEV_Base::
+compute_batch(const std::vector<MAST::LAPACK_ZGGEV_Base*>& solvers,
+              const std::vector<const ComplexMatrixX*>& A,
+              const std::vector<const ComplexMatrixX*>& B,
+              bool computeEigenvectors) {
+    
+    libmesh_assert_equal_to(solvers.size(), A.size());
+    libmesh_assert_equal_to(solvers.size(), B.size());
+    
+    libMesh::Threads::parallel_for
+    (libMesh::Threads::BlockedRange<unsigned int>(0, (unsigned int)solvers.size(), 1),
+     MAST::LAPACK_ZGGEV_Base::BatchCompute(solvers, A, B, computeEigenvectors));
+}
+
+
+
+void
+MAST::LAPACK_ZGGEV_Base::BatchCompute::
+operator() (const libMesh::Threads::BlockedRange<unsigned int>& range) const {
+    
+    for (unsigned int i=range.begin(); i<range.end(); i++)
+        _solvers[i]->compute(*_A[i], *_B[i], _vecs);
+}
+
@@ -21,10 +21,18 @@
 #define __mast__lapack_zggev_interface_base_h__
 
 
+// C++ includes
+#include <vector>
+
+
 // MAST includes
 #include "base/mast_data_types.h"
 
 
+// libMesh includes
+#include "libmesh/threads.h"
+
+
 
 
 namespace MAST {
@@ -34,25 +42,56 @@ namespace MAST {
     public:
         
         LAPACK_ZGGEV_Base():
-        info_val(-1)
+        info_val(-1),
+        _if_matrices(false),
+        _work_n(-1),
+        _work_vecs(false)
         { }
         
+        virtual ~LAPACK_ZGGEV_Base() { }
+        
         /*!
-         *    computes the eigensolution for A x = \lambda B x. A & B will be
-         *    overwritten
+         *    computes the eigensolution for A x = \lambda B x. A & B are
+         *    retained, and are available through A() and B(). The working
+         *    copies given to LAPACK and the workspace are stored in this
+         *    object, and are reallocated only if the size of the matrices
+         *    changes.
          */
         virtual void compute(const ComplexMatrixX& A,
                              const ComplexMatrixX& B,
                              bool computeEigenvectors = true) = 0;
         
+        /*!
+         *    computes the eigensolution for A x = \lambda B x without
+         *    copying the matrices. A & B will be overwritten, and
+         *    A(), B(), scale_eigenvectors_to_identity_innerproduct()
+         *    and print_inner_product() cannot be used for this solution.
+         */
+        virtual void compute_in_place(ComplexMatrixX& A,
+                                      ComplexMatrixX& B,
+                                      bool computeEigenvectors = true) = 0;
+        
+        /*!
+         *    computes the eigensolution of each pair (*A[i], *B[i]) with
+         *    solvers[i]->compute(). The solutions are independent of each
+         *    other and are distributed over the libMesh threads. Each
+         *    object in \p solvers must be distinct.
+         */
+        static void compute_batch(const std::vector<MAST::LAPACK_ZGGEV_Base*>& solvers,
+                                  const std::vector<const ComplexMatrixX*>& A,
+                                  const std::vector<const ComplexMatrixX*>& B,
+                                  bool computeEigenvectors = true);
+        
         const ComplexMatrixX& A() const {
             libmesh_assert(info_val == 0);
+            libmesh_assert(_if_matrices);
             return this->_A;
         }
         
         
         const ComplexMatrixX& B() const {
             libmesh_assert(info_val == 0);
+            libmesh_assert(_if_matrices);
             return this->_B;
         }
         
@@ -84,6 +123,7 @@ namespace MAST {
          */
         void scale_eigenvectors_to_identity_innerproduct() {
             libmesh_assert(info_val == 0);
+            libmesh_assert(_if_matrices);
             
             // this product should be an identity matrix
             ComplexMatrixX r = this->VL.conjugate().transpose() * _B * this->VR;
@@ -100,6 +140,7 @@ namespace MAST {
         
         void print_inner_product(std::ostream& out) const {
             libmesh_assert(info_val == 0);
+            libmesh_assert(_if_matrices);
             ComplexMatrixX r;
             r = this->VL.conjugate().transpose() * _A * this->VR;
             out << "conj(VL)' * A * VR" << std::endl
@@ -126,6 +167,53 @@ namespace MAST {
         ComplexVectorX beta;
         
         int info_val;
+        
+        /*!
+         *   \p true if _A and _B store the matrices of the last solution
+         */
+        bool _if_matrices;
+        
+        /*!
+         *   working copies of the matrices given to LAPACK by compute()
+         */
+        ComplexMatrixX _Amat;
+        
+        ComplexMatrixX _Bmat;
+        
+        /*!
+         *   workspace arrays, and the matrix size and eigenvector option
+         *   for which the optimal workspace size was queried
+         */
+        ComplexVectorX _work;
+        
+        RealVectorX    _rwork;
+        
+        int            _work_n;
+        
+        bool           _work_vecs;
+        
+        
+        /*!
+         *   Functor used by compute_batch()
+         */
+        class BatchCompute {
+        public:
+            
+            BatchCompute(const std::vector<MAST::LAPACK_ZGGEV_Base*>& solvers,
+                         const std::vector<const ComplexMatrixX*>&    A,
+                         const std::vector<const ComplexMatrixX*>&    B,
+                         bool computeEigenvectors):
+            _solvers(solvers), _A(A), _B(B), _vecs(computeEigenvectors) { }
+            
+            void operator() (const libMesh::Threads::BlockedRange<unsigned int>& range) const;
+            
+        protected:
+            
+            const std::vector<MAST::LAPACK_ZGGEV_Base*>& _solvers;
+            const std::vector<const ComplexMatrixX*>&    _A;
+            const std::vector<const ComplexMatrixX*>&    _B;
+            bool                                         _vecs;
+        };
     };
 }
 
@@ -18,6 +18,10 @@
  */
 
 
+// C++ includes
+#include <algorithm>
+
+
 // MAST includes
 #include "numerics/lapack_zggev_interface.h"
 
@@ -34,32 +38,93 @@ MAST::LAPACK_ZGGEV::compute(const ComplexMatrixX &A,
     _A = A;
     _B = B;
     
-    ComplexMatrixX
-    Amat = _A,
-    Bmat = _B;
+    if (!_compute_hermitian(A, B, computeEigenvectors)) {
+        
+        // the working copies keep their storage if the size is unchanged
+        _Amat = A;
+        _Bmat = B;
+        
+        _compute(_Amat, _Bmat, computeEigenvectors);
+    }
+    _if_matrices = true;
+}
+
+
+
+void
+MAST::LAPACK_ZGGEV::compute_in_place(ComplexMatrixX &A,
+                                     ComplexMatrixX &B,
+                                     bool computeEigenvectors) {
+    
+    libmesh_assert(A.cols() == A.rows() &&
+                   B.cols() == A.rows() &&
+                   B.cols() == B.rows());
+    
+    _if_matrices = false;
+    if (!_compute_hermitian(A, B, computeEigenvectors))
+        _compute(A, B, computeEigenvectors);
+}
+
+
+
+bool
+MAST::LAPACK_ZGGEV::_compute_hermitian(const ComplexMatrixX &A,
+                                       const ComplexMatrixX &B,
+                                       bool computeEigenvectors) {
+    
+    _hermitian_solution = false;
+    
+    if (!_detect_hermitian ||
+        !MAST::LAPACK_ZHEGVD::is_hermitian(A, B))
+        return false;
+    
+    // the working copies are given to the solver, which does not retain
+    // its own copies of the matrices
+    _Amat = A;
+    _Bmat = B;
+    
+    _hermitian_solver.compute_in_place(_Amat, _Bmat, computeEigenvectors);
     
-    int n = (int)A.cols();
+    if (_hermitian_solver.info() != 0)
+        return false;
+    
+    alpha.swap(_hermitian_solver.alpha);
+    beta.swap(_hermitian_solver.beta);
+    if (computeEigenvectors) {
+        VL.swap(_hermitian_solver.VL);
+        VR.swap(_hermitian_solver.VR);
+    }
+    
+    info_val            = 0;
+    _hermitian_solution = true;
+    
+    return true;
+}
+
+
+
+void
+MAST::LAPACK_ZGGEV::_compute(ComplexMatrixX &Amat,
+                             ComplexMatrixX &Bmat,
+                             bool computeEigenvectors) {
+    
+    int n = (int)Amat.cols();
+    
+    _hermitian_solution = false;
     
     char L='N',R='N';
     
     if (computeEigenvectors)
     {
         L = 'V'; R = 'V';
-        VL.setZero(n, n);
-        VR.setZero(n, n);
+        VL.resize(n, n);
+        VR.resize(n, n);
     }
     
-    int
-    lwork=16*n,
-    l_rwork=8*n;
     info_val=-1;
     
-    alpha.setZero(n);
-    beta.setZero(n);
-    ComplexVectorX
-    work  = ComplexVectorX::Zero(lwork);
-    RealVectorX
-    rwork = RealVectorX::Zero(l_rwork);
+    alpha.resize(n);
+    beta.resize(n);
     
     Complex
     *a_vals     = Amat.data(),
@@ -67,11 +132,47 @@ MAST::LAPACK_ZGGEV::compute(const ComplexMatrixX &A,
     *alpha_v    = alpha.data(),
     *beta_v     = beta.data(),
     *VL_v       = VL.data(),
-    *VR_v       = VR.data(),
-    *work_v     = work.data();
+    *VR_v       = VR.data();
+    
+    int
+    lwork       = 0;
+    
+    // query the optimal workspace size for this problem
+    if (n != _work_n || computeEigenvectors != _work_vecs) {
+        
+        _rwork.setZero(8*n);
+        
+        Complex
+        opt         = 0.;
+        lwork       = -1;
+        
+        zggev_(&L, &R, &n,
+               &(a_vals[0]), &n,
+               &(b_vals[0]), &n,
+               &(alpha_v[0]), &(beta_v[0]),
+               &(VL_v[0]), &n, &(VR_v[0]), &n,
+               &opt, &lwork,
+               &(_rwork.data()[0]),
+               &info_val);
+        
+        if (info_val == 0)
+            lwork = std::max((int)std::real(opt), std::max(1, 2*n));
+        else
+            lwork = 16*n;
+        
+        _work.setZero(lwork);
+        _work_n    = n;
+        _work_vecs = computeEigenvectors;
+        info_val   = -1;
+    }
+    
+    lwork = (int)_work.size();
+    
+    Complex
+    *work_v     = _work.data();
     
     Real
-    *rwork_v    = rwork.data();
+    *rwork_v    = _rwork.data();
     
     
     zggev_(&L, &R, &n,
@@ -88,5 +189,3 @@ MAST::LAPACK_ZGGEV::compute(const ComplexMatrixX &A,
         << "Warning!!  ZGGEV returned with nonzero info = "
         << info_val << std::endl;
 }
-
-
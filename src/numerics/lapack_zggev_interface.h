@@ -24,6 +24,7 @@
 // MAST includes
 #include "base/mast_data_types.h"
 #include "numerics/lapack_zggev_base.h"
+#include "numerics/lapack_zhegvd_interface.h"
 
 
 extern "C" {
@@ -173,17 +174,83 @@ namespace MAST {
     public:
         
         LAPACK_ZGGEV():
-        MAST::LAPACK_ZGGEV_Base()
+        MAST::LAPACK_ZGGEV_Base(),
+        _detect_hermitian(true),
+        _hermitian_solution(false)
         { }
         
         /*!
-         *    computes the eigensolution for A x = \lambda B x. A & B will be
-         *    overwritten
+         *    if \p f is true, which is the default, pairs of Hermitian
+         *    matrices are detected before each solution and are solved
+         *    with the symmetric-definite solver MAST::LAPACK_ZHEGVD, which
+         *    is several times faster than the QZ algorithm and gives
+         *    B-orthonormal eigenvectors. This is the case, for example, for
+         *    the reduced structural matrices without aerodynamic loads. If
+         *    B is not positive definite, ZGGEV is used.
+         */
+        void set_detect_hermitian(bool f) {
+            _detect_hermitian = f;
+        }
+        
+        /*!
+         *    @returns true if the last solution was obtained with the
+         *    symmetric-definite solver
+         */
+        bool if_hermitian_solution() const {
+            return _hermitian_solution;
+        }
+        
+        /*!
+         *    computes the eigensolution for A x = \lambda B x. A & B are
+         *    retained
          */
         virtual void compute(const ComplexMatrixX& A,
                              const ComplexMatrixX& B,
                              bool computeEigenvectors = true);
         
+        /*!
+         *    computes the eigensolution for A x = \lambda B x. A & B will be
+         *    overwritten
+         */
+        virtual void compute_in_place(ComplexMatrixX& A,
+                                      ComplexMatrixX& B,
+                                      bool computeEigenvectors = true);
+        
+    protected:
+        
+        /*!
+         *    calls ZGGEV for \p Amat and \p Bmat, which are overwritten.
+         *    The optimal workspace is queried if the size of the matrices
+         *    or the eigenvector option has changed since the last call.
+         */
+        void _compute(ComplexMatrixX& Amat,
+                      ComplexMatrixX& Bmat,
+                      bool computeEigenvectors);
+        
+        /*!
+         *    solves the problem with the symmetric-definite solver if the
+         *    detection is enabled and \p A and \p B are Hermitian.
+         *    @returns false if the problem was not solved, in which case
+         *    ZGGEV must be used.
+         */
+        bool _compute_hermitian(const ComplexMatrixX& A,
+                                const ComplexMatrixX& B,
+                                bool computeEigenvectors);
+        
+        /*!
+         *   flag to detect Hermitian problems
+         */
+        bool                _detect_hermitian;
+        
+        /*!
+         *   \p true if the last solution is from \p _hermitian_solver
+         */
+        bool                _hermitian_solution;
+        
+        /*!
+         *   solver for Hermitian-definite problems
+         */
+        MAST::LAPACK_ZHEGVD _hermitian_solver;
     };
 }
 
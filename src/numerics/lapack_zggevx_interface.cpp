@@ -18,6 +18,10 @@
  */
 
 
+// C++ includes
+#include <algorithm>
+
+
 // MAST includes
 #include "numerics/lapack_zggevx_interface.h"
 
@@ -34,38 +38,59 @@ MAST::LAPACK_ZGGEVX::compute(const ComplexMatrixX &A,
     _A = A;
     _B = B;
     
-    ComplexMatrixX
-    Amat = _A,
-    Bmat = _B;
+    // the working copies keep their storage if the size is unchanged
+    _Amat = A;
+    _Bmat = B;
+    
+    _compute(_Amat, _Bmat, computeEigenvectors);
+    _if_matrices = true;
+}
+
+
+
+void
+MAST::LAPACK_ZGGEVX::compute_in_place(ComplexMatrixX &A,
+                                      ComplexMatrixX &B,
+                                      bool computeEigenvectors) {
     
-    int n = (int)A.cols();
+    libmesh_assert(A.cols() == A.rows() &&
+                   B.cols() == A.rows() &&
+                   B.cols() == B.rows());
+    
+    _if_matrices = false;
+    _compute(A, B, computeEigenvectors);
+}
+
+
+
+void
+MAST::LAPACK_ZGGEVX::_compute(ComplexMatrixX &Amat,
+                              ComplexMatrixX &Bmat,
+                              bool computeEigenvectors) {
+    
+    int n = (int)Amat.cols();
     
     char BAL='B', L='N',R='N', S='E';
     
     if (computeEigenvectors) {
         
         L = 'V'; R = 'V'; S='B';
-        VL.setZero(n, n);
-        VR.setZero(n, n);
+        VL.resize(n, n);
+        VR.resize(n, n);
     }
     
     int
-    lwork    =4*(n*n+n),
-    l_rwork  =8*n,
+    lwork    = 0,
     ilo      = 0,
     ihi      = 0;
-    info_val =-1,
-    
-    alpha.setZero(n);
-    beta.setZero(n);
-    ComplexVectorX
-    work   = ComplexVectorX::Zero(lwork);
-    RealVectorX
-    rwork  = RealVectorX::Zero(l_rwork),
-    lscale = RealVectorX::Zero(n),
-    rscale = RealVectorX::Zero(n),
-    rconde = RealVectorX::Zero(n),
-    rcondv = RealVectorX::Zero(n);
+    info_val =-1;
+    
+    alpha.resize(n);
+    beta.resize(n);
+    _lscale.resize(n);
+    _rscale.resize(n);
+    _rconde.resize(n);
+    _rcondv.resize(n);
     
     Complex
     *a_vals  = Amat.data(),
@@ -73,23 +98,61 @@ MAST::LAPACK_ZGGEVX::compute(const ComplexMatrixX &A,
     *alpha_v = alpha.data(),
     *beta_v  = beta.data(),
     *VL_v    = VL.data(),
-    *VR_v    = VR.data(),
-    *work_v  = work.data();
+    *VR_v    = VR.data();
     
     Real
-    *rwork_v  = rwork.data(),
-    *lscale_v = lscale.data(),
-    *rscale_v = rscale.data(),
-    *rconde_v = rconde.data(),
-    *rcondv_v = rcondv.data(),
+    *lscale_v = _lscale.data(),
+    *rscale_v = _rscale.data(),
+    *rconde_v = _rconde.data(),
+    *rcondv_v = _rcondv.data(),
     abnrm     = 0.,
     bbnrm     = 0.;
     
-    std::vector<int>
-    iwork(n+2, 0);
+    // query the optimal workspace size for this problem
+    if (n != _work_n || computeEigenvectors != _work_vecs) {
+        
+        _rwork.setZero(8*n);
+        _iwork.assign(n+2, 0);
+        _bwork.assign(n, 0);
+        
+        Complex
+        opt      = 0.;
+        lwork    = -1;
+        
+        zggevx_(&BAL, &L, &R, &S, &n,
+                &(a_vals[0]), &n,
+                &(b_vals[0]), &n,
+                &(alpha_v[0]), &(beta_v[0]),
+                &(VL_v[0]), &n,
+                &(VR_v[0]), &n,
+                &ilo, &ihi,
+                &(lscale_v[0]), &(rscale_v[0]),
+                &abnrm, &bbnrm,
+                &(rconde_v[0]), &(rcondv_v[0]),
+                &opt, &lwork,
+                &(_rwork.data()[0]),
+                &(_iwork[0]),
+                &(_bwork[0]),
+                &info_val);
+        
+        if (info_val == 0)
+            lwork = std::max((int)std::real(opt), 4*(n*n+n));
+        else
+            lwork = 4*(n*n+n);
+        
+        _work.setZero(lwork);
+        _work_n    = n;
+        _work_vecs = computeEigenvectors;
+        info_val   = -1;
+    }
+    
+    lwork = (int)_work.size();
     
-    bool
-    bwork[n];
+    Complex
+    *work_v  = _work.data();
+    
+    Real
+    *rwork_v  = _rwork.data();
     
     zggevx_(&BAL, &L, &R, &S, &n,
             &(a_vals[0]), &n,
@@ -103,8 +166,8 @@ MAST::LAPACK_ZGGEVX::compute(const ComplexMatrixX &A,
             &(rconde_v[0]), &(rcondv_v[0]),
             &(work_v[0]), &lwork,
             &(rwork_v[0]),
-            &(iwork[0]),
-            &(bwork[0]),
+            &(_iwork[0]),
+            &(_bwork[0]),
             &info_val);
     
     if (info_val  != 0)
@@ -112,5 +175,3 @@ MAST::LAPACK_ZGGEVX::compute(const ComplexMatrixX &A,
         << "Warning!!  ZGGEVX returned with nonzero info = "
         << info_val << std::endl;
 }
-
-
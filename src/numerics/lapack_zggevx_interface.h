@@ -280,7 +280,7 @@ extern "C" {
                        int*                  lwork,
                        double*               rwork,
                        int*                  iwork,
-                       bool*                 bwork,
+                       int*                  bwork,
                        int*                  info);
     
 }
@@ -298,13 +298,49 @@ namespace MAST {
         { }
         
         /*!
-         *    computes the eigensolution for A x = \lambda B x. A & B will be
-         *    overwritten
+         *    computes the eigensolution for A x = \lambda B x. A & B are
+         *    retained
          */
         virtual void compute(const ComplexMatrixX& A,
                              const ComplexMatrixX& B,
                              bool computeEigenvectors = true);
         
+        /*!
+         *    computes the eigensolution for A x = \lambda B x. A & B will be
+         *    overwritten
+         */
+        virtual void compute_in_place(ComplexMatrixX& A,
+                                      ComplexMatrixX& B,
+                                      bool computeEigenvectors = true);
+        
+    protected:
+        
+        /*!
+         *    calls ZGGEVX for \p Amat and \p Bmat, which are overwritten.
+         *    The optimal workspace is queried if the size of the matrices
+         *    or the eigenvector option has changed since the last call.
+         */
+        void _compute(ComplexMatrixX& Amat,
+                      ComplexMatrixX& Bmat,
+                      bool computeEigenvectors);
+        
+        /*!
+         *   balancing factors and reciprocal condition numbers
+         */
+        RealVectorX      _lscale;
+        
+        RealVectorX      _rscale;
+        
+        RealVectorX      _rconde;
+        
+        RealVectorX      _rcondv;
+        
+        /*!
+         *   integer and logical workspace arrays
+         */
+        std::vector<int> _iwork;
+        
+        std::vector<int> _bwork;
     };
 }
 
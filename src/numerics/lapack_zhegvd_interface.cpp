@@ -0,0 +1,205 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2017  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+// C++ includes
+#include <algorithm>
+
+
+// MAST includes
+#include "numerics/lapack_zhegvd_interface.h"
+
+
+bool
+MAST::LAPACK_ZHEGVD::is_hermitian(const ComplexMatrixX& A,
+                                  const ComplexMatrixX& B,
+                                  Real tol) {
+    
+    if (A.rows() != A.cols() || B.rows() != B.cols())
+        return false;
+    
+    const Real
+    a = A.cwiseAbs().maxCoeff(),
+    b = B.cwiseAbs().maxCoeff();
+    
+    return ((A - A.adjoint()).cwiseAbs().maxCoeff() <= tol * a &&
+            (B - B.adjoint()).cwiseAbs().maxCoeff() <= tol * b);
+}
+
+
+
+void
+MAST::LAPACK_ZHEGVD::compute(const ComplexMatrixX &A,
+                             const ComplexMatrixX &B,
+                             bool computeEigenvectors) {
+    
+    libmesh_assert(A.cols() == A.rows() &&
+                   B.cols() == A.rows() &&
+                   B.cols() == B.rows());
+    
+    _A = A;
+    _B = B;
+    
+    // the working copies keep their storage if the size is unchanged
+    _Amat = A;
+    _Bmat = B;
+    
+    _compute(_Amat, _Bmat, computeEigenvectors);
+    _if_matrices = true;
+}
+
+
+
+void
+MAST::LAPACK_ZHEGVD::compute_in_place(ComplexMatrixX &A,
+                                      ComplexMatrixX &B,
+                                      bool computeEigenvectors) {
+    
+    libmesh_assert(A.cols() == A.rows() &&
+                   B.cols() == A.rows() &&
+                   B.cols() == B.rows());
+    
+    _if_matrices = false;
+    _compute(A, B, computeEigenvectors);
+}
+
+
+
+void
+MAST::LAPACK_ZHEGVD::_compute(ComplexMatrixX &Amat,
+                              ComplexMatrixX &Bmat,
+                              bool computeEigenvectors) {
+    
+    int
+    n      = (int)Amat.cols();
+    
+    info_val = -1;
+    
+    alpha.resize(n);
+    beta.setOnes(n);
+    
+    // real matrices, for example the structural matrices without
+    // aerodynamic terms, are solved in real arithmetic
+    if (Amat.imag().cwiseAbs().maxCoeff() == 0. &&
+        Bmat.imag().cwiseAbs().maxCoeff() == 0.) {
+        
+        RealMatrixX
+        a = Amat.real(),
+        b = Bmat.real();
+        
+        _real_solver.compute_in_place(a, b, computeEigenvectors);
+        info_val = _real_solver.info();
+        
+        if (info_val != 0)
+            return;
+        
+        alpha = _real_solver.eigenvalues().cast<Complex>();
+        if (computeEigenvectors) {
+            VR = _real_solver.eigenvectors().cast<Complex>();
+            VL = VR;
+        }
+        
+        return;
+    }
+    
+    int
+    itype  = 1,
+    lwork  = 0,
+    lrwork = 0,
+    liwork = 0;
+    
+    char
+    jobz   = computeEigenvectors? 'V': 'N',
+    uplo   = 'U';
+    
+    _w.resize(n);
+    
+    Complex
+    *a_vals = Amat.data(),
+    *b_vals = Bmat.data();
+    
+    // query the optimal workspace size for this problem
+    if (n != _work_n || computeEigenvectors != _work_vecs) {
+        
+        Complex
+        opt      = 0.;
+        Real
+        ropt     = 0.;
+        int
+        iopt     = 0;
+        lwork    = -1;
+        lrwork   = -1;
+        liwork   = -1;
+        
+        zhegvd_(&itype, &jobz, &uplo, &n,
+                &(a_vals[0]), &n,
+                &(b_vals[0]), &n,
+                &(_w.data()[0]),
+                &opt, &lwork,
+                &ropt, &lrwork,
+                &iopt, &liwork,
+                &info_val);
+        
+        if (info_val == 0) {
+            lwork  = std::max((int)std::real(opt), 1);
+            lrwork = std::max((int)ropt, 1);
+            liwork = std::max(iopt, 1);
+        }
+        else {
+            lwork  = 2*n + n*n;
+            lrwork = 1 + 5*n + 2*n*n;
+            liwork = 3 + 5*n;
+        }
+        
+        _work.setZero(lwork);
+        _rwork.setZero(lrwork);
+        _iwork.resize(liwork);
+        _work_n    = n;
+        _work_vecs = computeEigenvectors;
+        info_val   = -1;
+    }
+    
+    lwork  = (int)_work.size();
+    lrwork = (int)_rwork.size();
+    liwork = (int)_iwork.size();
+    
+    zhegvd_(&itype, &jobz, &uplo, &n,
+            &(a_vals[0]), &n,
+            &(b_vals[0]), &n,
+            &(_w.data()[0]),
+            &(_work.data()[0]), &lwork,
+            &(_rwork.data()[0]), &lrwork,
+            &(_iwork[0]), &liwork,
+            &info_val);
+    
+    if (info_val  != 0) {
+        
+        libMesh::out
+        << "Warning!!  ZHEGVD returned with nonzero info = "
+        << info_val << std::endl;
+        return;
+    }
+    
+    alpha = _w.cast<Complex>();
+    if (computeEigenvectors) {
+        VR = Amat;
+        VL = VR;
+    }
+}
+
@@ -0,0 +1,239 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2017  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+#ifndef __mast__lapack_zhegvd_interface_h__
+#define __mast__lapack_zhegvd_interface_h__
+
+
+// MAST includes
+#include "base/mast_data_types.h"
+#include "numerics/lapack_zggev_base.h"
+#include "numerics/lapack_dsygvd_interface.h"
+
+
+extern "C" {
+    
+    /*
+     *  =====================================================================
+     *  Purpose
+     *  =======
+     *
+     *  ZHEGVD computes all the eigenvalues, and optionally, the eigenvectors
+     *  of a complex generalized Hermitian-definite eigenproblem, of the form
+     *  A*x=(lambda)*B*x,  A*Bx=(lambda)*x,  or B*A*x=(lambda)*x.  Here A and
+     *  B are assumed to be Hermitian and B is also positive definite.
+     *  If eigenvectors are desired, it uses a divide and conquer algorithm.
+     *
+     *  Arguments
+     *  =========
+     *
+     *  ITYPE   (input) INTEGER
+     *          Specifies the problem type to be solved:
+     *          = 1:  A*x = (lambda)*B*x
+     *          = 2:  A*B*x = (lambda)*x
+     *          = 3:  B*A*x = (lambda)*x
+     *
+     *  JOBZ    (input) CHARACTER*1
+     *          = 'N':  Compute eigenvalues only;
+     *          = 'V':  Compute eigenvalues and eigenvectors.
+     *
+     *  UPLO    (input) CHARACTER*1
+     *          = 'U':  Upper triangles of A and B are stored;
+     *          = 'L':  Lower triangles of A and B are stored.
+     *
+     *  N       (input) INTEGER
+     *          The order of the matrices A and B.  N >= 0.
+     *
+     *  A       (input/output) COMPLEX*16 array, dimension (LDA, N)
+     *          On entry, the Hermitian matrix A.
+     *          On exit, if JOBZ = 'V', then if INFO = 0, A contains the
+     *          matrix Z of eigenvectors.  The eigenvectors are normalized
+     *          as follows: if ITYPE = 1 or 2, Z**H*B*Z = I; if ITYPE = 3,
+     *          Z**H*inv(B)*Z = I. If JOBZ = 'N', then on exit the upper
+     *          triangle (if UPLO='U') or the lower triangle (if UPLO='L')
+     *          of A, including the diagonal, is destroyed.
+     *
+     *  LDA     (input) INTEGER
+     *          The leading dimension of the array A.  LDA >= max(1,N).
+     *
+     *  B       (input/output) COMPLEX*16 array, dimension (LDB, N)
+     *          On entry, the Hermitian matrix B.
+     *          On exit, if INFO <= N, the part of B containing the matrix is
+     *          overwritten by the triangular factor U or L from the Cholesky
+     *          factorization B = U**H*U or B = L*L**H.
+     *
+     *  LDB     (input) INTEGER
+     *          The leading dimension of the array B.  LDB >= max(1,N).
+     *
+     *  W       (output) DOUBLE PRECISION array, dimension (N)
+     *          If INFO = 0, the eigenvalues in ascending order.
+     *
+     *  WORK    (workspace/output) COMPLEX*16 array, dimension (MAX(1,LWORK))
+     *          On exit, if INFO = 0, WORK(1) returns the optimal LWORK.
+     *
+     *  LWORK   (input) INTEGER
+     *          The length of the array WORK.
+     *          If N <= 1,                LWORK >= 1.
+     *          If JOBZ  = 'N' and N > 1, LWORK >= N + 1.
+     *          If JOBZ  = 'V' and N > 1, LWORK >= 2*N + N**2.
+     *
+     *  RWORK   (workspace/output) DOUBLE PRECISION array, dimension (MAX(1,LRWORK))
+     *          On exit, if INFO = 0, RWORK(1) returns the optimal LRWORK.
+     *
+     *  LRWORK  (input) INTEGER
+     *          The dimension of the array RWORK.
+     *          If N <= 1,                LRWORK >= 1.
+     *          If JOBZ  = 'N' and N > 1, LRWORK >= N.
+     *          If JOBZ  = 'V' and N > 1, LRWORK >= 1 + 5*N + 2*N**2.
+     *
+     *  IWORK   (workspace/output) INTEGER array, dimension (MAX(1,LIWORK))
+     *          On exit, if INFO = 0, IWORK(1) returns the optimal LIWORK.
+     *
+     *  LIWORK  (input) INTEGER
+     *          The dimension of the array IWORK.
+     *          If N <= 1,                LIWORK >= 1.
+     *          If JOBZ  = 'N' and N > 1, LIWORK >= 1.
+     *          If JOBZ  = 'V' and N > 1, LIWORK >= 3 + 5*N.
+     *
+     *          If LWORK, LRWORK or LIWORK = -1, then a workspace query is
+     *          assumed; the routine only calculates the optimal sizes of
+     *          the WORK, RWORK and IWORK arrays.
+     *
+     *  INFO    (output) INTEGER
+     *          = 0:  successful exit
+     *          < 0:  if INFO = -i, the i-th argument had an illegal value
+     *          > 0:  ZPOTRF or ZHEEVD returned an error code:
+     *             <= N:  the algorithm failed to converge;
+     *             > N:   if INFO = N + i, for 1 <= i <= N, then the leading
+     *                    minor of order i of B is not positive definite.
+     *                    The factorization of B could not be completed and
+     *                    no eigenvalues or eigenvectors were computed.
+     *
+     *  =====================================================================
+     */
+    extern int zhegvd_(int*                  itype,
+                       char*                 jobz,
+                       char*                 uplo,
+                       int*                  n,
+                       std::complex<double>* a,
+                       int*                  lda,
+                       std::complex<double>* b,
+                       int*                  ldb,
+                       double*               w,
+                       std::complex<double>* work,
+                       int*                  lwork,
+                       double*               rwork,
+                       int*                  lrwork,
+                       int*                  iwork,
+                       int*                  liwork,
+                       int*                  info);
+    
+}
+
+
+namespace MAST {
+    
+    // Forward declerations
+    class LAPACK_ZGGEV;
+    
+    
+    /*!
+     *    Solves the Hermitian-definite generalized eigenproblem
+     *    A x = \lambda B x, where A is Hermitian and B is Hermitian positive
+     *    definite, with the interface of MAST::LAPACK_ZGGEV_Base, so that
+     *    the solution can be used in place of that of MAST::LAPACK_ZGGEV.
+     *    The eigenvalues are real and ascending, with alphas() storing
+     *    the eigenvalues and betas() equal to one. The right and left
+     *    eigenvectors are the same B-orthonormal vectors,
+     *    X^H B X = I. If the imaginary parts of both matrices are zero,
+     *    the real problem is solved with MAST::LAPACK_DSYGVD. Only the
+     *    upper triangles of the matrices are used.
+     */
+    class LAPACK_ZHEGVD:
+    public MAST::LAPACK_ZGGEV_Base {
+        
+    public:
+        
+        LAPACK_ZHEGVD():
+        MAST::LAPACK_ZGGEV_Base()
+        { }
+        
+        /*!
+         *    computes the eigensolution for A x = \lambda B x. A & B are
+         *    retained
+         */
+        virtual void compute(const ComplexMatrixX& A,
+                             const ComplexMatrixX& B,
+                             bool computeEigenvectors = true);
+        
+        /*!
+         *    computes the eigensolution for A x = \lambda B x. A & B will be
+         *    overwritten
+         */
+        virtual void compute_in_place(ComplexMatrixX& A,
+                                      ComplexMatrixX& B,
+                                      bool computeEigenvectors = true);
+        
+        /*!
+         *    @returns the info value returned by LAPACK. A value greater
+         *    than the size of the matrices indicates that B is not
+         *    positive definite.
+         */
+        int info() const {
+            return info_val;
+        }
+        
+        /*!
+         *    @returns true if \p A and \p B are Hermitian to within the
+         *    relative tolerance \p tol on the largest entry of each matrix
+         */
+        static bool is_hermitian(const ComplexMatrixX& A,
+                                 const ComplexMatrixX& B,
+                                 Real tol = 1.e-12);
+        
+    protected:
+        
+        /*!
+         *    calls ZHEGVD, or DSYGVD for real matrices, for \p Amat and
+         *    \p Bmat, which are overwritten.
+         */
+        void _compute(ComplexMatrixX& Amat,
+                      ComplexMatrixX& Bmat,
+                      bool computeEigenvectors);
+        
+        /*!
+         *   solver for real matrices
+         */
+        MAST::LAPACK_DSYGVD _real_solver;
+        
+        /*!
+         *   eigenvalues from LAPACK, and the integer workspace
+         */
+        RealVectorX         _w;
+        
+        std::vector<int>    _iwork;
+        
+        friend class MAST::LAPACK_ZGGEV;
+    };
+}
+
+
+
+#endif // __mast__lapack_zhegvd_interface_h__
@@ -0,0 +1,135 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2017  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+// C++ includes
+#include <algorithm>
+
+
+// MAST includes
+#include "numerics/point_tree.h"
+
+
+MAST::PointTree::PointTree():
+_dim(0)
+{ }
+
+
+
+MAST::PointTree::PointTree(const std::vector<libMesh::Point>& pts,
+                           unsigned int dim):
+_dim(0) {
+    
+    this->init(pts, dim);
+}
+
+
+
+void
+MAST::PointTree::init(const std::vector<libMesh::Point>& pts,
+                      unsigned int dim) {
+    
+    libmesh_assert_greater(dim, 0);
+    libmesh_assert_less_equal(dim, 3);
+    
+    _pts = pts;
+    _dim = dim;
+    _idx.resize(pts.size());
+    
+    for (unsigned int i=0; i<_idx.size(); i++)
+        _idx[i] = i;
+    
+    _build(0, (unsigned int)_idx.size(), 0);
+}
+
+
+
+void
+MAST::PointTree::clear() {
+    
+    _pts.clear();
+    _idx.clear();
+    _dim = 0;
+}
+
+
+
+void
+MAST::PointTree::find(const libMesh::Point& p,
+                      Real r,
+                      std::vector<unsigned int>& ids) const {
+    
+    ids.clear();
+    _find(0, (unsigned int)_idx.size(), 0, p, r, ids);
+}
+
+
+
+void
+MAST::PointTree::_build(unsigned int lo, unsigned int hi, unsigned int d) {
+    
+    if (hi - lo < 2)
+        return;
+    
+    const unsigned int
+    mid  = (lo + hi)/2,
+    axis = d % _dim;
+    
+    const std::vector<libMesh::Point>& pts = _pts;
+    
+    std::nth_element(_idx.begin()+lo,
+                     _idx.begin()+mid,
+                     _idx.begin()+hi,
+                     [&pts, axis](unsigned int a, unsigned int b)
+                     { return pts[a](axis) < pts[b](axis); });
+    
+    _build(lo, mid, d+1);
+    _build(mid+1, hi, d+1);
+}
+
+
+
+void
+MAST::PointTree::_find(unsigned int lo,
+                       unsigned int hi,
+                       unsigned int d,
+                       const libMesh::Point& p,
+                       Real r,
+                       std::vector<unsigned int>& ids) const {
+    
+    if (lo >= hi)
+        return;
+    
+    const unsigned int
+    mid  = (lo + hi)/2,
+    axis = d % _dim,
+    i    = _idx[mid];
+    
+    if ((_pts[i] - p).norm() <= r)
+        ids.push_back(i);
+    
+    // points before the median are not greater than the median
+    // along the axis, and points after it are not smaller
+    const Real
+    diff = p(axis) - _pts[i](axis);
+    
+    if (diff <= r)
+        _find(lo, mid, d+1, p, r, ids);
+    if (diff >= -r)
+        _find(mid+1, hi, d+1, p, r, ids);
+}
@@ -0,0 +1,104 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2017  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef __mast__point_tree_h__
+#define __mast__point_tree_h__
+
+// C++ includes
+#include <vector>
+
+
+// MAST includes
+#include "base/mast_data_types.h"
+
+
+// libMesh includes
+#include "libmesh/point.h"
+
+
+namespace MAST {
+    
+    /*!
+     *   k-d tree over a set of points, stored as a permutation of the
+     *   points in which the median of each subrange is the node that
+     *   splits the subrange. The points are copied to the tree, and the
+     *   ids returned by find() are the indices of the points in the
+     *   vector given to init().
+     */
+    class PointTree {
+        
+    public:
+        
+        PointTree();
+        
+        
+        PointTree(const std::vector<libMesh::Point>& pts,
+                  unsigned int dim);
+        
+        
+        /*!
+         *   builds the tree for the first \p dim coordinates of \p pts
+         */
+        void init(const std::vector<libMesh::Point>& pts,
+                  unsigned int dim);
+        
+        
+        /*!
+         *   clears the points of the tree
+         */
+        void clear();
+        
+        
+        /*!
+         *   @returns the number of points in the tree
+         */
+        unsigned int n_points() const {
+            return (unsigned int)_pts.size();
+        }
+        
+        
+        /*!
+         *   sets \p ids to the points within distance \p r of \p p
+         */
+        void find(const libMesh::Point& p,
+                  Real r,
+                  std::vector<unsigned int>& ids) const;
+        
+    protected:
+        
+        void _build(unsigned int lo, unsigned int hi, unsigned int d);
+        
+        
+        void _find(unsigned int lo,
+                   unsigned int hi,
+                   unsigned int d,
+                   const libMesh::Point& p,
+                   Real r,
+                   std::vector<unsigned int>& ids) const;
+        
+        
+        std::vector<libMesh::Point>        _pts;
+        
+        unsigned int                       _dim;
+        
+        std::vector<unsigned int>          _idx;
+    };
+}
+
+#endif // __mast__point_tree_h__
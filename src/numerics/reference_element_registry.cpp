@@ -0,0 +1,170 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2017  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+// C++ includes
+#include <map>
+#include <mutex>
+
+
+// MAST includes
+#include "numerics/reference_element_registry.h"
+
+
+// libMesh includes
+#include "libmesh/fe_base.h"
+#include "libmesh/quadrature.h"
+
+
+namespace MAST {
+    
+    /*!
+     *   objects owned by the registry. The available objects are indexed
+     *   by the shape function family and order, the element type and the
+     *   quadrature order, and the objects in use are stored with their
+     *   index.
+     */
+    struct ReferenceElementCache {
+        
+        typedef std::pair<libMesh::FEBase*, libMesh::QBase*> FEQRule;
+        
+        ~ReferenceElementCache() {
+            
+            this->clear();
+        }
+        
+        void clear() {
+            
+            std::map<std::vector<int>, std::vector<FEQRule> >::iterator
+            it   = available.begin(),
+            end  = available.end();
+            
+            for ( ; it != end; it++)
+                for (unsigned int i=0; i<it->second.size(); i++) {
+                    
+                    delete it->second[i].first;
+                    delete it->second[i].second;
+                }
+            
+            available.clear();
+        }
+        
+        std::mutex                                             mutex;
+        
+        std::map<std::vector<int>, std::vector<FEQRule> >      available;
+        
+        std::map<const libMesh::FEBase*, std::vector<int> >    in_use;
+    };
+    
+    static MAST::ReferenceElementCache _reference_element_cache;
+}
+
+
+
+void
+MAST::ReferenceElementRegistry::
+acquire(const libMesh::FEType& fe_type,
+        libMesh::ElemType e_type,
+        unsigned int dim,
+        int extra_quadrature_order,
+        libMesh::FEBase** fe,
+        libMesh::QBase** qrule) {
+    
+    std::vector<int> key(5);
+    key[0] = (int)fe_type.family;
+    key[1] = (int)fe_type.order;
+    key[2] = (int)e_type;
+    key[3] = (int)dim;
+    key[4] = (int)fe_type.default_quadrature_order() + extra_quadrature_order;
+    
+    std::lock_guard<std::mutex>
+    lock(_reference_element_cache.mutex);
+    
+    std::vector<MAST::ReferenceElementCache::FEQRule>&
+    objs = _reference_element_cache.available[key];
+    
+    if (objs.size()) {
+        
+        (*fe)    = objs.back().first;
+        (*qrule) = objs.back().second;
+        objs.pop_back();
+    }
+    else {
+        
+        (*fe)    = libMesh::FEBase::build(dim, fe_type).release();
+        (*qrule) = fe_type.default_quadrature_rule(dim,
+                                                   extra_quadrature_order).release();
+        (*fe)->attach_quadrature_rule(*qrule);
+    }
+    
+    _reference_element_cache.in_use[*fe] = key;
+}
+
+
+
+void
+MAST::ReferenceElementRegistry::release(libMesh::FEBase* fe,
+                                        libMesh::QBase* qrule) {
+    
+    std::lock_guard<std::mutex>
+    lock(_reference_element_cache.mutex);
+    
+    std::map<const libMesh::FEBase*, std::vector<int> >::iterator
+    it = _reference_element_cache.in_use.find(fe);
+    
+    // the objects must have been obtained from acquire()
+    libmesh_assert(it != _reference_element_cache.in_use.end());
+    
+    _reference_element_cache.available[it->second].push_back
+    (MAST::ReferenceElementCache::FEQRule(fe, qrule));
+    _reference_element_cache.in_use.erase(it);
+}
+
+
+
+void
+MAST::ReferenceElementRegistry::clear() {
+    
+    std::lock_guard<std::mutex>
+    lock(_reference_element_cache.mutex);
+    
+    _reference_element_cache.clear();
+}
+
+
+
+unsigned int
+MAST::ReferenceElementRegistry::n_objects() {
+    
+    std::lock_guard<std::mutex>
+    lock(_reference_element_cache.mutex);
+    
+    unsigned int
+    n = (unsigned int)_reference_element_cache.in_use.size();
+    
+    std::map<std::vector<int>, std::vector<MAST::ReferenceElementCache::FEQRule> >::const_iterator
+    it   = _reference_element_cache.available.begin(),
+    end  = _reference_element_cache.available.end();
+    
+    for ( ; it != end; it++)
+        n += (unsigned int)it->second.size();
+    
+    return n;
+}
+
@@ -0,0 +1,112 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2017  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+#ifndef __mast__reference_element_registry__
+#define __mast__reference_element_registry__
+
+// C++ includes
+#include <vector>
+
+
+// MAST includes
+#include "base/mast_data_types.h"
+
+
+// libMesh includes
+#include "libmesh/fe_type.h"
+#include "libmesh/enum_elem_type.h"
+
+
+namespace libMesh {
+    
+    // Forward declerations
+    class FEBase;
+    class QBase;
+}
+
+
+namespace MAST {
+    
+    /*!
+     *   Registry of the finite element and quadrature rule objects used
+     *   by the elements for volume integration, indexed by the shape
+     *   function family and order, the element type and the quadrature
+     *   order. A libMesh::FEBase object computes the shape functions and
+     *   their reference derivatives at the quadrature points when it is
+     *   first initialized for an element type, and on subsequent calls
+     *   to \p reinit() for elements of the same type only computes the
+     *   mapping of the element (which, for elements with an affine map,
+     *   is evaluated once per element) and the physical derivatives.
+     *   The objects released by an element are kept by the registry
+     *   and given to the next element of the same type, so that the
+     *   reference tables are computed once for each combination instead
+     *   of once for each element, and only as many objects exist as
+     *   there are elements alive at a time. An object is used by only
+     *   one element at a time. This is thread-safe.
+     */
+    class ReferenceElementRegistry {
+        
+    public:
+        
+        /*!
+         *   provides in \p fe and \p qrule the objects for elements of
+         *   type \p e_type and dimension \p dim with shape functions
+         *   \p fe_type and the default quadrature rule increased by
+         *   \p extra_quadrature_order. The quadrature rule is attached
+         *   to the finite element. The objects are owned by the registry
+         *   and must be returned with release() once the element no
+         *   longer needs them. Newly created objects have not computed
+         *   any quantity, and the caller must request the quantities
+         *   before the first \p reinit(). The same quantities must be
+         *   requested for all uses of an element type.
+         */
+        static void
+        acquire(const libMesh::FEType& fe_type,
+                libMesh::ElemType e_type,
+                unsigned int dim,
+                int extra_quadrature_order,
+                libMesh::FEBase** fe,
+                libMesh::QBase** qrule);
+        
+        
+        /*!
+         *   returns the objects obtained from acquire() to the registry
+         */
+        static void
+        release(libMesh::FEBase* fe,
+                libMesh::QBase* qrule);
+        
+        
+        /*!
+         *   deletes the objects that are not in use
+         */
+        static void clear();
+        
+        
+        /*!
+         *   @returns the number of objects owned by the registry,
+         *   including those in use
+         */
+        static unsigned int n_objects();
+    };
+}
+
+
+#endif // __mast__reference_element_registry__
@@ -0,0 +1,462 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2017  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+// C++ includes
+#include <map>
+#include <mutex>
+#include <cmath>
+#include <algorithm>
+
+
+// MAST includes
+#include "numerics/tensor_product_kernel.h"
+
+
+// libMesh includes
+#include "libmesh/quadrature_gauss.h"
+#include "libmesh/fe_interface.h"
+
+
+namespace MAST {
+    
+    /*!
+     *   kernels shared by the elements, indexed by the shape function
+     *   family and order, the element type and the quadrature order.
+     *   Unsupported combinations are stored as \p nullptr.
+     */
+    struct TensorProductKernelCache {
+        
+        ~TensorProductKernelCache() {
+            
+            std::map<std::vector<int>, MAST::TensorProductKernel*>::iterator
+            it   = kernels.begin(),
+            end  = kernels.end();
+            
+            for ( ; it != end; it++)
+                if (it->second) delete it->second;
+        }
+        
+        std::mutex                                               mutex;
+        
+        std::map<std::vector<int>, MAST::TensorProductKernel*>  kernels;
+    };
+    
+    static MAST::TensorProductKernelCache _tensor_product_kernel_cache;
+}
+
+
+
+MAST::TensorProductKernel::
+TensorProductKernel(const libMesh::FEType& fe_type,
+                    libMesh::ElemType e_type,
+                    libMesh::Order q_order):
+_dim(0),
+_n1(0),
+_nq1(0) {
+    
+    libmesh_assert(supported(fe_type, e_type));
+    
+    switch (e_type) {
+        case libMesh::EDGE2:
+        case libMesh::EDGE3:
+            _dim = 1;
+            break;
+            
+        case libMesh::QUAD4:
+        case libMesh::QUAD9:
+            _dim = 2;
+            break;
+            
+        case libMesh::HEX8:
+        case libMesh::HEX27:
+            _dim = 3;
+            break;
+            
+        default:
+            libmesh_error();
+    }
+    
+    _n1 = (unsigned int)fe_type.order + 1;
+    
+    // 1D Gauss rule
+    libMesh::QGauss q1(1, q_order);
+    q1.init(libMesh::EDGE2);
+    _nq1 = q1.n_points();
+    
+    // equispaced 1D nodes in [-1, 1]
+    std::vector<Real>
+    xi(_n1, 0.);
+    for (unsigned int a=0; a<_n1; a++)
+        xi[a] = -1. + 2.*a/(_n1-1.);
+    
+    // 1D Lagrange polynomials and their derivatives at the quadrature
+    // points
+    _B.setZero(_nq1, _n1);
+    _D.setZero(_nq1, _n1);
+    
+    for (unsigned int q=0; q<_nq1; q++) {
+        
+        const Real x = q1.qp(q)(0);
+        
+        for (unsigned int a=0; a<_n1; a++) {
+            
+            Real
+            v  = 1.,
+            dv = 0.;
+            
+            for (unsigned int b=0; b<_n1; b++) {
+                
+                if (b == a) continue;
+                
+                // product rule for the derivative of the product of
+                // the factors up to b
+                dv = dv * (x-xi[b])/(xi[a]-xi[b]) + v/(xi[a]-xi[b]);
+                v *= (x-xi[b])/(xi[a]-xi[b]);
+            }
+            
+            _B(q, a) = v;
+            _D(q, a) = dv;
+        }
+    }
+    
+    // the tensor-product nodes are identified with the libMesh nodes by
+    // evaluating the shape functions at the node locations
+    const unsigned int
+    n2 = _dim > 1 ? _n1 : 1,
+    n3 = _dim > 2 ? _n1 : 1,
+    nshape = libMesh::FEInterface::n_shape_functions(_dim, fe_type, e_type);
+    
+    libmesh_assert_equal_to(nshape, _n1*n2*n3);
+    
+    _node_map.resize(nshape);
+    
+    for (unsigned int k=0; k<n3; k++)
+        for (unsigned int j=0; j<n2; j++)
+            for (unsigned int i=0; i<_n1; i++) {
+                
+                libMesh::Point p(xi[i], 0., 0.);
+                if (_dim > 1) p(1) = xi[j];
+                if (_dim > 2) p(2) = xi[k];
+                
+                unsigned int
+                n = nshape;
+                for (unsigned int l=0; l<nshape; l++)
+                    if (std::fabs(libMesh::FEInterface::shape(_dim,
+                                                              fe_type,
+                                                              e_type,
+                                                              l,
+                                                              p) - 1.) < 1.e-10) {
+                        n = l;
+                        break;
+                    }
+                
+                libmesh_assert_less(n, nshape);
+                _node_map[(k*n2+j)*_n1+i] = n;
+            }
+    
+    // quadrature points with the first direction fastest
+    const unsigned int
+    nq2 = _dim > 1 ? _nq1 : 1,
+    nq3 = _dim > 2 ? _nq1 : 1;
+    
+    _qpoints.resize(_nq1*nq2*nq3);
+    
+    for (unsigned int k=0; k<nq3; k++)
+        for (unsigned int j=0; j<nq2; j++)
+            for (unsigned int i=0; i<_nq1; i++) {
+                
+                libMesh::Point& p = _qpoints[(k*nq2+j)*_nq1+i];
+                p(0) = q1.qp(i)(0);
+                if (_dim > 1) p(1) = q1.qp(j)(0);
+                if (_dim > 2) p(2) = q1.qp(k)(0);
+            }
+}
+
+
+
+MAST::TensorProductKernel::~TensorProductKernel() {
+    
+}
+
+
+
+bool
+MAST::TensorProductKernel::supported(const libMesh::FEType& fe_type,
+                                     libMesh::ElemType e_type) {
+    
+    if (fe_type.family != libMesh::LAGRANGE)
+        return false;
+    
+    switch (fe_type.order) {
+            
+        case libMesh::FIRST:
+            return (e_type == libMesh::EDGE2 ||
+                    e_type == libMesh::EDGE3 ||
+                    e_type == libMesh::QUAD4 ||
+                    e_type == libMesh::QUAD9 ||
+                    e_type == libMesh::HEX8  ||
+                    e_type == libMesh::HEX27);
+            
+        case libMesh::SECOND:
+            return (e_type == libMesh::EDGE3 ||
+                    e_type == libMesh::QUAD9 ||
+                    e_type == libMesh::HEX27);
+            
+        default:
+            return false;
+    }
+}
+
+
+
+const MAST::TensorProductKernel*
+MAST::TensorProductKernel::get(const libMesh::FEType& fe_type,
+                               libMesh::ElemType e_type,
+                               const libMesh::QBase& qrule) {
+    
+    if (qrule.type() != libMesh::QGAUSS ||
+        !supported(fe_type, e_type))
+        return nullptr;
+    
+    std::vector<int> key(4);
+    key[0] = (int)fe_type.family;
+    key[1] = (int)fe_type.order;
+    key[2] = (int)e_type;
+    key[3] = (int)qrule.get_order();
+    
+    std::lock_guard<std::mutex>
+    lock(_tensor_product_kernel_cache.mutex);
+    
+    std::map<std::vector<int>, MAST::TensorProductKernel*>::iterator
+    it = _tensor_product_kernel_cache.kernels.find(key);
+    
+    if (it != _tensor_product_kernel_cache.kernels.end())
+        return it->second;
+    
+    MAST::TensorProductKernel*
+    k = new MAST::TensorProductKernel(fe_type, e_type, qrule.get_order());
+    
+    // the kernel is only used if its quadrature points are those of
+    // the rule used by the elements, in the same order
+    const std::vector<libMesh::Point>&
+    pts = qrule.get_points();
+    
+    bool
+    matches = (pts.size() == k->n_qp());
+    
+    for (unsigned int q=0; matches && q<pts.size(); q++)
+        matches = ((pts[q] - k->_qpoints[q]).norm() < 1.e-12);
+    
+    if (!matches) {
+        
+        delete k;
+        k = nullptr;
+    }
+    
+    _tensor_product_kernel_cache.kernels[key] = k;
+    
+    return k;
+}
+
+
+
+void
+MAST::TensorProductKernel::interpolate(const RealVectorX& u,
+                                       const unsigned int n_vars,
+                                       RealMatrixX& u_qp,
+                                       std::vector<RealMatrixX>* du_qp) const {
+    
+    const unsigned int
+    nn = n_nodes(),
+    nq = n_qp();
+    
+    libmesh_assert_equal_to(u.size(), n_vars*nn);
+    
+    u_qp.setZero(n_vars, nq);
+    if (du_qp) {
+        du_qp->resize(_dim);
+        for (unsigned int k=0; k<_dim; k++)
+            (*du_qp)[k].setZero(n_vars, nq);
+    }
+    
+    // the intermediate tensors are at most n_qp in size
+    std::vector<Real>
+    u_t (nn, 0.),
+    w1  (std::max(nn, nq), 0.),
+    w2  (std::max(nn, nq), 0.);
+    
+    unsigned int
+    n_in[3], n_out[3];
+    
+    for (unsigned int i_var=0; i_var<n_vars; i_var++) {
+        
+        // nodal values in the tensor-product numbering
+        for (unsigned int a=0; a<nn; a++)
+            u_t[a] = u(i_var*nn + _node_map[a]);
+        
+        // the value uses the polynomials in all directions, and the
+        // derivative along k uses the derivatives in direction k
+        for (unsigned int k=0; k<=_dim; k++) {
+            
+            if (k > 0 && !du_qp)
+                break;
+            
+            n_in[0] = _n1;
+            n_in[1] = _dim > 1 ? _n1 : 1;
+            n_in[2] = _dim > 2 ? _n1 : 1;
+            
+            const Real* in = &u_t[0];
+            Real
+            *out   = &w1[0],
+            *other = &w2[0];
+            
+            for (unsigned int d=0; d<_dim; d++) {
+                
+                _contract((k == d+1) ? _D : _B, false, d, n_in, in, n_out, out);
+                
+                for (unsigned int i=0; i<3; i++) n_in[i] = n_out[i];
+                in = out;
+                std::swap(out, other);
+            }
+            
+            if (k == 0)
+                for (unsigned int q=0; q<nq; q++) u_qp(i_var, q) = in[q];
+            else
+                for (unsigned int q=0; q<nq; q++) (*du_qp)[k-1](i_var, q) = in[q];
+        }
+    }
+}
+
+
+
+void
+MAST::TensorProductKernel::integrate(const RealMatrixX* v_qp,
+                                     const std::vector<RealMatrixX>* w_qp,
+                                     RealVectorX& f) const {
+    
+    const unsigned int
+    nn = n_nodes(),
+    nq = n_qp(),
+    n_vars = v_qp ? (unsigned int)v_qp->rows() :
+    (w_qp ? (unsigned int)(*w_qp)[0].rows() : 0);
+    
+    if (!n_vars)
+        return;
+    
+    libmesh_assert_equal_to(f.size(), n_vars*nn);
+    libmesh_assert(!w_qp || w_qp->size() == _dim);
+    
+    std::vector<Real>
+    f_t (nn, 0.),
+    w1  (std::max(nn, nq), 0.),
+    w2  (std::max(nn, nq), 0.);
+    
+    unsigned int
+    n_in[3], n_out[3];
+    
+    for (unsigned int i_var=0; i_var<n_vars; i_var++) {
+        
+        std::fill(f_t.begin(), f_t.end(), 0.);
+        
+        for (unsigned int k=0; k<=_dim; k++) {
+            
+            if ((k == 0 && !v_qp) || (k > 0 && !w_qp))
+                continue;
+            
+            const RealMatrixX&
+            v = (k == 0) ? *v_qp : (*w_qp)[k-1];
+            
+            for (unsigned int q=0; q<nq; q++)
+                w1[q] = v(i_var, q);
+            
+            n_in[0] = _nq1;
+            n_in[1] = _dim > 1 ? _nq1 : 1;
+            n_in[2] = _dim > 2 ? _nq1 : 1;
+            
+            const Real* in = &w1[0];
+            Real
+            *out   = &w2[0],
+            *other = &w1[0];
+            
+            for (unsigned int d=0; d<_dim; d++) {
+                
+                _contract((k == d+1) ? _D : _B, true, d, n_in, in, n_out, out);
+                
+                for (unsigned int i=0; i<3; i++) n_in[i] = n_out[i];
+                in = out;
+                std::swap(out, other);
+            }
+            
+            for (unsigned int a=0; a<nn; a++)
+                f_t[a] += in[a];
+        }
+        
+        for (unsigned int a=0; a<nn; a++)
+            f(i_var*nn + _node_map[a]) += f_t[a];
+    }
+}
+
+
+
+void
+MAST::TensorProductKernel::_contract(const RealMatrixX& M,
+                                     bool transpose,
+                                     const unsigned int d,
+                                     const unsigned int* n_in,
+                                     const Real* in,
+                                     unsigned int* n_out,
+                                     Real* out) const {
+    
+    libmesh_assert_equal_to(n_in[d], transpose ? M.rows() : M.cols());
+    
+    for (unsigned int i=0; i<3; i++) n_out[i] = n_in[i];
+    n_out[d] = transpose ? (unsigned int)M.cols() : (unsigned int)M.rows();
+    
+    const unsigned int
+    s_in [3] = {1, n_in[0],  n_in[0]*n_in[1]},
+    s_out[3] = {1, n_out[0], n_out[0]*n_out[1]},
+    n_sum    = n_in[d];
+    
+    unsigned int i[3];
+    
+    for (i[2]=0; i[2]<n_out[2]; i[2]++)
+        for (i[1]=0; i[1]<n_out[1]; i[1]++)
+            for (i[0]=0; i[0]<n_out[0]; i[0]++) {
+                
+                // offset of the input entry with zero index along d
+                unsigned int
+                base = 0;
+                for (unsigned int l=0; l<3; l++)
+                    if (l != d) base += i[l]*s_in[l];
+                
+                Real
+                v = 0.;
+                
+                if (transpose)
+                    for (unsigned int a=0; a<n_sum; a++)
+                        v += M(a, i[d]) * in[base + a*s_in[d]];
+                else
+                    for (unsigned int a=0; a<n_sum; a++)
+                        v += M(i[d], a) * in[base + a*s_in[d]];
+                
+                out[i[0]*s_out[0] + i[1]*s_out[1] + i[2]*s_out[2]] = v;
+            }
+}
+
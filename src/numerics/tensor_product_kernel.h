@@ -0,0 +1,207 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2017  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+#ifndef __mast__tensor_product_kernel__
+#define __mast__tensor_product_kernel__
+
+// C++ includes
+#include <vector>
+
+
+// MAST includes
+#include "base/mast_data_types.h"
+
+
+// libMesh includes
+#include "libmesh/fe_type.h"
+#include "libmesh/enum_elem_type.h"
+#include "libmesh/point.h"
+
+
+namespace libMesh {
+    
+    // Forward declerations
+    class QBase;
+}
+
+
+namespace MAST {
+    
+    /*!
+     *   Sum-factorized interpolation and integration for Lagrange
+     *   elements of tensor-product type (EDGE2/EDGE3, QUAD4/QUAD9 and
+     *   HEX8/HEX27) with a tensor-product Gauss quadrature rule. The
+     *   shape functions are products of the 1D Lagrange polynomials
+     *   \f$ N_a(\xi) \f$, so that the interpolation of the nodal values
+     *   to the quadrature points is a sequence of contractions of the 1D
+     *   tables with the nodal tensor, one direction at a time. With
+     *   \f$ n \f$ nodes and \f$ q \f$ quadrature points in each
+     *   direction, this requires \f$ O(d\, n^{d} q) \f$ operations for
+     *   \f$ d \f$ dimensions instead of the \f$ O(n^d q^d) \f$ of the
+     *   product with the full shape function table. The transpose of
+     *   these operations, with the derivatives of the 1D polynomials
+     *   for the derivative directions, integrates the quadrature point
+     *   values against the shape functions or their derivatives.
+     *
+     *   All derivatives are with respect to the reference coordinates
+     *   \f$ \xi_k \f$. The quadrature points are numbered with the first
+     *   direction fastest, which is the numbering of the libMesh Gauss
+     *   rules for these elements. The nodal values are numbered by the
+     *   libMesh node numbering, with the values of all nodes for one
+     *   variable stored together, as in the element solution vectors.
+     */
+    class TensorProductKernel {
+        
+    public:
+        
+        /*!
+         *   initializes the kernel for elements of type \p e_type with
+         *   shape functions \p fe_type and the 1D Gauss quadrature of
+         *   order \p q_order in each direction.
+         */
+        TensorProductKernel(const libMesh::FEType& fe_type,
+                            libMesh::ElemType e_type,
+                            libMesh::Order q_order);
+        
+        
+        virtual ~TensorProductKernel();
+        
+        
+        /*!
+         *   @returns \p true if the kernel can be used for elements of
+         *   type \p e_type with shape functions \p fe_type
+         */
+        static bool supported(const libMesh::FEType& fe_type,
+                              libMesh::ElemType e_type);
+        
+        
+        /*!
+         *   @returns the kernel for elements of type \p e_type with shape
+         *   functions \p fe_type and the quadrature rule \p qrule, or
+         *   \p nullptr if the combination is not supported. The kernels
+         *   are created on the first request and shared by all elements.
+         *   This is thread-safe.
+         */
+        static const MAST::TensorProductKernel*
+        get(const libMesh::FEType& fe_type,
+            libMesh::ElemType e_type,
+            const libMesh::QBase& qrule);
+        
+        
+        /*!
+         *   @returns the dimension of the element
+         */
+        unsigned int dim() const { return _dim; }
+        
+        
+        /*!
+         *   @returns the number of nodes of the element
+         */
+        unsigned int n_nodes() const { return (unsigned int)_node_map.size(); }
+        
+        
+        /*!
+         *   @returns the number of quadrature points of the element
+         */
+        unsigned int n_qp() const { return (unsigned int)_qpoints.size(); }
+        
+        
+        /*!
+         *   @returns the reference quadrature points in the order used
+         *   by this kernel
+         */
+        const std::vector<libMesh::Point>& qpoints() const { return _qpoints; }
+        
+        
+        /*!
+         *   interpolates the nodal values \p u of \p n_vars variables to
+         *   the quadrature points. \p u_qp is resized to
+         *   \p n_vars x \p n_qp() and stores the values. If \p du_qp is
+         *   provided, it is resized to \p dim() matrices of the same
+         *   size, which store the derivatives with respect to each
+         *   reference coordinate.
+         */
+        void interpolate(const RealVectorX& u,
+                         const unsigned int n_vars,
+                         RealMatrixX& u_qp,
+                         std::vector<RealMatrixX>* du_qp = nullptr) const;
+        
+        
+        /*!
+         *   adds to \p f the integral of the quadrature point values
+         *   against the shape functions and their reference derivatives,
+         *   \f$ f_{v,a} \mathrel{+}= \sum_q N_a(q) v(v, q) +
+         *   \sum_k \sum_q \partial N_a/\partial \xi_k(q) w_k(v, q) \f$.
+         *   The quadrature weights must be included in the values.
+         *   Either of \p v_qp and \p w_qp can be \p nullptr, and \p w_qp
+         *   has one \p n_vars x \p n_qp() matrix for each dimension.
+         */
+        void integrate(const RealMatrixX* v_qp,
+                       const std::vector<RealMatrixX>* w_qp,
+                       RealVectorX& f) const;
+        
+    protected:
+        
+        /*!
+         *   contracts \p M, or its transpose if \p transpose is \p true,
+         *   with the tensor \p in of dimensions \p n_in along direction
+         *   \p d. The result is written to \p out, and its dimensions to
+         *   \p n_out.
+         */
+        void _contract(const RealMatrixX& M,
+                       bool transpose,
+                       const unsigned int d,
+                       const unsigned int* n_in,
+                       const Real* in,
+                       unsigned int* n_out,
+                       Real* out) const;
+        
+        
+        /*!
+         *   dimension of the element
+         */
+        unsigned int                 _dim;
+        
+        /*!
+         *   number of nodes and of quadrature points in each direction
+         */
+        unsigned int                 _n1, _nq1;
+        
+        /*!
+         *   values and derivatives of the 1D Lagrange polynomials at the
+         *   1D quadrature points, \p _nq1 x \p _n1
+         */
+        RealMatrixX                  _B, _D;
+        
+        /*!
+         *   libMesh node number of each node of the tensor-product
+         *   numbering, in which the first direction is the fastest
+         */
+        std::vector<unsigned int>    _node_map;
+        
+        /*!
+         *   reference quadrature points
+         */
+        std::vector<libMesh::Point>  _qpoints;
+    };
+}
+
+
+#endif // __mast__tensor_product_kernel__
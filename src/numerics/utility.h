@@ -163,14 +163,23 @@ namespace MAST {
     
     
     
+    /*!
+     *   copies the Eigen matrix \p m2 to the libMesh dense matrix \p m1.
+     *   The storage of \p m1 is reused if it already has the required
+     *   dimensions, and the values are copied in a single pass
+     *   through an Eigen::Map view of the row-major libMesh storage.
+     */
     inline void
     copy (DenseRealMatrix& m1, const RealMatrixX& m2) {
         
         const unsigned int m=(unsigned int)m2.rows(), n=(unsigned int)m2.cols();
-        m1.resize(m, n);
-        for (unsigned int i=0; i<m; i++)
-            for (unsigned int j=0; j<n; j++)
-                m1(i,j) = m2(i,j);
+        
+        if (m1.m() != m || m1.n() != n)
+            m1.resize(m, n);
+        
+        if (m*n)
+            Map<Matrix<Real, Dynamic, Dynamic, RowMajor> >
+            (&m1.get_values()[0], m, n) = m2;
     }
 
     
@@ -179,21 +188,31 @@ namespace MAST {
     copy (RealMatrixX& m2, const DenseRealMatrix& m1) {
         
         const unsigned int m=(unsigned int)m1.m(), n=(unsigned int)m1.n();
-        m2.setZero(m, n);
-        for (unsigned int i=0; i<m; i++)
-            for (unsigned int j=0; j<n; j++)
-                m2(i,j) = m1(i,j);
+        
+        if (m*n)
+            m2 = Map<const Matrix<Real, Dynamic, Dynamic, RowMajor> >
+            (&m1.get_values()[0], m, n);
+        else
+            m2.setZero(m, n);
     }
 
     
     
+    /*!
+     *   copies the Eigen vector \p v2 to the libMesh dense vector \p v1.
+     *   The storage of \p v1 is reused if it already has the required
+     *   dimension.
+     */
     inline void
     copy (DenseRealVector& v1, const RealVectorX& v2) {
         
         const unsigned int m=(unsigned int)v2.rows();
-        v1.resize(m);
-        for (unsigned int i=0; i<m; i++)
-            v1(i) = v2(i);
+        
+        if (v1.size() != m)
+            v1.resize(m);
+        
+        if (m)
+            Map<RealVectorX>(&v1.get_values()[0], m) = v2;
     }
 
     
@@ -202,10 +221,10 @@ namespace MAST {
         
         const unsigned int m=(unsigned int)v2.size();
         
-        v1 = RealVectorX::Zero(m);
-        
-        for (unsigned int i=0; i<m; i++)
-            v1(i) = v2(i);
+        if (m)
+            v1 = Map<const RealVectorX>(&v2.get_values()[0], m);
+        else
+            v1 = RealVectorX::Zero(m);
     }
 
 
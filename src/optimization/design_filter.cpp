@@ -0,0 +1,381 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2017  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+// C++ includes
+#include <algorithm>
+
+
+// MAST includes
+#include "optimization/design_filter.h"
+#include "numerics/point_tree.h"
+#include "base/performance_log.h"
+
+
+// libMesh includes
+#include "libmesh/elem.h"
+#include "libmesh/mesh_base.h"
+#include "libmesh/petsc_vector.h"
+#include "libmesh/parallel.h"
+
+
+MAST::DesignFilter::DesignFilter(libMesh::System& sys,
+                                 unsigned int var,
+                                 Real radius):
+libMesh::ParallelObject(sys.comm()),
+_sys(sys),
+_var(var),
+_radius(radius),
+_n_local_nonzeros(0),
+_H(PETSC_NULL) {
+    
+    libmesh_assert_greater(radius, 0.);
+}
+
+
+
+MAST::DesignFilter::~DesignFilter() {
+    
+    this->clear();
+}
+
+
+
+void
+MAST::DesignFilter::clear() {
+    
+    if (_H) {
+        
+        PetscErrorCode ierr = MatDestroy(&_H);
+        CHKERRABORT(this->comm().get(), ierr);
+        _H = PETSC_NULL;
+    }
+    
+    _n_local_nonzeros = 0;
+}
+
+
+
+void
+MAST::DesignFilter::set_radius(Real r) {
+    
+    libmesh_assert_greater(r, 0.);
+    
+    _radius = r;
+    this->clear();
+}
+
+
+
+void
+MAST::DesignFilter::init() {
+    
+    MAST_LOG_SCOPE("init()", "DesignFilter");
+    
+    this->clear();
+    
+    const libMesh::MeshBase& mesh = _sys.get_mesh();
+    
+    // centroid, dof index and volume of the local elements
+    std::vector<Real> local_data, remote_data;
+    
+    libMesh::MeshBase::const_element_iterator       el     =
+    mesh.active_local_elements_begin();
+    const libMesh::MeshBase::const_element_iterator end_el =
+    mesh.active_local_elements_end();
+    
+    for ( ; el != end_el; ++el) {
+        
+        const libMesh::Elem* elem = *el;
+        const libMesh::Point c = elem->centroid();
+        
+        local_data.push_back(c(0));
+        local_data.push_back(c(1));
+        local_data.push_back(c(2));
+        local_data.push_back(elem->dof_number(_sys.number(), _var, 0));
+        local_data.push_back(elem->volume());
+    }
+    
+    _get_remote_elem_data(local_data, remote_data);
+    
+    const unsigned int
+    n_local = (unsigned int)local_data.size()/5,
+    n_all   = n_local + (unsigned int)remote_data.size()/5;
+    
+    std::vector<libMesh::Point>       pts(n_all);
+    std::vector<PetscInt>             dofs(n_all);
+    std::vector<Real>                 vols(n_all);
+    
+    for (unsigned int i=0; i<n_all; i++) {
+        
+        const Real* d = (i < n_local)? &local_data[5*i] : &remote_data[5*(i-n_local)];
+        
+        pts[i]  = libMesh::Point(d[0], d[1], d[2]);
+        dofs[i] = (PetscInt)d[3];
+        vols[i] = d[4];
+    }
+    
+    const unsigned int
+    dim = std::max(1u, (unsigned int)mesh.spatial_dimension());
+    
+    MAST::PointTree tree(pts, dim);
+    
+    // the weights of the rows of the local elements
+    const PetscInt
+    first = (PetscInt)_sys.solution->first_local_index(),
+    last  = (PetscInt)_sys.solution->last_local_index(),
+    m_l   = last - first,
+    m     = (PetscInt)_sys.solution->size();
+    
+    std::vector<PetscInt>
+    d_nnz(m_l, 0),
+    o_nnz(m_l, 0),
+    row_begin(n_local+1, 0),
+    cols;
+    
+    std::vector<Real>              vals;
+    std::vector<unsigned int>      ids;
+    
+    for (unsigned int i=0; i<n_local; i++) {
+        
+        tree.find(pts[i], _radius, ids);
+        
+        Real sum = 0.;
+        const unsigned int n0 = (unsigned int)cols.size();
+        
+        for (unsigned int k=0; k<ids.size(); k++) {
+            
+            const unsigned int j = ids[k];
+            const Real w = vols[j] * (_radius - (pts[j] - pts[i]).norm());
+            
+            if (w <= 0.)
+                continue;
+            
+            cols.push_back(dofs[j]);
+            vals.push_back(w);
+            sum += w;
+            
+            if (dofs[j] >= first && dofs[j] < last)
+                d_nnz[dofs[i]-first]++;
+            else
+                o_nnz[dofs[i]-first]++;
+        }
+        
+        for (unsigned int k=n0; k<cols.size(); k++)
+            vals[k] /= sum;
+        
+        row_begin[i+1] = (PetscInt)cols.size();
+    }
+    
+    PetscErrorCode ierr = 0;
+    
+    ierr = MatCreateAIJ(this->comm().get(),
+                        m_l, m_l, m, m,
+                        0, m_l? &d_nnz[0] : PETSC_NULL,
+                        0, m_l? &o_nnz[0] : PETSC_NULL,
+                        &_H);
+    CHKERRABORT(this->comm().get(), ierr);
+    
+    for (unsigned int i=0; i<n_local; i++) {
+        
+        const PetscInt
+        n = row_begin[i+1] - row_begin[i];
+        
+        if (!n)
+            continue;
+        
+        ierr = MatSetValues(_H,
+                            1, &dofs[i],
+                            n, &cols[row_begin[i]],
+                            &vals[row_begin[i]],
+                            INSERT_VALUES);
+        CHKERRABORT(this->comm().get(), ierr);
+    }
+    
+    ierr = MatAssemblyBegin(_H, MAT_FINAL_ASSEMBLY); CHKERRABORT(this->comm().get(), ierr);
+    ierr = MatAssemblyEnd  (_H, MAT_FINAL_ASSEMBLY); CHKERRABORT(this->comm().get(), ierr);
+    
+    _n_local_nonzeros = (unsigned int)cols.size();
+}
+
+
+
+void
+MAST::DesignFilter::filter(const libMesh::NumericVector<Real>& x,
+                           libMesh::NumericVector<Real>& y) const {
+    
+    libmesh_assert_msg(_H, "DesignFilter::init() must be called before use.");
+    
+    MAST_LOG_SCOPE("filter()", "DesignFilter");
+    
+    libMesh::PetscVector<Real>
+    &x_p = const_cast<libMesh::PetscVector<Real>&>
+    (dynamic_cast<const libMesh::PetscVector<Real>&>(x)),
+    &y_p = dynamic_cast<libMesh::PetscVector<Real>&>(y);
+    
+    PetscErrorCode ierr = MatMult(_H, x_p.vec(), y_p.vec());
+    CHKERRABORT(this->comm().get(), ierr);
+    
+    y.close();
+}
+
+
+
+void
+MAST::DesignFilter::filter_gradient(const libMesh::NumericVector<Real>& dy,
+                                    libMesh::NumericVector<Real>& dx) const {
+    
+    libmesh_assert_msg(_H, "DesignFilter::init() must be called before use.");
+    
+    MAST_LOG_SCOPE("filter_gradient()", "DesignFilter");
+    
+    libMesh::PetscVector<Real>
+    &dy_p = const_cast<libMesh::PetscVector<Real>&>
+    (dynamic_cast<const libMesh::PetscVector<Real>&>(dy)),
+    &dx_p = dynamic_cast<libMesh::PetscVector<Real>&>(dx);
+    
+    PetscErrorCode ierr = MatMultTranspose(_H, dy_p.vec(), dx_p.vec());
+    CHKERRABORT(this->comm().get(), ierr);
+    
+    dx.close();
+}
+
+
+
+void
+MAST::DesignFilter::filter_sensitivity(const libMesh::NumericVector<Real>& x,
+                                       const libMesh::NumericVector<Real>& g,
+                                       libMesh::NumericVector<Real>& g_filtered,
+                                       Real x_min) const {
+    
+    libmesh_assert_greater(x_min, 0.);
+    
+    // x o g
+    std::auto_ptr<libMesh::NumericVector<Real> >
+    xg(x.clone().release());
+    xg->pointwise_mult(x, g);
+    xg->close();
+    
+    this->filter(*xg, g_filtered);
+    
+    const libMesh::numeric_index_type
+    first = g_filtered.first_local_index(),
+    last  = g_filtered.last_local_index();
+    
+    for (libMesh::numeric_index_type i=first; i<last; i++)
+        g_filtered.set(i, g_filtered(i)/std::max(x_min, x(i)));
+    
+    g_filtered.close();
+}
+
+
+
+void
+MAST::DesignFilter::_get_remote_elem_data(const std::vector<Real>& local_data,
+                                          std::vector<Real>& data) const {
+    
+    data.clear();
+    
+    if (this->comm().size() == 1)
+        return;
+    
+    MAST_LOG_SCOPE("get_remote_elem_data()", "DesignFilter");
+    
+    const unsigned int
+    n_local = (unsigned int)local_data.size()/5,
+    n_procs = this->comm().size(),
+    rank    = this->comm().rank();
+    
+    // bounding box of the local centroids, expanded by the radius. An
+    // empty box is used for processors without elements.
+    std::vector<Real> boxes(6, 0.);
+    
+    if (n_local) {
+        
+        for (unsigned int k=0; k<3; k++) {
+            
+            boxes[k]   = local_data[k];
+            boxes[k+3] = local_data[k];
+        }
+        
+        for (unsigned int i=1; i<n_local; i++)
+            for (unsigned int k=0; k<3; k++) {
+                
+                boxes[k]   = std::min(boxes[k],   local_data[5*i+k]);
+                boxes[k+3] = std::max(boxes[k+3], local_data[5*i+k]);
+            }
+        
+        for (unsigned int k=0; k<3; k++) {
+            
+            boxes[k]   -= _radius;
+            boxes[k+3] += _radius;
+        }
+    }
+    else {
+        
+        for (unsigned int k=0; k<3; k++) {
+            
+            boxes[k]   =  1.;
+            boxes[k+3] = -1.;
+        }
+    }
+    
+    this->comm().allgather(boxes, true);
+    
+    // local elements that lie in the box of another processor, along with
+    // the rank of this processor
+    std::vector<Real> send;
+    
+    for (unsigned int i=0; i<n_local; i++) {
+        
+        const Real* d = &local_data[5*i];
+        
+        for (unsigned int p=0; p<n_procs; p++) {
+            
+            if (p == rank)
+                continue;
+            
+            const Real* b = &boxes[6*p];
+            
+            if (d[0] >= b[0] && d[0] <= b[3] &&
+                d[1] >= b[1] && d[1] <= b[4] &&
+                d[2] >= b[2] && d[2] <= b[5]) {
+                
+                send.insert(send.end(), d, d+5);
+                send.push_back(rank);
+                break;
+            }
+        }
+    }
+    
+    this->comm().allgather(send, false);
+    
+    // keep the elements of other processors that lie in the local box
+    const Real* b = &boxes[6*rank];
+    
+    for (unsigned int i=0; i<send.size()/6; i++) {
+        
+        const Real* d = &send[6*i];
+        
+        if ((unsigned int)d[5] != rank &&
+            d[0] >= b[0] && d[0] <= b[3] &&
+            d[1] >= b[1] && d[1] <= b[4] &&
+            d[2] >= b[2] && d[2] <= b[5])
+            data.insert(data.end(), d, d+5);
+    }
+}
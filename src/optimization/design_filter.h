@@ -0,0 +1,173 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2017  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef __mast__design_filter__
+#define __mast__design_filter__
+
+// MAST includes
+#include "base/mast_data_types.h"
+
+
+// libMesh includes
+#include "libmesh/parallel_object.h"
+#include "libmesh/system.h"
+#include "libmesh/numeric_vector.h"
+
+
+// PETSc includes
+#include <petscmat.h>
+
+
+namespace MAST {
+    
+    /*!
+     *    Filter of element-wise design values with radius \f$ r \f$, for
+     *    density and sensitivity filtering in topology optimization. The
+     *    design values are the element-constant dofs of variable \p var in
+     *    \p sys, as used by MAST::ElementwiseDesignField. The filtered
+     *    value of element \f$ i \f$ is
+     *    \f$ \tilde{\rho}_i = \sum_j H_{ij} \rho_j \f$, with the weights
+     *    \f$ H_{ij} \propto v_j \max(0, r - |x_i - x_j|) \f$ normalized so
+     *    that each row sums to one, where \f$ x_j \f$ and \f$ v_j \f$ are
+     *    the centroid and volume of element \f$ j \f$.
+     *
+     *    The neighbors are found once in init(), with a k-d tree over the
+     *    centroids of the local elements and of the elements of other
+     *    processors that lie within \f$ r \f$ of the local elements. The
+     *    centroids of the elements near the partition boundaries are
+     *    exchanged with a single allgather. The weights are stored in a
+     *    distributed sparse matrix with the row and column layout of the
+     *    design vector, so that filtering the design values and the chain
+     *    rule for the gradients are one matrix-vector product each.
+     */
+    class DesignFilter:
+    public libMesh::ParallelObject {
+        
+    public:
+        
+        DesignFilter(libMesh::System& sys,
+                     unsigned int var,
+                     Real radius);
+        
+        virtual ~DesignFilter();
+        
+        
+        /*!
+         *   builds the weight matrix. This must be called on all
+         *   processors before the filter is used, and again if the mesh
+         *   or the radius is changed.
+         */
+        void init();
+        
+        
+        /*!
+         *   clears the weight matrix
+         */
+        void clear();
+        
+        
+        /*!
+         *   sets the filter radius. init() must be called after this.
+         */
+        void set_radius(Real r);
+        
+        
+        /*!
+         *   @returns the filter radius
+         */
+        Real radius() const {
+            return _radius;
+        }
+        
+        
+        /*!
+         *   @returns the number of nonzero weights on this processor
+         */
+        unsigned int n_local_nonzeros() const {
+            return _n_local_nonzeros;
+        }
+        
+        
+        /*!
+         *   computes the filtered design values \f$ y = [H] x \f$
+         */
+        void filter(const libMesh::NumericVector<Real>& x,
+                    libMesh::NumericVector<Real>& y) const;
+        
+        
+        /*!
+         *   computes the gradient with respect to the design values from
+         *   the gradient with respect to the filtered values,
+         *   \f$ dx = [H]^T dy \f$. This is the chain rule for density
+         *   filtering.
+         */
+        void filter_gradient(const libMesh::NumericVector<Real>& dy,
+                             libMesh::NumericVector<Real>& dx) const;
+        
+        
+        /*!
+         *   computes the filtered sensitivity
+         *   \f$ \tilde{g}_i = ([H] \{x \circ g\})_i / \max(x_{min}, x_i) \f$
+         *   of the heuristic sensitivity filter from the design values
+         *   \p x and the gradient \p g.
+         */
+        void filter_sensitivity(const libMesh::NumericVector<Real>& x,
+                                const libMesh::NumericVector<Real>& g,
+                                libMesh::NumericVector<Real>& g_filtered,
+                                Real x_min = 1.e-3) const;
+        
+    protected:
+        
+        /*!
+         *   sets \p data to the elements of other processors that lie
+         *   within the filter radius of the bounding box of the local
+         *   elements. Both \p local_data and \p data store five Reals per
+         *   element: the centroid coordinates, the dof index and the
+         *   volume.
+         */
+        void _get_remote_elem_data(const std::vector<Real>& local_data,
+                                   std::vector<Real>& data) const;
+        
+        
+        /*!
+         *   system and variable of the design values
+         */
+        libMesh::System&              _sys;
+        
+        const unsigned int            _var;
+        
+        /*!
+         *   filter radius
+         */
+        Real                          _radius;
+        
+        /*!
+         *   number of nonzero weights on this processor
+         */
+        unsigned int                  _n_local_nonzeros;
+        
+        /*!
+         *   weight matrix, which is null until init() is called
+         */
+        Mat                           _H;
+    };
+}
+
+
+#endif // __mast__design_filter__
@@ -0,0 +1,294 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2017  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+// C++ includes
+#include <algorithm>
+
+// MAST includes
+#include "optimization/design_iteration_state.h"
+#include "solver/slepc_eigen_solver.h"
+#include "aeroelasticity/flutter_root_base.h"
+
+
+MAST::DesignIterationState::DesignIterationState():
+_solution(nullptr),
+_if_flutter_root(false),
+_flutter_V(0.),
+_flutter_omega(0.),
+_flutter_kr(0.),
+_flutter_g(0.) {
+    
+}
+
+
+
+MAST::DesignIterationState::~DesignIterationState() {
+    
+    this->clear();
+}
+
+
+
+void
+MAST::DesignIterationState::clear() {
+    
+    _dvars.clear();
+    
+    if (_solution) {
+        delete _solution;
+        _solution = nullptr;
+    }
+    
+    for (unsigned int i=0; i<_eig_vecs.size(); i++)
+        delete _eig_vecs[i];
+    _eig_vecs.clear();
+    _eig_vals.clear();
+    
+    _if_flutter_root = false;
+    
+    std::map<unsigned int, libMesh::NumericVector<Real>*>::iterator
+    it  = _adjoint.begin(),
+    end = _adjoint.end();
+    
+    for ( ; it != end; it++)
+        delete it->second;
+    _adjoint.clear();
+}
+
+
+
+bool
+MAST::DesignIterationState::if_warm_start(const std::vector<Real>& dvars,
+                                          Real tol) const {
+    
+    if (_dvars.size() != dvars.size() ||
+        !_dvars.size())
+        return false;
+    
+    for (unsigned int i=0; i<_dvars.size(); i++)
+        if (fabs(dvars[i]-_dvars[i]) > tol * std::max(1., fabs(_dvars[i])))
+            return false;
+    
+    return true;
+}
+
+
+
+void
+MAST::DesignIterationState::store_solution(const libMesh::NumericVector<Real>& sol) {
+    
+    this->_copy(sol, _solution);
+}
+
+
+
+bool
+MAST::DesignIterationState::restore_solution(libMesh::NumericVector<Real>& sol) const {
+    
+    if (!_solution ||
+        _solution->size()       != sol.size() ||
+        _solution->local_size() != sol.local_size())
+        return false;
+    
+    sol = *_solution;
+    sol.close();
+    
+    return true;
+}
+
+
+
+void
+MAST::DesignIterationState::
+store_eigenpairs(const std::vector<libMesh::NumericVector<Real>*>& vecs,
+                 const std::vector<Real>& vals) {
+    
+    libmesh_assert_equal_to(vecs.size(), vals.size());
+    
+    for (unsigned int i=(unsigned int)vecs.size(); i<_eig_vecs.size(); i++)
+        delete _eig_vecs[i];
+    _eig_vecs.resize(vecs.size(), nullptr);
+    
+    for (unsigned int i=0; i<vecs.size(); i++)
+        this->_copy(*vecs[i], _eig_vecs[i]);
+    
+    _eig_vals = vals;
+}
+
+
+
+const libMesh::NumericVector<Real>&
+MAST::DesignIterationState::eigenvector(unsigned int i) const {
+    
+    libmesh_assert_less(i, _eig_vecs.size());
+    
+    return *_eig_vecs[i];
+}
+
+
+
+Real
+MAST::DesignIterationState::eigenvalue(unsigned int i) const {
+    
+    libmesh_assert_less(i, _eig_vals.size());
+    
+    return _eig_vals[i];
+}
+
+
+
+void
+MAST::DesignIterationState::init_eigen_solver(MAST::SlepcEigenSolver& solver) const {
+    
+    if (_eig_vecs.size())
+        solver.set_initial_space(_eig_vecs);
+}
+
+
+
+void
+MAST::DesignIterationState::store_flutter_root(const MAST::FlutterRootBase& root) {
+    
+    _if_flutter_root = true;
+    _flutter_V       = root.V;
+    _flutter_omega   = root.omega;
+    _flutter_kr      = root.kr;
+    _flutter_g       = root.g;
+}
+
+
+
+Real
+MAST::DesignIterationState::flutter_velocity() const {
+    
+    libmesh_assert(_if_flutter_root);
+    
+    return _flutter_V;
+}
+
+
+
+Real
+MAST::DesignIterationState::flutter_omega() const {
+    
+    libmesh_assert(_if_flutter_root);
+    
+    return _flutter_omega;
+}
+
+
+
+Real
+MAST::DesignIterationState::flutter_kr() const {
+    
+    libmesh_assert(_if_flutter_root);
+    
+    return _flutter_kr;
+}
+
+
+
+Real
+MAST::DesignIterationState::flutter_g() const {
+    
+    libmesh_assert(_if_flutter_root);
+    
+    return _flutter_g;
+}
+
+
+
+std::pair<Real, Real>
+MAST::DesignIterationState::flutter_scan_range(Real V_lower,
+                                               Real V_upper,
+                                               Real f) const {
+    
+    libmesh_assert_less(V_lower, V_upper);
+    libmesh_assert_greater(f, 0.);
+    
+    if (!_if_flutter_root)
+        return std::pair<Real, Real>(V_lower, V_upper);
+    
+    std::pair<Real, Real>
+    range(std::max(V_lower, (1.-f) * _flutter_V),
+          std::min(V_upper, (1.+f) * _flutter_V));
+    
+    // the stored root is outside of the interval
+    if (range.first >= range.second)
+        return std::pair<Real, Real>(V_lower, V_upper);
+    
+    return range;
+}
+
+
+
+void
+MAST::DesignIterationState::
+store_adjoint_solution(unsigned int i,
+                       const libMesh::NumericVector<Real>& sol) {
+    
+    std::map<unsigned int, libMesh::NumericVector<Real>*>::iterator
+    it = _adjoint.insert(std::make_pair(i, (libMesh::NumericVector<Real>*)nullptr)).first;
+    
+    this->_copy(sol, it->second);
+}
+
+
+
+bool
+MAST::DesignIterationState::
+restore_adjoint_solution(unsigned int i,
+                         libMesh::NumericVector<Real>& sol) const {
+    
+    std::map<unsigned int, libMesh::NumericVector<Real>*>::const_iterator
+    it = _adjoint.find(i);
+    
+    if (it == _adjoint.end() ||
+        it->second->size()       != sol.size() ||
+        it->second->local_size() != sol.local_size())
+        return false;
+    
+    sol = *it->second;
+    sol.close();
+    
+    return true;
+}
+
+
+
+void
+MAST::DesignIterationState::_copy(const libMesh::NumericVector<Real>& v,
+                                  libMesh::NumericVector<Real>*& copy) const {
+    
+    if (copy &&
+        (copy->size()       != v.size() ||
+         copy->local_size() != v.local_size())) {
+        
+        delete copy;
+        copy = nullptr;
+    }
+    
+    if (!copy)
+        copy = v.clone().release();
+    else {
+        *copy = v;
+        copy->close();
+    }
+}
+
@@ -0,0 +1,244 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2017  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef __mast__design_iteration_state_h__
+#define __mast__design_iteration_state_h__
+
+// C++ includes
+#include <vector>
+#include <map>
+#include <utility>
+
+
+// MAST includes
+#include "base/mast_data_types.h"
+
+
+// libMesh includes
+#include "libmesh/numeric_vector.h"
+
+
+namespace MAST {
+    
+    // Forward declerations
+    class SlepcEigenSolver;
+    class FlutterRootBase;
+    
+    
+    /*!
+     *   Stores the solutions of the analyses of a design iteration, so
+     *   that the analyses of the next iteration can start from them
+     *   instead of zero initial guesses: the static solution, the
+     *   eigenvectors and eigenvalues of a modal analysis, the critical
+     *   flutter root, and the adjoint solutions. The design variables of
+     *   the stored iteration are used with if_warm_start() to decide if the
+     *   design step is small enough for a warm start. The vectors are
+     *   copied, and the stored vectors of the same size are reused in the
+     *   following iterations.
+     */
+    class DesignIterationState {
+        
+    public:
+        
+        DesignIterationState();
+        
+        virtual ~DesignIterationState();
+        
+        
+        /*!
+         *   deletes all stored data
+         */
+        void clear();
+        
+        
+        /*!
+         *   sets the design variables of the stored iteration
+         */
+        void set_design(const std::vector<Real>& dvars) {
+            _dvars = dvars;
+        }
+        
+        
+        /*!
+         *   @returns true if data was stored for a design and the change
+         *   of each design variable from that design is less than
+         *   \p tol * max(1, |x_i|)
+         */
+        bool if_warm_start(const std::vector<Real>& dvars,
+                           Real tol) const;
+        
+        
+        /*!
+         *   stores the static solution
+         */
+        void store_solution(const libMesh::NumericVector<Real>& sol);
+        
+        
+        /*!
+         *   copies the stored static solution to \p sol. @returns false
+         *   and leaves \p sol unchanged if no solution is stored.
+         */
+        bool restore_solution(libMesh::NumericVector<Real>& sol) const;
+        
+        
+        /*!
+         *   stores the eigenvectors and eigenvalues of a modal analysis
+         */
+        void store_eigenpairs(const std::vector<libMesh::NumericVector<Real>*>& vecs,
+                              const std::vector<Real>& vals);
+        
+        
+        /*!
+         *   @returns the number of stored eigenvectors
+         */
+        unsigned int n_eigenvectors() const {
+            return (unsigned int)_eig_vecs.size();
+        }
+        
+        
+        /*!
+         *   @returns the i^th stored eigenvector
+         */
+        const libMesh::NumericVector<Real>& eigenvector(unsigned int i) const;
+        
+        
+        /*!
+         *   @returns the i^th stored eigenvalue
+         */
+        Real eigenvalue(unsigned int i) const;
+        
+        
+        /*!
+         *   sets the stored eigenvectors as the initial space of the next
+         *   solve of \p solver. Nothing is done if no eigenvectors are
+         *   stored.
+         */
+        void init_eigen_solver(MAST::SlepcEigenSolver& solver) const;
+        
+        
+        /*!
+         *   stores the critical flutter root
+         */
+        void store_flutter_root(const MAST::FlutterRootBase& root);
+        
+        
+        /*!
+         *   removes the stored flutter root, for example if no root was
+         *   found in the iteration
+         */
+        void clear_flutter_root() {
+            _if_flutter_root = false;
+        }
+        
+        
+        /*!
+         *   @returns true if a flutter root is stored
+         */
+        bool if_flutter_root() const {
+            return _if_flutter_root;
+        }
+        
+        
+        /*!
+         *   @returns the velocity, frequency, reduced frequency and damping
+         *   of the stored flutter root
+         */
+        Real flutter_velocity() const;
+        
+        Real flutter_omega() const;
+        
+        Real flutter_kr() const;
+        
+        Real flutter_g() const;
+        
+        
+        /*!
+         *   @returns the interval from \p V_lower to \p V_upper reduced to
+         *   \f$ (1 \pm f) V_f \f$ around the stored flutter velocity
+         *   \f$ V_f \f$, or the full interval if no root is stored. If no
+         *   root is found in the reduced interval, the scan should be
+         *   repeated on the full interval.
+         */
+        std::pair<Real, Real>
+        flutter_scan_range(Real V_lower,
+                           Real V_upper,
+                           Real f) const;
+        
+        
+        /*!
+         *   stores the i^th adjoint solution
+         */
+        void store_adjoint_solution(unsigned int i,
+                                    const libMesh::NumericVector<Real>& sol);
+        
+        
+        /*!
+         *   copies the stored i^th adjoint solution to \p sol. @returns
+         *   false and leaves \p sol unchanged if no solution is stored.
+         */
+        bool restore_adjoint_solution(unsigned int i,
+                                      libMesh::NumericVector<Real>& sol) const;
+        
+    protected:
+        
+        /*!
+         *   copies \p v to \p copy, which is created if it is \p nullptr or
+         *   of a different size
+         */
+        void _copy(const libMesh::NumericVector<Real>& v,
+                   libMesh::NumericVector<Real>*& copy) const;
+        
+        /*!
+         *   design variables of the stored iteration
+         */
+        std::vector<Real>                                      _dvars;
+        
+        /*!
+         *   static solution
+         */
+        libMesh::NumericVector<Real>*                          _solution;
+        
+        /*!
+         *   eigenvectors and eigenvalues
+         */
+        std::vector<libMesh::NumericVector<Real>*>             _eig_vecs;
+        
+        std::vector<Real>                                      _eig_vals;
+        
+        /*!
+         *   critical flutter root
+         */
+        bool                                                   _if_flutter_root;
+        
+        Real                                                   _flutter_V;
+        
+        Real                                                   _flutter_omega;
+        
+        Real                                                   _flutter_kr;
+        
+        Real                                                   _flutter_g;
+        
+        /*!
+         *   adjoint solutions
+         */
+        std::map<unsigned int, libMesh::NumericVector<Real>*>  _adjoint;
+    };
+}
+
+#endif // __mast__design_iteration_state_h__
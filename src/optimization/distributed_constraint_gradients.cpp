@@ -0,0 +1,254 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2017  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+// C++ includes
+#include <algorithm>
+#include <cmath>
+
+// MAST includes
+#include "optimization/distributed_constraint_gradients.h"
+
+// libMesh includes
+#include "libmesh/parallel.h"
+
+
+namespace MAST {
+    
+    struct ConstraintEntryLess {
+        
+        bool operator() (const std::pair<unsigned int, Real>& a,
+                         unsigned int i) const {
+            return a.first < i;
+        }
+    };
+}
+
+
+
+MAST::DistributedConstraintGradients::
+DistributedConstraintGradients(const libMesh::NumericVector<Real>& x,
+                               unsigned int n_con):
+libMesh::ParallelObject(x.comm()),
+_n_con(n_con),
+_n_vars(x.size()),
+_first(x.first_local_index()),
+_last(x.last_local_index()),
+_entries(x.last_local_index()-x.first_local_index()) {
+    
+}
+
+
+
+MAST::DistributedConstraintGradients::~DistributedConstraintGradients() {
+    
+}
+
+
+
+void
+MAST::DistributedConstraintGradients::zero() {
+    
+    for (unsigned int j=0; j<_entries.size(); j++)
+        _entries[j].clear();
+}
+
+
+
+void
+MAST::DistributedConstraintGradients::zero_constraint(unsigned int i) {
+    
+    libmesh_assert_less(i, _n_con);
+    
+    for (unsigned int j=0; j<_entries.size(); j++) {
+        
+        std::vector<std::pair<unsigned int, Real> >::iterator
+        it = std::lower_bound(_entries[j].begin(),
+                              _entries[j].end(),
+                              i,
+                              MAST::ConstraintEntryLess());
+        
+        if (it != _entries[j].end() && it->first == i)
+            _entries[j].erase(it);
+    }
+}
+
+
+
+void
+MAST::DistributedConstraintGradients::set(libMesh::numeric_index_type j,
+                                          unsigned int i,
+                                          Real v) {
+    
+    this->_entry(j, i) = v;
+}
+
+
+
+void
+MAST::DistributedConstraintGradients::add(libMesh::numeric_index_type j,
+                                          unsigned int i,
+                                          Real v) {
+    
+    this->_entry(j, i) += v;
+}
+
+
+
+Real
+MAST::DistributedConstraintGradients::operator() (libMesh::numeric_index_type j,
+                                                  unsigned int i) const {
+    
+    const std::vector<std::pair<unsigned int, Real> >&
+    row = this->var_entries(j);
+    
+    std::vector<std::pair<unsigned int, Real> >::const_iterator
+    it = std::lower_bound(row.begin(), row.end(), i, MAST::ConstraintEntryLess());
+    
+    if (it != row.end() && it->first == i)
+        return it->second;
+    
+    return 0.;
+}
+
+
+
+unsigned long long
+MAST::DistributedConstraintGradients::n_nonzeros() const {
+    
+    unsigned long long n = 0;
+    
+    for (unsigned int j=0; j<_entries.size(); j++)
+        n += _entries[j].size();
+    
+    this->comm().sum(n);
+    
+    return n;
+}
+
+
+
+Real
+MAST::DistributedConstraintGradients::frobenius_norm() const {
+    
+    Real v = 0.;
+    
+    for (unsigned int j=0; j<_entries.size(); j++)
+        for (unsigned int k=0; k<_entries[j].size(); k++)
+            v += _entries[j][k].second * _entries[j][k].second;
+    
+    this->comm().sum(v);
+    
+    return sqrt(v);
+}
+
+
+
+void
+MAST::DistributedConstraintGradients::
+vector_mult(const libMesh::NumericVector<Real>& w,
+            std::vector<Real>& r) const {
+    
+    libmesh_assert_equal_to(w.first_local_index(), _first);
+    libmesh_assert_equal_to(w.last_local_index(),  _last);
+    
+    r.assign(_n_con, 0.);
+    
+    for (libMesh::numeric_index_type j=_first; j<_last; j++) {
+        
+        const std::vector<std::pair<unsigned int, Real> >&
+        row = _entries[j-_first];
+        
+        const Real wj = w(j);
+        
+        for (unsigned int k=0; k<row.size(); k++)
+            r[row[k].first] += row[k].second * wj;
+    }
+    
+    this->comm().sum(r);
+}
+
+
+
+void
+MAST::DistributedConstraintGradients::
+vector_mult_transpose(const std::vector<Real>& lambda,
+                      libMesh::NumericVector<Real>& y) const {
+    
+    libmesh_assert_equal_to(lambda.size(), _n_con);
+    libmesh_assert_equal_to(y.first_local_index(), _first);
+    libmesh_assert_equal_to(y.last_local_index(),  _last);
+    
+    for (libMesh::numeric_index_type j=_first; j<_last; j++) {
+        
+        const std::vector<std::pair<unsigned int, Real> >&
+        row = _entries[j-_first];
+        
+        Real v = 0.;
+        
+        for (unsigned int k=0; k<row.size(); k++)
+            v += row[k].second * lambda[row[k].first];
+        
+        y.set(j, v);
+    }
+    
+    y.close();
+}
+
+
+
+void
+MAST::DistributedConstraintGradients::localize(std::vector<Real>& grads) const {
+    
+    grads.assign(_n_vars*_n_con, 0.);
+    
+    for (libMesh::numeric_index_type j=_first; j<_last; j++) {
+        
+        const std::vector<std::pair<unsigned int, Real> >&
+        row = _entries[j-_first];
+        
+        for (unsigned int k=0; k<row.size(); k++)
+            grads[j*_n_con+row[k].first] = row[k].second;
+    }
+    
+    // each entry is nonzero only on the rank that owns the variable
+    this->comm().sum(grads);
+}
+
+
+
+Real&
+MAST::DistributedConstraintGradients::_entry(libMesh::numeric_index_type j,
+                                             unsigned int i) {
+    
+    libmesh_assert_greater_equal(j, _first);
+    libmesh_assert_less(j, _last);
+    libmesh_assert_less(i, _n_con);
+    
+    std::vector<std::pair<unsigned int, Real> >&
+    row = _entries[j-_first];
+    
+    std::vector<std::pair<unsigned int, Real> >::iterator
+    it = std::lower_bound(row.begin(), row.end(), i, MAST::ConstraintEntryLess());
+    
+    if (it == row.end() || it->first != i)
+        it = row.insert(it, std::make_pair(i, 0.));
+    
+    return it->second;
+}
+
@@ -0,0 +1,219 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2017  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef __mast__distributed_constraint_gradients_h__
+#define __mast__distributed_constraint_gradients_h__
+
+// C++ includes
+#include <vector>
+#include <utility>
+
+
+// MAST includes
+#include "base/mast_data_types.h"
+
+
+// libMesh includes
+#include "libmesh/parallel_object.h"
+#include "libmesh/numeric_vector.h"
+
+
+namespace MAST {
+    
+    /*!
+     *   Sparse storage of the gradients of the constraints of an
+     *   optimization problem, distributed with the design variables. Each
+     *   rank stores the nonzero derivatives \f$ df_i/dx_j \f$ of all
+     *   constraints \f$ i \f$ with respect to the design variables
+     *   \f$ j \f$ in the local range of the design variable vector, so
+     *   that the storage scales with the number of local design variables
+     *   and the number of constraints that depend on them, rather than
+     *   with the product of the number of constraints and of all design
+     *   variables.
+     */
+    class DistributedConstraintGradients:
+    public libMesh::ParallelObject {
+        
+    public:
+        
+        /*!
+         *   storage for \p n_con constraints, with the design variables
+         *   distributed as \p x
+         */
+        DistributedConstraintGradients(const libMesh::NumericVector<Real>& x,
+                                       unsigned int n_con);
+        
+        virtual ~DistributedConstraintGradients();
+        
+        
+        /*!
+         *   @returns the number of constraints
+         */
+        unsigned int n_constraints() const {
+            return _n_con;
+        }
+        
+        
+        /*!
+         *   @returns the number of design variables on all ranks
+         */
+        libMesh::numeric_index_type n_vars() const {
+            return _n_vars;
+        }
+        
+        
+        /*!
+         *   @returns the first local design variable
+         */
+        libMesh::numeric_index_type first_local_index() const {
+            return _first;
+        }
+        
+        
+        /*!
+         *   @returns the design variable after the last local variable
+         */
+        libMesh::numeric_index_type last_local_index() const {
+            return _last;
+        }
+        
+        
+        /*!
+         *   removes all entries
+         */
+        void zero();
+        
+        
+        /*!
+         *   removes the entries of the i^th constraint
+         */
+        void zero_constraint(unsigned int i);
+        
+        
+        /*!
+         *   sets the derivative of the i^th constraint with respect to the
+         *   local design variable \p j to \p v
+         */
+        void set(libMesh::numeric_index_type j,
+                 unsigned int i,
+                 Real v);
+        
+        
+        /*!
+         *   adds \p v to the derivative of the i^th constraint with respect
+         *   to the local design variable \p j
+         */
+        void add(libMesh::numeric_index_type j,
+                 unsigned int i,
+                 Real v);
+        
+        
+        /*!
+         *   @returns the derivative of the i^th constraint with respect to
+         *   the local design variable \p j
+         */
+        Real operator() (libMesh::numeric_index_type j,
+                         unsigned int i) const;
+        
+        
+        /*!
+         *   @returns the nonzero derivatives with respect to the local
+         *   design variable \p j, as pairs of the constraint and the
+         *   derivative sorted by the constraint
+         */
+        const std::vector<std::pair<unsigned int, Real> >&
+        var_entries(libMesh::numeric_index_type j) const {
+            
+            libmesh_assert_greater_equal(j, _first);
+            libmesh_assert_less(j, _last);
+            
+            return _entries[j-_first];
+        }
+        
+        
+        /*!
+         *   @returns the number of stored entries on all ranks
+         */
+        unsigned long long n_nonzeros() const;
+        
+        
+        /*!
+         *   @returns the Frobenius norm of the gradients. This must be
+         *   called on all ranks.
+         */
+        Real frobenius_norm() const;
+        
+        
+        /*!
+         *   computes \f$ r_i = \sum_j df_i/dx_j w_j \f$ for all
+         *   constraints. This must be called on all ranks.
+         */
+        void vector_mult(const libMesh::NumericVector<Real>& w,
+                         std::vector<Real>& r) const;
+        
+        
+        /*!
+         *   computes \f$ y_j = \sum_i df_i/dx_j \lambda_i \f$ for the local
+         *   design variables
+         */
+        void vector_mult_transpose(const std::vector<Real>& lambda,
+                                   libMesh::NumericVector<Real>& y) const;
+        
+        
+        /*!
+         *   copies the gradients to the dense array \p grads replicated on
+         *   all ranks, with the derivative of constraint i with respect to
+         *   variable j at j*n_constraints()+i, which is the layout of
+         *   FunctionEvaluation::evaluate(). This must be called on all
+         *   ranks, and should be used only for small problems.
+         */
+        void localize(std::vector<Real>& grads) const;
+        
+    protected:
+        
+        /*!
+         *   @returns a reference to the derivative of the i^th constraint
+         *   with respect to the local design variable \p j, which is
+         *   created if it does not exist
+         */
+        Real& _entry(libMesh::numeric_index_type j,
+                     unsigned int i);
+        
+        /*!
+         *   number of constraints
+         */
+        const unsigned int                                        _n_con;
+        
+        /*!
+         *   number of design variables and the range of local variables
+         */
+        const libMesh::numeric_index_type                         _n_vars;
+        
+        const libMesh::numeric_index_type                         _first;
+        
+        const libMesh::numeric_index_type                         _last;
+        
+        /*!
+         *   nonzero derivatives for each local design variable
+         */
+        std::vector<std::vector<std::pair<unsigned int, Real> > > _entries;
+    };
+}
+
+#endif // __mast__distributed_constraint_gradients_h__
@@ -0,0 +1,185 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2017  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+// MAST includes
+#include "optimization/distributed_function_evaluation.h"
+#include "optimization/optimization_history.h"
+
+
+void
+MAST::DistributedFunctionEvaluation::
+timed_evaluate(const libMesh::NumericVector<Real>& dvars,
+               Real& obj,
+               bool eval_obj_grad,
+               libMesh::NumericVector<Real>& obj_grad,
+               std::vector<Real>& fvals,
+               std::vector<bool>& eval_grads,
+               MAST::DistributedConstraintGradients& grads) {
+    
+    if (_history)
+        _history->start_phase(MAST::OptimizationHistory::ANALYSIS);
+    
+    this->evaluate(dvars, obj, eval_obj_grad, obj_grad, fvals, eval_grads, grads);
+    
+    if (_history)
+        _history->stop_phase(MAST::OptimizationHistory::ANALYSIS);
+    
+    if (eval_obj_grad)
+        _obj_grad_norm = obj_grad.l2_norm();
+    
+    bool if_grads = false;
+    for (unsigned int i=0; i<eval_grads.size(); i++)
+        if_grads = (if_grads || eval_grads[i]);
+    
+    if (if_grads)
+        _con_grad_norm = grads.frobenius_norm();
+}
+
+
+
+void
+MAST::DistributedFunctionEvaluation::init_dvar(std::vector<Real>& x,
+                                               std::vector<Real>& xmin,
+                                               std::vector<Real>& xmax) {
+    
+    std::auto_ptr<libMesh::NumericVector<Real> >
+    x_vec    (this->build_dvar_vector().release()),
+    xmin_vec (this->build_dvar_vector().release()),
+    xmax_vec (this->build_dvar_vector().release());
+    
+    this->init_dvar(*x_vec, *xmin_vec, *xmax_vec);
+    
+    x_vec->localize(x);
+    xmin_vec->localize(xmin);
+    xmax_vec->localize(xmax);
+}
+
+
+
+void
+MAST::DistributedFunctionEvaluation::evaluate(const std::vector<Real>& dvars,
+                                              Real& obj,
+                                              bool eval_obj_grad,
+                                              std::vector<Real>& obj_grad,
+                                              std::vector<Real>& fvals,
+                                              std::vector<bool>& eval_grads,
+                                              std::vector<Real>& grads) {
+    
+    std::auto_ptr<libMesh::NumericVector<Real> >
+    x_vec    (this->build_dvar_vector().release()),
+    grad_vec (this->build_dvar_vector().release());
+    
+    libmesh_assert_equal_to(dvars.size(), x_vec->size());
+    
+    for (libMesh::numeric_index_type i=x_vec->first_local_index();
+         i<x_vec->last_local_index(); i++)
+        x_vec->set(i, dvars[i]);
+    x_vec->close();
+    grad_vec->zero();
+    
+    MAST::DistributedConstraintGradients
+    dist_grads(*x_vec, _n_eq+_n_ineq);
+    
+    this->evaluate(*x_vec, obj, eval_obj_grad, *grad_vec, fvals, eval_grads, dist_grads);
+    
+    if (eval_obj_grad)
+        grad_vec->localize(obj_grad);
+    
+    bool if_grads = false;
+    for (unsigned int i=0; i<eval_grads.size(); i++)
+        if_grads = (if_grads || eval_grads[i]);
+    
+    // only the requested gradients are copied, since the optimizers may
+    // expect the others to be unchanged
+    if (if_grads) {
+        
+        std::vector<Real> g;
+        dist_grads.localize(g);
+        
+        const unsigned int
+        n_fvals = _n_eq + _n_ineq;
+        
+        for (unsigned int j=0; j<_n_vars; j++)
+            for (unsigned int i=0; i<n_fvals; i++)
+                if (eval_grads[i])
+                    grads[j*n_fvals+i] = g[j*n_fvals+i];
+    }
+}
+
+
+
+void
+MAST::DistributedFunctionEvaluation::output(unsigned int iter,
+                                            const libMesh::NumericVector<Real>& x,
+                                            Real obj,
+                                            const std::vector<Real>& fval) const {
+    
+    libmesh_assert_equal_to(fval.size(), _n_eq + _n_ineq);
+    
+    unsigned int
+    n_active      = 0,
+    n_violated    = 0;
+    Real
+    max_constr    = -1.e20;
+    
+    for (unsigned int i=0; i<_n_ineq; i++) {
+        
+        if (fabs(fval[i+_n_eq]) <= _tol)
+            n_active++;
+        else if (fval[i+_n_eq] > _tol)
+            n_violated++;
+        
+        max_constr = std::max(max_constr, fval[i+_n_eq]);
+    }
+    
+    libMesh::out
+    << " *************************** " << std::endl
+    << " *** Optimization Output *** " << std::endl
+    << " *************************** " << std::endl
+    << std::endl
+    << "Iter:            "  << std::setw(10) << iter << std::endl
+    << "Nvars:           " << std::setw(10) << x.size() << std::endl
+    << "Ncons-Equality:  " << std::setw(10) << _n_eq << std::endl
+    << "Ncons-Inquality: " << std::setw(10) << _n_ineq << std::endl
+    << std::endl
+    << "Obj =                  " << std::setw(20) << obj << std::endl
+    << "min(x) =               " << std::setw(20) << x.min() << std::endl
+    << "max(x) =               " << std::setw(20) << x.max() << std::endl
+    << std::endl
+    << std::setw(35) << " N Active Constraints: "
+    << std::setw(20) << n_active << std::endl
+    << std::setw(35) << " N Violated Constraints: "
+    << std::setw(20) << n_violated << std::endl
+    << std::setw(35) << " Most critical constraint: "
+    << std::setw(20) << max_constr << std::endl
+    << std::endl
+    << " *************************** " << std::endl;
+    
+    if (_history)
+        _history->write_record(iter, x, obj, fval, _obj_grad_norm, _con_grad_norm);
+    
+    if (_output && this->comm().rank() == 0) {
+        
+        *_output << std::setw(10) << iter << std::setw(20) << obj;
+        for (unsigned int i=0; i < fval.size(); i++)
+            *_output << std::setw(20) << fval[i];
+        *_output << std::endl;
+    }
+}
+
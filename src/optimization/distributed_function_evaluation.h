@@ -0,0 +1,141 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2017  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef __mast__distributed_function_evaluation_h__
+#define __mast__distributed_function_evaluation_h__
+
+// C++ includes
+#include <memory>
+
+
+// MAST includes
+#include "optimization/function_evaluation.h"
+#include "optimization/distributed_constraint_gradients.h"
+
+
+namespace MAST {
+    
+    /*!
+     *   Function evaluation for optimization problems with a large number
+     *   of design variables, for example topology optimization. The
+     *   design variables and the objective gradient are distributed
+     *   vectors, and the constraint gradients are stored in
+     *   MAST::DistributedConstraintGradients, so that no rank stores
+     *   quantities of the size of all design variables times the number
+     *   of constraints. This is used by MAST::MMAOptimizationInterface.
+     *   The replicated interface of MAST::FunctionEvaluation is
+     *   implemented by copying the distributed quantities to all ranks,
+     *   so that small problems can also be used with the other
+     *   optimizers.
+     */
+    class DistributedFunctionEvaluation:
+    public MAST::FunctionEvaluation {
+        
+    public:
+        
+        DistributedFunctionEvaluation(const libMesh::Parallel::Communicator& comm_in):
+        MAST::FunctionEvaluation(comm_in)
+        { }
+        
+        virtual ~DistributedFunctionEvaluation() { }
+        
+        
+        /*!
+         *   @returns a new vector with the parallel layout of the design
+         *   variables
+         */
+        virtual std::auto_ptr<libMesh::NumericVector<Real> >
+        build_dvar_vector() = 0;
+        
+        
+        /*!
+         *   sets the initial design and the bounds of the design variables
+         */
+        virtual void init_dvar(libMesh::NumericVector<Real>& x,
+                               libMesh::NumericVector<Real>& xmin,
+                               libMesh::NumericVector<Real>& xmax) = 0;
+        
+        
+        /*!
+         *   evaluates the objective and constraints at \p dvars, and the
+         *   gradients if requested. The constraint gradients are added
+         *   to \p grads, which is zeroed before the call.
+         */
+        virtual void evaluate(const libMesh::NumericVector<Real>& dvars,
+                              Real& obj,
+                              bool eval_obj_grad,
+                              libMesh::NumericVector<Real>& obj_grad,
+                              std::vector<Real>& fvals,
+                              std::vector<bool>& eval_grads,
+                              MAST::DistributedConstraintGradients& grads) = 0;
+        
+        
+        /*!
+         *   calls the distributed evaluate(), measures its time as the
+         *   analysis phase of the history, if attached, and stores the
+         *   norms of the computed gradients for output(). This is used by
+         *   the optimizers.
+         */
+        void timed_evaluate(const libMesh::NumericVector<Real>& dvars,
+                            Real& obj,
+                            bool eval_obj_grad,
+                            libMesh::NumericVector<Real>& obj_grad,
+                            std::vector<Real>& fvals,
+                            std::vector<bool>& eval_grads,
+                            MAST::DistributedConstraintGradients& grads);
+        
+        
+        /*!
+         *   calls the distributed init_dvar() and copies the vectors to
+         *   all ranks
+         */
+        virtual void init_dvar(std::vector<Real>& x,
+                               std::vector<Real>& xmin,
+                               std::vector<Real>& xmax);
+        
+        
+        /*!
+         *   calls the distributed evaluate() and copies the results to all
+         *   ranks
+         */
+        virtual void evaluate(const std::vector<Real>& dvars,
+                              Real& obj,
+                              bool eval_obj_grad,
+                              std::vector<Real>& obj_grad,
+                              std::vector<Real>& fvals,
+                              std::vector<bool>& eval_grads,
+                              std::vector<Real>& grads);
+        
+        
+        /*!
+         *   outputs the objective and a summary of the constraints of the
+         *   current iterate, without the design variables, and writes the
+         *   iterate to the history, if attached. This must be called on
+         *   all ranks.
+         */
+        virtual void output(unsigned int iter,
+                            const libMesh::NumericVector<Real>& x,
+                            Real obj,
+                            const std::vector<Real>& fval) const;
+        
+        using MAST::FunctionEvaluation::output;
+    };
+}
+
+#endif // __mast__distributed_function_evaluation_h__
@@ -128,9 +128,9 @@ MAST::DOTOptimizationInterface::optimize() {
             obj_grad = true;
         }
         
-        _feval->evaluate(X,
-                         OBJ, obj_grad, DF0DX,
-                         G, eval_grads, DFDX);
+        _feval->cached_evaluate(X,
+                                OBJ, obj_grad, DF0DX,
+                                G, eval_grads, DFDX);
         
         // if gradients were requested, copy the data back to WK
         if (INFO == 2) {
@@ -17,8 +17,15 @@
  * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
  */
 
+// C++ includes
+#include <algorithm>
+
 // MAST includes
 #include "optimization/function_evaluation.h"
+#include "optimization/optimization_history.h"
+
+// libMesh includes
+#include "libmesh/parallel.h"
 
 
 void
@@ -41,13 +48,17 @@ MAST::FunctionEvaluation::output(unsigned int iter, const std::vector<Real> &x,
     << "Ncons-Inquality: " << std::setw(10) << _n_ineq << std::endl
     << std::endl
     << "Obj =                  " << std::setw(20) << obj << std::endl
-    << std::endl
-    << "Vars:            " << std::endl;
+    << std::endl;
     
-    for (unsigned int i=0; i<_n_vars; i++)
-        libMesh::out
-        << "x     [ " << std::setw(10) << i << " ] = "
-        << std::setw(20) << x[i] << std::endl;
+    if (_output_dvars) {
+        
+        libMesh::out << "Vars:            " << std::endl;
+        
+        for (unsigned int i=0; i<_n_vars; i++)
+            libMesh::out
+            << "x     [ " << std::setw(10) << i << " ] = "
+            << std::setw(20) << x[i] << std::endl;
+    }
     
     if (_n_eq) {
         libMesh::out << std::endl
@@ -102,6 +113,10 @@ MAST::FunctionEvaluation::output(unsigned int iter, const std::vector<Real> &x,
     << " *************************** " << std::endl;
     
     
+    if (_history)
+        _history->write_record(iter, x, obj, fval, _obj_grad_norm, _con_grad_norm);
+    
+    
     // the next section writes to the optimization file.
     if (!if_write_to_optim_file ||
         !_output)  // or if the output has not been specified
@@ -111,7 +126,7 @@ MAST::FunctionEvaluation::output(unsigned int iter, const std::vector<Real> &x,
         // write header for the first iteration
         if (iter == 0) {
             *_output << std::setw(10) << "Iter";
-            for (unsigned int i=0; i < x.size(); i++) {
+            for (unsigned int i=0; _output_dvars && i < x.size(); i++) {
                 std::stringstream x; x << "x_" << i;
                 *_output << std::setw(20) << x.str();
             }
@@ -124,7 +139,7 @@ MAST::FunctionEvaluation::output(unsigned int iter, const std::vector<Real> &x,
         }
         
         *_output << std::setw(10) << iter;
-        for (unsigned int i=0; i < x.size(); i++)
+        for (unsigned int i=0; _output_dvars && i < x.size(); i++)
             *_output << std::setw(20) << x[i];
         *_output << std::setw(20) << obj;
         for (unsigned int i=0; i < fval.size(); i++)
@@ -137,6 +152,436 @@ MAST::FunctionEvaluation::output(unsigned int iter, const std::vector<Real> &x,
 
 
 
+void
+MAST::FunctionEvaluation::set_n_sensitivity_groups(unsigned int n_groups) {
+    
+    libmesh_assert_greater(n_groups, 0);
+    libmesh_assert_less_equal(n_groups, this->n_processors());
+    
+    _n_sensitivity_groups = n_groups;
+    
+    // contiguous ranks are assigned to each group, so that the ranks
+    // of a group are likely to share a node
+    const unsigned int
+    n_ranks   = this->n_processors(),
+    rank      = this->processor_id(),
+    per_group = n_ranks / n_groups,
+    n_larger  = n_ranks % n_groups;   // groups with one additional rank
+    
+    if (rank < n_larger * (per_group + 1))
+        _sensitivity_group = rank / (per_group + 1);
+    else
+        _sensitivity_group = n_larger + (rank - n_larger * (per_group + 1)) / per_group;
+    
+    this->comm().split(_sensitivity_group, rank, _sensitivity_comm);
+}
+
+
+
+void
+MAST::FunctionEvaluation::gather_sensitivity(std::vector<Real>& v,
+                                             unsigned int n_per_var) const {
+    
+    if (_n_sensitivity_groups == 1)
+        return;
+    
+    libmesh_assert_equal_to(v.size(), _n_vars * n_per_var);
+    
+    // only the first rank of each group contributes the values of the
+    // design variables owned by the group, so that the sum over all
+    // ranks provides the sensitivity of all variables.
+    const bool if_contribute = (_sensitivity_comm.rank() == 0);
+    
+    for (unsigned int i=0; i<_n_vars; i++)
+        if (!if_contribute || !this->if_sensitivity_group_owns(i))
+            std::fill(v.begin() +  i   *n_per_var,
+                      v.begin() + (i+1)*n_per_var,
+                      0.);
+    
+    this->comm().sum(v);
+}
+
+
+
+void
+MAST::FunctionEvaluation::set_evaluation_cache(unsigned int n_max, Real tol) {
+    
+    libmesh_assert_greater_equal(tol, 0.);
+    
+    _cache_max_size = n_max;
+    _cache_tol      = tol;
+    
+    while (_cache.size() > _cache_max_size) {
+        this->_clear_cached_solution(_cache.back().id);
+        _cache.pop_back();
+    }
+}
+
+
+
+void
+MAST::FunctionEvaluation::clear_evaluation_cache() {
+    
+    for (unsigned int i=0; i<_cache.size(); i++)
+        this->_clear_cached_solution(_cache[i].id);
+    _cache.clear();
+}
+
+
+
+MAST::FunctionEvaluation::EvaluationCacheEntry*
+MAST::FunctionEvaluation::
+_find_cached_evaluation(const std::vector<Real>& dvars) {
+    
+    for (unsigned int i=0; i<_cache.size(); i++) {
+        
+        const std::vector<Real>& x = _cache[i].dvars;
+        bool found = (x.size() == dvars.size());
+        
+        for (unsigned int j=0; found && j<x.size(); j++)
+            found = fabs(x[j]-dvars[j]) <= _cache_tol * std::max(1., fabs(x[j]));
+        
+        if (found)
+            return &_cache[i];
+    }
+    
+    return nullptr;
+}
+
+
+
+void
+MAST::FunctionEvaluation::cached_evaluate(const std::vector<Real>& dvars,
+                                          Real& obj,
+                                          bool eval_obj_grad,
+                                          std::vector<Real>& obj_grad,
+                                          std::vector<Real>& fvals,
+                                          std::vector<bool>& eval_grads,
+                                          std::vector<Real>& grads) {
+    
+    libmesh_assert_equal_to(eval_grads.size(), _n_eq + _n_ineq);
+    
+    const unsigned int
+    n_fvals = _n_eq + _n_ineq;
+    
+    // the gradients requested by the optimizer. evaluate() may compute
+    // fewer gradients if the constraints are screened.
+    const std::vector<bool>
+    requested(eval_grads);
+    
+    if (!_cache_max_size) {
+        
+        this->_timed_evaluate(dvars, obj, eval_obj_grad, obj_grad, fvals, eval_grads, grads);
+        this->_update_gradient_norms(eval_obj_grad, obj_grad, eval_grads, grads);
+        this->_update_stale_gradients(requested, eval_grads, grads);
+        eval_grads = requested;
+        return;
+    }
+    
+    EvaluationCacheEntry* entry = this->_find_cached_evaluation(dvars);
+    
+    if (entry) {
+        
+        // gradients of inactive constraints are not needed
+        std::vector<bool> computed(n_fvals, false);
+        
+        bool complete = (entry->if_obj_grad || !eval_obj_grad);
+        for (unsigned int i=0; complete && i<n_fvals; i++) {
+            computed[i] = (eval_grads[i] && entry->if_grads[i]);
+            complete    = (computed[i] ||
+                           !eval_grads[i] ||
+                           (_active_set_screening &&
+                            !this->if_constraint_active(i, entry->fvals[i])));
+        }
+        
+        this->_restore_cached_solution(entry->id);
+        
+        if (complete) {
+            
+            obj   = entry->obj;
+            fvals = entry->fvals;
+            if (eval_obj_grad)
+                obj_grad = entry->obj_grad;
+            
+            // the gradients of constraint i with respect to variable j
+            // are at j*n_fvals+i
+            for (unsigned int i=0; i<n_fvals; i++)
+                if (computed[i])
+                    for (unsigned int j=0; j<_n_vars; j++)
+                        grads[j*n_fvals+i] = entry->grads[j*n_fvals+i];
+            
+            this->_update_gradient_norms(eval_obj_grad, obj_grad, computed, grads);
+            this->_update_stale_gradients(requested, computed, grads);
+            return;
+        }
+    }
+    
+    this->_timed_evaluate(dvars, obj, eval_obj_grad, obj_grad, fvals, eval_grads, grads);
+    
+    if (!entry) {
+        
+        // the oldest evaluation is replaced if the cache is full
+        if (_cache.size() == _cache_max_size) {
+            this->_clear_cached_solution(_cache.back().id);
+            _cache.pop_back();
+        }
+        
+        _cache.push_front(EvaluationCacheEntry());
+        entry = &_cache.front();
+        
+        entry->id          = _cache_next_id++;
+        entry->dvars       = dvars;
+        entry->if_obj_grad = false;
+        entry->obj_grad.resize(_n_vars, 0.);
+        entry->if_grads.resize(n_fvals, false);
+        entry->grads.resize(_n_vars*n_fvals, 0.);
+    }
+    
+    entry->obj   = obj;
+    entry->fvals = fvals;
+    
+    if (eval_obj_grad) {
+        entry->if_obj_grad = true;
+        entry->obj_grad    = obj_grad;
+    }
+    
+    for (unsigned int i=0; i<n_fvals; i++)
+        if (eval_grads[i]) {
+            entry->if_grads[i] = true;
+            for (unsigned int j=0; j<_n_vars; j++)
+                entry->grads[j*n_fvals+i] = grads[j*n_fvals+i];
+        }
+    
+    this->_cache_solution(entry->id);
+    
+    this->_update_gradient_norms(eval_obj_grad, obj_grad, eval_grads, grads);
+    this->_update_stale_gradients(requested, eval_grads, grads);
+    eval_grads = requested;
+}
+
+
+
+void
+MAST::FunctionEvaluation::_timed_evaluate(const std::vector<Real>& dvars,
+                                          Real& obj,
+                                          bool eval_obj_grad,
+                                          std::vector<Real>& obj_grad,
+                                          std::vector<Real>& fvals,
+                                          std::vector<bool>& eval_grads,
+                                          std::vector<Real>& grads) {
+    
+    if (_history)
+        _history->start_phase(MAST::OptimizationHistory::ANALYSIS);
+    
+    this->evaluate(dvars, obj, eval_obj_grad, obj_grad, fvals, eval_grads, grads);
+    
+    if (_history)
+        _history->stop_phase(MAST::OptimizationHistory::ANALYSIS);
+}
+
+
+
+void
+MAST::FunctionEvaluation::
+_update_gradient_norms(bool eval_obj_grad,
+                       const std::vector<Real>& obj_grad,
+                       const std::vector<bool>& eval_grads,
+                       const std::vector<Real>& grads) {
+    
+    const unsigned int
+    n_fvals = _n_eq + _n_ineq;
+    
+    if (eval_obj_grad) {
+        
+        _obj_grad_norm = 0.;
+        for (unsigned int j=0; j<_n_vars; j++)
+            _obj_grad_norm += obj_grad[j]*obj_grad[j];
+        _obj_grad_norm = sqrt(_obj_grad_norm);
+    }
+    
+    bool if_grads = false;
+    Real norm     = 0.;
+    
+    for (unsigned int i=0; i<n_fvals; i++)
+        if (eval_grads[i]) {
+            if_grads = true;
+            for (unsigned int j=0; j<_n_vars; j++)
+                norm += grads[j*n_fvals+i]*grads[j*n_fvals+i];
+        }
+    
+    if (if_grads)
+        _con_grad_norm = sqrt(norm);
+}
+
+
+
+void
+MAST::FunctionEvaluation::set_active_set_screening(bool f, Real tol) {
+    
+    _active_set_screening = f;
+    _active_set_tol       = tol;
+}
+
+
+
+void
+MAST::FunctionEvaluation::set_constraint_active(unsigned int i, bool f) {
+    
+    libmesh_assert_less(i, _n_eq + _n_ineq);
+    
+    if (_forced_active.size() != _n_eq + _n_ineq)
+        _forced_active.assign(_n_eq + _n_ineq, false);
+    
+    _forced_active[i] = f;
+}
+
+
+
+bool
+MAST::FunctionEvaluation::if_constraint_active(unsigned int i, Real fval) const {
+    
+    libmesh_assert_less(i, _n_eq + _n_ineq);
+    
+    return (!_active_set_screening        ||
+            i < _n_eq                     ||
+            fval >= _active_set_tol       ||
+            (i < _forced_active.size() && _forced_active[i]));
+}
+
+
+
+void
+MAST::FunctionEvaluation::
+screen_active_constraints(const std::vector<Real>& fvals,
+                          std::vector<bool>& eval_grads) const {
+    
+    libmesh_assert_equal_to(fvals.size(),      _n_eq + _n_ineq);
+    libmesh_assert_equal_to(eval_grads.size(), _n_eq + _n_ineq);
+    
+    for (unsigned int i=0; i<eval_grads.size(); i++)
+        eval_grads[i] = (eval_grads[i] && this->if_constraint_active(i, fvals[i]));
+}
+
+
+
+bool
+MAST::FunctionEvaluation::if_gradient_stale(unsigned int i) const {
+    
+    libmesh_assert_less(i, _n_eq + _n_ineq);
+    
+    return i < _stale_grads.size() && _stale_grads[i];
+}
+
+
+
+void
+MAST::FunctionEvaluation::
+_update_stale_gradients(const std::vector<bool>& requested,
+                        const std::vector<bool>& computed,
+                        std::vector<Real>& grads) {
+    
+    const unsigned int
+    n_fvals = _n_eq + _n_ineq;
+    
+    if (_last_grads.size() != _n_vars*n_fvals) {
+        
+        _last_grads.assign(_n_vars*n_fvals, 0.);
+        _stale_grads.assign(n_fvals, false);
+    }
+    
+    for (unsigned int i=0; i<n_fvals; i++) {
+        
+        if (!requested[i])
+            continue;
+        
+        _stale_grads[i] = !computed[i];
+        
+        for (unsigned int j=0; j<_n_vars; j++) {
+            
+            if (computed[i])
+                _last_grads[j*n_fvals+i] = grads[j*n_fvals+i];
+            else
+                grads[j*n_fvals+i] = _last_grads[j*n_fvals+i];
+        }
+    }
+}
+
+
+
+void
+MAST::FunctionEvaluation::
+evaluate_many(const std::vector<std::vector<Real> >& dvars,
+              std::vector<Real>& obj,
+              std::vector<std::vector<Real> >& fvals) {
+    
+    const unsigned int
+    n_designs = (unsigned int)dvars.size(),
+    n_fvals   = _n_eq + _n_ineq;
+    
+    // the objective and constraints of design k are stored at
+    // k*(n_fvals+1), so that the results of all groups are collected
+    // with a single sum
+    std::vector<Real>
+    vals(n_designs*(n_fvals+1), 0.),
+    f(n_fvals, 0.);
+    
+    const bool
+    if_contribute = (_n_sensitivity_groups == 1 ||
+                     _sensitivity_comm.rank() == 0);
+    
+    for (unsigned int k=0; k<n_designs; k++) {
+        
+        if (k % _n_sensitivity_groups != _sensitivity_group)
+            continue;
+        
+        Real o = 0.;
+        std::fill(f.begin(), f.end(), 0.);
+        
+        this->_evaluate_on_group(dvars[k], o, f);
+        
+        if (if_contribute) {
+            vals[k*(n_fvals+1)] = o;
+            for (unsigned int i=0; i<n_fvals; i++)
+                vals[k*(n_fvals+1)+1+i] = f[i];
+        }
+    }
+    
+    if (_n_sensitivity_groups > 1)
+        this->comm().sum(vals);
+    
+    obj.resize(n_designs);
+    fvals.resize(n_designs);
+    
+    for (unsigned int k=0; k<n_designs; k++) {
+        
+        obj[k] = vals[k*(n_fvals+1)];
+        fvals[k].assign(vals.begin() + k*(n_fvals+1) + 1,
+                        vals.begin() + (k+1)*(n_fvals+1));
+    }
+}
+
+
+
+void
+MAST::FunctionEvaluation::_evaluate_on_group(const std::vector<Real>& dvars,
+                                             Real& obj,
+                                             std::vector<Real>& fvals) {
+    
+    if (_n_sensitivity_groups > 1)
+        libmesh_error_msg("Evaluation on sensitivity groups must be implemented by the derived class.");
+    
+    std::vector<Real>
+    obj_grad,
+    grads;
+    
+    std::vector<bool>
+    eval_grads(_n_eq + _n_ineq, false);
+    
+    this->evaluate(dvars, obj, false, obj_grad, fvals, eval_grads, grads);
+}
+
+
+
 bool
 MAST::FunctionEvaluation::verify_gradients(const std::vector<Real>& dvars) {
     
@@ -153,7 +598,6 @@ MAST::FunctionEvaluation::verify_gradients(const std::vector<Real>& dvars) {
     
     
     std::vector<Real>
-    dvars_fd   (dvars),
     obj_grad   (_n_vars),
     obj_grad_fd(_n_vars),
     fvals      (_n_ineq + _n_eq),
@@ -166,7 +610,6 @@ MAST::FunctionEvaluation::verify_gradients(const std::vector<Real>& dvars) {
     eval_grads (_n_eq+_n_ineq);
     
     
-    std::fill(    dvars_fd.begin(),     dvars_fd.end(),   0.);
     std::fill(    obj_grad.begin(),     obj_grad.end(),   0.);
     std::fill( obj_grad_fd.begin(),  obj_grad_fd.end(),   0.);
     std::fill(       fvals.begin(),        fvals.end(),   0.);
@@ -186,31 +629,26 @@ MAST::FunctionEvaluation::verify_gradients(const std::vector<Real>& dvars) {
                    grads);
     
     
-    // now turn off the sensitivity variables
-    eval_obj_grad = false;
-    std::fill(  eval_grads.begin(),   eval_grads.end(), false);
-    
     // now iteratve over the design variables, and calculate the finite
-    // difference sensitivity values
+    // difference sensitivity values. The perturbed designs are evaluated
+    // together, so that they can be distributed over the sensitivity
+    // groups.
+    std::vector<std::vector<Real> >
+    dvars_fd_all (_n_vars, dvars),
+    fvals_fd_all;
+    
+    std::vector<Real>
+    obj_fd_all;
+    
+    for (unsigned int i=0; i<_n_vars; i++)
+        dvars_fd_all[i][i] += delta;
+    
+    this->evaluate_many(dvars_fd_all, obj_fd_all, fvals_fd_all);
     
     for (unsigned int i=0; i<_n_vars; i++) {
         
-        // copy the original vector
-        dvars_fd =  dvars;
-        
-        // now perturb it
-        dvars_fd[i] += delta;
-        
-        // call the evaluate routine
-        obj_fd       = 0.;
-        std::fill(    fvals_fd.begin(),     fvals_fd.end(),   0.);
-        this->evaluate(dvars_fd,
-                       obj_fd,
-                       eval_obj_grad,
-                       obj_grad_fd,
-                       fvals_fd,
-                       eval_grads,
-                       grads_fd);
+        obj_fd       = obj_fd_all[i];
+        fvals_fd     = fvals_fd_all[i];
         
         // objective gradient
         obj_grad_fd[i]  = (obj_fd-obj)/delta;
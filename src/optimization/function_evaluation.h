@@ -23,6 +23,7 @@
 
 // C++ includes
 #include <vector>
+#include <deque>
 #include <iostream>
 #include <iomanip>
 #include <fstream>
@@ -38,6 +39,10 @@
 
 namespace MAST {
     
+    // Forward declerations
+    class OptimizationHistory;
+    
+    
     class FunctionEvaluation:
     public libMesh::ParallelObject {
         
@@ -51,7 +56,19 @@ namespace MAST {
         _max_iters(0),
         _n_rel_change_iters(5),
         _tol(1.0e-6),
-        _output(nullptr)
+        _output(nullptr),
+        _n_sensitivity_groups(1),
+        _sensitivity_group(0),
+        _sensitivity_comm(comm_in.get()),
+        _cache_max_size(0),
+        _cache_tol(0.),
+        _cache_next_id(0),
+        _active_set_screening(false),
+        _active_set_tol(-0.1),
+        _output_dvars(true),
+        _history(nullptr),
+        _obj_grad_norm(0.),
+        _con_grad_norm(0.)
         { }
         
         virtual ~FunctionEvaluation() { }
@@ -104,6 +121,41 @@ namespace MAST {
                               std::vector<Real>& grads) = 0;
         
         
+        /*!
+         *   stores up to \p n_max evaluations of evaluate() for use by
+         *   cached_evaluate(). Two design vectors are considered identical
+         *   if each component differs by less than
+         *   \p tol * max(1, |x_i|). The default \p n_max = 0 disables the
+         *   cache, and \p tol = 0 requires an exact match.
+         */
+        void set_evaluation_cache(unsigned int n_max, Real tol = 0.);
+        
+        
+        /*!
+         *   deletes all stored evaluations. This should be called if the
+         *   functions change, for example after a change of the analysis
+         *   parameters.
+         */
+        void clear_evaluation_cache();
+        
+        
+        /*!
+         *   same as evaluate(), but returns the stored results if \p dvars
+         *   was evaluated before with all the requested gradients. Otherwise
+         *   evaluate() is called, and its results are stored together with
+         *   the gradients available from a previous evaluation of the same
+         *   design. Without a cache this calls evaluate(). This is used by
+         *   the optimization interfaces.
+         */
+        void cached_evaluate(const std::vector<Real>& dvars,
+                             Real& obj,
+                             bool eval_obj_grad,
+                             std::vector<Real>& obj_grad,
+                             std::vector<Real>& fvals,
+                             std::vector<bool>& eval_grads,
+                             std::vector<Real>& grads);
+        
+        
         /*!
          *   sets the output file and the function evaluation will 
          *   write the optimization iterates to this file. If this is not called
@@ -123,9 +175,50 @@ namespace MAST {
         }
 
         
+        /*!
+         *   if \p f is false, the design variables are not written by
+         *   output() to libMesh::out and to the output file, which is
+         *   useful for problems with many design variables. This is true
+         *   by default.
+         */
+        void set_output_design_variables(bool f) {
+            _output_dvars = f;
+        }
+        
+        
+        /*!
+         *   attaches the binary history to which output() writes a record
+         *   for each iterate. cached_evaluate() measures the time of
+         *   evaluate() as the analysis phase of the history, and derived
+         *   classes can measure the sensitivity analysis in evaluate() with
+         *   the SENSITIVITY phase of history().
+         */
+        void attach_history(MAST::OptimizationHistory& h) {
+            _history = &h;
+        }
+        
+        
+        /*!
+         *   detaches the history
+         */
+        void detach_history() {
+            _history = nullptr;
+        }
+        
+        
+        /*!
+         *   @returns a pointer to the attached history, or \p nullptr
+         */
+        MAST::OptimizationHistory* history() {
+            return _history;
+        }
+        
+        
         /*!
          *   outputs the the current iterate to libMesh::out, and to the 
-         *   output file if it was set for this rank.
+         *   output file if it was set for this rank. If a history is
+         *   attached, the iterate is also written to the history with the
+         *   norms of the gradients last computed by cached_evaluate().
          */
         virtual void output(unsigned int iter,
                             const std::vector<Real>& x,
@@ -134,6 +227,138 @@ namespace MAST {
                             bool if_write_to_optim_file) const;
         
         
+        /*!
+         *   splits the ranks of the communicator of this object into
+         *   \p n_groups groups of contiguous ranks for the sensitivity
+         *   analysis. Each group owns the design variables \p i for which
+         *   \p i % n_groups equals the group id (see
+         *   if_sensitivity_group_owns()). In evaluate(), each group computes
+         *   the sensitivities of its design variables on a system created
+         *   on sensitivity_comm(), which needs to be duplicated by the
+         *   derived class, and all sensitivities are then collected with
+         *   gather_sensitivity(). One group is used by default.
+         */
+        void set_n_sensitivity_groups(unsigned int n_groups);
+        
+        
+        /*!
+         *   @returns the number of groups for sensitivity analysis
+         */
+        unsigned int n_sensitivity_groups() const {
+            return _n_sensitivity_groups;
+        }
+        
+        
+        /*!
+         *   @returns the group of this rank for sensitivity analysis
+         */
+        unsigned int sensitivity_group() const {
+            return _sensitivity_group;
+        }
+        
+        
+        /*!
+         *   @returns the communicator of the ranks in the sensitivity group
+         *   of this rank. This is the communicator of this object if only
+         *   one group is used.
+         */
+        const libMesh::Parallel::Communicator& sensitivity_comm() const {
+            return _sensitivity_comm;
+        }
+        
+        
+        /*!
+         *   @returns true if the sensitivity group of this rank computes
+         *   the sensitivity with respect to the i^th design variable
+         */
+        bool if_sensitivity_group_owns(unsigned int i) const {
+            return (i % _n_sensitivity_groups) == _sensitivity_group;
+        }
+        
+        
+        /*!
+         *   collects the sensitivities computed by all groups on all ranks.
+         *   The sensitivities of the j^th design variable are the
+         *   \p n_per_var entries of \p v starting at \p j*n_per_var, which
+         *   is the layout of \p obj_grad (\p n_per_var = 1) and \p grads
+         *   (\p n_per_var = number of constraints) in evaluate(). On
+         *   input, only the entries of the design variables owned by the
+         *   group of this rank are used. This must be called on all ranks.
+         */
+        void gather_sensitivity(std::vector<Real>& v,
+                                unsigned int n_per_var = 1) const;
+        
+        
+        /*!
+         *   if \p f is true, the gradients are computed only for the
+         *   active constraints: the equality constraints, the inequality
+         *   constraints \f$ f_i \le 0 \f$ with \f$ f_i \ge \f$ \p tol,
+         *   and the constraints set active with set_constraint_active().
+         *   The derived class calls screen_active_constraints() in
+         *   evaluate() once the constraint values are known, and skips
+         *   the sensitivity analysis of the screened constraints.
+         *   cached_evaluate() then returns the last computed gradients of
+         *   these constraints, which are marked stale. This is false by
+         *   default.
+         */
+        void set_active_set_screening(bool f, Real tol = -0.1);
+        
+        
+        /*!
+         *   @returns true if the gradients of the constraints are screened
+         */
+        bool if_active_set_screening() const {
+            return _active_set_screening;
+        }
+        
+        
+        /*!
+         *   if \p f is true, the i^th constraint is treated as active
+         *   regardless of its value, for example if the optimizer
+         *   reports a nonzero multiplier for the constraint
+         */
+        void set_constraint_active(unsigned int i, bool f);
+        
+        
+        /*!
+         *   @returns true if the gradient of the i^th constraint with
+         *   value \p fval is needed
+         */
+        bool if_constraint_active(unsigned int i, Real fval) const;
+        
+        
+        /*!
+         *   sets \p eval_grads to false for the inactive constraints, based
+         *   on the constraint values \p fvals
+         */
+        void screen_active_constraints(const std::vector<Real>& fvals,
+                                       std::vector<bool>& eval_grads) const;
+        
+        
+        /*!
+         *   @returns true if the gradient of the i^th constraint returned
+         *   by the last call to cached_evaluate() was not computed at the
+         *   design, but copied from an earlier evaluation
+         */
+        bool if_gradient_stale(unsigned int i) const;
+        
+        
+        /*!
+         *   evaluates the objective and constraints, without gradients, at
+         *   each design of \p dvars. The designs are distributed over the
+         *   sensitivity groups (see set_n_sensitivity_groups()), with
+         *   design \p k evaluated by group \p k % n_sensitivity_groups()
+         *   using _evaluate_on_group(), and the results are then
+         *   collected on all ranks. This is used for finite difference
+         *   gradients in verify_gradients(), and can be used for design
+         *   sweeps or multiple starting points. This must be called on all
+         *   ranks.
+         */
+        virtual void evaluate_many(const std::vector<std::vector<Real> >& dvars,
+                                   std::vector<Real>& obj,
+                                   std::vector<std::vector<Real> >& fvals);
+        
+        
         /*!
          *  verifies the gradients at the specified design point
          */
@@ -187,6 +412,101 @@ namespace MAST {
         
     protected:
         
+        /*!
+         *   evaluates the objective and constraints at \p dvars on the
+         *   ranks of the sensitivity group of this rank, for
+         *   evaluate_many(). The default implementation calls evaluate()
+         *   without gradients, which is only possible with one group. With
+         *   more than one group, derived classes must evaluate the design
+         *   on their copy of the analysis created on sensitivity_comm().
+         */
+        virtual void _evaluate_on_group(const std::vector<Real>& dvars,
+                                        Real& obj,
+                                        std::vector<Real>& fvals);
+        
+        
+        /*!
+         *   called after \p evaluate() in cached_evaluate(), so that a
+         *   derived class can store its solution vectors for the design as
+         *   evaluation \p id. The default implementation does nothing.
+         */
+        virtual void _cache_solution(unsigned int id) { }
+        
+        
+        /*!
+         *   called by cached_evaluate() before the stored evaluation \p id
+         *   is returned, or before evaluate() is called to compute the
+         *   gradients missing from evaluation \p id. A derived class can
+         *   restore its solution vectors here, so that the analyses need not
+         *   be repeated for the gradients. The default implementation does
+         *   nothing.
+         */
+        virtual void _restore_cached_solution(unsigned int id) { }
+        
+        
+        /*!
+         *   called when the stored evaluation \p id is deleted. The default
+         *   implementation does nothing.
+         */
+        virtual void _clear_cached_solution(unsigned int id) { }
+        
+        
+        /*!
+         *   calls evaluate(), and measures its time for the history
+         */
+        void _timed_evaluate(const std::vector<Real>& dvars,
+                             Real& obj,
+                             bool eval_obj_grad,
+                             std::vector<Real>& obj_grad,
+                             std::vector<Real>& fvals,
+                             std::vector<bool>& eval_grads,
+                             std::vector<Real>& grads);
+        
+        
+        /*!
+         *   updates the norms of the gradients for the history, if any
+         *   gradients were computed
+         */
+        void _update_gradient_norms(bool eval_obj_grad,
+                                    const std::vector<Real>& obj_grad,
+                                    const std::vector<bool>& eval_grads,
+                                    const std::vector<Real>& grads);
+        
+        
+        /*!
+         *   copies the \p computed gradients to the last gradients, and
+         *   the last gradients to \p grads for the \p requested gradients
+         *   that were not computed
+         */
+        void _update_stale_gradients(const std::vector<bool>& requested,
+                                     const std::vector<bool>& computed,
+                                     std::vector<Real>& grads);
+        
+        
+        /*!
+         *   results of a call to evaluate()
+         */
+        struct EvaluationCacheEntry {
+            
+            unsigned int       id;
+            std::vector<Real>  dvars;
+            Real               obj;
+            bool               if_obj_grad;
+            std::vector<Real>  obj_grad;
+            std::vector<Real>  fvals;
+            std::vector<bool>  if_grads;
+            std::vector<Real>  grads;
+        };
+        
+        
+        /*!
+         *   @returns the stored evaluation of \p dvars, or \p nullptr
+         *   if none is available
+         */
+        EvaluationCacheEntry*
+        _find_cached_evaluation(const std::vector<Real>& dvars);
+        
+        
         unsigned int _n_vars;
         
         unsigned int _n_eq;
@@ -200,6 +520,76 @@ namespace MAST {
         Real _tol;
         
         std::ofstream* _output;
+        
+        /*!
+         *   number of groups for the sensitivity analysis
+         */
+        unsigned int _n_sensitivity_groups;
+        
+        /*!
+         *   group of this rank for the sensitivity analysis
+         */
+        unsigned int _sensitivity_group;
+        
+        /*!
+         *   communicator of the ranks in the sensitivity group of this rank
+         */
+        libMesh::Parallel::Communicator _sensitivity_comm;
+        
+        /*!
+         *   maximum number of stored evaluations, and the tolerance on the
+         *   design variables
+         */
+        unsigned int _cache_max_size;
+        
+        Real _cache_tol;
+        
+        /*!
+         *   id of the next stored evaluation
+         */
+        unsigned int _cache_next_id;
+        
+        /*!
+         *   stored evaluations, with the most recent first
+         */
+        std::deque<EvaluationCacheEntry> _cache;
+        
+        /*!
+         *   flag and tolerance for the screening of the constraints
+         */
+        bool _active_set_screening;
+        
+        Real _active_set_tol;
+        
+        /*!
+         *   constraints set active independent of their values
+         */
+        std::vector<bool> _forced_active;
+        
+        /*!
+         *   last computed gradients, and flags for the constraints whose
+         *   gradients were copied from these in the last evaluation
+         */
+        std::vector<Real> _last_grads;
+        
+        std::vector<bool> _stale_grads;
+        
+        /*!
+         *   flag to write the design variables in output()
+         */
+        bool _output_dvars;
+        
+        /*!
+         *   binary history of the iterations
+         */
+        MAST::OptimizationHistory* _history;
+        
+        /*!
+         *   norms of the last computed objective and constraint gradients
+         */
+        Real _obj_grad_norm;
+        
+        Real _con_grad_norm;
     };
 
 
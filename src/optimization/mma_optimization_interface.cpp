@@ -0,0 +1,463 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2017  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+// C++ includes
+#include <algorithm>
+#include <cmath>
+
+
+// MAST includes
+#include "optimization/mma_optimization_interface.h"
+#include "optimization/distributed_function_evaluation.h"
+#include "base/performance_log.h"
+
+
+// libMesh includes
+#include "libmesh/parallel.h"
+
+
+MAST::MMAOptimizationInterface::MMAOptimizationInterface():
+MAST::OptimizationInterface(),
+asymptote_init(0.5),
+asymptote_decrease(0.7),
+asymptote_increase(1.2),
+move_limit(0.5),
+constraint_penalty(1.e3),
+max_dual_iters(100),
+_dist_feval(nullptr),
+_n_con(0) {
+    
+}
+
+
+
+MAST::MMAOptimizationInterface::~MMAOptimizationInterface() {
+    
+}
+
+
+
+void
+MAST::MMAOptimizationInterface::optimize() {
+    
+    MAST_LOG_SCOPE("optimize()", "MMAOptimizationInterface");
+    
+    _dist_feval = dynamic_cast<MAST::DistributedFunctionEvaluation*>(_feval);
+    
+    if (!_dist_feval)
+        libmesh_error_msg("MMA requires a DistributedFunctionEvaluation.");
+    
+    if (_dist_feval->n_eq())
+        libmesh_error_msg("MMA supports only inequality constraints.");
+    
+    _n_con = _dist_feval->n_ineq();
+    
+    std::auto_ptr<libMesh::NumericVector<Real> >
+    x    (_dist_feval->build_dvar_vector().release()),
+    xmin (_dist_feval->build_dvar_vector().release()),
+    xmax (_dist_feval->build_dvar_vector().release()),
+    df0  (_dist_feval->build_dvar_vector().release());
+    
+    _dist_feval->init_dvar(*x, *xmin, *xmax);
+    
+    const libMesh::numeric_index_type
+    first   = x->first_local_index(),
+    last    = x->last_local_index(),
+    n_local = last - first;
+    
+    _x.resize(n_local);
+    _xmin.resize(n_local);
+    _xmax.resize(n_local);
+    
+    for (libMesh::numeric_index_type j=first; j<last; j++) {
+        _x   [j-first] = (*x)(j);
+        _xmin[j-first] = (*xmin)(j);
+        _xmax[j-first] = (*xmax)(j);
+    }
+    
+    _xold1  = _x;
+    _xold2  = _x;
+    _lambda.assign(_n_con, 0.);
+    
+    MAST::DistributedConstraintGradients
+    dfdx(*x, _n_con);
+    
+    std::vector<Real>
+    fvals(_n_con, 0.),
+    df0_local(n_local, 0.);
+    
+    std::vector<bool>
+    eval_grads(_n_con, true);
+    
+    const unsigned int
+    n_rel_change_iters = _dist_feval->n_iters_relative_change();
+    
+    const Real
+    tol = _dist_feval->tolerance();
+    
+    std::vector<Real>
+    f0_iters(n_rel_change_iters, 0.);
+    
+    Real
+    f0 = 0.;
+    
+    for (unsigned int iter=1; ; iter++) {
+        
+        df0->zero();
+        dfdx.zero();
+        std::fill(eval_grads.begin(), eval_grads.end(), true);
+        
+        _dist_feval->timed_evaluate(*x, f0, true, *df0, fvals, eval_grads, dfdx);
+        _dist_feval->output(iter-1, *x, f0, fvals);
+        
+        f0_iters[(iter-1)%n_rel_change_iters] = f0;
+        
+        if (iter > _dist_feval->max_iters()) {
+            libMesh::out
+            << "MMA: Reached maximum iterations, terminating! "
+            << std::endl;
+            break;
+        }
+        
+        // relative change in objective
+        if (iter >= n_rel_change_iters) {
+            
+            bool rel_change_conv = true;
+            
+            for (unsigned int i=0; i<n_rel_change_iters; i++) {
+                if (fabs(f0) > sqrt(tol))
+                    rel_change_conv = (rel_change_conv &&
+                                       fabs(f0_iters[i]-f0)/fabs(f0) < tol);
+                else
+                    rel_change_conv = (rel_change_conv &&
+                                       fabs(f0_iters[i]-f0) < tol);
+            }
+            
+            if (rel_change_conv) {
+                libMesh::out
+                << "MMA: Converged relative change tolerance, terminating! "
+                << std::endl;
+                break;
+            }
+        }
+        
+        for (libMesh::numeric_index_type j=first; j<last; j++)
+            df0_local[j-first] = (*df0)(j);
+        
+        this->_init_subproblem(iter, fvals, df0_local, dfdx);
+        this->_solve_subproblem();
+        
+        _xold2 = _xold1;
+        _xold1 = _x;
+        _x     = _x_sub;
+        
+        for (libMesh::numeric_index_type j=first; j<last; j++)
+            x->set(j, _x[j-first]);
+        x->close();
+    }
+}
+
+
+
+void
+MAST::MMAOptimizationInterface::
+_init_subproblem(unsigned int iter,
+                 const std::vector<Real>& fvals,
+                 const std::vector<Real>& df0,
+                 const MAST::DistributedConstraintGradients& dfdx) {
+    
+    const unsigned int
+    n_local = (unsigned int)_x.size();
+    
+    const Real
+    raa0    = 1.e-5;
+    
+    _low.resize(n_local);
+    _upp.resize(n_local);
+    _alpha.resize(n_local);
+    _beta.resize(n_local);
+    _p0.resize(n_local);
+    _q0.resize(n_local);
+    _pq.resize(n_local);
+    _b.assign(_n_con, 0.);
+    
+    for (unsigned int j=0; j<n_local; j++) {
+        
+        const Real
+        x     = _x[j],
+        range = std::max(_xmax[j] - _xmin[j], 1.e-12);
+        
+        // the asymptotes move away from the design for monotonic
+        // changes of the variable, and towards it for oscillations
+        if (iter <= 2) {
+            
+            _low[j] = x - asymptote_init * range;
+            _upp[j] = x + asymptote_init * range;
+        }
+        else {
+            
+            const Real
+            s     = (x - _xold1[j]) * (_xold1[j] - _xold2[j]);
+            Real
+            gamma = 1.;
+            
+            if (s < 0.)
+                gamma = asymptote_decrease;
+            else if (s > 0.)
+                gamma = asymptote_increase;
+            
+            _low[j] = x - gamma * (_xold1[j] - _low[j]);
+            _upp[j] = x + gamma * (_upp[j] - _xold1[j]);
+            
+            _low[j] = std::max(_low[j], x - 10.  * range);
+            _low[j] = std::min(_low[j], x - 0.01 * range);
+            _upp[j] = std::min(_upp[j], x + 10.  * range);
+            _upp[j] = std::max(_upp[j], x + 0.01 * range);
+        }
+        
+        _alpha[j] = std::max(std::max(_xmin[j], _low[j] + 0.1 * (x - _low[j])),
+                             x - move_limit * range);
+        _beta[j]  = std::min(std::min(_xmax[j], _upp[j] - 0.1 * (_upp[j] - x)),
+                             x + move_limit * range);
+        
+        const Real
+        ux2 = pow(_upp[j] - x, 2),
+        xl2 = pow(x - _low[j], 2),
+        g   = df0[j];
+        
+        _p0[j] = ux2 * (1.001 * std::max(g, 0.) + 0.001 * std::max(-g, 0.) + raa0/range);
+        _q0[j] = xl2 * (0.001 * std::max(g, 0.) + 1.001 * std::max(-g, 0.) + raa0/range);
+        
+        // the constraint coefficients keep the sparsity of the gradients.
+        // Unlike the objective, they do not include the raa0/range term
+        // of Svanberg, which would couple every constraint to every
+        // variable. The objective term alone keeps the subproblem strictly
+        // convex in the variables, since p and q are nonnegative.
+        const std::vector<std::pair<unsigned int, Real> >&
+        entries = dfdx.var_entries(dfdx.first_local_index() + j);
+        
+        _pq[j].resize(entries.size());
+        
+        for (unsigned int k=0; k<entries.size(); k++) {
+            
+            const Real
+            gi = entries[k].second,
+            p  = ux2 * (1.001 * std::max(gi, 0.) + 0.001 * std::max(-gi, 0.)),
+            q  = xl2 * (0.001 * std::max(gi, 0.) + 1.001 * std::max(-gi, 0.));
+            
+            _pq[j][k] = std::make_pair(entries[k].first, std::make_pair(p, q));
+            
+            _b[entries[k].first] += p/(_upp[j] - x) + q/(x - _low[j]);
+        }
+    }
+    
+    dfdx.comm().sum(_b);
+    
+    for (unsigned int i=0; i<_n_con; i++)
+        _b[i] -= fvals[i];
+}
+
+
+
+Real
+MAST::MMAOptimizationInterface::_dual_function(const std::vector<Real>& lambda,
+                                               std::vector<Real>& grad,
+                                               std::vector<Real>* hess) {
+    
+    const unsigned int
+    n_local = (unsigned int)_x.size();
+    
+    _x_sub.resize(n_local);
+    grad.assign(_n_con, 0.);
+    if (hess)
+        hess->assign(_n_con*_n_con, 0.);
+    
+    Real
+    w = 0.;
+    
+    std::vector<Real>
+    a;
+    
+    for (unsigned int j=0; j<n_local; j++) {
+        
+        const std::vector<std::pair<unsigned int, std::pair<Real, Real> > >&
+        pq = _pq[j];
+        
+        Real
+        P = _p0[j],
+        Q = _q0[j];
+        
+        for (unsigned int k=0; k<pq.size(); k++) {
+            P += lambda[pq[k].first] * pq[k].second.first;
+            Q += lambda[pq[k].first] * pq[k].second.second;
+        }
+        
+        // minimizer of P/(U-x) + Q/(x-L) within the bounds
+        const Real
+        sP = sqrt(P),
+        sQ = sqrt(Q);
+        
+        Real
+        x  = (sP * _low[j] + sQ * _upp[j]) / (sP + sQ);
+        
+        const bool
+        if_free = (x > _alpha[j] && x < _beta[j]);
+        
+        x = std::min(std::max(x, _alpha[j]), _beta[j]);
+        _x_sub[j] = x;
+        
+        const Real
+        ux = _upp[j] - x,
+        xl = x - _low[j];
+        
+        w += P/ux + Q/xl;
+        
+        for (unsigned int k=0; k<pq.size(); k++)
+            grad[pq[k].first] += pq[k].second.first/ux + pq[k].second.second/xl;
+        
+        // the Hessian has contributions only from the variables within
+        // their bounds, for which dx/dlambda_i = -a_i/h
+        if (hess && if_free && pq.size()) {
+            
+            const Real
+            h = 2.*P/(ux*ux*ux) + 2.*Q/(xl*xl*xl);
+            
+            a.resize(pq.size());
+            for (unsigned int k=0; k<pq.size(); k++)
+                a[k] = pq[k].second.first/(ux*ux) - pq[k].second.second/(xl*xl);
+            
+            for (unsigned int k=0; k<pq.size(); k++)
+                for (unsigned int l=0; l<pq.size(); l++)
+                    (*hess)[pq[k].first*_n_con + pq[l].first] -= a[k]*a[l]/h;
+        }
+    }
+    
+    _dist_feval->comm().sum(w);
+    _dist_feval->comm().sum(grad);
+    if (hess)
+        _dist_feval->comm().sum(*hess);
+    
+    // the artificial variables minimize c y + y^2/2 - lambda y
+    for (unsigned int i=0; i<_n_con; i++) {
+        
+        const Real
+        y = std::max(0., lambda[i] - constraint_penalty);
+        
+        w       += constraint_penalty * y + 0.5 * y * y - lambda[i] * (y + _b[i]);
+        grad[i] -= y + _b[i];
+        
+        if (hess && y > 0.)
+            (*hess)[i*_n_con + i] -= 1.;
+    }
+    
+    return w;
+}
+
+
+
+void
+MAST::MMAOptimizationInterface::_solve_subproblem() {
+    
+    MAST_LOG_SCOPE("solve_subproblem()", "MMAOptimizationInterface");
+    
+    std::vector<Real>
+    grad,
+    grad_new,
+    hess,
+    lambda_new;
+    
+    Real
+    w = this->_dual_function(_lambda, grad, &hess),
+    b_max = 0.;
+    
+    for (unsigned int i=0; i<_n_con; i++)
+        b_max = std::max(b_max, fabs(_b[i]));
+    
+    for (unsigned int it=0; it<max_dual_iters; it++) {
+        
+        // the multipliers at zero with a negative gradient remain fixed
+        std::vector<unsigned int> free_ids;
+        Real pg_max = 0.;
+        
+        for (unsigned int i=0; i<_n_con; i++)
+            if (_lambda[i] > 0. || grad[i] > 0.) {
+                free_ids.push_back(i);
+                pg_max = std::max(pg_max, fabs(grad[i]));
+            }
+        
+        if (pg_max <= 1.e-10 * (1. + b_max))
+            break;
+        
+        // Newton step for the maximum of the concave dual function
+        const unsigned int
+        n_free = (unsigned int)free_ids.size();
+        
+        RealMatrixX
+        H = RealMatrixX::Zero(n_free, n_free);
+        RealVectorX
+        g = RealVectorX::Zero(n_free);
+        
+        for (unsigned int k=0; k<n_free; k++) {
+            g(k) = grad[free_ids[k]];
+            for (unsigned int l=0; l<n_free; l++)
+                H(k, l) = -hess[free_ids[k]*_n_con + free_ids[l]];
+            H(k, k) += 1.e-10 * (1. + H(k, k));
+        }
+        
+        const RealVectorX
+        dlambda = H.ldlt().solve(g);
+        
+        // backtracking line search on the projected step
+        Real
+        t     = 1.,
+        w_new = 0.;
+        bool
+        accepted = false;
+        
+        // if all variables of a constraint are at their bounds, its
+        // Hessian is only the regularization above, and the first step
+        // can exceed the maximum of the dual by a factor of about 1e10
+        for (unsigned int ls=0; ls<60; ls++) {
+            
+            lambda_new = _lambda;
+            for (unsigned int k=0; k<n_free; k++)
+                lambda_new[free_ids[k]] =
+                std::max(0., _lambda[free_ids[k]] + t * dlambda(k));
+            
+            w_new = this->_dual_function(lambda_new, grad_new, nullptr);
+            
+            if (w_new >= w) {
+                accepted = true;
+                break;
+            }
+            
+            t *= 0.5;
+        }
+        
+        if (!accepted)
+            break;
+        
+        _lambda = lambda_new;
+        w = this->_dual_function(_lambda, grad, &hess);
+    }
+    
+    // the subproblem solution for the final multipliers
+    this->_dual_function(_lambda, grad, nullptr);
+}
+
@@ -0,0 +1,168 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2017  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef __MAST_mma_optimization_interface_h__
+#define __MAST_mma_optimization_interface_h__
+
+// C++ includes
+#include <vector>
+
+
+// MAST includes
+#include "optimization/optimization_interface.h"
+
+
+namespace MAST {
+    
+    // Forward declerations
+    class DistributedFunctionEvaluation;
+    class DistributedConstraintGradients;
+    
+    
+    /*!
+     *   Method of moving asymptotes (MMA) of Svanberg for problems with a
+     *   large number of design variables and inequality constraints
+     *   \f$ f_i(x) \le 0 \f$. The design variables and the objective
+     *   gradient are distributed vectors, and the constraint gradients
+     *   are sparse and distributed with the design variables (see
+     *   MAST::DistributedFunctionEvaluation). The subproblem is solved
+     *   through its dual, which is a function of one multiplier per
+     *   constraint, with a projected Newton method. Only the multipliers
+     *   and the dual Hessian of the size of the number of constraints are
+     *   replicated on all ranks. Each constraint has an artificial
+     *   variable \f$ y_i \ge 0 \f$ with the cost
+     *   \f$ c y_i + y_i^2/2 \f$, so that the subproblem is always feasible.
+     *   The iterations terminate with the maximum number of iterations,
+     *   or with the relative change of the objective of the function
+     *   evaluation.
+     */
+    class MMAOptimizationInterface:
+    public MAST::OptimizationInterface {
+        
+    public:
+        
+        MMAOptimizationInterface();
+        
+        virtual ~MMAOptimizationInterface();
+        
+        virtual void optimize();
+        
+        /*!
+         *   initial distance of the asymptotes from the design, relative
+         *   to the range of the design variables
+         */
+        Real asymptote_init;
+        
+        /*!
+         *   factors by which the distance of the asymptotes is reduced for
+         *   oscillating and increased for monotonic design variables
+         */
+        Real asymptote_decrease;
+        
+        Real asymptote_increase;
+        
+        /*!
+         *   maximum change of a design variable in an iteration, relative
+         *   to its range
+         */
+        Real move_limit;
+        
+        /*!
+         *   cost of the artificial variables of the constraints
+         */
+        Real constraint_penalty;
+        
+        /*!
+         *   maximum number of iterations of the dual subproblem
+         */
+        unsigned int max_dual_iters;
+        
+    protected:
+        
+        /*!
+         *   computes the asymptotes, the bounds and the coefficients of
+         *   the subproblem at iteration \p iter from the current design
+         *   in \p _x and the function values and gradients
+         */
+        void _init_subproblem(unsigned int iter,
+                              const std::vector<Real>& fvals,
+                              const std::vector<Real>& df0,
+                              const MAST::DistributedConstraintGradients& dfdx);
+        
+        
+        /*!
+         *   solves the dual of the subproblem, starting with the
+         *   multipliers \p _lambda, and sets the solution in \p _x_sub
+         */
+        void _solve_subproblem();
+        
+        
+        /*!
+         *   computes the solution of the subproblem in \p _x_sub for the
+         *   multipliers \p lambda, and @returns the dual function. The
+         *   gradient is computed in \p grad, and the Hessian in \p hess
+         *   (row major), if provided.
+         */
+        Real _dual_function(const std::vector<Real>& lambda,
+                            std::vector<Real>& grad,
+                            std::vector<Real>* hess);
+        
+        
+        /*!
+         *   function evaluation
+         */
+        MAST::DistributedFunctionEvaluation*   _dist_feval;
+        
+        /*!
+         *   number of constraints
+         */
+        unsigned int                           _n_con;
+        
+        /*!
+         *   local values of the design, the designs of the previous two
+         *   iterations, the bounds and the subproblem solution
+         */
+        std::vector<Real>  _x, _xold1, _xold2, _xmin, _xmax, _x_sub;
+        
+        /*!
+         *   local values of the asymptotes and of the bounds of the
+         *   subproblem
+         */
+        std::vector<Real>  _low, _upp, _alpha, _beta;
+        
+        /*!
+         *   local coefficients of the objective in the subproblem
+         */
+        std::vector<Real>  _p0, _q0;
+        
+        /*!
+         *   local nonzero coefficients of the constraints in the
+         *   subproblem for each design variable, with the constraint id
+         */
+        std::vector<std::vector<std::pair<unsigned int, std::pair<Real, Real> > > > _pq;
+        
+        /*!
+         *   right hand side of the constraints in the subproblem, and the
+         *   multipliers of the constraints
+         */
+        std::vector<Real>  _b, _lambda;
+    };
+}
+
+#endif // __MAST_mma_optimization_interface_h__
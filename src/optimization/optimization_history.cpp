@@ -0,0 +1,316 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2017  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+// C++ includes
+#include <cstring>
+
+// MAST includes
+#include "optimization/optimization_history.h"
+
+
+namespace MAST {
+    
+    static const char         history_magic[8] = {'M','A','S','T','O','P','T','H'};
+    static const unsigned int history_version  = 1;
+}
+
+
+
+MAST::OptimizationHistory::
+OptimizationHistory(const libMesh::Parallel::Communicator& comm):
+libMesh::ParallelObject(comm),
+_n_vars(0),
+_n_fvals(0),
+_t_phase(std::chrono::steady_clock::now()),
+_t_record(_t_phase) {
+    
+    for (unsigned int i=0; i<N_PHASES; i++)
+        _time[i] = 0.;
+}
+
+
+
+MAST::OptimizationHistory::~OptimizationHistory() {
+    
+    this->close();
+}
+
+
+
+void
+MAST::OptimizationHistory::open(const std::string& nm,
+                                unsigned int n_vars,
+                                unsigned int n_fvals,
+                                bool append) {
+    
+    this->close();
+    
+    _n_vars  = n_vars;
+    _n_fvals = n_fvals;
+    
+    _phases.clear();
+    for (unsigned int i=0; i<N_PHASES; i++)
+        _time[i] = 0.;
+    _t_phase  = std::chrono::steady_clock::now();
+    _t_record = _t_phase;
+    
+    if (this->comm().rank())
+        return;
+    
+    bool if_header = true;
+    
+    if (append) {
+        
+        std::ifstream in(nm.c_str(), std::ios::in | std::ios::binary);
+        
+        if (in.good()) {
+            
+            char         magic[8];
+            unsigned int vals[3];
+            in.read(magic, 8);
+            in.read((char*)vals, 3*sizeof(unsigned int));
+            
+            if (!in.good() ||
+                std::memcmp(magic, MAST::history_magic, 8) ||
+                vals[0] != MAST::history_version ||
+                vals[1] != n_vars ||
+                vals[2] != n_fvals)
+                libmesh_error_msg("Incompatible optimization history file: " << nm);
+            
+            if_header = false;
+        }
+    }
+    
+    _file.open(nm.c_str(),
+               std::ios::out | std::ios::binary |
+               (if_header ? std::ios::trunc : std::ios::app));
+    
+    if (!_file.good())
+        libmesh_error_msg("Unable to open file: " << nm);
+    
+    if (if_header) {
+        
+        _file.write(MAST::history_magic, 8);
+        _file.write((const char*)&MAST::history_version, sizeof(unsigned int));
+        _file.write((const char*)&_n_vars,  sizeof(unsigned int));
+        _file.write((const char*)&_n_fvals, sizeof(unsigned int));
+        _file.flush();
+    }
+}
+
+
+
+void
+MAST::OptimizationHistory::close() {
+    
+    if (_file.is_open())
+        _file.close();
+}
+
+
+
+void
+MAST::OptimizationHistory::start_phase(MAST::OptimizationHistory::Phase p) {
+    
+    libmesh_assert_less(p, N_PHASES);
+    
+    this->_update_phase_time();
+    _phases.push_back(p);
+}
+
+
+
+void
+MAST::OptimizationHistory::stop_phase(MAST::OptimizationHistory::Phase p) {
+    
+    libmesh_assert(_phases.size());
+    libmesh_assert_equal_to(_phases.back(), p);
+    
+    this->_update_phase_time();
+    _phases.pop_back();
+}
+
+
+
+void
+MAST::OptimizationHistory::_update_phase_time() {
+    
+    const std::chrono::steady_clock::time_point
+    t = std::chrono::steady_clock::now();
+    
+    if (_phases.size())
+        _time[_phases.back()] +=
+        std::chrono::duration<Real>(t - _t_phase).count();
+    
+    _t_phase = t;
+}
+
+
+
+void
+MAST::OptimizationHistory::write_record(unsigned int iter,
+                                        const std::vector<Real>& x,
+                                        Real obj,
+                                        const std::vector<Real>& fvals,
+                                        Real obj_grad_norm,
+                                        Real con_grad_norm) {
+    
+    this->_write(iter, x, obj, fvals, obj_grad_norm, con_grad_norm);
+}
+
+
+
+void
+MAST::OptimizationHistory::write_record(unsigned int iter,
+                                        const libMesh::NumericVector<Real>& x,
+                                        Real obj,
+                                        const std::vector<Real>& fvals,
+                                        Real obj_grad_norm,
+                                        Real con_grad_norm) {
+    
+    std::vector<Real> vals;
+    x.localize_to_one(vals, 0);
+    
+    this->_write(iter, vals, obj, fvals, obj_grad_norm, con_grad_norm);
+}
+
+
+
+void
+MAST::OptimizationHistory::_write(unsigned int iter,
+                                  const std::vector<Real>& x,
+                                  Real obj,
+                                  const std::vector<Real>& fvals,
+                                  Real obj_grad_norm,
+                                  Real con_grad_norm) {
+    
+    this->_update_phase_time();
+    
+    const std::chrono::steady_clock::time_point
+    t = std::chrono::steady_clock::now();
+    
+    // the time that was not spent in the analysis is attributed to the
+    // optimizer
+    Real
+    t_opt = std::chrono::duration<Real>(t - _t_record).count()
+    - _time[ANALYSIS] - _time[SENSITIVITY];
+    _time[OPTIMIZER] = std::max(_time[OPTIMIZER], t_opt);
+    
+    if (!this->comm().rank() && _file.is_open()) {
+        
+        libmesh_assert_equal_to(x.size(),     _n_vars);
+        libmesh_assert_equal_to(fvals.size(), _n_fvals);
+        
+        _file.write((const char*)&iter,          sizeof(unsigned int));
+        _file.write((const char*)&obj,           sizeof(Real));
+        _file.write((const char*)&obj_grad_norm, sizeof(Real));
+        _file.write((const char*)&con_grad_norm, sizeof(Real));
+        _file.write((const char*)_time,          N_PHASES*sizeof(Real));
+        if (_n_vars)
+            _file.write((const char*)&x[0],      _n_vars*sizeof(Real));
+        if (_n_fvals)
+            _file.write((const char*)&fvals[0],  _n_fvals*sizeof(Real));
+        _file.flush();
+    }
+    
+    for (unsigned int i=0; i<N_PHASES; i++)
+        _time[i] = 0.;
+    _t_record = t;
+}
+
+
+
+std::streamoff
+MAST::OptimizationHistory::_header_size() {
+    
+    return 8 + 3*sizeof(unsigned int);
+}
+
+
+
+std::streamoff
+MAST::OptimizationHistory::_record_size(unsigned int n_vars,
+                                        unsigned int n_fvals) {
+    
+    return
+    sizeof(unsigned int) +
+    (3 + N_PHASES + (std::streamoff)n_vars + n_fvals) * sizeof(Real);
+}
+
+
+
+unsigned int
+MAST::OptimizationHistory::n_records(const std::string& nm) {
+    
+    std::ifstream in(nm.c_str(), std::ios::in | std::ios::binary);
+    
+    char         magic[8];
+    unsigned int vals[3];
+    in.read(magic, 8);
+    in.read((char*)vals, 3*sizeof(unsigned int));
+    
+    if (!in.good() || std::memcmp(magic, MAST::history_magic, 8))
+        libmesh_error_msg("Invalid optimization history file: " << nm);
+    
+    in.seekg(0, std::ios::end);
+    
+    return (unsigned int)((in.tellg() - _header_size()) /
+                          _record_size(vals[1], vals[2]));
+}
+
+
+
+void
+MAST::OptimizationHistory::read_record(const std::string& nm,
+                                       unsigned int i,
+                                       MAST::OptimizationHistory::Record& r) {
+    
+    std::ifstream in(nm.c_str(), std::ios::in | std::ios::binary);
+    
+    char         magic[8];
+    unsigned int vals[3];
+    in.read(magic, 8);
+    in.read((char*)vals, 3*sizeof(unsigned int));
+    
+    if (!in.good() || std::memcmp(magic, MAST::history_magic, 8))
+        libmesh_error_msg("Invalid optimization history file: " << nm);
+    
+    const unsigned int
+    n_vars  = vals[1],
+    n_fvals = vals[2];
+    
+    in.seekg(_header_size() + i * _record_size(n_vars, n_fvals));
+    
+    r.x.resize(n_vars);
+    r.fvals.resize(n_fvals);
+    
+    in.read((char*)&r.iter,          sizeof(unsigned int));
+    in.read((char*)&r.obj,           sizeof(Real));
+    in.read((char*)&r.obj_grad_norm, sizeof(Real));
+    in.read((char*)&r.con_grad_norm, sizeof(Real));
+    in.read((char*)r.time,           N_PHASES*sizeof(Real));
+    if (n_vars)
+        in.read((char*)&r.x[0],      n_vars*sizeof(Real));
+    if (n_fvals)
+        in.read((char*)&r.fvals[0],  n_fvals*sizeof(Real));
+    
+    if (!in.good())
+        libmesh_error_msg("Record " << i << " not found in file: " << nm);
+}
+
@@ -0,0 +1,231 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2017  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef __mast__optimization_history_h__
+#define __mast__optimization_history_h__
+
+// C++ includes
+#include <string>
+#include <vector>
+#include <fstream>
+#include <chrono>
+
+
+// MAST includes
+#include "base/mast_data_types.h"
+
+
+// libMesh includes
+#include "libmesh/parallel_object.h"
+#include "libmesh/numeric_vector.h"
+
+
+namespace MAST {
+    
+    /*!
+     *   Binary history of the iterations of an optimization, written by
+     *   processor 0. The file starts with a header of the 8 characters
+     *   \p MASTOPTH, followed by the format version, the number of design
+     *   variables, and the number of constraints as \p unsigned \p int. Each
+     *   iteration is then stored as a record of fixed size with
+     *    - the iteration number as \p unsigned \p int,
+     *    - the objective, the norms of the objective and of the constraint
+     *      gradients (zero if not computed), and the wall time in seconds
+     *      spent in the analysis, the sensitivity analysis, and the
+     *      optimizer as Reals,
+     *    - the design variables and the constraints as Reals.
+     *
+     *   Since the records have a fixed size, any iteration can be read
+     *   with read_record() without reading the file, for example to
+     *   restart from a design. The file is flushed after each record.
+     *
+     *   The time of an iteration is measured with start_phase() and
+     *   stop_phase(). Phases can be nested, in which case the enclosing
+     *   phase is paused, and the time not spent in the analysis or the
+     *   sensitivity analysis between two records is attributed to the
+     *   optimizer.
+     */
+    class OptimizationHistory:
+    public libMesh::ParallelObject {
+        
+    public:
+        
+        /*!
+         *   phases of an iteration
+         */
+        enum Phase {
+            ANALYSIS,
+            SENSITIVITY,
+            OPTIMIZER,
+            N_PHASES
+        };
+        
+        
+        /*!
+         *   data of an iteration
+         */
+        struct Record {
+            
+            Record(): iter(0), obj(0.), obj_grad_norm(0.), con_grad_norm(0.) {
+                for (unsigned int i=0; i<N_PHASES; i++) time[i] = 0.;
+            }
+            
+            unsigned int       iter;
+            Real               obj;
+            Real               obj_grad_norm;
+            Real               con_grad_norm;
+            Real               time[N_PHASES];
+            std::vector<Real>  x;
+            std::vector<Real>  fvals;
+        };
+        
+        
+        OptimizationHistory(const libMesh::Parallel::Communicator& comm);
+        
+        virtual ~OptimizationHistory();
+        
+        
+        /*!
+         *   opens the history file \p nm for \p n_vars design variables and
+         *   \p n_fvals constraints. If \p append is true and the file
+         *   exists, the records are added at the end of the file, which
+         *   must have been written for the same problem size.
+         */
+        void open(const std::string& nm,
+                  unsigned int n_vars,
+                  unsigned int n_fvals,
+                  bool append = false);
+        
+        
+        /*!
+         *   closes the file
+         */
+        void close();
+        
+        
+        /*!
+         *   starts measuring the time of phase \p p. The current phase, if
+         *   any, is paused until \p p is stopped.
+         */
+        void start_phase(MAST::OptimizationHistory::Phase p);
+        
+        
+        /*!
+         *   stops measuring the time of phase \p p, which must be the last
+         *   started phase
+         */
+        void stop_phase(MAST::OptimizationHistory::Phase p);
+        
+        
+        /*!
+         *   writes a record with design variables \p x replicated on all
+         *   ranks, and resets the phase times
+         */
+        void write_record(unsigned int iter,
+                          const std::vector<Real>& x,
+                          Real obj,
+                          const std::vector<Real>& fvals,
+                          Real obj_grad_norm,
+                          Real con_grad_norm);
+        
+        
+        /*!
+         *   writes a record with distributed design variables \p x. This
+         *   must be called on all ranks.
+         */
+        void write_record(unsigned int iter,
+                          const libMesh::NumericVector<Real>& x,
+                          Real obj,
+                          const std::vector<Real>& fvals,
+                          Real obj_grad_norm,
+                          Real con_grad_norm);
+        
+        
+        /*!
+         *   @returns the number of records in the history file \p nm
+         */
+        static unsigned int n_records(const std::string& nm);
+        
+        
+        /*!
+         *   reads the i^th record of the history file \p nm to \p r
+         */
+        static void read_record(const std::string& nm,
+                                unsigned int i,
+                                MAST::OptimizationHistory::Record& r);
+        
+    protected:
+        
+        /*!
+         *   adds the time since the last change of phase to the current
+         *   phase
+         */
+        void _update_phase_time();
+        
+        
+        /*!
+         *   writes the record on processor 0
+         */
+        void _write(unsigned int iter,
+                    const std::vector<Real>& x,
+                    Real obj,
+                    const std::vector<Real>& fvals,
+                    Real obj_grad_norm,
+                    Real con_grad_norm);
+        
+        /*!
+         *   size of the header and of a record in bytes
+         */
+        static std::streamoff _header_size();
+        
+        static std::streamoff _record_size(unsigned int n_vars,
+                                           unsigned int n_fvals);
+        
+        /*!
+         *   history file
+         */
+        std::ofstream                           _file;
+        
+        /*!
+         *   problem size of the file
+         */
+        unsigned int                            _n_vars;
+        
+        unsigned int                            _n_fvals;
+        
+        /*!
+         *   times of the phases of the current iteration
+         */
+        Real                                    _time[N_PHASES];
+        
+        /*!
+         *   started phases, with the current phase last
+         */
+        std::vector<MAST::OptimizationHistory::Phase> _phases;
+        
+        /*!
+         *   time of the last change of phase, and of the last record
+         */
+        std::chrono::steady_clock::time_point   _t_phase;
+        
+        std::chrono::steady_clock::time_point   _t_record;
+    };
+}
+
+#endif // __mast__optimization_history_h__
@@ -44,6 +44,34 @@ namespace MAST
     };
     
     
+    /*!
+     *   quadrature scheme used for the strain energy of the element.
+     *   With \p REDUCED_INTEGRATION, a HEX8 element uses a single
+     *   quadrature point along with hourglass stabilization.
+     */
+    enum IntegrationScheme {
+        FULL_INTEGRATION,
+        REDUCED_INTEGRATION
+    };
+    
+    
+    /*!
+     *   scheme used to obtain the diagonal mass matrix of the element.
+     *   \p NODAL_VOLUME_LUMPING distributes the element volume equally
+     *   to the nodes, with the inertia evaluated at the first quadrature
+     *   point. \p ROW_SUM_LUMPING uses the sum of each row of the 
+     *   consistent mass matrix. \p HRZ_LUMPING (Hinton, Rock and 
+     *   Zienkiewicz) scales the diagonal of the consistent mass matrix of
+     *   each variable to preserve its total mass, which keeps the entries
+     *   positive for higher order elements.
+     */
+    enum MassLumpingScheme {
+        NODAL_VOLUME_LUMPING,
+        ROW_SUM_LUMPING,
+        HRZ_LUMPING
+    };
+    
+    
     
     class ElementPropertyCardBase:
     public MAST::FunctionSetBase {
@@ -52,7 +80,11 @@ namespace MAST
         ElementPropertyCardBase():
         MAST::FunctionSetBase(),
         _strain_type(MAST::LINEAR_STRAIN),
-        _diagonal_mass(false)
+        _diagonal_mass(false),
+        _mass_lumping(MAST::NODAL_VOLUME_LUMPING),
+        _integration_scheme(MAST::FULL_INTEGRATION),
+        _hourglass_coefficient(0.1),
+        _shear_quadrature_reduction(2)
         { }
         
         /*!
@@ -169,6 +201,78 @@ namespace MAST
         }
         
         
+        /*!
+         *    sets the scheme used for the diagonal mass matrix. This is
+         *    NODAL_VOLUME_LUMPING by default, and is used only if the
+         *    diagonal mass matrix is requested.
+         */
+        void set_mass_lumping_scheme(MAST::MassLumpingScheme s) {
+            _mass_lumping = s;
+        }
+        
+        
+        /*!
+         *    @returns the scheme used for the diagonal mass matrix
+         */
+        MAST::MassLumpingScheme mass_lumping_scheme() const {
+            return _mass_lumping;
+        }
+        
+        
+        /*!
+         *    sets the quadrature scheme used for the strain energy of the
+         *    element. This is FULL_INTEGRATION by default.
+         */
+        void set_integration_scheme(MAST::IntegrationScheme s) {
+            _integration_scheme = s;
+        }
+        
+        
+        /*!
+         *    @returns the quadrature scheme used for the strain energy
+         */
+        MAST::IntegrationScheme integration_scheme() const {
+            return _integration_scheme;
+        }
+        
+        
+        /*!
+         *    sets the coefficient of the hourglass stabilization stiffness
+         *    used with REDUCED_INTEGRATION. This is 0.1 by default.
+         */
+        void set_hourglass_coefficient(Real c) {
+            _hourglass_coefficient = c;
+        }
+        
+        
+        /*!
+         *    @returns the coefficient of the hourglass stabilization stiffness
+         */
+        Real hourglass_coefficient() const {
+            return _hourglass_coefficient;
+        }
+        
+        
+        /*!
+         *    sets the reduction in quadrature order, with respect to the
+         *    rest of the element, for integration of the transverse shear
+         *    energy of Mindlin and Timoshenko elements. This is 2 by
+         *    default, which is the selective reduced integration of shear.
+         *    A value of 0 uses the full quadrature.
+         */
+        void set_transverse_shear_quadrature_reduction(unsigned int n) {
+            _shear_quadrature_reduction = n;
+        }
+        
+        
+        /*!
+         *    @returns the reduction in quadrature order for transverse shear
+         */
+        unsigned int transverse_shear_quadrature_reduction() const {
+            return _shear_quadrature_reduction;
+        }
+        
+        
         /*!
          *    @returns true if the element prestress has been specified, false
          *    otherwise
@@ -189,6 +293,26 @@ namespace MAST
          *    flag to use a diagonal mass matrix. By default, this is false
          */
         bool _diagonal_mass;
+        
+        /*!
+         *    scheme for the diagonal mass matrix
+         */
+        MAST::MassLumpingScheme _mass_lumping;
+        
+        /*!
+         *    quadrature scheme for the strain energy
+         */
+        MAST::IntegrationScheme _integration_scheme;
+        
+        /*!
+         *    coefficient of the hourglass stabilization stiffness
+         */
+        Real _hourglass_coefficient;
+        
+        /*!
+         *    reduction in quadrature order for transverse shear energy
+         */
+        unsigned int _shear_quadrature_reduction;
     };
     
 }
@@ -36,6 +36,10 @@ namespace MAST {
             
             virtual ~StiffnessMatrix1D() { }
             
+            virtual bool is_constant() const {
+                return _if_dependent_functions_constant();
+            }
+            
             virtual void operator() (const libMesh::Point& p,
                                      const Real t,
                                      RealMatrixX& m) const;
@@ -62,6 +66,10 @@ namespace MAST {
             
             virtual ~TransverseShearStiffnessMatrix() { }
             
+            virtual bool is_constant() const {
+                return _if_dependent_functions_constant();
+            }
+            
             virtual void operator() (const libMesh::Point& p,
                                      const Real t,
                                      RealMatrixX& m) const;
@@ -88,6 +96,10 @@ namespace MAST {
             
             virtual ~StiffnessMatrix2D() { }
             
+            virtual bool is_constant() const {
+                return _if_dependent_functions_constant();
+            }
+            
             
             virtual void operator() (const libMesh::Point& p,
                                      const Real t,
@@ -114,6 +126,10 @@ namespace MAST {
             
             virtual ~StiffnessMatrix3D() { }
             
+            virtual bool is_constant() const {
+                return _if_dependent_functions_constant();
+            }
+            
             virtual void operator() (const libMesh::Point& p,
                                      const Real t,
                                      RealMatrixX& m) const;
@@ -123,8 +139,21 @@ namespace MAST {
                                     const Real t,
                                     RealMatrixX& m) const;
             
+            /*!
+             *   evaluates E and nu for all points with one call each, and
+             *   computes the matrix once for points with the same values
+             */
+            virtual void operator() (const std::vector<libMesh::Point>& pts,
+                                     const Real t,
+                                     std::vector<RealMatrixX>& m) const;
+            
         protected:
             
+            /*!
+             *   computes the matrix for \p E and \p nu
+             */
+            static void _matrix(Real E, Real nu, RealMatrixX& m);
+            
             const MAST::FieldFunction<Real>& _E;
             const MAST::FieldFunction<Real>& _nu;
         };
@@ -138,6 +167,10 @@ namespace MAST {
 
             virtual ~InertiaMatrix3D() { }
             
+            virtual bool is_constant() const {
+                return _if_dependent_functions_constant();
+            }
+            
             virtual void operator() (const libMesh::Point& p,
                                      const Real t,
                                      RealMatrixX& m) const;
@@ -169,6 +202,10 @@ namespace MAST {
 
             virtual ~ThermalExpansionMatrix() { }
             
+            virtual bool is_constant() const {
+                return _if_dependent_functions_constant();
+            }
+            
             virtual void operator() (const libMesh::Point& p,
                                      const Real t,
                                      RealMatrixX& m) const;
@@ -203,6 +240,10 @@ namespace MAST {
             
             virtual ~ThermalConductanceMatrix() { }
             
+            virtual bool is_constant() const {
+                return _if_dependent_functions_constant();
+            }
+            
             virtual void operator() (const libMesh::Point& p,
                                      const Real t,
                                      RealMatrixX& m) const;
@@ -240,6 +281,10 @@ namespace MAST {
             
             virtual ~ThermalCapacitanceMatrix() { }
             
+            virtual bool is_constant() const {
+                return _if_dependent_functions_constant();
+            }
+            
             virtual void operator() (const libMesh::Point& p,
                                      const Real t,
                                      RealMatrixX& m) const;
@@ -482,9 +527,43 @@ MAST::IsotropicMaterialProperty::
 StiffnessMatrix3D::operator() (const libMesh::Point& p,
                                const Real t,
                                RealMatrixX& m) const {
-    m = RealMatrixX::Zero(6,6);
     Real E, nu;
     _E(p, t, E); _nu(p, t, nu);
+    _matrix(E, nu, m);
+}
+
+
+
+
+void
+MAST::IsotropicMaterialProperty::
+StiffnessMatrix3D::operator() (const std::vector<libMesh::Point>& pts,
+                               const Real t,
+                               std::vector<RealMatrixX>& m) const {
+    
+    std::vector<Real> E, nu;
+    _E (pts, t, E);
+    _nu(pts, t, nu);
+    
+    m.resize(pts.size());
+    
+    for (unsigned int i=0; i<pts.size(); i++) {
+        
+        if (i && E[i] == E[i-1] && nu[i] == nu[i-1])
+            m[i] = m[i-1];
+        else
+            _matrix(E[i], nu[i], m[i]);
+    }
+}
+
+
+
+
+void
+MAST::IsotropicMaterialProperty::
+StiffnessMatrix3D::_matrix(Real E, Real nu, RealMatrixX& m) {
+    
+    m = RealMatrixX::Zero(6,6);
     for (unsigned int i=0; i<3; i++) {
         for (unsigned int j=0; j<3; j++)
             if (i == j) // diagonal: direct stress
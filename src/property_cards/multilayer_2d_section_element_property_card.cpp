@@ -22,6 +22,7 @@
 #include "property_cards/multilayer_2d_section_element_property_card.h"
 #include "property_cards/solid_2d_section_element_property_card.h"
 #include "base/field_function_base.h"
+#include "base/parameter.h"
 
 
 namespace MAST {
@@ -100,12 +101,22 @@ namespace MAST {
         
         class Matrix: public MAST::FieldFunction<RealMatrixX> {
         public:
-            Matrix(std::vector<MAST::FieldFunction<RealMatrixX>*>& layer_mats):
+            Matrix(std::vector<MAST::FieldFunction<RealMatrixX>*>& layer_mats,
+                   const MAST::Multilayer2DSectionElementPropertyCard& card,
+                   MAST::Multilayer2DSectionElementPropertyCard::LaminateQuantity q):
             MAST::FieldFunction<RealMatrixX>("Matrix2D"),
-            _layer_mats(layer_mats) {
+            _layer_mats(layer_mats),
+            _card(card),
+            _quantity(q),
+            _constant(false) {
                 for (unsigned int i=0; i < _layer_mats.size(); i++) {
                     _functions.insert(_layer_mats[i]);
                 }
+                
+                if (_quantity != MAST::Multilayer2DSectionElementPropertyCard::N_LAMINATE_QUANTITIES) {
+                    _constant = _if_dependent_functions_constant();
+                    _card._add_laminate_parameters(*this);
+                }
             }
             
             
@@ -115,9 +126,25 @@ namespace MAST {
                     delete _layer_mats[i];
             }
             
+            virtual bool is_constant() const {
+                return _if_dependent_functions_constant();
+            }
+            
             virtual void operator() (const libMesh::Point& p,
                                      const Real t,
                                      RealMatrixX& m) const {
+                
+                const bool
+                cache = _card.if_laminate_cache() &&
+                _quantity != MAST::Multilayer2DSectionElementPropertyCard::N_LAMINATE_QUANTITIES;
+                const std::pair<libMesh::Point, Real>
+                key = _constant?
+                std::make_pair(libMesh::Point(), 0.): std::make_pair(p, t);
+                
+                if (cache &&
+                    _card._get_laminate_value(_quantity, nullptr, key, m))
+                    return;
+                
                 // add the values of each matrix to get the integrated value
                 RealMatrixX mi;
                 for (unsigned int i=0; i<_layer_mats.size(); i++) {
@@ -129,6 +156,9 @@ namespace MAST {
                     
                     m += mi;
                 }
+                
+                if (cache)
+                    _card._set_laminate_value(_quantity, nullptr, key, m);
             }
             
             
@@ -136,7 +166,20 @@ namespace MAST {
                                 const libMesh::Point& p,
                                 const Real t,
                                 RealMatrixX& m) const {
-                // add the values of each matrix to get the integrated value
+                
+                const bool
+                cache = _card.if_laminate_cache() &&
+                _quantity != MAST::Multilayer2DSectionElementPropertyCard::N_LAMINATE_QUANTITIES;
+                const std::pair<libMesh::Point, Real>
+                key = _constant?
+                std::make_pair(libMesh::Point(), 0.): std::make_pair(p, t);
+                
+                if (cache &&
+                    _card._get_laminate_value(_quantity, &f, key, m))
+                    return;
+                
+                // add the values of each matrix to get the integrated value.
+                // Layers that do not depend on f do not contribute.
                 RealMatrixX mi;
                 m = RealMatrixX::Zero(2,2);
                 for (unsigned int i=0; i<_layer_mats.size(); i++) {
@@ -148,12 +191,25 @@ namespace MAST {
                     
                     m += mi;
                 }
+                
+                if (cache)
+                    _card._set_laminate_value(_quantity, &f, key, m);
             }
             
             
         protected:
             
             std::vector<MAST::FieldFunction<RealMatrixX>*> _layer_mats;
+            
+            const MAST::Multilayer2DSectionElementPropertyCard& _card;
+            
+            const MAST::Multilayer2DSectionElementPropertyCard::LaminateQuantity _quantity;
+            
+            /*!
+             *   \p true if the layer matrices do not depend on location 
+             *   and time, in which case a single value is stored
+             */
+            bool _constant;
         };
         
         
@@ -250,7 +306,7 @@ MAST::Multilayer2DSectionElementPropertyCard::depends_on(const MAST::FunctionBas
 
 std::auto_ptr<MAST::FieldFunction<RealMatrixX> >
 MAST::Multilayer2DSectionElementPropertyCard::
-stiffness_A_matrix(const MAST::ElementBase& e) {
+stiffness_A_matrix(const MAST::ElementBase& e) const {
     
     // prepare vector of matrix functions from each layer
     std::vector<MAST::FieldFunction<RealMatrixX>*> layer_mats(_layers.size());
@@ -258,17 +314,14 @@ stiffness_A_matrix(const MAST::ElementBase& e) {
         layer_mats[i] = _layers[i]->stiffness_A_matrix(e).release();
     
     // now create the integrated object
-    std::auto_ptr<MAST::FieldFunction<RealMatrixX> > rval
-    (new MAST::Multilayer2DSectionProperty::Matrix(layer_mats));
-    
-    return rval;
+    return _laminate_matrix(layer_mats, LAMINATE_A);
 }
 
 
 
 std::auto_ptr<MAST::FieldFunction<RealMatrixX> >
 MAST::Multilayer2DSectionElementPropertyCard::
-stiffness_B_matrix(const MAST::ElementBase& e) {
+stiffness_B_matrix(const MAST::ElementBase& e) const {
     
     // prepare vector of matrix functions from each layer
     std::vector<MAST::FieldFunction<RealMatrixX>*> layer_mats(_layers.size());
@@ -276,10 +329,7 @@ stiffness_B_matrix(const MAST::ElementBase& e) {
         layer_mats[i] = _layers[i]->stiffness_B_matrix(e).release();
     
     // now create the integrated object
-    std::auto_ptr<MAST::FieldFunction<RealMatrixX> > rval
-    (new MAST::Multilayer2DSectionProperty::Matrix(layer_mats));
-    
-    return rval;
+    return _laminate_matrix(layer_mats, LAMINATE_B);
 }
 
 
@@ -287,7 +337,7 @@ stiffness_B_matrix(const MAST::ElementBase& e) {
 
 std::auto_ptr<MAST::FieldFunction<RealMatrixX> >
 MAST::Multilayer2DSectionElementPropertyCard::
-stiffness_D_matrix(const MAST::ElementBase& e) {
+stiffness_D_matrix(const MAST::ElementBase& e) const {
     
     // prepare vector of matrix functions from each layer
     std::vector<MAST::FieldFunction<RealMatrixX>*> layer_mats(_layers.size());
@@ -295,17 +345,14 @@ stiffness_D_matrix(const MAST::ElementBase& e) {
         layer_mats[i] = _layers[i]->stiffness_D_matrix(e).release();
     
     // now create the integrated object
-    std::auto_ptr<MAST::FieldFunction<RealMatrixX> > rval
-    (new MAST::Multilayer2DSectionProperty::Matrix(layer_mats));
-    
-    return rval;
+    return _laminate_matrix(layer_mats, LAMINATE_D);
 }
 
 
 
 std::auto_ptr<MAST::FieldFunction<RealMatrixX> >
 MAST::Multilayer2DSectionElementPropertyCard::
-damping_matrix(const MAST::ElementBase& e) {
+damping_matrix(const MAST::ElementBase& e) const {
     
     // prepare vector of matrix functions from each layer
     std::vector<MAST::FieldFunction<RealMatrixX>*> layer_mats(_layers.size());
@@ -313,17 +360,14 @@ damping_matrix(const MAST::ElementBase& e) {
         layer_mats[i] = _layers[i]->damping_matrix(e).release();
     
     // now create the integrated object
-    std::auto_ptr<MAST::FieldFunction<RealMatrixX> > rval
-    (new MAST::Multilayer2DSectionProperty::Matrix(layer_mats));
-    
-    return rval;
+    return _laminate_matrix(layer_mats, N_LAMINATE_QUANTITIES);
 }
 
 
 
 std::auto_ptr<MAST::FieldFunction<RealMatrixX> >
 MAST::Multilayer2DSectionElementPropertyCard::
-inertia_matrix(const MAST::ElementBase& e) {
+inertia_matrix(const MAST::ElementBase& e) const {
     
     // prepare vector of matrix functions from each layer
     std::vector<MAST::FieldFunction<RealMatrixX>*> layer_mats(_layers.size());
@@ -331,17 +375,14 @@ inertia_matrix(const MAST::ElementBase& e) {
         layer_mats[i] = _layers[i]->inertia_matrix(e).release();
     
     // now create the integrated object
-    std::auto_ptr<MAST::FieldFunction<RealMatrixX> > rval
-    (new MAST::Multilayer2DSectionProperty::Matrix(layer_mats));
-    
-    return rval;
+    return _laminate_matrix(layer_mats, LAMINATE_INERTIA);
 }
 
 
 
 std::auto_ptr<MAST::FieldFunction<RealMatrixX> >
 MAST::Multilayer2DSectionElementPropertyCard::
-thermal_expansion_A_matrix(const MAST::ElementBase& e) {
+thermal_expansion_A_matrix(const MAST::ElementBase& e) const {
     
     // prepare vector of matrix functions from each layer
     std::vector<MAST::FieldFunction<RealMatrixX>*> layer_mats(_layers.size());
@@ -349,17 +390,14 @@ thermal_expansion_A_matrix(const MAST::ElementBase& e) {
         layer_mats[i] = _layers[i]->thermal_expansion_A_matrix(e).release();
     
     // now create the integrated object
-    std::auto_ptr<MAST::FieldFunction<RealMatrixX> > rval
-    (new MAST::Multilayer2DSectionProperty::Matrix(layer_mats));
-    
-    return rval;
+    return _laminate_matrix(layer_mats, LAMINATE_THERMAL_A);
 }
 
 
 
 std::auto_ptr<MAST::FieldFunction<RealMatrixX> >
 MAST::Multilayer2DSectionElementPropertyCard::
-thermal_expansion_B_matrix(const MAST::ElementBase& e) {
+thermal_expansion_B_matrix(const MAST::ElementBase& e) const {
     
     // prepare vector of matrix functions from each layer
     std::vector<MAST::FieldFunction<RealMatrixX>*> layer_mats(_layers.size());
@@ -367,17 +405,14 @@ thermal_expansion_B_matrix(const MAST::ElementBase& e) {
         layer_mats[i] = _layers[i]->thermal_expansion_B_matrix(e).release();
     
     // now create the integrated object
-    std::auto_ptr<MAST::FieldFunction<RealMatrixX> > rval
-    (new MAST::Multilayer2DSectionProperty::Matrix(layer_mats));
-    
-    return rval;
+    return _laminate_matrix(layer_mats, LAMINATE_THERMAL_B);
 }
 
 
 
 std::auto_ptr<MAST::FieldFunction<RealMatrixX> >
 MAST::Multilayer2DSectionElementPropertyCard::
-transverse_shear_stiffness_matrix(const MAST::ElementBase& e) {
+transverse_shear_stiffness_matrix(const MAST::ElementBase& e) const {
     
     // prepare vector of matrix functions from each layer
     std::vector<MAST::FieldFunction<RealMatrixX>*> layer_mats(_layers.size());
@@ -385,10 +420,7 @@ transverse_shear_stiffness_matrix(const MAST::ElementBase& e) {
         layer_mats[i] = _layers[i]->transverse_shear_stiffness_matrix(e).release();
     
     // now create the integrated object
-    std::auto_ptr<MAST::FieldFunction<RealMatrixX> > rval
-    (new MAST::Multilayer2DSectionProperty::Matrix(layer_mats));
-    
-    return rval;
+    return _laminate_matrix(layer_mats, LAMINATE_TRANSVERSE_SHEAR);
 }
 
 
@@ -396,7 +428,7 @@ transverse_shear_stiffness_matrix(const MAST::ElementBase& e) {
 
 std::auto_ptr<MAST::FieldFunction<RealMatrixX> >
 MAST::Multilayer2DSectionElementPropertyCard::
-prestress_A_matrix( MAST::ElementBase& e) {
+prestress_A_matrix( MAST::ElementBase& e) const {
     
     // prepare vector of matrix functions from each layer
     std::vector<MAST::FieldFunction<RealMatrixX>*> layer_mats(_layers.size());
@@ -404,17 +436,14 @@ prestress_A_matrix( MAST::ElementBase& e) {
         layer_mats[i] = _layers[i]->prestress_A_matrix(e).release();
     
     // now create the integrated object
-    std::auto_ptr<MAST::FieldFunction<RealMatrixX> > rval
-    (new MAST::Multilayer2DSectionProperty::Matrix(layer_mats));
-    
-    return rval;
+    return _laminate_matrix(layer_mats, N_LAMINATE_QUANTITIES);
 }
 
 
 
 std::auto_ptr<MAST::FieldFunction<RealMatrixX> >
 MAST::Multilayer2DSectionElementPropertyCard::
-prestress_B_matrix( MAST::ElementBase& e) {
+prestress_B_matrix( MAST::ElementBase& e) const {
     
     // prepare vector of matrix functions from each layer
     std::vector<MAST::FieldFunction<RealMatrixX>*> layer_mats(_layers.size());
@@ -422,11 +451,183 @@ prestress_B_matrix( MAST::ElementBase& e) {
         layer_mats[i] = _layers[i]->prestress_B_matrix(e).release();
     
     // now create the integrated object
-    std::auto_ptr<MAST::FieldFunction<RealMatrixX> > rval
-    (new MAST::Multilayer2DSectionProperty::Matrix(layer_mats));
+    return _laminate_matrix(layer_mats, N_LAMINATE_QUANTITIES);
+}
+
+
+
+std::auto_ptr<MAST::FieldFunction<RealMatrixX> >
+MAST::Multilayer2DSectionElementPropertyCard::
+thermal_conductance_matrix(const MAST::ElementBase& e) const {
+    
+    // prepare vector of matrix functions from each layer
+    std::vector<MAST::FieldFunction<RealMatrixX>*> layer_mats(_layers.size());
+    for (unsigned int i=0; i<_layers.size(); i++)
+        layer_mats[i] = _layers[i]->thermal_conductance_matrix(e).release();
+    
+    // now create the integrated object
+    return _laminate_matrix(layer_mats, LAMINATE_CONDUCTANCE);
+}
+
+
+
+std::auto_ptr<MAST::FieldFunction<RealMatrixX> >
+MAST::Multilayer2DSectionElementPropertyCard::
+thermal_capacitance_matrix(const MAST::ElementBase& e) const {
+    
+    // prepare vector of matrix functions from each layer
+    std::vector<MAST::FieldFunction<RealMatrixX>*> layer_mats(_layers.size());
+    for (unsigned int i=0; i<_layers.size(); i++)
+        layer_mats[i] = _layers[i]->thermal_capacitance_matrix(e).release();
+    
+    // now create the integrated object
+    return _laminate_matrix(layer_mats, LAMINATE_CAPACITANCE);
+}
+
+
+
+void
+MAST::Multilayer2DSectionElementPropertyCard::set_laminate_cache(bool f) {
+    
+    _laminate_cache = f;
+    this->clear_laminate_cache();
+}
+
+
+
+void
+MAST::Multilayer2DSectionElementPropertyCard::clear_laminate_cache() {
+    
+    std::lock_guard<std::mutex> lock(_laminate_mutex);
     
-    return rval;
+    for (unsigned int i=0; i<N_LAMINATE_QUANTITIES; i++) {
+        _laminate[i].values.clear();
+        _laminate[i].sensitivities.clear();
+    }
 }
 
 
 
+std::auto_ptr<MAST::FieldFunction<RealMatrixX> >
+MAST::Multilayer2DSectionElementPropertyCard::
+_laminate_matrix(std::vector<MAST::FieldFunction<RealMatrixX>*>& layer_mats,
+                 MAST::Multilayer2DSectionElementPropertyCard::LaminateQuantity q) const {
+    
+    return std::auto_ptr<MAST::FieldFunction<RealMatrixX> >
+    (new MAST::Multilayer2DSectionProperty::Matrix(layer_mats, *this, q));
+}
+
+
+
+void
+MAST::Multilayer2DSectionElementPropertyCard::
+_add_laminate_parameters(const MAST::FunctionBase& f) const {
+    
+    std::set<const MAST::FunctionBase*> funcs;
+    f.get_independent_functions(funcs);
+    
+    std::set<const MAST::FunctionBase*>::const_iterator
+    it  = funcs.begin(),
+    end = funcs.end();
+    
+    std::lock_guard<std::mutex> lock(_laminate_mutex);
+    
+    // values stored so far do not depend on parameters that are added
+    // here, since the functions of those quantities added theirs
+    // on construction
+    for ( ; it != end; it++) {
+        const MAST::Parameter* prm = dynamic_cast<const MAST::Parameter*>(*it);
+        if (prm && !_laminate_params.count(prm))
+            _laminate_params[prm] = prm->version();
+    }
+}
+
+
+
+void
+MAST::Multilayer2DSectionElementPropertyCard::_check_laminate_parameters() const {
+    
+    // this is called with _laminate_mutex locked
+    bool changed = false;
+    
+    std::map<const MAST::Parameter*, unsigned long long>::iterator
+    it  = _laminate_params.begin(),
+    end = _laminate_params.end();
+    
+    for ( ; it != end; it++) {
+        const unsigned long long
+        v = it->first->version();
+        if (v != it->second) {
+            it->second = v;
+            changed    = true;
+        }
+    }
+    
+    if (changed)
+        for (unsigned int i=0; i<N_LAMINATE_QUANTITIES; i++) {
+            _laminate[i].values.clear();
+            _laminate[i].sensitivities.clear();
+        }
+}
+
+
+
+bool
+MAST::Multilayer2DSectionElementPropertyCard::
+_get_laminate_value(MAST::Multilayer2DSectionElementPropertyCard::LaminateQuantity q,
+                    const MAST::FunctionBase* f,
+                    const std::pair<libMesh::Point, Real>& key,
+                    RealMatrixX& m) const {
+    
+    libmesh_assert_less(q, N_LAMINATE_QUANTITIES);
+    
+    std::lock_guard<std::mutex> lock(_laminate_mutex);
+    
+    _check_laminate_parameters();
+    
+    const LaminateData& d = _laminate[q];
+    
+    if (!f) {
+        
+        std::map<std::pair<libMesh::Point, Real>, RealMatrixX>::const_iterator
+        it = d.values.find(key);
+        
+        if (it == d.values.end())
+            return false;
+        
+        m = it->second;
+    }
+    else {
+        
+        std::map<std::pair<const MAST::FunctionBase*, std::pair<libMesh::Point, Real> >,
+        RealMatrixX>::const_iterator
+        it = d.sensitivities.find(std::make_pair(f, key));
+        
+        if (it == d.sensitivities.end())
+            return false;
+        
+        m = it->second;
+    }
+    
+    return true;
+}
+
+
+
+void
+MAST::Multilayer2DSectionElementPropertyCard::
+_set_laminate_value(MAST::Multilayer2DSectionElementPropertyCard::LaminateQuantity q,
+                    const MAST::FunctionBase* f,
+                    const std::pair<libMesh::Point, Real>& key,
+                    const RealMatrixX& m) const {
+    
+    libmesh_assert_less(q, N_LAMINATE_QUANTITIES);
+    
+    std::lock_guard<std::mutex> lock(_laminate_mutex);
+    
+    if (!f)
+        _laminate[q].values[key] = m;
+    else
+        _laminate[q].sensitivities[std::make_pair(f, key)] = m;
+}
+
@@ -21,23 +21,54 @@
 #define __mast__multilayer_2d_section_element_property_card__
 
 
+// C++ includes
+#include <map>
+#include <mutex>
+
 
 // MAST includes
 #include "property_cards/element_property_card_2D.h"
 
 
+// libMesh includes
+#include "libmesh/point.h"
+
+
 namespace MAST {
     
     // Forward declerations
     class Solid2DSectionElementPropertyCard;
+    class Parameter;
+    namespace Multilayer2DSectionProperty {
+        class Matrix;
+    }
     
     
     class Multilayer2DSectionElementPropertyCard : public MAST::ElementPropertyCard2D {
         
     public:
         
+        /*!
+         *   section quantities obtained by integration over the layers
+         *   that can be stored by the laminate cache
+         */
+        enum LaminateQuantity {
+            LAMINATE_A,
+            LAMINATE_B,
+            LAMINATE_D,
+            LAMINATE_THERMAL_A,
+            LAMINATE_THERMAL_B,
+            LAMINATE_INERTIA,
+            LAMINATE_TRANSVERSE_SHEAR,
+            LAMINATE_CONDUCTANCE,
+            LAMINATE_CAPACITANCE,
+            N_LAMINATE_QUANTITIES
+        };
+        
+        
         Multilayer2DSectionElementPropertyCard():
-        MAST::ElementPropertyCard2D()
+        MAST::ElementPropertyCard2D(),
+        _laminate_cache(false)
         { }
         
         
@@ -79,46 +110,164 @@ namespace MAST {
         virtual bool depends_on(const MAST::FunctionBase& f) const;
         
         
+        /*!
+         *   tells the card to store the laminate matrices, thermal
+         *   expansion resultants, inertia and their sensitivities computed
+         *   at each point and time, so that the contributions of the
+         *   layers are summed only once for a point, instead of once per
+         *   quadrature point of each element. The stored values are
+         *   shared by the matrix functions of all elements and are
+         *   discarded when the value of any parameter that the layers
+         *   depend on changes. If the layers change otherwise,
+         *   clear_laminate_cache() must be called. This is \p false by
+         *   default.
+         */
+        void set_laminate_cache(bool f);
+        
+        
+        /*!
+         *   @returns \p true if the laminate matrices are stored
+         */
+        bool if_laminate_cache() const {
+            return _laminate_cache;
+        }
+        
+        
+        /*!
+         *   discards the stored laminate matrices
+         */
+        void clear_laminate_cache();
+        
         
         virtual std::auto_ptr<MAST::FieldFunction<RealMatrixX> >
-        stiffness_A_matrix(const MAST::ElementBase& e);
+        stiffness_A_matrix(const MAST::ElementBase& e) const;
         
         virtual std::auto_ptr<MAST::FieldFunction<RealMatrixX> >
-        stiffness_B_matrix(const MAST::ElementBase& e);
+        stiffness_B_matrix(const MAST::ElementBase& e) const;
         
         virtual std::auto_ptr<MAST::FieldFunction<RealMatrixX> >
-        stiffness_D_matrix(const MAST::ElementBase& e);
+        stiffness_D_matrix(const MAST::ElementBase& e) const;
         
         virtual std::auto_ptr<MAST::FieldFunction<RealMatrixX> >
-        damping_matrix(const MAST::ElementBase& e);
+        damping_matrix(const MAST::ElementBase& e) const;
         
         virtual std::auto_ptr<MAST::FieldFunction<RealMatrixX> >
-        inertia_matrix(const MAST::ElementBase& e);
+        inertia_matrix(const MAST::ElementBase& e) const;
         
         virtual std::auto_ptr<MAST::FieldFunction<RealMatrixX> >
-        thermal_expansion_A_matrix(const MAST::ElementBase& e);
+        thermal_expansion_A_matrix(const MAST::ElementBase& e) const;
         
         virtual std::auto_ptr<MAST::FieldFunction<RealMatrixX> >
-        thermal_expansion_B_matrix(const MAST::ElementBase& e);
+        thermal_expansion_B_matrix(const MAST::ElementBase& e) const;
         
         virtual std::auto_ptr<MAST::FieldFunction<RealMatrixX> >
-        transverse_shear_stiffness_matrix(const MAST::ElementBase& e);
+        transverse_shear_stiffness_matrix(const MAST::ElementBase& e) const;
         
         virtual std::auto_ptr<MAST::FieldFunction<RealMatrixX> >
-        prestress_A_matrix( MAST::ElementBase& e);
+        prestress_A_matrix( MAST::ElementBase& e) const;
         
         virtual std::auto_ptr<MAST::FieldFunction<RealMatrixX> >
-        prestress_B_matrix( MAST::ElementBase& e);
+        prestress_B_matrix( MAST::ElementBase& e) const;
 
+        virtual std::auto_ptr<MAST::FieldFunction<RealMatrixX> >
+        thermal_conductance_matrix(const MAST::ElementBase& e) const;
+        
+        virtual std::auto_ptr<MAST::FieldFunction<RealMatrixX> >
+        thermal_capacitance_matrix(const MAST::ElementBase& e) const;
         
     protected:
         
+        friend class MAST::Multilayer2DSectionProperty::Matrix;
+        
+        /*!
+         *   values and sensitivities of a laminate quantity stored for
+         *   each point and time, and for each function
+         */
+        struct LaminateData {
+            
+            std::map<std::pair<libMesh::Point, Real>, RealMatrixX> values;
+            
+            std::map<std::pair<const MAST::FunctionBase*, std::pair<libMesh::Point, Real> >,
+            RealMatrixX> sensitivities;
+        };
+        
+        
+        /*!
+         *   @returns a function that sums the matrices of all layers in
+         *   \p layer_mats, which are owned by the returned function. 
+         *   \p q identifies the stored values, or is 
+         *   \p N_LAMINATE_QUANTITIES for a quantity that is not stored.
+         */
+        std::auto_ptr<MAST::FieldFunction<RealMatrixX> >
+        _laminate_matrix(std::vector<MAST::FieldFunction<RealMatrixX>*>& layer_mats,
+                         LaminateQuantity q) const;
+        
+        
+        /*!
+         *   adds the parameters that \p f depends on to the parameters
+         *   that identify the stored values
+         */
+        void _add_laminate_parameters(const MAST::FunctionBase& f) const;
+        
+        
+        /*!
+         *   clears the stored values if the version of a laminate parameter
+         *   has changed since they were computed. This must be called with
+         *   \p _laminate_mutex locked.
+         */
+        void _check_laminate_parameters() const;
+        
+        
+        /*!
+         *   copies the value of \p q, or its sensitivity with respect to 
+         *   \p f if \p f is not \p nullptr, at \p key into \p m.
+         *   @returns \p false if no value is stored.
+         */
+        bool _get_laminate_value(LaminateQuantity q,
+                                 const MAST::FunctionBase* f,
+                                 const std::pair<libMesh::Point, Real>& key,
+                                 RealMatrixX& m) const;
+        
+        
+        /*!
+         *   stores \p m as the value of \p q, or its sensitivity with
+         *   respect to \p f if \p f is not \p nullptr, at \p key.
+         */
+        void _set_laminate_value(LaminateQuantity q,
+                                 const MAST::FunctionBase* f,
+                                 const std::pair<libMesh::Point, Real>& key,
+                                 const RealMatrixX& m) const;
+        
+        
         std::vector<MAST::FieldFunction<Real>*> _layer_offsets;
         
         /*!
          *   vector of thickness function for each layer
          */
         std::vector<MAST::Solid2DSectionElementPropertyCard*> _layers;
+        
+        /*!
+         *   flag to store the laminate matrices
+         */
+        bool _laminate_cache;
+        
+        /*!
+         *   parameters that the layers depend on, and their versions for
+         *   which the stored values were computed. The parameters are
+         *   stored since the laminate functions are created for each
+         *   element.
+         */
+        mutable std::map<const MAST::Parameter*, unsigned long long> _laminate_params;
+        
+        /*!
+         *   stored values for each laminate quantity
+         */
+        mutable LaminateData _laminate[N_LAMINATE_QUANTITIES];
+        
+        /*!
+         *   mutex for access to the stored values from multiple threads
+         */
+        mutable std::mutex _laminate_mutex;
     };
     
 }
@@ -224,8 +224,7 @@ StiffnessMatrix::operator() (const libMesh::Point& p,
     Tinv = RealMatrixX::Zero(6, 6);
     
     _material_stiffness (p, t, m);
-    _orient             (p, t, A);
-    _orient.stress_strain_transformation_matrix(A.transpose(), Tinv);
+    _orient.transformation_matrices(p, t, A, Tinv);
     
     //    vk'  = vj ej.ek' = vj Ajk = A^T v
     //    v = A vk'
@@ -262,12 +261,8 @@ StiffnessMatrix::derivative (const MAST::FunctionBase& f,
     
     _material_stiffness (p, t, m);
     _material_stiffness.derivative( f, p, t, dm);
-    _orient             (p, t, A);
-    _orient.stress_strain_transformation_matrix(A.transpose(), Tinv);
-    _orient.derivative    (f, p, t, dA);
-    _orient.stress_strain_transformation_matrix_sens(A.transpose(),
-                                                     dA.transpose(),
-                                                     dTinv);
+    _orient.transformation_matrices     (p, t, A, Tinv);
+    _orient.transformation_matrices_sens(f, p, t, dA, dTinv);
     
     m =
     dTinv *  m *  Tinv.transpose() +
@@ -341,8 +336,7 @@ ThermalExpansionMatrix::operator() (const libMesh::Point& p,
     
     _material_stiffness  (p, t, m);
     _material_expansion  (p, t, mat);
-    _orient              (p, t, A);
-    _orient.stress_strain_transformation_matrix(A.transpose(), Tinv);
+    _orient.transformation_matrices(p, t, A, Tinv);
     
     //    epsilon' = T^{-T} epsilon
     //    epsilon  = T^T epsilon'
@@ -380,12 +374,8 @@ ThermalExpansionMatrix::derivative (   const MAST::FunctionBase& f,
     _material_stiffness.derivative( f, p, t, dm);
     _material_expansion (p, t, mat);
     _material_expansion.derivative( f, p, t, dmat);
-    _orient              (p, t, A);
-    _orient.stress_strain_transformation_matrix(A.transpose(), Tinv);
-    _orient.derivative    (f, p, t, dA);
-    _orient.stress_strain_transformation_matrix_sens(A.transpose(),
-                                                      dA.transpose(),
-                                                      dTinv);
+    _orient.transformation_matrices     (p, t, A, Tinv);
+    _orient.transformation_matrices_sens(f, p, t, dA, dTinv);
     
     m =
     dTinv *  m *  mat +
@@ -458,10 +448,11 @@ operator() (const libMesh::Point& p,
             RealMatrixX& m) const {
     
     RealMatrixX
-    A    = RealMatrixX::Zero(3, 3);
+    A    = RealMatrixX::Zero(3, 3),
+    Tinv;
     
     _mat_cond (p, t, m);
-    _orient   (p, t, A);
+    _orient.transformation_matrices(p, t, A, Tinv);
 
     m = A.transpose() * m * A;
 }
@@ -477,12 +468,14 @@ MAST::OrthotropicProperty3D::ThermalConductanceMatrix::derivative (
     RealMatrixX
     dm    = RealMatrixX::Zero(3, 3),
     A     = RealMatrixX::Zero(3, 3),
-    dA    = RealMatrixX::Zero(3, 3);
+    dA    = RealMatrixX::Zero(3, 3),
+    Tinv,
+    dTinv;
     
     _mat_cond    (p, t, m);
-    _orient      (p, t, A);
+    _orient.transformation_matrices(p, t, A, Tinv);
     _mat_cond.derivative( f, p, t, dm);
-    _orient.derivative  ( f, p, t, dA);
+    _orient.transformation_matrices_sens(f, p, t, dA, dTinv);
     
     m =
     dA.transpose() *  m * A +
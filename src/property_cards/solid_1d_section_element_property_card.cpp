@@ -23,6 +23,7 @@
 #include "base/field_function_base.h"
 #include "base/elem_base.h"
 #include "mesh/local_elem_base.h"
+#include "base/parameter.h"
 
 
 
@@ -32,8 +33,10 @@ namespace MAST {
         class Area: public MAST::FieldFunction<Real> {
         public:
             Area(const MAST::FieldFunction<Real>& hy,
-                 const MAST::FieldFunction<Real>&  hz):
+                 const MAST::FieldFunction<Real>&  hz,
+                 const MAST::Solid1DSectionElementPropertyCard& card):
             MAST::FieldFunction<Real>("Area"),
+            _card(card),
             _hy(hy),
             _hz(hz) {
                 _functions.insert(&hy);
@@ -42,9 +45,20 @@ namespace MAST {
             
             virtual ~Area() { }
             
+            virtual bool is_constant() const {
+                return _if_dependent_functions_constant();
+            }
+            
             virtual void operator() (const libMesh::Point& p,
                                      const Real t,
                                      Real& m) const {
+                if (_card.if_section_cache()) {
+                    MAST::Solid1DSectionElementPropertyCard::SectionValues v;
+                    _card.section_values(p, t, v);
+                    m = v.A;
+                    return;
+                }
+                
                 Real hy, hz;
                 _hy(p, t, hy);
                 _hz(p, t, hz);
@@ -56,6 +70,13 @@ namespace MAST {
                                      const libMesh::Point& p,
                                      const Real t,
                                      Real& m) const {
+                if (_card.if_section_cache()) {
+                    MAST::Solid1DSectionElementPropertyCard::SectionValues dv;
+                    _card.section_value_derivatives(f, p, t, dv);
+                    m = dv.A;
+                    return;
+                }
+                
                 Real hy, hz, dhy, dhz;
                 _hy(p, t, hy); _hy.derivative( f, p, t, dhy);
                 _hz(p, t, hz); _hz.derivative( f, p, t, dhz);
@@ -65,6 +86,8 @@ namespace MAST {
             
         protected:
             
+            const MAST::Solid1DSectionElementPropertyCard& _card;
+            
             const MAST::FieldFunction<Real>& _hy, &_hz;
         };
         
@@ -73,8 +96,10 @@ namespace MAST {
         class TorsionalConstant: public MAST::FieldFunction<Real> {
         public:
             TorsionalConstant(const MAST::FieldFunction<Real>& hy,
-                              const MAST::FieldFunction<Real>&  hz):
+                              const MAST::FieldFunction<Real>&  hz,
+                              const MAST::Solid1DSectionElementPropertyCard& card):
             MAST::FieldFunction<Real>("TorsionalConstant"),
+            _card(card),
             _hy(hy),
             _hz(hz) {
                 _functions.insert(&hy);
@@ -84,9 +109,20 @@ namespace MAST {
             
             virtual ~TorsionalConstant() { }
             
+            virtual bool is_constant() const {
+                return _if_dependent_functions_constant();
+            }
+            
             virtual void operator() (const libMesh::Point& p,
                                      const Real t,
                                      Real& m) const {
+                if (_card.if_section_cache()) {
+                    MAST::Solid1DSectionElementPropertyCard::SectionValues v;
+                    _card.section_values(p, t, v);
+                    m = v.J;
+                    return;
+                }
+                
                 Real hy, hz, a, b;
                 _hy(p, t, hy);
                 _hz(p, t, hz);
@@ -110,6 +146,13 @@ namespace MAST {
                                      const libMesh::Point& p,
                                      const Real t,
                                      Real& m) const {
+                if (_card.if_section_cache()) {
+                    MAST::Solid1DSectionElementPropertyCard::SectionValues dv;
+                    _card.section_value_derivatives(f, p, t, dv);
+                    m = dv.J;
+                    return;
+                }
+                
                 Real hy, hz, dhy, dhz, a, b, da, db;
                 _hy(p, t, hy); _hy.derivative( f, p, t, dhy);
                 _hz(p, t, hz); _hz.derivative( f, p, t, dhz);
@@ -135,6 +178,8 @@ namespace MAST {
             
         protected:
             
+            const MAST::Solid1DSectionElementPropertyCard& _card;
+            
             const MAST::FieldFunction<Real>& _hy, &_hz;
         };
         
@@ -145,8 +190,10 @@ namespace MAST {
             PolarInertia(const MAST::FieldFunction<Real>& hy,
                          const MAST::FieldFunction<Real>&  hz,
                          const MAST::FieldFunction<Real>&  hy_offset,
-                         const MAST::FieldFunction<Real>&  hz_offset):
+                         const MAST::FieldFunction<Real>&  hz_offset,
+                         const MAST::Solid1DSectionElementPropertyCard& card):
             MAST::FieldFunction<Real>("PolarInertia"),
+            _card(card),
             _hy(hy),
             _hz(hz),
             _hy_offset(hy_offset),
@@ -159,9 +206,20 @@ namespace MAST {
             
             virtual ~PolarInertia() { }
             
+            virtual bool is_constant() const {
+                return _if_dependent_functions_constant();
+            }
+            
             virtual void operator() (const libMesh::Point& p,
                                      const Real t,
                                      Real& m) const {
+                if (_card.if_section_cache()) {
+                    MAST::Solid1DSectionElementPropertyCard::SectionValues v;
+                    _card.section_values(p, t, v);
+                    m = v.Ip;
+                    return;
+                }
+                
                 Real hy, hz, offy, offz;
                 _hy(p, t, hy);
                 _hz(p, t, hz);
@@ -176,6 +234,13 @@ namespace MAST {
                                      const libMesh::Point& p,
                                      const Real t,
                                      Real& m) const {
+                if (_card.if_section_cache()) {
+                    MAST::Solid1DSectionElementPropertyCard::SectionValues dv;
+                    _card.section_value_derivatives(f, p, t, dv);
+                    m = dv.Ip;
+                    return;
+                }
+                
                 Real hy, hz, dhy, dhz, offy, offz, doffy, doffz;
                 _hy        (p, t, hy);           _hy.derivative( f, p, t, dhy);
                 _hz        (p, t, hz);           _hz.derivative( f, p, t, dhz);
@@ -192,6 +257,8 @@ namespace MAST {
             
         protected:
             
+            const MAST::Solid1DSectionElementPropertyCard& _card;
+            
             const MAST::FieldFunction<Real>& _hy, &_hz, &_hy_offset, &_hz_offset;
         };
         
@@ -205,8 +272,10 @@ namespace MAST {
         public:
             AreaYMoment(const MAST::FieldFunction<Real>&  hy,
                         const MAST::FieldFunction<Real>&  hz,
-                        const MAST::FieldFunction<Real>&  hz_offset):
+                        const MAST::FieldFunction<Real>&  hz_offset,
+                        const MAST::Solid1DSectionElementPropertyCard& card):
             MAST::FieldFunction<Real>("AreaYMoment"),
+            _card(card),
             _hy(hy),
             _hz(hz),
             _hz_offset(hz_offset) {
@@ -218,9 +287,20 @@ namespace MAST {
             
             virtual ~AreaYMoment() { }
             
+            virtual bool is_constant() const {
+                return _if_dependent_functions_constant();
+            }
+            
             virtual void operator() (const libMesh::Point& p,
                                      const Real t,
                                      Real& m) const {
+                if (_card.if_section_cache()) {
+                    MAST::Solid1DSectionElementPropertyCard::SectionValues v;
+                    _card.section_values(p, t, v);
+                    m = v.Ay;
+                    return;
+                }
+                
                 Real hy, hz, off;
                 _hy(p, t, hy);
                 _hz(p, t, hz);
@@ -234,6 +314,13 @@ namespace MAST {
                                      const libMesh::Point& p,
                                      const Real t,
                                      Real& m) const {
+                if (_card.if_section_cache()) {
+                    MAST::Solid1DSectionElementPropertyCard::SectionValues dv;
+                    _card.section_value_derivatives(f, p, t, dv);
+                    m = dv.Ay;
+                    return;
+                }
+                
                 Real hy, hz, off, dhy, dhz, doff;
                 _hy        (p, t, hy);         _hy.derivative( f, p, t, dhy);
                 _hz        (p, t, hz);         _hz.derivative( f, p, t, dhz);
@@ -244,6 +331,8 @@ namespace MAST {
             
         protected:
             
+            const MAST::Solid1DSectionElementPropertyCard& _card;
+            
             const MAST::FieldFunction<Real>& _hy, &_hz, &_hz_offset;
         };
         
@@ -257,8 +346,10 @@ namespace MAST {
         public:
             AreaZMoment(const MAST::FieldFunction<Real>&  hy,
                         const MAST::FieldFunction<Real>&  hz,
-                        const MAST::FieldFunction<Real>&  hy_offset):
+                        const MAST::FieldFunction<Real>&  hy_offset,
+                        const MAST::Solid1DSectionElementPropertyCard& card):
             MAST::FieldFunction<Real>("AreaZMoment"),
+            _card(card),
             _hy(hy),
             _hz(hz),
             _hy_offset(hy_offset) {
@@ -269,9 +360,20 @@ namespace MAST {
             
             virtual ~AreaZMoment() { }
             
+            virtual bool is_constant() const {
+                return _if_dependent_functions_constant();
+            }
+            
             virtual void operator() (const libMesh::Point& p,
                                      const Real t,
                                      Real& m) const {
+                if (_card.if_section_cache()) {
+                    MAST::Solid1DSectionElementPropertyCard::SectionValues v;
+                    _card.section_values(p, t, v);
+                    m = v.Az;
+                    return;
+                }
+                
                 Real hy, hz, off;
                 _hy(p, t, hy);
                 _hz(p, t, hz);
@@ -285,6 +387,13 @@ namespace MAST {
                                      const libMesh::Point& p,
                                      const Real t,
                                      Real& m) const {
+                if (_card.if_section_cache()) {
+                    MAST::Solid1DSectionElementPropertyCard::SectionValues dv;
+                    _card.section_value_derivatives(f, p, t, dv);
+                    m = dv.Az;
+                    return;
+                }
+                
                 Real hy, hz, off, dhy, dhz, doff;
                 _hy(p, t, hy); _hy.derivative( f, p, t, dhy);
                 _hz(p, t, hz); _hz.derivative( f, p, t, dhz);
@@ -295,6 +404,8 @@ namespace MAST {
             
         protected:
             
+            const MAST::Solid1DSectionElementPropertyCard& _card;
+            
             const MAST::FieldFunction<Real>& _hy, &_hz, &_hy_offset;
         };
         
@@ -314,8 +425,10 @@ namespace MAST {
             AreaInertiaMatrix(const MAST::FieldFunction<Real>&  hy,
                               const MAST::FieldFunction<Real>&  hz,
                               const MAST::FieldFunction<Real>&  hy_offset,
-                              const MAST::FieldFunction<Real>&  hz_offset):
+                              const MAST::FieldFunction<Real>&  hz_offset,
+                              const MAST::Solid1DSectionElementPropertyCard& card):
             MAST::FieldFunction<RealMatrixX>("AreaInertiaMatrix"),
+            _card(card),
             _hy(hy),
             _hz(hz),
             _hy_offset(hy_offset),
@@ -328,9 +441,20 @@ namespace MAST {
             
             virtual ~AreaInertiaMatrix() { }
             
+            virtual bool is_constant() const {
+                return _if_dependent_functions_constant();
+            }
+            
             virtual void operator() (const libMesh::Point& p,
                                      const Real t,
                                      RealMatrixX& m) const {
+                if (_card.if_section_cache()) {
+                    MAST::Solid1DSectionElementPropertyCard::SectionValues v;
+                    _card.section_values(p, t, v);
+                    v.inertia_matrix(m);
+                    return;
+                }
+                
                 Real hy, hz, offy, offz;
                 m = RealMatrixX::Zero(2,2);
                 _hy(p, t, hy);
@@ -349,6 +473,13 @@ namespace MAST {
                                      const libMesh::Point& p,
                                      const Real t,
                                      RealMatrixX& m) const {
+                if (_card.if_section_cache()) {
+                    MAST::Solid1DSectionElementPropertyCard::SectionValues dv;
+                    _card.section_value_derivatives(f, p, t, dv);
+                    dv.inertia_matrix(m);
+                    return;
+                }
+                
                 Real hy, hz, offy, offz, dhy, dhz, doffy, doffz;
                 m = RealMatrixX::Zero(2,2);
                 _hy(p, t, hy); _hy.derivative( f, p, t, dhy);
@@ -368,6 +499,8 @@ namespace MAST {
             
         protected:
             
+            const MAST::Solid1DSectionElementPropertyCard& _card;
+            
             const MAST::FieldFunction<Real>& _hy, &_hz, &_hy_offset, &_hz_offset;
         };
         
@@ -380,6 +513,10 @@ namespace MAST {
             
             virtual ~ExtensionStiffnessMatrix() { }
             
+            virtual bool is_constant() const {
+                return _if_dependent_functions_constant();
+            }
+            
             virtual void operator() (const libMesh::Point& p,
                                      const Real t,
                                      RealMatrixX& m) const;
@@ -407,6 +544,10 @@ namespace MAST {
             
             virtual ~ExtensionBendingStiffnessMatrix() { }
             
+            virtual bool is_constant() const {
+                return _if_dependent_functions_constant();
+            }
+            
             virtual void operator() (const libMesh::Point& p,
                                      const Real t,
                                      RealMatrixX& m) const;
@@ -432,6 +573,10 @@ namespace MAST {
             
             virtual ~BendingStiffnessMatrix() { }
             
+            virtual bool is_constant() const {
+                return _if_dependent_functions_constant();
+            }
+            
             virtual void operator() (const libMesh::Point& p,
                                      const Real t,
                                      RealMatrixX& m) const;
@@ -463,6 +608,10 @@ namespace MAST {
             
             virtual ~TransverseStiffnessMatrix() { }
             
+            virtual bool is_constant() const {
+                return _if_dependent_functions_constant();
+            }
+            
             virtual void operator() (const libMesh::Point& p,
                                      const Real t,
                                      RealMatrixX& m) const {
@@ -1511,28 +1660,307 @@ MAST::Solid1DSectionElementPropertyCard::init() {
     &hz_off =  this->get<MAST::FieldFunction<Real> >("hz_off");
     
     _A.reset(new MAST::Solid1DSectionProperty::Area(hy,
-                                                    hz));
+                                                    hz,
+                                                    *this));
     _Ay.reset(new MAST::Solid1DSectionProperty::AreaYMoment(hy,
                                                             hz,
-                                                            hz_off));
+                                                            hz_off,
+                                                            *this));
     _Az.reset(new MAST::Solid1DSectionProperty::AreaZMoment(hy,
                                                             hz,
-                                                            hy_off));
+                                                            hy_off,
+                                                            *this));
     _J.reset(new MAST::Solid1DSectionProperty::TorsionalConstant(hy,
-                                                                 hz));
+                                                                 hz,
+                                                                 *this));
     _Ip.reset(new MAST::Solid1DSectionProperty::PolarInertia(hy,
                                                              hz,
                                                              hy_off,
-                                                             hz_off));
+                                                             hz_off,
+                                                             *this));
     _AI.reset(new MAST::Solid1DSectionProperty::AreaInertiaMatrix(hy,
                                                                   hz,
                                                                   hy_off,
-                                                                  hz_off));
+                                                                  hz_off,
+                                                                  *this));
+    
+    // the cached section values are identified by the version of the
+    // functions of the section dimensions
+    _section_version = _A->version() + _Ip->version();
+    
+    _constant_section = _Ip->is_constant();
     
     _initialized = true;
 }
 
 
+
+void
+MAST::Solid1DSectionElementPropertyCard::set_section_cache(bool f) {
+    
+    _section_cache = f;
+    this->clear_section_cache();
+}
+
+
+
+void
+MAST::Solid1DSectionElementPropertyCard::clear_section_cache() {
+    
+    std::lock_guard<std::mutex> lock(_section_mutex);
+    
+    _section_values_cache.clear();
+    _section_sens_cache.clear();
+}
+
+
+
+void
+MAST::Solid1DSectionElementPropertyCard::
+section_values(const libMesh::Point& p,
+               const Real t,
+               MAST::Solid1DSectionElementPropertyCard::SectionValues& v) const {
+    
+    libmesh_assert(_initialized);
+    
+    // a section that does not depend on location and time is stored
+    // at a single key
+    const std::pair<libMesh::Point, Real>
+    key = _constant_section?
+    std::make_pair(libMesh::Point(), 0.): std::make_pair(p, t);
+    
+    {
+        std::lock_guard<std::mutex> lock(_section_mutex);
+        
+        _check_section_version();
+        
+        std::map<std::pair<libMesh::Point, Real>, SectionValues>::const_iterator
+        it = _section_values_cache.find(key);
+        
+        if (it != _section_values_cache.end()) {
+            v = it->second;
+            return;
+        }
+    }
+    
+    std::vector<libMesh::Point> pts(1, p);
+    std::vector<SectionValues>  vals;
+    _evaluate_section(pts, t, nullptr, vals, nullptr);
+    v = vals[0];
+    
+    if (_section_cache) {
+        
+        std::lock_guard<std::mutex> lock(_section_mutex);
+        _section_values_cache[key] = v;
+    }
+}
+
+
+
+void
+MAST::Solid1DSectionElementPropertyCard::
+section_value_derivatives(const MAST::FunctionBase& f,
+                          const libMesh::Point& p,
+                          const Real t,
+                          MAST::Solid1DSectionElementPropertyCard::SectionValues& dv) const {
+    
+    libmesh_assert(_initialized);
+    
+    const std::pair<libMesh::Point, Real>
+    pt_key = _constant_section?
+    std::make_pair(libMesh::Point(), 0.): std::make_pair(p, t);
+    const std::pair<const MAST::FunctionBase*, std::pair<libMesh::Point, Real> >
+    key(&f, pt_key);
+    
+    {
+        std::lock_guard<std::mutex> lock(_section_mutex);
+        
+        _check_section_version();
+        
+        std::map<std::pair<const MAST::FunctionBase*, std::pair<libMesh::Point, Real> >,
+        SectionValues>::const_iterator
+        it = _section_sens_cache.find(key);
+        
+        if (it != _section_sens_cache.end()) {
+            dv = it->second;
+            return;
+        }
+    }
+    
+    std::vector<libMesh::Point> pts(1, p);
+    std::vector<SectionValues>  vals, dvals;
+    _evaluate_section(pts, t, &f, vals, &dvals);
+    dv = dvals[0];
+    
+    if (_section_cache) {
+        
+        std::lock_guard<std::mutex> lock(_section_mutex);
+        _section_sens_cache[key] = dv;
+        if (!_section_values_cache.count(pt_key))
+            _section_values_cache[pt_key] = vals[0];
+    }
+}
+
+
+
+void
+MAST::Solid1DSectionElementPropertyCard::
+section_values(const std::vector<libMesh::Point>& pts,
+               const Real t,
+               std::vector<MAST::Solid1DSectionElementPropertyCard::SectionValues>& v) const {
+    
+    libmesh_assert(_initialized);
+    
+    _evaluate_section(pts, t, nullptr, v, nullptr);
+    
+    if (_section_cache) {
+        
+        std::lock_guard<std::mutex> lock(_section_mutex);
+        
+        _check_section_version();
+        
+        if (_constant_section)
+            _section_values_cache[std::make_pair(libMesh::Point(), 0.)] = v[0];
+        else
+            for (unsigned int i=0; i<pts.size(); i++)
+                _section_values_cache[std::make_pair(pts[i], t)] = v[i];
+    }
+}
+
+
+
+void
+MAST::Solid1DSectionElementPropertyCard::_check_section_version() const {
+    
+    // this is called with _section_mutex locked
+    const unsigned long long
+    v = _A->version() + _Ip->version();
+    
+    if (v != _section_version) {
+        
+        _section_version = v;
+        _section_values_cache.clear();
+        _section_sens_cache.clear();
+    }
+}
+
+
+
+void
+MAST::Solid1DSectionElementPropertyCard::
+_evaluate_section(const std::vector<libMesh::Point>& pts,
+                  const Real t,
+                  const MAST::FunctionBase* f,
+                  std::vector<MAST::Solid1DSectionElementPropertyCard::SectionValues>& v,
+                  std::vector<MAST::Solid1DSectionElementPropertyCard::SectionValues>* dv) const {
+    
+    typedef Eigen::Array<Real, Eigen::Dynamic, 1> RealArrayX;
+    
+    const MAST::FieldFunction<Real>
+    &hy_f     =  this->get<MAST::FieldFunction<Real> >("hy"),
+    &hz_f     =  this->get<MAST::FieldFunction<Real> >("hz"),
+    &hy_off_f =  this->get<MAST::FieldFunction<Real> >("hy_off"),
+    &hz_off_f =  this->get<MAST::FieldFunction<Real> >("hz_off");
+    
+    const unsigned int n = (unsigned int)pts.size();
+    
+    RealArrayX
+    hy   = RealArrayX::Zero(n),
+    hz   = RealArrayX::Zero(n),
+    offy = RealArrayX::Zero(n),
+    offz = RealArrayX::Zero(n),
+    dhy  = RealArrayX::Zero(n),
+    dhz  = RealArrayX::Zero(n),
+    doffy= RealArrayX::Zero(n),
+    doffz= RealArrayX::Zero(n);
+    
+    // the section dimensions are evaluated for all points, and the
+    // section properties are then computed for all points together
+    for (unsigned int i=0; i<n; i++) {
+        
+        hy_f    (pts[i], t, hy(i));
+        hz_f    (pts[i], t, hz(i));
+        hy_off_f(pts[i], t, offy(i));
+        hz_off_f(pts[i], t, offz(i));
+        
+        if (f) {
+            hy_f.derivative    (*f, pts[i], t, dhy(i));
+            hz_f.derivative    (*f, pts[i], t, dhz(i));
+            hy_off_f.derivative(*f, pts[i], t, doffy(i));
+            hz_off_f.derivative(*f, pts[i], t, doffz(i));
+        }
+    }
+    
+    // shorter side is b, and longer side is a, for the torsional constant
+    const RealArrayX
+    a      = hy.max(hz),
+    b      = hy.min(hz),
+    da     = (hy > hz).select(dhy, dhz),
+    db     = (hy > hz).select(dhz, dhy),
+    area   = hy*hz,
+    r4     = (b/a).pow(4),
+    fj     = 1./3.-.21*b/a*(1.-r4/12.),
+    Jv     = a*b.cube()*fj,
+    sq     = (hy.square() + hz.square())/12. + offy.square() + offz.square(),
+    Ipv    = area*sq,
+    I00    = hz*hy.cube()/12. + area*offy.square(),
+    I01    = area*offy*offz,
+    I11    = hy*hz.cube()/12. + area*offz.square();
+    
+    v.resize(n);
+    for (unsigned int i=0; i<n; i++) {
+        
+        SectionValues& s = v[i];
+        s.A   = area(i);
+        s.Ay  = area(i)*offz(i);
+        s.Az  = area(i)*offy(i);
+        s.J   = Jv(i);
+        s.Ip  = Ipv(i);
+        s.I00 = I00(i);
+        s.I01 = I01(i);
+        s.I11 = I11(i);
+    }
+    
+    if (!f)
+        return;
+    
+    const RealArrayX
+    darea  = dhy*hz + hy*dhz,
+    dJ     =
+    da*b.cube()*fj +
+    a*3.*b.square()*db*fj +
+    a*b.cube()*(-.21*db/a*(1.-r4/12.) +
+                (.21*b/a.square()*da*(1.-r4/12.)) +
+                (-.21*b/a*(-4.*b.cube()*db/a.pow(4)/12.+
+                           4.*b.pow(4)/a.pow(5)*da/12.))),
+    dIp    =
+    darea*sq +
+    2.*area*((hy*dhy + hz*dhz)/12. + offy*doffy + offz*doffz),
+    dI00   =
+    dhz*hy.cube()/12. + hz*hy.square()/4.*dhy +
+    dhy*hz*offy.square() + hy*dhz*offy.square() + 2.*area*offy*doffy,
+    dI01   =
+    darea*offy*offz + area*doffy*offz + area*offy*doffz,
+    dI11   =
+    dhy*hz.cube()/12. + hy*hz.square()/4.*dhz +
+    dhy*hz*offz.square() + hy*dhz*offz.square() + 2.*area*offz*doffz;
+    
+    dv->resize(n);
+    for (unsigned int i=0; i<n; i++) {
+        
+        SectionValues& s = (*dv)[i];
+        s.A   = darea(i);
+        s.Ay  = darea(i)*offz(i) + area(i)*doffz(i);
+        s.Az  = darea(i)*offy(i) + area(i)*doffy(i);
+        s.J   = dJ(i);
+        s.Ip  = dIp(i);
+        s.I00 = dI00(i);
+        s.I01 = dI01(i);
+        s.I11 = dI11(i);
+    }
+}
+
+
 std::auto_ptr<MAST::FieldFunction<RealMatrixX> >
 MAST::Solid1DSectionElementPropertyCard::
 stiffness_A_matrix(const MAST::ElementBase& e) const {
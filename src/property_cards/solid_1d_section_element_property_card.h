@@ -21,21 +21,60 @@
 #define __mast__solid_1d_section_element_property_card__
 
 
+// C++ includes
+#include <map>
+#include <vector>
+#include <mutex>
+
+
 // MAST includes
 #include "property_cards/element_property_card_1D.h"
 
+
+// libMesh includes
+#include "libmesh/point.h"
+
+
 namespace MAST {
     
     
+    // Forward declerations
+    class Parameter;
+    
+    
     class Solid1DSectionElementPropertyCard :
     public MAST::ElementPropertyCard1D {
         
     public:
         
+        /*!
+         *   section properties at a point: area, area moments about the
+         *   y- and z-axes, torsional constant, polar moment and the
+         *   entries of the 2x2 area inertia matrix I()
+         */
+        struct SectionValues {
+            
+            Real A, Ay, Az, J, Ip, I00, I01, I11;
+            
+            /*!
+             *   sets \p m to the area inertia matrix
+             */
+            void inertia_matrix(RealMatrixX& m) const {
+                m = RealMatrixX::Zero(2,2);
+                m(0,0) = I00;
+                m(0,1) = m(1,0) = I01;
+                m(1,1) = I11;
+            }
+        };
+        
+        
         Solid1DSectionElementPropertyCard():
         MAST::ElementPropertyCard1D(),
         _initialized(false),
-        _material(nullptr)
+        _material(nullptr),
+        _section_cache(false),
+        _constant_section(false),
+        _section_version(0)
         { }
         
         
@@ -186,7 +225,82 @@ namespace MAST {
         
         virtual void init();
         
+        
+        /*!
+         *   tells the card to store the section properties and their
+         *   sensitivities computed at each point and time, so that A(),
+         *   J(), Ip(), Ay(), Az() and I() evaluate the section dimensions
+         *   and properties only once for a point. The stored values are
+         *   discarded when the value of any parameter that the section
+         *   dimensions depend on changes. If the section dimensions
+         *   change otherwise, clear_section_cache() must be called. This
+         *   is \p false by default.
+         */
+        void set_section_cache(bool f);
+        
+        
+        /*!
+         *   @returns \p true if the section properties are stored
+         */
+        bool if_section_cache() const {
+            return _section_cache;
+        }
+        
+        
+        /*!
+         *   discards the stored section properties
+         */
+        void clear_section_cache();
+        
+        
+        /*!
+         *   computes the section properties at \p p and time \p t in
+         *   \p v. Stored values are used, if available.
+         */
+        void section_values(const libMesh::Point& p,
+                            const Real t,
+                            SectionValues& v) const;
+        
+        
+        /*!
+         *   computes the sensitivity of the section properties with
+         *   respect to \p f at \p p and time \p t in \p dv. Stored
+         *   values are used, if available.
+         */
+        void section_value_derivatives(const MAST::FunctionBase& f,
+                                       const libMesh::Point& p,
+                                       const Real t,
+                                       SectionValues& dv) const;
+        
+        
+        /*!
+         *   computes the section properties at all points in \p pts,
+         *   for example the quadrature points of an element, in a single
+         *   pass. The values are stored if the section cache is on.
+         */
+        void section_values(const std::vector<libMesh::Point>& pts,
+                            const Real t,
+                            std::vector<SectionValues>& v) const;
+        
     protected:
+        
+        /*!
+         *   clears the stored values if the version of the section
+         *   functions has changed since they were computed. This must be
+         *   called with \p _section_mutex locked.
+         */
+        void _check_section_version() const;
+        
+        
+        /*!
+         *   computes the section properties in \p v, and if \p f is
+         *   provided, their sensitivity in \p dv, for all points in \p pts.
+         */
+        void _evaluate_section(const std::vector<libMesh::Point>& pts,
+                               const Real t,
+                               const MAST::FunctionBase* f,
+                               std::vector<SectionValues>& v,
+                               std::vector<SectionValues>* dv) const;
 
         bool _initialized;
         
@@ -222,7 +336,42 @@ namespace MAST {
         std::auto_ptr<MAST::FieldFunction<RealMatrixX> > _thermal_B;
 
         std::auto_ptr<MAST::FieldFunction<RealMatrixX> > _transverse_shear;
-
+        
+        /*!
+         *   flag to store the section properties
+         */
+        bool _section_cache;
+        
+        /*!
+         *   \p true if the section dimensions do not depend on location
+         *   and time, in which case a single value is stored
+         */
+        bool _constant_section;
+        
+        /*!
+         *   version of the section area and polar moment functions, which
+         *   depend on all section dimensions, for which the stored values
+         *   were computed
+         */
+        mutable unsigned long long _section_version;
+        
+        /*!
+         *   section properties stored for each point and time
+         */
+        mutable std::map<std::pair<libMesh::Point, Real>, SectionValues>
+        _section_values_cache;
+        
+        /*!
+         *   section property sensitivities stored for each function,
+         *   point and time
+         */
+        mutable std::map<std::pair<const MAST::FunctionBase*, std::pair<libMesh::Point, Real> >,
+        SectionValues> _section_sens_cache;
+        
+        /*!
+         *   mutex for access to the stored values from multiple threads
+         */
+        mutable std::mutex _section_mutex;
     };
     
 }
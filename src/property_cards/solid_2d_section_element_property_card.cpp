@@ -36,6 +36,10 @@ namespace MAST {
             
             virtual ~ExtensionStiffnessMatrix() { }
             
+            virtual bool is_constant() const {
+                return _if_dependent_functions_constant();
+            }
+            
             virtual void operator() (const libMesh::Point& p,
                                      const Real t,
                                      RealMatrixX& m) const;
@@ -62,6 +66,10 @@ namespace MAST {
             
             virtual ~ExtensionBendingStiffnessMatrix() { }
             
+            virtual bool is_constant() const {
+                return _if_dependent_functions_constant();
+            }
+            
 
             virtual void operator() (const libMesh::Point& p,
                                      const Real t,
@@ -88,6 +96,10 @@ namespace MAST {
             
             virtual ~BendingStiffnessMatrix() { }
             
+            virtual bool is_constant() const {
+                return _if_dependent_functions_constant();
+            }
+            
             virtual void operator() (const libMesh::Point& p,
                                      const Real t,
                                      RealMatrixX& m) const;
@@ -120,6 +132,10 @@ namespace MAST {
             
             virtual ~TransverseStiffnessMatrix() { }
             
+            virtual bool is_constant() const {
+                return _if_dependent_functions_constant();
+            }
+            
             virtual void operator() (const libMesh::Point& p,
                                      const Real t,
                                      RealMatrixX& m) const {
@@ -158,6 +174,10 @@ namespace MAST {
             
             virtual ~InertiaMatrix() { }
             
+            virtual bool is_constant() const {
+                return _if_dependent_functions_constant();
+            }
+            
             
             virtual void operator() (const libMesh::Point& p,
                                      const Real t,
@@ -370,6 +390,15 @@ MAST::Solid2DSectionElementPropertyCard::depends_on(const MAST::FunctionBase& f)
 
 
 
+bool
+MAST::Solid2DSectionElementPropertyCard::is_constant() const {
+    
+    return _material->is_constant() &&            // check if the material property is constant
+    MAST::ElementPropertyCardBase::is_constant(); // check with this property card
+}
+
+
+
 
 MAST::Solid2DSectionProperty::ExtensionStiffnessMatrix::
 ExtensionStiffnessMatrix(const MAST::FieldFunction<RealMatrixX>& mat,
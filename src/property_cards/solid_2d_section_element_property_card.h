@@ -86,6 +86,14 @@ namespace MAST {
         virtual bool depends_on(const MAST::FunctionBase& f) const;
         
         
+        /*!
+         *  returns true if the section and material properties are
+         *  independent of location and time. The section stiffness
+         *  matrices can then be evaluated once per element.
+         */
+        virtual bool is_constant() const;
+        
+        
         virtual std::auto_ptr<MAST::FieldFunction<RealMatrixX> >
         stiffness_A_matrix(const MAST::ElementBase& e) const;
         
@@ -0,0 +1,422 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2017  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+// C++ includes
+#include <algorithm>
+#include <cmath>
+
+
+// MAST includes
+#include "solver/arc_length_continuation_solver.h"
+#include "elasticity/structural_nonlinear_assembly.h"
+#include "base/nonlinear_system.h"
+#include "base/parameter.h"
+#include "base/performance_log.h"
+
+
+// libMesh includes
+#include "libmesh/dof_map.h"
+#include "libmesh/parameter_vector.h"
+#include "libmesh/sparse_matrix.h"
+#include "libmesh/petsc_matrix.h"
+#include "libmesh/petsc_vector.h"
+
+
+
+MAST::ArcLengthContinuationSolver::ArcLengthContinuationSolver():
+arc_length(0.),
+min_arc_length(0.),
+max_arc_length(0.),
+load_scale(1.),
+desired_iterations(5),
+max_iterations(15),
+abs_tol(1.e-8),
+rel_tol(1.e-8),
+jacobian_lag(1),
+initial_direction(1.),
+_assembly(nullptr),
+_load_param(nullptr),
+_ksp(PETSC_NULL),
+_n_lagged_its(0),
+_n_steps(0),
+_n_iterations(0),
+_n_jacobian_updates(0),
+_dlambda_prev(0.) {
+    
+}
+
+
+
+MAST::ArcLengthContinuationSolver::~ArcLengthContinuationSolver() {
+    
+    this->clear();
+}
+
+
+
+void
+MAST::ArcLengthContinuationSolver::
+init(MAST::StructuralNonlinearAssembly& assembly,
+     MAST::Parameter& load_param) {
+    
+    this->clear();
+    
+    _assembly           = &assembly;
+    _load_param         = &load_param;
+    _n_steps            = 0;
+    _n_iterations       = 0;
+    _n_jacobian_updates = 0;
+    _dlambda_prev       = 0.;
+    _dX_prev.reset();
+}
+
+
+
+void
+MAST::ArcLengthContinuationSolver::clear() {
+    
+    if (!_ksp)
+        return;
+    
+    PetscErrorCode ierr = KSPDestroy(&_ksp);
+    CHKERRABORT(_assembly->system().comm().get(), ierr);
+    
+    _ksp          = PETSC_NULL;
+    _n_lagged_its = 0;
+}
+
+
+
+bool
+MAST::ArcLengthContinuationSolver::solve_step() {
+    
+    MAST_LOG_SCOPE("solve_step()", "ArcLengthContinuationSolver");
+    
+    libmesh_assert(_assembly);
+    libmesh_assert_greater(arc_length, 0.);
+    
+    MAST::NonlinearSystem& sys = _assembly->system();
+    
+    // the last converged point, which is restored after a rejected step
+    std::auto_ptr<libMesh::NumericVector<Real> >
+    X0(sys.solution->clone().release());
+    
+    const Real
+    lambda0 = (*_load_param)();
+    
+    unsigned int
+    n_its = 0;
+    
+    while (true) {
+        
+        if (this->_solve_step(*X0, lambda0, n_its)) {
+            
+            // data for the secant predictor of the next step
+            if (!_dX_prev.get())
+                _dX_prev.reset(sys.solution->zero_clone().release());
+            
+            *_dX_prev = *sys.solution;
+            _dX_prev->add(-1., *X0);
+            _dX_prev->close();
+            _dlambda_prev = (*_load_param)() - lambda0;
+            _n_steps++;
+            
+            // the arc length is scaled to reach the desired number of
+            // iterations in the next step
+            Real
+            f = std::sqrt(1.*desired_iterations/std::max(n_its, 1U));
+            f = std::max(0.5, std::min(2., f));
+            
+            arc_length  = std::max(min_arc_length, f * arc_length);
+            if (max_arc_length > 0.)
+                arc_length = std::min(max_arc_length, arc_length);
+            
+            return true;
+        }
+        
+        // the step is rejected and restarted with half the arc length
+        // from the last converged point
+        *sys.solution = *X0;
+        sys.solution->close();
+        sys.update();
+        (*_load_param)() = lambda0;
+        
+        if (arc_length <= min_arc_length)
+            return false;
+        
+        arc_length    = std::max(min_arc_length, 0.5 * arc_length);
+        _n_lagged_its = jacobian_lag;
+        
+        libMesh::out
+        << "Arc-length step rejected after " << n_its
+        << " iterations, arc length reduced to " << arc_length << std::endl;
+    }
+    
+    return false;
+}
+
+
+
+bool
+MAST::ArcLengthContinuationSolver::
+_solve_step(const libMesh::NumericVector<Real>& X0,
+            const Real lambda0,
+            unsigned int& n_its) {
+    
+    MAST::NonlinearSystem& sys = _assembly->system();
+    
+    n_its = 0;
+    
+    std::auto_ptr<libMesh::NumericVector<Real> >
+    R  (sys.solution->zero_clone().release()),
+    q  (sys.solution->zero_clone().release()),
+    dxR(sys.solution->zero_clone().release()),
+    dxF(sys.solution->zero_clone().release()),
+    dx (sys.solution->zero_clone().release()),
+    Dx (sys.solution->zero_clone().release());
+    
+    const Real
+    psi2 = load_scale * load_scale;
+    
+    Real
+    Dlambda = 0.;
+    
+    //////////////////////////////////////////////////////////////////
+    //   predictor
+    //////////////////////////////////////////////////////////////////
+    if (!_n_steps) {
+        
+        // tangent predictor along J^{-1} (-dR/dlambda) about the
+        // initial point
+        if (!_ksp)
+            this->_update_jacobian();
+        
+        this->_load_vector(*q);
+        this->_linear_solve(*q, *dxF);
+        
+        Dlambda = (initial_direction < 0.)? -1. : 1.;
+        Dlambda *= arc_length / std::sqrt(dxF->dot(*dxF) + psi2);
+        
+        *Dx = *dxF;
+        Dx->scale(Dlambda);
+    }
+    else {
+        
+        // secant predictor scaled from the last converged step
+        const Real
+        ds_prev = std::sqrt(_dX_prev->dot(*_dX_prev) +
+                            psi2 * _dlambda_prev * _dlambda_prev),
+        f       = arc_length/ds_prev;
+        
+        *Dx = *_dX_prev;
+        Dx->scale(f);
+        Dlambda = f * _dlambda_prev;
+    }
+    Dx->close();
+    
+    _assembly->update_incompatible_solution(*sys.solution, *Dx);
+    
+    sys.solution->add(1., *Dx);
+    sys.solution->close();
+    sys.update();
+    (*_load_param)() = lambda0 + Dlambda;
+    
+    //////////////////////////////////////////////////////////////////
+    //   corrector iterations on the arc-length constraint
+    //////////////////////////////////////////////////////////////////
+    Real
+    r_prev = 0.;
+    
+    while (true) {
+        
+        _assembly->residual_and_jacobian(*sys.solution, R.get(), nullptr, sys);
+        this->_load_vector(*q);
+        
+        const Real
+        r     = R->l2_norm(),
+        r_ref = std::fabs((*_load_param)()) * q->l2_norm();
+        
+        libMesh::out
+        << "Arc-length iter: " << n_its
+        << " : load = " << (*_load_param)()
+        << " : ||R|| = " << r << std::endl;
+        
+        if (r <= abs_tol || r <= rel_tol * r_ref)
+            return true;
+        
+        if (n_its == max_iterations)
+            return false;
+        
+        // the factorization is updated after the lag, or if the
+        // residual grows with the lagged Jacobian
+        if (!_ksp ||
+            _n_lagged_its >= jacobian_lag ||
+            (n_its && r > r_prev))
+            this->_update_jacobian();
+        
+        r_prev = r;
+        n_its++;
+        _n_iterations++;
+        _n_lagged_its++;
+        
+        R->scale(-1.);
+        R->close();
+        this->_linear_solve(*R, *dxR);
+        this->_linear_solve(*q, *dxF);
+        
+        // the load correction satisfies the constraint on the updated
+        // increments Dx + dxR + dlambda dxF and Dlambda + dlambda,
+        //   a dlambda^2 + b dlambda + c = 0
+        *dx = *Dx;
+        dx->add(1., *dxR);
+        dx->close();
+        
+        const Real
+        a    = dxF->dot(*dxF) + psi2,
+        b    = 2. * (dxF->dot(*dx) + psi2 * Dlambda),
+        c    = dx->dot(*dx) + psi2 * Dlambda * Dlambda - arc_length * arc_length,
+        disc = b * b - 4. * a * c;
+        
+        if (disc < 0.) {
+            
+            libMesh::out
+            << "Arc-length constraint has no real root" << std::endl;
+            return false;
+        }
+        
+        // of the two roots, the one with the increment closest to the
+        // increment of the previous iteration is chosen
+        const Real
+        dl1     = (-b + std::sqrt(disc))/(2. * a),
+        dl2     = (-b - std::sqrt(disc))/(2. * a),
+        Dx_dxR  = Dx->dot(*dx),
+        Dx_dxF  = Dx->dot(*dxF),
+        cos1    = Dx_dxR + dl1 * Dx_dxF + psi2 * Dlambda * (Dlambda + dl1),
+        cos2    = Dx_dxR + dl2 * Dx_dxF + psi2 * Dlambda * (Dlambda + dl2),
+        dlambda = (cos1 >= cos2)? dl1 : dl2;
+        
+        *dx = *dxR;
+        dx->add(dlambda, *dxF);
+        dx->close();
+        
+        _assembly->update_incompatible_solution(*sys.solution, *dx);
+        
+        sys.solution->add(1., *dx);
+        sys.solution->close();
+        sys.update();
+        
+        Dx->add(1., *dx);
+        Dx->close();
+        Dlambda          += dlambda;
+        (*_load_param)() += dlambda;
+    }
+    
+    return false;
+}
+
+
+
+void
+MAST::ArcLengthContinuationSolver::_update_jacobian() {
+    
+    MAST_LOG_SCOPE("update_jacobian()", "ArcLengthContinuationSolver");
+    
+    MAST::NonlinearSystem& sys = _assembly->system();
+    
+    _assembly->request_jacobian_update();
+    _assembly->residual_and_jacobian(*sys.solution, nullptr, sys.matrix, sys);
+    sys.matrix->close();
+    
+    PetscErrorCode ierr = 0;
+    
+    if (!_ksp) {
+        
+        Mat mat = dynamic_cast<libMesh::PetscMatrix<Real>*>(sys.matrix)->mat();
+        
+        ierr = KSPCreate(sys.comm().get(), &_ksp);
+        CHKERRABORT(sys.comm().get(), ierr);
+        
+        if (libMesh::on_command_line("--solver_system_names")) {
+            
+            std::string nm = sys.name() + "_arc_length_";
+            KSPSetOptionsPrefix(_ksp, nm.c_str());
+        }
+        
+        std::pair<unsigned int, Real>
+        solver_params = sys.get_linear_solve_parameters();
+        
+        ierr = KSPSetOperators(_ksp, mat, mat);
+        CHKERRABORT(sys.comm().get(), ierr);
+        ierr = KSPSetTolerances(_ksp,
+                                solver_params.second,
+                                PETSC_DEFAULT,
+                                PETSC_DEFAULT,
+                                solver_params.first);
+        CHKERRABORT(sys.comm().get(), ierr);
+        ierr = KSPSetFromOptions(_ksp);
+        CHKERRABORT(sys.comm().get(), ierr);
+    }
+    
+    // the preconditioner is refactorized here, and then reused by all
+    // solves until the next update
+    ierr = KSPSetUp(_ksp);
+    CHKERRABORT(sys.comm().get(), ierr);
+    
+    _n_lagged_its = 0;
+    _n_jacobian_updates++;
+}
+
+
+
+void
+MAST::ArcLengthContinuationSolver::_load_vector(libMesh::NumericVector<Real>& q) {
+    
+    libMesh::ParameterVector params;
+    params.resize(1);
+    params[0] = _load_param->ptr();
+    
+    q.zero();
+    _assembly->sensitivity_assemble(params, 0, q);
+}
+
+
+
+void
+MAST::ArcLengthContinuationSolver::
+_linear_solve(libMesh::NumericVector<Real>& b,
+              libMesh::NumericVector<Real>& x) {
+    
+    MAST_LOG_SCOPE("linear_solve()", "ArcLengthContinuationSolver");
+    
+    MAST::NonlinearSystem& sys = _assembly->system();
+    
+    libMesh::PetscVector<Real>
+    &rhs = dynamic_cast<libMesh::PetscVector<Real>&>(b),
+    &sol = dynamic_cast<libMesh::PetscVector<Real>&>(x);
+    
+    PetscErrorCode ierr = KSPSolve(_ksp, rhs.vec(), sol.vec());
+    CHKERRABORT(sys.comm().get(), ierr);
+    
+#ifdef LIBMESH_ENABLE_CONSTRAINTS
+    sys.get_dof_map().enforce_constraints_exactly
+    (sys, &x, /* homogeneous = */ true);
+#endif
+}
+
@@ -0,0 +1,252 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2017  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+#ifndef __mast__arc_length_continuation_solver__
+#define __mast__arc_length_continuation_solver__
+
+// C++ includes
+#include <memory>
+
+
+// MAST includes
+#include "base/mast_data_types.h"
+
+
+// libMesh includes
+#include "libmesh/numeric_vector.h"
+
+
+// PETSc includes
+#include <petscksp.h>
+
+
+namespace MAST {
+    
+    // Forward declerations
+    class StructuralNonlinearAssembly;
+    class Parameter;
+    
+    
+    /*!
+     *    Traces the equilibrium path \f$ R(x, \lambda) = 0 \f$ of a nonlinear
+     *    structural problem through limit points with the spherical
+     *    arc-length method of Crisfield, where \f$ \lambda \f$ is the
+     *    value of a load parameter. Each step satisfies the constraint
+     *    \f[ \{\Delta x\}^T \{\Delta x\} + \psi^2 \Delta\lambda^2 = \Delta s^2 \f]
+     *    on the increments from the last converged point. The first step
+     *    uses a tangent predictor, and the following steps a secant
+     *    predictor from the last two converged points. In each corrector
+     *    iteration, \f$ [J] \{\delta x_R\} = -\{R\} \f$ and
+     *    \f$ [J] \{\delta x_F\} = -\{\partial R/\partial \lambda\} \f$ are
+     *    solved with the same factorization, and \f$ \delta\lambda \f$ is
+     *    the root of the constraint closest to the previous direction.
+     *
+     *    The Jacobian is factorized every \p jacobian_lag iterations,
+     *    counted over consecutive steps, so that a factorization is reused
+     *    across steps, and is refactorized if the residual norm grows. The
+     *    arc length is scaled after each converged step by
+     *    \f$ \sqrt{N_d/N} \f$, where \f$ N \f$ is the number of corrector
+     *    iterations and \f$ N_d \f$ is \p desired_iterations, and is halved
+     *    if a step does not converge or the constraint has no real root.
+     *
+     *    The loads must depend on the parameter, which must be added to the
+     *    discipline, so that \f$ \partial R/\partial \lambda \f$ is
+     *    obtained from MAST::StructuralNonlinearAssembly::sensitivity_assemble().
+     *    The linear solver uses the options prefix
+     *    \p <system name>_arc_length_ if \p --solver_system_names is given.
+     */
+    class ArcLengthContinuationSolver {
+        
+    public:
+        
+        ArcLengthContinuationSolver();
+        
+        virtual ~ArcLengthContinuationSolver();
+        
+        /*!
+         *    arc length \f$ \Delta s \f$ of the next step. This is updated
+         *    after each step.
+         */
+        Real          arc_length;
+        
+        /*!
+         *    bounds on the arc length. The upper bound is not used if it
+         *    is zero.
+         */
+        Real          min_arc_length;
+        
+        Real          max_arc_length;
+        
+        /*!
+         *    scaling \f$ \psi \f$ of the load increment in the constraint
+         */
+        Real          load_scale;
+        
+        /*!
+         *    number of corrector iterations \f$ N_d \f$ for which the arc
+         *    length is kept unchanged
+         */
+        unsigned int  desired_iterations;
+        
+        /*!
+         *    maximum number of corrector iterations of a step
+         */
+        unsigned int  max_iterations;
+        
+        /*!
+         *    a step is converged if \f$ ||R|| \f$ is less than \p abs_tol, or
+         *    less than \p rel_tol times the norm of the load
+         *    \f$ ||\lambda \partial R/\partial \lambda|| \f$.
+         */
+        Real          abs_tol;
+        
+        Real          rel_tol;
+        
+        /*!
+         *    number of corrector iterations over which a factorization of
+         *    the Jacobian is reused. This is 1 by default, which gives
+         *    Newton's method.
+         */
+        unsigned int  jacobian_lag;
+        
+        /*!
+         *    sign of the load increment of the first step
+         */
+        Real          initial_direction;
+        
+        
+        /*!
+         *    sets the assembly and the load parameter, and resets the
+         *    path data so that the next step starts from the current
+         *    solution of the system and the current parameter value. The
+         *    objects must exist as long as this object is used.
+         */
+        void init(MAST::StructuralNonlinearAssembly& assembly,
+                  MAST::Parameter& load_param);
+        
+        
+        /*!
+         *    performs one step along the path, with as many reductions of
+         *    the arc length as needed. The converged solution and load are
+         *    left in the system solution and the load parameter.
+         *    @returns false if the step did not converge with the minimum
+         *    arc length, in which case the last converged point is restored.
+         */
+        bool solve_step();
+        
+        
+        /*!
+         *    deletes the factorization of the Jacobian
+         */
+        void clear();
+        
+        
+        /*!
+         *    @returns the number of converged steps since init()
+         */
+        unsigned int n_steps() const {
+            return _n_steps;
+        }
+        
+        /*!
+         *    @returns the number of corrector iterations since init(),
+         *    including those of rejected steps
+         */
+        unsigned int n_iterations() const {
+            return _n_iterations;
+        }
+        
+        /*!
+         *    @returns the number of factorizations of the Jacobian since init()
+         */
+        unsigned int n_jacobian_updates() const {
+            return _n_jacobian_updates;
+        }
+        
+    protected:
+        
+        /*!
+         *    attempts a step of arc length \p arc_length from the converged
+         *    point \p X0 and \p lambda0, and returns the number of corrector
+         *    iterations in \p n_its.
+         *    @returns true if the step converged.
+         */
+        bool _solve_step(const libMesh::NumericVector<Real>& X0,
+                         const Real lambda0,
+                         unsigned int& n_its);
+        
+        /*!
+         *    assembles and factorizes the Jacobian about the current solution
+         */
+        void _update_jacobian();
+        
+        /*!
+         *    assembles \f$ -\partial R/\partial \lambda \f$ about the current
+         *    solution in \p q
+         */
+        void _load_vector(libMesh::NumericVector<Real>& q);
+        
+        /*!
+         *    solves \f$ [J] \{x\} = \{b\} \f$ with the current factorization
+         */
+        void _linear_solve(libMesh::NumericVector<Real>& b,
+                           libMesh::NumericVector<Real>& x);
+        
+        /*!
+         *    assembly of the structural system
+         */
+        MAST::StructuralNonlinearAssembly*             _assembly;
+        
+        /*!
+         *    load parameter \f$ \lambda \f$
+         */
+        MAST::Parameter*                               _load_param;
+        
+        /*!
+         *    KSP with the factorization of the Jacobian
+         */
+        KSP                                            _ksp;
+        
+        /*!
+         *    number of iterations since the last factorization
+         */
+        unsigned int                                   _n_lagged_its;
+        
+        /*!
+         *    counters of the steps, iterations, and factorizations
+         */
+        unsigned int                                   _n_steps;
+        
+        unsigned int                                   _n_iterations;
+        
+        unsigned int                                   _n_jacobian_updates;
+        
+        /*!
+         *    increments of the solution and load of the last converged step,
+         *    used by the secant predictor
+         */
+        std::auto_ptr<libMesh::NumericVector<Real> >   _dX_prev;
+        
+        Real                                           _dlambda_prev;
+    };
+}
+
+
+#endif // __mast__arc_length_continuation_solver__
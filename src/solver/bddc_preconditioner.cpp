@@ -0,0 +1,150 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2017  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+// C++ includes
+#include <string>
+#include <vector>
+
+
+// MAST includes
+#include "solver/bddc_preconditioner.h"
+#include "base/nonlinear_system.h"
+#include "base/performance_log.h"
+#include "solver/petsc_options.h"
+
+
+// libMesh includes
+#include "libmesh/dof_map.h"
+#include "libmesh/petsc_matrix.h"
+
+
+MAST::BDDCPreconditioner::BDDCPreconditioner(MAST::NonlinearSystem& sys):
+libMesh::ParallelObject(sys.comm()),
+_sys(sys),
+_vertices(true),
+_edges(true),
+_faces(false) {
+    
+}
+
+
+
+MAST::BDDCPreconditioner::~BDDCPreconditioner() {
+    
+}
+
+
+
+void
+MAST::BDDCPreconditioner::set_primal_constraints(bool vertices,
+                                                 bool edges,
+                                                 bool faces) {
+    
+    _vertices = vertices;
+    _edges    = edges;
+    _faces    = faces;
+}
+
+
+
+void
+MAST::BDDCPreconditioner::configure_preconditioner(PC pc) {
+    
+    MAST_LOG_SCOPE("configure_preconditioner()", "BDDCPreconditioner");
+    
+    PetscErrorCode ierr = 0;
+    
+    // the operators of the PC of the nonlinear solver are only set by
+    // the SNES, and the system matrix is checked instead
+    Mat       P = dynamic_cast<libMesh::PetscMatrix<Real>*>(_sys.matrix)->mat();
+    PetscBool if_matis = PETSC_FALSE;
+    
+    ierr = PetscObjectTypeCompare((PetscObject)P, MATIS, &if_matis);
+    CHKERRABORT(this->comm().get(), ierr);
+    
+    if (!if_matis)
+        libmesh_error_msg("BDDC requires the MATIS storage of the matrices of "
+                          << _sys.name()
+                          << ", see MAST::NonlinearSystem::set_matrix_type()");
+    
+    // the primal constraints are set as defaults for the prefix of the
+    // PC, so that they can be changed from the command line
+    const char* prefix = PETSC_NULL;
+    ierr = PCGetOptionsPrefix(pc, &prefix);      CHKERRABORT(this->comm().get(), ierr);
+    
+    const std::string
+    p = std::string("-") + (prefix? prefix: "");
+    
+    MAST::set_default_petsc_option(p + "pc_bddc_use_vertices", _vertices? "true": "false");
+    MAST::set_default_petsc_option(p + "pc_bddc_use_edges",    _edges?    "true": "false");
+    MAST::set_default_petsc_option(p + "pc_bddc_use_faces",    _faces?    "true": "false");
+    
+    // the near null space attached to the matrix defines the constraints
+    MatNullSpace nnsp = PETSC_NULL;
+    ierr = MatGetNearNullSpace(P, &nnsp);        CHKERRABORT(this->comm().get(), ierr);
+    
+    if (nnsp)
+#if PETSC_VERSION_LESS_THAN(3,12,0)
+        MAST::set_default_petsc_option(p + "pc_bddc_use_nnsp_true", "true");
+#else
+        MAST::set_default_petsc_option(p + "pc_bddc_use_nnsp", "true");
+#endif
+    
+    ierr = PCSetType(pc, PCBDDC);                CHKERRABORT(this->comm().get(), ierr);
+    
+    // the locally owned dofs of each variable are a field
+    const unsigned int
+    n_vars = _sys.n_vars();
+    
+    if (n_vars > 1) {
+        
+        const libMesh::DofMap& dof_map = _sys.get_dof_map();
+        
+        std::vector<IS> fields(n_vars);
+        std::vector<libMesh::dof_id_type> dofs;
+        std::vector<PetscInt> idx;
+        
+        for (unsigned int i=0; i<n_vars; i++) {
+            
+            dofs.clear();
+            dof_map.local_variable_indices(dofs, _sys.get_mesh(), i);
+            
+            idx.assign(dofs.begin(), dofs.end());
+            
+            ierr = ISCreateGeneral(this->comm().get(),
+                                   (PetscInt)idx.size(),
+                                   idx.size()? &idx[0]: PETSC_NULL,
+                                   PETSC_COPY_VALUES,
+                                   &fields[i]);
+            CHKERRABORT(this->comm().get(), ierr);
+        }
+        
+        ierr = PCBDDCSetDofsSplitting(pc, (PetscInt)n_vars, &fields[0]);
+        CHKERRABORT(this->comm().get(), ierr);
+        
+        // the PC keeps a reference to the index sets
+        for (unsigned int i=0; i<n_vars; i++) {
+            ierr = ISDestroy(&fields[i]);        CHKERRABORT(this->comm().get(), ierr);
+        }
+    }
+    
+    ierr = PCSetFromOptions(pc);                 CHKERRABORT(this->comm().get(), ierr);
+}
+
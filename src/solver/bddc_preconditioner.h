@@ -0,0 +1,110 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2017  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+#ifndef __mast__bddc_preconditioner__
+#define __mast__bddc_preconditioner__
+
+
+// MAST includes
+#include "base/mast_data_types.h"
+
+
+// libMesh includes
+#include "libmesh/parallel_object.h"
+
+
+// PETSc includes
+#include <petscksp.h>
+
+
+namespace MAST {
+    
+    // Forward declerations
+    class NonlinearSystem;
+    
+    
+    /*!
+     *   Balancing domain decomposition by constraints (PCBDDC) for the
+     *   solves of a system whose matrices are stored unassembled by
+     *   subdomain. This storage is selected with
+     *   MAST::NonlinearSystem::set_matrix_type(MATIS) before the
+     *   equation systems are initialized. Each processor then stores the
+     *   matrix of its local elements, which is assembled with the
+     *   element loop of the assemblies, and PETSc only sums the subdomain
+     *   contributions when it needs them. This avoids the factorization
+     *   of the assembled matrix and the degradation of AMG for thin
+     *   shells and stiffened panels.
+     *
+     *   The coarse space is defined by primal constraints at the dofs
+     *   shared by subdomains. The default uses the subdomain corners
+     *   (vertices) and edges. The dofs of each variable are given to
+     *   PCBDDC as separate fields, so that the constraints are defined
+     *   for each displacement and rotation component. If the system has
+     *   a near null space function, the near null space is attached to
+     *   the matrix and PCBDDC uses it for the constraints. The PETSc
+     *   options of the PC can change all of these choices.
+     *
+     *   The preconditioner is used by the nonlinear, sensitivity and
+     *   adjoint solves of a system once it is attached with
+     *   MAST::NonlinearSystem::set_bddc_preconditioner(). The operator
+     *   should be solved with CG for symmetric structural problems.
+     */
+    class BDDCPreconditioner:
+    public libMesh::ParallelObject {
+        
+    public:
+        
+        BDDCPreconditioner(MAST::NonlinearSystem& sys);
+        
+        virtual ~BDDCPreconditioner();
+        
+        
+        /*!
+         *   selects the dofs on the subdomain interface that are used as
+         *   primal constraints: the subdomain corners, the averages over
+         *   the edges, and the averages over the faces.
+         */
+        void set_primal_constraints(bool vertices,
+                                    bool edges,
+                                    bool faces = false);
+        
+        
+        /*!
+         *   sets \p pc to PCBDDC. The operators of \p pc must be the
+         *   matrix of the system, which must use the MATIS storage.
+         */
+        void configure_preconditioner(PC pc);
+        
+    protected:
+        
+        /*!
+         *   system whose matrices are preconditioned
+         */
+        MAST::NonlinearSystem&      _sys;
+        
+        /*!
+         *   flags for the primal constraints
+         */
+        bool                        _vertices, _edges, _faces;
+    };
+}
+
+
+#endif // __mast__bddc_preconditioner__
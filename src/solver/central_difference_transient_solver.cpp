@@ -0,0 +1,219 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2017  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+// C++ includes
+#include <cmath>
+
+// MAST includes
+#include "solver/central_difference_transient_solver.h"
+#include "base/nonlinear_system.h"
+#include "base/performance_log.h"
+
+// libMesh includes
+#include "libmesh/numeric_vector.h"
+#include "libmesh/sparse_matrix.h"
+#include "libmesh/dof_map.h"
+
+
+MAST::CentralDifferenceTransientSolver::CentralDifferenceTransientSolver():
+MAST::SecondOrderNewmarkTransientSolver(),
+_half_step_velocity(false)
+{ }
+
+
+MAST::CentralDifferenceTransientSolver::~CentralDifferenceTransientSolver()
+{ }
+
+
+
+void
+MAST::CentralDifferenceTransientSolver::clear_mass() {
+    
+    _inv_mass.reset();
+    _half_step_velocity = false;
+}
+
+
+
+void
+MAST::CentralDifferenceTransientSolver::_init_inverse_mass() {
+    
+    if (_inv_mass.get())
+        return;
+    
+    // in the highest derivative mode the Jacobian is the mass matrix
+    _if_highest_derivative_solution = true;
+    _system->assembly(true, true);
+    _if_highest_derivative_solution = false;
+    
+    _inv_mass.reset(_system->solution->zero_clone().release());
+    _system->matrix->get_diagonal(*_inv_mass);
+    _inv_mass->close();
+    _inv_mass->reciprocal();
+    _inv_mass->close();
+}
+
+
+
+void
+MAST::CentralDifferenceTransientSolver::_assemble_residual() {
+    
+    _if_highest_derivative_solution = true;
+    _system->assembly(true, false);
+    _if_highest_derivative_solution = false;
+}
+
+
+
+void
+MAST::CentralDifferenceTransientSolver::solve() {
+    
+    // make sure that the system has been specified
+    libmesh_assert_msg(_system, "System pointer is nullptr.");
+    libmesh_assert_msg(!_adaptive_time_step,
+                       "Adaptive time step is not supported by the explicit solver.");
+    
+    MAST_LOG_SCOPE("solve()", "CentralDifferenceTransientSolver");
+    
+    if (!_inv_mass.get())
+        this->_init_inverse_mass();
+    else
+        this->_assemble_residual();
+    
+    // the residual is
+    //    r(x_n, x_dot, x_ddot) = M x_ddot + f(x_n, x_dot),
+    // which is evaluated with the current acceleration, so that the
+    // acceleration increment is  -M^{-1} r
+    std::auto_ptr<libMesh::NumericVector<Real> >
+    dvec(acceleration().zero_clone().release());
+    
+    dvec->pointwise_mult(*_system->rhs, *_inv_mass);
+    dvec->close();
+    
+    libMesh::NumericVector<Real>
+    &acc = acceleration(),
+    &vel = velocity();
+    
+    acc.add(-1., *dvec);
+    acc.close();
+    
+#ifdef LIBMESH_ENABLE_CONSTRAINTS
+    _system->get_dof_map().enforce_constraints_exactly
+    (*_system, &acc, /* homogeneous = */ true);
+#endif
+    
+    // x_dot_{n+1/2} = x_dot_{n-1/2} + dt x_ddot_n, with a half step
+    // from the initial velocity
+    vel.add(_half_step_velocity? dt: 0.5*dt, acc);
+    vel.close();
+    _half_step_velocity = true;
+    
+    // x_{n+1} = x_n + dt x_dot_{n+1/2}
+    _system->solution->add(dt, vel);
+    _system->solution->close();
+    _system->update();
+}
+
+
+
+Real
+MAST::CentralDifferenceTransientSolver::critical_time_step(unsigned int n_iters) {
+    
+    libmesh_assert_msg(_system, "System pointer is nullptr.");
+    libmesh_assert_greater(n_iters, 0);
+    
+    MAST_LOG_SCOPE("critical_time_step()", "CentralDifferenceTransientSolver");
+    
+    this->_init_inverse_mass();
+    
+    libMesh::NumericVector<Real>& sol = *_system->solution;
+    
+    std::auto_ptr<libMesh::NumericVector<Real> >
+    x0(sol.clone().release()),
+    r0(sol.zero_clone().release()),
+    v (sol.zero_clone().release()),
+    w (sol.zero_clone().release());
+    
+    // residual at the current solution
+    this->_assemble_residual();
+    *r0 = *_system->rhs;
+    r0->close();
+    
+    // starting vector with entries of varying sign, since a smooth
+    // vector is nearly orthogonal to the highest modes
+    for (libMesh::numeric_index_type i=v->first_local_index(); i<v->last_local_index(); i++)
+        v->set(i, std::sin(1.+i));
+    v->close();
+    
+#ifdef LIBMESH_ENABLE_CONSTRAINTS
+    _system->get_dof_map().enforce_constraints_exactly
+    (*_system, v.get(), /* homogeneous = */ true);
+#endif
+    
+    v->scale(1./v->l2_norm());
+    
+    const Real
+    eps = 1.e-6 * std::max(1., x0->linfty_norm());
+    
+    Real
+    lambda = 0.;
+    
+    for (unsigned int i=0; i<n_iters; i++) {
+        
+        // K v = (r(x0 + eps v) - r(x0))/eps
+        sol = *x0;
+        sol.add(eps, *v);
+        sol.close();
+        _system->update();
+        
+        this->_assemble_residual();
+        
+        w->zero();
+        w->add( 1./eps, *_system->rhs);
+        w->add(-1./eps, *r0);
+        w->close();
+        
+        // M^{-1} K v
+        w->pointwise_mult(*w, *_inv_mass);
+        w->close();
+        
+#ifdef LIBMESH_ENABLE_CONSTRAINTS
+        _system->get_dof_map().enforce_constraints_exactly
+        (*_system, w.get(), /* homogeneous = */ true);
+#endif
+        
+        lambda = w->l2_norm();
+        if (lambda == 0.)
+            break;
+        
+        *v = *w;
+        v->scale(1./lambda);
+        v->close();
+    }
+    
+    // restore the solution
+    sol = *x0;
+    sol.close();
+    _system->update();
+    
+    libmesh_assert_greater(lambda, 0.);
+    
+    return 2./std::sqrt(lambda);
+}
+
@@ -0,0 +1,116 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2017  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef __mast__central_difference_transient_solver__
+#define __mast__central_difference_transient_solver__
+
+// C++ includes
+#include <memory>
+
+// MAST includes
+#include "solver/second_order_newmark_transient_solver.h"
+
+
+namespace MAST {
+    
+    
+    /*!
+     *    Explicit central difference integration of a second-order ODE
+     *    \f[ [M] \ddot{x} + f(x, \dot{x}) = 0 \f]
+     *    with a diagonal [M], which is obtained with a diagonal mass
+     *    matrix in the element property cards (see
+     *    MAST::ElementPropertyCardBase::set_diagonal_mass_matrix() and
+     *    MAST::ElementPropertyCardBase::set_mass_lumping_scheme()). The
+     *    velocity is stored at the half steps, and a time step is
+     *    \f{eqnarray*}{
+     *     \ddot{x}_n  &=& -[M]^{-1} f(x_n, \dot{x}_{n-1/2}) \\
+     *     \dot{x}_{n+1/2} &=& \dot{x}_{n-1/2} + dt \ddot{x}_n \\
+     *     x_{n+1}     &=& x_n + dt \dot{x}_{n+1/2}
+     *    \f}
+     *    where the first step uses half of the time step for the velocity.
+     *    The damping forces use the velocity of the previous half step.
+     *    The residual is assembled in the highest derivative mode of the
+     *    parent class, and [M] is inverted entry-wise, so that no linear
+     *    solution is needed. The inverse of the diagonal of the mass
+     *    matrix is computed on the first step and reused until
+     *    clear_mass() is called.
+     *
+     *    The scheme is stable for \f$ dt \le 2/\omega_{max} \f$, which
+     *    can be estimated with critical_time_step(). Adaptive time
+     *    stepping is not supported.
+     */
+    class CentralDifferenceTransientSolver:
+    public MAST::SecondOrderNewmarkTransientSolver {
+    public:
+        
+        CentralDifferenceTransientSolver();
+        
+        virtual ~CentralDifferenceTransientSolver();
+        
+        /*!
+         *   computes the solution at the end of the current time step
+         */
+        virtual void solve();
+        
+        /*!
+         *   clears the inverse of the mass matrix, which is recomputed
+         *   on the next step, and restarts the half step velocity
+         */
+        void clear_mass();
+        
+        /*!
+         *   estimates the critical time step \f$ 2/\omega_{max} \f$ at the
+         *   current solution, where \f$ \omega_{max}^2 \f$ is the largest
+         *   eigenvalue of \f$ [M]^{-1}[K] \f$ obtained with \p n_iters power
+         *   iterations. The products with the tangent stiffness [K] are
+         *   computed by differences of the residual, so that no matrix is
+         *   assembled. Damping is not included, and the result should be
+         *   multiplied by a safety factor.
+         */
+        Real critical_time_step(unsigned int n_iters = 20);
+        
+    protected:
+        
+        /*!
+         *   computes the inverse of the diagonal of the mass matrix, if
+         *   not already available
+         */
+        void _init_inverse_mass();
+        
+        /*!
+         *   assembles the residual at the current solution with the
+         *   current velocity and acceleration
+         */
+        void _assemble_residual();
+        
+        /*!
+         *   inverse of the diagonal of the mass matrix
+         */
+        std::auto_ptr<libMesh::NumericVector<Real> > _inv_mass;
+        
+        /*!
+         *   \p true once the velocity has been advanced to the first
+         *   half step
+         */
+        bool _half_step_velocity;
+    };
+}
+
+
+#endif // __mast__central_difference_transient_solver__
@@ -22,6 +22,8 @@
 #include "solver/complex_solver_base.h"
 #include "base/complex_assembly_base.h"
 #include "base/nonlinear_system.h"
+#include "base/performance_log.h"
+#include "solver/hybrid_parallel_configuration.h"
 
 
 // libMesh includes
@@ -39,7 +41,15 @@
 MAST::ComplexSolverBase::ComplexSolverBase():
 _assembly(nullptr),
 tol(1.0e-3),
-max_iters(20) {
+max_iters(20),
+use_complex_matrix(false),
+reuse_block_matrix(true),
+_block_mat(nullptr),
+_block_res(nullptr),
+_block_sol(nullptr),
+_block_ksp(nullptr),
+_block_n_dofs(0),
+_parallel_config(nullptr) {
     
 }
 
@@ -47,6 +57,7 @@ max_iters(20) {
 
 MAST::ComplexSolverBase::~ComplexSolverBase() {
     
+    this->clear_block_matrix();
 }
 
 
@@ -55,6 +66,7 @@ MAST::ComplexSolverBase::~ComplexSolverBase() {
 void
 MAST::ComplexSolverBase::set_assembly(MAST::ComplexAssemblyBase& assembly) {
     
+    this->clear_block_matrix();
     _assembly = &assembly;
 }
 
@@ -63,11 +75,41 @@ MAST::ComplexSolverBase::set_assembly(MAST::ComplexAssemblyBase& assembly) {
 void
 MAST::ComplexSolverBase::clear_assembly() {
     
+    this->clear_block_matrix();
     _assembly = nullptr;
 }
 
 
 
+void
+MAST::ComplexSolverBase::clear_block_matrix() {
+    
+    if (!_block_mat)
+        return;
+    
+    // the communicator is obtained from the matrix, since the assembly
+    // may not be available
+    MPI_Comm
+    comm = PetscObjectComm((PetscObject)_block_mat);
+    
+    PetscErrorCode   ierr;
+    
+    ierr = KSPDestroy(&_block_ksp);           CHKERRABORT(comm, ierr);
+    ierr = MatDestroy(&_block_mat);           CHKERRABORT(comm, ierr);
+    ierr = VecDestroy(&_block_res);           CHKERRABORT(comm, ierr);
+    ierr = VecDestroy(&_block_sol);           CHKERRABORT(comm, ierr);
+    
+    _block_mat    = nullptr;
+    _block_res    = nullptr;
+    _block_sol    = nullptr;
+    _block_ksp    = nullptr;
+    _block_n_dofs = 0;
+    _block_n_nz.clear();
+    _block_n_oz.clear();
+}
+
+
+
 
 libMesh::NumericVector<Real>&
 MAST::ComplexSolverBase::real_solution(bool if_sens) {
@@ -380,82 +422,29 @@ MAST::ComplexSolverBase::solve_pc_fieldsplit() {
 void
 MAST::ComplexSolverBase::solve_block_matrix(MAST::Parameter* p)  {
     
+    // the complex matrix is factored serially, so the parallel block
+    // solve is used on more than one processor
+    if (use_complex_matrix &&
+        _assembly->system().comm().size() == 1) {
+        
+        this->solve_complex_matrix(p);
+        return;
+    }
+    
     START_LOG("solve_block_matrix()", "ComplexSolve");
     
     // get reference to the system
     MAST::NonlinearSystem& sys =
     dynamic_cast<MAST::NonlinearSystem&>(_assembly->system());
     
-    libMesh::DofMap& dof_map = sys.get_dof_map();
-    
-    const PetscInt
-    my_m = dof_map.n_dofs(),
-    my_n = my_m,
-    n_l  = dof_map.n_dofs_on_processor(sys.processor_id()),
-    m_l  = n_l;
-    
-    const std::vector<libMesh::dof_id_type>
-    & n_nz       = dof_map.get_n_nz(),
-    & n_oz       = dof_map.get_n_oz();
-    
-    std::vector<libMesh::dof_id_type>
-    complex_n_nz (2*n_nz.size()),
-    complex_n_oz (2*n_oz.size());
-    
-    // create the n_nz and n_oz for the complex matrix without block format
-    for (unsigned int i=0; i<n_nz.size(); i++) {
-        
-        complex_n_nz[2*i]   = 2*n_nz[i];
-        complex_n_nz[2*i+1] = 2*n_nz[i];
-    }
-    
-    for (unsigned int i=0; i<n_oz.size(); i++) {
-        
-        complex_n_oz[2*i]   = 2*n_oz[i];
-        complex_n_oz[2*i+1] = 2*n_oz[i];
-    }
-    
-    
-    
-    // create the matrix
+    // create the matrix, vectors and KSP, or reuse them from the
+    // previous solve
     PetscErrorCode   ierr;
-    Mat              mat;
-    
-    ierr = MatCreate(sys.comm().get(), &mat);                      CHKERRABORT(sys.comm().get(), ierr);
-    ierr = MatSetSizes(mat, 2*m_l, 2*n_l, 2*my_m, 2*my_n);         CHKERRABORT(sys.comm().get(), ierr);
-
-    if (libMesh::on_command_line("--solver_system_names")) {
-        
-        std::string nm = _assembly->system().name() + "_complex_";
-        MatSetOptionsPrefix(mat, nm.c_str());
-    }
-    ierr = MatSetFromOptions(mat);                                 CHKERRABORT(sys.comm().get(), ierr);
     
-    //ierr = MatSetType(mat, MATBAIJ);                                CHKERRABORT(sys.comm().get(), ierr);
-    ierr = MatSetBlockSize(mat, 2);                                CHKERRABORT(sys.comm().get(), ierr);
-    ierr = MatSeqAIJSetPreallocation(mat,
-                                     2*my_m,
-                                     (PetscInt*)&complex_n_nz[0]); CHKERRABORT(sys.comm().get(), ierr);
-    ierr = MatMPIAIJSetPreallocation(mat,
-                                     0,
-                                     (PetscInt*)&complex_n_nz[0],
-                                     0,
-                                     (PetscInt*)&complex_n_oz[0]); CHKERRABORT(sys.comm().get(), ierr);
-    ierr = MatSeqBAIJSetPreallocation (mat, 2,
-                                       0, (PetscInt*)&n_nz[0]);    CHKERRABORT(sys.comm().get(), ierr);
-    ierr = MatMPIBAIJSetPreallocation (mat, 2,
-                                       0, (PetscInt*)&n_nz[0],
-                                       0, (PetscInt*)&n_oz[0]);    CHKERRABORT(sys.comm().get(), ierr);
-    ierr = MatSetOption(mat,
-                        MAT_NEW_NONZERO_ALLOCATION_ERR,
-                        PETSC_TRUE);                               CHKERRABORT(sys.comm().get(), ierr);
+    _init_block_matrix();
     
-    
-    // now create the vectors
-    Vec              res_vec, sol_vec;
-    
-    ierr = MatCreateVecs(mat, &res_vec, PETSC_NULL);               CHKERRABORT(sys.comm().get(), ierr);
-    ierr = MatCreateVecs(mat, &sol_vec, PETSC_NULL);               CHKERRABORT(sys.comm().get(), ierr);
+    Mat              mat     = _block_mat;
+    Vec              res_vec = _block_res, sol_vec = _block_sol;
     
     
     std::auto_ptr<libMesh::SparseMatrix<Real> >
@@ -487,41 +476,35 @@ MAST::ComplexSolverBase::solve_block_matrix(MAST::Parameter* p)  {
         
         sol->close();
     }
+    else {
+        
+        // the vector may have the solution of a previous solve
+        sol->zero();
+        sol->close();
+    }
     
     
     // assemble the matrix
     _assembly->residual_and_jacobian_blocked(*sol,
                                              *res,
-                                             *jac_mat,
+                                             jac_mat.get(),
                                              sys,
                                              p);
     
     
-    // now initialize the KSP and ask for solution.
-    KSP        ksp;
-    PC         pc;
-    
-    // setup the KSP
-    ierr = KSPCreate(sys.comm().get(), &ksp); CHKERRABORT(sys.comm().get(), ierr);
-    
-    if (libMesh::on_command_line("--solver_system_names")) {
-        
-        std::string nm = _assembly->system().name() + "_complex_";
-        KSPSetOptionsPrefix(ksp, nm.c_str());
-    }
-    
-    ierr = KSPSetOperators(ksp, mat, mat);    CHKERRABORT(sys.comm().get(), ierr);
-    ierr = KSPSetFromOptions(ksp);            CHKERRABORT(sys.comm().get(), ierr);
-    
-    // setup the PC
-    ierr = KSPGetPC(ksp, &pc);                CHKERRABORT(sys.comm().get(), ierr);
-    ierr = PCSetFromOptions(pc);              CHKERRABORT(sys.comm().get(), ierr);
+    // the KSP was set up with the matrix in _init_block_matrix(). Since
+    // the nonzero pattern is unchanged, the preconditioner only
+    // recomputes its numeric factorization for the new values.
+    KSP        ksp = _block_ksp;
     
     
     START_LOG("KSPSolve", "ComplexSolve");
     
     // now solve
-    ierr = KSPSolve(ksp, res_vec, sol_vec);
+    {
+        MAST_LOG_SCOPE("KSPSolve", "ComplexSolverBase");
+        ierr = KSPSolve(ksp, res_vec, sol_vec);
+    }
 
     STOP_LOG("KSPSolve", "ComplexSolve");
     
@@ -550,14 +533,605 @@ MAST::ComplexSolverBase::solve_block_matrix(MAST::Parameter* p)  {
     sol_I.close();
     sol->close();
     
+    jac_mat.reset();
+    res.reset();
+    sol.reset();
+    
+    if (!reuse_block_matrix)
+        this->clear_block_matrix();
+    
+    STOP_LOG("solve_block_matrix()", "ComplexSolve");
+}
+
+
+
+
+void
+MAST::ComplexSolverBase::solve_complex_matrix(MAST::Parameter* p)  {
+    
+    MAST_LOG_SCOPE("solve_complex_matrix()", "ComplexSolverBase");
+    
+    // get reference to the system
+    MAST::NonlinearSystem& sys =
+    dynamic_cast<MAST::NonlinearSystem&>(_assembly->system());
+    
+    if (sys.comm().size() > 1)
+        libmesh_error_msg("Error: solve_complex_matrix() is limited to serial runs.");
+    
+    const unsigned int
+    n_dofs = sys.n_dofs();
+    
+    // the current solution is used for the sensitivity analysis
+    std::auto_ptr<libMesh::NumericVector<Real> >
+    zero(this->real_solution().zero_clone().release());
+    
+    const libMesh::NumericVector<Real>
+    &X_R = p? this->real_solution(): *zero,
+    &X_I = p? this->imag_solution(): *zero;
+    
+    ComplexVectorX
+    res = ComplexVectorX::Zero(n_dofs),
+    sol = ComplexVectorX::Zero(n_dofs);
+    
+    std::vector<Eigen::Triplet<Complex> > jac;
+    
+    _assembly->residual_and_jacobian_complex(X_R, X_I, res, jac, sys, p);
+    
+    // duplicate entries from different elements are summed
+    Eigen::SparseMatrix<Complex> mat(n_dofs, n_dofs);
+    mat.setFromTriplets(jac.begin(), jac.end());
+    mat.makeCompressed();
+    jac.clear();
+    
+    Eigen::SparseLU<Eigen::SparseMatrix<Complex>, Eigen::COLAMDOrdering<int> >
+    solver;
+    
+    {
+        MAST_LOG_SCOPE("SparseLU", "ComplexSolverBase");
+        solver.compute(mat);
+        
+        if (solver.info() != Eigen::Success)
+            libmesh_error_msg("Error! Complex sparse LU factorization failed: "
+                              << solver.lastErrorMessage());
+        
+        sol = -solver.solve(res);
+    }
+    
+    
+    // copy the solution to separate real and imaginary vectors
+    libMesh::NumericVector<Real>
+    &sol_R = this->real_solution(p != nullptr),
+    &sol_I = this->imag_solution(p != nullptr);
+    
+    unsigned int
+    first = sol_R.first_local_index(),
+    last  = sol_R.last_local_index();
+    
+    for (unsigned int i=first; i<last; i++) {
+        sol_R.set(i, std::real(sol(i)));
+        sol_I.set(i, std::imag(sol(i)));
+    }
+    
+    sol_R.close();
+    sol_I.close();
+}
+
+
+
+std::auto_ptr<libMesh::NumericVector<Real> >
+MAST::ComplexSolverBase::assemble_block_rhs() {
+    
+    MAST_LOG_SCOPE("assemble_block_rhs()", "ComplexSolverBase");
+    
+    // get reference to the system
+    MAST::NonlinearSystem& sys =
+    dynamic_cast<MAST::NonlinearSystem&>(_assembly->system());
+    
+    std::auto_ptr<libMesh::NumericVector<Real> >
+    rhs(libMesh::NumericVector<Real>::build(sys.comm()).release()),
+    sol(libMesh::NumericVector<Real>::build(sys.comm()).release());
+    
+    rhs->init(2*sys.n_dofs(), 2*sys.n_local_dofs(), false, libMesh::PARALLEL);
+    sol->init(2*sys.n_dofs(), 2*sys.n_local_dofs(), false, libMesh::PARALLEL);
+    sol->zero();
+    sol->close();
+    
+    // only the residual is needed
+    _assembly->residual_and_jacobian_blocked(*sol, *rhs, nullptr, sys);
+    
+    return rhs;
+}
+
+
+
+
+void
+MAST::ComplexSolverBase::
+solve_block_matrix_multiple_rhs(const std::vector<libMesh::NumericVector<Real>*>& rhs,
+                                std::vector<libMesh::NumericVector<Real>*>& sol_R,
+                                std::vector<libMesh::NumericVector<Real>*>& sol_I) {
+    
+    MAST_LOG_SCOPE("solve_block_matrix_multiple_rhs()", "ComplexSolverBase");
+    
+    libmesh_assert_equal_to(sol_R.size(), rhs.size());
+    libmesh_assert_equal_to(sol_I.size(), rhs.size());
+    
+    // get reference to the system
+    MAST::NonlinearSystem& sys =
+    dynamic_cast<MAST::NonlinearSystem&>(_assembly->system());
+    
+    PetscErrorCode   ierr;
+    
+    _init_block_matrix();
+    
+    Mat              mat     = _block_mat;
+    Vec              res_vec = _block_res, sol_vec = _block_sol;
+    
+    // the matrix is independent of the right-hand side, and is
+    // assembled only once
+    {
+        std::auto_ptr<libMesh::SparseMatrix<Real> >
+        jac_mat(new libMesh::PetscMatrix<Real>(mat, sys.comm()));
+        
+        std::auto_ptr<libMesh::NumericVector<Real> >
+        res(new libMesh::PetscVector<Real>(res_vec, sys.comm())),
+        sol(new libMesh::PetscVector<Real>(sol_vec, sys.comm()));
+        
+        sol->zero();
+        sol->close();
+        
+        _assembly->residual_and_jacobian_blocked(*sol, *res, jac_mat.get(), sys);
+    }
+    
+    
+    // setup the KSP. The preconditioner is set up with the first solve,
+    // and is reused for the subsequent right-hand sides.
+    KSP        ksp = _block_ksp;
+    
+    ierr = KSPSetUp(ksp);                     CHKERRABORT(sys.comm().get(), ierr);
+    
+    
+    for (unsigned int i=0; i<rhs.size(); i++) {
+        
+        ierr = VecCopy(dynamic_cast<libMesh::PetscVector<Real>*>(rhs[i])->vec(),
+                       res_vec);                                        CHKERRABORT(sys.comm().get(), ierr);
+        
+        {
+            MAST_LOG_SCOPE("KSPSolve", "ComplexSolverBase");
+            ierr = KSPSolve(ksp, res_vec, sol_vec);                     CHKERRABORT(sys.comm().get(), ierr);
+        }
+        
+        // copy the solution to separate real and imaginary vectors
+        libMesh::PetscVector<Real> sol(sol_vec, sys.comm());
+        
+        libMesh::NumericVector<Real>
+        &s_R = *sol_R[i],
+        &s_I = *sol_I[i];
+        
+        unsigned int
+        first = s_R.first_local_index(),
+        last  = s_R.last_local_index();
+        
+        for (unsigned int j=first; j<last; j++) {
+            s_R.set(j, sol(  2*j));
+            s_I.set(j, sol(2*j+1));
+        }
+        
+        s_R.close();
+        s_I.close();
+    }
+    
+    if (!reuse_block_matrix)
+        this->clear_block_matrix();
+}
+
+
+
+void
+MAST::ComplexSolverBase::
+solve_block_matrix_multi_frequency(const std::vector<Real>& omega,
+                                   std::vector<libMesh::NumericVector<Real>*>& sol_R,
+                                   std::vector<libMesh::NumericVector<Real>*>& sol_I) {
+    
+    MAST_LOG_SCOPE("solve_block_matrix_multi_frequency()", "ComplexSolverBase");
+    
+    libmesh_assert_equal_to(sol_R.size(), omega.size());
+    libmesh_assert_equal_to(sol_I.size(), omega.size());
+    
+    // get reference to the system
+    MAST::NonlinearSystem& sys =
+    dynamic_cast<MAST::NonlinearSystem&>(_assembly->system());
+    
+    PetscErrorCode   ierr;
+    Mat              mat0, mat1, mat;
+    Vec              res0_vec, res1_vec, res_vec, sol_vec;
+    
+    _create_block_matrix(mat0);
+    _create_block_matrix(mat1);
+    
+    ierr = MatCreateVecs(mat0, &res0_vec, PETSC_NULL);             CHKERRABORT(sys.comm().get(), ierr);
+    ierr = MatCreateVecs(mat0, &res1_vec, PETSC_NULL);             CHKERRABORT(sys.comm().get(), ierr);
+    ierr = MatCreateVecs(mat0, &res_vec,  PETSC_NULL);             CHKERRABORT(sys.comm().get(), ierr);
+    ierr = MatCreateVecs(mat0, &sol_vec,  PETSC_NULL);             CHKERRABORT(sys.comm().get(), ierr);
+    
+    {
+        std::auto_ptr<libMesh::SparseMatrix<Real> >
+        jac0(new libMesh::PetscMatrix<Real>(mat0, sys.comm())),
+        jac1(new libMesh::PetscMatrix<Real>(mat1, sys.comm()));
+        
+        std::auto_ptr<libMesh::NumericVector<Real> >
+        res0(new libMesh::PetscVector<Real>(res0_vec, sys.comm())),
+        res1(new libMesh::PetscVector<Real>(res1_vec, sys.comm())),
+        sol(new libMesh::PetscVector<Real>(sol_vec, sys.comm()));
+        
+        sol->zero();
+        sol->close();
+        
+        // the frequency independent and the frequency coefficient
+        // operators are assembled only once for all frequencies
+        _assembly->set_frequency_operator(MAST::FREQUENCY_INDEPENDENT_OPERATOR);
+        _assembly->residual_and_jacobian_blocked(*sol, *res0, jac0.get(), sys);
+        
+        _assembly->set_frequency_operator(MAST::FREQUENCY_COEFFICIENT_OPERATOR);
+        _assembly->residual_and_jacobian_blocked(*sol, *res1, jac1.get(), sys);
+        
+        _assembly->set_frequency_operator(MAST::FULL_FREQUENCY_OPERATOR);
+    }
+    
+    ierr = MatDuplicate(mat0, MAT_COPY_VALUES, &mat);              CHKERRABORT(sys.comm().get(), ierr);
+    
+    
+    // setup the KSP, which is shared by all frequencies
+    KSP        ksp;
+    PC         pc;
+    
+    ierr = KSPCreate(sys.comm().get(), &ksp); CHKERRABORT(sys.comm().get(), ierr);
+    
+    if (libMesh::on_command_line("--solver_system_names")) {
+        
+        std::string nm = _assembly->system().name() + "_complex_";
+        KSPSetOptionsPrefix(ksp, nm.c_str());
+    }
+    
+    ierr = KSPSetFromOptions(ksp);            CHKERRABORT(sys.comm().get(), ierr);
+    ierr = KSPGetPC(ksp, &pc);                CHKERRABORT(sys.comm().get(), ierr);
+    ierr = PCSetFromOptions(pc);              CHKERRABORT(sys.comm().get(), ierr);
+    
+    if (_parallel_config)
+        _parallel_config->configure_direct_solver(pc);
+    
+    // the solution of the previous frequency is used as initial guess
+    ierr = KSPSetInitialGuessNonzero(ksp, PETSC_TRUE); CHKERRABORT(sys.comm().get(), ierr);
+    
+    
+    for (unsigned int i=0; i<omega.size(); i++) {
+        
+        // A(omega) = A_0 + omega A_1,  R(omega) = R_0 + omega R_1
+        ierr = MatCopy(mat0, mat, SAME_NONZERO_PATTERN);                CHKERRABORT(sys.comm().get(), ierr);
+        ierr = MatAXPY(mat, omega[i], mat1, SAME_NONZERO_PATTERN);     CHKERRABORT(sys.comm().get(), ierr);
+        ierr = VecWAXPY(res_vec, omega[i], res1_vec, res0_vec);         CHKERRABORT(sys.comm().get(), ierr);
+        
+        ierr = KSPSetOperators(ksp, mat, mat);                          CHKERRABORT(sys.comm().get(), ierr);
+        
+        {
+            MAST_LOG_SCOPE("KSPSolve", "ComplexSolverBase");
+            ierr = KSPSolve(ksp, res_vec, sol_vec);                     CHKERRABORT(sys.comm().get(), ierr);
+        }
+        
+        // copy the solution to separate real and imaginary vectors
+        libMesh::PetscVector<Real> sol(sol_vec, sys.comm());
+        
+        libMesh::NumericVector<Real>
+        &s_R = *sol_R[i],
+        &s_I = *sol_I[i];
+        
+        unsigned int
+        first = s_R.first_local_index(),
+        last  = s_R.last_local_index();
+        
+        for (unsigned int j=first; j<last; j++) {
+            s_R.set(j, sol(  2*j));
+            s_I.set(j, sol(2*j+1));
+        }
+        
+        s_R.close();
+        s_I.close();
+    }
+    
     ierr = KSPDestroy(&ksp);                  CHKERRABORT(sys.comm().get(), ierr);
     ierr = MatDestroy(&mat);                  CHKERRABORT(sys.comm().get(), ierr);
+    ierr = MatDestroy(&mat0);                 CHKERRABORT(sys.comm().get(), ierr);
+    ierr = MatDestroy(&mat1);                 CHKERRABORT(sys.comm().get(), ierr);
+    ierr = VecDestroy(&res0_vec);             CHKERRABORT(sys.comm().get(), ierr);
+    ierr = VecDestroy(&res1_vec);             CHKERRABORT(sys.comm().get(), ierr);
     ierr = VecDestroy(&res_vec);              CHKERRABORT(sys.comm().get(), ierr);
     ierr = VecDestroy(&sol_vec);              CHKERRABORT(sys.comm().get(), ierr);
+}
+
+
+
+void
+MAST::ComplexSolverBase::
+solve_block_matrix_transpose(const libMesh::NumericVector<Real>& b_R,
+                             const libMesh::NumericVector<Real>& b_I,
+                             libMesh::NumericVector<Real>& lambda_R,
+                             libMesh::NumericVector<Real>& lambda_I) {
     
-    STOP_LOG("solve_block_matrix()", "ComplexSolve");
+    MAST_LOG_SCOPE("solve_block_matrix_transpose()", "ComplexSolverBase");
+    
+    // get reference to the system
+    MAST::NonlinearSystem& sys =
+    dynamic_cast<MAST::NonlinearSystem&>(_assembly->system());
+    
+    PetscErrorCode   ierr;
+    
+    _init_block_matrix();
+    
+    Mat              mat     = _block_mat;
+    Vec              res_vec = _block_res, sol_vec = _block_sol;
+    
+    std::auto_ptr<libMesh::NumericVector<Real> >
+    res(new libMesh::PetscVector<Real>(res_vec, sys.comm())),
+    sol(new libMesh::PetscVector<Real>(sol_vec, sys.comm()));
+    
+    {
+        std::auto_ptr<libMesh::SparseMatrix<Real> >
+        jac_mat(new libMesh::PetscMatrix<Real>(mat, sys.comm()));
+        
+        sol->zero();
+        sol->close();
+        
+        _assembly->residual_and_jacobian_blocked(*sol, *res, jac_mat.get(), sys);
+    }
+    
+    // the transpose of the block matrix is the block matrix of the
+    // conjugate transpose of the complex matrix. So, the block system is
+    // solved for the conjugate of the adjoint, with the conjugate of b
+    // as the right-hand side.
+    unsigned int
+    first = b_R.first_local_index(),
+    last  = b_R.last_local_index();
+    
+    for (unsigned int i=first; i<last; i++) {
+        
+        res->set(  2*i,  b_R(i));
+        res->set(2*i+1, -b_I(i));
+    }
+    
+    res->close();
+    sol->zero();
+    sol->close();
+    
+    
+    KSP        ksp = _block_ksp;
+    
+    {
+        MAST_LOG_SCOPE("KSPSolveTranspose", "ComplexSolverBase");
+        ierr = KSPSolveTranspose(ksp, res_vec, sol_vec);               CHKERRABORT(sys.comm().get(), ierr);
+    }
+    
+    first = lambda_R.first_local_index();
+    last  = lambda_R.last_local_index();
+    
+    for (unsigned int i=first; i<last; i++) {
+        
+        lambda_R.set(i,  (*sol)(  2*i));
+        lambda_I.set(i, -(*sol)(2*i+1));
+    }
+    
+    lambda_R.close();
+    lambda_I.close();
+    
+    res.reset();
+    sol.reset();
+    
+    if (!reuse_block_matrix)
+        this->clear_block_matrix();
 }
 
 
 
+void
+MAST::ComplexSolverBase::
+adjoint_sensitivity_product(const libMesh::NumericVector<Real>& lambda_R,
+                            const libMesh::NumericVector<Real>& lambda_I,
+                            const std::vector<MAST::Parameter*>& params,
+                            ComplexVectorX& dq) {
+    
+    MAST_LOG_SCOPE("adjoint_sensitivity_product()", "ComplexSolverBase");
+    
+    // get reference to the system
+    MAST::NonlinearSystem& sys =
+    dynamic_cast<MAST::NonlinearSystem&>(_assembly->system());
+    
+    dq.setZero(params.size());
+    
+    std::auto_ptr<libMesh::NumericVector<Real> >
+    res(libMesh::NumericVector<Real>::build(sys.comm()).release()),
+    sol(libMesh::NumericVector<Real>::build(sys.comm()).release());
+    
+    res->init(2*sys.n_dofs(), 2*sys.n_local_dofs(), false, libMesh::PARALLEL);
+    sol->init(2*sys.n_dofs(), 2*sys.n_local_dofs(), false, libMesh::PARALLEL);
+    
+    // the current complex solution about which the sensitivity of the
+    // residual is computed
+    const libMesh::NumericVector<Real>
+    &sol_R = this->real_solution(),
+    &sol_I = this->imag_solution();
+    
+    const unsigned int
+    first = sol_R.first_local_index(),
+    last  = sol_R.last_local_index();
+    
+    for (unsigned int i=first; i<last; i++) {
+        
+        sol->set(  2*i, sol_R(i));
+        sol->set(2*i+1, sol_I(i));
+    }
+    
+    sol->close();
+    
+    std::vector<Real>
+    vals(2*params.size(), 0.);
+    
+    for (unsigned int j=0; j<params.size(); j++) {
+        
+        libmesh_assert(params[j]);
+        
+        _assembly->residual_and_jacobian_blocked(*sol, *res, nullptr, sys, params[j]);
+        
+        // lambda^T R for the complex vectors with interleaved real and
+        // imaginary parts
+        for (unsigned int i=first; i<last; i++) {
+            
+            const Real
+            l_R = lambda_R(i),
+            l_I = lambda_I(i),
+            r_R = (*res)(  2*i),
+            r_I = (*res)(2*i+1);
+            
+            vals[2*j  ] += l_R * r_R - l_I * r_I;
+            vals[2*j+1] += l_R * r_I + l_I * r_R;
+        }
+    }
+    
+    sys.comm().sum(vals);
+    
+    for (unsigned int j=0; j<params.size(); j++)
+        dq(j) = Complex(vals[2*j], vals[2*j+1]);
+}
+
 
+
+void
+MAST::ComplexSolverBase::_create_block_matrix(Mat& mat) {
+    
+    // get reference to the system
+    MAST::NonlinearSystem& sys =
+    dynamic_cast<MAST::NonlinearSystem&>(_assembly->system());
+    
+    libMesh::DofMap& dof_map = sys.get_dof_map();
+    
+    const PetscInt
+    my_m = dof_map.n_dofs(),
+    my_n = my_m,
+    n_l  = dof_map.n_dofs_on_processor(sys.processor_id()),
+    m_l  = n_l;
+    
+    const std::vector<libMesh::dof_id_type>
+    & n_nz       = dof_map.get_n_nz(),
+    & n_oz       = dof_map.get_n_oz();
+    
+    std::vector<libMesh::dof_id_type>
+    complex_n_nz (2*n_nz.size()),
+    complex_n_oz (2*n_oz.size());
+    
+    // create the n_nz and n_oz for the complex matrix without block format
+    for (unsigned int i=0; i<n_nz.size(); i++) {
+        
+        complex_n_nz[2*i]   = 2*n_nz[i];
+        complex_n_nz[2*i+1] = 2*n_nz[i];
+    }
+    
+    for (unsigned int i=0; i<n_oz.size(); i++) {
+        
+        complex_n_oz[2*i]   = 2*n_oz[i];
+        complex_n_oz[2*i+1] = 2*n_oz[i];
+    }
+    
+    
+    
+    PetscErrorCode   ierr;
+    
+    ierr = MatCreate(sys.comm().get(), &mat);                      CHKERRABORT(sys.comm().get(), ierr);
+    ierr = MatSetSizes(mat, 2*m_l, 2*n_l, 2*my_m, 2*my_n);         CHKERRABORT(sys.comm().get(), ierr);
+
+    if (libMesh::on_command_line("--solver_system_names")) {
+        
+        std::string nm = _assembly->system().name() + "_complex_";
+        MatSetOptionsPrefix(mat, nm.c_str());
+    }
+    ierr = MatSetFromOptions(mat);                                 CHKERRABORT(sys.comm().get(), ierr);
+    
+    //ierr = MatSetType(mat, MATBAIJ);                                CHKERRABORT(sys.comm().get(), ierr);
+    ierr = MatSetBlockSize(mat, 2);                                CHKERRABORT(sys.comm().get(), ierr);
+    ierr = MatSeqAIJSetPreallocation(mat,
+                                     2*my_m,
+                                     (PetscInt*)&complex_n_nz[0]); CHKERRABORT(sys.comm().get(), ierr);
+    ierr = MatMPIAIJSetPreallocation(mat,
+                                     0,
+                                     (PetscInt*)&complex_n_nz[0],
+                                     0,
+                                     (PetscInt*)&complex_n_oz[0]); CHKERRABORT(sys.comm().get(), ierr);
+    ierr = MatSeqBAIJSetPreallocation (mat, 2,
+                                       0, (PetscInt*)&n_nz[0]);    CHKERRABORT(sys.comm().get(), ierr);
+    ierr = MatMPIBAIJSetPreallocation (mat, 2,
+                                       0, (PetscInt*)&n_nz[0],
+                                       0, (PetscInt*)&n_oz[0]);    CHKERRABORT(sys.comm().get(), ierr);
+    ierr = MatSetOption(mat,
+                        MAT_NEW_NONZERO_ALLOCATION_ERR,
+                        PETSC_TRUE);                               CHKERRABORT(sys.comm().get(), ierr);
+}
+
+
+
+void
+MAST::ComplexSolverBase::_init_block_matrix() {
+    
+    MAST_LOG_SCOPE("init_block_matrix()", "ComplexSolverBase");
+    
+    // get reference to the system
+    MAST::NonlinearSystem& sys =
+    dynamic_cast<MAST::NonlinearSystem&>(_assembly->system());
+    
+    libMesh::DofMap& dof_map = sys.get_dof_map();
+    
+    const std::vector<libMesh::dof_id_type>
+    & n_nz       = dof_map.get_n_nz(),
+    & n_oz       = dof_map.get_n_oz();
+    
+    // the retained objects are reused if the matrix was created for the
+    // same sparsity on all processors
+    bool
+    same = (_block_mat                          &&
+            _block_n_dofs == dof_map.n_dofs()   &&
+            _block_n_nz   == n_nz               &&
+            _block_n_oz   == n_oz);
+    sys.comm().min(same);
+    
+    if (same)
+        return;
+    
+    this->clear_block_matrix();
+    
+    PetscErrorCode   ierr;
+    PC               pc;
+    
+    _create_block_matrix(_block_mat);
+    
+    ierr = MatCreateVecs(_block_mat, &_block_res, PETSC_NULL);     CHKERRABORT(sys.comm().get(), ierr);
+    ierr = MatCreateVecs(_block_mat, &_block_sol, PETSC_NULL);     CHKERRABORT(sys.comm().get(), ierr);
+    
+    // setup the KSP
+    ierr = KSPCreate(sys.comm().get(), &_block_ksp);               CHKERRABORT(sys.comm().get(), ierr);
+    
+    if (libMesh::on_command_line("--solver_system_names")) {
+        
+        std::string nm = _assembly->system().name() + "_complex_";
+        KSPSetOptionsPrefix(_block_ksp, nm.c_str());
+    }
+    
+    ierr = KSPSetOperators(_block_ksp, _block_mat, _block_mat);    CHKERRABORT(sys.comm().get(), ierr);
+    ierr = KSPSetFromOptions(_block_ksp);                          CHKERRABORT(sys.comm().get(), ierr);
+    
+    // setup the PC
+    ierr = KSPGetPC(_block_ksp, &pc);                              CHKERRABORT(sys.comm().get(), ierr);
+    ierr = PCSetFromOptions(pc);                                   CHKERRABORT(sys.comm().get(), ierr);
+    
+    if (_parallel_config)
+        _parallel_config->configure_direct_solver(pc);
+    
+    _block_n_dofs = dof_map.n_dofs();
+    _block_n_nz   = n_nz;
+    _block_n_oz   = n_oz;
+}
@@ -20,12 +20,20 @@
 #ifndef __mast__complex_solver_base_h__
 #define __mast__complex_solver_base_h__
 
+// C++ includes
+#include <vector>
+#include <memory>
+
 // MAST includes
 #include "base/mast_data_types.h"
 
 // libMesh includes
 #include "libmesh/numeric_vector.h"
 
+// PETSc includes
+#include <petscmat.h>
+#include <petscksp.h>
+
 
 namespace MAST {
     
@@ -34,6 +42,8 @@ namespace MAST {
     class ComplexAssemblyBase;
     class ElementBase;
     class Parameter;
+    class FrequencyDomainFluidROM;
+    class HybridParallelConfiguration;
     
     /*!
      *   uses a Gauss-Siedel method to solve the complex system of equations
@@ -98,6 +108,103 @@ namespace MAST {
         virtual void solve_block_matrix(MAST::Parameter* p = nullptr);
 
         
+        /*!
+         *  solves the complex system of equations in complex arithmetic.
+         *  The complex sparse matrix is assembled in a single pass over
+         *  the elements, with half the storage of the 2x2 real block
+         *  matrix, and is factored with a serial sparse LU decomposition.
+         *  Hence, this is limited to serial runs, and an error is raised
+         *  on more than one processor. If no argument is specified for
+         *  \par p, then the system is solved. Otherwise, the sensitivity
+         *  of the system is solved with respect to the parameter p. This
+         *  is used by solve_block_matrix() if \p use_complex_matrix is
+         *  \p true and the run is serial.
+         */
+        virtual void solve_complex_matrix(MAST::Parameter* p = nullptr);
+
+        
+        /*!
+         *  assembles the right-hand side of the block system of
+         *  solve_block_matrix() for the current boundary conditions of the
+         *  assembly and a zero complex solution. The returned vector can be
+         *  used with solve_block_matrix_multiple_rhs().
+         */
+        std::auto_ptr<libMesh::NumericVector<Real> > assemble_block_rhs();
+        
+        
+        /*!
+         *  solves the block system of solve_block_matrix() for each
+         *  right-hand side in \p rhs. The matrix is assembled once and the
+         *  Krylov solver and preconditioner, for example a direct
+         *  factorization with \p -pc_type \p lu, are set up once and reused
+         *  for all right-hand sides. The real and imaginary parts of the
+         *  solution for \p rhs[i] are returned in \p sol_R[i] and
+         *  \p sol_I[i], which must be initialized with the layout of the
+         *  system solution.
+         */
+        void
+        solve_block_matrix_multiple_rhs(const std::vector<libMesh::NumericVector<Real>*>& rhs,
+                                        std::vector<libMesh::NumericVector<Real>*>& sol_R,
+                                        std::vector<libMesh::NumericVector<Real>*>& sol_I);
+
+        
+        /*!
+         *  solves the complex system of equations with block matrices for
+         *  each frequency in \p omega. The assembly must support
+         *  MAST::ComplexAssemblyBase::set_frequency_operator(). The system
+         *  is linear in frequency, A(omega) = A_0 + omega A_1, and the
+         *  residual likewise. A_0, A_1, and the two residual terms are
+         *  assembled once, and the system for each frequency is formed
+         *  at the matrix level. The Krylov solver is shared by all
+         *  frequencies, and is started from the solution of the previous
+         *  frequency. The real and imaginary parts of the solution at
+         *  \p omega[i] are returned in \p sol_R[i] and \p sol_I[i], which
+         *  must be initialized with the layout of the system solution.
+         *  \p omega is the value of the frequency used by the frequency
+         *  function of the assembly, i.e. the reduced frequency if the
+         *  function is nondimensional.
+         */
+        virtual void
+        solve_block_matrix_multi_frequency(const std::vector<Real>& omega,
+                                           std::vector<libMesh::NumericVector<Real>*>& sol_R,
+                                           std::vector<libMesh::NumericVector<Real>*>& sol_I);
+
+        
+        /*!
+         *  solves the transpose of the complex system, 
+         *  \f$ [J]^T \{\lambda\} = \{b\} \f$, for the adjoint 
+         *  \f$ \lambda \f$ with real and imaginary parts returned in 
+         *  \p lambda_R and \p lambda_I, where \p b_R and \p b_I are the
+         *  real and imaginary parts of \f$ b \f$. This is the transpose
+         *  and not the conjugate transpose, so that the adjoint provides 
+         *  the sensitivity of the non-conjugated product 
+         *  \f$ b^T x \f$ of the solution \f$ x \f$ with 
+         *  adjoint_sensitivity_product(). The block matrix is solved 
+         *  with \p KSPSolveTranspose, and with the options of
+         *  solve_block_matrix().
+         */
+        void solve_block_matrix_transpose(const libMesh::NumericVector<Real>& b_R,
+                                          const libMesh::NumericVector<Real>& b_I,
+                                          libMesh::NumericVector<Real>& lambda_R,
+                                          libMesh::NumericVector<Real>& lambda_I);
+
+        
+        /*!
+         *  computes \f$ \lambda^T \partial R/\partial p \f$ for each
+         *  parameter in \p params in \p dq, where \f$ R \f$ is the
+         *  right-hand side of the block system at the current solution of 
+         *  this solver, i.e. the residual used for the sensitivity solve
+         *  in solve_block_matrix(). With \f$ \lambda \f$ from 
+         *  solve_block_matrix_transpose(), this is the sensitivity of 
+         *  \f$ b^T x \f$, and requires only an assembly of the residual
+         *  sensitivity for each parameter instead of a sensitivity solve.
+         */
+        void adjoint_sensitivity_product(const libMesh::NumericVector<Real>& lambda_R,
+                                         const libMesh::NumericVector<Real>& lambda_I,
+                                         const std::vector<MAST::Parameter*>& params,
+                                         ComplexVectorX& dq);
+
+        
         /*!
          *  @returns a reference to the real part of the solution. If 
          *  \par if_sens is true, the the sensitivity vector is returned. Note,
@@ -138,8 +245,86 @@ namespace MAST {
         
         unsigned int max_iters;
         
+        /*!
+         *  if \p true, solve_block_matrix() solves the system with
+         *  solve_complex_matrix() in serial runs. In parallel runs the
+         *  distributed block solve is always used. This is \p false by
+         *  default.
+         */
+        bool use_complex_matrix;
+        
+        /*!
+         *  if \p true, the block matrix, its vectors and the Krylov solver
+         *  are retained after a solve with solve_block_matrix(),
+         *  solve_block_matrix_multiple_rhs() or
+         *  solve_block_matrix_transpose(), and are reused by the next solve
+         *  as long as the sparsity of the system dof map is unchanged. Only
+         *  the values of the matrix are then assembled for a new frequency
+         *  or parameter, and the preconditioner reuses its symbolic
+         *  factorization. This is \p true by default.
+         */
+        bool reuse_block_matrix;
+        
+        
+        /*!
+         *  destroys the retained block matrix, vectors and Krylov solver.
+         *  This should be called if the assembly changes the coupling of
+         *  the dofs without a change of the dof map sparsity.
+         */
+        void clear_block_matrix();
+        
+        
+        /*!
+         *  sets the configuration that chooses the threaded direct solver
+         *  of the block matrix solves, if these use an LU or Cholesky
+         *  preconditioner. The object must exist as long as it is attached
+         *  to this solver. \p nullptr removes it.
+         */
+        void
+        set_parallel_configuration(const MAST::HybridParallelConfiguration* c) {
+            _parallel_config = c;
+        }
+        
     protected:
         
+        /*!
+         *   creates the 2x2 block matrix for the real and imaginary parts
+         *   of the complex system, with the sparsity of the system dof map.
+         */
+        void _create_block_matrix(Mat& mat);
+        
+        
+        /*!
+         *   initializes the retained block matrix, vectors and Krylov
+         *   solver, or reuses them if they were created for the current
+         *   sparsity of the system dof map.
+         */
+        void _init_block_matrix();
+        
+        
+        /*!
+         *   retained block matrix, right-hand side and solution vectors,
+         *   and Krylov solver
+         */
+        Mat                                _block_mat;
+        
+        Vec                                _block_res, _block_sol;
+        
+        KSP                                _block_ksp;
+        
+        /*!
+         *   number of dofs, and number of nonzeros of the local rows of
+         *   the dof map for which the block matrix was created
+         */
+        libMesh::dof_id_type               _block_n_dofs;
+        
+        std::vector<libMesh::dof_id_type>  _block_n_nz, _block_n_oz;
+        
+        /*!
+         *   configuration of the direct solver, if provided
+         */
+        const MAST::HybridParallelConfiguration* _parallel_config;
+        
         
         /*!
          *   Associated ComplexAssembly object that provides the
@@ -147,6 +332,11 @@ namespace MAST {
          */
         MAST::ComplexAssemblyBase* _assembly;
         
+        /*!
+         *   the reduced-order model creates the block matrices of the
+         *   frequency operators
+         */
+        friend class MAST::FrequencyDomainFluidROM;
     };
 }
 
@@ -0,0 +1,101 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2017  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+// MAST includes
+#include "solver/first_order_explicit_transient_solver.h"
+#include "base/nonlinear_system.h"
+#include "base/performance_log.h"
+
+// libMesh includes
+#include "libmesh/numeric_vector.h"
+#include "libmesh/sparse_matrix.h"
+#include "libmesh/dof_map.h"
+
+
+MAST::FirstOrderExplicitTransientSolver::FirstOrderExplicitTransientSolver():
+MAST::FirstOrderNewmarkTransientSolver()
+{ }
+
+
+MAST::FirstOrderExplicitTransientSolver::~FirstOrderExplicitTransientSolver()
+{ }
+
+
+
+void
+MAST::FirstOrderExplicitTransientSolver::clear_capacitance() {
+    
+    _inv_capacitance.reset();
+}
+
+
+
+void
+MAST::FirstOrderExplicitTransientSolver::solve() {
+    
+    // make sure that the system has been specified
+    libmesh_assert_msg(_system, "System pointer is nullptr.");
+    libmesh_assert_msg(!_adaptive_time_step,
+                       "Adaptive time step is not supported by the explicit solver.");
+    
+    MAST_LOG_SCOPE("solve()", "FirstOrderExplicitTransientSolver");
+    
+    // the residual is
+    //    r(x_n, x_dot) = M x_dot + f(x_n),
+    // which is evaluated with the current velocity, so that the velocity
+    // increment is  -M^{-1} r(x_n, x_dot)
+    _if_highest_derivative_solution = true;
+    
+    if (!_inv_capacitance.get()) {
+        
+        _system->assembly(true, true);
+        
+        _inv_capacitance.reset(_system->solution->zero_clone().release());
+        _system->matrix->get_diagonal(*_inv_capacitance);
+        _inv_capacitance->close();
+        _inv_capacitance->reciprocal();
+        _inv_capacitance->close();
+    }
+    else
+        _system->assembly(true, false);
+    
+    _if_highest_derivative_solution = false;
+    
+    std::auto_ptr<libMesh::NumericVector<Real> >
+    dvec(velocity().zero_clone().release());
+    
+    dvec->pointwise_mult(*_system->rhs, *_inv_capacitance);
+    dvec->close();
+    
+    libMesh::NumericVector<Real>& vel = velocity();
+    
+    vel.add(-1., *dvec);
+    vel.close();
+    
+#ifdef LIBMESH_ENABLE_CONSTRAINTS
+    _system->get_dof_map().enforce_constraints_exactly
+    (*_system, &vel, /* homogeneous = */ true);
+#endif
+    
+    // x_{n+1} = x_n + dt x_dot_n
+    _system->solution->add(dt, vel);
+    _system->solution->close();
+    _system->update();
+}
+
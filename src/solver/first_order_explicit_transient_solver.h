@@ -0,0 +1,87 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2017  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef __mast__first_order_explicit_transient_solver__
+#define __mast__first_order_explicit_transient_solver__
+
+// C++ includes
+#include <memory>
+
+// MAST includes
+#include "solver/first_order_newmark_transient_solver.h"
+
+
+namespace MAST {
+    
+    
+    /*!
+     *    Forward Euler integration of a first-order ODE
+     *    \f[ [M] \dot{x} + f(x) = 0 \f]
+     *    with a diagonal [M], for example the row-sum lumped capacitance
+     *    of heat conduction elements with a diagonal mass matrix in their
+     *    property card (see
+     *    MAST::ElementPropertyCardBase::set_diagonal_mass_matrix()).
+     *    A time step is
+     *    \f{eqnarray*}{
+     *     \dot{x}_n &=& -[M]^{-1} f(x_n) \\
+     *     x_{n+1}   &=& x_n + dt \dot{x}_n
+     *    \f}
+     *    The residual is assembled in the highest derivative mode of
+     *    the parent class, and [M] is inverted entry-wise, so that no
+     *    linear or nonlinear solution is needed. The inverse of the
+     *    diagonal of the Jacobian is computed on the first step and
+     *    reused, which assumes a constant capacitance. clear_capacitance()
+     *    must be called if the capacitance changes.
+     *
+     *    The scheme is stable only for time steps smaller than the
+     *    critical time step of the discretization, which scales with the
+     *    square of the element size. The velocity available after a step
+     *    is that at the beginning of the step. Adaptive time stepping is
+     *    not supported.
+     */
+    class FirstOrderExplicitTransientSolver:
+    public MAST::FirstOrderNewmarkTransientSolver {
+    public:
+        
+        FirstOrderExplicitTransientSolver();
+        
+        virtual ~FirstOrderExplicitTransientSolver();
+        
+        /*!
+         *   computes the solution at the end of the current time step
+         */
+        virtual void solve();
+        
+        /*!
+         *   clears the inverse of the capacitance, which is recomputed
+         *   on the next step
+         */
+        void clear_capacitance();
+        
+    protected:
+        
+        /*!
+         *   inverse of the diagonal of the capacitance
+         */
+        std::auto_ptr<libMesh::NumericVector<Real> > _inv_capacitance;
+    };
+}
+
+
+#endif // __mast__first_order_explicit_transient_solver__
@@ -0,0 +1,346 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2017  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+// C++ includes
+#include <map>
+#include <cmath>
+
+
+// MAST includes
+#include "solver/geometric_multigrid.h"
+#include "base/nonlinear_system.h"
+#include "base/performance_log.h"
+
+
+// libMesh includes
+#include "libmesh/dof_map.h"
+#include "libmesh/elem.h"
+#include "libmesh/fe_base.h"
+#include "libmesh/fe_interface.h"
+#include "libmesh/point_locator_base.h"
+#include "libmesh/numeric_vector.h"
+#include "libmesh/petsc_macro.h"
+
+
+
+MAST::GeometricMultigrid::GeometricMultigrid(MAST::NonlinearSystem& sys):
+libMesh::ParallelObject(sys.comm()),
+n_smoothing_iterations(2),
+_sys(sys) {
+    
+}
+
+
+
+MAST::GeometricMultigrid::~GeometricMultigrid() {
+    
+    this->clear();
+}
+
+
+
+void
+MAST::GeometricMultigrid::add_coarse_level(libMesh::System& sys) {
+    
+    libmesh_assert_equal_to(sys.n_vars(), _sys.n_vars());
+    
+    _levels.push_back(&sys);
+    this->clear();
+}
+
+
+
+void
+MAST::GeometricMultigrid::clear() {
+    
+    for (unsigned int i=0; i<_P.size(); i++) {
+        
+        PetscErrorCode ierr = MatDestroy(&_P[i]);
+        CHKERRABORT(this->comm().get(), ierr);
+    }
+    
+    _P.clear();
+}
+
+
+
+void
+MAST::GeometricMultigrid::init() {
+    
+    MAST_LOG_SCOPE("init()", "GeometricMultigrid");
+    
+    libmesh_assert_msg(_levels.size(),
+                       "At least one coarse level is required for multigrid.");
+    
+    // the Galerkin products are not available for the symmetric storage
+    libmesh_assert(!_sys.if_symmetric_matrices());
+    
+    this->clear();
+    
+    _P.resize(_levels.size(), PETSC_NULL);
+    
+    for (unsigned int i=0; i<_levels.size(); i++) {
+        
+        const libMesh::System&
+        fine = (i+1 < _levels.size())? *_levels[i+1] : _sys;
+        
+        _build_prolongation(*_levels[i], fine, _P[i]);
+    }
+}
+
+
+
+void
+MAST::GeometricMultigrid::configure_preconditioner(PC pc) const {
+    
+    libmesh_assert_msg(this->initialized(),
+                       "GeometricMultigrid::init() must be called before use.");
+    
+    MAST_LOG_SCOPE("configure_preconditioner()", "GeometricMultigrid");
+    
+    const PetscInt
+    n = this->n_levels();
+    
+    PetscErrorCode ierr = 0;
+    
+    ierr = PCSetType(pc, PCMG);                         CHKERRABORT(this->comm().get(), ierr);
+    ierr = PCMGSetLevels(pc, n, PETSC_NULL);            CHKERRABORT(this->comm().get(), ierr);
+    ierr = PCMGSetType(pc, PC_MG_MULTIPLICATIVE);       CHKERRABORT(this->comm().get(), ierr);
+#if PETSC_VERSION_LESS_THAN(3,8,0)
+    ierr = PCMGSetGalerkin(pc, PETSC_TRUE);             CHKERRABORT(this->comm().get(), ierr);
+#else
+    ierr = PCMGSetGalerkin(pc, PC_MG_GALERKIN_BOTH);    CHKERRABORT(this->comm().get(), ierr);
+#endif
+    
+    // point-block Jacobi uses the blocks of the matrices, which are
+    // propagated to the coarse levels by the Galerkin products
+    const bool
+    if_block = _sys.if_blocked_matrices();
+    
+    for (PetscInt l=1; l<n; l++) {
+        
+        ierr = PCMGSetInterpolation(pc, l, _P[l-1]);    CHKERRABORT(this->comm().get(), ierr);
+        
+        KSP smoother;
+        PC  smoother_pc;
+        
+        ierr = PCMGGetSmoother(pc, l, &smoother);       CHKERRABORT(this->comm().get(), ierr);
+        ierr = KSPSetType(smoother, KSPCHEBYSHEV);      CHKERRABORT(this->comm().get(), ierr);
+        ierr = KSPSetTolerances(smoother,
+                                PETSC_DEFAULT,
+                                PETSC_DEFAULT,
+                                PETSC_DEFAULT,
+                                n_smoothing_iterations);
+        CHKERRABORT(this->comm().get(), ierr);
+        ierr = KSPSetNormType(smoother, KSP_NORM_NONE); CHKERRABORT(this->comm().get(), ierr);
+        
+        ierr = KSPGetPC(smoother, &smoother_pc);        CHKERRABORT(this->comm().get(), ierr);
+        ierr = PCSetType(smoother_pc, if_block? PCPBJACOBI : PCJACOBI);
+        CHKERRABORT(this->comm().get(), ierr);
+    }
+    
+    // direct solve on the coarsest level, which is replicated on all
+    // processors for a parallel solve
+    KSP coarse;
+    PC  coarse_pc;
+    
+    ierr = PCMGGetCoarseSolve(pc, &coarse);             CHKERRABORT(this->comm().get(), ierr);
+    ierr = KSPSetType(coarse, KSPPREONLY);              CHKERRABORT(this->comm().get(), ierr);
+    ierr = KSPGetPC(coarse, &coarse_pc);                CHKERRABORT(this->comm().get(), ierr);
+    ierr = PCSetType(coarse_pc, this->comm().size() > 1? PCREDUNDANT : PCLU);
+    CHKERRABORT(this->comm().get(), ierr);
+    
+    ierr = PCSetFromOptions(pc);                        CHKERRABORT(this->comm().get(), ierr);
+}
+
+
+
+void
+MAST::GeometricMultigrid::_build_prolongation(const libMesh::System& coarse,
+                                              const libMesh::System& fine,
+                                              Mat& P) const {
+    
+    MAST_LOG_SCOPE("build_prolongation()", "GeometricMultigrid");
+    
+    const libMesh::DofMap
+    &c_dof_map = coarse.get_dof_map(),
+    &f_dof_map = fine.get_dof_map();
+    
+    const unsigned int
+    n_vars = fine.n_vars();
+    
+    std::auto_ptr<libMesh::PointLocatorBase>
+    locator(coarse.get_mesh().sub_point_locator().release());
+    
+    const libMesh::dof_id_type
+    f_first = f_dof_map.first_dof(),
+    f_last  = f_dof_map.end_dof(),
+    c_first = c_dof_map.first_dof(),
+    c_last  = c_dof_map.end_dof();
+    
+    // weights of the coarse dofs for each local fine dof
+    std::map<libMesh::dof_id_type, std::map<libMesh::dof_id_type, Real> > rows;
+    
+    std::vector<libMesh::dof_id_type> c_dofs;
+    
+    libMesh::MeshBase::const_node_iterator       nd     =
+    fine.get_mesh().local_nodes_begin();
+    const libMesh::MeshBase::const_node_iterator end_nd =
+    fine.get_mesh().local_nodes_end();
+    
+    for ( ; nd != end_nd; ++nd) {
+        
+        const libMesh::Node& node = **nd;
+        
+        if (!node.n_dofs(fine.number()))
+            continue;
+        
+        const libMesh::Elem*
+        elem = (*locator)(node);
+        
+        if (!elem)
+            libmesh_error_msg("Error! Fine node not found in the coarse mesh.");
+        
+        for (unsigned int v=0; v<n_vars; v++) {
+            
+            if (!node.n_dofs(fine.number(), v))
+                continue;
+            
+            const libMesh::FEType&
+            fe_type = c_dof_map.variable_type(v);
+            
+            libmesh_assert_msg(fe_type.family == libMesh::LAGRANGE,
+                               "Geometric multigrid requires Lagrange variables.");
+            
+            std::auto_ptr<libMesh::FEBase>
+            fe(libMesh::FEBase::build(elem->dim(), fe_type).release());
+            
+            const std::vector<std::vector<Real> >&
+            phi = fe->get_phi();
+            
+            std::vector<libMesh::Point>
+            ref_pts(1, libMesh::FEInterface::inverse_map(elem->dim(),
+                                                         fe_type,
+                                                         elem,
+                                                         node));
+            fe->reinit(elem, &ref_pts);
+            
+            c_dof_map.dof_indices(elem, c_dofs, v);
+            libmesh_assert_equal_to(c_dofs.size(), phi.size());
+            
+            const libMesh::dof_id_type
+            f_dof = node.dof_number(fine.number(), v, 0);
+            
+            std::map<libMesh::dof_id_type, Real>& row = rows[f_dof];
+            
+            for (unsigned int j=0; j<c_dofs.size(); j++)
+                if (std::fabs(phi[j][0]) > 1.e-12)
+                    row[c_dofs[j]] = phi[j][0];
+        }
+    }
+    
+    // preallocation of the rows of the local fine dofs
+    const PetscInt
+    m_l = f_last - f_first,
+    n_l = c_last - c_first;
+    
+    std::vector<PetscInt>
+    d_nnz(m_l, 0),
+    o_nnz(m_l, 0);
+    
+    std::map<libMesh::dof_id_type, std::map<libMesh::dof_id_type, Real> >::const_iterator
+    r_it  = rows.begin(),
+    r_end = rows.end();
+    
+    for ( ; r_it != r_end; r_it++) {
+        
+        libmesh_assert(r_it->first >= f_first && r_it->first < f_last);
+        
+        std::map<libMesh::dof_id_type, Real>::const_iterator
+        c_it  = r_it->second.begin(),
+        c_end = r_it->second.end();
+        
+        for ( ; c_it != c_end; c_it++) {
+            
+            if (c_it->first >= c_first && c_it->first < c_last)
+                d_nnz[r_it->first - f_first]++;
+            else
+                o_nnz[r_it->first - f_first]++;
+        }
+    }
+    
+    PetscErrorCode ierr = 0;
+    
+    ierr = MatCreate(this->comm().get(), &P);            CHKERRABORT(this->comm().get(), ierr);
+    ierr = MatSetSizes(P, m_l, n_l,
+                       fine.n_dofs(), coarse.n_dofs()); CHKERRABORT(this->comm().get(), ierr);
+    ierr = MatSetType(P, MATAIJ);                        CHKERRABORT(this->comm().get(), ierr);
+    
+    // the prolongation maps the node blocks of the coarse level to those
+    // of the fine level
+    if (_sys.if_blocked_matrices()) {
+        ierr = MatSetBlockSizes(P, n_vars, n_vars);      CHKERRABORT(this->comm().get(), ierr);
+    }
+    
+    ierr = MatSeqAIJSetPreallocation(P,
+                                     0,
+                                     m_l? &d_nnz[0] : PETSC_NULL);
+    CHKERRABORT(this->comm().get(), ierr);
+    ierr = MatMPIAIJSetPreallocation(P,
+                                     0,
+                                     m_l? &d_nnz[0] : PETSC_NULL,
+                                     0,
+                                     m_l? &o_nnz[0] : PETSC_NULL);
+    CHKERRABORT(this->comm().get(), ierr);
+    
+    std::vector<PetscInt>         cols;
+    std::vector<PetscScalar>      vals;
+    
+    for (r_it = rows.begin(); r_it != r_end; r_it++) {
+        
+        const PetscInt
+        row = r_it->first;
+        
+        cols.clear();
+        vals.clear();
+        
+        std::map<libMesh::dof_id_type, Real>::const_iterator
+        c_it  = r_it->second.begin(),
+        c_end = r_it->second.end();
+        
+        for ( ; c_it != c_end; c_it++) {
+            
+            cols.push_back(c_it->first);
+            vals.push_back(c_it->second);
+        }
+        
+        if (cols.empty())
+            continue;
+        
+        ierr = MatSetValues(P,
+                            1, &row,
+                            (PetscInt)cols.size(), &cols[0],
+                            &vals[0],
+                            INSERT_VALUES);
+        CHKERRABORT(this->comm().get(), ierr);
+    }
+    
+    ierr = MatAssemblyBegin(P, MAT_FINAL_ASSEMBLY);      CHKERRABORT(this->comm().get(), ierr);
+    ierr = MatAssemblyEnd  (P, MAT_FINAL_ASSEMBLY);      CHKERRABORT(this->comm().get(), ierr);
+}
@@ -0,0 +1,175 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2017  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef __mast__geometric_multigrid__
+#define __mast__geometric_multigrid__
+
+// C++ includes
+#include <vector>
+
+
+// MAST includes
+#include "base/mast_data_types.h"
+
+
+// libMesh includes
+#include "libmesh/parallel_object.h"
+#include "libmesh/system.h"
+
+
+// PETSc includes
+#include <petscksp.h>
+
+
+namespace MAST {
+    
+    // Forward declerations
+    class NonlinearSystem;
+    
+    
+    /*!
+     *   Geometric multigrid preconditioner for a system on a mesh obtained
+     *   by uniform refinement of a coarse mesh, such as the stiffened
+     *   panel meshes or meshes from \p build_square. The coarse levels
+     *   are systems on the meshes of the refinement hierarchy, with the
+     *   same variables as the fine system, which are added with
+     *   add_coarse_level() from the coarsest to the finest. These systems
+     *   only provide the dofs of the levels and do not need to be
+     *   assembled.
+     *
+     *   init() builds the prolongation from each level to the next finer
+     *   one by interpolation of the Lagrange variables of the coarse level
+     *   at the nodes of the finer level. The coarse meshes must be
+     *   replicated, since the coarse element containing a fine node is
+     *   found with a point locator. The coarse operators are the Galerkin
+     *   products \f$ [P]^T [A] [P] \f$ computed by PETSc, so that they
+     *   are consistent with the constraints and any nonlinearity of the
+     *   fine operator. If the fine system uses blocked matrices, the
+     *   prolongations have the node block size, which is retained by
+     *   the Galerkin products, and the smoothers use point-block Jacobi
+     *   on the blocks of all variables of a node, such as the six dofs of
+     *   a shell node. The smoothers are Chebyshev iterations, and the
+     *   coarsest level is solved with a direct solver.
+     *
+     *   The preconditioner is used by the nonlinear, sensitivity and
+     *   adjoint solves of the system once it is attached with
+     *   MAST::NonlinearSystem::set_multigrid_preconditioner(). The PETSc
+     *   options of the PC, for example \p -mg_levels_ksp_max_it, are
+     *   applied after this configuration.
+     */
+    class GeometricMultigrid:
+    public libMesh::ParallelObject {
+        
+    public:
+        
+        GeometricMultigrid(MAST::NonlinearSystem& sys);
+        
+        virtual ~GeometricMultigrid();
+        
+        
+        /*!
+         *   adds the system of the next finer coarse level. The coarsest
+         *   level should be added first. The system must be initialized
+         *   and must exist as long as this object is used.
+         */
+        void add_coarse_level(libMesh::System& sys);
+        
+        
+        /*!
+         *   @returns the number of levels, including the fine system
+         */
+        unsigned int n_levels() const {
+            return (unsigned int)_levels.size() + 1;
+        }
+        
+        
+        /*!
+         *   number of smoothing iterations on each level. This is 2 by
+         *   default.
+         */
+        unsigned int n_smoothing_iterations;
+        
+        
+        /*!
+         *   builds the prolongation operators. This must be called after
+         *   the coarse levels are added, and again if the meshes change.
+         */
+        void init();
+        
+        
+        /*!
+         *   deletes the prolongation operators
+         */
+        void clear();
+        
+        
+        /*!
+         *   @returns true if the prolongation operators are available
+         */
+        bool initialized() const {
+            return (_levels.size() && _P.size() == _levels.size());
+        }
+        
+        
+        /*!
+         *   sets up \p pc as the multigrid preconditioner for the fine
+         *   system. This is called by the solves of the fine system, and
+         *   can be used for a KSP created outside of these solves.
+         */
+        void configure_preconditioner(PC pc) const;
+        
+        
+        /*!
+         *   @returns the prolongation from level \p l to level \p l+1,
+         *   where level 0 is the coarsest level
+         */
+        Mat prolongation(unsigned int l) const {
+            libmesh_assert_less(l, _P.size());
+            return _P[l];
+        }
+        
+    protected:
+        
+        /*!
+         *   builds the prolongation \p P from \p coarse to \p fine
+         */
+        void _build_prolongation(const libMesh::System& coarse,
+                                 const libMesh::System& fine,
+                                 Mat& P) const;
+        
+        
+        /*!
+         *   fine system
+         */
+        MAST::NonlinearSystem&               _sys;
+        
+        /*!
+         *   coarse level systems, from the coarsest to the finest
+         */
+        std::vector<libMesh::System*>        _levels;
+        
+        /*!
+         *   prolongation from each level to the next finer level
+         */
+        std::vector<Mat>                     _P;
+    };
+}
+
+
+#endif // __mast__geometric_multigrid__
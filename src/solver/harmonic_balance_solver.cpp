@@ -0,0 +1,931 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2017  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+// C++ includes
+#include <cmath>
+
+// MAST includes
+#include "solver/harmonic_balance_solver.h"
+#include "base/transient_assembly.h"
+#include "base/elem_base.h"
+#include "base/nonlinear_system.h"
+#include "base/performance_log.h"
+
+// libMesh includes
+#include "libmesh/numeric_vector.h"
+#include "libmesh/dof_map.h"
+#include "libmesh/petsc_matrix.h"
+#include "libmesh/petsc_vector.h"
+
+
+MAST::HarmonicBalanceSolver::
+HarmonicBalanceSolver(unsigned int order,
+                      unsigned int n_instances):
+MAST::TransientSolverBase(),
+_order                (order),
+_n_instances          (n_instances),
+_omega                (0.),
+_frequency_unknown    (false),
+_phase_dof            (0),
+_instance             (0),
+_frequency_derivative (false),
+_instance_system      (nullptr),
+_snes                 (PETSC_NULL),
+_pc_ksp               (PETSC_NULL),
+_converged            (false),
+_n_iters              (0) {
+    
+    libmesh_assert(order == 1 || order == 2);
+    
+    // an odd number of instances avoids the Nyquist harmonic, which
+    // cannot be differentiated
+    libmesh_assert_equal_to(n_instances%2, 1);
+    
+    _D1 = RealMatrixX::Zero(n_instances, n_instances);
+    
+    for (unsigned int i=0; i<n_instances; i++)
+        for (unsigned int j=0; j<n_instances; j++) {
+            
+            if (i == j)
+                continue;
+            
+            const int
+            d = (int)i - (int)j;
+            
+            _D1(i, j) = 0.5 * (d%2? -1.: 1.) / sin(M_PI * d / n_instances);
+        }
+    
+    _D2 = _D1 * _D1;
+}
+
+
+
+MAST::HarmonicBalanceSolver::~HarmonicBalanceSolver() {
+    
+    this->_clear_instances();
+}
+
+
+
+void
+MAST::HarmonicBalanceSolver::set_frequency(Real omega,
+                                           bool if_unknown,
+                                           unsigned int phase_dof) {
+    
+    libmesh_assert_greater(omega, 0.);
+    
+    _omega             = omega;
+    _frequency_unknown = if_unknown;
+    _phase_dof         = phase_dof;
+}
+
+
+
+Real
+MAST::HarmonicBalanceSolver::time_instance(unsigned int i) const {
+    
+    libmesh_assert_less(i, _n_instances);
+    libmesh_assert_greater(_omega, 0.);
+    
+    return 2. * M_PI * i / _n_instances / _omega;
+}
+
+
+
+libMesh::NumericVector<Real>&
+MAST::HarmonicBalanceSolver::time_instance_solution(unsigned int i) {
+    
+    libmesh_assert_less(i, _n_instances);
+    
+    this->_init_instances();
+    
+    return *_x[i];
+}
+
+
+
+void
+MAST::HarmonicBalanceSolver::
+init_time_instances(const libMesh::NumericVector<Real>& mean,
+                    const libMesh::NumericVector<Real>& cos_part,
+                    const libMesh::NumericVector<Real>& sin_part) {
+    
+    this->_init_instances();
+    
+    for (unsigned int i=0; i<_n_instances; i++) {
+        
+        const Real
+        theta = 2. * M_PI * i / _n_instances;
+        
+        _x[i]->zero();
+        _x[i]->add(          1., mean);
+        _x[i]->add( cos(theta), cos_part);
+        _x[i]->add( sin(theta), sin_part);
+        _x[i]->close();
+    }
+}
+
+
+
+void
+MAST::HarmonicBalanceSolver::solve() {
+    
+    // make sure that the system has been specified
+    libmesh_assert_msg(_system, "System pointer is nullptr.");
+    libmesh_assert_greater(_omega, 0.);
+    
+    MAST_LOG_SCOPE("solve()", "HarmonicBalanceSolver");
+    
+    this->_init_instances();
+    
+    const libMesh::Parallel::Communicator&
+    comm = _system->comm();
+    
+    const bool
+    sys_name = libMesh::on_command_line("--solver_system_names");
+    
+    const Real
+    t0 = _system->time;
+    
+    // the frequency is the last entry, which is stored on processor 0
+    const PetscInt
+    n_local  = _n_instances * _system->n_local_dofs() +
+    ((_frequency_unknown && comm.rank() == 0)? 1: 0),
+    n_global = _n_instances * _system->n_dofs() + (_frequency_unknown? 1: 0);
+    
+    PetscErrorCode ierr = 0;
+    Vec            sol, res;
+    Mat            mat;
+    KSP            ksp;
+    PC             pc;
+    std::string    nm = sys_name? _system->name() + "_": "";
+    
+    ierr = VecCreate(comm.get(), &sol);                   CHKERRABORT(comm.get(), ierr);
+    ierr = VecSetSizes(sol, n_local, n_global);           CHKERRABORT(comm.get(), ierr);
+    ierr = VecSetType(sol, VECMPI);                       CHKERRABORT(comm.get(), ierr);
+    ierr = VecDuplicate(sol, &res);                       CHKERRABORT(comm.get(), ierr);
+    
+    // the provided time instance solutions are the initial guess
+    this->_gather(_x, _omega, sol);
+    
+    ierr = SNESCreate(comm.get(), &_snes);                CHKERRABORT(comm.get(), ierr);
+    
+    // the Jacobian is applied by the shell matrix
+    ierr = MatCreateShell(comm.get(),
+                          n_local,
+                          n_local,
+                          n_global,
+                          n_global,
+                          this,
+                          &mat);
+    CHKERRABORT(comm.get(), ierr);
+    ierr = MatShellSetOperation(mat,
+                                MATOP_MULT,
+                                (void(*)(void))MAST::HarmonicBalanceSolver::_mat_mult);
+    CHKERRABORT(comm.get(), ierr);
+    
+    ierr = SNESSetFunction(_snes,
+                           res,
+                           MAST::HarmonicBalanceSolver::_snes_residual,
+                           this);
+    CHKERRABORT(comm.get(), ierr);
+    ierr = SNESSetJacobian(_snes,
+                           mat,
+                           mat,
+                           MAST::HarmonicBalanceSolver::_snes_jacobian,
+                           this);
+    CHKERRABORT(comm.get(), ierr);
+    
+    // solver of the diagonal blocks, which is a direct solve by default
+    ierr = KSPCreate(comm.get(), &_pc_ksp);               CHKERRABORT(comm.get(), ierr);
+    ierr = KSPSetOptionsPrefix(_pc_ksp, (nm + "hb_pc_").c_str());
+    CHKERRABORT(comm.get(), ierr);
+    ierr = KSPSetType(_pc_ksp, KSPPREONLY);               CHKERRABORT(comm.get(), ierr);
+    ierr = KSPGetPC(_pc_ksp, &pc);                        CHKERRABORT(comm.get(), ierr);
+    ierr = PCSetType(pc, PCLU);                           CHKERRABORT(comm.get(), ierr);
+    
+    if (comm.size() > 1) {
+#if PETSC_VERSION_LESS_THAN(3,9,0)
+        ierr = PCFactorSetMatSolverPackage(pc, MATSOLVERMUMPS);
+#else
+        ierr = PCFactorSetMatSolverType(pc, MATSOLVERMUMPS);
+#endif
+        CHKERRABORT(comm.get(), ierr);
+    }
+    ierr = KSPSetFromOptions(_pc_ksp);                    CHKERRABORT(comm.get(), ierr);
+    
+    if (sys_name)
+        SNESSetOptionsPrefix(_snes, (nm + "hb_").c_str());
+    
+    // the block diagonal preconditioner over the time instances
+    ierr = SNESGetKSP(_snes, &ksp);                       CHKERRABORT(comm.get(), ierr);
+    ierr = KSPGetPC(ksp, &pc);                            CHKERRABORT(comm.get(), ierr);
+    ierr = PCSetType(pc, PCSHELL);                        CHKERRABORT(comm.get(), ierr);
+    ierr = PCShellSetContext(pc, this);                   CHKERRABORT(comm.get(), ierr);
+    ierr = PCShellSetName(pc, "MAST harmonic balance block Jacobi");
+    CHKERRABORT(comm.get(), ierr);
+    ierr = PCShellSetApply(pc, MAST::HarmonicBalanceSolver::_pc_apply);
+    CHKERRABORT(comm.get(), ierr);
+    
+    ierr = SNESSetFromOptions(_snes);                     CHKERRABORT(comm.get(), ierr);
+    
+    {
+        MAST_LOG_SCOPE("SNESSolve", "HarmonicBalanceSolver");
+        ierr = SNESSolve(_snes, PETSC_NULL, sol);         CHKERRABORT(comm.get(), ierr);
+    }
+    
+    SNESConvergedReason reason;
+    PetscInt            its = 0;
+    
+    ierr = SNESGetConvergedReason(_snes, &reason);        CHKERRABORT(comm.get(), ierr);
+    ierr = SNESGetIterationNumber(_snes, &its);           CHKERRABORT(comm.get(), ierr);
+    
+    _converged = reason > 0;
+    _n_iters   = (unsigned int)its;
+    
+    // copy the solution back to the time instances and the system
+    this->_scatter(sol, _x, &_omega);
+    
+    *_system->solution = *_x[0];
+    _system->solution->close();
+    _system->time      = t0;
+    _system->update();
+    _instance          = 0;
+    
+    libMesh::out
+    << "Harmonic balance: "
+    << (_converged? "converged": "diverged")
+    << " in " << _n_iters << " iterations, frequency = "
+    << _omega << std::endl;
+    
+    ierr = SNESDestroy(&_snes);                           CHKERRABORT(comm.get(), ierr);
+    ierr = KSPDestroy(&_pc_ksp);                          CHKERRABORT(comm.get(), ierr);
+    ierr = MatDestroy(&mat);                              CHKERRABORT(comm.get(), ierr);
+    ierr = VecDestroy(&sol);                              CHKERRABORT(comm.get(), ierr);
+    ierr = VecDestroy(&res);                              CHKERRABORT(comm.get(), ierr);
+    
+    _snes   = PETSC_NULL;
+    _pc_ksp = PETSC_NULL;
+}
+
+
+
+void
+MAST::HarmonicBalanceSolver::advance_time_step() {
+    
+    libmesh_error_msg("Error! Time step cannot be advanced for HarmonicBalanceSolver.");
+}
+
+
+
+void
+MAST::HarmonicBalanceSolver::residual(Vec X, Vec R) {
+    
+    MAST_LOG_SCOPE("residual()", "HarmonicBalanceSolver");
+    
+    this->_scatter(X, _x, &_omega);
+    
+    for (unsigned int i=0; i<_n_instances; i++) {
+        
+        this->_set_instance(i, *_x[i]);
+        _assembly->residual_and_jacobian(*_x[i], _r[i], nullptr, *_system);
+    }
+    
+    this->_gather(_r,
+                  _frequency_unknown? this->_phase_value(_x): 0.,
+                  R);
+}
+
+
+
+void
+MAST::HarmonicBalanceSolver::jacobian(Vec X) {
+    
+    MAST_LOG_SCOPE("jacobian()", "HarmonicBalanceSolver");
+    
+    this->_scatter(X, _x, &_omega);
+    
+    std::auto_ptr<libMesh::NumericVector<Real> >
+    zero(_x[0]->zero_clone().release()),
+    mean(_x[0]->zero_clone().release());
+    
+    // the derivative of the residual with respect to the frequency is
+    // the product of the Jacobian of the time derivatives with the
+    // time derivatives scaled by their derivatives wrt the frequency
+    if (_frequency_unknown) {
+        
+        _frequency_derivative = true;
+        
+        for (unsigned int i=0; i<_n_instances; i++) {
+            
+            this->_set_instance(i, *_x[i]);
+            _assembly->linearized_jacobian_solution_product(*_x[i],
+                                                            *zero,
+                                                            *_dr_dw[i],
+                                                            *_system);
+        }
+        
+        _frequency_derivative = false;
+    }
+    
+    // the preconditioner is the diagonal block of the mean state, which
+    // is the same for all instances
+    for (unsigned int i=0; i<_n_instances; i++)
+        mean->add(1./_n_instances, *_x[i]);
+    mean->close();
+    
+    this->_set_instance(_n_instances, *mean);
+    _assembly->residual_and_jacobian(*mean, nullptr, _system->matrix, *_system);
+    
+    Mat mat = dynamic_cast<libMesh::PetscMatrix<Real>*>(_system->matrix)->mat();
+    
+    PetscErrorCode ierr = 0;
+    
+    ierr = KSPSetOperators(_pc_ksp, mat, mat);  CHKERRABORT(_system->comm().get(), ierr);
+    ierr = KSPSetUp(_pc_ksp);                   CHKERRABORT(_system->comm().get(), ierr);
+}
+
+
+
+void
+MAST::HarmonicBalanceSolver::jacobian_product(Vec dX, Vec Y) {
+    
+    MAST_LOG_SCOPE("jacobian_product()", "HarmonicBalanceSolver");
+    
+    PetscErrorCode ierr = 0;
+    Vec x;
+    
+    // the product is about the current iterate of the solver
+    ierr = SNESGetSolution(_snes, &x);          CHKERRABORT(_system->comm().get(), ierr);
+    
+    Real
+    dw = 0.;
+    
+    this->_scatter(x,  _x,  &_omega);
+    this->_scatter(dX, _dx, &dw);
+    
+#ifdef LIBMESH_ENABLE_CONSTRAINTS
+    for (unsigned int i=0; i<_n_instances; i++)
+        _system->get_dof_map().enforce_constraints_exactly(*_system,
+                                                           _dx[i],
+                                                           true /* homogeneous = true */);
+#endif
+    
+    for (unsigned int i=0; i<_n_instances; i++) {
+        
+        this->_set_instance(i, *_x[i]);
+        _assembly->linearized_jacobian_solution_product(*_x[i],
+                                                        *_dx[i],
+                                                        *_r[i],
+                                                        *_system);
+        
+        if (_frequency_unknown) {
+            
+            _r[i]->add(dw, *_dr_dw[i]);
+            _r[i]->close();
+        }
+    }
+    
+    this->_gather(_r,
+                  _frequency_unknown? this->_phase_value(_dx): 0.,
+                  Y);
+}
+
+
+
+void
+MAST::HarmonicBalanceSolver::apply_preconditioner(Vec X, Vec Y) {
+    
+    MAST_LOG_SCOPE("apply_preconditioner()", "HarmonicBalanceSolver");
+    
+    PetscErrorCode ierr = 0;
+    
+    // the frequency entry is not preconditioned
+    Real
+    w = 0.;
+    
+    this->_scatter(X, _r, &w);
+    
+    for (unsigned int i=0; i<_n_instances; i++) {
+        
+        ierr = KSPSolve(_pc_ksp,
+                        dynamic_cast<libMesh::PetscVector<Real>*>(_r[i])->vec(),
+                        dynamic_cast<libMesh::PetscVector<Real>*>(_dx[i])->vec());
+        CHKERRABORT(_system->comm().get(), ierr);
+    }
+    
+    this->_gather(_dx, w, Y);
+}
+
+
+
+void
+MAST::HarmonicBalanceSolver::
+update_velocity(libMesh::NumericVector<Real>&       vec,
+                const libMesh::NumericVector<Real>& sol) {
+    
+    this->_spectral_product(_D1, _omega, _x, sol, vec);
+}
+
+
+
+void
+MAST::HarmonicBalanceSolver::
+update_acceleration(libMesh::NumericVector<Real>&       vec,
+                    const libMesh::NumericVector<Real>& sol) {
+    
+    this->_spectral_product(_D2, _omega*_omega, _x, sol, vec);
+}
+
+
+
+void
+MAST::HarmonicBalanceSolver::
+update_delta_velocity(libMesh::NumericVector<Real>&       vec,
+                      const libMesh::NumericVector<Real>& sol) {
+    
+    if (_frequency_derivative)
+        // d(omega D x)/d omega
+        this->_spectral_product(_D1, 1., _x, *_x[_instance], vec);
+    else
+        this->_spectral_product(_D1, _omega, _dx, sol, vec);
+}
+
+
+
+void
+MAST::HarmonicBalanceSolver::
+update_delta_acceleration(libMesh::NumericVector<Real>&       vec,
+                          const libMesh::NumericVector<Real>& sol) {
+    
+    if (_frequency_derivative)
+        // d(omega^2 D^2 x)/d omega
+        this->_spectral_product(_D2, 2.*_omega, _x, *_x[_instance], vec);
+    else
+        this->_spectral_product(_D2, _omega*_omega, _dx, sol, vec);
+}
+
+
+
+void
+MAST::HarmonicBalanceSolver::_predict_solution(libMesh::NumericVector<Real>& x) {
+    
+    libmesh_error_msg("Error! Adaptive time step not available for HarmonicBalanceSolver.");
+}
+
+
+
+Real
+MAST::HarmonicBalanceSolver::_error_constant() const {
+    
+    libmesh_error_msg("Error! Adaptive time step not available for HarmonicBalanceSolver.");
+    return 0.;
+}
+
+
+
+unsigned int
+MAST::HarmonicBalanceSolver::_error_order() const {
+    
+    libmesh_error_msg("Error! Adaptive time step not available for HarmonicBalanceSolver.");
+    return 0;
+}
+
+
+
+void
+MAST::HarmonicBalanceSolver::
+_set_element_data(const std::vector<libMesh::dof_id_type>& dof_indices,
+                  const std::vector<libMesh::NumericVector<Real>*>& sols,
+                  MAST::ElementBase &elem){
+    
+    libmesh_assert_equal_to(sols.size(), _order+1);
+    
+    const unsigned int n_dofs = (unsigned int)dof_indices.size();
+    
+    RealVectorX
+    sol          = RealVectorX::Zero(n_dofs),
+    vel          = RealVectorX::Zero(n_dofs),
+    accel        = RealVectorX::Zero(n_dofs);
+    
+    for (unsigned int i=0; i<n_dofs; i++) {
+        
+        sol(i)          = (*sols[0])(dof_indices[i]);
+        vel(i)          = (*sols[1])(dof_indices[i]);
+        if (_order > 1)
+            accel(i)    = (*sols[2])(dof_indices[i]);
+    }
+    
+    elem.set_solution(sol);
+    elem.set_velocity(vel);
+    if (_order > 1)
+        elem.set_acceleration(accel);
+}
+
+
+
+void
+MAST::HarmonicBalanceSolver::
+_set_element_perturbed_data(const std::vector<libMesh::dof_id_type>& dof_indices,
+                            const std::vector<libMesh::NumericVector<Real>*>& sols,
+                            MAST::ElementBase &elem){
+    
+    libmesh_assert_equal_to(sols.size(), _order+1);
+    
+    const unsigned int n_dofs = (unsigned int)dof_indices.size();
+    
+    RealVectorX
+    sol          = RealVectorX::Zero(n_dofs),
+    vel          = RealVectorX::Zero(n_dofs),
+    accel        = RealVectorX::Zero(n_dofs);
+    
+    for (unsigned int i=0; i<n_dofs; i++) {
+        
+        sol(i)          = (*sols[0])(dof_indices[i]);
+        vel(i)          = (*sols[1])(dof_indices[i]);
+        if (_order > 1)
+            accel(i)    = (*sols[2])(dof_indices[i]);
+    }
+    
+    elem.set_perturbed_solution(sol);
+    elem.set_perturbed_velocity(vel);
+    if (_order > 1)
+        elem.set_perturbed_acceleration(accel);
+}
+
+
+
+void
+MAST::HarmonicBalanceSolver::
+_elem_calculations(MAST::ElementBase& elem,
+                   const std::vector<libMesh::dof_id_type>& dof_indices,
+                   bool if_jac,
+                   RealVectorX& vec,
+                   RealMatrixX& mat) {
+    
+    // make sure that the assembly object is provided
+    libmesh_assert(_assembly);
+    unsigned int n_dofs = (unsigned int)dof_indices.size();
+    
+    RealVectorX
+    f_x     = RealVectorX::Zero(n_dofs),
+    f_m     = RealVectorX::Zero(n_dofs);
+    
+    RealMatrixX
+    f_m_jac_xddot    = RealMatrixX::Zero(n_dofs, n_dofs),
+    f_m_jac_xdot     = RealMatrixX::Zero(n_dofs, n_dofs),
+    f_m_jac          = RealMatrixX::Zero(n_dofs, n_dofs),
+    f_x_jac_xdot     = RealMatrixX::Zero(n_dofs, n_dofs),
+    f_x_jac          = RealMatrixX::Zero(n_dofs, n_dofs);
+    
+    // the diagonal coefficients of the spectral operators are the same
+    // for all instances
+    const Real
+    c1 = _omega * _D1(0, 0),
+    c2 = _omega * _omega * _D2(0, 0);
+    
+    if (_order == 1) {
+        
+        _assembly->_elem_calculations(elem,
+                                      if_jac,
+                                      f_m,           // mass vector
+                                      f_x,           // forcing vector
+                                      f_m_jac_xdot,  // Jac of mass wrt x_dot
+                                      f_m_jac,       // Jac of mass wrt x
+                                      f_x_jac);      // Jac of forcing vector wrt x
+        
+        vec  = (f_m + f_x);
+        
+        if (if_jac)
+            mat = c1 * f_m_jac_xdot + (f_m_jac + f_x_jac);
+    }
+    else {
+        
+        _assembly->_elem_calculations(elem,
+                                      if_jac,
+                                      f_m,           // mass vector
+                                      f_x,           // forcing vector
+                                      f_m_jac_xddot, // Jac of mass wrt x_dotdot
+                                      f_m_jac_xdot,  // Jac of mass wrt x_dot
+                                      f_m_jac,       // Jac of mass wrt x
+                                      f_x_jac_xdot,  // Jac of forcing vector wrt x_dot
+                                      f_x_jac);      // Jac of forcing vector wrt x
+        
+        vec  = (f_m + f_x);
+        
+        if (if_jac)
+            mat =
+            c2 * f_m_jac_xddot +
+            c1 * (f_m_jac_xdot + f_x_jac_xdot) +
+            (f_m_jac + f_x_jac);
+    }
+}
+
+
+
+void
+MAST::HarmonicBalanceSolver::
+_elem_linearized_jacobian_solution_product(MAST::ElementBase& elem,
+                                           const std::vector<libMesh::dof_id_type>& dof_indices,
+                                           RealVectorX& vec) {
+    
+    // make sure that the assembly object is provided
+    libmesh_assert(_assembly);
+    
+    // the perturbed time derivatives include the coupling to the
+    // other time instances
+    _assembly->_linearized_jacobian_solution_product(elem, vec);
+}
+
+
+
+void
+MAST::HarmonicBalanceSolver::
+_elem_sensitivity_calculations(MAST::ElementBase& elem,
+                               const std::vector<libMesh::dof_id_type>& dof_indices,
+                               RealVectorX& vec) {
+    
+    // make sure that the assembly object is provided
+    libmesh_assert(_assembly);
+    
+    _assembly->_elem_sensitivity_calculations(elem, vec);
+}
+
+
+
+void
+MAST::HarmonicBalanceSolver::_init_instances() {
+    
+    libmesh_assert_msg(_system, "System pointer is nullptr.");
+    
+    if (_instance_system == _system && _x.size())
+        return;
+    
+    this->_clear_instances();
+    
+    _x.resize(_n_instances);
+    _dx.resize(_n_instances);
+    _r.resize(_n_instances);
+    _dr_dw.resize(_n_instances);
+    
+    for (unsigned int i=0; i<_n_instances; i++) {
+        
+        _x[i]     = _system->solution->clone().release();
+        _dx[i]    = _system->solution->zero_clone().release();
+        _r[i]     = _system->solution->zero_clone().release();
+        _dr_dw[i] = _system->solution->zero_clone().release();
+    }
+    
+    _instance_system = _system;
+}
+
+
+
+void
+MAST::HarmonicBalanceSolver::_clear_instances() {
+    
+    for (unsigned int i=0; i<_x.size(); i++) {
+        
+        delete _x[i];
+        delete _dx[i];
+        delete _r[i];
+        delete _dr_dw[i];
+    }
+    
+    _x.clear();
+    _dx.clear();
+    _r.clear();
+    _dr_dw.clear();
+    
+    _instance_system = nullptr;
+}
+
+
+
+void
+MAST::HarmonicBalanceSolver::_set_instance(unsigned int i,
+                                           const libMesh::NumericVector<Real>& x) {
+    
+    libmesh_assert_less_equal(i, _n_instances);
+    
+    _instance = i;
+    
+    *_system->solution = x;
+    _system->solution->close();
+    _system->update();
+    
+    // the mean state is evaluated at the current time
+    if (i < _n_instances)
+        _system->time = this->time_instance(i);
+}
+
+
+
+void
+MAST::HarmonicBalanceSolver::
+_scatter(Vec X,
+         std::vector<libMesh::NumericVector<Real>*>& vecs,
+         Real* w) {
+    
+    const libMesh::Parallel::Communicator&
+    comm = _system->comm();
+    
+    const unsigned int
+    n_local = _system->n_local_dofs();
+    
+    PetscErrorCode     ierr = 0;
+    const PetscScalar *x    = nullptr;
+    PetscScalar       *v    = nullptr;
+    
+    ierr = VecGetArrayRead(X, &x);               CHKERRABORT(comm.get(), ierr);
+    
+    for (unsigned int i=0; i<_n_instances; i++) {
+        
+        Vec vec = dynamic_cast<libMesh::PetscVector<Real>*>(vecs[i])->vec();
+        
+        ierr = VecGetArray(vec, &v);             CHKERRABORT(comm.get(), ierr);
+        for (unsigned int j=0; j<n_local; j++)
+            v[j] = x[i*n_local+j];
+        ierr = VecRestoreArray(vec, &v);         CHKERRABORT(comm.get(), ierr);
+        
+        vecs[i]->close();
+    }
+    
+    if (w && _frequency_unknown) {
+        
+        Real
+        val = comm.rank() == 0? x[_n_instances*n_local]: 0.;
+        
+        comm.broadcast(val);
+        *w = val;
+    }
+    
+    ierr = VecRestoreArrayRead(X, &x);           CHKERRABORT(comm.get(), ierr);
+    
+#ifdef LIBMESH_ENABLE_CONSTRAINTS
+    // the solutions satisfy the constraints exactly, while the
+    // perturbations are constrained by the caller
+    if (&vecs == &_x)
+        for (unsigned int i=0; i<_n_instances; i++)
+            _system->get_dof_map().enforce_constraints_exactly(*_system, _x[i]);
+#endif
+}
+
+
+
+void
+MAST::HarmonicBalanceSolver::
+_gather(const std::vector<libMesh::NumericVector<Real>*>& vecs,
+        Real w,
+        Vec X) {
+    
+    const libMesh::Parallel::Communicator&
+    comm = _system->comm();
+    
+    const unsigned int
+    n_local = _system->n_local_dofs();
+    
+    PetscErrorCode     ierr = 0;
+    PetscScalar       *x    = nullptr;
+    const PetscScalar *v    = nullptr;
+    
+    ierr = VecGetArray(X, &x);                   CHKERRABORT(comm.get(), ierr);
+    
+    for (unsigned int i=0; i<_n_instances; i++) {
+        
+        Vec vec = dynamic_cast<libMesh::PetscVector<Real>*>(vecs[i])->vec();
+        
+        ierr = VecGetArrayRead(vec, &v);         CHKERRABORT(comm.get(), ierr);
+        for (unsigned int j=0; j<n_local; j++)
+            x[i*n_local+j] = v[j];
+        ierr = VecRestoreArrayRead(vec, &v);     CHKERRABORT(comm.get(), ierr);
+    }
+    
+    if (_frequency_unknown && comm.rank() == 0)
+        x[_n_instances*n_local] = w;
+    
+    ierr = VecRestoreArray(X, &x);               CHKERRABORT(comm.get(), ierr);
+}
+
+
+
+Real
+MAST::HarmonicBalanceSolver::
+_phase_value(const std::vector<libMesh::NumericVector<Real>*>& vecs) const {
+    
+    Real
+    val = 0.;
+    
+    if (_phase_dof >= vecs[0]->first_local_index() &&
+        _phase_dof <  vecs[0]->last_local_index())
+        for (unsigned int i=0; i<_n_instances; i++)
+            val += _D1(0, i) * (*vecs[i])(_phase_dof);
+    
+    _system->comm().sum(val);
+    
+    return val;
+}
+
+
+
+void
+MAST::HarmonicBalanceSolver::
+_spectral_product(const RealMatrixX& D,
+                  Real c,
+                  const std::vector<libMesh::NumericVector<Real>*>& vecs,
+                  const libMesh::NumericVector<Real>& v_i,
+                  libMesh::NumericVector<Real>& vec) {
+    
+    vec.zero();
+    
+    // the time derivatives of the mean state are zero
+    if (_instance < _n_instances)
+        for (unsigned int i=0; i<_n_instances; i++) {
+            
+            if (D(_instance, i) == 0.)
+                continue;
+            
+            vec.add(c * D(_instance, i), i == _instance? v_i: *vecs[i]);
+        }
+    
+    vec.close();
+}
+
+
+
+PetscErrorCode
+MAST::HarmonicBalanceSolver::_snes_residual(SNES snes, Vec x, Vec r, void* ctx) {
+    
+    libmesh_assert(ctx);
+    
+    static_cast<MAST::HarmonicBalanceSolver*>(ctx)->residual(x, r);
+    
+    return 0;
+}
+
+
+
+PetscErrorCode
+MAST::HarmonicBalanceSolver::_snes_jacobian(SNES snes, Vec x, Mat jac, Mat pc, void* ctx) {
+    
+    libmesh_assert(ctx);
+    
+    static_cast<MAST::HarmonicBalanceSolver*>(ctx)->jacobian(x);
+    
+    PetscErrorCode ierr = 0;
+    
+    ierr = MatAssemblyBegin(jac, MAT_FINAL_ASSEMBLY);   CHKERRQ(ierr);
+    ierr = MatAssemblyEnd(jac, MAT_FINAL_ASSEMBLY);     CHKERRQ(ierr);
+    
+    return ierr;
+}
+
+
+
+PetscErrorCode
+MAST::HarmonicBalanceSolver::_mat_mult(Mat mat, Vec dx, Vec y) {
+    
+    PetscErrorCode ierr = 0;
+    void* ctx = PETSC_NULL;
+    
+    ierr = MatShellGetContext(mat, &ctx);
+    CHKERRQ(ierr);
+    
+    static_cast<MAST::HarmonicBalanceSolver*>(ctx)->jacobian_product(dx, y);
+    
+    return ierr;
+}
+
+
+
+PetscErrorCode
+MAST::HarmonicBalanceSolver::_pc_apply(PC pc, Vec x, Vec y) {
+    
+    PetscErrorCode ierr = 0;
+    void* ctx = PETSC_NULL;
+    
+    ierr = PCShellGetContext(pc, &ctx);
+    CHKERRQ(ierr);
+    
+    static_cast<MAST::HarmonicBalanceSolver*>(ctx)->apply_preconditioner(x, y);
+    
+    return ierr;
+}
+
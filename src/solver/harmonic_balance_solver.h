@@ -0,0 +1,403 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2017  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+#ifndef __mast__harmonic_balance_solver__
+#define __mast__harmonic_balance_solver__
+
+// C++ includes
+#include <vector>
+
+// MAST includes
+#include "solver/transient_solver_base.h"
+
+// PETSc includes
+#include <petscsnes.h>
+
+
+namespace MAST {
+    
+    
+    /*!
+     *    Harmonic balance (time-spectral) solver for the periodic response
+     *    of a first or second-order system, for example the limit-cycle
+     *    oscillation of a panel with nonlinear structure and piston theory
+     *    aerodynamic loads. The solution is represented at N equispaced
+     *    time instances \f$ t_n = 2 \pi n / (N \omega) \f$ over one
+     *    period, with N odd, and the time derivatives are replaced by the
+     *    spectral differentiation operator
+     *    \f[ \dot{x}_n = \omega \sum_m D_{nm} x_m, \quad
+     *        D_{nm} = \frac{1}{2} \frac{(-1)^{n-m}}{\sin(\pi(n-m)/N)}, \f]
+     *    which is exact for the harmonics up to (N-1)/2. The acceleration
+     *    uses \f$ \omega^2 [D]^2 \f$. The residual of each time instance
+     *    is computed by the element kernels of the transient assembly
+     *    attached to this solver, and the N coupled residuals are solved
+     *    together by a PETSc Newton solver.
+     *
+     *    The Jacobian is applied matrix-free: the product for instance n
+     *    is computed by the linearized Jacobian-solution product of the
+     *    assembly, with the perturbation of the time derivatives obtained
+     *    from the spectral operator applied to the perturbations of all
+     *    instances. The preconditioner is block diagonal over the time
+     *    instances, with the Jacobian of the mean state assembled in the
+     *    system matrix and solved under the option prefix \p hb_pc_. By
+     *    default this is a direct solve.
+     *
+     *    For a forced response the frequency is given. For a limit-cycle
+     *    oscillation the frequency is an additional unknown, and the phase
+     *    of the oscillation is fixed by requiring that the velocity of
+     *    the dof specified in set_frequency() vanishes at the first time
+     *    instance. The initial guess must then be a nonzero oscillation,
+     *    for example the flutter mode of the linear problem, since the
+     *    static solution also satisfies the equations.
+     */
+    class HarmonicBalanceSolver:
+    public MAST::TransientSolverBase {
+    public:
+        
+        /*!
+         *    \p order is the order of the ODE, 1 or 2, and \p n_instances
+         *    the odd number of time instances
+         */
+        HarmonicBalanceSolver(unsigned int order,
+                              unsigned int n_instances);
+        
+        virtual ~HarmonicBalanceSolver();
+        
+        /*!
+         *    @returns the highest order time derivative that the solver
+         *    will handle
+         */
+        virtual int ode_order() const {
+            return _order;
+        }
+        
+        /*!
+         *    @returns the number of time instances
+         */
+        unsigned int n_time_instances() const {
+            return _n_instances;
+        }
+        
+        /*!
+         *    sets the circular frequency \p omega of the periodic response.
+         *    If \p if_unknown is true, \p omega is the initial guess of the
+         *    frequency of a limit-cycle oscillation, and the phase is
+         *    fixed with the velocity of the global dof \p phase_dof.
+         */
+        void set_frequency(Real omega,
+                           bool if_unknown         = false,
+                           unsigned int phase_dof  = 0);
+        
+        /*!
+         *    @returns the circular frequency, which is the converged
+         *    frequency of the limit-cycle oscillation after solve()
+         */
+        Real frequency() const {
+            return _omega;
+        }
+        
+        /*!
+         *    @returns the time of the i^th time instance
+         */
+        Real time_instance(unsigned int i) const;
+        
+        /*!
+         *    @returns the solution at the i^th time instance, which is
+         *    the initial guess for solve(), and its result after solve().
+         *    The solutions are created on the first call, after the
+         *    assembly is attached, as copies of the system solution.
+         */
+        libMesh::NumericVector<Real>& time_instance_solution(unsigned int i);
+        
+        /*!
+         *    initializes the time instance solutions as
+         *    \f$ x_n = \bar{x} + x_c \cos(2 \pi n/N) + x_s \sin(2 \pi n/N) \f$,
+         *    for example with the real and imaginary parts of a flutter mode
+         */
+        void init_time_instances(const libMesh::NumericVector<Real>& mean,
+                                 const libMesh::NumericVector<Real>& cos_part,
+                                 const libMesh::NumericVector<Real>& sin_part);
+        
+        /*!
+         *    solves the coupled time instance residuals. The solution of
+         *    the first instance is copied to the system solution.
+         */
+        virtual void solve();
+        
+        /*!
+         *    @returns true if the last solve converged
+         */
+        bool converged() const {
+            return _converged;
+        }
+        
+        /*!
+         *    @returns the number of Newton iterations of the last solve
+         */
+        unsigned int n_iterations() const {
+            return _n_iters;
+        }
+        
+        /*!
+         *    the time instances are solved together, so the time step
+         *    cannot be advanced
+         */
+        virtual void advance_time_step();
+        
+        /*!
+         *    update the velocity of the current time instance from the
+         *    solutions of all instances
+         */
+        virtual void update_velocity(libMesh::NumericVector<Real>& vec,
+                                     const libMesh::NumericVector<Real>& sol);
+        
+        /*!
+         *    update the acceleration of the current time instance from the
+         *    solutions of all instances
+         */
+        virtual void update_acceleration(libMesh::NumericVector<Real>& vec,
+                                         const libMesh::NumericVector<Real>& sol);
+        
+        /*!
+         *    update the perturbation in velocity of the current time
+         *    instance from the perturbations of all instances
+         */
+        virtual void
+        update_delta_velocity(libMesh::NumericVector<Real>& vec,
+                              const libMesh::NumericVector<Real>& sol);
+        
+        /*!
+         *    update the perturbation in acceleration of the current time
+         *    instance from the perturbations of all instances
+         */
+        virtual void
+        update_delta_acceleration(libMesh::NumericVector<Real>& vec,
+                                  const libMesh::NumericVector<Real>& sol);
+        
+        /*!
+         *    computes the residual \p R of the coupled time instances at
+         *    \p X. This is called by the PETSc solver during solve().
+         */
+        void residual(Vec X, Vec R);
+        
+        /*!
+         *    computes the frequency derivative of the residual and the
+         *    preconditioner at \p X. This is called by the PETSc solver
+         *    during solve().
+         */
+        void jacobian(Vec X);
+        
+        /*!
+         *    computes \f$ Y = [J] dX \f$ about the current iterate. This is
+         *    called by the PETSc shell matrix during solve().
+         */
+        void jacobian_product(Vec dX, Vec Y);
+        
+        /*!
+         *    applies the block diagonal preconditioner to \p X. This is
+         *    called by the PETSc shell preconditioner during solve().
+         */
+        void apply_preconditioner(Vec X, Vec Y);
+        
+    protected:
+        
+        /*!
+         *    @returns the number of iterations for which solution and velocity
+         *    are to be stored.
+         */
+        virtual unsigned int _n_iters_to_store() const {
+            return 1;
+        }
+        
+        /*!
+         *    not available for the harmonic balance solver
+         */
+        virtual void _predict_solution(libMesh::NumericVector<Real>& x);
+        
+        virtual Real _error_constant() const;
+        
+        virtual unsigned int _error_order() const;
+        
+        /*!
+         *    provides the element with the transient data for calculations
+         */
+        virtual void _set_element_data(const std::vector<libMesh::dof_id_type>& dof_indices,
+                                       const std::vector<libMesh::NumericVector<Real>*>& sols,
+                                       MAST::ElementBase& elem);
+        
+        /*!
+         *    provides the element with the transient data for calculations
+         */
+        virtual void
+        _set_element_perturbed_data
+        (const std::vector<libMesh::dof_id_type>& dof_indices,
+         const std::vector<libMesh::NumericVector<Real>*>& sols,
+         MAST::ElementBase& elem);
+        
+        /*!
+         *   performs the element calculations over \par elem. The Jacobian
+         *   is the diagonal block of the current time instance.
+         */
+        virtual void
+        _elem_calculations(MAST::ElementBase& elem,
+                           const std::vector<libMesh::dof_id_type>& dof_indices,
+                           bool if_jac,
+                           RealVectorX& vec,
+                           RealMatrixX& mat);
+        
+        /*!
+         *   performs the element calculations over \par elem, and returns
+         *   the element vector quantity in \par vec.
+         */
+        virtual void
+        _elem_linearized_jacobian_solution_product(MAST::ElementBase& elem,
+                                                   const std::vector<libMesh::dof_id_type>& dof_indices,
+                                                   RealVectorX& vec);
+        
+        /*!
+         *   performs the element sensitivity calculations over \par elem,
+         *   and returns the element residual sensitivity in \par vec .
+         */
+        virtual void
+        _elem_sensitivity_calculations(MAST::ElementBase& elem,
+                                       const std::vector<libMesh::dof_id_type>& dof_indices,
+                                       RealVectorX& vec);
+        
+        /*!
+         *    creates the vectors of the time instances, if needed
+         */
+        void _init_instances();
+        
+        /*!
+         *    deletes the vectors of the time instances
+         */
+        void _clear_instances();
+        
+        /*!
+         *    prepares the system for the evaluation of time instance \p i,
+         *    or of the mean state if \p i is the number of instances
+         */
+        void _set_instance(unsigned int i,
+                           const libMesh::NumericVector<Real>& x);
+        
+        /*!
+         *    copies the blocks of \p X to \p vecs, and the frequency entry
+         *    to \p w, if provided
+         */
+        void _scatter(Vec X,
+                      std::vector<libMesh::NumericVector<Real>*>& vecs,
+                      Real* w);
+        
+        /*!
+         *    copies \p vecs to the blocks of \p X, and \p w to the
+         *    frequency entry, if the frequency is unknown
+         */
+        void _gather(const std::vector<libMesh::NumericVector<Real>*>& vecs,
+                     Real w,
+                     Vec X);
+        
+        /*!
+         *    @returns \f$ \sum_m D_{0m} \{v_m\}_k \f$, where k is the
+         *    phase dof
+         */
+        Real _phase_value(const std::vector<libMesh::NumericVector<Real>*>& vecs) const;
+        
+        /*!
+         *    applies the spectral operator \p D scaled by \p c to \p vecs,
+         *    with \p v_i replacing the vector of the current instance
+         */
+        void _spectral_product(const RealMatrixX& D,
+                               Real c,
+                               const std::vector<libMesh::NumericVector<Real>*>& vecs,
+                               const libMesh::NumericVector<Real>& v_i,
+                               libMesh::NumericVector<Real>& vec);
+        
+        static PetscErrorCode _snes_residual(SNES snes, Vec x, Vec r, void* ctx);
+        
+        static PetscErrorCode _snes_jacobian(SNES snes, Vec x, Mat jac, Mat pc, void* ctx);
+        
+        static PetscErrorCode _mat_mult(Mat mat, Vec dx, Vec y);
+        
+        static PetscErrorCode _pc_apply(PC pc, Vec x, Vec y);
+        
+        /*!
+         *    order of the ODE and number of time instances
+         */
+        const unsigned int _order;
+        
+        const unsigned int _n_instances;
+        
+        /*!
+         *    spectral differentiation operator, and its square, for a
+         *    unit frequency
+         */
+        RealMatrixX        _D1, _D2;
+        
+        /*!
+         *    frequency, and the flag for an unknown frequency with the dof
+         *    of the phase condition
+         */
+        Real               _omega;
+        
+        bool               _frequency_unknown;
+        
+        unsigned int       _phase_dof;
+        
+        /*!
+         *    current time instance of the assembly, which is the number of
+         *    instances for the mean state
+         */
+        unsigned int       _instance;
+        
+        /*!
+         *    if true, the perturbed time derivatives are the derivatives
+         *    with respect to the frequency
+         */
+        bool               _frequency_derivative;
+        
+        /*!
+         *    system for which the instance vectors were created
+         */
+        MAST::NonlinearSystem* _instance_system;
+        
+        /*!
+         *    solutions, perturbations and residuals of the time instances,
+         *    and the frequency derivatives of the residuals
+         */
+        std::vector<libMesh::NumericVector<Real>*> _x, _dx, _r, _dr_dw;
+        
+        /*!
+         *    solver context and preconditioner solver, which are available
+         *    only during solve()
+         */
+        SNES               _snes;
+        
+        KSP                _pc_ksp;
+        
+        /*!
+         *    convergence and number of iterations of the last solve
+         */
+        bool               _converged;
+        
+        unsigned int       _n_iters;
+    };
+}
+
+#endif // __mast__harmonic_balance_solver__
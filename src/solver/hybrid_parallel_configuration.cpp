@@ -0,0 +1,215 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2017  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+// C++ includes
+#include <sstream>
+#include <thread>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+
+// MAST includes
+#include "solver/hybrid_parallel_configuration.h"
+#include "base/node_shared_memory.h"
+#include "solver/petsc_options.h"
+
+
+// libMesh includes
+#include "libmesh/libmesh.h"
+#include "libmesh/petsc_macro.h"
+
+
+MAST::HybridParallelConfiguration::
+HybridParallelConfiguration(const libMesh::Parallel::Communicator& comm_in):
+libMesh::ParallelObject(comm_in),
+#if defined(PETSC_HAVE_MUMPS)
+_direct_solver(MAST::HybridParallelConfiguration::MUMPS),
+#else
+_direct_solver(MAST::HybridParallelConfiguration::DEFAULT_DIRECT_SOLVER),
+#endif
+_n_threads(libMesh::n_threads()),
+_n_node_procs(1) {
+    
+}
+
+
+
+MAST::HybridParallelConfiguration::~HybridParallelConfiguration() {
+    
+}
+
+
+
+void
+MAST::HybridParallelConfiguration::init() {
+    
+    // the threads of the dense operations
+#ifdef _OPENMP
+    omp_set_num_threads(_n_threads);
+#endif
+    Eigen::setNbThreads(_n_threads);
+    
+    // the number of threads of all processors on a node is compared to
+    // the number of cores of the node
+    {
+        MAST::NodeSharedMemory node(this->comm());
+        _n_node_procs = node.node_size();
+    }
+    
+    const unsigned int
+    n_hw = std::thread::hardware_concurrency();
+    
+    if (n_hw &&
+        _n_node_procs * _n_threads > n_hw &&
+        this->comm().rank() == 0)
+        libMesh::out
+        << "Warning: " << _n_node_procs << " processors with "
+        << _n_threads << " threads each exceed the "
+        << n_hw << " hardware threads of the node." << std::endl;
+    
+    // the options of the direct solver are not added to the global
+    // options database here. configure_direct_solver() adds them for the
+    // options prefix of each solver to which this is attached.
+}
+
+
+
+void
+MAST::HybridParallelConfiguration::configure_direct_solver(PC pc) const {
+    
+    PetscErrorCode ierr;
+    PetscBool      factor = PETSC_FALSE;
+    
+    // the defaults of the prefix are used if the type of the
+    // preconditioner is set later from the options
+    const char* prefix = PETSC_NULL;
+    ierr = PCGetOptionsPrefix(pc, &prefix);   CHKERRABORT(this->comm().get(), ierr);
+    
+    this->_set_default_options(prefix? prefix: "");
+    
+    const char* package = this->_solver_package_name();
+    
+    if (!package)
+        return;
+    
+    ierr = PetscObjectTypeCompareAny((PetscObject)pc, &factor, PCLU, PCCHOLESKY, "");
+    CHKERRABORT(this->comm().get(), ierr);
+    
+    if (!factor)
+        return;
+    
+    // the package given on the command line is retained
+    const std::string
+    nm = std::string("-") + (prefix? prefix: "") +
+#if PETSC_VERSION_LESS_THAN(3,9,0)
+    "pc_factor_mat_solver_package";
+#else
+    "pc_factor_mat_solver_type";
+#endif
+    
+    PetscBool set = PETSC_FALSE;
+    ierr = PetscOptionsHasName(PETSC_NULL, PETSC_NULL, nm.c_str(), &set);
+    CHKERRABORT(this->comm().get(), ierr);
+    
+    if (set)
+        return;
+    
+#if PETSC_VERSION_LESS_THAN(3,9,0)
+    ierr = PCFactorSetMatSolverPackage(pc, package);
+#else
+    ierr = PCFactorSetMatSolverType(pc, package);
+#endif
+    CHKERRABORT(this->comm().get(), ierr);
+}
+
+
+
+void
+MAST::HybridParallelConfiguration::
+_set_default_options(const std::string& prefix) const {
+    
+    const char* package = this->_solver_package_name();
+    
+    if (!package)
+        return;
+    
+    MAST::set_default_petsc_option
+    ("-" + prefix +
+#if PETSC_VERSION_LESS_THAN(3,9,0)
+     "pc_factor_mat_solver_package",
+#else
+     "pc_factor_mat_solver_type",
+#endif
+     package);
+    
+    // MUMPS uses the OpenMP threads set in init(), while PARDISO is given
+    // the number of threads as a parameter
+    if (_direct_solver == MAST::HybridParallelConfiguration::MKL_PARDISO) {
+        
+        std::ostringstream oss;
+        oss << _n_threads;
+        
+        MAST::set_default_petsc_option
+        ("-" + prefix +
+         (this->comm().size() > 1? "mat_mkl_cpardiso_65": "mat_mkl_pardiso_65"),
+         oss.str());
+    }
+}
+
+
+
+const char*
+MAST::HybridParallelConfiguration::_solver_package_name() const {
+    
+    switch (_direct_solver) {
+            
+        case MAST::HybridParallelConfiguration::DEFAULT_DIRECT_SOLVER:
+            return nullptr;
+            
+        case MAST::HybridParallelConfiguration::MUMPS:
+#if defined(PETSC_HAVE_MUMPS)
+            return MATSOLVERMUMPS;
+#else
+            libmesh_error_msg("MUMPS requires PETSc configured with MUMPS");
+#endif
+            
+        case MAST::HybridParallelConfiguration::MKL_PARDISO:
+            if (this->comm().size() > 1) {
+#if defined(PETSC_HAVE_MKL_CPARDISO)
+                return MATSOLVERMKL_CPARDISO;
+#else
+                libmesh_error_msg("MKL Cluster PARDISO requires PETSc configured with MKL");
+#endif
+            }
+            else {
+#if defined(PETSC_HAVE_MKL_PARDISO)
+                return MATSOLVERMKL_PARDISO;
+#else
+                libmesh_error_msg("MKL PARDISO requires PETSc configured with MKL");
+#endif
+            }
+            
+        default:
+            libmesh_error();
+    }
+    
+    return nullptr;
+}
+
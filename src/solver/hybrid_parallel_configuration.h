@@ -0,0 +1,161 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2017  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef __mast__hybrid_parallel_configuration_h__
+#define __mast__hybrid_parallel_configuration_h__
+
+// C++ includes
+#include <string>
+
+// MAST includes
+#include "base/mast_data_types.h"
+
+// libMesh includes
+#include "libmesh/parallel_object.h"
+
+// PETSc includes
+#include <petscpc.h>
+
+
+namespace MAST {
+    
+    /*!
+     *   Configures the solvers for hybrid runs with several threads on each
+     *   processor, so that the solves use the threads given to the threaded
+     *   assembly. The number of threads per processor is the single runtime
+     *   setting \p --n_threads of libMesh. init() uses this setting for
+     *   - the OpenMP threads, which are used by threaded BLAS and LAPACK
+     *     libraries, for example in the dense flutter and reduced-order
+     *     problems, and the threads of the Eigen dense products;
+     *   - the direct solver of LU and Cholesky preconditioners, which is
+     *     MUMPS or MKL PARDISO (MKL Cluster PARDISO on more than one
+     *     processor) with the given threads.
+     *
+     *   The direct solver and its threads are added as defaults to the
+     *   PETSc options database by configure_direct_solver(), only for the
+     *   options prefix of the preconditioner it is given. This is called
+     *   by the objects to which this configuration is attached:
+     *   MAST::NonlinearSystem, MAST::SlepcEigenSolver and
+     *   MAST::ComplexSolverBase. Solvers without this configuration are
+     *   not affected. In all cases, options given on the command line take
+     *   precedence.
+     *
+     *   The placement of the threads on the cores is not changed, and is
+     *   left to the MPI launcher and to \p OMP_PLACES / \p OMP_PROC_BIND.
+     *   init() warns if the processors of a node together use more threads
+     *   than the node provides.
+     */
+    class HybridParallelConfiguration:
+    public libMesh::ParallelObject {
+        
+    public:
+        
+        /*!
+         *   direct solver package for LU and Cholesky factorizations
+         */
+        enum DirectSolverType {
+            DEFAULT_DIRECT_SOLVER,
+            MUMPS,
+            MKL_PARDISO
+        };
+        
+        
+        HybridParallelConfiguration(const libMesh::Parallel::Communicator& comm_in);
+        
+        virtual ~HybridParallelConfiguration();
+        
+        
+        /*!
+         *   sets the direct solver package. With \p DEFAULT_DIRECT_SOLVER,
+         *   the package is chosen by PETSc and only the dense threads are
+         *   set. The default is \p MUMPS if PETSc is configured with MUMPS,
+         *   and \p DEFAULT_DIRECT_SOLVER otherwise.
+         */
+        void set_direct_solver(MAST::HybridParallelConfiguration::DirectSolverType t) {
+            _direct_solver = t;
+        }
+        
+        
+        /*!
+         *   @returns the number of threads per processor
+         */
+        unsigned int n_threads() const {
+            return _n_threads;
+        }
+        
+        
+        /*!
+         *   @returns the number of processors on the node of this processor,
+         *   which is available after init()
+         */
+        unsigned int n_node_processors() const {
+            return _n_node_procs;
+        }
+        
+        
+        /*!
+         *   sets the dense threads. This must be called on all processors
+         *   before the solvers are created.
+         */
+        void init();
+        
+        
+        /*!
+         *   adds the defaults of the direct solver to the options database
+         *   for the options prefix of \p pc, and sets the direct solver
+         *   package of \p pc if it is already an LU or Cholesky
+         *   preconditioner. This should be called before \p pc is set up.
+         */
+        void configure_direct_solver(PC pc) const;
+        
+        
+    protected:
+        
+        /*!
+         *   adds the defaults of the direct solver to the options database
+         *   for the options \p prefix
+         */
+        void _set_default_options(const std::string& prefix) const;
+        
+        
+        /*!
+         *   @returns the PETSc name of the direct solver package
+         */
+        const char* _solver_package_name() const;
+        
+        
+        /*!
+         *   direct solver package
+         */
+        MAST::HybridParallelConfiguration::DirectSolverType  _direct_solver;
+        
+        /*!
+         *   number of threads per processor
+         */
+        unsigned int                                         _n_threads;
+        
+        /*!
+         *   number of processors on the node of this processor
+         */
+        unsigned int                                         _n_node_procs;
+    };
+}
+
+
+#endif // __mast__hybrid_parallel_configuration_h__
@@ -18,11 +18,18 @@
  */
 
 
+// C++ includes
+#include <sstream>
+
+
 // MAST includes
 #include "solver/multiphysics_nonlinear_solver.h"
 #include "base/nonlinear_implicit_assembly.h"
 #include "base/system_initialization.h"
 #include "base/nonlinear_system.h"
+#include "base/performance_log.h"
+#include "base/solver_telemetry.h"
+#include "solver/petsc_options.h"
 
 // libMesh includes
 #include "libmesh/dof_map.h"
@@ -111,7 +118,7 @@ __mast_multiphysics_petsc_mat_mult(Mat mat,Vec dx,Vec y) {
                                                           true /* homogeneous = true */);
         }
         else
-            sys_dsols[i]  = sys_sols[i]->zero_clone().release();
+            sys_dsols[i]  = &solver->zero_solution(i);
     }
     
     //////////////////////////////////////////////////////////////////
@@ -150,9 +157,11 @@ __mast_multiphysics_petsc_mat_mult(Mat mat,Vec dx,Vec y) {
         // get the IS for this system
         IS sys_is = solver->index_sets()[i];
         
-        // delete the NumericVector wrappers
+        // delete the NumericVector wrappers. The zero vectors are
+        // retained by the solver
         delete sys_sols[i];
-        delete sys_dsols[i];
+        if (i == mat_ctx->j)
+            delete sys_dsols[i];
         
         // now restore the subvectors
         ierr = VecRestoreSubVector(x, sys_is, &sol[i]);  CHKERRABORT(solver->comm().get(), ierr);
@@ -230,15 +239,32 @@ __mast_multiphysics_petsc_snes_residual (SNES snes, Vec x, Vec r, void * ctx) {
     Real
     global_l2 = 0.;
 
+    // with concurrent evaluation, the residuals are closed only after
+    // the element loops of all disciplines, so that disciplines on
+    // disjoint processors do not wait for each other
+    const bool
+    concurrent = solver->if_concurrent_discipline_evaluation();
+    
     for (unsigned int i=0; i< nd; i++) {
         
+        MAST::NonlinearImplicitAssembly& assembly = solver->get_system_assembly(i);
+        
         // system for this discipline
-        MAST::NonlinearSystem& sys = solver->get_system_assembly(i).system();
+        MAST::NonlinearSystem& sys = assembly.system();
+        
+        assembly.set_deferred_close(concurrent);
+        assembly.residual_and_jacobian (*sys_sols[i],
+                                        sys_res[i],
+                                        nullptr,
+                                        sys);
+    }
+    
+    for (unsigned int i=0; i< nd; i++) {
+        
+        MAST::NonlinearImplicitAssembly& assembly = solver->get_system_assembly(i);
         
-        solver->get_system_assembly(i).residual_and_jacobian (*sys_sols[i],
-                                                              sys_res[i],
-                                                              nullptr,
-                                                              sys);
+        assembly.close_residual_and_jacobian();
+        assembly.set_deferred_close(false);
         
         sys_res[i]->close();
         
@@ -343,8 +369,14 @@ __mast_multiphysics_petsc_snes_jacobian(SNES snes, Vec x, Mat jac, Mat pc, void
     //////////////////////////////////////////////////////////////////
     // calculate the residuals
     //////////////////////////////////////////////////////////////////
+    const bool
+    concurrent = solver->if_concurrent_discipline_evaluation();
+    
     for (unsigned int i=0; i< nd; i++) {
         
+        MAST::NonlinearImplicitAssembly&
+        assembly = solver->get_preconditioner_assembly(i);
+        
         // system for this discipline
         MAST::NonlinearSystem& sys = solver->get_system_assembly(i).system();
         
@@ -352,12 +384,24 @@ __mast_multiphysics_petsc_snes_jacobian(SNES snes, Vec x, Mat jac, Mat pc, void
         //PC.attach_dof_map(sys.get_dof_map());
         //PC.close();
 
-        solver->get_system_assembly(i).residual_and_jacobian (*sys_sols[i],
-                                                              nullptr,
-                                                              sys.matrix,
-                                                              sys);
+        // if the Jacobian is matrix-free, then the system matrix stores
+        // the preconditioner
+        assembly.set_deferred_close(concurrent);
+        assembly.residual_and_jacobian (*sys_sols[i],
+                                        nullptr,
+                                        sys.matrix,
+                                        sys);
+    }
+    
+    for (unsigned int i=0; i< nd; i++) {
+        
+        MAST::NonlinearImplicitAssembly&
+        assembly = solver->get_preconditioner_assembly(i);
+        
+        assembly.close_residual_and_jacobian();
+        assembly.set_deferred_close(false);
         
-        sys.matrix->close();
+        solver->get_system_assembly(i).system().matrix->close();
     }
 
     //////////////////////////////////////////////////////////////////
@@ -380,6 +424,29 @@ __mast_multiphysics_petsc_snes_jacobian(SNES snes, Vec x, Mat jac, Mat pc, void
     ierr = MatAssemblyBegin(jac, MAT_FINAL_ASSEMBLY);  CHKERRABORT(solver->comm().get(), ierr);
     ierr = MatAssemblyEnd(jac, MAT_FINAL_ASSEMBLY);    CHKERRABORT(solver->comm().get(), ierr);
     
+    if (pc != jac) {
+        ierr = MatAssemblyBegin(pc, MAT_FINAL_ASSEMBLY);  CHKERRABORT(solver->comm().get(), ierr);
+        ierr = MatAssemblyEnd(pc, MAT_FINAL_ASSEMBLY);    CHKERRABORT(solver->comm().get(), ierr);
+    }
+    
+    // with a nonlinear preconditioner, the SNES matrix is the shell of the
+    // preconditioned Jacobian, and the nested matrices used by its
+    // fieldsplit are marked as changed here
+    if (jac != solver->mat()) {
+        
+        ierr = MatAssemblyBegin(solver->mat(), MAT_FINAL_ASSEMBLY);
+        CHKERRABORT(solver->comm().get(), ierr);
+        ierr = MatAssemblyEnd(solver->mat(), MAT_FINAL_ASSEMBLY);
+        CHKERRABORT(solver->comm().get(), ierr);
+        
+        if (solver->pc_mat() != solver->mat()) {
+            ierr = MatAssemblyBegin(solver->pc_mat(), MAT_FINAL_ASSEMBLY);
+            CHKERRABORT(solver->comm().get(), ierr);
+            ierr = MatAssemblyEnd(solver->pc_mat(), MAT_FINAL_ASSEMBLY);
+            CHKERRABORT(solver->comm().get(), ierr);
+        }
+    }
+    
     
     return ierr;
 }
@@ -387,6 +454,52 @@ __mast_multiphysics_petsc_snes_jacobian(SNES snes, Vec x, Mat jac, Mat pc, void
 
 
 
+//---------------------------------------------------------------
+// this function is called by PETSc to apply the nonlinear preconditioner,
+// which replaces x with M(x)
+PetscErrorCode
+__mast_multiphysics_petsc_npc_solve(SNES snes, Vec x) {
+    
+    LOG_SCOPE("npc_solve()", "PetscMultiphysicsNonlinearSolver");
+    
+    PetscErrorCode ierr=0;
+    
+    void * ctx = PETSC_NULL;
+    ierr = SNESShellGetContext(snes, &ctx);
+    
+    MAST::MultiphysicsNonlinearSolverBase * solver =
+    static_cast<MAST::MultiphysicsNonlinearSolverBase*> (ctx);
+    
+    solver->apply_nonlinear_preconditioner(x);
+    
+    return ierr;
+}
+
+
+
+//---------------------------------------------------------------
+// method for matrix vector multiplication with the Jacobian of the
+// preconditioned residual
+PetscErrorCode
+__mast_multiphysics_petsc_npc_mat_mult(Mat mat, Vec x, Vec y) {
+    
+    LOG_SCOPE("npc_mat_mult()", "PetscMultiphysicsNonlinearSolver");
+    
+    PetscErrorCode ierr=0;
+    
+    void * ctx = PETSC_NULL;
+    ierr = MatShellGetContext(mat, &ctx);
+    
+    MAST::MultiphysicsNonlinearSolverBase * solver =
+    static_cast<MAST::MultiphysicsNonlinearSolverBase*> (ctx);
+    
+    solver->preconditioned_jacobian_product(x, y);
+    
+    return ierr;
+}
+
+
+
 
 MAST::MultiphysicsNonlinearSolverBase::
 MultiphysicsNonlinearSolverBase(const libMesh::Parallel::Communicator& comm_in,
@@ -397,9 +510,23 @@ _name                         (nm),
 _n_disciplines                (n),
 _update                       (nullptr),
 _discipline_assembly          (n, nullptr),
+_matrix_free_jacobian         (false),
+_preconditioner_assembly      (n, nullptr),
+_fieldsplit_type              (MAST::MultiphysicsNonlinearSolverBase::FIELDSPLIT_FROM_OPTIONS),
+_block_pc_type                (n, MAST::MultiphysicsNonlinearSolverBase::BLOCK_PC_FROM_OPTIONS),
+_pc_lag                       (1),
+_npc_type                     (MAST::MultiphysicsNonlinearSolverBase::NPC_NONE),
+_npc_mat                      (PETSC_NULL),
+_npc_pc                       (PETSC_NULL),
+_npc_work                     (PETSC_NULL),
+_concurrent_disciplines       (false),
+_zero_sols                    (n, nullptr),
 _is                           (_n_disciplines, PETSC_NULL),
 _sub_mats                     (_n_disciplines*_n_disciplines, PETSC_NULL),
-_n_dofs                       (0) {
+_pc_sub_mats                  (_n_disciplines*_n_disciplines, PETSC_NULL),
+_n_dofs                       (0),
+_mat                          (PETSC_NULL),
+_pc_mat                       (PETSC_NULL) {
     
 }
 
@@ -445,6 +572,99 @@ get_system_assembly(unsigned int i) {
 
 
 
+void
+MAST::MultiphysicsNonlinearSolverBase::
+set_preconditioner_assembly(unsigned int i,
+                            MAST::NonlinearImplicitAssembly& assembly) {
+    
+    // make sure that the index is within bounds
+    libmesh_assert_less(i, _n_disciplines);
+    
+    _preconditioner_assembly[i] = &assembly;
+}
+
+
+
+MAST::NonlinearImplicitAssembly&
+MAST::MultiphysicsNonlinearSolverBase::
+get_preconditioner_assembly(unsigned int i) {
+    
+    // make sure that the index is within bounds
+    libmesh_assert_less(i, _n_disciplines);
+    
+    if (_preconditioner_assembly[i])
+        return *_preconditioner_assembly[i];
+    else
+        return this->get_system_assembly(i);
+}
+
+
+
+//---------------------------------------------------------------
+// context of the SNES monitor that reports the iterations to the
+// solver telemetry
+struct
+__mast_multiphysics_petsc_telemetry_context {
+    MAST::MultiphysicsNonlinearSolverBase*  solver;
+    std::chrono::steady_clock::time_point   t0;
+};
+
+
+
+//---------------------------------------------------------------
+// this function is called by PETSc at each iteration if the solver
+// telemetry is active, and reports the norms of the residual of each
+// discipline
+PetscErrorCode
+__mast_multiphysics_petsc_telemetry_monitor(SNES snes,
+                                            PetscInt its,
+                                            PetscReal norm2,
+                                            void* ctx) {
+    
+    __mast_multiphysics_petsc_telemetry_context* p =
+    static_cast<__mast_multiphysics_petsc_telemetry_context*>(ctx);
+    
+    MAST::MultiphysicsNonlinearSolverBase& solver = *p->solver;
+    
+    PetscErrorCode ierr = 0;
+    
+    MAST::SolverTelemetry::Event
+    e(MAST::SolverTelemetry::NONLINEAR_ITERATION, solver.name());
+    
+    PetscInt
+    n_lin = 0;
+    ierr = SNESGetLinearSolveIterations(snes, &n_lin); CHKERRABORT(solver.comm().get(), ierr);
+    
+    e.iteration         = (unsigned int)its;
+    e.linear_iterations = (unsigned int)n_lin;
+    e.residual_l2       = norm2;
+    e.wall_time         = MAST::SolverTelemetry::elapsed(p->t0);
+    e.discipline_l2.resize(solver.n_disciplines(), 0.);
+    
+    // the norms of the discipline blocks of the residual
+    Vec r, sub_r;
+    ierr = SNESGetFunction(snes, &r, PETSC_NULL, PETSC_NULL); CHKERRABORT(solver.comm().get(), ierr);
+    
+    for (unsigned int i=0; i<solver.n_disciplines(); i++) {
+        
+        PetscReal
+        v = 0.;
+        
+        ierr = VecGetSubVector(r, solver.index_sets()[i], &sub_r);     CHKERRABORT(solver.comm().get(), ierr);
+        ierr = VecNorm(sub_r, NORM_2, &v);                             CHKERRABORT(solver.comm().get(), ierr);
+        ierr = VecRestoreSubVector(r, solver.index_sets()[i], &sub_r); CHKERRABORT(solver.comm().get(), ierr);
+        
+        e.discipline_l2[i] = v;
+    }
+    
+    MAST::solver_telemetry.emit(e);
+    
+    return ierr;
+}
+
+
+
+
 void
 MAST::MultiphysicsNonlinearSolverBase::solve() {
     
@@ -477,19 +697,25 @@ MAST::MultiphysicsNonlinearSolverBase::solve() {
     
     
     // all diagonal blocks use the system matrcices, while shell matrices
-    // are created for the off-diagonal terms.
+    // are created for the off-diagonal terms. If the Jacobian is
+    // matrix-free, the diagonal blocks are also shell matrices, and the
+    // system matrices are used only for the preconditioner.
     _n_dofs = 0.;
     for (unsigned int i=0; i<_n_disciplines; i++) {
         
         MAST::NonlinearSystem& sys = _discipline_assembly[i]->system();
         
+        // the diagonal block keeps the near null space of the system,
+        // which is used by the preconditioner of the fieldsplit block
+        sys.attach_near_null_space();
+        
         // add the number of dofs in this system to the global count
         _n_dofs      +=  sys.n_dofs();
         n_local_dofs +=  sys.n_local_dofs();
         
         for (unsigned int j=0; j<_n_disciplines; j++) {
             
-            if (i==j) {
+            if (i==j && !_matrix_free_jacobian) {
                 
                 // the diagonal matrix
                 _sub_mats[i*_n_disciplines+j] =
@@ -497,6 +723,11 @@ MAST::MultiphysicsNonlinearSolverBase::solve() {
             }
             else {
                 
+                // the diagonal preconditioner matrix
+                if (i==j)
+                    _pc_sub_mats[i*_n_disciplines+j] =
+                    dynamic_cast<libMesh::PetscMatrix<Real>*>(sys.matrix)->mat();
+                
                 MAST::NonlinearSystem& sys_j = _discipline_assembly[j]->system();
                 
                 PetscInt
@@ -542,6 +773,17 @@ MAST::MultiphysicsNonlinearSolverBase::solve() {
                          &_sub_mats[0],
                          &_mat);
     CHKERRABORT(this->comm().get(), ierr);
+    
+    // the preconditioner only couples the diagonal blocks
+    if (_matrix_free_jacobian) {
+        
+        ierr = MatCreateNest(this->comm().get(),
+                             _n_disciplines, PETSC_NULL,
+                             _n_disciplines, PETSC_NULL,
+                             &_pc_sub_mats[0],
+                             &_pc_mat);
+        CHKERRABORT(this->comm().get(), ierr);
+    }
 
     // we need to turn off MULT_TRANSPOSE operator for the global matrix
     // since that is not implemented for the shell matrices pushes PETSc 3.7.4
@@ -582,7 +824,10 @@ MAST::MultiphysicsNonlinearSolverBase::solve() {
     
     //////////////////////////////////////////////////////////////////////
     // now initialize the vector from the system solutions, which will serve
-    // as the initial solution for the coupled system
+    // as the initial solution for the coupled system. The index sets of the
+    // nested matrix are contiguous on each processor, so that the
+    // subvectors are views of the nested vector storage, and the values
+    // are copied in one operation per discipline.
     //////////////////////////////////////////////////////////////////////
     for (unsigned int i=0; i<_n_disciplines; i++) {
 
@@ -590,6 +835,10 @@ MAST::MultiphysicsNonlinearSolverBase::solve() {
         libMesh::NumericVector<Real>
         &sys_sol = *_discipline_assembly[i]->system().solution;
         
+        // zero vector used for the perturbation of the other disciplines
+        // in the off-diagonal products
+        _zero_sols[i] = sys_sol.zero_clone().release();
+        
         // limiting indices for the system, and multiphysics assembly. Should
         // be the same
         int
@@ -610,13 +859,8 @@ MAST::MultiphysicsNonlinearSolverBase::solve() {
         libmesh_assert_equal_to(multiphysics_first, first);
         libmesh_assert_equal_to( multiphysics_last,  last);
         
-        std::auto_ptr<libMesh::NumericVector<Real> >
-        multiphysics_sol(new libMesh::PetscVector<Real>(sub_vec, this->comm()));
-        
-        for (unsigned int i=first; i<last; i++)
-            multiphysics_sol->set(i, sys_sol(i));
-
-        multiphysics_sol->close();
+        ierr = VecCopy(dynamic_cast<libMesh::PetscVector<Real>&>(sys_sol).vec(),
+                       sub_vec);                         CHKERRABORT(this->comm().get(), ierr);
         
         ierr = VecRestoreSubVector(_sol, _is[i], &sub_vec);  CHKERRABORT(this->comm().get(), ierr);
     }
@@ -639,7 +883,7 @@ MAST::MultiphysicsNonlinearSolverBase::solve() {
                             this);
     ierr = SNESSetJacobian(snes,
                            _mat,
-                           _mat,
+                           this->pc_mat(),
                            __mast_multiphysics_petsc_snes_jacobian,
                            this);
     
@@ -652,15 +896,16 @@ MAST::MultiphysicsNonlinearSolverBase::solve() {
     
     
     
-    // setup the ksp
+    // setup the ksp and pc. The built-in preconditioner settings are
+    // applied first so that the command line options can override them
     ierr = SNESGetKSP (snes, &ksp);                   CHKERRABORT(this->comm().get(), ierr);
+    ierr = KSPGetPC(ksp, &pc);                        CHKERRABORT(this->comm().get(), ierr);
+    this->_set_preconditioner(snes, pc, sys_name?nm:std::string());
+    if (_npc_type != MAST::MultiphysicsNonlinearSolverBase::NPC_NONE)
+        this->_set_nonlinear_preconditioner(snes, sys_name?nm:std::string());
     ierr = SNESSetFromOptions(snes);                  CHKERRABORT(this->comm().get(), ierr);
     
     
-    
-    // setup the pc
-    ierr = KSPGetPC(ksp, &pc);                        CHKERRABORT(this->comm().get(), ierr);
-    
     for (unsigned int i=0; i<_n_disciplines; i++) {
         
         if (sys_name) {
@@ -679,13 +924,70 @@ MAST::MultiphysicsNonlinearSolverBase::solve() {
     //////////////////////////////////////////////////////////////////////
     // now, solve
     //////////////////////////////////////////////////////////////////////
+    // the iterations are reported to the telemetry only if a callback
+    // is registered
+    const bool
+    telemetry = MAST::solver_telemetry.active();
+    
+    __mast_multiphysics_petsc_telemetry_context
+    telemetry_ctx;
+    telemetry_ctx.solver = this;
+    telemetry_ctx.t0     = std::chrono::steady_clock::now();
+    
+    const std::chrono::steady_clock::time_point
+    t0 = telemetry_ctx.t0;
+    
+    if (telemetry) {
+        
+        ierr = SNESMonitorSet(snes,
+                              __mast_multiphysics_petsc_telemetry_monitor,
+                              (void*)&telemetry_ctx,
+                              PETSC_NULL);
+        CHKERRABORT(this->comm().get(), ierr);
+    }
+    
     START_LOG("SNESSolve", this->name()+"_MultiphysicsSolve");
     
     // now solve
-    ierr = SNESSolve(snes, PETSC_NULL, _sol);
+    {
+        MAST_LOG_SCOPE("SNESSolve", "MultiphysicsNonlinearSolver");
+        ierr = SNESSolve(snes, PETSC_NULL, _sol);
+    }
     
     STOP_LOG("SNESSolve", this->name()+"_MultiphysicsSolve");
     
+    if (telemetry) {
+        
+        MAST::SolverTelemetry::Event
+        e(MAST::SolverTelemetry::NONLINEAR_SOLVE, this->name());
+        
+        PetscInt
+        its   = 0,
+        n_lin = 0;
+        PetscReal
+        norm2 = 0.;
+        SNESConvergedReason
+        reason = SNES_CONVERGED_ITERATING;
+        Vec r;
+        
+        ierr = SNESGetIterationNumber(snes, &its);                CHKERRABORT(this->comm().get(), ierr);
+        ierr = SNESGetLinearSolveIterations(snes, &n_lin);        CHKERRABORT(this->comm().get(), ierr);
+        ierr = SNESGetConvergedReason(snes, &reason);             CHKERRABORT(this->comm().get(), ierr);
+        ierr = SNESGetFunction(snes, &r, PETSC_NULL, PETSC_NULL); CHKERRABORT(this->comm().get(), ierr);
+        ierr = VecNorm(r, NORM_2, &norm2);                        CHKERRABORT(this->comm().get(), ierr);
+        
+        std::chrono::steady_clock::time_point
+        t = t0;
+        
+        e.iteration         = (unsigned int)its;
+        e.linear_iterations = (unsigned int)n_lin;
+        e.residual_l2       = norm2;
+        e.converged         = reason > 0;
+        e.wall_time         = MAST::SolverTelemetry::elapsed(t);
+        
+        MAST::solver_telemetry.emit(e);
+    }
+    
     
     //////////////////////////////////////////////////////////////////////
     // now copy the solution back to the system solution vector
@@ -716,13 +1018,16 @@ MAST::MultiphysicsNonlinearSolverBase::solve() {
         libmesh_assert_equal_to(multiphysics_first, first);
         libmesh_assert_equal_to( multiphysics_last,  last);
         
-        std::auto_ptr<libMesh::NumericVector<Real> >
-        multiphysics_sol(new libMesh::PetscVector<Real>(sub_vec, this->comm()));
-        
-        for (unsigned int i=first; i<last; i++)
-            sys_sol.set(i, (*multiphysics_sol)(i));
+        ierr = VecCopy(sub_vec,
+                       dynamic_cast<libMesh::PetscVector<Real>&>(sys_sol).vec());
+        CHKERRABORT(this->comm().get(), ierr);
 
         ierr = VecRestoreSubVector(_sol, _is[i], &sub_vec);  CHKERRABORT(this->comm().get(), ierr);
+        
+        sys_sol.close();
+        
+        delete _zero_sols[i];
+        _zero_sols[i] = nullptr;
     }
 
     
@@ -731,19 +1036,345 @@ MAST::MultiphysicsNonlinearSolverBase::solve() {
     ierr = SNESDestroy(&snes);                        CHKERRABORT(this->comm().get(), ierr);
     for (unsigned int i=0; i<_n_disciplines; i++)
         for (unsigned int j=0; j<_n_disciplines; j++)
-            if (i != j) {
+            if (i != j || _matrix_free_jacobian) {
                 ierr = MatDestroy(&_sub_mats[i*_n_disciplines+j]);
                 CHKERRABORT(this->comm().get(), ierr);
             }
     
     ierr = MatDestroy(&_mat);                          CHKERRABORT(this->comm().get(), ierr);
+    if (_matrix_free_jacobian) {
+        ierr = MatDestroy(&_pc_mat);                   CHKERRABORT(this->comm().get(), ierr);
+    }
     ierr = VecDestroy(&_sol);                          CHKERRABORT(this->comm().get(), ierr);
     ierr = VecDestroy(&_res);                          CHKERRABORT(this->comm().get(), ierr);
     
+    if (_npc_mat) {
+        ierr = MatDestroy(&_npc_mat);                  CHKERRABORT(this->comm().get(), ierr);
+        ierr = PCDestroy(&_npc_pc);                    CHKERRABORT(this->comm().get(), ierr);
+        ierr = VecDestroy(&_npc_work);                 CHKERRABORT(this->comm().get(), ierr);
+    }
+    
+}
+
+
+
+
+void
+MAST::MultiphysicsNonlinearSolverBase::
+set_block_preconditioner(unsigned int i,
+                         MAST::MultiphysicsNonlinearSolverBase::BlockPreconditionerType t) {
+    
+    libmesh_assert_less(i, _n_disciplines);
+    
+    _block_pc_type[i] = t;
+}
+
+
+
+void
+MAST::MultiphysicsNonlinearSolverBase::_set_preconditioner(SNES snes,
+                                                           PC pc,
+                                                           const std::string& prefix) {
+    
+    PetscErrorCode ierr;
+    
+    ierr = SNESSetLagPreconditioner(snes, _pc_lag);   CHKERRABORT(this->comm().get(), ierr);
+    
+    if (_fieldsplit_type == MAST::MultiphysicsNonlinearSolverBase::FIELDSPLIT_FROM_OPTIONS)
+        return;
+    
+    ierr = PCSetType(pc, PCFIELDSPLIT);               CHKERRABORT(this->comm().get(), ierr);
+    
+    switch (_fieldsplit_type) {
+            
+        case MAST::MultiphysicsNonlinearSolverBase::FIELDSPLIT_ADDITIVE:
+            ierr = PCFieldSplitSetType(pc, PC_COMPOSITE_ADDITIVE);
+            break;
+            
+        case MAST::MultiphysicsNonlinearSolverBase::FIELDSPLIT_MULTIPLICATIVE:
+            ierr = PCFieldSplitSetType(pc, PC_COMPOSITE_MULTIPLICATIVE);
+            break;
+            
+        case MAST::MultiphysicsNonlinearSolverBase::FIELDSPLIT_SCHUR: {
+            
+            // the off-diagonal blocks are shell matrices, so the Schur
+            // complement is preconditioned with the diagonal block
+            libmesh_assert_equal_to(_n_disciplines, 2);
+            ierr = PCFieldSplitSetType(pc, PC_COMPOSITE_SCHUR);
+            CHKERRABORT(this->comm().get(), ierr);
+            ierr = PCFieldSplitSetSchurPre(pc, PC_FIELDSPLIT_SCHUR_PRE_A11, PETSC_NULL);
+        }
+            break;
+            
+        default:
+            libmesh_error();
+    }
+    CHKERRABORT(this->comm().get(), ierr);
+    
+    this->_set_block_preconditioner_options(prefix);
+}
+
+
+
+void
+MAST::MultiphysicsNonlinearSolverBase::
+_set_block_preconditioner_options(const std::string& prefix) {
+    
+    // the sub-solvers of the blocks are created in the setup of the
+    // fieldsplit, and are configured through their option prefix. Splits
+    // without a name are numbered by PETSc.
+    for (unsigned int i=0; i<_n_disciplines; i++) {
+        
+        std::ostringstream oss;
+        oss << "-" << prefix << "fieldsplit_";
+        if (libMesh::on_command_line("--solver_system_names"))
+            oss << _discipline_assembly[i]->system().name();
+        else
+            oss << i;
+        oss << "_";
+        
+        const std::string
+        block = oss.str();
+        
+        switch (_block_pc_type[i]) {
+                
+            case MAST::MultiphysicsNonlinearSolverBase::BLOCK_PC_FROM_OPTIONS:
+                break;
+                
+            case MAST::MultiphysicsNonlinearSolverBase::BLOCK_PC_GAMG: {
+                
+                // the interpolation is reused when the preconditioner is
+                // recomputed for the same nonzero pattern
+                MAST::set_default_petsc_option(block + "ksp_type", "preonly");
+                MAST::set_default_petsc_option(block + "pc_type",  "gamg");
+                MAST::set_default_petsc_option(block + "pc_gamg_reuse_interpolation", "true");
+            }
+                break;
+                
+            case MAST::MultiphysicsNonlinearSolverBase::BLOCK_PC_ILU: {
+                
+                MAST::set_default_petsc_option(block + "ksp_type",    "preonly");
+                MAST::set_default_petsc_option(block + "pc_type",     "bjacobi");
+                MAST::set_default_petsc_option(block + "sub_pc_type", "ilu");
+            }
+                break;
+                
+            case MAST::MultiphysicsNonlinearSolverBase::BLOCK_PC_ASM: {
+                
+                MAST::set_default_petsc_option(block + "ksp_type",    "preonly");
+                MAST::set_default_petsc_option(block + "pc_type",     "asm");
+                MAST::set_default_petsc_option(block + "sub_pc_type", "ilu");
+            }
+                break;
+                
+            default:
+                libmesh_error();
+        }
+    }
+}
+
+
+
+void
+MAST::MultiphysicsNonlinearSolverBase::
+_set_nonlinear_preconditioner(SNES snes,
+                              const std::string& prefix) {
+    
+    PetscErrorCode ierr;
+    KSP            ksp;
+    PC             pc;
+    SNES           npc;
+    PetscInt       n_local = 0;
+    
+    const std::string
+    npc_prefix = prefix + "npc_";
+    
+    // Newton iterations with line search are applied to the
+    // preconditioned residual x - M(x)
+    ierr = SNESSetType(snes, SNESNEWTONLS);           CHKERRABORT(this->comm().get(), ierr);
+    ierr = SNESSetNPCSide(snes, PC_LEFT);             CHKERRABORT(this->comm().get(), ierr);
+    ierr = SNESSetFunctionType(snes, SNES_FUNCTION_PRECONDITIONED);
+    CHKERRABORT(this->comm().get(), ierr);
+    
+    // the nonlinear preconditioner solves the disciplines
+    ierr = VecDuplicate(_sol, &_npc_work);            CHKERRABORT(this->comm().get(), ierr);
+    ierr = SNESGetNPC(snes, &npc);                    CHKERRABORT(this->comm().get(), ierr);
+    ierr = SNESSetType(npc, SNESSHELL);               CHKERRABORT(this->comm().get(), ierr);
+    ierr = SNESShellSetContext(npc, this);            CHKERRABORT(this->comm().get(), ierr);
+    ierr = SNESShellSetSolve(npc, __mast_multiphysics_petsc_npc_solve);
+    CHKERRABORT(this->comm().get(), ierr);
+    ierr = SNESSetFunction(npc,
+                           _npc_work,
+                           __mast_multiphysics_petsc_snes_residual,
+                           this);                     CHKERRABORT(this->comm().get(), ierr);
+    
+    // the Jacobian of the preconditioned residual is a shell matrix. The
+    // Jacobian callback assembles the discipline blocks of the coupled
+    // Jacobian used by the shell.
+    ierr = VecGetLocalSize(_sol, &n_local);           CHKERRABORT(this->comm().get(), ierr);
+    ierr = MatCreateShell(this->comm().get(),
+                          n_local,
+                          n_local,
+                          _n_dofs,
+                          _n_dofs,
+                          this,
+                          &_npc_mat);                 CHKERRABORT(this->comm().get(), ierr);
+    ierr = MatShellSetOperation(_npc_mat,
+                                MATOP_MULT,
+                                (void(*)(void))__mast_multiphysics_petsc_npc_mat_mult);
+    CHKERRABORT(this->comm().get(), ierr);
+    ierr = SNESSetJacobian(snes,
+                           _npc_mat,
+                           _npc_mat,
+                           __mast_multiphysics_petsc_snes_jacobian,
+                           this);                     CHKERRABORT(this->comm().get(), ierr);
+    
+    // the shell is already preconditioned
+    ierr = SNESGetKSP (snes, &ksp);                   CHKERRABORT(this->comm().get(), ierr);
+    ierr = KSPGetPC(ksp, &pc);                        CHKERRABORT(this->comm().get(), ierr);
+    ierr = PCSetType(pc, PCNONE);                     CHKERRABORT(this->comm().get(), ierr);
+    
+    // the fieldsplit of the discipline blocks, which is additive for
+    // ASPIN and multiplicative for the sweep over the disciplines
+    ierr = PCCreate(this->comm().get(), &_npc_pc);    CHKERRABORT(this->comm().get(), ierr);
+    ierr = PCSetOptionsPrefix(_npc_pc, npc_prefix.c_str());
+    CHKERRABORT(this->comm().get(), ierr);
+    ierr = PCSetType(_npc_pc, PCFIELDSPLIT);          CHKERRABORT(this->comm().get(), ierr);
+    ierr = PCFieldSplitSetType(_npc_pc,
+                               _npc_type == MAST::MultiphysicsNonlinearSolverBase::NPC_ASPIN?
+                               PC_COMPOSITE_ADDITIVE:PC_COMPOSITE_MULTIPLICATIVE);
+    CHKERRABORT(this->comm().get(), ierr);
+    ierr = PCSetOperators(_npc_pc, _mat, this->pc_mat());
+    CHKERRABORT(this->comm().get(), ierr);
+    
+    for (unsigned int i=0; i<_n_disciplines; i++) {
+        
+        if (libMesh::on_command_line("--solver_system_names")) {
+            
+            std::string nm = _discipline_assembly[i]->system().name();
+            ierr = PCFieldSplitSetIS(_npc_pc, nm.c_str(), _is[i]);
+        }
+        else
+            ierr = PCFieldSplitSetIS(_npc_pc, nullptr, _is[i]);
+        CHKERRABORT(this->comm().get(), ierr);
+    }
+    
+    this->_set_block_preconditioner_options(npc_prefix);
+    ierr = PCSetFromOptions(_npc_pc);                 CHKERRABORT(this->comm().get(), ierr);
 }
 
 
 
+void
+MAST::MultiphysicsNonlinearSolverBase::apply_nonlinear_preconditioner(Vec x) {
+    
+    MAST_LOG_SCOPE("apply_nonlinear_preconditioner()", "MultiphysicsNonlinearSolver");
+    
+    PetscErrorCode ierr;
+    Vec            y = PETSC_NULL;
+    
+    const bool
+    additive = (_npc_type == MAST::MultiphysicsNonlinearSolverBase::NPC_ASPIN);
+    
+    // the disciplines start from the current iterate
+    for (unsigned int i=0; i<_n_disciplines; i++)
+        this->_copy_to_system_solution(i, x);
+    
+    // for the additive method, the discipline solutions are collected in
+    // y, and each discipline is solved with the others at the iterate
+    if (additive) {
+        
+        ierr = VecDuplicate(x, &y);                   CHKERRABORT(this->comm().get(), ierr);
+        ierr = VecCopy(x, y);                         CHKERRABORT(this->comm().get(), ierr);
+    }
+    
+    std::vector<libMesh::NumericVector<Real>*> sols(_n_disciplines);
+    
+    for (unsigned int i=0; i<_n_disciplines; i++) {
+        
+        if (_update) {
+            
+            for (unsigned int j=0; j<_n_disciplines; j++)
+                sols[j] = _discipline_assembly[j]->system().solution.get();
+            
+            _update->update_at_solution(sols);
+        }
+        
+        // the nonlinear solver of the system may have been used by another
+        // assembly
+        _discipline_assembly[i]->reattach_to_system();
+        _discipline_assembly[i]->system().solve();
+        
+        if (additive) {
+            
+            this->_copy_from_system_solution(i, y);
+            this->_copy_to_system_solution(i, x);
+        }
+        else
+            this->_copy_from_system_solution(i, x);
+    }
+    
+    if (additive) {
+        
+        ierr = VecCopy(y, x);                         CHKERRABORT(this->comm().get(), ierr);
+        ierr = VecDestroy(&y);                        CHKERRABORT(this->comm().get(), ierr);
+    }
+}
+
+
+
+void
+MAST::MultiphysicsNonlinearSolverBase::preconditioned_jacobian_product(Vec x, Vec y) {
+    
+    libmesh_assert(_npc_pc);
+    
+    PetscErrorCode ierr;
+    
+    // the fieldsplit is setup again if the blocks were assembled at a
+    // new iterate
+    ierr = PCSetUp(_npc_pc);                          CHKERRABORT(this->comm().get(), ierr);
+    
+    ierr = MatMult(_mat, x, _npc_work);               CHKERRABORT(this->comm().get(), ierr);
+    ierr = PCApply(_npc_pc, _npc_work, y);            CHKERRABORT(this->comm().get(), ierr);
+}
+
+
+
+void
+MAST::MultiphysicsNonlinearSolverBase::_copy_to_system_solution(unsigned int i, Vec x) {
+    
+    PetscErrorCode ierr;
+    Vec            sub_vec;
+    
+    MAST::NonlinearSystem& sys = _discipline_assembly[i]->system();
+    
+    ierr = VecGetSubVector(x, _is[i], &sub_vec);      CHKERRABORT(this->comm().get(), ierr);
+    ierr = VecCopy(sub_vec,
+                   dynamic_cast<libMesh::PetscVector<Real>&>(*sys.solution).vec());
+    CHKERRABORT(this->comm().get(), ierr);
+    ierr = VecRestoreSubVector(x, _is[i], &sub_vec);  CHKERRABORT(this->comm().get(), ierr);
+    
+    sys.solution->close();
+    sys.update();
+}
+
+
+
+void
+MAST::MultiphysicsNonlinearSolverBase::_copy_from_system_solution(unsigned int i, Vec x) {
+    
+    PetscErrorCode ierr;
+    Vec            sub_vec;
+    
+    MAST::NonlinearSystem& sys = _discipline_assembly[i]->system();
+    
+    ierr = VecGetSubVector(x, _is[i], &sub_vec);      CHKERRABORT(this->comm().get(), ierr);
+    ierr = VecCopy(dynamic_cast<libMesh::PetscVector<Real>&>(*sys.solution).vec(),
+                   sub_vec);                          CHKERRABORT(this->comm().get(), ierr);
+    ierr = VecRestoreSubVector(x, _is[i], &sub_vec);  CHKERRABORT(this->comm().get(), ierr);
+}
+
+
 
 void
 MAST::MultiphysicsNonlinearSolverBase::verify_gateaux_derivatives(SNES snes) {
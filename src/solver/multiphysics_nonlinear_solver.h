@@ -96,6 +96,212 @@ namespace MAST {
         MAST::NonlinearImplicitAssembly& get_system_assembly(unsigned int i);
 
         
+        /*!
+         *   if \p f is true, the diagonal blocks of the coupled Jacobian are
+         *   also replaced by shell matrices that compute the product
+         *   \f$ [J_{ii}] \{dX_i\} \f$ through
+         *   NonlinearImplicitAssembly::linearized_jacobian_solution_product,
+         *   so that the Jacobian of no discipline is stored. The system
+         *   matrices are then only used to store the preconditioner, which
+         *   is assembled by the preconditioner assembly of each discipline,
+         *   if provided, or by the discipline assembly otherwise. This is
+         *   false by default. Combine with \p -snes_lag_preconditioner to
+         *   reuse the assembled preconditioner over several Newton
+         *   iterations.
+         */
+        void set_matrix_free_jacobian(bool f) {
+            
+            _matrix_free_jacobian = f;
+        }
+
+        
+        /*!
+         *   @returns true if the Jacobian is applied in a matrix-free manner
+         */
+        bool if_matrix_free_jacobian() const {
+            
+            return _matrix_free_jacobian;
+        }
+        
+        
+        /*!
+         *   sets the assembly used to compute the preconditioner matrix
+         *   of the i^th discipline when the Jacobian is matrix-free. This
+         *   can be a cheaper approximation of the Jacobian, for example the
+         *   linear stiffness matrix, or a lower-order fluid Jacobian. The
+         *   object must be initialized for the same system as the i^th
+         *   discipline assembly.
+         */
+        void set_preconditioner_assembly(unsigned int i,
+                                         MAST::NonlinearImplicitAssembly& assembly);
+        
+        
+        /*!
+         *   @returns a reference to the assembly that computes the
+         *   preconditioner of the i^th discipline. This is the discipline
+         *   assembly unless a preconditioner assembly was provided.
+         */
+        MAST::NonlinearImplicitAssembly& get_preconditioner_assembly(unsigned int i);
+
+        
+        
+        /*!
+         *   type of the fieldsplit preconditioner over the disciplines
+         */
+        enum FieldSplitType {
+            FIELDSPLIT_FROM_OPTIONS,    // configured only from the command line
+            FIELDSPLIT_ADDITIVE,        // block Jacobi
+            FIELDSPLIT_MULTIPLICATIVE,  // block Gauss-Seidel
+            FIELDSPLIT_SCHUR            // Schur complement, for two disciplines
+        };
+        
+        
+        /*!
+         *   preconditioner of the diagonal block of a discipline
+         */
+        enum BlockPreconditionerType {
+            BLOCK_PC_FROM_OPTIONS,      // configured only from the command line
+            BLOCK_PC_GAMG,              // algebraic multigrid
+            BLOCK_PC_ILU,               // block Jacobi with ILU on each processor
+            BLOCK_PC_ASM                // additive Schwarz with ILU subdomain solves
+        };
+        
+        
+        /*!
+         *   sets the fieldsplit preconditioner used by solve(). These
+         *   settings, and those of the block preconditioners, are applied
+         *   before the solver reads the PETSc options, so that options given
+         *   on the command line for the same solver take precedence. This
+         *   is \p FIELDSPLIT_FROM_OPTIONS by default.
+         */
+        void set_fieldsplit_type(MAST::MultiphysicsNonlinearSolverBase::FieldSplitType t) {
+            _fieldsplit_type = t;
+        }
+        
+        
+        /*!
+         *   sets the preconditioner of the diagonal block of the i^th
+         *   discipline in the fieldsplit preconditioner. The near null
+         *   space of the discipline system, if provided, is attached to the
+         *   block, which is used by \p BLOCK_PC_GAMG. For example, GAMG is
+         *   suited to the structural block, and ILU or ASM to the fluid
+         *   block. This has an effect only if a fieldsplit type is set.
+         */
+        void set_block_preconditioner(unsigned int i,
+                                      MAST::MultiphysicsNonlinearSolverBase::BlockPreconditionerType t);
+        
+        
+        /*!
+         *   sets the number of Newton iterations over which the
+         *   preconditioner is reused, so that the setup of the block
+         *   preconditioners, including the GAMG hierarchy, is not repeated
+         *   at every iteration. A value of -2 computes the preconditioner
+         *   once. See SNESSetLagPreconditioner(). This is 1 by default.
+         */
+        void set_preconditioner_lag(int n) {
+            _pc_lag = n;
+        }
+        
+        
+        /*!
+         *   nonlinear preconditioner of the coupled Newton solver
+         */
+        enum NonlinearPreconditionerType {
+            NPC_NONE,                   // Newton on the coupled residual
+            NPC_ASPIN,                  // additive Schwarz over the disciplines
+            NPC_FIELDSPLIT              // multiplicative sweep over the disciplines
+        };
+        
+        
+        /*!
+         *   sets the nonlinear preconditioner used by solve(). With a
+         *   nonlinear preconditioner, Newton iterations are applied to the
+         *   left-preconditioned residual \f$ \{x\} - \{M(x)\} \f$, where
+         *   \f$ M \f$ solves the nonlinear problem of each discipline with
+         *   its own solver and options, for the other disciplines fixed.
+         *   With \p NPC_ASPIN, the disciplines are the subdomains of
+         *   the additive Schwarz preconditioned inexact Newton method, and
+         *   are all solved about the same iterate. With \p NPC_FIELDSPLIT,
+         *   the disciplines are solved in the order of their index, each
+         *   with the updated solution of the previous disciplines. The
+         *   pre-residual update object is called before each discipline
+         *   solve. The Jacobian of the preconditioned residual is applied
+         *   as \f$ [P]^{-1} [J] \f$, where \f$ [P] \f$ is the additive or
+         *   multiplicative fieldsplit of the discipline blocks of the
+         *   coupled Jacobian, whose blocks are solved with the block
+         *   preconditioners of set_block_preconditioner() under the option
+         *   prefix \p npc_. The localized nonlinearities are thus resolved
+         *   by the discipline solves, which reduces the number of global
+         *   Newton iterations. This is \p NPC_NONE by default.
+         */
+        void
+        set_nonlinear_preconditioner(MAST::MultiphysicsNonlinearSolverBase::NonlinearPreconditionerType t) {
+            _npc_type = t;
+        }
+        
+        
+        /*!
+         *   @returns the nonlinear preconditioner used by solve()
+         */
+        MAST::MultiphysicsNonlinearSolverBase::NonlinearPreconditionerType
+        nonlinear_preconditioner() const {
+            return _npc_type;
+        }
+        
+        
+        /*!
+         *   replaces the coupled iterate \p x with \f$ M(x) \f$ of the
+         *   nonlinear preconditioner by solving each discipline. This is
+         *   called by the PETSc nonlinear preconditioner during solve().
+         */
+        void apply_nonlinear_preconditioner(Vec x);
+        
+        
+        /*!
+         *   computes \f$ y = [P]^{-1} [J] x \f$, the product of the
+         *   Jacobian of the preconditioned residual with \p x about the
+         *   current iterate. This is called by the PETSc shell matrix of
+         *   the nonlinear preconditioner during solve().
+         */
+        void preconditioned_jacobian_product(Vec x, Vec y);
+        
+        
+        /*!
+         *   if \p f is true, the residual and Jacobian callbacks run the
+         *   element loops of all disciplines before the first global
+         *   synchronization of the assembled quantities (see
+         *   MAST::NonlinearImplicitAssembly::set_deferred_close()). If the
+         *   meshes of the disciplines are partitioned on disjoint sets of
+         *   processors, for example with MAST::RankRangePartitioner sized to
+         *   the cost of each discipline, the disciplines are then evaluated
+         *   concurrently. The element kernels must then not require
+         *   global communication. This is false by default.
+         */
+        void set_concurrent_discipline_evaluation(bool f) {
+            _concurrent_disciplines = f;
+        }
+        
+        
+        /*!
+         *   @returns true if the disciplines are evaluated concurrently
+         */
+        bool if_concurrent_discipline_evaluation() const {
+            return _concurrent_disciplines;
+        }
+        
+        
+        /*!
+         *   @returns a zero vector of the i^th discipline, which is used
+         *   as the perturbation of the disciplines that are not perturbed
+         *   in the off-diagonal Jacobian products. This is available only
+         *   during solve(), and must not be modified.
+         */
+        libMesh::NumericVector<Real>& zero_solution(unsigned int i) {
+            libmesh_assert_less(i, _n_disciplines);
+            libmesh_assert(_zero_sols[i]);
+            return *_zero_sols[i];
+        }
+        
         
         /*!
          *   @returns a reference to the petsc index sets
@@ -113,6 +319,16 @@ namespace MAST {
             
             return _mat;
         }
+
+        
+        /*!
+         *   @returns the preconditioner matrix context. This is the same as
+         *   mat() unless the Jacobian is matrix-free.
+         */
+        Mat pc_mat() {
+            
+            return _matrix_free_jacobian?_pc_mat:_mat;
+        }
         
         /*!
          *   solves the system using the nested matrices that uses the
@@ -202,11 +418,103 @@ namespace MAST {
          */
         std::vector<MAST::NonlinearImplicitAssembly*>  _discipline_assembly;
 
+        /*!
+         *   flag to apply the Jacobian in a matrix-free manner
+         */
+        bool                                           _matrix_free_jacobian;
+        
+        /*!
+         *   vector of assembly objects used to compute the preconditioner
+         *   of each discipline when the Jacobian is matrix-free. Entries
+         *   are nullptr if the discipline assembly should be used.
+         */
+        std::vector<MAST::NonlinearImplicitAssembly*>  _preconditioner_assembly;
+        
+        
+        /*!
+         *   sets up the fieldsplit preconditioner \p pc of \p snes. The
+         *   options of the block preconditioners are added to the PETSc
+         *   options database for the solver with option \p prefix, unless
+         *   they are already set.
+         */
+        void _set_preconditioner(SNES snes,
+                                 PC pc,
+                                 const std::string& prefix);
+        
+        /*!
+         *   adds the options of the block preconditioners to the PETSc
+         *   options database for the fieldsplit with option \p prefix,
+         *   unless they are already set
+         */
+        void _set_block_preconditioner_options(const std::string& prefix);
+        
+        /*!
+         *   sets up the nonlinear preconditioner of \p snes, with the
+         *   shell Jacobian of the preconditioned residual and the
+         *   fieldsplit of the discipline blocks with option \p prefix
+         */
+        void _set_nonlinear_preconditioner(SNES snes,
+                                           const std::string& prefix);
+        
+        /*!
+         *   copies the solution of the i^th discipline in \p x to the
+         *   solution vector of its system
+         */
+        void _copy_to_system_solution(unsigned int i, Vec x);
+        
+        /*!
+         *   copies the solution vector of the i^th discipline system to
+         *   the block of the discipline in \p x
+         */
+        void _copy_from_system_solution(unsigned int i, Vec x);
+        
+        /*!
+         *   type of the fieldsplit preconditioner
+         */
+        MAST::MultiphysicsNonlinearSolverBase::FieldSplitType _fieldsplit_type;
+        
+        /*!
+         *   preconditioner of the diagonal block of each discipline
+         */
+        std::vector<MAST::MultiphysicsNonlinearSolverBase::BlockPreconditionerType>
+        _block_pc_type;
+        
+        /*!
+         *   number of Newton iterations for which the preconditioner is
+         *   reused
+         */
+        int                                            _pc_lag;
+        
+        /*!
+         *   nonlinear preconditioner, and the shell Jacobian of the
+         *   preconditioned residual with its fieldsplit of the discipline
+         *   blocks, created during solve()
+         */
+        MAST::MultiphysicsNonlinearSolverBase::NonlinearPreconditionerType _npc_type;
+        
+        Mat                                            _npc_mat;
+        
+        PC                                             _npc_pc;
+        
+        Vec                                            _npc_work;
+        
+        /*!
+         *   flag to evaluate the disciplines concurrently
+         */
+        bool                                           _concurrent_disciplines;
+        
+
+        /*!
+         *   zero vectors of the disciplines, retained during solve()
+         */
+        std::vector<libMesh::NumericVector<Real>*>     _zero_sols;
+        
         std::vector<IS>  _is;
         std::vector<Mat> _sub_mats; // row-major ordering
+        std::vector<Mat> _pc_sub_mats; // row-major ordering
         unsigned int     _n_dofs;
 
-        Mat              _mat;
+        Mat              _mat, _pc_mat;
         Vec              _sol, _res;
 
     };
@@ -0,0 +1,331 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2017  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+// C++ includes
+#include <algorithm>
+
+
+// MAST includes
+#include "solver/parareal_transient_solver.h"
+#include "solver/transient_solver_base.h"
+#include "base/transient_assembly.h"
+#include "base/performance_log.h"
+
+
+
+MAST::PararealTransientSolver::
+PararealTransientSolver(const libMesh::Parallel::Communicator& time_comm):
+initial_time(0.),
+fine_dt(0.),
+n_fine_steps(0),
+n_coarse_steps(1),
+max_iterations(0),
+tol(1.e-6),
+_time_comm(time_comm),
+_fine(nullptr),
+_fine_assembly(nullptr),
+_coarse(nullptr),
+_coarse_assembly(nullptr),
+_send_pending(false),
+_n_iters(0),
+_converged(false) {
+    
+}
+
+
+
+MAST::PararealTransientSolver::~PararealTransientSolver() {
+    
+    if (_send_pending)
+        _send_request.wait();
+}
+
+
+
+void
+MAST::PararealTransientSolver::
+set_fine_solver(MAST::TransientSolverBase& solver,
+                MAST::TransientAssembly& assembly) {
+    
+    _fine          = &solver;
+    _fine_assembly = &assembly;
+}
+
+
+
+void
+MAST::PararealTransientSolver::
+set_coarse_solver(MAST::TransientSolverBase& solver,
+                  MAST::TransientAssembly& assembly) {
+    
+    libmesh_assert_equal_to(solver.ode_order(), _fine? _fine->ode_order(): solver.ode_order());
+    
+    _coarse          = &solver;
+    _coarse_assembly = &assembly;
+}
+
+
+
+void
+MAST::PararealTransientSolver::solve() {
+    
+    MAST_LOG_SCOPE("solve()", "PararealTransientSolver");
+    
+    libmesh_assert(_fine);
+    libmesh_assert_greater(fine_dt, 0.);
+    libmesh_assert_greater(n_fine_steps, 0);
+    libmesh_assert_greater(n_coarse_steps, 0);
+    
+    const unsigned int
+    rank    = _time_comm.rank(),
+    n_slabs = _time_comm.size(),
+    max_its = max_iterations? max_iterations: n_slabs;
+    
+    const Real
+    coarse_dt = n_fine_steps * fine_dt / n_coarse_steps;
+    
+    MAST::TransientSolverBase
+    &coarse          = _coarse? *_coarse: *_fine;
+    MAST::TransientAssembly
+    &coarse_assembly = _coarse? *_coarse_assembly: *_fine_assembly;
+    
+    std::vector<libMesh::NumericVector<Real>*>
+    U     = this->_build_state(),
+    U_new = this->_build_state(),
+    F     = this->_build_state(),
+    G_old = this->_build_state(),
+    G_new = this->_build_state(),
+    U_end = this->_build_state();
+    
+    // the serial coarse sweep gives the initial states of the slabs
+    if (!rank)
+        _fine->get_state(U);
+    else
+        this->_receive_state(U);
+    
+    this->_propagate(coarse, coarse_assembly, U, coarse_dt, n_coarse_steps, G_old);
+    
+    if (rank < n_slabs-1)
+        this->_send_state(G_old);
+    
+    _n_iters   = 0;
+    _converged = false;
+    
+    // the fine propagation is repeated only if the start of the slab
+    // has changed
+    bool
+    changed = true;
+    
+    for (unsigned int it=1; it<=max_its; it++) {
+        
+        // the fine propagation of all slabs in parallel
+        if (changed)
+            this->_propagate(*_fine, *_fine_assembly, U, fine_dt, n_fine_steps, F);
+        
+        // the serial coarse correction
+        Real
+        err = 0.;
+        changed = false;
+        
+        if (rank) {
+            
+            this->_receive_state(U_new);
+            
+            U_end[0]->zero();
+            U_end[0]->add( 1., *U_new[0]);
+            U_end[0]->add(-1., *U[0]);
+            U_end[0]->close();
+            
+            const Real
+            d   = U_end[0]->l2_norm(),
+            nrm = U_new[0]->l2_norm();
+            
+            err     = nrm > 0.? d/nrm: d;
+            changed = d > 0.;
+            
+            for (unsigned int i=0; i<U.size(); i++)
+                std::swap(U[i], U_new[i]);
+        }
+        
+        if (changed)
+            this->_propagate(coarse, coarse_assembly, U, coarse_dt, n_coarse_steps, G_new);
+        
+        // U_end = F + (G_new - G_old), where the correction is zero if
+        // the start of the slab has not changed
+        for (unsigned int i=0; i<U.size(); i++) {
+            
+            U_end[i]->zero();
+            if (changed) {
+                U_end[i]->add( 1., *G_new[i]);
+                U_end[i]->add(-1., *G_old[i]);
+                std::swap(G_old[i], G_new[i]);
+            }
+            U_end[i]->add(1., *F[i]);
+            U_end[i]->close();
+        }
+        
+        if (rank < n_slabs-1)
+            this->_send_state(U_end);
+        
+        _n_iters = it;
+        
+        _time_comm.max(err);
+        
+        libMesh::out
+        << "Parareal iter: " << it << " : change = " << err << std::endl;
+        
+        if (err <= tol) {
+            
+            _converged = true;
+            break;
+        }
+    }
+    
+    if (_send_pending) {
+        
+        _send_request.wait();
+        _send_pending = false;
+    }
+    
+    // the fine solver is left at the state at the end of its slab
+    if (_coarse)
+        _fine_assembly->reattach_to_system();
+    
+    _fine->dt = fine_dt;
+    _fine->set_state(U_end,
+                     initial_time + (rank+1) * n_fine_steps * fine_dt + fine_dt);
+    
+    this->_clear_state(U);
+    this->_clear_state(U_new);
+    this->_clear_state(F);
+    this->_clear_state(G_old);
+    this->_clear_state(G_new);
+    this->_clear_state(U_end);
+}
+
+
+
+void
+MAST::PararealTransientSolver::
+_propagate(MAST::TransientSolverBase& solver,
+           MAST::TransientAssembly& assembly,
+           const std::vector<libMesh::NumericVector<Real>*>& in,
+           Real dt,
+           unsigned int n,
+           std::vector<libMesh::NumericVector<Real>*>& out) {
+    
+    MAST_LOG_SCOPE("propagate()", "PararealTransientSolver");
+    
+    if (_coarse)
+        assembly.reattach_to_system();
+    
+    const Real
+    t = initial_time + _time_comm.rank() * n_fine_steps * fine_dt;
+    
+    // the time of the system after a time step is that of the next step
+    solver.dt = dt;
+    solver.set_state(in, t + dt);
+    
+    for (unsigned int i=0; i<n; i++) {
+        
+        solver.solve();
+        solver.advance_time_step();
+    }
+    
+    solver.get_state(out);
+}
+
+
+
+void
+MAST::PararealTransientSolver::
+_send_state(const std::vector<libMesh::NumericVector<Real>*>& state) {
+    
+    // the buffer of the previous send is reused after its completion
+    if (_send_pending)
+        _send_request.wait();
+    
+    _send_buffer.clear();
+    
+    for (unsigned int i=0; i<state.size(); i++) {
+        
+        const libMesh::NumericVector<Real>& v = *state[i];
+        
+        for (libMesh::numeric_index_type j=v.first_local_index();
+             j<v.last_local_index(); j++)
+            _send_buffer.push_back(v(j));
+    }
+    
+    _time_comm.send(_time_comm.rank()+1, _send_buffer, _send_request);
+    _send_pending = true;
+}
+
+
+
+void
+MAST::PararealTransientSolver::
+_receive_state(std::vector<libMesh::NumericVector<Real>*>& state) {
+    
+    std::vector<Real> buf;
+    _time_comm.receive(_time_comm.rank()-1, buf);
+    
+    unsigned int
+    k = 0;
+    
+    for (unsigned int i=0; i<state.size(); i++) {
+        
+        libMesh::NumericVector<Real>& v = *state[i];
+        
+        for (libMesh::numeric_index_type j=v.first_local_index();
+             j<v.last_local_index(); j++)
+            v.set(j, buf[k++]);
+        
+        v.close();
+    }
+    
+    libmesh_assert_equal_to(k, buf.size());
+}
+
+
+
+std::vector<libMesh::NumericVector<Real>*>
+MAST::PararealTransientSolver::_build_state() const {
+    
+    std::vector<libMesh::NumericVector<Real>*>
+    state(_fine->ode_order()+1, nullptr);
+    
+    for (unsigned int i=0; i<state.size(); i++)
+        state[i] = _fine->solution().zero_clone().release();
+    
+    return state;
+}
+
+
+
+void
+MAST::PararealTransientSolver::
+_clear_state(std::vector<libMesh::NumericVector<Real>*>& state) const {
+    
+    for (unsigned int i=0; i<state.size(); i++)
+        delete state[i];
+    
+    state.clear();
+}
+
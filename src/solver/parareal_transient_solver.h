@@ -0,0 +1,221 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2017  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+#ifndef __mast__parareal_transient_solver__
+#define __mast__parareal_transient_solver__
+
+// C++ includes
+#include <vector>
+
+
+// MAST includes
+#include "base/mast_data_types.h"
+
+
+// libMesh includes
+#include "libmesh/parallel.h"
+#include "libmesh/numeric_vector.h"
+
+
+namespace MAST {
+    
+    // Forward declerations
+    class TransientSolverBase;
+    class TransientAssembly;
+    
+    
+    /*!
+     *    Parallel-in-time integration of a transient problem with the
+     *    Parareal method. The time interval is split into slabs of
+     *    \p n_fine_steps steps of size \p fine_dt. The i^th slab is solved
+     *    by the processors of rank i in the time communicator, each of
+     *    which is a processor of the spatial communicator of its slab. So,
+     *    every slab must have a copy of the mesh and system on its own
+     *    spatial communicator, with the same partitioning of the dofs, and
+     *    the time communicator connects the processors with the same
+     *    rank in the spatial communicators. Only the local values of the
+     *    states are exchanged between slabs.
+     *
+     *    With the state \f$ U_k \f$ at the start of slab \p k, the fine
+     *    propagator \f$ F \f$ over the slab with \p fine_dt, and the coarse
+     *    propagator \f$ G \f$ with \p n_coarse_steps steps, the iterations
+     *    \f[ U_{k+1}^{j+1} = G(U_k^{j+1}) + F(U_k^j) - G(U_k^j) \f]
+     *    start from a serial coarse sweep. The fine propagations of all
+     *    slabs are performed in parallel, and only the coarse corrections
+     *    are serial. The state of a slab is exact after as many
+     *    iterations as its index, after which its propagations are
+     *    skipped. The iterations stop when the relative change of the
+     *    solution at the start of the slabs is less than \p tol.
+     *
+     *    The coarse propagator uses the fine solver by default. A separate
+     *    solver of the same type can be given with set_coarse_solver(), for
+     *    example with a retained operator of its own for linear problems
+     *    (see MAST::TransientSolverBase::set_linear_solve()). Both solvers
+     *    then share the solution and history vectors of the system.
+     */
+    class PararealTransientSolver {
+        
+    public:
+        
+        PararealTransientSolver(const libMesh::Parallel::Communicator& time_comm);
+        
+        virtual ~PararealTransientSolver();
+        
+        /*!
+         *   time of the initial condition
+         */
+        Real          initial_time;
+        
+        /*!
+         *   time step of the fine propagator
+         */
+        Real          fine_dt;
+        
+        /*!
+         *   number of fine and coarse time steps in each slab
+         */
+        unsigned int  n_fine_steps;
+        
+        unsigned int  n_coarse_steps;
+        
+        /*!
+         *   maximum number of Parareal iterations, which is the number of
+         *   slabs if it is zero
+         */
+        unsigned int  max_iterations;
+        
+        /*!
+         *   tolerance on the relative change of the solution at the start
+         *   of the slabs
+         */
+        Real          tol;
+        
+        
+        /*!
+         *   sets the solver and assembly of the slab of this processor,
+         *   which are used as the fine propagator. The initial condition
+         *   is the current state of the solver of the first slab (see
+         *   MAST::TransientSolverBase::solve_highest_derivative_and_advance_time_step()).
+         */
+        void set_fine_solver(MAST::TransientSolverBase& solver,
+                             MAST::TransientAssembly& assembly);
+        
+        
+        /*!
+         *   sets the solver and assembly used as the coarse propagator,
+         *   which must be attached to the same system as the fine solver
+         */
+        void set_coarse_solver(MAST::TransientSolverBase& solver,
+                               MAST::TransientAssembly& assembly);
+        
+        
+        /*!
+         *   performs the Parareal iterations. Upon return, the fine solver
+         *   of each slab is at the state at the end of its slab.
+         */
+        void solve();
+        
+        
+        /*!
+         *   @returns the number of iterations of the last solve
+         */
+        unsigned int n_iterations() const {
+            return _n_iters;
+        }
+        
+        
+        /*!
+         *   @returns true if the last solve converged
+         */
+        bool converged() const {
+            return _converged;
+        }
+        
+    protected:
+        
+        /*!
+         *   propagates \p in from the start of the slab of this processor
+         *   with \p n steps of size \p dt of \p solver, and returns the
+         *   state in \p out
+         */
+        void _propagate(MAST::TransientSolverBase& solver,
+                        MAST::TransientAssembly& assembly,
+                        const std::vector<libMesh::NumericVector<Real>*>& in,
+                        Real dt,
+                        unsigned int n,
+                        std::vector<libMesh::NumericVector<Real>*>& out);
+        
+        /*!
+         *   sends the local values of \p state to the next slab without
+         *   waiting for it to be received
+         */
+        void _send_state(const std::vector<libMesh::NumericVector<Real>*>& state);
+        
+        /*!
+         *   receives the local values of \p state from the previous slab
+         */
+        void _receive_state(std::vector<libMesh::NumericVector<Real>*>& state);
+        
+        /*!
+         *   @returns a new state with vectors of the size of the solution
+         */
+        std::vector<libMesh::NumericVector<Real>*> _build_state() const;
+        
+        /*!
+         *   deletes the vectors of \p state
+         */
+        void _clear_state(std::vector<libMesh::NumericVector<Real>*>& state) const;
+        
+        /*!
+         *   communicator that connects the slabs
+         */
+        const libMesh::Parallel::Communicator&   _time_comm;
+        
+        /*!
+         *   fine and coarse solvers, and their assemblies
+         */
+        MAST::TransientSolverBase*               _fine;
+        
+        MAST::TransientAssembly*                 _fine_assembly;
+        
+        MAST::TransientSolverBase*               _coarse;
+        
+        MAST::TransientAssembly*                 _coarse_assembly;
+        
+        /*!
+         *   buffer and request of the last send to the next slab
+         */
+        std::vector<Real>                        _send_buffer;
+        
+        libMesh::Parallel::Request               _send_request;
+        
+        bool                                     _send_pending;
+        
+        /*!
+         *   number of iterations and convergence of the last solve
+         */
+        unsigned int                             _n_iters;
+        
+        bool                                     _converged;
+    };
+}
+
+
+#endif // __mast__parareal_transient_solver__
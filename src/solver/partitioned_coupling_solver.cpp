@@ -0,0 +1,353 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2017  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+// MAST includes
+#include "solver/partitioned_coupling_solver.h"
+#include "base/nonlinear_implicit_assembly.h"
+#include "base/nonlinear_system.h"
+#include "base/performance_log.h"
+#include "base/solver_telemetry.h"
+
+
+MAST::PartitionedCouplingSolver::
+PartitionedCouplingSolver(const libMesh::Parallel::Communicator& comm_in,
+                          unsigned int n):
+libMesh::ParallelObject       (comm_in),
+tol                           (1.e-6),
+max_iters                     (50),
+_n_disciplines                (n),
+_discipline_assembly          (n, nullptr),
+_update                       (nullptr),
+_acceleration                 (MAST::PartitionedCouplingSolver::AITKEN),
+_omega0                       (0.5),
+_n_max_vecs                   (20),
+_omega                        (0.5),
+_r_prev                       (nullptr),
+_x_tilde_prev                 (nullptr),
+_n_iters                      (0),
+_converged                    (false) {
+
+}
+
+
+
+MAST::PartitionedCouplingSolver::~PartitionedCouplingSolver() {
+
+    this->_clear_acceleration_data();
+}
+
+
+
+void
+MAST::PartitionedCouplingSolver::
+set_system_assembly(unsigned int i,
+                    MAST::NonlinearImplicitAssembly& assembly) {
+
+    libmesh_assert_less(i, _n_disciplines);
+
+    _discipline_assembly[i] = &assembly;
+}
+
+
+
+MAST::NonlinearImplicitAssembly&
+MAST::PartitionedCouplingSolver::get_system_assembly(unsigned int i) {
+
+    libmesh_assert_less(i, _n_disciplines);
+    libmesh_assert(_discipline_assembly[i]);
+
+    return *_discipline_assembly[i];
+}
+
+
+
+void
+MAST::PartitionedCouplingSolver::
+set_acceleration(MAST::PartitionedCouplingSolver::AccelerationType t,
+                 Real omega,
+                 unsigned int n_vecs) {
+
+    libmesh_assert_greater(omega, 0.);
+
+    _acceleration = t;
+    _omega0       = omega;
+    _n_max_vecs   = n_vecs;
+}
+
+
+
+void
+MAST::PartitionedCouplingSolver::solve() {
+
+    MAST_LOG_SCOPE("solve()", "PartitionedCouplingSolver");
+
+    // make sure that all systems have been specified
+    for (unsigned int i=0; i<_n_disciplines; i++)
+        libmesh_assert(_discipline_assembly[i]);
+
+    this->_clear_acceleration_data();
+
+    MAST::NonlinearSystem&
+    sys = _discipline_assembly[_n_disciplines-1]->system();
+
+    // current iterate of the coupling variable, and the residual of the
+    // fixed-point iteration
+    std::auto_ptr<libMesh::NumericVector<Real> >
+    x(sys.solution->clone().release()),
+    r(sys.solution->zero_clone().release());
+
+    _n_iters   = 0;
+    _converged = false;
+
+    std::chrono::steady_clock::time_point
+    t0 = std::chrono::steady_clock::now();
+
+    while (_n_iters < max_iters) {
+
+        // block Gauss-Seidel iteration over the disciplines
+        for (unsigned int i=0; i<_n_disciplines; i++) {
+
+            this->_update_interface();
+            this->_solve_discipline(i);
+        }
+
+        const libMesh::NumericVector<Real>&
+        x_tilde = *sys.solution;
+
+        r->zero();
+        r->add( 1., x_tilde);
+        r->add(-1., *x);
+        r->close();
+
+        const Real
+        r_norm = r->l2_norm(),
+        x_norm = x_tilde.l2_norm();
+
+        libMesh::out
+        << "Coupling iter: " << _n_iters
+        << " :  ||dx|| = " << r_norm
+        << " :  ||x|| = " << x_norm
+        << std::endl;
+
+        _n_iters++;
+
+        const bool
+        converged = r_norm <= tol * x_norm;
+
+        if (MAST::solver_telemetry.active()) {
+
+            MAST::SolverTelemetry::Event
+            e(MAST::SolverTelemetry::COUPLING_ITERATION, sys.name());
+
+            e.iteration   = _n_iters-1;
+            e.residual_l2 = r_norm;
+            e.converged   = converged;
+            e.wall_time   = MAST::SolverTelemetry::elapsed(t0);
+
+            MAST::solver_telemetry.emit(e);
+        }
+
+        if (converged) {
+
+            _converged = true;
+            break;
+        }
+
+        this->_accelerate(_n_iters-1, *x, x_tilde, *r);
+
+        // the next iterate is given to the disciplines through the
+        // solution of the last discipline
+        *sys.solution = *x;
+        sys.solution->close();
+        sys.update();
+    }
+
+    // the interface data is left consistent with the final solutions
+    this->_update_interface();
+
+    this->_clear_acceleration_data();
+}
+
+
+
+void
+MAST::PartitionedCouplingSolver::_solve_discipline(unsigned int i) {
+
+    MAST::NonlinearImplicitAssembly& assembly = *_discipline_assembly[i];
+
+    // the nonlinear solver of the system may have been used by another
+    // assembly
+    assembly.reattach_to_system();
+    assembly.system().solve();
+}
+
+
+
+void
+MAST::PartitionedCouplingSolver::_update_interface() {
+
+    if (!_update)
+        return;
+
+    std::vector<libMesh::NumericVector<Real>*> sols(_n_disciplines);
+
+    for (unsigned int i=0; i<_n_disciplines; i++)
+        sols[i] = _discipline_assembly[i]->system().solution.get();
+
+    _update->update_at_solution(sols);
+}
+
+
+
+void
+MAST::PartitionedCouplingSolver::
+_accelerate(unsigned int k,
+            libMesh::NumericVector<Real>& x,
+            const libMesh::NumericVector<Real>& x_tilde,
+            const libMesh::NumericVector<Real>& r) {
+
+    switch (_acceleration) {
+
+        case MAST::PartitionedCouplingSolver::CONSTANT_RELAXATION: {
+
+            x.add(_omega0, r);
+            x.close();
+        }
+            break;
+
+        case MAST::PartitionedCouplingSolver::AITKEN: {
+
+            if (k == 0)
+                _omega = _omega0;
+            else {
+
+                // omega_k = -omega_{k-1} r_{k-1}^T (r_k - r_{k-1}) / |r_k - r_{k-1}|^2
+                std::auto_ptr<libMesh::NumericVector<Real> >
+                dr(r.clone().release());
+                dr->add(-1., *_r_prev);
+                dr->close();
+
+                const Real
+                dr_norm2 = dr->dot(*dr);
+
+                if (dr_norm2 > 0.)
+                    _omega = -_omega * _r_prev->dot(*dr) / dr_norm2;
+            }
+
+            x.add(_omega, r);
+            x.close();
+        }
+            break;
+
+        case MAST::PartitionedCouplingSolver::IQN_ILS: {
+
+            if (k > 0) {
+
+                libMesh::NumericVector<Real>
+                *dr = r.clone().release(),
+                *dx = x_tilde.clone().release();
+
+                dr->add(-1., *_r_prev);       dr->close();
+                dx->add(-1., *_x_tilde_prev); dx->close();
+
+                _V.push_front(dr);
+                _W.push_front(dx);
+
+                if (_V.size() > _n_max_vecs) {
+
+                    delete _V.back(); _V.pop_back();
+                    delete _W.back(); _W.pop_back();
+                }
+            }
+
+            if (_V.empty()) {
+
+                x.add(_omega0, r);
+                x.close();
+            }
+            else {
+
+                // least-squares solution of [V] {alpha} = -{r} from the
+                // normal equations. The matrix is small, and only needs
+                // global dot products of the vectors.
+                const unsigned int
+                m = (unsigned int)_V.size();
+
+                RealMatrixX
+                A = RealMatrixX::Zero(m, m);
+                RealVectorX
+                b = RealVectorX::Zero(m);
+
+                for (unsigned int i=0; i<m; i++) {
+
+                    b(i) = -_V[i]->dot(r);
+                    for (unsigned int j=0; j<=i; j++) {
+                        A(i,j) = _V[i]->dot(*_V[j]);
+                        A(j,i) = A(i,j);
+                    }
+                }
+
+                const RealVectorX
+                alpha = A.colPivHouseholderQr().solve(b);
+
+                // x_{k+1} = x_tilde_k + [W] {alpha}
+                x = x_tilde;
+                for (unsigned int i=0; i<m; i++)
+                    x.add(alpha(i), *_W[i]);
+                x.close();
+            }
+        }
+            break;
+
+        default:
+            libmesh_error();
+    }
+
+    // store the data for the next iteration
+    if (!_r_prev) {
+
+        _r_prev       = r.zero_clone().release();
+        _x_tilde_prev = x_tilde.zero_clone().release();
+    }
+
+    *_r_prev       = r;
+    *_x_tilde_prev = x_tilde;
+    _r_prev->close();
+    _x_tilde_prev->close();
+}
+
+
+
+void
+MAST::PartitionedCouplingSolver::_clear_acceleration_data() {
+
+    delete _r_prev;
+    delete _x_tilde_prev;
+    _r_prev       = nullptr;
+    _x_tilde_prev = nullptr;
+
+    for (unsigned int i=0; i<_V.size(); i++) {
+        delete _V[i];
+        delete _W[i];
+    }
+    _V.clear();
+    _W.clear();
+
+    _omega = _omega0;
+}
@@ -0,0 +1,247 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2017  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef __mast__partitioned_coupling_solver_h__
+#define __mast__partitioned_coupling_solver_h__
+
+// C++ includes
+#include <vector>
+#include <deque>
+
+
+// MAST includes
+#include "base/mast_data_types.h"
+#include "solver/multiphysics_nonlinear_solver.h"
+
+
+// libMesh includes
+#include "libmesh/parallel_object.h"
+#include "libmesh/numeric_vector.h"
+
+
+namespace MAST {
+
+    // Forward declerations
+    class NonlinearImplicitAssembly;
+
+
+    /*!
+     *   Solves a coupled problem by block Gauss-Seidel iterations over
+     *   the disciplines, where each discipline is solved with its own
+     *   solver and options. In each iteration the disciplines are solved
+     *   in the order of their index, and the pre-residual update object
+     *   is called before each discipline solve to transfer the interface
+     *   data from the current solutions of the other disciplines. The
+     *   solution of the last discipline is the coupling variable of the
+     *   fixed-point iteration, to which constant or Aitken relaxation, or
+     *   the interface quasi-Newton method with an inverse Jacobian from a
+     *   least-squares model (IQN-ILS) is applied. For FSI, the fluid
+     *   should therefore be discipline 0 and the structure discipline 1.
+     *   Only the vectors of the last discipline are stored by the
+     *   acceleration, and no coupled matrix is created.
+     */
+    class PartitionedCouplingSolver:
+    public libMesh::ParallelObject {
+
+    public:
+
+        /*!
+         *   acceleration of the fixed-point iterations
+         */
+        enum AccelerationType {
+            CONSTANT_RELAXATION,
+            AITKEN,
+            IQN_ILS
+        };
+
+
+        PartitionedCouplingSolver(const libMesh::Parallel::Communicator& comm_in,
+                                  unsigned int n);
+
+
+        virtual ~PartitionedCouplingSolver();
+
+
+        /*!
+         *   @returns the number of disciplines
+         */
+        unsigned int n_disciplines() const {
+            return _n_disciplines;
+        }
+
+
+        /*!
+         *   sets the assembly of the i^th discipline. The assembly must be
+         *   attached to its discipline and system.
+         */
+        void set_system_assembly(unsigned int i,
+                                 MAST::NonlinearImplicitAssembly& assembly);
+
+
+        /*!
+         *   @returns a reference to the assembly of the i^th discipline
+         */
+        MAST::NonlinearImplicitAssembly& get_system_assembly(unsigned int i);
+
+
+        /*!
+         *   sets the object that is called with the current solutions of
+         *   all disciplines before each discipline solve
+         */
+        void
+        set_pre_residual_update_object
+        (MAST::MultiphysicsNonlinearSolverBase::PreResidualUpdate& update) {
+            _update = &update;
+        }
+
+
+        /*!
+         *   sets the acceleration of the fixed-point iterations. \p omega
+         *   is the relaxation factor for \p CONSTANT_RELAXATION, and of the
+         *   first iteration for \p AITKEN and \p IQN_ILS. \p n_vecs is the
+         *   maximum number of iterations retained by the least-squares
+         *   model of IQN-ILS. The default is Aitken relaxation with
+         *   \p omega = 0.5.
+         */
+        void set_acceleration(MAST::PartitionedCouplingSolver::AccelerationType t,
+                              Real omega          = 0.5,
+                              unsigned int n_vecs = 20);
+
+
+        /*!
+         *   relative tolerance on the change of the coupling variable in
+         *   an iteration
+         */
+        Real          tol;
+
+        /*!
+         *   maximum number of coupling iterations
+         */
+        unsigned int  max_iters;
+
+
+        /*!
+         *   solves the coupled problem starting from the current solutions
+         *   of the discipline systems
+         */
+        void solve();
+
+
+        /*!
+         *   @returns the number of coupling iterations of the last solve
+         */
+        unsigned int n_iterations() const {
+            return _n_iters;
+        }
+
+
+        /*!
+         *   @returns true if the last solve converged
+         */
+        bool converged() const {
+            return _converged;
+        }
+
+    protected:
+
+        /*!
+         *   solves the i^th discipline. The default implementation calls
+         *   solve() of the discipline system, which uses the nonlinear
+         *   solver and options of the system. This can be reimplemented to
+         *   use, for example, a transient solver for the discipline.
+         */
+        virtual void _solve_discipline(unsigned int i);
+
+
+        /*!
+         *   calls the pre-residual update object, if provided, with the
+         *   current solutions of all disciplines
+         */
+        void _update_interface();
+
+
+        /*!
+         *   computes the next iterate of the coupling variable in \p x
+         *   from the iterate \p x, the result of the iteration \p x_tilde,
+         *   and the residual \p r = \p x_tilde - \p x of iteration \p k
+         */
+        void _accelerate(unsigned int k,
+                         libMesh::NumericVector<Real>& x,
+                         const libMesh::NumericVector<Real>& x_tilde,
+                         const libMesh::NumericVector<Real>& r);
+
+
+        /*!
+         *   deletes the vectors retained by the acceleration
+         */
+        void _clear_acceleration_data();
+
+
+        /*!
+         *   number of disciplines
+         */
+        const unsigned int _n_disciplines;
+
+        /*!
+         *   assembly objects of the disciplines
+         */
+        std::vector<MAST::NonlinearImplicitAssembly*>  _discipline_assembly;
+
+        /*!
+         *   interface data update
+         */
+        MAST::MultiphysicsNonlinearSolverBase::PreResidualUpdate* _update;
+
+        /*!
+         *   acceleration type, relaxation factor and maximum number of
+         *   IQN-ILS vectors
+         */
+        MAST::PartitionedCouplingSolver::AccelerationType _acceleration;
+
+        Real                                           _omega0;
+
+        unsigned int                                   _n_max_vecs;
+
+        /*!
+         *   relaxation factor of the last Aitken iteration
+         */
+        Real                                           _omega;
+
+        /*!
+         *   residual and result of the previous iteration
+         */
+        libMesh::NumericVector<Real>                   *_r_prev, *_x_tilde_prev;
+
+        /*!
+         *   differences of residuals and of results of successive
+         *   iterations used by IQN-ILS, with the most recent first
+         */
+        std::deque<libMesh::NumericVector<Real>*>      _V, _W;
+
+        /*!
+         *   number of iterations and convergence of the last solve
+         */
+        unsigned int                                   _n_iters;
+
+        bool                                           _converged;
+    };
+}
+
+
+#endif // __mast__partitioned_coupling_solver_h__
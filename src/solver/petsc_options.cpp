@@ -0,0 +1,42 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2017  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+// MAST includes
+#include "solver/petsc_options.h"
+
+
+// PETSc includes
+#include <petscsys.h>
+
+
+void
+MAST::set_default_petsc_option(const std::string& name,
+                               const std::string& value) {
+    
+    PetscErrorCode ierr;
+    PetscBool      set = PETSC_FALSE;
+    
+    ierr = PetscOptionsHasName(PETSC_NULL, PETSC_NULL, name.c_str(), &set);
+    CHKERRABORT(PETSC_COMM_WORLD, ierr);
+    
+    if (!set) {
+        ierr = PetscOptionsSetValue(PETSC_NULL, name.c_str(), value.c_str());
+        CHKERRABORT(PETSC_COMM_WORLD, ierr);
+    }
+}
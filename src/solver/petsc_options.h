@@ -0,0 +1,39 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2017  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef __mast__petsc_options_h__
+#define __mast__petsc_options_h__
+
+// C++ includes
+#include <string>
+
+
+namespace MAST {
+    
+    /*!
+     *   adds the option \p name with \p value to the PETSc options database,
+     *   unless the option has already been set, for example on the command
+     *   line. \p name includes the leading dash and the options prefix.
+     */
+    void set_default_petsc_option(const std::string& name,
+                                  const std::string& value);
+}
+
+
+#endif // __mast__petsc_options_h__
@@ -0,0 +1,236 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2017  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+// C++ includes
+#include <cmath>
+#include <algorithm>
+
+
+// MAST includes
+#include "solver/pseudo_transient_solver.h"
+#include "base/transient_assembly.h"
+#include "base/elem_base.h"
+#include "base/nonlinear_system.h"
+
+
+// libMesh includes
+#include "libmesh/numeric_vector.h"
+#include "libmesh/mesh_base.h"
+
+
+MAST::PseudoTransientSolver::PseudoTransientSolver():
+MAST::FirstOrderNewmarkTransientSolver(),
+initial_cfl(1.),
+min_cfl(1.e-2),
+max_cfl(1.e6),
+ser_exponent(1.),
+local_time_step(true),
+_cfl(1.),
+_initial_residual_norm(-1.),
+_residual_norm(0.)
+{ }
+
+
+MAST::PseudoTransientSolver::~PseudoTransientSolver()
+{ }
+
+
+
+void
+MAST::PseudoTransientSolver::reset() {
+    
+    _cfl                   = initial_cfl;
+    _initial_residual_norm = -1.;
+    _residual_norm         = 0.;
+    _elem_dt.clear();
+}
+
+
+
+void
+MAST::PseudoTransientSolver::solve() {
+    
+    // make sure that the system has been specified
+    libmesh_assert_msg(_system, "System pointer is nullptr.");
+    
+    this->_update_residual_and_cfl();
+    
+    // ask the Newton solver to solve for the system solution
+    _system->solve();
+}
+
+
+
+bool
+MAST::PseudoTransientSolver::
+solve_to_steady_state(const unsigned int max_steps,
+                      const Real rel_tol,
+                      const Real abs_tol) {
+    
+    // make sure that the system has been specified
+    libmesh_assert_msg(_system, "System pointer is nullptr.");
+    
+    this->reset();
+    
+    for (unsigned int i=0; i<=max_steps; i++) {
+        
+        this->_update_residual_and_cfl();
+        
+        if (_residual_norm <= abs_tol ||
+            _residual_norm <= rel_tol * _initial_residual_norm)
+            return true;
+        
+        if (i == max_steps)
+            break;
+        
+        _system->solve();
+        this->advance_time_step();
+    }
+    
+    return false;
+}
+
+
+
+void
+MAST::PseudoTransientSolver::_update_residual_and_cfl() {
+    
+    libmesh_assert_msg(beta == 1.,
+                       "Pseudo-transient continuation requires beta = 1.");
+    libmesh_assert_greater(dt, 0.);
+    
+    // the element time steps are recomputed for the solution at the
+    // beginning of this pseudo time step. The entries of all local
+    // elements are created here, so that the threaded assembly only
+    // assigns the values of existing entries.
+    _elem_dt.clear();
+    
+    libMesh::MeshBase::const_element_iterator
+    el     = _system->get_mesh().active_local_elements_begin(),
+    end_el = _system->get_mesh().active_local_elements_end();
+    
+    for ( ; el != end_el; el++)
+        _elem_dt.insert(std::pair<const libMesh::Elem*, Real>(*el, -1.));
+    
+    // at the beginning of the time step x = x0, so that the velocity
+    // (x - x0)/dt is zero, and the system residual is the steady
+    // residual, f_x(x0).
+    _system->assembly(true, false);
+    _residual_norm = _system->rhs->l2_norm();
+    
+    if (_initial_residual_norm < 0.) {
+        
+        _initial_residual_norm = _residual_norm;
+        _cfl                   = initial_cfl;
+    }
+    else if (_residual_norm > 0.)
+        // switched evolution relaxation
+        _cfl = initial_cfl * pow(_initial_residual_norm/_residual_norm, ser_exponent);
+    else
+        _cfl = max_cfl;
+    
+    _cfl = std::max(min_cfl, std::min(max_cfl, _cfl));
+}
+
+
+
+Real
+MAST::PseudoTransientSolver::_elem_time_step(MAST::ElementBase& elem) {
+    
+    if (!local_time_step)
+        return dt * _cfl / initial_cfl;
+    
+    // the time step for unit CFL is retained for each element, so that
+    // it is evaluated once for the solution at the beginning of the step.
+    // The map is not modified here, since this may be called from the
+    // threads of the assembly.
+    std::map<const libMesh::Elem*, Real>::iterator
+    it = _elem_dt.find(&elem.elem());
+    
+    if (it == _elem_dt.end())
+        return _cfl * _assembly->_elem_local_time_step(elem, 1.);
+    
+    if (it->second < 0.)
+        it->second = _assembly->_elem_local_time_step(elem, 1.);
+    
+    return _cfl * it->second;
+}
+
+
+
+void
+MAST::PseudoTransientSolver::
+_elem_calculations(MAST::ElementBase& elem,
+                   const std::vector<libMesh::dof_id_type>& dof_indices,
+                   bool if_jac,
+                   RealVectorX& vec,
+                   RealMatrixX& mat) {
+    
+    // the initialization of the velocity is same as the parent class
+    if (_if_highest_derivative_solution) {
+        
+        MAST::FirstOrderNewmarkTransientSolver::_elem_calculations(elem,
+                                                                  dof_indices,
+                                                                  if_jac,
+                                                                  vec,
+                                                                  mat);
+        return;
+    }
+    
+    // make sure that the assembly object is provided
+    libmesh_assert(_assembly);
+    unsigned int n_dofs = (unsigned int)dof_indices.size();
+    
+    RealVectorX
+    f_x     = RealVectorX::Zero(n_dofs),
+    f_m     = RealVectorX::Zero(n_dofs);
+    
+    RealMatrixX
+    f_m_jac_xdot  = RealMatrixX::Zero(n_dofs, n_dofs),
+    f_m_jac       = RealMatrixX::Zero(n_dofs, n_dofs),
+    f_x_jac       = RealMatrixX::Zero(n_dofs, n_dofs);
+    
+    // perform the element assembly
+    _assembly->_elem_calculations(elem,
+                                  if_jac,
+                                  f_m,           // mass vector
+                                  f_x,           // forcing vector
+                                  f_m_jac_xdot,  // Jac of mass wrt x_dot
+                                  f_m_jac,       // Jac of mass wrt x
+                                  f_x_jac);      // Jac of forcing vector wrt x
+    
+    //
+    // with beta = 1, x_dot = (x-x0)/dt. Scaling the mass term by dt/dt_e
+    // replaces dt with the element time step:
+    //
+    // r     = dt/dt_e f_m + f_x
+    // dr/dx = 1/dt_e df_m/dx_dot + dt/dt_e df_m/dx + df_x/dx
+    //
+    const Real
+    fact = dt / _elem_time_step(elem);
+    
+    // system residual
+    vec  = fact * f_m + f_x;
+    
+    // system Jacobian
+    if (if_jac)
+        mat = fact * ((1./dt)*f_m_jac_xdot + f_m_jac) + f_x_jac;
+}
+
@@ -0,0 +1,181 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2017  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+#ifndef __mast__pseudo_transient_solver__
+#define __mast__pseudo_transient_solver__
+
+// C++ includes
+#include <map>
+
+
+// MAST includes
+#include "solver/first_order_newmark_transient_solver.h"
+
+
+namespace MAST {
+    
+    
+    /*!
+     *    This class implements pseudo-transient continuation for the
+     *    solution of steady-state problems with a first-order ODE,
+     *    \f$ f_m(x, \dot{x}) + f_x(x) = 0  \f$. Each pseudo time step
+     *    is an implicit Euler step, \p beta = 1, of the parent class
+     *    where the mass term of each element is scaled by
+     *    \f$ dt/dt_e \f$, so that the element is advanced with its own
+     *    time step \f$ dt_e \f$. With \p local_time_step, \f$ dt_e \f$ is
+     *    obtained from the CFL number and the local spectral radius through
+     *    MAST::TransientAssembly::_elem_local_time_step(). Otherwise,
+     *    all elements use \f$ dt_e = dt \cdot CFL/CFL_0 \f$. The element
+     *    time steps are frozen at the solution at the beginning of each
+     *    pseudo time step.
+     *
+     *    The CFL number is updated before each pseudo time step using
+     *    switched evolution relaxation (SER),
+     *    \f[ CFL = CFL_0 \left( \frac{||f_x(x_0)||}{||f_x(x)||}\right)^{p} \f]
+     *    and is bounded by \p min_cfl and \p max_cfl, so that the time step
+     *    grows as the steady residual is reduced and the iterations
+     *    approach Newton's method.
+     */
+    class PseudoTransientSolver:
+    public MAST::FirstOrderNewmarkTransientSolver {
+    public:
+        PseudoTransientSolver();
+        
+        virtual ~PseudoTransientSolver();
+        
+        /*!
+         *    CFL number for the first pseudo time step, \f$ CFL_0 \f$.
+         */
+        Real initial_cfl;
+        
+        /*!
+         *    bounds on the CFL number
+         */
+        Real min_cfl;
+        Real max_cfl;
+        
+        /*!
+         *    exponent \f$ p \f$ of the SER update of the CFL number
+         */
+        Real ser_exponent;
+        
+        /*!
+         *    if \p true, element-local time steps are used. This is
+         *    \p true by default.
+         */
+        bool local_time_step;
+        
+        /*!
+         *    resets the CFL number to \p initial_cfl, and the reference
+         *    residual norm of the SER update.
+         */
+        void reset();
+        
+        /*!
+         *    @returns the CFL number used for the current pseudo time step.
+         */
+        Real cfl() const {
+            return _cfl;
+        }
+        
+        /*!
+         *    @returns the norm of the steady residual at the solution at the
+         *    beginning of the latest pseudo time step.
+         */
+        Real steady_residual_norm() const {
+            return _residual_norm;
+        }
+        
+        /*!
+         *   evaluates the steady residual at the current solution, updates
+         *   the CFL number and solves the current pseudo time step
+         */
+        virtual void solve();
+        
+        /*!
+         *   performs pseudo time steps with solve() and advance_time_step()
+         *   until the steady residual norm is below \p abs_tol, or is reduced
+         *   by \p rel_tol relative to its value at the first step, or until
+         *   \p max_steps steps have been performed. The CFL number is
+         *   reset before the first step.
+         *   @returns \p true if the tolerance was satisfied.
+         */
+        bool solve_to_steady_state(const unsigned int max_steps,
+                                   const Real rel_tol,
+                                   const Real abs_tol);
+        
+    protected:
+        
+        /*!
+         *   performs the element calculations over \par elem, and returns
+         *   the element vector and matrix quantities in \par mat and
+         *   \par vec, respectively, with the mass term scaled for the
+         *   element time step.
+         */
+        virtual void
+        _elem_calculations(MAST::ElementBase& elem,
+                           const std::vector<libMesh::dof_id_type>& dof_indices,
+                           bool if_jac,
+                           RealVectorX& vec,
+                           RealMatrixX& mat);
+        
+        /*!
+         *   evaluates the steady residual norm at the current solution,
+         *   which is assumed to be the solution at the beginning of the
+         *   pseudo time step, and updates the CFL number.
+         */
+        void _update_residual_and_cfl();
+        
+        /*!
+         *   @returns the time step of \p elem for the current pseudo 
+         *   time step. This is computed on the first request for the
+         *   element in a pseudo time step.
+         */
+        Real _elem_time_step(MAST::ElementBase& elem);
+        
+        /*!
+         *   CFL number for the current pseudo time step
+         */
+        Real _cfl;
+        
+        /*!
+         *   steady residual norm at the first pseudo time step. This is
+         *   negative if the first step has not been performed since reset().
+         */
+        Real _initial_residual_norm;
+        
+        /*!
+         *   steady residual norm at the beginning of the current pseudo
+         *   time step
+         */
+        Real _residual_norm;
+        
+        /*!
+         *   time steps of the elements for the current pseudo time step.
+         *   The entries are created for all local elements at the
+         *   beginning of the step, with a negative value until the time
+         *   step of the element is computed.
+         */
+        std::map<const libMesh::Elem*, Real> _elem_dt;
+    };
+    
+}
+
+#endif // __mast__pseudo_transient_solver__
@@ -0,0 +1,434 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2017  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+// C++ includes
+#include <cmath>
+#include <limits>
+
+
+// MAST includes
+#include "solver/reduced_order_thermal_transient_solver.h"
+#include "base/transient_assembly.h"
+#include "base/nonlinear_system.h"
+#include "base/performance_log.h"
+
+
+// libMesh includes
+#include "libmesh/dof_map.h"
+#include "libmesh/petsc_matrix.h"
+#include "libmesh/petsc_vector.h"
+
+
+MAST::ReducedOrderThermalTransientSolver::ReducedOrderThermalTransientSolver():
+dt(0.),
+beta(1.),
+energy_tol(1.e-8),
+max_basis_size(0),
+_assembly(nullptr),
+_time_dependent_load(true),
+_force_initialized(false),
+_time(0.),
+_op_dt(0.),
+_op_beta(0.) {
+    
+}
+
+
+
+MAST::ReducedOrderThermalTransientSolver::~ReducedOrderThermalTransientSolver() {
+    
+    this->_clear_basis();
+    
+    for (unsigned int i=0; i<_snapshots.size(); i++)
+        delete _snapshots[i];
+}
+
+
+
+void
+MAST::ReducedOrderThermalTransientSolver::
+init(MAST::TransientAssembly& assembly,
+     bool time_dependent_load) {
+    
+    MAST_LOG_SCOPE("init()", "ReducedOrderThermalTransientSolver");
+    
+    _assembly            = &assembly;
+    _time_dependent_load = time_dependent_load;
+    _force_initialized   = false;
+    
+    MAST::NonlinearSystem& sys = assembly.system();
+    
+    _C.reset(libMesh::SparseMatrix<Real>::build(sys.comm()).release());
+    _K.reset(libMesh::SparseMatrix<Real>::build(sys.comm()).release());
+    sys.get_dof_map().attach_matrix(*_C);
+    sys.get_dof_map().attach_matrix(*_K);
+    _C->init();
+    _K->init();
+    
+    std::auto_ptr<libMesh::NumericVector<Real> >
+    zero(sys.solution->zero_clone().release());
+    
+    assembly.assemble_first_order_quantities(*zero, nullptr, _C.get(), _K.get());
+    
+    _time = sys.time;
+}
+
+
+
+void
+MAST::ReducedOrderThermalTransientSolver::
+add_snapshot(const libMesh::NumericVector<Real>& sol) {
+    
+    _snapshots.push_back(sol.clone().release());
+}
+
+
+
+void
+MAST::ReducedOrderThermalTransientSolver::build_pod_basis() {
+    
+    MAST_LOG_SCOPE("build_pod_basis()", "ReducedOrderThermalTransientSolver");
+    
+    libmesh_assert(_assembly);
+    libmesh_assert(_snapshots.size());
+    
+    this->_clear_basis();
+    
+    const unsigned int
+    ns = (unsigned int)_snapshots.size();
+    
+    // method of snapshots with the correlation matrix
+    RealMatrixX
+    S = RealMatrixX::Zero(ns, ns);
+    
+    for (unsigned int i=0; i<ns; i++)
+        for (unsigned int j=i; j<ns; j++) {
+            S(i,j) = _snapshots[i]->dot(*_snapshots[j]);
+            S(j,i) = S(i,j);
+        }
+    
+    Eigen::SelfAdjointEigenSolver<RealMatrixX> eig(S);
+    
+    const RealVectorX
+    &sigma = eig.eigenvalues();
+    
+    const Real
+    total  = sigma.cwiseMax(0.).sum();
+    
+    libmesh_assert_greater(total, 0.);
+    
+    // the eigenvalues are in ascending order
+    Real
+    retained = 0.;
+    
+    for (int k=(int)ns-1; k>=0; k--) {
+        
+        if (sigma(k) <= ns * std::numeric_limits<Real>::epsilon() * sigma(ns-1) ||
+            (max_basis_size && _basis.size() == max_basis_size) ||
+            retained >= (1.-energy_tol) * total)
+            break;
+        
+        libMesh::NumericVector<Real>*
+        phi = _snapshots[0]->zero_clone().release();
+        
+        for (unsigned int i=0; i<ns; i++)
+            phi->add(eig.eigenvectors()(i,k)/std::sqrt(sigma(k)), *_snapshots[i]);
+        phi->close();
+        
+        _basis.push_back(phi);
+        retained += sigma(k);
+    }
+    
+    libMesh::out
+    << "Thermal POD basis with " << _basis.size() << " modes from "
+    << ns << " snapshots, retained energy fraction: "
+    << retained/total << std::endl;
+    
+    this->_init_reduced_system();
+}
+
+
+
+void
+MAST::ReducedOrderThermalTransientSolver::
+build_krylov_basis(unsigned int n_moments) {
+    
+    MAST_LOG_SCOPE("build_krylov_basis()", "ReducedOrderThermalTransientSolver");
+    
+    libmesh_assert(_assembly);
+    libmesh_assert_greater(n_moments, 0);
+    
+    this->_clear_basis();
+    
+    MAST::NonlinearSystem& sys = _assembly->system();
+    
+    PetscErrorCode ierr;
+    KSP            ksp;
+    
+    Mat K_mat = dynamic_cast<libMesh::PetscMatrix<Real>&>(*_K).mat();
+    
+    std::pair<unsigned int, Real>
+    solver_params = sys.get_linear_solve_parameters();
+    
+    ierr = KSPCreate(sys.comm().get(), &ksp);          CHKERRABORT(sys.comm().get(), ierr);
+    if (libMesh::on_command_line("--solver_system_names")) {
+        
+        std::string nm = sys.name() + "_thermal_rom_";
+        KSPSetOptionsPrefix(ksp, nm.c_str());
+    }
+    ierr = KSPSetOperators(ksp, K_mat, K_mat);         CHKERRABORT(sys.comm().get(), ierr);
+    ierr = KSPSetTolerances(ksp,
+                            solver_params.second,
+                            PETSC_DEFAULT,
+                            PETSC_DEFAULT,
+                            solver_params.first);      CHKERRABORT(sys.comm().get(), ierr);
+    ierr = KSPSetFromOptions(ksp);                     CHKERRABORT(sys.comm().get(), ierr);
+    ierr = KSPSetUp(ksp);                              CHKERRABORT(sys.comm().get(), ierr);
+    
+    std::auto_ptr<libMesh::NumericVector<Real> >
+    rhs(sys.solution->zero_clone().release());
+    
+    // the first moment is the static response to the load
+    this->_load_residual(_time, *rhs);
+    
+    for (unsigned int k=0; k<n_moments; k++) {
+        
+        libMesh::NumericVector<Real>*
+        v = rhs->zero_clone().release();
+        
+        ierr = KSPSolve(ksp,
+                        dynamic_cast<libMesh::PetscVector<Real>&>(*rhs).vec(),
+                        dynamic_cast<libMesh::PetscVector<Real>&>(*v).vec());
+        CHKERRABORT(sys.comm().get(), ierr);
+        
+        // the next moment is the response to the capacitance term of
+        // this vector
+        _C->vector_mult(*rhs, *v);
+        
+        _basis.push_back(v);
+    }
+    
+    ierr = KSPDestroy(&ksp);                           CHKERRABORT(sys.comm().get(), ierr);
+    
+    this->_init_reduced_system();
+    
+    libMesh::out
+    << "Thermal Krylov basis with " << _basis.size() << " vectors from "
+    << n_moments << " moments" << std::endl;
+}
+
+
+
+void
+MAST::ReducedOrderThermalTransientSolver::
+set_initial_condition(const libMesh::NumericVector<Real>& sol) {
+    
+    libmesh_assert(_basis_mat.get());
+    
+    // the basis is orthonormal
+    _basis_mat->project(sol, _q);
+    
+    // C q_dot = f - K q
+    _reduced_force(_time, _f);
+    _q_dot = _C_r.partialPivLu().solve(_f - _K_r * _q);
+}
+
+
+
+void
+MAST::ReducedOrderThermalTransientSolver::solve_and_advance_time_step() {
+    
+    MAST_LOG_SCOPE("solve_and_advance_time_step()", "ReducedOrderThermalTransientSolver");
+    
+    libmesh_assert(_basis_mat.get());
+    libmesh_assert_greater(dt, 0.);
+    
+    // the effective operator is factorized once for the time step and
+    // Newmark parameter
+    if (_op_dt != dt || _op_beta != beta) {
+        
+        _op.compute(_K_r + (1./beta/dt) * _C_r);
+        _op_dt    = dt;
+        _op_beta  = beta;
+    }
+    
+    const Real
+    t = _time + dt;
+    
+    _reduced_force(t, _f);
+    
+    // the solution is written as
+    //   q      = q0 + (1-beta) dt q0_dot + beta dt q_dot
+    // which is substituted in the equations
+    RealVectorX
+    rhs = _f +
+    _C_r * ((1./beta/dt) * _q +
+            ((1.-beta)/beta) * _q_dot),
+    q = _op.solve(rhs);
+    
+    _q_dot = (1./beta/dt) * (q - _q) - ((1.-beta)/beta) * _q_dot;
+    _q     = q;
+    _time  = t;
+}
+
+
+
+void
+MAST::ReducedOrderThermalTransientSolver::advance_to_time(Real t) {
+    
+    libmesh_assert_greater(dt, 0.);
+    
+    const Real
+    dt0 = dt,
+    tol = 1.e-10 * dt;
+    
+    while (_time < t - tol) {
+        
+        if (_time + dt0 > t)
+            dt = t - _time;
+        
+        this->solve_and_advance_time_step();
+    }
+    
+    dt = dt0;
+}
+
+
+
+void
+MAST::ReducedOrderThermalTransientSolver::
+reconstruct_solution(libMesh::NumericVector<Real>& sol) const {
+    
+    libmesh_assert(_basis_mat.get());
+    
+    _basis_mat->reconstruct(_q, sol);
+}
+
+
+
+void
+MAST::ReducedOrderThermalTransientSolver::_init_reduced_system() {
+    
+    // modified Gram-Schmidt, repeated once, with the vectors that are
+    // linearly dependent on the previous ones discarded
+    std::vector<libMesh::NumericVector<Real>*> basis;
+    
+    for (unsigned int i=0; i<_basis.size(); i++) {
+        
+        libMesh::NumericVector<Real>& v = *_basis[i];
+        
+        const Real
+        v0 = v.l2_norm();
+        
+        for (unsigned int pass=0; pass<2; pass++)
+            for (unsigned int j=0; j<basis.size(); j++)
+                v.add(-v.dot(*basis[j]), *basis[j]);
+        
+        const Real
+        v1 = v.l2_norm();
+        
+        if (v0 == 0. || v1 < 1.e-10 * v0) {
+            
+            delete _basis[i];
+            continue;
+        }
+        
+        v.scale(1./v1);
+        v.close();
+        basis.push_back(_basis[i]);
+    }
+    
+    _basis.swap(basis);
+    
+    libmesh_assert(_basis.size());
+    
+    MAST::NonlinearSystem& sys = _assembly->system();
+    
+    _basis_mat.reset(new MAST::BasisMatrix<Real>(sys.comm()));
+    _basis_mat->modes = _basis;
+    _basis_mat->init_dense_storage();
+    
+    _basis_mat->project(*_C, _C_r);
+    _basis_mat->project(*_K, _K_r);
+    
+    const unsigned int
+    n = (unsigned int)_basis.size();
+    
+    _q      = RealVectorX::Zero(n);
+    _q_dot  = RealVectorX::Zero(n);
+    _f      = RealVectorX::Zero(n);
+    
+    _force_initialized = false;
+    _op_dt             = 0.;
+}
+
+
+
+void
+MAST::ReducedOrderThermalTransientSolver::
+_load_residual(Real t, libMesh::NumericVector<Real>& res) {
+    
+    MAST::NonlinearSystem& sys = _assembly->system();
+    
+    std::auto_ptr<libMesh::NumericVector<Real> >
+    zero(sys.solution->zero_clone().release());
+    
+    // the loads are evaluated at the time of the system
+    const Real
+    t0 = sys.time;
+    sys.time = t;
+    
+    _assembly->assemble_first_order_quantities(*zero, &res, nullptr, nullptr);
+    
+    sys.time = t0;
+}
+
+
+
+void
+MAST::ReducedOrderThermalTransientSolver::_reduced_force(Real t, RealVectorX& f) {
+    
+    if (!_time_dependent_load && _force_initialized)
+        return;
+    
+    MAST_LOG_SCOPE("reduced_force()", "ReducedOrderThermalTransientSolver");
+    
+    std::auto_ptr<libMesh::NumericVector<Real> >
+    res(_assembly->system().solution->zero_clone().release());
+    
+    _load_residual(t, *res);
+    
+    _basis_mat->project(*res, f);
+    f *= -1.;
+    
+    _force_initialized = true;
+}
+
+
+
+void
+MAST::ReducedOrderThermalTransientSolver::_clear_basis() {
+    
+    for (unsigned int i=0; i<_basis.size(); i++)
+        delete _basis[i];
+    
+    _basis.clear();
+    _basis_mat.reset();
+}
+
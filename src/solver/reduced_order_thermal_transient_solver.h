@@ -0,0 +1,284 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2017  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef __mast__reduced_order_thermal_transient_solver__
+#define __mast__reduced_order_thermal_transient_solver__
+
+// C++ includes
+#include <vector>
+#include <memory>
+
+// MAST includes
+#include "base/mast_data_types.h"
+#include "numerics/basis_matrix.h"
+
+
+// libMesh includes
+#include "libmesh/numeric_vector.h"
+#include "libmesh/sparse_matrix.h"
+
+
+namespace MAST {
+    
+    // Forward declerations
+    class TransientAssembly;
+    
+    
+    /*!
+     *    Reduced-order model of linear transient heat conduction,
+     *    \f[ [C] \dot{T} + [K] T + \{R(0, t)\} = 0, \f]
+     *    with the capacitance \f$ C \f$ and conductance \f$ K \f$
+     *    assembled once in init() by
+     *    MAST::TransientAssembly::assemble_first_order_quantities() from a
+     *    MAST::HeatConductionTransientAssembly. The basis \f$ \Phi \f$ is
+     *    computed either by a proper orthogonal decomposition of the
+     *    temperature snapshots added with add_snapshot(), or by matching
+     *    the moments of the transfer function at zero frequency with
+     *    the Krylov vectors \f$ K^{-1} R, (K^{-1} C) K^{-1} R, \ldots \f$,
+     *    and is orthonormal. The projected system
+     *    \f[ [C_r] \dot{q} + [K_r] q = \{f_r(t)\} \f]
+     *    with \f$ f_r = -\Phi^T R(0, t) \f$ is integrated with the first
+     *    order Newmark scheme, with the effective operator factorized
+     *    once for the time step. If the loads do not change with time, the
+     *    reduced force is computed once. The full field temperature is
+     *    reconstructed only on request, for example at the times at which
+     *    a structural analysis requires the thermal load, by
+     *    advance_to_time() followed by reconstruct_solution().
+     *
+     *    The model assumes temperature-independent properties and loads, and
+     *    homogeneous Dirichlet conditions on the constrained dofs.
+     */
+    class ReducedOrderThermalTransientSolver {
+        
+    public:
+        
+        ReducedOrderThermalTransientSolver();
+        
+        virtual ~ReducedOrderThermalTransientSolver();
+        
+        /*!
+         *    time step
+         */
+        Real dt;
+        
+        /*!
+         *    \f$ \beta \f$ parameter of the first order Newmark scheme,
+         *    which is 1 (backward Euler) by default.
+         */
+        Real beta;
+        
+        /*!
+         *    fraction of the snapshot energy that may be discarded by the
+         *    POD basis. This is 1.e-8 by default.
+         */
+        Real energy_tol;
+        
+        /*!
+         *    maximum number of POD modes, or zero for no limit, which is
+         *    the default
+         */
+        unsigned int max_basis_size;
+        
+        
+        /*!
+         *    assembles the capacitance and conductance matrices of the
+         *    system of \p assembly at zero temperature and the current
+         *    time of the system. The assembly must be attached to its
+         *    discipline and system, and must exist as long as this object
+         *    is used. If \p time_dependent_load is false, the reduced force is
+         *    computed once and reused for all time steps.
+         */
+        void init(MAST::TransientAssembly& assembly,
+                  bool time_dependent_load = true);
+        
+        
+        /*!
+         *    adds a copy of the temperature \p sol to the snapshots. The
+         *    basis is not changed until build_pod_basis() is called.
+         */
+        void add_snapshot(const libMesh::NumericVector<Real>& sol);
+        
+        
+        /*!
+         *    @returns the number of snapshots
+         */
+        unsigned int n_snapshots() const {
+            return (unsigned int)_snapshots.size();
+        }
+        
+        
+        /*!
+         *    computes the POD basis of the snapshots with the modes required
+         *    to retain a fraction \p 1-energy_tol of the snapshot energy, up
+         *    to \p max_basis_size modes, and the reduced matrices.
+         */
+        void build_pod_basis();
+        
+        
+        /*!
+         *    computes a basis that matches the first \p n_moments moments
+         *    of the response to the load at the current time about zero
+         *    frequency, and the reduced matrices. The vectors that are
+         *    linearly dependent on the previous ones are discarded.
+         */
+        void build_krylov_basis(unsigned int n_moments);
+        
+        
+        /*!
+         *    @returns the number of basis vectors
+         */
+        unsigned int n_basis() const {
+            return (unsigned int)_basis.size();
+        }
+        
+        
+        /*!
+         *    sets the reduced solution to the projection of the temperature
+         *    \p sol on the basis. The initial rate is obtained from the
+         *    reduced equations at the current time.
+         */
+        void set_initial_condition(const libMesh::NumericVector<Real>& sol);
+        
+        
+        /*!
+         *    advances the reduced solution by one time step
+         */
+        void solve_and_advance_time_step();
+        
+        
+        /*!
+         *    advances the reduced solution in steps of \p dt to time \p t,
+         *    with the last step shortened to end at \p t
+         */
+        void advance_to_time(Real t);
+        
+        
+        /*!
+         *    computes the full field temperature \f$ T = [\Phi] q \f$
+         */
+        void reconstruct_solution(libMesh::NumericVector<Real>& sol) const;
+        
+        
+        /*!
+         *    @returns the current time
+         */
+        Real time() const {
+            return _time;
+        }
+        
+        /*!
+         *    @returns the reduced solution
+         */
+        const RealVectorX& solution() const {
+            return _q;
+        }
+        
+        /*!
+         *    @returns the reduced capacitance and conductance matrices
+         */
+        const RealMatrixX& capacitance() const { return _C_r; }
+        
+        const RealMatrixX& conductance() const { return _K_r; }
+        
+    protected:
+        
+        /*!
+         *    orthonormalizes the basis vectors, computes the reduced
+         *    matrices, and resets the reduced state
+         */
+        void _init_reduced_system();
+        
+        /*!
+         *    computes the full order residual \f$ R(0, t) \f$ in \p res
+         */
+        void _load_residual(Real t, libMesh::NumericVector<Real>& res);
+        
+        /*!
+         *    computes the reduced force at time \p t in \p f
+         */
+        void _reduced_force(Real t, RealVectorX& f);
+        
+        /*!
+         *    deletes the basis vectors
+         */
+        void _clear_basis();
+        
+        /*!
+         *    assembly of the thermal system
+         */
+        MAST::TransientAssembly*                    _assembly;
+        
+        /*!
+         *    flag for time-dependent loads
+         */
+        bool                                        _time_dependent_load;
+        
+        /*!
+         *    flag to indicate if the reduced force is available in
+         *    \p _f, for time-invariant loads
+         */
+        bool                                        _force_initialized;
+        
+        /*!
+         *    full order capacitance and conductance matrices
+         */
+        std::auto_ptr<libMesh::SparseMatrix<Real> > _C, _K;
+        
+        /*!
+         *    temperature snapshots
+         */
+        std::vector<libMesh::NumericVector<Real>*>  _snapshots;
+        
+        /*!
+         *    basis vectors, which are owned by this object, and their
+         *    dense storage used for the projections
+         */
+        std::vector<libMesh::NumericVector<Real>*>  _basis;
+        
+        std::auto_ptr<MAST::BasisMatrix<Real> >     _basis_mat;
+        
+        /*!
+         *    current time
+         */
+        Real                                        _time;
+        
+        /*!
+         *    reduced matrices
+         */
+        RealMatrixX                                 _C_r, _K_r;
+        
+        /*!
+         *    reduced force, and reduced solution and its rate
+         */
+        RealVectorX                                 _f, _q, _q_dot;
+        
+        /*!
+         *    time step and Newmark parameter of the factorized operator
+         */
+        Real                                        _op_dt, _op_beta;
+        
+        /*!
+         *    factorization of the effective Newmark operator
+         */
+        Eigen::PartialPivLU<RealMatrixX>            _op;
+    };
+}
+
+
+#endif // __mast__reduced_order_thermal_transient_solver__
@@ -0,0 +1,240 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2017  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+// C++ includes
+#include <map>
+
+
+// MAST includes
+#include "solver/reduced_order_transient_solver.h"
+#include "elasticity/structural_fluid_interaction_assembly.h"
+#include "base/nonlinear_implicit_assembly.h"
+#include "base/nonlinear_system.h"
+#include "base/performance_log.h"
+#include "base/solver_telemetry.h"
+
+
+MAST::ReducedOrderTransientSolver::ReducedOrderTransientSolver():
+dt(0.),
+beta(0.25),
+gamma(0.5),
+_assembly(nullptr),
+_load_assembly(nullptr),
+_time_dependent_load(true),
+_force_initialized(false),
+_time(0.),
+_op_dt(0.),
+_op_beta(0.),
+_op_gamma(0.) {
+
+}
+
+
+
+MAST::ReducedOrderTransientSolver::~ReducedOrderTransientSolver() {
+
+}
+
+
+
+void
+MAST::ReducedOrderTransientSolver::
+init(MAST::StructuralFluidInteractionAssembly& assembly,
+     std::vector<libMesh::NumericVector<Real>*>& basis) {
+
+    MAST_LOG_SCOPE("init()", "ReducedOrderTransientSolver");
+
+    libmesh_assert(basis.size());
+
+    _assembly = &assembly;
+    _basis    = basis;
+
+    std::map<MAST::StructuralQuantityType, RealMatrixX*> qty_map;
+    qty_map[MAST::MASS]      = &_M;
+    qty_map[MAST::DAMPING]   = &_C;
+    qty_map[MAST::STIFFNESS] = &_K;
+
+    assembly.assemble_reduced_order_quantity(_basis, qty_map);
+    
+    _basis_mat.reset(new MAST::BasisMatrix<Real>(assembly.system().comm()));
+    _basis_mat->modes = _basis;
+    _basis_mat->init_dense_storage();
+
+    const unsigned int
+    n = (unsigned int)_basis.size();
+
+    _q      = RealVectorX::Zero(n);
+    _q_dot  = RealVectorX::Zero(n);
+    _q_ddot = RealVectorX::Zero(n);
+    _f      = RealVectorX::Zero(n);
+
+    _time              = assembly.system().time;
+    _force_initialized = false;
+    _op_dt             = 0.;
+}
+
+
+
+void
+MAST::ReducedOrderTransientSolver::
+set_load_assembly(MAST::NonlinearImplicitAssembly& assembly,
+                  bool time_dependent) {
+
+    _load_assembly       = &assembly;
+    _time_dependent_load = time_dependent;
+    _force_initialized   = false;
+}
+
+
+
+void
+MAST::ReducedOrderTransientSolver::
+set_initial_condition(const RealVectorX& q,
+                      const RealVectorX& q_dot) {
+
+    libmesh_assert(_assembly);
+    libmesh_assert_equal_to(q.size(),     _basis.size());
+    libmesh_assert_equal_to(q_dot.size(), _basis.size());
+
+    _q     = q;
+    _q_dot = q_dot;
+
+    // M q_ddot = f - C q_dot - K q
+    _reduced_force(_time, _f);
+    _q_ddot = _M.partialPivLu().solve(_f - _C * _q_dot - _K * _q);
+}
+
+
+
+void
+MAST::ReducedOrderTransientSolver::solve_and_advance_time_step() {
+
+    MAST_LOG_SCOPE("solve_and_advance_time_step()", "ReducedOrderTransientSolver");
+
+    libmesh_assert(_assembly);
+    libmesh_assert_greater(dt, 0.);
+
+    std::chrono::steady_clock::time_point
+    t0 = std::chrono::steady_clock::now();
+
+    // the effective operator is factorized once for the time step and
+    // Newmark parameters
+    if (_op_dt != dt || _op_beta != beta || _op_gamma != gamma) {
+
+        _op.compute(_K +
+                    (gamma/beta/dt) * _C +
+                    (1./beta/dt/dt) * _M);
+        _op_dt    = dt;
+        _op_beta  = beta;
+        _op_gamma = gamma;
+    }
+
+    const Real
+    t = _time + dt;
+
+    _reduced_force(t, _f);
+
+    // the solution is written as
+    //   q      = q0 + dt q0_dot + (1/2-beta) dt^2 q0_ddot + beta dt^2 q_ddot
+    //   q_dot  = q0_dot + (1-gamma) dt q0_ddot + gamma dt q_ddot
+    // which is substituted in the equations of motion
+    RealVectorX
+    rhs = _f +
+    _M * ((1./beta/dt/dt) * _q +
+          (1./beta/dt) * _q_dot +
+          (.5/beta - 1.) * _q_ddot) +
+    _C * ((gamma/beta/dt) * _q +
+          (gamma/beta - 1.) * _q_dot +
+          dt * (.5*gamma/beta - 1.) * _q_ddot),
+    q = _op.solve(rhs),
+    q_ddot =
+    (1./beta/dt/dt) * (q - _q) -
+    (1./beta/dt) * _q_dot -
+    (.5/beta - 1.) * _q_ddot;
+
+    _q_dot += dt * ((1.-gamma) * _q_ddot + gamma * q_ddot);
+    _q      = q;
+    _q_ddot = q_ddot;
+    _time   = t;
+
+    if (MAST::solver_telemetry.active()) {
+
+        MAST::SolverTelemetry::Event
+        e(MAST::SolverTelemetry::TIME_STEP, "ReducedOrderTransientSolver");
+
+        e.time      = _time;
+        e.dt        = dt;
+        e.converged = true;
+        e.wall_time = MAST::SolverTelemetry::elapsed(t0);
+
+        MAST::solver_telemetry.emit(e);
+    }
+}
+
+
+
+void
+MAST::ReducedOrderTransientSolver::
+reconstruct_solution(libMesh::NumericVector<Real>& X) const {
+
+    libmesh_assert_equal_to(_q.size(), _basis.size());
+
+    _basis_mat->reconstruct(_q, X);
+}
+
+
+
+void
+MAST::ReducedOrderTransientSolver::_reduced_force(Real t, RealVectorX& f) {
+
+    const unsigned int
+    n = (unsigned int)_basis.size();
+
+    if (!_load_assembly) {
+
+        f = RealVectorX::Zero(n);
+        return;
+    }
+
+    if (!_time_dependent_load && _force_initialized)
+        return;
+
+    MAST_LOG_SCOPE("reduced_force()", "ReducedOrderTransientSolver");
+
+    MAST::NonlinearSystem& sys = _load_assembly->system();
+
+    std::auto_ptr<libMesh::NumericVector<Real> >
+    zero(sys.solution->zero_clone().release()),
+    res (sys.solution->zero_clone().release());
+
+    // the loads are evaluated at the time of the system
+    const Real
+    t0 = sys.time;
+    sys.time = t;
+
+    _load_assembly->residual_and_jacobian(*zero, res.get(), nullptr, sys);
+
+    sys.time = t0;
+
+    _basis_mat->project(*res, f);
+    f *= -1.;
+
+    _force_initialized = true;
+}
+
@@ -0,0 +1,231 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2017  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef __mast__reduced_order_transient_solver__
+#define __mast__reduced_order_transient_solver__
+
+// C++ includes
+#include <vector>
+
+// MAST includes
+#include "base/mast_data_types.h"
+#include "numerics/basis_matrix.h"
+
+
+// libMesh includes
+#include "libmesh/numeric_vector.h"
+
+
+namespace MAST {
+
+    // Forward declerations
+    class StructuralFluidInteractionAssembly;
+    class NonlinearImplicitAssembly;
+
+
+    /*!
+     *    Newmark time integration of a linear structural model projected
+     *    on a set of basis vectors, for example the structural modes used
+     *    for flutter analysis. The reduced mass, damping and stiffness
+     *    matrices, which include the piston theory aerodynamic terms if
+     *    the discipline has these loads, are obtained from
+     *    StructuralFluidInteractionAssembly::assemble_reduced_order_quantity()
+     *    once in init(). The time integration then operates only on the
+     *    dense reduced system
+     *    \f[ [M_r] \ddot{q} + [C_r] \dot{q} + [K_r] q = \{f_r(t)\}, \f]
+     *    with the effective Newmark operator factorized once. The reduced
+     *    force is \f$ -[\Phi]^T \{R(0, t)\} \f$, where \f$ R \f$ is the
+     *    residual of the load assembly at zero solution. If the loads do
+     *    not change with time, it is computed once. The full field
+     *    solution is reconstructed only on request with
+     *    reconstruct_solution(). The basis is copied to a dense matrix,
+     *    so that the force projection and the reconstruction are each
+     *    a single dense product of the local rows.
+     */
+    class ReducedOrderTransientSolver {
+
+    public:
+
+        ReducedOrderTransientSolver();
+
+        virtual ~ReducedOrderTransientSolver();
+
+        /*!
+         *    time step
+         */
+        Real dt;
+
+        /*!
+         *    \f$ \beta \f$ parameter of the Newmark scheme
+         */
+        Real beta;
+
+        /*!
+         *    \f$ \gamma \f$ parameter of the Newmark scheme
+         */
+        Real gamma;
+
+
+        /*!
+         *    assembles the reduced mass, damping and stiffness matrices
+         *    on \p basis with \p assembly. The basis vectors and the
+         *    assembly must exist as long as this object is used. The
+         *    reduced state is set to zero, and the time to the time of
+         *    the system.
+         */
+        void init(MAST::StructuralFluidInteractionAssembly& assembly,
+                  std::vector<libMesh::NumericVector<Real>*>& basis);
+
+
+        /*!
+         *    sets the assembly used to compute the reduced force. The
+         *    residual is evaluated at zero solution, and its negative
+         *    is projected on the basis. If \p time_dependent is false, the
+         *    force is computed once and reused for all time steps. Without
+         *    a load assembly the reduced force is zero.
+         */
+        void set_load_assembly(MAST::NonlinearImplicitAssembly& assembly,
+                               bool time_dependent = true);
+
+
+        /*!
+         *    sets the reduced initial displacement and velocity. The
+         *    initial acceleration is obtained from the equations of motion
+         *    at the current time.
+         */
+        void set_initial_condition(const RealVectorX& q,
+                                   const RealVectorX& q_dot);
+
+
+        /*!
+         *    advances the reduced solution by one time step
+         */
+        void solve_and_advance_time_step();
+
+
+        /*!
+         *    computes the full field solution \f$ X = [\Phi] q \f$
+         */
+        void reconstruct_solution(libMesh::NumericVector<Real>& X) const;
+
+
+        /*!
+         *    @returns the current time
+         */
+        Real time() const {
+            return _time;
+        }
+
+        /*!
+         *    @returns the reduced solution
+         */
+        const RealVectorX& solution() const {
+            return _q;
+        }
+
+        /*!
+         *    @returns the reduced velocity
+         */
+        const RealVectorX& velocity() const {
+            return _q_dot;
+        }
+
+        /*!
+         *    @returns the reduced acceleration
+         */
+        const RealVectorX& acceleration() const {
+            return _q_ddot;
+        }
+
+        /*!
+         *    @returns the reduced mass, damping and stiffness matrices
+         */
+        const RealMatrixX& mass() const { return _M; }
+
+        const RealMatrixX& damping() const { return _C; }
+
+        const RealMatrixX& stiffness() const { return _K; }
+
+    protected:
+
+        /*!
+         *    computes the reduced force at time \p t in \p f
+         */
+        void _reduced_force(Real t, RealVectorX& f);
+
+        /*!
+         *    assembly used for the reduced matrices
+         */
+        MAST::StructuralFluidInteractionAssembly* _assembly;
+
+        /*!
+         *    assembly used for the reduced force
+         */
+        MAST::NonlinearImplicitAssembly*          _load_assembly;
+
+        /*!
+         *    basis on which the model is projected
+         */
+        std::vector<libMesh::NumericVector<Real>*> _basis;
+        
+        /*!
+         *    dense storage of the basis used for the projections
+         */
+        std::auto_ptr<MAST::BasisMatrix<Real> >    _basis_mat;
+
+        /*!
+         *    flag for time-dependent loads
+         */
+        bool                                       _time_dependent_load;
+
+        /*!
+         *    flag to indicate if the reduced force is available in
+         *    \p _f, for time-invariant loads
+         */
+        bool                                       _force_initialized;
+
+        /*!
+         *    current time
+         */
+        Real                                       _time;
+
+        /*!
+         *    reduced matrices
+         */
+        RealMatrixX                                _M, _C, _K;
+
+        /*!
+         *    reduced force, and reduced solution and its time derivatives
+         */
+        RealVectorX                                _f, _q, _q_dot, _q_ddot;
+
+        /*!
+         *    time step and Newmark parameters of the factorized operator
+         */
+        Real                                       _op_dt, _op_beta, _op_gamma;
+
+        /*!
+         *    factorization of the effective Newmark operator
+         */
+        Eigen::PartialPivLU<RealMatrixX>           _op;
+    };
+}
+
+
+#endif // __mast__reduced_order_transient_solver__
@@ -17,13 +17,15 @@
  * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
  */
 
+// C++ includes
+#include <cmath>
+
 // MAST includes
 #include "solver/second_order_newmark_transient_solver.h"
 #include "base/transient_assembly.h"
 #include "base/elem_base.h"
 #include "base/nonlinear_system.h"
 
-
 // libMesh includes
 #include "libmesh/numeric_vector.h"
 
@@ -46,8 +48,13 @@ MAST::SecondOrderNewmarkTransientSolver::solve() {
     // make sure that the system has been specified
     libmesh_assert_msg(_system, "System pointer is nullptr.");
     
-    // ask the Newton solver to solve for the system solution
-    _system->solve();
+    // the linear problem needs only one solve with the retained
+    // operator. Otherwise, ask the Newton solver to solve for the
+    // system solution. The adaptive step may repeat the solve.
+    if (_adaptive_time_step)
+        this->_solve_adaptive_step();
+    else
+        this->_solve_step();
     
 }
 
@@ -343,6 +350,97 @@ _elem_sensitivity_calculations(MAST::ElementBase& elem,
                                const std::vector<libMesh::dof_id_type>& dof_indices,
                                RealVectorX& vec) {
 
-    // to be implemented
-    libmesh_error();
+    // make sure that the assembly object is provided
+    libmesh_assert(_assembly);
+
+    // the time derivatives do not depend on the parameters, so the
+    // sensitivity of the residual is that of the element quantities
+    _assembly->_elem_sensitivity_calculations(elem, vec);
+}
+
+
+
+void
+MAST::SecondOrderNewmarkTransientSolver::
+_elem_derivative_jacobians(MAST::ElementBase& elem,
+                           const std::vector<libMesh::dof_id_type>& dof_indices,
+                           std::vector<RealMatrixX>& jacs) {
+
+    // make sure that the assembly object is provided
+    libmesh_assert(_assembly);
+    unsigned int n_dofs = (unsigned int)dof_indices.size();
+
+    RealVectorX
+    f_x     = RealVectorX::Zero(n_dofs),
+    f_m     = RealVectorX::Zero(n_dofs);
+
+    RealMatrixX
+    f_m_jac_xddot    = RealMatrixX::Zero(n_dofs, n_dofs),
+    f_m_jac_xdot     = RealMatrixX::Zero(n_dofs, n_dofs),
+    f_m_jac          = RealMatrixX::Zero(n_dofs, n_dofs),
+    f_x_jac_xdot     = RealMatrixX::Zero(n_dofs, n_dofs),
+    f_x_jac          = RealMatrixX::Zero(n_dofs, n_dofs);
+
+    // perform the element assembly
+    _assembly->_elem_calculations(elem,
+                                  true,
+                                  f_m,           // mass vector
+                                  f_x,           // forcing vector
+                                  f_m_jac_xddot, // Jac of mass wrt x_dotdot
+                                  f_m_jac_xdot,  // Jac of mass wrt x_dot
+                                  f_m_jac,       // Jac of mass wrt x
+                                  f_x_jac_xdot,  // Jac of forcing vector wrt x_dot
+                                  f_x_jac);      // Jac of forcing vector wrt x
+
+    jacs.resize(2);
+    jacs[0] = f_m_jac_xdot + f_x_jac_xdot;
+    jacs[1] = f_m_jac_xddot;
+}
+
+
+
+void
+MAST::SecondOrderNewmarkTransientSolver::
+_adjoint_coefficients(Real dt,
+                      RealVectorX& c,
+                      RealMatrixX& G) const {
+
+    // x_dot  = gamma/beta/dt (x-x0) + (1 - gamma/beta) x0_dot +
+    //          (1 - gamma/2/beta) dt x0_ddot
+    // x_ddot = (x-x0)/beta/dt^2 - 1/beta/dt x0_dot - (1/2-beta)/beta x0_ddot
+    c = RealVectorX::Zero(2);
+    G = RealMatrixX::Zero(2, 2);
+
+    c(0)    = gamma/beta/dt;
+    c(1)    = 1./beta/dt/dt;
+
+    G(0, 0) = 1.-gamma/beta;
+    G(0, 1) = (1.-gamma/2./beta)*dt;
+    G(1, 0) = -1./beta/dt;
+    G(1, 1) = -(.5-beta)/beta;
+}
+
+
+
+void
+MAST::SecondOrderNewmarkTransientSolver::
+_predict_solution(libMesh::NumericVector<Real>& x) {
+    
+    // x = x0 + dt x0_dot + dt^2/2 x0_ddot
+    x.zero();
+    x.add(      1., this->solution(1));
+    x.add(      dt, this->velocity(1));
+    x.add(.5*dt*dt, this->acceleration(1));
+    x.close();
+}
+
+
+
+Real
+MAST::SecondOrderNewmarkTransientSolver::_error_constant() const {
+    
+    // the difference between the solution and the predictor is
+    // beta dt^2 (x_ddot - x0_ddot), and the local truncation error
+    // is (beta - 1/6) dt^2 (x_ddot - x0_ddot)
+    return std::fabs(beta - 1./6.)/beta;
 }
@@ -107,6 +107,26 @@ namespace MAST {
             return 2;
         }
         
+        /*!
+         *    computes the explicit predictor of the solution at the end
+         *    of the current time step
+         */
+        virtual void _predict_solution(libMesh::NumericVector<Real>& x);
+        
+        /*!
+         *    @returns the constant that scales the difference between the
+         *    solution and the predictor to the local truncation error
+         */
+        virtual Real _error_constant() const;
+        
+        /*!
+         *    @returns the order of the error estimate, which changes as
+         *    \f$ dt^{3} \f$
+         */
+        virtual unsigned int _error_order() const {
+            return 2;
+        }
+        
         /*!
          *    provides the element with the transient data for calculations
          */
@@ -158,6 +178,25 @@ namespace MAST {
         _elem_sensitivity_calculations(MAST::ElementBase& elem,
                                        const std::vector<libMesh::dof_id_type>& dof_indices,
                                        RealVectorX& vec);
+        
+        /*!
+         *   performs the element calculations over \par elem, and returns
+         *   in \par jacs[k-1] the Jacobian of the element residual with
+         *   respect to the k^th time derivative of the solution.
+         */
+        virtual void
+        _elem_derivative_jacobians(MAST::ElementBase& elem,
+                                   const std::vector<libMesh::dof_id_type>& dof_indices,
+                                   std::vector<RealMatrixX>& jacs);
+        
+        /*!
+         *   returns the coefficients of the update of the velocity and acceleration over a
+         *   step of size \p dt for the adjoint of the time integration
+         */
+        virtual void
+        _adjoint_coefficients(Real dt,
+                              RealVectorX& c,
+                              RealMatrixX& G) const;
     };
     
 }
@@ -0,0 +1,275 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2017  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+// C++ includes
+#include <algorithm>
+
+
+// MAST includes
+#include "solver/single_precision_ilu.h"
+#include "base/performance_log.h"
+
+
+MAST::SinglePrecisionILU::
+SinglePrecisionILU(const libMesh::Parallel::Communicator& comm_in):
+libMesh::ParallelObject (comm_in),
+_n                      (0) {
+    
+}
+
+
+
+MAST::SinglePrecisionILU::~SinglePrecisionILU() {
+    
+}
+
+
+
+void
+MAST::SinglePrecisionILU::configure_preconditioner(PC pc) {
+    
+    PetscErrorCode ierr = 0;
+    
+    ierr = PCSetType(pc, PCSHELL);               CHKERRABORT(this->comm().get(), ierr);
+    ierr = PCShellSetContext(pc, this);          CHKERRABORT(this->comm().get(), ierr);
+    ierr = PCShellSetName(pc, "MAST single precision ILU(0)");
+    CHKERRABORT(this->comm().get(), ierr);
+    ierr = PCShellSetSetUp(pc, MAST::SinglePrecisionILU::_setup);
+    CHKERRABORT(this->comm().get(), ierr);
+    ierr = PCShellSetApply(pc, MAST::SinglePrecisionILU::_apply);
+    CHKERRABORT(this->comm().get(), ierr);
+    ierr = PCShellSetApplyTranspose(pc, MAST::SinglePrecisionILU::_apply_transpose);
+    CHKERRABORT(this->comm().get(), ierr);
+}
+
+
+
+void
+MAST::SinglePrecisionILU::factorize(Mat P) {
+    
+    MAST_LOG_SCOPE("factorize()", "SinglePrecisionILU");
+    
+    PetscErrorCode ierr = 0;
+    Mat            A;
+    PetscBool      if_sym = PETSC_FALSE;
+    
+    ierr = PetscObjectTypeCompareAny((PetscObject)P, &if_sym,
+                                     MATSEQSBAIJ, MATMPISBAIJ, MATSBAIJ, "");
+    CHKERRABORT(this->comm().get(), ierr);
+    
+    if (if_sym)
+        libmesh_error_msg("SinglePrecisionILU requires the full matrix storage");
+    
+    // the block of the local rows and columns, with local column indices
+    ierr = MatGetDiagonalBlock(P, &A);           CHKERRABORT(this->comm().get(), ierr);
+    ierr = MatGetLocalSize(A, &_n, PETSC_NULL);  CHKERRABORT(this->comm().get(), ierr);
+    
+    _row_begin.assign(_n+1, 0);
+    _diag.assign(_n, -1);
+    _cols.clear();
+    _vals.clear();
+    
+    for (PetscInt i=0; i<_n; i++) {
+        
+        PetscInt           nc   = 0;
+        const PetscInt*    cols = PETSC_NULL;
+        const PetscScalar* vals = PETSC_NULL;
+        
+        ierr = MatGetRow(A, i, &nc, &cols, &vals);
+        CHKERRABORT(this->comm().get(), ierr);
+        
+        for (PetscInt j=0; j<nc; j++) {
+            
+            if (cols[j] == i)
+                _diag[i] = (PetscInt)_cols.size();
+            _cols.push_back(cols[j]);
+            _vals.push_back((float)vals[j]);
+        }
+        
+        ierr = MatRestoreRow(A, i, &nc, &cols, &vals);
+        CHKERRABORT(this->comm().get(), ierr);
+        
+        _row_begin[i+1] = (PetscInt)_cols.size();
+        
+        if (_diag[i] < 0)
+            libmesh_error_msg("SinglePrecisionILU: no diagonal entry in local row " << i);
+    }
+    
+    // ILU(0) by the IKJ variant, with the position of the columns of the
+    // current row in pos
+    std::vector<PetscInt> pos(_n, -1);
+    
+    for (PetscInt i=0; i<_n; i++) {
+        
+        for (PetscInt p=_row_begin[i]; p<_row_begin[i+1]; p++)
+            pos[_cols[p]] = p;
+        
+        for (PetscInt p=_row_begin[i]; p<_diag[i]; p++) {
+            
+            const PetscInt
+            k     = _cols[p];
+            
+            const double
+            l_ik  = (double)_vals[p] / (double)_vals[_diag[k]];
+            
+            _vals[p] = (float)l_ik;
+            
+            for (PetscInt q=_diag[k]+1; q<_row_begin[k+1]; q++)
+                if (pos[_cols[q]] >= 0)
+                    _vals[pos[_cols[q]]] =
+                    (float)((double)_vals[pos[_cols[q]]] - l_ik * (double)_vals[q]);
+        }
+        
+        if (_vals[_diag[i]] == 0.f)
+            libmesh_error_msg("SinglePrecisionILU: zero pivot in local row " << i);
+        
+        for (PetscInt p=_row_begin[i]; p<_row_begin[i+1]; p++)
+            pos[_cols[p]] = -1;
+    }
+}
+
+
+
+void
+MAST::SinglePrecisionILU::apply(Vec x, Vec y, bool transpose) const {
+    
+    MAST_LOG_SCOPE("apply()", "SinglePrecisionILU");
+    
+    PetscErrorCode     ierr = 0;
+    const PetscScalar* xv   = PETSC_NULL;
+    PetscScalar*       yv   = PETSC_NULL;
+    
+    ierr = VecGetArrayRead(x, &xv);              CHKERRABORT(this->comm().get(), ierr);
+    ierr = VecGetArray(y, &yv);                  CHKERRABORT(this->comm().get(), ierr);
+    
+    std::copy(xv, xv+_n, yv);
+    
+    if (!transpose) {
+        
+        // L z = x, with unit diagonal
+        for (PetscInt i=0; i<_n; i++) {
+            
+            double s = yv[i];
+            for (PetscInt p=_row_begin[i]; p<_diag[i]; p++)
+                s -= (double)_vals[p] * yv[_cols[p]];
+            yv[i] = s;
+        }
+        
+        // U y = z
+        for (PetscInt i=_n-1; i>=0; i--) {
+            
+            double s = yv[i];
+            for (PetscInt p=_diag[i]+1; p<_row_begin[i+1]; p++)
+                s -= (double)_vals[p] * yv[_cols[p]];
+            yv[i] = s / (double)_vals[_diag[i]];
+        }
+    }
+    else {
+        
+        // U^T z = x, by columns of U^T
+        for (PetscInt i=0; i<_n; i++) {
+            
+            const double z = yv[i] / (double)_vals[_diag[i]];
+            yv[i] = z;
+            for (PetscInt p=_diag[i]+1; p<_row_begin[i+1]; p++)
+                yv[_cols[p]] -= (double)_vals[p] * z;
+        }
+        
+        // L^T y = z, by columns of L^T
+        for (PetscInt i=_n-1; i>=0; i--) {
+            
+            const double z = yv[i];
+            for (PetscInt p=_row_begin[i]; p<_diag[i]; p++)
+                yv[_cols[p]] -= (double)_vals[p] * z;
+        }
+    }
+    
+    ierr = VecRestoreArray(y, &yv);              CHKERRABORT(this->comm().get(), ierr);
+    ierr = VecRestoreArrayRead(x, &xv);          CHKERRABORT(this->comm().get(), ierr);
+}
+
+
+
+void
+MAST::SinglePrecisionILU::clear() {
+    
+    _n = 0;
+    _row_begin.clear();
+    _cols.clear();
+    _diag.clear();
+    _vals.clear();
+}
+
+
+
+std::size_t
+MAST::SinglePrecisionILU::memory_bytes() const {
+    
+    return
+    (_row_begin.capacity() + _cols.capacity() + _diag.capacity()) * sizeof(PetscInt) +
+    _vals.capacity() * sizeof(float);
+}
+
+
+
+PetscErrorCode
+MAST::SinglePrecisionILU::_setup(PC pc) {
+    
+    PetscErrorCode ierr = 0;
+    void*          ctx  = PETSC_NULL;
+    Mat            A, P;
+    
+    ierr = PCShellGetContext(pc, &ctx);          CHKERRQ(ierr);
+    ierr = PCGetOperators(pc, &A, &P);           CHKERRQ(ierr);
+    
+    static_cast<MAST::SinglePrecisionILU*>(ctx)->factorize(P);
+    
+    return ierr;
+}
+
+
+
+PetscErrorCode
+MAST::SinglePrecisionILU::_apply(PC pc, Vec x, Vec y) {
+    
+    PetscErrorCode ierr = 0;
+    void*          ctx  = PETSC_NULL;
+    
+    ierr = PCShellGetContext(pc, &ctx);          CHKERRQ(ierr);
+    
+    static_cast<MAST::SinglePrecisionILU*>(ctx)->apply(x, y, false);
+    
+    return ierr;
+}
+
+
+
+PetscErrorCode
+MAST::SinglePrecisionILU::_apply_transpose(PC pc, Vec x, Vec y) {
+    
+    PetscErrorCode ierr = 0;
+    void*          ctx  = PETSC_NULL;
+    
+    ierr = PCShellGetContext(pc, &ctx);          CHKERRQ(ierr);
+    
+    static_cast<MAST::SinglePrecisionILU*>(ctx)->apply(x, y, true);
+    
+    return ierr;
+}
+
@@ -0,0 +1,133 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2017  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef __mast__single_precision_ilu__
+#define __mast__single_precision_ilu__
+
+// C++ includes
+#include <vector>
+
+
+// MAST includes
+#include "base/mast_data_types.h"
+
+
+// libMesh includes
+#include "libmesh/parallel_object.h"
+
+
+// PETSc includes
+#include <petscksp.h>
+
+
+namespace MAST {
+    
+    /*!
+     *   Block Jacobi ILU(0) preconditioner whose factors are computed and
+     *   stored in single precision, while the vectors of the Krylov solver
+     *   and the residuals remain in double precision. The block of each
+     *   processor is the diagonal block of the preconditioning matrix of
+     *   the PC, which is copied to a float CSR structure when the PC is
+     *   setup and factorized without fill. This halves the memory and
+     *   bandwidth of the preconditioner compared to the PETSc ILU, and is
+     *   meant for the preconditioning matrices of Newton-Krylov solves of
+     *   fluid and FSI systems, in particular with the matrix-free
+     *   Jacobian of MAST::NonlinearSystem, where the system matrix is only
+     *   used by the preconditioner. The products of the factors are
+     *   accumulated in double precision.
+     *
+     *   The preconditioner is used by the nonlinear, sensitivity and
+     *   adjoint solves of a system once it is attached with
+     *   MAST::NonlinearSystem::set_single_precision_preconditioner(). The
+     *   matrix must not use the symmetric storage.
+     */
+    class SinglePrecisionILU:
+    public libMesh::ParallelObject {
+        
+    public:
+        
+        SinglePrecisionILU(const libMesh::Parallel::Communicator& comm_in);
+        
+        virtual ~SinglePrecisionILU();
+        
+        
+        /*!
+         *   sets \p pc as a shell PC that uses this object. The factors are
+         *   computed from the preconditioning matrix of \p pc each time
+         *   PETSc sets up the PC. A PC for which this is called must not
+         *   be used after this object is deleted.
+         */
+        void configure_preconditioner(PC pc);
+        
+        
+        /*!
+         *   computes the factors of the diagonal block of \p P on this
+         *   processor
+         */
+        void factorize(Mat P);
+        
+        
+        /*!
+         *   computes \f$ y = (LU)^{-1} x \f$, or
+         *   \f$ y = (LU)^{-T} x \f$ if \p transpose is true
+         */
+        void apply(Vec x, Vec y, bool transpose) const;
+        
+        
+        /*!
+         *   deletes the factors
+         */
+        void clear();
+        
+        
+        /*!
+         *   @returns the bytes of the factors on this processor
+         */
+        std::size_t memory_bytes() const;
+        
+    protected:
+        
+        /*!
+         *   callbacks of the shell PC
+         */
+        static PetscErrorCode _setup(PC pc);
+        
+        static PetscErrorCode _apply(PC pc, Vec x, Vec y);
+        
+        static PetscErrorCode _apply_transpose(PC pc, Vec x, Vec y);
+        
+        
+        /*!
+         *   number of local rows
+         */
+        PetscInt                  _n;
+        
+        /*!
+         *   CSR structure of the factors, with \p L stored below the
+         *   diagonal of each row with unit diagonal, and \p U on and above
+         *   the diagonal. The columns of each row are sorted.
+         */
+        std::vector<PetscInt>     _row_begin, _cols, _diag;
+        
+        std::vector<float>        _vals;
+    };
+}
+
+
+#endif // __mast__single_precision_ilu__
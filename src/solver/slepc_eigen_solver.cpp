@@ -17,21 +17,500 @@
  * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
  */
 
+// C++ includes
+#include <algorithm>
+#include <cmath>
+
 // MAST includes
 #include "solver/slepc_eigen_solver.h"
+#include "base/performance_log.h"
+#include "solver/hybrid_parallel_configuration.h"
 
 // libMesh includes
 #include "libmesh/petsc_vector.h"
+#include "libmesh/petsc_matrix.h"
 
 
 MAST::SlepcEigenSolver::SlepcEigenSolver(const libMesh::Parallel::Communicator & comm_in
                                          LIBMESH_CAN_DEFAULT_TO_COMMWORLD):
-libMesh::SlepcEigenSolver<Real>(comm_in) {
+libMesh::SlepcEigenSolver<Real>(comm_in),
+_reuse_eigenvectors(false),
+_reuse_preconditioner(false),
+_pc_mat(PETSC_NULL),
+_spectrum_slicing(false),
+_slice_lower(0.),
+_slice_upper(0.),
+_n_slice_partitions(1),
+_cluster_tol(1.e-8),
+_parallel_config(nullptr) {
+    
+}
+
+
+
+MAST::SlepcEigenSolver::~SlepcEigenSolver() {
+    
+    this->clear_reuse_data();
+    this->_clear_sliced_eigenpairs();
+}
+
+
+
+void
+MAST::SlepcEigenSolver::clear() {
+    
+    this->clear_reuse_data();
+    this->_clear_sliced_eigenpairs();
+    
+    libMesh::SlepcEigenSolver<Real>::clear();
+}
+
+
+
+void
+MAST::SlepcEigenSolver::set_reuse_eigenvectors(bool f) {
+    
+    _reuse_eigenvectors = f;
+    
+    if (!f)
+        this->clear_reuse_data();
+}
+
+
+
+void
+MAST::SlepcEigenSolver::set_reuse_preconditioner(bool f) {
+    
+    _reuse_preconditioner = f;
+    
+    if (!f)
+        this->clear_reuse_data();
+}
+
+
+
+void
+MAST::SlepcEigenSolver::clear_reuse_data() {
+    
+    PetscErrorCode ierr = 0;
+    
+    for (unsigned int i=0; i<_eigenvectors.size(); i++) {
+        ierr = VecDestroy(&_eigenvectors[i]);
+        CHKERRABORT(this->comm().get(), ierr);
+    }
+    _eigenvectors.clear();
+    
+    if (_pc_mat) {
+        ierr = MatDestroy(&_pc_mat);
+        CHKERRABORT(this->comm().get(), ierr);
+    }
+}
+
+
+
+void
+MAST::SlepcEigenSolver::
+set_initial_space(const std::vector<libMesh::NumericVector<Real>*>& vecs) {
+    
+    PetscErrorCode ierr = 0;
+    
+    for (unsigned int i=0; i<_eigenvectors.size(); i++) {
+        ierr = VecDestroy(&_eigenvectors[i]);
+        CHKERRABORT(this->comm().get(), ierr);
+    }
+    
+    _eigenvectors.resize(vecs.size());
     
+    for (unsigned int i=0; i<vecs.size(); i++) {
+        
+        Vec v = libMesh::cast_ptr<libMesh::PetscVector<Real>*>(vecs[i])->vec();
+        
+        ierr = VecDuplicate(v, &_eigenvectors[i]);
+        CHKERRABORT(this->comm().get(), ierr);
+        ierr = VecCopy(v, _eigenvectors[i]);
+        CHKERRABORT(this->comm().get(), ierr);
+    }
+}
+
+
+
+void
+MAST::SlepcEigenSolver::set_spectrum_slicing(Real lower,
+                                              Real upper,
+                                              unsigned int n_partitions,
+                                              Real cluster_tol) {
+    
+    libmesh_assert_less(lower, upper);
+    libmesh_assert_greater(n_partitions, 0);
+    libmesh_assert_equal_to(this->comm().size() % n_partitions, 0);
+    
+    _spectrum_slicing   = true;
+    _slice_lower        = lower;
+    _slice_upper        = upper;
+    _n_slice_partitions = n_partitions;
+    _cluster_tol        = cluster_tol;
+}
+
+
+
+void
+MAST::SlepcEigenSolver::clear_spectrum_slicing() {
+    
+    _spectrum_slicing = false;
+    this->_clear_sliced_eigenpairs();
+}
+
+
+
+std::pair<unsigned int, unsigned int>
+MAST::SlepcEigenSolver::solve_standard (libMesh::SparseMatrix<Real> &matrix_A,
+                                        int nev,
+                                        int ncv,
+                                        const double tol,
+                                        const unsigned int m_its) {
+    
+    Mat A = libMesh::cast_ptr<libMesh::PetscMatrix<Real>*>(&matrix_A)->mat();
+    
+    _init_reuse_data(A, PETSC_NULL, ncv);
+    
+    std::pair<unsigned int, unsigned int>
+    rval = libMesh::SlepcEigenSolver<Real>::solve_standard(matrix_A,
+                                                           nev,
+                                                           ncv,
+                                                           tol,
+                                                           m_its);
+    
+    _store_reuse_data(A);
+    
+    return rval;
 }
 
 
 
+std::pair<unsigned int, unsigned int>
+MAST::SlepcEigenSolver::solve_generalized (libMesh::SparseMatrix<Real> &matrix_A,
+                                           libMesh::SparseMatrix<Real> &matrix_B,
+                                           int nev,
+                                           int ncv,
+                                           const double tol,
+                                           const unsigned int m_its) {
+    
+    Mat
+    A = libMesh::cast_ptr<libMesh::PetscMatrix<Real>*>(&matrix_A)->mat(),
+    B = libMesh::cast_ptr<libMesh::PetscMatrix<Real>*>(&matrix_B)->mat();
+    
+    if (_spectrum_slicing)
+        return _solve_sliced(A, B, nev, tol, m_its);
+    
+    _init_reuse_data(A, B, ncv);
+    
+    std::pair<unsigned int, unsigned int>
+    rval = libMesh::SlepcEigenSolver<Real>::solve_generalized(matrix_A,
+                                                              matrix_B,
+                                                              nev,
+                                                              ncv,
+                                                              tol,
+                                                              m_its);
+    
+    _store_reuse_data(A);
+    
+    return rval;
+}
+
+
+
+void
+MAST::SlepcEigenSolver::_init_reuse_data(Mat A, Mat B, int ncv) {
+    
+    PetscErrorCode ierr = 0;
+    PetscInt       m = 0, n = 0;
+    
+    ierr = MatGetSize(A, &m, PETSC_NULL);
+    CHKERRABORT(this->comm().get(), ierr);
+    
+    // the retained data is not used for a problem of different size,
+    // for example with the condensed matrices
+    if (_eigenvectors.size()) {
+        ierr = VecGetSize(_eigenvectors[0], &n);
+        CHKERRABORT(this->comm().get(), ierr);
+    }
+    else if (_pc_mat) {
+        ierr = MatGetSize(_pc_mat, &n, PETSC_NULL);
+        CHKERRABORT(this->comm().get(), ierr);
+    }
+    
+    if (n && n != m)
+        this->clear_reuse_data();
+    
+    // the initial space is used by only one solve, and is set again
+    // before each solve
+    if (_eigenvectors.size()) {
+        
+        PetscInt
+        n_vecs = std::min((PetscInt)_eigenvectors.size(), (PetscInt)ncv);
+        
+        ierr = EPSSetInitialSpace(eps(), n_vecs, &_eigenvectors[0]);
+        CHKERRABORT(this->comm().get(), ierr);
+        
+        // vectors provided with set_initial_space() are used only once,
+        // and SLEPc retains its own references
+        if (!_reuse_eigenvectors) {
+            for (unsigned int i=0; i<_eigenvectors.size(); i++) {
+                ierr = VecDestroy(&_eigenvectors[i]);
+                CHKERRABORT(this->comm().get(), ierr);
+            }
+            _eigenvectors.clear();
+        }
+    }
+    
+    if (!_reuse_preconditioner)
+        return;
+    
+    // the spectral transformation is chosen from the options, which
+    // are processed again by libMesh before the solve
+    ST          st;
+    EPSType     eps_type;
+    STType      st_type;
+    PetscBool   precond = PETSC_FALSE;
+    
+    ierr = EPSSetFromOptions(eps());           CHKERRABORT(this->comm().get(), ierr);
+    ierr = EPSGetType(eps(), &eps_type);       CHKERRABORT(this->comm().get(), ierr);
+    ierr = EPSGetST(eps(), &st);               CHKERRABORT(this->comm().get(), ierr);
+    ierr = STGetType(st, &st_type);            CHKERRABORT(this->comm().get(), ierr);
+    
+    if (st_type)
+        ierr = PetscStrcmp(st_type, STPRECOND, &precond);
+    else {
+        // the default spectral transformation of the preconditioned
+        // eigensolvers is set here, since it is otherwise set only
+        // during the solve
+        PetscBool lobpcg, jd, gd;
+        ierr = PetscStrcmp(eps_type, EPSLOBPCG, &lobpcg);
+        ierr = PetscStrcmp(eps_type, EPSJD, &jd);
+        ierr = PetscStrcmp(eps_type, EPSGD, &gd);
+        if (lobpcg || jd || gd) {
+            ierr = STSetType(st, STPRECOND);   CHKERRABORT(this->comm().get(), ierr);
+            precond = PETSC_TRUE;
+        }
+    }
+    CHKERRABORT(this->comm().get(), ierr);
+    
+    if (!precond)
+        return;
+    
+    if (!_pc_mat) {
+        
+        MAST_LOG_SCOPE("init_preconditioner()", "SlepcEigenSolver");
+        
+        PetscScalar sigma = 0.;
+        ierr = STGetShift(st, &sigma);         CHKERRABORT(this->comm().get(), ierr);
+        
+        // A - sigma B
+        ierr = MatDuplicate(A, MAT_COPY_VALUES, &_pc_mat);
+        CHKERRABORT(this->comm().get(), ierr);
+        
+        if (sigma != 0.) {
+            
+            if (B)
+                ierr = MatAXPY(_pc_mat, -sigma, B, DIFFERENT_NONZERO_PATTERN);
+            else
+                ierr = MatShift(_pc_mat, -sigma);
+            CHKERRABORT(this->comm().get(), ierr);
+        }
+    }
+    
+    // the copy is not modified after it is created, so the KSP of the
+    // spectral transformation does not rebuild the preconditioner
+    KSP ksp;
+    PC  pc;
+    ierr = STPrecondSetMatForPC(st, _pc_mat);  CHKERRABORT(this->comm().get(), ierr);
+    ierr = STGetKSP(st, &ksp);                 CHKERRABORT(this->comm().get(), ierr);
+    ierr = KSPGetPC(ksp, &pc);                 CHKERRABORT(this->comm().get(), ierr);
+    ierr = PCSetReusePreconditioner(pc, PETSC_TRUE);
+    CHKERRABORT(this->comm().get(), ierr);
+}
+
+
+
+void
+MAST::SlepcEigenSolver::_store_reuse_data(Mat A) {
+    
+    if (!_reuse_eigenvectors)
+        return;
+    
+    PetscErrorCode ierr = 0;
+    PetscInt       n_conv = 0;
+    
+    ierr = EPSGetConverged(eps(), &n_conv);
+    CHKERRABORT(this->comm().get(), ierr);
+    
+    // if nothing converged, the previous vectors are retained
+    if (!n_conv)
+        return;
+    
+    for (unsigned int i=0; i<_eigenvectors.size(); i++) {
+        ierr = VecDestroy(&_eigenvectors[i]);
+        CHKERRABORT(this->comm().get(), ierr);
+    }
+    
+    _eigenvectors.resize(n_conv);
+    
+    // for complex pairs of real problems, only the real part is stored
+    for (PetscInt i=0; i<n_conv; i++) {
+        
+        ierr = MatCreateVecs(A, &_eigenvectors[i], PETSC_NULL);
+        CHKERRABORT(this->comm().get(), ierr);
+        ierr = EPSGetEigenvector(eps(), i, _eigenvectors[i], PETSC_NULL);
+        CHKERRABORT(this->comm().get(), ierr);
+    }
+}
+
+
+
+std::pair<unsigned int, unsigned int>
+MAST::SlepcEigenSolver::_solve_sliced(Mat A,
+                                      Mat B,
+                                      int nev,
+                                      const double tol,
+                                      const unsigned int m_its) {
+    
+    MAST_LOG_SCOPE("solve_sliced()", "SlepcEigenSolver");
+    
+    libmesh_assert(this->eigen_problem_type() == libMesh::GHEP);
+    
+    this->_clear_sliced_eigenpairs();
+    
+    PetscErrorCode ierr = 0;
+    EPS            e    = eps();
+    ST             st;
+    KSP            ksp;
+    PC             pc;
+    PetscInt       its  = 0, n_conv = 0;
+    
+    ierr = EPSSetOperators(e, A, B);               CHKERRABORT(this->comm().get(), ierr);
+    ierr = EPSSetProblemType(e, EPS_GHEP);         CHKERRABORT(this->comm().get(), ierr);
+    ierr = EPSSetType(e, EPSKRYLOVSCHUR);          CHKERRABORT(this->comm().get(), ierr);
+    ierr = EPSSetWhichEigenpairs(e, EPS_ALL);      CHKERRABORT(this->comm().get(), ierr);
+    ierr = EPSSetInterval(e, _slice_lower, _slice_upper);
+    CHKERRABORT(this->comm().get(), ierr);
+    ierr = EPSSetTolerances(e, tol, m_its);        CHKERRABORT(this->comm().get(), ierr);
+    
+    // the inertia of the shifted matrices requires a direct solver
+    ierr = EPSGetST(e, &st);                       CHKERRABORT(this->comm().get(), ierr);
+    ierr = STSetType(st, STSINVERT);               CHKERRABORT(this->comm().get(), ierr);
+    ierr = STGetKSP(st, &ksp);                     CHKERRABORT(this->comm().get(), ierr);
+    ierr = KSPSetType(ksp, KSPPREONLY);            CHKERRABORT(this->comm().get(), ierr);
+    ierr = KSPGetPC(ksp, &pc);                     CHKERRABORT(this->comm().get(), ierr);
+    ierr = PCSetType(pc, PCCHOLESKY);              CHKERRABORT(this->comm().get(), ierr);
+    
+    if (_parallel_config)
+        _parallel_config->configure_direct_solver(pc);
+    else if (this->comm().size() > 1) {
+#if PETSC_VERSION_LESS_THAN(3,9,0)
+        ierr = PCFactorSetMatSolverPackage(pc, MATSOLVERMUMPS);
+#else
+        ierr = PCFactorSetMatSolverType(pc, MATSOLVERMUMPS);
+#endif
+        CHKERRABORT(this->comm().get(), ierr);
+    }
+    
+    ierr = EPSKrylovSchurSetPartitions(e, _n_slice_partitions);
+    CHKERRABORT(this->comm().get(), ierr);
+    ierr = EPSKrylovSchurSetDimensions(e, nev, PETSC_DEFAULT, PETSC_DEFAULT);
+    CHKERRABORT(this->comm().get(), ierr);
+    
+    ierr = EPSSetFromOptions(e);                   CHKERRABORT(this->comm().get(), ierr);
+    ierr = EPSSolve(e);                            CHKERRABORT(this->comm().get(), ierr);
+    ierr = EPSGetIterationNumber(e, &its);         CHKERRABORT(this->comm().get(), ierr);
+    ierr = EPSGetConverged(e, &n_conv);            CHKERRABORT(this->comm().get(), ierr);
+    
+    // the eigenpairs are returned in increasing order of the eigenvalues
+    _sliced_eigenvalues.resize(n_conv);
+    _sliced_eigenvectors.resize(n_conv);
+    
+    for (PetscInt i=0; i<n_conv; i++) {
+        
+        PetscScalar kr, ki;
+        
+        ierr = MatCreateVecs(A, &_sliced_eigenvectors[i], PETSC_NULL);
+        CHKERRABORT(this->comm().get(), ierr);
+        ierr = EPSGetEigenpair(e, i, &kr, &ki, _sliced_eigenvectors[i], PETSC_NULL);
+        CHKERRABORT(this->comm().get(), ierr);
+        
+        _sliced_eigenvalues[i] = PetscRealPart(kr);
+    }
+    
+    // B-orthonormalization of the clusters, which may have been computed
+    // by different subintervals
+    std::vector<Vec> Bv;
+    PetscInt         i0 = 0;
+    
+    while (i0 < n_conv) {
+        
+        PetscInt i1 = i0+1;
+        
+        while (i1 < n_conv &&
+               std::fabs(_sliced_eigenvalues[i1] - _sliced_eigenvalues[i1-1]) <=
+               _cluster_tol * std::max(std::fabs(_sliced_eigenvalues[i1]), 1.))
+            i1++;
+        
+        if (i1 - i0 > 1) {
+            
+            Bv.resize(i1 - i0);
+            
+            for (PetscInt j=i0; j<i1; j++) {
+                
+                Vec v = _sliced_eigenvectors[j];
+                
+                for (PetscInt k=i0; k<j; k++) {
+                    
+                    PetscScalar c = 0.;
+                    ierr = VecDot(v, Bv[k-i0], &c);
+                    CHKERRABORT(this->comm().get(), ierr);
+                    ierr = VecAXPY(v, -c, _sliced_eigenvectors[k]);
+                    CHKERRABORT(this->comm().get(), ierr);
+                }
+                
+                PetscScalar nrm = 0.;
+                ierr = VecDuplicate(v, &Bv[j-i0]);    CHKERRABORT(this->comm().get(), ierr);
+                ierr = MatMult(B, v, Bv[j-i0]);       CHKERRABORT(this->comm().get(), ierr);
+                ierr = VecDot(v, Bv[j-i0], &nrm);     CHKERRABORT(this->comm().get(), ierr);
+                
+                nrm = 1./std::sqrt(PetscRealPart(nrm));
+                ierr = VecScale(v, nrm);              CHKERRABORT(this->comm().get(), ierr);
+                ierr = VecScale(Bv[j-i0], nrm);       CHKERRABORT(this->comm().get(), ierr);
+            }
+            
+            for (unsigned int j=0; j<Bv.size(); j++) {
+                ierr = VecDestroy(&Bv[j]);
+                CHKERRABORT(this->comm().get(), ierr);
+            }
+            Bv.clear();
+        }
+        
+        i0 = i1;
+    }
+    
+    return std::make_pair((unsigned int)n_conv, (unsigned int)its);
+}
+
+
+
+void
+MAST::SlepcEigenSolver::_clear_sliced_eigenpairs() {
+    
+    PetscErrorCode ierr = 0;
+    
+    for (unsigned int i=0; i<_sliced_eigenvectors.size(); i++) {
+        ierr = VecDestroy(&_sliced_eigenvectors[i]);
+        CHKERRABORT(this->comm().get(), ierr);
+    }
+    
+    _sliced_eigenvectors.clear();
+    _sliced_eigenvalues.clear();
+}
+
+
 
 std::pair<Real, Real>
 MAST::SlepcEigenSolver::get_eigenpair(unsigned int i,
@@ -48,6 +527,20 @@ MAST::SlepcEigenSolver::get_eigenpair(unsigned int i,
         libmesh_assert(eig_vec_im == NULL);
 #endif
     
+    // eigenpairs of a sliced solve are retained by this object
+    if (_sliced_eigenvectors.size()) {
+        
+        libmesh_assert_less(i, _sliced_eigenvectors.size());
+        
+        libMesh::PetscVector<Real>
+        *v = libMesh::cast_ptr<libMesh::PetscVector<Real>*>(&eig_vec);
+        
+        PetscErrorCode ierr = VecCopy(_sliced_eigenvectors[i], v->vec());
+        CHKERRABORT(this->comm().get(), ierr);
+        
+        return std::make_pair(_sliced_eigenvalues[i], 0.);
+    }
+    
     PetscErrorCode ierr=0;
     
     PetscReal re, im;
@@ -20,6 +20,9 @@
 #ifndef __mast__slepc_eigen_solver__
 #define __mast__slepc_eigen_solver__
 
+// C++ includes
+#include <vector>
+
 // MAST includes
 #include "base/mast_data_types.h"
 
@@ -30,6 +33,9 @@
 
 namespace MAST {
     
+    // Forward declerations
+    class HybridParallelConfiguration;
+    
     /*!
      *  This class inherits from libMesh::SlepcEigenSolver<Real> and implements a
      *  method for retriving the real and imaginary components of the eigenvector, 
@@ -43,6 +49,140 @@ namespace MAST {
         SlepcEigenSolver(const libMesh::Parallel::Communicator & comm_in
                          LIBMESH_CAN_DEFAULT_TO_COMMWORLD);
         
+        virtual ~SlepcEigenSolver();
+        
+        
+        /*!
+         *   clears the data retained from prior solves, and the SLEPc
+         *   solver
+         */
+        virtual void clear();
+        
+        
+        /*!
+         *   if \p f is true, the converged eigenvectors of each solve are
+         *   stored and used as the initial space of the next solve with
+         *   EPSSetInitialSpace(). This is useful when the matrices change
+         *   only slightly between solves, for example between the design
+         *   iterations of an optimization. This is false by default.
+         */
+        void set_reuse_eigenvectors(bool f);
+        
+        
+        /*!
+         *   if \p f is true and a preconditioned eigensolver is used
+         *   (\p -eps_type lobpcg, jd or gd, which use the STPRECOND
+         *   spectral transformation), the preconditioner is built from a
+         *   copy of the shifted matrix of the first solve and retained for
+         *   the subsequent solves. With a direct solver as preconditioner,
+         *   the factorization of the first solve then preconditions the
+         *   iterative spectral transformation of the later solves. Call
+         *   clear_reuse_data() to rebuild the preconditioner if the
+         *   matrices have changed significantly. This is false by default.
+         */
+        void set_reuse_preconditioner(bool f);
+        
+        
+        /*!
+         *   deletes the eigenvectors and preconditioner matrix retained
+         *   from prior solves
+         */
+        void clear_reuse_data();
+        
+        
+        /*!
+         *   sets copies of \p vecs as the initial space of the next solve,
+         *   for example the eigenvectors of a previous design iteration. If
+         *   the eigenvectors are not reused, the copies are deleted after
+         *   the next solve.
+         */
+        void set_initial_space(const std::vector<libMesh::NumericVector<Real>*>& vecs);
+        
+        
+        /*!
+         *   enables spectrum slicing for symmetric generalized problems
+         *   (GHEP), in which all eigenvalues in [\p lower, \p upper] are
+         *   computed with the Krylov-Schur solver of SLEPc. The interval
+         *   is split in \p n_partitions subintervals, each of which is
+         *   solved with shift-and-invert on a subcommunicator of
+         *   \p n_procs/n_partitions processors, so that the number of
+         *   processors must be divisible by \p n_partitions. The subinterval
+         *   bounds are equispaced, and can be changed with
+         *   \p -eps_krylovschur_subintervals. The inertia of the shifted
+         *   matrices is obtained from a Cholesky factorization, with MUMPS
+         *   on more than one processor, which can be changed with the
+         *   \p -st_pc_factor_mat_solver_type option. The \p nev value
+         *   given to the solve is the number of eigenvalues computed per
+         *   shift. The interval refers to the eigenvalues of the pencil
+         *   given to solve_generalized().
+         *
+         *   Eigenvectors of the same subinterval are B-orthogonal, while
+         *   those of close eigenvalues from neighboring subintervals are
+         *   B-orthogonal only up to the solver tolerance. After the solve,
+         *   the eigenvectors of each cluster of eigenvalues within a
+         *   relative distance \p cluster_tol are therefore B-orthonormalized
+         *   with modified Gram-Schmidt. The eigenpairs are then retained by
+         *   this object and returned by get_eigenpair().
+         */
+        void set_spectrum_slicing(Real lower,
+                                  Real upper,
+                                  unsigned int n_partitions = 1,
+                                  Real cluster_tol          = 1.e-8);
+        
+        
+        /*!
+         *   disables the spectrum slicing, and deletes the eigenpairs of
+         *   the last sliced solve
+         */
+        void clear_spectrum_slicing();
+        
+        
+        /*!
+         *   sets the configuration that chooses the direct solver of the
+         *   shifted matrices of the sliced solves. Without it, MUMPS is
+         *   used on more than one processor. The object must exist as long
+         *   as it is attached to this solver. \p nullptr removes it.
+         */
+        void set_parallel_configuration(const MAST::HybridParallelConfiguration* c) {
+            _parallel_config = c;
+        }
+        
+        
+        /*!
+         *   @returns true if the spectrum slicing is enabled
+         */
+        bool if_spectrum_slicing() const {
+            return _spectrum_slicing;
+        }
+        
+        
+        /*!
+         *   solves the standard eigenproblem after setting the initial
+         *   space and preconditioner retained from the prior solve
+         */
+        virtual std::pair<unsigned int, unsigned int>
+        solve_standard (libMesh::SparseMatrix<Real> &matrix_A,
+                        int nev,
+                        int ncv,
+                        const double tol,
+                        const unsigned int m_its);
+        
+        
+        /*!
+         *   solves the generalized eigenproblem after setting the initial
+         *   space and preconditioner retained from the prior solve
+         */
+        virtual std::pair<unsigned int, unsigned int>
+        solve_generalized (libMesh::SparseMatrix<Real> &matrix_A,
+                           libMesh::SparseMatrix<Real> &matrix_B,
+                           int nev,
+                           int ncv,
+                           const double tol,
+                           const unsigned int m_its);
+        
+        using libMesh::SlepcEigenSolver<Real>::solve_standard;
+        using libMesh::SlepcEigenSolver<Real>::solve_generalized;
+        
         /**
          * This function returns the real and imaginary part of the
          * ith eigenvalue and copies the respective eigenvector to the
@@ -54,7 +194,93 @@ namespace MAST {
                        libMesh::NumericVector<Real> &eig_vec,
                        libMesh::NumericVector<Real> *eig_vec_im = libmesh_nullptr);
 
+    protected:
+        
+        /*!
+         *   sets the initial space and the preconditioner matrix before
+         *   a solve with \p A and \p B (\p PETSC_NULL for standard
+         *   eigenproblems)
+         */
+        void _init_reuse_data(Mat A, Mat B, int ncv);
+        
+        
+        /*!
+         *   stores the converged eigenvectors after a solve
+         */
+        void _store_reuse_data(Mat A);
+        
+        
+        /*!
+         *   solves the generalized eigenproblem with spectrum slicing and
+         *   B-orthonormalizes the eigenvectors of clusters of eigenvalues
+         */
+        std::pair<unsigned int, unsigned int>
+        _solve_sliced(Mat A,
+                      Mat B,
+                      int nev,
+                      const double tol,
+                      const unsigned int m_its);
+        
+        
+        /*!
+         *   deletes the eigenpairs of the last sliced solve
+         */
+        void _clear_sliced_eigenpairs();
+        
+        /*!
+         *   flag to use the eigenvectors of the prior solve as the initial
+         *   space
+         */
+        bool _reuse_eigenvectors;
 
+        /*!
+         *   flag to retain the preconditioner of the spectral
+         *   transformation
+         */
+        bool _reuse_preconditioner;
+        
+        /*!
+         *   eigenvectors of the prior solve
+         */
+        std::vector<Vec> _eigenvectors;
+        
+        /*!
+         *   matrix from which the retained preconditioner is built
+         */
+        Mat _pc_mat;
+        
+        /*!
+         *   flag to use spectrum slicing for generalized problems
+         */
+        bool _spectrum_slicing;
+        
+        /*!
+         *   interval of the sliced solve
+         */
+        Real _slice_lower, _slice_upper;
+        
+        /*!
+         *   number of subintervals, which are solved in parallel
+         */
+        unsigned int _n_slice_partitions;
+        
+        /*!
+         *   relative distance of eigenvalues in a cluster
+         */
+        Real _cluster_tol;
+        
+        /*!
+         *   configuration of the direct solver, if provided
+         */
+        const MAST::HybridParallelConfiguration* _parallel_config;
+        
+        /*!
+         *   eigenvalues and B-orthonormal eigenvectors of the last sliced
+         *   solve
+         */
+        std::vector<Real> _sliced_eigenvalues;
+        
+        std::vector<Vec>  _sliced_eigenvectors;
     };
 }
 
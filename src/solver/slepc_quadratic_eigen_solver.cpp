@@ -0,0 +1,486 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2017  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+// C++ includes
+#include <algorithm>
+
+
+// MAST includes
+#include "solver/slepc_quadratic_eigen_solver.h"
+
+
+// libMesh includes
+#include "libmesh/petsc_matrix.h"
+
+
+
+MAST::SlepcQuadraticEigenSolver::SlepcQuadraticEigenSolver():
+_n_eig(0),
+_target(0.),
+_tol(1.e-10),
+_max_its(1000),
+_reuse_factorization(false),
+_max_reuse(5),
+_n_reuse(0),
+_if_factor_ksp(false) {
+    
+}
+
+
+
+MAST::SlepcQuadraticEigenSolver::~SlepcQuadraticEigenSolver() {
+    
+    _clear_factorization();
+}
+
+
+
+void
+MAST::SlepcQuadraticEigenSolver::set_reuse_factorization(bool f,
+                                                         unsigned int max_reuse) {
+    
+    _reuse_factorization = f;
+    _max_reuse           = max_reuse;
+    
+    if (!f)
+        _clear_factorization();
+}
+
+
+
+void
+MAST::SlepcQuadraticEigenSolver::compute(const RealMatrixX& M,
+                                         const RealMatrixX& C,
+                                         const RealMatrixX& K,
+                                         bool computeEigenvectors) {
+    
+    libmesh_assert(M.cols() == M.rows() &&
+                   C.cols() == M.rows() && C.rows() == M.rows() &&
+                   K.cols() == M.rows() && K.rows() == M.rows());
+    libmesh_assert_greater(_n_eig, 0);
+    
+    const unsigned int n = (unsigned int)M.rows();
+    
+    // the linearized matrices
+    _A.setZero(2*n, 2*n);
+    _B.setZero(2*n, 2*n);
+    
+    _B.topLeftCorner(n, n)      = RealMatrixX::Identity(n, n);
+    _B.bottomRightCorner(n, n)  = M;
+    
+    _A.topRightCorner(n, n)     = RealMatrixX::Identity(n, n);
+    _A.bottomLeftCorner(n, n)   = -K;
+    _A.bottomRightCorner(n, n)  = -C;
+    
+    ComplexMatrixX
+    x;
+    
+    _solve_pep(M, C, K, computeEigenvectors, alpha, x);
+    
+    beta.setOnes(_n_eig);
+    
+    if (!computeEigenvectors)
+        return;
+    
+    // the left eigenvectors are obtained from the transposed problem.
+    // If Q(p)^T v = 0, then w^H Q(p) = 0 for w = conj(v).
+    ComplexVectorX
+    vals_l;
+    ComplexMatrixX
+    v;
+    
+    _solve_pep(M.transpose(), C.transpose(), K.transpose(), true, vals_l, v);
+    
+    const ComplexMatrixX
+    Mt = M.transpose().cast<Complex>(),
+    Ct = C.transpose().cast<Complex>();
+    
+    VR.setZero(2*n, _n_eig);
+    VL.setZero(2*n, _n_eig);
+    
+    for (unsigned int i=0; i<_n_eig; i++) {
+        
+        const Complex p = alpha(i);
+        
+        // y = {x^T  p x^T}^T
+        VR.col(i).topRows(n)    = x.col(i);
+        VR.col(i).bottomRows(n) = p * x.col(i);
+        
+        // eigenvalue of the transposed problem closest to this one
+        unsigned int j_min = 0;
+        for (unsigned int j=1; j<_n_eig; j++)
+            if (std::abs(vals_l(j)-p) < std::abs(vals_l(j_min)-p))
+                j_min = j;
+        
+        // z = {((p M + C)^H w)^T  w^T}^T
+        const ComplexVectorX w = v.col(j_min).conjugate();
+        VL.col(i).topRows(n)    = (std::conj(p) * Mt + Ct) * w;
+        VL.col(i).bottomRows(n) = w;
+    }
+}
+
+
+
+void
+MAST::SlepcQuadraticEigenSolver::compute(libMesh::SparseMatrix<Real>& M,
+                                         libMesh::SparseMatrix<Real>& C,
+                                         libMesh::SparseMatrix<Real>& K) {
+    
+    libmesh_assert_greater(_n_eig, 0);
+    
+    PetscErrorCode ierr = 0;
+    
+    MPI_Comm comm = M.comm().get();
+    
+    // the PEP operators are in the order of increasing degree:
+    // K + p C + p^2 M
+    Mat mats[3] = {
+        libMesh::cast_ptr<libMesh::PetscMatrix<Real>*>(&K)->mat(),
+        libMesh::cast_ptr<libMesh::PetscMatrix<Real>*>(&C)->mat(),
+        libMesh::cast_ptr<libMesh::PetscMatrix<Real>*>(&M)->mat()};
+    
+    // factorize the shifted operator if it is not available, or has been
+    // reused for the maximum number of solutions
+    if (_reuse_factorization &&
+        (!_if_factor_ksp || _n_reuse >= _max_reuse)) {
+        
+        _clear_factorization();
+        
+        Mat T;
+        PC  pc;
+        
+        ierr = MatDuplicate(mats[0], MAT_COPY_VALUES, &T);
+        CHKERRABORT(comm, ierr);
+        ierr = MatAXPY(T, _target, mats[1], DIFFERENT_NONZERO_PATTERN);
+        CHKERRABORT(comm, ierr);
+        ierr = MatAXPY(T, _target*_target, mats[2], DIFFERENT_NONZERO_PATTERN);
+        CHKERRABORT(comm, ierr);
+        
+        ierr = KSPCreate(comm, &_factor_ksp);
+        CHKERRABORT(comm, ierr);
+        ierr = KSPSetOperators(_factor_ksp, T, T);
+        CHKERRABORT(comm, ierr);
+        ierr = KSPSetType(_factor_ksp, KSPPREONLY);
+        CHKERRABORT(comm, ierr);
+        ierr = KSPGetPC(_factor_ksp, &pc);
+        CHKERRABORT(comm, ierr);
+        ierr = PCSetType(pc, PCLU);
+        CHKERRABORT(comm, ierr);
+        ierr = KSPSetOptionsPrefix(_factor_ksp, "mast_pep_factor_");
+        CHKERRABORT(comm, ierr);
+        ierr = KSPSetFromOptions(_factor_ksp);
+        CHKERRABORT(comm, ierr);
+        ierr = KSPSetUp(_factor_ksp);
+        CHKERRABORT(comm, ierr);
+        
+        // the KSP keeps a reference to the operator
+        ierr = MatDestroy(&T);
+        CHKERRABORT(comm, ierr);
+        
+        _if_factor_ksp = true;
+        _n_reuse       = 0;
+    }
+    else if (_reuse_factorization)
+        _n_reuse++;
+    
+    PEP pep;
+    
+    ierr = PEPCreate(comm, &pep);
+    CHKERRABORT(comm, ierr);
+    ierr = PEPSetOperators(pep, 3, mats);
+    CHKERRABORT(comm, ierr);
+    
+    _set_pep_options(pep);
+    
+    if (_reuse_factorization) {
+        
+        // the shifted systems are solved with GMRES, preconditioned by
+        // the retained factorization
+        ST  st;
+        KSP ksp;
+        PC  pc;
+        
+        ierr = PEPGetST(pep, &st);
+        CHKERRABORT(comm, ierr);
+        ierr = STGetKSP(st, &ksp);
+        CHKERRABORT(comm, ierr);
+        ierr = KSPSetType(ksp, KSPGMRES);
+        CHKERRABORT(comm, ierr);
+        ierr = KSPSetTolerances(ksp, 1.e-2*_tol, PETSC_DEFAULT, PETSC_DEFAULT, PETSC_DEFAULT);
+        CHKERRABORT(comm, ierr);
+        ierr = KSPGetPC(ksp, &pc);
+        CHKERRABORT(comm, ierr);
+        ierr = PCSetType(pc, PCSHELL);
+        CHKERRABORT(comm, ierr);
+        ierr = PCShellSetContext(pc, this);
+        CHKERRABORT(comm, ierr);
+        ierr = PCShellSetApply(pc, MAST::SlepcQuadraticEigenSolver::_apply_factorization);
+        CHKERRABORT(comm, ierr);
+    }
+    
+    // allow the user to override the settings from the command line
+    ierr = PEPSetFromOptions(pep);
+    CHKERRABORT(comm, ierr);
+    
+    ierr = PEPSolve(pep);
+    CHKERRABORT(comm, ierr);
+    
+    PetscInt nconv = 0;
+    ierr = PEPGetConverged(pep, &nconv);
+    CHKERRABORT(comm, ierr);
+    
+    if (nconv < (PetscInt)_n_eig)
+        libmesh_error_msg
+        ("SLEPc PEP converged " << nconv << " of "
+         << _n_eig << " requested eigenvalues.");
+    
+    alpha.setZero(_n_eig);
+    beta.setOnes(_n_eig);
+    
+    PetscScalar kr, ki;
+    
+    for (unsigned int i=0; i<_n_eig; i++) {
+        
+        ierr = PEPGetEigenpair(pep, (PetscInt)i, &kr, &ki, PETSC_NULL, PETSC_NULL);
+        CHKERRABORT(comm, ierr);
+        
+#ifdef LIBMESH_USE_COMPLEX_NUMBERS
+        alpha(i) = Complex(PetscRealPart(kr), PetscImaginaryPart(kr));
+#else
+        alpha(i) = Complex(kr, ki);
+#endif
+    }
+    
+    ierr = PEPDestroy(&pep);
+    CHKERRABORT(comm, ierr);
+    
+    // the linearized matrices and eigenvectors are not available for the
+    // full order system
+    _A.resize(0, 0);
+    _B.resize(0, 0);
+    VL.resize(0, 0);
+    VR.resize(0, 0);
+}
+
+
+
+void
+MAST::SlepcQuadraticEigenSolver::scale_eigenvectors_to_identity_innerproduct() {
+    
+    // this product should be an identity matrix
+    ComplexMatrixX r = this->VL.conjugate().transpose() * _B * this->VR;
+    
+    // scale the right eigenvectors by the inverse of the inner-product
+    // diagonal
+    Complex val;
+    for (unsigned int i=0; i<r.cols(); i++) {
+        val = r(i,i);
+        if (std::abs(val) > 0.)
+            this->VR.col(i) *= (1./val);
+    }
+}
+
+
+
+void
+MAST::SlepcQuadraticEigenSolver::_solve_pep(const RealMatrixX& M,
+                                            const RealMatrixX& C,
+                                            const RealMatrixX& K,
+                                            bool computeEigenvectors,
+                                            ComplexVectorX& vals,
+                                            ComplexMatrixX& vecs) {
+    
+    const PetscInt n = (PetscInt)M.rows();
+    
+    PetscErrorCode ierr = 0;
+    
+    // the PEP operators are in the order of increasing degree:
+    // K + p C + p^2 M
+    const RealMatrixX* m_ptr[3] = {&K, &C, &M};
+    Mat mats[3];
+    
+    for (unsigned int i=0; i<3; i++) {
+        
+        ierr = MatCreateSeqDense(PETSC_COMM_SELF, n, n, PETSC_NULL, &mats[i]);
+        CHKERRABORT(PETSC_COMM_SELF, ierr);
+        
+        // both PETSc and Eigen store dense matrices in column major order
+        PetscScalar* v = PETSC_NULL;
+        ierr = MatDenseGetArray(mats[i], &v);
+        CHKERRABORT(PETSC_COMM_SELF, ierr);
+        
+        std::copy(m_ptr[i]->data(), m_ptr[i]->data()+n*n, v);
+        
+        ierr = MatDenseRestoreArray(mats[i], &v);
+        CHKERRABORT(PETSC_COMM_SELF, ierr);
+        
+        ierr = MatAssemblyBegin(mats[i], MAT_FINAL_ASSEMBLY);
+        CHKERRABORT(PETSC_COMM_SELF, ierr);
+        ierr = MatAssemblyEnd(mats[i], MAT_FINAL_ASSEMBLY);
+        CHKERRABORT(PETSC_COMM_SELF, ierr);
+    }
+    
+    PEP pep;
+    
+    ierr = PEPCreate(PETSC_COMM_SELF, &pep);
+    CHKERRABORT(PETSC_COMM_SELF, ierr);
+    ierr = PEPSetOperators(pep, 3, mats);
+    CHKERRABORT(PETSC_COMM_SELF, ierr);
+    
+    _set_pep_options(pep);
+    
+    // allow the user to override the settings from the command line
+    ierr = PEPSetFromOptions(pep);
+    CHKERRABORT(PETSC_COMM_SELF, ierr);
+    
+    ierr = PEPSolve(pep);
+    CHKERRABORT(PETSC_COMM_SELF, ierr);
+    
+    PetscInt nconv = 0;
+    ierr = PEPGetConverged(pep, &nconv);
+    CHKERRABORT(PETSC_COMM_SELF, ierr);
+    
+    if (nconv < (PetscInt)_n_eig)
+        libmesh_error_msg
+        ("SLEPc PEP converged " << nconv << " of "
+         << _n_eig << " requested eigenvalues.");
+    
+    Vec xr, xi;
+    ierr = MatCreateVecs(mats[0], &xr, PETSC_NULL);
+    CHKERRABORT(PETSC_COMM_SELF, ierr);
+    ierr = VecDuplicate(xr, &xi);
+    CHKERRABORT(PETSC_COMM_SELF, ierr);
+    
+    vals.setZero(_n_eig);
+    if (computeEigenvectors)
+        vecs.setZero(n, _n_eig);
+    
+    PetscScalar kr, ki;
+    const PetscScalar *vr = PETSC_NULL, *vi = PETSC_NULL;
+    
+    for (unsigned int i=0; i<_n_eig; i++) {
+        
+        ierr = PEPGetEigenpair(pep, (PetscInt)i, &kr, &ki, xr, xi);
+        CHKERRABORT(PETSC_COMM_SELF, ierr);
+        
+#ifdef LIBMESH_USE_COMPLEX_NUMBERS
+        vals(i) = Complex(PetscRealPart(kr), PetscImaginaryPart(kr));
+#else
+        vals(i) = Complex(kr, ki);
+#endif
+        
+        if (!computeEigenvectors)
+            continue;
+        
+        ierr = VecGetArrayRead(xr, &vr);
+        CHKERRABORT(PETSC_COMM_SELF, ierr);
+        ierr = VecGetArrayRead(xi, &vi);
+        CHKERRABORT(PETSC_COMM_SELF, ierr);
+        
+        for (PetscInt j=0; j<n; j++)
+#ifdef LIBMESH_USE_COMPLEX_NUMBERS
+            vecs(j, i) = Complex(PetscRealPart(vr[j]), PetscImaginaryPart(vr[j]));
+#else
+            vecs(j, i) = Complex(vr[j], vi[j]);
+#endif
+        
+        ierr = VecRestoreArrayRead(xr, &vr);
+        CHKERRABORT(PETSC_COMM_SELF, ierr);
+        ierr = VecRestoreArrayRead(xi, &vi);
+        CHKERRABORT(PETSC_COMM_SELF, ierr);
+    }
+    
+    ierr = VecDestroy(&xr);
+    CHKERRABORT(PETSC_COMM_SELF, ierr);
+    ierr = VecDestroy(&xi);
+    CHKERRABORT(PETSC_COMM_SELF, ierr);
+    ierr = PEPDestroy(&pep);
+    CHKERRABORT(PETSC_COMM_SELF, ierr);
+    
+    for (unsigned int i=0; i<3; i++) {
+        ierr = MatDestroy(&mats[i]);
+        CHKERRABORT(PETSC_COMM_SELF, ierr);
+    }
+}
+
+
+
+void
+MAST::SlepcQuadraticEigenSolver::_set_pep_options(PEP pep) {
+    
+    PetscErrorCode ierr = 0;
+    MPI_Comm comm;
+    ST  st;
+    
+    ierr = PetscObjectGetComm((PetscObject)pep, &comm);
+    CHKERRABORT(PETSC_COMM_SELF, ierr);
+    
+    ierr = PEPSetProblemType(pep, PEP_GENERAL);
+    CHKERRABORT(comm, ierr);
+    ierr = PEPSetDimensions(pep, (PetscInt)_n_eig, PETSC_DEFAULT, PETSC_DEFAULT);
+    CHKERRABORT(comm, ierr);
+    ierr = PEPSetTolerances(pep, _tol, (PetscInt)_max_its);
+    CHKERRABORT(comm, ierr);
+    
+    // shift-and-invert about the target
+    ierr = PEPSetTarget(pep, _target);
+    CHKERRABORT(comm, ierr);
+    ierr = PEPSetWhichEigenpairs(pep, PEP_TARGET_MAGNITUDE);
+    CHKERRABORT(comm, ierr);
+    ierr = PEPGetST(pep, &st);
+    CHKERRABORT(comm, ierr);
+    ierr = STSetType(st, STSINVERT);
+    CHKERRABORT(comm, ierr);
+}
+
+
+
+void
+MAST::SlepcQuadraticEigenSolver::_clear_factorization() {
+    
+    if (!_if_factor_ksp)
+        return;
+    
+    PetscErrorCode ierr = KSPDestroy(&_factor_ksp);
+    CHKERRABORT(PETSC_COMM_SELF, ierr);
+    
+    _if_factor_ksp = false;
+    _n_reuse       = 0;
+}
+
+
+
+PetscErrorCode
+MAST::SlepcQuadraticEigenSolver::_apply_factorization(PC pc, Vec x, Vec y) {
+    
+    PetscErrorCode ierr = 0;
+    void* ctx = PETSC_NULL;
+    
+    ierr = PCShellGetContext(pc, &ctx);
+    CHKERRQ(ierr);
+    
+    MAST::SlepcQuadraticEigenSolver*
+    solver = static_cast<MAST::SlepcQuadraticEigenSolver*>(ctx);
+    
+    ierr = KSPSolve(solver->_factor_ksp, x, y);
+    CHKERRQ(ierr);
+    
+    return 0;
+}
+
@@ -0,0 +1,253 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2017  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef __mast__slepc_quadratic_eigen_solver__
+#define __mast__slepc_quadratic_eigen_solver__
+
+// MAST includes
+#include "base/mast_data_types.h"
+
+
+// libMesh includes
+#include "libmesh/sparse_matrix.h"
+
+
+// SLEPc includes
+#include <slepcpep.h>
+
+
+namespace MAST {
+    
+    /*!
+     *  Computes a subset of the eigenpairs of the quadratic eigenproblem
+     *  (p^2 M + p C + K) x = 0 with the SLEPc PEP solver, instead of the dense
+     *  eigensolution of the linearized pencil of size 2n. The eigenvalues
+     *  closest to the target are computed with a shift-and-invert spectral
+     *  transformation, which for a target at the origin gives the lowest
+     *  frequency modes near the imaginary axis.
+     *
+     *  The eigenvectors are returned for the linearized first order
+     *  problem A y = p B y, with
+     *   A  = [  0  I  ]     B  = [ I  0 ]
+     *        [ -K -C  ],         [ 0  M ],
+     *  so that the results can be used in place of those from
+     *  MAST::LAPACK_DGGEV. The right eigenvector is y = {x^T p x^T}^T, and
+     *  the left eigenvector is obtained from a second solution with the
+     *  transposed matrices.
+     *
+     *  The dense matrices are stored on each processor, and the solution
+     *  is performed on the communicator of a single processor. The
+     *  problem can also be solved for distributed sparse matrices of the
+     *  full order system, in which case only the eigenvalues are computed,
+     *  and the shift-and-invert factorization can be reused for
+     *  subsequent solutions with nearby matrices.
+     */
+    class SlepcQuadraticEigenSolver {
+        
+    public:
+        
+        SlepcQuadraticEigenSolver();
+        
+        virtual ~SlepcQuadraticEigenSolver();
+        
+        /*!
+         *    sets the number of eigenvalues to be computed. Each complex
+         *    conjugate of a pair is counted separately.
+         */
+        void set_n_eigenvalues(unsigned int n) {
+            _n_eig = n;
+        }
+        
+        /*!
+         *    sets the shift about which the eigenvalues are computed.
+         *    This is zero by default.
+         */
+        void set_target(Real t) {
+            _target = t;
+        }
+        
+        /*!
+         *    sets the tolerance and maximum number of iterations of the
+         *    PEP solver.
+         */
+        void set_tolerance(Real tol, unsigned int max_its) {
+            _tol     = tol;
+            _max_its = max_its;
+        }
+        
+        /*!
+         *    tells the solver to reuse the factorization of the shifted
+         *    operator K + s C + s^2 M from a previous compute() with the
+         *    sparse matrices. The previous factorization is then used as
+         *    the preconditioner of a GMRES solve with the new operator, and
+         *    a new factorization is computed after \p max_reuse solutions.
+         *    The factorization can be configured with the
+         *    \p -mast_pep_factor_ prefix on the command line. This is
+         *    \p false by default.
+         */
+        void set_reuse_factorization(bool f, unsigned int max_reuse = 5);
+        
+        /*!
+         *    computes the eigenvalues closest to the target for
+         *    (p^2 M + p C + K) x = 0.
+         */
+        void compute(const RealMatrixX& M,
+                     const RealMatrixX& C,
+                     const RealMatrixX& K,
+                     bool computeEigenvectors = true);
+        
+        /*!
+         *    computes the eigenvalues closest to the target for
+         *    (p^2 M + p C + K) x = 0, where the matrices are the
+         *    distributed sparse matrices of the full order system. The
+         *    solution is performed on the communicator of the matrices, and
+         *    the eigenvectors are not computed. The matrices must have the
+         *    same sparsity for subsequent calls if the factorization is
+         *    reused.
+         */
+        void compute(libMesh::SparseMatrix<Real>& M,
+                     libMesh::SparseMatrix<Real>& C,
+                     libMesh::SparseMatrix<Real>& K);
+        
+        /*!
+         *    @returns the number of eigenvalues computed
+         */
+        unsigned int n_eigenvalues() const {
+            return (unsigned int)alpha.size();
+        }
+        
+        /*!
+         *   @returns the matrix A of the linearized problem
+         */
+        const RealMatrixX& A() const {
+            return this->_A;
+        }
+        
+        /*!
+         *   @returns the matrix B of the linearized problem
+         */
+        const RealMatrixX& B() const {
+            return this->_B;
+        }
+        
+        const ComplexVectorX& alphas() const {
+            return this->alpha;
+        }
+        
+        const RealVectorX& betas() const {
+            return this->beta;
+        }
+        
+        const ComplexMatrixX& left_eigenvectors() const {
+            return this->VL;
+        }
+        
+        const ComplexMatrixX& right_eigenvectors() const {
+            return this->VR;
+        }
+        
+        /*!
+         *    Scales the right eigenvector so that the inner product with respect
+         *    to the B matrix is equal to an Identity matrix, i.e.
+         *    VL* B * VR = I
+         */
+        void scale_eigenvectors_to_identity_innerproduct();
+        
+    protected:
+        
+        /*!
+         *    solves the PEP for (p^2 M + p C + K) x = 0 and returns the
+         *    \p _n_eig eigenvalues and eigenvectors in \p vals and \p vecs.
+         */
+        void _solve_pep(const RealMatrixX& M,
+                        const RealMatrixX& C,
+                        const RealMatrixX& K,
+                        bool computeEigenvectors,
+                        ComplexVectorX& vals,
+                        ComplexMatrixX& vecs);
+        
+        /*!
+         *    sets the dimensions, tolerance, target and spectral
+         *    transformation for \p pep
+         */
+        void _set_pep_options(PEP pep);
+        
+        /*!
+         *    destroys the retained factorization
+         */
+        void _clear_factorization();
+        
+        /*!
+         *    applies the retained factorization as the preconditioner of
+         *    the shift-and-invert solves
+         */
+        static PetscErrorCode _apply_factorization(PC pc, Vec x, Vec y);
+        
+        /*!
+         *   number of eigenvalues to compute
+         */
+        unsigned int   _n_eig;
+        
+        /*!
+         *   shift of the spectral transformation
+         */
+        Real           _target;
+        
+        /*!
+         *   tolerance and maximum iterations of the solver
+         */
+        Real           _tol;
+        
+        unsigned int   _max_its;
+        
+        /*!
+         *   flag to reuse the factorization for the sparse matrices, and
+         *   the maximum and current number of reuses
+         */
+        bool           _reuse_factorization;
+        
+        unsigned int   _max_reuse;
+        
+        unsigned int   _n_reuse;
+        
+        /*!
+         *   solver with the retained factorization of the shifted
+         *   operator
+         */
+        KSP            _factor_ksp;
+        
+        bool           _if_factor_ksp;
+        
+        RealMatrixX    _A;
+        
+        RealMatrixX    _B;
+        
+        ComplexMatrixX VL;
+        
+        ComplexMatrixX VR;
+        
+        ComplexVectorX alpha;
+        
+        RealVectorX    beta;
+    };
+}
+
+
+#endif // __mast__slepc_quadratic_eigen_solver__
+
@@ -17,10 +17,17 @@
  * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
  */
 
+// C++ includes
+#include <algorithm>
+#include <cmath>
+
 // MAST includes
 #include "solver/transient_solver_base.h"
 #include "base/transient_assembly.h"
 #include "base/nonlinear_system.h"
+#include "base/output_assembly_base.h"
+#include "base/performance_log.h"
+#include "base/solver_telemetry.h"
 
 
 // libMesh includes
@@ -28,12 +35,39 @@
 #include "libmesh/dof_map.h"
 #include "libmesh/sparse_matrix.h"
 #include "libmesh/linear_solver.h"
+#include "libmesh/petsc_matrix.h"
+#include "libmesh/petsc_vector.h"
 
 
 
 MAST::TransientSolverBase::TransientSolverBase():
 dt(0.),
 _first_step(true),
+_linear_solve(false),
+_linear_dt(0.),
+_linear_mat(PETSC_NULL),
+_linear_ksp(PETSC_NULL),
+_adaptive_time_step(false),
+_dt_tol(1.e-3),
+_dt_min(0.),
+_dt_max(0.),
+_dt_next(0.),
+_n_rejected_steps(0),
+_predictor(MAST::TransientSolverBase::PREVIOUS_SOLUTION),
+_predictor_order(2),
+_predictor_tol(0.),
+_n_predictor_steps(0),
+_n_streaming_steps(0),
+_n_telemetry_steps(0),
+_n_memory_snapshots(10),
+_n_disk_snapshots(0),
+_snapshot_prefix("adjoint_checkpoint"),
+_adjoint_t0(0.),
+_adjoint_output(nullptr),
+_adjoint_params(nullptr),
+_adjoint_sens(nullptr),
+_adjoint_ksp(PETSC_NULL),
+_n_adjoint_steps(0),
 _assembly(nullptr),
 _system(nullptr),
 _if_highest_derivative_solution(false) {
@@ -45,6 +79,7 @@ _if_highest_derivative_solution(false) {
 
 MAST::TransientSolverBase::~TransientSolverBase() {
     this->clear_assembly();
+    this->_clear_predictor_history();
 }
 
 
@@ -58,6 +93,9 @@ MAST::TransientSolverBase::set_assembly(MAST::TransientAssembly& assembly) {
     _assembly = &assembly;
     _system   = &assembly.system();
     
+    _n_telemetry_steps = 0;
+    _telemetry_t0      = std::chrono::steady_clock::now();
+    
     // number of time steps to store
     unsigned int n_iters = _n_iters_to_store();
     
@@ -90,6 +128,7 @@ MAST::TransientSolverBase::set_assembly(MAST::TransientAssembly& assembly) {
     }
     
     _first_step = true;
+    this->_clear_predictor_history();
 }
 
 
@@ -101,6 +140,8 @@ MAST::TransientSolverBase::clear_assembly() {
     if (!_system)
         return;
     
+    this->clear_linear_solver();
+    
     // clear the transient solutions stored in system for solution
     // number of time steps to store
     unsigned int n_iters = _n_iters_to_store();
@@ -134,6 +175,8 @@ MAST::TransientSolverBase::clear_assembly() {
         }
     }
     
+    this->_clear_predictor_history();
+    
     _assembly   = nullptr;
     _system     = nullptr;
     _first_step = true;
@@ -142,6 +185,332 @@ MAST::TransientSolverBase::clear_assembly() {
 
 
 
+void
+MAST::TransientSolverBase::set_linear_solve(bool f) {
+    
+    _linear_solve = f;
+    
+    if (!f)
+        this->clear_linear_solver();
+}
+
+
+
+void
+MAST::TransientSolverBase::clear_linear_solver() {
+    
+    if (!_linear_ksp)
+        return;
+    
+    libmesh_assert(_system);
+    
+    PetscErrorCode ierr = 0;
+    
+    ierr = KSPDestroy(&_linear_ksp);  CHKERRABORT(_system->comm().get(), ierr);
+    ierr = MatDestroy(&_linear_mat);  CHKERRABORT(_system->comm().get(), ierr);
+    
+    _linear_dt = 0.;
+}
+
+
+
+void
+MAST::TransientSolverBase::_solve_linear_step() {
+    
+    libmesh_assert(_system);
+    
+    if (_linear_ksp && _linear_dt != dt)
+        this->clear_linear_solver();
+    
+    // the operator is assembled only for the first step
+    const bool
+    if_jac = !_linear_ksp;
+    
+    _system->assembly(true, if_jac);
+    
+    PetscErrorCode ierr = 0;
+    
+    if (if_jac) {
+        
+        Mat mat = dynamic_cast<libMesh::PetscMatrix<Real>*>(_system->matrix)->mat();
+        
+        ierr = MatDuplicate(mat, MAT_COPY_VALUES, &_linear_mat);
+        CHKERRABORT(_system->comm().get(), ierr);
+        
+        ierr = KSPCreate(_system->comm().get(), &_linear_ksp);
+        CHKERRABORT(_system->comm().get(), ierr);
+        
+        if (libMesh::on_command_line("--solver_system_names")) {
+            
+            std::string nm = _system->name() + "_transient_";
+            KSPSetOptionsPrefix(_linear_ksp, nm.c_str());
+        }
+        
+        std::pair<unsigned int, Real>
+        solver_params = _system->get_linear_solve_parameters();
+        
+        ierr = KSPSetOperators(_linear_ksp, _linear_mat, _linear_mat);
+        CHKERRABORT(_system->comm().get(), ierr);
+        ierr = KSPSetTolerances(_linear_ksp,
+                                solver_params.second,
+                                PETSC_DEFAULT,
+                                PETSC_DEFAULT,
+                                solver_params.first);
+        CHKERRABORT(_system->comm().get(), ierr);
+        ierr = KSPSetFromOptions(_linear_ksp);
+        CHKERRABORT(_system->comm().get(), ierr);
+        ierr = KSPSetUp(_linear_ksp);
+        CHKERRABORT(_system->comm().get(), ierr);
+        
+        _linear_dt = dt;
+    }
+    
+    // the residual is evaluated about the current solution estimate, and
+    // one Newton step gives the solution of the linear problem
+    std::auto_ptr<libMesh::NumericVector<Real> >
+    dsol(_system->solution->zero_clone().release());
+    
+    libMesh::PetscVector<Real>
+    &rhs = dynamic_cast<libMesh::PetscVector<Real>&>(*_system->rhs),
+    &dx  = dynamic_cast<libMesh::PetscVector<Real>&>(*dsol);
+    
+    ierr = KSPSolve(_linear_ksp, rhs.vec(), dx.vec());
+    CHKERRABORT(_system->comm().get(), ierr);
+    
+#ifdef LIBMESH_ENABLE_CONSTRAINTS
+    _system->get_dof_map().enforce_constraints_exactly
+    (*_system, dsol.get(), /* homogeneous = */ true);
+#endif
+    
+    _system->solution->add(-1., *dsol);
+    _system->solution->close();
+    _system->update();
+}
+
+
+
+void
+MAST::TransientSolverBase::set_adaptive_time_step(bool f,
+                                                  Real tol,
+                                                  Real dt_min,
+                                                  Real dt_max) {
+    
+    libmesh_assert_greater(tol, 0.);
+    libmesh_assert_greater_equal(dt_min, 0.);
+    libmesh_assert(dt_max == 0. || dt_max >= dt_min);
+    
+    _adaptive_time_step = f;
+    _dt_tol             = tol;
+    _dt_min             = dt_min;
+    _dt_max             = dt_max;
+    _dt_next            = 0.;
+    _n_rejected_steps   = 0;
+}
+
+
+
+void
+MAST::TransientSolverBase::set_predictor(MAST::TransientSolverBase::PredictorType t,
+                                         unsigned int order) {
+    
+    libmesh_assert_greater(order, 0);
+    
+    if (t != _predictor || order < _predictor_order)
+        this->_clear_predictor_history();
+    
+    _predictor       = t;
+    _predictor_order = order;
+}
+
+
+
+void
+MAST::TransientSolverBase::_solve_step() {
+    
+    this->_apply_predictor();
+    
+    // the step is accepted without a solve if the residual of the
+    // predictor is small enough
+    if (_predictor_tol > 0. && !_adaptive_time_step) {
+        
+        _system->assembly(true, false);
+        
+        if (_system->rhs->l2_norm() <= _predictor_tol) {
+            
+            _n_predictor_steps++;
+            return;
+        }
+    }
+    
+    if (_linear_solve)
+        this->_solve_linear_step();
+    else
+        _system->solve();
+}
+
+
+
+void
+MAST::TransientSolverBase::_apply_predictor() {
+    
+    libMesh::NumericVector<Real>& x = *_system->solution;
+    
+    switch (_predictor) {
+            
+        case MAST::TransientSolverBase::PREVIOUS_SOLUTION:
+            // the system solution is the solution of the previous step,
+            // unless it was reset by an adaptive step
+            return;
+            
+        case MAST::TransientSolverBase::TIME_DERIVATIVE_PREDICTOR:
+            this->_predict_solution(x);
+            break;
+            
+        case MAST::TransientSolverBase::POLYNOMIAL_EXTRAPOLATION: {
+            
+            if (_predictor_history.size() < 2)
+                return;
+            
+            // Lagrange extrapolation to the end of the step with the
+            // most recent solutions
+            const unsigned int
+            n  = std::min(_predictor_order+1, (unsigned int)_predictor_history.size()),
+            i0 = (unsigned int)_predictor_history.size() - n;
+            
+            const Real
+            t  = _system->time + dt;
+            
+            x.zero();
+            
+            for (unsigned int i=i0; i<i0+n; i++) {
+                
+                Real
+                l = 1.;
+                
+                for (unsigned int j=i0; j<i0+n; j++)
+                    if (j != i)
+                        l *= (t - _predictor_history[j].first) /
+                        (_predictor_history[i].first - _predictor_history[j].first);
+                
+                x.add(l, *_predictor_history[i].second);
+            }
+        }
+            break;
+            
+        default:
+            libmesh_error();
+    }
+    
+    x.close();
+    
+#ifdef LIBMESH_ENABLE_CONSTRAINTS
+    _system->get_dof_map().enforce_constraints_exactly(*_system);
+#endif
+    
+    _system->update();
+}
+
+
+
+void
+MAST::TransientSolverBase::_add_predictor_history() {
+    
+    if (_predictor != MAST::TransientSolverBase::POLYNOMIAL_EXTRAPOLATION)
+        return;
+    
+    // the history is restarted if the time does not increase, for
+    // example after the state is restored by the adjoint
+    if (_predictor_history.size() &&
+        _predictor_history.back().first >= _system->time)
+        this->_clear_predictor_history();
+    
+    libMesh::NumericVector<Real>* v = nullptr;
+    
+    if (_predictor_history.size() == _predictor_order+1) {
+        
+        // the oldest vector is reused
+        v = _predictor_history.front().second;
+        _predictor_history.pop_front();
+        *v = *_system->solution;
+    }
+    else
+        v = _system->solution->clone().release();
+    
+    v->close();
+    
+    _predictor_history.push_back(std::make_pair(_system->time, v));
+}
+
+
+
+void
+MAST::TransientSolverBase::_clear_predictor_history() {
+    
+    for (unsigned int i=0; i<_predictor_history.size(); i++)
+        delete _predictor_history[i].second;
+    
+    _predictor_history.clear();
+}
+
+
+
+void
+MAST::TransientSolverBase::_solve_adaptive_step() {
+    
+    libmesh_assert(_system);
+    
+    // the step size chosen after the previous step
+    if (_dt_next > 0.)
+        dt = _dt_next;
+    
+    std::auto_ptr<libMesh::NumericVector<Real> >
+    x_p(_system->solution->zero_clone().release());
+    
+    const Real
+    p = this->_error_order();
+    
+    while (true) {
+        
+        // Newmark schemes are one-step methods, so the updates of
+        // velocity and acceleration only need the quantities of the
+        // previous step, and the step can be repeated with a new dt
+        this->_predict_solution(*x_p);
+        
+        *_system->solution = this->solution(1);
+        _system->solution->close();
+        _system->update();
+        
+        this->_solve_step();
+        
+        x_p->add(-1., *_system->solution);
+        x_p->close();
+        
+        const Real
+        nrm = std::max(_system->solution->l2_norm(), this->solution(1).l2_norm()),
+        err = nrm > 0.? this->_error_constant() * x_p->l2_norm() / nrm / _dt_tol: 0.;
+        
+        // factor for the new step size, with a safety factor and bounds
+        // on the change in one step
+        Real
+        fac = err > 0.? 0.9 * pow(1./err, 1./(p+1.)): 2.;
+        fac = std::min(2., std::max(0.2, fac));
+        
+        if (err <= 1. || dt <= _dt_min) {
+            
+            _dt_next = std::max(_dt_min, dt*fac);
+            if (_dt_max > 0.)
+                _dt_next = std::min(_dt_max, _dt_next);
+            break;
+        }
+        
+        // the step is rejected and repeated with a smaller time step
+        dt = std::max(_dt_min, dt*fac);
+        _n_rejected_steps++;
+    }
+}
+
+
+
 libMesh::NumericVector<Real>&
 MAST::TransientSolverBase::solution(unsigned int prev_iter) const {
     
@@ -204,6 +573,45 @@ MAST::TransientSolverBase::acceleration(unsigned int prev_iter) const {
 
 
 
+void
+MAST::TransientSolverBase::write_checkpoint(const std::string& prefix) const {
+    
+    libmesh_assert(_system);
+    
+    std::vector<Real> data(5);
+    data[0] = this->ode_order();
+    data[1] = dt;
+    data[2] = _first_step;
+    data[3] = _dt_next;
+    data[4] = _n_rejected_steps;
+    
+    _system->write_checkpoint(prefix, data);
+}
+
+
+
+void
+MAST::TransientSolverBase::read_checkpoint(const std::string& prefix) {
+    
+    libmesh_assert(_system);
+    
+    std::vector<Real> data;
+    _system->read_checkpoint(prefix, &data);
+    
+    if (data.size() != 5 || (int)data[0] != this->ode_order())
+        libmesh_error_msg("Checkpoint " << prefix
+                          << " was not written by a solver of this type");
+    
+    dt                = data[1];
+    _first_step       = data[2] != 0.;
+    _dt_next          = data[3];
+    _n_rejected_steps = (unsigned int)data[4];
+    
+    this->_clear_predictor_history();
+}
+
+
+
 void
 MAST::TransientSolverBase::solve_highest_derivative_and_advance_time_step() {
     
@@ -285,9 +693,16 @@ MAST::TransientSolverBase::solve_highest_derivative_and_advance_time_step() {
         }
     }
     
+    // the initial condition is the first evaluation of the outputs
+    this->_evaluate_streaming_outputs();
+    
     // finally, update the system time
     _system->time     += dt;
     _first_step        = false;
+    
+    this->_add_predictor_history();
+    
+    this->_report_time_step();
 }
 
 
@@ -480,11 +895,687 @@ MAST::TransientSolverBase::advance_time_step() {
     // and localize solution so that if the user calls the solution and
     // velocity routines,
     
+    // the outputs are evaluated at the time of the solution
+    _n_streaming_steps++;
+    this->_evaluate_streaming_outputs();
+    
     // finally, update the system time
     _system->time     += dt;
     _first_step        = false;
+    
+    this->_add_predictor_history();
+    
+    this->_report_time_step();
+}
+
+
+
+
+
+
+
+void
+MAST::TransientSolverBase::_report_time_step() {
+    
+    _n_telemetry_steps++;
+    
+    if (!MAST::solver_telemetry.active()) {
+        
+        _telemetry_t0 = std::chrono::steady_clock::now();
+        return;
+    }
+    
+    MAST::SolverTelemetry::Event
+    e(MAST::SolverTelemetry::TIME_STEP, _system->name());
+    
+    e.iteration = _n_telemetry_steps-1;
+    e.time      = _system->time;
+    e.dt        = dt;
+    e.converged = true;
+    e.wall_time = MAST::SolverTelemetry::elapsed(_telemetry_t0);
+    
+    // the residual of the nonlinear solve, if the step was solved
+    // by the nonlinear solver
+    if (!_linear_solve)
+        e.residual_l2 = _system->final_nonlinear_residual();
+    
+    MAST::solver_telemetry.emit(e);
+}
+
+
+
+void
+MAST::TransientSolverBase::
+get_state(std::vector<libMesh::NumericVector<Real>*>& state) const {
+    
+    libmesh_assert(_system);
+    libmesh_assert_equal_to(state.size(), this->ode_order()+1);
+    
+    *state[0] = this->solution();
+    *state[1] = this->velocity();
+    if (this->ode_order() > 1)
+        *state[2] = this->acceleration();
+    
+    for (unsigned int i=0; i<state.size(); i++)
+        state[i]->close();
+}
+
+
+
+void
+MAST::TransientSolverBase::
+set_state(const std::vector<libMesh::NumericVector<Real>*>& state,
+          Real t) {
+    
+    libmesh_assert(_system);
+    libmesh_assert_equal_to(state.size(), this->ode_order()+1);
+    
+    // the state after a time step has the same values in all
+    // history vectors
+    for (unsigned int j=0; j<_n_iters_to_store(); j++) {
+        
+        this->solution(j) = *state[0];
+        this->solution(j).close();
+        this->velocity(j) = *state[1];
+        this->velocity(j).close();
+        
+        if (this->ode_order() > 1) {
+            this->acceleration(j) = *state[2];
+            this->acceleration(j).close();
+        }
+    }
+    
+    _system->time = t;
+    _system->update();
+    _first_step   = false;
+    
+    this->_clear_predictor_history();
+}
+
+
+
+void
+MAST::TransientSolverBase::set_adjoint_checkpoints(unsigned int n_memory,
+                                                   unsigned int n_disk,
+                                                   const std::string& prefix) {
+    
+    libmesh_assert_greater(n_memory + n_disk, 0);
+    
+    _n_memory_snapshots = n_memory;
+    _n_disk_snapshots   = n_disk;
+    _snapshot_prefix    = prefix;
+}
+
+
+
+void
+MAST::TransientSolverBase::adjoint_sensitivity(MAST::OutputAssemblyBase& output,
+                                               const libMesh::ParameterVector& params,
+                                               unsigned int n_steps,
+                                               std::vector<Real>& sens) {
+    
+    MAST_LOG_SCOPE("adjoint_sensitivity()", "TransientSolverBase");
+    
+    libmesh_assert(_system);
+    libmesh_assert(!_first_step);
+    libmesh_assert_greater(n_steps, 0);
+    
+    _adjoint_output  = &output;
+    _adjoint_params  = &params;
+    _adjoint_sens    = &sens;
+    _adjoint_t0      = _system->time - dt;
+    _n_adjoint_steps = 0;
+    _adjoint_dt.clear();
+    
+    sens.assign(params.size(), 0.);
+    
+    // the recomputed steps are not included in the streaming outputs
+    std::vector<StreamingOutput> streaming_outputs;
+    streaming_outputs.swap(_streaming_outputs);
+    
+    // the adjoint variables of the updates are zero after the last step
+    _adjoint_mu.resize(this->ode_order());
+    for (unsigned int i=0; i<_adjoint_mu.size(); i++)
+        _adjoint_mu[i] = _system->solution->zero_clone().release();
+    
+    const unsigned int
+    n_levels = _n_memory_snapshots + _n_disk_snapshots;
+    
+    _snapshots.resize(n_levels, nullptr);
+    
+    this->_store_adjoint_snapshot(0);
+    this->_adjoint_sweep(0, n_steps, 0, n_levels-1);
+    
+    // the initial state is restored for the adjoint of the highest
+    // derivative solve, which was performed at the initial time
+    this->_restore_adjoint_snapshot(0);
+    _system->time = _adjoint_t0;
+    this->_adjoint_step(0);
+    _system->time = _snapshots[0]->time;
+    
+    for (unsigned int i=0; i<_snapshots.size(); i++)
+        delete _snapshots[i];
+    _snapshots.clear();
+    
+    for (unsigned int i=0; i<_adjoint_mu.size(); i++)
+        delete _adjoint_mu[i];
+    _adjoint_mu.clear();
+    
+    if (_adjoint_ksp) {
+        
+        PetscErrorCode ierr = KSPDestroy(&_adjoint_ksp);
+        CHKERRABORT(_system->comm().get(), ierr);
+        _adjoint_ksp = PETSC_NULL;
+    }
+    
+    _adjoint_output = nullptr;
+    _adjoint_params = nullptr;
+    _adjoint_sens   = nullptr;
+    
+    _streaming_outputs.swap(streaming_outputs);
+}
+
+
+
+void
+MAST::TransientSolverBase::_store_adjoint_snapshot(unsigned int i) {
+    
+    libmesh_assert_less(i, _snapshots.size());
+    
+    delete _snapshots[i];
+    _snapshots[i] = new AdjointSnapshot;
+    _snapshots[i]->time = _system->time;
+    
+    if (i >= _n_memory_snapshots) {
+        
+        std::ostringstream oss;
+        oss << _snapshot_prefix << "_" << i;
+        this->write_checkpoint(oss.str());
+        return;
+    }
+    
+    _snapshots[i]->vecs.push_back(this->solution().clone().release());
+    _snapshots[i]->vecs.push_back(this->velocity().clone().release());
+    if (this->ode_order() > 1)
+        _snapshots[i]->vecs.push_back(this->acceleration().clone().release());
+}
+
+
+
+void
+MAST::TransientSolverBase::_restore_adjoint_snapshot(unsigned int i) {
+    
+    libmesh_assert_less(i, _snapshots.size());
+    libmesh_assert(_snapshots[i]);
+    
+    if (i >= _n_memory_snapshots) {
+        
+        std::ostringstream oss;
+        oss << _snapshot_prefix << "_" << i;
+        this->read_checkpoint(oss.str());
+    }
+    else
+        this->set_state(_snapshots[i]->vecs, _snapshots[i]->time);
+    
+    _system->time = _snapshots[i]->time;
+    _system->update();
+}
+
+
+
+void
+MAST::TransientSolverBase::_adjoint_advance(unsigned int from,
+                                            unsigned int to) {
+    
+    for (unsigned int n=from+1; n<=to; n++) {
+        
+        this->_adjoint_solve_step(n);
+        this->advance_time_step();
+    }
+}
+
+
+
+void
+MAST::TransientSolverBase::_adjoint_solve_step(unsigned int n) {
+    
+    if (n > _adjoint_dt.size()) {
+        
+        // the first pass over the step records the time step, which may
+        // be chosen adaptively
+        libmesh_assert_equal_to(n, _adjoint_dt.size()+1);
+        
+        this->solve();
+        _adjoint_dt.push_back(dt);
+    }
+    else {
+        
+        const bool
+        adaptive = _adaptive_time_step;
+        
+        dt                  = _adjoint_dt[n-1];
+        _adaptive_time_step = false;
+        this->solve();
+        _adaptive_time_step = adaptive;
+    }
+    
+    _n_adjoint_steps++;
+}
+
+
+
+void
+MAST::TransientSolverBase::_adjoint_sweep(unsigned int from,
+                                          unsigned int to,
+                                          unsigned int level,
+                                          unsigned int n_free) {
+    
+    libmesh_assert_greater(to, from);
+    
+    const unsigned int
+    n = to - from;
+    
+    if (n == 1) {
+        
+        this->_adjoint_step(to);
+        return;
+    }
+    
+    if (!n_free) {
+        
+        // without a free level, each step is recomputed from the
+        // stored state
+        for (unsigned int i=to; i>from; i--) {
+            
+            this->_restore_adjoint_snapshot(level);
+            this->_adjoint_advance(from, i-1);
+            this->_adjoint_step(i);
+        }
+        return;
+    }
+    
+    // the smallest number of repetitions t, for which s = n_free levels
+    // cover beta(s,t) = (s+t)!/(s!t!) >= n steps
+    Real
+    b_s_t   = 1.,      // beta(s,t)
+    b_s1_t  = 1.;      // beta(s-1,t)
+    unsigned int
+    t       = 0;
+    
+    while (b_s_t < n) {
+        
+        t++;
+        b_s1_t  = b_s1_t * (n_free - 1 + t) / t;
+        b_s_t   = b_s_t  * (n_free + t) / t;
+    }
+    
+    // the last beta(s-1,t) steps are swept with s-1 free levels, and
+    // the remaining beta(s,t-1) steps with s free levels
+    const unsigned int
+    n_right = (unsigned int)std::min(b_s1_t, Real(n-1)),
+    mid     = to - n_right;
+    
+    this->_adjoint_advance(from, mid);
+    this->_store_adjoint_snapshot(level+1);
+    this->_adjoint_sweep(mid, to, level+1, n_free-1);
+    
+    this->_restore_adjoint_snapshot(level);
+    this->_adjoint_sweep(from, mid, level, n_free);
+}
+
+
+
+void
+MAST::TransientSolverBase::_adjoint_step(unsigned int n) {
+    
+    MAST_LOG_SCOPE("adjoint_step()", "TransientSolverBase");
+    
+    // The time integration is written as
+    //   R_n(X_n, d_n)  = 0
+    //   d_n            = c (X_n - X_{n-1}) + G d_{n-1}
+    // where d_n are the time derivatives of the solution at step n. With
+    // the adjoint variables lambda_n of R_n and mu_n of the derivative
+    // updates, the stationarity of the Lagrangian gives
+    //   eta                 = G_{n+1}^T mu_{n+1}
+    //   J_n^T lambda_n      = -dJ/dX_n - c_{n+1}^T mu_{n+1} + c_n^T eta
+    //   mu_n                = eta - [dR_n/dd_n]^T lambda_n
+    // where J_n = dR_n/dX_n + c_n dR_n/dd_n is the Jacobian of the step.
+    // For the initial highest derivative solve of order m,
+    //   [dR_0/dd_m]^T lambda_0 = eta_m
+    // Then, dJ/dp = sum_n lambda_n^T dR_n/dp.
+    
+    // the solution of the step. The adjoint steps are in reverse order,
+    // so the time steps of all steps are known after the first.
+    if (n)
+        this->_adjoint_solve_step(n);
+    
+    const unsigned int
+    n_steps = (unsigned int)_adjoint_dt.size(),
+    order   = this->ode_order();
+    
+    RealVectorX
+    c_n,
+    c_np1;
+    
+    RealMatrixX
+    G_n,
+    G_np1;
+    
+    std::vector<libMesh::NumericVector<Real>*>
+    eta(order, nullptr);
+    
+    for (unsigned int j=0; j<order; j++) {
+        
+        eta[j] = _adjoint_mu[j]->zero_clone().release();
+        
+        if (n < n_steps) {
+            
+            if (!j)
+                this->_adjoint_coefficients(_adjoint_dt[n], c_np1, G_np1);
+            
+            for (unsigned int k=0; k<order; k++)
+                eta[j]->add(G_np1(k, j), *_adjoint_mu[k]);
+            eta[j]->close();
+        }
+    }
+    
+    std::auto_ptr<libMesh::NumericVector<Real> >
+    rhs   (_system->solution->zero_clone().release()),
+    lambda(_system->solution->zero_clone().release());
+    
+    if (n) {
+        
+        this->_adjoint_coefficients(dt, c_n, G_n);
+        
+        _adjoint_output->assemble_output_derivative(*_system->solution, *rhs);
+        rhs->scale(-dt);
+        
+        for (unsigned int j=0; j<order; j++) {
+            
+            if (n < n_steps)
+                rhs->add(-c_np1(j), *_adjoint_mu[j]);
+            rhs->add(c_n(j), *eta[j]);
+        }
+        rhs->close();
+        
+        this->_adjoint_transpose_solve(*rhs, *lambda, false);
+    }
+    else {
+        
+        *rhs = *eta[order-1];
+        rhs->close();
+        
+        this->_adjoint_transpose_solve(*rhs, *lambda, true);
+    }
+    
+    // the products with the Jacobians of the time derivatives also
+    // update the time derivatives of the step, which are used by the
+    // sensitivity assembly
+    if (n) {
+        
+        std::vector<libMesh::NumericVector<Real>*>
+        prods(order, nullptr);
+        for (unsigned int j=0; j<order; j++)
+            prods[j] = _adjoint_mu[j];
+        
+        _assembly->derivative_jacobian_transpose_product(*_system->solution,
+                                                         *lambda,
+                                                         prods);
+        
+        for (unsigned int j=0; j<order; j++) {
+            
+            _adjoint_mu[j]->scale(-1.);
+            _adjoint_mu[j]->add(1., *eta[j]);
+            _adjoint_mu[j]->close();
+        }
+    }
+    
+    for (unsigned int j=0; j<order; j++)
+        delete eta[j];
+    
+    // the sensitivity assembly provides -dR/dp
+    for (unsigned int i=0; i<_adjoint_params->size(); i++) {
+        
+        _assembly->sensitivity_assemble(*_adjoint_params, i, *rhs);
+        (*_adjoint_sens)[i] -= lambda->dot(*rhs);
+    }
+}
+
+
+
+void
+MAST::TransientSolverBase::
+_adjoint_transpose_solve(libMesh::NumericVector<Real>& b,
+                         libMesh::NumericVector<Real>& lambda,
+                         bool if_highest_derivative) {
+    
+    PetscErrorCode ierr = 0;
+    
+    KSP ksp = PETSC_NULL;
+    
+    if (!if_highest_derivative &&
+        _linear_solve && _linear_ksp && _linear_dt == dt) {
+        
+        // the operator of the linear time steps is reused
+        ksp = _linear_ksp;
+    }
+    else {
+        
+        _if_highest_derivative_solution = if_highest_derivative;
+        _system->assembly(false, true);
+        _if_highest_derivative_solution = false;
+        
+        Mat mat = dynamic_cast<libMesh::PetscMatrix<Real>*>(_system->matrix)->mat();
+        
+        if (!_adjoint_ksp) {
+            
+            ierr = KSPCreate(_system->comm().get(), &_adjoint_ksp);
+            CHKERRABORT(_system->comm().get(), ierr);
+            
+            if (libMesh::on_command_line("--solver_system_names")) {
+                
+                std::string nm = _system->name() + "_transient_adjoint_";
+                KSPSetOptionsPrefix(_adjoint_ksp, nm.c_str());
+            }
+            
+            std::pair<unsigned int, Real>
+            solver_params = _system->get_linear_solve_parameters();
+            
+            ierr = KSPSetTolerances(_adjoint_ksp,
+                                    solver_params.second,
+                                    PETSC_DEFAULT,
+                                    PETSC_DEFAULT,
+                                    solver_params.first);
+            CHKERRABORT(_system->comm().get(), ierr);
+        }
+        
+        ierr = KSPSetOperators(_adjoint_ksp, mat, mat);
+        CHKERRABORT(_system->comm().get(), ierr);
+        ierr = KSPSetFromOptions(_adjoint_ksp);
+        CHKERRABORT(_system->comm().get(), ierr);
+        ierr = KSPSetUp(_adjoint_ksp);
+        CHKERRABORT(_system->comm().get(), ierr);
+        
+        ksp = _adjoint_ksp;
+    }
+    
+    libMesh::PetscVector<Real>
+    &rhs = dynamic_cast<libMesh::PetscVector<Real>&>(b),
+    &sol = dynamic_cast<libMesh::PetscVector<Real>&>(lambda);
+    
+    ierr = KSPSolveTranspose(ksp, rhs.vec(), sol.vec());
+    CHKERRABORT(_system->comm().get(), ierr);
+    
+#ifdef LIBMESH_ENABLE_CONSTRAINTS
+    _system->get_dof_map().enforce_constraints_exactly
+    (*_system, &lambda, /* homogeneous = */ true);
+#endif
+}
+
+
+
+
+unsigned int
+MAST::TransientSolverBase::
+add_streaming_output(MAST::TransientSolverBase::OutputEvaluation& f,
+                     MAST::TransientSolverBase::StreamingOutputType t,
+                     unsigned int stride) {
+    
+    libmesh_assert_greater(stride, 0);
+    
+    StreamingOutput o;
+    o.f      = &f;
+    o.type   = t;
+    o.stride = stride;
+    
+    _streaming_outputs.push_back(o);
+    
+    return (unsigned int)_streaming_outputs.size()-1;
+}
+
+
+
+Real
+MAST::TransientSolverBase::streaming_output_value(unsigned int i) const {
+    
+    libmesh_assert_less(i, _streaming_outputs.size());
+    
+    const StreamingOutput& o = _streaming_outputs[i];
+    
+    const Real
+    dt_total = o.last_time - o.first_time;
+    
+    switch (o.type) {
+            
+        case TIME_AVERAGE:
+            return dt_total > 0.? o.value/dt_total: o.last_value;
+            
+        case ROOT_MEAN_SQUARE:
+            return sqrt(dt_total > 0.? o.value/dt_total: o.last_value);
+            
+        default:
+            return o.value;
+    }
+}
+
+
+
+Real
+MAST::TransientSolverBase::streaming_output_extreme_time(unsigned int i) const {
+    
+    libmesh_assert_less(i, _streaming_outputs.size());
+    
+    return _streaming_outputs[i].extreme_time;
+}
+
+
+
+unsigned int
+MAST::TransientSolverBase::n_streaming_output_evaluations(unsigned int i) const {
+    
+    libmesh_assert_less(i, _streaming_outputs.size());
+    
+    return _streaming_outputs[i].n_evals;
 }
 
 
 
+void
+MAST::TransientSolverBase::reset_streaming_outputs() {
+    
+    for (unsigned int i=0; i<_streaming_outputs.size(); i++) {
+        
+        StreamingOutput& o = _streaming_outputs[i];
+        
+        o.n_evals      = 0;
+        o.value        = 0.;
+        o.last_value   = 0.;
+        o.first_time   = 0.;
+        o.last_time    = 0.;
+        o.extreme_time = 0.;
+    }
+    
+    _n_streaming_steps = 0;
+}
+
+
+
+void
+MAST::TransientSolverBase::clear_streaming_outputs() {
+    
+    _streaming_outputs.clear();
+    _n_streaming_steps = 0;
+}
+
+
+
+void
+MAST::TransientSolverBase::_evaluate_streaming_outputs() {
+    
+    if (_streaming_outputs.empty())
+        return;
+    
+    MAST_LOG_SCOPE("evaluate_streaming_outputs()", "TransientSolverBase");
+    
+    const Real
+    t = _system->time;
+    
+    for (unsigned int i=0; i<_streaming_outputs.size(); i++) {
+        
+        StreamingOutput& o = _streaming_outputs[i];
+        
+        if (_n_streaming_steps % o.stride)
+            continue;
+        
+        Real
+        v = o.f->evaluate(*_system->solution, t);
+        
+        switch (o.type) {
+                
+            case ROOT_MEAN_SQUARE:
+                v *= v;
+                // fall through to the time integral
+                
+            case TIME_INTEGRAL:
+            case TIME_AVERAGE: {
+                
+                if (o.n_evals)
+                    o.value += .5 * (t - o.last_time) * (v + o.last_value);
+            }
+                break;
+                
+            case MAXIMUM_ABSOLUTE:
+                v = std::fabs(v);
+                // fall through to the maximum
+                
+            case MAXIMUM: {
+                
+                if (!o.n_evals || v > o.value) {
+                    o.value        = v;
+                    o.extreme_time = t;
+                }
+            }
+                break;
+                
+            case MINIMUM: {
+                
+                if (!o.n_evals || v < o.value) {
+                    o.value        = v;
+                    o.extreme_time = t;
+                }
+            }
+                break;
+                
+            default:
+                libmesh_error();
+        }
+        
+        if (!o.n_evals)
+            o.first_time = t;
+        
+        o.last_value = v;
+        o.last_time  = t;
+        o.n_evals++;
+    }
+}
 
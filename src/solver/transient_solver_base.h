@@ -21,12 +21,23 @@
 #ifndef __mast__transient_solver_base__
 #define __mast__transient_solver_base__
 
+// C++ includes
+#include <string>
+#include <vector>
+#include <deque>
+#include <chrono>
+
+
 // MAST includes
 #include "base/mast_data_types.h"
 
 
 // libMesh includes
 #include "libmesh/numeric_vector.h"
+#include "libmesh/parameter_vector.h"
+
+// PETSc includes
+#include <petscksp.h>
 
 
 namespace MAST {
@@ -35,6 +46,7 @@ namespace MAST {
     class TransientAssembly;
     class ElementBase;
     class NonlinearSystem;
+    class OutputAssemblyBase;
     
     
     class TransientSolverBase {
@@ -132,6 +144,318 @@ namespace MAST {
         virtual void solve() = 0;
         
         
+        /*!
+         *   if \p f is true, the time steps are solved assuming that the
+         *   problem is linear, so that the Jacobian of the time step does
+         *   not depend on the solution. At the first step, the effective
+         *   operator of the time integration scheme is assembled and a
+         *   copy of it is given to a KSP, which is set up once and
+         *   retained. Each subsequent step then needs only a residual
+         *   assembly and one solve with the retained factorization or
+         *   preconditioner. The operator is rebuilt if \p dt changes.
+         *   clear_linear_solver() must be called if the properties,
+         *   boundary conditions or parameters of the time integration
+         *   scheme are changed. This is false by default.
+         */
+        void set_linear_solve(bool f);
+        
+        
+        /*!
+         *   @returns true if the time steps are solved as linear problems
+         */
+        bool if_linear_solve() const {
+            return _linear_solve;
+        }
+        
+        
+        /*!
+         *   destroys the operator and KSP retained for the linear solves
+         */
+        void clear_linear_solver();
+        
+        
+        /*!
+         *   if \p f is true, solve() chooses the time step from an
+         *   estimate of the local truncation error, which is obtained from
+         *   the difference between an explicit predictor and the solution
+         *   of the step. A step with an error larger than \p tol relative
+         *   to the norm of the solution is rejected and repeated with a
+         *   smaller \p dt, unless \p dt is already \p dt_min. After
+         *   each accepted step the next step size is chosen from the error,
+         *   within [\p dt_min, \p dt_max]. \p dt_max = 0 does not limit
+         *   the step size. Upon return from solve(), \p dt is the size of
+         *   the accepted step, which is used by advance_time_step(). The
+         *   initial value of \p dt is used for the first step.
+         */
+        void set_adaptive_time_step(bool f,
+                                    Real tol    = 1.e-3,
+                                    Real dt_min = 0.,
+                                    Real dt_max = 0.);
+        
+        
+        /*!
+         *   @returns true if the time step is chosen adaptively
+         */
+        bool if_adaptive_time_step() const {
+            return _adaptive_time_step;
+        }
+        
+        
+        /*!
+         *   @returns the number of steps that have been rejected by the
+         *   adaptive time step control
+         */
+        unsigned int n_rejected_steps() const {
+            return _n_rejected_steps;
+        }
+        
+        
+        /*!
+         *   initial guess of the nonlinear solution of a time step
+         */
+        enum PredictorType {
+            PREVIOUS_SOLUTION,          // solution of the previous step
+            POLYNOMIAL_EXTRAPOLATION,   // extrapolation of the solution history
+            TIME_DERIVATIVE_PREDICTOR   // Taylor series of the previous step
+        };
+        
+        
+        /*!
+         *   sets the initial guess of the solve of each time step. With
+         *   \p POLYNOMIAL_EXTRAPOLATION, the solution is extrapolated to
+         *   the end of the step with the Lagrange polynomial of degree
+         *   \p order through the solutions of the last \p order+1 steps,
+         *   which are copied after each step. The degree is lower until
+         *   this history is available, and the history is restarted when
+         *   the state of the solver is set. With
+         *   \p TIME_DERIVATIVE_PREDICTOR, the explicit predictor of the
+         *   scheme from the solution and its time derivatives at the
+         *   previous step is used, which is also used by the adaptive time
+         *   step. This is \p PREVIOUS_SOLUTION by default.
+         */
+        void set_predictor(MAST::TransientSolverBase::PredictorType t,
+                           unsigned int order = 2);
+        
+        
+        /*!
+         *   @returns the initial guess of the solve of each time step
+         */
+        MAST::TransientSolverBase::PredictorType predictor() const {
+            return _predictor;
+        }
+        
+        
+        /*!
+         *   if \p tol is positive, the residual is computed at the
+         *   predicted solution, and the predictor is accepted as the
+         *   solution of the step without a Jacobian assembly or solve if
+         *   the l2 norm of the residual is at most \p tol. This should be
+         *   consistent with the absolute tolerance of the nonlinear solver.
+         *   This is not used with the adaptive time step, whose error
+         *   estimate is the difference from the predictor. This is 0 by
+         *   default.
+         */
+        void set_predictor_residual_tolerance(Real tol) {
+            libmesh_assert_greater_equal(tol, 0.);
+            _predictor_tol = tol;
+        }
+        
+        
+        /*!
+         *   @returns the number of steps for which the predictor was
+         *   accepted as the solution
+         */
+        unsigned int n_predictor_accepted_steps() const {
+            return _n_predictor_steps;
+        }
+        
+        
+        /*!
+         *   writes the solution, its time derivatives and history, and
+         *   the state of the solver (time step, adaptive time step data
+         *   and first step flag) to the per-processor checkpoint files with
+         *   \p prefix. See MAST::NonlinearSystem::write_checkpoint().
+         *   The assembly must be set.
+         */
+        void write_checkpoint(const std::string& prefix) const;
+        
+        
+        /*!
+         *   restarts the solver from the checkpoint written by
+         *   write_checkpoint(). The assembly must be set, and the same
+         *   solver type and number of processors must be used. The
+         *   time integration continues from the checkpointed step
+         *   without a call to solve_highest_derivative_and_advance_time_step().
+         */
+        void read_checkpoint(const std::string& prefix);
+        
+        
+        /*!
+         *   copies the solution and its time derivatives up to ode_order()
+         *   to \p state, which must have ode_order()+1 vectors of the
+         *   size of the solution
+         */
+        void get_state(std::vector<libMesh::NumericVector<Real>*>& state) const;
+        
+        
+        /*!
+         *   sets the solution and its time derivatives up to ode_order()
+         *   from \p state in the current and all previous iterations, as
+         *   after advance_time_step(), and sets the time of the system to
+         *   \p t. The next call to solve() then solves the time step from
+         *   this state.
+         */
+        void set_state(const std::vector<libMesh::NumericVector<Real>*>& state,
+                       Real t);
+        
+        
+        /*!
+         *   sets the number of states that adjoint_sensitivity() can store
+         *   at a time. \p n_memory states are kept in memory, and
+         *   \p n_disk states are written to the per-processor checkpoint
+         *   files with \p prefix (see write_checkpoint()). The states are
+         *   used as a stack, with the first \p n_memory levels in memory.
+         *   The default is 10 states in memory and none on disk.
+         */
+        void set_adjoint_checkpoints(unsigned int n_memory,
+                                     unsigned int n_disk        = 0,
+                                     const std::string& prefix  = "adjoint_checkpoint");
+        
+        
+        /*!
+         *   computes the sensitivity of the time-integrated output
+         *   \f[ J = \sum_{n=1}^{N} dt_n q(X_n) \f]
+         *   over the next \p n_steps time steps with respect to each
+         *   parameter in \p params with the discrete adjoint of the time
+         *   integration scheme, and returns it in \p sens. \p output
+         *   provides \f$ \partial q/\partial X \f$, and the output must
+         *   depend on the parameters only through the solution. The
+         *   parameters must be added to the discipline.
+         *
+         *   The initial condition must be set, and
+         *   solve_highest_derivative_and_advance_time_step() must have been
+         *   called. The adjoint of step \p n is solved with the transpose
+         *   of the Jacobian of step \p n about the solution of the step,
+         *   so the states are needed in reverse order. These are recomputed
+         *   from the states stored with set_adjoint_checkpoints(), which are
+         *   placed with the binomial schedule of Revolve (Griewank and
+         *   Walther, 2000). With \p s states and \p t repetitions this
+         *   covers up to \f$ (s+t)!/(s!t!) \f$ steps, and the number of
+         *   solved forward steps is available from n_adjoint_forward_steps().
+         *   The time steps of the first forward pass are recorded, so that
+         *   adaptive time steps are reproduced by the recomputation. The
+         *   cost for any number of parameters is therefore about that of
+         *   the recomputed forward steps and one backward pass. Upon
+         *   return, the solver is at the initial state.
+         *
+         *   This requires the solver to implement _adjoint_coefficients()
+         *   and _elem_derivative_jacobians(), and the assembly to provide
+         *   the element residual sensitivity.
+         */
+        void adjoint_sensitivity(MAST::OutputAssemblyBase& output,
+                                 const libMesh::ParameterVector& params,
+                                 unsigned int n_steps,
+                                 std::vector<Real>& sens);
+        
+        
+        /*!
+         *   @returns the number of forward steps that were solved by the
+         *   last call to adjoint_sensitivity(), including the first pass
+         */
+        unsigned int n_adjoint_forward_steps() const {
+            return _n_adjoint_steps;
+        }
+        
+        
+        /*!
+         *   evaluates a scalar quantity of the solution, which is
+         *   accumulated over the time steps by a streaming output. This can
+         *   be, for example, the displacement of a node, or a functional of
+         *   the stresses or of the heat flux computed with the assembly
+         *   of the outputs.
+         */
+        class OutputEvaluation {
+            
+        public:
+            
+            OutputEvaluation() { }
+            
+            virtual ~OutputEvaluation() { }
+            
+            /*!
+             *   @returns the quantity for the solution \p X at time \p t.
+             *   This is called on all processors, and must return the same
+             *   value on all processors.
+             */
+            virtual Real evaluate(const libMesh::NumericVector<Real>& X,
+                                  Real t) = 0;
+        };
+        
+        
+        /*!
+         *   accumulation of the values of a streaming output. The time
+         *   integrals use the trapezoidal rule over the evaluations.
+         */
+        enum StreamingOutputType {
+            TIME_INTEGRAL,
+            TIME_AVERAGE,
+            ROOT_MEAN_SQUARE,
+            MAXIMUM,
+            MINIMUM,
+            MAXIMUM_ABSOLUTE
+        };
+        
+        
+        /*!
+         *   adds a streaming output, which evaluates \p f every \p stride
+         *   time steps after advance_time_step(), and after the initial
+         *   condition in solve_highest_derivative_and_advance_time_step().
+         *   The values are accumulated as specified by \p t, so that the
+         *   history of the solution does not need to be stored for the
+         *   output. \p f must exist as long as it is used by this object.
+         *   The outputs are not evaluated by the recomputed steps of
+         *   adjoint_sensitivity().
+         *   @returns the index of the output.
+         */
+        unsigned int
+        add_streaming_output(MAST::TransientSolverBase::OutputEvaluation& f,
+                             MAST::TransientSolverBase::StreamingOutputType t,
+                             unsigned int stride = 1);
+        
+        
+        /*!
+         *   @returns the accumulated value of the i^th streaming output
+         */
+        Real streaming_output_value(unsigned int i) const;
+        
+        
+        /*!
+         *   @returns the time of the extreme value of the i^th streaming
+         *   output, for the \p MAXIMUM, \p MINIMUM and \p MAXIMUM_ABSOLUTE
+         *   outputs
+         */
+        Real streaming_output_extreme_time(unsigned int i) const;
+        
+        
+        /*!
+         *   @returns the number of evaluations of the i^th streaming output
+         */
+        unsigned int n_streaming_output_evaluations(unsigned int i) const;
+        
+        
+        /*!
+         *   resets the accumulated values of the streaming outputs and the
+         *   count of the time steps for the stride
+         */
+        void reset_streaming_outputs();
+        
+        
+        /*!
+         *   removes all streaming outputs
+         */
+        void clear_streaming_outputs();
+        
+        
         /*!
          *    To be used only for initial conditions.
          *    Initializes the highest derivative solution using the solution 
@@ -185,6 +509,177 @@ namespace MAST {
          */
         bool  _first_step;
         
+        /*!
+         *    solves the current time step with one linear solve, using the
+         *    operator and KSP retained from prior steps.
+         */
+        void _solve_linear_step();
+        
+        /*!
+         *    solves the current time step with the linear or nonlinear
+         *    solver, as requested
+         */
+        void _solve_step();
+        
+        /*!
+         *    solves the current time step, and repeats it with a smaller
+         *    time step until the local truncation error is acceptable
+         */
+        void _solve_adaptive_step();
+        
+        /*!
+         *    computes in \p x the explicit predictor of the solution at
+         *    the end of the current time step from the solution and its
+         *    time derivatives at the previous time step
+         */
+        virtual void _predict_solution(libMesh::NumericVector<Real>& x) = 0;
+        
+        /*!
+         *    sets the system solution to the initial guess of the current
+         *    time step
+         */
+        void _apply_predictor();
+        
+        /*!
+         *    copies the current solution to the history used by the
+         *    polynomial extrapolation
+         */
+        void _add_predictor_history();
+        
+        /*!
+         *    deletes the solution history of the polynomial extrapolation
+         */
+        void _clear_predictor_history();
+        
+        /*!
+         *    predictor of the solution of a time step, and the degree of
+         *    the polynomial extrapolation
+         */
+        MAST::TransientSolverBase::PredictorType _predictor;
+        
+        unsigned int _predictor_order;
+        
+        /*!
+         *    tolerance on the residual of the predictor to accept it as
+         *    the solution, and the number of accepted steps
+         */
+        Real  _predictor_tol;
+        
+        unsigned int _n_predictor_steps;
+        
+        /*!
+         *    times and solutions of the previous steps, with the most
+         *    recent last
+         */
+        std::deque<std::pair<Real, libMesh::NumericVector<Real>*> > _predictor_history;
+        
+        /*!
+         *    @returns the constant that scales the difference between the
+         *    solution and the predictor to the local truncation error
+         */
+        virtual Real _error_constant() const = 0;
+        
+        /*!
+         *    @returns the order \p p of the error estimate, which changes
+         *    as \f$ dt^{p+1} \f$
+         */
+        virtual unsigned int _error_order() const = 0;
+        
+        /*!
+         *    data of a streaming output
+         */
+        struct StreamingOutput {
+            
+            StreamingOutput():
+            f(nullptr), type(TIME_INTEGRAL), stride(1), n_evals(0),
+            value(0.), last_value(0.), first_time(0.), last_time(0.),
+            extreme_time(0.) { }
+            
+            MAST::TransientSolverBase::OutputEvaluation*     f;
+            MAST::TransientSolverBase::StreamingOutputType   type;
+            unsigned int                                     stride;
+            unsigned int                                     n_evals;
+            Real                                             value;
+            Real                                             last_value;
+            Real                                             first_time;
+            Real                                             last_time;
+            Real                                             extreme_time;
+        };
+        
+        /*!
+         *    evaluates the streaming outputs whose stride divides the
+         *    number of time steps, for the current solution and time
+         */
+        void _evaluate_streaming_outputs();
+        
+        /*!
+         *    reports the completed time step to MAST::solver_telemetry
+         */
+        void _report_time_step();
+        
+        /*!
+         *    streaming outputs, and the number of time steps since they
+         *    were reset
+         */
+        std::vector<StreamingOutput> _streaming_outputs;
+        
+        unsigned int _n_streaming_steps;
+        
+        /*!
+         *    number of time steps since the assembly was set, and the wall
+         *    time of the previous step, reported to MAST::solver_telemetry
+         */
+        unsigned int _n_telemetry_steps;
+        
+        std::chrono::steady_clock::time_point _telemetry_t0;
+        
+        /*!
+         *    flag to choose the time step adaptively
+         */
+        bool  _adaptive_time_step;
+        
+        /*!
+         *    tolerance on the relative local truncation error
+         */
+        Real  _dt_tol;
+        
+        /*!
+         *    bounds of the adaptive time step
+         */
+        Real  _dt_min, _dt_max;
+        
+        /*!
+         *    time step chosen for the next step after an accepted step
+         */
+        Real  _dt_next;
+        
+        /*!
+         *    number of rejected steps
+         */
+        unsigned int _n_rejected_steps;
+        
+        /*!
+         *    flag to solve the time steps as linear problems
+         */
+        bool  _linear_solve;
+        
+        /*!
+         *    time step for which the retained operator was assembled
+         */
+        Real  _linear_dt;
+        
+        /*!
+         *    copy of the effective operator of the time step. A copy is
+         *    used so that the assembly of other quantities into the system
+         *    matrix does not modify the retained factorization.
+         */
+        Mat   _linear_mat;
+        
+        /*!
+         *    KSP retained for the linear solves
+         */
+        KSP   _linear_ksp;
+        
         /*!
          *    @returns the number of iterations for which solution and velocity
          *    are to be stored.
@@ -244,6 +739,157 @@ namespace MAST {
                                        const std::vector<libMesh::dof_id_type>& dof_indices,
                                        RealVectorX& vec) = 0;
         
+        /*!
+         *   performs the element calculations over \par elem, and returns
+         *   in \par jacs[k-1] the Jacobian of the element residual with
+         *   respect to the k^th time derivative of the solution, for
+         *   k = 1, ..., ode_order(). This is used by the adjoint of the
+         *   time integration, and is not available by default.
+         */
+        virtual void
+        _elem_derivative_jacobians(MAST::ElementBase& elem,
+                                   const std::vector<libMesh::dof_id_type>& dof_indices,
+                                   std::vector<RealMatrixX>& jacs) {
+            
+            libmesh_error_msg("Error! Adjoint not implemented for this solver.");
+        }
+        
+        /*!
+         *   returns the coefficients of the update of the time derivatives
+         *   of the solution over a step of size \p dt, written as
+         *   \f[ \{d_n\}_k = c_k (X_n - X_{n-1}) + \sum_j G_{kj} \{d_{n-1}\}_j, \f]
+         *   where \f$ \{d_n\}_k \f$ is the k^th time derivative at step
+         *   \p n. This is used by the adjoint of the time integration, and
+         *   is not available by default.
+         */
+        virtual void
+        _adjoint_coefficients(Real dt,
+                              RealVectorX& c,
+                              RealMatrixX& G) const {
+            
+            libmesh_error_msg("Error! Adjoint not implemented for this solver.");
+        }
+        
+        /*!
+         *   state of the solver stored for the adjoint
+         */
+        struct AdjointSnapshot {
+            
+            AdjointSnapshot(): time(0.) { }
+            
+            ~AdjointSnapshot() {
+                for (unsigned int i=0; i<vecs.size(); i++)
+                    delete vecs[i];
+            }
+            
+            /*!
+             *   solution and its time derivatives, which are empty if the
+             *   state is on disk
+             */
+            std::vector<libMesh::NumericVector<Real>*> vecs;
+            
+            Real                                       time;
+        };
+        
+        /*!
+         *   stores the current state at level \p i of the stack
+         */
+        void _store_adjoint_snapshot(unsigned int i);
+        
+        /*!
+         *   restores the state at level \p i of the stack
+         */
+        void _restore_adjoint_snapshot(unsigned int i);
+        
+        /*!
+         *   advances the solver from step \p from to step \p to with the
+         *   recorded time steps
+         */
+        void _adjoint_advance(unsigned int from, unsigned int to);
+        
+        /*!
+         *   solves step \p n from the state of step \p n-1 in the solver.
+         *   The time step is recorded if this is the first solve of the
+         *   step, and is otherwise set to the recorded value.
+         */
+        void _adjoint_solve_step(unsigned int n);
+        
+        /*!
+         *   solves the adjoint of steps \p to, ..., \p from+1 in reverse
+         *   order, starting from the state of step \p from, which is in the
+         *   solver and at level \p level of the stack, with \p n_free
+         *   free levels above it
+         */
+        void _adjoint_sweep(unsigned int from,
+                            unsigned int to,
+                            unsigned int level,
+                            unsigned int n_free);
+        
+        /*!
+         *   solves step \p n from the state of step \p n-1 in the solver,
+         *   and then the adjoint of the step. \p n = 0 solves the adjoint
+         *   of the initial highest derivative solve.
+         */
+        void _adjoint_step(unsigned int n);
+        
+        /*!
+         *   solves \f$ [J]^T \{\lambda\} = \{b\} \f$ with the Jacobian of
+         *   the current step, or of the highest derivative solve if
+         *   \p if_highest_derivative is true
+         */
+        void _adjoint_transpose_solve(libMesh::NumericVector<Real>& b,
+                                      libMesh::NumericVector<Real>& lambda,
+                                      bool if_highest_derivative);
+        
+        /*!
+         *   number of states stored in memory and on disk by the adjoint,
+         *   and the prefix of the files
+         */
+        unsigned int  _n_memory_snapshots, _n_disk_snapshots;
+        
+        std::string   _snapshot_prefix;
+        
+        /*!
+         *   stack of stored states
+         */
+        std::vector<AdjointSnapshot*>               _snapshots;
+        
+        /*!
+         *   time steps of the forward pass, where \p _adjoint_dt[n-1] is
+         *   the time step of step \p n
+         */
+        std::vector<Real>                           _adjoint_dt;
+        
+        /*!
+         *   time of the initial condition
+         */
+        Real                                        _adjoint_t0;
+        
+        /*!
+         *   adjoint variables of the updates of the time derivatives of
+         *   the last solved adjoint step
+         */
+        std::vector<libMesh::NumericVector<Real>*>  _adjoint_mu;
+        
+        /*!
+         *   output, parameters and sensitivities of the current adjoint
+         */
+        MAST::OutputAssemblyBase*                   _adjoint_output;
+        
+        const libMesh::ParameterVector*             _adjoint_params;
+        
+        std::vector<Real>*                          _adjoint_sens;
+        
+        /*!
+         *   KSP of the transposed solves
+         */
+        KSP                                         _adjoint_ksp;
+        
+        /*!
+         *   number of forward steps solved by the last adjoint
+         */
+        unsigned int                                _n_adjoint_steps;
+        
         /*!
          *   Associated TransientAssembly object that provides the 
          *   element level quantities
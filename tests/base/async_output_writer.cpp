@@ -0,0 +1,149 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2017  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+// C++ includes
+#include <string>
+
+
+// BOOST includes
+#include <boost/test/unit_test.hpp>
+
+
+// MAST includes
+#include "base/async_output_writer.h"
+#include "tests/base/test_comparisons.h"
+
+
+// libMesh includes
+#include "libmesh/libmesh.h"
+#include "libmesh/replicated_mesh.h"
+#include "libmesh/mesh_generation.h"
+#include "libmesh/equation_systems.h"
+#include "libmesh/explicit_system.h"
+#include "libmesh/exodusII_io.h"
+#include "libmesh/numeric_vector.h"
+
+
+extern libMesh::LibMeshInit* __init;
+
+
+namespace {
+    
+    // nodal value of file f at time t, which is linear in the coordinates
+    // so that it does not depend on the node numbering of the file
+    Real async_output_value(unsigned int f, const libMesh::Point& p, Real t) {
+        
+        return f? (3.*p(0) - p(1) + 10.*t): (p(0) + 2.*p(1) + t);
+    }
+    
+    
+    void async_output_set_solution(libMesh::ExplicitSystem& sys,
+                                   unsigned int f,
+                                   Real t) {
+        
+        libMesh::MeshBase::const_node_iterator
+        it   = sys.get_mesh().local_nodes_begin(),
+        end  = sys.get_mesh().local_nodes_end();
+        
+        for ( ; it != end; it++)
+            sys.solution->set((*it)->dof_number(sys.number(), 0, 0),
+                              async_output_value(f, **it, t));
+        
+        sys.solution->close();
+        sys.update();
+    }
+}
+
+
+
+BOOST_AUTO_TEST_SUITE  (AsyncOutputWriterExodus)
+
+BOOST_AUTO_TEST_CASE   (AlternatingFiles) {
+    
+    // time steps are added to two files alternately, so that the first
+    // step of the second file is written while the I/O thread may still
+    // be writing the first file
+    const unsigned int
+    n_steps  = 4;
+    
+    const Real
+    tol      = 1.e-10;
+    
+    const std::string
+    fnames[] = {"async_output_0.exo", "async_output_1.exo"};
+    
+    {
+        libMesh::ReplicatedMesh mesh(__init->comm());
+        libMesh::MeshTools::Generation::build_square(mesh, 4, 4);
+        
+        libMesh::EquationSystems eq_sys(mesh);
+        libMesh::ExplicitSystem&
+        sys = eq_sys.add_system<libMesh::ExplicitSystem>("sys");
+        sys.add_variable("u", libMesh::FIRST);
+        eq_sys.init();
+        
+        MAST::AsyncOutputWriter writer(__init->comm());
+        
+        for (unsigned int i=0; i<n_steps; i++)
+            for (unsigned int f=0; f<2; f++) {
+                
+                async_output_set_solution(sys, f, i);
+                writer.write_exodus_timestep(fnames[f], eq_sys, i);
+            }
+        
+        writer.flush();
+    }
+    
+    // read the files and compare the nodal values of all time steps
+    for (unsigned int f=0; f<2; f++) {
+        
+        libMesh::ReplicatedMesh mesh(__init->comm());
+        libMesh::ExodusII_IO io(mesh);
+        io.read(fnames[f]);
+        mesh.prepare_for_use();
+        
+        libMesh::EquationSystems eq_sys(mesh);
+        libMesh::ExplicitSystem&
+        sys = eq_sys.add_system<libMesh::ExplicitSystem>("sys");
+        sys.add_variable("u", libMesh::FIRST);
+        eq_sys.init();
+        
+        BOOST_CHECK_EQUAL(io.get_num_time_steps(), (int)n_steps);
+        
+        for (unsigned int i=0; i<n_steps; i++) {
+            
+            io.copy_nodal_solution(sys, "u", "u", i+1);
+            sys.update();
+            
+            libMesh::MeshBase::const_node_iterator
+            it   = mesh.local_nodes_begin(),
+            end  = mesh.local_nodes_end();
+            
+            for ( ; it != end; it++)
+                BOOST_CHECK(MAST::compare_value
+                            (async_output_value(f, **it, i),
+                             (*sys.current_local_solution)
+                             ((*it)->dof_number(sys.number(), 0, 0)),
+                             tol));
+        }
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
@@ -0,0 +1,289 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2017  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+// C++ includes
+#include <cstdlib>
+#include <new>
+#include <atomic>
+#include <fstream>
+#include <sstream>
+#include <map>
+#include <vector>
+#include <limits>
+
+// BOOST includes
+#include <boost/test/unit_test.hpp>
+
+// MAST includes
+#include "tests/base/performance_check.h"
+
+// libMesh includes
+#include "libmesh/libmesh.h"
+
+
+extern libMesh::LibMeshInit* __init;
+
+
+#ifdef MAST_COUNT_ALLOCATIONS
+
+namespace {
+    
+    std::atomic<unsigned long long> n_counted_allocations(0);
+    
+    
+    inline void*
+    counted_malloc(std::size_t n) {
+        
+        n_counted_allocations.fetch_add(1, std::memory_order_relaxed);
+        return std::malloc(n? n: 1);
+    }
+}
+
+
+// the allocation functions of the test executable are replaced to count
+// the allocations of the library and of its dependencies. This is only
+// compiled if mast_tests is configured with ENABLE_ALLOCATION_COUNTING.
+void* operator new(std::size_t n) {
+    
+    void* p = counted_malloc(n);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+
+
+void* operator new[](std::size_t n) {
+    
+    void* p = counted_malloc(n);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+
+
+void* operator new(std::size_t n, const std::nothrow_t&) noexcept {
+    
+    return counted_malloc(n);
+}
+
+
+void* operator new[](std::size_t n, const std::nothrow_t&) noexcept {
+    
+    return counted_malloc(n);
+}
+
+
+void operator delete(void* p) noexcept                          { std::free(p); }
+void operator delete[](void* p) noexcept                        { std::free(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept   { std::free(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { std::free(p); }
+
+#endif // MAST_COUNT_ALLOCATIONS
+
+
+
+bool
+MAST::if_count_allocations() {
+    
+#ifdef MAST_COUNT_ALLOCATIONS
+    return true;
+#else
+    return false;
+#endif
+}
+
+
+
+unsigned long long
+MAST::n_global_allocations() {
+    
+#ifdef MAST_COUNT_ALLOCATIONS
+    return n_counted_allocations.load(std::memory_order_relaxed);
+#else
+    return 0;
+#endif
+}
+
+
+
+MAST::PerformanceCheck::PerformanceCheck(const std::string& nm,
+                                         Real time_tol,
+                                         Real alloc_tol):
+_nm          (nm),
+_time_tol    (time_tol),
+_alloc_tol   (alloc_tol),
+_n_samples   (0),
+_wall_time   (0.),
+_n_allocs    (0),
+_n_allocs0   (0) {
+    
+}
+
+
+
+void
+MAST::PerformanceCheck::start() {
+    
+    __init->comm().barrier();
+    _n_allocs0 = MAST::n_global_allocations();
+    _t0        = std::chrono::steady_clock::now();
+}
+
+
+
+void
+MAST::PerformanceCheck::stop() {
+    
+    __init->comm().barrier();
+
+    Real
+    t   = std::chrono::duration<Real>(std::chrono::steady_clock::now() - _t0).count();
+    unsigned long long
+    n   = MAST::n_global_allocations() - _n_allocs0;
+
+    // the slowest processor determines the time of the sample
+    __init->comm().max(t);
+    __init->comm().max(n);
+    
+    if (!_n_samples || t < _wall_time) _wall_time = t;
+    if (!_n_samples || n < _n_allocs)  _n_allocs  = n;
+    _n_samples++;
+}
+
+
+
+bool
+MAST::PerformanceCheck::check() const {
+    
+    libmesh_assert(_n_samples);
+    
+    const std::string
+    fname = _baseline_file();
+    
+    // read the baselines of all tests
+    std::map<std::string, std::pair<Real, unsigned long long> > baselines;
+    std::vector<std::string> comments;
+    {
+        std::ifstream in(fname.c_str());
+        std::string   line, nm;
+        Real          t = 0.;
+        unsigned long long n = 0;
+        
+        while (std::getline(in, line)) {
+            
+            if (line.empty() || line[0] == '#') {
+                comments.push_back(line);
+                continue;
+            }
+            
+            std::istringstream s(line);
+            if (s >> nm >> t >> n)
+                baselines[nm] = std::make_pair(t, n);
+        }
+    }
+    
+    BOOST_TEST_MESSAGE("  ** " << _nm
+                       << " : time = " << _wall_time
+                       << " s, allocations = " << _n_allocs << " **");
+    
+    if (std::getenv("MAST_PERF_UPDATE")) {
+        
+        // the stored number of allocations is retained if these are
+        // not counted
+        if (MAST::if_count_allocations() ||
+            !baselines.count(_nm))
+            baselines[_nm] = std::make_pair(_wall_time, _n_allocs);
+        else
+            baselines[_nm].first = _wall_time;
+        
+        if (__init->comm().rank() == 0) {
+            
+            std::ofstream out(fname.c_str());
+            if (!out.good())
+                libmesh_error_msg("Unable to open file: " << fname);
+
+            for (unsigned int i=0; i<comments.size(); i++)
+                out << comments[i] << std::endl;
+            out.precision(std::numeric_limits<Real>::digits10);
+
+            std::map<std::string, std::pair<Real, unsigned long long> >::const_iterator
+            it  = baselines.begin(),
+            end = baselines.end();
+            
+            for ( ; it != end; it++)
+                out
+                << it->first << "  "
+                << it->second.first << "  "
+                << it->second.second << std::endl;
+        }
+        
+        BOOST_TEST_MESSAGE("  ** Updated baseline in " << fname << " **");
+        return true;
+    }
+    
+    std::map<std::string, std::pair<Real, unsigned long long> >::const_iterator
+    it = baselines.find(_nm);
+    
+    if (it == baselines.end()) {
+        
+        BOOST_TEST_MESSAGE("  ** No baseline for " << _nm << " in " << fname
+                           << ", set MAST_PERF_UPDATE to record it **");
+        return true;
+    }
+    
+    bool pass = true;
+    
+    const Real
+    t0  = it->second.first;
+    const unsigned long long
+    n0  = it->second.second;
+    
+    if (_wall_time > t0 * (1. + _time_tol)) {
+        
+        BOOST_TEST_MESSAGE("Time regression: "
+                           << "baseline: " << t0 << "  , "
+                           << "measured: " << _wall_time << " : "
+                           << "tol: " << _time_tol);
+        pass = false;
+    }
+    
+    // the allocations are compared only if they are counted, and if the
+    // baseline was recorded with the count
+    if (MAST::if_count_allocations() &&
+        n0                           &&
+        _n_allocs > n0 * (1. + _alloc_tol)) {
+        
+        BOOST_TEST_MESSAGE("Allocation regression: "
+                           << "baseline: " << n0 << "  , "
+                           << "measured: " << _n_allocs << " : "
+                           << "tol: " << _alloc_tol);
+        pass = false;
+    }
+    
+    return pass;
+}
+
+
+
+std::string
+MAST::PerformanceCheck::_baseline_file() {
+    
+    const char* f = std::getenv("MAST_PERF_BASELINES");
+    
+    return f? std::string(f): std::string("performance_baselines.txt");
+}
+
@@ -0,0 +1,158 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2017  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef __mast_test_performance_check_h__
+#define __mast_test_performance_check_h__
+
+// C++ includes
+#include <string>
+#include <chrono>
+
+// MAST includes
+#include "base/mast_data_types.h"
+
+
+namespace MAST {
+    
+    /*!
+     *   @returns \p true if the allocations are counted. This requires
+     *   mast_tests to be configured with \p ENABLE_ALLOCATION_COUNTING,
+     *   which defines \p MAST_COUNT_ALLOCATIONS.
+     */
+    bool
+    if_count_allocations();
+    
+    
+    /*!
+     *   @returns the number of calls to the global \p operator \p new in
+     *   this process since it was started, or zero if the allocations are
+     *   not counted. The global allocation functions are replaced in
+     *   performance_check.cpp to keep this count, but only if
+     *   if_count_allocations() is \p true, so that the default test
+     *   executable uses the standard allocation functions.
+     */
+    unsigned long long
+    n_global_allocations();
+    
+    
+    /*!
+     *   Records the wall time and the number of allocations of a section of
+     *   a performance test and compares them against a stored baseline. A
+     *   sample is recorded between each pair of start() and stop() calls,
+     *   and the minimum over the samples is used for the comparison, which
+     *   reduces the influence of the first-call initializations and of the
+     *   noise of the machine.
+     *
+     *   The baselines are read from the file given by the environment
+     *   variable \p MAST_PERF_BASELINES, or from
+     *   \p performance_baselines.txt in the working directory. Each line
+     *   of the file stores the name of a test, its wall time in seconds and
+     *   its number of allocations. If \p MAST_PERF_UPDATE is set, check()
+     *   writes the measured values to the file instead of comparing them.
+     *   A test without a baseline passes with a message. The number of
+     *   allocations is compared only if if_count_allocations() is
+     *   \p true and the baseline has a nonzero count.
+     */
+    class PerformanceCheck {
+        
+    public:
+        
+        /*!
+         *   \p time_tol and \p alloc_tol are the relative increase of the
+         *   wall time and of the number of allocations over the baseline
+         *   that are accepted.
+         */
+        PerformanceCheck(const std::string& nm,
+                         Real time_tol  = 0.25,
+                         Real alloc_tol = 0.05);
+        
+        
+        /*!
+         *   starts a sample
+         */
+        void start();
+        
+        
+        /*!
+         *   ends the sample started with start()
+         */
+        void stop();
+        
+        
+        /*!
+         *   @returns the minimum wall time of the samples
+         */
+        Real wall_time() const {
+            return _wall_time;
+        }
+        
+        
+        /*!
+         *   @returns the minimum number of allocations of the samples
+         */
+        unsigned long long n_allocations() const {
+            return _n_allocs;
+        }
+        
+        
+        /*!
+         *   compares the recorded values with the baseline, or updates the
+         *   baseline if requested. @returns false if either value exceeds
+         *   the baseline by more than its tolerance.
+         */
+        bool check() const;
+        
+        
+    protected:
+        
+        /*!
+         *   @returns the name of the baseline file
+         */
+        static std::string _baseline_file();
+        
+        
+        /*!
+         *   name of the test in the baseline file
+         */
+        const std::string  _nm;
+        
+        /*!
+         *   tolerances on the wall time and on the number of allocations
+         */
+        const Real         _time_tol, _alloc_tol;
+        
+        /*!
+         *   number of samples, and the minimum values of the samples
+         */
+        unsigned int       _n_samples;
+        
+        Real               _wall_time;
+        
+        unsigned long long _n_allocs;
+        
+        /*!
+         *   values at the start of the current sample
+         */
+        std::chrono::steady_clock::time_point _t0;
+        
+        unsigned long long _n_allocs0;
+    };
+}
+
+#endif // __mast_test_performance_check_h__
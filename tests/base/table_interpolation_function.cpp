@@ -0,0 +1,217 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2017  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+// C++ includes
+#include <map>
+#include <vector>
+
+// BOOST includes
+#include <boost/test/unit_test.hpp>
+
+
+// MAST includes
+#include "base/table_interpolation_function.h"
+#include "base/constant_field_function.h"
+#include "base/parameter.h"
+#include "tests/base/test_comparisons.h"
+
+
+namespace {
+    
+    /*!
+     *   function equal to the y-coordinate, which is independent of
+     *   all parameters
+     */
+    class YCoordinateFunction:
+    public MAST::FieldFunction<Real> {
+        
+    public:
+        
+        YCoordinateFunction():
+        MAST::FieldFunction<Real>("y")
+        { }
+        
+        virtual void operator() (const libMesh::Point& p,
+                                 const Real t,
+                                 Real& v) const {
+            v = p(1);
+        }
+        
+        virtual void derivative (const MAST::FunctionBase& f,
+                                 const libMesh::Point& p,
+                                 const Real t,
+                                 Real& v) const {
+            v = 0.;
+        }
+    };
+    
+    
+    /*!
+     *   evaluates \p f at \p x, at one point and at all points, and
+     *   checks both against \p v0. The derivative with respect to
+     *   \p p is checked against \p dv0 in the same way.
+     */
+    void
+    check_table(const MAST::TableInterpolationFunction& f,
+                const MAST::Parameter& p,
+                const std::vector<Real>& x,
+                const Real y,
+                const RealVectorX& v0,
+                const RealVectorX& dv0) {
+        
+        const unsigned int
+        n = (unsigned int)x.size();
+        
+        std::vector<libMesh::Point>
+        pts(n);
+        
+        for (unsigned int i=0; i<n; i++)
+            pts[i] = libMesh::Point(x[i], y, 0.);
+        
+        RealVectorX
+        v    = RealVectorX::Zero(n),
+        dv   = RealVectorX::Zero(n);
+        
+        std::vector<Real>
+        vv,
+        dvv;
+        
+        for (unsigned int i=0; i<n; i++) {
+            f(pts[i], 0., v(i));
+            f.derivative(p, pts[i], 0., dv(i));
+        }
+        
+        BOOST_CHECK(MAST::compare_vector(v0,  v, 1.e-12));
+        BOOST_CHECK(MAST::compare_vector(dv0, dv, 1.e-12));
+        
+        f(pts, 0., vv);
+        f.derivative(p, pts, 0., dvv);
+        
+        BOOST_REQUIRE_EQUAL(vv.size(),  n);
+        BOOST_REQUIRE_EQUAL(dvv.size(), n);
+        
+        for (unsigned int i=0; i<n; i++) {
+            v(i)  = vv[i];
+            dv(i) = dvv[i];
+        }
+        
+        BOOST_CHECK(MAST::compare_vector(v0,  v, 1.e-12));
+        BOOST_CHECK(MAST::compare_vector(dv0, dv, 1.e-12));
+    }
+}
+
+
+
+BOOST_AUTO_TEST_SUITE  (TableInterpolationFunction)
+
+BOOST_AUTO_TEST_CASE   (ConstantBreakpoints) {
+    
+    // the table is 1 at x = 0, 3 at x = 1 and 2 at x = 3
+    MAST::Parameter
+    p0("p0", 1.),
+    p1("p1", 3.),
+    p2("p2", 2.);
+    
+    MAST::ConstantFieldFunction
+    f0("f", p0),
+    f1("f", p1),
+    f2("f", p2);
+    
+    std::map<Real, MAST::FieldFunction<Real>*>
+    values;
+    
+    values[3.] = &f2;
+    values[0.] = &f0;
+    values[1.] = &f1;
+    
+    MAST::TableInterpolationFunction
+    f("f", values);
+    
+    BOOST_CHECK_EQUAL(f.n_breakpoints(), 3);
+    
+    // points at, between and outside of the breakpoints, out of order
+    // so that the search does not only use the interval of the previous
+    // point
+    const Real
+    x_vals[] = {0., 1., 3., 0.5, 2., 2.5, 0.25, -1., 5.};
+    
+    std::vector<Real>
+    x(x_vals, x_vals+9);
+    
+    RealVectorX
+    v0   = RealVectorX::Zero(9),
+    dv0  = RealVectorX::Zero(9);
+    
+    v0  <<  1., 3., 2., 2., 2.5, 2.25, 1.5, 1., 2.;
+    
+    // derivative with respect to the value at x = 1
+    dv0 <<  0., 1., 0., 0.5, 0.5, 0.25, 0.25, 0., 0.;
+    
+    check_table(f, p1, x, 0., v0, dv0);
+}
+
+
+
+BOOST_AUTO_TEST_CASE   (FieldFunctionBreakpoints) {
+    
+    // the function at x = 1 is the y-coordinate, so that the values
+    // are not only read from the parameters
+    MAST::Parameter
+    p0("p0", 1.),
+    p2("p2", 2.);
+    
+    MAST::ConstantFieldFunction
+    f0("f", p0),
+    f2("f", p2);
+    
+    YCoordinateFunction
+    f1;
+    
+    std::map<Real, MAST::FieldFunction<Real>*>
+    values;
+    
+    values[0.] = &f0;
+    values[1.] = &f1;
+    values[3.] = &f2;
+    
+    MAST::TableInterpolationFunction
+    f("f", values);
+    
+    const Real
+    x_vals[] = {0., 1., 3., 0.5, 2., -1., 5.};
+    
+    std::vector<Real>
+    x(x_vals, x_vals+7);
+    
+    RealVectorX
+    v0   = RealVectorX::Zero(7),
+    dv0  = RealVectorX::Zero(7);
+    
+    // y = 3, so that this is the same table as above
+    v0  <<  1., 3., 2., 2., 2.5, 1., 2.;
+    
+    // derivative with respect to the value at x = 0
+    dv0 <<  1., 0., 0., 0.5, 0., 1., 0.;
+    
+    check_table(f, p0, x, 3., v0, dv0);
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
+
@@ -0,0 +1,223 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2017  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+// C++ includes
+#include <vector>
+
+
+// BOOST includes
+#include <boost/test/unit_test.hpp>
+
+
+// MAST includes
+#include "examples/fluid/panel_small_disturbance_frequency_domain_analysis_2D/panel_small_disturbance_frequency_domain_analysis_2d.h"
+#include "fluid/frequency_domain_linearized_complex_assembly.h"
+#include "fluid/conservative_fluid_system_initialization.h"
+#include "aeroelasticity/frequency_function.h"
+#include "solver/complex_solver_base.h"
+#include "base/nonlinear_system.h"
+#include "base/parameter.h"
+#include "tests/base/test_comparisons.h"
+
+// libMesh includes
+#include "libmesh/numeric_vector.h"
+
+
+namespace {
+    
+    // copies the entries of v to a RealVectorX
+    RealVectorX
+    frequency_domain_vector_values(const libMesh::NumericVector<Real>& v) {
+        
+        RealVectorX
+        vals = RealVectorX::Zero(v.size());
+        
+        for (unsigned int i=0; i<v.size(); i++)
+            vals(i) = v(i);
+        
+        return vals;
+    }
+    
+    
+    // initializes the uniform flow base solution of the panel, and
+    // attaches the assembly and solver to the fluid system
+    void
+    frequency_domain_init_solve(MAST::PanelInviscidSmallDisturbanceFrequencyDomain2DAnalysis& a,
+                                MAST::FrequencyDomainLinearizedComplexAssembly& assembly,
+                                MAST::ComplexSolverBase& solver) {
+        
+        RealVectorX s = RealVectorX::Zero(4);
+        s(0) = a._flight_cond->rho();
+        s(1) = a._flight_cond->rho_u1();
+        s(2) = a._flight_cond->rho_u2();
+        s(3) = a._flight_cond->rho_e();
+        
+        libMesh::NumericVector<Real>& base_sol =
+        a._sys->add_vector("fluid_base_solution");
+        a._sys->solution->swap(base_sol);
+        a._fluid_sys->initialize_solution(s);
+        a._sys->solution->swap(base_sol);
+        
+        assembly.attach_discipline_and_system(*a._discipline,
+                                              solver,
+                                              *a._fluid_sys);
+        assembly.set_base_solution(base_sol);
+        assembly.set_frequency_function(*a._freq_function);
+    }
+}
+
+
+
+BOOST_FIXTURE_TEST_SUITE  (FrequencyDomainComplexSolves,
+                           MAST::PanelInviscidSmallDisturbanceFrequencyDomain2DAnalysis)
+
+BOOST_AUTO_TEST_CASE   (MultiFrequencySolve) {
+    
+    // both solves converge to the tolerance of the Krylov solver
+    const Real
+    tol      = 1.e-4;
+    
+    const Real
+    omegas[] = {50., 100., 150.};
+    
+    const unsigned int
+    n_freq   = 3;
+    
+    MAST::FrequencyDomainLinearizedComplexAssembly   assembly;
+    MAST::ComplexSolverBase                          solver;
+    
+    frequency_domain_init_solve(*this, assembly, solver);
+    
+    // solutions for each frequency with a separate solve, and the values
+    // of the frequency function for the multi-frequency solve
+    std::vector<RealVectorX>
+    sol_re(n_freq),
+    sol_im(n_freq);
+    
+    std::vector<Real>
+    freq(n_freq, 0.);
+    
+    for (unsigned int i=0; i<n_freq; i++) {
+        
+        (*_omega) = omegas[i];
+        (*_freq_function)(freq[i]);
+        
+        solver.solve_block_matrix();
+        
+        sol_re[i] = frequency_domain_vector_values(solver.real_solution());
+        sol_im[i] = frequency_domain_vector_values(solver.imag_solution());
+    }
+    
+    std::vector<libMesh::NumericVector<Real>*>
+    multi_re(n_freq, nullptr),
+    multi_im(n_freq, nullptr);
+    
+    for (unsigned int i=0; i<n_freq; i++) {
+        
+        multi_re[i] = solver.real_solution().zero_clone().release();
+        multi_im[i] = solver.imag_solution().zero_clone().release();
+    }
+    
+    solver.solve_block_matrix_multi_frequency(freq, multi_re, multi_im);
+    
+    for (unsigned int i=0; i<n_freq; i++) {
+        
+        BOOST_TEST_MESSAGE("  ** real solution at omega = " << omegas[i] << " **");
+        BOOST_CHECK(MAST::compare_vector(sol_re[i],
+                                         frequency_domain_vector_values(*multi_re[i]),
+                                         tol));
+        
+        BOOST_TEST_MESSAGE("  ** imag solution at omega = " << omegas[i] << " **");
+        BOOST_CHECK(MAST::compare_vector(sol_im[i],
+                                         frequency_domain_vector_values(*multi_im[i]),
+                                         tol));
+        
+        delete multi_re[i];
+        delete multi_im[i];
+    }
+    
+    assembly.clear_discipline_and_system();
+}
+
+
+
+BOOST_AUTO_TEST_CASE   (ComplexMatrixSolve) {
+    
+    // the complex matrix is factored with a serial sparse LU
+    // decomposition, and is not available on more than one processor
+    if (_sys->comm().size() > 1) {
+        
+        BOOST_TEST_MESSAGE("  ** complex matrix solve is serial only: skipped **");
+        return;
+    }
+    
+    // the block solve converges to the tolerance of the Krylov solver
+    const Real
+    tol      = 1.e-4;
+    
+    MAST::FrequencyDomainLinearizedComplexAssembly   assembly;
+    MAST::ComplexSolverBase                          solver;
+    
+    frequency_domain_init_solve(*this, assembly, solver);
+    
+    (*_omega) = 100.;
+    
+    // solution and its sensitivity with the 2x2 real block matrix
+    solver.use_complex_matrix = false;
+    solver.solve_block_matrix();
+    solver.solve_block_matrix(_omega);
+    
+    const RealVectorX
+    sol_re  = frequency_domain_vector_values(solver.real_solution()),
+    sol_im  = frequency_domain_vector_values(solver.imag_solution()),
+    dsol_re = frequency_domain_vector_values(solver.real_solution(true)),
+    dsol_im = frequency_domain_vector_values(solver.imag_solution(true));
+    
+    // the same with the complex matrix, which is used by
+    // solve_block_matrix() in serial runs
+    solver.use_complex_matrix = true;
+    solver.solve_block_matrix();
+    
+    BOOST_TEST_MESSAGE("  ** real solution **");
+    BOOST_CHECK(MAST::compare_vector(sol_re,
+                                     frequency_domain_vector_values(solver.real_solution()),
+                                     tol));
+    
+    BOOST_TEST_MESSAGE("  ** imag solution **");
+    BOOST_CHECK(MAST::compare_vector(sol_im,
+                                     frequency_domain_vector_values(solver.imag_solution()),
+                                     tol));
+    
+    solver.solve_block_matrix(_omega);
+    
+    BOOST_TEST_MESSAGE("  ** real solution sensitivity **");
+    BOOST_CHECK(MAST::compare_vector(dsol_re,
+                                     frequency_domain_vector_values(solver.real_solution(true)),
+                                     tol));
+    
+    BOOST_TEST_MESSAGE("  ** imag solution sensitivity **");
+    BOOST_CHECK(MAST::compare_vector(dsol_im,
+                                     frequency_domain_vector_values(solver.imag_solution(true)),
+                                     tol));
+    
+    assembly.clear_discipline_and_system();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
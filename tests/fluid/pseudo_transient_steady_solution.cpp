@@ -0,0 +1,147 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2017  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+// BOOST includes
+#include <boost/test/unit_test.hpp>
+
+
+// MAST includes
+#include "examples/fluid/panel_inviscid_analysis_2D/panel_inviscid_analysis_2d.h"
+#include "fluid/conservative_fluid_system_initialization.h"
+#include "fluid/conservative_fluid_discipline.h"
+#include "fluid/conservative_fluid_transient_assembly.h"
+#include "fluid/flight_condition.h"
+#include "solver/pseudo_transient_solver.h"
+#include "base/nonlinear_system.h"
+#include "tests/base/test_comparisons.h"
+
+// libMesh includes
+#include "libmesh/numeric_vector.h"
+
+
+namespace {
+    
+    // exposes the element time steps of the solver
+    struct PseudoTransientSolverLocalDt:
+    public MAST::PseudoTransientSolver {
+        
+        using MAST::PseudoTransientSolver::_elem_dt;
+    };
+    
+    
+    // solves for the steady flow over the bump and returns the solution
+    void
+    solve_steady_flow(MAST::PanelInviscidAnalysis2D& panel,
+                      bool local_time_step,
+                      RealVectorX& sol) {
+        
+        // the freestream is the initial solution
+        RealVectorX s = RealVectorX::Zero(4);
+        s(0) = panel._flight_cond->rho();
+        s(1) = panel._flight_cond->rho_u1();
+        s(2) = panel._flight_cond->rho_u2();
+        s(3) = panel._flight_cond->rho_e();
+        panel._fluid_sys->initialize_solution(s);
+        
+        MAST::ConservativeFluidTransientAssembly   assembly;
+        PseudoTransientSolverLocalDt               solver;
+        
+        assembly.attach_discipline_and_system(*panel._discipline,
+                                              solver,
+                                              *panel._fluid_sys);
+        
+        solver.dt              = panel._time_step_size;
+        solver.beta            = 1.;
+        solver.initial_cfl     = 10.;
+        solver.local_time_step = local_time_step;
+        
+        // zero velocity at the initial solution
+        solver.solution(1).zero();
+        solver.solution(1).add(1., solver.solution());
+        solver.solution(1).close();
+        
+        const unsigned int
+        n_elems = panel._mesh->n_active_local_elem();
+        
+        // the first pseudo time step computes the time step of all
+        // elements in the entries created before the assembly
+        solver.reset();
+        solver.solve();
+        solver.advance_time_step();
+        
+        BOOST_CHECK_EQUAL(solver._elem_dt.size(), n_elems);
+        
+        std::map<const libMesh::Elem*, Real>::const_iterator
+        it   = solver._elem_dt.begin(),
+        end  = solver._elem_dt.end();
+        
+        for ( ; it != end; it++)
+            BOOST_CHECK(it->second > 0. || !local_time_step);
+        
+        // now march to the steady state
+        const bool
+        converged = solver.solve_to_steady_state(200, 1.e-6, 1.e-10);
+        
+        BOOST_TEST_MESSAGE("  ** local dt = " << local_time_step
+                           << " : CFL = " << solver.cfl()
+                           << " , residual = " << solver.steady_residual_norm()
+                           << " **");
+        BOOST_REQUIRE(converged);
+        
+        // the residual reduction increases the CFL number
+        BOOST_CHECK(solver.cfl() > solver.initial_cfl);
+        
+        // the entries of the next step are created for all local elements
+        BOOST_CHECK_EQUAL(solver._elem_dt.size(), n_elems);
+        
+        // copy the solution
+        std::vector<Real> v;
+        panel._sys->solution->localize(v);
+        
+        sol = RealVectorX::Zero(v.size());
+        for (unsigned int i=0; i<v.size(); i++)
+            sol(i) = v[i];
+        
+        assembly.clear_discipline_and_system();
+    }
+}
+
+
+
+BOOST_FIXTURE_TEST_SUITE  (PanelPseudoTransientSteadySolution,
+                           MAST::PanelInviscidAnalysis2D)
+
+BOOST_AUTO_TEST_CASE   (LocalTimeStepConvergence) {
+    
+    // the steady solution does not depend on the pseudo time steps, so
+    // the element-local time steps must converge to the same solution
+    // as the uniform time step.
+    RealVectorX
+    sol_local,
+    sol_global;
+    
+    solve_steady_flow(*this,  true, sol_local);
+    solve_steady_flow(*this, false, sol_global);
+    
+    BOOST_CHECK(MAST::compare_vector(sol_global, sol_local, 1.e-4));
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
+
@@ -0,0 +1,139 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2017  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+// BOOST includes
+#include <boost/test/unit_test.hpp>
+
+
+// MAST includes
+#include "aeroelasticity/flutter_solver_base.h"
+#include "tests/base/test_comparisons.h"
+
+
+namespace {
+    
+    // exposes the eigenpair tracking helpers used by the UG root search
+    struct FlutterEigenpairTracking:
+    public MAST::FlutterSolverBase {
+        
+        using MAST::FlutterSolverBase::_refine_eigenpair;
+        using MAST::FlutterSolverBase::_modal_assurance_criterion;
+    };
+}
+
+
+
+BOOST_AUTO_TEST_SUITE  (FlutterEigenpairTracking)
+
+BOOST_AUTO_TEST_CASE   (RefineEigenpair) {
+    
+    const unsigned int
+    n        = 4;
+    
+    const Real
+    tol      = 1.e-8;
+    
+    const Complex
+    iota(0., 1.);
+    
+    // A = B V D V^{-1}, so that the eigenvalues of A x = lambda B x are
+    // the diagonal of D, and the right eigenvectors are the columns of V
+    ComplexMatrixX
+    V  = ComplexMatrixX::Identity(n, n),
+    D  = ComplexMatrixX::Zero(n, n),
+    B  = ComplexMatrixX::Identity(n, n),
+    A;
+    
+    for (unsigned int i=0; i<n; i++)
+        for (unsigned int j=0; j<n; j++)
+            if (i != j)
+                V(i, j) = 0.1*(i+1.) + 0.05*iota*(j+1.);
+    
+    D(0, 0) = 1. + 0.5*iota;
+    D(1, 1) = 2.;
+    D(2, 2) = 3. - 1.*iota;
+    D(3, 3) = 4. + 2.*iota;
+    
+    B.diagonal() *= 2.;
+    A = B * V * D * V.inverse();
+    
+    // perturbed guess of the second eigenpair
+    Complex
+    lambda   = 2.05 + 0.02*iota;
+    
+    ComplexVectorX
+    x        = V.col(1) + 0.05*(V.col(0) + V.col(2)),
+    y        = x;
+    
+    BOOST_CHECK(FlutterEigenpairTracking::_refine_eigenpair(A, B,
+                                                            lambda,
+                                                            x, y,
+                                                            tol, 20));
+    
+    BOOST_CHECK(MAST::compare_value(D(1, 1).real(), lambda.real(), 1.e-6));
+    BOOST_CHECK(MAST::is_numerical_zero(lambda.imag(), 1.e-6));
+    BOOST_CHECK_LE((A*x - lambda*(B*x)).norm(), 1.e-6 * (A*x).norm());
+    
+    // the right eigenvector is parallel to the exact one
+    BOOST_CHECK(MAST::compare_value
+                (1., FlutterEigenpairTracking::_modal_assurance_criterion(x, V.col(1)),
+                 1.e-6));
+    
+    // the left eigenvector satisfies y^H A = lambda y^H B
+    BOOST_CHECK_LE((A.adjoint()*y - std::conj(lambda)*(B.adjoint()*y)).norm(),
+                   1.e-6 * (A.adjoint()*y).norm());
+}
+
+
+
+BOOST_AUTO_TEST_CASE   (ModalAssuranceCriterion) {
+    
+    const Complex
+    iota(0., 1.);
+    
+    ComplexVectorX
+    x1 = ComplexVectorX::Zero(3),
+    x2 = ComplexVectorX::Zero(3);
+    
+    x1(0) = 1.;
+    x1(1) = iota;
+    
+    // scaled copy is parallel
+    x2    = (2. - 3.*iota) * x1;
+    BOOST_CHECK(MAST::compare_value
+                (1., FlutterEigenpairTracking::_modal_assurance_criterion(x1, x2),
+                 1.e-12));
+    
+    // orthogonal vectors
+    x2.setZero();
+    x2(2) = 1.;
+    BOOST_CHECK(MAST::is_numerical_zero
+                (FlutterEigenpairTracking::_modal_assurance_criterion(x1, x2),
+                 1.e-12));
+    
+    // zero vector
+    x2.setZero();
+    BOOST_CHECK(MAST::is_numerical_zero
+                (FlutterEigenpairTracking::_modal_assurance_criterion(x1, x2),
+                 1.e-12));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
@@ -0,0 +1,110 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2017  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+// BOOST includes
+#include <boost/test/unit_test.hpp>
+
+
+// MAST includes
+#include "examples/fsi/beam_flutter_solution/beam_euler_fsi_flutter_solution.h"
+#include "tests/base/test_comparisons.h"
+#include "elasticity/structural_discipline.h"
+#include "elasticity/structural_system_initialization.h"
+#include "elasticity/fsi_generalized_aero_force_assembly.h"
+#include "fluid/conservative_fluid_discipline.h"
+#include "fluid/conservative_fluid_system_initialization.h"
+#include "fluid/frequency_domain_linearized_complex_assembly.h"
+#include "solver/complex_solver_base.h"
+#include "base/nonlinear_system.h"
+#include "base/parameter.h"
+
+
+// libMesh includes
+#include "libmesh/numeric_vector.h"
+
+
+BOOST_FIXTURE_TEST_SUITE  (BeamFSIGeneralizedAeroForce,
+                           MAST::BeamEulerFSIFlutterAnalysis)
+
+
+BOOST_AUTO_TEST_CASE    (BeamFSIGAFMultipleRHSSolve) {
+    
+    // both solves converge to the tolerance of the Krylov solver
+    const Real
+    tol      = 1.e-4;
+    
+    // this computes the modal basis and the fluid base solution
+    this->solve(false, 1.e-4, 100);
+    
+    libMesh::NumericVector<Real>& base_sol =
+    _fluid_sys->get_vector("fluid_base_solution");
+    
+    MAST::FrequencyDomainLinearizedComplexAssembly   assembly;
+    MAST::ComplexSolverBase                          solver;
+    
+    assembly.attach_discipline_and_system(*_fluid_discipline,
+                                          solver,
+                                          *_fluid_sys_init);
+    assembly.set_base_solution(base_sol);
+    assembly.set_frequency_function(*_freq_function);
+    
+    MAST::FSIGeneralizedAeroForceAssembly fsi_assembly;
+    fsi_assembly.attach_discipline_and_system(*_structural_discipline,
+                                              *_structural_sys_init);
+    fsi_assembly.init(&solver,
+                      _pressure_function,
+                      _freq_domain_pressure_function,
+                      _displ);
+    
+    (*_omega) = 0.5*(_k_lower + _k_upper);
+    
+    ComplexMatrixX
+    gaf_seq,
+    gaf_multi;
+    
+    // one fluid solve for each mode
+    fsi_assembly.set_multiple_rhs_solve(false);
+    fsi_assembly.assemble_generalized_aerodynamic_force_matrix(_basis, gaf_seq);
+    
+    // all modes with one matrix assembly and preconditioner setup
+    fsi_assembly.set_multiple_rhs_solve(true);
+    fsi_assembly.assemble_generalized_aerodynamic_force_matrix(_basis, gaf_multi);
+    
+    BOOST_CHECK_EQUAL(gaf_seq.rows(), gaf_multi.rows());
+    BOOST_CHECK_EQUAL(gaf_seq.cols(), gaf_multi.cols());
+    
+    for (unsigned int i=0; i<gaf_seq.rows(); i++)
+        for (unsigned int j=0; j<gaf_seq.cols(); j++) {
+            
+            BOOST_TEST_MESSAGE("  ** GAF(" << i << "," << j << ") **");
+            BOOST_CHECK(MAST::compare_value(std::real(gaf_seq(i, j)),
+                                            std::real(gaf_multi(i, j)),
+                                            tol));
+            BOOST_CHECK(MAST::compare_value(std::imag(gaf_seq(i, j)),
+                                            std::imag(gaf_multi(i, j)),
+                                            tol));
+        }
+    
+    fsi_assembly.clear_discipline_and_system();
+    assembly.clear_discipline_and_system();
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
+
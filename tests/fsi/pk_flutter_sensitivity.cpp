@@ -0,0 +1,263 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2017  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+// C++ includes
+#include <cmath>
+#include <memory>
+
+
+// BOOST includes
+#include <boost/test/unit_test.hpp>
+
+
+// MAST includes
+#include "examples/fsi/beam_flutter_solution/beam_euler_fsi_flutter_solution.h"
+#include "tests/base/test_comparisons.h"
+#include "aeroelasticity/pk_flutter_solver.h"
+#include "aeroelasticity/flutter_solution_base.h"
+#include "aeroelasticity/flutter_root_base.h"
+#include "aeroelasticity/frequency_function.h"
+#include "elasticity/structural_discipline.h"
+#include "elasticity/structural_system_initialization.h"
+#include "elasticity/fsi_generalized_aero_force_assembly.h"
+#include "fluid/conservative_fluid_discipline.h"
+#include "fluid/conservative_fluid_system_initialization.h"
+#include "fluid/frequency_domain_linearized_complex_assembly.h"
+#include "fluid/flight_condition.h"
+#include "solver/complex_solver_base.h"
+#include "base/nonlinear_system.h"
+#include "base/parameter.h"
+
+
+// libMesh includes
+#include "libmesh/numeric_vector.h"
+#include "libmesh/parameter_vector.h"
+
+
+namespace {
+    
+    // exposes the PK eigensolution at a specified kr and V
+    struct PKFlutterSensitivitySolver:
+    public MAST::PKFlutterSolver {
+        
+        using MAST::PKFlutterSolver::_analyze;
+    };
+    
+    
+    // @returns the index of the root of \p sol closest to \p p
+    unsigned int
+    pk_nearest_root(const MAST::FlutterSolutionBase& sol,
+                    const Complex p) {
+        
+        unsigned int
+        i_min  = 0;
+        
+        for (unsigned int i=1; i<sol.n_roots(); i++)
+            if (std::abs(sol.get_root(i).root - p) <
+                std::abs(sol.get_root(i_min).root - p))
+                i_min = i;
+        
+        return i_min;
+    }
+    
+    
+    // Newton iterations for kr and V that satisfy the PK flutter
+    // conditions  Re(p) = 0  and  Im(p) = kr V/b, with a finite difference
+    // Jacobian, so that the converged point does not depend on the
+    // sensitivity code being tested. @returns the solution at the
+    // converged point and the index of the flutter root in \p root_num.
+    std::auto_ptr<MAST::FlutterSolutionBase>
+    pk_converge_flutter_point(PKFlutterSensitivitySolver& solver,
+                              const Real b,
+                              Real& kr,
+                              Real& V,
+                              unsigned int& root_num) {
+        
+        const Real
+        delta   = 1.e-6,
+        tol     = 1.e-10;
+        
+        std::auto_ptr<MAST::FlutterSolutionBase>
+        sol,
+        sol_dV,
+        sol_dkr;
+        
+        Complex
+        p       = Complex(0., kr*V/b);
+        
+        RealVectorX
+        res     = RealVectorX::Zero(2);
+        
+        RealMatrixX
+        jac     = RealMatrixX::Zero(2, 2);
+        
+        for (unsigned int n_iters=0; n_iters<20; n_iters++) {
+            
+            sol.reset(solver._analyze(kr, V).release());
+            root_num = pk_nearest_root(*sol, p);
+            p        = sol->get_root(root_num).root;
+            
+            res(0)   = p.real();
+            res(1)   = p.imag() - kr*V/b;
+            
+            if (res.norm() <= tol * std::abs(p))
+                return sol;
+            
+            sol_dV.reset(solver._analyze(kr, V*(1.+delta)).release());
+            sol_dkr.reset(solver._analyze(kr*(1.+delta), V).release());
+            
+            const Complex
+            dp_dV   = (sol_dV->get_root(pk_nearest_root(*sol_dV, p)).root - p)/(delta*V),
+            dp_dkr  = (sol_dkr->get_root(pk_nearest_root(*sol_dkr, p)).root - p)/(delta*kr);
+            
+            jac(0, 0) = dp_dV.real();
+            jac(0, 1) = dp_dkr.real();
+            jac(1, 0) = dp_dV.imag()  - kr/b;
+            jac(1, 1) = dp_dkr.imag() - V/b;
+            
+            res       = -jac.inverse() * res;
+            V        += res(0);
+            kr       += res(1);
+        }
+        
+        BOOST_FAIL("PK flutter point did not converge");
+        return sol;
+    }
+}
+
+
+
+BOOST_FIXTURE_TEST_SUITE  (BeamFSIPKFlutterSensitivity,
+                           MAST::BeamEulerFSIFlutterAnalysis)
+
+
+BOOST_AUTO_TEST_CASE    (BeamFSIPKFlutterSpeedAndReducedFrequencySensitivity) {
+    
+    const Real
+    delta    = 1.e-5,
+    tol      = 1.e-3;
+    
+    // the UG flutter point, which has zero damping, is the initial
+    // point of the PK iterations. This also computes the modal basis and
+    // the fluid base solution.
+    this->solve(false, 1.e-4, 100);
+    
+    Real
+    kr0      = _flutter_root->kr,
+    V0       = _flutter_root->V;
+    
+    libMesh::NumericVector<Real>& base_sol =
+    _fluid_sys->get_vector("fluid_base_solution");
+    
+    MAST::FrequencyDomainLinearizedComplexAssembly   assembly;
+    MAST::ComplexSolverBase                          solver;
+    
+    assembly.attach_discipline_and_system(*_fluid_discipline,
+                                          solver,
+                                          *_fluid_sys_init);
+    assembly.set_base_solution(base_sol);
+    assembly.set_frequency_function(*_freq_function);
+    
+    MAST::FSIGeneralizedAeroForceAssembly fsi_assembly;
+    fsi_assembly.attach_discipline_and_system(*_structural_discipline,
+                                              *_structural_sys_init);
+    fsi_assembly.init(&solver,
+                      _pressure_function,
+                      _freq_domain_pressure_function,
+                      _displ);
+    
+    // the generalized aerodynamic force matrix depends on kr through
+    // the frequency of the fluid solution, and does not depend on V
+    PKFlutterSensitivitySolver pk;
+    pk.attach_assembly(fsi_assembly);
+    pk.initialize(*_velocity,
+                  *_omega,
+                  *_b_ref,
+                  _flight_cond->rho(),
+                  0.5*V0, 2.*V0, 1,
+                  _k_lower, _k_upper, _n_k_divs,
+                  _basis);
+    
+    const Real
+    b        = (*_b_ref)();
+    
+    unsigned int
+    root_num = 0;
+    
+    std::auto_ptr<MAST::FlutterSolutionBase>
+    sol0(pk_converge_flutter_point(pk, b, kr0, V0, root_num).release());
+    
+    MAST::FlutterRootBase&
+    root     = sol0->get_root(root_num);
+    
+    for (unsigned int i=0; i<this->_params_for_sensitivity.size(); i++ ) {
+        
+        MAST::Parameter& f = *this->_params_for_sensitivity[i];
+        
+        // the sensitivity of the aerodynamic matrix wrt kr is computed
+        // by the fluid discipline
+        _structural_discipline->add_parameter(f);
+        _fluid_discipline->add_parameter(*_omega);
+        
+        libMesh::ParameterVector params;
+        params.resize(1);
+        params[0]  =  f.ptr();
+        
+        pk.calculate_sensitivity(root, params, 0);
+        
+        std::vector<Real> V_sens;
+        pk.calculate_sensitivity(root, params, V_sens);
+        
+        _structural_discipline->remove_parameter(f);
+        _fluid_discipline->remove_parameter(*_omega);
+        
+        // finite difference sensitivity from the converged flutter point
+        // at the perturbed parameter value
+        const Real
+        p0       = f(),
+        dp       = (fabs(p0) > 0.)? delta*p0 : delta;
+        
+        Real
+        kr       = kr0,
+        V        = V0;
+        
+        unsigned int
+        n        = 0;
+        
+        f()     += dp;
+        pk_converge_flutter_point(pk, b, kr, V, n);
+        f()      = p0;
+        
+        const Real
+        dV_fd    = (V  - V0)/dp,
+        dkr_fd   = (kr - kr0)/dp;
+        
+        BOOST_TEST_MESSAGE("  ** dV_F/dp, dkr_F/dp wrt : " << f.name() << " **");
+        BOOST_CHECK(MAST::compare_value( dV_fd,   root.V_sens,  tol));
+        BOOST_CHECK(MAST::compare_value( dkr_fd,  root.kr_sens, tol));
+        BOOST_CHECK(MAST::compare_value( root.V_sens, V_sens[0], 1.e-10));
+    }
+    
+    fsi_assembly.clear_discipline_and_system();
+    pk.clear_assembly_object();
+    assembly.clear_discipline_and_system();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
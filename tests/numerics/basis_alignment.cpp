@@ -0,0 +1,234 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2017  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+// C++ includes
+#include <cmath>
+#include <vector>
+
+// BOOST includes
+#include <boost/test/unit_test.hpp>
+
+
+// MAST includes
+#include "numerics/basis_alignment.h"
+#include "tests/base/test_comparisons.h"
+
+
+// libMesh includes
+#include "libmesh/libmesh.h"
+#include "libmesh/numeric_vector.h"
+
+
+extern libMesh::LibMeshInit* __init;
+
+
+namespace {
+    
+    /*!
+     *   creates serial vectors from the columns of \p m
+     */
+    void
+    build_basis(const RealMatrixX& m,
+                std::vector<libMesh::NumericVector<Real>*>& basis) {
+        
+        basis.resize(m.cols());
+        
+        for (unsigned int j=0; j<m.cols(); j++) {
+            
+            basis[j] = libMesh::NumericVector<Real>::build(__init->comm()).release();
+            basis[j]->init(m.rows(), true, libMesh::SERIAL);
+            
+            for (unsigned int i=0; i<m.rows(); i++)
+                basis[j]->set(i, m(i,j));
+            
+            basis[j]->close();
+        }
+    }
+    
+    
+    void
+    clear_basis(std::vector<libMesh::NumericVector<Real>*>& basis) {
+        
+        for (unsigned int j=0; j<basis.size(); j++)
+            delete basis[j];
+        
+        basis.clear();
+    }
+    
+    
+    /*!
+     *   orthonormal basis of three vectors in six dimensions
+     */
+    RealMatrixX
+    old_basis_matrix() {
+        
+        const Real
+        r = 1./sqrt(2.);
+        
+        RealMatrixX
+        phi0 = RealMatrixX::Zero(6, 3);
+        
+        phi0(0,0) =  r;  phi0(3,0) =  r;
+        phi0(1,1) =  r;  phi0(4,1) = -r;
+        phi0(2,2) =  1.;
+        
+        return phi0;
+    }
+    
+    
+    bool
+    compare_matrix(const RealMatrixX& m0, const RealMatrixX& m, const Real tol) {
+        
+        libmesh_assert_equal_to(m0.rows(), m.rows());
+        libmesh_assert_equal_to(m0.cols(), m.cols());
+        
+        return MAST::compare_vector(Eigen::Map<const RealVectorX>(m0.data(), m0.size()),
+                                    Eigen::Map<const RealVectorX>(m.data(),  m.size()),
+                                    tol);
+    }
+}
+
+
+
+BOOST_AUTO_TEST_SUITE  (BasisAlignment)
+
+BOOST_AUTO_TEST_CASE   (RotatedBasis) {
+    
+    // the new basis is the old basis rotated in the plane of the first
+    // two vectors, with the vectors reordered and one sign changed, so
+    // that Phi_1 = Phi_0 Q with an orthogonal Q
+    const Real
+    theta  = 0.3,
+    c      = cos(theta),
+    s      = sin(theta),
+    tol    = 1.e-10;
+    
+    RealMatrixX
+    rot    = RealMatrixX::Identity(3, 3),
+    Q      = RealMatrixX::Zero(3, 3);
+    
+    rot(0,0) =  c;  rot(0,1) = -s;
+    rot(1,0) =  s;  rot(1,1) =  c;
+    
+    Q.col(0) = -rot.col(2);
+    Q.col(1) =  rot.col(0);
+    Q.col(2) =  rot.col(1);
+    
+    const RealMatrixX
+    phi0   = old_basis_matrix(),
+    phi1   = phi0 * Q;
+    
+    std::vector<libMesh::NumericVector<Real>*>
+    old_basis,
+    new_basis;
+    
+    build_basis(phi0, old_basis);
+    build_basis(phi1, new_basis);
+    
+    MAST::BasisAlignment alignment;
+    alignment.compute(old_basis, new_basis);
+    
+    BOOST_CHECK_EQUAL(alignment.n_old(), 3);
+    BOOST_CHECK_EQUAL(alignment.n_new(), 3);
+    
+    // the new vectors are in the span of the old basis, with the
+    // coordinates Q, and the Procrustes rotation recovers Q^T
+    BOOST_CHECK_SMALL(alignment.subspace_residual(), tol);
+    BOOST_CHECK(compare_matrix(Q, alignment.coordinates(), tol));
+    BOOST_CHECK(compare_matrix(RealMatrixX(Q.transpose()), alignment.rotation(), tol));
+    
+    // the MAC is the square of the entries of Q
+    BOOST_CHECK(compare_matrix(RealMatrixX(Q.array().square().matrix()),
+                               alignment.mac(),
+                               tol));
+    
+    // the reduced quantities transform with the coordinates
+    RealMatrixX
+    A = RealMatrixX::Zero(3, 3);
+    A << 1., 2., 0.,
+         3., 4., 5.,
+         0., 6., 7.;
+    
+    BOOST_CHECK(compare_matrix(RealMatrixX(Q.transpose() * A * Q),
+                               alignment.transform(A),
+                               tol));
+    
+    // the rotated basis is the old basis
+    alignment.rotate_basis(new_basis);
+    
+    BOOST_CHECK(compare_matrix(RealMatrixX::Identity(3, 3), alignment.rotation(), tol));
+    BOOST_CHECK(compare_matrix(RealMatrixX::Identity(3, 3), alignment.mac(), tol));
+    
+    for (unsigned int j=0; j<3; j++) {
+        
+        std::vector<Real> v;
+        new_basis[j]->localize(v);
+        
+        BOOST_CHECK(MAST::compare_vector(RealVectorX(phi0.col(j)),
+                                         Eigen::Map<const RealVectorX>(&v[0], v.size()),
+                                         tol));
+    }
+    
+    clear_basis(old_basis);
+    clear_basis(new_basis);
+}
+
+
+
+BOOST_AUTO_TEST_CASE   (SubspaceResidual) {
+    
+    // the new vector has the part 0.1 (e_0 - e_3)/sqrt(2) outside of the
+    // span of the old basis
+    const Real
+    r      = 1./sqrt(2.),
+    tol    = 1.e-10;
+    
+    const RealMatrixX
+    phi0   = old_basis_matrix();
+    
+    RealMatrixX
+    phi1   = phi0.col(0);
+    
+    phi1(0,0) += 0.1*r;
+    phi1(3,0) -= 0.1*r;
+    
+    std::vector<libMesh::NumericVector<Real>*>
+    old_basis,
+    new_basis;
+    
+    build_basis(phi0, old_basis);
+    build_basis(phi1, new_basis);
+    
+    MAST::BasisAlignment alignment;
+    alignment.compute(old_basis, new_basis);
+    
+    RealVectorX
+    t = RealVectorX::Zero(3);
+    t(0) = 1.;
+    
+    BOOST_CHECK(MAST::compare_value(0.1/sqrt(1.01), alignment.subspace_residual(), tol));
+    BOOST_CHECK(MAST::compare_vector(t, RealVectorX(alignment.coordinates().col(0)), tol));
+    
+    clear_basis(old_basis);
+    clear_basis(new_basis);
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
+
@@ -125,3 +125,218 @@
 //}
 //
 //
+
+
+// C++ includes
+#include <chrono>
+
+// BOOST includes
+#include <boost/test/unit_test.hpp>
+
+
+// MAST includes
+#include "numerics/fem_operator_matrix.h"
+#include "numerics/fem_operator_matrix_batch.h"
+#include "tests/base/test_comparisons.h"
+
+
+/*!
+ *   Builds \p n_qp operators with the block sparsity of the membrane
+ *   strain operator of a quad4 plate element, with random shape function
+ *   values at each quadrature point.
+ */
+inline void
+build_fem_operators(unsigned int n_qp,
+                    std::vector<MAST::FEMOperatorMatrix*>& ops) {
+    
+    const unsigned int
+    n_phi = 4;
+    
+    ops.resize(n_qp);
+    
+    for (unsigned int q=0; q<n_qp; q++) {
+        
+        RealVectorX
+        dphidx = RealVectorX::Random(n_phi),
+        dphidy = RealVectorX::Random(n_phi);
+        
+        ops[q] = new MAST::FEMOperatorMatrix;
+        ops[q]->reinit(3, 6, n_phi);
+        ops[q]->set_shape_function(0, 0, dphidx); // epsilon_xx = du/dx
+        ops[q]->set_shape_function(2, 1, dphidx); // gamma_xy = dv/dx + ...
+        ops[q]->set_shape_function(1, 1, dphidy); // epsilon_yy = dv/dy
+        ops[q]->set_shape_function(2, 0, dphidy); // gamma_xy = du/dy + ...
+    }
+}
+
+
+
+inline void
+clear_fem_operators(std::vector<MAST::FEMOperatorMatrix*>& ops) {
+    
+    for (unsigned int q=0; q<ops.size(); q++)
+        delete ops[q];
+    ops.clear();
+}
+
+
+
+BOOST_AUTO_TEST_SUITE  (FEMOperatorMatrixBatchProducts)
+
+
+BOOST_AUTO_TEST_CASE   (BatchProductsMatchSingleOperator) {
+    
+    const Real
+    tol      = 1.e-10;
+    
+    const unsigned int
+    n_qp     = 9;
+    
+    std::vector<MAST::FEMOperatorMatrix*> ops;
+    build_fem_operators(n_qp, ops);
+    
+    MAST::FEMOperatorMatrixBatch batch;
+    batch.reinit(std::vector<const MAST::FEMOperatorMatrix*>(ops.begin(), ops.end()));
+    
+    BOOST_CHECK_EQUAL(batch.n_batch(), n_qp);
+    BOOST_CHECK_EQUAL(batch.m(), ops[0]->m());
+    BOOST_CHECK_EQUAL(batch.n(), ops[0]->n());
+    
+    const unsigned int
+    m        = ops[0]->m(),
+    n        = ops[0]->n();
+    
+    RealVectorX
+    u        = RealVectorX::Random(n),
+    w        = RealVectorX::Random(n_qp),
+    vec_m    = RealVectorX::Zero(m),
+    vec_n    = RealVectorX::Zero(n),
+    sum0     = RealVectorX::Zero(n),
+    sum      = RealVectorX::Zero(n);
+    
+    RealMatrixX
+    v        = RealMatrixX::Random(m, n_qp),
+    u_q      = RealMatrixX::Random(n, n_qp),
+    mat      = RealMatrixX::Random(n, 5),
+    res,
+    tmp;
+    
+    std::vector<RealMatrixX>
+    r_batch,
+    mat_q(n_qp);
+    
+    for (unsigned int q=0; q<n_qp; q++)
+        mat_q[q] = RealMatrixX::Random(7, n);
+    
+    // same vector for all operators
+    batch.vector_mult(res, u);
+    for (unsigned int q=0; q<n_qp; q++) {
+        ops[q]->vector_mult(vec_m, u);
+        BOOST_CHECK(MAST::compare_vector(vec_m, res.col(q), tol));
+    }
+    
+    // different vector for each operator
+    batch.vector_mult(res, u_q);
+    for (unsigned int q=0; q<n_qp; q++) {
+        ops[q]->vector_mult(vec_m, RealVectorX(u_q.col(q)));
+        BOOST_CHECK(MAST::compare_vector(vec_m, res.col(q), tol));
+    }
+    
+    batch.vector_mult_transpose(res, v);
+    for (unsigned int q=0; q<n_qp; q++) {
+        ops[q]->vector_mult_transpose(vec_n, RealVectorX(v.col(q)));
+        BOOST_CHECK(MAST::compare_vector(vec_n, res.col(q), tol));
+        sum0 += w(q) * vec_n;
+    }
+    
+    batch.vector_mult_transpose_sum(sum, v, w);
+    BOOST_CHECK(MAST::compare_vector(sum0, sum, tol));
+    
+    batch.right_multiply(r_batch, mat);
+    BOOST_CHECK_EQUAL(r_batch.size(), n_qp);
+    for (unsigned int q=0; q<n_qp; q++) {
+        tmp.setZero(m, mat.cols());
+        ops[q]->right_multiply(tmp, mat);
+        BOOST_CHECK(MAST::compare_matrix(tmp, r_batch[q], tol));
+    }
+    
+    batch.left_multiply_transpose(r_batch, mat_q);
+    BOOST_CHECK_EQUAL(r_batch.size(), n_qp);
+    for (unsigned int q=0; q<n_qp; q++) {
+        tmp.setZero(mat_q[q].rows(), m);
+        ops[q]->left_multiply_transpose(tmp, mat_q[q]);
+        BOOST_CHECK(MAST::compare_matrix(tmp, r_batch[q], tol));
+    }
+    
+    clear_fem_operators(ops);
+}
+
+
+
+BOOST_AUTO_TEST_CASE   (BatchProductsThroughput) {
+    
+    // this only reports the timings, since the speedup depends on the
+    // compiler flags and the machine.
+    const unsigned int
+    n_qp     = 9,
+    n_elems  = 20000;
+    
+    std::vector<MAST::FEMOperatorMatrix*> ops;
+    build_fem_operators(n_qp, ops);
+    
+    MAST::FEMOperatorMatrixBatch batch;
+    batch.reinit(std::vector<const MAST::FEMOperatorMatrix*>(ops.begin(), ops.end()));
+    
+    const unsigned int
+    m        = ops[0]->m(),
+    n        = ops[0]->n();
+    
+    RealVectorX
+    w        = RealVectorX::Random(n_qp),
+    vec_n    = RealVectorX::Zero(n),
+    sum0     = RealVectorX::Zero(n),
+    sum      = RealVectorX::Zero(n);
+    
+    RealMatrixX
+    v        = RealMatrixX::Random(m, n_qp);
+    
+    std::vector<RealVectorX> v_q(n_qp);
+    for (unsigned int q=0; q<n_qp; q++)
+        v_q[q] = v.col(q);
+    
+    std::chrono::high_resolution_clock::time_point
+    t0 = std::chrono::high_resolution_clock::now();
+    
+    for (unsigned int e=0; e<n_elems; e++)
+        for (unsigned int q=0; q<n_qp; q++) {
+            ops[q]->vector_mult_transpose(vec_n, v_q[q]);
+            sum0 += w(q) * vec_n;
+        }
+    
+    std::chrono::high_resolution_clock::time_point
+    t1 = std::chrono::high_resolution_clock::now();
+    
+    for (unsigned int e=0; e<n_elems; e++)
+        batch.vector_mult_transpose_sum(sum, v, w);
+    
+    std::chrono::high_resolution_clock::time_point
+    t2 = std::chrono::high_resolution_clock::now();
+    
+    const Real
+    t_single = std::chrono::duration<Real>(t1-t0).count(),
+    t_batch  = std::chrono::duration<Real>(t2-t1).count();
+    
+    BOOST_TEST_MESSAGE("FEMOperatorMatrix  B^T v quadrature sum: "
+                       << n_elems << " elems x " << n_qp << " qps : "
+                       << "single: " << t_single << " s , "
+                       << "batched: " << t_batch << " s , "
+                       << "speedup: " << t_single/t_batch);
+    
+    BOOST_CHECK(MAST::compare_vector(sum0, sum, 1.e-8));
+    
+    clear_fem_operators(ops);
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
+
@@ -0,0 +1,244 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2017  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+// C++ includes
+#include <cmath>
+#include <algorithm>
+
+// BOOST includes
+#include <boost/test/unit_test.hpp>
+
+
+// MAST includes
+#include "numerics/lapack_dsygvd_interface.h"
+#include "numerics/lapack_zhegvd_interface.h"
+#include "numerics/lapack_zggev_interface.h"
+#include "tests/base/test_comparisons.h"
+
+
+namespace {
+    
+    //
+    // the matrices of the second difference operator
+    //   A = tridiag(-1, 2, -1),  B = 2 I
+    // of size 3 have the eigenvalues (2 - 2 cos(k pi/4))/2, k = 1, 2, 3.
+    // The Hermitian matrix with the off-diagonal entries -i and i is
+    // unitarily similar to A, and has the same eigenvalues.
+    //
+    
+    void
+    second_difference(ComplexMatrixX& A,
+                      ComplexMatrixX& B,
+                      const Complex& off_diag) {
+        
+        A = ComplexMatrixX::Zero(3, 3);
+        B = 2. * ComplexMatrixX::Identity(3, 3);
+        
+        for (unsigned int i=0; i<3; i++) {
+            A(i, i) = 2.;
+            if (i < 2) {
+                A(i, i+1) = off_diag;
+                A(i+1, i) = std::conj(off_diag);
+            }
+        }
+    }
+    
+    
+    RealVectorX
+    second_difference_eigenvalues() {
+        
+        RealVectorX
+        eig = RealVectorX::Zero(3);
+        
+        for (unsigned int k=1; k<=3; k++)
+            eig(k-1) = 1. - cos(k*acos(-1.)/4.);
+        
+        return eig;
+    }
+    
+    
+    // @returns the real parts of alpha/beta in ascending order
+    RealVectorX
+    sorted_eigenvalues(const MAST::LAPACK_ZGGEV_Base& solver) {
+        
+        const ComplexVectorX
+        &alpha = solver.alphas(),
+        &beta  = solver.betas();
+        
+        std::vector<Real>
+        v(alpha.size());
+        
+        for (unsigned int i=0; i<v.size(); i++)
+            v[i] = std::real(alpha(i)/beta(i));
+        
+        std::sort(v.begin(), v.end());
+        
+        RealVectorX
+        eig = RealVectorX::Zero(v.size());
+        for (unsigned int i=0; i<v.size(); i++)
+            eig(i) = v[i];
+        
+        return eig;
+    }
+}
+
+
+
+BOOST_AUTO_TEST_SUITE  (LapackHermitianEigensolvers)
+
+BOOST_AUTO_TEST_CASE   (RealSymmetricDefinite) {
+    
+    ComplexMatrixX
+    A,
+    B;
+    
+    second_difference(A, B, -1.);
+    
+    const RealMatrixX
+    Ar = A.real(),
+    Br = B.real();
+    
+    MAST::LAPACK_DSYGVD solver;
+    solver.compute(Ar, Br);
+    
+    BOOST_REQUIRE_EQUAL(solver.info(), 0);
+    
+    const RealVectorX
+    &eig  = solver.eigenvalues();
+    const RealMatrixX
+    &X    = solver.eigenvectors();
+    
+    BOOST_CHECK(MAST::compare_vector(second_difference_eigenvalues(), eig, 1.e-10));
+    
+    // the eigenvectors are B-orthonormal, and satisfy A X = B X Lambda
+    const RealMatrixX
+    XBX  = X.transpose() * Br * X,
+    res  = Ar * X - Br * X * eig.asDiagonal();
+    
+    BOOST_CHECK_SMALL((XBX - RealMatrixX::Identity(3, 3)).norm(), 1.e-10);
+    BOOST_CHECK_SMALL(res.norm(), 1.e-10);
+    
+    // the complex solver uses the real solver for these matrices
+    MAST::LAPACK_ZHEGVD csolver;
+    csolver.compute(A, B);
+    
+    BOOST_REQUIRE_EQUAL(csolver.info(), 0);
+    BOOST_CHECK(MAST::compare_vector(eig, RealVectorX(csolver.alphas().real()), 1.e-12));
+}
+
+
+
+BOOST_AUTO_TEST_CASE   (HermitianDefinite) {
+    
+    const Complex
+    iota(0., 1.);
+    
+    ComplexMatrixX
+    A,
+    B;
+    
+    second_difference(A, B, -iota);
+    
+    BOOST_CHECK(MAST::LAPACK_ZHEGVD::is_hermitian(A, B));
+    
+    MAST::LAPACK_ZHEGVD solver;
+    solver.compute(A, B);
+    
+    BOOST_REQUIRE_EQUAL(solver.info(), 0);
+    
+    const ComplexVectorX
+    &alpha = solver.alphas();
+    const ComplexMatrixX
+    &X     = solver.right_eigenvectors();
+    
+    const RealVectorX
+    eig    = alpha.real();
+    
+    BOOST_CHECK(MAST::compare_vector(second_difference_eigenvalues(), eig, 1.e-10));
+    BOOST_CHECK_SMALL(alpha.imag().norm(), 1.e-12);
+    BOOST_CHECK_SMALL((solver.betas() - ComplexVectorX::Ones(3)).norm(), 1.e-12);
+    
+    // the eigenvectors are B-orthonormal, and satisfy A X = B X Lambda
+    const ComplexMatrixX
+    XBX  = X.adjoint() * B * X,
+    res  = A * X - B * X * alpha.asDiagonal();
+    
+    BOOST_CHECK_SMALL((XBX - ComplexMatrixX::Identity(3, 3)).norm(), 1.e-10);
+    BOOST_CHECK_SMALL(res.norm(), 1.e-10);
+    
+    // the left and right eigenvectors are the same
+    BOOST_CHECK_SMALL((solver.left_eigenvectors() - X).norm(), 1.e-12);
+}
+
+
+
+BOOST_AUTO_TEST_CASE   (ZGGEVHermitianDetection) {
+    
+    const Complex
+    iota(0., 1.);
+    
+    ComplexMatrixX
+    A,
+    B;
+    
+    second_difference(A, B, -iota);
+    
+    // the Hermitian pair is solved by the symmetric-definite solver, and
+    // gives the same eigenvalues as the QZ algorithm
+    MAST::LAPACK_ZGGEV
+    hermitian,
+    qz;
+    
+    qz.set_detect_hermitian(false);
+    
+    hermitian.compute(A, B);
+    qz.compute(A, B);
+    
+    BOOST_REQUIRE_EQUAL(hermitian.info(), 0);
+    BOOST_REQUIRE_EQUAL(qz.info(), 0);
+    BOOST_CHECK(hermitian.if_hermitian_solution());
+    BOOST_CHECK(!qz.if_hermitian_solution());
+    
+    BOOST_CHECK(MAST::compare_vector(second_difference_eigenvalues(),
+                                     sorted_eigenvalues(hermitian),
+                                     1.e-10));
+    BOOST_CHECK(MAST::compare_vector(second_difference_eigenvalues(),
+                                     sorted_eigenvalues(qz),
+                                     1.e-10));
+    
+    // a non-Hermitian pair is solved by the QZ algorithm
+    A(0, 2) = 1.;
+    BOOST_CHECK(!MAST::LAPACK_ZHEGVD::is_hermitian(A, B));
+    
+    hermitian.compute(A, B);
+    BOOST_REQUIRE_EQUAL(hermitian.info(), 0);
+    BOOST_CHECK(!hermitian.if_hermitian_solution());
+    
+    // a Hermitian pair with an indefinite B falls back to the QZ algorithm
+    second_difference(A, B, -iota);
+    B(2, 2) = -2.;
+    
+    hermitian.compute(A, B);
+    BOOST_REQUIRE_EQUAL(hermitian.info(), 0);
+    BOOST_CHECK(!hermitian.if_hermitian_solution());
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
+
@@ -0,0 +1,82 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2017  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+// C++ includes
+#include <cmath>
+
+// BOOST includes
+#include <boost/test/unit_test.hpp>
+
+
+// MAST includes
+#include "solver/first_order_newmark_transient_solver.h"
+#include "tests/base/test_comparisons.h"
+
+
+namespace {
+    
+    // exposes the error constant used by the adaptive time step
+    struct FirstOrderNewmarkErrorEstimate:
+    public MAST::FirstOrderNewmarkTransientSolver {
+        
+        using MAST::FirstOrderNewmarkTransientSolver::_error_constant;
+    };
+}
+
+
+
+BOOST_AUTO_TEST_SUITE  (FirstOrderNewmarkErrorEstimate)
+
+BOOST_AUTO_TEST_CASE   (DecayODE) {
+    
+    // one step of x_dot = -lambda x from x0 has the exact solution
+    // x0 exp(-lambda dt). The scheme gives
+    //     x = x0 + dt ((1-beta) x0_dot + beta x_dot)
+    // and the predictor is x0 + dt x0_dot, so the estimated local
+    // truncation error must approach the true error as dt -> 0.
+    const Real
+    lambda   = 1.,
+    x0       = 1.,
+    dt       = 1.e-3,
+    tol      = 2.e-3;
+    
+    const Real
+    betas[]  = {0.6, 0.75, 1.};
+    
+    FirstOrderNewmarkErrorEstimate solver;
+    
+    for (unsigned int i=0; i<3; i++) {
+        
+        solver.beta = betas[i];
+        
+        const Real
+        x      = x0*(1.-dt*(1.-solver.beta)*lambda)/(1.+dt*solver.beta*lambda),
+        x_p    = x0 - dt*lambda*x0,
+        err    = std::fabs(x - x0*exp(-lambda*dt)),
+        est    = solver._error_constant() * std::fabs(x - x_p);
+        
+        BOOST_TEST_MESSAGE("  ** beta = " << solver.beta
+                           << " : error = " << err
+                           << " , estimate = " << est << " **");
+        BOOST_CHECK(MAST::compare_value(1., est/err, tol));
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
@@ -0,0 +1,177 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2017  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+// C++ includes
+#include <vector>
+#include <algorithm>
+
+// BOOST includes
+#include <boost/test/unit_test.hpp>
+
+
+// MAST includes
+#include "numerics/point_tree.h"
+
+
+namespace {
+    
+    /*!
+     *   linear congruential generator, so that the points are the same
+     *   on all platforms
+     */
+    struct UniformSequence {
+        
+        UniformSequence(): _s(12345) { }
+        
+        Real operator() () {
+            _s = (1103515245u * _s + 12345u) % 2147483648u;
+            return Real(_s) / 2147483648.;
+        }
+        
+        unsigned long long _s;
+    };
+    
+    
+    /*!
+     *   checks that the tree finds the same points as a search over all
+     *   points, for each of the query points and radii
+     */
+    void
+    check_tree(const std::vector<libMesh::Point>& pts,
+               unsigned int dim,
+               const std::vector<libMesh::Point>& queries,
+               const std::vector<Real>& radii) {
+        
+        MAST::PointTree tree(pts, dim);
+        
+        BOOST_CHECK_EQUAL(tree.n_points(), pts.size());
+        
+        std::vector<unsigned int>
+        ids,
+        ids_brute;
+        
+        unsigned int
+        n_mismatch = 0;
+        
+        for (unsigned int k=0; k<radii.size(); k++)
+            for (unsigned int q=0; q<queries.size(); q++) {
+                
+                tree.find(queries[q], radii[k], ids);
+                
+                ids_brute.clear();
+                for (unsigned int i=0; i<pts.size(); i++)
+                    if ((pts[i] - queries[q]).norm() <= radii[k])
+                        ids_brute.push_back(i);
+                
+                std::sort(ids.begin(), ids.end());
+                
+                if (ids != ids_brute)
+                    n_mismatch++;
+            }
+        
+        BOOST_CHECK_EQUAL(n_mismatch, 0);
+    }
+}
+
+
+
+BOOST_AUTO_TEST_SUITE  (PointTree)
+
+BOOST_AUTO_TEST_CASE   (GridPoints2D) {
+    
+    // points of a grid have equal coordinates along the split axes, and
+    // points at exactly the search radius
+    std::vector<libMesh::Point>
+    pts,
+    queries;
+    
+    for (unsigned int i=0; i<11; i++)
+        for (unsigned int j=0; j<7; j++)
+            pts.push_back(libMesh::Point(0.5*i, 0.5*j, 0.));
+    
+    queries = pts;
+    queries.push_back(libMesh::Point( 1.25, 0.75, 0.));
+    queries.push_back(libMesh::Point(-1.,   1.,   0.));
+    queries.push_back(libMesh::Point(10.,  10.,   0.));
+    
+    std::vector<Real>
+    radii;
+    
+    radii.push_back(0.);
+    radii.push_back(0.5);
+    radii.push_back(0.75);
+    radii.push_back(1.);
+    radii.push_back(100.);
+    
+    check_tree(pts, 2, queries, radii);
+}
+
+
+
+BOOST_AUTO_TEST_CASE   (RandomPoints3D) {
+    
+    UniformSequence
+    u;
+    
+    std::vector<libMesh::Point>
+    pts(500),
+    queries(50);
+    
+    for (unsigned int i=0; i<pts.size(); i++)
+        pts[i] = libMesh::Point(u(), u(), u());
+    
+    // queries within and outside of the points
+    for (unsigned int i=0; i<queries.size(); i++)
+        queries[i] = libMesh::Point(1.2*u()-0.1, 1.2*u()-0.1, 1.2*u()-0.1);
+    
+    std::vector<Real>
+    radii;
+    
+    radii.push_back(0.05);
+    radii.push_back(0.1);
+    radii.push_back(0.3);
+    radii.push_back(2.);
+    
+    check_tree(pts, 3, queries, radii);
+}
+
+
+
+BOOST_AUTO_TEST_CASE   (EmptyTree) {
+    
+    std::vector<libMesh::Point>
+    pts(1, libMesh::Point(1., 2., 3.));
+    
+    std::vector<unsigned int>
+    ids;
+    
+    MAST::PointTree tree(pts, 3);
+    tree.find(libMesh::Point(1., 2., 3.), 0., ids);
+    BOOST_CHECK_EQUAL(ids.size(), 1);
+    
+    tree.clear();
+    BOOST_CHECK_EQUAL(tree.n_points(), 0);
+    
+    tree.find(libMesh::Point(1., 2., 3.), 1., ids);
+    BOOST_CHECK(ids.empty());
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
+
@@ -0,0 +1,162 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2017  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+// C++ includes
+#include <algorithm>
+
+
+// BOOST includes
+#include <boost/test/unit_test.hpp>
+
+
+// MAST includes
+#include "optimization/function_evaluation.h"
+#include "tests/base/test_comparisons.h"
+
+
+// libMesh includes
+#include "libmesh/libmesh.h"
+
+
+extern libMesh::LibMeshInit* __init;
+
+
+namespace {
+    
+    /*!
+     *   analytical functions f = sum_j x_j^2 and g_i = sum_j (i+1) j x_j,
+     *   where each sensitivity group only computes the derivatives for the
+     *   variables it owns, and sets the others to a value that must not
+     *   survive the gather.
+     */
+    class GroupedEvaluation:
+    public MAST::FunctionEvaluation {
+        
+    public:
+        
+        GroupedEvaluation(const libMesh::Parallel::Communicator& comm_in):
+        MAST::FunctionEvaluation(comm_in) {
+            
+            _n_vars = 5;
+            _n_ineq = 2;
+        }
+        
+        virtual void init_dvar(std::vector<Real>& x,
+                               std::vector<Real>& xmin,
+                               std::vector<Real>& xmax) {
+            
+            x.resize(_n_vars);
+            xmin.resize(_n_vars);
+            xmax.resize(_n_vars);
+            
+            for (unsigned int j=0; j<_n_vars; j++) {
+                x[j]    = 0.5 + j;
+                xmin[j] = -10.;
+                xmax[j] =  10.;
+            }
+        }
+        
+        virtual void evaluate(const std::vector<Real>& dvars,
+                              Real& obj,
+                              bool eval_obj_grad,
+                              std::vector<Real>& obj_grad,
+                              std::vector<Real>& fvals,
+                              std::vector<bool>& eval_grads,
+                              std::vector<Real>& grads) {
+            
+            obj = 0.;
+            std::fill(fvals.begin(), fvals.end(), 0.);
+            
+            for (unsigned int j=0; j<_n_vars; j++) {
+                
+                obj += dvars[j]*dvars[j];
+                
+                for (unsigned int i=0; i<_n_ineq; i++)
+                    fvals[i] += (i+1.)*j*dvars[j];
+                
+                const bool own = this->if_sensitivity_group_owns(j);
+                
+                obj_grad[j] = own ? 2.*dvars[j] : -1.;
+                
+                for (unsigned int i=0; i<_n_ineq; i++)
+                    grads[j*_n_ineq+i] = own ? (i+1.)*j : -1.;
+            }
+            
+            this->gather_sensitivity(obj_grad);
+            this->gather_sensitivity(grads, _n_ineq);
+        }
+    };
+}
+
+
+
+BOOST_AUTO_TEST_SUITE  (FunctionEvaluationSensitivityGroups)
+
+BOOST_AUTO_TEST_CASE   (GatherSensitivity) {
+    
+    const Real
+    tol      = 1.e-12;
+    
+    GroupedEvaluation func_eval(__init->comm());
+    
+    // two groups if there is more than one rank, so that the gather
+    // combines the sensitivities of both groups
+    const unsigned int
+    n_groups = std::min(2u, func_eval.n_processors());
+    
+    func_eval.set_n_sensitivity_groups(n_groups);
+    
+    BOOST_CHECK_EQUAL(func_eval.n_sensitivity_groups(), n_groups);
+    BOOST_CHECK_LT(func_eval.sensitivity_group(), n_groups);
+    BOOST_CHECK_LE(func_eval.sensitivity_comm().size(), func_eval.n_processors());
+    
+    const unsigned int
+    n_vars = func_eval.n_vars(),
+    n_ineq = func_eval.n_ineq();
+    
+    std::vector<Real>
+    x,
+    xmin,
+    xmax,
+    obj_grad(n_vars, 0.),
+    fvals(n_ineq, 0.),
+    grads(n_vars*n_ineq, 0.);
+    
+    std::vector<bool>
+    eval_grads(n_ineq, true);
+    
+    Real
+    obj      = 0.;
+    
+    func_eval.init_dvar(x, xmin, xmax);
+    func_eval.evaluate(x, obj, true, obj_grad, fvals, eval_grads, grads);
+    
+    // all ranks hold the sensitivities of all variables
+    for (unsigned int j=0; j<n_vars; j++) {
+        
+        BOOST_CHECK(MAST::compare_value(2.*x[j], obj_grad[j], tol));
+        
+        for (unsigned int i=0; i<n_ineq; i++)
+            BOOST_CHECK(MAST::compare_value((i+1.)*j, grads[j*n_ineq+i], tol));
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
@@ -0,0 +1,182 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2017  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+// BOOST includes
+#include <boost/test/unit_test.hpp>
+
+
+// MAST includes
+#include "optimization/mma_optimization_interface.h"
+#include "optimization/distributed_function_evaluation.h"
+#include "tests/base/test_comparisons.h"
+
+
+// libMesh includes
+#include "libmesh/libmesh.h"
+#include "libmesh/numeric_vector.h"
+
+
+extern libMesh::LibMeshInit* __init;
+
+
+namespace {
+    
+    /*!
+     *   the subproblem is defined directly, so that the function
+     *   evaluation only provides the communicator
+     */
+    class NoEvaluation:
+    public MAST::DistributedFunctionEvaluation {
+        
+    public:
+        
+        NoEvaluation(const libMesh::Parallel::Communicator& comm_in):
+        MAST::DistributedFunctionEvaluation(comm_in)
+        { }
+        
+        using MAST::DistributedFunctionEvaluation::init_dvar;
+        using MAST::DistributedFunctionEvaluation::evaluate;
+        
+        virtual std::auto_ptr<libMesh::NumericVector<Real> >
+        build_dvar_vector() {
+            
+            libmesh_error();
+            return std::auto_ptr<libMesh::NumericVector<Real> >();
+        }
+        
+        virtual void init_dvar(libMesh::NumericVector<Real>& x,
+                               libMesh::NumericVector<Real>& xmin,
+                               libMesh::NumericVector<Real>& xmax) {
+            
+            libmesh_error();
+        }
+        
+        virtual void evaluate(const libMesh::NumericVector<Real>& dvars,
+                              Real& obj,
+                              bool eval_obj_grad,
+                              libMesh::NumericVector<Real>& obj_grad,
+                              std::vector<Real>& fvals,
+                              std::vector<bool>& eval_grads,
+                              MAST::DistributedConstraintGradients& grads) {
+            
+            libmesh_error();
+        }
+    };
+    
+    
+    // exposes the subproblem of the MMA optimizer
+    struct MMADualSubproblem:
+    public MAST::MMAOptimizationInterface {
+        
+        using MAST::MMAOptimizationInterface::_solve_subproblem;
+        using MAST::MMAOptimizationInterface::_dist_feval;
+        using MAST::MMAOptimizationInterface::_n_con;
+        using MAST::MMAOptimizationInterface::_x;
+        using MAST::MMAOptimizationInterface::_x_sub;
+        using MAST::MMAOptimizationInterface::_low;
+        using MAST::MMAOptimizationInterface::_upp;
+        using MAST::MMAOptimizationInterface::_alpha;
+        using MAST::MMAOptimizationInterface::_beta;
+        using MAST::MMAOptimizationInterface::_p0;
+        using MAST::MMAOptimizationInterface::_q0;
+        using MAST::MMAOptimizationInterface::_pq;
+        using MAST::MMAOptimizationInterface::_b;
+        using MAST::MMAOptimizationInterface::_lambda;
+    };
+}
+
+
+
+BOOST_AUTO_TEST_SUITE  (MMADualSubproblem)
+
+BOOST_AUTO_TEST_CASE   (KnownKKTPoint) {
+    
+    //
+    // with L = 0 and U = 2 for all variables, the subproblem
+    //
+    //   min   1/x1 + 4/x2 + 1/x3
+    //   s.t.  1/(2-x1) + 1/(2-x2) <= 5/2
+    //         1/x1                <= 5
+    //         0.1 <= x_j <= 1.9
+    //
+    // has the KKT point x = (1, 4/3, 1.9) with the multipliers
+    // lambda = (1, 0): the first constraint is active, the second is
+    // inactive, and x3 is at its upper bound. The subproblem solution
+    // for a variable that is free is
+    //   x = (sqrt(P) L + sqrt(Q) U)/(sqrt(P) + sqrt(Q)),
+    // which gives x1 = 2/(1+1) and x2 = 4/(1+2) with lambda_1 = 1.
+    // The dual iterations start at lambda = 0, where all variables are
+    // at their upper bounds.
+    //
+    NoEvaluation       feval(__init->comm());
+    MMADualSubproblem  mma;
+    
+    mma._dist_feval  = &feval;
+    mma._n_con       = 2;
+    mma._b.resize(2);
+    mma._b[0]        = 2.5;
+    mma._b[1]        = 5.;
+    mma._lambda.assign(2, 0.);
+    
+    // the variables are local to the first rank
+    if (__init->comm().rank() == 0) {
+        
+        const unsigned int n = 3;
+        
+        mma._x.assign    (n, 1.);
+        mma._low.assign  (n, 0.);
+        mma._upp.assign  (n, 2.);
+        mma._alpha.assign(n, 0.1);
+        mma._beta.assign (n, 1.9);
+        
+        mma._p0.assign(n, 0.);
+        mma._q0.resize(n);
+        mma._q0[0] = 1.;
+        mma._q0[1] = 4.;
+        mma._q0[2] = 1.;
+        
+        // (constraint id, (p, q)) for each variable
+        mma._pq.resize(n);
+        mma._pq[0].push_back(std::make_pair(0, std::make_pair(1., 0.)));
+        mma._pq[0].push_back(std::make_pair(1, std::make_pair(0., 1.)));
+        mma._pq[1].push_back(std::make_pair(0, std::make_pair(1., 0.)));
+    }
+    
+    mma._solve_subproblem();
+    
+    const Real
+    tol   = 1.e-6;
+    
+    BOOST_TEST_MESSAGE("  ** lambda = (" << mma._lambda[0]
+                       << ", " << mma._lambda[1] << ") **");
+    BOOST_CHECK(MAST::compare_value(1., mma._lambda[0], tol));
+    BOOST_CHECK_EQUAL(mma._lambda[1], 0.);
+    
+    if (__init->comm().rank() == 0) {
+        
+        BOOST_CHECK(MAST::compare_value(   1., mma._x_sub[0], tol));
+        BOOST_CHECK(MAST::compare_value(4./3., mma._x_sub[1], tol));
+        BOOST_CHECK(MAST::compare_value(  1.9, mma._x_sub[2], tol));
+    }
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
+
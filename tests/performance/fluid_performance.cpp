@@ -0,0 +1,126 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2017  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+// BOOST includes
+#include <boost/test/unit_test.hpp>
+
+// MAST includes
+#include "tests/fluid/build_conservative_fluid_elem.h"
+#include "tests/base/performance_check.h"
+#include "fluid/frequency_domain_linearized_conservative_fluid_elem.h"
+#include "fluid/conservative_fluid_discipline.h"
+#include "fluid/conservative_fluid_system_initialization.h"
+#include "base/parameter.h"
+
+
+// the performance tests are disabled by default, and are run with
+// --run_test=FluidPerformance
+BOOST_FIXTURE_TEST_SUITE  (FluidPerformance,
+                           MAST::BuildConservativeFluidElem,
+                           * boost::unit_test::disabled())
+
+
+BOOST_AUTO_TEST_CASE   (FreqDomainJacobianCheck) {
+    
+    // set the frequency value
+    *_omega = 100.;
+    
+    // make sure there is only one element in the mesh.
+    libmesh_assert_equal_to(_mesh->n_elem(), 1);
+    libMesh::Elem& e = **_mesh->local_elements_begin();
+    
+    const MAST::FlightCondition& p =
+    dynamic_cast<MAST::ConservativeFluidDiscipline*>(_discipline)->flight_condition();
+    
+    std::auto_ptr<MAST::FrequencyDomainLinearizedConservativeFluidElem>
+    elem(new MAST::FrequencyDomainLinearizedConservativeFluidElem(*_fluid_sys, e, p));
+    elem->freq   = _freq_function;
+    
+    const Real
+    delta    = 1.e-5;
+    
+    const Complex
+    iota(0., 1.);
+    
+    // number of dofs in this element
+    const unsigned int ndofs = 16;
+    
+    RealVectorX
+    x_base      = RealVectorX::Zero(ndofs);
+    
+    ComplexVectorX
+    x           = ComplexVectorX::Zero(ndofs),
+    res0        = ComplexVectorX::Zero(ndofs),
+    res         = ComplexVectorX::Zero(ndofs);
+    
+    ComplexMatrixX
+    jac_x       = ComplexMatrixX::Zero(ndofs, ndofs),
+    jac_x_fd    = ComplexMatrixX::Zero(ndofs, ndofs),
+    dummy;
+    
+    elem->set_velocity(x_base);
+    
+    // initialize the base solution vector. The 2D elem has 4 variables
+    for (unsigned int i=0; i<4; i++)
+        for (unsigned int j=0; j<4; j++)
+            x_base(i*4+j) = _base_sol(i);
+    elem->set_solution(x_base);
+    
+    MAST::PerformanceCheck
+    perf("FluidPerformance/FreqDomainJacobianCheck");
+    
+    // each sample is the Jacobian and its finite difference approximation
+    // with real and imaginary perturbations, as computed by
+    // FreqDomainJacobianEvaluation
+    for (unsigned int k=0; k<20; k++) {
+        
+        perf.start();
+        
+        x.setZero();
+        elem->set_complex_solution(x);
+        res0.setZero();
+        jac_x.setZero();
+        elem->internal_residual(true, res0, jac_x);
+        
+        for (unsigned int i=0; i<ndofs; i++) {
+            
+            x      = ComplexVectorX::Zero(ndofs);
+            x(i)  += delta;
+            elem->set_complex_solution(x);
+            res.setZero();
+            elem->internal_residual(false, res, dummy);
+            jac_x_fd.col(i) = (res-res0)/delta;
+            
+            x      = ComplexVectorX::Zero(ndofs);
+            x(i)  += delta * iota;
+            elem->set_complex_solution(x);
+            res.setZero();
+            elem->internal_residual(false, res, dummy);
+            jac_x_fd.col(i) = (res-res0)/delta/iota;
+        }
+        
+        perf.stop();
+    }
+    
+    BOOST_CHECK(perf.check());
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
+
@@ -0,0 +1,96 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2017  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+// BOOST includes
+#include <boost/test/unit_test.hpp>
+
+
+// MAST includes
+#include "examples/structural/plate_modal_analysis/plate_modal_analysis.h"
+#include "tests/base/performance_check.h"
+#include "elasticity/structural_nonlinear_assembly.h"
+#include "base/nonlinear_system.h"
+
+// libMesh includes
+#include "libmesh/numeric_vector.h"
+#include "libmesh/sparse_matrix.h"
+
+
+// the performance tests are disabled by default, and are run with
+// --run_test=StructuralPerformance
+BOOST_FIXTURE_TEST_SUITE  (StructuralPerformance,
+                           MAST::PlateModalAnalysis,
+                           * boost::unit_test::disabled())
+
+BOOST_AUTO_TEST_CASE   (PlateJacobianAssembly) {
+    
+    // 100x100 plate
+    this->init(libMesh::QUAD4, false, 100);
+    
+    MAST::StructuralNonlinearAssembly   assembly;
+    assembly.attach_discipline_and_system(*_discipline, *_structural_sys);
+    
+    libMesh::NumericVector<Real>
+    &X   = *_sys->solution;
+    libMesh::SparseMatrix<Real>
+    &J   = *_sys->matrix;
+    
+    X.zero();
+    X.close();
+    
+    MAST::PerformanceCheck
+    perf("StructuralPerformance/PlateJacobianAssembly");
+    
+    for (unsigned int i=0; i<5; i++) {
+        
+        perf.start();
+        assembly.residual_and_jacobian(X, nullptr, &J, *_sys);
+        perf.stop();
+    }
+    
+    assembly.clear_discipline_and_system();
+    
+    BOOST_CHECK(perf.check());
+}
+
+
+
+BOOST_AUTO_TEST_CASE   (PlateModalSolve) {
+    
+    this->init(libMesh::QUAD4, false);
+    
+    std::vector<Real>
+    eig;
+    
+    MAST::PerformanceCheck
+    perf("StructuralPerformance/PlateModalSolve");
+    
+    for (unsigned int i=0; i<3; i++) {
+        
+        perf.start();
+        this->solve(false, &eig);
+        perf.stop();
+    }
+    
+    BOOST_CHECK(perf.check());
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
+
@@ -0,0 +1,191 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2017  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+// BOOST includes
+#include <boost/test/unit_test.hpp>
+
+
+// MAST includes
+#include "examples/structural/beam_bending/beam_bending.h"
+#include "tests/base/test_comparisons.h"
+#include "elasticity/structural_nonlinear_assembly.h"
+#include "elasticity/stress_functional_output_assembly.h"
+#include "elasticity/stress_output_base.h"
+#include "base/physics_discipline_base.h"
+#include "base/nonlinear_system.h"
+#include "base/parameter.h"
+
+
+// libMesh includes
+#include "libmesh/numeric_vector.h"
+#include "libmesh/parameter_vector.h"
+
+
+
+BOOST_FIXTURE_TEST_SUITE  (Structural1DBeamAdjointSensitivity,
+                           MAST::BeamBending)
+
+BOOST_AUTO_TEST_CASE   (BeamBendingStressFunctionalAdjointSensitivity) {
+    
+    const Real
+    tol      = 1.e-6,
+    fd_tol   = 1.e-3,
+    delta    = 1.e-5;
+    
+    this->init(libMesh::EDGE2, false);
+    this->solve();
+    
+    // p-norm of the von Mises stress at the points used by the outputs
+    // of each element, evaluated on all elements
+    std::vector<libMesh::Point> pts;
+    pts.push_back(libMesh::Point(-1/sqrt(3), 1., 0.)); // upper skin
+    pts.push_back(libMesh::Point(-1/sqrt(3),-1., 0.)); // lower skin
+    pts.push_back(libMesh::Point( 1/sqrt(3), 1., 0.)); // upper skin
+    pts.push_back(libMesh::Point( 1/sqrt(3),-1., 0.)); // lower skin
+    
+    MAST::StressStrainOutputBase output;
+    output.set_points_for_evaluation(pts);
+    output.set_volume_loads(_discipline->volume_loads());
+    output.set_stress_functional(MAST::VON_MISES_P_NORM_FUNCTIONAL, 4.);
+    
+    MAST::StructuralNonlinearAssembly       assembly;
+    MAST::StressFunctionalOutputAssembly    output_assembly(output);
+    
+    assembly.attach_discipline_and_system(*_discipline, *_structural_sys);
+    output_assembly.attach_discipline_and_system(*_discipline, *_structural_sys);
+    
+    MAST::NonlinearSystem& nonlin_sys = assembly.system();
+    
+    const Real
+    q0 = output_assembly.calculate_output(*nonlin_sys.solution);
+    BOOST_CHECK(q0 > 0.);
+    
+    // one adjoint solution is used for all parameters
+    nonlin_sys.adjoint_solve(output_assembly);
+    
+    libMesh::ParameterVector params;
+    params.resize(1);
+    
+    for (unsigned int i=0; i<_params_for_sensitivity.size(); i++) {
+        
+        MAST::Parameter& p = *_params_for_sensitivity[i];
+        
+        _discipline->add_parameter(p);
+        params[0]  =  p.ptr();
+        
+        // direct sensitivity
+        nonlin_sys.add_sensitivity_solution(0).zero();
+        nonlin_sys.sensitivity_solve(params);
+        
+        const Real
+        direct  = output_assembly.calculate_output_sensitivity
+        (*nonlin_sys.solution, p, &nonlin_sys.get_sensitivity_solution(0)),
+        adjoint = output_assembly.calculate_adjoint_sensitivity
+        (assembly, params, 0, nonlin_sys.get_adjoint_solution(0));
+        
+        BOOST_TEST_MESSAGE("  ** dq/dp (adjoint vs direct): " << p.name() << " **");
+        BOOST_CHECK(MAST::compare_value(direct, adjoint, tol));
+        
+        // central difference of the output of the perturbed solutions
+        const Real
+        p0 = p(),
+        dp = delta * p0;
+        
+        p() = p0 + dp;
+        nonlin_sys.solution->zero();
+        nonlin_sys.solve();
+        const Real qp = output_assembly.calculate_output(*nonlin_sys.solution);
+        
+        p() = p0 - dp;
+        nonlin_sys.solution->zero();
+        nonlin_sys.solve();
+        const Real qm = output_assembly.calculate_output(*nonlin_sys.solution);
+        
+        p() = p0;
+        nonlin_sys.solution->zero();
+        nonlin_sys.solve();
+        
+        BOOST_TEST_MESSAGE("  ** dq/dp (adjoint vs FD): " << p.name() << " **");
+        BOOST_CHECK(MAST::compare_value((qp-qm)/(2.*dp), adjoint, fd_tol));
+        
+        _discipline->remove_parameter(p);
+    }
+    
+    output_assembly.clear_discipline_and_system();
+    assembly.clear_discipline_and_system();
+}
+
+
+BOOST_AUTO_TEST_CASE   (BeamBendingStressFunctionalDerivative) {
+    
+    const Real
+    tol      = 1.e-3,
+    delta    = 1.e-6;
+    
+    this->init(libMesh::EDGE2, false);
+    this->solve();
+    
+    std::vector<libMesh::Point> pts;
+    pts.push_back(libMesh::Point(-1/sqrt(3), 1., 0.)); // upper skin
+    pts.push_back(libMesh::Point(-1/sqrt(3),-1., 0.)); // lower skin
+    
+    MAST::StressStrainOutputBase output;
+    output.set_points_for_evaluation(pts);
+    output.set_volume_loads(_discipline->volume_loads());
+    output.set_stress_functional(MAST::VON_MISES_KS_FUNCTIONAL, 10.);
+    
+    MAST::StructuralNonlinearAssembly       assembly;
+    MAST::StressFunctionalOutputAssembly    output_assembly(output);
+    
+    assembly.attach_discipline_and_system(*_discipline, *_structural_sys);
+    output_assembly.attach_discipline_and_system(*_discipline, *_structural_sys);
+    
+    MAST::NonlinearSystem& nonlin_sys = assembly.system();
+    
+    std::auto_ptr<libMesh::NumericVector<Real> >
+    dq_dX (nonlin_sys.solution->zero_clone().release()),
+    X     (nonlin_sys.solution->clone().release());
+    
+    output_assembly.assemble_output_derivative(*X, *dq_dX);
+    
+    // the derivative along the solution is compared with a central
+    // difference of the output
+    const Real
+    h  = delta / X->l2_norm();
+    
+    X->scale(1.+h);
+    X->close();
+    const Real qp = output_assembly.calculate_output(*X);
+    
+    X->scale((1.-h)/(1.+h));
+    X->close();
+    const Real qm = output_assembly.calculate_output(*X);
+    
+    BOOST_CHECK(MAST::compare_value((qp-qm)/(2.*h),
+                                    dq_dX->dot(*nonlin_sys.solution),
+                                    tol));
+    
+    output_assembly.clear_discipline_and_system();
+    assembly.clear_discipline_and_system();
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
+
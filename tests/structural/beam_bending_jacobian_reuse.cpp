@@ -0,0 +1,303 @@
+/*
+ * MAST: Multidisciplinary-design Adaptation and Sensitivity Toolkit
+ * Copyright (C) 2013-2017  Manav Bhatia
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+// BOOST includes
+#include <boost/test/unit_test.hpp>
+
+
+// MAST includes
+#include "examples/structural/beam_bending/beam_bending.h"
+#include "tests/base/test_comparisons.h"
+#include "elasticity/structural_nonlinear_assembly.h"
+#include "elasticity/structural_discipline.h"
+#include "elasticity/structural_system_initialization.h"
+#include "base/nonlinear_system.h"
+#include "base/parameter.h"
+#include "base/performance_log.h"
+
+
+// libMesh includes
+#include "libmesh/numeric_vector.h"
+#include "libmesh/sparse_matrix.h"
+#include "libmesh/mesh_refinement.h"
+
+
+// copies the local entries of \p v to \p vec
+static void
+beam_local_solution(const libMesh::NumericVector<Real>& v,
+                    RealVectorX& vec) {
+    
+    const libMesh::numeric_index_type
+    first = v.first_local_index(),
+    last  = v.last_local_index();
+    
+    vec = RealVectorX::Zero(last-first);
+    
+    for (libMesh::numeric_index_type i=first; i<last; i++)
+        vec(i-first) = v.el(i);
+}
+
+
+
+// solves the system with \p assembly, which is attached to the system,
+// uniformly refines the mesh and solves again. The solution on the
+// refined mesh is compared with that of a new assembly.
+static void
+beam_solve_after_refinement(MAST::StructuralNonlinearAssembly& assembly,
+                            libMesh::SerialMesh& mesh,
+                            libMesh::EquationSystems& eq_sys,
+                            MAST::NonlinearSystem& sys,
+                            MAST::StructuralDiscipline& discipline,
+                            MAST::StructuralSystemInitialization& sys_init) {
+    
+    const Real
+    tol      = 1.e-6;
+    
+    RealVectorX
+    sol0,
+    sol;
+    
+    sys.solution->zero();
+    sys.solve();
+    
+    // the matrix of the system is retained by reinit(), so that only
+    // clear_mesh_dependent_data() tells the assembly that the Jacobian
+    // must be reassembled
+    libMesh::MeshRefinement(mesh).uniformly_refine(1);
+    eq_sys.reinit();
+    assembly.clear_mesh_dependent_data();
+    
+    sys.solution->zero();
+    sys.solve();
+    beam_local_solution(*sys.solution, sol);
+    
+    assembly.clear_discipline_and_system();
+    
+    // reference solution with a new assembly
+    MAST::StructuralNonlinearAssembly   ref_assembly;
+    ref_assembly.attach_discipline_and_system(discipline, sys_init);
+    
+    sys.solution->zero();
+    sys.solve();
+    beam_local_solution(*sys.solution, sol0);
+    
+    ref_assembly.clear_discipline_and_system();
+    
+    BOOST_CHECK(MAST::compare_vector(sol0, sol, tol));
+}
+
+
+
+BOOST_FIXTURE_TEST_SUITE  (Structural1DBeamJacobianReuse,
+                           MAST::BeamBending)
+
+BOOST_AUTO_TEST_CASE   (BeamBendingNonlinearJacobianLag) {
+    
+    const Real
+    tol      = 1.e-4;
+    
+    this->init(libMesh::EDGE2, true);
+    
+    RealVectorX
+    sol0,
+    sol;
+    
+    // reference solution with a Jacobian on every Newton step
+    this->solve();
+    beam_local_solution(*_sys->solution, sol0);
+    
+    // the lagged Jacobian is retained by the solver between the
+    // Newton steps in which it is not reassembled
+    MAST::StructuralNonlinearAssembly   assembly;
+    assembly.attach_discipline_and_system(*_discipline, *_structural_sys);
+    assembly.set_jacobian_lag(2);
+    
+    _sys->solution->zero();
+    _sys->solve();
+    
+    assembly.clear_discipline_and_system();
+    
+    beam_local_solution(*_sys->solution, sol);
+    
+    BOOST_CHECK(MAST::compare_vector(sol0, sol, tol));
+}
+
+
+
+BOOST_AUTO_TEST_CASE   (BeamBendingSolutionIndependentJacobian) {
+    
+    const Real
+    tol      = 1.e-6;
+    
+    this->init(libMesh::EDGE2, false);
+    
+    RealVectorX
+    sol0,
+    sol;
+    
+    MAST::StructuralNonlinearAssembly   assembly;
+    assembly.attach_discipline_and_system(*_discipline, *_structural_sys);
+    assembly.set_solution_independent_jacobian(true);
+    
+    _sys->solution->zero();
+    _sys->solve();
+    beam_local_solution(*_sys->solution, sol0);
+    
+    // the second and third solves only assemble the residual, and use
+    // the Jacobian that was retained by the solver
+    _sys->solution->zero();
+    _sys->solve();
+    beam_local_solution(*_sys->solution, sol);
+    
+    BOOST_CHECK(MAST::compare_vector(sol0, sol, tol));
+    
+    // the solution of the linear problem scales with the load
+    (*_press)() *= 2.;
+    
+    _sys->solution->zero();
+    _sys->solve();
+    beam_local_solution(*_sys->solution, sol);
+    
+    (*_press)() /= 2.;
+    
+    assembly.clear_discipline_and_system();
+    
+    BOOST_CHECK(MAST::compare_vector(2.*sol0, sol, tol));
+}
+
+
+
+BOOST_AUTO_TEST_CASE   (BeamBendingSolutionIndependentJacobianRefinement) {
+    
+    this->init(libMesh::EDGE2, false);
+    
+    MAST::StructuralNonlinearAssembly   assembly;
+    assembly.attach_discipline_and_system(*_discipline, *_structural_sys);
+    assembly.set_solution_independent_jacobian(true);
+    
+    beam_solve_after_refinement(assembly, *_mesh, *_eq_sys, *_sys,
+                                *_discipline, *_structural_sys);
+}
+
+
+
+BOOST_AUTO_TEST_CASE   (BeamBendingJacobianLagRefinement) {
+    
+    this->init(libMesh::EDGE2, false);
+    
+    // the lag is long enough to skip the first request after refinement
+    MAST::StructuralNonlinearAssembly   assembly;
+    assembly.attach_discipline_and_system(*_discipline, *_structural_sys);
+    assembly.set_jacobian_lag(10);
+    
+    beam_solve_after_refinement(assembly, *_mesh, *_eq_sys, *_sys,
+                                *_discipline, *_structural_sys);
+}
+
+
+
+BOOST_AUTO_TEST_CASE   (BeamBendingIncrementalAssembly) {
+    
+    const Real
+    tol      = 1.e-10;
+    
+    this->init(libMesh::EDGE2, false);
+    
+    // the element quantities are recomputed only for changes in the
+    // parameters of the discipline
+    _discipline->add_parameter(*_thy);
+    
+    MAST::StructuralNonlinearAssembly   assembly;
+    assembly.attach_discipline_and_system(*_discipline, *_structural_sys);
+    
+    _sys->solve();
+    
+    const libMesh::NumericVector<Real>&
+    X  = *_sys->solution;
+    libMesh::NumericVector<Real>&
+    R  = *_sys->rhs;
+    libMesh::SparseMatrix<Real>&
+    J  = *_sys->matrix;
+    
+    std::auto_ptr<libMesh::NumericVector<Real> >
+    v(X.clone().release()),
+    R0(X.zero_clone().release()),
+    JV0(X.zero_clone().release()),
+    JV(X.zero_clone().release());
+    
+    // the Jacobian is compared through its product with v
+    v->add(1.);
+    
+    // reference quantities for the modified parameter
+    (*_thy)() *= 1.1;
+    assembly.residual_and_jacobian(X, &R, &J, *_sys);
+    *R0 = R;
+    J.vector_mult(*JV0, *v);
+    (*_thy)() /= 1.1;
+    
+    assembly.set_incremental_assembly(true);
+    
+    MAST::PerformanceLog::Event&
+    elem_calcs = MAST::perf_log.register_event("elem_calculations()",
+                                               "NonlinearImplicitAssembly");
+    
+    const bool
+    log_enabled = MAST::perf_log.enabled();
+    MAST::perf_log.enable();
+    
+    // the residual and Jacobian are requested in separate calls, as
+    // done by SNES
+    assembly.residual_and_jacobian(X, &R, nullptr, *_sys);
+    assembly.residual_and_jacobian(X, nullptr, &J, *_sys);
+    
+    // no element is recomputed for the same solution and parameters
+    MAST::perf_log.reset();
+    assembly.residual_and_jacobian(X, &R, nullptr, *_sys);
+    assembly.residual_and_jacobian(X, nullptr, &J, *_sys);
+    
+    BOOST_CHECK_EQUAL(elem_calcs.count.load(), 0ull);
+    
+    // the elements that depend on the modified parameter are recomputed
+    // once for each quantity, which are all elements of the beam
+    (*_thy)() *= 1.1;
+    MAST::perf_log.reset();
+    assembly.residual_and_jacobian(X, &R, nullptr, *_sys);
+    assembly.residual_and_jacobian(X, nullptr, &J, *_sys);
+    (*_thy)() /= 1.1;
+    
+    BOOST_CHECK_EQUAL(elem_calcs.count.load(),
+                      2ull * _mesh->n_active_local_elem());
+    
+    MAST::perf_log.enable(log_enabled);
+    
+    J.vector_mult(*JV, *v);
+    
+    R.add(-1., *R0);
+    JV->add(-1., *JV0);
+    
+    BOOST_CHECK_LE(R.linfty_norm(),   tol * R0->linfty_norm());
+    BOOST_CHECK_LE(JV->linfty_norm(), tol * JV0->linfty_norm());
+    
+    assembly.clear_discipline_and_system();
+    _discipline->remove_parameter(*_thy);
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -99,17 +99,17 @@ BOOST_FIXTURE_TEST_SUITE  (Structural1DBeamBending,
 //        // get the element and the nodes to evaluate the stress
 //        const libMesh::Elem& e  = **(_outputs[i]->get_elem_subset().begin());
 //        
-//        const std::vector<MAST::StressStrainOutputBase::Data*>&
+//        std::vector<MAST::StressStrainOutputBase::Data>
 //        data = _outputs[i]->get_stress_strain_data_for_elem(&e);
 //        
 //        // find the location of quadrature point
 //        for (unsigned int j=0; j<data.size(); j++) {
 //            
 //            // logitudinal strain for this location
-//            numerical = data[j]->stress()(0);
+//            numerical = data[j].stress()(0);
 //            
-//            xi   = data[j]->point_location_in_element_coordinate()(0);
-//            eta  = data[j]->point_location_in_element_coordinate()(1);
+//            xi   = data[j].point_location_in_element_coordinate()(0);
+//            eta  = data[j].point_location_in_element_coordinate()(1);
 //            
 //            // assuming linear Lagrange interpolation for elements
 //            x =  e.point(0)(0) * (1.-xi)/2. +  e.point(1)(0) * (1.+xi)/2.;
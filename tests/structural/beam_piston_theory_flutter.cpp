@@ -33,6 +33,8 @@
 #include "property_cards/isotropic_material_property_card.h"
 #include "elasticity/structural_element_base.h"
 #include "base/nonlinear_system.h"
+#include "aeroelasticity/time_domain_flutter_solver.h"
+#include "aeroelasticity/flutter_root_base.h"
 
 
 BOOST_FIXTURE_TEST_SUITE  (Structural1DBeamPistonTheoryFlutterAnalysis,
@@ -145,6 +147,44 @@ BOOST_AUTO_TEST_CASE    (BeamPistonTheoryFlutterSolutionSensitivity) {
     }
 }
 
+
+
+BOOST_AUTO_TEST_CASE    (BeamPistonTheoryFullOrderFlutterSolution) {
+    
+    const Real
+    tol      = 5.e-2;
+    
+    this->init(libMesh::EDGE2, false);
+    
+    const Real
+    V0       = this->solve(false);
+    
+    // the roots closest to zero of the full order quadratic eigenproblem,
+    // which include the conjugate pairs of the modes in the reduced basis
+    _flutter_solver->set_quadratic_eigensolver(true, 6, 0.);
+    _flutter_solver->set_full_order_eigensolver(true);
+    
+    const Real
+    V        = this->solve(false);
+    
+    BOOST_CHECK(MAST::compare_value(V0, V, tol));
+    
+    // the full order eigensolver does not provide the eigenvectors
+    // required for the sensitivity
+    BOOST_CHECK_EQUAL(_flutter_root->eig_vec_right.size(), 0);
+    BOOST_CHECK_EQUAL(_flutter_root->eig_vec_left.size(),  0);
+    
+    libMesh::ParameterVector params;
+    params.resize(1);
+    params[0] = _thy->ptr();
+    
+    BOOST_CHECK_THROW(_flutter_solver->calculate_sensitivity(*_flutter_root, params, 0),
+                      std::exception);
+    
+    _flutter_solver->set_full_order_eigensolver(false);
+    _flutter_solver->set_quadratic_eigensolver(false);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 
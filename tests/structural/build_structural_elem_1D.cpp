@@ -69,7 +69,8 @@ _thermal_load(nullptr) {
 
 void
 MAST::BuildStructural1DElem::init(bool if_link_offset_to_th,
-                                  bool if_nonlinear) {
+                                  bool if_nonlinear,
+                                  libMesh::ElemType e_type) {
 
     // make sure that this has not already been initialized
     libmesh_assert(!_initialized);
@@ -78,7 +79,7 @@ MAST::BuildStructural1DElem::init(bool if_link_offset_to_th,
     _mesh       = new libMesh::SerialMesh(__init->comm());
     
     // initialize the mesh with one element
-    libMesh::MeshTools::Generation::build_line(*_mesh, 1, 0, 2);
+    libMesh::MeshTools::Generation::build_line(*_mesh, 1, 0, 2, e_type);
     
     // create the equation system
     _eq_sys    = new  libMesh::EquationSystems(*_mesh);
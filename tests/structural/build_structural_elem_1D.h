@@ -59,7 +59,8 @@ namespace MAST {
 
         
         void init(bool if_link_offset_to_th,
-                  bool if_nonlinear);
+                  bool if_nonlinear,
+                  libMesh::ElemType e_type = libMesh::EDGE2);
         
         
         bool _initialized;
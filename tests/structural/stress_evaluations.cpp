@@ -251,17 +251,17 @@ void check_stress (ValType& v, const RealVectorX& x0) {
     
     // get access to the vector of stress/strain data for this element.
     {
-        const std::vector<MAST::StressStrainOutputBase::Data*>&
+        std::vector<MAST::StressStrainOutputBase::Data>
         stress_data = output.get_stress_strain_data_for_elem(&elem);
         
         libmesh_assert_equal_to(stress_data.size(), 1); // this should have one element
         
-        stress0     = stress_data[0]->stress();
-        strain0     = stress_data[0]->strain();
-        dstressdX0  = stress_data[0]->get_dstress_dX();
-        dstraindX0  = stress_data[0]->get_dstrain_dX();
-        vm0         = stress_data[0]->von_Mises_stress();
-        dvm_dX0     = stress_data[0]->dvon_Mises_stress_dX();
+        stress0     = stress_data[0].stress();
+        strain0     = stress_data[0].strain();
+        dstressdX0  = stress_data[0].get_dstress_dX();
+        dstraindX0  = stress_data[0].get_dstrain_dX();
+        vm0         = stress_data[0].von_Mises_stress();
+        dvm_dX0     = stress_data[0].dvon_Mises_stress_dX();
         vmf0        = output.von_Mises_p_norm_functional_for_all_elems(pval);
         dvmf_dX0    = output.von_Mises_p_norm_functional_state_derivartive_for_all_elems(pval);
         
@@ -279,16 +279,16 @@ void check_stress (ValType& v, const RealVectorX& x0) {
         
         // now use the updated stress to calculate the finite difference data
         {
-            const std::vector<MAST::StressStrainOutputBase::Data*>&
+            std::vector<MAST::StressStrainOutputBase::Data>
             stress_data = output.get_stress_strain_data_for_elem(&elem);
             
             libmesh_assert_equal_to(stress_data.size(), 1); // this should have one element
             
-            stress              = stress_data[0]->stress();
-            strain              = stress_data[0]->strain();
+            stress              = stress_data[0].stress();
+            strain              = stress_data[0].strain();
             dstressdX_fd.col(i) = (stress-stress0)/delta;
             dstraindX_fd.col(i) = (strain-strain0)/delta;
-            vm                  = stress_data[0]->von_Mises_stress();
+            vm                  = stress_data[0].von_Mises_stress();
             dvm_dX_fd(i)        = (vm-vm0)/delta;
             dvmf_dX_fd(i)       = (output.von_Mises_p_norm_functional_for_all_elems(pval)-vm0)/delta;
             
@@ -328,14 +328,14 @@ void check_stress (ValType& v, const RealVectorX& x0) {
 
         // next, check the total derivative of the quantity wrt the parameter
         {
-            const std::vector<MAST::StressStrainOutputBase::Data*>&
+            std::vector<MAST::StressStrainOutputBase::Data>
             stress_data = output.get_stress_strain_data_for_elem(&elem);
             
             libmesh_assert_equal_to(stress_data.size(), 1); // this should have one element
             
-            dstressdp           = stress_data[0]->get_stress_sensitivity(&f);
-            dstraindp           = stress_data[0]->get_strain_sensitivity(&f);
-            dvmdp               = stress_data[0]->dvon_Mises_stress_dp  (&f);
+            dstressdp           = stress_data[0].get_stress_sensitivity(&f);
+            dstraindp           = stress_data[0].get_strain_sensitivity(&f);
+            dvmdp               = stress_data[0].dvon_Mises_stress_dp  (&f);
             dvmf_dp             =
             output.von_Mises_p_norm_functional_sensitivity_for_all_elems(pval, &f);
             
@@ -357,14 +357,14 @@ void check_stress (ValType& v, const RealVectorX& x0) {
         
         // next, check the total derivative of the quantity wrt the parameter
         {
-            const std::vector<MAST::StressStrainOutputBase::Data*>&
+            std::vector<MAST::StressStrainOutputBase::Data>
             stress_data = output.get_stress_strain_data_for_elem(&elem);
             
             libmesh_assert_equal_to(stress_data.size(), 1); // this should have one element
             
-            stress              = (stress_data[0]->stress() - stress0)/dp;
-            strain              = (stress_data[0]->strain() - strain0)/dp;
-            vm                  = (stress_data[0]->von_Mises_stress() - vm0)/dp;
+            stress              = (stress_data[0].stress() - stress0)/dp;
+            strain              = (stress_data[0].strain() - strain0)/dp;
+            vm                  = (stress_data[0].von_Mises_stress() - vm0)/dp;
             dvmf_dp_fd          =
             (output.von_Mises_p_norm_functional_for_all_elems(pval)-vmf0)/dp;
             
@@ -415,14 +415,14 @@ void check_stress (ValType& v, const RealVectorX& x0) {
 
             {
                 // copy it for comparison
-                const std::vector<MAST::StressStrainOutputBase::Data*>&
+                std::vector<MAST::StressStrainOutputBase::Data>
                 stress_data = output.get_stress_strain_data_for_elem(&elem);
                 
                 libmesh_assert_equal_to(stress_data.size(), 1); // this should have one element
                 
-                dstressdp           = stress_data[0]->get_stress_sensitivity(&f);
-                dstraindp           = stress_data[0]->get_strain_sensitivity(&f);
-                dvmdp               = stress_data[0]->dvon_Mises_stress_dp  (&f);
+                dstressdp           = stress_data[0].get_stress_sensitivity(&f);
+                dstraindp           = stress_data[0].get_strain_sensitivity(&f);
+                dvmdp               = stress_data[0].dvon_Mises_stress_dp  (&f);
                 dvmf_dp             =
                 output.von_Mises_p_norm_functional_sensitivity_for_all_elems(pval, &f);
                 
@@ -452,14 +452,14 @@ void check_stress (ValType& v, const RealVectorX& x0) {
 
             // next, check the total derivative of the quantity wrt the parameter
             {
-                const std::vector<MAST::StressStrainOutputBase::Data*>&
+                std::vector<MAST::StressStrainOutputBase::Data>
                 stress_data = output.get_stress_strain_data_for_elem(&elem);
                 
                 libmesh_assert_equal_to(stress_data.size(), 1); // this should have one element
                 
-                stress              = (stress_data[0]->stress() - stress0)/dp;
-                strain              = (stress_data[0]->strain() - strain0)/dp;
-                vm                  = (stress_data[0]->von_Mises_stress() - vm0)/dp;
+                stress              = (stress_data[0].stress() - stress0)/dp;
+                strain              = (stress_data[0].strain() - strain0)/dp;
+                vm                  = (stress_data[0].von_Mises_stress() - vm0)/dp;
                 dvmf_dp_fd          =
                 (output.von_Mises_p_norm_functional_for_all_elems(pval)-vmf0)/dp;
                 
@@ -519,46 +519,46 @@ BOOST_AUTO_TEST_CASE   (VonMisesStress) {
     output.add_stress_strain_at_qp_location(elem.get(), p, p, stress, strain, JxW);
 
     // now, the stress sensitivity values
-    const std::vector<MAST::StressStrainOutputBase::Data*>&
+    std::vector<MAST::StressStrainOutputBase::Data>
     data = output.get_stress_strain_data_for_elem(elem.get());
     
     // set the sensitivity for each stress
     stress(0)   =   dstress1;
-    data[0]->set_sensitivity(&f, stress, strain);
+    data[0].set_sensitivity(&f, stress, strain);
     stress(0)   =  -dstress1;
-    data[1]->set_sensitivity(&f, stress, strain);
+    data[1].set_sensitivity(&f, stress, strain);
     stress(0)   =   dstress2;
-    data[2]->set_sensitivity(&f, stress, strain);
+    data[2].set_sensitivity(&f, stress, strain);
     stress(0)   =  -dstress2;
-    data[3]->set_sensitivity(&f, stress, strain);
+    data[3].set_sensitivity(&f, stress, strain);
     
     // now check the vm stress value for each case
     BOOST_TEST_MESSAGE("   ** von Mises Stress ** ");
     BOOST_CHECK(MAST::compare_value(fabs(stress1),
-                                    data[0]->von_Mises_stress(),
+                                    data[0].von_Mises_stress(),
                                     tol));
     BOOST_CHECK(MAST::compare_value(fabs(stress1),
-                                    data[1]->von_Mises_stress(),
+                                    data[1].von_Mises_stress(),
                                     tol));
     BOOST_CHECK(MAST::compare_value(fabs(stress2),
-                                    data[2]->von_Mises_stress(),
+                                    data[2].von_Mises_stress(),
                                     tol));
     BOOST_CHECK(MAST::compare_value(fabs(stress2),
-                                    data[3]->von_Mises_stress(),
+                                    data[3].von_Mises_stress(),
                                     tol));
     
     BOOST_TEST_MESSAGE("   ** dvm-stress/dp **");
     BOOST_CHECK(MAST::compare_value(dstress1,
-                                    data[0]->dvon_Mises_stress_dp(&f),
+                                    data[0].dvon_Mises_stress_dp(&f),
                                     tol));
     BOOST_CHECK(MAST::compare_value(dstress1,
-                                    data[1]->dvon_Mises_stress_dp(&f),
+                                    data[1].dvon_Mises_stress_dp(&f),
                                     tol));
     BOOST_CHECK(MAST::compare_value(dstress2,
-                                    data[2]->dvon_Mises_stress_dp(&f),
+                                    data[2].dvon_Mises_stress_dp(&f),
                                     tol));
     BOOST_CHECK(MAST::compare_value(dstress2,
-                                    data[3]->dvon_Mises_stress_dp(&f),
+                                    data[3].dvon_Mises_stress_dp(&f),
                                     tol));
 
     BOOST_TEST_MESSAGE("   ** vm-stress functional **");
@@ -594,6 +594,57 @@ BOOST_AUTO_TEST_CASE   (VonMisesStress) {
 
 
 
+BOOST_AUTO_TEST_CASE   (AggregatedVonMisesStressFunctional) {
+    
+    const Real
+    tol      = 1.e-2;
+    
+    // check that the von Mises stress functional accumulated while the
+    // stress values are added is the same as the one computed from the
+    // stored data
+    
+    std::auto_ptr<libMesh::Elem> elem(new libMesh::Edge2);
+    MAST::Parameter f("a", 0.);
+    libMesh::Point     p;
+    RealVectorX
+    strain  = RealVectorX::Zero(6),
+    stress  = RealVectorX::Zero(6),
+    dstress = RealVectorX::Zero(6);
+    
+    const Real
+    vals[]  = {5.e6, -15.e6, 8.e6, 20.e6},
+    dvals[] = {-1.e8, -3.e8, 2.e8, 1.e8},
+    JxW     = 0.1;
+    
+    MAST::StressStrainOutputBase  output, aggregated;
+    aggregated.set_stress_functional(MAST::VON_MISES_P_NORM_FUNCTIONAL, 2.);
+    
+    for (unsigned int i=0; i<4; i++) {
+        
+        stress(0)   = vals[i];
+        dstress(0)  = dvals[i];
+        
+        output.add_stress_strain_at_qp_location(elem.get(), p, p, stress, strain, JxW).
+        set_sensitivity(&f, dstress, strain);
+        aggregated.add_stress_strain_at_qp_location(elem.get(), p, p, stress, strain, JxW).
+        set_sensitivity(&f, dstress, strain);
+    }
+    
+    BOOST_TEST_MESSAGE("   ** aggregated vm-stress functional **");
+    BOOST_CHECK(MAST::compare_value
+                (output.von_Mises_p_norm_functional_for_all_elems(2),
+                 aggregated.aggregated_stress_functional(),
+                 tol));
+    
+    BOOST_TEST_MESSAGE("   ** aggregated dvm-stress functional/dp **");
+    BOOST_CHECK(MAST::compare_value
+                (output.von_Mises_p_norm_functional_sensitivity_for_all_elems(2, &f),
+                 aggregated.aggregated_stress_functional_sensitivity(&f),
+                 tol));
+}
+
+
+
 BOOST_FIXTURE_TEST_SUITE  (Structural1DStressEvaluation, MAST::BuildStructural1DElem)
 
 BOOST_AUTO_TEST_CASE   (StressLinear1DIndependentOffset) {